@@ -28,6 +28,7 @@
 #include <orea/app/oreapp.hpp>
 
 #include <orea/app/initbuilders.hpp>
+#include <orea/engine/distributedvaluationengine.hpp>
 
 #include <qle/version.hpp>
 
@@ -66,8 +67,15 @@ int main(int argc, char** argv) {
         exit(0);
     }
 
+    // worker process of a distributed cube generation, see DistributedValuationEngine
+    if (argc == 4 && string(argv[1]) == "--distributed-worker") {
+        ore::analytics::initBuilders();
+        return runDistributedValuationWorker(argv[2], std::stoul(argv[3])) ? 0 : -1;
+    }
+
     if (argc != 2) {
-        std::cout << endl << "usage: ORE path/to/ore.xml" << endl << endl;
+        std::cout << endl << "usage: ORE path/to/ore.xml" << endl;
+        std::cout << "       ORE --distributed-worker path/to/jobdirectory partition" << endl << endl;
         return -1;
     }
 
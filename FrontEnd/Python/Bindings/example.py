@@ -0,0 +1,28 @@
+# Runs an ORE example in-process and post-processes the results with NumPy and pandas, without writing and
+# re-reading csv files. Build ORE with -DORE_BUILD_PYTHON=ON and add the build directory containing orepy to
+# PYTHONPATH, then run this script from Examples/Example_1.
+
+import numpy as np
+import pandas as pd
+
+import orepy
+
+app = orepy.App("Input/ore.xml")
+app.run()
+print("ORE", app.version, "run time", app.run_time, "seconds")
+
+# the npv cube as a read only view of shape (ids, dates, samples, depth)
+cube = app.cube("cube")
+npv = cube.values()[..., 0]
+epe = np.maximum(npv, 0.0).mean(axis=2)
+print(pd.DataFrame(epe, index=cube.ids, columns=cube.dates))
+
+# simulated index fixings, fx spots etc. of shape (dates, samples)
+if "scenariodata" in app.scenario_data_names():
+    data = app.scenario_data("scenariodata")
+    for key in data.keys():
+        print(key, data.values(*key).mean(axis=1))
+
+# reports as data frames, the numeric columns are views on the report buffers
+exposure = pd.DataFrame(app.report("exposure_trade_Swap_20y").to_dict())
+print(exposure.head())
@@ -0,0 +1,313 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orepy.cpp
+    \brief Python module exposing cubes, scenario data and reports as NumPy arrays
+
+    The arrays are views on the buffers of the C++ objects wherever these are contiguous, i.e. for in memory cubes,
+    in memory aggregation scenario data and the Size, Real and string (dictionary codes) columns of in memory
+    reports. The views are read only and keep the owning C++ object alive. Other cube types and the Date and
+    Period report columns are copied.
+*/
+
+#include <orea/app/initbuilders.hpp>
+#include <orea/app/oreapp.hpp>
+#include <orea/app/parameters.hpp>
+#include <orea/cube/contiguouscube.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/cube/npvcube.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+
+#include <ored/report/inmemoryreport.hpp>
+#include <ored/utilities/to_string.hpp>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <memory>
+
+#ifndef QL_USE_STD_SHARED_PTR
+#include <boost/shared_ptr.hpp>
+PYBIND11_DECLARE_HOLDER_TYPE(T, boost::shared_ptr<T>)
+#endif
+
+namespace py = pybind11;
+
+using namespace ore::analytics;
+using namespace ore::data;
+using QuantLib::Date;
+using QuantLib::Real;
+using QuantLib::Size;
+
+namespace {
+
+// read only view on a buffer owned by owner, the strides are given in elements
+template <typename T>
+py::array view(const T* data, const std::vector<py::ssize_t>& shape, std::vector<py::ssize_t> strides,
+               const py::object& owner) {
+    for (auto& s : strides)
+        s *= static_cast<py::ssize_t>(sizeof(T));
+    py::array a(py::dtype::of<T>(), shape, strides, data, owner);
+    a.attr("setflags")(py::arg("write") = false);
+    return a;
+}
+
+// datetime64 array, QuantLib serial numbers count from 1899-12-30, i.e. 1970-01-01 is 25569
+py::object dates(const std::vector<Date>& d) {
+    py::array_t<std::int64_t> days(d.size());
+    auto r = days.mutable_unchecked<1>();
+    for (Size i = 0; i < d.size(); ++i)
+        r(i) = static_cast<std::int64_t>(d[i].serialNumber()) - 25569;
+    return days.attr("astype")("datetime64[D]");
+}
+
+py::object objectArray(const py::list& values) {
+    return py::module_::import("numpy").attr("array")(values, py::arg("dtype") = "O");
+}
+
+template <typename T> bool inMemoryCubeValues(const NPVCube& cube, const py::object& owner, py::object& result) {
+    auto c = dynamic_cast<const InMemoryCubeBase<T>*>(&cube);
+    if (c == nullptr)
+        return false;
+    auto stride = [c](Size i, Size j, Size k) { return static_cast<py::ssize_t>(c->index(i, j, k, 0)); };
+    result = view(c->data(), {(py::ssize_t)c->numIds(), (py::ssize_t)c->numDates(), (py::ssize_t)c->samples(),
+                              (py::ssize_t)c->depth()},
+                  {c->numIds() > 1 ? stride(1, 0, 0) : 0, c->numDates() > 1 ? stride(0, 1, 0) : 0,
+                   c->samples() > 1 ? stride(0, 0, 1) : 0, 1},
+                  owner);
+    return true;
+}
+
+template <typename T> bool contiguousCubeValues(const NPVCube& cube, const py::object& owner, py::object& result) {
+    auto c = dynamic_cast<const ContiguousInMemoryCube<T>*>(&cube);
+    if (c == nullptr)
+        return false;
+    auto const& s = *c->storage();
+    result = view(s.data, {(py::ssize_t)s.numIds, (py::ssize_t)s.numDates, (py::ssize_t)s.samples, (py::ssize_t)s.depth},
+                  {(py::ssize_t)(s.numDates * s.samples * s.depth), (py::ssize_t)(s.samples * s.depth),
+                   (py::ssize_t)s.depth, 1},
+                  owner);
+    return true;
+}
+
+// values with shape (ids, dates, samples, depth)
+py::object cubeValues(const py::object& self) {
+    auto cube = self.cast<QuantLib::ext::shared_ptr<NPVCube>>();
+    py::object result;
+    if (inMemoryCubeValues<double>(*cube, self, result) || inMemoryCubeValues<float>(*cube, self, result) ||
+        contiguousCubeValues<double>(*cube, self, result) || contiguousCubeValues<float>(*cube, self, result))
+        return result;
+    py::array_t<double> values(std::vector<py::ssize_t>{(py::ssize_t)cube->numIds(), (py::ssize_t)cube->numDates(),
+                                                        (py::ssize_t)cube->samples(), (py::ssize_t)cube->depth()});
+    auto r = values.mutable_unchecked<4>();
+    for (Size i = 0; i < cube->numIds(); ++i)
+        for (Size j = 0; j < cube->numDates(); ++j)
+            for (Size k = 0; k < cube->samples(); ++k)
+                for (Size d = 0; d < cube->depth(); ++d)
+                    r(i, j, k, d) = cube->get(i, j, k, d);
+    return std::move(values);
+}
+
+// t0 values with shape (ids, depth)
+py::object cubeT0Values(const py::object& self) {
+    auto cube = self.cast<QuantLib::ext::shared_ptr<NPVCube>>();
+    std::vector<py::ssize_t> shape{(py::ssize_t)cube->numIds(), (py::ssize_t)cube->depth()};
+    std::vector<py::ssize_t> strides{(py::ssize_t)cube->depth(), 1};
+    if (auto c = dynamic_cast<const InMemoryCubeBase<double>*>(cube.get()))
+        return view(c->t0Data(), shape, strides, self);
+    if (auto c = dynamic_cast<const InMemoryCubeBase<float>*>(cube.get()))
+        return view(c->t0Data(), shape, strides, self);
+    if (auto c = dynamic_cast<const ContiguousInMemoryCube<double>*>(cube.get()))
+        return view(c->storage()->t0Data, shape, strides, self);
+    if (auto c = dynamic_cast<const ContiguousInMemoryCube<float>*>(cube.get()))
+        return view(c->storage()->t0Data, shape, strides, self);
+    py::array_t<double> values(shape);
+    auto r = values.mutable_unchecked<2>();
+    for (Size i = 0; i < cube->numIds(); ++i)
+        for (Size d = 0; d < cube->depth(); ++d)
+            r(i, d) = cube->getT0(i, d);
+    return std::move(values);
+}
+
+std::vector<std::string> cubeIds(const NPVCube& cube) {
+    std::vector<std::string> ids(cube.numIds());
+    for (auto const& [id, i] : cube.idsAndIndexes())
+        ids[i] = id;
+    return ids;
+}
+
+// values with shape (dates, samples) for the given key
+py::object scenarioDataValues(const py::object& self, const AggregationScenarioDataType type,
+                              const std::string& qualifier) {
+    auto data = self.cast<QuantLib::ext::shared_ptr<AggregationScenarioData>>();
+    QL_REQUIRE(data->has(type, qualifier), "no scenario data for " << type << " " << qualifier);
+    std::vector<py::ssize_t> shape{(py::ssize_t)data->dimDates(), (py::ssize_t)data->dimSamples()};
+    if (auto d = QuantLib::ext::dynamic_pointer_cast<InMemoryAggregationScenarioData>(data))
+        return view(d->data(type, qualifier), shape, {(py::ssize_t)data->dimSamples(), 1}, self);
+    if (auto d = QuantLib::ext::dynamic_pointer_cast<SinglePrecisionInMemoryAggregationScenarioData>(data))
+        return view(d->data(type, qualifier), shape, {(py::ssize_t)data->dimSamples(), 1}, self);
+    py::array_t<double> values(shape);
+    auto r = values.mutable_unchecked<2>();
+    for (Size i = 0; i < data->dimDates(); ++i)
+        for (Size j = 0; j < data->dimSamples(); ++j)
+            r(i, j) = data->get(i, j, type, qualifier);
+    return std::move(values);
+}
+
+Size columnIndex(const InMemoryReport& report, const std::string& name) {
+    for (Size i = 0; i < report.columns(); ++i)
+        if (report.header(i) == name)
+            return i;
+    QL_FAIL("report has no column " << name);
+}
+
+// Size and Real columns as views, string columns as object arrays, Date columns as datetime64, Period columns as
+// object arrays of strings
+py::object reportColumn(const py::object& self, const Size i) {
+    auto report = self.cast<QuantLib::ext::shared_ptr<InMemoryReport>>();
+    QL_REQUIRE(i < report->columns(), "column " << i << " out of range, report has " << report->columns()
+                                                << " columns");
+    const py::ssize_t n = report->rows();
+    switch (report->columnType(i).which()) {
+    case 0:
+        return view(report->sizeColumn(i).data(), {n}, {1}, self);
+    case 1:
+        return view(report->realColumn(i).data(), {n}, {1}, self);
+    case 2: {
+        auto const& codes = report->stringColumn(i);
+        py::list dictionary = py::cast(report->stringDictionary(i));
+        py::list values(n);
+        for (py::ssize_t j = 0; j < n; ++j)
+            values[j] = dictionary[codes[j]];
+        return objectArray(values);
+    }
+    case 3: {
+        std::vector<Date> d(n);
+        for (py::ssize_t j = 0; j < n; ++j)
+            d[j] = boost::get<Date>(report->data(i, j));
+        return dates(d);
+    }
+    default: {
+        py::list values(n);
+        for (py::ssize_t j = 0; j < n; ++j)
+            values[j] = ore::data::to_string(boost::get<QuantLib::Period>(report->data(i, j)));
+        return objectArray(values);
+    }
+    }
+}
+
+} // namespace
+
+PYBIND11_MODULE(orepy, m) {
+    m.doc() = "ORE cubes, scenario data and reports as NumPy arrays";
+
+    ore::analytics::initBuilders();
+
+    py::class_<NPVCube, QuantLib::ext::shared_ptr<NPVCube>>(m, "NPVCube")
+        .def_property_readonly("ids", &cubeIds, "trade or netting set ids in cube order")
+        .def_property_readonly("asof", [](const NPVCube& c) { return py::object(dates({c.asof()})[py::int_(0)]); })
+        .def_property_readonly("dates", [](const NPVCube& c) { return dates(c.dates()); })
+        .def_property_readonly("samples", &NPVCube::samples)
+        .def_property_readonly("depth", &NPVCube::depth)
+        .def("values", &cubeValues, "values with shape (ids, dates, samples, depth), a read only view if possible")
+        .def("t0_values", &cubeT0Values, "t0 values with shape (ids, depth), a read only view if possible");
+
+    py::enum_<AggregationScenarioDataType>(m, "AggregationScenarioDataType")
+        .value("IndexFixing", AggregationScenarioDataType::IndexFixing)
+        .value("FXSpot", AggregationScenarioDataType::FXSpot)
+        .value("Numeraire", AggregationScenarioDataType::Numeraire)
+        .value("CreditState", AggregationScenarioDataType::CreditState)
+        .value("SurvivalWeight", AggregationScenarioDataType::SurvivalWeight)
+        .value("RecoveryRate", AggregationScenarioDataType::RecoveryRate)
+        .value("Generic", AggregationScenarioDataType::Generic);
+
+    py::class_<AggregationScenarioData, QuantLib::ext::shared_ptr<AggregationScenarioData>>(m,
+                                                                                            "AggregationScenarioData")
+        .def_property_readonly("dates", &AggregationScenarioData::dimDates)
+        .def_property_readonly("samples", &AggregationScenarioData::dimSamples)
+        .def("keys", &AggregationScenarioData::keys)
+        .def("values", &scenarioDataValues, py::arg("type"), py::arg("qualifier") = "",
+             "values with shape (dates, samples), a read only view if possible");
+
+    py::class_<InMemoryReport, QuantLib::ext::shared_ptr<InMemoryReport>>(m, "Report")
+        .def_property_readonly("rows", &InMemoryReport::rows)
+        .def_property_readonly("columns",
+                               [](const InMemoryReport& r) {
+                                   std::vector<std::string> headers;
+                                   for (Size i = 0; i < r.columns(); ++i)
+                                       headers.push_back(r.header(i));
+                                   return headers;
+                               })
+        .def("column", &reportColumn, py::arg("index"),
+             "column values, Size and Real columns are read only views")
+        .def(
+            "column",
+            [](const py::object& self, const std::string& name) {
+                return reportColumn(self, columnIndex(*self.cast<QuantLib::ext::shared_ptr<InMemoryReport>>(), name));
+            },
+            py::arg("name"))
+        .def(
+            "categories",
+            [](const py::object& self, const std::string& name) {
+                auto report = self.cast<QuantLib::ext::shared_ptr<InMemoryReport>>();
+                Size i = columnIndex(*report, name);
+                auto const& codes = report->stringColumn(i);
+                return py::make_tuple(view(codes.data(), {(py::ssize_t)codes.size()}, {1}, self),
+                                      py::cast(report->stringDictionary(i)));
+            },
+            py::arg("name"),
+            "codes (a read only view) and categories of a string column, e.g. for pandas.Categorical.from_codes()")
+        .def(
+            "to_dict",
+            [](const py::object& self) {
+                auto report = self.cast<QuantLib::ext::shared_ptr<InMemoryReport>>();
+                py::dict result;
+                for (Size i = 0; i < report->columns(); ++i)
+                    result[py::str(report->header(i))] = reportColumn(self, i);
+                return result;
+            },
+            "columns by header, e.g. for pandas.DataFrame()");
+
+    py::class_<OREApp>(m, "App")
+        .def(py::init([](const std::string& oreXml, const bool console) {
+                 auto params = QuantLib::ext::make_shared<Parameters>();
+                 params->fromFile(oreXml);
+                 return std::make_unique<OREApp>(params, console);
+             }),
+             py::arg("ore_xml"), py::arg("console") = false)
+        .def(
+            "run",
+            [](OREApp& app) {
+                py::gil_scoped_release release;
+                app.run();
+            },
+            "run the analytics configured in ore.xml")
+        .def("analytic_types", &OREApp::getAnalyticTypes)
+        .def("report_names", &OREApp::getReportNames)
+        .def(
+            "report", [](OREApp& app, const std::string& name) { return app.getReport(name)->report(); },
+            py::arg("name"))
+        .def("cube_names", &OREApp::getCubeNames)
+        .def("cube", &OREApp::getCube, py::arg("name"))
+        .def("scenario_data_names", &OREApp::getMarketCubeNames)
+        .def("scenario_data", &OREApp::getMarketCube, py::arg("name"))
+        .def("errors", &OREApp::getErrors)
+        .def_property_readonly("run_time", &OREApp::getRunTime)
+        .def_property_readonly("version", &OREApp::version);
+}
@@ -0,0 +1,277 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "benchmark.hpp"
+#include "xvascaling.hpp"
+
+#include <orea/app/initbuilders.hpp>
+#include <qle/version.hpp>
+
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <thread>
+
+namespace ore {
+namespace benchmark {
+
+namespace {
+
+constexpr std::size_t maxIterations = 1000000000;
+
+std::map<std::string, std::function<void(State&)>>& registry() {
+    static std::map<std::string, std::function<void(State&)>> r;
+    return r;
+}
+
+std::string& dataPathValue() {
+#ifdef ORE_BENCHMARK_DATA_PATH
+    static std::string p = ORE_BENCHMARK_DATA_PATH;
+#else
+    static std::string p = "../../Examples";
+#endif
+    return p;
+}
+
+std::string jsonEscape(const std::string& s) {
+    std::string result;
+    for (char c : s) {
+        if (c == '"' || c == '\\')
+            result.push_back('\\');
+        if (static_cast<unsigned char>(c) >= 0x20)
+            result.push_back(c);
+    }
+    return result;
+}
+
+// write the results in the json format of Google Benchmark, so that existing tooling for comparing runs can be used
+void writeJson(const std::string& filename, const std::string& executable, const std::vector<Result>& results) {
+    std::ofstream out(filename);
+    if (!out.is_open())
+        throw std::runtime_error("ore_benchmarks: can not open output file " + filename);
+    std::time_t now = std::time(nullptr);
+    char date[32];
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    out << std::setprecision(12);
+    out << "{\n  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"executable\": \"" << jsonEscape(executable) << "\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "    \"ore_version\": \"" << OPEN_SOURCE_RISK_VERSION << "\",\n";
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\"\n";
+#else
+    out << "    \"library_build_type\": \"debug\"\n";
+#endif
+    out << "  },\n  \"benchmarks\": [";
+    bool first = true;
+    for (auto const& r : results) {
+        if (!r.skipReason.empty())
+            continue;
+        out << (first ? "\n" : ",\n") << "    {\n";
+        out << "      \"name\": \"" << jsonEscape(r.name) << "\",\n";
+        out << "      \"run_name\": \"" << jsonEscape(r.name) << "\",\n";
+        out << "      \"run_type\": \"iteration\",\n";
+        out << "      \"iterations\": " << r.iterations << ",\n";
+        out << "      \"real_time\": " << r.realTime << ",\n";
+        out << "      \"cpu_time\": " << r.cpuTime << ",\n";
+        if (r.itemsPerSecond > 0.0)
+            out << "      \"items_per_second\": " << r.itemsPerSecond << ",\n";
+        for (auto const& [counter, value] : r.counters)
+            out << "      \"" << jsonEscape(counter) << "\": " << value << ",\n";
+        out << "      \"time_unit\": \"ns\"\n    }";
+        first = false;
+    }
+    out << "\n  ]\n}\n";
+}
+
+void usage() {
+    std::cout << "usage: ore_benchmarks [options]\n"
+              << "  --benchmark_list_tests              list the benchmarks and exit\n"
+              << "  --benchmark_filter=<regex>          run only the benchmarks whose name matches\n"
+              << "  --benchmark_min_time=<seconds>      minimum timed duration per benchmark (default 0.5)\n"
+              << "  --benchmark_out=<file>              write the results in Google Benchmark json format\n"
+              << "  --data_path=<dir>                   the ORE Examples directory holding the input data\n"
+              << "  --xva_scaling                       run the xva scaling study instead of the benchmarks\n"
+              << "  --xva_portfolios=<list>             vanilla,scripted\n"
+              << "  --xva_engines=<list>                classic,amc,cg\n"
+              << "  --xva_trades=<list>                 number of trades, e.g. 10,100,1000\n"
+              << "  --xva_samples=<list>                number of samples, e.g. 100,1000\n"
+              << "  --xva_threads=<list>                number of threads, e.g. 1,2,4,8\n"
+              << "  --xva_grid=<grid>                   overrides the simulation grid, e.g. 40,3M\n";
+}
+
+std::vector<std::string> parseList(const std::string& s) {
+    std::vector<std::string> result;
+    boost::split(result, s, boost::is_any_of(","), boost::token_compress_on);
+    return result;
+}
+
+std::vector<std::size_t> parseSizeList(const std::string& s) {
+    std::vector<std::size_t> result;
+    for (auto const& t : parseList(s))
+        result.push_back(std::stoul(t));
+    return result;
+}
+
+void printHeader() {
+    std::cout << std::left << std::setw(72) << "Benchmark" << std::right << std::setw(16) << "Time (ns)"
+              << std::setw(16) << "CPU (ns)" << std::setw(14) << "Iterations" << std::setw(16) << "Items/s" << "\n"
+              << std::string(134, '-') << std::endl;
+}
+
+void printResult(const Result& r) {
+    if (r.skipReason.empty()) {
+        std::cout << std::left << std::setw(72) << r.name << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(16) << r.realTime << std::setw(16) << r.cpuTime << std::setw(14) << r.iterations
+                  << std::setw(16) << std::scientific << std::setprecision(3) << r.itemsPerSecond;
+        for (auto const& [counter, value] : r.counters)
+            std::cout << " " << counter << "=" << std::defaultfloat << value;
+        std::cout << std::endl;
+    } else {
+        std::cout << std::left << std::setw(72) << r.name << " skipped: " << r.skipReason << std::endl;
+    }
+}
+
+} // namespace
+
+const std::string& State::dataPath() { return dataPathValue(); }
+
+bool registerBenchmark(const std::string& name, const std::function<void(State&)>& function) {
+    registry()[name] = function;
+    return true;
+}
+
+int runBenchmarks(int argc, char** argv) {
+
+    std::string filter = ".*", outFile;
+    double minTime = 0.5;
+    bool list = false, xvaScaling = false;
+    XvaScalingOptions xvaOptions;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+        auto value = [&arg](const std::string& option) -> const char* {
+            return arg.compare(0, option.size() + 1, option + "=") == 0 ? arg.c_str() + option.size() + 1 : nullptr;
+        };
+        if (arg == "--benchmark_list_tests") {
+            list = true;
+        } else if (auto v = value("--benchmark_filter")) {
+            filter = v;
+        } else if (auto v = value("--benchmark_min_time")) {
+            minTime = std::stod(v);
+        } else if (auto v = value("--benchmark_out")) {
+            outFile = v;
+        } else if (auto v = value("--data_path")) {
+            dataPathValue() = v;
+        } else if (arg == "--xva_scaling") {
+            xvaScaling = true;
+        } else if (auto v = value("--xva_portfolios")) {
+            xvaOptions.portfolios = parseList(v);
+        } else if (auto v = value("--xva_engines")) {
+            xvaOptions.engines = parseList(v);
+        } else if (auto v = value("--xva_trades")) {
+            xvaOptions.trades = parseSizeList(v);
+        } else if (auto v = value("--xva_samples")) {
+            xvaOptions.samples = parseSizeList(v);
+        } else if (auto v = value("--xva_threads")) {
+            xvaOptions.threads = parseSizeList(v);
+        } else if (auto v = value("--xva_grid")) {
+            xvaOptions.grid = v;
+        } else {
+            usage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    ore::analytics::initBuilders();
+
+    std::regex re(filter);
+    std::vector<Result> results;
+
+    if (!list)
+        printHeader();
+
+    if (xvaScaling && !list) {
+        try {
+            runXvaScaling(xvaOptions, [&results](const Result& r) {
+                printResult(r);
+                results.push_back(r);
+            });
+        } catch (const std::exception& e) {
+            std::cout << "xva scaling failed: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    for (auto const& [name, function] : registry()) {
+        if (xvaScaling || !std::regex_search(name, re))
+            continue;
+        if (list) {
+            std::cout << name << std::endl;
+            continue;
+        }
+        Result r;
+        r.name = name;
+        try {
+            // increase the number of iterations until the minimum time is reached, as Google Benchmark does
+            std::size_t n = 1;
+            while (true) {
+                State state(n);
+                function(state);
+                if (!state.skipReason().empty()) {
+                    r.skipReason = state.skipReason();
+                    break;
+                }
+                if (state.realTime() >= minTime || n >= maxIterations) {
+                    r.iterations = n;
+                    r.realTime = state.realTime() / static_cast<double>(n) * 1.0E9;
+                    r.cpuTime = state.cpuTime() / static_cast<double>(n) * 1.0E9;
+                    if (state.itemsPerIteration() > 0 && state.realTime() > 0.0)
+                        r.itemsPerSecond = static_cast<double>(state.itemsPerIteration() * n) / state.realTime();
+                    break;
+                }
+                double multiplier = state.realTime() > 0.0 ? std::min(10.0, 1.4 * minTime / state.realTime()) : 10.0;
+                n = std::min(maxIterations, std::max(n + 1, static_cast<std::size_t>(multiplier * n)));
+            }
+        } catch (const std::exception& e) {
+            r.skipReason = std::string("error: ") + e.what();
+        }
+        printResult(r);
+        results.push_back(r);
+    }
+
+    if (!outFile.empty()) {
+        writeJson(outFile, argv[0], results);
+        std::cout << "results written to " << outFile << std::endl;
+    }
+
+    bool failed = std::any_of(results.begin(), results.end(),
+                              [](const Result& r) { return r.skipReason.compare(0, 6, "error:") == 0; });
+    return failed ? 1 : 0;
+}
+
+} // namespace benchmark
+} // namespace ore
+
+int main(int argc, char** argv) { return ore::benchmark::runBenchmarks(argc, argv); }
@@ -0,0 +1,117 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file benchmark/benchmark.hpp
+    \brief minimal benchmark registry and runner for the ore_benchmarks executable
+*/
+
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace benchmark {
+
+//! The state of a running benchmark, the benchmark function times the body of a loop over keepRunning()
+/*! The number of iterations is increased until the timed loop ran for at least the minimum time. Setup work inside
+    the loop can be excluded from the timing with pauseTiming() / resumeTiming(). */
+class State {
+public:
+    explicit State(const std::size_t iterations) : iterations_(iterations) {}
+
+    bool keepRunning() {
+        if (done_ == 0)
+            start();
+        if (done_ < iterations_) {
+            ++done_;
+            return true;
+        }
+        stop();
+        return false;
+    }
+
+    void pauseTiming() { stop(); }
+    void resumeTiming() { start(); }
+
+    //! number of items (e.g. samples or trades) processed per iteration, reported as items per second
+    void setItemsPerIteration(const std::size_t n) { itemsPerIteration_ = n; }
+    //! mark the benchmark as skipped, e.g. if its input data is missing
+    void skip(const std::string& reason) { skipReason_ = reason; }
+    //! data path given on the command line
+    static const std::string& dataPath();
+
+    std::size_t iterations() const { return iterations_; }
+    std::size_t itemsPerIteration() const { return itemsPerIteration_; }
+    double realTime() const { return realTime_; }
+    double cpuTime() const { return cpuTime_; }
+    const std::string& skipReason() const { return skipReason_; }
+
+private:
+    void start() {
+        if (running_)
+            return;
+        running_ = true;
+        realStart_ = std::chrono::steady_clock::now();
+        cpuStart_ = std::clock();
+    }
+    void stop() {
+        if (!running_)
+            return;
+        running_ = false;
+        realTime_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - realStart_).count();
+        cpuTime_ += static_cast<double>(std::clock() - cpuStart_) / CLOCKS_PER_SEC;
+    }
+
+    std::size_t iterations_, done_ = 0, itemsPerIteration_ = 0;
+    bool running_ = false;
+    std::chrono::steady_clock::time_point realStart_;
+    std::clock_t cpuStart_ = 0;
+    double realTime_ = 0.0, cpuTime_ = 0.0;
+    std::string skipReason_;
+};
+
+//! The result of a benchmark, times are per iteration in nanoseconds
+struct Result {
+    std::string name;
+    std::size_t iterations = 0;
+    double realTime = 0.0, cpuTime = 0.0, itemsPerSecond = 0.0;
+    //! additional values reported in the json output, e.g. the peak memory usage
+    std::map<std::string, double> counters;
+    //! non-empty if the benchmark was skipped or failed, failures start with "error:"
+    std::string skipReason;
+};
+
+//! Register a benchmark, returns true so that it can be used to initialise a static variable
+bool registerBenchmark(const std::string& name, const std::function<void(State&)>& function);
+
+//! Run the registered benchmarks, see usage() in benchmark.cpp for the command line options
+int runBenchmarks(int argc, char** argv);
+
+} // namespace benchmark
+} // namespace ore
+
+//! Define and register a benchmark function with the given name
+#define ORE_BENCHMARK(name)                                                                                            \
+    static void name(ore::benchmark::State&);                                                                         \
+    static const bool name##_registered = ore::benchmark::registerBenchmark(#name, name);                             \
+    static void name(ore::benchmark::State& state)
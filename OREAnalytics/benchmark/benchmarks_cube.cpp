@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "benchmark.hpp"
+
+#include <orea/cube/cube_io.hpp>
+#include <orea/cube/inmemorycube.hpp>
+
+#include <boost/filesystem.hpp>
+
+using namespace ore::analytics;
+using QuantLib::Date;
+using QuantLib::Size;
+
+namespace {
+
+constexpr Size trades = 100, dates = 50, samples = 1000;
+
+QuantLib::ext::shared_ptr<NPVCube> buildCube() {
+    Date asof(5, QuantLib::February, 2016);
+    std::set<std::string> ids;
+    for (Size i = 0; i < trades; ++i)
+        ids.insert("Trade_" + std::to_string(i));
+    std::vector<Date> cubeDates;
+    for (Size j = 0; j < dates; ++j)
+        cubeDates.push_back(asof + static_cast<QuantLib::Integer>(30 * (j + 1)));
+    auto cube = QuantLib::ext::make_shared<SinglePrecisionInMemoryCube>(asof, ids, cubeDates, samples);
+    for (Size i = 0; i < trades; ++i)
+        for (Size j = 0; j < dates; ++j)
+            for (Size k = 0; k < samples; ++k)
+                cube->set(static_cast<QuantLib::Real>(i + j + k), i, j, k);
+    return cube;
+}
+
+} // namespace
+
+ORE_BENCHMARK(InMemoryCube_Set) {
+    auto cube = buildCube();
+    while (state.keepRunning()) {
+        for (Size i = 0; i < trades; ++i)
+            for (Size j = 0; j < dates; ++j)
+                for (Size k = 0; k < samples; ++k)
+                    cube->set(1.0, i, j, k);
+    }
+    state.setItemsPerIteration(trades * dates * samples);
+}
+
+ORE_BENCHMARK(InMemoryCube_Get) {
+    auto cube = buildCube();
+    QuantLib::Real sum = 0.0;
+    while (state.keepRunning()) {
+        for (Size i = 0; i < trades; ++i)
+            for (Size j = 0; j < dates; ++j)
+                for (Size k = 0; k < samples; ++k)
+                    sum += cube->get(i, j, k);
+    }
+    state.setItemsPerIteration(trades * dates * samples);
+    if (sum < 0.0)
+        state.skip("unexpected cube values");
+}
+
+ORE_BENCHMARK(CubeIO_SaveLoadCompressed) {
+    auto cube = buildCube();
+    std::string filename = (boost::filesystem::temp_directory_path() / "ore_benchmark_cube.csv.gz").string();
+    while (state.keepRunning()) {
+        saveCube(filename, NPVCubeWithMetaData{cube});
+        loadCube(filename);
+    }
+    boost::filesystem::remove(filename);
+    state.setItemsPerIteration(trades * dates * samples);
+}
+
+ORE_BENCHMARK(CubeIO_SaveLoadBinary) {
+    auto cube = buildCube();
+    std::string filename = (boost::filesystem::temp_directory_path() / "ore_benchmark_cube.bin").string();
+    while (state.keepRunning()) {
+        saveCube(filename, NPVCubeWithMetaData{cube});
+        loadCube(filename);
+    }
+    boost::filesystem::remove(filename);
+    state.setItemsPerIteration(trades * dates * samples);
+}
@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "benchmark.hpp"
+
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/scenariosimmarketparameters.hpp>
+
+#include <ored/configuration/conventions.hpp>
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/marketdata/todaysmarketparameters.hpp>
+
+#include <ql/settings.hpp>
+
+#include <boost/filesystem.hpp>
+
+using namespace ore::analytics;
+using namespace ore::data;
+using QuantLib::Date;
+
+namespace {
+
+// the market of the examples, see Examples/Input
+struct ExampleMarketData {
+    ExampleMarketData() {
+        asof = Date(5, QuantLib::February, 2016);
+        std::string input = ore::benchmark::State::dataPath() + "/Input/";
+        if (!boost::filesystem::exists(input + "todaysmarket.xml"))
+            return;
+        QuantLib::Settings::instance().evaluationDate() = asof;
+        auto conventions = QuantLib::ext::make_shared<Conventions>();
+        conventions->fromFile(input + "conventions.xml");
+        InstrumentConventions::instance().setConventions(conventions);
+        params = QuantLib::ext::make_shared<TodaysMarketParameters>();
+        params->fromFile(input + "todaysmarket.xml");
+        curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+        curveConfigs->fromFile(input + "curveconfig.xml");
+        loader = QuantLib::ext::make_shared<CSVLoader>(input + "market_20160205_flat.txt",
+                                                       input + "fixings_20160205.txt", true);
+    }
+    bool available() const { return loader != nullptr; }
+    QuantLib::ext::shared_ptr<TodaysMarket> build() const {
+        return QuantLib::ext::make_shared<TodaysMarket>(asof, params, loader, curveConfigs, false, true, false);
+    }
+
+    Date asof;
+    QuantLib::ext::shared_ptr<TodaysMarketParameters> params;
+    QuantLib::ext::shared_ptr<CurveConfigurations> curveConfigs;
+    QuantLib::ext::shared_ptr<Loader> loader;
+};
+
+} // namespace
+
+ORE_BENCHMARK(TodaysMarket_Build) {
+    ExampleMarketData data;
+    if (!data.available()) {
+        state.skip("example market data not found in " + ore::benchmark::State::dataPath());
+        return;
+    }
+    while (state.keepRunning())
+        data.build();
+}
+
+ORE_BENCHMARK(ScenarioSimMarket_ApplyScenario) {
+    ExampleMarketData data;
+    std::string simulation = ore::benchmark::State::dataPath() + "/Example_1/Input/simulation.xml";
+    if (!data.available() || !boost::filesystem::exists(simulation)) {
+        state.skip("example market data not found in " + ore::benchmark::State::dataPath());
+        return;
+    }
+    auto simParams = QuantLib::ext::make_shared<ScenarioSimMarketParameters>();
+    simParams->fromFile(simulation);
+    auto simMarket = QuantLib::ext::make_shared<ScenarioSimMarket>(data.build(), simParams);
+    // alternate between the base scenario and a scenario with all values bumped by 1%, so that every quote changes
+    auto base = simMarket->baseScenario();
+    auto bumped = base->clone();
+    for (auto const& key : bumped->keys())
+        bumped->add(key, bumped->get(key) * 1.01);
+    bool useBase = false;
+    while (state.keepRunning()) {
+        simMarket->applyScenario(useBase ? base : bumped);
+        useBase = !useBase;
+    }
+    state.setItemsPerIteration(base->keys().size());
+}
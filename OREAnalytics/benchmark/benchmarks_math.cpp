@@ -0,0 +1,94 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "benchmark.hpp"
+
+#include <qle/ad/backwardderivatives.hpp>
+#include <qle/ad/computationgraph.hpp>
+#include <qle/ad/forwardevaluation.hpp>
+#include <qle/math/randomvariable.hpp>
+#include <qle/math/randomvariable_ops.hpp>
+
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+using namespace QuantExt;
+using QuantLib::Size;
+
+namespace {
+
+constexpr Size samples = 10000;
+
+RandomVariable randomVariable(const Size n, const unsigned long seed) {
+    QuantLib::MersenneTwisterUniformRng rng(seed);
+    RandomVariable r(n);
+    for (Size i = 0; i < n; ++i)
+        r.set(i, rng.nextReal());
+    return r;
+}
+
+} // namespace
+
+ORE_BENCHMARK(RandomVariable_Add) {
+    RandomVariable x = randomVariable(samples, 42), y = randomVariable(samples, 43);
+    while (state.keepRunning())
+        x = x + y;
+    state.setItemsPerIteration(samples);
+}
+
+ORE_BENCHMARK(RandomVariable_Mult) {
+    RandomVariable x = randomVariable(samples, 42), y = randomVariable(samples, 43);
+    while (state.keepRunning())
+        x = x * y;
+    state.setItemsPerIteration(samples);
+}
+
+ORE_BENCHMARK(RandomVariable_Exp) {
+    RandomVariable x = randomVariable(samples, 42), y;
+    while (state.keepRunning())
+        y = exp(x);
+    state.setItemsPerIteration(samples);
+}
+
+ORE_BENCHMARK(ComputationGraph_ForwardBackward) {
+    // a small payoff like expression exp(x * y + x) * z over a chain of 20 terms
+    ComputationGraph g;
+    auto x = cg_var(g, "x", ComputationGraph::VarDoesntExist::Create);
+    auto y = cg_var(g, "y", ComputationGraph::VarDoesntExist::Create);
+    auto z = cg_var(g, "z", ComputationGraph::VarDoesntExist::Create);
+    std::size_t sum = cg_const(g, 0.0);
+    for (Size i = 0; i < 20; ++i)
+        sum = cg_add(g, sum, cg_mult(g, cg_exp(g, cg_add(g, cg_mult(g, x, y), x)), z));
+    auto ops = getRandomVariableOps(samples);
+    auto grads = getRandomVariableGradients(samples);
+    auto opNodeRequirements = getRandomVariableOpNodeRequirements();
+    std::vector<bool> keep(g.size(), false);
+    keep[x] = keep[y] = keep[z] = true;
+    RandomVariable xv = randomVariable(samples, 42), yv = randomVariable(samples, 43), zv = randomVariable(samples, 44);
+    while (state.keepRunning()) {
+        std::vector<RandomVariable> values(g.size()), derivatives(g.size());
+        values[x] = xv;
+        values[y] = yv;
+        values[z] = zv;
+        for (auto const& [c, node] : g.constants())
+            values[node] = RandomVariable(samples, c);
+        forwardEvaluation(g, values, ops, RandomVariable::deleter, true, opNodeRequirements, keep);
+        derivatives[sum] = RandomVariable(samples, 1.0);
+        backwardDerivatives(g, values, derivatives, grads, RandomVariable::deleter, keep);
+    }
+    state.setItemsPerIteration(samples);
+}
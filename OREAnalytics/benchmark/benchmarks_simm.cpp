@@ -0,0 +1,42 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "benchmark.hpp"
+
+#include <orea/simm/crifloader.hpp>
+#include <orea/simm/simmbucketmapperbase.hpp>
+#include <orea/simm/simmcalculator.hpp>
+#include <orea/simm/utilities.hpp>
+
+#include <boost/filesystem.hpp>
+
+using namespace ore::analytics;
+
+ORE_BENCHMARK(SimmCalculator_Example44) {
+    std::string crifFile = ore::benchmark::State::dataPath() + "/Example_44/Input/crif.csv";
+    if (!boost::filesystem::exists(crifFile)) {
+        state.skip("crif file not found in " + ore::benchmark::State::dataPath());
+        return;
+    }
+    auto config = buildSimmConfiguration("2.6", QuantLib::ext::make_shared<SimmBucketMapperBase>());
+    CsvFileCrifLoader loader(crifFile, config, {}, false, true, '\n', ',', '"');
+    Crif crif = loader.loadCrif();
+    while (state.keepRunning())
+        SimmCalculator(crif, config, "USD", "USD", "USD", nullptr, true, false, true);
+    state.setItemsPerIteration(crif.size());
+}
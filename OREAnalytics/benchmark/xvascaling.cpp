@@ -0,0 +1,319 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "xvascaling.hpp"
+
+#include <orea/app/oreapp.hpp>
+#include <orea/app/parameters.hpp>
+#include <orea/scenario/scenariogeneratordata.hpp>
+
+#include <ored/utilities/dategrid.hpp>
+#include <ored/utilities/osutils.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <regex>
+#include <set>
+#include <sstream>
+
+namespace ore {
+namespace benchmark {
+
+using namespace ore::analytics;
+
+namespace {
+
+// the input files and trade templates of a synthetic portfolio, paths are relative to the examples directory
+struct PortfolioFamily {
+    std::vector<std::pair<std::string, std::string>> files;
+    std::string simulationConfig, templatePortfolio;
+    std::vector<std::string> extraTemplates;
+    bool scriptLibrary = false;
+    std::string amcTradeTypes;
+    std::set<std::string> engines;
+};
+
+const std::string fxForwardTemplate = R"(<Trade id="FxFwd_EURUSD">
+    <TradeType>FxForward</TradeType>
+    <Envelope>
+      <CounterParty>CPTY_A</CounterParty>
+      <NettingSetId>CPTY_A</NettingSetId>
+      <AdditionalFields/>
+    </Envelope>
+    <FxForwardData>
+      <ValueDate>2026-03-01</ValueDate>
+      <BoughtCurrency>EUR</BoughtCurrency>
+      <BoughtAmount>1000000</BoughtAmount>
+      <SoldCurrency>USD</SoldCurrency>
+      <SoldAmount>1100000</SoldAmount>
+    </FxForwardData>
+  </Trade>)";
+
+PortfolioFamily portfolioFamily(const std::string& name) {
+    PortfolioFamily f;
+    if (name == "vanilla") {
+        f.files = {{"Input/market_20160205_flat.txt", "market.txt"},
+                   {"Input/todaysmarket.xml", "todaysmarket.xml"},
+                   {"Example_39/Input/pricingengine.xml", "pricingengine.xml"},
+                   {"Example_39/Input/pricingengine_amc.xml", "pricingengine_amc.xml"},
+                   {"Example_39/Input/netting.xml", "netting.xml"}};
+        f.simulationConfig = "Example_39/Input/simulation.xml";
+        f.templatePortfolio = "Example_39/Input/portfolio.xml";
+        f.extraTemplates = {fxForwardTemplate};
+        f.amcTradeTypes = "Swap,Swaption,FxOption";
+        f.engines = {"classic", "amc"};
+    } else if (name == "scripted") {
+        f.files = {{"Example_56/Input/market.txt", "market.txt"},
+                   {"Example_56/Input/todaysmarket.xml", "todaysmarket.xml"},
+                   {"Example_56/Input/pricingengine.xml", "pricingengine.xml"},
+                   {"Example_56/Input/pricingengine_amc.xml", "pricingengine_amc.xml"},
+                   {"Example_56/Input/netting.xml", "netting.xml"},
+                   {"Example_56/Input/scriptlibrary.xml", "scriptlibrary.xml"},
+                   {"Example_56/Input/xvasensiconfig.xml", "xvasensiconfig.xml"}};
+        f.simulationConfig = "Example_56/Input/simulation.xml";
+        f.templatePortfolio = "Example_56/Input/portfolio.xml";
+        f.scriptLibrary = true;
+        f.amcTradeTypes = "ScriptedTrade";
+        f.engines = {"classic", "amc", "cg"};
+    } else {
+        QL_FAIL("xva scaling: unknown portfolio '" << name << "', expected vanilla or scripted");
+    }
+    f.files.push_back({"Input/fixings_20160205.txt", "fixings.txt"});
+    f.files.push_back({"Input/curveconfig.xml", "curveconfig.xml"});
+    f.files.push_back({"Input/conventions.xml", "conventions.xml"});
+    return f;
+}
+
+std::string readFile(const boost::filesystem::path& p) {
+    std::ifstream in(p.string());
+    QL_REQUIRE(in.is_open(), "xva scaling: can not open " << p.string());
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const boost::filesystem::path& p, const std::string& content) {
+    std::ofstream out(p.string());
+    QL_REQUIRE(out.is_open(), "xva scaling: can not write " << p.string());
+    out << content;
+}
+
+// the trade nodes of the template portfolio followed by the extra templates
+std::vector<std::string> tradeTemplates(const PortfolioFamily& f) {
+    std::string portfolio = readFile(boost::filesystem::path(State::dataPath()) / f.templatePortfolio);
+    std::vector<std::string> result;
+    for (std::size_t start = portfolio.find("<Trade "); start != std::string::npos;
+         start = portfolio.find("<Trade ", start)) {
+        std::size_t end = portfolio.find("</Trade>", start);
+        QL_REQUIRE(end != std::string::npos, "xva scaling: unterminated trade in " << f.templatePortfolio);
+        end += 8;
+        result.push_back(portfolio.substr(start, end - start));
+        start = end;
+    }
+    result.insert(result.end(), f.extraTemplates.begin(), f.extraTemplates.end());
+    QL_REQUIRE(!result.empty(), "xva scaling: no trades found in " << f.templatePortfolio);
+    return result;
+}
+
+// n trades cycling through the templates, the trade ids are made unique by a suffix
+std::string syntheticPortfolio(const std::vector<std::string>& templates, const std::size_t n) {
+    static const std::regex id("<Trade id=\"([^\"]*)\"");
+    std::ostringstream os;
+    os << "<?xml version=\"1.0\"?>\n<Portfolio>\n";
+    for (std::size_t i = 0; i < n; ++i)
+        os << "  "
+           << std::regex_replace(templates[i % templates.size()], id, "<Trade id=\"$1_" + std::to_string(i) + "\"",
+                                 std::regex_constants::format_first_only)
+           << "\n";
+    os << "</Portfolio>\n";
+    return os.str();
+}
+
+std::string simulationXml(std::string xml, const std::size_t samples, const std::string& grid) {
+    xml = std::regex_replace(xml, std::regex("<Samples>[^<]*</Samples>"),
+                             "<Samples>" + std::to_string(samples) + "</Samples>",
+                             std::regex_constants::format_first_only);
+    if (!grid.empty())
+        xml = std::regex_replace(xml, std::regex("<Grid>[^<]*</Grid>"), "<Grid>" + grid + "</Grid>",
+                                 std::regex_constants::format_first_only);
+    return xml;
+}
+
+std::string oreConfig(const boost::filesystem::path& dir, const PortfolioFamily& f, const std::string& engine,
+                      const std::size_t threads) {
+    auto param = [](const std::string& name, const std::string& value) {
+        return "      <Parameter name=\"" + name + "\">" + value + "</Parameter>\n";
+    };
+    std::ostringstream os;
+    os << "<?xml version=\"1.0\"?>\n<ORE>\n  <Setup>\n"
+       << param("asofDate", "2016-02-05") << param("inputPath", dir.string())
+       << param("outputPath", (dir / "Output").string()) << param("logFile", "log.txt") << param("logMask", "7")
+       << param("marketDataFile", "market.txt") << param("fixingDataFile", "fixings.txt")
+       << param("implyTodaysFixings", "N") << param("curveConfigFile", "curveconfig.xml")
+       << param("conventionsFile", "conventions.xml") << param("marketConfigFile", "todaysmarket.xml")
+       << param("pricingEnginesFile", "pricingengine.xml") << param("portfolioFile", "portfolio.xml")
+       << param("observationModel", "Disable") << param("nThreads", std::to_string(threads));
+    if (f.scriptLibrary)
+        os << param("scriptLibrary", "scriptlibrary.xml");
+    os << "  </Setup>\n  <Markets>\n"
+       << param("lgmcalibration", "collateral_inccy") << param("fxcalibration", "xois_eur")
+       << param("pricing", "xois_eur") << param("simulation", "xois_eur") << param("sensitivity", "xois_eur")
+       << "  </Markets>\n  <Analytics>\n    <Analytic type=\"simulation\">\n"
+       << param("active", "Y") << param("amc", engine == "classic" ? "N" : "Y")
+       << param("amcCg", engine == "cg" ? "Y" : "N");
+    if (engine == "cg")
+        os << param("xvaCgSensitivityConfigFile", "xvasensiconfig.xml");
+    os << param("amcTradeTypes", f.amcTradeTypes) << param("simulationConfigFile", "simulation.xml")
+       << param("pricingEnginesFile", "pricingengine.xml") << param("amcPricingEnginesFile", "pricingengine_amc.xml")
+       << param("baseCurrency", "EUR") << param("storeScenarios", "N")
+       << "    </Analytic>\n  </Analytics>\n</ORE>\n";
+    return os.str();
+}
+
+std::string engineName(const std::string& engine, const std::size_t threads) {
+    if (engine == "classic")
+        return threads == 1 ? "ValuationEngine" : "MultiThreadedValuationEngine";
+    if (engine == "amc")
+        return "AMCValuationEngine";
+    if (engine == "cg")
+        return "XvaEngineCG";
+    QL_FAIL("xva scaling: unknown engine '" << engine << "', expected classic, amc or cg");
+}
+
+// reset the peak resident set size, so that it can be attributed to a single run (linux only)
+void resetPeakRss() {
+#ifdef __linux__
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (clearRefs.is_open())
+        clearRefs << "5";
+#endif
+}
+
+unsigned long long peakRss() {
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0)
+            return std::stoull(line.substr(6)) * 1024;
+    }
+#endif
+    return ore::data::os::getPeakMemoryUsageBytes();
+}
+
+} // namespace
+
+void runXvaScaling(const XvaScalingOptions& options, const std::function<void(const Result&)>& report) {
+
+    for (auto const& portfolio : options.portfolios) {
+        PortfolioFamily family = portfolioFamily(portfolio);
+        std::vector<std::string> templates;
+        std::string simulationTemplate;
+        std::string setupError;
+        try {
+            templates = tradeTemplates(family);
+            simulationTemplate = readFile(boost::filesystem::path(State::dataPath()) / family.simulationConfig);
+        } catch (const std::exception& e) {
+            setupError = e.what();
+        }
+
+        for (auto const& engine : options.engines) {
+            for (auto const& trades : options.trades) {
+                for (auto const& samples : options.samples) {
+                    for (auto const& threads : options.threads) {
+
+                        Result r;
+                        std::string name = engineName(engine, threads);
+                        r.name = "XvaScaling/" + portfolio + "/" + name + "/trades:" + std::to_string(trades) +
+                                 "/samples:" + std::to_string(samples) + "/threads:" + std::to_string(threads);
+
+                        // the single threaded engines are run for one thread only
+                        if (threads > 1 && engine == "cg")
+                            continue;
+                        if (family.engines.find(engine) == family.engines.end()) {
+                            r.skipReason = "engine " + engine + " does not support the " + portfolio + " portfolio";
+                            report(r);
+                            continue;
+                        }
+                        if (!setupError.empty()) {
+                            r.skipReason = setupError;
+                            report(r);
+                            continue;
+                        }
+
+                        boost::filesystem::path dir =
+                            boost::filesystem::temp_directory_path() /
+                            boost::filesystem::unique_path("ore_xva_scaling_%%%%-%%%%-%%%%");
+                        try {
+                            boost::filesystem::create_directories(dir / "Output");
+                            for (auto const& [source, target] : family.files)
+                                boost::filesystem::copy_file(boost::filesystem::path(State::dataPath()) / source,
+                                                             dir / target);
+                            writeFile(dir / "simulation.xml",
+                                      simulationXml(simulationTemplate, samples, options.grid));
+                            writeFile(dir / "portfolio.xml", syntheticPortfolio(templates, trades));
+                            writeFile(dir / "ore.xml", oreConfig(dir, family, engine, threads));
+
+                            auto params = QuantLib::ext::make_shared<Parameters>();
+                            params->fromFile((dir / "ore.xml").string());
+                            OREApp app(params);
+
+                            resetPeakRss();
+                            auto start = std::chrono::steady_clock::now();
+                            std::clock_t cpuStart = std::clock();
+                            app.run();
+                            double wallTime =
+                                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                            double cpuTime = static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+                            // OREApp::run() does not throw, a run without results has failed
+                            auto reports = app.getReportNames();
+                            QL_REQUIRE(!app.getCubeNames().empty() ||
+                                           reports.find("xvacg-exposure") != reports.end(),
+                                       "no exposure results, see " << (dir / "Output" / "log.txt").string());
+
+                            std::size_t dates = 1;
+                            if (app.getInputs() && app.getInputs()->scenarioGeneratorData())
+                                dates = app.getInputs()->scenarioGeneratorData()->getGrid()->valuationDates().size();
+
+                            r.iterations = 1;
+                            r.realTime = wallTime * 1.0E9;
+                            r.cpuTime = cpuTime * 1.0E9;
+                            r.itemsPerSecond = static_cast<double>(trades * samples * dates) / wallTime;
+                            r.counters["peak_rss_bytes"] = static_cast<double>(peakRss());
+                            r.counters["trades"] = static_cast<double>(trades);
+                            r.counters["samples"] = static_cast<double>(samples);
+                            r.counters["threads"] = static_cast<double>(threads);
+                            r.counters["valuation_dates"] = static_cast<double>(dates);
+                            boost::filesystem::remove_all(dir);
+                        } catch (const std::exception& e) {
+                            r.skipReason = std::string("error: ") + e.what();
+                        }
+                        report(r);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace benchmark
+} // namespace ore
@@ -0,0 +1,52 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file benchmark/xvascaling.hpp
+    \brief end-to-end scaling study of the exposure simulation engines on synthetic portfolios
+*/
+
+#pragma once
+
+#include "benchmark.hpp"
+
+namespace ore {
+namespace benchmark {
+
+//! The grid of runs of the xva scaling study, every combination of the values is run once
+struct XvaScalingOptions {
+    /*! vanilla: swaps, cross currency swaps, fx forwards, swaptions and fx options on the market of Example_39
+        scripted: scripted swaps on the market of Example_56 */
+    std::vector<std::string> portfolios = {"vanilla", "scripted"};
+    /*! classic: ValuationEngine for one thread, MultiThreadedValuationEngine otherwise
+        amc: AMCValuationEngine
+        cg: XvaEngineCG, scripted portfolio only */
+    std::vector<std::string> engines = {"classic", "amc", "cg"};
+    std::vector<std::size_t> trades = {10, 100};
+    std::vector<std::size_t> samples = {100, 1000};
+    std::vector<std::size_t> threads = {1, 2, 4};
+    //! overrides the simulation grid of the example if not empty, e.g. "40,3M"
+    std::string grid;
+};
+
+/*! Run the xva scaling study. Each run generates the input files of an ORE run in a temporary directory, runs the
+    simulation analytic and reports the wall time, the peak resident set size and the number of trade-scenario
+    valuations (trades x samples x valuation dates) per second. */
+void runXvaScaling(const XvaScalingOptions& options, const std::function<void(const Result&)>& report);
+
+} // namespace benchmark
+} // namespace ore
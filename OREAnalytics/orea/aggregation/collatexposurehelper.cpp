@@ -19,6 +19,9 @@
 #include <orea/aggregation/collatexposurehelper.hpp>
 #include <ql/errors.hpp>
 
+#include <algorithm>
+#include <deque>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -28,6 +31,46 @@ namespace ore {
 using namespace data;
 namespace analytics {
 
+namespace {
+
+// the values of all scenarios as of the simulation date, see CollateralExposureHelper::estimateUncollatValue()
+void estimateUncollatValues(const Date& simulationDate, const Real npv_t0, const Date& date_t0,
+                            const vector<vector<Real>>& scenPvProfiles, const vector<Date>& dateGrid,
+                            vector<Real>& values) {
+
+    QL_REQUIRE(simulationDate >= date_t0, "CollatExposureHelper error: simulation date < start date");
+    QL_REQUIRE(dateGrid[0] >= date_t0, "CollatExposureHelper error: cube dateGrid starts before t0");
+
+    if (simulationDate >= dateGrid.back()) {
+        values = scenPvProfiles.back(); // flat extrapolation
+        return;
+    }
+    if (simulationDate == date_t0) {
+        std::fill(values.begin(), values.end(), npv_t0);
+        return;
+    }
+    Size pos2 = std::lower_bound(dateGrid.begin(), dateGrid.end(), simulationDate) - dateGrid.begin();
+#ifdef FLAT_INTERPOLATION
+    // a grid date or the next grid date
+    values = scenPvProfiles[pos2];
+#else
+    if (dateGrid[pos2] == simulationDate) {
+        values = scenPvProfiles[pos2];
+        return;
+    }
+    Date t1 = pos2 == 0 ? date_t0 : dateGrid[pos2 - 1];
+    Date t2 = dateGrid[pos2];
+    Real w = double(simulationDate - t1) / double(t2 - t1);
+    const vector<Real>& npv2 = scenPvProfiles[pos2];
+    for (Size k = 0; k < values.size(); ++k) {
+        Real npv1 = pos2 == 0 ? npv_t0 : scenPvProfiles[pos2 - 1][k];
+        values[k] = npv1 + ((npv2[k] - npv1) * w);
+    }
+#endif
+}
+
+} // namespace
+
 CollateralExposureHelper::CalculationType parseCollateralCalculationType(const string& s) {
     static map<string, CollateralExposureHelper::CalculationType> m = {
         {"Symmetric", CollateralExposureHelper::Symmetric},
@@ -264,5 +307,143 @@ QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>>
         QL_FAIL("CollateralExposureHelper - unknown error when generating collateralBalancePaths");
     }
 }
+vector<vector<Real>> CollateralExposureHelper::collateralBalances(
+    const QuantLib::ext::shared_ptr<NettingSetDefinition>& csaDef, const Real& nettingSetPv, const Date& date_t0,
+    const vector<vector<Real>>& nettingSetValues, const Date& nettingSet_maturity, const vector<Date>& dateGrid,
+    const Real& csaFxTodayRate, const vector<vector<Real>>& csaFxScenarioRates, const Real& csaTodayCollatCurve,
+    const vector<vector<Real>>& csaScenCollatCurves, const CalculationType& calcType,
+    const QuantLib::ext::shared_ptr<CollateralBalance>& balance) {
+
+    // step 1; t0 balance, see collateralBalancePaths()
+
+    Real initialBalance = 0.0;
+    if (balance && balance->variationMargin() != Null<Real>()) {
+        initialBalance = balance->variationMargin();
+        DLOG("initial collateral balance: " << initialBalance);
+    } else {
+        DLOG("initial collateral balance not found");
+    }
+    Real bal_t0 = marginRequirementCalc(QuantLib::ext::make_shared<CollateralAccount>(csaDef, initialBalance, date_t0),
+                                        nettingSetPv, date_t0);
+    DLOG("base current collateral balance: " << bal_t0);
+
+    // step 2; the csa details used in the scenario loops below
+
+    Size numScenarios = nettingSetValues.front().size();
+    QL_REQUIRE(numScenarios == csaFxScenarioRates.front().size(), "netting values -v- scenario FX rate mismatch");
+    const QuantLib::ext::shared_ptr<CSA>& csa = csaDef->csaDetails();
+    const Real ia = csa->independentAmountHeld();
+    const Real thresholdRcv = csa->thresholdRcv(), thresholdPay = csa->thresholdPay();
+    const Real mtaRcv = csa->mtaRcv(), mtaPay = csa->mtaPay();
+    const Real spreadRcv = csa->collatSpreadRcv(), spreadPay = csa->collatSpreadPay();
+    const Period lag = (calcType == NoLag ? 0 * Days : csa->marginPeriodOfRisk());
+    Date simEndDate = std::min(nettingSet_maturity, dateGrid.back()) + csa->marginPeriodOfRisk();
+
+    // step 3; the state of the accounts, i.e. the balances as of the last account date per scenario and the open margin
+    // calls sorted by pay date, each holding the amounts over all scenarios (zero if a scenario has no such call)
+
+    struct MarginCalls {
+        Date payDate;
+        vector<Real> amounts;
+    };
+    vector<Real> accountBalance(numScenarios, bal_t0);
+    vector<Date> accountDate(numScenarios, date_t0);
+    std::deque<MarginCalls> marginCalls;
+
+    // the balances as of the grid dates, a grid date is written once all account updates up to this date are done
+    vector<vector<Real>> result(dateGrid.size());
+    Size nextGridDate = 0;
+    auto writeBalances = [&result, &dateGrid, &nextGridDate, &accountBalance](const Date& nextAccountDate) {
+        for (; nextGridDate < dateGrid.size() && dateGrid[nextGridDate] < nextAccountDate; ++nextGridDate)
+            result[nextGridDate] = accountBalance;
+    };
+
+    // step 4; evolve all scenarios along the margin dates
+
+    vector<Real> uncollatVal(numScenarios), fxValue(numScenarios), annualisedZeroRate(numScenarios);
+    vector<Real> openMargins(numScenarios), marginUs(numScenarios), marginCtp(numScenarios);
+    Date tmpDate = date_t0; // the date which gets evolved
+    Date nextMarginReqDateUs = date_t0;
+    Date nextMarginReqDateCtp = date_t0;
+    while (tmpDate <= simEndDate) {
+        QL_REQUIRE(tmpDate <= nextMarginReqDateUs && tmpDate <= nextMarginReqDateCtp &&
+                       (tmpDate == nextMarginReqDateUs || tmpDate == nextMarginReqDateCtp),
+                   "collateral balance path generation error; invalid time stepping");
+        bool eligMarginReqDateUs = tmpDate == nextMarginReqDateUs;
+        bool eligMarginReqDateCtp = tmpDate == nextMarginReqDateCtp;
+        estimateUncollatValues(tmpDate, nettingSetPv, date_t0, nettingSetValues, dateGrid, uncollatVal);
+        estimateUncollatValues(tmpDate, csaFxTodayRate, date_t0, csaFxScenarioRates, dateGrid, fxValue);
+        estimateUncollatValues(tmpDate, csaTodayCollatCurve, date_t0, csaScenCollatCurves, dateGrid,
+                               annualisedZeroRate);
+
+        // settle the margin calls due, then bring the accounts up to the simulation date, the accrual rate is
+        // compounded daily, see CollateralAccount::updateAccountBalance()
+        while (!marginCalls.empty() && marginCalls.front().payDate <= tmpDate) {
+            const MarginCalls& mc = marginCalls.front();
+            writeBalances(mc.payDate);
+            for (Size k = 0; k < numScenarios; ++k) {
+                if (mc.amounts[k] == 0.0)
+                    continue;
+                Real accrualRate = annualisedZeroRate[k] - (accountBalance[k] >= 0.0 ? spreadRcv : spreadPay);
+                int accrualDays = mc.payDate - accountDate[k];
+                accountBalance[k] =
+                    accountBalance[k] * std::pow(1.0 + accrualRate / 365.0, accrualDays) + mc.amounts[k];
+                accountDate[k] = mc.payDate;
+            }
+            marginCalls.pop_front();
+        }
+        writeBalances(tmpDate);
+        for (Size k = 0; k < numScenarios; ++k) {
+            Real accrualRate = annualisedZeroRate[k] - (accountBalance[k] >= 0.0 ? spreadRcv : spreadPay);
+            int accrualDays = tmpDate - accountDate[k];
+            accountBalance[k] *= std::pow(1.0 + accrualRate / 365.0, accrualDays);
+            accountDate[k] = tmpDate;
+        }
+
+        // margin requirement, see marginRequirementCalc() and creditSupportAmount()
+        std::fill(openMargins.begin(), openMargins.end(), 0.0);
+        for (auto const& mc : marginCalls) {
+            for (Size k = 0; k < numScenarios; ++k)
+                openMargins[k] += mc.amounts[k];
+        }
+        for (Size k = 0; k < numScenarios; ++k) {
+            Real v = uncollatVal[k] / fxValue[k] + ia;
+            Real csaAmount = v >= 0.0 ? std::max(v - thresholdRcv, 0.0) : std::min(v + thresholdPay, 0.0);
+            Real collatShortfall = csaAmount - accountBalance[k] - openMargins[k];
+            Real mta = collatShortfall >= 0.0 ? mtaRcv : mtaPay;
+            Real margin = std::fabs(collatShortfall) >= mta ? collatShortfall : 0.0;
+            marginUs[k] = margin > 0.0 && eligMarginReqDateUs ? margin : 0.0;
+            marginCtp[k] = margin < 0.0 && eligMarginReqDateCtp ? margin : 0.0;
+        }
+
+        // issue the new margin calls, settled on the appropriate date, see updateMarginCall()
+        Date payDateUs = calcType == AsymmetricDVA ? tmpDate : tmpDate + lag;
+        Date payDateCtp = calcType == AsymmetricCVA ? tmpDate : tmpDate + lag;
+        for (auto* m : {&marginUs, &marginCtp}) {
+            if (std::all_of(m->begin(), m->end(), [](const Real x) { return x == 0.0; }))
+                continue;
+            Date payDate = m == &marginUs ? payDateUs : payDateCtp;
+            auto pos = std::upper_bound(marginCalls.begin(), marginCalls.end(), payDate,
+                                        [](const Date& d, const MarginCalls& mc) { return d < mc.payDate; });
+            marginCalls.insert(pos, MarginCalls{payDate, *m});
+        }
+
+        if (nextMarginReqDateUs == tmpDate)
+            nextMarginReqDateUs = tmpDate + csa->marginCallFrequency();
+        if (nextMarginReqDateCtp == tmpDate)
+            nextMarginReqDateCtp = tmpDate + csa->marginPostFrequency();
+        tmpDate = std::min(nextMarginReqDateUs, nextMarginReqDateCtp);
+    }
+    QL_REQUIRE(tmpDate > simEndDate, "collateral balance path generation error; while loop terminated too early. ("
+                                         << tmpDate << ", " << simEndDate << ")");
+
+    // step 5; set the account balances to zero after maturity of portfolio
+    writeBalances(simEndDate + Period(1, Days));
+    std::fill(accountBalance.begin(), accountBalance.end(), 0.0);
+    writeBalances(Date::maxDate());
+
+    return result;
+}
+
 } // namespace analytics
 } // namespace ore
@@ -110,6 +110,20 @@ public:
         const Real& csaFxTodayRate, const vector<vector<Real>>& csaFxScenarioRates, const Real& csaTodayCollatCurve,
         const vector<vector<Real>>& csaScenCollatCurves, const CalculationType& calcType = Symmetric,
         const QuantLib::ext::shared_ptr<CollateralBalance>& balance = QuantLib::ext::shared_ptr<CollateralBalance>());
+
+    /*!
+      Takes a netting set (and scenario exposures) as input and returns the collateral balances
+      by date of the dateGrid and scenario, i.e. the balances of the collateralBalancePaths()
+      as of the grid dates. All scenarios are evolved together, the account balances and the
+      outstanding margin calls are held as arrays over the scenarios instead of one
+      CollateralAccount per scenario.
+    */
+    static vector<vector<Real>> collateralBalances(
+        const QuantLib::ext::shared_ptr<NettingSetDefinition>& csaDef, const Real& nettingSetPv, const Date& date_t0,
+        const vector<vector<Real>>& nettingSetValues, const Date& nettingSet_maturity, const vector<Date>& dateGrid,
+        const Real& csaFxTodayRate, const vector<vector<Real>>& csaFxScenarioRates, const Real& csaTodayCollatCurve,
+        const vector<vector<Real>>& csaScenCollatCurves, const CalculationType& calcType = Symmetric,
+        const QuantLib::ext::shared_ptr<CollateralBalance>& balance = QuantLib::ext::shared_ptr<CollateralBalance>());
 };
 
 //! Convert text representation to CollateralExposureHelper::CalculationType
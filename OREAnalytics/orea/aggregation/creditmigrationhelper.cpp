@@ -54,6 +54,7 @@ CreditMigrationHelper::CreditMigrationHelper(const QuantLib::ext::shared_ptr<Cre
       evaluation_(parseEvaluation(parameters_->evaluation())),
       bucketing_(distributionLowerBound, distributionUpperBound, buckets) {
 
+    stateCube_ = QuantLib::ext::dynamic_pointer_cast<CreditStateNpvCube>(cube_);
     rescaledTransitionMatrices_.resize(cube_->numDates());
     init();
     if (evaluation_ == Evaluation::TerminalSimulation)
@@ -291,6 +292,8 @@ Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size pat
         // issuer migration risk
         Size simEntityState = simulatedEntityState(i, path);
         for (auto const& tradeId : issuerTradeIds_[i]) {
+            if (unaffected(tradeId, date, path))
+                continue;
             try {
                 Size tid = cube_->idsAndIndexes().at(tradeId);
                 Real baseValue = cube_->get(tid, date, path, 0);
@@ -343,6 +346,17 @@ Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size pat
     return pnl;
 } // generateMigrationPnl
 
+bool CreditMigrationHelper::unaffected(const std::string& tradeId, const Size date, const Size path) const {
+    // the notional exposure mode and joint defaults of CDS counterparties modify the state values
+    if (!stateCube_ || loanExposureMode_ == LoanExposureMode::Notional ||
+        tradeCdsCptyIdx_.find(tradeId) != tradeCdsCptyIdx_.end())
+        return false;
+    auto t = stateCube_->idsAndIndexes().find(tradeId);
+    if (t == stateCube_->idsAndIndexes().end() || stateCube_->stateDependent(t->second, date))
+        return false;
+    return stateCube_->get(t->second, date, path, cubeIndexStateNpvs_) == stateCube_->get(t->second, date, path, 0);
+} // unaffected
+
 void CreditMigrationHelper::generateConditionalMigrationPnl(const Size date, const Size path,
                                                             const std::map<string, Matrix>& transMat,
                                                             std::vector<Array>& condProbs,
@@ -367,6 +381,8 @@ void CreditMigrationHelper::generateConditionalMigrationPnl(const Size date, con
         // issuer migration risk
         Size cdsCptyIdx = Null<Size>();
         for (auto const& tradeId : issuerTradeIds_[i]) {
+            if (unaffected(tradeId, date, path))
+                continue;
             for (Size j = 0; j < n_; ++j) {
                 try {
                     Size tid = cube_->idsAndIndexes().at(tradeId);
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <orea/aggregation/creditsimulationparameters.hpp>
+#include <orea/cube/creditstatenpvcube.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <orea/scenario/aggregationscenariodata.hpp>
 
@@ -106,8 +107,13 @@ private:
     void generateConditionalMigrationPnl(const Size date, const Size path, const std::map<string, Matrix>& transMat,
                                          std::vector<Array>& condProbs, std::vector<Array>& pnl) const;
 
+    /*! True if the credit state of the issuer does not change the value of the trade on the given date and path, i.e.
+      the trade does not contribute to the migration PnL, only known if the state npvs are stored sparsely */
+    bool unaffected(const std::string& tradeId, const Size date, const Size path) const;
+
     QuantLib::ext::shared_ptr<CreditSimulationParameters> parameters_;
     QuantLib::ext::shared_ptr<NPVCube> cube_, nettedCube_;
+    QuantLib::ext::shared_ptr<CreditStateNpvCube> stateCube_;
     QuantLib::ext::shared_ptr<AggregationScenarioData> aggData_;
     Size cubeIndexCashflows_, cubeIndexStateNpvs_;
     Matrix globalFactorCorrelation_;
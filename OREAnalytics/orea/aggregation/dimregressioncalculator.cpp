@@ -36,6 +36,11 @@
 #include <boost/accumulators/statistics/mean.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -44,6 +49,37 @@ using namespace boost::accumulators;
 namespace ore {
 namespace analytics {
 
+namespace {
+// call f for 0, ..., n-1 on up to nThreads threads
+void forEachDate(const Size n, const Size nThreads, const std::function<void(Size)>& f) {
+    Size nWorkers = std::min<Size>(std::max<Size>(nThreads, 1), n);
+    if (nWorkers <= 1) {
+        for (Size j = 0; j < n; ++j)
+            f(j);
+        return;
+    }
+    std::atomic<Size> next(0);
+    std::vector<std::exception_ptr> errors(nWorkers);
+    std::vector<std::thread> workers;
+    for (Size w = 0; w < nWorkers; ++w) {
+        workers.emplace_back([&, w]() {
+            try {
+                for (Size j = next++; j < n; j = next++)
+                    f(j);
+            } catch (...) {
+                errors[w] = std::current_exception();
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    for (const auto& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
+}
+} // namespace
+
 RegressionDynamicInitialMarginCalculator::RegressionDynamicInitialMarginCalculator(
     const QuantLib::ext::shared_ptr<InputParameters>& inputs,
     const QuantLib::ext::shared_ptr<Portfolio>& portfolio, const QuantLib::ext::shared_ptr<NPVCube>& cube,
@@ -116,6 +152,10 @@ void RegressionDynamicInitialMarginCalculator::build() {
     Size simple_dim_index_h = Size(floor(quantile_ * (samples - 1) + 0.5));
     Size simple_dim_index_p = Size(floor((1.0 - quantile_) * (samples - 1) + 0.5));
 
+    Size nThreads = inputs_ ? inputs_->nThreads() : 1;
+    LOG("DIM regression uses " << nThreads << " threads");
+    buildScenarioRegressors(stopDatesLoop, nThreads);
+
     Size nettingSetCount = 0;
     for (auto n : nettingSetIds_) {
         LOG("Process netting set " << n);
@@ -170,19 +210,33 @@ void RegressionDynamicInitialMarginCalculator::build() {
             nettingSetScaling_.find(n) == nettingSetScaling_.end() ? 1.0 : nettingSetScaling_[n];
         LOG("Netting set DIM scaling factor: " << nettingSetDimScaling);
 
-        for (Size j = 0; j < stopDatesLoop; ++j) {
+        // the dates are independent, each one writes its own slice of the netting set results
+        vector<vector<Real>>& npvs = nettingSetNPV_[n];
+        const vector<vector<Real>>& flows = nettingSetFLOW_[n];
+        const vector<vector<Real>>& closeOutNpvs = nettingSetCloseOutNPV_[n];
+        vector<vector<Real>>& deltaNpvs = nettingSetDeltaNPV_[n];
+        vector<vector<Array>>& regressorArrays = regressorArray_[n];
+        vector<vector<Real>>& dims = nettingSetDIM_[n];
+        vector<vector<Real>>& localDims = nettingSetLocalDIM_[n];
+        vector<Real>& expectedDims = nettingSetExpectedDIM_[n];
+        vector<Real>& zeroOrderDims = nettingSetZeroOrderDIM_[n];
+        vector<Real>& simpleDimsH = nettingSetSimpleDIMh_[n];
+        vector<Real>& simpleDimsP = nettingSetSimpleDIMp_[n];
+
+        auto processDate = [&](const Size j) {
             accumulator_set<double, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> accDiff;
             accumulator_set<double, stats<boost::accumulators::tag::mean>> accOneOverNumeraire;
+            vector<Real> numDefault(samples), numCloseOut(samples);
             for (Size k = 0; k < samples; ++k) {
-                Real numDefault =
+                numDefault[k] =
                     cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real numCloseOut =
+                numCloseOut[k] =
                     cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real npvDefault = nettingSetNPV_[n][j][k];
-                Real flow = nettingSetFLOW_[n][j][k];
-                Real npvCloseOut = nettingSetCloseOutNPV_[n][j][k];
-                accDiff((npvCloseOut * numCloseOut) + (flow * numDefault) - (npvDefault * numDefault));
-                accOneOverNumeraire(1.0 / numDefault);
+                Real npvDefault = npvs[j][k];
+                Real flow = flows[j][k];
+                Real npvCloseOut = closeOutNpvs[j][k];
+                accDiff((npvCloseOut * numCloseOut[k]) + (flow * numDefault[k]) - (npvDefault * numDefault[k]));
+                accOneOverNumeraire(1.0 / numDefault[k]);
             }
 
             Size mporCalendarDays = cubeInterpretation_->getMporCalendarDays(cube_, j);
@@ -192,45 +246,41 @@ void RegressionDynamicInitialMarginCalculator::build() {
             Real E_OneOverNumeraire =
                 mean(accOneOverNumeraire); // "re-discount" (the stdev is calculated on non-discounted deltaNPVs)
 
-            nettingSetZeroOrderDIM_[n][j] = stdevDiff * horizonScaling * confidenceLevel;
-            nettingSetZeroOrderDIM_[n][j] *= E_OneOverNumeraire;
+            zeroOrderDims[j] = stdevDiff * horizonScaling * confidenceLevel;
+            zeroOrderDims[j] *= E_OneOverNumeraire;
 
             vector<Real> rx0(samples, 0.0);
             vector<Array> rx(samples, Array());
             vector<Real> ry1(samples, 0.0);
             vector<Real> ry2(samples, 0.0);
             for (Size k = 0; k < samples; ++k) {
-                Real numDefault =
-                    cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real numCloseOut =
-                    cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real x = nettingSetNPV_[n][j][k] * numDefault;
-                Real f = nettingSetFLOW_[n][j][k] * numDefault;
-                Real y = nettingSetCloseOutNPV_[n][j][k] * numCloseOut;
+                Real x = npvs[j][k] * numDefault[k];
+                Real f = flows[j][k] * numDefault[k];
+                Real y = closeOutNpvs[j][k] * numCloseOut[k];
                 Real z = (y + f - x);
-                rx[k] = regressors_.empty() ? Array(1, nettingSetNPV_[n][j][k]) : regressorArray(n, j, k);
+                rx[k] = regressors_.empty() ? Array(1, npvs[j][k]) : regressorArray(npvs, j, k);
                 rx0[k] = rx[k][0];
                 ry1[k] = z;     // for local regression
                 ry2[k] = z * z; // for least squares regression
-                nettingSetDeltaNPV_[n][j][k] = z;
-                regressorArray_[n][j][k] = rx[k];
+                deltaNpvs[j][k] = z;
+                regressorArrays[j][k] = rx[k];
             }
-            vector<Real> delNpvVec_copy = nettingSetDeltaNPV_[n][j];
+            vector<Real> delNpvVec_copy = deltaNpvs[j];
             sort(delNpvVec_copy.begin(), delNpvVec_copy.end());
             Real simpleDim_h = delNpvVec_copy[simple_dim_index_h];
             Real simpleDim_p = delNpvVec_copy[simple_dim_index_p];
-            simpleDim_h *= horizonScaling;                                  // the usual scaling factors
-            simpleDim_p *= horizonScaling;                                  // the usual scaling factors
-            nettingSetSimpleDIMh_[n][j] = simpleDim_h * E_OneOverNumeraire; // discounted DIM
-            nettingSetSimpleDIMp_[n][j] = simpleDim_p * E_OneOverNumeraire; // discounted DIM
+            simpleDim_h *= horizonScaling;                        // the usual scaling factors
+            simpleDim_p *= horizonScaling;                        // the usual scaling factors
+            simpleDimsH[j] = simpleDim_h * E_OneOverNumeraire; // discounted DIM
+            simpleDimsP[j] = simpleDim_p * E_OneOverNumeraire; // discounted DIM
 
             QL_REQUIRE(rx.size() > v.size(), "not enough points for regression with polynom order " << polynomOrder);
             if (close_enough(stdevDiff, 0.0)) {
                 LOG("DIM: Zero std dev estimation at step " << j);
                 // Skip IM calculation if all samples have zero NPV (e.g. after latest maturity)
                 for (Size k = 0; k < samples; ++k) {
-                    nettingSetDIM_[n][j][k] = 0.0;
-                    nettingSetLocalDIM_[n][j][k] = 0.0;
+                    dims[j][k] = 0.0;
+                    localDims[j][k] = 0.0;
                 }
             } else {
                 // Least squares polynomial regression with specified polynom order
@@ -244,20 +294,21 @@ void RegressionDynamicInitialMarginCalculator::build() {
                 // Local regression versus first regression variable (i.e. we do not perform a
                 // multidimensional local regression):
                 // We evaluate this at a limited number of samples only for validation purposes.
-                // Note that computational effort scales quadratically with number of samples.
+                // The samples are binned, so that each evaluation costs a fixed number of kernel evaluations.
                 // NadarayaWatson needs a large number of samples for good results.
-                QuantExt::NadarayaWatson lr(rx0.begin(), rx0.end(), ry1.begin(),
-                                            GaussianKernel(0.0, localRegressionBandWidth_));
+                QuantLib::ext::shared_ptr<QuantExt::BinnedNadarayaWatson> lr;
                 Size localRegressionSamples = samples;
-                if (localRegressionEvaluations_ > 0)
-                    localRegressionSamples = Size(floor(1.0 * samples / localRegressionEvaluations_ + .5));
+                if (localRegressionEvaluations_ > 0) {
+                    lr = QuantLib::ext::make_shared<QuantExt::BinnedNadarayaWatson>(
+                        rx0.begin(), rx0.end(), ry1.begin(), GaussianKernel(0.0, localRegressionBandWidth_),
+                        localRegressionBandWidth_);
+                    localRegressionSamples =
+                        std::max<Size>(Size(floor(1.0 * samples / localRegressionEvaluations_ + .5)), 1);
+                }
 
                 // Evaluate regression function to compute DIM for each scenario
                 for (Size k = 0; k < samples; ++k) {
-                    // Real num1 = scenarioData_->get(j, k, AggregationScenarioDataType::Numeraire);
-                    Real numDefault = cubeInterpretation_->getDefaultAggregationScenarioData(
-                        AggregationScenarioDataType::Numeraire, j, k);
-                    Array regressor = regressors_.empty() ? Array(1, nettingSetNPV_[n][j][k]) : regressorArray(n, j, k);
+                    const Array& regressor = rx[k];
                     Real e = ls.eval(regressor, v);
                     if (e < 0.0)
                         LOG("Negative variance regression for date " << j << ", sample " << k
@@ -271,47 +322,68 @@ void RegressionDynamicInitialMarginCalculator::build() {
                     //    variance approaching zero. We correct this here by taking the positive part.
                     Real std = sqrt(std::max(e, 0.0));
                     Real scalingFactor = horizonScaling * confidenceLevel * nettingSetDimScaling;
-                    // Real dim = std * scalingFactor / num1;
-                    Real dim = std * scalingFactor / numDefault;
+                    Real dim = std * scalingFactor / numDefault[k];
                     dimCube_->set(dim, nettingSetCount, j, k);
-                    nettingSetDIM_[n][j][k] = dim;
-                    nettingSetExpectedDIM_[n][j] += dim / samples;
+                    dims[j][k] = dim;
+                    expectedDims[j] += dim / samples;
 
                     // Evaluate the Kernel regression for a subset of the samples only (performance)
-                    if (localRegressionEvaluations_ > 0 && (k % localRegressionSamples == 0))
-                        // nettingSetLocalDIM_[n][j][k] = lr.standardDeviation(regressor[0]) * scalingFactor / num1;
-                        nettingSetLocalDIM_[n][j][k] = lr.standardDeviation(regressor[0]) * scalingFactor / numDefault;
+                    if (lr && (k % localRegressionSamples == 0))
+                        localDims[j][k] = lr->standardDeviation(regressor[0]) * scalingFactor / numDefault[k];
                     else
-                        nettingSetLocalDIM_[n][j][k] = 0.0;
+                        localDims[j][k] = 0.0;
                 }
             }
-        }
+        };
+        forEachDate(stopDatesLoop, nThreads, processDate);
 
         nettingSetCount++;
     }
     LOG("DIM by polynomial regression done");
 }
 
-Array RegressionDynamicInitialMarginCalculator::regressorArray(string nettingSet, Size dateIndex,
-                                                                           Size sampleIndex) {
-    Array a(regressors_.size());
+void RegressionDynamicInitialMarginCalculator::buildScenarioRegressors(const Size dates, const Size nThreads) {
+    // the scenario data regressors are the same for all netting sets, only the NPV regressors are netting set specific
+    npvRegressors_.clear();
+    vector<pair<AggregationScenarioDataType, string>> sources(regressors_.size());
     for (Size i = 0; i < regressors_.size(); ++i) {
-        string variable = regressors_[i];
+        const string& variable = regressors_[i];
         if (boost::to_upper_copy(variable) ==
             "NPV") // this allows possibility to include NPV as a regressor alongside more fundamental risk factors
-            a[i] = nettingSetNPV_[nettingSet][dateIndex][sampleIndex];
+            npvRegressors_.push_back(i);
         else if (scenarioData_->has(AggregationScenarioDataType::IndexFixing, variable))
-            a[i] = cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::IndexFixing,
-                                                                      dateIndex, sampleIndex, variable);
+            sources[i] = make_pair(AggregationScenarioDataType::IndexFixing, variable);
         else if (scenarioData_->has(AggregationScenarioDataType::FXSpot, variable))
-            a[i] = cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::FXSpot, dateIndex,
-                                                                      sampleIndex, variable);
+            sources[i] = make_pair(AggregationScenarioDataType::FXSpot, variable);
         else if (scenarioData_->has(AggregationScenarioDataType::Generic, variable))
-            a[i] = cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Generic, dateIndex,
-                                                                      sampleIndex, variable);
+            sources[i] = make_pair(AggregationScenarioDataType::Generic, variable);
         else
             QL_FAIL("scenario data does not provide data for " << variable);
     }
+
+    scenarioRegressors_.clear();
+    if (regressors_.empty())
+        return;
+    Size samples = cube_->samples();
+    scenarioRegressors_ = vector<vector<Array>>(dates, vector<Array>(samples, Array(regressors_.size(), 0.0)));
+    if (npvRegressors_.size() == regressors_.size())
+        return;
+    forEachDate(dates, nThreads, [this, samples, &sources](const Size j) {
+        for (Size k = 0; k < samples; ++k) {
+            for (Size i = 0; i < sources.size(); ++i) {
+                if (!sources[i].second.empty())
+                    scenarioRegressors_[j][k][i] =
+                        cubeInterpretation_->getDefaultAggregationScenarioData(sources[i].first, j, k, sources[i].second);
+            }
+        }
+    });
+}
+
+Array RegressionDynamicInitialMarginCalculator::regressorArray(const vector<vector<Real>>& nettingSetNPV,
+                                                               Size dateIndex, Size sampleIndex) const {
+    Array a = scenarioRegressors_[dateIndex][sampleIndex];
+    for (Size i : npvRegressors_)
+        a[i] = nettingSetNPV[dateIndex][sampleIndex];
     return a;
 }
 
@@ -78,14 +78,20 @@ public:
     const vector<Real>& simpleResultsLower(const string& nettingSet);
 
 private:
-    //! Compile the array of DIM regressors for the specified netting set, date and sample index
-    Array regressorArray(string nettingSet, Size dateIndex, Size sampleIndex);
+    //! Read the scenario data regressors for the first \p dates dates and all samples
+    void buildScenarioRegressors(Size dates, Size nThreads);
+    //! Compile the array of DIM regressors for the specified netting set NPVs, date and sample index
+    Array regressorArray(const vector<vector<Real>>& nettingSetNPV, Size dateIndex, Size sampleIndex) const;
 
     Size regressionOrder_;
     vector<string> regressors_;
     Size localRegressionEvaluations_;
     Real localRegressionBandWidth_;
 
+    // Array of scenario data regressor values by date and sample, shared by all netting sets
+    vector<vector<Array>> scenarioRegressors_;
+    // Positions of the NPV regressors, filled per netting set
+    vector<Size> npvRegressors_;
     // For each netting set: Array of regressor values by date and sample
     map<string, vector<vector<Array>>> regressorArray_;
     // For each netting set: local regression DIM estimate by date and sample
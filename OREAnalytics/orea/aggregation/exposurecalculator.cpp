@@ -19,11 +19,17 @@
 #include <orea/aggregation/exposurecalculator.hpp>
 #include <orea/cube/inmemorycube.hpp>
 
+#include <qle/math/p2quantileestimator.hpp>
+
 #include <ored/portfolio/trade.hpp>
 
 #include <ql/time/date.hpp>
 #include <ql/time/calendars/weekendsonly.hpp>
 
+#include <atomic>
+#include <exception>
+#include <thread>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -36,13 +42,14 @@ ExposureCalculator::ExposureCalculator(
     const QuantLib::ext::shared_ptr<Market>& market,
     bool exerciseNextBreak, const string& baseCurrency, const string& configuration,
     const Real quantile, const CollateralExposureHelper::CalculationType calcType, const bool multiPath,
-    const bool flipViewXVA)
+    const bool flipViewXVA, const bool streaming, const Size nThreads)
     : portfolio_(portfolio), cube_(cube), cubeInterpretation_(cubeInterpretation),
        market_(market), exerciseNextBreak_(exerciseNextBreak),
       baseCurrency_(baseCurrency), configuration_(configuration),
       quantile_(quantile), calcType_(calcType),
-      multiPath_(multiPath), dates_(cube->dates()),
-      today_(market_->asofDate()), dc_(ActualActual(ActualActual::ISDA)), flipViewXVA_(flipViewXVA) {
+      multiPath_(multiPath), streaming_(streaming), dates_(cube->dates()),
+      today_(market_->asofDate()), dc_(ActualActual(ActualActual::ISDA)), flipViewXVA_(flipViewXVA),
+      nThreads_(nThreads) {
 
     QL_REQUIRE(portfolio_, "portfolio is null");
 
@@ -70,12 +77,26 @@ ExposureCalculator::ExposureCalculator(
 
 void ExposureCalculator::build() {
     LOG("Compute trade exposure profiles, " << (flipViewXVA_ ? "inverted (flipViewXVA = Y)" : "regular (flipViewXVA = N)"));
+
+    Handle<YieldTermStructure> curve = market_->discountCurve(baseCurrency_, configuration_);
+    vector<Real> discounts(dates_.size());
+    for (Size j = 0; j < dates_.size(); ++j)
+        discounts[j] = curve->discount(cube_->dates()[j]);
+
+    // collect the trades per netting set, the netting set paths are created here so that the map is not modified
+    // while the netting sets are processed
+    struct TradeTask {
+        Size index;
+        string tradeId;
+        Date maturity;
+        Date nextBreakDate;
+    };
+    map<string, vector<TradeTask>> nettingSetTrades;
     size_t i = 0;
     for (auto tradeIt = portfolio_->trades().begin(); tradeIt != portfolio_->trades().end(); ++tradeIt, ++i) {
         auto trade = tradeIt->second;
         string tradeId = tradeIt->first;
         string nettingSetId = trade->envelope().nettingSetId();
-        LOG("Aggregate exposure for trade " << tradeId);
         if (nettingSetDefaultValue_.find(nettingSetId) == nettingSetDefaultValue_.end()) {
             nettingSetDefaultValue_[nettingSetId] = vector<vector<Real>>(dates_.size(), vector<Real>(cube_->samples(), 0.0));
             nettingSetCloseOutValue_[nettingSetId] = vector<vector<Real>>(dates_.size(), vector<Real>(cube_->samples(), 0.0));
@@ -109,110 +130,193 @@ void ExposureCalculator::build() {
                 }
             }
         }
+        nettingSetTrades[nettingSetId].push_back({i, tradeId, trade->maturity(), nextBreakDate});
+    }
 
-        Handle<YieldTermStructure> curve = market_->discountCurve(baseCurrency_, configuration_);
-        Real npv0;
-        if (flipViewXVA_) {
-            npv0 = -cube_->getT0(i);
-        } else {
-            npv0 = cube_->getT0(i);
+    // the trades of a netting set are processed by one thread in portfolio order, so that the netting set paths do
+    // not depend on the number of threads
+    vector<const pair<const string, vector<TradeTask>>*> tasks;
+    for (auto const& n : nettingSetTrades)
+        tasks.push_back(&n);
+    vector<TradeExposure> results(portfolio_->size());
+    auto processNettingSet = [this, &tasks, &results, &discounts](const Size t) {
+        for (auto const& trade : tasks[t]->second)
+            results[trade.index] = buildTrade(trade.index, trade.tradeId, tasks[t]->first, trade.maturity,
+                                              trade.nextBreakDate, discounts);
+    };
+    Size nWorkers = std::min<Size>(std::max<Size>(nThreads_, 1), tasks.size());
+    if (nWorkers <= 1) {
+        for (Size t = 0; t < tasks.size(); ++t)
+            processNettingSet(t);
+    } else {
+        LOG("Process " << tasks.size() << " netting sets on " << nWorkers << " threads");
+        std::atomic<Size> next(0);
+        std::vector<std::exception_ptr> errors(nWorkers);
+        std::vector<std::thread> workers;
+        for (Size w = 0; w < nWorkers; ++w) {
+            workers.emplace_back([&, w]() {
+                try {
+                    for (Size t = next++; t < tasks.size(); t = next++)
+                        processNettingSet(t);
+                } catch (...) {
+                    errors[w] = std::current_exception();
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        for (const auto& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
         }
-        vector<Real> epe(dates_.size() + 1, 0.0);
-        vector<Real> ene(dates_.size() + 1, 0.0);
-        vector<Real> ee_b(dates_.size() + 1, 0.0);
-        vector<Real> eee_b(dates_.size() + 1, 0.0);
-        vector<Real> pfe(dates_.size() + 1, 0.0);
-        epe[0] = std::max(npv0, 0.0);
-        ene[0] = std::max(-npv0, 0.0);
-        ee_b[0] = epe[0];
-        eee_b[0] = ee_b[0];
-        pfe[0] = std::max(npv0, 0.0);
-        exposureCube_->setT0(epe[0], tradeId, ExposureIndex::EPE);
-        exposureCube_->setT0(ene[0], tradeId, ExposureIndex::ENE);
-        for (Size j = 0; j < dates_.size(); ++j) {
-            Date d = cube_->dates()[j];
-            vector<Real> distribution(cube_->samples(), 0.0);
-            for (Size k = 0; k < cube_->samples(); ++k) {
-                // RL 2020-07-17
-                // 1) If the calculation type is set to NoLag:
-                //    Collateral balances are NOT delayed by the MPoR, but we use the close-out NPV.
-                // 2) Otherwise:
-                //    Collateral balances are delayed by the MPoR (if possible, i.e. the valuation
-                //    grid has MPoR spacing), and we use the default date NPV.
-                //    This is the treatment in the ORE releases up to June 2020).
-                Real defaultValue =
-                    d > nextBreakDate && exerciseNextBreak_ ? 0.0 : cubeInterpretation_->getDefaultNpv(cube_, i, j, k);
-                Real closeOutValue;
-                if (isRegularCubeStorage_ && j == dates_.size() - 1)
-                    closeOutValue = defaultValue;
-                else
-                    closeOutValue = d > nextBreakDate && exerciseNextBreak_
-                                        ? 0.0
-                                        : cubeInterpretation_->getCloseOutNpv(cube_, i, j, k);
-
-                Real positiveCashFlow = cubeInterpretation_->getMporPositiveFlows(cube_, i, j, k);
-                Real negativeCashFlow = cubeInterpretation_->getMporNegativeFlows(cube_, i, j, k);
-                //for single trade exposures, always default value is relevant
-                Real npv = defaultValue;
-                epe[j + 1] += max(npv, 0.0) / cube_->samples();
-                ene[j + 1] += max(-npv, 0.0) / cube_->samples();
-                nettingSetDefaultValue_[nettingSetId][j][k] += defaultValue;
-                nettingSetCloseOutValue_[nettingSetId][j][k] += closeOutValue;
-                nettingSetMporPositiveFlow_[nettingSetId][j][k] += positiveCashFlow;
-                nettingSetMporNegativeFlow_[nettingSetId][j][k] += negativeCashFlow;
+    }
+
+    i = 0;
+    for (auto tradeIt = portfolio_->trades().begin(); tradeIt != portfolio_->trades().end(); ++tradeIt, ++i) {
+        const string& tradeId = tradeIt->first;
+        ee_b_[tradeId] = std::move(results[i].ee_b);
+        eee_b_[tradeId] = std::move(results[i].eee_b);
+        pfe_[tradeId] = std::move(results[i].pfe);
+        epe_b_[tradeId] = results[i].epe_b;
+        eepe_b_[tradeId] = results[i].eepe_b;
+    }
+}
+
+ExposureCalculator::TradeExposure ExposureCalculator::buildTrade(const Size i, const string& tradeId,
+                                                                 const string& nettingSetId, const Date& tradeMaturity,
+                                                                 const Date& nextBreakDate,
+                                                                 const vector<Real>& discounts) {
+    LOG("Aggregate exposure for trade " << tradeId);
+    // resolve the netting set once per trade, so that the sample loop below streams over contiguous rows
+    vector<vector<Real>>& nettingSetDefaultValue = nettingSetDefaultValue_.find(nettingSetId)->second;
+    vector<vector<Real>>& nettingSetCloseOutValue = nettingSetCloseOutValue_.find(nettingSetId)->second;
+    vector<vector<Real>>& nettingSetMporPositiveFlow = nettingSetMporPositiveFlow_.find(nettingSetId)->second;
+    vector<vector<Real>>& nettingSetMporNegativeFlow = nettingSetMporNegativeFlow_.find(nettingSetId)->second;
+
+    Real npv0;
+    if (flipViewXVA_) {
+        npv0 = -cube_->getT0(i);
+    } else {
+        npv0 = cube_->getT0(i);
+    }
+    vector<Real> epe(dates_.size() + 1, 0.0);
+    vector<Real> ene(dates_.size() + 1, 0.0);
+    vector<Real> ee_b(dates_.size() + 1, 0.0);
+    vector<Real> eee_b(dates_.size() + 1, 0.0);
+    vector<Real> pfe(dates_.size() + 1, 0.0);
+    epe[0] = std::max(npv0, 0.0);
+    ene[0] = std::max(-npv0, 0.0);
+    ee_b[0] = epe[0];
+    eee_b[0] = ee_b[0];
+    pfe[0] = std::max(npv0, 0.0);
+    // the exposure cube has the same ids as the portfolio, i.e. the trade has index i in it
+    exposureCube_->setT0(epe[0], i, ExposureIndex::EPE);
+    exposureCube_->setT0(ene[0], i, ExposureIndex::ENE);
+    for (Size j = 0; j < dates_.size(); ++j) {
+        Date d = cube_->dates()[j];
+        vector<Real> distribution(streaming_ ? 0 : cube_->samples(), 0.0);
+        QuantExt::P2QuantileEstimator pfeEstimator(quantile_);
+        vector<Real>& defaultValues = nettingSetDefaultValue[j];
+        vector<Real>& closeOutValues = nettingSetCloseOutValue[j];
+        vector<Real>& mporPositiveFlows = nettingSetMporPositiveFlow[j];
+        vector<Real>& mporNegativeFlows = nettingSetMporNegativeFlow[j];
+        for (Size k = 0; k < cube_->samples(); ++k) {
+            // RL 2020-07-17
+            // 1) If the calculation type is set to NoLag:
+            //    Collateral balances are NOT delayed by the MPoR, but we use the close-out NPV.
+            // 2) Otherwise:
+            //    Collateral balances are delayed by the MPoR (if possible, i.e. the valuation
+            //    grid has MPoR spacing), and we use the default date NPV.
+            //    This is the treatment in the ORE releases up to June 2020).
+            Real defaultValue =
+                d > nextBreakDate && exerciseNextBreak_ ? 0.0 : cubeInterpretation_->getDefaultNpv(cube_, i, j, k);
+            Real closeOutValue;
+            if (isRegularCubeStorage_ && j == dates_.size() - 1)
+                closeOutValue = defaultValue;
+            else
+                closeOutValue = d > nextBreakDate && exerciseNextBreak_
+                                    ? 0.0
+                                    : cubeInterpretation_->getCloseOutNpv(cube_, i, j, k);
+
+            Real positiveCashFlow = cubeInterpretation_->getMporPositiveFlows(cube_, i, j, k);
+            Real negativeCashFlow = cubeInterpretation_->getMporNegativeFlows(cube_, i, j, k);
+            //for single trade exposures, always default value is relevant
+            Real npv = defaultValue;
+            epe[j + 1] += max(npv, 0.0) / cube_->samples();
+            ene[j + 1] += max(-npv, 0.0) / cube_->samples();
+            defaultValues[k] += defaultValue;
+            closeOutValues[k] += closeOutValue;
+            mporPositiveFlows[k] += positiveCashFlow;
+            mporNegativeFlows[k] += negativeCashFlow;
+            if (streaming_)
+                pfeEstimator.add(npv);
+            else
                 distribution[k] = npv;
-                if (multiPath_) {
-                    exposureCube_->set(max(npv, 0.0), tradeId, d, k, ExposureIndex::EPE);
-                    exposureCube_->set(max(-npv, 0.0), tradeId, d, k, ExposureIndex::ENE);
-                }
-            }
-            if (!multiPath_) {
-                exposureCube_->set(epe[j + 1], tradeId, d, 0, ExposureIndex::EPE);
-                exposureCube_->set(ene[j + 1], tradeId, d, 0, ExposureIndex::ENE);
+            if (multiPath_) {
+                exposureCube_->set(max(npv, 0.0), i, j, k, ExposureIndex::EPE);
+                exposureCube_->set(max(-npv, 0.0), i, j, k, ExposureIndex::ENE);
             }
-            ee_b[j + 1] = epe[j + 1] / curve->discount(cube_->dates()[j]);
-            eee_b[j + 1] = std::max(eee_b[j], ee_b[j + 1]);
+        }
+        if (!multiPath_) {
+            exposureCube_->set(epe[j + 1], i, j, 0, ExposureIndex::EPE);
+            exposureCube_->set(ene[j + 1], i, j, 0, ExposureIndex::ENE);
+        }
+        ee_b[j + 1] = epe[j + 1] / discounts[j];
+        eee_b[j + 1] = std::max(eee_b[j], ee_b[j + 1]);
+        if (streaming_) {
+            pfe[j + 1] = std::max(pfeEstimator.quantile(), 0.0);
+        } else {
             std::sort(distribution.begin(), distribution.end());
             Size index = Size(floor(quantile_ * (cube_->samples() - 1) + 0.5));
             pfe[j + 1] = std::max(distribution[index], 0.0);
         }
-        ee_b_[tradeId] = ee_b;
-        eee_b_[tradeId] = eee_b;
-        pfe_[tradeId] = pfe;
-
-        Real epe_b = 0.0;
-        Real eepe_b = 0.0;
-
-        Size t = 0;
-        Calendar cal = WeekendsOnly();
-        /*The time average in the EEPE calculation is taken over the first year of the exposure evolution
-        (or until maturity if all positions of the netting set mature before one year).
-        This one year point is actually taken to be today+1Y+4D, so that the 1Y point on the dateGrid is always
-        included.
-        This may effect DateGrids with daily data points*/
-        Date maturity = std::min(cal.adjust(today_ + 1 * Years + 4 * Days), trade->maturity());
-        QuantLib::Real maturityTime = dc_.yearFraction(today_, maturity);
-
-        while (t < dates_.size() && times_[t] <= maturityTime)
-            ++t;
-
-        if (t > 0) {
-            vector<double> weights(t);
-            weights[0] = times_[0];
-            for (Size k = 1; k < t; k++)
-                weights[k] = times_[k] - times_[k - 1];
-            double totalWeights = std::accumulate(weights.begin(), weights.end(), 0.0);
-            for (Size k = 0; k < t; k++)
-                weights[k] /= totalWeights;
-
-            for (Size k = 0; k < t; k++) {
-                epe_b += ee_b[k] * weights[k];
-                eepe_b += eee_b[k] * weights[k];
-            }
+    }
+
+    TradeExposure result;
+    result.ee_b = ee_b;
+    result.eee_b = eee_b;
+    result.pfe = pfe;
+
+    Size t = 0;
+    Calendar cal = WeekendsOnly();
+    /*The time average in the EEPE calculation is taken over the first year of the exposure evolution
+    (or until maturity if all positions of the netting set mature before one year).
+    This one year point is actually taken to be today+1Y+4D, so that the 1Y point on the dateGrid is always
+    included.
+    This may effect DateGrids with daily data points*/
+    Date maturity = std::min(cal.adjust(today_ + 1 * Years + 4 * Days), tradeMaturity);
+    QuantLib::Real maturityTime = dc_.yearFraction(today_, maturity);
+
+    while (t < dates_.size() && times_[t] <= maturityTime)
+        ++t;
+
+    if (t > 0) {
+        vector<double> weights(t);
+        weights[0] = times_[0];
+        for (Size k = 1; k < t; k++)
+            weights[k] = times_[k] - times_[k - 1];
+        double totalWeights = std::accumulate(weights.begin(), weights.end(), 0.0);
+        for (Size k = 0; k < t; k++)
+            weights[k] /= totalWeights;
+
+        for (Size k = 0; k < t; k++) {
+            result.epe_b += ee_b[k] * weights[k];
+            result.eepe_b += eee_b[k] * weights[k];
         }
-        epe_b_[tradeId] = epe_b;
-        eepe_b_[tradeId] = eepe_b;
     }
+    return result;
+}
+
+std::tuple<map<string, vector<vector<Real>>>, map<string, vector<vector<Real>>>, map<string, vector<vector<Real>>>,
+           map<string, vector<vector<Real>>>>
+ExposureCalculator::releaseNettingSetPaths() {
+    auto result = std::make_tuple(std::move(nettingSetDefaultValue_), std::move(nettingSetCloseOutValue_),
+                                  std::move(nettingSetMporPositiveFlow_), std::move(nettingSetMporNegativeFlow_));
+    nettingSetDefaultValue_.clear();
+    nettingSetCloseOutValue_.clear();
+    nettingSetMporPositiveFlow_.clear();
+    nettingSetMporNegativeFlow_.clear();
+    return result;
 }
 
 vector<Real> ExposureCalculator::getMeanExposure(const string& tid, ExposureIndex index) {
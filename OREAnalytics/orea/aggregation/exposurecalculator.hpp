@@ -30,6 +30,8 @@
 
 #include <ql/shared_ptr.hpp>
 
+#include <tuple>
+
 namespace ore {
 namespace analytics {
 using namespace QuantLib;
@@ -67,7 +69,11 @@ public:
 	    //! Flag to indicate exposure evaluation with dynamic credit
         const bool multiPath,
         //! Flag to indicate flipped xva calculation
-        const bool flipViewXVA
+        const bool flipViewXVA,
+        //! Flag to estimate the PFE quantile in constant memory per date instead of sorting the samples
+        const bool streaming = false,
+        //! Number of threads processing the netting sets concurrently
+        const Size nThreads = 1
     );
 
     virtual ~ExposureCalculator() {}
@@ -94,6 +100,8 @@ public:
     CollateralExposureHelper::CalculationType calcType() { return calcType_; }
     bool isRegularCubeStorage() { return isRegularCubeStorage_; }
     bool multiPath() { return multiPath_; }
+    bool streaming() { return streaming_; }
+    Size nThreads() { return nThreads_; }
 
     vector<Date> dates() { return dates_; }
     Date today() { return today_; }
@@ -108,6 +116,11 @@ public:
     const map<string, vector<vector<Real>>>& nettingSetCloseOutValue() { return nettingSetCloseOutValue_; }
     const map<string, vector<vector<Real>>>& nettingSetMporPositiveFlow() { return nettingSetMporPositiveFlow_; }
     const map<string, vector<vector<Real>>>& nettingSetMporNegativeFlow() { return nettingSetMporNegativeFlow_; }
+    //! Move the netting set paths out of the calculator, in the order default value, close out value, mpor positive
+    //! and negative flow, the accessors above return empty maps afterwards
+    std::tuple<map<string, vector<vector<Real>>>, map<string, vector<vector<Real>>>,
+               map<string, vector<vector<Real>>>, map<string, vector<vector<Real>>>>
+    releaseNettingSetPaths();
 
     vector<Real> epe(const string& tid) { return getMeanExposure(tid, ExposureIndex::EPE); }
     vector<Real> ene(const string& tid) { return getMeanExposure(tid, ExposureIndex::ENE); }
@@ -130,6 +143,7 @@ protected:
     const Real quantile_;
     const CollateralExposureHelper::CalculationType calcType_;
     const bool multiPath_;
+    const bool streaming_;
     bool isRegularCubeStorage_;
 
     vector<Date> dates_;
@@ -151,6 +165,16 @@ protected:
     map<string, Real> eepe_b_;
     vector<Real> getMeanExposure(const string& tid, ExposureIndex index);
     bool flipViewXVA_;
+    Size nThreads_;
+
+    struct TradeExposure {
+        vector<Real> ee_b, eee_b, pfe;
+        Real epe_b = 0.0, eepe_b = 0.0;
+    };
+    /*! Exposures of the trade with cube index i, its paths are added to the netting set paths. Does not access the
+        market or other thread local singletons, so that the netting sets can be processed concurrently. */
+    TradeExposure buildTrade(const Size i, const string& tradeId, const string& nettingSetId, const Date& tradeMaturity,
+                             const Date& nextBreakDate, const vector<Real>& discounts);
 };
 
 } // namespace analytics
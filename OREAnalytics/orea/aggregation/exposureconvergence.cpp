@@ -0,0 +1,203 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/aggregation/exposureconvergence.hpp>
+
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/to_string.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/math/comparison.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ore {
+namespace analytics {
+
+using QuantLib::Real;
+using QuantLib::Size;
+
+ExposureConvergenceMonitor::ExposureConvergenceMonitor(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+                                                       Real tolerance, Size minSamples, Size npvIndex)
+    : tolerance_(tolerance), minSamples_(std::max<Size>(minSamples, 2)), npvIndex_(npvIndex) {
+    QL_REQUIRE(portfolio, "ExposureConvergenceMonitor: no portfolio given");
+    QL_REQUIRE(tolerance_ > 0.0, "ExposureConvergenceMonitor: tolerance (" << tolerance_ << ") must be positive");
+    for (auto const& [tradeId, trade] : portfolio->trades())
+        tradeNettingSets_[tradeId] = trade->envelope().nettingSetId();
+}
+
+void ExposureConvergenceMonitor::setCvaWeights(const std::string& nettingSet, const std::vector<Real>& weights) {
+    QL_REQUIRE(moments_.empty(), "ExposureConvergenceMonitor: CVA weights must be set before the first samples");
+    cvaWeights_[nettingSet] = weights;
+}
+
+bool ExposureConvergenceMonitor::consume(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size begin, Size end) {
+    if (moments_.empty()) {
+        std::map<std::string, Size> nettingSetIndex;
+        for (auto const& [tradeId, nettingSet] : tradeNettingSets_)
+            nettingSetIndex.insert(std::make_pair(nettingSet, 0));
+        for (auto& [nettingSet, index] : nettingSetIndex) {
+            index = nettingSets_.size();
+            nettingSets_.push_back(nettingSet);
+        }
+        idNettingSet_.resize(cube->numIds());
+        for (auto const& [id, index] : cube->idsAndIndexes()) {
+            auto t = tradeNettingSets_.find(id);
+            QL_REQUIRE(t != tradeNettingSets_.end(), "ExposureConvergenceMonitor: cube id " << id << " not found");
+            idNettingSet_[index] = nettingSetIndex.at(t->second);
+        }
+        moments_.resize(nettingSets_.size());
+        for (Size n = 0; n < nettingSets_.size(); ++n) {
+            moments_[n].sum.resize(cube->numDates(), 0.0);
+            moments_[n].sumSquares.resize(cube->numDates(), 0.0);
+            auto w = cvaWeights_.find(nettingSets_[n]);
+            if (w != cvaWeights_.end()) {
+                QL_REQUIRE(w->second.size() == cube->numDates(), "ExposureConvergenceMonitor: "
+                                                                     << w->second.size() << " CVA weights for netting set "
+                                                                     << w->first << ", expected " << cube->numDates());
+                moments_[n].cvaWeights = w->second;
+            }
+        }
+    }
+
+    std::vector<Real> npv(nettingSets_.size()), cva(nettingSets_.size());
+    for (Size k = begin; k < end; ++k) {
+        std::fill(cva.begin(), cva.end(), 0.0);
+        for (Size j = 0; j < cube->numDates(); ++j) {
+            std::fill(npv.begin(), npv.end(), 0.0);
+            for (Size i = 0; i < cube->numIds(); ++i)
+                npv[idNettingSet_[i]] += cube->get(i, j, k, npvIndex_);
+            for (Size n = 0; n < npv.size(); ++n) {
+                Real e = std::max(npv[n], 0.0);
+                moments_[n].sum[j] += e;
+                moments_[n].sumSquares[j] += e * e;
+                if (!moments_[n].cvaWeights.empty())
+                    cva[n] += moments_[n].cvaWeights[j] * e;
+            }
+        }
+        for (Size n = 0; n < cva.size(); ++n) {
+            moments_[n].cvaSum += cva[n];
+            moments_[n].cvaSumSquares += cva[n] * cva[n];
+        }
+    }
+    samples_ += end - begin;
+
+    if (samples_ < minSamples_ || !converged())
+        return true;
+    LOG("ExposureConvergenceMonitor: EPE profiles of " << nettingSets_.size() << " netting sets converged after "
+                                                       << samples_ << " samples, tolerance " << tolerance_);
+    return false;
+}
+
+bool ExposureConvergenceMonitor::converged() const {
+    if (samples_ < 2)
+        return false;
+    for (auto const& n : nettingSets_) {
+        if (!converged(n))
+            return false;
+    }
+    return true;
+}
+
+bool ExposureConvergenceMonitor::converged(const std::string& nettingSet) const {
+    if (samples_ < 2)
+        return false;
+    std::vector<Real> e = epe(nettingSet), se = epeStandardError(nettingSet);
+    Real maxEpe = e.empty() ? 0.0 : *std::max_element(e.begin(), e.end());
+    for (Size j = 0; j < se.size(); ++j) {
+        if (se[j] > tolerance_ * maxEpe)
+            return false;
+    }
+    return moments(nettingSet).cvaWeights.empty() ||
+           cvaStandardError(nettingSet) <= tolerance_ * std::abs(cva(nettingSet));
+}
+
+Real ExposureConvergenceMonitor::standardError(Real sum, Real sumSquares) const {
+    if (samples_ < 2)
+        return 0.0;
+    Real n = static_cast<Real>(samples_);
+    Real mean = sum / n;
+    Real variance = std::max(sumSquares / n - mean * mean, 0.0) * n / (n - 1.0);
+    return std::sqrt(variance / n);
+}
+
+std::vector<std::string> ExposureConvergenceMonitor::nettingSets() const { return nettingSets_; }
+
+const ExposureConvergenceMonitor::Moments& ExposureConvergenceMonitor::moments(const std::string& nettingSet) const {
+    auto n = std::find(nettingSets_.begin(), nettingSets_.end(), nettingSet);
+    QL_REQUIRE(n != nettingSets_.end(), "ExposureConvergenceMonitor: netting set " << nettingSet << " not found");
+    return moments_[n - nettingSets_.begin()];
+}
+
+std::vector<Real> ExposureConvergenceMonitor::epe(const std::string& nettingSet) const {
+    const Moments& m = moments(nettingSet);
+    std::vector<Real> result(m.sum.size(), 0.0);
+    for (Size j = 0; j < result.size(); ++j)
+        result[j] = m.sum[j] / static_cast<Real>(samples_);
+    return result;
+}
+
+std::vector<Real> ExposureConvergenceMonitor::epeStandardError(const std::string& nettingSet) const {
+    const Moments& m = moments(nettingSet);
+    std::vector<Real> result(m.sum.size(), 0.0);
+    for (Size j = 0; j < result.size(); ++j)
+        result[j] = standardError(m.sum[j], m.sumSquares[j]);
+    return result;
+}
+
+Real ExposureConvergenceMonitor::cva(const std::string& nettingSet) const {
+    return samples_ == 0 ? 0.0 : moments(nettingSet).cvaSum / static_cast<Real>(samples_);
+}
+
+Real ExposureConvergenceMonitor::cvaStandardError(const std::string& nettingSet) const {
+    const Moments& m = moments(nettingSet);
+    return standardError(m.cvaSum, m.cvaSumSquares);
+}
+
+void ExposureConvergenceMonitor::exportConvergence(ore::data::Report& report) const {
+    report.addColumn("NettingSetId", std::string())
+        .addColumn("Samples", Size())
+        .addColumn("Converged", std::string())
+        .addColumn("MaxEPE", Real(), 6)
+        .addColumn("MaxEPEStdError", Real(), 6)
+        .addColumn("RelativeEPEStdError", Real(), 6)
+        .addColumn("CVA", Real(), 6)
+        .addColumn("CVAStdError", Real(), 6)
+        .addColumn("RelativeCVAStdError", Real(), 6);
+    for (auto const& n : nettingSets_) {
+        std::vector<Real> e = epe(n), se = epeStandardError(n);
+        Real maxEpe = e.empty() ? 0.0 : *std::max_element(e.begin(), e.end());
+        Real maxSe = se.empty() ? 0.0 : *std::max_element(se.begin(), se.end());
+        Real c = cva(n), cse = cvaStandardError(n);
+        report.next()
+            .add(n)
+            .add(samples_)
+            .add(ore::data::to_string(converged(n)))
+            .add(maxEpe)
+            .add(maxSe)
+            .add(QuantLib::close_enough(maxEpe, 0.0) ? 0.0 : maxSe / maxEpe)
+            .add(c)
+            .add(cse)
+            .add(QuantLib::close_enough(c, 0.0) ? 0.0 : cse / std::abs(c));
+    }
+    report.end();
+}
+
+} // namespace analytics
+} // namespace ore
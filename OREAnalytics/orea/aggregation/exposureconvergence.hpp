@@ -0,0 +1,103 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/aggregation/exposureconvergence.hpp
+    \brief incremental netting set EPE with a convergence criterion
+    \ingroup analytics
+*/
+
+#pragma once
+
+#include <orea/engine/sampleconsumer.hpp>
+
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/report/report.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+//! Monitors the convergence of the netting set EPE profiles while the cube is built
+/*! The monitor accumulates the positive part of the netting set NPVs (the sum of the trade NPVs in the cube at the
+    given depth) by date over the consumed samples. The profile of a netting set is converged if the standard error of
+    the EPE on each date is at most \p tolerance times the maximum EPE of the profile. If CVA weights are given for a
+    netting set, the pathwise CVA is accumulated as well, and the standard error of the CVA must in addition be at most
+    \p tolerance times the CVA. Once at least \p minSamples samples are consumed and all netting sets are converged,
+    consume() returns false, i.e. the simulation stops.
+
+    The EPE is in units of the cube, i.e. deflated by the numeraire, and neither collateral nor close-out lags are
+    taken into account. The monitor only decides when enough samples are simulated, the exposures are computed by the
+    post processor on the computed samples.
+
+    \ingroup analytics
+*/
+class ExposureConvergenceMonitor : public SampleConsumer {
+public:
+    ExposureConvergenceMonitor(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+                               QuantLib::Real tolerance, QuantLib::Size minSamples, QuantLib::Size npvIndex = 0);
+
+    /*! Set the CVA weights of a netting set, i.e. the loss given default times the default probability between the
+        previous and the current cube date, for each cube date. Must be called before the first consume(). */
+    void setCvaWeights(const std::string& nettingSet, const std::vector<QuantLib::Real>& weights);
+
+    bool consume(const QuantLib::ext::shared_ptr<NPVCube>& cube, QuantLib::Size begin, QuantLib::Size end) override;
+
+    //! The number of consumed samples
+    QuantLib::Size samples() const { return samples_; }
+    //! True if all netting set profiles are converged
+    bool converged() const;
+    //! The netting sets
+    std::vector<std::string> nettingSets() const;
+    //! The EPE by date of the netting set over the consumed samples
+    std::vector<QuantLib::Real> epe(const std::string& nettingSet) const;
+    //! The standard error of the EPE by date of the netting set
+    std::vector<QuantLib::Real> epeStandardError(const std::string& nettingSet) const;
+    //! The CVA of the netting set, in units of the cube, 0 if no CVA weights are given
+    QuantLib::Real cva(const std::string& nettingSet) const;
+    //! The standard error of the CVA of the netting set
+    QuantLib::Real cvaStandardError(const std::string& nettingSet) const;
+
+    //! Write the achieved EPE and CVA standard errors by netting set
+    void exportConvergence(ore::data::Report& report) const;
+
+private:
+    struct Moments {
+        std::vector<QuantLib::Real> sum, sumSquares;
+        std::vector<QuantLib::Real> cvaWeights;
+        QuantLib::Real cvaSum = 0.0, cvaSumSquares = 0.0;
+    };
+    const Moments& moments(const std::string& nettingSet) const;
+    bool converged(const std::string& nettingSet) const;
+    QuantLib::Real standardError(QuantLib::Real sum, QuantLib::Real sumSquares) const;
+
+    std::map<std::string, std::string> tradeNettingSets_;
+    std::map<std::string, std::vector<QuantLib::Real>> cvaWeights_;
+    QuantLib::Real tolerance_;
+    QuantLib::Size minSamples_, npvIndex_;
+    QuantLib::Size samples_ = 0;
+    // netting set index by cube id, set on the first call of consume()
+    std::vector<QuantLib::Size> idNettingSet_;
+    std::vector<std::string> nettingSets_;
+    std::vector<Moments> moments_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -20,9 +20,15 @@
 
 #include <ored/portfolio/trade.hpp>
 
+#include <qle/math/p2quantileestimator.hpp>
+
 #include <ql/time/date.hpp>
 #include <ql/time/calendars/weekendsonly.hpp>
 
+#include <atomic>
+#include <exception>
+#include <thread>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -35,30 +41,33 @@ NettedExposureCalculator::NettedExposureCalculator(
     const Real quantile, const CollateralExposureHelper::CalculationType calcType, const bool multiPath,
     const QuantLib::ext::shared_ptr<NettingSetManager>& nettingSetManager,
     const QuantLib::ext::shared_ptr<CollateralBalances>& collateralBalances,
-    const map<string, vector<vector<Real>>>& nettingSetDefaultValue,
-    const map<string, vector<vector<Real>>>& nettingSetCloseOutValue,
-    const map<string, vector<vector<Real>>>& nettingSetMporPositiveFlow,
-    const map<string, vector<vector<Real>>>& nettingSetMporNegativeFlow,
+    map<string, vector<vector<Real>>> nettingSetDefaultValue,
+    map<string, vector<vector<Real>>> nettingSetCloseOutValue,
+    map<string, vector<vector<Real>>> nettingSetMporPositiveFlow,
+    map<string, vector<vector<Real>>> nettingSetMporNegativeFlow,
     const QuantLib::ext::shared_ptr<AggregationScenarioData>& scenarioData,
     const QuantLib::ext::shared_ptr<CubeInterpretation> cubeInterpretation, const bool applyInitialMargin,
     const QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator>& dimCalculator, const bool fullInitialCollateralisation,
     const bool marginalAllocation, const Real marginalAllocationLimit,
     const QuantLib::ext::shared_ptr<NPVCube>& tradeExposureCube, const Size allocatedEpeIndex, const Size allocatedEneIndex,
-    const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode)
+    const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode,
+    const bool streaming, const Size nThreads)
     : portfolio_(portfolio), market_(market), cube_(cube), baseCurrency_(baseCurrency), configuration_(configuration),
       quantile_(quantile), calcType_(calcType), multiPath_(multiPath), nettingSetManager_(nettingSetManager),
       collateralBalances_(collateralBalances),
-      nettingSetDefaultValue_(nettingSetDefaultValue), nettingSetCloseOutValue_(nettingSetCloseOutValue),
-      nettingSetMporPositiveFlow_(nettingSetMporPositiveFlow), nettingSetMporNegativeFlow_(nettingSetMporNegativeFlow),
+      nettingSetDefaultValue_(std::move(nettingSetDefaultValue)),
+      nettingSetCloseOutValue_(std::move(nettingSetCloseOutValue)),
+      nettingSetMporPositiveFlow_(std::move(nettingSetMporPositiveFlow)),
+      nettingSetMporNegativeFlow_(std::move(nettingSetMporNegativeFlow)),
       scenarioData_(scenarioData), cubeInterpretation_(cubeInterpretation), applyInitialMargin_(applyInitialMargin),
       dimCalculator_(dimCalculator), fullInitialCollateralisation_(fullInitialCollateralisation),
       marginalAllocation_(marginalAllocation), marginalAllocationLimit_(marginalAllocationLimit),
       tradeExposureCube_(tradeExposureCube), allocatedEpeIndex_(allocatedEpeIndex),
       allocatedEneIndex_(allocatedEneIndex), flipViewXVA_(flipViewXVA), withMporStickyDate_(withMporStickyDate),
-      mporCashFlowMode_(mporCashFlowMode) {
+      mporCashFlowMode_(mporCashFlowMode), streaming_(streaming), nThreads_(nThreads) {
 
     set<string> nettingSetIds;
-    for (auto nettingSet : nettingSetDefaultValue) {
+    for (auto const& nettingSet : nettingSetDefaultValue_) {
         nettingSetIds.insert(nettingSet.first);
         if (flipViewXVA_) {
             if (nettingSetManager_->get(nettingSet.first)->activeCsaFlag()) {
@@ -93,7 +102,8 @@ void NettedExposureCalculator::build() {
     
     map<string, Real> nettingSetValueToday;
     map<string, Date> nettingSetMaturity;
-    map<string, Size> nettingSetSize;
+    // the cube indices of the trades of each netting set, used for the marginal allocation below
+    map<string, vector<Size>> nettingSetTradeIndices;
     Size cubeIndex = 0;
     for (auto tradeIt = portfolio_->trades().begin(); tradeIt != portfolio_->trades().end(); ++tradeIt, ++cubeIndex) {
         const auto& trade = tradeIt->second;
@@ -115,23 +125,28 @@ void NettedExposureCalculator::build() {
         if (nettingSetValueToday.find(nettingSetId) == nettingSetValueToday.end()) {
             nettingSetValueToday[nettingSetId] = 0.0;
             nettingSetMaturity[nettingSetId] = today;
-            nettingSetSize[nettingSetId] = 0;
         }
 
         nettingSetValueToday[nettingSetId] += npv;
 
         if (trade->maturity() > nettingSetMaturity[nettingSetId])
             nettingSetMaturity[nettingSetId] = trade->maturity();
-        nettingSetSize[nettingSetId]++;
+        nettingSetTradeIndices[nettingSetId].push_back(cubeIndex);
     }
 
     vector<vector<Real>> averagePositiveAllocation(portfolio_->size(), vector<Real>(cube_->dates().size(), 0.0));
     vector<vector<Real>> averageNegativeAllocation(portfolio_->size(), vector<Real>(cube_->dates().size(), 0.0));
 
+    Handle<YieldTermStructure> curve = market_->discountCurve(baseCurrency_, configuration_);
+    vector<Real> discounts(cube_->dates().size());
+    for (Size j = 0; j < cube_->dates().size(); ++j)
+        discounts[j] = curve->discount(cube_->dates()[j]);
+
+    // everything depending on the market is prepared here, the netting sets are then processed concurrently
+    vector<NettingSetTask> tasks(nettingSetDefaultValue_.size());
     Size nettingSetCount = 0;
-    for (auto n : nettingSetDefaultValue_) {
-        string nettingSetId = n.first;
-        vector<vector<Real>> data = n.second;
+    for (auto& n : nettingSetDefaultValue_) {
+        const string& nettingSetId = n.first;
         QuantLib::ext::shared_ptr<NettingSetDefinition> netting = nettingSetManager_->get(nettingSetId);
 
         // retrieve collateral balances object, if possible
@@ -141,29 +156,30 @@ void NettedExposureCalculator::build() {
             DLOG("got collateral balances for netting set " << nettingSetId);
         }
         
-        //only for active CSA and calcType == NoLag close-out value is relevant
-        if (netting->activeCsaFlag() && calcType_ == CollateralExposureHelper::CalculationType::NoLag) 
-            data = nettingSetCloseOutValue_[nettingSetId];
-        
-        vector<vector<Real>> nettingSetMporPositiveFlow = nettingSetMporPositiveFlow_[nettingSetId];
-        vector<vector<Real>> nettingSetMporNegativeFlow = nettingSetMporNegativeFlow_[nettingSetId];
-
-        LOG("Aggregate exposure for netting set " << nettingSetId);
-        // Get the collateral account balance paths for the netting set.
-        // The pointer may remain empty if there is no CSA or if it is inactive.
-        QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>> collateral =
-            collateralPaths(nettingSetId,
-                            nettingSetValueToday[nettingSetId],
-                            nettingSetDefaultValue_[nettingSetId],
-                            nettingSetMaturity[nettingSetId]);
-
-	// Get the CSA index for Eonia Floor calculation below
-        colva_[nettingSetId] = 0.0;
-        collateralFloor_[nettingSetId] = 0.0;
-        string csaIndexName;
+        // only for active CSA and calcType == NoLag close-out value is relevant
+        // the netting set paths are resolved once here, no lookups by netting set id in the date / sample loops below
+        NettingSetTask& task = tasks[nettingSetCount];
+        task.index = nettingSetCount;
+        task.nettingSetId = nettingSetId;
+        task.netting = netting;
+        task.defaultValue = &n.second;
+        task.data = netting->activeCsaFlag() && calcType_ == CollateralExposureHelper::CalculationType::NoLag
+                        ? &nettingSetCloseOutValue_[nettingSetId]
+                        : &n.second;
+        task.closeOutValue = &nettingSetCloseOutValue_[nettingSetId];
+        task.mporPositiveFlow = &nettingSetMporPositiveFlow_[nettingSetId];
+        task.mporNegativeFlow = &nettingSetMporNegativeFlow_[nettingSetId];
+        task.tradeIndices = &nettingSetTradeIndices[nettingSetId];
+        task.valueToday = nettingSetValueToday[nettingSetId];
+        task.maturity = nettingSetMaturity[nettingSetId];
+        // the market data for the collateral account balance paths, which are built with the exposures below
+        task.collateral = collateralInputs(nettingSetId);
+
+        // Get the CSA index for Eonia Floor calculation below
+        string& csaIndexName = task.csaIndexName;
         Handle<IborIndex> csaIndex;
         bool applyInitialMargin = false;
-        CSA::Type initialMarginType = CSA::Bilateral;
+        CSA::Type& initialMarginType = task.initialMarginType;
         if (netting->activeCsaFlag()) {
             csaIndexName = netting->csaDetails()->index();
             if (csaIndexName != "") {
@@ -188,8 +204,8 @@ void NettedExposureCalculator::build() {
         // Retrieve the constant independent amount from the CSA data and the VM balance
         // This is used below to reduce the exposure across all paths and time steps.
         // See below for the conversion to base currency.
-        Real initialVM = 0, initialVMbase = 0;
-        Real initialIM = 0, initialIMbase = 0;
+        Real initialVM = 0, &initialVMbase = task.initialVMbase;
+        Real initialIM = 0, &initialIMbase = task.initialIMbase;
         string csaCurrency = "";
         if (netting->activeCsaFlag() && balance) {
             initialVM = balance->variationMargin();
@@ -205,244 +221,381 @@ void NettedExposureCalculator::build() {
         else {
             DLOG("Netting set " << nettingSetId << ", IA base = VM base = 0");
         }
-        
-        Handle<YieldTermStructure> curve = market_->discountCurve(baseCurrency_, configuration_);
-        vector<Real> epe(cube_->dates().size() + 1, 0.0);
-        vector<Real> ene(cube_->dates().size() + 1, 0.0);
-        vector<Real> ee_b(cube_->dates().size() + 1, 0.0);
-        vector<Real> eee_b(cube_->dates().size() + 1, 0.0);
-        vector<Real> eee_b_kva_1(cube_->dates().size() + 1, 0.0);
-        vector<Real> eee_b_kva_2(cube_->dates().size() + 1, 0.0);
-        vector<Real> eepe_b_kva_1(cube_->dates().size() + 1, 0.0);
-        vector<Real> eepe_b_kva_2(cube_->dates().size() + 1, 0.0);
-        vector<Real> eab(cube_->dates().size() + 1, 0.0);
-        vector<Real> pfe(cube_->dates().size() + 1, 0.0);
-        vector<Real> colvaInc(cube_->dates().size() + 1, 0.0);
-        vector<Real> eoniaFloorInc(cube_->dates().size() + 1, 0.0);
-        Real npv = nettingSetValueToday[nettingSetId];
-        if ((fullInitialCollateralisation_) & (netting->activeCsaFlag())) {
-            // This assumes that the collateral at t=0 is the same as the npv at t=0.
-            epe[0] = 0;
-            ene[0] = 0;
-            pfe[0] = 0;
-        } else {
-            epe[0] = std::max(npv - initialVMbase - initialIMbase, 0.0);
-            ene[0] = std::max(-npv + initialVMbase, 0.0);
-            pfe[0] = std::max(npv - initialVMbase - initialIMbase, 0.0);
+
+        task.dynamicIM =
+            applyInitialMargin && task.collateral.active ? &dimCalculator_->dynamicIM(nettingSetId) : nullptr;
+
+        // the day count fractions of the collateral compounding periods
+        task.dcfs.resize(cube_->dates().size(), 0.0);
+        if (netting->activeCsaFlag()) {
+            DayCounter csaDc = csaIndexName != "" ? csaIndex->dayCounter() : dc;
+            for (Size j = 0; j < cube_->dates().size(); ++j)
+                task.dcfs[j] = csaDc.yearFraction(j > 0 ? cube_->dates()[j - 1] : today, cube_->dates()[j]);
         }
-        // The fullInitialCollateralisation flag doesn't affect the eab, which feeds into the "ExpectedCollateral"
-        // column of the 'exposure_nettingset_*' reports.  We always assume the full collateral here.
-        eab[0] = npv;
-        ee_b[0] = epe[0];
-        eee_b[0] = ee_b[0];
-        nettedCube_->setT0(npv, nettingSetCount);
-        exposureCube_->setT0(epe[0], nettingSetCount, ExposureIndex::EPE);
-        exposureCube_->setT0(ene[0], nettingSetCount, ExposureIndex::ENE);
-
-        for (Size j = 0; j < cube_->dates().size(); ++j) {
-
-            Date date = cube_->dates()[j];
-            Date prevDate = j > 0 ? cube_->dates()[j - 1] : today;
-            vector<Real> distribution(cube_->samples(), 0.0);
-            for (Size k = 0; k < cube_->samples(); ++k) {
-                Real balance = 0.0;
-                if (collateral) {
-                    balance = collateral->at(k)->accountBalance(date);
-                    if (netting->csaDetails()->csaCurrency() != baseCurrency_) {
-                        // Convert from CSACurrency to baseCurrency
-                        double fxRate = scenarioData_->get(j, k, AggregationScenarioDataType::FXSpot,
-                                                           netting->csaDetails()->csaCurrency());
-                        balance *= fxRate;
-                    }
+        nettingSetCount++;
+    }
+
+    // each netting set writes to its own rows of the cubes and of the allocations, the results are stored by netting
+    // set index and written in netting set order below, so that they do not depend on the number of threads
+    vector<NettingSetExposure> results(tasks.size());
+    auto processNettingSet = [&](const Size t) {
+        results[t] = buildNettingSet(tasks[t], today, times, discounts, averagePositiveAllocation,
+                                     averageNegativeAllocation);
+    };
+    Size nWorkers = std::min<Size>(std::max<Size>(nThreads_, 1), tasks.size());
+    if (nWorkers <= 1) {
+        for (Size t = 0; t < tasks.size(); ++t)
+            processNettingSet(t);
+    } else {
+        LOG("Process " << tasks.size() << " netting sets on " << nWorkers << " threads");
+        std::atomic<Size> next(0);
+        std::vector<std::exception_ptr> errors(nWorkers);
+        std::vector<std::thread> workers;
+        for (Size w = 0; w < nWorkers; ++w) {
+            workers.emplace_back([&, w]() {
+                try {
+                    for (Size t = next++; t < tasks.size(); t = next++)
+                        processNettingSet(t);
+                } catch (...) {
+                    errors[w] = std::current_exception();
                 }
-                
-                eab[j + 1] += balance / cube_->samples();
-                
-                Real mporCashFlow = 0;
-                // If ActualDate is active, then the cash flows over mpor can be configured.
-                // Otherwise (StickyDate is active), it is assumed that no cash flow over mpor is paid out.
-                if (!withMporStickyDate_) {
-                    if (mporCashFlowMode_ == MporCashFlowMode::BothPay) {
-                        // in cube generation -actual date- the (+/-) cashflows over mpor are
-                        // payed out, i.e. are not part of the exposure .
-                        mporCashFlow = 0;
-                    } else if (mporCashFlowMode_ == MporCashFlowMode::NonePay) {
-                        // +/- cashflows is to be incorporated in the exposure
-                        mporCashFlow = (nettingSetMporPositiveFlow[j][k] + nettingSetMporNegativeFlow[j][k]);
-                    } else if (mporCashFlowMode_ ==
-                               MporCashFlowMode::WePay) { 
-                        // only positive cash flows (i.e. cp's cashflows) is to be
-                        // incorporated in the exposure, since cp does not pay out cash
-                        // flows
-                        mporCashFlow = nettingSetMporPositiveFlow[j][k];
-                    } else if (mporCashFlowMode_ ==
-                               MporCashFlowMode::TheyPay) { // onyl negative cash flows (i.e. our cashflows)  is to be
-                        // incorporated in the exposure,  ince we do not pay out cash
-                        // flows
-                        mporCashFlow = nettingSetMporNegativeFlow[j][k];
-                    }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        for (const auto& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+    }
+
+    for (Size t = 0; t < tasks.size(); ++t) {
+        const string& nettingSetId = tasks[t].nettingSetId;
+        NettingSetExposure& r = results[t];
+        ee_b_[nettingSetId] = std::move(r.ee_b);
+        eee_b_[nettingSetId] = std::move(r.eee_b);
+        pfe_[nettingSetId] = std::move(r.pfe);
+        colva_[nettingSetId] = r.colva;
+        collateralFloor_[nettingSetId] = r.collateralFloor;
+        expectedCollateral_[nettingSetId] = std::move(r.eab);
+        colvaInc_[nettingSetId] = std::move(r.colvaInc);
+        eoniaFloorInc_[nettingSetId] = std::move(r.eoniaFloorInc);
+        epe_b_[nettingSetId] = r.epe_b;
+        eepe_b_[nettingSetId] = r.eepe_b;
+    }
+
+    if (marginalAllocation_ && !multiPath_) {
+        for (Size i = 0; i < portfolio_->trades().size(); ++i) {
+            for (Size j = 0; j < cube_->dates().size(); ++j) {
+                tradeExposureCube_->set(averagePositiveAllocation[i][j], i, j, 0, allocatedEpeIndex_);
+                tradeExposureCube_->set(averageNegativeAllocation[i][j], i, j, 0, allocatedEneIndex_);
+            }
+        }
+    }
+}
+
+NettedExposureCalculator::NettingSetExposure
+NettedExposureCalculator::buildNettingSet(NettingSetTask& task, const Date& today, const vector<Real>& times,
+                                          const vector<Real>& discounts,
+                                          vector<vector<Real>>& averagePositiveAllocation,
+                                          vector<vector<Real>>& averageNegativeAllocation) {
+    const string& nettingSetId = task.nettingSetId;
+    const QuantLib::ext::shared_ptr<NettingSetDefinition>& netting = task.netting;
+    const vector<vector<Real>>& data = *task.data;
+    const vector<vector<Real>>& nettingSetMporPositiveFlow = *task.mporPositiveFlow;
+    const vector<vector<Real>>& nettingSetMporNegativeFlow = *task.mporNegativeFlow;
+    const vector<Size>& tradeIndices = *task.tradeIndices;
+    const Size tradesInNettingSet = tradeIndices.size();
+    const string& csaIndexName = task.csaIndexName;
+    const CSA::Type initialMarginType = task.initialMarginType;
+    const Real initialVMbase = task.initialVMbase, initialIMbase = task.initialIMbase;
+    const vector<vector<Real>>* dynamicIM = task.dynamicIM;
+    const vector<Real>& dcfs = task.dcfs;
+
+    LOG("Aggregate exposure for netting set " << nettingSetId);
+    // Get the collateral account balance paths for the netting set.
+    // The pointer may remain empty if there is no CSA or if it is inactive.
+    QuantLib::ext::shared_ptr<vector<vector<Real>>> collateral =
+        collateralPaths(nettingSetId, task.collateral, task.valueToday, *task.defaultValue, task.maturity);
+
+    Real colva = 0.0;
+    Real collateralFloor = 0.0;
+    vector<Real> epe(cube_->dates().size() + 1, 0.0);
+    vector<Real> ene(cube_->dates().size() + 1, 0.0);
+    vector<Real> ee_b(cube_->dates().size() + 1, 0.0);
+    vector<Real> eee_b(cube_->dates().size() + 1, 0.0);
+    vector<Real> eee_b_kva_1(cube_->dates().size() + 1, 0.0);
+    vector<Real> eee_b_kva_2(cube_->dates().size() + 1, 0.0);
+    vector<Real> eepe_b_kva_1(cube_->dates().size() + 1, 0.0);
+    vector<Real> eepe_b_kva_2(cube_->dates().size() + 1, 0.0);
+    vector<Real> eab(cube_->dates().size() + 1, 0.0);
+    vector<Real> pfe(cube_->dates().size() + 1, 0.0);
+    vector<Real> colvaInc(cube_->dates().size() + 1, 0.0);
+    vector<Real> eoniaFloorInc(cube_->dates().size() + 1, 0.0);
+    Real npv = task.valueToday;
+    if ((fullInitialCollateralisation_) & (netting->activeCsaFlag())) {
+        // This assumes that the collateral at t=0 is the same as the npv at t=0.
+        epe[0] = 0;
+        ene[0] = 0;
+        pfe[0] = 0;
+    } else {
+        epe[0] = std::max(npv - initialVMbase - initialIMbase, 0.0);
+        ene[0] = std::max(-npv + initialVMbase, 0.0);
+        pfe[0] = std::max(npv - initialVMbase - initialIMbase, 0.0);
+    }
+    // The fullInitialCollateralisation flag doesn't affect the eab, which feeds into the "ExpectedCollateral"
+    // column of the 'exposure_nettingset_*' reports.  We always assume the full collateral here.
+    eab[0] = npv;
+    ee_b[0] = epe[0];
+    eee_b[0] = ee_b[0];
+    nettedCube_->setT0(npv, task.index);
+    exposureCube_->setT0(epe[0], task.index, ExposureIndex::EPE);
+    exposureCube_->setT0(ene[0], task.index, ExposureIndex::ENE);
+
+    // resolve the scenario data keys used in the loop below once
+    Size csaFxSlot = Null<Size>(), csaIndexSlot = Null<Size>(), numeraireSlot = Null<Size>();
+    if (collateral && netting->csaDetails()->csaCurrency() != baseCurrency_)
+        csaFxSlot = scenarioData_->slot(AggregationScenarioDataType::FXSpot, netting->csaDetails()->csaCurrency());
+    if (netting->activeCsaFlag()) {
+        if (csaIndexName != "")
+            csaIndexSlot = scenarioData_->slot(AggregationScenarioDataType::IndexFixing, csaIndexName);
+        numeraireSlot = scenarioData_->slot(AggregationScenarioDataType::Numeraire);
+    }
+
+    for (Size j = 0; j < cube_->dates().size(); ++j) {
+
+        vector<Real> distribution(streaming_ ? 0 : cube_->samples(), 0.0);
+        QuantExt::P2QuantileEstimator pfeEstimator(quantile_);
+        for (Size k = 0; k < cube_->samples(); ++k) {
+            Real balance = 0.0;
+            if (collateral) {
+                balance = (*collateral)[j][k];
+                if (netting->csaDetails()->csaCurrency() != baseCurrency_) {
+                    // Convert from CSACurrency to baseCurrency
+                    double fxRate = scenarioData_->get(j, k, csaFxSlot);
+                    balance *= fxRate;
                 }
-                Real exposure = data[j][k] - balance + mporCashFlow;
-                Real dim = 0.0;
-                if (applyInitialMargin && collateral) { // don't apply initial margin without VM, i.e. inactive CSA
-                    // Initial Margin
-                    // Use IM to reduce exposure
-                    // Size dimIndex = j == 0 ? 0 : j - 1;
-                    Size dimIndex = j;
-                    dim = dimCalculator_->dynamicIM(nettingSetId)[dimIndex][k];
-                    QL_REQUIRE(dim >= 0, "negative DIM for set " << nettingSetId << ", date " << j << ", sample " << k
-                                                                 << ": " << dim);
+            }
+            
+            eab[j + 1] += balance / cube_->samples();
+            
+            Real mporCashFlow = 0;
+            // If ActualDate is active, then the cash flows over mpor can be configured.
+            // Otherwise (StickyDate is active), it is assumed that no cash flow over mpor is paid out.
+            if (!withMporStickyDate_) {
+                if (mporCashFlowMode_ == MporCashFlowMode::BothPay) {
+                    // in cube generation -actual date- the (+/-) cashflows over mpor are
+                    // payed out, i.e. are not part of the exposure .
+                    mporCashFlow = 0;
+                } else if (mporCashFlowMode_ == MporCashFlowMode::NonePay) {
+                    // +/- cashflows is to be incorporated in the exposure
+                    mporCashFlow = (nettingSetMporPositiveFlow[j][k] + nettingSetMporNegativeFlow[j][k]);
+                } else if (mporCashFlowMode_ ==
+                           MporCashFlowMode::WePay) { 
+                    // only positive cash flows (i.e. cp's cashflows) is to be
+                    // incorporated in the exposure, since cp does not pay out cash
+                    // flows
+                    mporCashFlow = nettingSetMporPositiveFlow[j][k];
+                } else if (mporCashFlowMode_ ==
+                           MporCashFlowMode::TheyPay) { // onyl negative cash flows (i.e. our cashflows)  is to be
+                    // incorporated in the exposure,  ince we do not pay out cash
+                    // flows
+                    mporCashFlow = nettingSetMporNegativeFlow[j][k];
                 }
-                Real dim_epe = 0;
-                Real dim_ene = 0;
-                if (initialMarginType != CSA::Type::PostOnly)
-                    dim_epe = dim;
-                if (initialMarginType != CSA::Type::CallOnly)
-                    dim_ene = dim;
-                
-                // dim here represents the held IM, and is expressed as a positive number
-                epe[j + 1] += std::max(exposure - dim_epe, 0.0) / cube_->samples(); 
-                // dim here represents the posted IM, and is expressed as a positive number
-                ene[j + 1] += std::max(-exposure - dim_ene, 0.0) / cube_->samples(); 
+            }
+            Real exposure = data[j][k] - balance + mporCashFlow;
+            Real dim = 0.0;
+            if (dynamicIM) { // don't apply initial margin without VM, i.e. inactive CSA
+                // Initial Margin
+                // Use IM to reduce exposure
+                // Size dimIndex = j == 0 ? 0 : j - 1;
+                Size dimIndex = j;
+                dim = (*dynamicIM)[dimIndex][k];
+                QL_REQUIRE(dim >= 0, "negative DIM for set " << nettingSetId << ", date " << j << ", sample " << k
+                                                             << ": " << dim);
+            }
+            Real dim_epe = 0;
+            Real dim_ene = 0;
+            if (initialMarginType != CSA::Type::PostOnly)
+                dim_epe = dim;
+            if (initialMarginType != CSA::Type::CallOnly)
+                dim_ene = dim;
+            
+            // dim here represents the held IM, and is expressed as a positive number
+            epe[j + 1] += std::max(exposure - dim_epe, 0.0) / cube_->samples(); 
+            // dim here represents the posted IM, and is expressed as a positive number
+            ene[j + 1] += std::max(-exposure - dim_ene, 0.0) / cube_->samples(); 
+            if (streaming_)
+                pfeEstimator.add(exposure - dim_epe);
+            else
                 distribution[k] = exposure - dim_epe;
-                nettedCube_->set(exposure, nettingSetCount, j, k);
-                
-                Real epeIncrement = std::max(exposure - dim_epe, 0.0) / cube_->samples();
-                DLOG("sample " << k << " date " << j << fixed << showpos << setprecision(2)
-                     << ": VM "  << setw(15) << balance
-                     << ": NPV " << setw(15) << data[j][k]
-                     << ": NPV-C " << setw(15) << distribution[k]
-                     << ": EPE " << setw(15) << epeIncrement);
-                
-                if (multiPath_) {
-                    exposureCube_->set(std::max(exposure - dim_epe, 0.0), nettingSetCount, j, k, ExposureIndex::EPE);
-                    exposureCube_->set(std::max(-exposure - dim_ene, 0.0), nettingSetCount, j, k, ExposureIndex::ENE);
-                }
+            nettedCube_->set(exposure, task.index, j, k);
+            
+            Real epeIncrement = std::max(exposure - dim_epe, 0.0) / cube_->samples();
+            DLOG("sample " << k << " date " << j << fixed << showpos << setprecision(2)
+                 << ": VM "  << setw(15) << balance
+                 << ": NPV " << setw(15) << data[j][k]
+                 << ": NPV-C " << setw(15) << exposure - dim_epe
+                 << ": EPE " << setw(15) << epeIncrement);
+            
+            if (multiPath_) {
+                exposureCube_->set(std::max(exposure - dim_epe, 0.0), task.index, j, k, ExposureIndex::EPE);
+                exposureCube_->set(std::max(-exposure - dim_ene, 0.0), task.index, j, k, ExposureIndex::ENE);
+            }
  
-                if (netting->activeCsaFlag()) {
-                    Real indexValue = 0.0;
-                    DayCounter dc = ActualActual(ActualActual::ISDA);
-                    if (csaIndexName != "") {
-                        indexValue = scenarioData_->get(j, k, AggregationScenarioDataType::IndexFixing, csaIndexName);
-                        dc = csaIndex->dayCounter();
-                    }
-                    Real dcf = dc.yearFraction(prevDate, date);
-                    Real collateralSpread = (balance >= 0.0 ? netting->csaDetails()->collatSpreadRcv() : netting->csaDetails()->collatSpreadPay());
-                    Real numeraire = scenarioData_->get(j, k, AggregationScenarioDataType::Numeraire);
-                    Real colvaDelta = -balance * collateralSpread * dcf / numeraire / cube_->samples();
-                    // intuitive floorDelta including collateralSpread would be:
-                    // -balance * (max(indexValue - collateralSpread,0) - (indexValue - collateralSpread)) * dcf /
-                    // samples
-                    Real floorDelta = -balance * std::max(-(indexValue - collateralSpread), 0.0) * dcf / numeraire / cube_->samples();
-                    colvaInc[j + 1] += colvaDelta;
-                    colva_[nettingSetId] += colvaDelta;
-                    eoniaFloorInc[j + 1] += floorDelta;
-                    collateralFloor_[nettingSetId] += floorDelta;
-                }
+            if (netting->activeCsaFlag()) {
+                Real indexValue = 0.0;
+                if (csaIndexName != "")
+                    indexValue = scenarioData_->get(j, k, csaIndexSlot);
+                Real dcf = dcfs[j];
+                Real collateralSpread = (balance >= 0.0 ? netting->csaDetails()->collatSpreadRcv() : netting->csaDetails()->collatSpreadPay());
+                Real numeraire = scenarioData_->get(j, k, numeraireSlot);
+                Real colvaDelta = -balance * collateralSpread * dcf / numeraire / cube_->samples();
+                // intuitive floorDelta including collateralSpread would be:
+                // -balance * (max(indexValue - collateralSpread,0) - (indexValue - collateralSpread)) * dcf /
+                // samples
+                Real floorDelta = -balance * std::max(-(indexValue - collateralSpread), 0.0) * dcf / numeraire / cube_->samples();
+                colvaInc[j + 1] += colvaDelta;
+                colva += colvaDelta;
+                eoniaFloorInc[j + 1] += floorDelta;
+                collateralFloor += floorDelta;
+            }
 
-                if (marginalAllocation_) {
-                    Size i = 0;
-                    for (auto tradeIt = portfolio_->trades().begin(); tradeIt != portfolio_->trades().end();
-                         ++tradeIt, ++i) {
-                        const auto& trade = tradeIt->second;
-                        string nid = trade->envelope().nettingSetId();
-                        if (nid != nettingSetId)
-                            continue;
-                        
-                        Real allocation = 0.0;
-                        if (balance == 0.0)
-                            allocation = cubeInterpretation_->getDefaultNpv(cube_, i, j, k);
-                        // else if (data[j][k] == 0.0)
-                        else if (fabs(data[j][k]) <= marginalAllocationLimit_)
-                            allocation = exposure / nettingSetSize[nid];
+            if (marginalAllocation_) {
+                for (Size i : tradeIndices) {
+                    Real allocation = 0.0;
+                    if (balance == 0.0)
+                        allocation = cubeInterpretation_->getDefaultNpv(cube_, i, j, k);
+                    // else if (data[j][k] == 0.0)
+                    else if (fabs(data[j][k]) <= marginalAllocationLimit_)
+                        allocation = exposure / tradesInNettingSet;
+                    else
+                        allocation = exposure * cubeInterpretation_->getDefaultNpv(cube_, i, j, k) / data[j][k];
+
+                    if (multiPath_) {
+                        if (exposure > 0.0)
+                            tradeExposureCube_->set(allocation, i, j, k, allocatedEpeIndex_);
+                        else
+                            tradeExposureCube_->set(-allocation, i, j, k, allocatedEneIndex_);
+                    } else {
+                        if (exposure > 0.0)
+                            averagePositiveAllocation[i][j] += allocation / cube_->samples();
                         else
-                            allocation = exposure * cubeInterpretation_->getDefaultNpv(cube_, i, j, k) / data[j][k];
-
-                        if (multiPath_) {
-                            if (exposure > 0.0)
-                                tradeExposureCube_->set(allocation, i, j, k, allocatedEpeIndex_);
-                            else
-                                tradeExposureCube_->set(-allocation, i, j, k, allocatedEneIndex_);
-                        } else {
-                            if (exposure > 0.0)
-                                averagePositiveAllocation[i][j] += allocation / cube_->samples();
-                            else
-                                averageNegativeAllocation[i][j] -= allocation / cube_->samples();
-                        }
+                            averageNegativeAllocation[i][j] -= allocation / cube_->samples();
                     }
                 }
             }
-            if (!multiPath_) {
-                exposureCube_->set(epe[j + 1], nettingSetCount, j, 0, ExposureIndex::EPE);
-                exposureCube_->set(ene[j + 1], nettingSetCount, j, 0, ExposureIndex::ENE);
-            }
-            ee_b[j + 1] = epe[j + 1] / curve->discount(cube_->dates()[j]);
-            eee_b[j + 1] = std::max(eee_b[j], ee_b[j + 1]);
+        }
+        if (!multiPath_) {
+            exposureCube_->set(epe[j + 1], task.index, j, 0, ExposureIndex::EPE);
+            exposureCube_->set(ene[j + 1], task.index, j, 0, ExposureIndex::ENE);
+        }
+        ee_b[j + 1] = epe[j + 1] / discounts[j];
+        eee_b[j + 1] = std::max(eee_b[j], ee_b[j + 1]);
+        if (streaming_) {
+            pfe[j + 1] = std::max(pfeEstimator.quantile(), 0.0);
+        } else {
             std::sort(distribution.begin(), distribution.end());
             Size index = Size(floor(quantile_ * (cube_->samples() - 1) + 0.5));
             pfe[j + 1] = std::max(distribution[index], 0.0);
         }
-        ee_b_[nettingSetId] = ee_b;
-        eee_b_[nettingSetId] = eee_b;
-        pfe_[nettingSetId] = pfe;
-        expectedCollateral_[nettingSetId] = eab;
-        colvaInc_[nettingSetId] = colvaInc;
-        eoniaFloorInc_[nettingSetId] = eoniaFloorInc;
-
-        nettingSetCount++;
+    }
 
-        Real epe_b = 0;
-        Real eepe_b = 0;
-
-        Size t = 0;
-        Calendar cal = WeekendsOnly();
-        Date maturity = std::min(cal.adjust(today + 1 * Years + 4 * Days), nettingSetMaturity[nettingSetId]);
-        QuantLib::Real maturityTime = dc.yearFraction(today, maturity);
-
-        while (t < cube_->dates().size() && times[t] <= maturityTime)
-            ++t;
-
-        if (t > 0) {
-            vector<double> weights(t);
-            weights[0] = times[0];
-            for (Size k = 1; k < t; k++)
-                weights[k] = times[k] - times[k - 1];
-            double totalWeights = std::accumulate(weights.begin(), weights.end(), 0.0);
-            for (Size k = 0; k < t; k++)
-                weights[k] /= totalWeights;
-
-            for (Size k = 0; k < t; k++) {
-                epe_b += ee_b[k] * weights[k];
-                eepe_b += eee_b[k] * weights[k];
-            }
+    NettingSetExposure result;
+    result.colva = colva;
+    result.collateralFloor = collateralFloor;
+
+    Size t = 0;
+    Calendar cal = WeekendsOnly();
+    Date maturity = std::min(cal.adjust(today + 1 * Years + 4 * Days), task.maturity);
+    QuantLib::Real maturityTime = ActualActual(ActualActual::ISDA).yearFraction(today, maturity);
+
+    while (t < cube_->dates().size() && times[t] <= maturityTime)
+        ++t;
+
+    if (t > 0) {
+        vector<double> weights(t);
+        weights[0] = times[0];
+        for (Size k = 1; k < t; k++)
+            weights[k] = times[k] - times[k - 1];
+        double totalWeights = std::accumulate(weights.begin(), weights.end(), 0.0);
+        for (Size k = 0; k < t; k++)
+            weights[k] /= totalWeights;
+
+        for (Size k = 0; k < t; k++) {
+            result.epe_b += ee_b[k] * weights[k];
+            result.eepe_b += eee_b[k] * weights[k];
         }
-        epe_b_[nettingSetId] = epe_b;
-        eepe_b_[nettingSetId] = eepe_b;
     }
-                
-    if (marginalAllocation_ && !multiPath_) {
-        for (Size i = 0; i < portfolio_->trades().size(); ++i) {
-            for (Size j = 0; j < cube_->dates().size(); ++j) {
-                tradeExposureCube_->set(averagePositiveAllocation[i][j], i, j, 0, allocatedEpeIndex_);
-                tradeExposureCube_->set(averageNegativeAllocation[i][j], i, j, 0, allocatedEneIndex_);
-            }
-        }
+    result.ee_b = std::move(ee_b);
+    result.eee_b = std::move(eee_b);
+    result.pfe = std::move(pfe);
+    result.eab = std::move(eab);
+    result.colvaInc = std::move(colvaInc);
+    result.eoniaFloorInc = std::move(eoniaFloorInc);
+
+    // in streaming mode the paths of the netting set are not retained after processing
+    if (streaming_) {
+        vector<vector<Real>>().swap(*task.closeOutValue);
+        vector<vector<Real>>().swap(*task.mporPositiveFlow);
+        vector<vector<Real>>().swap(*task.mporNegativeFlow);
+        vector<vector<Real>>().swap(*task.defaultValue);
+    }
+    return result;
+}
+
+NettedExposureCalculator::CollateralInputs
+NettedExposureCalculator::collateralInputs(const string& nettingSetId) {
+
+    CollateralInputs inputs;
+
+    if (!nettingSetManager_->has(nettingSetId) || !nettingSetManager_->get(nettingSetId)->activeCsaFlag()) {
+        LOG("CSA missing or inactive for netting set " << nettingSetId);
+        return inputs;
+    }
+    inputs.active = true;
+
+    QuantLib::ext::shared_ptr<NettingSetDefinition> netting = nettingSetManager_->get(nettingSetId);
+    string csaFxPair = netting->csaDetails()->csaCurrency() + baseCurrency_;
+    if (netting->csaDetails()->csaCurrency() != baseCurrency_)
+        inputs.csaFxRateToday = market_->fxRate(csaFxPair, configuration_)->value();
+    LOG("CSA FX rate for pair " << csaFxPair << " = " << inputs.csaFxRateToday);
+
+    // Don't use Settings::instance().evaluationDate() here, this has moved to simulation end date.
+    Date today = market_->asofDate();
+    string csaIndexName = netting->csaDetails()->index();
+    // avoid thrown errors of the index fixing here on holidays of the index, instead take the preceding date then.
+    if (!market_->iborIndex(csaIndexName, configuration_)->isValidFixingDate(today)) {
+        today = market_->iborIndex(csaIndexName, configuration_)->fixingCalendar().adjust(today, Preceding);
     }
+    inputs.csaRateToday = market_->iborIndex(csaIndexName, configuration_)->fixing(today);
+    LOG("CSA compounding rate for index " << csaIndexName << " = " << setprecision(8) << inputs.csaRateToday << " as of " << today);
+
+    return inputs;
 }
 
-QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>>
+QuantLib::ext::shared_ptr<vector<vector<Real>>>
 NettedExposureCalculator::collateralPaths(
     const string& nettingSetId,
     const Real& nettingSetValueToday,
     const vector<vector<Real>>& nettingSetValue,
     const Date& nettingSetMaturity) {
+    return collateralPaths(nettingSetId, collateralInputs(nettingSetId), nettingSetValueToday, nettingSetValue,
+                           nettingSetMaturity);
+}
 
-    QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>> collateral;
+QuantLib::ext::shared_ptr<vector<vector<Real>>>
+NettedExposureCalculator::collateralPaths(
+    const string& nettingSetId,
+    const CollateralInputs& inputs,
+    const Real& nettingSetValueToday,
+    const vector<vector<Real>>& nettingSetValue,
+    const Date& nettingSetMaturity) {
 
-    if (!nettingSetManager_->has(nettingSetId) || !nettingSetManager_->get(nettingSetId)->activeCsaFlag()) {
-        LOG("CSA missing or inactive for netting set " << nettingSetId);
+    QuantLib::ext::shared_ptr<vector<vector<Real>>> collateral;
+
+    if (!inputs.active)
         return collateral;
-    }
 
     // retrieve collateral balances object, if possible
     QuantLib::ext::shared_ptr<CollateralBalance> balance = nullptr;
@@ -454,20 +607,7 @@ NettedExposureCalculator::collateralPaths(
     LOG("Build collateral account balance paths for netting set " << nettingSetId);
     QuantLib::ext::shared_ptr<NettingSetDefinition> netting = nettingSetManager_->get(nettingSetId);
     string csaFxPair = netting->csaDetails()->csaCurrency() + baseCurrency_;
-    Real csaFxRateToday = 1.0;
-    if (netting->csaDetails()->csaCurrency() != baseCurrency_)
-        csaFxRateToday = market_->fxRate(csaFxPair, configuration_)->value();
-    LOG("CSA FX rate for pair " << csaFxPair << " = " << csaFxRateToday);
-
-    // Don't use Settings::instance().evaluationDate() here, this has moved to simulation end date.
-    Date today = market_->asofDate();
     string csaIndexName = netting->csaDetails()->index();
-    // avoid thrown errors of the index fixing here on holidays of the index, instead take the preceding date then.
-    if (!market_->iborIndex(csaIndexName, configuration_)->isValidFixingDate(today)) {
-        today = market_->iborIndex(csaIndexName, configuration_)->fixingCalendar().adjust(today, Preceding);
-    }
-    Real csaRateToday = market_->iborIndex(csaIndexName, configuration_)->fixing(today);
-    LOG("CSA compounding rate for index " << csaIndexName << " = " << setprecision(8) << csaRateToday << " as of " << today);
 
     // Copy scenario data to keep the collateral exposure helper unchanged
     vector<vector<Real>> csaScenFxRates(cube_->dates().size(), vector<Real>(cube_->samples(), 0.0));
@@ -494,19 +634,19 @@ NettedExposureCalculator::collateralPaths(
         }
     }
 
-    collateral = CollateralExposureHelper::collateralBalancePaths(
+    collateral = QuantLib::ext::make_shared<vector<vector<Real>>>(CollateralExposureHelper::collateralBalances(
         netting,              // this netting set's definition
         nettingSetValueToday, // today's netting set NPV
         market_->asofDate(),  // original evaluation date
         nettingSetValue,      // matrix of netting set values by date and sample
         nettingSetMaturity,   // netting set's maximum maturity date
         cube_->dates(),               // vector of future evaluation dates
-        csaFxRateToday,       // today's FX rate for CSA to base currency, possibly 1
+        inputs.csaFxRateToday, // today's FX rate for CSA to base currency, possibly 1
         csaScenFxRates,       // matrix of fx rates by date and sample, possibly 1
-        csaRateToday,         // today's collateral compounding rate in CSA currency
+        inputs.csaRateToday,  // today's collateral compounding rate in CSA currency
         csaScenRates,         // matrix of CSA ccy short rates by date and sample
         calcType_,
-        balance);             // initial collateral balances (VM, IM, IA) for the netting set
+        balance));            // initial collateral balances (VM, IM, IA) for the netting set
     LOG("Collateral account balance paths for netting set " << nettingSetId << " done");
 
     return collateral;
@@ -50,17 +50,21 @@ public:
         const Real quantile, const CollateralExposureHelper::CalculationType calcType, const bool multiPath,
         const QuantLib::ext::shared_ptr<NettingSetManager>& nettingSetManager,
         const QuantLib::ext::shared_ptr<CollateralBalances>& collateralBalances,
-        const map<string, vector<vector<Real>>>& nettingSetDefaultValue,
-        const map<string, vector<vector<Real>>>& nettingSetCloseOutValue,
-        const map<string, vector<vector<Real>>>& nettingSetMporPositiveFlow,
-        const map<string, vector<vector<Real>>>& nettingSetMporNegativeFlow,
+        map<string, vector<vector<Real>>> nettingSetDefaultValue,
+        map<string, vector<vector<Real>>> nettingSetCloseOutValue,
+        map<string, vector<vector<Real>>> nettingSetMporPositiveFlow,
+        map<string, vector<vector<Real>>> nettingSetMporNegativeFlow,
         const QuantLib::ext::shared_ptr<AggregationScenarioData>& scenarioData,
         const QuantLib::ext::shared_ptr<CubeInterpretation> cubeInterpretation, const bool applyInitialMargin,
         const QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator>& dimCalculator, const bool fullInitialCollateralisation,
         // Marginal Allocation
         const bool marginalAllocation, const Real marginalAllocationLimit,
         const QuantLib::ext::shared_ptr<NPVCube>& tradeExposureCube, const Size allocatedEpeIndex, const Size allocatedEneIndex,
-        const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode);
+        const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode,
+        // Estimate the PFE in constant memory and release the netting set paths once processed
+        const bool streaming = false,
+        // Number of threads processing the netting sets concurrently
+        const Size nThreads = 1);
 
     virtual ~NettedExposureCalculator() {}
     const QuantLib::ext::shared_ptr<NPVCube>& exposureCube() { return exposureCube_; }
@@ -137,14 +141,64 @@ protected:
     map<string, Real> collateralFloor_;
     vector<Real> getMeanExposure(const string& tid, ExposureIndex index);
 
-    QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>>
+    // collateral balances by date and sample, null if there is no active CSA
+    QuantLib::ext::shared_ptr<vector<vector<Real>>>
     collateralPaths(const string& nettingSetId,
         const Real& nettingSetValueToday,
         const vector<vector<Real>>& nettingSetValue,
         const Date& nettingSetMaturity);
 
+    // the market data needed for the collateral balance paths of a netting set
+    struct CollateralInputs {
+        bool active = false;
+        Real csaFxRateToday = 1.0;
+        Real csaRateToday = 0.0;
+    };
+    CollateralInputs collateralInputs(const string& nettingSetId);
+    // as above, does not access the market
+    QuantLib::ext::shared_ptr<vector<vector<Real>>>
+    collateralPaths(const string& nettingSetId,
+        const CollateralInputs& inputs,
+        const Real& nettingSetValueToday,
+        const vector<vector<Real>>& nettingSetValue,
+        const Date& nettingSetMaturity);
+
     bool withMporStickyDate_;
     MporCashFlowMode mporCashFlowMode_;
+    bool streaming_;
+    Size nThreads_;
+
+    // the inputs of a netting set, prepared serially since they depend on the market
+    struct NettingSetTask {
+        Size index = 0;
+        string nettingSetId;
+        QuantLib::ext::shared_ptr<NettingSetDefinition> netting;
+        vector<vector<Real>>* defaultValue = nullptr;
+        const vector<vector<Real>>* data = nullptr;
+        vector<vector<Real>>* closeOutValue = nullptr;
+        vector<vector<Real>>* mporPositiveFlow = nullptr;
+        vector<vector<Real>>* mporNegativeFlow = nullptr;
+        const vector<Size>* tradeIndices = nullptr;
+        Real valueToday = 0.0;
+        Date maturity;
+        CollateralInputs collateral;
+        string csaIndexName;
+        CSA::Type initialMarginType = CSA::Bilateral;
+        Real initialVMbase = 0.0, initialIMbase = 0.0;
+        const vector<vector<Real>>* dynamicIM = nullptr;
+        // day count fractions of the collateral compounding periods by date
+        vector<Real> dcfs;
+    };
+    struct NettingSetExposure {
+        vector<Real> ee_b, eee_b, pfe, eab, colvaInc, eoniaFloorInc;
+        Real colva = 0.0, collateralFloor = 0.0, epe_b = 0.0, eepe_b = 0.0;
+    };
+    /*! Exposures of one netting set, fills its rows of the netted and exposure cubes and the allocations of its
+        trades, so that distinct netting sets can be processed concurrently */
+    NettingSetExposure buildNettingSet(NettingSetTask& task, const Date& today, const vector<Real>& times,
+                                       const vector<Real>& discounts,
+                                       vector<vector<Real>>& averagePositiveAllocation,
+                                       vector<vector<Real>>& averageNegativeAllocation);
 };
 
 } // namespace analytics
@@ -25,6 +25,7 @@
 #include <orea/aggregation/staticcreditxvacalculator.hpp>
 #include <orea/aggregation/cvaspreadsensitivitycalculator.hpp>
 #include <ored/utilities/log.hpp>
+#include <ored/utilities/timers.hpp>
 #include <ored/utilities/vectorutils.hpp>
 #include <ql/errors.hpp>
 #include <ql/time/calendars/weekendsonly.hpp>
@@ -67,7 +68,8 @@ PostProcess::PostProcess(
     const string& flipViewLendingCurvePostfix,
     const QuantLib::ext::shared_ptr<CreditSimulationParameters>& creditSimulationParameters,
     const std::vector<Real>& creditMigrationDistributionGrid, const std::vector<Size>& creditMigrationTimeSteps,
-    const Matrix& creditStateCorrelationMatrix, bool withMporStickyDate, MporCashFlowMode mporCashFlowMode)
+    const Matrix& creditStateCorrelationMatrix, bool withMporStickyDate, MporCashFlowMode mporCashFlowMode,
+    const bool streamingExposure, const Size nThreads)
 : portfolio_(portfolio), nettingSetManager_(nettingSetManager), collateralBalances_(collateralBalances),
       market_(market), configuration_(configuration),
       cube_(cube), cptyCube_(cptyCube), scenarioData_(scenarioData), analytics_(analytics), baseCurrency_(baseCurrency),
@@ -81,7 +83,10 @@ PostProcess::PostProcess(
       creditSimulationParameters_(creditSimulationParameters),
       creditMigrationDistributionGrid_(creditMigrationDistributionGrid),
       creditMigrationTimeSteps_(creditMigrationTimeSteps), creditStateCorrelationMatrix_(creditStateCorrelationMatrix),
-      withMporStickyDate_(withMporStickyDate), mporCashFlowMode_(mporCashFlowMode) {
+      withMporStickyDate_(withMporStickyDate), mporCashFlowMode_(mporCashFlowMode),
+      streamingExposure_(streamingExposure), nThreads_(nThreads) {
+
+    ORE_TIMER("post processing");
 
     QL_REQUIRE(cubeInterpretation_ != nullptr, "PostProcess: cubeInterpretation is not given.");
 
@@ -175,7 +180,8 @@ PostProcess::PostProcess(
         QuantLib::ext::make_shared<ExposureCalculator>(
             portfolio, cube_, cubeInterpretation_,
             market_, analytics_["exerciseNextBreak"], baseCurrency_, configuration_,
-            quantile_, calcType_, analytics_["dynamicCredit"], analytics_["flipViewXVA"]
+            quantile_, calcType_, analytics_["dynamicCredit"], analytics_["flipViewXVA"], streamingExposure_,
+            nThreads_
         );
     exposureCalculator_->build();
 
@@ -192,15 +198,26 @@ PostProcess::PostProcess(
      *    Michael Pykhtin & Dan Rosen, Pricing Counterparty Risk
      *    at the Trade Level and CVA Allocations, October 2010
      */
+    // when streaming, the netting set paths are moved to the netted exposure calculator instead of copied
+    map<string, vector<vector<Real>>> defaultValue, closeOutValue, mporPositiveFlow, mporNegativeFlow;
+    if (streamingExposure_) {
+        std::tie(defaultValue, closeOutValue, mporPositiveFlow, mporNegativeFlow) =
+            exposureCalculator_->releaseNettingSetPaths();
+    } else {
+        defaultValue = exposureCalculator_->nettingSetDefaultValue();
+        closeOutValue = exposureCalculator_->nettingSetCloseOutValue();
+        mporPositiveFlow = exposureCalculator_->nettingSetMporPositiveFlow();
+        mporNegativeFlow = exposureCalculator_->nettingSetMporNegativeFlow();
+    }
     nettedExposureCalculator_ = QuantLib::ext::make_shared<NettedExposureCalculator>(
         portfolio_, market_, cube_, baseCurrency, configuration_, quantile_, calcType_, analytics_["dynamicCredit"],
-        nettingSetManager_, collateralBalances_, exposureCalculator_->nettingSetDefaultValue(),
-        exposureCalculator_->nettingSetCloseOutValue(), exposureCalculator_->nettingSetMporPositiveFlow(),
-        exposureCalculator_->nettingSetMporNegativeFlow(), scenarioData_, cubeInterpretation_, analytics_["dim"],
+        nettingSetManager_, collateralBalances_, std::move(defaultValue), std::move(closeOutValue),
+        std::move(mporPositiveFlow), std::move(mporNegativeFlow), scenarioData_, cubeInterpretation_, analytics_["dim"],
         dimCalculator_, fullInitialCollateralisation_,
         allocationMethod == ExposureAllocator::AllocationMethod::Marginal, marginalAllocationLimit,
         exposureCalculator_->exposureCube(), ExposureCalculator::allocatedEPE, ExposureCalculator::allocatedENE,
-        analytics_["flipViewXVA"], withMporStickyDate_, mporCashFlowMode_);
+        analytics_["flipViewXVA"], withMporStickyDate_, mporCashFlowMode_, streamingExposure_,
+        nThreads_);
     nettedExposureCalculator_->build();
 
     /********************************************************
@@ -169,7 +169,11 @@ public:
         //! If set to true, cash flows in the margin period of risk are ignored in the collateral modelling
         bool withMporStickyDate = false,
         //! Treatment of cash flows over the margin period of risk
-        const MporCashFlowMode mporCashFlowMode = MporCashFlowMode::Unspecified);
+        const MporCashFlowMode mporCashFlowMode = MporCashFlowMode::Unspecified,
+        //! If set to true, PFE quantiles are estimated in constant memory and netting set paths are released early
+        const bool streamingExposure = false,
+        //! Number of threads processing the netting sets concurrently in the exposure calculations
+        const Size nThreads = 1);
 
     void setDimCalculator(QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator> dimCalculator) {
         dimCalculator_ = dimCalculator;
@@ -381,6 +385,8 @@ protected:
     std::vector<std::vector<Real>> creditMigrationPdf_;
     bool withMporStickyDate_;
     MporCashFlowMode mporCashFlowMode_;
+    bool streamingExposure_;
+    Size nThreads_;
 };
 
 } // namespace analytics
@@ -53,154 +53,102 @@ StaticCreditXvaCalculator::StaticCreditXvaCalculator(
 }
 
 
+const vector<Real>& StaticCreditXvaCalculator::survivalProbabilities(const string& name) {
+    auto it = survivalProbabilities_.find(name);
+    if (it == survivalProbabilities_.end()) {
+        Handle<DefaultProbabilityTermStructure> dts = market_->defaultCurve(name, configuration_)->curve();
+        QL_REQUIRE(!dts.empty(), "Default curve missing for " << name);
+        vector<Real> sp(dates().size() + 1);
+        sp[0] = dts->survivalProbability(asof());
+        for (Size i = 0; i < dates().size(); ++i)
+            sp[i + 1] = dts->survivalProbability(dates()[i]);
+        it = survivalProbabilities_.emplace(name, std::move(sp)).first;
+    }
+    return it->second;
+}
+
+Size StaticCreditXvaCalculator::gridIndex(const Date& d) {
+    if (d == asof())
+        return 0;
+    auto it = dateIndexMap_.find(d);
+    QL_REQUIRE(it != dateIndexMap_.end(), "StaticCreditXvaCalculator: date " << d << " not in the cube date grid");
+    return it->second + 1;
+}
+
 const Real StaticCreditXvaCalculator::calculateCvaIncrement(
     const string& tid, const string& cid, const Date& d0, const Date& d1, const Real& rr) {
-    Handle<DefaultProbabilityTermStructure> dts = market_->defaultCurve(cid, configuration_)->curve();
-    QL_REQUIRE(!dts.empty(), "Default curve missing for counterparty " << cid);
-    Real increment = 0.0;
-    Real s0 = dts->survivalProbability(d0);
-    Real s1 = dts->survivalProbability(d1);
+    const vector<Real>& sp = survivalProbabilities(cid);
     Real epe = tradeExposureCube_->get(tid, d1, 0, tradeEpeIndex_);
-    increment = (1.0 - rr) * (s0 - s1) * epe;
-    return increment;
+    return (1.0 - rr) * (sp[gridIndex(d0)] - sp[gridIndex(d1)]) * epe;
 }
 
 const Real StaticCreditXvaCalculator::calculateDvaIncrement(
     const string& tid, const Date& d0, const Date& d1, const Real& rr) {
-    Handle<DefaultProbabilityTermStructure> dts = market_->defaultCurve(dvaName_, configuration_)->curve();
-    QL_REQUIRE(!dts.empty(), "Default curve missing for dvaName " << dvaName_);
-    Real increment = 0.0;
-    Real s0 = dts->survivalProbability(d0);
-    Real s1 = dts->survivalProbability(d1);
+    const vector<Real>& sp = survivalProbabilities(dvaName_);
     Real ene = tradeExposureCube_->get(tid, d1, 0, tradeEneIndex_);
-    increment = (1.0 - rr) * (s0 - s1) * ene;
-    return increment;
+    return (1.0 - rr) * (sp[gridIndex(d0)] - sp[gridIndex(d1)]) * ene;
 }
 
 const Real StaticCreditXvaCalculator::calculateNettingSetCvaIncrement(
     const string& nid, const string& cid, const Date& d0, const Date& d1, const Real& rr) {
-    Handle<DefaultProbabilityTermStructure> dts = market_->defaultCurve(cid, configuration_)->curve();
-    QL_REQUIRE(!dts.empty(), "Default curve missing for counterparty " << cid);
-    Real increment = 0.0;
-    Real s0 = dts->survivalProbability(d0);
-    Real s1 = dts->survivalProbability(d1);
+    const vector<Real>& sp = survivalProbabilities(cid);
     Real epe = nettingSetExposureCube_->get(nid, d1, 0, nettingSetEpeIndex_);
-    increment = (1.0 - rr) * (s0 - s1) * epe;
-    return increment;
+    return (1.0 - rr) * (sp[gridIndex(d0)] - sp[gridIndex(d1)]) * epe;
 }
 
 const Real StaticCreditXvaCalculator::calculateNettingSetDvaIncrement(
     const string& nid, const Date& d0, const Date& d1, const Real& rr) {
-    Handle<DefaultProbabilityTermStructure> dts = market_->defaultCurve(dvaName_, configuration_)->curve();
-    QL_REQUIRE(!dts.empty(), "Default curve missing for dvaName " << dvaName_);
-    Real increment = 0.0;
-    Real s0 = dts->survivalProbability(d0);
-    Real s1 = dts->survivalProbability(d1);
+    const vector<Real>& sp = survivalProbabilities(dvaName_);
     Real ene = nettingSetExposureCube_->get(nid, d1, 0, nettingSetEneIndex_);
-    increment = (1.0 - rr) * (s0 - s1) * ene;
-    return increment;
+    return (1.0 - rr) * (sp[gridIndex(d0)] - sp[gridIndex(d1)]) * ene;
 }
 
 const Real StaticCreditXvaCalculator::calculateFbaIncrement(
     const string& tid, const string& cid, const string& dvaName,
     const Date& d0, const Date& d1, const Real& dcf) {
-    Handle<DefaultProbabilityTermStructure> dts_cid;
-    Handle<DefaultProbabilityTermStructure> dts_dvaName;
-    if (cid != "") {
-        dts_cid = market_->defaultCurve(cid, configuration_)->curve();
-        QL_REQUIRE(!dts_cid.empty(), "Default curve missing for counterparty " << cid);
-    }
-    if (dvaName != "") {
-        dts_dvaName = market_->defaultCurve(dvaName, configuration_)->curve();
-        QL_REQUIRE(!dts_dvaName.empty(), "Default curve missing for dvaName " << dvaName);
-    }
-
-    Real increment = 0.0;
-    Real s0 = cid == "" ? 1.0 : dts_cid->survivalProbability(d0);
-    Real s1 = dvaName == "" ? 1.0 : dts_dvaName->survivalProbability(d0);
+    Size i0 = gridIndex(d0);
+    Real s0 = cid == "" ? 1.0 : survivalProbabilities(cid)[i0];
+    Real s1 = dvaName == "" ? 1.0 : survivalProbabilities(dvaName)[i0];
     Real ene = tradeExposureCube_->get(tid, d1, 0, tradeEneIndex_);
-    increment = s0 * s1 * ene * dcf;
-    return increment;
+    return s0 * s1 * ene * dcf;
 }
 
 const Real StaticCreditXvaCalculator::calculateFcaIncrement(
     const string& tid, const string& cid, const string& dvaName,
     const Date& d0, const Date& d1, const Real& dcf) {
-    Handle<DefaultProbabilityTermStructure> dts_cid;
-    Handle<DefaultProbabilityTermStructure> dts_dvaName;
-    if (cid != "") {
-        dts_cid = market_->defaultCurve(cid, configuration_)->curve();
-        QL_REQUIRE(!dts_cid.empty(), "Default curve missing for counterparty " << cid);
-    }
-    if (dvaName != "") {
-        dts_dvaName = market_->defaultCurve(dvaName, configuration_)->curve();
-        QL_REQUIRE(!dts_dvaName.empty(), "Default curve missing for dvaName " << dvaName);
-    }
-
-    Real increment = 0.0;
-    Real s0 = cid == "" ? 1.0 : dts_cid->survivalProbability(d0);
-    Real s1 = dvaName == "" ? 1.0 : dts_dvaName->survivalProbability(d0);
+    Size i0 = gridIndex(d0);
+    Real s0 = cid == "" ? 1.0 : survivalProbabilities(cid)[i0];
+    Real s1 = dvaName == "" ? 1.0 : survivalProbabilities(dvaName)[i0];
     Real epe = tradeExposureCube_->get(tid, d1, 0, tradeEpeIndex_);
-    increment = s0 * s1 * epe * dcf;
-    return increment;
+    return s0 * s1 * epe * dcf;
 }
 
 const Real StaticCreditXvaCalculator::calculateNettingSetFbaIncrement(
     const string& nid, const string& cid, const string& dvaName,
     const Date& d0, const Date& d1, const Real& dcf) {
-    Handle<DefaultProbabilityTermStructure> dts_cid;
-    Handle<DefaultProbabilityTermStructure> dts_dvaName;
-    if (cid != "") {
-        dts_cid = market_->defaultCurve(cid, configuration_)->curve();
-        QL_REQUIRE(!dts_cid.empty(), "Default curve missing for counterparty " << cid);
-    }
-    if (dvaName != "") {
-        dts_dvaName = market_->defaultCurve(dvaName, configuration_)->curve();
-        QL_REQUIRE(!dts_dvaName.empty(), "Default curve missing for dvaName " << dvaName);
-    }
-
-    Real increment = 0.0;
-    Real s0 = cid == "" ? 1.0 : dts_cid->survivalProbability(d0);
-    Real s1 = dvaName == "" ? 1.0 : dts_dvaName->survivalProbability(d0);
+    Size i0 = gridIndex(d0);
+    Real s0 = cid == "" ? 1.0 : survivalProbabilities(cid)[i0];
+    Real s1 = dvaName == "" ? 1.0 : survivalProbabilities(dvaName)[i0];
     Real ene = nettingSetExposureCube_->get(nid, d1, 0, nettingSetEneIndex_);
-    increment = s0 * s1 * ene * dcf;
-    return increment;
+    return s0 * s1 * ene * dcf;
 }
 
 const Real StaticCreditXvaCalculator::calculateNettingSetFcaIncrement(
     const string& nid, const string& cid, const string& dvaName,
     const Date& d0, const Date& d1, const Real& dcf) {
-    Handle<DefaultProbabilityTermStructure> dts_cid;
-    Handle<DefaultProbabilityTermStructure> dts_dvaName;
-    if (cid != "") {
-        dts_cid = market_->defaultCurve(cid, configuration_)->curve();
-        QL_REQUIRE(!dts_cid.empty(), "Default curve missing for counterparty " << cid);
-    }
-    if (dvaName != "") {
-        dts_dvaName = market_->defaultCurve(dvaName, configuration_)->curve();
-        QL_REQUIRE(!dts_dvaName.empty(), "Default curve missing for dvaName " << dvaName);
-    }
-
-    Real increment = 0.0;
-    Real s0 = cid == "" ? 1.0 : dts_cid->survivalProbability(d0);
-    Real s1 = dvaName == "" ? 1.0 : dts_dvaName->survivalProbability(d0);
+    Size i0 = gridIndex(d0);
+    Real s0 = cid == "" ? 1.0 : survivalProbabilities(cid)[i0];
+    Real s1 = dvaName == "" ? 1.0 : survivalProbabilities(dvaName)[i0];
     Real epe = nettingSetExposureCube_->get(nid, d1, 0, nettingSetEpeIndex_);
-    increment = s0 * s1 * epe * dcf;
-    return increment;
+    return s0 * s1 * epe * dcf;
 }
 
 const Real StaticCreditXvaCalculator::calculateNettingSetMvaIncrement(
     const string& nid, const string& cid, const Date& d0, const Date& d1, const Real& dcf) {
-    Handle<DefaultProbabilityTermStructure> dts_cid = market_->defaultCurve(cid, configuration_)->curve();
-    QL_REQUIRE(cid == "" || !dts_cid.empty(), "Default curve missing for counterparty " << cid);
-    Handle<DefaultProbabilityTermStructure> dts_dvaName = market_->defaultCurve(dvaName_, configuration_)->curve();
-    QL_REQUIRE(dvaName_ == "" || !dts_dvaName.empty(), "Default curve missing for dvaName " << dvaName_);
-
-    Real increment = 0.0;
-    Real s0 = cid == "" ? 1.0 : dts_cid->survivalProbability(d0);
-    Real s1 = dvaName_ == "" ? 1.0 : dts_dvaName->survivalProbability(d0);
-    increment = s0 * s1 * dimCalculator_->expectedIM(nid)[dateIndexMap_[d1]] * dcf;
-    return increment;
+    Size i0 = gridIndex(d0);
+    Real s0 = cid == "" ? 1.0 : survivalProbabilities(cid)[i0];
+    Real s1 = dvaName_ == "" ? 1.0 : survivalProbabilities(dvaName_)[i0];
+    return s0 * s1 * dimCalculator_->expectedIM(nid)[gridIndex(d1) - 1] * dcf;
 }
 
 } // namespace analytics
@@ -96,7 +96,13 @@ public:
                                                        const Date& d0, const Date& d1, const Real& dcf) override;
 
 protected:
+    //! Survival probabilities of the given name on today and the cube dates, the curve is evaluated once per name
+    const vector<Real>& survivalProbabilities(const string& name);
+    //! Index of today (0) or a cube date in the survival probability grid
+    Size gridIndex(const Date& d);
+
     map<Date, Size> dateIndexMap_; // cache for performance
+    map<string, vector<Real>> survivalProbabilities_;
 };
 
 } // namespace analytics
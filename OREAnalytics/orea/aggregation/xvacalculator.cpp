@@ -278,6 +278,23 @@ void ValueAdjustmentCalculator::build() {
     if (baseCurrency_ != "")
         oisCurve = market_->discountCurve(baseCurrency_, configuration_);
 
+    // the funding spread accrual factors by date, the curves are evaluated once per funding curve and not per trade
+    map<string, vector<Real>> fundingDcfs;
+    auto fundingDcf = [this, &fundingDcfs, &oisCurve, numDates,
+                       today](const string& name, const Handle<YieldTermStructure>& curve) -> const vector<Real>& {
+        auto it = fundingDcfs.find(name);
+        if (it == fundingDcfs.end()) {
+            vector<Real> dcf(numDates);
+            for (Size j = 0; j < numDates; ++j) {
+                Date d0 = j == 0 ? today : dates()[j - 1];
+                Date d1 = dates()[j];
+                dcf[j] = curve->discount(d0) / curve->discount(d1) - oisCurve->discount(d0) / oisCurve->discount(d1);
+            }
+            it = fundingDcfs.emplace(name, std::move(dcf)).first;
+        }
+        return it->second;
+    };
+
     string origDvaName = dvaName_;
     // Trade XVA
     for (const auto& [tid, trade] : portfolio_->trades()) {
@@ -308,6 +325,11 @@ void ValueAdjustmentCalculator::build() {
             if (dvaName_ != "")
                 dvaRR = market_->recoveryRate(dvaName_, configuration_)->value();
 
+            const vector<Real>* borrowingDcf =
+                borrowingCurve.empty() ? nullptr : &fundingDcf(fvaBorrowingCurve_, borrowingCurve);
+            const vector<Real>* lendingDcf =
+                lendingCurve.empty() ? nullptr : &fundingDcf(fvaLendingCurve_, lendingCurve);
+
             tradeCva_[tid] = 0.0;
             tradeDva_[tid] = 0.0;
             tradeFca_[tid] = 0.0;
@@ -328,9 +350,8 @@ void ValueAdjustmentCalculator::build() {
                 tradeDva_[tid] += dvaIncrement;
 
                 // FCA
-                if (!borrowingCurve.empty()) {
-                    Real dcf = borrowingCurve->discount(d0) / borrowingCurve->discount(d1) -
-                               oisCurve->discount(d0) / oisCurve->discount(d1);
+                if (borrowingDcf) {
+                    Real dcf = (*borrowingDcf)[j];
                     Real fcaIncrement = calculateFcaIncrement(tid, cid, dvaName_, d0, d1, dcf);
                     Real fcaIncrement_exOwnSP = calculateFcaIncrement(tid, cid, "", d0, d1, dcf);
                     Real fcaIncrement_exAllSP = calculateFcaIncrement(tid, "", "", d0, d1, dcf);
@@ -340,9 +361,8 @@ void ValueAdjustmentCalculator::build() {
                 }
 
                 // FBA
-                if (!lendingCurve.empty()) {
-                    Real dcf = lendingCurve->discount(d0) / lendingCurve->discount(d1) -
-                               oisCurve->discount(d0) / oisCurve->discount(d1);
+                if (lendingDcf) {
+                    Real dcf = (*lendingDcf)[j];
                     Real fbaIncrement = calculateFbaIncrement(tid, cid, dvaName_, d0, d1, dcf);
                     Real fbaIncrement_exOwnSP = calculateFbaIncrement(tid, cid, "", d0, d1, dcf);
                     Real fbaIncrement_exAllSP = calculateFbaIncrement(tid, "", "", d0, d1, dcf);
@@ -393,6 +413,11 @@ void ValueAdjustmentCalculator::build() {
                 QL_REQUIRE(baseCurrency_ != "", "baseCurrency required for FVA calculation");
             }
 
+            const vector<Real>* borrowingDcf =
+                borrowingCurve.empty() ? nullptr : &fundingDcf(fvaBorrowingCurve_, borrowingCurve);
+            const vector<Real>* lendingDcf =
+                lendingCurve.empty() ? nullptr : &fundingDcf(fvaLendingCurve_, lendingCurve);
+
             nettingSetCva_[nid] = 0.0;
             nettingSetDva_[nid] = 0.0;
             nettingSetFca_[nid] = 0.0;
@@ -412,9 +437,8 @@ void ValueAdjustmentCalculator::build() {
                 nettingSetDva_[nid] += dvaIncrement;
 
                 // FCA
-                if (!borrowingCurve.empty()) {
-                    Real dcf = borrowingCurve->discount(d0) / borrowingCurve->discount(d1) -
-                               oisCurve->discount(d0) / oisCurve->discount(d1);
+                if (borrowingDcf) {
+                    Real dcf = (*borrowingDcf)[j];
                     Real fcaIncrement = calculateNettingSetFcaIncrement(nid, cid, dvaName_, d0, d1, dcf);
                     Real fcaIncrement_exOwnSP = calculateNettingSetFcaIncrement(nid, cid, "", d0, d1, dcf);
                     Real fcaIncrement_exAllSP = calculateNettingSetFcaIncrement(nid, "", "", d0, d1, dcf);
@@ -430,9 +454,8 @@ void ValueAdjustmentCalculator::build() {
                 }
 
                 // FBA
-                if (!lendingCurve.empty()) {
-                    Real dcf = lendingCurve->discount(d0) / lendingCurve->discount(d1) -
-                               oisCurve->discount(d0) / oisCurve->discount(d1);
+                if (lendingDcf) {
+                    Real dcf = (*lendingDcf)[j];
                     Real fbaIncrement = calculateNettingSetFbaIncrement(nid, cid, dvaName_, d0, d1, dcf);
                     Real fbaIncrement_exOwnSP = calculateNettingSetFbaIncrement(nid, cid, "", d0, d1, dcf);
                     Real fbaIncrement_exAllSP = calculateNettingSetFbaIncrement(nid, "", "", d0, d1, dcf);
@@ -184,7 +184,16 @@ void Analytic::buildMarket(const QuantLib::ext::shared_ptr<ore::data::InMemoryLo
     QL_REQUIRE(configurations().curveConfig, "curve configurations not set");
     
     // first build the market if we have a todaysMarketParams
-    if (configurations().todaysMarketParams) {
+    const auto& cache = inputs_->marketCache();
+    MarketCache::Entry cached;
+    if (configurations().todaysMarketParams && cache)
+        cached = cache->get(configurations().asofDate, configurations().todaysMarketParams,
+                            configurations().curveConfig, loader);
+    if (cached.market) {
+        LOG("Reuse the market built by a previous analytic for the same configuration");
+        market_ = cached.market;
+        loader_ = cached.loader;
+    } else if (configurations().todaysMarketParams) {
         try {
             // imply bond spreads (no exclusion of securities in ore, just in ore+) and add results to loader
             auto bondSpreads = implyBondSpreads(configurations().asofDate, inputs_, configurations_.todaysMarketParams,
@@ -201,6 +210,9 @@ void Analytic::buildMarket(const QuantLib::ext::shared_ptr<ore::data::InMemoryLo
                 configurations().asofDate, configurations().todaysMarketParams, loader_, configurations().curveConfig,
                 inputs()->continueOnError(), true, inputs()->lazyMarketBuilding(), inputs()->refDataManager(), false,
                 *inputs()->iborFallbackConfig());
+            if (cache)
+                cache->add(configurations().asofDate, configurations().todaysMarketParams,
+                           configurations().curveConfig, loader, {market_, loader_});
         } catch (const std::exception& e) {
             if (marketRequired)
                 QL_FAIL("Failed to build market: " << e.what());
@@ -226,10 +238,18 @@ void Analytic::buildPortfolio() {
     portfolio_ = QuantLib::ext::make_shared<Portfolio>(inputs()->buildFailedTrades());
 
     tmp->reset();
-    // populate with trades
-    for (const auto& [tradeId, trade] : tmp->trades())
+    // populate with trades, skipping the trades the analytic does not need
+    auto filter = impl()->tradeFilter();
+    Size skipped = 0;
+    for (const auto& [tradeId, trade] : tmp->trades()) {
         // If portfolio was already provided to the analytic, make sure to only process those given trades.
-        portfolio()->add(trade);
+        if (!filter || filter(*trade))
+            portfolio()->add(trade);
+        else
+            ++skipped;
+    }
+    if (skipped > 0)
+        LOG("Skipped " << skipped << " trades not required by analytic " << label());
     
     if (market_) {
         replaceTrades();
@@ -238,6 +258,10 @@ void Analytic::buildPortfolio() {
         QuantLib::ext::shared_ptr<EngineFactory> factory = impl()->engineFactory();
         portfolio()->build(factory, "analytic/" + label());
 
+        auto engineBuilderStatsReport = QuantLib::ext::make_shared<InMemoryReport>();
+        ReportWriter(inputs()->reportNaString()).writeEngineBuilderStats(*engineBuilderStatsReport, factory);
+        reports_["STATS"]["enginebuilderstats"] = engineBuilderStatsReport;
+
         // remove dates that will have matured
         Date maturityDate = inputs()->asof();
         if (inputs()->portfolioFilterDate() != Null<Date>())
@@ -38,6 +38,7 @@
 #include <orea/app/marketcalibrationreport.hpp>
 
 #include <boost/any.hpp>
+#include <functional>
 #include <iostream>
 
 namespace ore {
@@ -109,6 +110,11 @@ public:
     virtual void marketCalibration(const QuantLib::ext::shared_ptr<MarketCalibrationReportBase>& mcr = nullptr);
     virtual void modifyPortfolio() {}
     virtual void replaceTrades() {}
+    /*! True if runAnalytic() only reads the inputs and the loader and builds its own market and portfolio, so that
+        the analytic can run concurrently with other analytics. The analytics manager then hands the analytic its own
+        shallow copy of the inputs and of the portfolio, the loader is shared and must not be modified, since neither
+        InMemoryLoader nor CSVLoader lock on access */
+    virtual bool supportsConcurrentRun() const { return false; }
 
     //! Inspectors
     const std::string label() const;
@@ -186,6 +192,10 @@ public:
     //! build an engine factory
     virtual QuantLib::ext::shared_ptr<ore::data::EngineFactory> engineFactory();
 
+    /*! filter for the trades the analytic needs, trades rejected by the filter are not added to the analytic's
+        portfolio in Analytic::buildPortfolio() and therefore never built, an empty filter keeps all trades */
+    virtual std::function<bool(const ore::data::Trade&)> tradeFilter() const { return {}; }
+
     void setLabel(const string& label) { label_ = label; }
     const std::string& label() const { return label_; };
 
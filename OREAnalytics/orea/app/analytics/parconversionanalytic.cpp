@@ -26,6 +26,9 @@
 #include <orea/scenario/shiftscenariogenerator.hpp>
 #include <ored/utilities/to_string.hpp>
 
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+
 using namespace ore::data;
 using namespace boost::filesystem;
 
@@ -95,7 +98,9 @@ void ParConversionAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore:
 
         simMarket->scenarioGenerator() = scenarioGenerator;
 
-        parAnalysis->computeParInstrumentSensitivities(simMarket);
+        parAnalysis->computeParInstrumentSensitivities(inputs_->nThreads(), simMarket, loader, configs.curveConfig,
+                                                       configs.todaysMarketParams, inputs_->refDataManager(),
+                                                       *inputs_->iborFallbackConfig());
 
         QuantLib::ext::shared_ptr<ParSensitivityConverter> parConverter =
             QuantLib::ext::make_shared<ParSensitivityConverter>(parAnalysis->parSensitivities(), parAnalysis->shiftSizes());
@@ -112,6 +117,48 @@ void ParConversionAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore:
         std::vector<SensitivityRecord> results;
         std::map<RiskFactorKey, std::string> descriptions = getScenarioDescriptions(simMarket->scenarioGenerator());
 
+        // the zero deltas of the valid trades are collected and converted in batches
+
+        constexpr Size batchSize = 100;
+        struct PendingTrade {
+            std::string id;
+            Real baseNpv;
+            std::string currency;
+            boost::numeric::ublas::vector<Real> zeroDeltas;
+            std::vector<SensitivityRecord> excludedDeltas;
+        };
+        std::vector<PendingTrade> pending;
+
+        auto convertPending = [&]() {
+            if (pending.empty())
+                return;
+            boost::numeric::ublas::matrix<Real> zeroDeltas(parConverter->rawKeys().size(), pending.size());
+            for (Size t = 0; t < pending.size(); ++t)
+                boost::numeric::ublas::column(zeroDeltas, t) = pending[t].zeroDeltas;
+            boost::numeric::ublas::matrix<Real> parDeltas = parConverter->convertSensitivities(zeroDeltas);
+            for (Size t = 0; t < pending.size(); ++t) {
+                Size counter = 0;
+                for (const auto& key : parConverter->parKeys()) {
+                    if (!close(parDeltas(counter, t), 0.0)) {
+                        SensitivityRecord sr;
+                        sr.tradeId = pending[t].id;
+                        sr.isPar = true;
+                        sr.key_1 = key;
+                        sr.desc_1 = descriptions[key];
+                        sr.delta = parDeltas(counter, t);
+                        sr.baseNpv = pending[t].baseNpv;
+                        sr.currency = pending[t].currency;
+                        sr.shift_1 = shiftSizes[key].second;
+                        sr.gamma = QuantLib::Null<QuantLib::Real>();
+                        results.push_back(sr);
+                    }
+                    counter++;
+                }
+                results.insert(results.end(), pending[t].excludedDeltas.begin(), pending[t].excludedDeltas.end());
+            }
+            pending.clear();
+        };
+
         for (const auto& [id, sensis] : zeroSensis) {
             boost::numeric::ublas::vector<Real> zeroDeltas(parConverter->rawKeys().size(), 0.0);
             std::vector<SensitivityRecord> excludedDeltas;
@@ -159,27 +206,13 @@ void ParConversionAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore:
                 }
             }
             if (!sensis.empty() && valid) {
-                boost::numeric::ublas::vector<Real> parDeltas = parConverter->convertSensitivity(zeroDeltas);
-                Size counter = 0;
-                for (const auto& key : parConverter->parKeys()) {
-                    if (!close(parDeltas[counter], 0.0)) {
-                        SensitivityRecord sr;
-                        sr.tradeId = id;
-                        sr.isPar = true;
-                        sr.key_1 = key;
-                        sr.desc_1 = descriptions[key];
-                        sr.delta = parDeltas[counter];
-                        sr.baseNpv = sensis.begin()->baseNpv;
-                        sr.currency = sensis.begin()->currency;
-                        sr.shift_1 = shiftSizes[key].second;
-                        sr.gamma = QuantLib::Null<QuantLib::Real>();
-                        results.push_back(sr);
-                    }
-                    counter++;
-                }
-                results.insert(results.end(), excludedDeltas.begin(), excludedDeltas.end());
+                pending.push_back({id, sensis.begin()->baseNpv, sensis.begin()->currency, std::move(zeroDeltas),
+                                   std::move(excludedDeltas)});
+                if (pending.size() == batchSize)
+                    convertPending();
             }
         }
+        convertPending();
 
         auto ss = QuantLib::ext::make_shared<SensitivityInMemoryStream>(results.begin(), results.end());
         QuantLib::ext::shared_ptr<InMemoryReport> report = QuantLib::ext::make_shared<InMemoryReport>();
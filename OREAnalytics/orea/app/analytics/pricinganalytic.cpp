@@ -17,6 +17,7 @@
 */
 
 #include <orea/app/analytics/pricinganalytic.hpp>
+#include <orea/app/multithreadedreportwriter.hpp>
 #include <orea/app/reportwriter.hpp>
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/parsensitivityanalysis.hpp>
@@ -47,6 +48,16 @@ void PricingAnalyticImpl::setUpConfigurations() {
     setGenerateAdditionalResults(true);
 }
 
+QuantLib::ext::shared_ptr<ReportWriter>
+PricingAnalyticImpl::cashflowReportWriter(const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader) {
+    if (inputs_->nThreads() == 1)
+        return QuantLib::ext::make_shared<ReportWriter>(inputs_->reportNaString());
+    LOG("Multi-threaded cashflow report with " << inputs_->nThreads() << " threads");
+    return QuantLib::ext::make_shared<MultiThreadedReportWriter>(
+        inputs_->nThreads(), inputs_->asof(), loader, analytic()->configurations().todaysMarketParams,
+        analytic()->configurations().curveConfig, engineFactory(), inputs_->reportNaString());
+}
+
 void PricingAnalyticImpl::runAnalytic( 
     const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader, 
     const std::set<std::string>& runTypes) {
@@ -117,20 +128,18 @@ void PricingAnalyticImpl::runAnalytic(
         else if (type == "CASHFLOW") {
             CONSOLEW("Pricing: Cashflow Report");
             string marketConfig = inputs_->marketConfig("pricing");
-            ReportWriter(inputs_->reportNaString())
-                .writeCashflow(*report, effectiveResultCurrency, analytic()->portfolio(),
-                               analytic()->market(),
-                               marketConfig, inputs_->includePastCashflows());
+            cashflowReportWriter(loader)->writeCashflow(*report, effectiveResultCurrency, analytic()->portfolio(),
+                                                        analytic()->market(), marketConfig,
+                                                        inputs_->includePastCashflows());
             analytic()->reports()[type]["cashflow"] = report;
             CONSOLE("OK");
         }
         else if (type == "CASHFLOWNPV") {
             CONSOLEW("Pricing: Cashflow NPV report");
             string marketConfig = inputs_->marketConfig("pricing");
-            ReportWriter(inputs_->reportNaString())
-                .writeCashflow(tmpReport, effectiveResultCurrency, analytic()->portfolio(),
-                               analytic()->market(),
-                               marketConfig, inputs_->includePastCashflows());
+            cashflowReportWriter(loader)->writeCashflow(tmpReport, effectiveResultCurrency, analytic()->portfolio(),
+                                                        analytic()->market(), marketConfig,
+                                                        inputs_->includePastCashflows());
             ReportWriter(inputs_->reportNaString())
                 .writeCashflowNpv(*report, tmpReport, analytic()->market(), marketConfig,
                                   effectiveResultCurrency, inputs_->cashflowHorizon());
@@ -164,6 +173,8 @@ void PricingAnalyticImpl::runAnalytic(
                     inputs_->refDataManager(), *inputs_->iborFallbackConfig(), true, inputs_->dryRun());
                 LOG("Multi-threaded sensi analysis created");
             }
+            sensiAnalysis->useAadDeltas(inputs_->sensiAadDeltas());
+            sensiAnalysis->skipUnaffectedTrades(inputs_->sensiSkipUnaffectedTrades());
             // FIXME: Why are these disabled?
             set<RiskFactorKey::KeyType> typesDisabled{RiskFactorKey::KeyType::OptionletVolatility};
             QuantLib::ext::shared_ptr<ParSensitivityAnalysis> parAnalysis = nullptr;
@@ -221,10 +232,23 @@ void PricingAnalyticImpl::runAnalytic(
                     parAnalysis->relevantRiskFactors() = collectRiskFactors;
                     LOG("optimiseRiskFactors active : parSensi risk factors set to zeroSensi risk factors");
                 }
-                parAnalysis->computeParInstrumentSensitivities(sensiAnalysis->simMarket());
+                if (!inputs_->parSensiCacheFile().empty()) {
+                    parAnalysis->setCache(inputs_->parSensiCacheFile(),
+                                          parSensitivityCacheKey(inputs_->asof(),
+                                                                 analytic()->configurations().simMarketParams,
+                                                                 *analytic()->configurations().sensiScenarioData,
+                                                                 analytic()->configurations().curveConfig,
+                                                                 analytic()->configurations().todaysMarketParams),
+                                          inputs_->parSensiCacheTolerance());
+                }
+                parAnalysis->computeParInstrumentSensitivities(
+                    inputs_->nThreads(), sensiAnalysis->simMarket(), loader, analytic()->configurations().curveConfig,
+                    analytic()->configurations().todaysMarketParams, inputs_->refDataManager(),
+                    *inputs_->iborFallbackConfig());
                 QuantLib::ext::shared_ptr<ParSensitivityConverter> parConverter =
                     QuantLib::ext::make_shared<ParSensitivityConverter>(parAnalysis->parSensitivities(), parAnalysis->shiftSizes());
-                auto parCube = QuantLib::ext::make_shared<ZeroToParCube>(sensiAnalysis->sensiCubes(), parConverter, typesDisabled, true);
+                auto parCube = QuantLib::ext::make_shared<ZeroToParCube>(sensiAnalysis->sensiCubes(), parConverter,
+                                                                         typesDisabled, true, inputs_->nThreads());
                 LOG("Sensi analysis - write par sensitivity report in memory");
                 QuantLib::ext::shared_ptr<ParSensitivityCubeStream> pss =
                     QuantLib::ext::make_shared<ParSensitivityCubeStream>(parCube, baseCurrency);
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <orea/app/analytic.hpp>
+#include <orea/app/reportwriter.hpp>
 
 namespace ore {
 namespace analytics {
@@ -39,6 +40,11 @@ public:
         const std::set<std::string>& runTypes = {}) override;
 
     void setUpConfigurations() override;
+
+private:
+    // the writer for the cashflow reports, multi-threaded if more than one thread is configured
+    QuantLib::ext::shared_ptr<ReportWriter>
+    cashflowReportWriter(const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader);
 };
 
 static const std::set<std::string> pricingAnalyticSubAnalytics {"NPV", "CASHFLOW", "CASHFLOWNPV", "SENSITIVITY"};
@@ -48,6 +54,7 @@ public:
     PricingAnalytic(const QuantLib::ext::shared_ptr<InputParameters>& inputs)
         : Analytic(std::make_unique<PricingAnalyticImpl>(inputs), pricingAnalyticSubAnalytics,
                    inputs) {}
+    bool supportsConcurrentRun() const override { return true; }
 };
  
 } // namespace analytics
@@ -137,13 +137,14 @@ void ScenarioStatisticsAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr
         auto statsReport = QuantLib::ext::make_shared<InMemoryReport>();
     scenarioGenerator->reset();
         ReportWriter().writeScenarioStatistics(scenarioGenerator, keys, samples_, grid_->valuationDates(),
-                                               *statsReport);
+                                               *statsReport, inputs_->nThreads());
     analytic()->reports()["SCENARIO_STATISTICS"]["scenario_statistics"] = statsReport;
 
     auto distributionReport = QuantLib::ext::make_shared<InMemoryReport>();
     scenarioGenerator->reset();
     ReportWriter().writeScenarioDistributions(scenarioGenerator, keys, samples_, grid_->valuationDates(),
-                                              inputs_->scenarioDistributionSteps(), *distributionReport);
+                                              inputs_->scenarioDistributionSteps(), *distributionReport,
+                                              inputs_->nThreads());
     analytic()->reports()["SCENARIO_STATISTICS"]["scenario_distribution"] = distributionReport;
 }
 
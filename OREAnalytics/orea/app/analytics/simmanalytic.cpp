@@ -43,42 +43,85 @@ void SimmAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::data::In
     auto simmAnalytic = static_cast<SimmAnalytic*>(analytic());
     QL_REQUIRE(simmAnalytic, "Analytic must be of type SimmAnalytic");
 
-    LOG("Get CRIF records from CRIF loader and fill amountUSD");        
-    simmAnalytic->loadCrifRecords(loader);
-
-    if (analytic()->getWriteIntermediateReports()) {
-        QuantLib::ext::shared_ptr<InMemoryReport> crifReport = QuantLib::ext::make_shared<InMemoryReport>();
-        ReportWriter(inputs_->reportNaString()).writeCrifReport(crifReport, simmAnalytic->crif());
-        analytic()->reports()[LABEL]["crif"] = crifReport;
-        LOG("CRIF report generated");
-
-        Crif simmDataCrif = simmAnalytic->crif().aggregate();
-        QuantLib::ext::shared_ptr<InMemoryReport> simmDataReport = QuantLib::ext::make_shared<InMemoryReport>();
-        ReportWriter(inputs_->reportNaString())
-            .writeSIMMData(simmAnalytic->crif(), simmDataReport);
-        analytic()->reports()[LABEL]["simm_data"] = simmDataReport;
-        LOG("SIMM data report generated");
-    }
-    MEM_LOG;
-
-    LOG("Calculating SIMM");
+    auto simmConfig = inputs_->getSimmConfiguration();
 
     // Save SIMM calibration data to output
     if (inputs_->simmCalibrationData())
         inputs_->simmCalibrationData()->toFile((inputs_->resultsPath() / "simmcalibration.xml").string());
 
-    auto simmConfig = inputs_->getSimmConfiguration();
-    simmConfig->bucketMapper()->updateFromCrif(simmAnalytic->crif());
-
-    // Calculate SIMM
-    auto simm = QuantLib::ext::make_shared<SimmCalculator>(simmAnalytic->crif(),
-                                                   simmConfig,
-                                                   inputs_->simmCalculationCurrencyCall(),
-                                                   inputs_->simmCalculationCurrencyPost(),
-                                                   inputs_->simmResultCurrency(),
-                                                   analytic()->market(),
-                                                   simmAnalytic->determineWinningRegulations(),
-                                                   inputs_->enforceIMRegulations());
+    std::map<SimmCalculator::SimmSide, std::map<NettingSetDetails, std::map<std::string, SimmResults>>> simmResults;
+    std::map<SimmCalculator::SimmSide, std::map<NettingSetDetails, std::pair<std::string, SimmResults>>>
+        finalSimmResults;
+    std::map<SimmCalculator::SimmSide, std::map<NettingSetDetails, std::pair<std::string, std::map<std::string, Real>>>>
+        allocations;
+    bool hasNettingSetDetails = false;
+
+    // Run the SIMM calculation on a CRIF and collect its results
+    auto calculate = [this, &simmAnalytic, &simmConfig, &simmResults, &finalSimmResults, &allocations](
+                         const Crif& crif) {
+        SimmCalculator simm(crif, simmConfig, inputs_->simmCalculationCurrencyCall(),
+                            inputs_->simmCalculationCurrencyPost(), inputs_->simmResultCurrency(), analytic()->market(),
+                            simmAnalytic->determineWinningRegulations(), inputs_->enforceIMRegulations(), false,
+                            std::map<SimmCalculator::SimmSide, std::set<NettingSetDetails>>(),
+                            std::map<SimmCalculator::SimmSide, std::set<NettingSetDetails>>(), inputs_->nThreads());
+        for (const auto& [side, nettingSetResults] : simm.simmResults()) {
+            for (const auto& [nettingSetDetails, regResults] : nettingSetResults) {
+                QL_REQUIRE(simmResults[side].count(nettingSetDetails) == 0,
+                           "SimmAnalytic: netting set " << nettingSetDetails
+                                                        << " found in more than one CRIF block, the streamed "
+                                                           "CRIF must be sorted by netting set");
+                simmResults[side][nettingSetDetails] = regResults;
+            }
+        }
+        for (const auto& [side, nettingSetResults] : simm.finalSimmResults()) {
+            for (const auto& [nettingSetDetails, regResults] : nettingSetResults) {
+                finalSimmResults[side][nettingSetDetails] = regResults;
+                // Euler allocation of the final SIMM to the trades
+                if (inputs_->simmTradeAllocation())
+                    allocations[side][nettingSetDetails] = std::make_pair(
+                        regResults.first, simm.tradeAllocations(side, nettingSetDetails, regResults.first));
+            }
+        }
+    };
+
+    if (inputs_->simmStreamCrif()) {
+        QL_REQUIRE(inputs_->crifLoader(), "SimmAnalytic: streamCrif is set but no CRIF loader is given");
+        if (analytic()->getWriteIntermediateReports())
+            WLOG("SimmAnalytic: intermediate CRIF reports are not written when the CRIF is streamed");
+        LOG("Calculating SIMM netting set by netting set on the streamed CRIF");
+        Size nBlocks = 0;
+        inputs_->crifLoader()->loadCrifByNettingSet([&calculate, &hasNettingSetDetails, &nBlocks, this](Crif&& crif) {
+            crif.fillAmountUsd(analytic()->market());
+            hasNettingSetDetails = hasNettingSetDetails || crif.hasNettingSetDetails();
+            calculate(crif);
+            ++nBlocks;
+            DLOG("SIMM calculated for CRIF block " << nBlocks << " with " << crif.size() << " records");
+        });
+        QL_REQUIRE(nBlocks > 0, "CRIF loader does not contain any records");
+    } else {
+        LOG("Get CRIF records from CRIF loader and fill amountUSD");
+        simmAnalytic->loadCrifRecords(loader);
+
+        if (analytic()->getWriteIntermediateReports()) {
+            QuantLib::ext::shared_ptr<InMemoryReport> crifReport = QuantLib::ext::make_shared<InMemoryReport>();
+            ReportWriter(inputs_->reportNaString()).writeCrifReport(crifReport, simmAnalytic->crif());
+            analytic()->reports()[LABEL]["crif"] = crifReport;
+            LOG("CRIF report generated");
+
+            Crif simmDataCrif = simmAnalytic->crif().aggregate();
+            QuantLib::ext::shared_ptr<InMemoryReport> simmDataReport = QuantLib::ext::make_shared<InMemoryReport>();
+            ReportWriter(inputs_->reportNaString())
+                .writeSIMMData(simmAnalytic->crif(), simmDataReport);
+            analytic()->reports()[LABEL]["simm_data"] = simmDataReport;
+            LOG("SIMM data report generated");
+        }
+        MEM_LOG;
+
+        LOG("Calculating SIMM");
+        simmConfig->bucketMapper()->updateFromCrif(simmAnalytic->crif());
+        hasNettingSetDetails = simmAnalytic->hasNettingSetDetails();
+        calculate(simmAnalytic->crif());
+    }
 
     Real fxSpot = 1.0;
     if (!inputs_->simmReportingCurrency().empty()) {
@@ -90,7 +133,7 @@ void SimmAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::data::In
 
     QuantLib::ext::shared_ptr<InMemoryReport> simmRegulationBreakdownReport = QuantLib::ext::make_shared<InMemoryReport>();
     ReportWriter(inputs_->reportNaString())
-        .writeSIMMReport(simm->simmResults(), simmRegulationBreakdownReport, simmAnalytic->hasNettingSetDetails(),
+        .writeSIMMReport(simmResults, simmRegulationBreakdownReport, hasNettingSetDetails,
                          inputs_->simmResultCurrency(), inputs_->simmCalculationCurrencyCall(),
                          inputs_->simmCalculationCurrencyPost(), inputs_->simmReportingCurrency(), false, fxSpot);
     LOG("SIMM regulation breakdown report generated");
@@ -99,11 +142,20 @@ void SimmAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::data::In
 
     QuantLib::ext::shared_ptr<InMemoryReport> simmReport = QuantLib::ext::make_shared<InMemoryReport>();
     ReportWriter(inputs_->reportNaString())
-        .writeSIMMReport(simm->finalSimmResults(), simmReport, simmAnalytic->hasNettingSetDetails(),
+        .writeSIMMReport(finalSimmResults, simmReport, hasNettingSetDetails,
                          inputs_->simmResultCurrency(), inputs_->simmCalculationCurrencyCall(),
                          inputs_->simmCalculationCurrencyPost(), inputs_->simmReportingCurrency(), fxSpot);
     analytic()->reports()[LABEL]["simm"] = simmReport;
     LOG("SIMM report generated");
+
+    if (inputs_->simmTradeAllocation()) {
+        QuantLib::ext::shared_ptr<InMemoryReport> allocationReport = QuantLib::ext::make_shared<InMemoryReport>();
+        ReportWriter(inputs_->reportNaString())
+            .writeSIMMTradeAllocationReport(allocations, allocationReport, hasNettingSetDetails,
+                                            inputs_->simmResultCurrency(), inputs_->simmReportingCurrency(), fxSpot);
+        analytic()->reports()[LABEL]["simm_trade_allocation"] = allocationReport;
+        LOG("SIMM trade allocation report generated");
+    }
     MEM_LOG;
 
 }
@@ -51,6 +51,8 @@ public:
         setWriteIntermediateReports(inputs->writeSimmIntermediateReports());
     }
 
+    bool supportsConcurrentRun() const override { return true; }
+
     const Crif& crif() const { return crif_; }
     bool hasNettingSetDetails() { return hasNettingSetDetails_; }
     bool determineWinningRegulations() { return determineWinningRegulations_; }
@@ -43,6 +43,7 @@ public:
 class StressTestAnalytic : public Analytic {
 public:
     StressTestAnalytic(const boost::shared_ptr<InputParameters>& inputs);
+    bool supportsConcurrentRun() const override { return true; }
 };
 
 } // namespace analytics
@@ -25,6 +25,8 @@
 #include <ored/marketdata/adjustmentfactors.hpp>
 #include <ored/marketdata/adjustedinmemoryloader.hpp>
 
+#include <boost/regex.hpp>
+
 using namespace ore::data;
 using namespace boost::filesystem;
 using namespace QuantLib::ext;
@@ -40,6 +42,19 @@ void VarAnalyticImpl::setUpConfigurations() {
     analytic()->configurations().todaysMarketParams = inputs_->todaysMarketParams();
 }
 
+std::function<bool(const ore::data::Trade&)> VarAnalyticImpl::tradeFilter() const {
+    if (inputs_->portfolioFilter().empty())
+        return {};
+    // same matching as in MarketRiskReport::initialiseRiskGroups()
+    boost::regex filter(inputs_->portfolioFilter());
+    return [filter](const ore::data::Trade& trade) {
+        for (auto const& pId : trade.portfolioIds())
+            if (boost::regex_match(pId, filter))
+                return true;
+        return false;
+    };
+}
+
 void VarAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader,
                               const std::set<std::string>& runTypes) {
     MEM_LOG;
@@ -59,6 +74,7 @@ void VarAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::data::InM
         
     setVarReport(loader);
     QL_REQUIRE(varReport_, "No Var Report created");
+    varReport_->setBreakdownThreads(inputs_->nThreads());
     
     LOG("Call VaR calculation");
     CONSOLEW("Risk: VaR Calculation");
@@ -140,6 +156,8 @@ void ParametricVarAnalyticImpl::setVarReport(const QuantLib::ext::shared_ptr<ore
 void HistoricalSimulationVarAnalyticImpl::setUpConfigurations() {
     VarAnalyticImpl::setUpConfigurations();
     analytic()->configurations().simMarketParams = inputs_->histVarSimMarketParams();
+    if (inputs_->histVarSensiPnlGammaThreshold() != Null<Real>())
+        analytic()->configurations().sensiScenarioData = inputs_->sensiScenarioData();
 }
 
 void HistoricalSimulationVarAnalyticImpl::setVarReport(
@@ -173,9 +191,22 @@ void HistoricalSimulationVarAnalyticImpl::setVarReport(
     std::unique_ptr<MarketRiskReport::FullRevalArgs> fullRevalArgs = std::make_unique<MarketRiskReport::FullRevalArgs>(
         simMarket, inputs_->pricingEngine(), inputs_->refDataManager(), *inputs_->iborFallbackConfig());
 
+    // optional hybrid mode, near-linear trades get their P&L from the sensitivities instead of a full revaluation
+    std::unique_ptr<MarketRiskReport::SensiRunArgs> sensiArgs;
+    if (inputs_->histVarSensiPnlGammaThreshold() != Null<Real>()) {
+        QL_REQUIRE(inputs_->sensitivityStream(), "sensiPnlGammaThreshold requires a sensitivity input");
+        QL_REQUIRE(analytic()->configurations().sensiScenarioData,
+                   "sensiPnlGammaThreshold requires a sensitivity configuration");
+        fullRevalArgs->sensiPnlGammaThreshold_ = inputs_->histVarSensiPnlGammaThreshold();
+        auto shiftCalculator = QuantLib::ext::make_shared<ScenarioShiftCalculator>(
+            analytic()->configurations().sensiScenarioData, analytic()->configurations().simMarketParams);
+        sensiArgs = std::make_unique<MarketRiskReport::SensiRunArgs>(inputs_->sensitivityStream(), shiftCalculator);
+    }
+
     varReport_ = ext::make_shared<HistoricalSimulationVarReport>(
         inputs_->baseCurrency(), analytic()->portfolio(), inputs_->portfolioFilter(), 
-        inputs_->varQuantiles(), benchmarkVarPeriod, scenarios, std::move(fullRevalArgs), inputs_->varBreakDown());
+        inputs_->varQuantiles(), benchmarkVarPeriod, scenarios, std::move(fullRevalArgs), inputs_->varBreakDown(),
+        std::move(sensiArgs));
 
 }
 
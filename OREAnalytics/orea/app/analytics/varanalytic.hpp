@@ -38,6 +38,8 @@ public:
     virtual void runAnalytic(const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader,
                      const std::set<std::string>& runTypes = {}) override;
     virtual void setUpConfigurations() override;
+    //! if a portfolio filter is given, only trades in a matching portfolio contribute to the VaR
+    std::function<bool(const ore::data::Trade&)> tradeFilter() const override;
 
 protected:
     QuantLib::ext::shared_ptr<VarReport> varReport_;
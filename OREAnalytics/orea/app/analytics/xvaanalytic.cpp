@@ -22,20 +22,38 @@
 #include <orea/app/reportwriter.hpp>
 #include <orea/app/structuredanalyticserror.hpp>
 #include <orea/app/structuredanalyticswarning.hpp>
+#include <orea/cube/contiguouscube.hpp>
+#include <orea/cube/creditstatenpvcube.hpp>
+#include <orea/cube/jaggedcube.hpp>
 #include <orea/cube/jointnpvcube.hpp>
+#include <orea/cube/mappedfilecube.hpp>
+#include <orea/cube/sampletruncatedcube.hpp>
 #include <orea/engine/amcvaluationengine.hpp>
+#include <orea/engine/closeoutregression.hpp>
 #include <orea/engine/cptycalculator.hpp>
+#include <orea/engine/cubecheckpoint.hpp>
+#include <orea/engine/distributedvaluationengine.hpp>
 #include <orea/engine/mporcalculator.hpp>
 #include <orea/engine/multistatenpvcalculator.hpp>
 #include <orea/engine/multithreadedvaluationengine.hpp>
 #include <orea/engine/observationmode.hpp>
+#include <orea/engine/observergraph.hpp>
+#include <orea/engine/sampleconsumer.hpp>
 #include <orea/engine/xvaenginecg.hpp>
+#include <orea/scenario/binaryscenariofile.hpp>
 #include <orea/scenario/scenariowriter.hpp>
 #include <orea/scenario/simplescenariofactory.hpp>
 
+#include <ored/configuration/conventions.hpp>
 #include <ored/model/crossassetmodelbuilder.hpp>
 #include <ored/portfolio/structuredtradeerror.hpp>
 
+#include <qle/utilities/memoryaccounting.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <iomanip>
+
 using namespace ore::data;
 using namespace boost::filesystem;
 
@@ -177,13 +195,24 @@ void XvaAnalyticImpl::buildScenarioSimMarket() {
 void XvaAnalyticImpl::buildScenarioGenerator(const bool continueOnCalibrationError) {
     if (!model_)
         buildCrossAssetModel(continueOnCalibrationError);
-    ScenarioGeneratorBuilder sgb(analytic()->configurations().scenarioGeneratorData);
-    QuantLib::ext::shared_ptr<ScenarioFactory> sf = QuantLib::ext::make_shared<SimpleScenarioFactory>(true);
-    string config = inputs_->marketConfig("simulation");
-    auto market = offsetScenario_ == nullptr ? analytic()->market() : simMarketCalibration_;
-    scenarioGenerator_ =
-        sgb.build(model_, sf, analytic()->configurations().simMarketParams, inputs_->asof(), market, config);
-    QL_REQUIRE(scenarioGenerator_, "failed to build the scenario generator");
+    const std::string& cacheFile = inputs_->scenarioCacheFile();
+    if (!cacheFile.empty() && boost::filesystem::exists(cacheFile)) {
+        // replay the scenarios of a previous run from the binary scenario cache
+        LOG("XVA: Read scenarios from cache file " << cacheFile);
+        scenarioGenerator_ = QuantLib::ext::make_shared<BinaryScenarioGenerator>(cacheFile);
+    } else {
+        ScenarioGeneratorBuilder sgb(analytic()->configurations().scenarioGeneratorData);
+        QuantLib::ext::shared_ptr<ScenarioFactory> sf = QuantLib::ext::make_shared<SimpleScenarioFactory>(true);
+        string config = inputs_->marketConfig("simulation");
+        auto market = offsetScenario_ == nullptr ? analytic()->market() : simMarketCalibration_;
+        scenarioGenerator_ =
+            sgb.build(model_, sf, analytic()->configurations().simMarketParams, inputs_->asof(), market, config);
+        QL_REQUIRE(scenarioGenerator_, "failed to build the scenario generator");
+        if (!cacheFile.empty()) {
+            LOG("XVA: Write scenarios to cache file " << cacheFile);
+            scenarioGenerator_ = QuantLib::ext::make_shared<BinaryScenarioWriter>(scenarioGenerator_, cacheFile);
+        }
+    }
     samples_ = analytic()->configurations().scenarioGeneratorData->samples();
     LOG("simulation grid size " << grid_->size());
     LOG("simulation grid valuation dates " << grid_->valuationDates().size());
@@ -203,13 +232,16 @@ void XvaAnalyticImpl::buildCrossAssetModel(const bool continueOnCalibrationError
                                                                      << ")");
     ext::shared_ptr<Market> market = offsetScenario_ != nullptr ? simMarketCalibration_ : analytic()->market();
     QL_REQUIRE(market != nullptr, "Internal error, buildCrossAssetModel needs to be called after the market is built.");
+    /* the calibrations on several threads require market objects that are built upfront, a lazily built todays
+       market would build the curves and vol surfaces concurrently on first use */
+    Size nThreads = offsetScenario_ == nullptr && inputs_->lazyMarketBuilding() ? 1 : inputs_->nThreads();
     CrossAssetModelBuilder modelBuilder(
         market, analytic()->configurations().crossAssetModelData, inputs_->marketConfig("lgmcalibration"),
         inputs_->marketConfig("fxcalibration"), inputs_->marketConfig("eqcalibration"),
         inputs_->marketConfig("infcalibration"), inputs_->marketConfig("crcalibration"),
         inputs_->marketConfig("simulation"), false, continueOnCalibrationError, "",
         inputs_->salvageCorrelationMatrix() ? SalvagingAlgorithm::Spectral : SalvagingAlgorithm::None,
-        "xva cam building");
+        "xva cam building", nThreads);
     model_ = *modelBuilder.model();
 }
 
@@ -222,19 +254,52 @@ void XvaAnalyticImpl::initCubeDepth() {
 }
 
 void XvaAnalyticImpl::initCube(QuantLib::ext::shared_ptr<NPVCube>& cube, const std::set<std::string>& ids,
-                               Size cubeDepth) {
+                               Size cubeDepth, const std::map<std::string, Date>& maturities) {
 
     LOG("Init cube with depth " << cubeDepth);
 
     for (Size i = 0; i < grid_->valuationDates().size(); ++i)
         DLOG("initCube: grid[" << i << "]=" << io::iso_date(grid_->valuationDates()[i]));
 
-    if (cubeDepth == 1)
+    // the credit state npvs are the last depths, they are kept as sparse deltas to the first state
+    Size states = cubeInterpreter_ ? cubeInterpreter_->storeCreditStateNPVs() : 0;
+    bool sparseStates = states > 1 && cubeInterpreter_->creditStateNPVsIndex() + states == cubeDepth;
+    Size denseDepth = sparseStates ? cubeDepth - states + 1 : cubeDepth;
+
+    if (inputs_->maturityTruncatedCube() && !maturities.empty()) {
+        auto c = QuantLib::ext::make_shared<SinglePrecisionJaggedCube>(inputs_->asof(), ids, grid_->valuationDates(),
+                                                                        samples_, denseDepth, maturities);
+        LOG("Maturity truncated cube stores " << c->avgDateLen() << " of " << grid_->valuationDates().size()
+                                              << " dates per trade on average");
+        cube = c;
+    } else if (denseDepth == 1)
         cube = QuantLib::ext::make_shared<SinglePrecisionInMemoryCube>(inputs_->asof(), ids, grid_->valuationDates(),
                                                                        samples_, 0.0f);
     else
         cube = QuantLib::ext::make_shared<SinglePrecisionInMemoryCubeN>(inputs_->asof(), ids, grid_->valuationDates(),
-                                                                        samples_, cubeDepth, 0.0f);
+                                                                        samples_, denseDepth, 0.0f);
+
+    if (sparseStates) {
+        LOG("Store " << states << " credit state npvs as sparse deltas to the first state");
+        cube = QuantLib::ext::make_shared<CreditStateNpvCube>(cube, states);
+    }
+}
+
+std::map<std::string, Date> XvaAnalyticImpl::tradeMaturities(const QuantLib::ext::shared_ptr<Portfolio>& portfolio) const {
+    std::map<std::string, Date> maturities;
+    if (inputs_->maturityTruncatedCube()) {
+        for (auto const& [tradeId, trade] : portfolio->trades())
+            maturities[tradeId] = trade->maturity();
+    }
+    return maturities;
+}
+
+QuantLib::ext::shared_ptr<AggregationScenarioData> XvaAnalyticImpl::createScenarioData() const {
+    if (inputs_->singlePrecisionScenarioData())
+        return QuantLib::ext::make_shared<SinglePrecisionInMemoryAggregationScenarioData>(
+            grid_->valuationDates().size(), samples_);
+    else
+        return QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(grid_->valuationDates().size(), samples_);
 }
 
 void XvaAnalyticImpl::initClassicRun(const QuantLib::ext::shared_ptr<Portfolio>& portfolio) {
@@ -246,15 +311,14 @@ void XvaAnalyticImpl::initClassicRun(const QuantLib::ext::shared_ptr<Portfolio>&
     // May have been set already
     if (scenarioData_.empty()) {
         LOG("XVA: Create asd " << grid_->valuationDates().size() << " x " << samples_);
-        scenarioData_.linkTo(
-            QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(grid_->valuationDates().size(), samples_));
+        scenarioData_.linkTo(createScenarioData());
         simMarket_->aggregationScenarioData() = *scenarioData_;
     }
 
     // We can skip the cube initialization if the mt val engine is used, since it builds its own cubes
-    if (inputs_->nThreads() == 1) {
+    if (inputs_->nThreads() == 1 || !inputs_->distributedWorkerCommand().empty()) {
         if (portfolio->size() > 0)
-            initCube(cube_, portfolio->ids(), cubeDepth_);
+            initCube(cube_, portfolio->ids(), cubeDepth_, tradeMaturities(portfolio));
         // not required by any calculators in ore at the moment
         nettingSetCube_ = nullptr;
         // Init counterparty cube for the storage of survival probabilities
@@ -308,6 +372,34 @@ XvaAnalyticImpl::classicRun(const QuantLib::ext::shared_ptr<Portfolio>& portfoli
     return classicPortfolio_;
 }
 
+void XvaAnalyticImpl::setCvaWeights(const QuantLib::ext::shared_ptr<Portfolio>& portfolio) {
+    // the CVA weights are evaluated here, the monitor runs in a background thread and must not access the market
+    string configuration = inputs_->marketConfig("simulation");
+    map<string, string> nettingSetCounterparties;
+    for (auto const& [tradeId, trade] : portfolio->trades())
+        nettingSetCounterparties.insert(
+            std::make_pair(trade->envelope().nettingSetId(), trade->envelope().counterparty()));
+    auto market = analytic()->market();
+    const vector<Date>& dates = grid_->valuationDates();
+    for (auto const& [nettingSet, cpty] : nettingSetCounterparties) {
+        try {
+            Handle<DefaultProbabilityTermStructure> dts = market->defaultCurve(cpty, configuration)->curve();
+            Real lgd = 1.0 - market->recoveryRate(cpty, configuration)->value();
+            vector<Real> weights(dates.size());
+            Real s0 = 1.0;
+            for (Size j = 0; j < dates.size(); ++j) {
+                Real s1 = dts->survivalProbability(dates[j]);
+                weights[j] = lgd * (s0 - s1);
+                s0 = s1;
+            }
+            convergenceMonitor_->setCvaWeights(nettingSet, weights);
+        } catch (const std::exception& e) {
+            WLOG("XVA: no CVA convergence criterion for netting set " << nettingSet << ", counterparty " << cpty << ": "
+                                                                      << e.what());
+        }
+    }
+}
+
 void XvaAnalyticImpl::buildClassicCube(const QuantLib::ext::shared_ptr<Portfolio>& portfolio) {
 
     LOG("XVA::buildCube");
@@ -333,6 +425,30 @@ void XvaAnalyticImpl::buildClassicCube(const QuantLib::ext::shared_ptr<Portfolio
         return calculators;
     };
 
+    // pricing profile reports, if profiling is enabled
+
+    auto writePricingProfile = [this](const std::map<std::string, ValuationEngine::PricingProfile>& profiles) {
+        auto report = QuantLib::ext::make_shared<InMemoryReport>();
+        ReportWriter(inputs_->reportNaString()).writePricingProfile(*report, profiles);
+        analytic()->reports()["XVA"]["pricing_profile"] = report;
+        auto engineReport = QuantLib::ext::make_shared<InMemoryReport>();
+        ReportWriter(inputs_->reportNaString()).writePricingProfileByEngine(*engineReport, profiles);
+        analytic()->reports()["XVA"]["pricing_profile_engines"] = engineReport;
+    };
+
+    // observer statistics reports, if enabled
+
+    auto writeObserverStatistics =
+        [this](const std::map<std::string, ObserverGraph::TradeStatistics>& tradeStatistics,
+               const std::map<ObserverGraph::RiskFactor, ObserverGraph::RiskFactorStatistics>& riskFactorStatistics) {
+            auto report = QuantLib::ext::make_shared<InMemoryReport>();
+            ReportWriter(inputs_->reportNaString()).writeObserverStatistics(*report, tradeStatistics);
+            analytic()->reports()["XVA"]["observer_statistics"] = report;
+            auto riskFactorReport = QuantLib::ext::make_shared<InMemoryReport>();
+            ReportWriter(inputs_->reportNaString()).writeObserverStatistics(*riskFactorReport, riskFactorStatistics);
+            analytic()->reports()["XVA"]["observer_statistics_riskfactors"] = riskFactorReport;
+        };
+
     // set up cpty calculator factory
 
     auto cptyCalculators = [this]() {
@@ -357,16 +473,163 @@ void XvaAnalyticImpl::buildClassicCube(const QuantLib::ext::shared_ptr<Portfolio
                                                                      ConsoleLog::instance().progressBarWidth());
     auto progressLog = QuantLib::ext::make_shared<ProgressLog>("XVA: Building cube", 100, oreSeverity::notice);
 
-    if (inputs_->nThreads() == 1) {
+    /* With the close-out regression the trades are priced on the valuation dates only, the close-out values are
+       estimated from these after the cube build. The distributed workers always price the close-out dates. */
+
+    bool closeOutRegression =
+        inputs_->closeOutRegression() && analytic()->configurations().scenarioGeneratorData->withCloseOutLag();
+    if (closeOutRegression && !inputs_->distributedWorkerCommand().empty()) {
+        WLOG("XVA: close-out regression not supported by the distributed cube generation, close-out dates are priced");
+        closeOutRegression = false;
+    }
+
+    /* The checkpoint key identifies the inputs of the cube build, a checkpoint is only resumed for the same inputs.
+       The inputs are hashed one by one, so that the key does not require a copy of the whole portfolio and market. */
+
+    std::string checkpointKey;
+    if (!inputs_->cubeCheckpointDirectory().empty()) {
+        std::size_t seed = 0;
+        boost::hash_combine(seed, io::iso_date(inputs_->asof()));
+        boost::hash_combine(seed, inputs_->exposureBaseCurrency());
+        boost::hash_combine(seed, inputs_->storeFlows());
+        boost::hash_combine(seed, inputs_->storeCreditStateNPVs());
+        boost::hash_combine(seed, closeOutRegression);
+        boost::hash_combine(seed, analytic()->configurations().scenarioGeneratorData->toXMLString());
+        boost::hash_combine(seed, analytic()->configurations().simMarketParams->toXMLString());
+        boost::hash_combine(seed, analytic()->configurations().crossAssetModelData->toXMLString());
+        boost::hash_combine(seed, inputs_->simulationPricingEngine()->toXMLString());
+        for (auto const& [id, config] : inputs_->curveConfigs().curveConfigurations()) {
+            boost::hash_combine(seed, id);
+            boost::hash_combine(seed, config ? config->toXMLString() : std::string());
+        }
+        if (auto conventions = InstrumentConventions::instance().conventions())
+            boost::hash_combine(seed, conventions->toXMLString());
+        if (inputs_->refDataManager())
+            boost::hash_combine(seed, inputs_->refDataManager()->toXMLString());
+        for (auto const& [id, trade] : portfolio->trades()) {
+            boost::hash_combine(seed, id);
+            boost::hash_combine(seed, trade->toXMLString());
+        }
+        for (auto const& q : analytic()->loader()->loadQuotes(inputs_->asof())) {
+            boost::hash_combine(seed, q->name());
+            boost::hash_combine(seed, q->quote()->value());
+        }
+        for (auto const& f : analytic()->loader()->loadFixings()) {
+            boost::hash_combine(seed, f.name);
+            boost::hash_combine(seed, f.date.serialNumber());
+            boost::hash_combine(seed, f.fixing);
+        }
+        for (auto const& d : analytic()->loader()->loadDividends()) {
+            boost::hash_combine(seed, d.name);
+            boost::hash_combine(seed, d.exDate.serialNumber());
+            boost::hash_combine(seed, d.rate);
+        }
+        std::ostringstream key;
+        key << io::iso_date(inputs_->asof()) << "_" << std::hex << seed;
+        checkpointKey = key.str();
+        LOG("XVA: checkpoint the cube build in " << inputs_->cubeCheckpointDirectory() << " every "
+                                                 << inputs_->cubeCheckpointBlockSize() << " samples");
+    }
+
+    if (!inputs_->distributedWorkerCommand().empty()) {
+
+        // distributed engine run, the partitions are valued by worker processes
+
+        QL_REQUIRE(offsetScenario_ == nullptr, "XVA: distributed cube generation does not support offset scenarios");
+        QL_REQUIRE(!inputs_->storeSurvivalProbabilities(),
+                   "XVA: distributed cube generation does not support storeSurvivalProbabilities");
+        if (inputs_->writeScenarios())
+            WLOG("XVA: the scenarios are generated by the distributed workers, the scenario report is empty");
+
+        Size partitions = inputs_->distributedPartitions() > 0 ? inputs_->distributedPartitions()
+                                                               : std::max<Size>(inputs_->nThreads(), 1);
+        std::map<std::string, std::string> marketConfigurations;
+        for (auto const& key :
+             {"simulation", "lgmcalibration", "fxcalibration", "eqcalibration", "infcalibration", "crcalibration"})
+            marketConfigurations[key] = inputs_->marketConfig(key);
+
+        auto edCopy = QuantLib::ext::make_shared<EngineData>(*inputs_->simulationPricingEngine());
+        edCopy->globalParameters()["GenerateAdditionalResults"] = "false";
+        edCopy->globalParameters()["RunType"] = "Exposure";
+        auto globalParams = edCopy->globalParameters();
+        auto continueOnCalErr = globalParams.find("ContinueOnCalibrationError");
+        bool continueOnErr = (continueOnCalErr != globalParams.end()) && parseBool(continueOnCalErr->second);
+
+        DistributedValuationEngine engine(
+            inputs_->distributedWorkerCommand(), partitions, inputs_->distributedMaxWorkers(),
+            inputs_->distributedJobDirectory(), inputs_->asof(), analytic()->loader(), edCopy,
+            inputs_->curveConfigs().get(), analytic()->configurations().todaysMarketParams,
+            analytic()->configurations().simMarketParams, analytic()->configurations().scenarioGeneratorData,
+            analytic()->configurations().crossAssetModelData, marketConfigurations, inputs_->exposureBaseCurrency(),
+            inputs_->storeFlows(), inputs_->storeCreditStateNPVs(), continueOnErr, inputs_->salvageCorrelationMatrix(),
+            inputs_->exposureObservationModel(), inputs_->refDataManager(), *inputs_->iborFallbackConfig());
+        engine.registerProgressIndicator(progressBar);
+        engine.registerProgressIndicator(progressLog);
+
+        if (cube_)
+            engine.buildCube(portfolio, cube_, *scenarioData_);
+
+    } else if (inputs_->nThreads() == 1) {
 
         // single-threaded engine run
 
         ValuationEngine engine(inputs_->asof(), grid_, simMarket_);
         engine.registerProgressIndicator(progressBar);
         engine.registerProgressIndicator(progressLog);
+
+        /* The EPE convergence is monitored in a background thread while the cube is built, the simulation stops
+           early once the netting set profiles are converged. Not possible if the cube is joined with an AMC cube,
+           which always covers all samples. */
+        bool monitorConvergence = inputs_->exposureConvergenceTolerance() > 0.0 &&
+                                  (!amcPortfolio_ || amcPortfolio_->trades().empty());
+        if (monitorConvergence) {
+            LOG("XVA: Monitor EPE and CVA convergence with tolerance "
+                << inputs_->exposureConvergenceTolerance() << " after " << inputs_->exposureConvergenceMinSamples()
+                << " samples, checked every " << inputs_->exposureConvergenceBlockSize() << " samples");
+            convergenceMonitor_ = QuantLib::ext::make_shared<ExposureConvergenceMonitor>(
+                portfolio, inputs_->exposureConvergenceTolerance(), inputs_->exposureConvergenceMinSamples(),
+                cubeInterpreter_->defaultDateNpvIndex());
+            setCvaWeights(portfolio);
+            engine.registerSampleConsumer(QuantLib::ext::make_shared<AsyncSampleConsumer>(convergenceMonitor_),
+                                          inputs_->exposureConvergenceBlockSize());
+        }
+
+        if (!checkpointKey.empty())
+            engine.setCheckpoint(
+                QuantLib::ext::make_shared<CubeCheckpoint>(inputs_->cubeCheckpointDirectory(), checkpointKey),
+                inputs_->cubeCheckpointBlockSize());
+
+        engine.setProfiling(inputs_->pricingProfile());
+        engine.setSkipCloseOutPricing(closeOutRegression);
+        engine.setObserverStatistics(inputs_->observerStatistics());
+        engine.setPruneObservers(inputs_->pruneObservers());
+
         engine.buildCube(portfolio, cube_, calculators(),
                          analytic()->configurations().scenarioGeneratorData->withMporStickyDate(), nettingSetCube_,
                          cptyCube_, cptyCalculators());
+
+        if (inputs_->pricingProfile())
+            writePricingProfile(engine.pricingProfiles());
+
+        if (inputs_->observerStatistics() && engine.observerGraph())
+            writeObserverStatistics(engine.observerGraph()->tradeStatistics(),
+                                    engine.observerGraph()->riskFactorStatistics());
+
+        if (monitorConvergence) {
+            if (engine.completedSamples() < samples_) {
+                LOG("XVA: exposures converged, the post processing uses the first " << engine.completedSamples() << " of "
+                                                                               << samples_ << " samples");
+                cube_ = QuantLib::ext::make_shared<SampleTruncatedCube>(cube_, engine.completedSamples());
+                if (cptyCube_)
+                    cptyCube_ = QuantLib::ext::make_shared<SampleTruncatedCube>(cptyCube_, engine.completedSamples());
+            } else if (!convergenceMonitor_->converged()) {
+                WLOG("XVA: exposures not converged within tolerance " << inputs_->exposureConvergenceTolerance()
+                                                                      << " after " << samples_ << " samples");
+            }
+            auto report = QuantLib::ext::make_shared<InMemoryReport>();
+            convergenceMonitor_->exportConvergence(*report);
+            analytic()->reports()["XVA"]["exposure_convergence"] = report;
+        }
     } else {
 
         // multi-threaded engine run
@@ -374,14 +637,45 @@ void XvaAnalyticImpl::buildClassicCube(const QuantLib::ext::shared_ptr<Portfolio
         /* TODO we assume no netting output cube is needed. Currently there are no valuation calculators in ore that
          * require this cube. */
 
-        auto cubeFactory = [this](const QuantLib::Date& asof, const std::set<std::string>& ids,
-                                  const std::vector<QuantLib::Date>& dates,
-                                  const Size samples) -> QuantLib::ext::shared_ptr<NPVCube> {
-            if (cubeDepth_ == 1)
-                return QuantLib::ext::make_shared<SinglePrecisionInMemoryCube>(asof, ids, dates, samples, 0.0f);
-            else
-                return QuantLib::ext::make_shared<SinglePrecisionInMemoryCubeN>(asof, ids, dates, samples, cubeDepth_,
-                                                                                0.0f);
+        /* The threads write into slices of one contiguous cube covering the whole portfolio, so that no joint cube
+           is needed afterwards. The cube is created on the first call of the factory, i.e. after the engine has
+           built the portfolio against the init market. */
+
+        /* With the maturity truncated cube each part gets its own jagged cube instead, these are joined afterwards. */
+
+        QuantLib::ext::shared_ptr<SinglePrecisionContiguousInMemoryCube> fullCube;
+        auto maturities = tradeMaturities(portfolio);
+        auto cubeFactory = [this, &fullCube, &portfolio,
+                            &maturities](const QuantLib::Date& asof, const std::set<std::string>& ids,
+                                         const std::vector<QuantLib::Date>& dates,
+                                         const Size samples) -> QuantLib::ext::shared_ptr<NPVCube> {
+            if (!maturities.empty())
+                return QuantLib::ext::make_shared<SinglePrecisionJaggedCube>(asof, ids, dates, samples, cubeDepth_,
+                                                                             maturities);
+            if (fullCube == nullptr) {
+                // spill the cube to a file in the temp directory if it does not fit into the memory budget
+                std::string cubeDirectory = inputs_->mtCubeDirectory();
+                Size cubeBytes = portfolio->ids().size() * (dates.size() * samples + 1) * cubeDepth_ * sizeof(float);
+                if (cubeDirectory.empty() && cubeBytes > QuantExt::MemoryAccounting::instance().available()) {
+                    cubeDirectory = boost::filesystem::temp_directory_path().string();
+                    WLOG("XvaAnalytic: the cube (" << cubeBytes / 1024 / 1024
+                                                   << " MB) exceeds the remaining memory budget, it is stored in a "
+                                                      "memory mapped file in "
+                                                   << cubeDirectory);
+                }
+                if (cubeDirectory.empty()) {
+                    fullCube = QuantLib::ext::make_shared<SinglePrecisionContiguousInMemoryCube>(
+                        asof, portfolio->ids(), dates, samples, cubeDepth_, 0.0f);
+                } else {
+                    std::string filename = (boost::filesystem::path(cubeDirectory) /
+                                            boost::filesystem::unique_path("npvcube-%%%%-%%%%-%%%%-%%%%.dat"))
+                                               .string();
+                    LOG("XvaAnalytic: using memory mapped cube file " << filename);
+                    fullCube = QuantLib::ext::make_shared<SinglePrecisionMappedFileCube>(
+                        filename, asof, portfolio->ids(), dates, samples, cubeDepth_, 0.0f);
+                }
+            }
+            return fullCube->slice(ids);
         };
 
         std::function<QuantLib::ext::shared_ptr<NPVCube>(const QuantLib::Date&, const std::set<std::string>&,
@@ -405,16 +699,74 @@ void XvaAnalyticImpl::buildClassicCube(const QuantLib::ext::shared_ptr<Portfolio
             analytic()->configurations().todaysMarketParams, inputs_->marketConfig("simulation"),
             analytic()->configurations().simMarketParams, false, false, QuantLib::ext::make_shared<ScenarioFilter>(),
             inputs_->refDataManager(), *inputs_->iborFallbackConfig(), true, false, false, cubeFactory, {},
-            cptyCubeFactory, "xva-simulation", offsetScenario_);
+            cptyCubeFactory, "xva-simulation", offsetScenario_, inputs_->mtSharedInputs());
 
         engine.setAggregationScenarioData(*scenarioData_);
+        engine.setTradeChunkSize(inputs_->mtTradeChunkSize());
+        engine.setSplitSamples(inputs_->mtSplitSamples());
+
+        /* with split samples the threads generate the scenarios of their slices themselves, skipping the samples of
+           the previous slices, unless the scenarios are read from or written to a cache resp. report */
+
+        if (inputs_->mtSplitSamples() && offsetScenario_ == nullptr && inputs_->scenarioCacheFile().empty() &&
+            !inputs_->writeScenarios()) {
+            auto inputs = inputs_;
+            auto camData = analytic()->configurations().crossAssetModelData;
+            auto sgData = analytic()->configurations().scenarioGeneratorData;
+            auto simMarketParams = analytic()->configurations().simMarketParams;
+            engine.setScenarioGeneratorBuilder([inputs, camData, sgData, simMarketParams](
+                                                   const QuantLib::ext::shared_ptr<Market>& market) {
+                CrossAssetModelBuilder modelBuilder(
+                    market, camData, inputs->marketConfig("lgmcalibration"), inputs->marketConfig("fxcalibration"),
+                    inputs->marketConfig("eqcalibration"), inputs->marketConfig("infcalibration"),
+                    inputs->marketConfig("crcalibration"), inputs->marketConfig("simulation"), false, true, "",
+                    inputs->salvageCorrelationMatrix() ? SalvagingAlgorithm::Spectral : SalvagingAlgorithm::None,
+                    "xva cam building");
+                ScenarioGeneratorBuilder sgb(sgData);
+                return sgb.build(*modelBuilder.model(), QuantLib::ext::make_shared<SimpleScenarioFactory>(true),
+                                 simMarketParams, inputs->asof(), market, inputs->marketConfig("simulation"));
+            });
+        }
+        engine.setCompactScenarios(inputs_->mtCompactScenarios());
+        if (!checkpointKey.empty())
+            engine.setCheckpoint(inputs_->cubeCheckpointDirectory(), checkpointKey, inputs_->cubeCheckpointBlockSize());
+        if (!inputs_->mtPricingTimeFile().empty())
+            engine.setPricingTimeFile(inputs_->mtPricingTimeFile());
+        engine.setProfiling(inputs_->pricingProfile());
+        engine.setSkipCloseOutPricing(closeOutRegression);
+        engine.setObserverStatistics(inputs_->observerStatistics());
+        engine.setPruneObservers(inputs_->pruneObservers());
         engine.registerProgressIndicator(progressBar);
         engine.registerProgressIndicator(progressLog);
 
         engine.buildCube(portfolio, calculators, cptyCalculators,
                          analytic()->configurations().scenarioGeneratorData->withMporStickyDate());
 
-        cube_ = QuantLib::ext::make_shared<JointNPVCube>(engine.outputCubes(), portfolio->ids());
+        if (fullCube)
+            cube_ = fullCube;
+        else
+            cube_ = QuantLib::ext::make_shared<JointNPVCube>(engine.outputCubes(), portfolio->ids());
+
+        if (inputs_->pricingProfile())
+            writePricingProfile(engine.pricingProfiles());
+
+        if (inputs_->observerStatistics())
+            writeObserverStatistics(engine.tradeObserverStatistics(), engine.riskFactorObserverStatistics());
+
+        if (!inputs_->mtPricingTimeFile().empty() && !engine.partitionTimes().empty()) {
+            auto report = QuantLib::ext::make_shared<InMemoryReport>();
+            (*report)
+                .addColumn("Part", Size())
+                .addColumn("NumberOfTrades", Size())
+                .addColumn("PredictedTime", double(), 3)
+                .addColumn("ActualTime", double(), 3);
+            for (Size i = 0; i < engine.partitionTimes().size(); ++i) {
+                auto const& p = engine.partitionTimes()[i];
+                (*report).next().add(i).add(p.trades).add(p.predicted).add(p.actual);
+            }
+            report->end();
+            analytic()->reports()["XVA"]["partition_times"] = report;
+        }
 
         if (inputs_->storeSurvivalProbabilities())
             cptyCube_ = QuantLib::ext::make_shared<JointNPVCube>(
@@ -422,6 +774,13 @@ void XvaAnalyticImpl::buildClassicCube(const QuantLib::ext::shared_ptr<Portfolio
                 [](Real a, Real x) { return std::max(a, x); }, 0.0);
     }
 
+    if (closeOutRegression) {
+        LOG("XVA: estimate the close-out values by regression of order " << inputs_->closeOutRegressionOrder());
+        CloseOutRegression(grid_, cubeInterpreter_->defaultDateNpvIndex(), cubeInterpreter_->closeOutDateNpvIndex(),
+                           inputs_->closeOutRegressionOrder())
+            .fill(cube_, scenarioData_);
+    }
+
     CONSOLE("OK");
 
     LOG("XVA::buildCube done");
@@ -493,8 +852,7 @@ void XvaAnalyticImpl::amcRun(bool doClassicRun) {
 
     if (scenarioData_.empty()) {
         LOG("XVA: Create asd " << grid_->valuationDates().size() << " x " << samples_);
-        scenarioData_.linkTo(
-            QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(grid_->valuationDates().size(), samples_));
+        scenarioData_.linkTo(createScenarioData());
         simMarket_->aggregationScenarioData() = *scenarioData_;
     }
 
@@ -652,7 +1010,8 @@ void XvaAnalyticImpl::runPostProcessor() {
         kvaTheirPdFloor, kvaOurCvaRiskWeight, kvaTheirCvaRiskWeight, cptyCube_, flipViewBorrowingCurvePostfix,
         flipViewLendingCurvePostfix, inputs_->creditSimulationParameters(), inputs_->creditMigrationDistributionGrid(),
         inputs_->creditMigrationTimeSteps(), creditStateCorrelationMatrix(),
-        analytic()->configurations().scenarioGeneratorData->withMporStickyDate(), inputs_->mporCashFlowMode());
+        analytic()->configurations().scenarioGeneratorData->withMporStickyDate(), inputs_->mporCashFlowMode(),
+        inputs_->streamingExposure(), inputs_->nThreads());
     LOG("post done");
 }
 
@@ -669,13 +1028,18 @@ void XvaAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::data::InM
             inputs_->amcPricingEngine(), inputs_->crossAssetModelData(), inputs_->scenarioGeneratorData(),
             inputs_->portfolio(), inputs_->marketConfig("simulation"), inputs_->marketConfig("simulation"),
             inputs_->xvaCgSensiScenarioData(), inputs_->refDataManager(), *inputs_->iborFallbackConfig(),
-            inputs_->xvaCgBumpSensis(), inputs_->xvaCgUseExternalComputeDevice(),
+            inputs_->xvaCgBumpSensis(), inputs_->xvaCgForwardSensis(), inputs_->xvaCgExposureSensis(),
+            inputs_->xvaCgProfileEvaluation(), inputs_->xvaCgUseExternalComputeDevice(),
             inputs_->xvaCgExternalDeviceCompatibilityMode(), inputs_->xvaCgUseDoublePrecisionForExternalCalculation(),
             inputs_->xvaCgExternalComputeDevice(), true, true);
 
         analytic()->reports()["XVA"]["xvacg-exposure"] = engine.exposureReport();
         if (inputs_->xvaCgSensiScenarioData())
             analytic()->reports()["XVA"]["xvacg-cva-sensi-scenario"] = engine.sensiReport();
+        if (engine.exposureSensiReport())
+            analytic()->reports()["XVA"]["xvacg-exposure-sensi-scenario"] = engine.exposureSensiReport();
+        if (engine.profileReport())
+            analytic()->reports()["XVA"]["xvacg-profile"] = engine.profileReport();
         return;
     }
 
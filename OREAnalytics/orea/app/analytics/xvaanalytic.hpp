@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <orea/aggregation/exposureconvergence.hpp>
 #include <orea/app/analytic.hpp>
 
 namespace ore {
@@ -53,10 +54,18 @@ protected:
     void buildScenarioGenerator(bool continueOnError);
 
     void initCubeDepth();
-    void initCube(QuantLib::ext::shared_ptr<NPVCube>& cube, const std::set<std::string>& ids, Size cubeDepth);
+    /*! if maturities are given and the maturity truncated cube is enabled, the values are stored up to the trade
+        maturities only */
+    void initCube(QuantLib::ext::shared_ptr<NPVCube>& cube, const std::set<std::string>& ids, Size cubeDepth,
+                  const std::map<std::string, Date>& maturities = {});
+    QuantLib::ext::shared_ptr<AggregationScenarioData> createScenarioData() const;
+    //! the trade maturities if the maturity truncated cube is enabled, otherwise empty
+    std::map<std::string, Date> tradeMaturities(const QuantLib::ext::shared_ptr<Portfolio>& portfolio) const;
 
     void initClassicRun(const QuantLib::ext::shared_ptr<Portfolio>& portfolio);
     void buildClassicCube(const QuantLib::ext::shared_ptr<Portfolio>& portfolio);
+    //! Set the CVA weights of the convergence monitor from the counterparty default curves
+    void setCvaWeights(const QuantLib::ext::shared_ptr<Portfolio>& portfolio);
     QuantLib::ext::shared_ptr<Portfolio> classicRun(const QuantLib::ext::shared_ptr<Portfolio>& portfolio);
 
     QuantLib::ext::shared_ptr<EngineFactory>
@@ -80,6 +89,7 @@ protected:
     QuantLib::ext::shared_ptr<CubeInterpretation> cubeInterpreter_;
     QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator> dimCalculator_;
     QuantLib::ext::shared_ptr<PostProcess> postProcess_;
+    QuantLib::ext::shared_ptr<ExposureConvergenceMonitor> convergenceMonitor_;
     QuantLib::ext::shared_ptr<Scenario> offsetScenario_;
     QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> offsetSimMarketParams_;
     Size cubeDepth_ = 0;
@@ -33,11 +33,25 @@
 #include <orea/app/analyticsmanager.hpp>
 #include <orea/app/reportwriter.hpp>
 #include <orea/app/structuredanalyticserror.hpp>
+#include <orea/engine/observationmode.hpp>
 
+#include <ored/marketdata/fixings.hpp>
+#include <ored/model/calibrationresultcache.hpp>
+#include <ored/report/parquetreport.hpp>
 #include <ored/utilities/log.hpp>
+#include <ored/utilities/osutils.hpp>
+#include <ored/utilities/timers.hpp>
 #include <ored/utilities/to_string.hpp>
 
 #include <ql/errors.hpp>
+#include <ql/settings.hpp>
+
+#include <qle/utilities/memoryaccounting.hpp>
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 using namespace boost::filesystem;
@@ -45,6 +59,20 @@ using ore::data::InMemoryReport;
 
 namespace ore {
 namespace analytics {
+
+namespace {
+// add the current and peak bytes of each memory account and of the process after running the given analytic(s)
+void addMemoryUsage(InMemoryReport& report, const std::string& analytic) {
+    for (auto const a : QuantExt::MemoryAccounting::instance().accounts()) {
+        report.next().add(analytic).add(a->name()).add(a->current()).add(a->peak());
+    }
+    report.next()
+        .add(analytic)
+        .add("Process")
+        .add(static_cast<Size>(ore::data::os::getMemoryUsageBytes()))
+        .add(static_cast<Size>(ore::data::os::getPeakMemoryUsageBytes()));
+}
+} // namespace
     
 AnalyticsManager::AnalyticsManager(const QuantLib::ext::shared_ptr<InputParameters>& inputs, 
                                    const QuantLib::ext::shared_ptr<MarketDataLoader>& marketDataLoader)
@@ -113,6 +141,40 @@ void AnalyticsManager::runAnalytics(const QuantLib::ext::shared_ptr<MarketCalibr
     if (analytics_.size() == 0)
         return;
 
+    // the markets of a previous run can not be reused, the loader may have been populated differently
+    if (inputs_->marketCache())
+        inputs_->marketCache()->clear();
+
+    auto& timerRegistry = ore::data::TimerRegistry::instance();
+    if (inputs_->runtimeStatistics()) {
+        timerRegistry.reset();
+        timerRegistry.enable(true, !inputs_->traceFile().empty());
+    }
+
+    auto& calibrationCache = ore::data::CalibrationResultCache::instance();
+    bool previousCalibrationCache = calibrationCache.enabled();
+    if (inputs_->calibrationCache()) {
+        calibrationCache.enable(true);
+        if (!inputs_->calibrationCacheFile().empty() && exists(inputs_->calibrationCacheFile()))
+            calibrationCache.load(inputs_->calibrationCacheFile());
+    }
+
+    auto& memoryAccounting = QuantExt::MemoryAccounting::instance();
+    std::size_t previousMemoryBudget = memoryAccounting.budget();
+    bool previousMemoryAccounting = memoryAccounting.enabled();
+    if (inputs_->memoryBudget() > 0 || inputs_->memoryStatistics())
+        memoryAccounting.enable(true);
+    if (inputs_->memoryBudget() > 0)
+        memoryAccounting.setBudget(inputs_->memoryBudget() * 1024 * 1024);
+    QuantLib::ext::shared_ptr<InMemoryReport> memoryReport;
+    if (inputs_->memoryStatistics()) {
+        memoryReport = QuantLib::ext::make_shared<InMemoryReport>();
+        memoryReport->addColumn("Analytic", string())
+            .addColumn("Component", string())
+            .addColumn("CurrentBytes", Size())
+            .addColumn("PeakBytes", Size());
+    }
+
     std::vector<QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>> tmps = todaysMarketParams();
     std::set<Date> marketDates;
     for (const auto& a : analytics_) {
@@ -133,6 +195,7 @@ void AnalyticsManager::runAnalytics(const QuantLib::ext::shared_ptr<MarketCalibr
         // load the market data
         if (tmps.size() > 0) {
             LOG("AnalyticsManager::runAnalytics: populate loader for dates: " << to_string(marketDates));
+            ORE_TIMER("market data loading");
             marketDataLoader_->populateLoader(tmps, marketDates);
         }
         
@@ -154,11 +217,47 @@ void AnalyticsManager::runAnalytics(const QuantLib::ext::shared_ptr<MarketCalibr
         reports_["DIVIDENDS"]["dividends"] = dividendReport;
     }
 
+    /* run the analytics that support it concurrently if more than one analytics thread is configured, the others
+       sequentially afterwards */
+    std::vector<std::pair<std::string, QuantLib::ext::shared_ptr<Analytic>>> concurrentAnalytics;
+    for (auto const& a : analytics_) {
+        if (a.second->supportsConcurrentRun())
+            concurrentAnalytics.push_back(a);
+    }
+    Size nAnalyticsThreads = std::min(inputs_->nAnalyticsThreads(), concurrentAnalytics.size());
+#ifndef QL_ENABLE_SESSIONS
+    if (nAnalyticsThreads > 1) {
+        WLOG("AnalyticsManager::runAnalytics: running analytics concurrently requires a build with "
+             "QL_ENABLE_SESSIONS = ON, running them sequentially.");
+        nAnalyticsThreads = 1;
+    }
+#endif
+    std::set<std::string> finished;
+    if (nAnalyticsThreads > 1) {
+        if (memoryReport)
+            memoryAccounting.resetPeaks();
+        runConcurrently(concurrentAnalytics, nAnalyticsThreads, marketCalibrationReport);
+        std::string labels;
+        for (auto const& a : concurrentAnalytics) {
+            finished.insert(a.first);
+            labels += (labels.empty() ? "" : ",") + a.first;
+        }
+        if (memoryReport)
+            addMemoryUsage(*memoryReport, labels);
+    }
+
     // run requested analytics
     for (auto a : analytics_) {
+        if (finished.find(a.first) != finished.end())
+            continue;
         LOG("run analytic with label '" << a.first << "'");
+        if (memoryReport)
+            memoryAccounting.resetPeaks();
+        ORE_TIMER(a.first);
         a.second->runAnalytic(marketDataLoader_->loader(), inputs_->analytics());
         LOG("run analytic with label '" << a.first << "' finished.");
+        if (memoryReport)
+            addMemoryUsage(*memoryReport, a.first);
         // then populate the market calibration report if required
         if (marketCalibrationReport)
             a.second->marketCalibration(marketCalibrationReport);
@@ -179,14 +278,158 @@ void AnalyticsManager::runAnalytics(const QuantLib::ext::shared_ptr<MarketCalibr
         }
     }
 
+    if (inputs_->marketCache())
+        inputs_->marketCache()->clear();
+
+    if (inputs_->runtimeStatistics()) {
+        timerRegistry.enable(false);
+        auto runtimeStatisticsReport = QuantLib::ext::make_shared<InMemoryReport>();
+        ReportWriter(inputs_->reportNaString()).writeRuntimeStatistics(*runtimeStatisticsReport);
+        reports_["STATS"]["runtimestatistics"] = runtimeStatisticsReport;
+        if (!inputs_->traceFile().empty())
+            timerRegistry.writeChromeTrace((inputs_->resultsPath() / inputs_->traceFile()).string());
+    }
+
+    if (memoryReport) {
+        memoryReport->end();
+        reports_["STATS"]["memoryusage"] = memoryReport;
+    }
+    memoryAccounting.setBudget(previousMemoryBudget);
+    memoryAccounting.enable(previousMemoryAccounting);
+
+    if (inputs_->calibrationCache()) {
+        if (!inputs_->calibrationCacheFile().empty())
+            calibrationCache.save(inputs_->calibrationCacheFile());
+        calibrationCache.enable(previousCalibrationCache);
+    }
+
     inputs_->writeOutParameters();
 }
 
+namespace {
+// replaces the inputs of an analytic and of its dependent analytics, where they are the given ones
+void replaceInputs(const QuantLib::ext::shared_ptr<Analytic>& analytic,
+                   const QuantLib::ext::shared_ptr<InputParameters>& from,
+                   const QuantLib::ext::shared_ptr<InputParameters>& to) {
+    auto analytics = analytic->allDependentAnalytics();
+    analytics.push_back(analytic);
+    for (auto const& a : analytics) {
+        if (a->inputs() != from)
+            continue;
+        a->setInputs(to);
+        a->impl()->setInputs(to);
+    }
+}
+} // namespace
+
+void AnalyticsManager::runConcurrently(
+    const std::vector<std::pair<std::string, QuantLib::ext::shared_ptr<Analytic>>>& analytics, const Size nThreads,
+    const QuantLib::ext::shared_ptr<MarketCalibrationReportBase>& marketCalibrationReport) {
+
+    LOG("AnalyticsManager::runConcurrently: run " << analytics.size() << " analytics using " << nThreads
+                                                  << " threads");
+
+    /* The trades of the input portfolio can not be built against several markets at the same time, each analytic
+       gets its own copy, parsed from the binary representation in the worker thread */
+
+    std::string portfolioAsString;
+    if (inputs_->portfolio())
+        portfolioAsString = inputs_->portfolio()->toBinaryString();
+    std::vector<QuantLib::ext::shared_ptr<ore::data::Portfolio>> portfolios(analytics.size());
+
+    /* each analytic runs on its own copy of the inputs, so that no analytic sees the modifications of another one,
+       the copies share the thread budget for the valuation engines; the copies are shallow, i.e. the objects held by
+       pointer (portfolio, configurations, market cache, ...) are still shared */
+
+    std::vector<QuantLib::ext::shared_ptr<InputParameters>> inputs(analytics.size());
+    for (Size i = 0; i < analytics.size(); ++i) {
+        inputs[i] = QuantLib::ext::make_shared<InputParameters>(*inputs_);
+        inputs[i]->setThreads(std::max<Size>(1, inputs_->nThreads() / nThreads));
+        replaceInputs(analytics[i].second, inputs_, inputs[i]);
+    }
+
+    /* the loader is shared by all analytics, this is safe as long as it is only read while they run, note that the
+       loaders (InMemoryLoader, CSVLoader) do not lock their data */
+
+    // set the thread local singletons in the worker threads as in the main thread
+
+    QuantLib::Date today = QuantLib::Settings::instance().evaluationDate();
+    bool includeReferenceDateEvents = QuantLib::Settings::instance().includeReferenceDateEvents();
+    boost::optional<bool> includeTodaysCashFlows = QuantLib::Settings::instance().includeTodaysCashFlows();
+    bool enforcesTodaysHistoricFixings = QuantLib::Settings::instance().enforcesTodaysHistoricFixings();
+    ore::data::FixingHistories fixingHistories = ore::data::getFixingHistories();
+    ObservationMode::Mode obsMode = ObservationMode::instance().mode();
+
+    std::atomic<Size> next(0);
+    std::vector<std::exception_ptr> errors(analytics.size());
+    std::mutex calibrationMutex;
+    std::vector<std::thread> jobs;
+
+    for (Size t = 0; t < nThreads; ++t) {
+        jobs.emplace_back([&, t]() {
+            QuantLib::Settings::instance().evaluationDate() = today;
+            QuantLib::Settings::instance().includeReferenceDateEvents() = includeReferenceDateEvents;
+            QuantLib::Settings::instance().includeTodaysCashFlows() = includeTodaysCashFlows;
+            QuantLib::Settings::instance().enforcesTodaysHistoricFixings() = enforcesTodaysHistoricFixings;
+            ObservationMode::instance().setMode(obsMode);
+            ore::data::applyFixingHistories(fixingHistories);
+
+            for (Size i = next++; i < analytics.size(); i = next++) {
+                auto const& [label, analytic] = analytics[i];
+                try {
+                    LOG("run analytic with label '" << label << "' in thread " << t);
+                    ORE_TIMER(label);
+                    if (!portfolioAsString.empty() && !analytic->portfolio()) {
+                        portfolios[i] =
+                            QuantLib::ext::make_shared<ore::data::Portfolio>(inputs[i]->buildFailedTrades());
+                        portfolios[i]->fromBinaryString(portfolioAsString);
+                        analytic->setPortfolio(portfolios[i]);
+                    }
+                    analytic->runAnalytic(marketDataLoader_->loader(), inputs[i]->analytics());
+                    LOG("run analytic with label '" << label << "' finished.");
+                    if (marketCalibrationReport) {
+                        std::lock_guard<std::mutex> lock(calibrationMutex);
+                        analytic->marketCalibration(marketCalibrationReport);
+                    }
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            }
+        });
+    }
+
+    for (auto& j : jobs)
+        j.join();
+
+    for (Size i = 0; i < analytics.size(); ++i)
+        replaceInputs(analytics[i].second, inputs[i], inputs_);
+
+    // add the pricing stats of the copies to the input portfolio, from which the pricing stats report is written
+
+    for (auto const& p : portfolios) {
+        if (!p)
+            continue;
+        for (auto const& [tradeId, trade] : p->trades()) {
+            if (!inputs_->portfolio()->has(tradeId))
+                continue;
+            auto t = inputs_->portfolio()->get(tradeId);
+            t->resetPricingStats(t->getNumberOfPricings() + trade->getNumberOfPricings(),
+                                 t->getCumulativePricingTime() + trade->getCumulativePricingTime());
+        }
+    }
+
+    for (auto const& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
+}
+
 Analytic::analytic_reports const AnalyticsManager::reports() {
     Analytic::analytic_reports reports = reports_;
+    // merge the reports of the analytics per report type, so that several analytics can contribute to one type
     for (auto a : analytics_) {
-        auto rs = a.second->reports();
-        reports.insert(rs.begin(), rs.end());
+        for (auto const& [type, rs] : a.second->reports())
+            reports[type].insert(rs.begin(), rs.end());
     }
     return reports;
 }
@@ -246,7 +489,7 @@ bool endsWith(const std::string& name, const std::string& suffix) {
 void AnalyticsManager::toFile(const ore::analytics::Analytic::analytic_reports& rpts, const std::string& outputPath,
                               const std::map<std::string, std::string>& reportNames, const char sep,
                               const bool commentCharacter, char quoteChar, const string& nullString,
-                              const std::set<std::string>& lowerHeaderReportNames) {
+                              const std::set<std::string>& lowerHeaderReportNames, const std::string& format) {
     std::map<std::string, Size> hits = checkReportNames(rpts);    
     for (const auto& rep : rpts) {
         string analytic = rep.first;
@@ -266,6 +509,22 @@ void AnalyticsManager::toFile(const ore::analytics::Analytic::analytic_reports&
                 fileName = analytic + "_" + reportName + "_" + to_string(hits[fileName]);
             }
 
+            if (format == "parquet") {
+                // replace a csv or txt suffix
+                if (endsWith(fileName, ".csv") || endsWith(fileName, ".txt"))
+                    fileName = fileName.substr(0, fileName.size() - 4);
+                std::string fullFileName = outputPath + "/" + fileName + ".parquet";
+#ifdef ORE_USE_ARROW
+                ParquetFileReport parquetReport(fullFileName);
+                report->toReport(parquetReport);
+#else
+                QL_FAIL("can not write report " << reportName << ", report format parquet requires a build with "
+                                                << "ORE_USE_ARROW = ON");
+#endif
+                LOG("report " << reportName << " written to " << fullFileName);
+                continue;
+            }
+
             // attach a suffix only if it does not have one already
             string suffix = "";
             if (!endsWith(fileName,".csv") && !endsWith(fileName, ".txt"))
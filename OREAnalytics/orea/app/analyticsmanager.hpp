@@ -61,13 +61,18 @@ public:
     Analytic::analytic_stresstests const stressTests();
     
     // Write all reports to files, reportNames map can be used to replace standard report names
-    // with custom names
+    // with custom names, format is csv or parquet, the csv options are ignored for parquet
     void toFile(const Analytic::analytic_reports& reports, const std::string& outputPath,
                 const std::map<std::string, std::string>& reportNames = {}, const char sep = ',',
                 const bool commentCharacter = false, char quoteChar = '\0', const string& nullString = "#N/A",
-                const std::set<std::string>& lowerHeaderReportNames = {});
+                const std::set<std::string>& lowerHeaderReportNames = {}, const std::string& format = "csv");
 
 private:
+    // run the given analytics in nThreads threads, each on its own copy of the input portfolio
+    void runConcurrently(const std::vector<std::pair<std::string, QuantLib::ext::shared_ptr<Analytic>>>& analytics,
+                         const Size nThreads,
+                         const QuantLib::ext::shared_ptr<MarketCalibrationReportBase>& marketCalibrationReport);
+
     std::map<std::string, QuantLib::ext::shared_ptr<Analytic>> analytics_;
     QuantLib::ext::shared_ptr<InputParameters> inputs_;
     QuantLib::ext::shared_ptr<MarketDataLoader> marketDataLoader_;
@@ -19,9 +19,12 @@
 #include <orea/app/cleanupsingletons.hpp>
 #include <orea/engine/observationmode.hpp>
 
+#include <ored/portfolio/schedulecache.hpp>
 #include <ored/portfolio/scriptedtrade.hpp>
+#include <ored/scripting/scriptcache.hpp>
 #include <ored/utilities/calendarparser.hpp>
 #include <ored/utilities/currencyparser.hpp>
+#include <ored/utilities/indexcache.hpp>
 #include <ored/utilities/indexnametranslator.hpp>
 #include <ored/utilities/log.hpp>
 
@@ -44,9 +47,12 @@ CleanUpThreadLocalSingletons::~CleanUpThreadLocalSingletons() {
 CleanUpThreadGlobalSingletons::~CleanUpThreadGlobalSingletons() {
     ore::data::InstrumentConventions::instance().clear();
     ore::data::IndexNameTranslator::instance().clear();
+    ore::data::IndexCache::instance().clear();
     ore::data::CalendarParser::instance().reset();
     ore::data::CurrencyParser::instance().reset();
     ore::data::ScriptLibraryStorage::instance().clear();
+    ore::data::ScriptCache::instance().clear();
+    ore::data::ScheduleCache::instance().clear();
 }
 
 CleanUpLogSingleton::CleanUpLogSingleton(const bool removeLoggers, const bool clearIndependentLoggers)
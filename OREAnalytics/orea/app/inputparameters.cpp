@@ -21,6 +21,7 @@
 #include <orea/cube/cube_io.hpp>
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/sensitivityfilestream.hpp>
+#include <orea/scenario/historicalscenariobinaryreader.hpp>
 #include <orea/scenario/historicalscenariofilereader.hpp>
 #include <orea/scenario/shiftscenariogenerator.hpp>
 #include <orea/scenario/simplescenariofactory.hpp>
@@ -28,6 +29,7 @@
 #include <ored/configuration/currencyconfig.hpp>
 #include <ored/utilities/calendaradjustmentconfig.hpp>
 #include <ored/utilities/parsers.hpp>
+#include <ored/portfolio/lazyreferencedatamanager.hpp>
 #include <ored/portfolio/scriptedtrade.hpp>
 #include <orea/simm/crifloader.hpp>
 
@@ -67,8 +69,19 @@ void InputParameters::setRefDataManager(const std::string& xml) {
     refDataManager_->fromXMLString(xml);
 }
 
-void InputParameters::setRefDataManagerFromFile(const std::string& fileName) {
-    refDataManager_ = QuantLib::ext::make_shared<BasicReferenceDataManager>(fileName);
+void InputParameters::setRefDataManagerFromFile(const std::string& fileName, bool lazy) {
+    if (lazy)
+        refDataManager_ = QuantLib::ext::make_shared<LazyReferenceDataManager>(fileName);
+    else
+        refDataManager_ = QuantLib::ext::make_shared<BasicReferenceDataManager>(fileName);
+}
+
+void InputParameters::setReportFormat(const std::string& s) {
+    QL_REQUIRE(s == "csv" || s == "parquet", "report format '" << s << "' not recognised, expected csv or parquet");
+#ifndef ORE_USE_ARROW
+    QL_REQUIRE(s != "parquet", "report format parquet requires a build with ORE_USE_ARROW = ON");
+#endif
+    reportFormat_ = s;
 }
 
 void InputParameters::setScriptLibrary(const std::string& xml) {
@@ -441,11 +454,15 @@ void InputParameters::setCovarianceDataFromBuffer(const std::string& xml) {
 }
 
 void InputParameters::setSensitivityStreamFromFile(const std::string& fileName) {
-    sensitivityStream_ = QuantLib::ext::make_shared<SensitivityFileStream>(fileName);
+    auto stream = QuantLib::ext::make_shared<SensitivityFileStream>(fileName);
+    stream->setThreads(nThreads_);
+    sensitivityStream_ = stream;
 }
 
 void InputParameters::setSensitivityStreamFromBuffer(const std::string& buffer) {
-    sensitivityStream_ = QuantLib::ext::make_shared<SensitivityBufferStream>(buffer);
+    auto stream = QuantLib::ext::make_shared<SensitivityBufferStream>(buffer);
+    stream->setThreads(nThreads_);
+    sensitivityStream_ = stream;
 }
 
 void InputParameters::setBenchmarkVarPeriod(const std::string& period) { 
@@ -457,8 +474,11 @@ void InputParameters::setHistoricalScenarioReader(const std::string& fileName) {
     QL_REQUIRE(exists(baseScenarioPath), "The provided base scenario file, " << baseScenarioPath << ", does not exist");
     QL_REQUIRE(is_regular_file(baseScenarioPath),
                "The provided base scenario file, " << baseScenarioPath << ", is not a file");
-    historicalScenarioReader_ = QuantLib::ext::make_shared<HistoricalScenarioFileReader>(
-        fileName, QuantLib::ext::make_shared<SimpleScenarioFactory>(false));
+    if (isBinaryScenarioFile(fileName))
+        historicalScenarioReader_ = QuantLib::ext::make_shared<HistoricalScenarioBinaryReader>(fileName, nThreads_);
+    else
+        historicalScenarioReader_ = QuantLib::ext::make_shared<HistoricalScenarioFileReader>(
+            fileName, QuantLib::ext::make_shared<SimpleScenarioFactory>(false));
 }
 
 void InputParameters::setAmcTradeTypes(const std::string& s) {
@@ -539,18 +559,27 @@ void InputParameters::setCreditSimulationParametersFromBuffer(const std::string&
 void InputParameters::setCrifFromFile(const std::string& fileName, char eol, char delim, char quoteChar, char escapeChar) {
     bool updateMappings = true;
     bool aggregateTrades = false;
-    auto crifLoader = CsvFileCrifLoader(fileName, getSimmConfiguration(), CrifRecord::additionalHeaders, updateMappings,
-                                        aggregateTrades, eol, delim, quoteChar, escapeChar, reportNaString());
-    crif_ = crifLoader.loadCrif();
+    auto crifLoader = QuantLib::ext::make_shared<CsvFileCrifLoader>(
+        fileName, getSimmConfiguration(), CrifRecord::additionalHeaders, updateMappings, aggregateTrades, eol, delim,
+        quoteChar, escapeChar, reportNaString());
+    crifLoader->setThreads(nThreads_);
+    if (simmStreamCrif_)
+        crifLoader_ = crifLoader;
+    else
+        crif_ = crifLoader->loadCrif();
 }
 
 void InputParameters::setCrifFromBuffer(const std::string& csvBuffer, char eol, char delim, char quoteChar, char escapeChar) {
     bool updateMappings = true;
     bool aggregateTrades = false;
-    auto crifLoader =
-        CsvBufferCrifLoader(csvBuffer, getSimmConfiguration(), CrifRecord::additionalHeaders, updateMappings,
-                            aggregateTrades, eol, delim, quoteChar, escapeChar, reportNaString());
-    crif_ = crifLoader.loadCrif();
+    auto crifLoader = QuantLib::ext::make_shared<CsvBufferCrifLoader>(
+        csvBuffer, getSimmConfiguration(), CrifRecord::additionalHeaders, updateMappings, aggregateTrades, eol, delim,
+        quoteChar, escapeChar, reportNaString());
+    crifLoader->setThreads(nThreads_);
+    if (simmStreamCrif_)
+        crifLoader_ = crifLoader;
+    else
+        crif_ = crifLoader->loadCrif();
 }
 
 void InputParameters::setSimmNameMapper(const std::string& xml) {
@@ -24,6 +24,7 @@
 
 #include <boost/filesystem/path.hpp>
 #include <orea/aggregation/creditsimulationparameters.hpp>
+#include <orea/app/marketcache.hpp>
 #include <orea/app/parameters.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <orea/engine/sensitivitystream.hpp>
@@ -80,7 +81,7 @@ public:
     void setImplyTodaysFixings(bool b) { implyTodaysFixings_ = b; }
     void setMarketConfig(const std::string& config, const std::string& context);
     void setRefDataManager(const std::string& xml);
-    void setRefDataManagerFromFile(const std::string& fileName);
+    void setRefDataManagerFromFile(const std::string& fileName, bool lazy = false);
     void setScriptLibrary(const std::string& xml);
     void setScriptLibraryFromFile(const std::string& fileName);
     void setConventions(const std::string& xml);
@@ -97,6 +98,33 @@ public:
     void setPortfolioFromFile(const std::string& fileNameString, const std::filesystem::path& inputPath); 
     void setMarketConfigs(const std::map<std::string, std::string>& m);
     void setThreads(int i) { nThreads_ = i; }
+    void setAnalyticsThreads(int i) { nAnalyticsThreads_ = i; }
+    void setShareMarkets(bool b) { marketCache_ = b ? QuantLib::ext::make_shared<MarketCache>() : nullptr; }
+    void setRuntimeStatistics(bool b) { runtimeStatistics_ = b; }
+    void setTraceFile(const std::string& s) { traceFile_ = s; }
+    void setPricingProfile(bool b) { pricingProfile_ = b; }
+    void setObserverStatistics(bool b) { observerStatistics_ = b; }
+    void setPruneObservers(bool b) { pruneObservers_ = b; }
+    void setSinglePrecisionScenarioData(bool b) { singlePrecisionScenarioData_ = b; }
+    void setMemoryStatistics(bool b) { memoryStatistics_ = b; }
+    void setMemoryBudget(Size megaBytes) { memoryBudget_ = megaBytes; }
+    void setCalibrationCache(bool b) { calibrationCache_ = b; }
+    void setCalibrationCacheFile(const std::string& s) { calibrationCacheFile_ = s; }
+    void setMtSharedInputs(bool b) { mtSharedInputs_ = b; }
+    void setMtTradeChunkSize(Size s) { mtTradeChunkSize_ = s; }
+    void setMtSplitSamples(bool b) { mtSplitSamples_ = b; }
+    void setMtCompactScenarios(bool b) { mtCompactScenarios_ = b; }
+    void setMtCubeDirectory(const std::string& s) { mtCubeDirectory_ = s; }
+    void setMaturityTruncatedCube(bool b) { maturityTruncatedCube_ = b; }
+    void setCloseOutRegression(bool b) { closeOutRegression_ = b; }
+    void setCloseOutRegressionOrder(Size s) { closeOutRegressionOrder_ = s; }
+    void setMtPricingTimeFile(const std::string& s) { mtPricingTimeFile_ = s; }
+    void setDistributedWorkerCommand(const std::string& s) { distributedWorkerCommand_ = s; }
+    void setDistributedPartitions(Size s) { distributedPartitions_ = s; }
+    void setDistributedMaxWorkers(Size s) { distributedMaxWorkers_ = s; }
+    void setDistributedJobDirectory(const std::string& s) { distributedJobDirectory_ = s; }
+    void setCubeCheckpointDirectory(const std::string& s) { cubeCheckpointDirectory_ = s; }
+    void setCubeCheckpointBlockSize(Size s) { cubeCheckpointBlockSize_ = s; }
     void setEntireMarket(bool b) { entireMarket_ = b; }
     void setAllFixings(bool b) { allFixings_ = b; }
     void setEomInflationFixings(bool b) { eomInflationFixings_ = b; }
@@ -106,6 +134,8 @@ public:
     void setCsvQuoteChar(const char& c){ csvQuoteChar_ = c; }
     void setCsvSeparator(const char& c) { csvSeparator_ = c; }
     void setCsvCommentCharacter(const char& c) { csvCommentCharacter_ = c; }
+    // csv or parquet, the latter requires a build with ORE_USE_ARROW = ON
+    void setReportFormat(const std::string& s);
     void setDryRun(bool b) { dryRun_ = b; }
     void setMporDays(Size s) { mporDays_ = s; }
     void setMporOverlappingPeriods(bool b) { mporOverlappingPeriods_ = b; }
@@ -131,6 +161,10 @@ public:
     void setOptimiseRiskFactors(bool b) { optimiseRiskFactors_ = b; }
     void setAlignPillars(bool b) { alignPillars_ = b; }
     void setOutputJacobi(bool b) { outputJacobi_ = b; }
+    void setSensiAadDeltas(bool b) { sensiAadDeltas_ = b; }
+    void setSensiSkipUnaffectedTrades(bool b) { sensiSkipUnaffectedTrades_ = b; }
+    void setParSensiCacheFile(const std::string& s) { parSensiCacheFile_ = s; }
+    void setParSensiCacheTolerance(Real r) { parSensiCacheTolerance_ = r; }
     void setUseSensiSpreadedTermStructures(bool b) { useSensiSpreadedTermStructures_ = b; }
     void setSensiThreshold(Real r) { sensiThreshold_ = r; }
     void setSensiRecalibrateModels(bool b) { sensiRecalibrateModels_ = b; }
@@ -152,6 +186,7 @@ public:
     // Setters for stress testing
     void setStressThreshold(Real r) { stressThreshold_ = r; }
     void setStressOptimiseRiskFactors(bool optimise) { stressOptimiseRiskFactors_ = optimise; }
+    void setStressSkipUnaffectedTrades(bool b) { stressSkipUnaffectedTrades_ = b; }
     void setStressSimMarketParams(const std::string& xml); 
     void setStressSimMarketParamsFromFile(const std::string& fileName); 
     void setStressScenarioData(const std::string& xml); 
@@ -188,12 +223,16 @@ public:
     void setHistVarSimMarketParams(const std::string& xml);
     void setHistVarSimMarketParamsFromFile(const std::string& fileName);
     void setOutputHistoricalScenarios(const bool b) { outputHistoricalScenarios_ = b; }
+    void setHistVarSensiPnlGammaThreshold(Real r) { histVarSensiPnlGammaThreshold_ = r; }
 
     // Setters for exposure simulation
     void setSalvageCorrelationMatrix(bool b) { salvageCorrelationMatrix_ = b; }
     void setAmc(bool b) { amc_ = b; }
     void setAmcCg(bool b) { amcCg_ = b; }
     void setXvaCgBumpSensis(bool b) { xvaCgBumpSensis_ = b; }
+    void setXvaCgForwardSensis(bool b) { xvaCgForwardSensis_ = b; }
+    void setXvaCgExposureSensis(bool b) { xvaCgExposureSensis_ = b; }
+    void setXvaCgProfileEvaluation(bool b) { xvaCgProfileEvaluation_ = b; }
     void setXvaCgUseExternalComputeDevice(bool b) { xvaCgUseExternalComputeDevice_ = b; }
     void setXvaCgExternalDeviceCompatibilityMode(bool b) { xvaCgExternalDeviceCompatibilityMode_ = b; }
     void setXvaCgUseDoublePrecisionForExternalCalculation(bool b) { xvaCgUseDoublePrecisionForExternalCalculation_ = b; }
@@ -208,8 +247,12 @@ public:
     void setStoreFlows(bool b) { storeFlows_ = b; }
     void setStoreCreditStateNPVs(Size states) { storeCreditStateNPVs_ = states; }
     void setStoreSurvivalProbabilities(bool b) { storeSurvivalProbabilities_ = b; }
+    void setExposureConvergenceTolerance(Real r) { exposureConvergenceTolerance_ = r; }
+    void setExposureConvergenceMinSamples(Size s) { exposureConvergenceMinSamples_ = s; }
+    void setExposureConvergenceBlockSize(Size s) { exposureConvergenceBlockSize_ = s; }
     void setWriteCube(bool b) { writeCube_ = b; }
     void setWriteScenarios(bool b) { writeScenarios_ = b; }
+    void setScenarioCacheFile(const std::string& s) { scenarioCacheFile_ = s; }
     void setExposureSimMarketParams(const std::string& xml);
     void setExposureSimMarketParamsFromFile(const std::string& fileName);
     void setScenarioGeneratorData(const std::string& xml);
@@ -249,6 +292,7 @@ public:
     // QuantLib::ext::shared_ptr<AggregationScenarioData> mktCube();
     void setFlipViewXVA(bool b) { flipViewXVA_ = b; }
     void setMporCashFlowMode(const MporCashFlowMode m) { mporCashFlowMode_ = m; }
+    void setStreamingExposure(bool b) { streamingExposure_ = b; }
     void setFullInitialCollateralisation(bool b) { fullInitialCollateralisation_ = b; }
     void setExposureProfiles(bool b) { exposureProfiles_ = b; }
     void setExposureProfilesByTrade(bool b) { exposureProfilesByTrade_ = b; }
@@ -359,6 +403,9 @@ public:
     void setSimmReportingCurrency(const std::string& s) { simmReportingCurrency_ = s; }
     void setEnforceIMRegulations(bool b) { enforceIMRegulations_= b; }
     void setWriteSimmIntermediateReports(bool b) { writeSimmIntermediateReports_ = b; }
+    void setSimmTradeAllocation(bool b) { simmTradeAllocation_ = b; }
+    //! If set before the CRIF is set, the CRIF is not loaded but streamed netting set by netting set in the analytic
+    void setSimmStreamCrif(bool b) { simmStreamCrif_ = b; }
 
     // Setters for ZeroToParSensiConversion
     void setParConversionXbsParConversion(bool b) { parConversionXbsParConversion_ = b; }
@@ -451,6 +498,41 @@ public:
 
     QuantLib::Size maxRetries() const { return maxRetries_; }
     QuantLib::Size nThreads() const { return nThreads_; }
+    QuantLib::Size nAnalyticsThreads() const { return nAnalyticsThreads_; }
+    // the cache of the markets shared between the analytics of a run, null if markets are not shared
+    const QuantLib::ext::shared_ptr<MarketCache>& marketCache() const { return marketCache_; }
+    bool runtimeStatistics() const { return runtimeStatistics_; }
+    // the file name of the Chrome trace of the timers, relative to the results path, empty if no trace is written
+    const std::string& traceFile() const { return traceFile_; }
+    bool pricingProfile() const { return pricingProfile_; }
+    bool observerStatistics() const { return observerStatistics_; }
+    bool pruneObservers() const { return pruneObservers_; }
+    // store the aggregation scenario data of the exposure simulation in single precision
+    bool singlePrecisionScenarioData() const { return singlePrecisionScenarioData_; }
+    bool memoryStatistics() const { return memoryStatistics_; }
+    // the memory budget in MB for the accounted components, 0 if there is no budget
+    QuantLib::Size memoryBudget() const { return memoryBudget_; }
+    // share calibration results between the models of the run, always true if a calibration cache file is given
+    bool calibrationCache() const { return calibrationCache_ || !calibrationCacheFile_.empty(); }
+    // the file the calibration results are loaded from (if it exists) and written to, empty if they are not persisted
+    const std::string& calibrationCacheFile() const { return calibrationCacheFile_; }
+    bool mtSharedInputs() const { return mtSharedInputs_; }
+    QuantLib::Size mtTradeChunkSize() const { return mtTradeChunkSize_; }
+    bool mtSplitSamples() const { return mtSplitSamples_; }
+    bool mtCompactScenarios() const { return mtCompactScenarios_; }
+    const std::string& mtCubeDirectory() const { return mtCubeDirectory_; }
+    // store the exposure simulation npvs of each trade up to its maturity only
+    bool maturityTruncatedCube() const { return maturityTruncatedCube_; }
+    // estimate the close-out npvs from the valuation date npvs instead of pricing on the close-out dates
+    bool closeOutRegression() const { return closeOutRegression_; }
+    Size closeOutRegressionOrder() const { return closeOutRegressionOrder_; }
+    const std::string& mtPricingTimeFile() const { return mtPricingTimeFile_; }
+    const std::string& distributedWorkerCommand() const { return distributedWorkerCommand_; }
+    QuantLib::Size distributedPartitions() const { return distributedPartitions_; }
+    QuantLib::Size distributedMaxWorkers() const { return distributedMaxWorkers_; }
+    const std::string& distributedJobDirectory() const { return distributedJobDirectory_; }
+    const std::string& cubeCheckpointDirectory() const { return cubeCheckpointDirectory_; }
+    QuantLib::Size cubeCheckpointBlockSize() const { return cubeCheckpointBlockSize_; }
     bool entireMarket() const { return entireMarket_; }
     bool allFixings() const { return allFixings_; }
     bool eomInflationFixings() const { return eomInflationFixings_; }
@@ -462,6 +544,7 @@ public:
     char csvQuoteChar() const { return csvQuoteChar_; }
     char csvSeparator() const { return csvSeparator_; }
     char csvEscapeChar() const { return csvEscapeChar_; }
+    const std::string& reportFormat() const { return reportFormat_; }
     bool dryRun() const { return dryRun_; }
     QuantLib::Size mporDays() const { return mporDays_; }
     QuantLib::Date mporDate();
@@ -502,6 +585,10 @@ public:
     bool optimiseRiskFactors() const { return optimiseRiskFactors_; }
     bool alignPillars() const { return alignPillars_; };
     bool outputJacobi() const { return outputJacobi_; };
+    bool sensiAadDeltas() const { return sensiAadDeltas_; }
+    bool sensiSkipUnaffectedTrades() const { return sensiSkipUnaffectedTrades_; }
+    const std::string& parSensiCacheFile() const { return parSensiCacheFile_; }
+    Real parSensiCacheTolerance() const { return parSensiCacheTolerance_; }
     bool useSensiSpreadedTermStructures() const { return useSensiSpreadedTermStructures_; }
     QuantLib::Real sensiThreshold() const { return sensiThreshold_; }
     bool sensiRecalibrateModels() const { return sensiRecalibrateModels_; }
@@ -527,6 +614,7 @@ public:
         return stressSensitivityScenarioData_;
     }
     bool stressOptimiseRiskFactors() const { return stressOptimiseRiskFactors_; }
+    bool stressSkipUnaffectedTrades() const { return stressSkipUnaffectedTrades_; }
     double stressLowerBoundCapFloorVolatility() const {
         return stressLowerBoundCapFloorVolatility_;
     }
@@ -558,6 +646,7 @@ public:
     QuantLib::ext::shared_ptr<HistoricalScenarioReader> historicalScenarioReader() const { return historicalScenarioReader_;};
     const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& histVarSimMarketParams() const { return histVarSimMarketParams_; }
     bool outputHistoricalScenarios() const { return outputHistoricalScenarios_; }
+    Real histVarSensiPnlGammaThreshold() const { return histVarSensiPnlGammaThreshold_; }
     
     /*********************************
      * Getters for exposure simulation 
@@ -566,6 +655,9 @@ public:
     bool amc() const { return amc_; }
     bool amcCg() const { return amcCg_; }
     bool xvaCgBumpSensis() const { return xvaCgBumpSensis_; }
+    bool xvaCgForwardSensis() const { return xvaCgForwardSensis_; }
+    bool xvaCgExposureSensis() const { return xvaCgExposureSensis_; }
+    bool xvaCgProfileEvaluation() const { return xvaCgProfileEvaluation_; }
     bool xvaCgUseExternalComputeDevice() const { return xvaCgUseExternalComputeDevice_; }
     bool xvaCgExternalDeviceCompatibilityMode() const { return xvaCgExternalDeviceCompatibilityMode_; }
     bool xvaCgUseDoublePrecisionForExternalCalculation() const {
@@ -581,8 +673,14 @@ public:
     bool storeFlows() const { return storeFlows_; }
     Size storeCreditStateNPVs() const { return storeCreditStateNPVs_; }
     bool storeSurvivalProbabilities() const { return storeSurvivalProbabilities_; }
+    //! Relative EPE standard error at which the simulation stops, 0 means all samples are simulated
+    Real exposureConvergenceTolerance() const { return exposureConvergenceTolerance_; }
+    Size exposureConvergenceMinSamples() const { return exposureConvergenceMinSamples_; }
+    //! Number of samples after which the convergence is checked
+    Size exposureConvergenceBlockSize() const { return exposureConvergenceBlockSize_; }
     bool writeCube() const { return writeCube_; }
     bool writeScenarios() const { return writeScenarios_; }
+    const std::string& scenarioCacheFile() const { return scenarioCacheFile_; }
     const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& exposureSimMarketParams() const { return exposureSimMarketParams_; }
     const QuantLib::ext::shared_ptr<ScenarioGeneratorData> scenarioGeneratorData() const { return scenarioGeneratorData_; }
     const QuantLib::ext::shared_ptr<CrossAssetModelData>& crossAssetModelData() const { return crossAssetModelData_; }
@@ -604,6 +702,7 @@ public:
     const QuantLib::ext::shared_ptr<AggregationScenarioData>& mktCube() const { return mktCube_; }
     bool flipViewXVA() const { return flipViewXVA_; }
     MporCashFlowMode mporCashFlowMode() const { return mporCashFlowMode_; }
+    bool streamingExposure() const { return streamingExposure_; }
     bool fullInitialCollateralisation() const { return fullInitialCollateralisation_; }
     bool exposureProfiles() const { return exposureProfiles_; }
     bool exposureProfilesByTrade() const { return exposureProfilesByTrade_; }
@@ -694,6 +793,10 @@ public:
     bool enforceIMRegulations() const { return enforceIMRegulations_; }
     QuantLib::ext::shared_ptr<SimmConfiguration> getSimmConfiguration();
     bool writeSimmIntermediateReports() const { return writeSimmIntermediateReports_; }
+    bool simmTradeAllocation() const { return simmTradeAllocation_; }
+    bool simmStreamCrif() const { return simmStreamCrif_; }
+    //! The CRIF loader kept for streaming, only set if simmStreamCrif() is true
+    const QuantLib::ext::shared_ptr<ore::analytics::StringStreamCrifLoader>& crifLoader() const { return crifLoader_; }
 
     /**************************************************
      * Getters for Zero to Par Sensi conversion
@@ -810,6 +913,33 @@ protected:
     QuantLib::ext::shared_ptr<ore::data::Portfolio> portfolio_, useCounterpartyOriginalPortfolio_;
     QuantLib::Size maxRetries_ = 7;
     QuantLib::Size nThreads_ = 1;
+    QuantLib::Size nAnalyticsThreads_ = 1;
+    QuantLib::ext::shared_ptr<MarketCache> marketCache_ = QuantLib::ext::make_shared<MarketCache>();
+    bool runtimeStatistics_ = false;
+    std::string traceFile_;
+    bool pricingProfile_ = false;
+    bool observerStatistics_ = false;
+    bool pruneObservers_ = false;
+    bool singlePrecisionScenarioData_ = false;
+    bool memoryStatistics_ = false;
+    QuantLib::Size memoryBudget_ = 0;
+    bool calibrationCache_ = false;
+    std::string calibrationCacheFile_;
+    bool mtSharedInputs_ = false;
+    QuantLib::Size mtTradeChunkSize_ = 0;
+    bool mtSplitSamples_ = false;
+    bool mtCompactScenarios_ = false;
+    std::string mtCubeDirectory_;
+    bool maturityTruncatedCube_ = false;
+    bool closeOutRegression_ = false;
+    QuantLib::Size closeOutRegressionOrder_ = 2;
+    std::string mtPricingTimeFile_;
+    std::string distributedWorkerCommand_;
+    QuantLib::Size distributedPartitions_ = 0;
+    QuantLib::Size distributedMaxWorkers_ = 0;
+    std::string distributedJobDirectory_;
+    std::string cubeCheckpointDirectory_;
+    QuantLib::Size cubeCheckpointBlockSize_ = 100;
    
     bool entireMarket_ = false; 
     bool allFixings_ = false; 
@@ -822,6 +952,7 @@ protected:
     char csvQuoteChar_ = '\0';
     char csvEscapeChar_ = '\\';
     std::string reportNaString_ = "#N/A";
+    std::string reportFormat_ = "csv";
     bool dryRun_ = false;
     QuantLib::Date mporDate_;
     QuantLib::Size mporDays_ = 10;
@@ -853,6 +984,10 @@ protected:
     bool parSensi_ = false;
     bool optimiseRiskFactors_ = false;
     bool outputJacobi_ = false;
+    bool sensiAadDeltas_ = false;
+    bool sensiSkipUnaffectedTrades_ = false;
+    std::string parSensiCacheFile_;
+    Real parSensiCacheTolerance_ = 1.0E-6;
     bool alignPillars_ = false;
     bool useSensiSpreadedTermStructures_ = true;
     QuantLib::Real sensiThreshold_ = 1e-6;
@@ -877,6 +1012,7 @@ protected:
     QuantLib::ext::shared_ptr<ore::analytics::SensitivityScenarioData> stressSensitivityScenarioData_;
     QuantLib::ext::shared_ptr<ore::data::EngineData> stressPricingEngine_;
     bool stressOptimiseRiskFactors_ = false;
+    bool stressSkipUnaffectedTrades_ = false;
     double stressLowerBoundCapFloorVolatility_;
     double stressUpperBoundCapFloorVolatility_;
     double stressLowerBoundSurvivalProb_;
@@ -903,6 +1039,8 @@ protected:
     QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters> histVarSimMarketParams_;
     std::string baseScenarioLoc_;
     bool outputHistoricalScenarios_ = false;
+    // hybrid sensitivity / full revaluation P&L in the historical simulation VaR, disabled if null
+    Real histVarSensiPnlGammaThreshold_ = Null<Real>();
 
     /*******************
      * EXPOSURE analytic
@@ -911,6 +1049,9 @@ protected:
     bool amc_ = false;
     bool amcCg_ = false;
     bool xvaCgBumpSensis_ = false;
+    bool xvaCgForwardSensis_ = false;
+    bool xvaCgExposureSensis_ = false;
+    bool xvaCgProfileEvaluation_ = false;
     bool xvaCgUseExternalComputeDevice_ = false;
     bool xvaCgExternalDeviceCompatibilityMode_ = false;
     bool xvaCgUseDoublePrecisionForExternalCalculation_ = false;
@@ -924,8 +1065,12 @@ protected:
     bool storeFlows_ = false;
     Size storeCreditStateNPVs_ = 0;
     bool storeSurvivalProbabilities_ = false;
+    Real exposureConvergenceTolerance_ = 0.0;
+    Size exposureConvergenceMinSamples_ = 1000;
+    Size exposureConvergenceBlockSize_ = 100;
     bool writeCube_ = false;
     bool writeScenarios_ = false;
+    std::string scenarioCacheFile_;
     QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters> exposureSimMarketParams_;
     QuantLib::ext::shared_ptr<ScenarioGeneratorData> scenarioGeneratorData_;
     QuantLib::ext::shared_ptr<CrossAssetModelData> crossAssetModelData_;
@@ -952,6 +1097,7 @@ protected:
     bool loadCube_ = false;
     bool flipViewXVA_ = false;
     MporCashFlowMode mporCashFlowMode_ = MporCashFlowMode::Unspecified;
+    bool streamingExposure_ = false;
     bool exerciseNextBreak_ = false;
     bool cvaAnalytic_ = true;
     bool dvaAnalytic_ = false;
@@ -1021,6 +1167,9 @@ protected:
     bool enforceIMRegulations_ = false;
     bool useSimmParameters_ = true;
     bool writeSimmIntermediateReports_ = true;
+    bool simmTradeAllocation_ = false;
+    bool simmStreamCrif_ = false;
+    QuantLib::ext::shared_ptr<ore::analytics::StringStreamCrifLoader> crifLoader_;
 
     /***************
      * Zero to Par Conversion analytic
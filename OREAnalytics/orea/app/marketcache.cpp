@@ -0,0 +1,55 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/app/marketcache.hpp>
+
+namespace ore {
+namespace analytics {
+
+MarketCache::Entry
+MarketCache::get(const QuantLib::Date& asof,
+                 const QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>& todaysMarketParams,
+                 const QuantLib::ext::shared_ptr<ore::data::CurveConfigurations>& curveConfigs,
+                 const QuantLib::ext::shared_ptr<ore::data::Loader>& loader) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = cache_.find(
+        Key(asof, todaysMarketParams.get(), curveConfigs.get(), loader.get(), std::this_thread::get_id()));
+    return it == cache_.end() ? Entry() : it->second.entry;
+}
+
+void MarketCache::add(const QuantLib::Date& asof,
+                      const QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>& todaysMarketParams,
+                      const QuantLib::ext::shared_ptr<ore::data::CurveConfigurations>& curveConfigs,
+                      const QuantLib::ext::shared_ptr<ore::data::Loader>& loader, const Entry& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_[Key(asof, todaysMarketParams.get(), curveConfigs.get(), loader.get(), std::this_thread::get_id())] =
+        CacheEntry{entry, todaysMarketParams, curveConfigs, loader};
+}
+
+void MarketCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+}
+
+QuantLib::Size MarketCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.size();
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/app/marketcache.hpp
+    \brief Cache of the todays markets built by the analytics of a run
+    \ingroup app
+*/
+
+#pragma once
+
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/marketdata/loader.hpp>
+#include <ored/marketdata/market.hpp>
+#include <ored/marketdata/todaysmarketparameters.hpp>
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+namespace ore {
+namespace analytics {
+
+//! Cache of the todays markets built by the analytics of a run
+/*! Analytics that build their market for the same as of date from the same todays market parameters, curve
+    configurations and loader get the same market instance, so that the curves are built once per run.
+
+    The key uses the identity of the configuration objects, not their content. The cache keeps them alive, so that
+    an address can not be reused by another object while the entry exists. The key also contains the id of the
+    calling thread, since a market must not be used concurrently in several threads.
+
+    \ingroup app
+*/
+class MarketCache {
+public:
+    struct Entry {
+        //! The market, null if there is no cached market
+        QuantLib::ext::shared_ptr<ore::data::Market> market;
+        //! The loader the market was built from, including the implied bond spreads
+        QuantLib::ext::shared_ptr<ore::data::Loader> loader;
+    };
+
+    //! Returns the cached entry for the given configuration, the market is null if there is none
+    Entry get(const QuantLib::Date& asof,
+              const QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>& todaysMarketParams,
+              const QuantLib::ext::shared_ptr<ore::data::CurveConfigurations>& curveConfigs,
+              const QuantLib::ext::shared_ptr<ore::data::Loader>& loader) const;
+
+    //! Adds the entry for the given configuration, an existing entry is replaced
+    void add(const QuantLib::Date& asof,
+             const QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>& todaysMarketParams,
+             const QuantLib::ext::shared_ptr<ore::data::CurveConfigurations>& curveConfigs,
+             const QuantLib::ext::shared_ptr<ore::data::Loader>& loader, const Entry& entry);
+
+    void clear();
+    QuantLib::Size size() const;
+
+private:
+    using Key = std::tuple<QuantLib::Date, const ore::data::TodaysMarketParameters*,
+                           const ore::data::CurveConfigurations*, const ore::data::Loader*, std::thread::id>;
+    struct CacheEntry {
+        Entry entry;
+        QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters> todaysMarketParams;
+        QuantLib::ext::shared_ptr<ore::data::CurveConfigurations> curveConfigs;
+        QuantLib::ext::shared_ptr<ore::data::Loader> loader;
+    };
+
+    std::map<Key, CacheEntry> cache_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace analytics
+} // namespace ore
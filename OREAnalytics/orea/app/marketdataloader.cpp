@@ -171,7 +171,7 @@ void MarketDataLoader::populateFixings(
         
         // portfolio fixings will warn if missing
         if (inputs_->portfolio()) {
-            portfolioFixings = inputs_->portfolio()->fixings();
+            portfolioFixings = inputs_->portfolio()->fixings(QuantLib::Date(), inputs_->nThreads());
             LOG("The portfolio depends on fixings from " << portfolioFixings.size() << " indices");
             for (const auto& it : portfolioFixings)
                 addRelevantFixings(it, lastAvailableFixingLookupMap);
@@ -0,0 +1,187 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/app/multithreadedreportwriter.hpp>
+#include <orea/app/structuredanalyticserror.hpp>
+#include <orea/engine/observationmode.hpp>
+
+#include <ored/marketdata/fixings.hpp>
+#include <ored/marketdata/lazyclonedloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <boost/timer/timer.hpp>
+
+#include <atomic>
+#include <future>
+
+namespace ore {
+namespace analytics {
+
+using QuantLib::Size;
+
+MultiThreadedReportWriter::MultiThreadedReportWriter(
+    const Size nThreads, const QuantLib::Date& today, const QuantLib::ext::shared_ptr<ore::data::Loader>& loader,
+    const QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>& todaysMarketParams,
+    const QuantLib::ext::shared_ptr<ore::data::CurveConfigurations>& curveConfigs,
+    const QuantLib::ext::shared_ptr<ore::data::EngineFactory>& engineFactory, const std::string& nullString)
+    : ReportWriter(nullString), nThreads_(nThreads), today_(today), loader_(loader),
+      todaysMarketParams_(todaysMarketParams), curveConfigs_(curveConfigs), engineFactory_(engineFactory) {
+    QL_REQUIRE(nThreads_ != 0, "MultiThreadedReportWriter: nThreads must be > 0");
+    QL_REQUIRE(engineFactory_, "MultiThreadedReportWriter: no engine factory given");
+}
+
+void MultiThreadedReportWriter::writeCashflow(ore::data::Report& report, const std::string& baseCurrency,
+                                              QuantLib::ext::shared_ptr<ore::data::Portfolio> portfolio,
+                                              QuantLib::ext::shared_ptr<ore::data::Market> market,
+                                              const std::string& configuration, const bool includePastCashflows) {
+
+#ifndef QL_ENABLE_SESSIONS
+    bool sessions = false;
+#else
+    bool sessions = true;
+#endif
+
+    if (nThreads_ == 1 || portfolio->size() < 2 || !sessions) {
+        if (!sessions)
+            WLOG("MultiThreadedReportWriter: requires a build with QL_ENABLE_SESSIONS = ON, writing the cashflow "
+                 "report in a single thread.");
+        ReportWriter::writeCashflow(report, baseCurrency, portfolio, market, configuration, includePastCashflows);
+        return;
+    }
+
+    boost::timer::cpu_timer timer;
+
+    // split the portfolio into chunks of consecutive trades, more chunks than threads to balance the load, the
+    // binary form avoids parsing the xml text in each worker
+
+    Size nChunks = std::min(portfolio->size(), 4 * nThreads_);
+    Size eff_nThreads = std::min(nChunks, nThreads_);
+    LOG("MultiThreadedReportWriter: writing cashflow report for " << portfolio->size() << " trades in " << nChunks
+                                                                  << " chunks using " << eff_nThreads << " threads");
+
+    std::vector<std::string> chunksAsString;
+    {
+        Size n = 0;
+        ore::data::Portfolio chunk;
+        for (auto const& [tid, t] : portfolio->trades()) {
+            chunk.add(t);
+            if (++n == (chunksAsString.size() + 1) * portfolio->size() / nChunks) {
+                chunksAsString.emplace_back(chunk.toBinaryString());
+                chunk.clear();
+            }
+        }
+    }
+
+    // the rows of each chunk are buffered and appended to the report in chunk order, the buffers are kept in memory
+
+    std::vector<ore::data::InMemoryReport> chunkReports(nChunks, ore::data::InMemoryReport(0));
+
+    ore::data::FixingHistories fixingHistories = ore::data::getFixingHistories();
+    ore::analytics::ObservationMode::Mode obsMode = ore::analytics::ObservationMode::instance().mode();
+    bool buildFailedTrades = portfolio->buildFailedTrades();
+    std::atomic<Size> nextChunk(0);
+
+    using resultType = int;
+    std::vector<std::future<resultType>> results(eff_nThreads);
+    std::vector<std::thread> jobs;
+
+    for (Size i = 0; i < eff_nThreads; ++i) {
+
+        auto job = [this, obsMode, buildFailedTrades, &fixingHistories, &chunksAsString, &chunkReports, &nextChunk,
+                    nChunks, &baseCurrency, &market, &configuration, includePastCashflows](int id) -> resultType {
+            // set thread local singletons
+
+            QuantLib::Settings::instance().evaluationDate() = today_;
+            ore::analytics::ObservationMode::instance().setMode(obsMode);
+
+            LOG("Start thread " << id);
+
+            try {
+
+                // build todays market reading the quotes from the original loader and an engine factory against it
+
+                ore::data::applyFixingHistories(fixingHistories);
+
+                auto threadMarket = QuantLib::ext::make_shared<ore::data::TodaysMarket>(
+                    today_, todaysMarketParams_, QuantLib::ext::make_shared<ore::data::LazyClonedLoader>(today_, loader_),
+                    curveConfigs_, true, false, true, engineFactory_->referenceData(), false,
+                    engineFactory_->iborFallbackConfig());
+
+                auto engineFactory = QuantLib::ext::make_shared<ore::data::EngineFactory>(
+                    engineFactory_->engineData(), threadMarket, engineFactory_->configurations(),
+                    engineFactory_->referenceData(), engineFactory_->iborFallbackConfig());
+
+                for (Size chunk = nextChunk++; chunk < nChunks; chunk = nextChunk++) {
+                    DLOG("Thread " << id << " processes chunk " << chunk);
+                    auto portfolio = QuantLib::ext::make_shared<ore::data::Portfolio>(buildFailedTrades);
+                    portfolio->fromBinaryString(chunksAsString[chunk]);
+                    std::string().swap(chunksAsString[chunk]);
+                    portfolio->build(engineFactory, "cashflow report", false);
+                    ReportWriter(nullString()).writeCashflow(chunkReports[chunk], baseCurrency, portfolio,
+                                                             market ? threadMarket : nullptr, configuration,
+                                                             includePastCashflows);
+                }
+
+                LOG("Thread " << id << " successfully finished.");
+                return 0;
+
+            } catch (const std::exception& e) {
+                ore::analytics::StructuredAnalyticsErrorMessage("Multithreaded Report Writer", "", e.what()).log();
+                return 1;
+            }
+        };
+
+        std::packaged_task<resultType(int)> task(job);
+        results[i] = task.get_future();
+        jobs.emplace_back(std::move(task), i);
+    }
+
+    for (auto& t : jobs)
+        t.join();
+
+    for (Size i = 0; i < results.size(); ++i) {
+        int rc = results[i].get();
+        QL_REQUIRE(rc == 0, "error: thread " << i << " exited with return code " << rc
+                                             << ". Check for structured errors from 'Multithreaded Report Writer'.");
+    }
+
+    // take the columns from a report for an empty portfolio and append the rows of the chunks
+
+    ore::data::InMemoryReport header(0);
+    ReportWriter::writeCashflow(header, baseCurrency, QuantLib::ext::make_shared<ore::data::Portfolio>(), market,
+                                configuration, includePastCashflows);
+    for (Size col = 0; col < header.columns(); ++col)
+        report.addColumn(header.header(col), header.columnType(col), header.columnPrecision(col));
+    for (auto const& r : chunkReports) {
+        for (Size row = 0; row < r.rows(); ++row) {
+            report.next();
+            for (Size col = 0; col < r.columns(); ++col)
+                report.add(r.data(col, row));
+        }
+    }
+    report.end();
+
+    LOG("MultiThreadedReportWriter: cashflow report written, timings: "
+        << static_cast<double>(timer.elapsed().wall) / 1.0E9 << "s Wall, "
+        << static_cast<double>(timer.elapsed().user) / 1.0E9 << "s User, "
+        << static_cast<double>(timer.elapsed().system) / 1.0E9 << "s System.");
+}
+
+} // namespace analytics
+} // namespace ore
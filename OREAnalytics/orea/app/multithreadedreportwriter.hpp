@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/app/multithreadedreportwriter.hpp
+  \brief A report writer generating the trade level reports in several threads
+  \ingroup app
+ */
+
+#pragma once
+
+#include <orea/app/reportwriter.hpp>
+
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+
+namespace ore {
+namespace analytics {
+
+//! Report writer generating the cashflow report in several threads
+/*! The portfolio is split into chunks of consecutive trades. Each worker thread builds its own todays market from
+    the given loader, an engine factory with the settings of the given engine factory and the trades of the chunks it
+    processes, since the QuantLib objects of the original market and portfolio can not be used concurrently. The
+    rows of each chunk are written to a buffer and appended to the report in trade order, so that the report is
+    identical to the one written by the ReportWriter.
+
+    This requires a build with QL_ENABLE_SESSIONS = ON, otherwise, and for a single thread, the report is written by
+    the ReportWriter in the calling thread.
+
+    \ingroup app
+ */
+class MultiThreadedReportWriter : public ReportWriter {
+public:
+    MultiThreadedReportWriter(const QuantLib::Size nThreads, const QuantLib::Date& today,
+                              const QuantLib::ext::shared_ptr<ore::data::Loader>& loader,
+                              const QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>& todaysMarketParams,
+                              const QuantLib::ext::shared_ptr<ore::data::CurveConfigurations>& curveConfigs,
+                              const QuantLib::ext::shared_ptr<ore::data::EngineFactory>& engineFactory,
+                              const std::string& nullString = "#NA");
+
+    void writeCashflow(ore::data::Report& report, const std::string& baseCurrency,
+                       QuantLib::ext::shared_ptr<ore::data::Portfolio> portfolio,
+                       QuantLib::ext::shared_ptr<ore::data::Market> market = QuantLib::ext::shared_ptr<ore::data::Market>(),
+                       const std::string& configuration = ore::data::Market::defaultConfiguration,
+                       const bool includePastCashflows = false) override;
+
+private:
+    QuantLib::Size nThreads_;
+    QuantLib::Date today_;
+    QuantLib::ext::shared_ptr<ore::data::Loader> loader_;
+    QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters> todaysMarketParams_;
+    QuantLib::ext::shared_ptr<ore::data::CurveConfigurations> curveConfigs_;
+    QuantLib::ext::shared_ptr<ore::data::EngineFactory> engineFactory_;
+};
+
+} // namespace analytics
+} // namespace ore
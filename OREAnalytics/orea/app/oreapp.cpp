@@ -36,6 +36,8 @@
 
 #include <ored/report/inmemoryreport.hpp>
 #include <ored/utilities/calendaradjustmentconfig.hpp>
+#include <ored/utilities/calendarparser.hpp>
+#include <ored/utilities/indexcache.hpp>
 #include <ored/configuration/currencyconfig.hpp>
 #include <ored/portfolio/collateralbalance.hpp>
 
@@ -255,7 +257,7 @@ void OREApp::analytics() {
         analyticsManager_->toFile(reports,
                                   inputs_->resultsPath().string(), outputs_->fileNameMap(),
                                   inputs_->csvSeparator(), inputs_->csvCommentCharacter(),
-                                  inputs_->csvQuoteChar(), inputs_->reportNaString());
+                                  inputs_->csvQuoteChar(), inputs_->reportNaString(), {}, inputs_->reportFormat());
 
         // Write npv cube(s)
         for (auto a : analyticsManager_->npvCubes()) {
@@ -357,10 +359,15 @@ void OREApp::initFromParams() {
         if (!tmp.empty()) {
             structuredLogRotationSize_ = static_cast<Size>(parseInteger(tmp));
         }
+        tmp = params_->get("logging", "asynchronous", false);
+        if (!tmp.empty()) {
+            asyncLog_ = ore::data::parseBool(tmp);
+        }
     }
     
     setupLog(outputPath_, logFile_, logMask_, logRootPath_, progressLogFile_, progressLogRotationSize_, progressLogToConsole_,
              structuredLogFile_, structuredLogRotationSize_);
+    Log::instance().setAsynchronous(asyncLog_);
 
     // Log the input parameters
     params_->log();
@@ -436,6 +443,9 @@ void OREApp::run() {
 
     CONSOLE("run time: " << runTimer_.format(default_places, "%w") << " sec");
     CONSOLE("ORE done.");
+    LOG("IndexCache: " << IndexCache::instance().hits() << " of "
+                       << IndexCache::instance().hits() + IndexCache::instance().misses()
+                       << " parseIndex() calls served from the cache");
     LOG("ORE done.");
 }
 
@@ -517,6 +527,9 @@ void OREApp::run(const std::vector<std::string>& marketData,
 
     runTimer_.stop();
     
+    LOG("IndexCache: " << IndexCache::instance().hits() << " of "
+                       << IndexCache::instance().hits() + IndexCache::instance().misses()
+                       << " parseIndex() calls served from the cache");
     LOG("ORE analytics done");
 }
 
@@ -559,7 +572,10 @@ void OREApp::setupLog(const std::string& path, const std::string& file, Size mas
     ore::data::Log::instance().registerIndependentLogger(eventLogger);
 }
 
-void OREApp::closeLog() { Log::instance().removeAllLoggers(); }
+void OREApp::closeLog() {
+    Log::instance().setAsynchronous(false);
+    Log::instance().removeAllLoggers();
+}
 
 std::string OREApp::version() { return std::string(OPEN_SOURCE_RISK_VERSION); }
 
@@ -589,6 +605,15 @@ void OREAppInputParameters::loadParameters() {
         WLOG("Calendar adjustments not found, using defaults");
     }
 
+    // Cache the calendar business days, after the calendar adjustments are applied
+    tmp = params_->get("setup", "cachedCalendarYears", false);
+    if (tmp != "") {
+        std::vector<Integer> years = parseListOfValues<Integer>(tmp, &parseInteger);
+        QL_REQUIRE(years.size() == 2, "cachedCalendarYears '" << tmp << "' must have the form firstYear,lastYear");
+        LOG("Cache calendar business days from " << years[0] << " to " << years[1]);
+        CalendarParser::instance().setCachedYears(years[0], years[1]);
+    }
+
     // Load currency configs
     tmp = params_->get("setup", "currencyConfiguration", false);
     if (tmp != "") {
@@ -637,6 +662,114 @@ void OREAppInputParameters::loadParameters() {
     if (tmp != "")
         setThreads(parseInteger(tmp));
 
+    tmp = params_->get("setup", "nAnalyticsThreads", false);
+    if (tmp != "")
+        setAnalyticsThreads(parseInteger(tmp));
+
+    tmp = params_->get("setup", "shareMarkets", false);
+    if (tmp != "")
+        setShareMarkets(parseBool(tmp));
+
+    tmp = params_->get("setup", "runtimeStatistics", false);
+    if (tmp != "")
+        setRuntimeStatistics(parseBool(tmp));
+
+    tmp = params_->get("setup", "traceFile", false);
+    if (tmp != "")
+        setTraceFile(tmp);
+
+    tmp = params_->get("setup", "pricingProfile", false);
+    if (tmp != "")
+        setPricingProfile(parseBool(tmp));
+
+    tmp = params_->get("setup", "observerStatistics", false);
+    if (tmp != "")
+        setObserverStatistics(parseBool(tmp));
+
+    tmp = params_->get("setup", "pruneObservers", false);
+    if (tmp != "")
+        setPruneObservers(parseBool(tmp));
+
+    tmp = params_->get("setup", "singlePrecisionScenarioData", false);
+    if (tmp != "")
+        setSinglePrecisionScenarioData(parseBool(tmp));
+
+    tmp = params_->get("setup", "memoryStatistics", false);
+    if (tmp != "")
+        setMemoryStatistics(parseBool(tmp));
+
+    tmp = params_->get("setup", "memoryBudget", false);
+    if (tmp != "")
+        setMemoryBudget(parseInteger(tmp));
+
+    tmp = params_->get("setup", "calibrationCache", false);
+    if (tmp != "")
+        setCalibrationCache(parseBool(tmp));
+
+    tmp = params_->get("setup", "calibrationCacheFile", false);
+    if (tmp != "")
+        setCalibrationCacheFile(tmp);
+
+    tmp = params_->get("setup", "mtSharedInputs", false);
+    if (tmp != "")
+        setMtSharedInputs(parseBool(tmp));
+
+    tmp = params_->get("setup", "mtTradeChunkSize", false);
+    if (tmp != "")
+        setMtTradeChunkSize(parseInteger(tmp));
+
+    tmp = params_->get("setup", "mtSplitSamples", false);
+    if (tmp != "")
+        setMtSplitSamples(parseBool(tmp));
+
+    tmp = params_->get("setup", "mtCompactScenarios", false);
+    if (tmp != "")
+        setMtCompactScenarios(parseBool(tmp));
+
+    tmp = params_->get("setup", "mtCubeDirectory", false);
+    if (tmp != "")
+        setMtCubeDirectory(tmp);
+
+    tmp = params_->get("setup", "maturityTruncatedCube", false);
+    if (tmp != "")
+        setMaturityTruncatedCube(parseBool(tmp));
+
+    tmp = params_->get("setup", "closeOutRegression", false);
+    if (tmp != "")
+        setCloseOutRegression(parseBool(tmp));
+
+    tmp = params_->get("setup", "closeOutRegressionOrder", false);
+    if (tmp != "")
+        setCloseOutRegressionOrder(static_cast<Size>(parseInteger(tmp)));
+
+    tmp = params_->get("setup", "mtPricingTimeFile", false);
+    if (tmp != "")
+        setMtPricingTimeFile(tmp);
+
+    tmp = params_->get("setup", "distributedWorkerCommand", false);
+    if (tmp != "")
+        setDistributedWorkerCommand(tmp);
+
+    tmp = params_->get("setup", "distributedPartitions", false);
+    if (tmp != "")
+        setDistributedPartitions(parseInteger(tmp));
+
+    tmp = params_->get("setup", "distributedMaxWorkers", false);
+    if (tmp != "")
+        setDistributedMaxWorkers(parseInteger(tmp));
+
+    tmp = params_->get("setup", "distributedJobDirectory", false);
+    if (tmp != "")
+        setDistributedJobDirectory(tmp);
+
+    tmp = params_->get("setup", "cubeCheckpointDirectory", false);
+    if (tmp != "")
+        setCubeCheckpointDirectory(tmp);
+
+    tmp = params_->get("setup", "cubeCheckpointBlockSize", false);
+    if (tmp != "")
+        setCubeCheckpointBlockSize(parseInteger(tmp));
+
     tmp = params_->get("setup", "entireMarket", false);
     if (tmp != "")
         setEntireMarket(parseBool(tmp));
@@ -672,7 +805,11 @@ void OREAppInputParameters::loadParameters() {
     if (tmp != "") {
         filesystem::path refDataFile = inputPath / tmp;
         LOG("Loading reference data from file: " << refDataFile);
-        setRefDataManagerFromFile(refDataFile.generic_string());
+        bool lazyRefData = false;
+        tmp = params_->get("setup", "lazyReferenceData", false);
+        if (tmp != "")
+            lazyRefData = parseBool(tmp);
+        setRefDataManagerFromFile(refDataFile.generic_string(), lazyRefData);
     } else {
         WLOG("Reference data not found");
     }
@@ -754,6 +891,10 @@ void OREAppInputParameters::loadParameters() {
         setCsvSeparator(tmp[0]);
     }
 
+    tmp = params_->get("setup", "reportFormat", false);
+    if (tmp != "")
+        setReportFormat(tmp);
+
     /*************
      * NPV
      *************/
@@ -860,6 +1001,22 @@ void OREAppInputParameters::loadParameters() {
         if (tmp != "")
             setOutputJacobi(parseBool(tmp));
 
+        tmp = params_->get("sensitivity", "aadDeltas", false);
+        if (tmp != "")
+            setSensiAadDeltas(parseBool(tmp));
+
+        tmp = params_->get("sensitivity", "skipUnaffectedTrades", false);
+        if (tmp != "")
+            setSensiSkipUnaffectedTrades(parseBool(tmp));
+
+        tmp = params_->get("sensitivity", "parSensitivityCacheFile", false);
+        if (tmp != "")
+            setParSensiCacheFile((filesystem::path(outputPath) / tmp).generic_string());
+
+        tmp = params_->get("sensitivity", "parSensitivityCacheTolerance", false);
+        if (tmp != "")
+            setParSensiCacheTolerance(parseReal(tmp));
+
         tmp = params_->get("sensitivity", "alignPillars", false);
         if (tmp != "")
             setAlignPillars(parseBool(tmp));
@@ -969,6 +1126,10 @@ void OREAppInputParameters::loadParameters() {
         if (tmp != "")
             setStressOptimiseRiskFactors(parseBool(tmp));
 
+        tmp = params_->get("stress", "skipUnaffectedTrades", false);
+        if (tmp != "")
+            setStressSkipUnaffectedTrades(parseBool(tmp));
+
         tmp = params_->get("stress", "sensitivityConfigFile", false);
         if (tmp != "") {
             string file = (inputPath / tmp).generic_string();
@@ -1229,6 +1390,23 @@ void OREAppInputParameters::loadParameters() {
         tmp = params_->get("historicalSimulationVar", "outputHistoricalScenarios", false);
         if (tmp != "")
             setOutputHistoricalScenarios(parseBool(tmp));
+
+        tmp = params_->get("historicalSimulationVar", "sensiPnlGammaThreshold", false);
+        if (tmp != "") {
+            setHistVarSensiPnlGammaThreshold(parseReal(tmp));
+
+            tmp = params_->get("historicalSimulationVar", "sensitivityInputFile", false);
+            QL_REQUIRE(tmp != "", "sensitivityInputFile not provided, required for sensiPnlGammaThreshold");
+            std::string sensiFile = (inputPath / tmp).generic_string();
+            LOG("Get sensitivity data from file " << sensiFile);
+            setSensitivityStreamFromFile(sensiFile);
+
+            tmp = params_->get("historicalSimulationVar", "sensitivityConfigFile", false);
+            QL_REQUIRE(tmp != "", "sensitivityConfigFile not provided, required for sensiPnlGammaThreshold");
+            string file = (inputPath / tmp).generic_string();
+            LOG("Load sensitivity scenario data from file" << file);
+            setSensiScenarioDataFromFile(file);
+        }
     }
 
     /****************
@@ -1292,6 +1470,10 @@ void OREAppInputParameters::loadParameters() {
                 setSimmCalibrationDataFromFile(file);
         }
 
+        tmp = params_->get("simm", "streamCrif", false);
+        if (tmp != "")
+            setSimmStreamCrif(parseBool(tmp));
+
         tmp = params_->get("simm", "crif", false);
         if (tmp != "") {
             string file = (inputPath / tmp).generic_string();
@@ -1333,6 +1515,10 @@ void OREAppInputParameters::loadParameters() {
         tmp = params_->get("simm", "writeIntermediateReports", false);
         if (tmp != "")
             setWriteSimmIntermediateReports(parseBool(tmp));
+
+        tmp = params_->get("simm", "tradeAllocation", false);
+        if (tmp != "")
+            setSimmTradeAllocation(parseBool(tmp));
     }
 
     LOG("IM SCHEDULE");
@@ -1352,6 +1538,7 @@ void OREAppInputParameters::loadParameters() {
 
         tmp = params_->get("imschedule", "crif", false);
         if (tmp != "") {
+            QL_REQUIRE(!simmStreamCrif(), "streamCrif is not supported for imschedule");
             string tmpSimm = params_->get("simm", "crif", false);
             QL_REQUIRE(!doSimm || tmp == tmpSimm, "crif files for imschedule and simm should match");
             string file = (inputPath / tmp).generic_string();
@@ -1514,6 +1701,18 @@ void OREAppInputParameters::loadParameters() {
         if (tmp == "Y")
             setStoreSurvivalProbabilities(true);
 
+        tmp = params_->get("simulation", "exposureConvergenceTolerance", false);
+        if (tmp != "")
+            setExposureConvergenceTolerance(parseReal(tmp));
+
+        tmp = params_->get("simulation", "exposureConvergenceMinSamples", false);
+        if (tmp != "")
+            setExposureConvergenceMinSamples(parseInteger(tmp));
+
+        tmp = params_->get("simulation", "exposureConvergenceBlockSize", false);
+        if (tmp != "")
+            setExposureConvergenceBlockSize(parseInteger(tmp));
+
         tmp = params_->get("simulation", "nettingSetId", false);
         if (tmp != "")
             setNettingSetId(tmp);
@@ -1526,6 +1725,10 @@ void OREAppInputParameters::loadParameters() {
         if (tmp != "")
             setWriteScenarios(true);
 
+        tmp = params_->get("simulation", "scenarioCacheFile", false);
+        if (tmp != "")
+            setScenarioCacheFile((resultsPath() / tmp).generic_string());
+
         tmp = params_->get("simulation", "xvaCgBumpSensis", false);
 	if (!tmp.empty())
 	    setXvaCgBumpSensis(parseBool(tmp));
@@ -1548,6 +1751,18 @@ void OREAppInputParameters::loadParameters() {
 	if (!tmp.empty())
 	    setXvaCgBumpSensis(parseBool(tmp));
 
+        tmp = params_->get("simulation", "xvaCgForwardSensis", false);
+	if (!tmp.empty())
+	    setXvaCgForwardSensis(parseBool(tmp));
+
+        tmp = params_->get("simulation", "xvaCgExposureSensis", false);
+	if (!tmp.empty())
+	    setXvaCgExposureSensis(parseBool(tmp));
+
+        tmp = params_->get("simulation", "xvaCgProfileEvaluation", false);
+	if (!tmp.empty())
+	    setXvaCgProfileEvaluation(parseBool(tmp));
+
     }
 
     /**********************
@@ -1625,6 +1840,10 @@ void OREAppInputParameters::loadParameters() {
     if (tmp != "")
         setMporCashFlowMode(parseMporCashFlowMode(tmp));
 
+    tmp = params_->get("xva", "streamingExposure", false);
+    if (tmp != "")
+        setStreamingExposure(parseBool(tmp));
+
     tmp = params_->get("xva", "fullInitialCollateralisation", false);
     if (tmp != "")
         setFullInitialCollateralisation(parseBool(tmp));
@@ -0,0 +1,228 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/app/analyticsmanager.hpp>
+#include <orea/app/marketdatainmemoryloader.hpp>
+#include <orea/app/oreservice.hpp>
+#include <orea/app/reportwriter.hpp>
+
+#include <ored/configuration/conventions.hpp>
+#include <ored/marketdata/compositeloader.hpp>
+#include <ored/marketdata/marketdatumparser.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/to_string.hpp>
+
+#include <boost/algorithm/string/join.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <iomanip>
+#include <sstream>
+
+using namespace ore::data;
+using QuantLib::Real;
+using QuantLib::Size;
+
+namespace ore {
+namespace analytics {
+
+OREService::OREService(const QuantLib::ext::shared_ptr<InputParameters>& inputs,
+                       const std::vector<std::string>& marketData, const std::vector<std::string>& fixingData)
+    : inputs_(inputs), marketData_(marketData), fixingData_(fixingData) {
+
+    QL_REQUIRE(inputs_, "OREService: inputs not set");
+    QL_REQUIRE(inputs_->todaysMarketParams(), "OREService: todays market parameters not set");
+    QL_REQUIRE(inputs_->pricingEngine(), "OREService: pricing engine not set");
+    QL_REQUIRE(inputs_->portfolio(), "OREService: portfolio not set");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    boost::timer::cpu_timer timer;
+    setGlobals();
+
+    // load the quotes and fixings, the fixings are added to the index manager by the loader
+
+    auto marketDataLoader = QuantLib::ext::make_shared<MarketDataInMemoryLoader>(inputs_, marketData_, fixingData_);
+    marketDataLoader->populateLoader({inputs_->todaysMarketParams()}, {inputs_->asof()});
+
+    // build the market as Analytic::buildMarket() does, but not lazily, the market is kept for all requests
+
+    auto bondSpreads = implyBondSpreads(inputs_->asof(), inputs_, inputs_->todaysMarketParams(),
+                                        marketDataLoader->loader(), inputs_->curveConfigs().get(), std::string());
+    auto loader = QuantLib::ext::make_shared<CompositeLoader>(marketDataLoader->loader(), bondSpreads);
+    market_ = QuantLib::ext::make_shared<TodaysMarket>(
+        inputs_->asof(), inputs_->todaysMarketParams(), loader, inputs_->curveConfigs().get(),
+        inputs_->continueOnError(), true, false, inputs_->refDataManager(), false, *inputs_->iborFallbackConfig());
+
+    // the service owns its trades, the input portfolio is left untouched
+
+    portfolio_ = QuantLib::ext::make_shared<Portfolio>(inputs_->buildFailedTrades());
+    portfolio_->fromXMLString(inputs_->portfolio()->toXMLString());
+    buildPortfolio();
+
+    LOG("OREService: market and " << portfolio_->size() << " trades built in " << timer.format(2, "%w") << " s");
+}
+
+void OREService::setGlobals() const {
+    QuantLib::Settings::instance().evaluationDate() = inputs_->asof();
+    GlobalPseudoCurrencyMarketParameters::instance().set(inputs_->pricingEngine()->globalParameters());
+    QL_REQUIRE(inputs_->conventions(), "OREService: conventions not set");
+    InstrumentConventions::instance().setConventions(inputs_->conventions());
+}
+
+QuantLib::ext::shared_ptr<EngineFactory> OREService::engineFactory() const {
+    // as in Analytic::Impl::engineFactory()
+    auto engineData = QuantLib::ext::make_shared<EngineData>(*inputs_->pricingEngine());
+    engineData->globalParameters()["GenerateAdditionalResults"] = "false";
+    engineData->globalParameters()["RunType"] = "NPV";
+    std::map<MarketContext, std::string> configurations;
+    configurations[MarketContext::irCalibration] = inputs_->marketConfig("lgmcalibration");
+    configurations[MarketContext::fxCalibration] = inputs_->marketConfig("fxcalibration");
+    configurations[MarketContext::pricing] = inputs_->marketConfig("pricing");
+    return QuantLib::ext::make_shared<EngineFactory>(engineData, market_, configurations, inputs_->refDataManager(),
+                                                     *inputs_->iborFallbackConfig());
+}
+
+void OREService::buildPortfolio() {
+    // the engine builders cache engines holding market handles, so a new factory is needed after a market update
+    engineFactory_ = engineFactory();
+    portfolio_->reset();
+    portfolio_->build(engineFactory_, "service");
+    portfolio_->removeMatured(inputs_->portfolioFilterDate() != QuantLib::Null<QuantLib::Date>()
+                                  ? inputs_->portfolioFilterDate()
+                                  : inputs_->asof());
+    ++portfolioBuilds_;
+}
+
+Size OREService::updateQuotes(const std::vector<QuantLib::ext::shared_ptr<MarketDatum>>& quotes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    setGlobals();
+    boost::timer::cpu_timer timer;
+
+    Size rebuilt = market_->update(quotes);
+    for (auto const& md : quotes) {
+        std::ostringstream line;
+        line << ore::data::to_string(md->asofDate()) << " " << md->name() << " " << std::setprecision(16)
+             << md->quote()->value();
+        updatedMarketData_[md->name()] = line.str();
+    }
+
+    // yield curve handles are relinked in place and the index forwarding curves follow them, everything else held
+    // by the trades is replaced in the market and requires a rebuild of the trades
+    static const std::set<MarketObject> relinked = {MarketObject::DiscountCurve, MarketObject::YieldCurve,
+                                                    MarketObject::IndexCurve, MarketObject::SwapIndexCurve};
+    bool rebuildTrades = false;
+    for (auto const& o : market_->updatedObjects())
+        rebuildTrades = rebuildTrades || relinked.find(o) == relinked.end();
+    if (rebuildTrades)
+        buildPortfolio();
+
+    LOG("OREService: " << quotes.size() << " changed quotes, " << rebuilt << " market objects rebuilt"
+                       << (rebuildTrades ? ", trades rebuilt" : "") << " in " << timer.format(2, "%w") << " s");
+    return rebuilt;
+}
+
+Size OREService::updateQuotes(const std::map<std::string, Real>& quotes) {
+    std::vector<QuantLib::ext::shared_ptr<MarketDatum>> data;
+    for (auto const& [name, value] : quotes)
+        data.push_back(parseMarketDatum(inputs_->asof(), name, value));
+    return updateQuotes(data);
+}
+
+void OREService::addTrades(const QuantLib::ext::shared_ptr<Portfolio>& trades) {
+    QL_REQUIRE(trades, "OREService::addTrades(): trades not set");
+    std::lock_guard<std::mutex> lock(mutex_);
+    setGlobals();
+    trades->reset();
+    trades->build(engineFactory_, "service");
+    for (auto const& [tradeId, trade] : trades->trades()) {
+        portfolio_->remove(tradeId);
+        portfolio_->add(trade);
+    }
+    DLOG("OREService: added " << trades->size() << " trades, portfolio has " << portfolio_->size() << " trades");
+}
+
+void OREService::addTrades(const std::string& portfolioXml) {
+    auto trades = QuantLib::ext::make_shared<Portfolio>(inputs_->buildFailedTrades());
+    trades->fromXMLString(portfolioXml);
+    addTrades(trades);
+}
+
+void OREService::removeTrades(const std::set<std::string>& tradeIds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto const& id : tradeIds)
+        portfolio_->remove(id);
+}
+
+QuantLib::ext::shared_ptr<Portfolio> OREService::subPortfolio(const std::set<std::string>& tradeIds) const {
+    if (tradeIds.empty())
+        return portfolio_;
+    auto result = QuantLib::ext::make_shared<Portfolio>(inputs_->buildFailedTrades());
+    for (auto const& id : tradeIds) {
+        auto trade = portfolio_->get(id);
+        QL_REQUIRE(trade, "OREService: trade " << id << " not found");
+        result->add(trade);
+    }
+    return result;
+}
+
+std::string OREService::resultCurrency() const {
+    return inputs_->resultCurrency().empty() ? inputs_->baseCurrency() : inputs_->resultCurrency();
+}
+
+QuantLib::ext::shared_ptr<InMemoryReport> OREService::npv(const std::set<std::string>& tradeIds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    setGlobals();
+    auto report = QuantLib::ext::make_shared<InMemoryReport>();
+    ReportWriter(inputs_->reportNaString())
+        .writeNpv(*report, resultCurrency(), market_, inputs_->marketConfig("pricing"), subPortfolio(tradeIds));
+    return report;
+}
+
+QuantLib::ext::shared_ptr<InMemoryReport> OREService::cashflows(const std::set<std::string>& tradeIds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    setGlobals();
+    auto report = QuantLib::ext::make_shared<InMemoryReport>();
+    ReportWriter(inputs_->reportNaString())
+        .writeCashflow(*report, resultCurrency(), subPortfolio(tradeIds), market_, inputs_->marketConfig("pricing"),
+                       inputs_->includePastCashflows());
+    return report;
+}
+
+Analytic::analytic_reports OREService::runAnalytics(const std::set<std::string>& analytics) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    setGlobals();
+
+    // the changed quotes come first, the loader skips the original quotes with the same name
+    std::vector<std::string> marketData;
+    marketData.reserve(updatedMarketData_.size() + marketData_.size());
+    for (auto const& [name, line] : updatedMarketData_)
+        marketData.push_back(line);
+    marketData.insert(marketData.end(), marketData_.begin(), marketData_.end());
+
+    inputs_->setPortfolio(portfolio_->toXMLString());
+    inputs_->setAnalytics(boost::algorithm::join(analytics, ","));
+    auto loader = QuantLib::ext::make_shared<MarketDataInMemoryLoader>(inputs_, marketData, fixingData_);
+    auto analyticsManager = QuantLib::ext::make_shared<AnalyticsManager>(inputs_, loader);
+    analyticsManager->runAnalytics();
+
+    // the analytics set their own evaluation date and observation mode
+    setGlobals();
+    return analyticsManager->reports();
+}
+
+} // namespace analytics
+} // namespace ore
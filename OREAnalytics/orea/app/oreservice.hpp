@@ -0,0 +1,117 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/app/oreservice.hpp
+    \brief Long-lived ORE service keeping the market and the portfolio built between requests
+    \ingroup app
+*/
+
+#pragma once
+
+#include <orea/app/analytic.hpp>
+#include <orea/app/inputparameters.hpp>
+
+#include <ored/marketdata/marketdatum.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/report/inmemoryreport.hpp>
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+//! Long-lived ORE service keeping the market and the portfolio built between requests
+/*! OREApp builds the market and the portfolio for each run. The service builds the todays market, the engine factory
+    and the portfolio once and keeps them for subsequent requests, e.g. for intraday what-if pricing:
+
+    - updateQuotes() applies changed quotes to the market via TodaysMarket::update(), only the affected market objects
+      are rebuilt. The trades are rebuilt if market objects other than yield and index curves changed, since only
+      the yield curve handles are relinked in place.
+    - addTrades() builds the new or amended trades only, removeTrades() removes trades.
+    - npv() and cashflows() price (a subset of) the portfolio against the current market.
+    - runAnalytics() runs any other analytic through an AnalyticsManager on the current quotes and portfolio. These
+      analytics build their own market and portfolio, i.e. they do not benefit from the warm state.
+
+    The service uses the global QuantLib settings (evaluation date, conventions), the requests are serialised.
+
+    \ingroup app
+*/
+class OREService {
+public:
+    /*! The inputs must contain the todays market parameters, curve configurations, pricing engine data and the
+        initial portfolio, the market data and fixings are given in the format accepted by OREApp::run() */
+    OREService(const QuantLib::ext::shared_ptr<InputParameters>& inputs, const std::vector<std::string>& marketData,
+               const std::vector<std::string>& fixingData);
+
+    //! Apply changed quotes for the as of date, returns the number of rebuilt market objects
+    QuantLib::Size updateQuotes(const std::vector<QuantLib::ext::shared_ptr<ore::data::MarketDatum>>& quotes);
+    //! Apply changed quotes for the as of date given by quote name and value
+    QuantLib::Size updateQuotes(const std::map<std::string, QuantLib::Real>& quotes);
+
+    //! Add trades, trades with existing ids are replaced, only the given trades are built
+    void addTrades(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& trades);
+    //! Add trades given as portfolio xml
+    void addTrades(const std::string& portfolioXml);
+    //! Remove trades, unknown ids are ignored
+    void removeTrades(const std::set<std::string>& tradeIds);
+
+    //! NPV report of the given trades, all trades if empty
+    QuantLib::ext::shared_ptr<ore::data::InMemoryReport> npv(const std::set<std::string>& tradeIds = {});
+    //! Cashflow report of the given trades, all trades if empty
+    QuantLib::ext::shared_ptr<ore::data::InMemoryReport> cashflows(const std::set<std::string>& tradeIds = {});
+
+    //! Run the given analytics on the current quotes and portfolio, returns the reports
+    Analytic::analytic_reports runAnalytics(const std::set<std::string>& analytics);
+
+    //! \name Inspectors
+    //@{
+    const QuantLib::ext::shared_ptr<InputParameters>& inputs() const { return inputs_; }
+    const QuantLib::ext::shared_ptr<ore::data::TodaysMarket>& market() const { return market_; }
+    const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio() const { return portfolio_; }
+    //! number of full portfolio builds, including the initial one
+    QuantLib::Size portfolioBuilds() const { return portfolioBuilds_; }
+    //@}
+
+private:
+    void setGlobals() const;
+    QuantLib::ext::shared_ptr<ore::data::EngineFactory> engineFactory() const;
+    void buildPortfolio();
+    QuantLib::ext::shared_ptr<ore::data::Portfolio> subPortfolio(const std::set<std::string>& tradeIds) const;
+    std::string resultCurrency() const;
+
+    QuantLib::ext::shared_ptr<InputParameters> inputs_;
+    std::vector<std::string> marketData_, fixingData_;
+    // the changed quotes in market data format by name, they take precedence over marketData_
+    std::map<std::string, std::string> updatedMarketData_;
+
+    QuantLib::ext::shared_ptr<ore::data::TodaysMarket> market_;
+    QuantLib::ext::shared_ptr<ore::data::EngineFactory> engineFactory_;
+    QuantLib::ext::shared_ptr<ore::data::Portfolio> portfolio_;
+    QuantLib::Size portfolioBuilds_ = 0;
+
+    mutable std::mutex mutex_;
+};
+
+} // namespace analytics
+} // namespace ore
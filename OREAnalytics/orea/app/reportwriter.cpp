@@ -26,6 +26,7 @@
 #include <ored/utilities/marketdata.hpp>
 #include <ored/portfolio/structuredtradeerror.hpp>
 #include <ored/utilities/indexnametranslator.hpp>
+#include <ored/utilities/timers.hpp>
 #include <ored/utilities/to_string.hpp>
 
 #include <qle/cashflows/cappedflooredaveragebmacoupon.hpp>
@@ -59,11 +60,15 @@
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/tail_quantile.hpp>
 #include <boost/accumulators/statistics/variates/covariate.hpp>
+#include <boost/algorithm/string/join.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/range/adaptor/indexed.hpp>
 
+#include <exception>
+#include <functional>
 #include <ostream>
 #include <stdio.h>
+#include <thread>
 
 using ore::data::to_string;
 using QuantLib::Date;
@@ -678,11 +683,11 @@ void ReportWriter::writeCashflowNpv(ore::data::Report& report, const ore::data::
     map<string, Real> npvMap;
     Date asof = Settings::instance().evaluationDate();
     for (Size i = 0; i < cashflowReport.rows(); ++i) {
-        string tradeId = QuantLib::ext::get<string>(cashflowReport.data(tradeIdColumn).at(i));
-        string tradeType = QuantLib::ext::get<string>(cashflowReport.data(tradeTypeColumn).at(i));
-        Date payDate = QuantLib::ext::get<Date>(cashflowReport.data(payDateColumn).at(i));
-        string ccy = QuantLib::ext::get<string>(cashflowReport.data(ccyColumn).at(i));
-        Real pv = QuantLib::ext::get<Real>(cashflowReport.data(pvColumn).at(i));
+        string tradeId = QuantLib::ext::get<string>(cashflowReport.data(tradeIdColumn, i));
+        string tradeType = QuantLib::ext::get<string>(cashflowReport.data(tradeTypeColumn, i));
+        Date payDate = QuantLib::ext::get<Date>(cashflowReport.data(payDateColumn, i));
+        string ccy = QuantLib::ext::get<string>(cashflowReport.data(ccyColumn, i));
+        Real pv = QuantLib::ext::get<Real>(cashflowReport.data(pvColumn, i));
         Real fx = 1.0;
 	// There shouldn't be entries in the cf report without ccy. We assume ccy = baseCcy in this case and log an error.
         if (ccy.empty()) {
@@ -1491,6 +1496,202 @@ void ReportWriter::writePricingStats(ore::data::Report& report, const QuantLib::
     LOG("Pricing stats report written");
 }
 
+void ReportWriter::writePricingProfile(ore::data::Report& report,
+                                       const std::map<std::string, ValuationEngine::PricingProfile>& profiles) {
+
+    LOG("Writing pricing profile report");
+
+    report.addColumn("TradeId", string())
+        .addColumn("TradeType", string())
+        .addColumn("PricingEngine", string())
+        .addColumn("NumberOfPricings", Size())
+        .addColumn("NotificationTime", Size())
+        .addColumn("MarketRecalculationTime", Size())
+        .addColumn("EngineTime", Size())
+        .addColumn("CalculatorTime", Size())
+        .addColumn("TotalTime", Size())
+        .addColumn("AverageTime", Size());
+
+    // times in microseconds, as in the pricing stats report
+    auto us = [](double t) { return static_cast<Size>(t * 1E6 + 0.5); };
+    for (auto const& [tid, p] : profiles) {
+        report.next()
+            .add(tid)
+            .add(p.tradeType)
+            .add(p.pricingEngine)
+            .add(p.pricings)
+            .add(us(p.notification))
+            .add(us(p.marketRecalculation))
+            .add(us(p.engine))
+            .add(us(p.calculators))
+            .add(us(p.total()))
+            .add(p.pricings > 0 ? us(p.total() / p.pricings) : 0);
+    }
+
+    report.end();
+    LOG("Pricing profile report written");
+}
+
+void ReportWriter::writePricingProfileByEngine(
+    ore::data::Report& report, const std::map<std::string, ValuationEngine::PricingProfile>& profiles) {
+
+    LOG("Writing pricing profile by engine report");
+
+    std::map<std::pair<std::string, std::string>, std::pair<Size, ValuationEngine::PricingProfile>> byEngine;
+    for (auto const& [tid, p] : profiles) {
+        auto& e = byEngine[std::make_pair(p.pricingEngine, p.tradeType)];
+        ++e.first;
+        e.second += p;
+    }
+
+    report.addColumn("PricingEngine", string())
+        .addColumn("TradeType", string())
+        .addColumn("NumberOfTrades", Size())
+        .addColumn("NumberOfPricings", Size())
+        .addColumn("NotificationTime", Size())
+        .addColumn("MarketRecalculationTime", Size())
+        .addColumn("EngineTime", Size())
+        .addColumn("CalculatorTime", Size())
+        .addColumn("TotalTime", Size())
+        .addColumn("AverageTime", Size());
+
+    auto us = [](double t) { return static_cast<Size>(t * 1E6 + 0.5); };
+    for (auto const& [key, e] : byEngine) {
+        auto const& p = e.second;
+        report.next()
+            .add(key.first)
+            .add(key.second)
+            .add(e.first)
+            .add(p.pricings)
+            .add(us(p.notification))
+            .add(us(p.marketRecalculation))
+            .add(us(p.engine))
+            .add(us(p.calculators))
+            .add(us(p.total()))
+            .add(p.pricings > 0 ? us(p.total() / p.pricings) : 0);
+    }
+
+    report.end();
+    LOG("Pricing profile by engine report written");
+}
+
+void ReportWriter::writeObserverStatistics(ore::data::Report& report,
+                                           const std::map<std::string, ObserverGraph::TradeStatistics>& statistics) {
+
+    LOG("Writing trade observer statistics report");
+
+    report.addColumn("TradeId", string())
+        .addColumn("TradeType", string())
+        .addColumn("RiskFactors", Size())
+        .addColumn("Notifications", Size())
+        .addColumn("Recalculations", Size())
+        .addColumn("Pricings", Size());
+
+    for (auto const& [tid, s] : statistics) {
+        report.next()
+            .add(tid)
+            .add(s.tradeType)
+            .add(s.riskFactors)
+            .add(s.notifications)
+            .add(s.recalculations)
+            .add(s.pricings);
+    }
+
+    report.end();
+    LOG("Trade observer statistics report written");
+}
+
+void ReportWriter::writeObserverStatistics(
+    ore::data::Report& report,
+    const std::map<ObserverGraph::RiskFactor, ObserverGraph::RiskFactorStatistics>& statistics) {
+
+    LOG("Writing risk factor observer statistics report");
+
+    report.addColumn("KeyType", string())
+        .addColumn("Name", string())
+        .addColumn("Quotes", Size())
+        .addColumn("ObservingTrades", Size())
+        .addColumn("Notifications", Size())
+        .addColumn("Pruned", string());
+
+    for (auto const& [rf, s] : statistics) {
+        report.next()
+            .add(ore::data::to_string(rf.first))
+            .add(rf.second)
+            .add(s.quotes)
+            .add(s.trades)
+            .add(s.notifications)
+            .add(ore::data::to_string(s.pruned));
+    }
+
+    report.end();
+    LOG("Risk factor observer statistics report written");
+}
+
+void ReportWriter::writeEngineBuilderStats(ore::data::Report& report,
+                                           const QuantLib::ext::shared_ptr<ore::data::EngineFactory>& engineFactory) {
+
+    LOG("Writing engine builder stats report");
+
+    report.addColumn("Model", string())
+        .addColumn("Engine", string())
+        .addColumn("TradeTypes", string())
+        .addColumn("CacheHits", Size())
+        .addColumn("CacheMisses", Size())
+        .addColumn("CacheSize", Size());
+
+    for (auto const& [key, builder] : engineFactory->builders()) {
+        auto stats = builder->cacheStatistics();
+        if (stats.hits + stats.misses == 0)
+            continue;
+        report.next()
+            .add(builder->model())
+            .add(builder->engine())
+            .add(boost::algorithm::join(builder->tradeTypes(), "|"))
+            .add(stats.hits)
+            .add(stats.misses)
+            .add(stats.size);
+    }
+
+    report.end();
+    LOG("Engine builder stats report written");
+}
+
+void ReportWriter::writeRuntimeStatistics(ore::data::Report& report) {
+
+    LOG("Writing runtime statistics report");
+
+    report.addColumn("Name", string())
+        .addColumn("Type", string())
+        .addColumn("Count", Size())
+        .addColumn("Total", double(), 6)
+        .addColumn("Average", double(), 6)
+        .addColumn("Min", double(), 6)
+        .addColumn("Max", double(), 6)
+        .addColumn("Threads", Size());
+
+    // timers are reported in seconds, counters by the sum of their increments
+    auto addRows = [&report](const std::string& type,
+                             const std::map<std::string, ore::data::TimerRegistry::Statistics>& stats) {
+        for (auto const& [name, s] : stats) {
+            report.next()
+                .add(name)
+                .add(type)
+                .add(s.count)
+                .add(s.total)
+                .add(s.count > 0 ? s.total / static_cast<double>(s.count) : 0.0)
+                .add(s.min)
+                .add(s.max)
+                .add(s.threads);
+        }
+    };
+    addRows("Timer", ore::data::TimerRegistry::instance().timers());
+    addRows("Counter", ore::data::TimerRegistry::instance().counters());
+
+    report.end();
+    LOG("Runtime statistics report written");
+}
+
 void ReportWriter::writeCube(ore::data::Report& report, const QuantLib::ext::shared_ptr<NPVCube>& cube,
                              const std::map<std::string, std::string>& nettingSetMap) {
     LOG("Writing cube report");
@@ -1733,6 +1934,48 @@ void ReportWriter::writeSIMMReport(
     }
 }
 
+void ReportWriter::writeSIMMTradeAllocationReport(
+    const map<SimmSide, map<NettingSetDetails, pair<string, map<string, Real>>>>& allocations,
+    const QuantLib::ext::shared_ptr<Report>& report, const bool hasNettingSetDetails, const string& simmResultCcy,
+    const string& reportCcy, Real fxSpot) {
+
+    LOG("Writing SIMM trade allocation report.");
+
+    report->addColumn("Portfolio", string());
+    if (hasNettingSetDetails) {
+        for (const string& field : NettingSetDetails::optionalFieldNames())
+            report->addColumn(field, string());
+    }
+    report->addColumn("TradeId", string())
+        .addColumn("SimmSide", string())
+        .addColumn("Regulation", string())
+        .addColumn("AllocatedIM", double(), 2)
+        .addColumn("Currency", string());
+    if (!reportCcy.empty())
+        report->addColumn("AllocatedIM(Report)", double(), 2).addColumn("ReportCurrency", string());
+
+    for (const auto& [side, nettingSetAllocations] : allocations) {
+        for (const auto& [nettingSetDetails, regAllocations] : nettingSetAllocations) {
+            map<string, string> nettingSetMap = nettingSetDetails.mapRepresentation();
+            for (const auto& [tradeId, im] : regAllocations.second) {
+                report->next();
+                for (const string& field : NettingSetDetails::fieldNames(hasNettingSetDetails))
+                    report->add(nettingSetMap[field]);
+                report->add(tradeId)
+                    .add(ore::data::to_string(side))
+                    .add(regAllocations.first)
+                    .add(im)
+                    .add(simmResultCcy);
+                if (!reportCcy.empty())
+                    report->add(im * fxSpot).add(reportCcy);
+            }
+        }
+    }
+
+    report->end();
+    LOG("SIMM trade allocation report written.");
+}
+
 void ReportWriter::writeSIMMData(const ore::analytics::Crif& simmData, const QuantLib::ext::shared_ptr<Report>& dataReport,
                                  const bool hasNettingSetDetails) {
 
@@ -1955,9 +2198,66 @@ void ReportWriter::writeCrifReport(const QuantLib::ext::shared_ptr<Report>& repo
     report->end();
 }
 
+namespace {
+
+// maximum number of scenario values buffered by forEachScenarioBlock()
+constexpr Size scenarioBlockValues = 1000000;
+
+/* Pass the scenarios of the generator in blocks of paths. For each block f(d, k, values, n) is called with the n
+   values of key k on date d, for disjoint sets of keys on up to nThreads threads. The values of each key and date are
+   passed in path order, so the result does not depend on the number of threads. */
+void forEachScenarioBlock(const QuantLib::ext::shared_ptr<ScenarioGenerator>& generator,
+                          const std::vector<RiskFactorKey>& keys, const Size numPaths, const std::vector<Date>& dates,
+                          const Size nThreads, const std::function<void(Size, Size, const Real*, Size)>& f) {
+    const Size nKeys = keys.size();
+    const Size blockPaths =
+        std::max<Size>(1, std::min<Size>(numPaths, scenarioBlockValues / std::max<Size>(nKeys * dates.size(), 1)));
+    // values of key k on date d for path p of the block at (d * nKeys + k) * blockPaths + p
+    std::vector<Real> block(blockPaths * nKeys * dates.size());
+    const Size nWorkers = std::min<Size>(std::max<Size>(nThreads, 1), nKeys);
+    for (Size i0 = 0; i0 < numPaths; i0 += blockPaths) {
+        const Size n = std::min(blockPaths, numPaths - i0);
+        for (Size p = 0; p < n; ++p) {
+            for (Size d = 0; d < dates.size(); ++d) {
+                QuantLib::ext::shared_ptr<Scenario> currentScenario = generator->next(dates[d]);
+                for (Size k = 0; k < nKeys; ++k)
+                    block[(d * nKeys + k) * blockPaths + p] = currentScenario->get(keys[k]);
+            }
+        }
+        auto process = [&](const Size w) {
+            for (Size k = w; k < nKeys; k += nWorkers)
+                for (Size d = 0; d < dates.size(); ++d)
+                    f(d, k, &block[(d * nKeys + k) * blockPaths], n);
+        };
+        if (nWorkers <= 1) {
+            process(0);
+            continue;
+        }
+        std::vector<std::exception_ptr> errors(nWorkers);
+        std::vector<std::thread> workers;
+        for (Size w = 0; w < nWorkers; ++w) {
+            workers.emplace_back([&, w]() {
+                try {
+                    process(w);
+                } catch (...) {
+                    errors[w] = std::current_exception();
+                }
+            });
+        }
+        for (auto& t : workers)
+            t.join();
+        for (const auto& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+    }
+}
+
+} // namespace
+
 void ReportWriter::writeScenarioStatistics(const QuantLib::ext::shared_ptr<ScenarioGenerator>& generator,
     const std::vector<RiskFactorKey>& keys, const Size numPaths,
-    const std::vector<Date>& dates, ore::data::Report& report) {
+    const std::vector<Date>& dates, ore::data::Report& report, const Size nThreads) {
     report.addColumn("Date", Date())
         .addColumn("Key", string())
         .addColumn("min", double(), 8)
@@ -1973,14 +2273,13 @@ void ReportWriter::writeScenarioStatistics(const QuantLib::ext::shared_ptr<Scena
         boost::accumulators::tag::skewness, boost::accumulators::tag::kurtosis>>>
         acc(keys.size() * dates.size());
 
-    for (Size i = 0; i < numPaths; ++i) {
-        for (Size d = 0; d < dates.size(); ++d) {
-            QuantLib::ext::shared_ptr<Scenario> currentScenario = generator->next(dates[d]);
-            for (Size k = 0; k < keys.size(); ++k) {
-                acc[d * keys.size() + k](currentScenario->get(keys[k]));
-            }
-        }
-    }
+    forEachScenarioBlock(generator, keys, numPaths, dates, nThreads,
+                         [&acc, &keys](const Size d, const Size k, const Real* values, const Size n) {
+                             auto& a = acc[d * keys.size() + k];
+                             for (Size i = 0; i < n; ++i)
+                                 a(values[i]);
+                         });
+
     for (Size d = 0; d < dates.size(); ++d) {
         for (Size k = 0; k < keys.size(); ++k) {
             Size idx = d * keys.size() + k;
@@ -2003,57 +2302,68 @@ void ReportWriter::writeScenarioStatistics(const QuantLib::ext::shared_ptr<Scena
     report.end();
 }
 
-namespace {
-template <class I>
-void distributionCount(I begin, I end, const Size steps, std::vector<Real>& bounds, std::vector<Size>& counts) {
-    Real xmin = *std::min_element(begin, end);
-    Real xmax = *std::max_element(begin, end);
-    std::vector<Real> v(begin, end);
-    std::sort(v.begin(), v.end());
-    Real h = (xmax - xmin) / static_cast<Real>(steps);
-    Size idx0 = 0;
-    counts.resize(steps);
-    bounds.resize(steps);
-    for (Size i = 0; i < steps; ++i) {
-        Real v1 = xmin + static_cast<Real>(i + 1) * h;
-        // Need the `i == steps - 1` here because noticed in backtest regression tests that xmax is not getting
-        // included in the count in the last bucket due to numerical accuracy. This ensures that it does.
-        Size idx1 = i == steps - 1 ? v.size() : std::upper_bound(v.begin(), v.end(), v1) - v.begin();
-        counts[i] = idx1 - idx0;
-        bounds[i] = v1;
-        idx0 = idx1;
-    }
-} // distributionCount
-} // namespace
-
 void ReportWriter::writeScenarioDistributions(const QuantLib::ext::shared_ptr<ScenarioGenerator>& generator,
                                               const std::vector<RiskFactorKey>& keys, const Size numPaths,
                                               const std::vector<Date>& dates, const Size distSteps,
-                                              ore::data::Report& report) {
+                                              ore::data::Report& report, const Size nThreads) {
     report.addColumn("Date", Date())
         .addColumn("Key", string())
         .addColumn("Bound", double(), 8)
         .addColumn("Count", Size());
 
-    std::vector<std::vector<std::vector<Real>>> values(
-        dates.size(), std::vector<std::vector<Real>>(keys.size(), std::vector<Real>(numPaths, 0.0)));
+    if (distSteps == 0) {
+        report.end();
+        return;
+    }
 
-    for (Size i = 0; i < numPaths; ++i) {
-        for (Size d = 0; d < dates.size(); ++d) {
-            QuantLib::ext::shared_ptr<Scenario> currentScenario = generator->next(dates[d]);
-            for (Size k = 0; k < keys.size(); ++k) {
-                values[d][k][i] = currentScenario->get(keys[k]);
+    // first pass: the range of each key and date
+
+    const Size nKeys = keys.size();
+    std::vector<Real> xmin(nKeys * dates.size(), QL_MAX_REAL), xmax(nKeys * dates.size(), -QL_MAX_REAL);
+    forEachScenarioBlock(generator, keys, numPaths, dates, nThreads,
+                         [&xmin, &xmax, nKeys](const Size d, const Size k, const Real* values, const Size n) {
+                             Size idx = d * nKeys + k;
+                             for (Size i = 0; i < n; ++i) {
+                                 xmin[idx] = std::min(xmin[idx], values[i]);
+                                 xmax[idx] = std::max(xmax[idx], values[i]);
+                             }
+                         });
+
+    /* second pass: count the values per bucket, bucket i contains the values in (bound(i-1), bound(i)] with bound(i)
+       = xmin + (i + 1) * h, the first bucket also contains xmin and the last bucket all values above bound(steps - 2),
+       so that xmax is included despite rounding */
+
+    generator->reset();
+    std::vector<Size> counts(nKeys * dates.size() * distSteps, 0);
+    forEachScenarioBlock(
+        generator, keys, numPaths, dates, nThreads,
+        [&xmin, &xmax, &counts, nKeys, distSteps](const Size d, const Size k, const Real* values, const Size n) {
+            Size idx = d * nKeys + k;
+            Real h = (xmax[idx] - xmin[idx]) / static_cast<Real>(distSteps);
+            auto bound = [&](const Size i) { return xmin[idx] + static_cast<Real>(i + 1) * h; };
+            for (Size j = 0; j < n; ++j) {
+                Size i = 0;
+                if (h > 0.0) {
+                    i = std::min<Size>(static_cast<Size>(std::max((values[j] - xmin[idx]) / h, 0.0)), distSteps - 1);
+                    while (i > 0 && values[j] <= bound(i - 1))
+                        --i;
+                    while (i < distSteps - 1 && values[j] > bound(i))
+                        ++i;
+                }
+                ++counts[idx * distSteps + i];
             }
-        }
-    }
+        });
 
-    std::vector<Real> bounds;
-    std::vector<Size> counts;
     for (Size d = 0; d < dates.size(); ++d) {
-        for (Size k = 0; k < keys.size(); ++k) {
-            distributionCount(values[d][k].begin(), values[d][k].end(), distSteps, bounds, counts);
+        for (Size k = 0; k < nKeys; ++k) {
+            Size idx = d * nKeys + k;
+            Real h = (xmax[idx] - xmin[idx]) / static_cast<Real>(distSteps);
             for (Size i = 0; i < distSteps; ++i) {
-                report.next().add(dates[d]).add(ore::data::to_string(keys[k])).add(bounds[i]).add(counts[i]);
+                report.next()
+                    .add(dates[d])
+                    .add(ore::data::to_string(keys[k]))
+                    .add(xmin[idx] + static_cast<Real>(i + 1) * h)
+                    .add(counts[idx * distSteps + i]);
             }
         }
     }
@@ -2412,14 +2722,14 @@ Real aggregateTradeFlow(const std::string& tradeId, const Date& d0, const Date&
 
     Real flow = 0.0;
     for (Size i = 0; i < cashFlowReport->rows(); ++i) {
-        string id = boost::get<string>(cashFlowReport->data(tradeIdColumn).at(i));
+        string id = boost::get<string>(cashFlowReport->data(tradeIdColumn, i));
 	if (id != tradeId)
 	    continue;
-	Date date = boost::get<Date>(cashFlowReport->data(dateColumn).at(i));
+	Date date = boost::get<Date>(cashFlowReport->data(dateColumn, i));
 	if (date <= d0 || date > d1)
 	    continue;
-	string ccy = boost::get<string>(cashFlowReport->data(ccyColumn).at(i));
-	Real amount = boost::get<Real>(cashFlowReport->data(amountColumn).at(i));
+	string ccy = boost::get<string>(cashFlowReport->data(ccyColumn, i));
+	Real amount = boost::get<Real>(cashFlowReport->data(amountColumn, i));
 	Real fx = 1.0;
 	if (ccy != baseCurrency)
 	    fx = market->fxRate(ccy + baseCurrency)->value();
@@ -2501,20 +2811,20 @@ void ReportWriter::writePnlReport(ore::data::Report& report,
 
     for (Size i = 0; i < t0NpvReport->rows(); ++i) {
         try {
-	    string tradeId = boost::get<string>(t0NpvReport->data(tradeIdColumn).at(i));
-	    string tradeId2 = boost::get<string>(t0NpvLaggedReport->data(tradeIdColumn).at(i));
-	    string tradeId3 = boost::get<string>(t1NpvLaggedReport->data(tradeIdColumn).at(i));
-	    string tradeId4 = boost::get<string>(t1NpvReport->data(tradeIdColumn).at(i));
+	    string tradeId = boost::get<string>(t0NpvReport->data(tradeIdColumn, i));
+	    string tradeId2 = boost::get<string>(t0NpvLaggedReport->data(tradeIdColumn, i));
+	    string tradeId3 = boost::get<string>(t1NpvLaggedReport->data(tradeIdColumn, i));
+	    string tradeId4 = boost::get<string>(t1NpvReport->data(tradeIdColumn, i));
 	    QL_REQUIRE(tradeId == tradeId2 && tradeId == tradeId3 && tradeId == tradeId4, "inconsistent ordering of NPV reports");
-	    string tradeType = boost::get<string>(t0NpvReport->data(tradeTypeColumn).at(i));
-	    Date maturityDate = boost::get<Date>(t0NpvReport->data(maturityDateColumn).at(i));
-            Real maturityTime = boost::get<Real>(t0NpvReport->data(maturityTimeColumn).at(i));
-	    string ccy = boost::get<string>(t0NpvReport->data(baseCcyColumn).at(i));
+	    string tradeType = boost::get<string>(t0NpvReport->data(tradeTypeColumn, i));
+	    Date maturityDate = boost::get<Date>(t0NpvReport->data(maturityDateColumn, i));
+            Real maturityTime = boost::get<Real>(t0NpvReport->data(maturityTimeColumn, i));
+	    string ccy = boost::get<string>(t0NpvReport->data(baseCcyColumn, i));
 	    QL_REQUIRE(ccy == baseCurrency, "inconsistent NPV and base currencies");
-            Real t0Npv = boost::get<Real>(t0NpvReport->data(npvBaseColumn).at(i));
-            Real t0NpvLagged = boost::get<Real>(t0NpvLaggedReport->data(npvBaseColumn).at(i));
-	    Real t1NpvLagged = boost::get<Real>(t1NpvLaggedReport->data(npvBaseColumn).at(i));
-	    Real t1Npv = boost::get<Real>(t1NpvReport->data(npvBaseColumn).at(i));
+            Real t0Npv = boost::get<Real>(t0NpvReport->data(npvBaseColumn, i));
+            Real t0NpvLagged = boost::get<Real>(t0NpvLaggedReport->data(npvBaseColumn, i));
+	    Real t1NpvLagged = boost::get<Real>(t1NpvLaggedReport->data(npvBaseColumn, i));
+	    Real t1Npv = boost::get<Real>(t1NpvReport->data(npvBaseColumn, i));
             
 	    Real hypotheticalCleanPnl = t0NpvLagged - t0Npv;
 	    Real periodFlow = aggregateTradeFlow(tradeId, startDate, endDate, t0CashFlowReport, market, baseCurrency);
@@ -29,7 +29,9 @@
 #include <orea/app/parameters.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <orea/cube/sensitivitycube.hpp>
+#include <orea/engine/observergraph.hpp>
 #include <orea/engine/sensitivitystream.hpp>
+#include <orea/engine/valuationengine.hpp>
 #include <orea/simm/crifrecord.hpp>
 #include <orea/simm/simmresults.hpp>
 #include <orea/simm/crif.hpp>
@@ -126,6 +128,30 @@ public:
 
     virtual void writePricingStats(ore::data::Report& report, const QuantLib::ext::shared_ptr<Portfolio>& portfolio);
 
+    //! Pricing time per trade split into notification, market recalculation, engine and calculators
+    virtual void writePricingProfile(ore::data::Report& report,
+                                     const std::map<std::string, ValuationEngine::PricingProfile>& profiles);
+
+    //! Pricing profiles aggregated by pricing engine
+    virtual void writePricingProfileByEngine(ore::data::Report& report,
+                                             const std::map<std::string, ValuationEngine::PricingProfile>& profiles);
+
+    //! Notifications, recalculations and pricings per trade, see ObserverGraph
+    virtual void writeObserverStatistics(ore::data::Report& report,
+                                         const std::map<std::string, ObserverGraph::TradeStatistics>& statistics);
+
+    //! Quotes, notifications and observing trades per risk factor, see ObserverGraph
+    virtual void writeObserverStatistics(
+        ore::data::Report& report,
+        const std::map<ObserverGraph::RiskFactor, ObserverGraph::RiskFactorStatistics>& statistics);
+
+    //! Engine cache hits, misses and sizes of the engine builders that were used
+    virtual void writeEngineBuilderStats(ore::data::Report& report,
+                                         const QuantLib::ext::shared_ptr<ore::data::EngineFactory>& engineFactory);
+
+    //! Timer and counter statistics recorded in the TimerRegistry
+    virtual void writeRuntimeStatistics(ore::data::Report& report);
+
     virtual void writeCube(ore::data::Report& report, const QuantLib::ext::shared_ptr<NPVCube>& cube,
                            const std::map<std::string, std::string>& nettingSetMap = std::map<std::string, std::string>());
 
@@ -152,6 +178,17 @@ public:
                     const std::string& simmCalcCcyPost = "", const std::string& reportCcy = "",
                     const bool isFinalSimm = true, QuantLib::Real fxSpot = 1.0, QuantLib::Real outputThreshold = 0.005);
 
+    /*! Write out the Euler allocation of the SIMM to the trades contained in \p allocations. The key is the SIMM side
+        and the netting set, the value is the regulation and the allocated SIMM per trade ID in the SIMM result
+        currency.
+    */
+    virtual void writeSIMMTradeAllocationReport(
+        const std::map<SimmConfiguration::SimmSide,
+                       std::map<NettingSetDetails, std::pair<std::string, std::map<std::string, QuantLib::Real>>>>&
+            allocations,
+        const QuantLib::ext::shared_ptr<ore::data::Report>& report, const bool hasNettingSetDetails = false,
+        const std::string& simmResultCcy = "", const std::string& reportCcy = "", QuantLib::Real fxSpot = 1.0);
+
     //! Write the SIMM data report i.e. the netted CRIF records used in a SIMM calculation
     virtual void writeSIMMData(const ore::analytics::Crif& simmData,
                                const QuantLib::ext::shared_ptr<ore::data::Report>& dataReport,
@@ -161,15 +198,22 @@ public:
     virtual void writeCrifReport(const QuantLib::ext::shared_ptr<ore::data::Report>& report,
                                  const ore::analytics::Crif& crifRecords);
 
+    /*! Write min, mean, max, standard deviation, skewness and kurtosis per key and date. The scenarios are passed in
+        one go, the moments are accumulated per key on up to \p nThreads threads, the memory does not grow with the
+        number of paths. */
     virtual void writeScenarioStatistics(const QuantLib::ext::shared_ptr<ore::analytics::ScenarioGenerator>& generator,
                                          const std::vector<ore::analytics::RiskFactorKey>& keys,
                                          QuantLib::Size numPaths, const std::vector<QuantLib::Date>& dates,
-                                         ore::data::Report& report);
+                                         ore::data::Report& report, const QuantLib::Size nThreads = 1);
 
+    /*! Write histograms with \p distSteps equidistant buckets between the min and max per key and date. The
+        generator is passed twice, the second time after a reset, to determine the ranges and to count the values
+        per bucket on up to \p nThreads threads, the memory does not grow with the number of paths. */
     virtual void writeScenarioDistributions(const QuantLib::ext::shared_ptr<ore::analytics::ScenarioGenerator>& generator,
                                             const std::vector<ore::analytics::RiskFactorKey>& keys,
                                             QuantLib::Size numPaths, const std::vector<QuantLib::Date>& dates,
-                                            QuantLib::Size distSteps, ore::data::Report& report);
+                                            QuantLib::Size distSteps, ore::data::Report& report,
+                                            const QuantLib::Size nThreads = 1);
 
     virtual void
     writeHistoricalScenarioDetails(const QuantLib::ext::shared_ptr<ore::analytics::HistoricalScenarioGenerator>& generator,
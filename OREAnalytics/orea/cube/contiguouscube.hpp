@@ -0,0 +1,231 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/cube/contiguouscube.hpp
+    \brief A cube implementation storing all values in one contiguous buffer which can be shared by slices
+    \ingroup cube
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+
+#include <ql/errors.hpp>
+
+#include <qle/utilities/memoryaccounting.hpp>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+using QuantLib::Date;
+using QuantLib::Real;
+using QuantLib::Size;
+using std::vector;
+
+//! Storage for a ContiguousInMemoryCube, the values are stored in the order id, date, sample, depth
+/*! The storage only holds pointers to the t0 and the future values, the buffers themselves are owned by derived
+    classes, e.g. InMemoryContiguousCubeStorage or MappedFileCubeStorage. */
+template <typename T> struct ContiguousCubeStorage {
+    ContiguousCubeStorage(Size numIds, Size numDates, Size samples, Size depth)
+        : numIds(numIds), numDates(numDates), samples(samples), depth(depth) {}
+    virtual ~ContiguousCubeStorage() {}
+    Size t0Index(Size i, Size d) const { return i * depth + d; }
+    Size index(Size i, Size j, Size k, Size d) const { return ((i * numDates + j) * samples + k) * depth + d; }
+    Size t0Size() const { return numIds * depth; }
+    Size dataSize() const { return numIds * numDates * samples * depth; }
+    const Size numIds, numDates, samples, depth;
+    T* t0Data = nullptr;
+    T* data = nullptr;
+};
+
+//! Contiguous cube storage on the heap
+template <typename T> struct InMemoryContiguousCubeStorage : public ContiguousCubeStorage<T> {
+    InMemoryContiguousCubeStorage(Size numIds, Size numDates, Size samples, Size depth, const T& t)
+        : ContiguousCubeStorage<T>(numIds, numDates, samples, depth),
+          memory(QuantExt::MemoryAccounting::instance().account("NPVCube"),
+                 (this->t0Size() + this->dataSize()) * sizeof(T)),
+          t0Buffer(this->t0Size(), t), buffer(this->dataSize(), t) {
+        this->t0Data = t0Buffer.data();
+        this->data = buffer.data();
+    }
+    // accounted before the buffers are allocated
+    QuantExt::AccountedMemory memory;
+    vector<T> t0Buffer;
+    vector<T> buffer;
+};
+
+//! Slice of a ContiguousInMemoryCube covering a subset of the ids
+/*! A slice reads and writes the values of its ids directly in the buffer of the parent cube. Slices of disjoint id
+    sets can be written to concurrently from different threads.
+
+    \ingroup cube
+*/
+template <typename T> class ContiguousInMemoryCubeSlice : public NPVCube {
+public:
+    ContiguousInMemoryCubeSlice(const Date& asof, const QuantLib::ext::shared_ptr<ContiguousCubeStorage<T>>& storage,
+                                const vector<Date>& dates, const std::map<std::string, Size>& parentIdIdx,
+                                const std::set<std::string>& ids)
+        : asof_(asof), storage_(storage), dates_(dates) {
+        QL_REQUIRE(ids.size() > 0, "ContiguousInMemoryCubeSlice: no ids specified");
+        Size pos = 0;
+        for (auto const& id : ids) {
+            auto p = parentIdIdx.find(id);
+            QL_REQUIRE(p != parentIdIdx.end(), "ContiguousInMemoryCubeSlice: id '" << id << "' not in parent cube");
+            idIdx_[id] = pos++;
+            parentIndex_.push_back(p->second);
+        }
+    }
+
+    Size numIds() const override { return idIdx_.size(); }
+    Size numDates() const override { return storage_->numDates; }
+    Size samples() const override { return storage_->samples; }
+    Size depth() const override { return storage_->depth; }
+    const std::map<std::string, Size>& idsAndIndexes() const override { return idIdx_; }
+    const std::vector<QuantLib::Date>& dates() const override { return dates_; }
+    QuantLib::Date asof() const override { return asof_; }
+
+    Real getT0(Size i, Size d) const override {
+        check(i, 0, 0, d);
+        return storage_->t0Data[storage_->t0Index(parentIndex_[i], d)];
+    }
+    void setT0(Real value, Size i, Size d) override {
+        check(i, 0, 0, d);
+        storage_->t0Data[storage_->t0Index(parentIndex_[i], d)] = static_cast<T>(value);
+    }
+    Real get(Size i, Size j, Size k, Size d) const override {
+        check(i, j, k, d);
+        return storage_->data[storage_->index(parentIndex_[i], j, k, d)];
+    }
+    void set(Real value, Size i, Size j, Size k, Size d) override {
+        check(i, j, k, d);
+        storage_->data[storage_->index(parentIndex_[i], j, k, d)] = static_cast<T>(value);
+    }
+
+private:
+    void check(Size i, Size j, Size k, Size d) const {
+        QL_REQUIRE(i < numIds(), "Out of bounds on ids (i=" << i << ", numIds=" << numIds() << ")");
+        QL_REQUIRE(j < numDates(), "Out of bounds on dates (j=" << j << ", numDates=" << numDates() << ")");
+        QL_REQUIRE(k < samples(), "Out of bounds on samples (k=" << k << ", samples=" << samples() << ")");
+        QL_REQUIRE(d < depth(), "Out of bounds on depth (d=" << d << ", depth=" << depth() << ")");
+    }
+
+    QuantLib::Date asof_;
+    QuantLib::ext::shared_ptr<ContiguousCubeStorage<T>> storage_;
+    vector<QuantLib::Date> dates_;
+    std::map<std::string, Size> idIdx_;
+    vector<Size> parentIndex_;
+};
+
+//! ContiguousInMemoryCube stores the cube in one pre-allocated contiguous buffer
+/*! The cube stores id x date x sample x depth values in a single buffer. Using slice(), views on subsets of the ids
+    can be created which write directly into this buffer. This way several threads can populate one cube without
+    the need to join mini-cubes afterwards, e.g. by handing out slices via the cube factory of the
+    MultiThreadedValuationEngine.
+
+    \ingroup cube
+*/
+template <typename T> class ContiguousInMemoryCube : public NPVCube {
+public:
+    ContiguousInMemoryCube(const Date& asof, const std::set<std::string>& ids, const vector<Date>& dates,
+                           Size samples, Size depth = 1, const T& t = T())
+        : asof_(asof), dates_(dates) {
+        QL_REQUIRE(ids.size() > 0, "ContiguousInMemoryCube: no ids specified");
+        QL_REQUIRE(dates.size() > 0, "ContiguousInMemoryCube: no dates specified");
+        QL_REQUIRE(samples > 0, "ContiguousInMemoryCube: samples must be > 0");
+        QL_REQUIRE(depth > 0, "ContiguousInMemoryCube: depth must be > 0");
+        Size pos = 0;
+        for (const auto& id : ids)
+            idIdx_[id] = pos++;
+        storage_ =
+            QuantLib::ext::make_shared<InMemoryContiguousCubeStorage<T>>(ids.size(), dates.size(), samples, depth, t);
+    }
+
+    Size numIds() const override { return storage_->numIds; }
+    Size numDates() const override { return storage_->numDates; }
+    Size samples() const override { return storage_->samples; }
+    Size depth() const override { return storage_->depth; }
+    const std::map<std::string, Size>& idsAndIndexes() const override { return idIdx_; }
+    const std::vector<QuantLib::Date>& dates() const override { return dates_; }
+    QuantLib::Date asof() const override { return asof_; }
+
+    Real getT0(Size i, Size d) const override {
+        check(i, 0, 0, d);
+        return storage_->t0Data[storage_->t0Index(i, d)];
+    }
+    void setT0(Real value, Size i, Size d) override {
+        check(i, 0, 0, d);
+        storage_->t0Data[storage_->t0Index(i, d)] = static_cast<T>(value);
+    }
+    Real get(Size i, Size j, Size k, Size d) const override {
+        check(i, j, k, d);
+        return storage_->data[storage_->index(i, j, k, d)];
+    }
+    void set(Real value, Size i, Size j, Size k, Size d) override {
+        check(i, j, k, d);
+        storage_->data[storage_->index(i, j, k, d)] = static_cast<T>(value);
+    }
+
+    //! Create a view on the given ids, which must be a subset of the ids of this cube
+    QuantLib::ext::shared_ptr<NPVCube> slice(const std::set<std::string>& ids) const {
+        return QuantLib::ext::make_shared<ContiguousInMemoryCubeSlice<T>>(asof_, storage_, dates_, idIdx_, ids);
+    }
+
+    //! the underlying storage
+    const QuantLib::ext::shared_ptr<ContiguousCubeStorage<T>>& storage() const { return storage_; }
+
+protected:
+    //! ctor for derived cubes providing their own storage
+    ContiguousInMemoryCube(const Date& asof, const std::set<std::string>& ids, const vector<Date>& dates,
+                           const QuantLib::ext::shared_ptr<ContiguousCubeStorage<T>>& storage)
+        : asof_(asof), dates_(dates), storage_(storage) {
+        QL_REQUIRE(ids.size() == storage->numIds, "ContiguousInMemoryCube: number of ids ("
+                                                      << ids.size() << ") does not match storage (" << storage->numIds
+                                                      << ")");
+        QL_REQUIRE(dates.size() == storage->numDates, "ContiguousInMemoryCube: number of dates ("
+                                                          << dates.size() << ") does not match storage ("
+                                                          << storage->numDates << ")");
+        Size pos = 0;
+        for (const auto& id : ids)
+            idIdx_[id] = pos++;
+    }
+
+private:
+    void check(Size i, Size j, Size k, Size d) const {
+        QL_REQUIRE(i < numIds(), "Out of bounds on ids (i=" << i << ", numIds=" << numIds() << ")");
+        QL_REQUIRE(j < numDates(), "Out of bounds on dates (j=" << j << ", numDates=" << numDates() << ")");
+        QL_REQUIRE(k < samples(), "Out of bounds on samples (k=" << k << ", samples=" << samples() << ")");
+        QL_REQUIRE(d < depth(), "Out of bounds on depth (d=" << d << ", depth=" << depth() << ")");
+    }
+
+    QuantLib::Date asof_;
+    vector<QuantLib::Date> dates_;
+    std::map<std::string, Size> idIdx_;
+    QuantLib::ext::shared_ptr<ContiguousCubeStorage<T>> storage_;
+};
+
+//! ContiguousInMemoryCube with single precision floating point numbers.
+using SinglePrecisionContiguousInMemoryCube = ContiguousInMemoryCube<float>;
+
+//! ContiguousInMemoryCube with double precision floating point numbers.
+using DoublePrecisionContiguousInMemoryCube = ContiguousInMemoryCube<double>;
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,124 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/cube/creditstatenpvcube.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/math/comparison.hpp>
+
+namespace ore {
+namespace analytics {
+
+CreditStateNpvCube::CreditStateNpvCube(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size states)
+    : cube_(cube), states_(states), memory_(QuantExt::MemoryAccounting::instance().account("NPVCube")) {
+    QL_REQUIRE(cube_, "CreditStateNpvCube: no cube given");
+    QL_REQUIRE(states_ > 0, "CreditStateNpvCube: states must be > 0");
+    stateIndex_ = cube_->depth() - 1;
+}
+
+Real CreditStateNpvCube::getT0(Size id, Size depth) const {
+    if (depth <= stateIndex_)
+        return cube_->getT0(id, depth);
+    return getState(cube_->getT0(id, stateIndex_), id, 0, 0, depth);
+}
+
+void CreditStateNpvCube::setT0(Real value, Size id, Size depth) {
+    if (depth < stateIndex_) {
+        cube_->setT0(value, id, depth);
+    } else if (depth == stateIndex_) {
+        Real before = cube_->getT0(id, depth);
+        cube_->setT0(value, id, depth);
+        setFirstState(before, cube_->getT0(id, depth), id, 0, 0);
+    } else {
+        setState(value, cube_->getT0(id, stateIndex_), id, 0, 0, depth);
+    }
+}
+
+Real CreditStateNpvCube::get(Size id, Size date, Size sample, Size depth) const {
+    if (depth <= stateIndex_)
+        return cube_->get(id, date, sample, depth);
+    return getState(cube_->get(id, date, sample, stateIndex_), id, date + 1, sample, depth);
+}
+
+void CreditStateNpvCube::set(Real value, Size id, Size date, Size sample, Size depth) {
+    if (depth < stateIndex_) {
+        cube_->set(value, id, date, sample, depth);
+    } else if (depth == stateIndex_) {
+        Real before = cube_->get(id, date, sample, depth);
+        cube_->set(value, id, date, sample, depth);
+        setFirstState(before, cube_->get(id, date, sample, depth), id, date + 1, sample);
+    } else {
+        setState(value, cube_->get(id, date, sample, stateIndex_), id, date + 1, sample, depth);
+    }
+}
+
+Real CreditStateNpvCube::getState(Real first, Size id, Size date, Size sample, Size depth) const {
+    QL_REQUIRE(depth < this->depth(), "CreditStateNpvCube: depth " << depth << " out of range " << this->depth());
+    auto d = deltas_.find(key(id, date));
+    if (d == deltas_.end())
+        return first;
+    return first + d->second[(depth - stateIndex_ - 1) * width(date) + sample];
+}
+
+void CreditStateNpvCube::setState(Real value, Real first, Size id, Size date, Size sample, Size depth) {
+    QL_REQUIRE(depth < this->depth(), "CreditStateNpvCube: depth " << depth << " out of range " << this->depth());
+    Real delta = value - first;
+    auto d = deltas_.find(key(id, date));
+    if (d == deltas_.end()) {
+        if (QuantLib::close_enough(delta, 0.0))
+            return;
+        Size n = (states_ - 1) * width(date);
+        memory_.resize(memory_.bytes() + n * sizeof(float));
+        d = deltas_.emplace(key(id, date), std::vector<float>(n, 0.0f)).first;
+    }
+    d->second[(depth - stateIndex_ - 1) * width(date) + sample] = static_cast<float>(delta);
+}
+
+void CreditStateNpvCube::setFirstState(Real before, Real after, Size id, Size date, Size sample) {
+    // the other states keep their values if they were set before the first state
+    auto d = deltas_.find(key(id, date));
+    if (d == deltas_.end())
+        return;
+    for (Size s = 0; s < states_ - 1; ++s)
+        d->second[s * width(date) + sample] += static_cast<float>(before - after);
+}
+
+void CreditStateNpvCube::remove(Size id) {
+    cube_->remove(id);
+    for (Size date = 0; date <= numDates(); ++date) {
+        auto d = deltas_.find(key(id, date));
+        if (d != deltas_.end()) {
+            memory_.resize(memory_.bytes() - d->second.size() * sizeof(float));
+            deltas_.erase(d);
+        }
+    }
+}
+
+void CreditStateNpvCube::remove(Size id, Size sample) {
+    cube_->remove(id, sample);
+    for (Size date = 1; date <= numDates(); ++date) {
+        auto d = deltas_.find(key(id, date));
+        if (d != deltas_.end()) {
+            for (Size s = 0; s < states_ - 1; ++s)
+                d->second[s * width(date) + sample] = 0.0f;
+        }
+    }
+}
+
+} // namespace analytics
+} // namespace ore
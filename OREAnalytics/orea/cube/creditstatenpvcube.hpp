@@ -0,0 +1,89 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/cube/creditstatenpvcube.hpp
+    \brief cube storing credit state npvs as sparse deltas to the first credit state
+    \ingroup cube
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+
+#include <qle/utilities/memoryaccounting.hpp>
+
+#include <map>
+
+namespace ore {
+namespace analytics {
+using QuantLib::Real;
+using QuantLib::Size;
+
+//! Cube storing the credit state npvs of the last depths as sparse deltas to the first credit state
+/*! The credit state npvs (see CubeInterpretation::creditStateNPVsIndex()) of most trades do not depend on the
+    credit state, i.e. all states carry the same npv. The given dense cube holds the depths up to and including the
+    first credit state, the other states are stored as deltas to the first state, only for the (id, date) pairs where
+    at least one state differs from the first one. The deltas are stored in single precision.
+
+    Like the SparseNpvCube this cube is not thread safe, i.e. set() must not be called concurrently.
+
+    \ingroup cube
+*/
+class CreditStateNpvCube : public NPVCube {
+public:
+    /*! The given cube has depth creditStateNPVsIndex + 1, the resulting cube has depth creditStateNPVsIndex + states */
+    CreditStateNpvCube(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size states);
+
+    Size numIds() const override { return cube_->numIds(); }
+    Size numDates() const override { return cube_->numDates(); }
+    Size samples() const override { return cube_->samples(); }
+    Size depth() const override { return stateIndex_ + states_; }
+    const std::map<std::string, Size>& idsAndIndexes() const override { return cube_->idsAndIndexes(); }
+    const std::vector<QuantLib::Date>& dates() const override { return cube_->dates(); }
+    QuantLib::Date asof() const override { return cube_->asof(); }
+
+    Real getT0(Size id, Size depth = 0) const override;
+    void setT0(Real value, Size id, Size depth = 0) override;
+    Real get(Size id, Size date, Size sample, Size depth = 0) const override;
+    void set(Real value, Size id, Size date, Size sample, Size depth = 0) override;
+
+    void remove(Size id) override;
+    void remove(Size id, Size sample) override;
+
+    //! True if the credit states of the id may carry different npvs on the given date
+    bool stateDependent(Size id, Size date) const { return deltas_.find(key(id, date + 1)) != deltas_.end(); }
+    //! The number of (id, date) pairs with stored deltas, including T0
+    Size stateDependentEntries() const { return deltas_.size(); }
+
+private:
+    // date 0 is T0, date j + 1 is dates()[j]
+    Size key(Size id, Size date) const { return id * (numDates() + 1) + date; }
+    Size width(Size date) const { return date == 0 ? 1 : samples(); }
+    Real getState(Real first, Size id, Size date, Size sample, Size depth) const;
+    void setState(Real value, Real first, Size id, Size date, Size sample, Size depth);
+    void setFirstState(Real before, Real after, Size id, Size date, Size sample);
+
+    QuantLib::ext::shared_ptr<NPVCube> cube_;
+    Size states_;
+    Size stateIndex_;
+    std::map<Size, std::vector<float>> deltas_;
+    QuantExt::AccountedMemory memory_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -18,30 +18,40 @@
 
 #include <orea/cube/cube_io.hpp>
 #include <orea/cube/inmemorycube.hpp>
+#include <orea/cube/mappedfilecube.hpp>
 
 #include <ored/utilities/to_string.hpp>
 
 #include <boost/filesystem.hpp>
 #include <boost/iostreams/device/file_descriptor.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #ifdef ORE_USE_ZLIB
 #include <boost/iostreams/filter/gzip.hpp>
 #endif
 #include <boost/iostreams/filtering_stream.hpp>
 
+#include <cstdint>
+#include <cstring>
 #include <iomanip>
 #include <regex>
+#include <sstream>
 
 namespace ore {
 namespace analytics {
 
 namespace {
 
+bool use_binary_format(const std::string& filename) {
+    // the binary format is selected by the file extension
+    return boost::filesystem::path(filename).extension().string() == ".bin";
+}
+
 bool use_compression(const std::string& filename) {
 #ifdef ORE_USE_ZLIB
-    // assume compression for all filenames that do not end with csv or txt
+    // assume compression for all filenames that do not end with csv, txt or bin
 
     std::string extension = boost::filesystem::path(filename).extension().string();
-    return extension != ".csv" && extension != ".txt";
+    return extension != ".csv" && extension != ".txt" && extension != ".bin";
 #else
     return false;
 #endif
@@ -58,52 +68,48 @@ std::string getMetaData(const std::string& line, const std::string& tag, const b
     return line.substr(0, 1) == "#" && line.substr(2, tag.size()) == tag ? line.substr(15) : std::string();
 }
 
-} // namespace
+// binary format: magic, version, value size, header size, header (text meta data), padding, t0 data, data
+const char binaryCubeMagic[8] = {'O', 'R', 'E', 'C', 'U', 'B', 'E', '\0'};
+const std::uint32_t binaryCubeVersion = 1;
+const std::size_t binaryCubeAlignment = 8;
 
-NPVCubeWithMetaData loadCube(const std::string& filename, const bool doublePrecision) {
-
-    NPVCubeWithMetaData result;
-
-    // open file
-
-    bool gzip = use_compression(filename);
-    std::ifstream in1(filename, gzip ? (std::ios::binary | std::ios::in) : std::ios::in);
-    boost::iostreams::filtering_stream<boost::iostreams::input> in;
-#ifdef ORE_USE_ZLIB
-    if (gzip)
-        in.push(boost::iostreams::gzip_decompressor());
-#endif
-    in.push(in1);
+struct CubeDimensions {
+    QuantLib::Date asof;
+    Size numIds, numDates, samples, depth;
+    std::vector<QuantLib::Date> dates;
+    std::set<std::string> ids;
+};
 
-    // read meta data
+/* read meta data from the input stream, populate the optional meta data in result, on return line contains the first
+   line after the meta data */
+template <class Stream>
+CubeDimensions readMetaData(Stream& in, NPVCubeWithMetaData& result, std::string& line) {
 
-    std::string line;
+    CubeDimensions dim;
 
     std::getline(in, line);
-    QuantLib::Date asof = ore::data::parseDate(getMetaData(line, "asof"));
+    dim.asof = ore::data::parseDate(getMetaData(line, "asof"));
     std::getline(in, line);
-    Size numIds = ore::data::parseInteger(getMetaData(line, "numIds"));
+    dim.numIds = ore::data::parseInteger(getMetaData(line, "numIds"));
     std::getline(in, line);
-    Size numDates = ore::data::parseInteger(getMetaData(line, "numDates"));
+    dim.numDates = ore::data::parseInteger(getMetaData(line, "numDates"));
     std::getline(in, line);
-    Size samples = ore::data::parseInteger(getMetaData(line, "samples"));
+    dim.samples = ore::data::parseInteger(getMetaData(line, "samples"));
     std::getline(in, line);
-    Size depth = ore::data::parseInteger(getMetaData(line, "depth"));
+    dim.depth = ore::data::parseInteger(getMetaData(line, "depth"));
 
     std::getline(in, line);
     getMetaData(line, "dates");
-    std::vector<QuantLib::Date> dates;
-    for (Size i = 0; i < numDates; ++i) {
+    for (Size i = 0; i < dim.numDates; ++i) {
         std::getline(in, line);
-        dates.push_back(ore::data::parseDate(line.substr(2)));
+        dim.dates.push_back(ore::data::parseDate(line.substr(2)));
     }
 
     std::getline(in, line);
     getMetaData(line, "ids");
-    std::set<std::string> ids;
-    for (Size i = 0; i < numIds; ++i) {
+    for (Size i = 0; i < dim.numIds; ++i) {
         std::getline(in, line);
-        ids.insert(line.substr(2));
+        dim.ids.insert(line.substr(2));
     }
 
     std::getline(in, line);
@@ -126,16 +132,217 @@ NPVCubeWithMetaData loadCube(const std::string& filename, const bool doublePreci
         DLOG("overwrite storeCreditStateNPVs with meta data from cube: " << md);
     }
 
-    QuantLib::ext::shared_ptr<NPVCube> cube;
-    if (doublePrecision && depth <= 1) {
-        cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(asof, ids, dates, samples, 0.0);
-    } else if (doublePrecision && depth > 1) {
-        cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCubeN>(asof, ids, dates, samples, depth, 0.0);
-    } else if (!doublePrecision && depth <= 1) {
-        cube = QuantLib::ext::make_shared<SinglePrecisionInMemoryCube>(asof, ids, dates, samples, 0.0f);
-    } else if (!doublePrecision && depth > 1) {
-        cube = QuantLib::ext::make_shared<SinglePrecisionInMemoryCubeN>(asof, ids, dates, samples, depth, 0.0f);
+    return dim;
+}
+
+template <class Stream> void writeMetaData(Stream& out, const NPVCubeWithMetaData& cube) {
+
+    // write meta data (tag width is hardcoded and used in getMetaData())
+
+    out << "# asof       : " << ore::data::to_string(cube.cube->asof()) << "\n";
+    out << "# numIds     : " << std::to_string(cube.cube->numIds()) << "\n";
+    out << "# numDates   : " << std::to_string(cube.cube->numDates()) << "\n";
+    out << "# samples    : " << ore::data::to_string(cube.cube->samples()) << "\n";
+    out << "# depth      : " << ore::data::to_string(cube.cube->depth()) << "\n";
+    out << "# dates      : \n";
+    for (auto const& d : cube.cube->dates())
+        out << "# " << ore::data::to_string(d) << "\n";
+
+    out << "# ids        : \n";
+    std::map<Size, std::string> ids;
+    for (auto const& d : cube.cube->idsAndIndexes()) {
+        ids[d.second] = d.first;
+    }
+    for (auto const& d : ids) {
+        out << "# " << d.second << "\n";
+    }
+
+    if (cube.scenarioGeneratorData) {
+        std::string scenGenDataXml =
+            std::regex_replace(cube.scenarioGeneratorData->toXMLString(), std::regex("\\r\\n|\\r|\\n|\\t"), "");
+        out << "# scenGenDta : " << scenGenDataXml << "\n";
+    }
+    if (cube.storeFlows) {
+        out << "# storeFlows : " << std::boolalpha << *cube.storeFlows << "\n";
+    }
+    if (cube.storeCreditStateNPVs) {
+        out << "# storeCrSt  : " << *cube.storeCreditStateNPVs << "\n";
+    }
+}
+
+QuantLib::ext::shared_ptr<NPVCube> createCube(const CubeDimensions& dim, const bool doublePrecision) {
+    if (doublePrecision && dim.depth <= 1) {
+        return QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(dim.asof, dim.ids, dim.dates, dim.samples, 0.0);
+    } else if (doublePrecision && dim.depth > 1) {
+        return QuantLib::ext::make_shared<DoublePrecisionInMemoryCubeN>(dim.asof, dim.ids, dim.dates, dim.samples,
+                                                                        dim.depth, 0.0);
+    } else if (!doublePrecision && dim.depth <= 1) {
+        return QuantLib::ext::make_shared<SinglePrecisionInMemoryCube>(dim.asof, dim.ids, dim.dates, dim.samples,
+                                                                       0.0f);
+    } else {
+        return QuantLib::ext::make_shared<SinglePrecisionInMemoryCubeN>(dim.asof, dim.ids, dim.dates, dim.samples,
+                                                                        dim.depth, 0.0f);
+    }
+}
+
+template <typename T>
+void populateCubeFromBuffer(NPVCube& cube, const char* t0Data, const char* data, const Size numIds,
+                            const Size numDates, const Size samples, const Size depth) {
+    const T* t0 = reinterpret_cast<const T*>(t0Data);
+    const T* v = reinterpret_cast<const T*>(data);
+    for (Size i = 0; i < numIds; ++i) {
+        for (Size d = 0; d < depth; ++d)
+            cube.setT0(*t0++, i, d);
+        for (Size j = 0; j < numDates; ++j) {
+            for (Size k = 0; k < samples; ++k) {
+                for (Size d = 0; d < depth; ++d) {
+                    cube.set(*v++, i, j, k, d);
+                }
+            }
+        }
+    }
+}
+
+NPVCubeWithMetaData loadCubeBinary(const std::string& filename, const bool doublePrecision,
+                                   const bool memoryMapped) {
+
+    NPVCubeWithMetaData result;
+
+    boost::iostreams::mapped_file_source file(filename);
+    const char* p = file.data();
+    const std::size_t fileSize = file.size();
+
+    // read the preamble and header
+
+    std::uint32_t version, valueSize;
+    std::uint64_t headerSize;
+    const std::size_t preambleSize = sizeof(binaryCubeMagic) + sizeof(version) + sizeof(valueSize) + sizeof(headerSize);
+    QL_REQUIRE(fileSize >= preambleSize, "loadCube(): file '" << filename << "' is too small for a binary cube");
+    QL_REQUIRE(std::memcmp(p, binaryCubeMagic, sizeof(binaryCubeMagic)) == 0,
+               "loadCube(): file '" << filename << "' is not a binary cube file");
+    std::memcpy(&version, p + sizeof(binaryCubeMagic), sizeof(version));
+    std::memcpy(&valueSize, p + sizeof(binaryCubeMagic) + sizeof(version), sizeof(valueSize));
+    std::memcpy(&headerSize, p + sizeof(binaryCubeMagic) + sizeof(version) + sizeof(valueSize), sizeof(headerSize));
+    QL_REQUIRE(version == binaryCubeVersion,
+               "loadCube(): binary cube version " << version << " not supported, expected " << binaryCubeVersion);
+    QL_REQUIRE(valueSize == sizeof(float) || valueSize == sizeof(double),
+               "loadCube(): invalid value size " << valueSize << " in binary cube file '" << filename << "'");
+    QL_REQUIRE(fileSize >= preambleSize + headerSize, "loadCube(): binary cube file '" << filename << "' truncated");
+
+    std::istringstream header(std::string(p + preambleSize, headerSize));
+    std::string line;
+    CubeDimensions dim = readMetaData(header, result, line);
+
+    // locate the data blocks and check the file size
+
+    std::size_t t0Offset = preambleSize + headerSize;
+    t0Offset = (t0Offset + binaryCubeAlignment - 1) / binaryCubeAlignment * binaryCubeAlignment;
+    std::size_t dataOffset = t0Offset + dim.numIds * dim.depth * valueSize;
+    std::size_t expectedSize = dataOffset + dim.numIds * dim.numDates * dim.samples * dim.depth * valueSize;
+    QL_REQUIRE(fileSize == expectedSize, "loadCube(): binary cube file '" << filename << "' has size " << fileSize
+                                                                          << ", expected " << expectedSize);
+
+    // map the values in the file or populate an in memory cube
+
+    if (memoryMapped) {
+        if (valueSize == sizeof(double))
+            result.cube = QuantLib::ext::make_shared<MappedBinaryCube<double>>(filename, t0Offset, dim.asof, dim.ids,
+                                                                               dim.dates, dim.samples, dim.depth);
+        else
+            result.cube = QuantLib::ext::make_shared<MappedBinaryCube<float>>(filename, t0Offset, dim.asof, dim.ids,
+                                                                              dim.dates, dim.samples, dim.depth);
+    } else {
+        result.cube = createCube(dim, doublePrecision);
+        if (valueSize == sizeof(double))
+            populateCubeFromBuffer<double>(*result.cube, p + t0Offset, p + dataOffset, dim.numIds, dim.numDates,
+                                           dim.samples, dim.depth);
+        else
+            populateCubeFromBuffer<float>(*result.cube, p + t0Offset, p + dataOffset, dim.numIds, dim.numDates,
+                                          dim.samples, dim.depth);
+    }
+
+    LOG("loaded binary cube from " << filename << ": asof = " << dim.asof << ", dim = " << dim.numIds << " x "
+                                   << dim.numDates << " x " << dim.samples << " x " << dim.depth << ", value size "
+                                   << valueSize << (memoryMapped ? ", memory mapped" : ""));
+
+    return result;
+}
+
+template <typename T> void saveCubeBinary(const std::string& filename, const NPVCubeWithMetaData& cube) {
+
+    std::ofstream out(filename, std::ios::binary | std::ios::out);
+    QL_REQUIRE(out.is_open(), "saveCube(): could not open file '" << filename << "'");
+
+    // write the preamble and header
+
+    std::ostringstream headerStream;
+    writeMetaData(headerStream, cube);
+    std::string header = headerStream.str();
+
+    std::uint32_t version = binaryCubeVersion;
+    std::uint32_t valueSize = sizeof(T);
+    std::uint64_t headerSize = header.size();
+    out.write(binaryCubeMagic, sizeof(binaryCubeMagic));
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out.write(reinterpret_cast<const char*>(&valueSize), sizeof(valueSize));
+    out.write(reinterpret_cast<const char*>(&headerSize), sizeof(headerSize));
+    out.write(header.data(), header.size());
+
+    std::size_t pos = sizeof(binaryCubeMagic) + sizeof(version) + sizeof(valueSize) + sizeof(headerSize) + headerSize;
+    std::size_t padding = (binaryCubeAlignment - pos % binaryCubeAlignment) % binaryCubeAlignment;
+    const char zeros[binaryCubeAlignment] = {};
+    out.write(zeros, padding);
+
+    // write the t0 values
+
+    const NPVCube& c = *cube.cube;
+    std::vector<T> buffer(c.numIds() * c.depth());
+    for (Size i = 0; i < c.numIds(); ++i)
+        for (Size d = 0; d < c.depth(); ++d)
+            buffer[i * c.depth() + d] = static_cast<T>(c.getT0(i, d));
+    out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(T));
+
+    // write one contiguous block per id
+
+    buffer.resize(c.numDates() * c.samples() * c.depth());
+    for (Size i = 0; i < c.numIds(); ++i) {
+        Size n = 0;
+        for (Size j = 0; j < c.numDates(); ++j)
+            for (Size k = 0; k < c.samples(); ++k)
+                for (Size d = 0; d < c.depth(); ++d)
+                    buffer[n++] = static_cast<T>(c.get(i, j, k, d));
+        out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(T));
     }
+
+    QL_REQUIRE(out.good(), "saveCube(): error while writing file '" << filename << "'");
+}
+
+} // namespace
+
+NPVCubeWithMetaData loadCube(const std::string& filename, const bool doublePrecision, const bool memoryMapped) {
+
+    if (use_binary_format(filename))
+        return loadCubeBinary(filename, doublePrecision, memoryMapped);
+
+    NPVCubeWithMetaData result;
+
+    // open file
+
+    bool gzip = use_compression(filename);
+    std::ifstream in1(filename, gzip ? (std::ios::binary | std::ios::in) : std::ios::in);
+    boost::iostreams::filtering_stream<boost::iostreams::input> in;
+#ifdef ORE_USE_ZLIB
+    if (gzip)
+        in.push(boost::iostreams::gzip_decompressor());
+#endif
+    in.push(in1);
+
+    // read meta data
+
+    std::string line;
+    CubeDimensions dim = readMetaData(in, result, line);
+
+    QuantLib::ext::shared_ptr<NPVCube> cube = createCube(dim, doublePrecision);
     result.cube = cube;
 
     vector<string> tokens;
@@ -158,14 +365,23 @@ NPVCubeWithMetaData loadCube(const std::string& filename, const bool doublePreci
         ++nData;
     }
 
-    LOG("loaded cube from " << filename << ": asof = " << asof << ", dim = " << numIds << " x " << numDates << " x "
-                            << samples << " x " << depth << ", " << nData << " data lines read.");
+    LOG("loaded cube from " << filename << ": asof = " << dim.asof << ", dim = " << dim.numIds << " x "
+                            << dim.numDates << " x " << dim.samples << " x " << dim.depth << ", " << nData
+                            << " data lines read.");
 
     return result;
 }
 
 void saveCube(const std::string& filename, const NPVCubeWithMetaData& cube, const bool doublePrecision) {
 
+    if (use_binary_format(filename)) {
+        if (doublePrecision)
+            saveCubeBinary<double>(filename, cube);
+        else
+            saveCubeBinary<float>(filename, cube);
+        return;
+    }
+
     // open file
 
     bool gzip = use_compression(filename);
@@ -177,37 +393,9 @@ void saveCube(const std::string& filename, const NPVCubeWithMetaData& cube, cons
 #endif
     out.push(out1);
 
-    // write meta data (tag width is hardcoded and used in getMetaData())
-
-    out << "# asof       : " << ore::data::to_string(cube.cube->asof()) << "\n";
-    out << "# numIds     : " << std::to_string(cube.cube->numIds()) << "\n";
-    out << "# numDates   : " << std::to_string(cube.cube->numDates()) << "\n";
-    out << "# samples    : " << ore::data::to_string(cube.cube->samples()) << "\n";
-    out << "# depth      : " << ore::data::to_string(cube.cube->depth()) << "\n";
-    out << "# dates      : \n";
-    for (auto const& d : cube.cube->dates())
-        out << "# " << ore::data::to_string(d) << "\n";
+    // write meta data
 
-    out << "# ids        : \n";
-    std::map<Size, std::string> ids;
-    for (auto const& d : cube.cube->idsAndIndexes()) {
-        ids[d.second] = d.first;
-    }
-    for (auto const& d : ids) {
-        out << "# " << d.second << "\n";
-    }
-
-    if (cube.scenarioGeneratorData) {
-        std::string scenGenDataXml =
-            std::regex_replace(cube.scenarioGeneratorData->toXMLString(), std::regex("\\r\\n|\\r|\\n|\\t"), "");
-        out << "# scenGenDta : " << scenGenDataXml << "\n";
-    }
-    if (cube.storeFlows) {
-        out << "# storeFlows : " << std::boolalpha << *cube.storeFlows << "\n";
-    }
-    if (cube.storeCreditStateNPVs) {
-        out << "# storeCrSt  : " << *cube.storeCreditStateNPVs << "\n";
-    }
+    writeMetaData(out, cube);
 
     // set precision
 
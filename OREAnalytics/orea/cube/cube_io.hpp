@@ -43,7 +43,16 @@ struct NPVCubeWithMetaData {
     boost::optional<Size> storeCreditStateNPVs;
 };
 
-NPVCubeWithMetaData loadCube(const std::string& filename, const bool doublePrecision = false);
+/*! Files with extension .bin are written / read in a binary format: a fixed preamble (magic, version, value size,
+    header size), the meta data in the same text format as above, followed by the t0 values and one contiguous block of
+    dates x samples x depth values per id. The values are stored in single or double precision depending on the
+    doublePrecision flag on saving. On loading, the file is memory mapped and the values are copied into an in memory
+    cube of the precision given by doublePrecision. If memoryMapped is true, a MappedBinaryCube is returned instead,
+    which reads the values directly from the mapped file in the precision they were saved in, i.e. without copying
+    them. The file must then not be modified while the cube is alive. All other extensions use the text format, for
+    which memoryMapped is ignored. */
+NPVCubeWithMetaData loadCube(const std::string& filename, const bool doublePrecision = false,
+                             const bool memoryMapped = false);
 void saveCube(const std::string& filename, const NPVCubeWithMetaData& cube, const bool doublePrecision = false);
 
 QuantLib::ext::shared_ptr<AggregationScenarioData> loadAggregationScenarioData(const std::string& filename);
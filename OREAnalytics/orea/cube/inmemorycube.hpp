@@ -28,6 +28,8 @@
 
 #include <ql/errors.hpp>
 
+#include <qle/utilities/memoryaccounting.hpp>
+
 #include <boost/make_shared.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <set>
@@ -39,11 +41,18 @@ using QuantLib::Real;
 using QuantLib::Size;
 using std::vector;
 
-//! InMemoryCube stores the cube in memory using nested STL vectors
-/*! InMemoryCube stores the cube in memory using nested STL vectors, this class is a template
- *  to allow both single and double precision implementations.
- *
- *  The use of nested STL vectors is adds a small memory overhead (~ 1 to 2%)
+//! Memory layout of an InMemoryCube
+enum class InMemoryCubeLayout {
+    //! order id, date, sample, depth, i.e. the values of one id are contiguous, optimal for writing by id
+    IdMajor,
+    //! order date, sample, id, depth, i.e. the values of one (date, sample) are contiguous, optimal for aggregation
+    SampleMajor
+};
+
+//! InMemoryCube stores the cube in memory in a single flat buffer
+/*! InMemoryCube stores the cube in memory using one STL vector of size ids x dates x samples x depth, the depth
+ *  being the fastest running index. The order of the other dimensions is given by the layout. This class is
+ *  a template to allow both single and double precision implementations.
 
  \ingroup cube
  */
@@ -51,17 +60,20 @@ template <typename T> class InMemoryCubeBase : public NPVCube {
 public:
     //! default ctor
     InMemoryCubeBase(const Date& asof, const std::set<std::string>& ids, const vector<Date>& dates, Size samples,
-                     const T& t = T())
-        : asof_(asof), dates_(dates), samples_(samples), t0Data_(ids.size(), t),
-          data_(ids.size(), vector<vector<T>>(dates.size(), vector<T>(samples, t))) {
+                     Size depth, const T& t = T(), const InMemoryCubeLayout layout = InMemoryCubeLayout::IdMajor)
+        : asof_(asof), dates_(dates), samples_(samples), depth_(depth), layout_(layout) {
         QL_REQUIRE(ids.size() > 0, "InMemoryCube::InMemoryCube no ids specified");
         QL_REQUIRE(dates.size() > 0, "InMemoryCube::InMemoryCube no dates specified");
         QL_REQUIRE(samples > 0, "InMemoryCube::InMemoryCube samples must be > 0");
+        QL_REQUIRE(depth > 0, "InMemoryCube::InMemoryCube depth must be > 0");
         size_t pos = 0;
         for (const auto& id : ids) {
             idIdx_[id] = pos++;
         }
-        
+        memory_ = QuantExt::AccountedMemory(QuantExt::MemoryAccounting::instance().account("NPVCube"),
+                                            (ids.size() + ids.size() * dates.size() * samples) * depth * sizeof(T));
+        t0Data_.resize(ids.size() * depth, t);
+        data_.resize(ids.size() * dates.size() * samples * depth, t);
     }
 
     //! default constructor
@@ -71,6 +83,7 @@ public:
     Size numIds() const override { return idIdx_.size(); }
     Size numDates() const override { return dates_.size(); }
     virtual Size samples() const override { return samples_; }
+    Size depth() const override { return depth_; }
 
     //! Return a map of all ids and their position in the cube
     const std::map<std::string, Size>& idsAndIndexes() const override { return idIdx_; }
@@ -80,6 +93,43 @@ public:
     //! Return the asof date (T0 date)
     QuantLib::Date asof() const override { return asof_; }
 
+    //! Get a T0 value from the cube
+    Real getT0(Size i, Size d) const override {
+        check(i, 0, 0, d);
+        return t0Data_[i * depth_ + d];
+    }
+
+    //! Set a value in the cube
+    void setT0(Real value, Size i, Size d) override {
+        check(i, 0, 0, d);
+        t0Data_[i * depth_ + d] = static_cast<T>(value);
+    }
+
+    //! Get a value from the cube
+    Real get(Size i, Size j, Size k, Size d) const override {
+        check(i, j, k, d);
+        return data_[index(i, j, k, d)];
+    }
+
+    //! Set a value in the cube
+    void set(Real value, Size i, Size j, Size k, Size d) override {
+        check(i, j, k, d);
+        data_[index(i, j, k, d)] = static_cast<T>(value);
+    }
+
+    //! Memory layout of the cube
+    InMemoryCubeLayout layout() const { return layout_; }
+
+    //! The flat buffers of the t0 and future values, ordered as given by index() resp. i * depth + d
+    const T* t0Data() const { return t0Data_.data(); }
+    const T* data() const { return data_.data(); }
+
+    //! Position of (i, j, k, d) in the flat buffer
+    Size index(Size i, Size j, Size k, Size d) const {
+        return layout_ == InMemoryCubeLayout::IdMajor ? ((i * dates_.size() + j) * samples_ + k) * depth_ + d
+                                                      : ((j * samples_ + k) * idIdx_.size() + i) * depth_ + d;
+    }
+
 protected:
     void check(Size i, Size j, Size k, Size d) const {
         QL_REQUIRE(i < numIds(), "Out of bounds on ids (i=" << i << ", numIds=" << numIds() << ")");
@@ -90,94 +140,38 @@ protected:
 
     QuantLib::Date asof_;
     vector<QuantLib::Date> dates_;
-    Size samples_;
+    Size samples_ = 0;
+    Size depth_ = 0;
+    InMemoryCubeLayout layout_ = InMemoryCubeLayout::IdMajor;
     vector<T> t0Data_;
-    vector<vector<vector<T>>> data_;
+    vector<T> data_;
+    QuantExt::AccountedMemory memory_;
 
     std::map<std::string, Size> idIdx_;
 };
 
 //! InMemoryCube of fixed depth 1
-/*! This implementation stores the type directly in an InMemoryCubeBase to avoid us having
- *  nested vectors all of length 1
- */
 template <typename T> class InMemoryCube1 : public InMemoryCubeBase<T> {
 public:
     //! ctor
     InMemoryCube1(const Date& asof, const std::set<std::string>& ids, const vector<Date>& dates, Size samples,
-                  const T& t = T())
-        : InMemoryCubeBase<T>(asof, ids, dates, samples, t) {}
+                  const T& t = T(), const InMemoryCubeLayout layout = InMemoryCubeLayout::IdMajor)
+        : InMemoryCubeBase<T>(asof, ids, dates, samples, 1, t, layout) {}
 
     //! default
     InMemoryCube1() {}
-
-    //! Fixed depth
-    Size depth() const override { return 1; }
-
-    //! Get a T0 value from the cube
-    virtual Real getT0(Size i, Size d) const override {
-        this->check(i, 0, 0, d);
-        return this->t0Data_[i];
-    }
-
-    //! Set a value in the cube
-    virtual void setT0(Real value, Size i, Size d) override {
-        this->check(i, 0, 0, d);
-        this->t0Data_[i] = static_cast<T>(value);
-    }
-
-    //! Get a value from the cube
-    Real get(Size i, Size j, Size k, Size d) const override {
-        this->check(i, j, k, d);
-        return this->data_[i][j][k];
-    }
-
-    //! Set a value in the cube
-    void set(Real value, Size i, Size j, Size k, Size d) override {
-        this->check(i, j, k, d);
-        this->data_[i][j][k] = static_cast<T>(value);
-    }
 };
 
 //! InMemoryCube of variable depth
-/*! This implementation stores a vector an InMemoryCubeBase
- */
-template <typename T> class InMemoryCubeN : public InMemoryCubeBase<vector<T>> {
+template <typename T> class InMemoryCubeN : public InMemoryCubeBase<T> {
 public:
     //! ctor
     InMemoryCubeN(const Date& asof, const std::set<std::string>& ids, const vector<Date>& dates, Size samples, Size depth,
-                  const T& t = T())
-        : InMemoryCubeBase<vector<T>>(asof, ids, dates, samples, vector<T>(depth, t)) {}
+                  const T& t = T(), const InMemoryCubeLayout layout = InMemoryCubeLayout::IdMajor)
+        : InMemoryCubeBase<T>(asof, ids, dates, samples, depth, t, layout) {}
 
     //! default
     InMemoryCubeN() {}
-
-    //! Depth
-    Size depth() const override { return this->data_[0][0][0].size(); } // we don't want any members in this class
-
-    //! Get a T0 value from the cube
-    virtual Real getT0(Size i, Size d) const override {
-        this->check(i, 0, 0, d);
-        return this->t0Data_[i][d];
-    }
-
-    //! Set a value in the cube
-    virtual void setT0(Real value, Size i, Size d) override {
-        this->check(i, 0, 0, d);
-        this->t0Data_[i][d] = static_cast<T>(value);
-    }
-
-    //! Get a value from the cube
-    Real get(Size i, Size j, Size k, Size d) const override {
-        this->check(i, j, k, d);
-        return this->data_[i][j][k][d];
-    }
-
-    //! Set a value in the cube
-    void set(Real value, Size i, Size j, Size k, Size d) override {
-        this->check(i, j, k, d);
-        this->data_[i][j][k][d] = static_cast<T>(value);
-    }
 };
 
 //! InMemoryCube of depth 1 with single precision floating point numbers.
@@ -32,6 +32,10 @@
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/portfolio/trade.hpp>
 #include <ored/utilities/serializationdate.hpp>
+#include <qle/utilities/memoryaccounting.hpp>
+
+#include <algorithm>
+#include <set>
 
 namespace ore {
 namespace analytics {
@@ -64,6 +68,10 @@ public:
 
     Size indexT0(Size dep) const { return dep; }
 
+    Size dateLen() const { return dateLen_; }
+    Size depth() const { return depth_; }
+    Size size() const { return data_.size(); }
+
     bool isValid(Size date, Size dep, Size sample) const {
         // return true if this is valid
         return date < dateLen_ && sample < samples_ && dep < depth_;
@@ -135,6 +143,9 @@ private:
 /*! JaggedCube stores the cube in memory using a vector of trade specific blocks
  *  to allow both single and double precision implementations.
  *
+ *  Each block covers the dates up to the first date on or after the trade maturity, on which the flows paid at
+ *  maturity are stored. Values on later dates are zero and are not stored, setting a nonzero value there throws.
+ *
  \ingroup cube
  */
 template <typename T> class JaggedCube : public ore::analytics::NPVCube {
@@ -149,31 +160,45 @@ public:
         init(asof, portfolio, dates, samples, dc);
     }
 
-    // go back to depth, dep??? they are different
+    /*! Cube for the given ids with constant depth, the maturities are given by id, ids without a maturity are stored
+        on all dates */
+    JaggedCube(Date asof, const std::set<std::string>& ids, const vector<Date>& dates, Size samples, Size depth,
+               const std::map<std::string, Date>& maturities) {
+        asof_ = asof;
+        dates_ = dates;
+        samples_ = samples;
+        maxDepth_ = depth;
+        Size pos = 0;
+        for (const auto& id : ids) {
+            ids_[id] = pos++;
+            auto m = maturities.find(id);
+            blocks_.push_back(
+                TradeBlock<T>(m == maturities.end() ? dates_.size() : dateLen(dates_, m->second), depth, samples));
+        }
+        account();
+    }
+
     void init(Date asof, QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio, const vector<Date>& dates, Size samples,
               const DepthCalculator& dc) {
         asof_ = asof;
         dates_ = dates;
         samples_ = samples;
         maxDepth_ = 0;
-        // Loop over each trade, calculate it's dateLength by checking the trade maturity
-        // get depth with the depth calculator
-        // create a TradeBlock with these parameters and store it.
-        //
-        // setup asof, .....
+        // for each trade set the id and a block with the trade's date length and depth
         Size pos = 0;
         for (const auto& [tid, t] : portfolio->trades()) {
-            // for each trade: set id and set a tradeblock
             ids_[tid] = pos++;
-            // TradeBlock
             Size depth = dc.depth(t);
             maxDepth_ = std::max(maxDepth_, depth);
-
-            Size dateLen = 0;
-            while (dateLen < dates_.size() && dates_[dateLen] < t->maturity())
-                dateLen++;
-            blocks_.push_back(TradeBlock<T>(dateLen, depth, samples));
+            blocks_.push_back(TradeBlock<T>(dateLen(dates_, t->maturity()), depth, samples));
         }
+        account();
+    }
+
+    //! The number of dates stored for a trade with the given maturity
+    static Size dateLen(const vector<Date>& dates, const Date& maturity) {
+        Size n = std::lower_bound(dates.begin(), dates.end(), maturity) - dates.begin();
+        return std::min(n + 1, dates.size());
     }
 
     //! Return the length of each dimension
@@ -183,25 +208,17 @@ public:
     Size depth() const override { return maxDepth_; }
 
     Real avgDateLen() const {
-        // loop  over tradeblocks
         Size dateTotal = 0;
-        Real dateLenAvg = 0.0;
-        for (auto b : blocks_)
-            dateTotal += b.dateLen;
-        // get date length of each
-        // return avg date (float)
-        dateLenAvg = dateTotal / blocks_.size();
-        return dateLenAvg;
+        for (auto const& b : blocks_)
+            dateTotal += b.dateLen();
+        return blocks_.empty() ? 0.0 : static_cast<Real>(dateTotal) / blocks_.size();
     }
 
     Real avgDepth() const {
-        // same as above
         Size depthTotal = 0;
-        Real depthAvg = 0.0;
-        for (auto b : blocks_)
-            depthTotal += b.depth;
-        depthAvg = depthTotal / blocks_.size();
-        return depthAvg;
+        for (auto const& b : blocks_)
+            depthTotal += b.depth();
+        return blocks_.empty() ? 0.0 : static_cast<Real>(depthTotal) / blocks_.size();
     }
 
     //! Get the vector of ids for this cube
@@ -239,6 +256,14 @@ public:
     }
 
 protected:
+    void account() {
+        Size size = 0;
+        for (auto const& b : blocks_)
+            size += b.size();
+        memory_ = QuantExt::AccountedMemory(QuantExt::MemoryAccounting::instance().account("NPVCube"),
+                                            size * sizeof(T));
+    }
+
     void check(Size i, Size j, Size k, Size d) const {
         QL_REQUIRE(i < numIds(), "Out of bounds on ids (i=" << i << ")");
         QL_REQUIRE(j < numDates(), "Out of bounds on dates (j=" << j << ")");
@@ -263,6 +288,7 @@ private:
     Size samples_;
     Size maxDepth_;
     vector<TradeBlock<T>> blocks_;
+    QuantExt::AccountedMemory memory_;
 };
 
 //! Jagged cube with single precision floating point numbers.
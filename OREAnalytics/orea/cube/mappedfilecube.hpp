@@ -0,0 +1,156 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/cube/mappedfilecube.hpp
+    \brief A cube implementation backed by a memory mapped file
+    \ingroup cube
+*/
+
+#pragma once
+
+#include <orea/cube/contiguouscube.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <algorithm>
+
+namespace ore {
+namespace analytics {
+
+//! Contiguous cube storage in a memory mapped file
+/*! The file contains the t0 values followed by the future values in the order id, date, sample, depth, i.e. the
+    values of one id form a contiguous block. The residency of the pages is managed by the operating system, so the
+    cube can be larger than the physical memory. The file is removed on destruction unless keepFile is true. */
+template <typename T> struct MappedFileCubeStorage : public ContiguousCubeStorage<T> {
+    MappedFileCubeStorage(const std::string& filename, Size numIds, Size numDates, Size samples, Size depth,
+                          const T& t, const bool keepFile)
+        : ContiguousCubeStorage<T>(numIds, numDates, samples, depth), filename(filename), keepFile(keepFile) {
+        boost::iostreams::mapped_file_params params(filename);
+        params.flags = boost::iostreams::mapped_file::readwrite;
+        params.new_file_size = (this->t0Size() + this->dataSize()) * sizeof(T);
+        try {
+            file.open(params);
+        } catch (const std::exception& e) {
+            QL_FAIL("MappedFileCubeStorage: could not map file '" << filename << "': " << e.what());
+        }
+        this->t0Data = reinterpret_cast<T*>(file.data());
+        this->data = this->t0Data + this->t0Size();
+        // a new file is zero filled, only overwrite if a different initial value is requested
+        if (t != T()) {
+            std::fill(this->t0Data, this->t0Data + this->t0Size(), t);
+            std::fill(this->data, this->data + this->dataSize(), t);
+        }
+    }
+    ~MappedFileCubeStorage() override {
+        file.close();
+        if (!keepFile) {
+            boost::system::error_code ec;
+            boost::filesystem::remove(filename, ec);
+        }
+    }
+    const std::string filename;
+    const bool keepFile;
+    boost::iostreams::mapped_file file;
+};
+
+//! MappedFileCube stores the cube in a memory mapped file
+/*! The cube has the same layout as the ContiguousInMemoryCube, in particular slices on subsets of the ids can be
+    handed out via the cube factory of the MultiThreadedValuationEngine. If no filename is given, a unique file in
+    the temporary directory is used.
+
+    \ingroup cube
+*/
+template <typename T> class MappedFileCube : public ContiguousInMemoryCube<T> {
+public:
+    MappedFileCube(const std::string& filename, const Date& asof, const std::set<std::string>& ids,
+                   const vector<Date>& dates, Size samples, Size depth = 1, const T& t = T(),
+                   const bool keepFile = false)
+        : ContiguousInMemoryCube<T>(asof, ids, dates, createStorage(filename, ids, dates, samples, depth, t, keepFile)) {
+    }
+
+    //! the file backing this cube
+    const std::string& filename() const {
+        return QuantLib::ext::static_pointer_cast<MappedFileCubeStorage<T>>(this->storage())->filename;
+    }
+
+private:
+    static QuantLib::ext::shared_ptr<ContiguousCubeStorage<T>>
+    createStorage(const std::string& filename, const std::set<std::string>& ids, const vector<Date>& dates,
+                  Size samples, Size depth, const T& t, const bool keepFile) {
+        QL_REQUIRE(ids.size() > 0, "MappedFileCube: no ids specified");
+        QL_REQUIRE(dates.size() > 0, "MappedFileCube: no dates specified");
+        QL_REQUIRE(samples > 0, "MappedFileCube: samples must be > 0");
+        QL_REQUIRE(depth > 0, "MappedFileCube: depth must be > 0");
+        std::string fn = filename.empty() ? (boost::filesystem::temp_directory_path() /
+                                             boost::filesystem::unique_path("orecube-%%%%-%%%%-%%%%-%%%%.dat"))
+                                                .string()
+                                          : filename;
+        return QuantLib::ext::make_shared<MappedFileCubeStorage<T>>(fn, ids.size(), dates.size(), samples, depth, t,
+                                                                    keepFile);
+    }
+};
+
+//! Contiguous cube storage in an existing file, mapped copy on write
+/*! The values start at \p t0Offset in the file, followed by the future values in the same order as above. Changes to
+    the values are private to the mapping and are not written back to the file. */
+template <typename T> struct CopyOnWriteFileCubeStorage : public ContiguousCubeStorage<T> {
+    CopyOnWriteFileCubeStorage(const std::string& filename, Size numIds, Size numDates, Size samples, Size depth,
+                               const std::size_t t0Offset)
+        : ContiguousCubeStorage<T>(numIds, numDates, samples, depth) {
+        boost::iostreams::mapped_file_params params(filename);
+        params.flags = boost::iostreams::mapped_file::priv;
+        try {
+            file.open(params);
+        } catch (const std::exception& e) {
+            QL_FAIL("CopyOnWriteFileCubeStorage: could not map file '" << filename << "': " << e.what());
+        }
+        QL_REQUIRE(file.size() >= t0Offset + (this->t0Size() + this->dataSize()) * sizeof(T),
+                   "CopyOnWriteFileCubeStorage: file '" << filename << "' is too small for the cube");
+        QL_REQUIRE(t0Offset % sizeof(T) == 0,
+                   "CopyOnWriteFileCubeStorage: offset " << t0Offset << " is not aligned to the value size");
+        this->t0Data = reinterpret_cast<T*>(file.data() + t0Offset);
+        this->data = this->t0Data + this->t0Size();
+    }
+    ~CopyOnWriteFileCubeStorage() override { file.close(); }
+    boost::iostreams::mapped_file file;
+};
+
+//! Cube reading its values directly from a memory mapped binary cube file, see loadCube()
+/*! The values are read from the page cache without copying them to the heap, values which are set are copied on
+    write and are not written back to the file. The file must not be modified while the cube is alive.
+
+    \ingroup cube
+*/
+template <typename T> class MappedBinaryCube : public ContiguousInMemoryCube<T> {
+public:
+    MappedBinaryCube(const std::string& filename, const std::size_t t0Offset, const Date& asof,
+                     const std::set<std::string>& ids, const vector<Date>& dates, Size samples, Size depth = 1)
+        : ContiguousInMemoryCube<T>(asof, ids, dates,
+                                    QuantLib::ext::make_shared<CopyOnWriteFileCubeStorage<T>>(
+                                        filename, ids.size(), dates.size(), samples, depth, t0Offset)) {}
+};
+
+//! MappedFileCube with single precision floating point numbers.
+using SinglePrecisionMappedFileCube = MappedFileCube<float>;
+
+//! MappedFileCube with double precision floating point numbers.
+using DoublePrecisionMappedFileCube = MappedFileCube<double>;
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,55 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/cube/sampletruncatedcube.hpp>
+
+#include <ql/errors.hpp>
+
+namespace ore {
+namespace analytics {
+
+SampleTruncatedCube::SampleTruncatedCube(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size samples)
+    : cube_(cube), samples_(samples) {
+    QL_REQUIRE(cube_, "SampleTruncatedCube: no cube given");
+    QL_REQUIRE(samples_ <= cube_->samples(),
+               "SampleTruncatedCube: samples (" << samples_ << ") exceed the cube samples (" << cube_->samples() << ")");
+}
+
+void SampleTruncatedCube::check(Size sample) const {
+    QL_REQUIRE(sample < samples_, "SampleTruncatedCube: sample " << sample << " out of range " << samples_);
+}
+
+Real SampleTruncatedCube::get(Size id, Size date, Size sample, Size depth) const {
+    check(sample);
+    return cube_->get(id, date, sample, depth);
+}
+
+void SampleTruncatedCube::set(Real value, Size id, Size date, Size sample, Size depth) {
+    check(sample);
+    cube_->set(value, id, date, sample, depth);
+}
+
+void SampleTruncatedCube::remove(Size id) { cube_->remove(id); }
+
+void SampleTruncatedCube::remove(Size id, Size sample) {
+    check(sample);
+    cube_->remove(id, sample);
+}
+
+} // namespace analytics
+} // namespace ore
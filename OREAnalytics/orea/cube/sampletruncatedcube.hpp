@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/cube/sampletruncatedcube.hpp
+    \brief view on the first samples of a cube
+    \ingroup cube
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+
+namespace ore {
+namespace analytics {
+using QuantLib::Real;
+using QuantLib::Size;
+
+//! View on the first samples of a cube
+/*! Used when a simulation stops before all samples of the cube are computed, e.g. because the exposures converged,
+    so that the aggregation only sees the computed samples. The data is not copied, setting a value sets it in the
+    underlying cube.
+
+    \ingroup cube
+*/
+class SampleTruncatedCube : public NPVCube {
+public:
+    SampleTruncatedCube(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size samples);
+
+    Size numIds() const override { return cube_->numIds(); }
+    Size numDates() const override { return cube_->numDates(); }
+    Size samples() const override { return samples_; }
+    Size depth() const override { return cube_->depth(); }
+    const std::map<std::string, Size>& idsAndIndexes() const override { return cube_->idsAndIndexes(); }
+    const std::vector<QuantLib::Date>& dates() const override { return cube_->dates(); }
+    QuantLib::Date asof() const override { return cube_->asof(); }
+
+    Real getT0(Size id, Size depth = 0) const override { return cube_->getT0(id, depth); }
+    void setT0(Real value, Size id, Size depth = 0) override { cube_->setT0(value, id, depth); }
+    Real get(Size id, Size date, Size sample, Size depth = 0) const override;
+    void set(Real value, Size id, Size date, Size sample, Size depth = 0) override;
+
+    void remove(Size id) override;
+    void remove(Size id, Size sample) override;
+
+    //! The underlying cube
+    const QuantLib::ext::shared_ptr<NPVCube>& cube() const { return cube_; }
+
+private:
+    void check(Size sample) const;
+
+    QuantLib::ext::shared_ptr<NPVCube> cube_;
+    Size samples_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -43,6 +43,7 @@
 #include <boost/timer/timer.hpp>
 
 #include <future>
+#include <memory>
 
 using namespace ore::data;
 using namespace ore::analytics;
@@ -228,6 +229,23 @@ void runCoreEngine(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
     McEngineStats::instance().calc_timer.start();
     McEngineStats::instance().calc_timer.stop();
 
+    /* register our model for the amc calculator extraction, the mc multileg engines running on it share their
+       calibration paths and the regression factorisations for identical regressors; the registration is removed
+       when the scope is left, also on errors */
+    auto sharedPathsScope = std::make_unique<McSharedPaths::Scope>(model);
+
+    /* collect the simulation times of the mc multileg engines running on our model, so that their calibration paths
+       can be simulated once on the union of the times; the engines abort their calculation in this phase, other
+       trades are priced here already, errors are reported during the extraction below */
+    McSharedPaths::instance().setCollecting(model, true);
+    for (auto const& trade : portfolio->trades()) {
+        try {
+            trade.second->instrument()->qlInstrument(true);
+        } catch (...) {
+        }
+    }
+    McSharedPaths::instance().setCollecting(model, false);
+
     auto extractAmcCalculator = [&amcCalculators, &tradeId, &tradeLabel, &tradeType, &effectiveMultiplier,
                                  &currencyIndex, &tradeFees, &model,
                                  &outputCube](const std::pair<std::string, QuantLib::ext::shared_ptr<Trade>>& trade,
@@ -304,6 +322,8 @@ void runCoreEngine(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
         }
     }
 
+    sharedPathsScope.reset();
+
     timer.stop();
     calibrationTime += timer.elapsed().wall * 1e-9;
     LOG("Extracted " << amcCalculators.size() << " AMCCalculators for " << portfolio->size() << " source trades");
@@ -327,8 +347,35 @@ void runCoreEngine(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
     Size nStates = process->size();
     QL_REQUIRE(sgd->getGrid()->timeGrid().size() > 0, "AMCValuationEngine: empty time grid given");
     std::vector<Real> pathTimes(std::next(sgd->getGrid()->timeGrid().begin(), 1), sgd->getGrid()->timeGrid().end());
-    std::vector<std::vector<RandomVariable>> paths(
-        pathTimes.size(), std::vector<RandomVariable>(nStates, RandomVariable(outputCube->samples())));
+
+    /* the amc calculators run on models projected onto the components their trades require, only the union of the
+       state components they read is stored; the first component is always kept, since the calculators take the
+       number of samples from it */
+    std::vector<bool> requiredState(nStates, false);
+    requiredState[0] = true;
+    for (auto const& c : amcCalculators) {
+        auto indices = c->stateIndices();
+        if (indices.empty()) {
+            std::fill(requiredState.begin(), requiredState.end(), true);
+            break;
+        }
+        for (auto const& k : indices) {
+            QL_REQUIRE(k < nStates, "AMCValuationEngine: state index " << k << " required by amc calculator is out of "
+                                                                        "range, model has " << nStates << " states");
+            requiredState[k] = true;
+        }
+    }
+    std::vector<Size> requiredStates;
+    for (Size k = 0; k < nStates; ++k) {
+        if (requiredState[k])
+            requiredStates.push_back(k);
+    }
+    LOG("Store " << requiredStates.size() << " out of " << nStates << " model states on paths for amc calculators");
+    std::vector<std::vector<RandomVariable>> paths(pathTimes.size(), std::vector<RandomVariable>(nStates));
+    for (auto& p : paths) {
+        for (auto const& k : requiredStates)
+            p[k] = RandomVariable(outputCube->samples());
+    }
 
     // fill fx buffer, ir state buffer and write ASD
 
@@ -357,7 +404,7 @@ void runCoreEngine(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfo
             }
         }
 
-        for (Size k = 0; k < nStates; ++k) {
+        for (auto const& k : requiredStates) {
             for (Size j = 0; j < pathTimes.size(); ++j) {
                 paths[j][k].set(i, path[k][j + 1]);
             }
@@ -889,6 +936,9 @@ void AMCValuationEngine::buildCube(const QuantLib::ext::shared_ptr<ore::data::Po
     for (auto& t : jobs)
         t.join();
 
+    // report the final progress of the threads
+    progressIndicator->flush();
+
     for (Size i = 0; i < results.size(); ++i) {
         results[i].wait();
     }
@@ -18,6 +18,8 @@
 
 #include <orea/engine/bufferedsensitivitystream.hpp>
 
+#include <algorithm>
+
 namespace ore {
 namespace analytics {
 
@@ -35,6 +37,22 @@ SensitivityRecord BufferedSensitivityStream::next() {
     return {};
 }
 
+QuantLib::Size BufferedSensitivityStream::nextBlock(std::vector<SensitivityRecord>& block,
+                                                    const QuantLib::Size maxRecords) {
+    if (index_ == QuantLib::Null<Size>()) {
+        stream_->nextBlock(block, maxRecords);
+        buffer_.insert(buffer_.end(), block.begin(), block.end());
+        return block.size();
+    }
+    // the buffer may contain empty end of stream records from calls to next(), we stop at the first one
+    auto itBegin = buffer_.begin() + std::min(index_, buffer_.size());
+    auto itEnd = itBegin + std::min<std::ptrdiff_t>(maxRecords, std::distance(itBegin, buffer_.end()));
+    auto itEmpty = std::find_if(itBegin, itEnd, [](const SensitivityRecord& sr) { return !sr; });
+    block.assign(itBegin, itEmpty);
+    index_ = itEmpty == itEnd ? std::distance(buffer_.begin(), itEnd) : buffer_.size();
+    return block.size();
+}
+
 void BufferedSensitivityStream::reset() {
     // if next() was never called, we do not switch to the buffered mode
     if (!buffer_.empty())
@@ -31,6 +31,7 @@ class BufferedSensitivityStream : public SensitivityStream {
 public:
     explicit BufferedSensitivityStream(const QuantLib::ext::shared_ptr<SensitivityStream>& stream);
     SensitivityRecord next() override;
+    QuantLib::Size nextBlock(std::vector<SensitivityRecord>& block, const QuantLib::Size maxRecords) override;
     void reset() override;
 
 private:
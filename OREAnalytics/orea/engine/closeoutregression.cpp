@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/closeoutregression.hpp>
+
+#include <ored/utilities/log.hpp>
+
+#include <qle/math/stabilisedglls.hpp>
+
+#include <ql/math/comparison.hpp>
+#include <ql/methods/montecarlo/lsmbasissystem.hpp>
+#include <ql/utilities/dataformatters.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace QuantLib;
+
+namespace ore {
+namespace analytics {
+
+CloseOutRegression::CloseOutRegression(const QuantLib::ext::shared_ptr<ore::data::DateGrid>& grid, Size defaultIndex,
+                                       Size closeOutIndex, Size polynomOrder)
+    : grid_(grid), defaultIndex_(defaultIndex), closeOutIndex_(closeOutIndex), polynomOrder_(polynomOrder) {
+    QL_REQUIRE(grid_, "CloseOutRegression: no date grid given");
+}
+
+void CloseOutRegression::fill(const QuantLib::ext::shared_ptr<NPVCube>& cube,
+                              const QuantLib::ext::shared_ptr<AggregationScenarioData>& scenarioData) const {
+    QL_REQUIRE(cube, "CloseOutRegression: no cube given");
+    QL_REQUIRE(scenarioData, "CloseOutRegression: no scenario data given");
+    QL_REQUIRE(std::max(defaultIndex_, closeOutIndex_) < cube->depth(),
+               "CloseOutRegression: cube depth " << cube->depth() << " too small for default index " << defaultIndex_
+                                                 << " and close-out index " << closeOutIndex_);
+
+    const std::vector<Date> dates = grid_->valuationDates();
+    const Size samples = cube->samples();
+    QL_REQUIRE(dates.size() == cube->numDates(), "CloseOutRegression: grid has " << dates.size()
+                                                                                  << " valuation dates, cube has "
+                                                                                  << cube->numDates());
+
+    Size numeraireSlot = scenarioData->slot(AggregationScenarioDataType::Numeraire);
+    auto basis = LsmBasisSystem::pathBasisSystem(polynomOrder_, LsmBasisSystem::Monomial);
+    QL_REQUIRE(samples > basis.size(), "CloseOutRegression: not enough samples (" << samples
+                                                                                  << ") for polynom order "
+                                                                                  << polynomOrder_);
+
+    std::vector<Real> x(samples), y(samples), e(samples);
+    for (Size j = 0; j < dates.size(); ++j) {
+        Date c = grid_->closeOutDateFromValuationDate(dates[j]);
+        if (c == Date())
+            continue;
+
+        // the first valuation date on or after the close-out date and the interpolation weight
+        Size u = std::lower_bound(dates.begin() + j + 1, dates.end(), c) - dates.begin();
+        Real a = 0.0;
+        if (u < dates.size())
+            a = static_cast<Real>(c - dates[j]) / static_cast<Real>(dates[u] - dates[j]);
+        TLOG("CloseOutRegression: close-out date " << io::iso_date(c) << " for valuation date "
+                                                   << io::iso_date(dates[j]) << ", weight " << a);
+
+        for (Size i = 0; i < cube->numIds(); ++i) {
+            Real meanX = 0.0, meanY = 0.0, variance = 0.0;
+            for (Size k = 0; k < samples; ++k) {
+                x[k] = cube->get(i, j, k, defaultIndex_);
+                y[k] = u < dates.size() ? cube->get(i, u, k, defaultIndex_) : x[k];
+                meanX += x[k];
+                meanY += y[k];
+            }
+            meanX /= samples;
+            meanY /= samples;
+            for (Size k = 0; k < samples; ++k)
+                variance += (x[k] - meanX) * (x[k] - meanX);
+
+            if (u == dates.size() || close_enough(variance, 0.0)) {
+                // no later date or no dispersion in the regressor, the conditional expectation is the mean
+                std::fill(e.begin(), e.end(), meanY);
+            } else {
+                QuantExt::StabilisedGLLS ls(x, y, basis, QuantExt::StabilisedGLLS::MeanStdDev);
+                for (Size k = 0; k < samples; ++k)
+                    e[k] = ls.eval(x[k], basis);
+            }
+
+            for (Size k = 0; k < samples; ++k) {
+                Real n = scenarioData->get(j, k, numeraireSlot);
+                if (u < dates.size())
+                    n *= std::pow(scenarioData->get(u, k, numeraireSlot) / n, a);
+                Real v = x[k] + a * (e[k] - x[k]) + std::sqrt(a) * (y[k] - e[k]);
+                cube->set(v * n, i, j, k, closeOutIndex_);
+            }
+        }
+    }
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/engine/closeoutregression.hpp
+    \brief close-out values estimated from the valuation date values of an exposure simulation
+    \ingroup simulation
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+
+#include <ored/utilities/dategrid.hpp>
+
+namespace ore {
+namespace analytics {
+
+//! Close-out values estimated from the valuation date values instead of a repricing on the close-out dates
+/*! With a close-out grid the trades are priced on the valuation date t and on the close-out date c = t + mpor. This
+    class fills the close-out values of a cube in which only the valuation date values are priced.
+
+    For each trade, the deflated value V(c) is derived from the deflated values V(t) and V(u) on the same path, where
+    u is the first valuation date on or after c. With a = (c - t) / (u - t) and the conditional expectation
+    E = E[V(u) | V(t)], estimated by a polynomial regression of V(u) on V(t) over all samples,
+
+    V(c) = V(t) + a (E - V(t)) + sqrt(a) (V(u) - E),
+
+    i.e. the drift of the value is interpolated linearly and its diffusion is scaled to the close-out horizon. The
+    numeraire on the close-out date is interpolated log-linearly between t and u. If there is no valuation date after
+    t, the valuation date value is used.
+
+    The estimate is accurate if the valuation grid is not much coarser than the margin period of risk and the trades
+    have no large flows or exercises between t and u. Flows on the close-out date itself are unaffected, they are
+    written by the cash flow calculator on the valuation date.
+
+    \ingroup simulation
+*/
+class CloseOutRegression {
+public:
+    /*! The cube stores the deflated valuation date values at defaultIndex, the close-out values (not deflated) are
+        written at closeOutIndex, as the MPORCalculator does. */
+    CloseOutRegression(const QuantLib::ext::shared_ptr<ore::data::DateGrid>& grid, QuantLib::Size defaultIndex,
+                       QuantLib::Size closeOutIndex, QuantLib::Size polynomOrder = 2);
+
+    //! Fill the close-out values of all trades in the cube, the numeraires are read from the scenario data
+    void fill(const QuantLib::ext::shared_ptr<NPVCube>& cube,
+              const QuantLib::ext::shared_ptr<AggregationScenarioData>& scenarioData) const;
+
+private:
+    QuantLib::ext::shared_ptr<ore::data::DateGrid> grid_;
+    QuantLib::Size defaultIndex_, closeOutIndex_, polynomOrder_;
+};
+
+} // namespace analytics
+} // namespace ore
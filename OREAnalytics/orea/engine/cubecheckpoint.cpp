@@ -0,0 +1,193 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/cubecheckpoint.hpp>
+
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/to_string.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+using QuantLib::Size;
+
+namespace {
+const char* const manifestName = "checkpoint.txt";
+const char magic[8] = {'O', 'R', 'E', 'C', 'K', 'P', 'T', '1'};
+
+std::string blockName(const Size begin, const Size end) {
+    return "block_" + std::to_string(begin) + "_" + std::to_string(end) + ".bin";
+}
+} // namespace
+
+CubeCheckpoint::CubeCheckpoint(const std::string& directory, const std::string& key)
+    : directory_(directory), key_(key) {
+    QL_REQUIRE(!directory_.empty(), "CubeCheckpoint: directory is empty");
+    boost::filesystem::create_directories(directory_);
+}
+
+std::string CubeCheckpoint::signature(const NPVCube& cube) const {
+    std::ostringstream s;
+    s << key_ << "|" << ore::data::to_string(cube.asof()) << "|" << cube.numDates() << "|" << cube.samples() << "|"
+      << cube.depth();
+    for (auto const& d : cube.dates())
+        s << "|" << ore::data::to_string(d);
+    for (auto const& [id, index] : cube.idsAndIndexes())
+        s << "|" << id << ":" << index;
+    std::ostringstream h;
+    h << std::hex << std::hash<std::string>()(s.str());
+    return h.str();
+}
+
+void CubeCheckpoint::reset(const std::string& signature) {
+    boost::filesystem::path dir(directory_);
+    for (auto const& f : boost::filesystem::directory_iterator(dir)) {
+        std::string name = f.path().filename().string();
+        if (name == manifestName || (name.compare(0, 6, "block_") == 0 && f.path().extension() == ".bin"))
+            boost::filesystem::remove(f.path());
+    }
+    std::ofstream manifest((dir / manifestName).string());
+    QL_REQUIRE(manifest.is_open(), "CubeCheckpoint: can not write manifest in " << directory_);
+    manifest << "key " << signature << "\n";
+    savedFailedTrades_.clear();
+}
+
+Size CubeCheckpoint::restore(const QuantLib::ext::shared_ptr<NPVCube>& cube, const Size firstSample,
+                             const Size endSample, std::set<std::string>& failedTrades) {
+
+    std::string sig = signature(*cube);
+    boost::filesystem::path dir(directory_);
+    std::ifstream manifest((dir / manifestName).string());
+    std::string line;
+    if (!manifest.is_open() || !std::getline(manifest, line) || line != "key " + sig) {
+        if (manifest.is_open())
+            WLOG("CubeCheckpoint: checkpoint in " << directory_ << " belongs to different inputs, it is discarded");
+        manifest.close();
+        reset(sig);
+        return 0;
+    }
+
+    // walk the recorded blocks, the engine records them in sample order
+
+    Size next = firstSample;
+    std::set<std::string> pendingFailures;
+    while (next < endSample && std::getline(manifest, line)) {
+        std::istringstream l(line);
+        std::string tag;
+        l >> tag;
+        if (tag == "failed") {
+            std::string tradeId;
+            std::getline(l >> std::ws, tradeId);
+            pendingFailures.insert(tradeId);
+        } else if (tag == "block") {
+            Size begin, end;
+            l >> begin >> end;
+            if (begin != next)
+                continue;
+            std::ifstream in((dir / blockName(begin, end)).string(), std::ios::binary);
+            char m[8];
+            std::uint64_t header[5];
+            if (!in.read(m, sizeof(m)) || !std::equal(m, m + 8, magic) ||
+                !in.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != begin ||
+                header[1] != end || header[2] != cube->numIds() || header[3] != cube->numDates() ||
+                header[4] != cube->depth()) {
+                WLOG("CubeCheckpoint: block " << blockName(begin, end) << " in " << directory_
+                                              << " is invalid, resume before it");
+                break;
+            }
+            Size endRestore = std::min(end, endSample);
+            std::vector<double> values((end - begin) * cube->depth());
+            bool ok = true;
+            for (Size i = 0; i < cube->numIds() && ok; ++i) {
+                for (Size j = 0; j < cube->numDates() && ok; ++j) {
+                    if (!in.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(double))) {
+                        ok = false;
+                        break;
+                    }
+                    for (Size s = begin; s < endRestore; ++s)
+                        for (Size d = 0; d < cube->depth(); ++d)
+                            cube->set(values[(s - begin) * cube->depth() + d], i, j, s, d);
+                }
+            }
+            if (!ok) {
+                WLOG("CubeCheckpoint: block " << blockName(begin, end) << " in " << directory_
+                                              << " is truncated, resume before it");
+                break;
+            }
+            failedTrades.insert(pendingFailures.begin(), pendingFailures.end());
+            savedFailedTrades_.insert(pendingFailures.begin(), pendingFailures.end());
+            next = endRestore;
+        }
+    }
+
+    Size restored = next - firstSample;
+    if (restored > 0)
+        LOG("CubeCheckpoint: restored samples " << firstSample << " ... " << next - 1 << " from " << directory_);
+    return restored;
+}
+
+void CubeCheckpoint::save(const QuantLib::ext::shared_ptr<NPVCube>& cube, const Size begin, const Size end,
+                          const std::set<std::string>& failedTrades) {
+
+    // write the block to a temporary file first, so that a recorded block is always complete
+
+    boost::filesystem::path dir(directory_);
+    boost::filesystem::path blockFile = dir / blockName(begin, end);
+    boost::filesystem::path tmpFile = blockFile;
+    tmpFile += ".tmp";
+    {
+        std::ofstream out(tmpFile.string(), std::ios::binary);
+        QL_REQUIRE(out.is_open(), "CubeCheckpoint: can not write block file " << tmpFile.string());
+        std::uint64_t header[5] = {begin, end, cube->numIds(), cube->numDates(), cube->depth()};
+        out.write(magic, sizeof(magic));
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        std::vector<double> values((end - begin) * cube->depth());
+        for (Size i = 0; i < cube->numIds(); ++i) {
+            for (Size j = 0; j < cube->numDates(); ++j) {
+                for (Size s = begin; s < end; ++s)
+                    for (Size d = 0; d < cube->depth(); ++d)
+                        values[(s - begin) * cube->depth() + d] = cube->get(i, j, s, d);
+                out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+            }
+        }
+        QL_REQUIRE(out.good(), "CubeCheckpoint: error writing block file " << tmpFile.string());
+    }
+    boost::filesystem::rename(tmpFile, blockFile);
+
+    std::ofstream manifest((dir / manifestName).string(), std::ios::app);
+    QL_REQUIRE(manifest.is_open(), "CubeCheckpoint: can not append to manifest in " << directory_);
+    for (auto const& tradeId : failedTrades) {
+        if (savedFailedTrades_.insert(tradeId).second)
+            manifest << "failed " << tradeId << "\n";
+    }
+    manifest << "block " << begin << " " << end << "\n";
+    manifest.flush();
+    DLOG("CubeCheckpoint: saved samples " << begin << " ... " << end - 1 << " to " << directory_);
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,74 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/engine/cubecheckpoint.hpp
+    \brief checkpoints of the samples completed by a valuation engine
+    \ingroup simulation
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+
+#include <set>
+#include <string>
+
+namespace ore {
+namespace analytics {
+
+//! Checkpoint of the samples of a cube build, allows to resume an interrupted build
+/*! The valuation engine saves the values of each completed block of samples to a file in the checkpoint directory and
+    records the block in the manifest file checkpoint.txt, together with the trades that failed so far. A block is
+    only recorded once its file is completely written, so that a build interrupted at any point can be resumed from
+    the last recorded block.
+
+    The manifest starts with a hash of the given key and the dimensions and ids of the cube. The key should identify
+    all inputs of the cube build (e.g. market data, configurations and portfolio). If a later build with different
+    inputs uses the same directory, the existing checkpoint is discarded.
+
+    T0 values are not saved, they are recomputed by the engine on resume.
+
+    \ingroup simulation
+*/
+class CubeCheckpoint {
+public:
+    CubeCheckpoint(const std::string& directory, const std::string& key);
+
+    /*! Restore the samples [firstSample, firstSample + n) of the cube from the recorded blocks and return n, the
+        number of consecutive samples available from firstSample, but at most endSample - firstSample. The trades
+        that failed in the restored samples are added to failedTrades. If the checkpoint does not match the key and
+        the cube, it is discarded and 0 is returned. */
+    QuantLib::Size restore(const QuantLib::ext::shared_ptr<NPVCube>& cube, QuantLib::Size firstSample,
+                           QuantLib::Size endSample, std::set<std::string>& failedTrades);
+
+    //! Save the samples [begin, end) of the cube, failedTrades are the trades that failed so far
+    void save(const QuantLib::ext::shared_ptr<NPVCube>& cube, QuantLib::Size begin, QuantLib::Size end,
+              const std::set<std::string>& failedTrades);
+
+    const std::string& directory() const { return directory_; }
+
+private:
+    std::string signature(const NPVCube& cube) const;
+    void reset(const std::string& signature);
+
+    std::string directory_, key_;
+    std::set<std::string> savedFailedTrades_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -50,12 +50,39 @@ SensitivityRecord DecomposedSensitivityStream::next() {
         return ss_->next();
     // No decomposed records left, so continue to the next record
     if (itCurrent_ == decomposedRecords_.end()) {
-        decomposedRecords_ = decompose(ss_->next());
+        decomposedRecords_ = decompose(underlyingIndex_ < underlyingBlock_.size()
+                                           ? underlyingBlock_[underlyingIndex_++]
+                                           : ss_->next());
         itCurrent_ = decomposedRecords_.begin();
     }
     return *(itCurrent_++);
 }
 
+QuantLib::Size DecomposedSensitivityStream::nextBlock(std::vector<SensitivityRecord>& block,
+                                                      const QuantLib::Size maxRecords) {
+    if (!decompose_)
+        return ss_->nextBlock(block, maxRecords);
+    block.clear();
+    while (block.size() < maxRecords) {
+        // Hand out the pending decomposed records first
+        for (; itCurrent_ != decomposedRecords_.end() && block.size() < maxRecords; ++itCurrent_) {
+            if (*itCurrent_)
+                block.push_back(*itCurrent_);
+        }
+        if (block.size() == maxRecords)
+            break;
+        // Decompose the next record from the underlying stream
+        if (underlyingIndex_ == underlyingBlock_.size()) {
+            underlyingIndex_ = 0;
+            if (ss_->nextBlock(underlyingBlock_, maxRecords) == 0)
+                break;
+        }
+        decomposedRecords_ = decompose(underlyingBlock_[underlyingIndex_++]);
+        itCurrent_ = decomposedRecords_.begin();
+    }
+    return block.size();
+}
+
 std::vector<SensitivityRecord> DecomposedSensitivityStream::decompose(const SensitivityRecord& record) const {
     std::vector<SensitivityRecord> results;
 
@@ -326,6 +353,8 @@ void DecomposedSensitivityStream::reset() {
     ss_->reset();
     decomposedRecords_.clear();
     itCurrent_ = decomposedRecords_.begin();
+    underlyingBlock_.clear();
+    underlyingIndex_ = 0;
 }
 
 std::vector<SensitivityRecord>
@@ -50,6 +50,8 @@ public:
         const QuantLib::ext::shared_ptr<ore::data::Market>& todaysMarket = nullptr);
     //! Returns the next SensitivityRecord in the stream after filtering
     SensitivityRecord next() override;
+    //! Returns the next block of SensitivityRecords in the stream after decomposition
+    QuantLib::Size nextBlock(std::vector<SensitivityRecord>& block, const QuantLib::Size maxRecords) override;
     //! Resets the stream so that SensitivityRecord objects can be streamed again
     void reset() override;
 
@@ -104,6 +106,9 @@ private:
     // Scale the fx risk entries from the index decomposition
     std::vector<SensitivityRecord> decomposedRecords_;
     std::vector<SensitivityRecord>::iterator itCurrent_;
+    //! Block read from the underlying stream
+    std::vector<SensitivityRecord> underlyingBlock_;
+    QuantLib::Size underlyingIndex_ = 0;
 
     //! The underlying sensitivity stream that has been wrapped
     QuantLib::ext::shared_ptr<SensitivityStream> ss_;
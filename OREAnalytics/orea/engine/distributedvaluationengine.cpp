@@ -0,0 +1,462 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/cube/cube_io.hpp>
+#include <orea/cube/cubeinterpretation.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/distributedvaluationengine.hpp>
+#include <orea/engine/mporcalculator.hpp>
+#include <orea/engine/multistatenpvcalculator.hpp>
+#include <orea/engine/observationmode.hpp>
+#include <orea/engine/valuationcalculator.hpp>
+#include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/scenariogeneratorbuilder.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/simplescenariofactory.hpp>
+
+#include <ored/configuration/conventions.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/model/crossassetmodelbuilder.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/parsers.hpp>
+#include <ored/utilities/to_string.hpp>
+#include <ored/utilities/xmlutils.hpp>
+
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+namespace ore {
+namespace analytics {
+
+using namespace ore::data;
+using QuantLib::Size;
+
+namespace {
+
+std::string jobFile(const std::string& jobDirectory, const std::string& name) {
+    return (boost::filesystem::path(jobDirectory) / name).string();
+}
+
+std::string partitionFile(const std::string& jobDirectory, const std::string& prefix, const Size partition,
+                          const std::string& extension) {
+    return jobFile(jobDirectory, prefix + "_" + std::to_string(partition) + extension);
+}
+
+std::string readFirstLine(const std::string& filename) {
+    std::ifstream in(filename);
+    std::string line;
+    if (in.is_open())
+        std::getline(in, line);
+    return line;
+}
+
+// the calculators of the classic xva cube, see XvaAnalyticImpl::buildClassicCube()
+std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>>
+classicCalculators(const CubeInterpretation& interpretation, const std::string& baseCurrency, const Date& asof,
+                   const QuantLib::ext::shared_ptr<DateGrid>& grid) {
+    std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators;
+    auto npvCalc = QuantLib::ext::make_shared<NPVCalculator>(baseCurrency);
+    if (interpretation.withCloseOutLag())
+        calculators.push_back(QuantLib::ext::make_shared<MPORCalculator>(
+            npvCalc, interpretation.defaultDateNpvIndex(), interpretation.closeOutDateNpvIndex()));
+    else
+        calculators.push_back(npvCalc);
+    if (interpretation.storeFlows())
+        calculators.push_back(
+            QuantLib::ext::make_shared<CashflowCalculator>(baseCurrency, asof, grid, interpretation.mporFlowsIndex()));
+    if (interpretation.storeCreditStateNPVs() > 0)
+        calculators.push_back(QuantLib::ext::make_shared<MultiStateNPVCalculator>(
+            baseCurrency, interpretation.creditStateNPVsIndex(), interpretation.storeCreditStateNPVs()));
+    return calculators;
+}
+
+} // namespace
+
+DistributedValuationEngine::DistributedValuationEngine(
+    const std::string& workerCommand, const Size partitions, const Size maxWorkers, const std::string& jobDirectory,
+    const QuantLib::Date& today, const QuantLib::ext::shared_ptr<Loader>& loader,
+    const QuantLib::ext::shared_ptr<EngineData>& engineData,
+    const QuantLib::ext::shared_ptr<CurveConfigurations>& curveConfigs,
+    const QuantLib::ext::shared_ptr<TodaysMarketParameters>& todaysMarketParams,
+    const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& simMarketData,
+    const QuantLib::ext::shared_ptr<ScenarioGeneratorData>& scenarioGeneratorData,
+    const QuantLib::ext::shared_ptr<CrossAssetModelData>& crossAssetModelData,
+    const std::map<std::string, std::string>& marketConfigurations, const std::string& baseCurrency,
+    const bool storeFlows, const Size storeCreditStateNPVs, const bool continueOnCalibrationError,
+    const bool salvageCorrelationMatrix, const std::string& observationMode,
+    const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData, const IborFallbackConfig& iborFallbackConfig)
+    : workerCommand_(workerCommand), partitions_(partitions), maxWorkers_(maxWorkers), jobDirectory_(jobDirectory),
+      today_(today), loader_(loader), engineData_(engineData), curveConfigs_(curveConfigs),
+      todaysMarketParams_(todaysMarketParams), simMarketData_(simMarketData),
+      scenarioGeneratorData_(scenarioGeneratorData), crossAssetModelData_(crossAssetModelData),
+      marketConfigurations_(marketConfigurations), baseCurrency_(baseCurrency), storeFlows_(storeFlows),
+      storeCreditStateNPVs_(storeCreditStateNPVs), continueOnCalibrationError_(continueOnCalibrationError),
+      salvageCorrelationMatrix_(salvageCorrelationMatrix), observationMode_(observationMode),
+      referenceData_(referenceData), iborFallbackConfig_(iborFallbackConfig) {
+    QL_REQUIRE(!workerCommand_.empty(), "DistributedValuationEngine: worker command is empty");
+    QL_REQUIRE(partitions_ > 0, "DistributedValuationEngine: number of partitions must be positive");
+    QL_REQUIRE(workerCommand_.find("{job}") != std::string::npos &&
+                   workerCommand_.find("{partition}") != std::string::npos,
+               "DistributedValuationEngine: worker command '" << workerCommand_
+                                                              << "' must contain the placeholders {job} and {partition}");
+}
+
+void DistributedValuationEngine::writeJob(
+    const std::vector<QuantLib::ext::shared_ptr<Portfolio>>& partitions) const {
+
+    // job parameters
+
+    XMLDocument doc;
+    XMLNode* root = doc.allocNode("DistributedValuationJob");
+    doc.appendNode(root);
+    XMLUtils::addChild(doc, root, "Asof", ore::data::to_string(today_));
+    XMLUtils::addChild(doc, root, "Partitions", static_cast<int>(partitions.size()));
+    XMLUtils::addChild(doc, root, "BaseCurrency", baseCurrency_);
+    XMLUtils::addChild(doc, root, "StoreFlows", storeFlows_);
+    XMLUtils::addChild(doc, root, "StoreCreditStateNPVs", static_cast<int>(storeCreditStateNPVs_));
+    XMLUtils::addChild(doc, root, "ContinueOnCalibrationError", continueOnCalibrationError_);
+    XMLUtils::addChild(doc, root, "SalvageCorrelationMatrix", salvageCorrelationMatrix_);
+    XMLUtils::addChild(doc, root, "ObservationMode", observationMode_);
+    XMLUtils::addChild(doc, root, "LogMask", static_cast<int>(Log::instance().mask()));
+    XMLNode* configurations = XMLUtils::addChild(doc, root, "MarketConfigurations");
+    for (auto const& [key, configuration] : marketConfigurations_)
+        XMLUtils::addChild(doc, configurations, key, configuration);
+    doc.toFile(jobFile(jobDirectory_, "job.xml"));
+
+    // market snapshot in the csv loader format
+
+    std::ofstream market(jobFile(jobDirectory_, "market.txt"));
+    QL_REQUIRE(market.is_open(), "DistributedValuationEngine: can not write to job directory " << jobDirectory_);
+    market << std::setprecision(16);
+    for (auto const& datum : loader_->loadQuotes(today_))
+        market << ore::data::to_string(datum->asofDate()) << " " << datum->name() << " "
+               << datum->quote()->value() << "\n";
+    market.close();
+
+    std::ofstream fixings(jobFile(jobDirectory_, "fixings.txt"));
+    fixings << std::setprecision(16);
+    for (auto const& f : loader_->loadFixings())
+        fixings << ore::data::to_string(f.date) << " " << f.name << " " << f.fixing << "\n";
+    fixings.close();
+
+    std::ofstream dividends(jobFile(jobDirectory_, "dividends.txt"));
+    dividends << std::setprecision(16);
+    for (auto const& d : loader_->loadDividends()) {
+        dividends << ore::data::to_string(d.exDate) << " " << d.name << " " << d.rate;
+        if (d.payDate != Date())
+            dividends << " " << ore::data::to_string(d.payDate);
+        dividends << "\n";
+    }
+    dividends.close();
+
+    // configurations, the conventions contain those that were used to build todays market and the portfolio
+
+    InstrumentConventions::instance().conventions()->toFile(jobFile(jobDirectory_, "conventions.xml"));
+    curveConfigs_->toFile(jobFile(jobDirectory_, "curveconfig.xml"));
+    todaysMarketParams_->toFile(jobFile(jobDirectory_, "todaysmarket.xml"));
+    engineData_->toFile(jobFile(jobDirectory_, "pricingengine.xml"));
+    simMarketData_->toFile(jobFile(jobDirectory_, "simmarket.xml"));
+    scenarioGeneratorData_->toFile(jobFile(jobDirectory_, "scenariogenerator.xml"));
+    crossAssetModelData_->toFile(jobFile(jobDirectory_, "crossassetmodel.xml"));
+    iborFallbackConfig_.toFile(jobFile(jobDirectory_, "iborfallback.xml"));
+    if (auto refData = QuantLib::ext::dynamic_pointer_cast<BasicReferenceDataManager>(referenceData_))
+        refData->toFile(jobFile(jobDirectory_, "referencedata.xml"));
+    else if (referenceData_)
+        WLOG("DistributedValuationEngine: reference data manager is not serializable, the workers run without "
+             "reference data");
+
+    // portfolio partitions
+
+    for (Size k = 0; k < partitions.size(); ++k)
+        partitions[k]->toFile(partitionFile(jobDirectory_, "portfolio", k, ".xml"));
+}
+
+void DistributedValuationEngine::runWorkers(const Size partitions) {
+
+    Size nWorkers = maxWorkers_ == 0 ? partitions : std::min(maxWorkers_, partitions);
+    std::vector<int> returnCodes(partitions, -1);
+    std::atomic<Size> next(0), done(0);
+    std::mutex progressMutex;
+
+    auto work = [this, partitions, &returnCodes, &next, &done, &progressMutex]() {
+        Size k;
+        while ((k = next++) < partitions) {
+            std::string command = workerCommand_;
+            boost::replace_all(command, "{job}", jobDirectory_);
+            boost::replace_all(command, "{partition}", std::to_string(k));
+            LOG("DistributedValuationEngine: run worker command '" << command << "'");
+            returnCodes[k] = std::system(command.c_str());
+            std::lock_guard<std::mutex> lock(progressMutex);
+            updateProgress(++done, partitions);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (Size i = 0; i < nWorkers; ++i)
+        threads.emplace_back(work);
+    for (auto& t : threads)
+        t.join();
+
+    for (Size k = 0; k < partitions; ++k) {
+        std::string status = readFirstLine(partitionFile(jobDirectory_, "status", k, ".txt"));
+        QL_REQUIRE(returnCodes[k] == 0 && status == "OK",
+                   "DistributedValuationEngine: worker for partition "
+                       << k << " failed (return code " << returnCodes[k] << "): "
+                       << (status.empty() ? "no status file written" : status) << ", see the job directory "
+                       << jobDirectory_);
+    }
+}
+
+void DistributedValuationEngine::buildCube(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
+                                           const QuantLib::ext::shared_ptr<NPVCube>& outputCube,
+                                           const QuantLib::ext::shared_ptr<AggregationScenarioData>& aggregationScenarioData) {
+
+    boost::timer::cpu_timer timer;
+
+    LOG("DistributedValuationEngine::buildCube() was called");
+
+    QL_REQUIRE(outputCube, "DistributedValuationEngine: no output cube given");
+
+    // set up the job directory
+
+    boost::filesystem::path jobPath =
+        jobDirectory_.empty()
+            ? boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("orejob-%%%%-%%%%-%%%%-%%%%")
+            : boost::filesystem::path(jobDirectory_);
+    boost::filesystem::create_directories(jobPath);
+    jobDirectory_ = boost::filesystem::absolute(jobPath).string();
+    LOG("DistributedValuationEngine: job directory is " << jobDirectory_);
+
+    // split the portfolio round robin, so that the partitions get a similar mix of trade types
+
+    Size nPartitions = std::min(partitions_, std::max<Size>(portfolio->size(), 1));
+    std::vector<QuantLib::ext::shared_ptr<Portfolio>> partitions;
+    for (Size k = 0; k < nPartitions; ++k)
+        partitions.push_back(QuantLib::ext::make_shared<Portfolio>());
+    Size i = 0;
+    for (auto const& [tradeId, trade] : portfolio->trades())
+        partitions[i++ % nPartitions]->add(trade);
+
+    writeJob(partitions);
+    LOG("DistributedValuationEngine: job written, run " << nPartitions << " workers");
+
+    runWorkers(nPartitions);
+
+    // merge the mini-cubes into the output cube
+
+    failedTrades_.clear();
+    for (Size k = 0; k < nPartitions; ++k) {
+        auto miniCube = loadCube(partitionFile(jobDirectory_, "cube", k, ".bin"), false, true).cube;
+        QL_REQUIRE(miniCube->numDates() == outputCube->numDates() && miniCube->samples() == outputCube->samples() &&
+                       miniCube->depth() <= outputCube->depth(),
+                   "DistributedValuationEngine: mini-cube " << k << " (" << miniCube->numDates() << " x "
+                                                            << miniCube->samples() << " x " << miniCube->depth()
+                                                            << ") does not match the output cube ("
+                                                            << outputCube->numDates() << " x " << outputCube->samples()
+                                                            << " x " << outputCube->depth() << ")");
+        for (auto const& [id, miniIndex] : miniCube->idsAndIndexes()) {
+            Size outIndex = outputCube->getTradeIndex(id);
+            for (Size d = 0; d < miniCube->depth(); ++d)
+                outputCube->setT0(miniCube->getT0(miniIndex, d), outIndex, d);
+            for (Size j = 0; j < miniCube->numDates(); ++j)
+                for (Size s = 0; s < miniCube->samples(); ++s)
+                    for (Size d = 0; d < miniCube->depth(); ++d)
+                        outputCube->set(miniCube->get(miniIndex, j, s, d), outIndex, j, s, d);
+        }
+        std::ifstream failed(partitionFile(jobDirectory_, "failed", k, ".txt"));
+        std::string tradeId;
+        while (std::getline(failed, tradeId)) {
+            if (!tradeId.empty()) {
+                ALOG("DistributedValuationEngine: trade '" << tradeId << "' failed in worker " << k
+                                                           << ", its results are set to zero");
+                failedTrades_.insert(tradeId);
+            }
+        }
+    }
+
+    if (aggregationScenarioData) {
+        auto asd = loadAggregationScenarioData(jobFile(jobDirectory_, "scenariodata.csv"));
+        for (auto const& type : asd->keys()) {
+            for (Size j = 0; j < asd->dimDates(); ++j)
+                for (Size s = 0; s < asd->dimSamples(); ++s)
+                    aggregationScenarioData->set(j, s, asd->get(j, s, type.first, type.second), type.first,
+                                                 type.second);
+        }
+    }
+
+    LOG("DistributedValuationEngine::buildCube() finished, timings: "
+        << static_cast<double>(timer.elapsed().wall) / 1.0E9 << "s Wall");
+}
+
+bool runDistributedValuationWorker(const std::string& jobDirectory, const Size partition) {
+
+    std::string statusFile = partitionFile(jobDirectory, "status", partition, ".txt");
+    boost::filesystem::remove(statusFile);
+
+    try {
+        XMLDocument doc(jobFile(jobDirectory, "job.xml"));
+        XMLNode* root = doc.getFirstNode("DistributedValuationJob");
+        QL_REQUIRE(root, "no DistributedValuationJob node found in " << jobDirectory);
+
+        if (!Log::instance().enabled()) {
+            Log::instance().registerLogger(
+                QuantLib::ext::make_shared<FileLogger>(partitionFile(jobDirectory, "log", partition, ".txt")));
+            Log::instance().setMask(XMLUtils::getChildValueAsInt(root, "LogMask", false, 15));
+            Log::instance().switchOn();
+        }
+
+        Date asof = parseDate(XMLUtils::getChildValue(root, "Asof", true));
+        std::string baseCurrency = XMLUtils::getChildValue(root, "BaseCurrency", true);
+        bool storeFlows = XMLUtils::getChildValueAsBool(root, "StoreFlows", false, false);
+        Size storeCreditStateNPVs = XMLUtils::getChildValueAsInt(root, "StoreCreditStateNPVs", false, 0);
+        bool continueOnCalibrationError = XMLUtils::getChildValueAsBool(root, "ContinueOnCalibrationError", false, false);
+        bool salvage = XMLUtils::getChildValueAsBool(root, "SalvageCorrelationMatrix", false, false);
+        std::map<std::string, std::string> marketConfigurations;
+        if (XMLNode* configurations = XMLUtils::getChildNode(root, "MarketConfigurations")) {
+            for (XMLNode* c = XMLUtils::getChildNode(configurations); c; c = XMLUtils::getNextSibling(c))
+                marketConfigurations[XMLUtils::getNodeName(c)] = XMLUtils::getNodeValue(c);
+        }
+        auto config = [&marketConfigurations](const std::string& key) {
+            auto c = marketConfigurations.find(key);
+            return c == marketConfigurations.end() ? Market::defaultConfiguration : c->second;
+        };
+
+        LOG("DistributedValuationWorker: run partition " << partition << " of job " << jobDirectory);
+
+        Settings::instance().evaluationDate() = asof;
+        ObservationMode::instance().setMode(XMLUtils::getChildValue(root, "ObservationMode", false, "None"));
+
+        // configurations
+
+        auto conventions = QuantLib::ext::make_shared<Conventions>();
+        conventions->fromFile(jobFile(jobDirectory, "conventions.xml"));
+        InstrumentConventions::instance().setConventions(conventions);
+        auto curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+        curveConfigs->fromFile(jobFile(jobDirectory, "curveconfig.xml"));
+        auto todaysMarketParams = QuantLib::ext::make_shared<TodaysMarketParameters>();
+        todaysMarketParams->fromFile(jobFile(jobDirectory, "todaysmarket.xml"));
+        auto engineData = QuantLib::ext::make_shared<EngineData>();
+        engineData->fromFile(jobFile(jobDirectory, "pricingengine.xml"));
+        auto simMarketData = QuantLib::ext::make_shared<ScenarioSimMarketParameters>();
+        simMarketData->fromFile(jobFile(jobDirectory, "simmarket.xml"));
+        auto scenarioGeneratorData = QuantLib::ext::make_shared<ScenarioGeneratorData>();
+        scenarioGeneratorData->fromFile(jobFile(jobDirectory, "scenariogenerator.xml"));
+        auto crossAssetModelData = QuantLib::ext::make_shared<CrossAssetModelData>();
+        crossAssetModelData->fromFile(jobFile(jobDirectory, "crossassetmodel.xml"));
+        IborFallbackConfig iborFallbackConfig;
+        iborFallbackConfig.fromFile(jobFile(jobDirectory, "iborfallback.xml"));
+        QuantLib::ext::shared_ptr<BasicReferenceDataManager> referenceData;
+        if (boost::filesystem::exists(jobFile(jobDirectory, "referencedata.xml")))
+            referenceData =
+                QuantLib::ext::make_shared<BasicReferenceDataManager>(jobFile(jobDirectory, "referencedata.xml"));
+
+        // todays market
+
+        auto loader = QuantLib::ext::make_shared<CSVLoader>(
+            jobFile(jobDirectory, "market.txt"), jobFile(jobDirectory, "fixings.txt"),
+            jobFile(jobDirectory, "dividends.txt"), false);
+        auto initMarket = QuantLib::ext::make_shared<TodaysMarket>(asof, todaysMarketParams, loader, curveConfigs, true,
+                                                                   true, true, referenceData, false, iborFallbackConfig,
+                                                                   false, true);
+
+        // model and scenario generator, the scenario generator data carries the seed used by the driver
+
+        std::string simulationConfig = config("simulation");
+        CrossAssetModelBuilder modelBuilder(initMarket, crossAssetModelData, config("lgmcalibration"),
+                                            config("fxcalibration"), config("eqcalibration"), config("infcalibration"),
+                                            config("crcalibration"), simulationConfig, false,
+                                            continueOnCalibrationError, "",
+                                            salvage ? SalvagingAlgorithm::Spectral : SalvagingAlgorithm::None,
+                                            "distributed worker cam building");
+        ScenarioGeneratorBuilder sgb(scenarioGeneratorData);
+        auto scenarioGenerator = sgb.build(*modelBuilder.model(), QuantLib::ext::make_shared<SimpleScenarioFactory>(true),
+                                           simMarketData, asof, initMarket, simulationConfig);
+
+        // simulation market and portfolio
+
+        auto simMarket = QuantLib::ext::make_shared<ScenarioSimMarket>(
+            initMarket, simMarketData, simulationConfig, *curveConfigs, *todaysMarketParams, true, false, false, false,
+            iborFallbackConfig, false);
+        simMarket->scenarioGenerator() = scenarioGenerator;
+
+        auto grid = scenarioGeneratorData->getGrid();
+        Size samples = scenarioGeneratorData->samples();
+        QuantLib::ext::shared_ptr<AggregationScenarioData> asd;
+        if (partition == 0) {
+            asd = QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(grid->valuationDates().size(), samples);
+            simMarket->aggregationScenarioData() = asd;
+        }
+
+        auto engineFactory = QuantLib::ext::make_shared<EngineFactory>(
+            engineData, simMarket, std::map<MarketContext, string>(), referenceData, iborFallbackConfig);
+        auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+        portfolio->fromFile(partitionFile(jobDirectory, "portfolio", partition, ".xml"));
+        portfolio->build(engineFactory, "distributed-worker", true);
+
+        // cube
+
+        CubeInterpretation interpretation(storeFlows, scenarioGeneratorData->withCloseOutLag(),
+                                          QuantLib::Handle<AggregationScenarioData>(), grid, storeCreditStateNPVs);
+        Size depth = interpretation.requiredNpvCubeDepth();
+        QuantLib::ext::shared_ptr<NPVCube> cube;
+        if (depth == 1)
+            cube = QuantLib::ext::make_shared<SinglePrecisionInMemoryCube>(asof, portfolio->ids(),
+                                                                           grid->valuationDates(), samples, 0.0f);
+        else
+            cube = QuantLib::ext::make_shared<SinglePrecisionInMemoryCubeN>(asof, portfolio->ids(),
+                                                                            grid->valuationDates(), samples, depth, 0.0f);
+
+        ValuationEngine engine(asof, grid, simMarket, engineFactory->modelBuilders());
+        engine.buildCube(portfolio, cube, classicCalculators(interpretation, baseCurrency, asof, grid),
+                         scenarioGeneratorData->withMporStickyDate());
+
+        // results
+
+        saveCube(partitionFile(jobDirectory, "cube", partition, ".bin"),
+                 NPVCubeWithMetaData{cube, scenarioGeneratorData, storeFlows, storeCreditStateNPVs});
+        std::ofstream failed(partitionFile(jobDirectory, "failed", partition, ".txt"));
+        for (auto const& tradeId : engine.failedTrades())
+            failed << tradeId << "\n";
+        failed.close();
+        if (asd)
+            saveAggregationScenarioData(jobFile(jobDirectory, "scenariodata.csv"), *asd);
+
+        std::ofstream status(statusFile);
+        status << "OK\n";
+        LOG("DistributedValuationWorker: partition " << partition << " done");
+        return true;
+
+    } catch (const std::exception& e) {
+        ALOG("DistributedValuationWorker: partition " << partition << " failed: " << e.what());
+        std::ofstream status(statusFile);
+        status << e.what() << "\n";
+        return false;
+    }
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,137 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file engine/distributedvaluationengine.hpp
+    \brief valuation engine distributing the cube generation over worker processes
+    \ingroup engine
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+#include <orea/scenario/scenariogeneratordata.hpp>
+#include <orea/scenario/scenariosimmarketparameters.hpp>
+
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/configuration/iborfallbackconfig.hpp>
+#include <ored/marketdata/loader.hpp>
+#include <ored/marketdata/todaysmarketparameters.hpp>
+#include <ored/model/crossassetmodeldata.hpp>
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/referencedata.hpp>
+#include <ored/utilities/progressbar.hpp>
+
+#include <map>
+#include <string>
+
+namespace ore {
+namespace analytics {
+
+//! Valuation engine distributing the classic cube generation over worker processes
+/*! The portfolio is split into partitions which are valued by independent worker processes, possibly on other hosts.
+    The engine writes a job directory containing everything a worker needs to rebuild the simulation:
+
+    - job.xml with the asof date, market configurations and the calculator set up
+    - the market data, fixings and dividends of the loader in the csv loader format
+    - conventions, curve configurations, todays market parameters, pricing engine, simulation market parameters,
+      scenario generator data (including the seed) and cross asset model data
+    - reference data and ibor fallback config
+    - one portfolio file per partition
+
+    Each worker rebuilds todays market, calibrates the cross asset model and generates the scenarios from the same
+    seed, values its partition and writes a mini-cube in the binary cube format, see saveCube(). The engine merges the
+    mini-cubes into the output cube. The first worker also writes the aggregation scenario data.
+
+    The workers are started by running the given shell command, where the placeholders {job} and {partition} are
+    replaced by the job directory and the partition index, e.g.
+
+    - "ore --distributed-worker {job} {partition}" to run the workers on the local host
+    - "ssh node{partition} ore --distributed-worker {job} {partition}" to run them on other hosts
+    - "srun -N1 -n1 ore --distributed-worker {job} {partition}" to submit them to a slurm cluster
+
+    The job directory must be accessible under the same path for the driver and the workers, e.g. on a shared file
+    system. At most maxWorkers commands are run concurrently, if maxWorkers is zero all partitions are started at once.
+
+    Not supported are offset scenarios, netting set cubes and counterparty cubes. */
+class DistributedValuationEngine : public ore::data::ProgressReporter {
+public:
+    DistributedValuationEngine(
+        const std::string& workerCommand, const QuantLib::Size partitions, const QuantLib::Size maxWorkers,
+        const std::string& jobDirectory, const QuantLib::Date& today,
+        const QuantLib::ext::shared_ptr<ore::data::Loader>& loader,
+        const QuantLib::ext::shared_ptr<ore::data::EngineData>& engineData,
+        const QuantLib::ext::shared_ptr<ore::data::CurveConfigurations>& curveConfigs,
+        const QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>& todaysMarketParams,
+        const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& simMarketData,
+        const QuantLib::ext::shared_ptr<ScenarioGeneratorData>& scenarioGeneratorData,
+        const QuantLib::ext::shared_ptr<ore::data::CrossAssetModelData>& crossAssetModelData,
+        //! market configurations keyed by simulation, lgmcalibration, fxcalibration, ... as in InputParameters
+        const std::map<std::string, std::string>& marketConfigurations, const std::string& baseCurrency,
+        const bool storeFlows = false, const QuantLib::Size storeCreditStateNPVs = 0,
+        const bool continueOnCalibrationError = false, const bool salvageCorrelationMatrix = false,
+        const std::string& observationMode = "None",
+        const QuantLib::ext::shared_ptr<ore::data::ReferenceDataManager>& referenceData = nullptr,
+        const ore::data::IborFallbackConfig& iborFallbackConfig = ore::data::IborFallbackConfig::defaultConfig());
+
+    /*! Values the portfolio and writes the results into the output cube, which must contain all trade ids of the
+        portfolio, the valuation dates of the scenario generator grid, the number of samples of the scenario generator
+        data and the depth required by the cube interpretation. If aggregationScenarioData is given, it is populated
+        from the data written by the first worker. */
+    void buildCube(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+                   const QuantLib::ext::shared_ptr<NPVCube>& outputCube,
+                   const QuantLib::ext::shared_ptr<AggregationScenarioData>& aggregationScenarioData = nullptr);
+
+    //! trades that failed in one of the workers, their results are set to zero in the output cube
+    const std::set<std::string>& failedTrades() const { return failedTrades_; }
+
+private:
+    void writeJob(const std::vector<QuantLib::ext::shared_ptr<ore::data::Portfolio>>& partitions) const;
+    void runWorkers(const QuantLib::Size partitions);
+
+    std::string workerCommand_;
+    QuantLib::Size partitions_, maxWorkers_;
+    std::string jobDirectory_;
+    QuantLib::Date today_;
+    QuantLib::ext::shared_ptr<ore::data::Loader> loader_;
+    QuantLib::ext::shared_ptr<ore::data::EngineData> engineData_;
+    QuantLib::ext::shared_ptr<ore::data::CurveConfigurations> curveConfigs_;
+    QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters> todaysMarketParams_;
+    QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> simMarketData_;
+    QuantLib::ext::shared_ptr<ScenarioGeneratorData> scenarioGeneratorData_;
+    QuantLib::ext::shared_ptr<ore::data::CrossAssetModelData> crossAssetModelData_;
+    std::map<std::string, std::string> marketConfigurations_;
+    std::string baseCurrency_;
+    bool storeFlows_;
+    QuantLib::Size storeCreditStateNPVs_;
+    bool continueOnCalibrationError_;
+    bool salvageCorrelationMatrix_;
+    std::string observationMode_;
+    QuantLib::ext::shared_ptr<ore::data::ReferenceDataManager> referenceData_;
+    ore::data::IborFallbackConfig iborFallbackConfig_;
+    std::set<std::string> failedTrades_;
+};
+
+/*! Runs one worker of a DistributedValuationEngine job: values the given partition of the job in the given directory
+    and writes the mini-cube cube_<partition>.bin, the failed trades failed_<partition>.txt and the status file
+    status_<partition>.txt, which contains "OK" on success or the error message otherwise. Returns true on success. */
+bool runDistributedValuationWorker(const std::string& jobDirectory, const QuantLib::Size partition);
+
+} // namespace analytics
+} // namespace ore
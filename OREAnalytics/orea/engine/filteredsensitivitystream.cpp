@@ -30,10 +30,13 @@ FilteredSensitivityStream::FilteredSensitivityStream(const QuantLib::ext::shared
     : ss_(ss), deltaThreshold_(deltaThreshold), gammaThreshold_(gammaThreshold) {
     // Reset the underlying stream in case
     ss_->reset();
-    while (SensitivityRecord sr = ss_->next()) {
-        if (sr.isCrossGamma() && fabs(sr.gamma) > gammaThreshold_) {
-            deltaKeys_.insert(sr.key_1);
-            deltaKeys_.insert(sr.key_2);
+    std::vector<SensitivityRecord> block;
+    while (ss_->nextBlock(block, SensitivityStream::defaultBlockSize) > 0) {
+        for (auto const& sr : block) {
+            if (sr.isCrossGamma() && fabs(sr.gamma) > gammaThreshold_) {
+                deltaKeys_.insert(sr.key_1);
+                deltaKeys_.insert(sr.key_2);
+            }
         }
     }
     ss_->reset();
@@ -43,12 +46,23 @@ FilteredSensitivityStream::FilteredSensitivityStream(const QuantLib::ext::shared
                                                      QuantLib::Real threshold)
     : FilteredSensitivityStream(ss, threshold, threshold) {}
 
+bool FilteredSensitivityStream::keep(const SensitivityRecord& sr) const {
+    return fabs(sr.delta) > deltaThreshold_ || fabs(sr.gamma) > gammaThreshold_ ||
+           (!sr.isCrossGamma() && deltaKeys_.find(sr.key_1) != deltaKeys_.end());
+}
+
 SensitivityRecord FilteredSensitivityStream::next() {
+    // Return the remaining records of a block read via nextBlock() first
+    while (underlyingIndex_ < underlyingBlock_.size()) {
+        const SensitivityRecord& sr = underlyingBlock_[underlyingIndex_++];
+        if (keep(sr))
+            return sr;
+    }
+
     // Return the next sensitivity record in the underlying stream that satisfies
     // the threshold conditions
     while (SensitivityRecord sr = ss_->next()) {
-        if (fabs(sr.delta) > deltaThreshold_ || fabs(sr.gamma) > gammaThreshold_ ||
-            (!sr.isCrossGamma() && deltaKeys_.find(sr.key_1) != deltaKeys_.end())) {
+        if (keep(sr)) {
             return sr;
         }
     }
@@ -57,9 +71,29 @@ SensitivityRecord FilteredSensitivityStream::next() {
     return SensitivityRecord();
 }
 
+QuantLib::Size FilteredSensitivityStream::nextBlock(std::vector<SensitivityRecord>& block,
+                                                    const QuantLib::Size maxRecords) {
+    block.clear();
+    while (block.size() < maxRecords) {
+        // Read the next block from the underlying stream if the current one is exhausted
+        if (underlyingIndex_ == underlyingBlock_.size()) {
+            underlyingIndex_ = 0;
+            if (ss_->nextBlock(underlyingBlock_, maxRecords) == 0)
+                break;
+        }
+        for (; underlyingIndex_ < underlyingBlock_.size() && block.size() < maxRecords; ++underlyingIndex_) {
+            if (keep(underlyingBlock_[underlyingIndex_]))
+                block.push_back(underlyingBlock_[underlyingIndex_]);
+        }
+    }
+    return block.size();
+}
+
 void FilteredSensitivityStream::reset() {
     // Reset the underlying stream
     ss_->reset();
+    underlyingBlock_.clear();
+    underlyingIndex_ = 0;
 }
 
 } // namespace analytics
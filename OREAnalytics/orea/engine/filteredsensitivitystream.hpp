@@ -44,6 +44,8 @@ public:
     FilteredSensitivityStream(const QuantLib::ext::shared_ptr<SensitivityStream>& ss, QuantLib::Real threshold);
     //! Returns the next SensitivityRecord in the stream after filtering
     SensitivityRecord next() override;
+    //! Returns the next block of SensitivityRecords in the stream after filtering
+    QuantLib::Size nextBlock(std::vector<SensitivityRecord>& block, const QuantLib::Size maxRecords) override;
     //! Resets the stream so that SensitivityRecord objects can be streamed again
     void reset() override;
 
@@ -56,6 +58,12 @@ private:
     QuantLib::Real gammaThreshold_;
     //! Set to hold Delta Keys appearing in CrossGammas
     std::set<RiskFactorKey> deltaKeys_;
+    //! Check if a record passes the thresholds
+    bool keep(const SensitivityRecord& sr) const;
+    //! Block read from the underlying stream
+    std::vector<SensitivityRecord> underlyingBlock_;
+    //! Position of the next unread record in underlyingBlock_
+    QuantLib::Size underlyingIndex_ = 0;
 };
 
 } // namespace analytics
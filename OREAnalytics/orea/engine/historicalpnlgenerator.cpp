@@ -21,6 +21,7 @@
 #include <orea/engine/multithreadedvaluationengine.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 
+#include <orea/cube/contiguouscube.hpp>
 #include <orea/cube/jointnpvcube.hpp>
 #include <orea/cube/inmemorycube.hpp>
 
@@ -47,10 +48,10 @@ HistoricalPnlGenerator::HistoricalPnlGenerator(
     const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket,
     const QuantLib::ext::shared_ptr<HistoricalScenarioGenerator>& hisScenGen, const QuantLib::ext::shared_ptr<NPVCube>& cube,
     const set<std::pair<string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>>& modelBuilders, bool dryRun)
-    : useSingleThreadedEngine_(true), portfolio_(portfolio), simMarket_(simMarket), hisScenGen_(hisScenGen),
-      cube_(cube), dryRun_(dryRun),
-      npvCalculator_([&baseCurrency]() -> std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> {
-          return {QuantLib::ext::make_shared<NPVCalculator>(baseCurrency)};
+    : useSingleThreadedEngine_(true), baseCurrency_(baseCurrency), portfolio_(portfolio), simMarket_(simMarket),
+      hisScenGen_(hisScenGen), cube_(cube), dryRun_(dryRun),
+      npvCalculator_([this]() -> std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> {
+          return {QuantLib::ext::make_shared<NPVCalculator>(baseCurrency_)};
       }) {
 
     // Check the cube's dimensions
@@ -85,19 +86,156 @@ HistoricalPnlGenerator::HistoricalPnlGenerator(
     const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& simMarketData,
     const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData, const IborFallbackConfig& iborFallbackConfig,
     bool dryRun, const std::string& context)
-    : useSingleThreadedEngine_(false), portfolio_(portfolio), hisScenGen_(hisScenGen), engineData_(engineData),
+    : useSingleThreadedEngine_(false), baseCurrency_(baseCurrency), portfolio_(portfolio), hisScenGen_(hisScenGen),
+      engineData_(engineData),
       nThreads_(nThreads), today_(today), loader_(loader), curveConfigs_(curveConfigs),
       todaysMarketParams_(todaysMarketParams), configuration_(configuration), simMarketData_(simMarketData),
       referenceData_(referenceData), iborFallbackConfig_(iborFallbackConfig), dryRun_(dryRun), context_(context),
-      npvCalculator_([&baseCurrency]() -> std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> {
-          return {QuantLib::ext::make_shared<NPVCalculator>(baseCurrency)};
+      npvCalculator_([this]() -> std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> {
+          return {QuantLib::ext::make_shared<NPVCalculator>(baseCurrency_)};
       }) {}
 
+void HistoricalPnlGenerator::setSensitivityPnl(const QuantLib::ext::shared_ptr<SensitivityStream>& ss,
+                                               const QuantLib::ext::shared_ptr<ScenarioShiftCalculator>& shiftCalculator,
+                                               const Real gammaThreshold) {
+    QL_REQUIRE(ss == nullptr || shiftCalculator != nullptr,
+               "HistoricalPnlGenerator::setSensitivityPnl(): shift calculator required");
+    QL_REQUIRE(gammaThreshold >= 0.0,
+               "HistoricalPnlGenerator::setSensitivityPnl(): gamma threshold (" << gammaThreshold << ") must be >= 0");
+    sensitivityStream_ = ss;
+    shiftCalculator_ = shiftCalculator;
+    gammaThreshold_ = gammaThreshold;
+}
+
+void HistoricalPnlGenerator::sensitivityPnl(const QuantLib::ext::shared_ptr<ScenarioFilter>& filter,
+                                            map<string, vector<Real>>& pnls, map<string, Real>& baseNpvs) const {
+
+    // collect the sensitivity records per trade, trades with records in a currency other than the base currency
+    // are revalued in full
+    map<string, vector<SensitivityRecord>> records;
+    set<string> excluded;
+    sensitivityStream_->reset();
+    while (SensitivityRecord sr = sensitivityStream_->next()) {
+        if (portfolio_->trades().find(sr.tradeId) == portfolio_->trades().end())
+            continue;
+        if (sr.currency != baseCurrency_)
+            excluded.insert(sr.tradeId);
+        else
+            records[sr.tradeId].push_back(sr);
+    }
+    sensitivityStream_->reset();
+    for (auto const& id : excluded)
+        records.erase(id);
+    if (records.empty())
+        return;
+
+    // the historical shifts for all relevant keys, scenarios x keys
+    map<RiskFactorKey, Size> keyIndex;
+    for (auto const& [_, srs] : records) {
+        for (auto const& sr : srs) {
+            keyIndex.insert(std::make_pair(sr.key_1, keyIndex.size()));
+            if (sr.isCrossGamma())
+                keyIndex.insert(std::make_pair(sr.key_2, keyIndex.size()));
+        }
+    }
+    const Size nKeys = keyIndex.size();
+    const Size nScen = hisScenGen_->numScenarios();
+    QuantLib::ext::shared_ptr<Scenario> baseScenario = hisScenGen_->baseScenario();
+    QL_REQUIRE(baseScenario, "HistoricalPnlGenerator: base scenario not set in historical scenario generator");
+    vector<Real> shifts(nScen * nKeys, 0.0);
+    vector<bool> failed(nKeys, false);
+    hisScenGen_->reset();
+    for (Size i = 0; i < nScen; ++i) {
+        QuantLib::ext::shared_ptr<Scenario> scenario = hisScenGen_->next(baseScenario->asof());
+        for (auto const& [key, k] : keyIndex) {
+            if (failed[k] || (filter && !filter->allow(key)))
+                continue;
+            try {
+                shifts[i * nKeys + k] = shiftCalculator_->shift(key, *baseScenario, *scenario);
+            } catch (const std::exception& e) {
+                DLOG("HistoricalPnlGenerator: could not compute shift for key " << key << ", trades sensitive to this "
+                                                                                << "key are revalued: " << e.what());
+                failed[k] = true;
+            }
+        }
+    }
+    hisScenGen_->reset();
+
+    // delta-gamma P&L per trade and classification
+    vector<Real> deltaPnl(nScen), gammaPnl(nScen);
+    for (auto const& [tradeId, srs] : records) {
+        std::fill(deltaPnl.begin(), deltaPnl.end(), 0.0);
+        std::fill(gammaPnl.begin(), gammaPnl.end(), 0.0);
+        bool valid = true;
+        for (auto const& sr : srs) {
+            Size k1 = keyIndex.at(sr.key_1);
+            if (!sr.isCrossGamma()) {
+                if (failed[k1]) {
+                    valid = false;
+                    break;
+                }
+                for (Size i = 0; i < nScen; ++i) {
+                    Real s = shifts[i * nKeys + k1];
+                    deltaPnl[i] += sr.delta * s;
+                    gammaPnl[i] += 0.5 * sr.gamma * s * s;
+                }
+            } else {
+                Size k2 = keyIndex.at(sr.key_2);
+                if (failed[k1] || failed[k2]) {
+                    valid = false;
+                    break;
+                }
+                for (Size i = 0; i < nScen; ++i)
+                    gammaPnl[i] += sr.gamma * shifts[i * nKeys + k1] * shifts[i * nKeys + k2];
+            }
+        }
+        if (!valid)
+            continue;
+        Real sumDelta = 0.0, sumGamma = 0.0;
+        for (Size i = 0; i < nScen; ++i) {
+            sumDelta += std::abs(deltaPnl[i]);
+            sumGamma += std::abs(gammaPnl[i]);
+        }
+        if (sumGamma > gammaThreshold_ * sumDelta) {
+            TLOG("HistoricalPnlGenerator: trade " << tradeId << " is revalued, gamma / delta P&L ratio is "
+                                                  << sumGamma / sumDelta);
+            continue;
+        }
+        vector<Real>& pnl = pnls[tradeId];
+        pnl.resize(nScen);
+        for (Size i = 0; i < nScen; ++i)
+            pnl[i] = deltaPnl[i] + gammaPnl[i];
+        baseNpvs[tradeId] = srs.front().baseNpv;
+    }
+}
+
 void HistoricalPnlGenerator::generateCube(const QuantLib::ext::shared_ptr<ScenarioFilter>& filter) {
 
     DLOG("Filling historical P&L cube for " << portfolio_->size() << " trades and " << hisScenGen_->numScenarios()
                                             << " scenarios.");
 
+    if (useSingleThreadedEngine_)
+        hisScenGen_->baseScenario() = simMarket_->baseScenario();
+
+    // split the portfolio into near-linear trades with sensitivity based P&L and trades that are revalued
+    map<string, vector<Real>> sensiPnls;
+    map<string, Real> sensiBaseNpvs;
+    sensitivityPnlTrades_.clear();
+    if (sensitivityStream_ && !dryRun_)
+        sensitivityPnl(filter, sensiPnls, sensiBaseNpvs);
+    QuantLib::ext::shared_ptr<Portfolio> revalPortfolio = portfolio_;
+    if (!sensiPnls.empty()) {
+        revalPortfolio = QuantLib::ext::make_shared<Portfolio>();
+        for (auto const& [id, trade] : portfolio_->trades()) {
+            if (sensiPnls.find(id) == sensiPnls.end())
+                revalPortfolio->add(trade);
+            else
+                sensitivityPnlTrades_.insert(id);
+        }
+        LOG("Historical P&L generation: " << sensiPnls.size() << " trades use sensitivity based P&L, "
+                                          << revalPortfolio->size() << " trades are revalued");
+    }
+
     if (useSingleThreadedEngine_) {
 
         valuationEngine_->unregisterAllProgressIndicators();
@@ -111,19 +249,59 @@ void HistoricalPnlGenerator::generateCube(const QuantLib::ext::shared_ptr<Scenar
         simMarket_->reset();
         simMarket_->scenarioGenerator() = hisScenGen_;
         hisScenGen_->baseScenario() = simMarket_->baseScenario();
-        valuationEngine_->buildCube(portfolio_, cube_, npvCalculator_(), true, nullptr, nullptr, {}, dryRun_);
+        if (revalPortfolio == portfolio_) {
+            valuationEngine_->buildCube(portfolio_, cube_, npvCalculator_(), true, nullptr, nullptr, {}, dryRun_);
+        } else if (revalPortfolio->size() > 0) {
+            auto revalCube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(
+                cube_->asof(), revalPortfolio->ids(), cube_->dates(), cube_->samples());
+            valuationEngine_->buildCube(revalPortfolio, revalCube, npvCalculator_(), true, nullptr, nullptr, {},
+                                        dryRun_);
+            for (auto const& [id, idx] : revalCube->idsAndIndexes()) {
+                Size j = cube_->idsAndIndexes().at(id);
+                cube_->setT0(revalCube->getT0(idx), j);
+                for (Size d = 0; d < cube_->numDates(); ++d)
+                    for (Size s = 0; s < cube_->samples(); ++s)
+                        cube_->set(revalCube->get(idx, d, s), j, d, s);
+            }
+        }
 
     } else {
+        // the threads write into slices of one contiguous cube, so that no joint cube is needed afterwards
+        QuantLib::ext::shared_ptr<DoublePrecisionContiguousInMemoryCube> fullCube;
+        auto cubeFactory = [this, &fullCube](const QuantLib::Date& asof, const std::set<std::string>& ids,
+                                             const std::vector<QuantLib::Date>& dates,
+                                             const Size samples) -> QuantLib::ext::shared_ptr<NPVCube> {
+            if (fullCube == nullptr)
+                fullCube = QuantLib::ext::make_shared<DoublePrecisionContiguousInMemoryCube>(asof, portfolio_->ids(),
+                                                                                          dates, samples);
+            return fullCube->slice(ids);
+        };
         MultiThreadedValuationEngine engine(
             nThreads_, today_, QuantLib::ext::make_shared<ore::analytics::DateGrid>(), hisScenGen_->numScenarios(), loader_,
             hisScenGen_, engineData_, curveConfigs_, todaysMarketParams_, configuration_, simMarketData_, false, false,
-            filter, referenceData_, iborFallbackConfig_, true, true, true, {}, {}, {}, context_);
+            filter, referenceData_, iborFallbackConfig_, true, true, true, cubeFactory, {}, {}, context_);
         for (auto const& i : this->progressIndicators()) {
             i->reset();
             engine.registerProgressIndicator(i);
         }
-        engine.buildCube(portfolio_, npvCalculator_, {}, true, dryRun_);
-        cube_ = QuantLib::ext::make_shared<JointNPVCube>(engine.outputCubes(), portfolio_->ids(), true);
+        if (revalPortfolio->size() > 0)
+            engine.buildCube(revalPortfolio, npvCalculator_, {}, true, dryRun_);
+        if (fullCube == nullptr)
+            fullCube = QuantLib::ext::make_shared<DoublePrecisionContiguousInMemoryCube>(
+                today_, portfolio_->ids(), vector<Date>(1, today_), hisScenGen_->numScenarios());
+        cube_ = fullCube;
+    }
+
+    // populate the cube for the trades with sensitivity based P&L
+    if (!sensiPnls.empty()) {
+        Size dateIdx = indexAsof();
+        for (auto const& [id, pnl] : sensiPnls) {
+            Size j = cube_->idsAndIndexes().at(id);
+            Real baseNpv = sensiBaseNpvs.at(id);
+            cube_->setT0(baseNpv, j);
+            for (Size s = 0; s < pnl.size(); ++s)
+                cube_->set(baseNpv + pnl[s], j, dateIdx, s);
+        }
     }
 
     DLOG("Historical P&L cube generated");
@@ -22,7 +22,9 @@
 
 #pragma once
 
+#include <orea/engine/sensitivitystream.hpp>
 #include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/scenarioshiftcalculator.hpp>
 #include <orea/scenario/scenariosimmarket.hpp>
 #include <ored/portfolio/enginedata.hpp>
 #include <ored/portfolio/enginefactory.hpp>
@@ -48,6 +50,11 @@ namespace analytics {
 
     In the calculation of P&L, the class allows the scenario shifts to be filtered and also the
     trades to be filtered.
+
+    Optionally, see setSensitivityPnl(), trades whose P&L is well described by their sensitivities are not
+    revalued. Their P&L is given by the delta-gamma approximation
+    \f$\Delta_i = \sum_k \delta_k s_{ik} + \frac{1}{2} \sum_k \gamma_k s_{ik}^2 + \sum_{k<l} \gamma_{kl} s_{ik} s_{il}\f$
+    where \f$s_{ik}\f$ is the historical shift in risk factor \f$k\f$ for scenario \f$i\f$.
 */
 class HistoricalPnlGenerator : public ore::data::ProgressReporter {
 public:
@@ -146,8 +153,28 @@ public:
     //! Time period covered by the historical P&L generator.
     ore::data::TimePeriod timePeriod() const;
 
+    /*! Enable the hybrid P&L generation: the sensitivities in \p ss are applied to the historical shifts computed
+        by \p shiftCalculator, and a trade is classified as near-linear if the sum over all scenarios of the
+        absolute second order P&L does not exceed \p gammaThreshold times the sum of the absolute first order P&L.
+        The P&L of near-linear trades is set to the delta-gamma P&L, only the remaining trades are revalued in full.
+        Trades without sensitivities, with sensitivities in a currency other than the base currency or with risk
+        factors for which no shift can be computed are always revalued in full. The sensitivities must be consistent
+        with the base market of the historical scenario generator. Pass a null stream to disable the hybrid mode. */
+    void setSensitivityPnl(const QuantLib::ext::shared_ptr<SensitivityStream>& ss,
+                           const QuantLib::ext::shared_ptr<ScenarioShiftCalculator>& shiftCalculator,
+                           const QuantLib::Real gammaThreshold = 0.01);
+
+    //! Trades with sensitivity based P&L in the last call to generateCube()
+    const std::set<std::string>& sensitivityPnlTrades() const { return sensitivityPnlTrades_; }
+
 private:
+    //! Computes the delta-gamma P&L for the near-linear trades and their base NPVs
+    void sensitivityPnl(const QuantLib::ext::shared_ptr<ScenarioFilter>& filter,
+                        std::map<std::string, std::vector<QuantLib::Real>>& pnls,
+                        std::map<std::string, QuantLib::Real>& baseNpvs) const;
+
     bool useSingleThreadedEngine_;
+    std::string baseCurrency_;
 
     QuantLib::ext::shared_ptr<ore::data::Portfolio> portfolio_;
     QuantLib::ext::shared_ptr<ScenarioSimMarket> simMarket_;
@@ -172,6 +199,11 @@ private:
 
     std::function<std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>>()> npvCalculator_;
 
+    QuantLib::ext::shared_ptr<SensitivityStream> sensitivityStream_;
+    QuantLib::ext::shared_ptr<ScenarioShiftCalculator> shiftCalculator_;
+    QuantLib::Real gammaThreshold_ = 0.01;
+    std::set<std::string> sensitivityPnlTrades_;
+
     //! Get the index of the as of date in the cube.
     QuantLib::Size indexAsof() const;
 };
@@ -21,11 +21,10 @@
 #include <orea/cube/inmemorycube.hpp>
 #include <ored/utilities/to_string.hpp>
 
-#include <boost/accumulators/accumulators.hpp>
-#include <boost/accumulators/statistics.hpp>
-#include <boost/accumulators/statistics/tail_quantile.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
-using namespace boost::accumulators;
 using namespace ore::data;
 using namespace QuantLib;
 
@@ -36,35 +35,57 @@ HistoricalSimulationVarReport::HistoricalSimulationVarReport(
     const std::string& baseCurrency, const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
     const string& portfolioFilter, const vector<Real>& p, boost::optional<TimePeriod> period,
     const ext::shared_ptr<HistoricalScenarioGenerator>& hisScenGen, std::unique_ptr<FullRevalArgs> fullRevalArgs,
-    const bool breakdown)
-    : VarReport(baseCurrency, portfolio, portfolioFilter, p, period, hisScenGen, nullptr, std::move(fullRevalArgs)) {
+    const bool breakdown, std::unique_ptr<SensiRunArgs> sensiArgs)
+    : VarReport(baseCurrency, portfolio, portfolioFilter, p, period, hisScenGen, std::move(sensiArgs),
+                std::move(fullRevalArgs)) {
     fullReval_ = true;
 }
 
-void HistoricalSimulationVarReport::createVarCalculator() {
-    varCalculator_ = QuantLib::ext::make_shared<HistoricalSimulationVarCalculator>(pnls_);
+std::function<std::vector<Real>()> HistoricalSimulationVarReport::varFunction() {
+    // the pnls are aggregated on the breakdown thread, the cube of the risk group is not changed while the tasks run
+    return [this, tradeIds = tradeIdIdxPairs_]() {
+        vector<Real> pnls = histPnlGen_->pnl(period_.get(), tradeIds);
+        return HistoricalSimulationVarCalculator(pnls).vars(p());
+    };
 }
 
-void HistoricalSimulationVarReport::handleFullRevalResults(const ext::shared_ptr<MarketRiskReport::Reports>& reports,
-                                                           const ext::shared_ptr<MarketRiskGroupBase>& riskGroup,
-                                                           const ext::shared_ptr<TradeGroupBase>& tradeGroup) {
-    pnls_ = histPnlGen_->pnl(period_.get(), tradeIdIdxPairs_);
-}
-
-Real HistoricalSimulationVarCalculator::var(Real confidence, const bool isCall, 
+Real HistoricalSimulationVarCalculator::var(Real confidence, const bool isCall,
     const set<pair<string, Size>>& tradeIds) {
+    return vars({confidence}, isCall, tradeIds).front();
+}
 
-    // Use boost to calculate the quantile based on confidence_
-    Size c = static_cast<Size>(std::floor(pnls_.size() * (1.0 - confidence) + 0.5)) + 2;
-    typedef accumulator_set<double, stats<boost::accumulators::tag::tail_quantile<boost::accumulators::right>>>
-        accumulator;
-    accumulator acc(boost::accumulators::tag::tail<boost::accumulators::right>::cache_size = c);
+vector<Real> HistoricalSimulationVarCalculator::vars(const vector<Real>& confidences, const bool isCall,
+                                                     const set<pair<string, Size>>& tradeIds) {
+    if (pnls_.empty())
+        return vector<Real>(confidences.size(), std::numeric_limits<Real>::quiet_NaN());
 
-    for (const auto& pnl : pnls_) {
-        acc(isCall ? pnl : -pnl);
+    /* The quantile is the k-th largest pnl with k = ceil(n * (1 - confidence)), i.e. the right tail quantile of
+       boost::accumulators. The positions in ascending order are selected in increasing order, each selection only
+       partitions the values above the previous position. */
+    Size n = pnls_.size();
+    vector<pair<Size, Size>> positions;
+    for (Size i = 0; i < confidences.size(); ++i) {
+        Size k = static_cast<Size>(std::ceil(n * (1.0 - confidences[i])));
+        k = std::min(std::max<Size>(k, 1), n);
+        positions.push_back(std::make_pair(n - k, i));
     }
+    std::sort(positions.begin(), positions.end());
 
-    return quantile(acc, quantile_probability = confidence);
+    vector<Real> values(pnls_);
+    if (!isCall) {
+        for (auto& v : values)
+            v = -v;
+    }
+    vector<Real> result(confidences.size());
+    auto begin = values.begin();
+    for (auto const& [position, i] : positions) {
+        if (begin <= values.begin() + position) {
+            std::nth_element(begin, values.begin() + position, values.end());
+            begin = values.begin() + position + 1;
+        }
+        result[i] = values[position];
+    }
+    return result;
 }
 
 } // namespace analytics
@@ -54,6 +54,10 @@ public:
     QuantLib::Real var(QuantLib::Real confidence, const bool isCall = true,
         const std::set<std::pair<std::string, QuantLib::Size>>& tradeIds = {}) override;
 
+    //! All quantiles are selected from one copy of the pnls, without a full sort
+    std::vector<QuantLib::Real> vars(const std::vector<QuantLib::Real>& confidences, const bool isCall = true,
+                                     const std::set<std::pair<std::string, QuantLib::Size>>& tradeIds = {}) override;
+
 private:
     const std::vector<QuantLib::Real>& pnls_;
 };
@@ -70,16 +74,11 @@ public:
                                   const std::string& portfolioFilter, 
         const vector<Real>& p, boost::optional<ore::data::TimePeriod> period,
         const QuantLib::ext::shared_ptr<HistoricalScenarioGenerator>& hisScenGen = nullptr, 
-        std::unique_ptr<FullRevalArgs> fullRevalArgs = nullptr, const bool breakdown = false);
+        std::unique_ptr<FullRevalArgs> fullRevalArgs = nullptr, const bool breakdown = false,
+        std::unique_ptr<SensiRunArgs> sensiArgs = nullptr);
 
 protected:
-    void createVarCalculator() override;
-    void handleFullRevalResults(const QuantLib::ext::shared_ptr<MarketRiskReport::Reports>& reports,
-        const QuantLib::ext::shared_ptr<MarketRiskGroupBase>& riskGroup, 
-        const QuantLib::ext::shared_ptr<TradeGroupBase>& tradeGroup) override;
-
-private:
-    std::vector<QuantLib::Real> pnls_;
+    std::function<std::vector<QuantLib::Real>()> varFunction() override;
 };
 
 } // namespace analytics
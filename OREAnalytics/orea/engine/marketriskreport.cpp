@@ -28,6 +28,11 @@
 #include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
 #include <boost/regex.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+
 using namespace QuantLib;
 using namespace ore::data;
 
@@ -126,6 +131,9 @@ void MarketRiskReport::initialise() {
 
     // save a sensi pnl calculator
     if (hisScenGen_) {
+        // the scenarios are regenerated for each risk group and trade group, so precompute the returns once
+        hisScenGen_->useReturnMatrix(true);
+
         // Build the filtered historical scenario generator
         hisScenGen_ = QuantLib::ext::make_shared<HistoricalScenarioGeneratorWithFilteredDates>(
             timePeriods(), hisScenGen_);
@@ -167,6 +175,14 @@ void MarketRiskReport::initialise() {
                 multiThreadArgs_->configuration_, multiThreadArgs_->simMarketData_, fullRevalArgs_->referenceData_,
                 fullRevalArgs_->iborFallbackConfig_, fullRevalArgs_->dryRun_, multiThreadArgs_->context_);
         }
+
+        if (fullRevalArgs_->sensiPnlGammaThreshold_ != Null<Real>() && sensiArgs_ && sensiArgs_->sensitivityStream_ &&
+            sensiArgs_->shiftCalculator_) {
+            LOG("Enable sensitivity based P&L for near-linear trades with gamma threshold "
+                << fullRevalArgs_->sensiPnlGammaThreshold_);
+            histPnlGen_->setSensitivityPnl(sensiArgs_->sensitivityStream_, sensiArgs_->shiftCalculator_,
+                                           fullRevalArgs_->sensiPnlGammaThreshold_);
+        }
     }
 
     initialiseRiskGroups();
@@ -256,10 +272,16 @@ void MarketRiskReport::calculate(const ext::shared_ptr<MarketRiskReport::Reports
 
     // Cube to store Sensi Shifts and vector of keys used in cube, per portfolio
     map<string, QuantLib::ext::shared_ptr<NPVCube>> sensiShiftCube;
+    // keys of the largest input covariance matrix checked for positive semi-definiteness
+    std::set<RiskFactorKey> psdCheckedKeys;
     ext::shared_ptr<SensitivityAggregator> sensiAgg;
-    if (sensiBased_)
+    SensitivityColumns sensiColumns;
+    if (sensiBased_) {
         // Create a sensitivity aggregator. Will be used if running sensi-based backtest.
         sensiAgg = ext::make_shared<SensitivityAggregator>(tradeIdGroups_);
+        // Read the sensitivities once, the risk groups below are aggregated from the columnar copy
+        sensiColumns = SensitivityColumns(*sensiArgs_->sensitivityStream_);
+    }
     
     bool runDetailTrd = runTradeDetail(reports);
     addPnlCalculators(reports);
@@ -280,7 +302,7 @@ void MarketRiskReport::calculate(const ext::shared_ptr<MarketRiskReport::Reports
         updateFilter(riskGroup, filter);
 
         if (sensiBased_)
-            sensiAgg->aggregate(*sensiArgs_->sensitivityStream_, filter);
+            sensiAgg->aggregate(sensiColumns, filter);
 
         // If doing a full revaluation backtest, generate the cube under this filter
         if (fullReval_) {
@@ -360,17 +382,20 @@ void MarketRiskReport::calculate(const ext::shared_ptr<MarketRiskReport::Reports
                     // if a covariance matrix has been provided as an input we use that
                     if (sensiArgs_->covarianceInput_.size() > 0) {
                         std::vector<bool> sensiKeyHasNonZeroVariance(deltaKeys.size(), false);
+                        std::map<RiskFactorKey, Size> deltaKeyIndex;
+                        for (Size i = 0; i < deltaKeys.size(); ++i)
+                            deltaKeyIndex[deltaKeys[i]] = i;
 
                         // build global covariance matrix
                         covarianceMatrix_ = Matrix(deltaKeys.size(), deltaKeys.size(), 0.0);
                         Size unusedCovariance = 0;
                         for (const auto& c : sensiArgs_->covarianceInput_) {
-                            auto k1 = std::find(deltaKeys.begin(), deltaKeys.end(), c.first.first);
-                            auto k2 = std::find(deltaKeys.begin(), deltaKeys.end(), c.first.second);
-                            if (k1 != deltaKeys.end() && k2 != deltaKeys.end()) {
-                                covarianceMatrix_(k1 - deltaKeys.begin(), k2 - deltaKeys.begin()) = c.second;
+                            auto k1 = deltaKeyIndex.find(c.first.first);
+                            auto k2 = deltaKeyIndex.find(c.first.second);
+                            if (k1 != deltaKeyIndex.end() && k2 != deltaKeyIndex.end()) {
+                                covarianceMatrix_(k1->second, k2->second) = c.second;
                                 if (k1 == k2)
-                                    sensiKeyHasNonZeroVariance[k1 - deltaKeys.begin()] = true;
+                                    sensiKeyHasNonZeroVariance[k1->second] = true;
                             } else
                                 ++unusedCovariance;
                         }
@@ -384,16 +409,23 @@ void MarketRiskReport::calculate(const ext::shared_ptr<MarketRiskReport::Reports
 
                         // make covariance matrix positive semi-definite
                         DLOG("Covariance matrix has dimension " << deltaKeys.size() << " x " << deltaKeys.size());
-                        if (salvage_ && !covarianceMatrix_.empty()) {
-                            DLOG("Covariance matrix is not salvaged, check for positive semi-definiteness");
-                            SymmetricSchurDecomposition ssd(covarianceMatrix_);
-                            Real evMin = ssd.eigenvalues().back();
-                            QL_REQUIRE(
-                                evMin > 0.0 || close_enough(evMin, 0.0),
-                                "ParametricVar: input covariance matrix is not positive semi-definite, smallest "
-                                "eigenvalue is "
-                                    << evMin);
-                            DLOG("Smallest eigenvalue is " << evMin);
+                        if (!covarianceMatrix_.empty()) {
+                            // the matrix of a breakdown is a principal submatrix of the matrix built from a superset
+                            // of its keys, so the decomposition is only needed if the keys are not covered yet
+                            if (!std::includes(psdCheckedKeys.begin(), psdCheckedKeys.end(), deltaKeys.begin(),
+                                               deltaKeys.end())) {
+                                DLOG("Covariance matrix is not salvaged, check for positive semi-definiteness");
+                                SymmetricSchurDecomposition ssd(covarianceMatrix_);
+                                Real evMin = ssd.eigenvalues().back();
+                                QL_REQUIRE(
+                                    evMin > 0.0 || close_enough(evMin, 0.0),
+                                    "ParametricVar: input covariance matrix is not positive semi-definite, smallest "
+                                    "eigenvalue is "
+                                        << evMin);
+                                DLOG("Smallest eigenvalue is " << evMin);
+                                if (deltaKeys.size() > psdCheckedKeys.size())
+                                    psdCheckedKeys = std::set<RiskFactorKey>(deltaKeys.begin(), deltaKeys.end());
+                            }
                             salvage_ = QuantLib::ext::make_shared<QuantExt::NoCovarianceSalvage>();
                         }
                     } else
@@ -419,6 +451,11 @@ void MarketRiskReport::calculate(const ext::shared_ptr<MarketRiskReport::Reports
 
             writeReports(reports, riskGroup, tradeGroup);
         }
+
+        // the full revaluation cube and the sensitivity aggregation are specific to the risk group, so the tasks
+        // are run before moving on to the next one
+        runBreakdownTasks();
+
         if (sensiBased_)
             // Reset the sensitivity aggregator before changing the risk filter
             sensiAgg->reset();
@@ -434,6 +471,47 @@ void MarketRiskReport::enableCubeWrite(const string& cubeDir, const string& cube
     fullRevalArgs_->cubeFilename_ = cubeFilename;
 }
 
+void MarketRiskReport::addBreakdownTask(const std::function<void()>& calculate, const std::function<void()>& write) {
+    breakdownTasks_.emplace_back(calculate, write);
+}
+
+void MarketRiskReport::runBreakdownTasks() {
+    std::vector<std::pair<std::function<void()>, std::function<void()>>> tasks;
+    tasks.swap(breakdownTasks_);
+    if (tasks.empty())
+        return;
+
+    Size nWorkers = std::min(breakdownThreads_, tasks.size());
+    if (nWorkers <= 1) {
+        for (auto const& t : tasks)
+            t.first();
+    } else {
+        DLOG("Running " << tasks.size() << " breakdown tasks using " << nWorkers << " threads");
+        std::atomic<Size> next(0);
+        std::vector<std::exception_ptr> errors(nWorkers);
+        std::vector<std::thread> workers;
+        for (Size w = 0; w < nWorkers; ++w) {
+            workers.emplace_back([&, w]() {
+                try {
+                    for (Size i = next++; i < tasks.size(); i = next++)
+                        tasks[i].first();
+                } catch (...) {
+                    errors[w] = std::current_exception();
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        for (const auto& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+    }
+
+    for (auto const& t : tasks)
+        t.second();
+}
+
 void MarketRiskReport::reset(const ext::shared_ptr<MarketRiskGroupBase>& riskGroup) {
     deltas_.clear();
     gammas_.clear();
@@ -30,6 +30,8 @@
 #include <orea/engine/riskfilter.hpp>
 #include <orea/scenario/scenariofilter.hpp>
 
+#include <algorithm>
+#include <functional>
 #include <vector>
 
 namespace ore {
@@ -184,6 +186,10 @@ public:
             FILTER pattern replaced by a description of the scenario filter
         */
         std::string cubeFilename_;
+        /*! If set and sensitivity run args with a shift calculator are given, the historical P&L of near-linear
+            trades is computed from the sensitivities and only the remaining trades are revalued, see
+            HistoricalPnlGenerator::setSensitivityPnl() */
+        QuantLib::Real sensiPnlGammaThreshold_ = QuantLib::Null<QuantLib::Real>();
 
         FullRevalArgs(const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarket>& sm,
                       const QuantLib::ext::shared_ptr<ore::data::EngineData>& ed,
@@ -252,6 +258,9 @@ public:
     */
     void enableCubeWrite(const std::string& cubeDir, const std::string& cubeFilename);
 
+    //! Set the number of threads used to run the breakdown tasks of a risk group, see addBreakdownTask()
+    void setBreakdownThreads(const QuantLib::Size n) { breakdownThreads_ = std::max<QuantLib::Size>(n, 1); }
+
 protected:
     //! Method for shared initialisation
     virtual void initialiseRiskGroups();
@@ -298,6 +307,17 @@ protected:
     QuantLib::ext::shared_ptr<ore::analytics::HistoricalPnlGenerator> histPnlGen_;
     QuantLib::ext::shared_ptr<HistoricalSensiPnlCalculator> sensiPnlCalculator_;
 
+    /*! Add a task for the current risk and trade group. The tasks of a risk group are run after all its trade groups
+        are processed: \p calculate on one of the breakdown threads, so it must only use its own copies of the inputs
+        of the trade group and members that do not change within the risk group, \p write afterwards on the calling
+        thread in the order in which the tasks were added. */
+    void addBreakdownTask(const std::function<void()>& calculate, const std::function<void()>& write);
+    //! Run and clear the pending breakdown tasks
+    void runBreakdownTasks();
+
+    QuantLib::Size breakdownThreads_ = 1;
+    std::vector<std::pair<std::function<void()>, std::function<void()>>> breakdownTasks_;
+
     virtual void registerProgressIndicators();
     virtual void createReports(const QuantLib::ext::shared_ptr<MarketRiskReport::Reports>& reports) = 0;
     virtual bool runTradeDetail(const QuantLib::ext::shared_ptr<MarketRiskReport::Reports>& reports) { return requireTradePnl_; };
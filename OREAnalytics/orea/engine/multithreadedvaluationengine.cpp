@@ -18,19 +18,28 @@
 
 #include <orea/app/structuredanalyticserror.hpp>
 #include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/cubecheckpoint.hpp>
 #include <orea/engine/multithreadedvaluationengine.hpp>
 #include <orea/engine/observationmode.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
 #include <orea/scenario/clonedscenariogenerator.hpp>
 
 #include <ored/marketdata/clonedloader.hpp>
+#include <ored/marketdata/fixings.hpp>
+#include <ored/marketdata/lazyclonedloader.hpp>
 #include <ored/marketdata/todaysmarket.hpp>
 #include <ored/portfolio/enginefactory.hpp>
 #include <ored/portfolio/trade.hpp>
 #include <ored/utilities/dategrid.hpp>
 
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/timer/timer.hpp>
 
+#include <atomic>
+#include <fstream>
 #include <future>
+#include <iomanip>
 
 // #include <ctpl_stl.h>
 
@@ -39,6 +48,64 @@ namespace analytics {
 
 using QuantLib::Size;
 
+namespace {
+
+// average pricing time of a trade, as persisted in the pricing time file
+struct PricingTime {
+    std::string tradeType;
+    std::size_t numberOfPricings;
+    double avgPricingTime;
+};
+
+std::map<std::string, PricingTime> loadPricingTimes(const std::string& fileName) {
+    std::map<std::string, PricingTime> result;
+    std::ifstream file(fileName);
+    if (!file.is_open()) {
+        LOG("Pricing time file '" << fileName << "' not found, use pricing times from single pricing.");
+        return result;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        boost::trim(line);
+        if (line.empty() || line[0] == '#')
+            continue;
+        // the trade id might contain commas, the other columns do not
+        std::vector<std::string> tokens;
+        boost::split(tokens, line, boost::is_any_of(","));
+        if (tokens.size() < 4) {
+            WLOG("Ignore invalid line '" << line << "' in pricing time file '" << fileName << "'");
+            continue;
+        }
+        Size n = tokens.size();
+        std::string tradeId = boost::join(std::vector<std::string>(tokens.begin(), tokens.end() - 3), ",");
+        try {
+            result[tradeId] = {tokens[n - 3], std::stoul(tokens[n - 2]), std::stod(tokens[n - 1])};
+        } catch (const std::exception& e) {
+            WLOG("Ignore invalid line '" << line << "' in pricing time file '" << fileName << "': " << e.what());
+        }
+    }
+    LOG("Loaded pricing times for " << result.size() << " trades from '" << fileName << "'");
+    return result;
+}
+
+void savePricingTimes(const std::string& fileName, const std::map<std::string, PricingTime>& pricingTimes) {
+    // write to a temporary file first, so that a concurrent or interrupted run does not see a partial file
+    std::string tmpFileName = fileName + ".tmp";
+    {
+        std::ofstream file(tmpFileName);
+        QL_REQUIRE(file.is_open(), "can not write pricing time file '" << tmpFileName << "'");
+        file << "#TradeId,TradeType,NumberOfPricings,AvgPricingTime\n";
+        file << std::setprecision(16);
+        for (auto const& [tid, p] : pricingTimes)
+            file << tid << "," << p.tradeType << "," << p.numberOfPricings << "," << p.avgPricingTime << "\n";
+        QL_REQUIRE(file.good(), "error writing pricing time file '" << tmpFileName << "'");
+    }
+    boost::filesystem::rename(tmpFileName, fileName);
+    LOG("Saved pricing times for " << pricingTimes.size() << " trades to '" << fileName << "'");
+}
+
+} // namespace
+
 MultiThreadedValuationEngine::MultiThreadedValuationEngine(
     const Size nThreads, const QuantLib::Date& today, const QuantLib::ext::shared_ptr<ore::data::DateGrid>& dateGrid,
     const Size nSamples, const QuantLib::ext::shared_ptr<ore::data::Loader>& loader,
@@ -60,7 +127,8 @@ MultiThreadedValuationEngine::MultiThreadedValuationEngine(
     const std::function<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>(const QuantLib::Date&, const std::set<std::string>&,
                                                                    const std::vector<QuantLib::Date>&,
                                                                    const QuantLib::Size)>& cptyCubeFactory,
-    const std::string& context, const QuantLib::ext::shared_ptr<ore::analytics::Scenario>& offSetScenario)
+    const std::string& context, const QuantLib::ext::shared_ptr<ore::analytics::Scenario>& offSetScenario,
+    const bool sharedInputs)
     : nThreads_(nThreads), today_(today), dateGrid_(dateGrid), nSamples_(nSamples), loader_(loader),
       scenarioGenerator_(scenarioGenerator), engineData_(engineData), curveConfigs_(curveConfigs),
       todaysMarketParams_(todaysMarketParams), configuration_(configuration), simMarketData_(simMarketData),
@@ -69,7 +137,8 @@ MultiThreadedValuationEngine::MultiThreadedValuationEngine(
       handlePseudoCurrenciesTodaysMarket_(handlePseudoCurrenciesTodaysMarket),
       handlePseudoCurrenciesSimMarket_(handlePseudoCurrenciesSimMarket), recalibrateModels_(recalibrateModels),
       cubeFactory_(cubeFactory), nettingSetCubeFactory_(nettingSetCubeFactory), cptyCubeFactory_(cptyCubeFactory),
-      context_(context), offsetScenario_(offSetScenario){
+      context_(context), offsetScenario_(offSetScenario), sharedInputs_(sharedInputs), tradeChunkSize_(0),
+      splitSamples_(false), compactScenarios_(false) {
 
     QL_REQUIRE(nThreads_ != 0, "MultiThreadedValuationEngine: nThreads must be > 0");
 
@@ -101,6 +170,44 @@ void MultiThreadedValuationEngine::setAggregationScenarioData(
     aggregationScenarioData_ = aggregationScenarioData;
 }
 
+void MultiThreadedValuationEngine::setTradeChunkSize(const Size tradeChunkSize) { tradeChunkSize_ = tradeChunkSize; }
+
+void MultiThreadedValuationEngine::setSplitSamples(const bool splitSamples) { splitSamples_ = splitSamples; }
+
+void MultiThreadedValuationEngine::setScenarioGeneratorBuilder(
+    const std::function<QuantLib::ext::shared_ptr<ScenarioGenerator>(
+        const QuantLib::ext::shared_ptr<ore::data::Market>&)>& scenarioGeneratorBuilder) {
+    scenarioGeneratorBuilder_ = scenarioGeneratorBuilder;
+}
+
+void MultiThreadedValuationEngine::setCompactScenarios(const bool compactScenarios) {
+    compactScenarios_ = compactScenarios;
+}
+
+void MultiThreadedValuationEngine::setCheckpoint(const std::string& directory, const std::string& key,
+                                                 const Size blockSize) {
+    QL_REQUIRE(blockSize > 0, "MultiThreadedValuationEngine: checkpoint block size must be positive");
+    checkpointDirectory_ = directory;
+    checkpointKey_ = key;
+    checkpointBlockSize_ = blockSize;
+}
+
+void MultiThreadedValuationEngine::setPricingTimeFile(const std::string& pricingTimeFile) {
+    pricingTimeFile_ = pricingTimeFile;
+}
+
+void MultiThreadedValuationEngine::setProfiling(const bool profiling) { profiling_ = profiling; }
+
+void MultiThreadedValuationEngine::setSkipCloseOutPricing(const bool skipCloseOutPricing) {
+    skipCloseOutPricing_ = skipCloseOutPricing;
+}
+
+void MultiThreadedValuationEngine::setObserverStatistics(const bool observerStatistics) {
+    observerStatistics_ = observerStatistics;
+}
+
+void MultiThreadedValuationEngine::setPruneObservers(const bool pruneObservers) { pruneObservers_ = pruneObservers; }
+
 void MultiThreadedValuationEngine::buildCube(
     const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
     const std::function<std::vector<QuantLib::ext::shared_ptr<ore::analytics::ValuationCalculator>>()>& calculators,
@@ -111,6 +218,8 @@ void MultiThreadedValuationEngine::buildCube(
 
     LOG("MultiThreadedValuationEngine::buildCube() was called");
 
+    QL_REQUIRE(!splitSamples_ || !dryRun, "MultiThreadedValuationEngine: dry run is not supported with split samples");
+
     // extract pricing stats accumulated so far and clear them
 
     LOG("Extract pricing stats and clear them in the current portfolio");
@@ -141,31 +250,66 @@ void MultiThreadedValuationEngine::buildCube(
                             << t->npvCurrency());
     }
 
-    // split portfolio into nThreads parts such that each part has an approximately similar total avg pricing time
+    // split portfolio into parts: if no chunk size is given, we use nThreads parts such that each part has an
+    // approximately similar total avg pricing time, otherwise we use chunks of the given size which are
+    // processed by the worker threads from a shared queue, starting with the most expensive trades
 
-    Size eff_nThreads = std::min(portfolio->size(), nThreads_);
+    // if samples are split between the threads, the portfolio is not split at all
+
+    Size nParts = splitSamples_ ? 1
+                  : tradeChunkSize_ == 0
+                      ? std::min(portfolio->size(), nThreads_)
+                      : (portfolio->size() + tradeChunkSize_ - 1) / tradeChunkSize_;
+    Size eff_nThreads = splitSamples_ ? std::min(nSamples_, nThreads_) : std::min(nParts, nThreads_);
 
     LOG("Splitting portfolio.");
 
     LOG("portfolio size = " << portfolio->size());
     LOG("nThreads       = " << nThreads_);
     LOG("eff nThreads   = " << eff_nThreads);
+    LOG("chunk size     = " << tradeChunkSize_);
+    LOG("parts          = " << nParts);
+    LOG("split samples  = " << std::boolalpha << splitSamples_);
 
     QL_REQUIRE(eff_nThreads > 0, "effective threads are zero, this is not allowed.");
 
     std::vector<QuantLib::ext::shared_ptr<ore::data::Portfolio>> portfolios;
-    for (Size i = 0; i < eff_nThreads; ++i)
+    for (Size i = 0; i < nParts; ++i)
         portfolios.push_back(QuantLib::ext::make_shared<ore::data::Portfolio>());
 
+    /* the avg pricing times are taken from the pricing time file if available, for trades not contained in the
+       file we use the avg time of the trade type in the file and the single pricing above as a last resort */
+
+    std::map<std::string, PricingTime> persistedPricingTimes;
+    std::map<std::string, std::pair<Size, double>> persistedTradeTypeTimes;
+    if (!pricingTimeFile_.empty()) {
+        persistedPricingTimes = loadPricingTimes(pricingTimeFile_);
+        for (auto const& [tid, p] : persistedPricingTimes) {
+            auto& tt = persistedTradeTypeTimes[p.tradeType];
+            tt.first++;
+            tt.second += p.avgPricingTime;
+        }
+    }
+
     double totalAvgPricingTime = 0.0;
+    Size tradesFromFile = 0, tradesFromTradeType = 0;
     std::vector<std::pair<std::string, double>> timings;
     for (auto const& [tid, t] : portfolio->trades()) {
-        if (t->getNumberOfPricings() != 0) {
-            double dt = t->getCumulativePricingTime() / static_cast<double>(t->getNumberOfPricings());
+        double dt = QuantLib::Null<double>();
+        if (auto p = persistedPricingTimes.find(tid); p != persistedPricingTimes.end()) {
+            dt = p->second.avgPricingTime;
+            ++tradesFromFile;
+        } else if (auto tt = persistedTradeTypeTimes.find(t->tradeType()); tt != persistedTradeTypeTimes.end()) {
+            dt = tt->second.second / static_cast<double>(tt->second.first);
+            ++tradesFromTradeType;
+        } else if (t->getNumberOfPricings() != 0) {
+            dt = t->getCumulativePricingTime() / static_cast<double>(t->getNumberOfPricings());
+        }
+        if (dt != QuantLib::Null<double>() && checkpointDirectory_.empty()) {
             timings.push_back(std::make_pair(tid, dt));
             totalAvgPricingTime += dt;
         } else {
-            // trade might be a failed trade
+            // trade might be a failed trade, if checkpointing the split must be deterministic, i.e. by trade id
             timings.push_back(std::make_pair(tid, 0.0));
         }
     }
@@ -179,56 +323,111 @@ void MultiThreadedValuationEngine::buildCube(
               });
 
     std::vector<double> portfolioTotalAvgPricingTime(portfolios.size());
-    Size portfolioIndex = 0;
+    Size portfolioIndex = 0, tradeCount = 0;
     for (auto const& t : timings) {
         portfolios[portfolioIndex]->add(portfolio->get(t.first));
         portfolioTotalAvgPricingTime[portfolioIndex] += t.second;
-        if (++portfolioIndex >= eff_nThreads)
-            portfolioIndex = 0;
+        if (tradeChunkSize_ == 0) {
+            if (++portfolioIndex >= nParts)
+                portfolioIndex = 0;
+        } else if (++tradeCount % tradeChunkSize_ == 0) {
+            ++portfolioIndex;
+        }
     }
 
-    // output the portfolios into strings so that the worker threads can load them from there
+    /* output the portfolios into strings so that the worker threads can load them from there, the binary form
+       avoids parsing the xml text in each worker */
 
     std::vector<std::string> portfoliosAsString;
     for (auto const& p : portfolios) {
-        portfoliosAsString.emplace_back(p->toXMLString());
+        portfoliosAsString.emplace_back(p->toBinaryString());
     }
 
     // log info on the portfolio split
 
+    if (!pricingTimeFile_.empty())
+        LOG("Avg pricing times from file for " << tradesFromFile << " trades, from trade type for "
+                                               << tradesFromTradeType << " trades");
     LOG("Total avg pricing time     : " << totalAvgPricingTime / 1E6 << " ms");
-    for (Size i = 0; i < eff_nThreads; ++i) {
+    for (Size i = 0; i < nParts; ++i) {
         LOG("Portfolio #" << i << " number of trades       : " << portfolios[i]->size());
         LOG("Portfolio #" << i << " total avg pricing time : " << portfolioTotalAvgPricingTime[i] / 1E6 << " ms");
     }
 
-    // build scenario generators for each thread as clones of the original one
-
-    LOG("Cloning scenario generators for " << eff_nThreads << " threads...");
-    std::vector<QuantLib::ext::shared_ptr<ore::analytics::ScenarioGenerator>> scenarioGenerators;
-    auto tmp =
-        QuantLib::ext::make_shared<ore::analytics::ClonedScenarioGenerator>(scenarioGenerator_, dateGrid_->dates(), nSamples_);
-    scenarioGenerators.push_back(tmp);
-    DLOG("generator for thread 1 cloned.");
-    for (Size i = 1; i < eff_nThreads; ++i) {
-        scenarioGenerators.push_back(QuantLib::ext::make_shared<ore::analytics::ClonedScenarioGenerator>(*tmp));
-        DLOG("generator for thread " << (i + 1) << " cloned.");
+    // determine the sample slices for each thread, if samples are split, otherwise each thread does all samples
+
+    std::vector<Size> firstSample(eff_nThreads, 0), numberOfSamples(eff_nThreads, QuantLib::Null<Size>());
+    if (splitSamples_) {
+        for (Size i = 0; i < eff_nThreads; ++i) {
+            firstSample[i] = i * nSamples_ / eff_nThreads;
+            numberOfSamples[i] = (i + 1) * nSamples_ / eff_nThreads - firstSample[i];
+            LOG("Thread #" << i << " samples " << firstSample[i] << " ... "
+                           << firstSample[i] + numberOfSamples[i] - 1);
+        }
     }
 
-    // build loaders for each thread as clones of the original one
+    /* build scenario generators for each thread as clones of the original one, positioned at the first sample, if
+       samples are split and a scenario generator builder is given, the threads build their own generators instead */
+
+    std::vector<QuantLib::ext::shared_ptr<ore::analytics::ScenarioGenerator>> scenarioGenerators(eff_nThreads);
+    if (splitSamples_ && scenarioGeneratorBuilder_) {
+        LOG("Scenario generators are built in the " << eff_nThreads << " threads.");
+    } else {
+        LOG("Cloning scenario generators for " << eff_nThreads << " threads...");
+        auto tmp = QuantLib::ext::make_shared<ore::analytics::ClonedScenarioGenerator>(
+            scenarioGenerator_, dateGrid_->dates(), nSamples_, compactScenarios_);
+        scenarioGenerators[0] = tmp;
+        DLOG("generator for thread 1 cloned.");
+        for (Size i = 1; i < eff_nThreads; ++i) {
+            scenarioGenerators[i] =
+                QuantLib::ext::make_shared<ore::analytics::ClonedScenarioGenerator>(*tmp, firstSample[i]);
+            DLOG("generator for thread " << (i + 1) << " cloned.");
+        }
+    }
 
-    LOG("Cloning loaders for " << eff_nThreads << " threads...");
-    std::vector<QuantLib::ext::shared_ptr<ore::data::ClonedLoader>> loaders;
-    for (Size i = 0; i < eff_nThreads; ++i)
-        loaders.push_back(QuantLib::ext::make_shared<ore::data::ClonedLoader>(today_, loader_));
+    /* if samples are split, each thread populates its own aggregation scenario data, which is copied to the
+       given one after all threads are finished, otherwise the thread processing the first portfolio part populates
+       the given data, see below */
+
+    std::vector<QuantLib::ext::shared_ptr<AggregationScenarioData>> threadAggregationScenarioData(eff_nThreads);
+    if (aggregationScenarioData_ != nullptr) {
+        if (splitSamples_) {
+            // the thread containers use the precision of the target container
+            bool singlePrecision = QuantLib::ext::dynamic_pointer_cast<SinglePrecisionInMemoryAggregationScenarioData>(
+                                       aggregationScenarioData_) != nullptr;
+            for (Size i = 0; i < eff_nThreads; ++i) {
+                if (singlePrecision)
+                    threadAggregationScenarioData[i] =
+                        QuantLib::ext::make_shared<SinglePrecisionInMemoryAggregationScenarioData>(
+                            aggregationScenarioData_->dimDates(), numberOfSamples[i]);
+                else
+                    threadAggregationScenarioData[i] = QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(
+                        aggregationScenarioData_->dimDates(), numberOfSamples[i]);
+            }
+        }
+    }
 
-    // build nThreads mini-cubes to which each thread writes its results
+    // build loaders for each thread as clones of the original one, or as lazy clones reading from the original
+    // loader, if shared inputs are used
+
+    std::vector<QuantLib::ext::shared_ptr<ore::data::Loader>> loaders;
+    if (sharedInputs_) {
+        LOG("Creating lazily cloning loaders for " << eff_nThreads << " threads (shared inputs)...");
+        for (Size i = 0; i < eff_nThreads; ++i)
+            loaders.push_back(QuantLib::ext::make_shared<ore::data::LazyClonedLoader>(today_, loader_));
+    } else {
+        LOG("Cloning loaders for " << eff_nThreads << " threads...");
+        for (Size i = 0; i < eff_nThreads; ++i)
+            loaders.push_back(QuantLib::ext::make_shared<ore::data::ClonedLoader>(today_, loader_));
+    }
 
-    LOG("Build " << eff_nThreads << " mini result cubes...");
+    // build one mini-cube per portfolio part to which the threads write their results
+
+    LOG("Build " << nParts << " mini result cubes...");
     miniCubes_.clear();
     miniNettingSetCubes_.clear();
     miniCptyCubes_.clear();
-    for (Size i = 0; i < eff_nThreads; ++i) {
+    for (Size i = 0; i < nParts; ++i) {
         miniCubes_.push_back(cubeFactory_(today_, portfolios[i]->ids(), dateGrid_->valuationDates(), nSamples_));
         miniNettingSetCubes_.push_back(nettingSetCubeFactory_(today_, dateGrid_->valuationDates(), nSamples_));
         miniCptyCubes_.push_back(
@@ -256,13 +455,38 @@ void MultiThreadedValuationEngine::buildCube(
     std::vector<std::map<std::string, std::pair<std::size_t, boost::timer::nanosecond_type>>> workerPricingStats(
         eff_nThreads);
 
+    // pricing profiles accumulated in worker threads, if profiling is enabled
+    std::vector<std::map<std::string, ValuationEngine::PricingProfile>> workerPricingProfiles(eff_nThreads);
+
+    // observer statistics of the portfolio parts processed by the worker threads, if enabled
+    std::vector<std::vector<std::pair<std::map<std::string, ObserverGraph::TradeStatistics>,
+                                      std::map<ObserverGraph::RiskFactor, ObserverGraph::RiskFactorStatistics>>>>
+        workerObserverStatistics(eff_nThreads);
+
+    // failed trades in worker threads, only used if samples are split
+    std::vector<std::set<std::string>> workerFailedTrades(eff_nThreads);
+
+    // get the fixings applied in the main thread by the init market, so that the worker threads can share them
+    // instead of parsing and applying the loader fixings once per thread
+
+    ore::data::FixingHistories fixingHistories = ore::data::getFixingHistories();
+
     // get obs mode of main thread, so that we can set this mode in the worker threads below
     ore::analytics::ObservationMode::Mode obsMode = ore::analytics::ObservationMode::instance().mode();
 
+    // the queue of portfolio parts, the worker threads pull the next part to process from here
+    std::atomic<Size> nextPart(0);
+
+    // wall time to process each portfolio part, each part is processed by one thread unless samples are split
+    std::vector<double> partWallTime(nParts, 0.0);
+
     for (Size i = 0; i < eff_nThreads; ++i) {
 
         auto job = [this, obsMode, dryRun, &calculators, &cptyCalculators, mporStickyDate, &portfoliosAsString,
-                    &scenarioGenerators, &loaders, &workerPricingStats, &progressIndicator](int id) -> resultType {
+                    &scenarioGenerators, &loaders, &workerPricingStats, &progressIndicator, &nextPart, nParts,
+                    &firstSample, &numberOfSamples, &threadAggregationScenarioData,
+                    &workerFailedTrades, &fixingHistories, &partWallTime,
+                    &workerPricingProfiles, &workerObserverStatistics](int id) -> resultType {
             // set thread local singletons
 
             QuantLib::Settings::instance().evaluationDate() = today_;
@@ -274,10 +498,12 @@ void MultiThreadedValuationEngine::buildCube(
 
             try {
 
-                // build todays market using cloned market data
+                // set the fixings from the main thread and build todays market using cloned market data
+
+                ore::data::applyFixingHistories(fixingHistories);
 
                 QuantLib::ext::shared_ptr<ore::data::Market> initMarket = QuantLib::ext::make_shared<ore::data::TodaysMarket>(
-                    today_, todaysMarketParams_, loaders[id], curveConfigs_, true, true, true, referenceData_, false,
+                    today_, todaysMarketParams_, loaders[id], curveConfigs_, true, false, true, referenceData_, false,
                     iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_);
 
                 // build sim market
@@ -288,10 +514,20 @@ void MultiThreadedValuationEngine::buildCube(
                         useSpreadedTermStructures_, cacheSimData_, false, iborFallbackConfig_,
                         handlePseudoCurrenciesSimMarket_, offsetScenario_);
 
-                // set aggregation scenario data, but only in one of the sim markets, that's sufficient to populate it
+                // set the thread's aggregation scenario data, if samples are split
+
+                if (threadAggregationScenarioData[id] != nullptr)
+                    simMarket->aggregationScenarioData() = threadAggregationScenarioData[id];
 
-                if (id == 0 && aggregationScenarioData_ != nullptr)
-                    simMarket->aggregationScenarioData() = aggregationScenarioData_;
+                // build the thread's own scenario generator and skip to the first sample of the slice, if required
+
+                if (scenarioGenerators[id] == nullptr) {
+                    auto generator = scenarioGeneratorBuilder_(initMarket);
+                    QL_REQUIRE(generator != nullptr && generator->skipTo(firstSample[id]),
+                               "MultiThreadedValuationEngine: scenario generator built in thread "
+                                   << id << " does not support skip-ahead");
+                    scenarioGenerators[id] = generator;
+                }
 
                 // link scenario generator to sim market
 
@@ -302,37 +538,95 @@ void MultiThreadedValuationEngine::buildCube(
                 if (scenarioFilter_)
                     simMarket->filter() = scenarioFilter_;
 
-                // build portfolio against sim market
+                // build engine factory against sim market
 
-                auto portfolio = QuantLib::ext::make_shared<ore::data::Portfolio>();
-                portfolio->fromXMLString(portfoliosAsString[id]);
                 auto engineFactory = QuantLib::ext::make_shared<ore::data::EngineFactory>(
                     engineData_, simMarket, std::map<ore::data::MarketContext, string>(), referenceData_,
                     iborFallbackConfig_);
 
-                portfolio->build(engineFactory, context_, true);
+                /* process portfolio parts until the queue is exhausted, if samples are split all threads process the
+                   single part for their sample slice */
+
+                for (Size part = splitSamples_ ? 0 : nextPart++; part < nParts;
+                     part = splitSamples_ ? nParts : nextPart++) {
+
+                    DLOG("Thread " << id << " processes portfolio part " << part);
+
+                    boost::timer::cpu_timer partTimer;
+
+                    // build portfolio against sim market
+
+                    auto portfolio = QuantLib::ext::make_shared<ore::data::Portfolio>();
+                    portfolio->fromBinaryString(portfoliosAsString[part]);
+
+                    // the binary representation is not needed any more, release it if shared inputs are used
+
+                    if (sharedInputs_ && !splitSamples_)
+                        std::string().swap(portfoliosAsString[part]);
+
+                    portfolio->build(engineFactory, context_, true);
+
+                    /* if samples are not split, the aggregation scenario data is populated by the thread that pulls
+                       the first part from the queue, this need not be thread 0 and a thread might not get any part */
+
+                    if (!splitSamples_ && part == 0)
+                        simMarket->aggregationScenarioData() = aggregationScenarioData_;
+
+                    // build valuation engine
+
+                    auto valEngine = QuantLib::ext::make_shared<ore::analytics::ValuationEngine>(
+                        today_, dateGrid_, simMarket,
+                        recalibrateModels_
+                            ? engineFactory->modelBuilders()
+                            : std::set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>>());
+                    valEngine->registerProgressIndicator(progressIndicator);
+                    valEngine->setProfiling(profiling_);
+                    valEngine->setSkipCloseOutPricing(skipCloseOutPricing_);
+                    valEngine->setObserverStatistics(observerStatistics_);
+                    valEngine->setPruneObservers(pruneObservers_);
+
+                    // each part resp. sample slice has its own checkpoint
+
+                    if (!checkpointDirectory_.empty() && !dryRun) {
+                        std::string dir = (boost::filesystem::path(checkpointDirectory_) /
+                                           ("part_" + std::to_string(part) + "_" + std::to_string(firstSample[id])))
+                                              .string();
+                        valEngine->setCheckpoint(QuantLib::ext::make_shared<CubeCheckpoint>(dir, checkpointKey_),
+                                                 checkpointBlockSize_);
+                    }
+
+                    // build mini-cube
+
+                    valEngine->buildCube(portfolio, miniCubes_[part], calculators(), mporStickyDate,
+                                         miniNettingSetCubes_[part], miniCptyCubes_[part],
+                                         cptyCalculators
+                                             ? cptyCalculators()
+                                             : std::vector<QuantLib::ext::shared_ptr<CounterpartyCalculator>>(),
+                                         dryRun, firstSample[id], numberOfSamples[id]);
+
+                    workerFailedTrades[id] = valEngine->failedTrades();
 
-                // build valuation engine
+                    for (auto const& [tid, p] : valEngine->pricingProfiles())
+                        workerPricingProfiles[id][tid] += p;
 
-                auto valEngine = QuantLib::ext::make_shared<ore::analytics::ValuationEngine>(
-                    today_, dateGrid_, simMarket,
-                    recalibrateModels_ ? engineFactory->modelBuilders()
-                                       : std::set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>>());
-                valEngine->registerProgressIndicator(progressIndicator);
+                    if (observerStatistics_ && valEngine->observerGraph())
+                        workerObserverStatistics[id].push_back(
+                            std::make_pair(valEngine->observerGraph()->tradeStatistics(),
+                                           valEngine->observerGraph()->riskFactorStatistics()));
 
-                // build mini-cube
+                    if (!splitSamples_)
+                        partWallTime[part] = static_cast<double>(partTimer.elapsed().wall) / 1.0E9;
 
-                valEngine->buildCube(portfolio, miniCubes_[id], calculators(), mporStickyDate, miniNettingSetCubes_[id],
-                                     miniCptyCubes_[id],
-                                     cptyCalculators ? cptyCalculators()
-                                                     : std::vector<QuantLib::ext::shared_ptr<CounterpartyCalculator>>(),
-                                     dryRun);
+                    // the aggregation scenario data is populated after the first run, no need to do this again
 
-                // set pricing stats for val engine run
+                    simMarket->aggregationScenarioData() = nullptr;
 
-                for (auto const& [tid, t] : portfolio->trades())
-                    workerPricingStats[id][tid] =
-                        std::make_pair(t->getNumberOfPricings(), t->getCumulativePricingTime());
+                    // set pricing stats for val engine run
+
+                    for (auto const& [tid, t] : portfolio->trades())
+                        workerPricingStats[id][tid] =
+                            std::make_pair(t->getNumberOfPricings(), t->getCumulativePricingTime());
+                }
 
                 // return code 0 = ok
 
@@ -368,6 +662,9 @@ void MultiThreadedValuationEngine::buildCube(
     for (auto& t : jobs)
         t.join();
 
+    // report the final progress of the threads
+    progressIndicator->flush();
+
     for (Size i = 0; i < results.size(); ++i) {
         results[i].wait();
     }
@@ -384,6 +681,38 @@ void MultiThreadedValuationEngine::buildCube(
     // LOG("Stop thread pool");
     // threadPool.stop(true);
 
+    if (splitSamples_) {
+
+        // remove failed trades from the cube, this is not done by the val engines for sample slices
+
+        std::set<std::string> failedTrades;
+        for (auto const& f : workerFailedTrades)
+            failedTrades.insert(f.begin(), f.end());
+        for (auto const& tid : failedTrades) {
+            ALOG("setting all results in output cube to zero for trade '"
+                 << tid << "' since there was at least one error during simulation");
+            miniCubes_[0]->remove(miniCubes_[0]->getTradeIndex(tid));
+        }
+
+        // copy the aggregation scenario data from the threads
+
+        if (aggregationScenarioData_ != nullptr) {
+            LOG("Copy aggregation scenario data from " << eff_nThreads << " threads.");
+            for (Size i = 0; i < eff_nThreads; ++i) {
+                for (auto const& [type, qualifier] : threadAggregationScenarioData[i]->keys()) {
+                    Size from = threadAggregationScenarioData[i]->slot(type, qualifier);
+                    Size to = aggregationScenarioData_->addSlot(type, qualifier);
+                    for (Size d = 0; d < aggregationScenarioData_->dimDates(); ++d) {
+                        for (Size k = 0; k < numberOfSamples[i]; ++k) {
+                            aggregationScenarioData_->set(d, firstSample[i] + k,
+                                                          threadAggregationScenarioData[i]->get(d, k, from), to);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
     // set updated pricing stats in original portfolio
 
     LOG("Update pricing stats of trades.");
@@ -402,6 +731,74 @@ void MultiThreadedValuationEngine::buildCube(
         t->resetPricingStats(n, d);
     }
 
+    // merge the pricing profiles of the threads, if samples are split each thread contributes to each trade
+
+    pricingProfiles_.clear();
+    for (auto const& w : workerPricingProfiles)
+        for (auto const& [tid, p] : w)
+            pricingProfiles_[tid] += p;
+
+    /* merge the observer statistics of the portfolio parts, the risk factors are observed by disjoint sets of trades
+       unless samples are split, in which case each sample slice sees all trades */
+
+    tradeObserverStatistics_.clear();
+    riskFactorObserverStatistics_.clear();
+    for (auto const& w : workerObserverStatistics) {
+        for (auto const& [tradeStatistics, riskFactorStatistics] : w) {
+            for (auto const& [tid, s] : tradeStatistics) {
+                auto& t = tradeObserverStatistics_[tid];
+                t.tradeType = s.tradeType;
+                t.riskFactors = std::max(t.riskFactors, s.riskFactors);
+                t.notifications += s.notifications;
+                t.recalculations += s.recalculations;
+                t.pricings += s.pricings;
+            }
+            for (auto const& [rf, s] : riskFactorStatistics) {
+                auto r = riskFactorObserverStatistics_.find(rf);
+                if (r == riskFactorObserverStatistics_.end()) {
+                    riskFactorObserverStatistics_[rf] = s;
+                    continue;
+                }
+                r->second.quotes = std::max(r->second.quotes, s.quotes);
+                r->second.trades = splitSamples_ ? std::max(r->second.trades, s.trades) : r->second.trades + s.trades;
+                r->second.notifications += s.notifications;
+                r->second.pruned = r->second.pruned && s.pruned;
+            }
+        }
+    }
+
+    // compare the predicted with the actual time per portfolio part
+
+    partitionTimes_.clear();
+    if (!splitSamples_) {
+        double pricingsPerTrade = static_cast<double>(dateGrid_->dates().size() * nSamples_);
+        for (Size i = 0; i < nParts; ++i) {
+            partitionTimes_.push_back(
+                {portfolios[i]->size(), portfolioTotalAvgPricingTime[i] * pricingsPerTrade / 1.0E9, partWallTime[i]});
+            LOG("Portfolio #" << i << " predicted time : " << partitionTimes_.back().predicted
+                              << " s, actual time : " << partitionTimes_.back().actual << " s");
+        }
+    }
+
+    // update the pricing time file with the avg pricing times observed in the worker threads, the trades
+    // not contained in this portfolio are kept
+
+    if (!pricingTimeFile_.empty() && !dryRun) {
+        for (auto const& [tid, t] : portfolio->trades()) {
+            std::size_t n = 0;
+            boost::timer::nanosecond_type d = 0;
+            for (auto const& w : workerPricingStats) {
+                if (auto p = w.find(tid); p != w.end()) {
+                    n += p->second.first;
+                    d += p->second.second;
+                }
+            }
+            if (n > 0)
+                persistedPricingTimes[tid] = {t->tradeType(), n, static_cast<double>(d) / static_cast<double>(n)};
+        }
+        savePricingTimes(pricingTimeFile_, persistedPricingTimes);
+    }
+
     // log timings and return the result mini-cubes
 
     LOG("MultiThreadedValuationEngine::buildCube() successfully finished, timings: "
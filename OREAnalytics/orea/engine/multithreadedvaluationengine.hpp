@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <orea/engine/observergraph.hpp>
 #include <orea/engine/valuationengine.hpp>
 #include <orea/scenario/scenariogenerator.hpp>
 #include <orea/scenario/scenariosimmarket.hpp>
@@ -39,7 +40,13 @@ public:
     /* if no cube factories are given, we create default ones as follows
        - cubeFactory          : creates DoublePrecisionInMemoryCube
        - nettingSetCubeFactory: creates nullptr
-       - cptyCubeFactory:       creates nullptr */
+       - cptyCubeFactory:       creates nullptr
+
+       if sharedInputs is true, the worker threads do not get a full copy of the market data
+       provided by the loader, but read from the given loader and clone only the quotes they actually
+       require (see LazyClonedLoader). Fixings and dividends are read from the given loader directly. This
+       requires the given loader to support concurrent reads, which is the case e.g. for the InMemoryLoader
+       and the CSVLoader. The portfolio xml is released in each worker as soon as the trades are loaded. */
     MultiThreadedValuationEngine(
         const QuantLib::Size nThreads, const QuantLib::Date& today,
         const QuantLib::ext::shared_ptr<ore::analytics::DateGrid>& dateGrid, const QuantLib::Size nSamples,
@@ -67,11 +74,88 @@ public:
             const QuantLib::Date&, const std::set<std::string>&, const std::vector<QuantLib::Date>&,
             const QuantLib::Size)>& cptyCubeFactory = {},
         const std::string& context = "unspecified",
-        const QuantLib::ext::shared_ptr<ore::analytics::Scenario>& offSetScenario = nullptr);
+        const QuantLib::ext::shared_ptr<ore::analytics::Scenario>& offSetScenario = nullptr,
+        const bool sharedInputs = false);
 
     // can be optionally called to set the agg scen data (which is done in the ssm for single-threaded runs)
     void setAggregationScenarioData(const QuantLib::ext::shared_ptr<AggregationScenarioData>& aggregationScenarioData);
 
+    /* can be optionally called to enable dynamic scheduling: if tradeChunkSize > 0, the portfolio is split into
+       chunks of (at most) tradeChunkSize trades, ordered by decreasing average pricing time. The worker threads
+       pull the next chunk from a shared queue when they are done with the previous one, so that the load balance
+       does not depend on the quality of pricing time statistics from previous runs. Each chunk is written to its
+       own mini-cube. If tradeChunkSize = 0 (the default) the portfolio is split into nThreads parts up front. */
+    void setTradeChunkSize(const QuantLib::Size tradeChunkSize);
+
+    /* can be optionally called to parallelise over samples instead of trades: if splitSamples is true, the sample
+       range is split into nThreads slices, each thread prices the whole portfolio on its own sim market for its
+       slice and writes the results to a single output cube. This is useful for small portfolios with many samples.
+       The output cube must support concurrent writes to disjoint samples, which is the case for the in memory
+       cubes. The trade chunk size is ignored in this mode. */
+    void setSplitSamples(const bool splitSamples);
+
+    /* can be optionally called to generate the scenarios of the sample slices in parallel if samples are split: each
+       thread builds its own scenario generator against its init market and positions it at the first sample of its
+       slice using ScenarioGenerator::skipTo(), instead of replaying the scenarios generated upfront in the main
+       thread by the given generator. The builder must produce generators with the same paths as the given one. */
+    void setScenarioGeneratorBuilder(
+        const std::function<QuantLib::ext::shared_ptr<ScenarioGenerator>(
+            const QuantLib::ext::shared_ptr<ore::data::Market>&)>& scenarioGeneratorBuilder);
+
+    /* can be optionally called to store the scenarios shared by the threads in single precision, see
+       CompactScenarioStore, this halves the memory needed for the scenarios at the expense of a small loss of
+       precision in the scenario values */
+    void setCompactScenarios(const bool compactScenarios);
+
+    /* can be optionally called to checkpoint the cube build, see CubeCheckpoint: each portfolio part resp. sample
+       slice saves its completed samples in blocks of blockSize samples to its own subdirectory of the given directory
+       and resumes from there if the build is repeated with the same key. The portfolio is split by trade id instead of
+       by pricing time in this case, so that the parts do not depend on the pricing time statistics of a previous
+       run. */
+    void setCheckpoint(const std::string& directory, const std::string& key, const QuantLib::Size blockSize = 100);
+
+    /* can be optionally called to persist the average pricing times of the trades across runs: if the given file
+       exists, the portfolio is split using the average pricing times from there instead of the single pricing on the
+       init market, trades not contained in the file get the average time of their trade type in the file. After the
+       cube is built, the file is updated with the average pricing times observed in the run. The file is a csv file
+       with columns TradeId, TradeType, NumberOfPricings, AvgPricingTime (in nanoseconds). */
+    void setPricingTimeFile(const std::string& pricingTimeFile);
+
+    //! can be optionally called to enable the profiling of the trade pricings, see ValuationEngine::setProfiling()
+    void setProfiling(const bool profiling);
+
+    //! skip the trade pricing on close-out dates, see ValuationEngine::setSkipCloseOutPricing()
+    void setSkipCloseOutPricing(const bool skipCloseOutPricing);
+
+    //! the pricing profiles of the trades from the last buildCube() call, if profiling is enabled
+    const std::map<std::string, ValuationEngine::PricingProfile>& pricingProfiles() const { return pricingProfiles_; }
+
+    /* can be optionally called to record notification statistics resp. prune unobserved risk factors in the worker
+       threads, see ValuationEngine::setObserverStatistics() and ValuationEngine::setPruneObservers() */
+    void setObserverStatistics(const bool observerStatistics);
+    void setPruneObservers(const bool pruneObservers);
+
+    /* the observer statistics of the last buildCube() call merged over the portfolio parts resp. sample slices, if
+       observer statistics are enabled, a risk factor is reported as pruned if it was pruned in all worker threads */
+    const std::map<std::string, ObserverGraph::TradeStatistics>& tradeObserverStatistics() const {
+        return tradeObserverStatistics_;
+    }
+    const std::map<ObserverGraph::RiskFactor, ObserverGraph::RiskFactorStatistics>&
+    riskFactorObserverStatistics() const {
+        return riskFactorObserverStatistics_;
+    }
+
+    //! predicted and actual time to build the mini-cube of a portfolio part, in seconds
+    struct PartitionTime {
+        QuantLib::Size trades;
+        double predicted;
+        double actual;
+    };
+
+    /* the predicted and actual times of the portfolio parts of the last buildCube() call, empty if samples are
+       split, the predicted time is the total avg pricing time of the part times the number of pricings per trade */
+    const std::vector<PartitionTime>& partitionTimes() const { return partitionTimes_; }
+
     /* analoguous to buildCube() in the single-threaded engine, results are retrieved using below constructors
        if no cptyCalculators is given a function returning an empty vector of calculators will be returned */
     void
@@ -81,7 +165,7 @@ public:
                   cptyCalculators = {},
               bool mporStickyDate = true, bool dryRun = false);
 
-    // result output cubes (mini-cubes, one per thread)
+    // result output cubes (mini-cubes, one per thread resp. trade chunk, a single cube if samples are split)
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>> outputCubes() const { return miniCubes_; }
 
     // result netting cubes (might be null, if nettingSetCubeFactory is returning null)
@@ -123,6 +207,23 @@ private:
         cptyCubeFactory_;
     std::string context_;
     QuantLib::ext::shared_ptr<ore::analytics::Scenario> offsetScenario_;
+    bool sharedInputs_;
+    QuantLib::Size tradeChunkSize_;
+    bool splitSamples_;
+    std::function<QuantLib::ext::shared_ptr<ScenarioGenerator>(const QuantLib::ext::shared_ptr<ore::data::Market>&)>
+        scenarioGeneratorBuilder_;
+    bool compactScenarios_;
+    std::string checkpointDirectory_, checkpointKey_;
+    QuantLib::Size checkpointBlockSize_ = 100;
+    std::string pricingTimeFile_;
+    std::vector<PartitionTime> partitionTimes_;
+    bool profiling_ = false;
+    bool skipCloseOutPricing_ = false;
+    bool observerStatistics_ = false;
+    bool pruneObservers_ = false;
+    std::map<std::string, ObserverGraph::TradeStatistics> tradeObserverStatistics_;
+    std::map<ObserverGraph::RiskFactor, ObserverGraph::RiskFactorStatistics> riskFactorObserverStatistics_;
+    std::map<std::string, ValuationEngine::PricingProfile> pricingProfiles_;
     QuantLib::ext::shared_ptr<AggregationScenarioData>
             aggregationScenarioData_;
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>> miniCubes_;
@@ -0,0 +1,270 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/observergraph.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/trade.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <qle/models/modelbuilder.hpp>
+
+#include <ql/patterns/observable.hpp>
+
+#include <algorithm>
+
+namespace ore {
+namespace analytics {
+
+using QuantLib::Real;
+using QuantLib::Size;
+
+// records the notifications received from the observables it is registered with
+class ObserverGraph::Probe : public QuantLib::Observer {
+public:
+    void update() override {
+        notified = true;
+        ++notifications;
+    }
+    bool notified = false;
+    Size notifications = 0;
+};
+
+ObserverGraph::ObserverGraph(
+    const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket,
+    const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+    const std::set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>>& modelBuilders)
+    : simMarket_(simMarket), modelBuilders_(modelBuilders) {
+    QL_REQUIRE(simMarket_, "ObserverGraph: sim market is null");
+    for (auto const& [tradeId, trade] : portfolio->trades())
+        trades_.push_back(trade);
+    for (auto const& [key, quote] : simMarket_->simData())
+        riskFactorQuotes_[std::make_pair(key.keytype, key.name)].push_back(quote);
+}
+
+ObserverGraph::~ObserverGraph() {}
+
+void ObserverGraph::recalibrateModels() const {
+    for (auto const& b : modelBuilders_)
+        b.second->recalibrate();
+}
+
+void ObserverGraph::analyse() {
+
+    riskFactorTrades_.clear();
+    failedTrades_.assign(trades_.size(), false);
+
+    // register a probe with each trade's instruments and make sure the instruments are calculated, so that they
+    // forward notifications to the probes
+    std::vector<QuantLib::ext::shared_ptr<Probe>> probes;
+    for (Size j = 0; j < trades_.size(); ++j) {
+        auto probe = QuantLib::ext::make_shared<Probe>();
+        probe->registerWith(trades_[j]->instrument()->qlInstrument());
+        for (auto const& i : trades_[j]->instrument()->additionalInstruments())
+            probe->registerWith(i);
+        probes.push_back(probe);
+        try {
+            trades_[j]->instrument()->NPV();
+        } catch (...) {
+            failedTrades_[j] = true;
+        }
+    }
+
+    // notify the quotes of each risk factor and collect the notified trades, the calibrated models are recalibrated
+    // so that dependencies via model parameters are detected as well
+    for (auto const& [rf, quotes] : riskFactorQuotes_) {
+        for (auto& p : probes)
+            p->notified = false;
+        for (auto const& q : quotes)
+            q->notifyObservers();
+        recalibrateModels();
+        auto& rfTrades = riskFactorTrades_[rf];
+        for (Size j = 0; j < trades_.size(); ++j) {
+            if (probes[j]->notified) {
+                rfTrades.push_back(j);
+                try {
+                    trades_[j]->instrument()->NPV();
+                } catch (...) {
+                    failedTrades_[j] = true;
+                }
+            }
+        }
+    }
+}
+
+std::vector<Real> ObserverGraph::npvs(bool& failed) const {
+    std::vector<Real> result(trades_.size(), 0.0);
+    for (Size j = 0; j < trades_.size(); ++j) {
+        try {
+            trades_[j]->instrument()->updateQlInstruments();
+            result[j] = trades_[j]->instrument()->NPV();
+        } catch (...) {
+            failed = true;
+        }
+    }
+    return result;
+}
+
+bool ObserverGraph::unaffected(const std::vector<RiskFactor>& riskFactors, const std::vector<Real>& baseNpvs) {
+    std::vector<std::pair<QuantLib::ext::shared_ptr<QuantLib::SimpleQuote>, Real>> saved;
+    for (auto const& rf : riskFactors) {
+        for (auto const& q : riskFactorQuotes_.at(rf)) {
+            Real v = q->value();
+            saved.push_back(std::make_pair(q, v));
+            q->setValue(v != 0.0 ? v * 0.99 : 1.0E-4);
+        }
+    }
+    recalibrateModels();
+    bool failed = false;
+    std::vector<Real> bumpedNpvs = npvs(failed);
+    ++repricings_;
+    for (auto const& [q, v] : saved)
+        q->setValue(v);
+    recalibrateModels();
+    return !failed && bumpedNpvs == baseNpvs;
+}
+
+std::vector<ObserverGraph::RiskFactor> ObserverGraph::verify(const std::vector<RiskFactor>& candidates,
+                                                             const std::vector<Real>& baseNpvs) {
+    if (candidates.empty() || unaffected(candidates, baseNpvs))
+        return candidates;
+    if (candidates.size() == 1) {
+        DLOG("ObserverGraph: risk factor " << candidates.front().first << "/" << candidates.front().second
+                                           << " is not observed by any trade, but affects the trade NPVs");
+        return {};
+    }
+    Size mid = candidates.size() / 2;
+    auto result = verify(std::vector<RiskFactor>(candidates.begin(), candidates.begin() + mid), baseNpvs);
+    auto second = verify(std::vector<RiskFactor>(candidates.begin() + mid, candidates.end()), baseNpvs);
+    result.insert(result.end(), second.begin(), second.end());
+    return result;
+}
+
+std::set<ObserverGraph::RiskFactor> ObserverGraph::prune(const std::set<RiskFactor>& excluded) {
+
+    pruned_.clear();
+    repricings_ = 0;
+
+    if (std::find(failedTrades_.begin(), failedTrades_.end(), true) != failedTrades_.end()) {
+        WLOG("ObserverGraph: the pricing of some trades failed, their dependencies are unknown, no risk factors are "
+             "pruned");
+        return pruned_;
+    }
+
+    std::vector<RiskFactor> candidates;
+    for (auto const& [rf, trades] : riskFactorTrades_) {
+        if (trades.empty() && excluded.find(rf) == excluded.end())
+            candidates.push_back(rf);
+    }
+    if (candidates.empty()) {
+        LOG("ObserverGraph: no unobserved risk factors, nothing to prune");
+        return pruned_;
+    }
+
+    bool failed = false;
+    std::vector<Real> baseNpvs = npvs(failed);
+    if (failed) {
+        WLOG("ObserverGraph: the repricing of the trades failed, no risk factors are pruned");
+        return pruned_;
+    }
+
+    auto verified = verify(candidates, baseNpvs);
+
+    // the subsets were verified separately, check that they do not affect the trades jointly either
+    if (verified.size() < candidates.size() && !verified.empty() && !unaffected(verified, baseNpvs)) {
+        WLOG("ObserverGraph: the unobserved risk factors affect the trade NPVs jointly, no risk factors are pruned");
+        verified.clear();
+    }
+
+    pruned_.insert(verified.begin(), verified.end());
+    LOG("ObserverGraph: pruned " << pruned_.size() << " of " << candidates.size() << " unobserved risk factors ("
+                                 << riskFactorQuotes_.size() << " risk factors in total) using " << repricings_
+                                 << " portfolio repricings");
+    return pruned_;
+}
+
+void ObserverGraph::startRecording() {
+    tradeProbes_.clear();
+    quoteProbes_.clear();
+    for (auto const& t : trades_) {
+        auto probe = QuantLib::ext::make_shared<Probe>();
+        probe->registerWith(t->instrument()->qlInstrument());
+        for (auto const& i : t->instrument()->additionalInstruments())
+            probe->registerWith(i);
+        tradeProbes_.push_back(probe);
+    }
+    for (auto const& [rf, quotes] : riskFactorQuotes_) {
+        auto& probes = quoteProbes_[rf];
+        for (auto const& q : quotes) {
+            probes.push_back(QuantLib::ext::make_shared<Probe>());
+            probes.back()->registerWith(q);
+        }
+    }
+    recalculations_.assign(trades_.size(), 0);
+    pricings_.assign(trades_.size(), 0);
+    recording_ = true;
+}
+
+void ObserverGraph::recordPricing(const Size tradeIndex, const bool updated) {
+    if (!recording_)
+        return;
+    auto& probe = *tradeProbes_[tradeIndex];
+    ++pricings_[tradeIndex];
+    if (updated || probe.notified)
+        ++recalculations_[tradeIndex];
+    probe.notified = false;
+}
+
+std::map<std::string, ObserverGraph::TradeStatistics> ObserverGraph::tradeStatistics() const {
+    std::vector<Size> riskFactors(trades_.size(), 0);
+    for (auto const& [rf, trades] : riskFactorTrades_)
+        for (auto j : trades)
+            ++riskFactors[j];
+    std::map<std::string, TradeStatistics> result;
+    for (Size j = 0; j < trades_.size(); ++j) {
+        auto& s = result[trades_[j]->id()];
+        s.tradeType = trades_[j]->tradeType();
+        s.riskFactors = riskFactors[j];
+        if (recording_) {
+            s.notifications = tradeProbes_[j]->notifications;
+            s.recalculations = recalculations_[j];
+            s.pricings = pricings_[j];
+        }
+    }
+    return result;
+}
+
+std::map<ObserverGraph::RiskFactor, ObserverGraph::RiskFactorStatistics> ObserverGraph::riskFactorStatistics() const {
+    std::map<RiskFactor, RiskFactorStatistics> result;
+    for (auto const& [rf, quotes] : riskFactorQuotes_) {
+        auto& s = result[rf];
+        s.quotes = quotes.size();
+        if (auto t = riskFactorTrades_.find(rf); t != riskFactorTrades_.end())
+            s.trades = t->second.size();
+        if (auto p = quoteProbes_.find(rf); p != quoteProbes_.end()) {
+            for (auto const& probe : p->second)
+                s.notifications += probe->notifications;
+        }
+        s.pruned = pruned_.find(rf) != pruned_.end();
+    }
+    return result;
+}
+
+} // namespace analytics
+} // namespace ore
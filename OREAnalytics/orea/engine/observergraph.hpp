@@ -0,0 +1,144 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/engine/observergraph.hpp
+    \brief dependencies of the trades on the risk factors of a simulation market and notification statistics
+    \ingroup simulation
+*/
+
+#pragma once
+
+#include <orea/scenario/scenario.hpp>
+
+#include <ql/quotes/simplequote.hpp>
+#include <ql/shared_ptr.hpp>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ore::data {
+class Portfolio;
+class Trade;
+} // namespace ore::data
+
+namespace QuantExt {
+class ModelBuilder;
+}
+
+namespace ore {
+namespace analytics {
+
+class ScenarioSimMarket;
+
+//! Dependencies of the trades on the risk factors of a simulation market
+/*! The trades observing a risk factor (key type and name) are determined by notifying the sim data quotes of each
+    risk factor in turn and recording which trade instruments receive the notification. This requires enabled
+    updates, see QuantLib::ObservableSettings.
+
+    Risk factors that no trade observes can be pruned, i.e. excluded from the scenario updates of the simulation
+    market, so that their quotes do not send notifications through the observer graph. To catch trades that read
+    market data without observing it, the candidates are verified by bumping their quotes and repricing all trades,
+    a candidate is only pruned if the NPVs of all trades are unchanged.
+
+    While recording, the notifications received by the sim data quotes and trade instruments and the recalculations of
+    the trades are counted.
+
+    \ingroup simulation
+*/
+class ObserverGraph {
+public:
+    typedef std::pair<RiskFactorKey::KeyType, std::string> RiskFactor;
+
+    struct TradeStatistics {
+        std::string tradeType;
+        //! number of risk factors the trade observes
+        QuantLib::Size riskFactors = 0;
+        //! notifications received by the trade instruments while recording
+        QuantLib::Size notifications = 0;
+        //! pricings after a notification or an explicit instrument update, resp. all pricings
+        QuantLib::Size recalculations = 0, pricings = 0;
+    };
+
+    struct RiskFactorStatistics {
+        //! number of sim data quotes and of trades observing them
+        QuantLib::Size quotes = 0, trades = 0;
+        //! notifications sent by the quotes while recording
+        QuantLib::Size notifications = 0;
+        bool pruned = false;
+    };
+
+    ObserverGraph(const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket,
+                  const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+                  const std::set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>>&
+                      modelBuilders = {});
+    ~ObserverGraph();
+
+    //! Determine the trades observing each risk factor
+    void analyse();
+
+    //! The indices of the trades (in portfolio order) observing each risk factor, available after analyse()
+    const std::map<RiskFactor, std::vector<QuantLib::Size>>& riskFactorTrades() const { return riskFactorTrades_; }
+
+    //! Trades whose pricing failed during analyse(), they do not forward notifications reliably
+    const std::vector<bool>& failedTrades() const { return failedTrades_; }
+
+    /*! Determine the risk factors that no trade observes and that do not affect any trade NPV, the excluded risk
+        factors are never pruned, e.g. because they are needed by the calculators or the aggregation scenario data.
+        The candidates are verified by bumping all of them at once and bisecting the set if an NPV changes. The sim
+        data quotes and models are restored afterwards. Requires analyse(). */
+    std::set<RiskFactor> prune(const std::set<RiskFactor>& excluded = {});
+
+    //! Start counting the notifications of the sim data quotes and the trade instruments
+    void startRecording();
+
+    //! Record a pricing of the trade with the given index, updated is true if its instruments were updated explicitly
+    void recordPricing(const QuantLib::Size tradeIndex, const bool updated);
+
+    //! Statistics by trade id resp. risk factor, the notifications and pricings are available if recording
+    std::map<std::string, TradeStatistics> tradeStatistics() const;
+    std::map<RiskFactor, RiskFactorStatistics> riskFactorStatistics() const;
+
+private:
+    class Probe;
+
+    void recalibrateModels() const;
+    std::vector<QuantLib::Real> npvs(bool& failed) const;
+    bool unaffected(const std::vector<RiskFactor>& riskFactors, const std::vector<QuantLib::Real>& baseNpvs);
+    std::vector<RiskFactor> verify(const std::vector<RiskFactor>& candidates,
+                                   const std::vector<QuantLib::Real>& baseNpvs);
+
+    QuantLib::ext::shared_ptr<ScenarioSimMarket> simMarket_;
+    std::vector<QuantLib::ext::shared_ptr<ore::data::Trade>> trades_;
+    std::set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>> modelBuilders_;
+
+    std::map<RiskFactor, std::vector<QuantLib::ext::shared_ptr<QuantLib::SimpleQuote>>> riskFactorQuotes_;
+    std::map<RiskFactor, std::vector<QuantLib::Size>> riskFactorTrades_;
+    std::vector<bool> failedTrades_;
+    std::set<RiskFactor> pruned_;
+    QuantLib::Size repricings_ = 0;
+
+    bool recording_ = false;
+    std::vector<QuantLib::ext::shared_ptr<Probe>> tradeProbes_;
+    std::map<RiskFactor, std::vector<QuantLib::ext::shared_ptr<Probe>>> quoteProbes_;
+    std::vector<QuantLib::Size> recalculations_, pricings_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -77,6 +77,11 @@ ostream& operator<<(ostream& out, const ParametricVarCalculator::ParametricVarPa
 
 Real ParametricVarCalculator::var(Real confidence, const bool isCall, 
     const set<pair<string, Size>>& tradeIds) {
+    return vars({confidence}, isCall, tradeIds).front();
+}
+
+vector<Real> ParametricVarCalculator::vars(const vector<Real>& confidences, const bool isCall,
+                                           const set<pair<string, Size>>& tradeIds) {
     Real factor = isCall ? 1.0 : -1.0;
 
     Array delta(deltas_.size(), 0.0);
@@ -106,33 +111,45 @@ Real ParametricVarCalculator::var(Real confidence, const bool isCall,
         }
     }
 
-    if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::Delta)
-        return QuantExt::deltaVar(omega_, delta, confidence, *covarianceSalvage_);
-    else if (parametricVarParams_.method ==
-                ParametricVarCalculator::ParametricVarParams::Method::DeltaGammaNormal)
-        return QuantExt::deltaGammaVarNormal(omega_, delta, gamma, confidence, *covarianceSalvage_);
-    else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::MonteCarlo) {
+    // the same covariance matrix is salvaged for each confidence level otherwise
+    QuantExt::CachingCovarianceSalvage salvage(*covarianceSalvage_);
+
+    auto mcVars = [this, &delta, &gamma, &salvage](const vector<Real>& p) {
         QL_REQUIRE(parametricVarParams_.samples != Null<Size>(),
                     "ParametricVarCalculator::computeVar(): method MonteCarlo requires mcSamples");
         QL_REQUIRE(parametricVarParams_.seed != Null<Size>(),
                     "ParametricVarCalculator::computeVar(): method MonteCarlo requires mcSamples");
-        return QuantExt::deltaGammaVarMc<PseudoRandom>(omega_, delta, gamma, confidence, parametricVarParams_.samples,
-                                                        parametricVarParams_.seed, *covarianceSalvage_);
-    } else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::CornishFisher)
-        return QuantExt::deltaGammaVarCornishFisher(omega_, delta, gamma, confidence, *covarianceSalvage_);
-    else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::Saddlepoint) {
-        Real res;
-        try {
-            res = QuantExt::deltaGammaVarSaddlepoint(omega_, delta, gamma, confidence, *covarianceSalvage_);
-        } catch (const std::exception& e) {
-            ALOG("Saddlepoint VaR computation exited with an error: " << e.what()
-                                                                        << ", falling back on Monte-Carlo");
-            res = QuantExt::deltaGammaVarMc<PseudoRandom>(omega_, delta, gamma, confidence,
-                parametricVarParams_.samples, parametricVarParams_.seed, *covarianceSalvage_);
-        }        
-        return res;
-    } else
-        QL_FAIL("ParametricVarCalculator::computeVar(): method " << parametricVarParams_.method << " not known.");
+        return QuantExt::deltaGammaVarMc<PseudoRandom>(omega_, delta, gamma, p, parametricVarParams_.samples,
+                                                        parametricVarParams_.seed, salvage);
+    };
+
+    if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::MonteCarlo)
+        return mcVars(confidences);
+
+    vector<Real> result;
+    for (auto const& confidence : confidences) {
+        if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::Delta)
+            result.push_back(QuantExt::deltaVar(omega_, delta, confidence, salvage));
+        else if (parametricVarParams_.method ==
+                    ParametricVarCalculator::ParametricVarParams::Method::DeltaGammaNormal)
+            result.push_back(QuantExt::deltaGammaVarNormal(omega_, delta, gamma, confidence, salvage));
+        else if (parametricVarParams_.method ==
+                 ParametricVarCalculator::ParametricVarParams::Method::CornishFisher)
+            result.push_back(QuantExt::deltaGammaVarCornishFisher(omega_, delta, gamma, confidence, salvage));
+        else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::Saddlepoint) {
+            Real res;
+            try {
+                res = QuantExt::deltaGammaVarSaddlepoint(omega_, delta, gamma, confidence, salvage);
+            } catch (const std::exception& e) {
+                ALOG("Saddlepoint VaR computation exited with an error: " << e.what()
+                                                                            << ", falling back on Monte-Carlo");
+                res = mcVars({confidence}).front();
+            }
+            result.push_back(res);
+        } else
+            QL_FAIL("ParametricVarCalculator::computeVar(): method " << parametricVarParams_.method << " not known.");
+    }
+    return result;
 }
 
 ParametricVarReport::ParametricVarReport(const std::string& baseCurrency, const ext::shared_ptr<Portfolio>& portfolio,
@@ -164,9 +181,14 @@ ParametricVarReport::ParametricVarReport(
     sensiBased_ = true;
 }
 
-void ParametricVarReport::createVarCalculator() {
-    varCalculator_ = QuantLib::ext::make_shared<ParametricVarCalculator>(
-        parametricVarParams_, covarianceMatrix_, deltas_, gammas_, salvage_, includeGammaMargin_, includeDeltaMargin_);
+std::function<std::vector<Real>()> ParametricVarReport::varFunction() {
+    // the calculator holds references, so the inputs of the trade group are copied into the function
+    return [this, omega = covarianceMatrix_, deltas = deltas_, gammas = gammas_, salvage = salvage_,
+            includeGammaMargin = includeGammaMargin_, includeDeltaMargin = includeDeltaMargin_]() {
+        return ParametricVarCalculator(parametricVarParams_, omega, deltas, gammas, salvage, includeGammaMargin,
+                                       includeDeltaMargin)
+            .vars(p());
+    };
 }
 
 } // namespace analytics
@@ -79,6 +79,10 @@ public:
     QuantLib::Real var(QuantLib::Real confidence, const bool isCall = true, 
         const std::set<std::pair<std::string, QuantLib::Size>>& tradeIds = {}) override;
 
+    //! The covariance matrix is salvaged once and the Monte Carlo paths are shared by all confidence levels
+    std::vector<QuantLib::Real> vars(const std::vector<QuantLib::Real>& confidences, const bool isCall = true,
+                                     const std::set<std::pair<std::string, QuantLib::Size>>& tradeIds = {}) override;
+
 private:
     const ParametricVarParams& parametricVarParams_;
     const QuantLib::Matrix& omega_;
@@ -114,11 +118,12 @@ public:
         const bool salvageCovarianceMatrix, boost::optional<ore::data::TimePeriod> period,
         std::unique_ptr<SensiRunArgs> sensiArgs = nullptr, const bool breakdown = false);
 
-    void createVarCalculator() override;
-    
     typedef std::pair<RiskFactorKey, RiskFactorKey> CrossPair;
 
 protected:    
+    std::function<std::vector<QuantLib::Real>()> varFunction() override;
+
+
     const QuantLib::ext::shared_ptr<SensitivityScenarioData> sensitivityConfig_;
     const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> simMarketConfig_;
 
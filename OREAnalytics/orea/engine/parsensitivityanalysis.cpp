@@ -23,13 +23,17 @@
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/parsensitivityanalysis.hpp>
 #include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/clonedscenariogenerator.hpp>
 #include <orea/scenario/sensitivityscenariodata.hpp>
 #include <orea/scenario/simplescenariofactory.hpp>
 
+#include <ored/marketdata/clonedloader.hpp>
 #include <ored/marketdata/inflationcurve.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
 #include <ored/utilities/indexparser.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/marketdata.hpp>
+#include <ored/utilities/parsers.hpp>
 #include <ored/utilities/to_string.hpp>
 
 #include <qle/indexes/inflationindexwrapper.hpp>
@@ -69,10 +73,17 @@
 #include <ql/termstructures/yield/oisratehelper.hpp>
 #include <qle/instruments/fixedbmaswap.hpp>
 
+#include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/numeric/ublas/operation.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -139,6 +150,32 @@ void ParSensitivityAnalysis::augmentRelevantRiskFactors() {
 }
 
 namespace {
+// removes todays fixings from the given indices for its lifetime
+struct TodaysFixingsRemover {
+    TodaysFixingsRemover(const std::set<std::string>& names) : today_(Settings::instance().evaluationDate()) {
+        Date today = Settings::instance().evaluationDate();
+        for (auto const& n : names) {
+            TimeSeries<Real> t = IndexManager::instance().getHistory(n);
+            if (t[today] != Null<Real>()) {
+                DLOG("removing todays fixing (" << std::setprecision(6) << t[today] << ") from " << n);
+                savedFixings_.insert(std::make_pair(n, t[today]));
+                t[today] = Null<Real>();
+                IndexManager::instance().setHistory(n, t);
+            }
+        }
+    }
+    ~TodaysFixingsRemover() {
+        for (auto const& p : savedFixings_) {
+            TimeSeries<Real> t = IndexManager::instance().getHistory(p.first);
+            t[today_] = p.second;
+            IndexManager::instance().setHistory(p.first, t);
+            DLOG("restored todays fixing (" << std::setprecision(6) << p.second << ") for " << p.first);
+        }
+    }
+    const Date today_;
+    std::set<std::pair<std::string, Real>> savedFixings_;
+};
+
 void writeSensitivity(const RiskFactorKey& a, const RiskFactorKey& b, const Real value,
                       std::map<std::pair<RiskFactorKey, RiskFactorKey>, Real>& parSensi,
                       std::set<RiskFactorKey>& parKeysNonZero, std::set<RiskFactorKey>& rawKeysNonZero) {
@@ -149,9 +186,150 @@ void writeSensitivity(const RiskFactorKey& a, const RiskFactorKey& b, const Real
     parSensi[std::make_pair(a, b)] = value;
     DLOG("ParInstrument Sensi " << a << " w.r.t. " << b << " " << setprecision(6) << value);
 }
+
+/* The par sensitivity cache file has the lines
+   ParSensitivityCache,<cacheKey>
+   Base,<parKey>,<base par rate or flat vol>
+   Raw,<zero key>                               (for each processed zero risk factor)
+   Sensi,<parKey>,<zero key>,<sensitivity>      (for each non-zero sensitivity) */
+
+void writeParSensitivityCache(const std::string& fileName, const std::string& cacheKey,
+                              const std::map<RiskFactorKey, Real>& parBase, const std::set<RiskFactorKey>& rawKeys,
+                              const ParSensitivityAnalysis::ParContainer& parSensi) {
+    std::ofstream file(fileName);
+    if (!file.is_open()) {
+        WLOG("could not open par sensitivity cache file '" << fileName << "' for writing");
+        return;
+    }
+    file << std::setprecision(17);
+    file << "ParSensitivityCache," << cacheKey << "\n";
+    for (auto const& [k, v] : parBase)
+        file << "Base," << k << "," << v << "\n";
+    for (auto const& k : rawKeys)
+        file << "Raw," << k << "\n";
+    for (auto const& [k, v] : parSensi)
+        file << "Sensi," << k.first << "," << k.second << "," << v << "\n";
+    LOG("Written par sensitivity cache file '" << fileName << "' (" << parSensi.size() << " sensitivities)");
+}
+
+std::pair<RiskFactorKey::KeyType, std::string> riskFactorGroup(const RiskFactorKey& k) {
+    return std::make_pair(k.keytype, k.name);
+}
+
+std::map<RiskFactorKey, std::vector<std::pair<RiskFactorKey, Real>>>
+reusableParSensitivities(const std::string& fileName, const std::string& cacheKey, const Real tolerance,
+                         const std::map<RiskFactorKey, Real>& parBase) {
+
+    std::map<RiskFactorKey, std::vector<std::pair<RiskFactorKey, Real>>> result;
+
+    // read the cache file, if it exists and was written for the same key
+
+    std::ifstream file(fileName);
+    if (!file.is_open()) {
+        LOG("par sensitivity cache file '" << fileName << "' not found, compute all par sensitivities");
+        return result;
+    }
+    std::map<RiskFactorKey, Real> cachedBase;
+    std::set<RiskFactorKey> cachedRawKeys;
+    std::map<RiskFactorKey, std::vector<std::pair<RiskFactorKey, Real>>> cachedSensitivities;
+    try {
+        std::string line;
+        std::vector<std::string> tokens;
+        QL_REQUIRE(std::getline(file, line), "empty file");
+        boost::split(tokens, line, boost::is_any_of(","));
+        if (tokens.size() != 2 || tokens[0] != "ParSensitivityCache" || tokens[1] != cacheKey) {
+            LOG("par sensitivity cache file '" << fileName << "' was written for a different configuration, "
+                                               << "compute all par sensitivities");
+            return result;
+        }
+        while (std::getline(file, line)) {
+            boost::split(tokens, line, boost::is_any_of(","));
+            if (tokens.size() == 3 && tokens[0] == "Base")
+                cachedBase[parseRiskFactorKey(tokens[1])] = parseReal(tokens[2]);
+            else if (tokens.size() == 2 && tokens[0] == "Raw")
+                cachedRawKeys.insert(parseRiskFactorKey(tokens[1]));
+            else if (tokens.size() == 4 && tokens[0] == "Sensi")
+                cachedSensitivities[parseRiskFactorKey(tokens[2])].push_back(
+                    std::make_pair(parseRiskFactorKey(tokens[1]), parseReal(tokens[3])));
+            else
+                QL_REQUIRE(line.empty(), "invalid line '" << line << "'");
+        }
+    } catch (const std::exception& e) {
+        WLOG("could not read par sensitivity cache file '" << fileName << "': " << e.what()
+                                                          << ", compute all par sensitivities");
+        return result;
+    }
+
+    // a risk factor group is unchanged if it has the same par instruments and all base values are within tolerance
+
+    std::map<std::pair<RiskFactorKey::KeyType, std::string>, bool> groupUnchanged;
+    for (auto const& [k, v] : parBase) {
+        auto c = cachedBase.find(k);
+        bool unchanged = c != cachedBase.end() && std::abs(v - c->second) <= tolerance;
+        auto g = groupUnchanged.insert(std::make_pair(riskFactorGroup(k), true)).first;
+        g->second = g->second && unchanged;
+    }
+    for (auto const& [k, v] : cachedBase) {
+        if (parBase.find(k) == parBase.end())
+            groupUnchanged[riskFactorGroup(k)] = false;
+    }
+    auto isUnchanged = [&groupUnchanged](const RiskFactorKey& k) {
+        auto g = groupUnchanged.find(riskFactorGroup(k));
+        return g != groupUnchanged.end() && g->second;
+    };
+
+    // the sensitivities w.r.t. a zero risk factor are reused, if its group and the groups of all par instruments
+    // sensitive to it are unchanged
+
+    for (auto const& r : cachedRawKeys) {
+        if (!isUnchanged(r))
+            continue;
+        auto s = cachedSensitivities.find(r);
+        bool reuse = true;
+        if (s != cachedSensitivities.end()) {
+            for (auto const& p : s->second)
+                reuse = reuse && isUnchanged(p.first);
+        }
+        if (reuse)
+            result[r] = s == cachedSensitivities.end() ? std::vector<std::pair<RiskFactorKey, Real>>() : s->second;
+    }
+
+    LOG("par sensitivity cache file '" << fileName << "': reuse sensitivities for " << result.size() << " of "
+                                       << cachedRawKeys.size() << " zero risk factors");
+    return result;
+}
 } // namespace
 
+void ParSensitivityAnalysis::setCache(const std::string& fileName, const std::string& cacheKey, const Real tolerance) {
+    cacheFile_ = fileName;
+    cacheKey_ = cacheKey;
+    cacheTolerance_ = tolerance;
+}
+
+std::string parSensitivityCacheKey(const Date& asof,
+                                   const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& simMarketParams,
+                                   const SensitivityScenarioData& sensitivityData,
+                                   const QuantLib::ext::shared_ptr<CurveConfigurations>& curveConfigs,
+                                   const QuantLib::ext::shared_ptr<TodaysMarketParameters>& todaysMarketParams) {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, simMarketParams ? simMarketParams->toXMLString() : std::string());
+    boost::hash_combine(seed, sensitivityData.toXMLString());
+    boost::hash_combine(seed, curveConfigs ? curveConfigs->toXMLString() : std::string());
+    boost::hash_combine(seed, todaysMarketParams ? todaysMarketParams->toXMLString() : std::string());
+    std::ostringstream key;
+    key << ore::data::to_string(asof) << "_" << std::hex << seed;
+    return key.str();
+}
+
 void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket) {
+    computeParInstrumentSensitivities(1, simMarket, nullptr, nullptr, nullptr);
+}
+
+void ParSensitivityAnalysis::computeParInstrumentSensitivities(
+    const Size nThreads, const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket,
+    const QuantLib::ext::shared_ptr<Loader>& loader, const QuantLib::ext::shared_ptr<CurveConfigurations>& curveConfigs,
+    const QuantLib::ext::shared_ptr<TodaysMarketParameters>& todaysMarketParams,
+    const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData, const IborFallbackConfig& iborFallbackConfig) {
 
     LOG("Cache base scenario par rates and flat vols");
 
@@ -164,30 +342,6 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
     }
 
     // remove todays fixings from relevant indices for the scope of this method
-    struct TodaysFixingsRemover {
-        TodaysFixingsRemover(const std::set<std::string>& names) : today_(Settings::instance().evaluationDate()) {
-            Date today = Settings::instance().evaluationDate();
-            for (auto const& n : names) {
-                TimeSeries<Real> t = IndexManager::instance().getHistory(n);
-                if (t[today] != Null<Real>()) {
-                    DLOG("removing todays fixing (" << std::setprecision(6) << t[today] << ") from " << n);
-                    savedFixings_.insert(std::make_pair(n, t[today]));
-                    t[today] = Null<Real>();
-                    IndexManager::instance().setHistory(n, t);
-                }
-            }
-        }
-        ~TodaysFixingsRemover() {
-            for (auto const& p : savedFixings_) {
-                TimeSeries<Real> t = IndexManager::instance().getHistory(p.first);
-                t[today_] = p.second;
-                IndexManager::instance().setHistory(p.first, t);
-                DLOG("restored todays fixing (" << std::setprecision(6) << p.second << ") for " << p.first);
-            }
-        }
-        const Date today_;
-        std::set<std::pair<std::string, Real>> savedFixings_;
-    };
     TodaysFixingsRemover fixingRemover(instruments_.removeTodaysFixingIndices_);
 
     // We must have a ShiftScenarioGenerator
@@ -288,6 +442,14 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
     std::set<RiskFactorKey> parKeysCheck, parKeysNonZero;
     std::set<RiskFactorKey> rawKeysCheck, rawKeysNonZero;
 
+    // par sensitivities from the cache by zero risk factor, for the risk factors whose par rates did not move
+
+    std::map<RiskFactorKey, Real> parBase(parRatesBase);
+    parBase.insert(parCapVols.begin(), parCapVols.end());
+    std::map<RiskFactorKey, std::vector<std::pair<RiskFactorKey, Real>>> cachedSensitivities;
+    if (!cacheFile_.empty())
+        cachedSensitivities = reusableParSensitivities(cacheFile_, cacheKey_, cacheTolerance_, parBase);
+
     for (auto const& p : instruments_.parHelpers_) {
         parKeysCheck.insert(p.first);
     }
@@ -300,7 +462,143 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
         parKeysCheck.insert(p.first);
     }
 
-    for (Size i = 1; i < scenarioGenerator->samples(); ++i) {
+    if (nThreads <= 1 || loader == nullptr || scenarioGenerator->samples() <= 2) {
+
+        computeShiftScenarioSensitivities(simMarket, instruments_, desc, parRatesBase, parCapVols, 1,
+                                          scenarioGenerator->samples(), cachedSensitivities, parSensi_, rawKeysCheck,
+                                          parKeysNonZero, rawKeysNonZero);
+
+    } else {
+
+        // split the shift scenarios 1, ..., samples - 1 into blocks processed by worker threads, each worker builds
+        // its own market, sim market and par instruments, the scenarios are generated once and shared
+
+        Size nScenarios = scenarioGenerator->samples() - 1;
+        Size effThreads = std::min(nThreads, nScenarios);
+        LOG("Compute par rate and flat vol sensitivities using " << effThreads << " threads");
+
+        auto scenarios = QuantLib::ext::make_shared<ClonedScenarioGenerator>(
+            scenarioGenerator, std::vector<Date>(1, asof_), scenarioGenerator->samples());
+
+        std::vector<ParContainer> workerParSensi(effThreads);
+        std::vector<std::set<RiskFactorKey>> workerRawKeysCheck(effThreads), workerParKeysNonZero(effThreads),
+            workerRawKeysNonZero(effThreads);
+        std::vector<std::exception_ptr> workerErrors(effThreads);
+        ObservationMode::Mode obsMode = ObservationMode::instance().mode();
+
+        std::vector<std::thread> workers;
+        for (Size t = 0; t < effThreads; ++t) {
+            Size firstSample = 1 + t * nScenarios / effThreads;
+            Size endSample = 1 + (t + 1) * nScenarios / effThreads;
+            workers.emplace_back([&, t, firstSample, endSample]() {
+                try {
+                    // set thread local singletons
+                    Settings::instance().evaluationDate() = asof_;
+                    ObservationMode::instance().setMode(obsMode);
+                    DLOG("par sensi worker " << t << " processes scenarios " << firstSample << " ... "
+                                             << endSample - 1);
+                    auto initMarket = QuantLib::ext::make_shared<TodaysMarket>(
+                        asof_, todaysMarketParams, QuantLib::ext::make_shared<ClonedLoader>(asof_, loader),
+                        curveConfigs, continueOnError_, true, true, referenceData, false, iborFallbackConfig);
+                    auto workerSimMarket = QuantLib::ext::make_shared<ScenarioSimMarket>(
+                        initMarket, simMarketParams_, marketConfiguration_,
+                        curveConfigs ? *curveConfigs : CurveConfigurations(),
+                        todaysMarketParams ? *todaysMarketParams : TodaysMarketParameters(), continueOnError_,
+                        sensitivityData_.useSpreadedTermStructures(), false, false, iborFallbackConfig);
+                    workerSimMarket->scenarioGenerator() =
+                        QuantLib::ext::make_shared<ClonedScenarioGenerator>(*scenarios, firstSample);
+                    TodaysFixingsRemover workerFixingRemover(instruments_.removeTodaysFixingIndices_);
+                    ParSensitivityInstrumentBuilder::Instruments workerInstruments;
+                    ParSensitivityInstrumentBuilder().createParInstruments(
+                        workerInstruments, asof_, simMarketParams_, sensitivityData_, typesDisabled_, parTypes_,
+                        relevantRiskFactors_, continueOnError_, marketConfiguration_, workerSimMarket);
+                    // evaluate the par instruments on the base scenario, like in the main thread
+                    for (auto& p : workerInstruments.parHelpers_)
+                        impliedQuote(p.second);
+                    for (auto& p : workerInstruments.parCaps_)
+                        p.second->NPV();
+                    for (auto& p : workerInstruments.parYoYCaps_)
+                        p.second->NPV();
+                    computeShiftScenarioSensitivities(workerSimMarket, workerInstruments, desc, parRatesBase,
+                                                      parCapVols, firstSample, endSample, cachedSensitivities,
+                                                      workerParSensi[t],
+                                                      workerRawKeysCheck[t], workerParKeysNonZero[t],
+                                                      workerRawKeysNonZero[t]);
+                } catch (...) {
+                    workerErrors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        for (auto const& e : workerErrors) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+
+        // assemble the results in scenario order, so that a later scenario overwrites an entry like in the
+        // single-threaded computation
+
+        for (Size t = 0; t < effThreads; ++t) {
+            for (auto& [key, value] : workerParSensi[t])
+                parSensi_.insert_or_assign(key, value);
+            rawKeysCheck.insert(workerRawKeysCheck[t].begin(), workerRawKeysCheck[t].end());
+            parKeysNonZero.insert(workerParKeysNonZero[t].begin(), workerParKeysNonZero[t].end());
+            rawKeysNonZero.insert(workerRawKeysNonZero[t].begin(), workerRawKeysNonZero[t].end());
+        }
+    }
+
+    // check for
+    // a) par instruments which have no sensitivity to any of the risk factors
+    // b) risk factors w.r.t. which no par instrument has a sensitivity
+    std::set<RiskFactorKey> parKeysZero, rawKeysZero;
+    std::set_difference(parKeysCheck.begin(), parKeysCheck.end(), parKeysNonZero.begin(), parKeysNonZero.end(),
+                        std::inserter(parKeysZero, parKeysZero.begin()));
+    std::set_difference(rawKeysCheck.begin(), rawKeysCheck.end(), rawKeysNonZero.begin(), rawKeysNonZero.end(),
+                        std::inserter(rawKeysZero, rawKeysZero.begin()));
+    std::set<RiskFactorKey> problematicKeys;
+    problematicKeys.insert(parKeysZero.begin(), parKeysZero.end());
+    problematicKeys.insert(rawKeysZero.begin(), rawKeysZero.end());
+    for (auto const& k : problematicKeys) {
+        std::string type;
+        if (parKeysZero.find(k) != parKeysZero.end())
+            type = "par instrument is insensitive to all zero risk factors";
+        else if (rawKeysZero.find(k) != rawKeysZero.end())
+            type = "zero risk factor that does not affect an par instrument";
+        else
+            type = "unknown";
+        Real parHelperValue = Null<Real>();
+        if (auto tmp = instruments_.parHelpers_.find(k); tmp != instruments_.parHelpers_.end())
+            parHelperValue = impliedQuote(tmp->second);
+        else if (auto tmp = instruments_.parCaps_.find(k); tmp != instruments_.parCaps_.end())
+            parHelperValue = tmp->second->NPV();
+        else if (auto tmp = instruments_.parYoYCaps_.find(k); tmp != instruments_.parYoYCaps_.end())
+            parHelperValue = tmp->second->NPV();
+        Real zeroFactorValue = Null<Real>();
+        if (simMarket->baseScenarioAbsolute()->has(k))
+            zeroFactorValue = simMarket->baseScenarioAbsolute()->get(k);
+        WLOG("zero/par relation problem for key '"
+             << k << "', type " + type + ", par value = "
+             << (parHelperValue == Null<Real>() ? "na" : std::to_string(parHelperValue))
+             << ", zero value = " << (zeroFactorValue == Null<Real>() ? "na" : std::to_string(zeroFactorValue)));
+    }
+
+    if (!cacheFile_.empty())
+        writeParSensitivityCache(cacheFile_, cacheKey_, parBase, rawKeysCheck, parSensi_);
+
+    LOG("Computing par rate and flat vol sensitivities done");
+} // compute par instrument sensis
+
+void ParSensitivityAnalysis::computeShiftScenarioSensitivities(
+    const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket,
+    const ParSensitivityInstrumentBuilder::Instruments& instruments,
+    const std::vector<ShiftScenarioGenerator::ScenarioDescription>& desc, const std::map<RiskFactorKey, Real>& parRatesBase,
+    const std::map<RiskFactorKey, Real>& parCapVols, const Size firstSample, const Size endSample,
+    const std::map<RiskFactorKey, std::vector<std::pair<RiskFactorKey, Real>>>& cachedSensitivities,
+    ParContainer& parSensi, std::set<RiskFactorKey>& rawKeysCheck, std::set<RiskFactorKey>& parKeysNonZero,
+    std::set<RiskFactorKey>& rawKeysNonZero) const {
+
+    for (Size i = firstSample; i < endSample; ++i) {
 
         simMarket->update(asof_);
 
@@ -312,14 +610,23 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
             !(relevantRiskFactors_.empty() || relevantRiskFactors_.find(desc[i].key1()) != relevantRiskFactors_.end()))
             continue;
 
+        // take the sensitivities from the cache, if they can be reused
+
+        if (auto cached = cachedSensitivities.find(desc[i].key1()); cached != cachedSensitivities.end()) {
+            rawKeysCheck.insert(desc[i].key1());
+            for (auto const& [parKey, value] : cached->second)
+                writeSensitivity(parKey, desc[i].key1(), value, parSensi, parKeysNonZero, rawKeysNonZero);
+            continue;
+        }
+
         // Since we are not using ValuationEngine we need to manually perform the trade updates here
         // TODO - explore means of utilising valuation engine
         if (ObservationMode::instance().mode() == ObservationMode::Mode::Disable) {
-            for (auto it : instruments_.parHelpers_)
+            for (auto it : instruments.parHelpers_)
                 it.second->deepUpdate();
-            for (auto it : instruments_.parCaps_)
+            for (auto it : instruments.parCaps_)
                 it.second->deepUpdate();
-            for (auto it : instruments_.parYoYCaps_)
+            for (auto it : instruments.parYoYCaps_)
                 it.second->deepUpdate();
         }
 
@@ -340,7 +647,7 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
             RiskFactorKey::KeyType::SurvivalProbability, RiskFactorKey::KeyType::DiscountCurve,
             RiskFactorKey::KeyType::YieldCurve, RiskFactorKey::KeyType::IndexCurve};
 
-        for (auto const& p : instruments_.parHelpers_) {
+        for (auto const& p : instruments.parHelpers_) {
 
             // skip if par helper has no sensi to zero risk factor (except the special treatment below kicks in)
 
@@ -380,17 +687,17 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
 
             // write sensitivity
 
-            writeSensitivity(p.first, desc[i].key1(), tmp, parSensi_, parKeysNonZero, rawKeysNonZero);
+            writeSensitivity(p.first, desc[i].key1(), tmp, parSensi, parKeysNonZero, rawKeysNonZero);
         }
 
         // process par caps
 
-        for (auto const& p : instruments_.parCaps_) {
+        for (auto const& p : instruments.parCaps_) {
 
             if (p.second->isCalculated() && p.first != desc[i].key1())
                 continue;
 
-            auto fair = impliedVolatility(p.first, instruments_);
+            auto fair = impliedVolatility(p.first, instruments);
             auto base = parCapVols.find(p.first);
             QL_REQUIRE(base != parCapVols.end(), "internal error: did not find parCapVols[" << p.first << "]");
 
@@ -408,17 +715,17 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
 
             // write sensitivity
 
-            writeSensitivity(p.first, desc[i].key1(), tmp, parSensi_, parKeysNonZero, rawKeysNonZero);
+            writeSensitivity(p.first, desc[i].key1(), tmp, parSensi, parKeysNonZero, rawKeysNonZero);
         }
 
         // process par yoy caps
 
-        for (auto const& p : instruments_.parYoYCaps_) {
+        for (auto const& p : instruments.parYoYCaps_) {
 
             if (p.second->isCalculated() && p.first != desc[i].key1())
                 continue;
 
-            auto fair = impliedVolatility(p.first, instruments_);
+            auto fair = impliedVolatility(p.first, instruments);
             auto base = parCapVols.find(p.first);
             QL_REQUIRE(base != parCapVols.end(), "internal error: did not find parCapVols[" << p.first << "]");
 
@@ -436,48 +743,11 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const QuantLib::e
 
             // write sensitivity
 
-            writeSensitivity(p.first, desc[i].key1(), tmp, parSensi_, parKeysNonZero, rawKeysNonZero);
+            writeSensitivity(p.first, desc[i].key1(), tmp, parSensi, parKeysNonZero, rawKeysNonZero);
         }
 
     } // end of loop over samples
-
-    // check for
-    // a) par instruments which have no sensitivity to any of the risk factors
-    // b) risk factors w.r.t. which no par instrument has a sensitivity
-    std::set<RiskFactorKey> parKeysZero, rawKeysZero;
-    std::set_difference(parKeysCheck.begin(), parKeysCheck.end(), parKeysNonZero.begin(), parKeysNonZero.end(),
-                        std::inserter(parKeysZero, parKeysZero.begin()));
-    std::set_difference(rawKeysCheck.begin(), rawKeysCheck.end(), rawKeysNonZero.begin(), rawKeysNonZero.end(),
-                        std::inserter(rawKeysZero, rawKeysZero.begin()));
-    std::set<RiskFactorKey> problematicKeys;
-    problematicKeys.insert(parKeysZero.begin(), parKeysZero.end());
-    problematicKeys.insert(rawKeysZero.begin(), rawKeysZero.end());
-    for (auto const& k : problematicKeys) {
-        std::string type;
-        if (parKeysZero.find(k) != parKeysZero.end())
-            type = "par instrument is insensitive to all zero risk factors";
-        else if (rawKeysZero.find(k) != rawKeysZero.end())
-            type = "zero risk factor that does not affect an par instrument";
-        else
-            type = "unknown";
-        Real parHelperValue = Null<Real>();
-        if (auto tmp = instruments_.parHelpers_.find(k); tmp != instruments_.parHelpers_.end())
-            parHelperValue = impliedQuote(tmp->second);
-        else if (auto tmp = instruments_.parCaps_.find(k); tmp != instruments_.parCaps_.end())
-            parHelperValue = tmp->second->NPV();
-        else if (auto tmp = instruments_.parYoYCaps_.find(k); tmp != instruments_.parYoYCaps_.end())
-            parHelperValue = tmp->second->NPV();
-        Real zeroFactorValue = Null<Real>();
-        if (simMarket->baseScenarioAbsolute()->has(k))
-            zeroFactorValue = simMarket->baseScenarioAbsolute()->get(k);
-        WLOG("zero/par relation problem for key '"
-             << k << "', type " + type + ", par value = "
-             << (parHelperValue == Null<Real>() ? "na" : std::to_string(parHelperValue))
-             << ", zero value = " << (zeroFactorValue == Null<Real>() ? "na" : std::to_string(zeroFactorValue)));
-    }
-
-    LOG("Computing par rate and flat vol sensitivities done");
-} // compute par instrument sensis
+}
 
 void ParSensitivityAnalysis::alignPillars() {
     LOG("Align simulation market pillars to actual latest relevant dates of par instruments");
@@ -805,6 +1075,47 @@ ParSensitivityConverter::convertSensitivity(const boost::numeric::ublas::vector<
     return parSensitivities;
 }
 
+boost::numeric::ublas::matrix<Real>
+ParSensitivityConverter::convertSensitivities(const boost::numeric::ublas::matrix<Real>& zeroSensitivities) const {
+
+    DLOG("Start batched sensitivity conversion for " << zeroSensitivities.size2() << " sensitivity arrays");
+
+    Size dim = zeroSensitivities.size1();
+    Size n = zeroSensitivities.size2();
+    QL_REQUIRE(jacobi_transp_inv_.size1() == dim, "Size mismatch between Transposed Jacobi inverse matrix ["
+                                                      << jacobi_transp_inv_.size1() << " x "
+                                                      << jacobi_transp_inv_.size2() << "] and zero sensitivity matrix ["
+                                                      << dim << " x " << n << "]");
+
+    // approximations for \frac{\partial V}{\partial z_i}, one row per zero factor, one column per array
+    boost::numeric::ublas::matrix<Real> zeroDerivs(dim, n);
+    for (Size i = 0; i < dim; ++i) {
+        for (Size k = 0; k < n; ++k)
+            zeroDerivs(i, k) = zeroSensitivities(i, k) / zeroShifts_[i];
+    }
+
+    // multiply by the conversion matrix, the inner loop runs over the contiguous row entries of both matrices
+    boost::numeric::ublas::matrix<Real> parSensitivities(dim, n, 0.0);
+    for (auto i1 = jacobi_transp_inv_.begin1(); i1 != jacobi_transp_inv_.end1(); ++i1) {
+        for (auto i2 = i1.begin(); i2 != i1.end(); ++i2) {
+            Real v = *i2;
+            Size r = i2.index1(), c = i2.index2();
+            for (Size k = 0; k < n; ++k)
+                parSensitivities(r, k) += v * zeroDerivs(c, k);
+        }
+    }
+
+    // scale to the NPV change due to the configured shift in each of the par factors c_i
+    for (Size i = 0; i < dim; ++i) {
+        for (Size k = 0; k < n; ++k)
+            parSensitivities(i, k) *= parShifts_[i];
+    }
+
+    DLOG("Batched sensitivity conversion done");
+
+    return parSensitivities;
+}
+
 void ParSensitivityConverter::writeConversionMatrix(Report& report) const {
 
     // Report headers
@@ -812,20 +1123,18 @@ void ParSensitivityConverter::writeConversionMatrix(Report& report) const {
     report.addColumn("ParFactor(c)", string());
     report.addColumn("dz/dc", double(), 12);
 
-    // Write report contents i.e. entries where sparse matrix is non-zero
-    Size parIdx = 0;
-    for (const auto& parKey : parKeys_) {
-        Size rawIdx = 0;
-        for (const auto& rawKey : rawKeys_) {
-            if (!close(jacobi_transp_inv_(parIdx, rawIdx), 0.0)) {
+    // Write report contents i.e. entries where sparse matrix is non-zero, we iterate over the stored entries only
+    std::vector<RiskFactorKey> parKeys(parKeys_.begin(), parKeys_.end());
+    std::vector<RiskFactorKey> rawKeys(rawKeys_.begin(), rawKeys_.end());
+    for (auto i1 = jacobi_transp_inv_.begin1(); i1 != jacobi_transp_inv_.end1(); ++i1) {
+        for (auto i2 = i1.begin(); i2 != i1.end(); ++i2) {
+            if (!close(*i2, 0.0)) {
                 report.next();
-                report.add(to_string(rawKey));
-                report.add(to_string(parKey));
-                report.add(jacobi_transp_inv_(parIdx, rawIdx));
+                report.add(to_string(rawKeys[i2.index2()]));
+                report.add(to_string(parKeys[i2.index1()]));
+                report.add(*i2);
             }
-            rawIdx++;
         }
-        parIdx++;
     }
 
     // Close report
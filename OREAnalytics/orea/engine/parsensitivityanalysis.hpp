@@ -30,13 +30,19 @@
 #include <orea/scenario/scenariosimmarketparameters.hpp>
 #include <orea/scenario/sensitivityscenariodata.hpp>
 #include <orea/scenario/sensitivityscenariogenerator.hpp>
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/configuration/iborfallbackconfig.hpp>
+#include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/market.hpp>
+#include <ored/marketdata/todaysmarketparameters.hpp>
+#include <ored/portfolio/referencedata.hpp>
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/report/report.hpp>
 
 #include <ql/instruments/inflationcapfloor.hpp>
 #include <ql/math/matrixutilities/sparsematrix.hpp>
 
+#include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 
 #include <map>
@@ -71,6 +77,18 @@ public:
     //! Compute par instrument sensitivities
     void computeParInstrumentSensitivities(const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket);
 
+    /*! Compute par instrument sensitivities using \p nThreads threads. The base par rates are computed on the given sim
+        market, the shift scenarios of its scenario generator are split into blocks which are processed by worker threads
+        on their own todays market, sim market and par instruments built from the \p loader. If \p nThreads is 1 or no
+        loader is given, this is equivalent to the single-threaded computation. */
+    void computeParInstrumentSensitivities(
+        const Size nThreads, const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket,
+        const QuantLib::ext::shared_ptr<ore::data::Loader>& loader,
+        const QuantLib::ext::shared_ptr<ore::data::CurveConfigurations>& curveConfigs,
+        const QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>& todaysMarketParams,
+        const QuantLib::ext::shared_ptr<ore::data::ReferenceDataManager>& referenceData = nullptr,
+        const ore::data::IborFallbackConfig& iborFallbackConfig = ore::data::IborFallbackConfig::defaultConfig());
+
     //! Return computed par sensitivities. Empty if they have not been computed yet.
     const ParContainer& parSensitivities() const { return parSensi_; }
 
@@ -99,10 +117,30 @@ public:
 
     const ParSensitivityInstrumentBuilder::Instruments& parInstruments() const { return instruments_; }
 
+    /*! Cache the par sensitivities across runs in \p fileName. If the file was written by a previous run with the same
+        \p cacheKey, the cached sensitivities w.r.t. a zero risk factor are reused without revaluing its shift scenario,
+        provided the base par rates / flat vols of its risk factor group (key type and name) and of the groups of all
+        par instruments sensitive to it moved by at most \p tolerance (absolute) since that run. The file is rewritten
+        after each computation. The key should identify the configuration, see parSensitivityCacheKey(). */
+    void setCache(const std::string& fileName, const std::string& cacheKey, const QuantLib::Real tolerance = 1E-6);
+
 private:
     //! Augment relevant risk factors
     void augmentRelevantRiskFactors();
 
+    //! Compute the par sensitivities w.r.t. the shift scenarios [firstSample, endSample) applied to \p simMarket
+    void computeShiftScenarioSensitivities(
+        const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket,
+        const ParSensitivityInstrumentBuilder::Instruments& instruments,
+        const std::vector<ShiftScenarioGenerator::ScenarioDescription>& desc,
+        const std::map<ore::analytics::RiskFactorKey, Real>& parRatesBase,
+        const std::map<ore::analytics::RiskFactorKey, Real>& parCapVols, const Size firstSample, const Size endSample,
+        const std::map<ore::analytics::RiskFactorKey,
+                       std::vector<std::pair<ore::analytics::RiskFactorKey, QuantLib::Real>>>& cachedSensitivities,
+        ParContainer& parSensi, std::set<ore::analytics::RiskFactorKey>& rawKeysCheck,
+        std::set<ore::analytics::RiskFactorKey>& parKeysNonZero,
+        std::set<ore::analytics::RiskFactorKey>& rawKeysNonZero) const;
+
     //! Populate `shiftSizes_` for \p key given the implied fair par rate \p parRate
     void populateShiftSizes(const ore::analytics::RiskFactorKey& key, QuantLib::Real parRate,
                             const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket);
@@ -137,8 +175,19 @@ private:
         by the configured relative zero rate shift size to give the par rate absolute shift size.
     */
     std::map<ore::analytics::RiskFactorKey, std::pair<QuantLib::Real, QuantLib::Real>> shiftSizes_;
+
+    //! Par sensitivity cache, see setCache()
+    std::string cacheFile_, cacheKey_;
+    QuantLib::Real cacheTolerance_ = 1E-6;
 };
 
+//! Key for the par sensitivity cache identifying the as of date and the configuration, see ParSensitivityAnalysis::setCache()
+std::string parSensitivityCacheKey(const QuantLib::Date& asof,
+                                   const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& simMarketParams,
+                                   const ore::analytics::SensitivityScenarioData& sensitivityData,
+                                   const QuantLib::ext::shared_ptr<ore::data::CurveConfigurations>& curveConfigs,
+                                   const QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>& todaysMarketParams);
+
 //! ParSensitivityConverter class
 /*!
   1) Build Jacobi matrix containing sensitivities of par rates (first index) w.r.t. zero shifts (second index)
@@ -200,6 +249,17 @@ public:
     boost::numeric::ublas::vector<Real>
     convertSensitivity(const boost::numeric::ublas::vector<Real>& zeroSensitivities);
 
+    //! Batched version of convertSensitivity()
+    /*! \param  zeroSensitivities matrix whose columns are the zero sensitivity arrays of several trades, with rows
+                                  ordered according to rawKeys()
+
+        \return matrix whose columns are the corresponding par sensitivity arrays, rows ordered according to parKeys()
+
+        The non-zero entries of the conversion matrix are traversed once for all trades.
+    */
+    boost::numeric::ublas::matrix<Real>
+    convertSensitivities(const boost::numeric::ublas::matrix<Real>& zeroSensitivities) const;
+
     //! Write the inverse of the transposed Jacobian to the \p reportOut
     void writeConversionMatrix(ore::data::Report& reportOut) const;
 
@@ -27,10 +27,15 @@ using ore::analytics::SensitivityRecord;
 namespace ore {
 namespace analytics {
 
+namespace {
+// number of trades per thread whose par deltas are converted in one batch
+constexpr Size parDeltasBatchSize = 100;
+} // namespace
+
 // Note: iterator initialisation below works because currentDeltas_ is
 //       (empty) initialised before itCurrent_
 ParSensitivityCubeStream::ParSensitivityCubeStream(const QuantLib::ext::shared_ptr<ZeroToParCube>& cube, const string& currency)
-    : zeroCubeIdx_(0), cube_(cube), currency_(currency), itCurrent_(currentDeltas_.begin()) {
+    : zeroCubeIdx_(0), cube_(cube), currency_(currency), itCurrent_(currentDeltas_.begin()), batchPos_(0) {
     QL_REQUIRE(!cube_->zeroCubes().empty(), "ParSensitivityCubeStream: cube contains no zero cubes");
     tradeIdx_ = cube_->zeroCubes().front()->tradeIdx().begin();
     init();
@@ -45,10 +50,7 @@ SensitivityRecord ParSensitivityCubeStream::next() {
         tradeIdx_++;
         // update par deltas
         if (tradeIdx_ != cube_->zeroCubes()[zeroCubeIdx_]->tradeIdx().end()) {
-            DLOG("Retrieving par deltas for trade " << tradeIdx_->first);
-            currentDeltas_ = cube_->parDeltas(zeroCubeIdx_, tradeIdx_->second);
-            itCurrent_ = currentDeltas_.begin();
-            DLOG("There are " << currentDeltas_.size() << " par deltas for trade " << tradeIdx_->first);
+            loadDeltas();
         }
     }
 
@@ -84,20 +86,39 @@ void ParSensitivityCubeStream::reset() {
     tradeIdx_ = cube_->zeroCubes()[zeroCubeIdx_]->tradeIdx().begin();
     currentDeltas_ = {};
     itCurrent_ = currentDeltas_.begin();
+    batchDeltas_.clear();
+    batchPos_ = 0;
     // Call init
     init();
 }
 
 void ParSensitivityCubeStream::init() {
+    // the batch belongs to the previous zero cube, if any
+    batchDeltas_.clear();
+    batchPos_ = 0;
     // If we have trade IDs in the underlying cube
     if (!cube_->zeroCubes()[zeroCubeIdx_]->tradeIdx().empty()) {
         tradeIdx_ = cube_->zeroCubes()[zeroCubeIdx_]->tradeIdx().begin();
-        DLOG("Retrieving par deltas for trade " << tradeIdx_->first);
-        currentDeltas_ = cube_->parDeltas(zeroCubeIdx_, tradeIdx_->second);
-        itCurrent_ = currentDeltas_.begin();
-        DLOG("There are " << currentDeltas_.size() << " par deltas for trade " << tradeIdx_->first);
+        loadDeltas();
     }
 }
 
+void ParSensitivityCubeStream::loadDeltas() {
+    // the trades are visited in order, so the batch is consumed trade by trade starting from its first trade
+    if (batchPos_ >= batchDeltas_.size()) {
+        std::vector<Size> tradeIndices;
+        for (auto it = tradeIdx_; it != cube_->zeroCubes()[zeroCubeIdx_]->tradeIdx().end() &&
+                                  tradeIndices.size() < parDeltasBatchSize * cube_->nThreads();
+             ++it)
+            tradeIndices.push_back(it->second);
+        DLOG("Retrieving par deltas for " << tradeIndices.size() << " trades starting with " << tradeIdx_->first);
+        batchDeltas_ = cube_->parDeltas(zeroCubeIdx_, tradeIndices);
+        batchPos_ = 0;
+    }
+    currentDeltas_ = std::move(batchDeltas_[batchPos_++]);
+    itCurrent_ = currentDeltas_.begin();
+    DLOG("There are " << currentDeltas_.size() << " par deltas for trade " << tradeIdx_->first);
+}
+
 } // namespace analytics
 } // namespace ore
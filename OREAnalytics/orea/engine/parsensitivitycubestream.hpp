@@ -26,6 +26,7 @@
 #include <orea/engine/zerotoparcube.hpp>
 
 #include <string>
+#include <vector>
 
 namespace ore {
 namespace analytics {
@@ -59,9 +60,15 @@ private:
     std::map<ore::analytics::RiskFactorKey, QuantLib::Real> currentDeltas_;
     //! Iterator to current delta
     std::map<ore::analytics::RiskFactorKey, QuantLib::Real>::iterator itCurrent_;
+    //! Par deltas for a batch of trades starting at the current trade, converted in one go
+    std::vector<std::map<ore::analytics::RiskFactorKey, QuantLib::Real>> batchDeltas_;
+    //! Position of the current trade in the batch
+    QuantLib::Size batchPos_;
 
     //! Shared initialisation
     void init();
+    //! Set the par deltas for the current trade, converting the next batch of trades if required
+    void loadDeltas();
 };
 
 } // namespace analytics
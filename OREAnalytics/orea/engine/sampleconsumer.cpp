@@ -0,0 +1,93 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/sampleconsumer.hpp>
+
+#include <ql/errors.hpp>
+
+namespace ore {
+namespace analytics {
+
+AsyncSampleConsumer::AsyncSampleConsumer(const QuantLib::ext::shared_ptr<SampleConsumer>& consumer)
+    : consumer_(consumer) {
+    QL_REQUIRE(consumer_, "AsyncSampleConsumer: no consumer given");
+    thread_ = std::thread([this]() { run(); });
+}
+
+AsyncSampleConsumer::~AsyncSampleConsumer() { stop(); }
+
+bool AsyncSampleConsumer::consume(const QuantLib::ext::shared_ptr<NPVCube>& cube, QuantLib::Size begin,
+                                  QuantLib::Size end) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (continue_ && !error_)
+        blocks_.push_back({cube, begin, end});
+    cv_.notify_all();
+    return continue_ && !error_;
+}
+
+void AsyncSampleConsumer::finish() {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return (blocks_.empty() && !busy_) || error_; });
+        if (error_)
+            std::rethrow_exception(error_);
+    }
+    consumer_->finish();
+}
+
+void AsyncSampleConsumer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void AsyncSampleConsumer::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this]() { return !blocks_.empty() || stopped_; });
+        if (stopped_)
+            return;
+        Block block = blocks_.front();
+        blocks_.pop_front();
+        busy_ = true;
+        lock.unlock();
+        bool cont = true;
+        std::exception_ptr error;
+        try {
+            cont = consumer_->consume(block.cube, block.begin, block.end);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+        busy_ = false;
+        if (error)
+            error_ = error;
+        if (!cont || error_) {
+            continue_ = continue_ && cont;
+            blocks_.clear();
+        }
+        cv_.notify_all();
+    }
+}
+
+} // namespace analytics
+} // namespace ore
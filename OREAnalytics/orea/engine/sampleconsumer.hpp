@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/engine/sampleconsumer.hpp
+    \brief consumers of the samples completed by a valuation engine
+    \ingroup simulation
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace ore {
+namespace analytics {
+
+//! Consumer of the samples completed by the ValuationEngine
+/*! The engine calls consume() with the samples [begin, end) after all their values are written to the cube, see
+    ValuationEngine::registerSampleConsumer(). This allows to aggregate results while the simulation is running and
+    to stop the simulation early, e.g. when the exposures have converged.
+
+    \ingroup simulation
+*/
+class SampleConsumer {
+public:
+    virtual ~SampleConsumer() {}
+    //! Process the samples [begin, end) of the cube, return false to stop the simulation
+    virtual bool consume(const QuantLib::ext::shared_ptr<NPVCube>& cube, QuantLib::Size begin,
+                         QuantLib::Size end) = 0;
+    //! Called by the engine after the last call of consume()
+    virtual void finish() {}
+};
+
+//! Runs another consumer in a background thread, so that the consumption overlaps with the simulation
+/*! consume() queues the samples and returns immediately, the result is the last decision of the wrapped consumer,
+    i.e. the simulation stops a few blocks after the wrapped consumer asks for it. finish() waits until all queued
+    samples are consumed and rethrows an exception thrown by the wrapped consumer.
+
+    The wrapped consumer reads the completed samples while the engine writes later samples. This is safe for cubes
+    that store the samples in separate memory, like the in-memory cubes, but not e.g. for the SparseNpvCube. The
+    wrapped consumer must not depend on thread local singletons like the evaluation date.
+
+    \ingroup simulation
+*/
+class AsyncSampleConsumer : public SampleConsumer {
+public:
+    explicit AsyncSampleConsumer(const QuantLib::ext::shared_ptr<SampleConsumer>& consumer);
+    ~AsyncSampleConsumer() override;
+
+    bool consume(const QuantLib::ext::shared_ptr<NPVCube>& cube, QuantLib::Size begin, QuantLib::Size end) override;
+    void finish() override;
+
+private:
+    struct Block {
+        QuantLib::ext::shared_ptr<NPVCube> cube;
+        QuantLib::Size begin, end;
+    };
+    void run();
+    void stop();
+
+    QuantLib::ext::shared_ptr<SampleConsumer> consumer_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Block> blocks_;
+    bool busy_ = false, continue_ = true, stopped_ = false;
+    std::exception_ptr error_;
+    std::thread thread_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -54,28 +54,69 @@ void SensitivityAggregator::aggregate(SensitivityStream& ss, const QuantLib::ext
     ss.reset();
 
     // Loop over stream's records
-    while (SensitivityRecord sr = ss.next()) {
-        // Skip this record if the risk factor is not in the filter
-        if (!sr.isCrossGamma() && !filter->allow(sr.key_1))
-            continue;
-        if (sr.isCrossGamma() && (!filter->allow(sr.key_1) || !filter->allow(sr.key_2)))
-            continue;
-
-        // "Blank out" trade ID before adding
-        string tradeId = sr.tradeId;
-        sr.tradeId = "";
-
-        // Update aggRecords_ for each category
-        for (const auto& kv : categories_) {
-            // Check if the sensitivity record's trade ID is in the category
-            if (kv.second(tradeId)) {
-                DLOG("Updating aggregated sensitivities for category " << kv.first << " with record: " << sr);
-                add(sr, aggRecords_[kv.first]);
+    std::vector<SensitivityRecord> block;
+    while (ss.nextBlock(block, SensitivityStream::defaultBlockSize) > 0) {
+        for (auto& sr : block) {
+            // Skip this record if the risk factor is not in the filter
+            if (!sr.isCrossGamma() && !filter->allow(sr.key_1))
+                continue;
+            if (sr.isCrossGamma() && (!filter->allow(sr.key_1) || !filter->allow(sr.key_2)))
+                continue;
+
+            // "Blank out" trade ID before adding
+            string tradeId = sr.tradeId;
+            sr.tradeId = "";
+
+            // Update aggRecords_ for each category
+            for (const auto& kv : categories_) {
+                // Check if the sensitivity record's trade ID is in the category
+                if (kv.second(tradeId)) {
+                    DLOG("Updating aggregated sensitivities for category " << kv.first << " with record: " << sr);
+                    add(sr, aggRecords_[kv.first]);
+                }
             }
         }
     }
 }
 
+void SensitivityAggregator::aggregate(const SensitivityColumns& columns,
+                                      const QuantLib::ext::shared_ptr<ScenarioFilter>& filter) {
+
+    // Evaluate the filter once per risk factor
+    std::vector<bool> factorAllowed(columns.factors().size());
+    for (Size f = 0; f < columns.factors().size(); ++f)
+        factorAllowed[f] = filter->allow(columns.factors()[f]);
+
+    // Evaluate the categories once per trade
+    std::vector<string> categoryNames;
+    for (const auto& kv : categories_)
+        categoryNames.push_back(kv.first);
+    std::vector<std::vector<Size>> tradeGroups(columns.tradeIds().size());
+    for (Size t = 0; t < columns.tradeIds().size(); ++t) {
+        Size c = 0;
+        for (const auto& kv : categories_) {
+            if (kv.second(columns.tradeIds()[t]))
+                tradeGroups[t].push_back(c);
+            ++c;
+        }
+    }
+
+    // Sum by category and risk factor(s) and update aggRecords_
+    std::vector<SensitivityColumns::Sums> sums = columns.aggregate(tradeGroups, categoryNames.size(), factorAllowed);
+    for (Size c = 0; c < sums.size(); ++c) {
+        std::set<SensitivityRecord>& records = aggRecords_[categoryNames[c]];
+        for (Size j = 0; j < sums[c].factors.size(); ++j) {
+            SensitivityRecord sr = columns.record(sums[c].firstRow[j]);
+            sr.tradeId = "";
+            sr.baseNpv = sums[c].baseNpv[j];
+            sr.delta = sums[c].delta[j];
+            sr.gamma = sums[c].gamma[j];
+            DLOG("Updating aggregated sensitivities for category " << categoryNames[c] << " with record: " << sr);
+            add(sr, records);
+        }
+    }
+}
+
 void SensitivityAggregator::reset() {
     // Clear the aggregated sensitivities
     aggRecords_.clear();
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <orea/engine/sensitivitycolumns.hpp>
 #include <orea/engine/sensitivitystream.hpp>
 #include <orea/scenario/scenariosimmarket.hpp>
 
@@ -63,6 +64,13 @@ public:
     void aggregate(SensitivityStream& ss, const QuantLib::ext::shared_ptr<ScenarioFilter>& filter =
                                               QuantLib::ext::make_shared<ScenarioFilter>());
 
+    /*! Update the aggregator with the records held in \p columns after applying the optional filter. Gives the same
+        result as aggregating a stream with the same records, but the filter is evaluated once per risk factor and the
+        categories once per trade, the records are then summed per category in a single pass over the columns.
+    */
+    void aggregate(const SensitivityColumns& columns, const QuantLib::ext::shared_ptr<ScenarioFilter>& filter =
+                                                          QuantLib::ext::make_shared<ScenarioFilter>());
+
     //! Reset the aggregator to it's initial state by clearing all aggregations
     void reset();
 
@@ -20,6 +20,7 @@
 #include <orea/cube/sensicube.hpp>
 #include <orea/engine/multithreadedvaluationengine.hpp>
 #include <orea/engine/sensitivityanalysis.hpp>
+#include <orea/engine/sensitivityenginecg.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 #include <orea/engine/valuationengine.hpp>
 #include <orea/scenario/clonescenariofactory.hpp>
@@ -102,6 +103,49 @@ splitPortfolioByScenarioGenerators(
 }
 } // namespace
 
+QuantLib::ext::shared_ptr<Portfolio> SensitivityAnalysis::computeAadDeltas(
+    const QuantLib::ext::shared_ptr<Portfolio>& portfolio, const QuantLib::ext::shared_ptr<EngineData>& engineData,
+    const QuantLib::ext::shared_ptr<EngineFactory>& engineFactory,
+    std::map<std::string, std::pair<Real, std::map<RiskFactorKey, Real>>>& results) const {
+    results.clear();
+    if (!useAadDeltas_ || dryRun_)
+        return portfolio;
+    if (sensitivityData_->useSpreadedTermStructures() || nonShiftedBaseCurrencyConversion_) {
+        WLOG("SensitivityAnalysis: aad deltas not supported with spreaded term structures or non-shifted base ccy "
+             "conversion, use bump and revalue for all trades.");
+        return portfolio;
+    }
+    SensitivityEngineCG engine(simMarket_, simMarketData_, engineData);
+    auto remaining = QuantLib::ext::make_shared<Portfolio>();
+    for (auto const& [id, t] : portfolio->trades()) {
+        bool done = false;
+        if (SensitivityEngineCG::isCandidate(t)) {
+            try {
+                if (engineFactory) {
+                    t->reset();
+                    t->build(engineFactory);
+                }
+                Real npv;
+                std::map<RiskFactorKey, Real> derivatives;
+                if (engine.computeDerivatives(t, npv, derivatives)) {
+                    results[id] = std::make_pair(npv, std::move(derivatives));
+                    done = true;
+                }
+            } catch (const std::exception& e) {
+                DLOG("SensitivityAnalysis: could not build trade " << id << " for aad deltas (" << e.what()
+                                                                   << "), will use bump and revalue.");
+            }
+        }
+        if (!done)
+            remaining->add(t);
+    }
+    LOG("SensitivityAnalysis: computed aad deltas for " << results.size() << " out of " << portfolio->size()
+                                                        << " trades.");
+    if (!results.empty() && sensitivityData_->computeGamma())
+        WLOG("SensitivityAnalysis: gamma and cross gamma are zero for trades with aad deltas.");
+    return remaining;
+}
+
 void SensitivityAnalysis::generateSensitivities() {
 
     LOG("Sensitivity analysis started...");
@@ -156,47 +200,28 @@ void SensitivityAnalysis::generateSensitivities() {
         }
         scenarioGenerator_ = scenarioGenerators.front();
 
-        map<MarketContext, string> configurations;
-        configurations[MarketContext::pricing] = marketConfiguration_;
         auto ed = QuantLib::ext::make_shared<EngineData>(*engineData_);
         ed->globalParameters()["RunType"] =
             std::string("Sensitivity") + (sensitivityData_->computeGamma() ? "DeltaGamma" : "Delta");
 
-        QuantLib::ext::shared_ptr<DateGrid> dg = QuantLib::ext::make_shared<DateGrid>("1,0W", NullCalendar());
-        vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators;
-        if (nonShiftedBaseCurrencyConversion_)
-            // use "original" FX rates to convert sensi to base currency
-            calculators.push_back(QuantLib::ext::make_shared<NPVCalculatorFXT0>(simMarketData_->baseCcy(), market_));
-        else
-            // use the scenario FX rate when converting sensi to base currency
-            calculators.push_back(QuantLib::ext::make_shared<NPVCalculator>(simMarketData_->baseCcy()));
-
         sensiCubes_.clear();
+        sensiCubeGenerators_.clear();
+        Size generatorIndex = 0;
         for (auto const& [pf, scenGen] :
              splitPortfolioByScenarioGenerators(portfolio_, sensiTemplateIds, scenarioGenerators)) {
+            ++generatorIndex;
             if (pf->trades().empty())
                 continue;
             LOG("Run Sensitivity Scenarios for " << pf->size() << " out of " << portfolio_->size() << " trades.");
-            QuantLib::ext::shared_ptr<NPVSensiCube> cube =
-                QuantLib::ext::make_shared<DoublePrecisionSensiCube>(pf->ids(), asof_, scenGen->samples());
-            simMarket_->scenarioGenerator() = scenGen;
-            auto factory =
-                QuantLib::ext::make_shared<EngineFactory>(ed, simMarket_, configurations, referenceData_, iborFallbackConfig_);
-            pf->reset();
-            pf->build(factory, "sensi analysis");
-            if (recalibrateModels_)
-                modelBuilders_ = factory->modelBuilders();
-            else
-                modelBuilders_.clear();
-            ValuationEngine engine(asof_, dg, simMarket_, modelBuilders_);
-            for (auto const& i : this->progressIndicators())
-                engine.registerProgressIndicator(i);
-            engine.buildCube(pf, cube, calculators, true, nullptr, nullptr, {}, dryRun_);
-
-            sensiCubes_.push_back(QuantLib::ext::make_shared<SensitivityCube>(cube, scenGen->scenarioDescriptions(),
-                                                                      scenarioGenerator_->shiftSizes(),
-                                                                      scenGen->shiftSizes(), scenGen->shiftSchemes()));
+            sensiCubes_.push_back(QuantLib::ext::make_shared<SensitivityCube>(
+                buildSingleThreadedCube(pf, scenGen, ed), scenGen->scenarioDescriptions(),
+                scenarioGenerator_->shiftSizes(), scenGen->shiftSizes(), scenGen->shiftSchemes()));
+            sensiCubeGenerators_.push_back(generatorIndex - 1);
         }
+
+        sensiTemplateIds_ = sensiTemplateIds;
+        scenarioGenerators_ = scenarioGenerators;
+        sensiEngineData_ = ed;
     } else {
 
         // handle request to use multi-threaded engine
@@ -229,10 +254,40 @@ void SensitivityAnalysis::generateSensitivities() {
             std::string("Sensitivity") + (sensitivityData_->computeGamma() ? "DeltaGamma" : "Delta");
 
         sensiCubes_.clear();
+        sensiCubeGenerators_.clear();
+        sensiTemplateIds_ = sensiTemplateIds;
+        scenarioGenerators_ = scenarioGenerators;
+        sensiEngineData_ = ed;
+        Size generatorIndex = 0;
         for (auto const& [pf, scenGen] :
              splitPortfolioByScenarioGenerators(portfolio_, sensiTemplateIds, scenarioGenerators)) {
+            ++generatorIndex;
             if (pf->trades().empty())
                 continue;
+            sensiCubeGenerators_.push_back(generatorIndex - 1);
+
+            std::map<std::string, std::pair<Real, std::map<RiskFactorKey, Real>>> aadResults;
+            std::vector<QuantLib::ext::shared_ptr<NPVSensiCube>> cubes;
+            auto bumpPf = pf;
+            if (useAadDeltas_) {
+                auto factory = QuantLib::ext::make_shared<EngineFactory>(
+                    ed, simMarket_, map<MarketContext, string>{{MarketContext::pricing, marketConfiguration_}},
+                    referenceData_, iborFallbackConfig_);
+                bumpPf = computeAadDeltas(pf, ed, factory, aadResults);
+            }
+            if (!aadResults.empty()) {
+                std::set<std::string> aadIds;
+                for (auto const& [id, _] : aadResults)
+                    aadIds.insert(id);
+                cubes.push_back(QuantLib::ext::make_shared<DoublePrecisionSensiCube>(aadIds, asof_, scenGen->samples()));
+                SensitivityEngineCG(simMarket_, simMarketData_, ed).buildCube(aadResults, cubes.back(), scenGen);
+            }
+            if (bumpPf->trades().empty()) {
+                sensiCubes_.push_back(QuantLib::ext::make_shared<SensitivityCube>(
+                    cubes.front(), scenGen->scenarioDescriptions(), scenarioGenerator_->shiftSizes(),
+                    scenGen->shiftSizes(), scenGen->shiftSchemes()));
+                continue;
+            }
 
             MultiThreadedValuationEngine engine(
                 nThreads_, asof_, QuantLib::ext::make_shared<ore::analytics::DateGrid>(), scenGen->numScenarios(), loader_,
@@ -250,19 +305,18 @@ void SensitivityAnalysis::generateSensitivities() {
 
             auto baseCcy = simMarketData_->baseCcy();
             engine.buildCube(
-                pf,
+                bumpPf,
                 [&baseCcy]() -> std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> {
                     return {QuantLib::ext::make_shared<NPVCalculator>(baseCcy)};
                 },
                 {}, true, dryRun_);
-            std::vector<QuantLib::ext::shared_ptr<NPVSensiCube>> miniCubes;
             for (auto const& c : engine.outputCubes()) {
-                miniCubes.push_back(QuantLib::ext::dynamic_pointer_cast<NPVSensiCube>(c));
+                cubes.push_back(QuantLib::ext::dynamic_pointer_cast<NPVSensiCube>(c));
                 QL_REQUIRE(
-                    miniCubes.back() != nullptr,
+                    cubes.back() != nullptr,
                     "SensitivityAnalysis::generateSensitivities(): internal error, could not cast to NPVSensiCube.");
             }
-            auto cube = QuantLib::ext::make_shared<JointNPVSensiCube>(miniCubes, pf->ids());
+            auto cube = QuantLib::ext::make_shared<JointNPVSensiCube>(cubes, pf->ids());
 
             sensiCubes_.push_back(QuantLib::ext::make_shared<SensitivityCube>(cube, scenGen->scenarioDescriptions(),
                                                                       scenarioGenerator_->shiftSizes(),
@@ -275,6 +329,148 @@ void SensitivityAnalysis::generateSensitivities() {
     LOG("Sensitivity analysis completed");
 }
 
+QuantLib::ext::shared_ptr<NPVSensiCube>
+SensitivityAnalysis::buildSingleThreadedCube(const QuantLib::ext::shared_ptr<Portfolio>& pf,
+                                             const QuantLib::ext::shared_ptr<SensitivityScenarioGenerator>& scenGen,
+                                             const QuantLib::ext::shared_ptr<EngineData>& ed) {
+    map<MarketContext, string> configurations;
+    configurations[MarketContext::pricing] = marketConfiguration_;
+
+    QuantLib::ext::shared_ptr<DateGrid> dg = QuantLib::ext::make_shared<DateGrid>("1,0W", NullCalendar());
+    vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators;
+    if (nonShiftedBaseCurrencyConversion_)
+        // use "original" FX rates to convert sensi to base currency
+        calculators.push_back(QuantLib::ext::make_shared<NPVCalculatorFXT0>(simMarketData_->baseCcy(), market_));
+    else
+        // use the scenario FX rate when converting sensi to base currency
+        calculators.push_back(QuantLib::ext::make_shared<NPVCalculator>(simMarketData_->baseCcy()));
+
+    simMarket_->scenarioGenerator() = scenGen;
+    auto factory =
+        QuantLib::ext::make_shared<EngineFactory>(ed, simMarket_, configurations, referenceData_, iborFallbackConfig_);
+    pf->reset();
+    pf->build(factory, "sensi analysis");
+    if (recalibrateModels_)
+        modelBuilders_ = factory->modelBuilders();
+    else
+        modelBuilders_.clear();
+    std::map<std::string, std::pair<Real, std::map<RiskFactorKey, Real>>> aadResults;
+    auto bumpPf = computeAadDeltas(pf, ed, nullptr, aadResults);
+    std::vector<QuantLib::ext::shared_ptr<NPVSensiCube>> cubes;
+    if (!bumpPf->trades().empty()) {
+        cubes.push_back(QuantLib::ext::make_shared<DoublePrecisionSensiCube>(bumpPf->ids(), asof_, scenGen->samples()));
+        ValuationEngine engine(asof_, dg, simMarket_, modelBuilders_);
+        engine.setSkipUnaffectedTrades(skipUnaffectedTrades_);
+        for (auto const& i : this->progressIndicators())
+            engine.registerProgressIndicator(i);
+        engine.buildCube(bumpPf, cubes.back(), calculators, true, nullptr, nullptr, {}, dryRun_);
+    }
+    if (!aadResults.empty()) {
+        std::set<std::string> aadIds;
+        for (auto const& [id, _] : aadResults)
+            aadIds.insert(id);
+        cubes.push_back(QuantLib::ext::make_shared<DoublePrecisionSensiCube>(aadIds, asof_, scenGen->samples()));
+        SensitivityEngineCG(simMarket_, simMarketData_, ed).buildCube(aadResults, cubes.back(), scenGen);
+    }
+    return cubes.size() == 1 ? cubes.front() : QuantLib::ext::make_shared<JointNPVSensiCube>(cubes, pf->ids());
+}
+
+void SensitivityAnalysis::updateSensitivities(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
+                                              const std::set<std::string>& changedTradeIds) {
+
+    LOG("Incremental sensitivity analysis started...");
+
+    QL_REQUIRE(simMarket_ && !scenarioGenerators_.empty(),
+               "SensitivityAnalysis::updateSensitivities(): generateSensitivities() must be called first");
+
+    // split the changed trades by sensi template, a template that was not used in the previous run requires a full
+    // run, since it needs a new scenario generator
+
+    std::set<std::string> sensiTemplateIdsFromSensiConfig = getShiftSpecKeys(*sensitivityData_);
+    std::vector<std::string> changedIds;
+    for (auto const& id : changedTradeIds) {
+        if (!portfolio->has(id))
+            continue;
+        auto const& t = portfolio->get(id);
+        QL_REQUIRE(!sensiTemplateIdsFromSensiConfig.count(t->sensitivityTemplate()) ||
+                       std::find(sensiTemplateIds_.begin(), sensiTemplateIds_.end(), t->sensitivityTemplate()) !=
+                           sensiTemplateIds_.end(),
+                   "SensitivityAnalysis::updateSensitivities(): trade '"
+                       << id << "' uses sensi template '" << t->sensitivityTemplate()
+                       << "' which was not used in the previous run, call generateSensitivities() instead");
+        changedIds.push_back(id);
+    }
+    auto changedPf = QuantLib::ext::make_shared<Portfolio>();
+    for (auto const& id : changedIds)
+        changedPf->add(portfolio->get(id));
+    auto changedPfs = splitPortfolioByScenarioGenerators(changedPf, sensiTemplateIds_, scenarioGenerators_);
+
+    // previous cube per scenario generator
+
+    std::vector<QuantLib::ext::shared_ptr<SensitivityCube>> previousCubes(scenarioGenerators_.size());
+    for (Size i = 0; i < sensiCubes_.size(); ++i)
+        previousCubes[sensiCubeGenerators_[i]] = sensiCubes_[i];
+
+    std::vector<QuantLib::ext::shared_ptr<SensitivityCube>> newCubes;
+    std::vector<Size> newCubeGenerators;
+    Size keptTrades = 0;
+    for (Size g = 0; g < scenarioGenerators_.size(); ++g) {
+        auto const& scenGen = scenarioGenerators_[g];
+        std::vector<QuantLib::ext::shared_ptr<NPVSensiCube>> cubes;
+
+        // the unchanged trades of the previous run which are still in the portfolio keep their results
+
+        if (previousCubes[g]) {
+            auto const& previous = previousCubes[g]->npvCube();
+            std::set<std::string> keptIds;
+            for (auto const& [id, _] : previous->idsAndIndexes()) {
+                if (portfolio->has(id) && changedTradeIds.count(id) == 0)
+                    keptIds.insert(id);
+            }
+            if (!keptIds.empty()) {
+                auto kept = QuantLib::ext::make_shared<DoublePrecisionSensiCube>(keptIds, asof_, previous->samples());
+                for (auto const& [id, pos] : kept->idsAndIndexes()) {
+                    Size idx = previous->idsAndIndexes().at(id);
+                    kept->setT0(previous->getT0(idx), pos);
+                    for (auto const& [sample, npv] : previous->getTradeNPVs(idx))
+                        kept->set(npv, pos, 0, sample);
+                }
+                cubes.push_back(kept);
+                keptTrades += keptIds.size();
+            }
+        }
+
+        // the changed trades are revalued on the existing sim market
+
+        auto const& pf = changedPfs[g].first;
+        if (!pf->trades().empty()) {
+            LOG("Run Sensitivity Scenarios for " << pf->size() << " changed trades.");
+            cubes.push_back(buildSingleThreadedCube(pf, scenGen, sensiEngineData_));
+        }
+
+        if (cubes.empty())
+            continue;
+        std::set<std::string> ids;
+        for (auto const& c : cubes)
+            for (auto const& [id, _] : c->idsAndIndexes())
+                ids.insert(id);
+        QuantLib::ext::shared_ptr<NPVSensiCube> cube =
+            cubes.size() == 1 ? cubes.front() : QuantLib::ext::make_shared<JointNPVSensiCube>(cubes, ids);
+        newCubes.push_back(QuantLib::ext::make_shared<SensitivityCube>(cube, scenGen->scenarioDescriptions(),
+                                                                       scenarioGenerator_->shiftSizes(),
+                                                                       scenGen->shiftSizes(), scenGen->shiftSchemes()));
+        newCubeGenerators.push_back(g);
+    }
+
+    sensiCubes_ = newCubes;
+    sensiCubeGenerators_ = newCubeGenerators;
+    portfolio_ = portfolio;
+    simMarket_->scenarioGenerator() = scenarioGenerator_;
+
+    LOG("Incremental sensitivity analysis completed, revalued " << changedIds.size() << " trades, kept the results of "
+                                                              << keptTrades << " trades");
+}
+
 Real getShiftSize(const RiskFactorKey& key, const SensitivityScenarioData& sensiParams,
                   const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket, const string& marketConfiguration) {
 
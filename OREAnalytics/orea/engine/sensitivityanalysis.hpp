@@ -32,6 +32,7 @@
 
 #include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/market.hpp>
+#include <ored/portfolio/enginefactory.hpp>
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/portfolio/referencedata.hpp>
 #include <ored/report/report.hpp>
@@ -96,6 +97,15 @@ public:
     //! Generate the Sensitivities
     void generateSensitivities();
 
+    /*! Update the sensitivities of a previous call to generateSensitivities() for a changed \p portfolio. Only the
+        trades in \p changedTradeIds (new or amended trades) are built and revalued, using the sim market and the
+        scenario generators of the previous run. Trades that are no longer in the portfolio are removed, all other
+        trades keep their results from the previous run. The changed trades are always revalued single-threaded.
+
+        \warning The market data and the sensitivity configuration must be the same as in the previous run. */
+    void updateSensitivities(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
+                             const std::set<std::string>& changedTradeIds);
+
     //! The ASOF date for the sensitivity analysis
     const QuantLib::Date asof() const { return asof_; }
 
@@ -117,6 +127,14 @@ public:
     //! override shift tenors with sim market tenors
     void overrideTenors(const bool b) { overrideTenors_ = b; }
 
+    /*! compute the first order sensitivities of supported linear trades by a backward derivatives sweep on a
+        computation graph instead of bump and revalue, see SensitivityEngineCG */
+    void useAadDeltas(const bool b) { useAadDeltas_ = b; }
+
+    /*! in single-threaded runs with observation mode Disable, only recalculate the trades that depend on a risk
+        factor shifted by the scenario, see ValuationEngine::setSkipUnaffectedTrades() */
+    void skipUnaffectedTrades(const bool b) { skipUnaffectedTrades_ = b; }
+
     //! the portfolio of trades
     QuantLib::ext::shared_ptr<Portfolio> portfolio() const { return portfolio_; }
 
@@ -131,6 +149,21 @@ public:
     }
 
 private:
+    /*! If enabled, compute the npvs and derivatives of the trades in \p portfolio supported by SensitivityEngineCG,
+        the trades must be built against the sim market unless an \p engineFactory is given to build them. Returns
+        the remaining trades. */
+    QuantLib::ext::shared_ptr<Portfolio>
+    computeAadDeltas(const QuantLib::ext::shared_ptr<Portfolio>& portfolio,
+                     const QuantLib::ext::shared_ptr<EngineData>& engineData,
+                     const QuantLib::ext::shared_ptr<EngineFactory>& engineFactory,
+                     std::map<std::string, std::pair<Real, std::map<RiskFactorKey, Real>>>& results) const;
+
+    //! Build the sensi cube for \p pf under the scenarios of \p scenGen using the single-threaded valuation engine
+    QuantLib::ext::shared_ptr<NPVSensiCube>
+    buildSingleThreadedCube(const QuantLib::ext::shared_ptr<Portfolio>& pf,
+                            const QuantLib::ext::shared_ptr<SensitivityScenarioGenerator>& scenGen,
+                            const QuantLib::ext::shared_ptr<EngineData>& ed);
+
     QuantLib::ext::shared_ptr<ore::data::Market> market_;
     std::string marketConfiguration_;
     Date asof_;
@@ -144,6 +177,8 @@ private:
     //! Optional todays market parameters. Used in building the scenario sim market.
     QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters> todaysMarketParams_;
     bool overrideTenors_;
+    bool useAadDeltas_ = false;
+    bool skipUnaffectedTrades_ = false;
 
     // if true, convert sensis to base currency using the original (non-shifted) FX rate
     bool nonShiftedBaseCurrencyConversion_;
@@ -162,6 +197,11 @@ private:
     std::set<std::pair<string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>> modelBuilders_;
     //! sensitivityCube
     std::vector<QuantLib::ext::shared_ptr<SensitivityCube>> sensiCubes_;
+    //! state of the last run, used in updateSensitivities()
+    std::vector<std::string> sensiTemplateIds_;
+    std::vector<QuantLib::ext::shared_ptr<SensitivityScenarioGenerator>> scenarioGenerators_;
+    std::vector<Size> sensiCubeGenerators_;
+    QuantLib::ext::shared_ptr<EngineData> sensiEngineData_;
 
     bool useSingleThreadedEngine_;
     // additional members needed for multihreaded constructor
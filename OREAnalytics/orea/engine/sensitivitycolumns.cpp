@@ -0,0 +1,148 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/sensitivitycolumns.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/utilities/null.hpp>
+
+#include <algorithm>
+
+using QuantLib::Null;
+using QuantLib::Real;
+using QuantLib::Size;
+
+namespace ore {
+namespace analytics {
+
+SensitivityColumns::SensitivityColumns(SensitivityStream& ss) {
+    ss.reset();
+    std::vector<SensitivityRecord> block;
+    while (ss.nextBlock(block, SensitivityStream::defaultBlockSize) > 0) {
+        for (auto const& sr : block)
+            add(sr);
+    }
+}
+
+void SensitivityColumns::add(const SensitivityRecord& sr) {
+    auto t = tradeCodes_.find(sr.tradeId);
+    if (t == tradeCodes_.end()) {
+        t = tradeCodes_.insert(std::make_pair(sr.tradeId, tradeIds_.size())).first;
+        tradeIds_.push_back(sr.tradeId);
+    }
+    auto c = std::find(currencies_.begin(), currencies_.end(), sr.currency);
+    if (c == currencies_.end())
+        c = currencies_.insert(currencies_.end(), sr.currency);
+    trade_.push_back(t->second);
+    factor1_.push_back(codeFactor(sr.key_1, sr.desc_1));
+    factor2_.push_back(sr.isCrossGamma() ? codeFactor(sr.key_2, sr.desc_2) : Null<Size>());
+    currency_.push_back(std::distance(currencies_.begin(), c));
+    isPar_.push_back(sr.isPar);
+    shift1_.push_back(sr.shift_1);
+    shift2_.push_back(sr.shift_2);
+    baseNpv_.push_back(sr.baseNpv);
+    delta_.push_back(sr.delta);
+    gamma_.push_back(sr.gamma);
+}
+
+Size SensitivityColumns::codeFactor(const RiskFactorKey& key, const std::string& desc) {
+    auto f = factorCodes_.find(key);
+    if (f == factorCodes_.end()) {
+        f = factorCodes_.insert(std::make_pair(key, factors_.size())).first;
+        factors_.push_back(key);
+        factorDescriptions_.push_back(desc);
+    }
+    return f->second;
+}
+
+SensitivityRecord SensitivityColumns::record(const Size i) const {
+    QL_REQUIRE(i < size(), "SensitivityColumns::record(): row " << i << " out of range, size is " << size());
+    bool cross = factor2_[i] != Null<Size>();
+    return SensitivityRecord(tradeIds_[trade_[i]], isPar_[i], factors_[factor1_[i]],
+                             factorDescriptions_[factor1_[i]], shift1_[i],
+                             cross ? factors_[factor2_[i]] : RiskFactorKey(),
+                             cross ? factorDescriptions_[factor2_[i]] : std::string(), shift2_[i],
+                             currencies_[currency_[i]], baseNpv_[i], delta_[i], gamma_[i]);
+}
+
+Size SensitivityColumns::tradeCode(const std::string& tradeId) const {
+    auto t = tradeCodes_.find(tradeId);
+    return t == tradeCodes_.end() ? Null<Size>() : t->second;
+}
+
+Size SensitivityColumns::factorCode(const RiskFactorKey& key) const {
+    auto f = factorCodes_.find(key);
+    return f == factorCodes_.end() ? Null<Size>() : f->second;
+}
+
+std::vector<SensitivityColumns::Sums>
+SensitivityColumns::aggregate(const std::vector<std::vector<Size>>& tradeGroups, const Size numberOfGroups,
+                              const std::vector<bool>& factorAllowed) const {
+    QL_REQUIRE(tradeGroups.size() == tradeIds_.size(), "SensitivityColumns::aggregate(): trade groups size ("
+                                                           << tradeGroups.size() << ") does not match number of trades ("
+                                                           << tradeIds_.size() << ")");
+    QL_REQUIRE(factorAllowed.size() == factors_.size(), "SensitivityColumns::aggregate(): factor mask size ("
+                                                            << factorAllowed.size()
+                                                            << ") does not match number of factors (" << factors_.size()
+                                                            << ")");
+
+    std::vector<Sums> result(numberOfGroups);
+
+    // position of a delta / gamma factor in the group's sums, cross gammas are looked up in a map
+
+    std::vector<std::vector<Size>> position(numberOfGroups, std::vector<Size>(factors_.size(), Null<Size>()));
+    std::vector<std::map<std::pair<Size, Size>, Size>> crossPosition(numberOfGroups);
+
+    for (Size i = 0; i < size(); ++i) {
+        const std::vector<Size>& groups = tradeGroups[trade_[i]];
+        if (groups.empty() || !factorAllowed[factor1_[i]])
+            continue;
+        bool cross = factor2_[i] != Null<Size>();
+        if (cross && !factorAllowed[factor2_[i]])
+            continue;
+        for (auto const g : groups) {
+            QL_REQUIRE(g < numberOfGroups, "SensitivityColumns::aggregate(): group " << g << " out of range");
+            Sums& s = result[g];
+            Size pos;
+            if (cross) {
+                pos = crossPosition[g]
+                          .insert(std::make_pair(std::make_pair(factor1_[i], factor2_[i]), s.factors.size()))
+                          .first->second;
+            } else {
+                if (position[g][factor1_[i]] == Null<Size>())
+                    position[g][factor1_[i]] = s.factors.size();
+                pos = position[g][factor1_[i]];
+            }
+            if (pos == s.factors.size()) {
+                s.factors.push_back(std::make_pair(factor1_[i], factor2_[i]));
+                s.firstRow.push_back(i);
+                s.baseNpv.push_back(0.0);
+                s.delta.push_back(0.0);
+                s.gamma.push_back(0.0);
+            }
+            s.baseNpv[pos] += baseNpv_[i];
+            s.delta[pos] += delta_[i];
+            s.gamma[pos] += gamma_[i];
+        }
+    }
+
+    return result;
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,116 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/engine/sensitivitycolumns.hpp
+    \brief Columnar store for sensitivity records
+ */
+
+#pragma once
+
+#include <orea/engine/sensitivitystream.hpp>
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+/*! Columnar store for SensitivityRecords.
+
+    The trade ids, risk factors and currencies of the records are coded as integers via dictionaries, the record
+    fields are held in one array per field. This allows aggregations over trade groups to be computed in a single
+    pass over the arrays, without string comparisons, see aggregate(). The factor descriptions are stored per factor,
+    i.e. the description of the first record with a given factor is used.
+
+    For delta / gamma records the second factor code is QuantLib::Null<Size>().
+*/
+class SensitivityColumns {
+public:
+    //! Sums of the records with the same (factor1, factor2) in a group, see aggregate()
+    struct Sums {
+        //! the factor codes
+        std::vector<std::pair<QuantLib::Size, QuantLib::Size>> factors;
+        //! the row of the first contributing record
+        std::vector<QuantLib::Size> firstRow;
+        std::vector<QuantLib::Real> baseNpv, delta, gamma;
+    };
+
+    SensitivityColumns() = default;
+    //! Reads all records from the stream \p ss
+    explicit SensitivityColumns(SensitivityStream& ss);
+
+    //! Append a record
+    void add(const SensitivityRecord& sr);
+
+    //! Number of records
+    QuantLib::Size size() const { return trade_.size(); }
+
+    //! Reconstruct the record in row \p i
+    SensitivityRecord record(const QuantLib::Size i) const;
+
+    //! \name Dictionaries
+    //@{
+    const std::vector<std::string>& tradeIds() const { return tradeIds_; }
+    const std::vector<RiskFactorKey>& factors() const { return factors_; }
+    const std::vector<std::string>& factorDescriptions() const { return factorDescriptions_; }
+    const std::vector<std::string>& currencies() const { return currencies_; }
+    //! Code of trade id, Null<Size>() if not present
+    QuantLib::Size tradeCode(const std::string& tradeId) const;
+    //! Code of risk factor, Null<Size>() if not present
+    QuantLib::Size factorCode(const RiskFactorKey& key) const;
+    //@}
+
+    //! \name Columns
+    //@{
+    const std::vector<QuantLib::Size>& trade() const { return trade_; }
+    const std::vector<QuantLib::Size>& factor1() const { return factor1_; }
+    const std::vector<QuantLib::Size>& factor2() const { return factor2_; }
+    const std::vector<QuantLib::Size>& currency() const { return currency_; }
+    const std::vector<bool>& isPar() const { return isPar_; }
+    const std::vector<QuantLib::Real>& shift1() const { return shift1_; }
+    const std::vector<QuantLib::Real>& shift2() const { return shift2_; }
+    const std::vector<QuantLib::Real>& baseNpv() const { return baseNpv_; }
+    const std::vector<QuantLib::Real>& delta() const { return delta_; }
+    const std::vector<QuantLib::Real>& gamma() const { return gamma_; }
+    //@}
+
+    /*! Sum baseNpv, delta and gamma of the records by group and (factor1, factor2). The groups of a trade are given
+        by \p tradeGroups, which is indexed by trade code, a trade can belong to several or no groups. Records with a
+        factor for which \p factorAllowed is false are skipped. Returns one Sums instance per group. */
+    std::vector<Sums> aggregate(const std::vector<std::vector<QuantLib::Size>>& tradeGroups,
+                                const QuantLib::Size numberOfGroups, const std::vector<bool>& factorAllowed) const;
+
+private:
+    QuantLib::Size codeFactor(const RiskFactorKey& key, const std::string& desc);
+
+    std::vector<std::string> tradeIds_;
+    std::unordered_map<std::string, QuantLib::Size> tradeCodes_;
+    std::vector<RiskFactorKey> factors_;
+    std::vector<std::string> factorDescriptions_;
+    std::map<RiskFactorKey, QuantLib::Size> factorCodes_;
+    std::vector<std::string> currencies_;
+
+    std::vector<QuantLib::Size> trade_, factor1_, factor2_, currency_;
+    std::vector<bool> isPar_;
+    std::vector<QuantLib::Real> shift1_, shift2_, baseNpv_, delta_, gamma_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,343 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/sensitivityenginecg.hpp>
+#include <orea/scenario/deltascenario.hpp>
+
+#include <ored/portfolio/fxforward.hpp>
+#include <ored/utilities/indexnametranslator.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <qle/ad/backwardderivatives.hpp>
+#include <qle/ad/forwardevaluation.hpp>
+#include <qle/cashflows/overnightindexedcoupon.hpp>
+#include <qle/indexes/fallbackiborindex.hpp>
+
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/cashflows/iborcoupon.hpp>
+#include <ql/cashflows/simplecashflow.hpp>
+#include <ql/math/comparison.hpp>
+
+#include <numeric>
+
+using namespace QuantLib;
+using namespace QuantExt;
+using namespace ore::data;
+
+namespace ore {
+namespace analytics {
+
+namespace {
+
+// records npvs of cashflows on a computation graph with the sim market quotes as input nodes
+class NpvRecorder {
+public:
+    NpvRecorder(ComputationGraph& g, const ScenarioSimMarket& simMarket, const ScenarioSimMarketParameters& simMarketData)
+        : g_(g), simMarket_(simMarket), simMarketData_(simMarketData), asof_(simMarket.asofDate()) {}
+
+    const std::map<RiskFactorKey, std::size_t>& inputs() const { return inputs_; }
+
+    std::size_t quote(const RiskFactorKey& key) {
+        if (auto i = inputs_.find(key); i != inputs_.end())
+            return i->second;
+        QL_REQUIRE(simMarket_.simData().find(key) != simMarket_.simData().end(),
+                   "no simulated quote for risk factor " << key);
+        return inputs_[key] = cg_insert(g_);
+    }
+
+    // discount factor of a sim market curve, this mirrors the interpolation in the sim market curves
+    std::size_t discount(const RiskFactorKey::KeyType type, const std::string& name,
+                         const Handle<YieldTermStructure>& curve, const Date& d) {
+        Time t = curve->timeFromReference(d);
+        if (close_enough(t, 0.0))
+            return cg_const(g_, 1.0);
+        QL_REQUIRE(t > 0.0, "discount factor for past date " << d << " requested on " << name);
+        auto c = simMarket_.baseScenario()->coordinates().find(std::make_pair(type, name));
+        QL_REQUIRE(c != simMarket_.baseScenario()->coordinates().end() && c->second.size() == 1,
+                   "no pillar times for " << type << " " << name);
+        const std::vector<Real>& times = c->second.front();
+        Size n = times.size();
+        QL_REQUIRE(n > 0, "no pillars for " << type << " " << name);
+        if (t > times.back()) {
+            if (simMarketData_.extrapolation() == "FlatZero")
+                return cg_exp(g_, cg_mult(g_, cg_const(g_, t / times.back()), logDiscount(type, name, n)));
+            // flat forward extrapolation continues the log discount of the last pillar interval
+            return cg_exp(g_, interpolate(n > 1 ? times[n - 2] : 0.0, times[n - 1], t, logDiscount(type, name, n - 1),
+                                          logDiscount(type, name, n)));
+        }
+        Size i = std::min<Size>(std::upper_bound(times.begin(), times.end(), t) - times.begin(), n - 1);
+        Time t0 = i == 0 ? 0.0 : times[i - 1], t1 = times[i];
+        std::size_t l0 = logDiscount(type, name, i), l1 = logDiscount(type, name, i + 1);
+        if (simMarketData_.interpolation() == "LogLinear")
+            return cg_exp(g_, interpolate(t0, t1, t, l0, l1));
+        // linear in zero rates, the zero rate at t = 0 is the one of the first pillar
+        std::size_t z1 = cg_mult(g_, cg_const(g_, -1.0 / t1), l1);
+        std::size_t z0 = i == 0 ? z1 : cg_mult(g_, cg_const(g_, -1.0 / t0), l0);
+        return cg_exp(g_, cg_mult(g_, cg_const(g_, -t), interpolate(t0, t1, t, z0, z1)));
+    }
+
+    // today's fx rate ccy / base ccy, i.e. the spot rate adjusted from the spot date to today
+    std::size_t fxToBase(const std::string& ccy) {
+        const std::string& baseCcy = simMarketData_.baseCcy();
+        if (ccy == baseCcy)
+            return cg_const(g_, 1.0);
+        std::size_t spot;
+        if (RiskFactorKey key(RiskFactorKey::KeyType::FXSpot, ccy + baseCcy);
+            simMarket_.simData().find(key) != simMarket_.simData().end()) {
+            spot = quote(key);
+        } else if (RiskFactorKey key(RiskFactorKey::KeyType::FXSpot, baseCcy + ccy);
+                   simMarket_.simData().find(key) != simMarket_.simData().end()) {
+            spot = cg_div(g_, cg_const(g_, 1.0), quote(key));
+        } else {
+            QL_FAIL("no simulated fx spot for " << ccy << baseCcy);
+        }
+        auto index = simMarket_.fxIndex(ccy + baseCcy);
+        if (index->fixingDays() == 0)
+            return spot;
+        Date spotDate = index->fixingCalendar().advance(asof_, index->fixingDays(), Days);
+        return cg_mult(g_, spot,
+                       cg_div(g_, discount(RiskFactorKey::KeyType::DiscountCurve, baseCcy, index->targetCurve(), spotDate),
+                              discount(RiskFactorKey::KeyType::DiscountCurve, ccy, index->sourceCurve(), spotDate)));
+    }
+
+    // npv of a leg in its currency
+    std::size_t legNpv(const Leg& leg, const std::string& ccy) {
+        Handle<YieldTermStructure> curve = simMarket_.discountCurve(ccy);
+        std::vector<std::size_t> pvs;
+        for (auto const& cf : leg) {
+            if (cf->hasOccurred(asof_))
+                continue;
+            pvs.push_back(cg_mult(g_, amount(cf),
+                                  discount(RiskFactorKey::KeyType::DiscountCurve, ccy, curve, cf->date())));
+        }
+        return pvs.empty() ? cg_const(g_, 0.0) : cg_add(g_, pvs);
+    }
+
+private:
+    std::size_t logDiscount(const RiskFactorKey::KeyType type, const std::string& name, const Size pillar) {
+        // pillar 0 is t = 0, the sim market quotes start at pillar 1
+        if (pillar == 0)
+            return cg_const(g_, 0.0);
+        RiskFactorKey key(type, name, pillar - 1);
+        auto l = logDiscounts_.find(key);
+        if (l == logDiscounts_.end())
+            l = logDiscounts_.insert(std::make_pair(key, cg_log(g_, quote(key)))).first;
+        return l->second;
+    }
+
+    std::size_t interpolate(const Time t0, const Time t1, const Time t, const std::size_t y0, const std::size_t y1) {
+        Real w = (t - t0) / (t1 - t0);
+        return cg_add(g_, cg_mult(g_, cg_const(g_, 1.0 - w), y0), cg_mult(g_, cg_const(g_, w), y1));
+    }
+
+    bool isFixed(const QuantLib::ext::shared_ptr<InterestRateIndex>& index, const Date& fixingDate) const {
+        return fixingDate < asof_ || (fixingDate == asof_ && index->pastFixing(fixingDate) != Null<Real>());
+    }
+
+    std::size_t indexCurveDiscount(const QuantLib::ext::shared_ptr<IborIndex>& index, const Date& d) {
+        QL_REQUIRE(!QuantLib::ext::dynamic_pointer_cast<FallbackIborIndex>(index),
+                   "fallback index " << index->name() << " not supported");
+        return discount(RiskFactorKey::KeyType::IndexCurve, IndexNameTranslator::instance().oreName(index->name()),
+                        index->forwardingTermStructure(), d);
+    }
+
+    std::size_t amount(const QuantLib::ext::shared_ptr<CashFlow>& cf) {
+        if (auto c = QuantLib::ext::dynamic_pointer_cast<QuantLib::IborCoupon>(cf)) {
+            QL_REQUIRE(!c->isInArrears(), "in arrears ibor coupons not supported");
+            if (isFixed(c->iborIndex(), c->fixingDate()))
+                return cg_const(g_, c->amount());
+            std::size_t compound = cg_div(g_, indexCurveDiscount(c->iborIndex(), c->fixingValueDate()),
+                                          indexCurveDiscount(c->iborIndex(), c->fixingEndDate()));
+            return couponAmount(*c, compound, c->spanningTime());
+        }
+        if (auto c = QuantLib::ext::dynamic_pointer_cast<QuantExt::OvernightIndexedCoupon>(cf)) {
+            QL_REQUIRE(c->lookback() == 0 * Days && c->rateCutoff() == 0 &&
+                           (!c->includeSpread() || close_enough(c->spread(), 0.0)),
+                       "overnight coupons with lookback, rate cutoff or included spread not supported");
+            const std::vector<Date>& fixingDates = c->fixingDates();
+            const std::vector<Date>& valueDates = c->valueDates();
+            Real pastCompound = 1.0;
+            Size k = 0;
+            for (; k < fixingDates.size() && isFixed(c->overnightIndex(), fixingDates[k]); ++k) {
+                Real fixing = c->overnightIndex()->pastFixing(fixingDates[k]);
+                QL_REQUIRE(fixing != Null<Real>(),
+                           "missing " << c->overnightIndex()->name() << " fixing for " << fixingDates[k]);
+                pastCompound *= 1.0 + fixing * c->dt()[k];
+            }
+            if (k == fixingDates.size())
+                return cg_const(g_, c->amount());
+            std::size_t compound =
+                cg_mult(g_, cg_const(g_, pastCompound),
+                        cg_div(g_, indexCurveDiscount(c->overnightIndex(), valueDates[k]),
+                               indexCurveDiscount(c->overnightIndex(), valueDates.back())));
+            return couponAmount(*c, compound, std::accumulate(c->dt().begin(), c->dt().end(), 0.0));
+        }
+        if (QuantLib::ext::dynamic_pointer_cast<FixedRateCoupon>(cf) || QuantLib::ext::dynamic_pointer_cast<SimpleCashFlow>(cf))
+            return cg_const(g_, cf->amount());
+        QL_FAIL("cashflow type not supported");
+    }
+
+    // nominal * accrual * (gearing * (compound - 1) / tau + spread)
+    std::size_t couponAmount(const FloatingRateCoupon& c, const std::size_t compound, const Time tau) {
+        Real a = c.nominal() * c.accrualPeriod();
+        return cg_add(g_, cg_mult(g_, cg_const(g_, a * c.gearing() / tau), compound),
+                      cg_const(g_, a * (c.spread() - c.gearing() / tau)));
+    }
+
+    ComputationGraph& g_;
+    const ScenarioSimMarket& simMarket_;
+    const ScenarioSimMarketParameters& simMarketData_;
+    Date asof_;
+    std::map<RiskFactorKey, std::size_t> inputs_;
+    std::map<RiskFactorKey, std::size_t> logDiscounts_;
+};
+
+std::string productType(const QuantLib::ext::shared_ptr<Trade>& trade) {
+    if (trade->tradeType() == "FxForward")
+        return "FxForward";
+    std::set<std::string> ccys(trade->legCurrencies().begin(), trade->legCurrencies().end());
+    return ccys.size() > 1 ? "CrossCurrencySwap" : "Swap";
+}
+
+} // namespace
+
+SensitivityEngineCG::SensitivityEngineCG(const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket,
+                                         const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& simMarketData,
+                                         const QuantLib::ext::shared_ptr<EngineData>& engineData)
+    : simMarket_(simMarket), simMarketData_(simMarketData), engineData_(engineData), ops_(getRandomVariableOps(1)),
+      grads_(getRandomVariableGradients(1)) {
+    QL_REQUIRE(!simMarket_->useSpreadedTermStructures(),
+               "SensitivityEngineCG: sim market with spreaded term structures not supported");
+}
+
+bool SensitivityEngineCG::isCandidate(const QuantLib::ext::shared_ptr<Trade>& trade) {
+    if (trade->tradeType() == "Swap")
+        return true;
+    if (auto fxFwd = QuantLib::ext::dynamic_pointer_cast<ore::data::FxForward>(trade))
+        return fxFwd->settlement() == "Physical";
+    return false;
+}
+
+bool SensitivityEngineCG::computeDerivatives(const QuantLib::ext::shared_ptr<Trade>& trade, Real& npv,
+                                             std::map<RiskFactorKey, Real>& derivatives) const {
+    try {
+        QL_REQUIRE(isCandidate(trade), "trade type not supported");
+        std::string product = productType(trade);
+        QL_REQUIRE(engineData_->hasProduct(product) && engineData_->model(product) == "DiscountedCashflows",
+                   "model for " << product << " not supported");
+        auto instrument = QuantLib::ext::dynamic_pointer_cast<VanillaInstrument>(trade->instrument());
+        QL_REQUIRE(instrument && instrument->additionalInstruments().empty(),
+                   "instrument wrapper with additional instruments not supported");
+
+        // record the base ccy npv
+
+        ComputationGraph g;
+        NpvRecorder recorder(g, *simMarket_, *simMarketData_);
+        std::vector<std::size_t> legNpvs;
+        for (Size i = 0; i < trade->legs().size(); ++i) {
+            std::size_t legNpv = cg_mult(g, recorder.legNpv(trade->legs()[i], trade->legCurrencies()[i]),
+                                         recorder.fxToBase(trade->legCurrencies()[i]));
+            legNpvs.push_back(trade->legPayers()[i] ? cg_negative(g, legNpv) : legNpv);
+        }
+        QL_REQUIRE(!legNpvs.empty(), "no legs");
+        std::size_t npvNode =
+            cg_mult(g, cg_const(g, instrument->multiplier() * instrument->multiplier2()), cg_add(g, legNpvs));
+
+        // forward evaluation and check against the npv of the built trade
+
+        std::vector<RandomVariable> values(g.size(), RandomVariable(1, 0.0));
+        for (auto const& [v, node] : g.constants())
+            values[node] = RandomVariable(1, v);
+        for (auto const& [key, node] : recorder.inputs())
+            values[node] = RandomVariable(1, simMarket_->simData().at(key)->value());
+        forwardEvaluation(g, values, ops_);
+
+        npv = trade->instrument()->NPV() * simMarket_->fxRate(trade->npvCurrency() + simMarketData_->baseCcy())->value() /
+              simMarket_->numeraire();
+        Real scale = 1.0;
+        for (auto const& n : legNpvs)
+            scale = std::max(scale, std::abs(values[n].at(0)));
+        QL_REQUIRE(std::abs(values[npvNode].at(0) - npv) <= 1E-8 * scale,
+                   "recorded npv " << values[npvNode].at(0) << " does not match trade npv " << npv);
+
+        // backward sweep
+
+        std::vector<RandomVariable> adjoints(g.size(), RandomVariable(1, 0.0));
+        adjoints[npvNode] = RandomVariable(1, 1.0);
+        backwardDerivatives(g, values, adjoints, grads_);
+
+        derivatives.clear();
+        for (auto const& [key, node] : recorder.inputs()) {
+            if (!QuantLib::close_enough(adjoints[node].at(0), 0.0))
+                derivatives[key] = adjoints[node].at(0) / simMarket_->numeraire();
+        }
+        return true;
+    } catch (const std::exception& e) {
+        DLOG("SensitivityEngineCG: trade " << trade->id() << " not supported (" << e.what()
+                                           << "), will use bump and revalue.");
+        return false;
+    }
+}
+
+void SensitivityEngineCG::buildCube(
+    const std::map<std::string, std::pair<Real, std::map<RiskFactorKey, Real>>>& results,
+    const QuantLib::ext::shared_ptr<NPVSensiCube>& cube,
+    const QuantLib::ext::shared_ptr<ScenarioGenerator>& scenarioGenerator) const {
+
+    for (auto const& [id, r] : results)
+        cube->setT0(r.first, id);
+
+    auto base = simMarket_->baseScenario();
+    std::vector<std::pair<RiskFactorKey, Real>> changes;
+
+    scenarioGenerator->reset();
+    for (Size sample = 0; sample < cube->samples(); ++sample) {
+
+        // collect the changes of the sim market quotes against the base scenario
+
+        auto scenario = scenarioGenerator->next(simMarket_->asofDate());
+        changes.clear();
+        if (auto ds = QuantLib::ext::dynamic_pointer_cast<DeltaScenario>(scenario); ds && ds->base() == base) {
+            for (auto const& k : ds->delta()->keys())
+                changes.push_back(std::make_pair(k, ds->delta()->get(k) - base->get(k)));
+        } else {
+            for (auto const& k : scenario->keys()) {
+                if (!base->has(k))
+                    continue;
+                if (Real d = scenario->get(k) - base->get(k); d != 0.0)
+                    changes.push_back(std::make_pair(k, d));
+            }
+        }
+
+        // first order npv of each trade
+
+        for (auto const& [id, r] : results) {
+            Real d = 0.0;
+            for (auto const& [k, v] : changes) {
+                if (auto it = r.second.find(k); it != r.second.end())
+                    d += it->second * v;
+            }
+            if (d != 0.0)
+                cube->set(r.first + d, id, sample);
+        }
+    }
+    scenarioGenerator->reset();
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/engine/sensitivityenginecg.hpp
+    \brief first order sensitivities of linear trades using cg infrastructure
+    \ingroup engine
+*/
+
+#pragma once
+
+#include <orea/cube/npvsensicube.hpp>
+#include <orea/scenario/scenariogenerator.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/scenariosimmarketparameters.hpp>
+
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/trade.hpp>
+
+#include <qle/math/randomvariable_ops.hpp>
+
+#include <map>
+#include <string>
+
+namespace ore {
+namespace analytics {
+
+//! First order sensitivities of linear trades from one backward derivatives sweep
+/*! The base currency npv of a supported trade is recorded into a computation graph whose inputs are the quotes of the
+    scenario sim market, i.e. the discount factors at the curve pillars and the fx spot rates. One backward sweep
+    yields the derivatives of the npv by all these quotes. A sensitivity cube is then populated with the first order
+    approximation
+
+    npv(scenario) = npv(base) + sum_k d npv / d q_k * (q_k(scenario) - q_k(base))
+
+    so that the cube can be processed exactly like a bump and revalue cube. Second order sensitivities are zero by
+    construction.
+
+    Supported are Swap (including cross currency swaps without fx resets) and physically settled FxForward trades
+    priced with a DiscountedCashflows engine, with legs consisting of fixed coupons, simple cashflows, Ibor coupons
+    (not in arrears) and compounded overnight coupons (without lookback, rate cutoff or included spread). The
+    recorded npv is checked against the npv of the built trade. Trades with other features or failing the check are
+    reported as not supported and should be processed by bump and revalue.
+
+    The sim market must use absolute (i.e. not spreaded) term structures.
+
+    \ingroup engine
+*/
+class SensitivityEngineCG {
+public:
+    SensitivityEngineCG(const QuantLib::ext::shared_ptr<ScenarioSimMarket>& simMarket,
+                        const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& simMarketData,
+                        const QuantLib::ext::shared_ptr<ore::data::EngineData>& engineData);
+
+    //! Can the trade type be supported at all, this allows to filter trades before building them
+    static bool isCandidate(const QuantLib::ext::shared_ptr<ore::data::Trade>& trade);
+
+    /*! Compute the base ccy npv of a trade, built against the sim market, and its derivatives by the sim market
+        quotes. Returns false if the trade is not supported. */
+    bool computeDerivatives(const QuantLib::ext::shared_ptr<ore::data::Trade>& trade, QuantLib::Real& npv,
+                            std::map<RiskFactorKey, QuantLib::Real>& derivatives) const;
+
+    /*! Populate a sensi cube for all scenarios of the scenario generator, \p results maps trade ids to their npv
+        and derivatives as returned by computeDerivatives(). */
+    void buildCube(const std::map<std::string, std::pair<QuantLib::Real, std::map<RiskFactorKey, QuantLib::Real>>>& results,
+                   const QuantLib::ext::shared_ptr<NPVSensiCube>& cube,
+                   const QuantLib::ext::shared_ptr<ScenarioGenerator>& scenarioGenerator) const;
+
+private:
+    QuantLib::ext::shared_ptr<ScenarioSimMarket> simMarket_;
+    QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> simMarketData_;
+    QuantLib::ext::shared_ptr<ore::data::EngineData> engineData_;
+    std::vector<QuantExt::RandomVariableOp> ops_;
+    std::vector<QuantExt::RandomVariableGrad> grads_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -24,6 +24,7 @@
 
 #include <boost/algorithm/string.hpp>
 
+
 using ore::analytics::deconstructFactor;
 using ore::data::parseBool;
 using ore::data::parseReal;
@@ -38,7 +39,16 @@ void SensitivityInputStream::setStream(std::istream* stream) {
     stream_ = stream; 
 }
 
+void SensitivityInputStream::setThreads(const Size nThreads) {
+    nThreads_ = std::max<Size>(nThreads, 1);
+    workers_ = nThreads_ > 1 ? QuantLib::ext::make_shared<ore::data::WorkerGroup>(nThreads_) : nullptr;
+}
+
 SensitivityRecord SensitivityInputStream::next() {
+    // Return records parsed ahead in nextBlock() first
+    if (parsedIndex_ < parsed_.size())
+        return parsed_[parsedIndex_++];
+
     // Get the next valid SensitivityRecord
     string line;
     while (getline(*stream_, line)) {
@@ -54,26 +64,72 @@ SensitivityRecord SensitivityInputStream::next() {
 
         // Try to parse line in to a SensitivityRecord
         DLOG("Processing line number " << lineNo_ << ": " << line);
-        vector<string> entries;
-        boost::split(
-            entries, line, [this](char c) { return c == delim_; }, boost::token_compress_off);
-        return processRecord(entries);
+        return processLine(line, lineNo_);
     }
 
     // If we get to here, no more lines to process so return empty record
     return SensitivityRecord();
 }
 
+Size SensitivityInputStream::nextBlock(vector<SensitivityRecord>& block, const Size maxRecords) {
+    if (nThreads_ == 1 && parsedIndex_ == parsed_.size())
+        return SensitivityStream::nextBlock(block, maxRecords);
+
+    // Parse ahead in chunks large enough to keep the worker threads busy
+    if (parsedIndex_ == parsed_.size())
+        parseAhead(std::max<Size>(maxRecords, 4096 * nThreads_));
+
+    Size n = std::min(maxRecords, parsed_.size() - parsedIndex_);
+    block.assign(parsed_.begin() + parsedIndex_, parsed_.begin() + parsedIndex_ + n);
+    parsedIndex_ += n;
+    return n;
+}
+
+void SensitivityInputStream::parseAhead(const Size n) {
+    // Read the lines sequentially, the splitting and parsing is done on the worker threads
+    vector<string> lines;
+    vector<Size> lineNumbers;
+    string line;
+    while (lines.size() < n && getline(*stream_, line)) {
+        ++lineNo_;
+        boost::trim(line);
+        if (line.empty() || boost::starts_with(line, comment_))
+            continue;
+        lines.push_back(std::move(line));
+        lineNumbers.push_back(lineNo_);
+    }
+
+    parsed_.resize(lines.size());
+    parsedIndex_ = 0;
+
+    // The error for the first line that failed is rethrown
+    auto parse = [this, &lines, &lineNumbers](Size i) { parsed_[i] = processLine(lines[i], lineNumbers[i]); };
+    if (workers_)
+        workers_->run(lines.size(), parse);
+    else
+        for (Size i = 0; i < lines.size(); ++i)
+            parse(i);
+}
+
 void SensitivityInputStream::reset() {
     // Reset to beginning of file and line number
     stream_->clear();
     stream_->seekg(0, std::ios::beg);
     lineNo_ = 0;
+    parsed_.clear();
+    parsedIndex_ = 0;
+}
+
+SensitivityRecord SensitivityInputStream::processLine(const string& line, const Size lineNo) const {
+    vector<string> entries;
+    boost::split(
+        entries, line, [this](char c) { return c == delim_; }, boost::token_compress_off);
+    return processRecord(entries, lineNo);
 }
 
-SensitivityRecord SensitivityInputStream::processRecord(const vector<string>& entries) const {
+SensitivityRecord SensitivityInputStream::processRecord(const vector<string>& entries, const Size lineNo) const {
 
-    QL_REQUIRE(entries.size() == 10, "On line number " << lineNo_ << ": A sensitivity record needs 10 entries");
+    QL_REQUIRE(entries.size() == 10, "On line number " << lineNo << ": A sensitivity record needs 10 entries");
 
     SensitivityRecord sr;
     sr.tradeId = entries[0];
@@ -23,9 +23,12 @@
 #pragma once
 
 #include <orea/engine/sensitivitystream.hpp>
+#include <ored/utilities/workergroup.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <string>
+#include <vector>
 
 namespace ore {
 namespace analytics {
@@ -42,8 +45,14 @@ public:
     void setStream(std::istream* stream);
     //! Returns the next SensitivityRecord in the stream
     SensitivityRecord next() override;
+    /*! Returns the next block of SensitivityRecords in the stream. If more than one thread is set, the lines are read
+        in chunks and parsed on worker threads, the records are returned in file order. */
+    QuantLib::Size nextBlock(std::vector<SensitivityRecord>& block, const QuantLib::Size maxRecords) override;
     //! Resets the stream so that SensitivityRecord objects can be streamed again
     void reset() override;
+    /*! Set the number of threads used to parse the lines in nextBlock(), defaults to 1. The threads are started here
+        and reused for all chunks. */
+    void setThreads(const QuantLib::Size nThreads);
 
 private:
     //! Handle on the stram
@@ -54,9 +63,20 @@ private:
     std::string comment_;
     //! Keep track of line number for messages
     QuantLib::Size lineNo_;
+    //! Number of threads used in nextBlock()
+    QuantLib::Size nThreads_ = 1;
+    //! The worker threads parsing the lines, if nThreads_ > 1
+    QuantLib::ext::shared_ptr<ore::data::WorkerGroup> workers_;
+    //! Records parsed ahead in nextBlock() and not yet returned
+    std::vector<SensitivityRecord> parsed_;
+    QuantLib::Size parsedIndex_ = 0;
 
-    //! Create a record from a collection of strings
-    SensitivityRecord processRecord(const std::vector<std::string>& entries) const;
+    //! Create a record from a collection of strings, \p lineNo is used in error messages
+    SensitivityRecord processRecord(const std::vector<std::string>& entries, const QuantLib::Size lineNo) const;
+    //! Create a record from a trimmed, non-empty line
+    SensitivityRecord processLine(const std::string& line, const QuantLib::Size lineNo) const;
+    //! Read and parse the next \p n records using nThreads_ threads into parsed_
+    void parseAhead(const QuantLib::Size n);
 };
 
 class SensitivityFileStream : public SensitivityInputStream {
@@ -19,6 +19,8 @@
 #include <orea/engine/sensitivityinmemorystream.hpp>
 #include <ored/utilities/log.hpp>
 
+#include <algorithm>
+
 using std::set;
 
 namespace ore {
@@ -35,6 +37,14 @@ SensitivityRecord SensitivityInMemoryStream::next() {
     return *(itCurrent_++);
 }
 
+QuantLib::Size SensitivityInMemoryStream::nextBlock(std::vector<SensitivityRecord>& block,
+                                                    const QuantLib::Size maxRecords) {
+    auto itEnd = itCurrent_ + std::min<std::ptrdiff_t>(maxRecords, std::distance(itCurrent_, records_.end()));
+    block.assign(itCurrent_, itEnd);
+    itCurrent_ = itEnd;
+    return block.size();
+}
+
 void SensitivityInMemoryStream::reset() {
     // Reset iterator to start of container
     itCurrent_ = records_.begin();
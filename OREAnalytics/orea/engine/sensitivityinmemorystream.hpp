@@ -39,6 +39,8 @@ public:
     SensitivityInMemoryStream(Iter begin, Iter end);
     //! Returns the next SensitivityRecord in the stream
     SensitivityRecord next() override;
+    //! Returns the next block of SensitivityRecords in the stream
+    QuantLib::Size nextBlock(std::vector<SensitivityRecord>& block, const QuantLib::Size maxRecords) override;
     //! Resets the stream so that SensitivityRecords can be streamed again
     void reset() override;
     /*! Add a record to the in-memory collection.
@@ -56,7 +58,8 @@ private:
 };
 
 template <class Iter> 
-SensitivityInMemoryStream::SensitivityInMemoryStream(Iter begin, Iter end) : records_(begin, end) {}
+SensitivityInMemoryStream::SensitivityInMemoryStream(Iter begin, Iter end)
+    : records_(begin, end), itCurrent_(records_.begin()) {}
 
 } // namespace analytics
 } // namespace ore
@@ -24,6 +24,8 @@
 
 #include <orea/engine/sensitivityrecord.hpp>
 
+#include <vector>
+
 namespace ore {
 namespace analytics {
 
@@ -32,8 +34,25 @@ class SensitivityStream {
 public:
     //! Destructor
     virtual ~SensitivityStream() {}
+    //! Default number of records requested per block by consumers of nextBlock()
+    static constexpr QuantLib::Size defaultBlockSize = 1024;
+
     //! Returns the next SensitivityRecord in the stream
     virtual SensitivityRecord next() = 0;
+    /*! Replaces the content of \p block by the next (at most) \p maxRecords records in the stream and returns the
+        number of records in the block, zero at the end of the stream. The default implementation calls next(),
+        streams override this where they can hand out records without a virtual call per record. Calls to next()
+        and nextBlock() can be mixed, both advance the same position in the stream. */
+    virtual QuantLib::Size nextBlock(std::vector<SensitivityRecord>& block, const QuantLib::Size maxRecords) {
+        block.clear();
+        while (block.size() < maxRecords) {
+            SensitivityRecord sr = next();
+            if (!sr)
+                break;
+            block.push_back(std::move(sr));
+        }
+        return block.size();
+    }
     //! Resets the stream so that SensitivityRecord objects can be streamed again
     virtual void reset() = 0;
 };
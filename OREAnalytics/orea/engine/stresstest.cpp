@@ -17,6 +17,8 @@
 */
 
 #include <orea/cube/inmemorycube.hpp>
+#include <orea/cube/jointnpvcube.hpp>
+#include <orea/engine/multithreadedvaluationengine.hpp>
 #include <orea/engine/stresstest.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 #include <orea/engine/valuationengine.hpp>
@@ -44,7 +46,8 @@ StressTest::StressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& po
                        const CurveConfigurations& curveConfigs, const TodaysMarketParameters& todaysMarketParams,
                        QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory,
                        const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
-                       const IborFallbackConfig& iborFallbackConfig, bool continueOnError) {
+                       const IborFallbackConfig& iborFallbackConfig, bool continueOnError,
+                       const bool skipUnaffectedTrades) {
 
     LOG("Run Stress Test");
     DLOG("Build Simulation Market");
@@ -81,13 +84,71 @@ StressTest::StressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& po
     vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators;
     calculators.push_back(QuantLib::ext::make_shared<NPVCalculator>(simMarketData->baseCcy()));
     ValuationEngine engine(asof, dg, simMarket, factory->modelBuilders());
+    engine.setSkipUnaffectedTrades(skipUnaffectedTrades);
 
     engine.registerProgressIndicator(QuantLib::ext::make_shared<ProgressLog>("stress scenarios", 100, oreSeverity::notice));
     engine.buildCube(portfolio, cube, calculators);
 
-    /*****************
-     * Collect results
-     */
+    collectResults(portfolio, cube, scenarioGenerator);
+    LOG("Stress testing done");
+}
+
+StressTest::StressTest(const Size nThreads, const QuantLib::ext::shared_ptr<ore::data::Loader>& loader,
+                       const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+                       const QuantLib::ext::shared_ptr<ore::data::Market>& market, const string& marketConfiguration,
+                       const QuantLib::ext::shared_ptr<ore::data::EngineData>& engineData,
+                       const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& simMarketData,
+                       const QuantLib::ext::shared_ptr<StressTestScenarioData>& stressData,
+                       const QuantLib::ext::shared_ptr<CurveConfigurations>& curveConfigs,
+                       const QuantLib::ext::shared_ptr<TodaysMarketParameters>& todaysMarketParams,
+                       QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory,
+                       const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
+                       const IborFallbackConfig& iborFallbackConfig, bool continueOnError, const bool sharedInputs,
+                       const Size tradeChunkSize) {
+
+    LOG("Run Stress Test using multi-threaded engine with " << nThreads << " threads");
+
+    // the stress scenarios are generated once on a sim market built on the given market, the workers only apply them
+
+    DLOG("Build Simulation Market");
+    QuantLib::ext::shared_ptr<ScenarioSimMarket> simMarket = QuantLib::ext::make_shared<ScenarioSimMarket>(
+        market, simMarketData, marketConfiguration, curveConfigs ? *curveConfigs : CurveConfigurations(),
+        todaysMarketParams ? *todaysMarketParams : TodaysMarketParameters(), continueOnError,
+        stressData->useSpreadedTermStructures(), false, false, iborFallbackConfig, true);
+
+    DLOG("Build Stress Scenario Generator");
+    Date asof = market->asofDate();
+    QuantLib::ext::shared_ptr<Scenario> baseScenario = simMarket->baseScenario();
+    scenarioFactory = scenarioFactory ? scenarioFactory : QuantLib::ext::make_shared<CloneScenarioFactory>(baseScenario);
+    QuantLib::ext::shared_ptr<StressScenarioGenerator> scenarioGenerator = QuantLib::ext::make_shared<StressScenarioGenerator>(
+        stressData, baseScenario, simMarketData, simMarket, scenarioFactory, simMarket->baseScenarioAbsolute());
+    simMarket->scenarioGenerator() = scenarioGenerator;
+
+    auto ed = QuantLib::ext::make_shared<EngineData>(*engineData);
+    ed->globalParameters()["RunType"] = "Stress";
+
+    DLOG("Run Stress Scenarios");
+    MultiThreadedValuationEngine engine(
+        nThreads, asof, QuantLib::ext::make_shared<DateGrid>("1,0W", NullCalendar()), scenarioGenerator->samples(),
+        loader, scenarioGenerator, ed, curveConfigs, todaysMarketParams, marketConfiguration, simMarketData,
+        stressData->useSpreadedTermStructures(), false, QuantLib::ext::make_shared<ScenarioFilter>(), referenceData,
+        iborFallbackConfig, true, true, true, {}, {}, {}, "stress analysis", nullptr, sharedInputs);
+    engine.setTradeChunkSize(tradeChunkSize);
+    engine.registerProgressIndicator(QuantLib::ext::make_shared<ProgressLog>("stress scenarios", 100, oreSeverity::notice));
+
+    auto baseCcy = simMarketData->baseCcy();
+    engine.buildCube(portfolio, [&baseCcy]() -> std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> {
+        return {QuantLib::ext::make_shared<NPVCalculator>(baseCcy)};
+    });
+
+    collectResults(portfolio, QuantLib::ext::make_shared<JointNPVCube>(engine.outputCubes(), portfolio->ids()),
+                   scenarioGenerator);
+    LOG("Stress testing done");
+}
+
+void StressTest::collectResults(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+                                const QuantLib::ext::shared_ptr<NPVCube>& cube,
+                                const QuantLib::ext::shared_ptr<StressScenarioGenerator>& scenarioGenerator) {
     baseNPV_.clear();
     shiftedNPV_.clear();
     delta_.clear();
@@ -112,7 +173,6 @@ StressTest::StressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& po
             labels_.insert(label);
         }
     }
-    LOG("Stress testing done");
 }
 
 void StressTest::writeReport(const QuantLib::ext::shared_ptr<ore::data::Report>& report, Real outputThreshold) {
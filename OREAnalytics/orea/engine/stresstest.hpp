@@ -28,6 +28,7 @@
 #include <orea/scenario/scenariosimmarketparameters.hpp>
 #include <orea/scenario/stressscenariodata.hpp>
 #include <orea/scenario/stressscenariogenerator.hpp>
+#include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/market.hpp>
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/report/report.hpp>
@@ -50,11 +51,16 @@ namespace analytics {
   - fill result structures that can be queried
   - write stress test report to a file
 
+  The multi-threaded constructor generates the stress scenarios once on a simulation market built from the given
+  market and prices them using a MultiThreadedValuationEngine, the worker markets are built from the given loader.
+
   \ingroup simulation
 */
 class StressTest {
 public:
-    //! Constructor
+    /*! Constructor, if \p skipUnaffectedTrades is true and the observation mode is Disable, only the trades that
+        depend on a risk factor changed by a scenario are recalculated, see
+        ValuationEngine::setSkipUnaffectedTrades() */
     StressTest(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
                const QuantLib::ext::shared_ptr<ore::data::Market>& market, const string& marketConfiguration,
                const QuantLib::ext::shared_ptr<ore::data::EngineData>& engineData,
@@ -65,7 +71,21 @@ public:
                QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory = {},
                const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData = nullptr,
                const IborFallbackConfig& iborFallbackConfig = IborFallbackConfig::defaultConfig(),
-               bool continueOnError = false);
+               bool continueOnError = false, const bool skipUnaffectedTrades = false);
+
+    //! Constructor for multi-threaded runs, see MultiThreadedValuationEngine for \p sharedInputs, \p tradeChunkSize
+    StressTest(const Size nThreads, const QuantLib::ext::shared_ptr<ore::data::Loader>& loader,
+               const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+               const QuantLib::ext::shared_ptr<ore::data::Market>& market, const string& marketConfiguration,
+               const QuantLib::ext::shared_ptr<ore::data::EngineData>& engineData,
+               const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& simMarketData,
+               const QuantLib::ext::shared_ptr<StressTestScenarioData>& stressData,
+               const QuantLib::ext::shared_ptr<ore::data::CurveConfigurations>& curveConfigs,
+               const QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>& todaysMarketParams,
+               QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory = {},
+               const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData = nullptr,
+               const IborFallbackConfig& iborFallbackConfig = IborFallbackConfig::defaultConfig(),
+               bool continueOnError = false, const bool sharedInputs = false, const Size tradeChunkSize = 0);
 
     //! Return set of trades analysed
     const std::set<std::string>& trades() { return trades_; }
@@ -86,6 +106,11 @@ public:
     void writeReport(const QuantLib::ext::shared_ptr<ore::data::Report>& report, Real outputThreshold = 0.0);
 
 private:
+    // fill the result structures from the cube
+    void collectResults(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
+                        const QuantLib::ext::shared_ptr<NPVCube>& cube,
+                        const QuantLib::ext::shared_ptr<StressScenarioGenerator>& scenarioGenerator);
+
     // base NPV by trade
     std::map<std::string, Real> baseNPV_;
     // NPV respectively sensitivity by trade and scenario
@@ -18,24 +18,34 @@
 
 #include <orea/cube/npvcube.hpp>
 #include <orea/engine/cptycalculator.hpp>
+#include <orea/engine/cubecheckpoint.hpp>
 #include <orea/engine/observationmode.hpp>
+#include <orea/engine/observergraph.hpp>
+#include <orea/engine/sampleconsumer.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 #include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/scenariofilter.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
 #include <orea/simulation/simmarket.hpp>
 
 #include <ored/portfolio/optionwrapper.hpp>
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/portfolio/structuredtradeerror.hpp>
 #include <ored/utilities/dategrid.hpp>
+#include <ored/utilities/indexparser.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/parsers.hpp>
 #include <ored/utilities/progressbar.hpp>
+#include <ored/utilities/timers.hpp>
 #include <ored/utilities/to_string.hpp>
 
 #include <ql/errors.hpp>
 
 #include <boost/timer/timer.hpp>
 
+#include <algorithm>
+#include <chrono>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -67,17 +77,157 @@ void ValuationEngine::recalibrateModels() {
     }
 }
 
+ValuationEngine::PricingProfile& ValuationEngine::PricingProfile::operator+=(const PricingProfile& p) {
+    if (tradeType.empty())
+        tradeType = p.tradeType;
+    if (pricingEngine.empty())
+        pricingEngine = p.pricingEngine;
+    pricings += p.pricings;
+    notification += p.notification;
+    marketRecalculation += p.marketRecalculation;
+    engine += p.engine;
+    calculators += p.calculators;
+    return *this;
+}
+
+namespace {
+double seconds(const std::chrono::steady_clock::time_point& start, const std::chrono::steady_clock::time_point& end) {
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// risk factors that are read by the aggregation scenario data or the calculators and therefore never pruned
+std::set<ObserverGraph::RiskFactor> unprunableRiskFactors(const ScenarioSimMarket& ssm) {
+    std::set<ObserverGraph::RiskFactor> result;
+    bool allCurves = false;
+    if (ssm.aggregationScenarioData()) {
+        for (auto const& i : ssm.parameters()->additionalScenarioDataIndices()) {
+            QuantLib::ext::shared_ptr<IborIndex> index;
+            if (tryParseIborIndex(i, index))
+                result.insert(std::make_pair(RiskFactorKey::KeyType::IndexCurve, i));
+            else
+                allCurves = true;
+        }
+    }
+    for (auto const& [key, quote] : ssm.simData()) {
+        if (key.keytype == RiskFactorKey::KeyType::FXSpot ||
+            (allCurves && (key.keytype == RiskFactorKey::KeyType::IndexCurve ||
+                           key.keytype == RiskFactorKey::KeyType::DiscountCurve ||
+                           key.keytype == RiskFactorKey::KeyType::YieldCurve)))
+            result.insert(std::make_pair(key.keytype, key.name));
+    }
+    return result;
+}
+} // namespace
+
+void ValuationEngine::initTradeRiskFactors(const QuantLib::ext::shared_ptr<data::Portfolio>& portfolio,
+                                           const bool allowPruning) {
+
+    riskFactorTrades_.clear();
+    tradeRecalculation_.clear();
+    tradeAlwaysRecalculated_.clear();
+    skippedCalculations_ = 0;
+    observerGraph_.reset();
+
+    auto ssm = QuantLib::ext::dynamic_pointer_cast<ScenarioSimMarket>(simMarket_);
+    bool skip = skipUnaffectedTrades_;
+    if (skip && (ssm == nullptr || ObservationMode::instance().mode() != ObservationMode::Mode::Disable ||
+                 dg_->dates().size() != 1)) {
+        WLOG("ValuationEngine: skipping of unaffected trades requires a ScenarioSimMarket, observation mode "
+             "Disable and a single valuation date, all trades are recalculated for all scenarios");
+        skip = false;
+    }
+    bool prune = pruneObservers_;
+    if (prune && !allowPruning) {
+        WLOG("ValuationEngine: pruning of observers is not supported with counterparty calculators, it is disabled");
+        prune = false;
+    }
+    bool graph = skip || prune || observerStatistics_;
+    if (graph && ssm == nullptr) {
+        WLOG("ValuationEngine: observer statistics and pruning require a ScenarioSimMarket, they are disabled");
+        graph = false;
+    }
+    if (graph && !ObservableSettings::instance().updatesEnabled()) {
+        WLOG("ValuationEngine: skipping of unaffected trades, observer statistics and pruning require enabled updates "
+             "when building the cube, they are disabled");
+        graph = false;
+    }
+    if (!graph) {
+        if (ssm)
+            ssm->trackChangedKeys(false);
+        return;
+    }
+
+    LOG("ValuationEngine: determine risk factors of " << portfolio->size() << " trades");
+
+    observerGraph_ = QuantLib::ext::make_shared<ObserverGraph>(ssm, portfolio, modelBuilders_);
+    observerGraph_->analyse();
+
+    if (prune) {
+        auto pruned = observerGraph_->prune(unprunableRiskFactors(*ssm));
+        if (!pruned.empty())
+            ssm->filter() = QuantLib::ext::make_shared<ExcludedRiskFactorScenarioFilter>(ssm->filter(), pruned);
+    }
+
+    if (observerStatistics_)
+        observerGraph_->startRecording();
+
+    if (!skip) {
+        ssm->trackChangedKeys(false);
+        return;
+    }
+
+    riskFactorTrades_ = observerGraph_->riskFactorTrades();
+    tradeAlwaysRecalculated_ = observerGraph_->failedTrades();
+
+    Size nAlways = std::count(tradeAlwaysRecalculated_.begin(), tradeAlwaysRecalculated_.end(), true);
+    LOG("ValuationEngine: risk factors determined for " << riskFactorTrades_.size() << " risk factors, " << nAlways
+                                                        << " trades will be recalculated for all scenarios");
+
+    tradeRecalculation_.resize(portfolio->size(), true);
+    ssm->trackChangedKeys(true);
+}
+
+void ValuationEngine::updateTradeRecalculation() {
+    if (tradeRecalculation_.empty())
+        return;
+    auto ssm = QuantLib::ext::dynamic_pointer_cast<ScenarioSimMarket>(simMarket_);
+    for (auto const& key : ssm->changedKeys()) {
+        auto rf = riskFactorTrades_.find(std::make_pair(key.keytype, key.name));
+        if (rf == riskFactorTrades_.end()) {
+            // unknown risk factor, recalculate all trades
+            std::fill(tradeRecalculation_.begin(), tradeRecalculation_.end(), true);
+            return;
+        }
+        for (auto j : rf->second)
+            tradeRecalculation_[j] = true;
+    }
+}
+
 void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>& portfolio,
                                 QuantLib::ext::shared_ptr<analytics::NPVCube> outputCube,
                                 vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators, bool mporStickyDate,
                                 QuantLib::ext::shared_ptr<analytics::NPVCube> outputCubeNettingSet,
                                 QuantLib::ext::shared_ptr<analytics::NPVCube> outputCptyCube,
-                                vector<QuantLib::ext::shared_ptr<CounterpartyCalculator>> cptyCalculators, bool dryRun) {
+                                vector<QuantLib::ext::shared_ptr<CounterpartyCalculator>> cptyCalculators, bool dryRun,
+                                const Size firstSample, const Size numberOfSamples) {
+
+    ORE_TIMER("valuation engine");
 
     struct SimMarketResetter {
-        SimMarketResetter(QuantLib::ext::shared_ptr<SimMarket> simMarket) : simMarket_(simMarket) {}
-        ~SimMarketResetter() { simMarket_->reset(); }
+        SimMarketResetter(QuantLib::ext::shared_ptr<SimMarket> simMarket) : simMarket_(simMarket) {
+            // the filter is replaced if observers are pruned
+            if (auto ssm = QuantLib::ext::dynamic_pointer_cast<ScenarioSimMarket>(simMarket_))
+                filter_ = ssm->filter();
+        }
+        ~SimMarketResetter() {
+            if (auto ssm = QuantLib::ext::dynamic_pointer_cast<ScenarioSimMarket>(simMarket_)) {
+                ssm->trackChangedKeys(false);
+                ssm->filter() = filter_;
+            }
+            simMarket_->reset();
+        }
         QuantLib::ext::shared_ptr<SimMarket> simMarket_;
+        QuantLib::ext::shared_ptr<ScenarioFilter> filter_;
     } simMarketResetter(simMarket_);
 
     LOG("Build cube with mporStickyDate=" << mporStickyDate << ", dryRun=" << std::boolalpha << dryRun);
@@ -105,8 +255,34 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
                                                                           << dg_->dates().size() << ")");
     }
 
+    const bool sampleSlice = numberOfSamples != Null<Size>();
+    if (sampleSlice) {
+        QL_REQUIRE(firstSample + numberOfSamples <= outputCube->samples(),
+                   "ValuationEngine: sample slice [" << firstSample << "," << firstSample + numberOfSamples
+                                                     << ") exceeds number of samples in cube (" << outputCube->samples()
+                                                     << ")");
+        QL_REQUIRE(!dryRun, "ValuationEngine: dry run is not supported for sample slices");
+    }
+
     LOG("Starting ValuationEngine for " << portfolio->size() << " trades, " << outputCube->samples() << " samples and "
                                         << dg_->size() << " dates.");
+    if (firstSample != 0 || sampleSlice) {
+        LOG("Computing samples starting at " << firstSample << ", number of samples "
+                                             << (sampleSlice ? std::to_string(numberOfSamples) : "all"));
+    }
+
+    failedTrades_.clear();
+
+    pricingProfiles_.clear();
+    tradeProfiles_.clear();
+    if (profiling_) {
+        LOG("ValuationEngine: profiling of trade pricings is enabled");
+        for (auto const& [tradeId, trade] : portfolio->trades()) {
+            tradeProfiles_.push_back(PricingProfile());
+            tradeProfiles_.back().tradeType = trade->tradeType();
+            tradeProfiles_.back().pricingEngine = trade->pricingEngine();
+        }
+    }
 
     ObservationMode::Mode om = ObservationMode::instance().mode();
     Real updateTime = 0.0;
@@ -135,14 +311,16 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
 
         recalibrateModels();
 
-        // T0 values
-        try {
-            for (auto& calc : calculators)
-                calc->calculateT0(trade, i, simMarket_, outputCube, outputCubeNettingSet);
-        } catch (const std::exception& e) {
-            string expMsg = string("T0 valuation error: ") + e.what();
-            StructuredTradeErrorMessage(tradeId, trade->tradeType(), "ScenarioValuation", expMsg.c_str()).log();
-            tradeHasError[i] = true;
+        // T0 values, these are only written by the run covering the first sample
+        if (firstSample == 0) {
+            try {
+                for (auto& calc : calculators)
+                    calc->calculateT0(trade, i, simMarket_, outputCube, outputCubeNettingSet);
+            } catch (const std::exception& e) {
+                string expMsg = string("T0 valuation error: ") + e.what();
+                StructuredTradeErrorMessage(tradeId, trade->tradeType(), "ScenarioValuation", expMsg.c_str()).log();
+                tradeHasError[i] = true;
+            }
         }
 
         if (om == ObservationMode::Mode::Unregister) {
@@ -169,16 +347,49 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
         simMarket_->fixingManager()->initialise(portfolio, simMarket_);
     }
 
+    initTradeRiskFactors(portfolio, cptyCalculators.empty() && outputCptyCube == nullptr);
+
     cpu_timer timer;
     cpu_timer loopTimer;
     Size nTrades = trades.size();
 
     // We call Cube::samples() each time here to allow for dynamic stopping times
-    // e.g. MC convergence tests
-    for (Size sample = 0; sample < (dryRun ? std::min<Size>(1, outputCube->samples()) : outputCube->samples());
-         ++sample) {
+    // e.g. MC convergence tests, unless a sample slice is given
+    auto endSample = [&outputCube, dryRun, sampleSlice, firstSample, numberOfSamples]() {
+        if (sampleSlice)
+            return firstSample + numberOfSamples;
+        return dryRun ? std::min<Size>(1, outputCube->samples()) : outputCube->samples();
+    };
+    // restore the samples completed by a previous, interrupted run from the checkpoint
+
+    bool checkpoint = checkpoint_ && !dryRun;
+    if (checkpoint && (outputCubeNettingSet || outputCptyCube)) {
+        WLOG("ValuationEngine: checkpointing is not supported with netting set or counterparty cubes, it is disabled");
+        checkpoint = false;
+    }
+    Size restoredSamples = 0;
+    if (checkpoint) {
+        std::set<std::string> restoredFailures;
+        restoredSamples = checkpoint_->restore(outputCube, firstSample, endSample(), restoredFailures);
+        i = 0;
+        for (auto const& [tradeId, trade] : trades) {
+            if (restoredFailures.count(tradeId))
+                tradeHasError[i] = true;
+            ++i;
+        }
+        if (restoredSamples > 0)
+            LOG("ValuationEngine: " << restoredSamples << " samples restored from checkpoint "
+                                    << checkpoint_->directory() << ", they are not priced again");
+    }
+    Size checkpointedSamples = restoredSamples;
+
+    completedSamples_ = 0;
+    Size consumedSamples = 0;
+    for (Size sample = firstSample; sample < endSample(); ++sample) {
         TLOG("ValuationEngine: apply scenario sample #" << sample);
 
+        const bool restored = sample < firstSample + restoredSamples;
+
         for (auto& [tradeId, trade] : portfolio->trades())
             trade->instrument()->reset();
 
@@ -193,15 +404,17 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
                 ++cubeDateIndex;
                 Date valueDate = dg_->valuationDates()[i];
                 Date closeOutDate = dg_->closeOutDateFromValuationDate(valueDate);
-                std::tie(priceTime, upTime) = populateCube(
-                    valueDate, cubeDateIndex, sample, true, false, scenarioUpdated, trades, tradeHasError, calculators,
-                    outputCube, outputCubeNettingSet, counterparties, cptyCalculators, outputCptyCube);
+                std::tie(priceTime, upTime) = populateCube(valueDate, cubeDateIndex, sample, true, false,
+                                                           scenarioUpdated, restored, trades, tradeHasError, calculators,
+                                                           outputCube, outputCubeNettingSet, counterparties,
+                                                           cptyCalculators, outputCptyCube);
                 pricingTime += priceTime;
                 updateTime += upTime;
                 if(closeOutDate != Date()){
                     std::tie(priceTime, upTime) = populateCube(
-                        closeOutDate, cubeDateIndex, sample, false, mporStickyDate, scenarioUpdated, trades, tradeHasError,
-                        calculators, outputCube, outputCubeNettingSet, counterparties, cptyCalculators, outputCptyCube);
+                        closeOutDate, cubeDateIndex, sample, false, mporStickyDate, scenarioUpdated, restored, trades,
+                        tradeHasError, calculators, outputCube, outputCubeNettingSet, counterparties, cptyCalculators,
+                        outputCptyCube);
                     pricingTime += priceTime;
                     updateTime += upTime;
                 }
@@ -222,9 +435,9 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
                                "Need to calculate valuation date before close out date");
                     for (size_t& valueDateIndex : closeOutDateToValueDateIndex[d]) {
                         std::tie(priceTime, upTime) =
-                            populateCube(d, valueDateIndex, sample, false, mporStickyDate, scenarioUpdated, trades,
-                                         tradeHasError, calculators, outputCube, outputCubeNettingSet, counterparties,
-                                         cptyCalculators, outputCptyCube);
+                            populateCube(d, valueDateIndex, sample, false, mporStickyDate, scenarioUpdated, restored,
+                                         trades, tradeHasError, calculators, outputCube, outputCubeNettingSet,
+                                         counterparties, cptyCalculators, outputCptyCube);
                         pricingTime += priceTime;
                         updateTime += upTime;
                         scenarioUpdated = true;
@@ -238,8 +451,8 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
                     if(closeOutDate != Date())
                         closeOutDateToValueDateIndex[closeOutDate].push_back(cubeDateIndex);
                     std::tie(priceTime, upTime) = populateCube(
-                        d, cubeDateIndex, sample, true, false, scenarioUpdated, trades, tradeHasError, calculators,
-                        outputCube, outputCubeNettingSet, counterparties, cptyCalculators, outputCptyCube);
+                        d, cubeDateIndex, sample, true, false, scenarioUpdated, restored, trades, tradeHasError,
+                        calculators, outputCube, outputCubeNettingSet, counterparties, cptyCalculators, outputCptyCube);
                     pricingTime += priceTime;
                     updateTime += upTime;
                     scenarioUpdated = true;
@@ -250,13 +463,39 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
         std::ostringstream detail;
         detail << nTrades << " trade" << (nTrades == 1 ? "" : "s") << ", " << outputCube->samples() << " sample"
                << (outputCube->samples() == 1 ? "" : "s");
-        updateProgress(sample * nTrades, outputCube->samples() * nTrades, detail.str());
+        updateProgress((sample - firstSample) * nTrades, (endSample() - firstSample) * nTrades, detail.str());
 
         timer.start();
         simMarket_->fixingManager()->reset();
         fixingTime += timer.elapsed().wall * 1e-9;
+
+        completedSamples_ = sample + 1 - firstSample;
+        if (checkpoint && (completedSamples_ - checkpointedSamples == checkpointBlockSize_ ||
+                           (sample + 1 == endSample() && completedSamples_ > checkpointedSamples))) {
+            std::set<std::string> failures;
+            Size j = 0;
+            for (auto const& [tradeId, trade] : trades) {
+                if (tradeHasError[j++])
+                    failures.insert(tradeId);
+            }
+            checkpoint_->save(outputCube, firstSample + checkpointedSamples, sample + 1, failures);
+            checkpointedSamples = completedSamples_;
+        }
+        if (sampleConsumer_ && !dryRun &&
+            (completedSamples_ - consumedSamples == sampleConsumerBlockSize_ || sample + 1 == endSample())) {
+            bool cont = sampleConsumer_->consume(outputCube, firstSample + consumedSamples, sample + 1);
+            consumedSamples = completedSamples_;
+            if (!cont) {
+                LOG("ValuationEngine: sample consumer stops the simulation after " << completedSamples_
+                                                                                   << " samples");
+                break;
+            }
+        }
     }
 
+    if (sampleConsumer_ && !dryRun)
+        sampleConsumer_->finish();
+
     if (dryRun) {
         LOG("Doing a dry run - fill remaining cube with random values.");
         for (Size sample = 1; sample < outputCube->samples(); ++sample) {
@@ -276,31 +515,60 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
     std::ostringstream detail;
     detail << nTrades << " trade" << (nTrades == 1 ? "" : "s") << ", " << outputCube->samples() << " sample"
            << (outputCube->samples() == 1 ? "" : "s");
-    updateProgress(outputCube->samples() * nTrades, outputCube->samples() * nTrades, detail.str());
+    updateProgress((endSample() - firstSample) * nTrades, (endSample() - firstSample) * nTrades, detail.str());
     loopTimer.stop();
     LOG("ValuationEngine completed: loop " << setprecision(2) << loopTimer.format(2, "%w") << " sec, "
                                            << "pricing " << pricingTime << " sec, "
                                            << "update " << updateTime << " sec "
                                            << "fixing " << fixingTime);
+    if (!tradeRecalculation_.empty()) {
+        LOG("ValuationEngine: skipped " << skippedCalculations_ << " trade recalculations not affected by the "
+                                        << "scenario");
+        tradeRecalculation_.clear();
+    }
 
-    // for trades with errors set all output cube values to zero
+    if (profiling_) {
+        i = 0;
+        for (auto const& [tradeId, trade] : trades)
+            pricingProfiles_[tradeId] = tradeProfiles_[i++];
+        tradeProfiles_.clear();
+    }
+
+    // for trades with errors set all output cube values to zero, for sample slices this is left to the caller
     i = 0;
     for (auto& [tradeId, trade] : trades) {
         if (tradeHasError[i]) {
-            ALOG("setting all results in output cube to zero for trade '"
-                 << tradeId << "' since there was at least one error during simulation");
-            outputCube->remove(i);
+            failedTrades_.insert(tradeId);
+            if (!sampleSlice) {
+                ALOG("setting all results in output cube to zero for trade '"
+                     << tradeId << "' since there was at least one error during simulation");
+                outputCube->remove(i);
+            }
         }
         i++;
     }
 }
 
+void ValuationEngine::registerSampleConsumer(const QuantLib::ext::shared_ptr<SampleConsumer>& consumer,
+                                             const Size blockSize) {
+    QL_REQUIRE(blockSize > 0, "ValuationEngine: sample consumer block size must be positive");
+    sampleConsumer_ = consumer;
+    sampleConsumerBlockSize_ = blockSize;
+}
+
+void ValuationEngine::setCheckpoint(const QuantLib::ext::shared_ptr<CubeCheckpoint>& checkpoint, const Size blockSize) {
+    QL_REQUIRE(blockSize > 0, "ValuationEngine: checkpoint block size must be positive");
+    checkpoint_ = checkpoint;
+    checkpointBlockSize_ = blockSize;
+}
+
 void ValuationEngine::runCalculators(bool isCloseOutDate, const std::map<std::string, QuantLib::ext::shared_ptr<Trade>>& trades,
                                      std::vector<bool>& tradeHasError,
                                      const std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>>& calculators,
                                      QuantLib::ext::shared_ptr<analytics::NPVCube>& outputCube,
                                      QuantLib::ext::shared_ptr<analytics::NPVCube>& outputCubeNettingSet, const Date& d,
                                      const Size cubeDateIndex, const Size sample, const string& label) {
+    ORE_TIMER("pricing");
     ObservationMode::Mode om = ObservationMode::instance().mode();
     for (auto& calc : calculators)
         calc->initScenario();
@@ -312,13 +580,56 @@ void ValuationEngine::runCalculators(bool isCloseOutDate, const std::map<std::st
             continue;
         }
 
-        // We can avoid checking mode here and always call updateQlInstruments()
-        if (om == ObservationMode::Mode::Disable || om == ObservationMode::Mode::Unregister)
-            trade->instrument()->updateQlInstruments();
+        std::chrono::steady_clock::time_point start;
+        if (profiling_)
+            start = std::chrono::steady_clock::now();
+
+        // We can avoid checking mode here and always call updateQlInstruments(), unless the trade does not
+        // depend on any risk factor changed since its last calculation
+        bool updated = false, skipped = false;
+        if (om == ObservationMode::Mode::Disable || om == ObservationMode::Mode::Unregister) {
+            if (tradeRecalculation_.empty() || tradeRecalculation_[j] || tradeAlwaysRecalculated_[j]) {
+                trade->instrument()->updateQlInstruments();
+                updated = true;
+                if (!tradeRecalculation_.empty())
+                    tradeRecalculation_[j] = false;
+            } else {
+                ++skippedCalculations_;
+                skipped = true;
+            }
+        }
+        if (observerStatistics_ && observerGraph_)
+            observerGraph_->recordPricing(j, updated);
         try {
+            if (profiling_) {
+                /* the first calculation includes the recalculation of the market objects the trade depends on, the
+                   forced second calculation the engine only, the calculators then use the cached results. A skipped
+                   trade keeps its results from the last pricing, forcing a recalculation would distort the profile */
+                auto& p = tradeProfiles_[j];
+                auto notified = std::chrono::steady_clock::now();
+                p.notification += seconds(start, notified);
+                start = notified;
+                auto const& ql = trade->instrument()->qlInstrument();
+                if (ql && !skipped) {
+                    ql->NPV();
+                    auto calculated = std::chrono::steady_clock::now();
+                    ql->recalculate();
+                    auto recalculated = std::chrono::steady_clock::now();
+                    double first = seconds(start, calculated);
+                    double engine = std::min(first, seconds(calculated, recalculated));
+                    p.engine += engine;
+                    p.marketRecalculation += first - engine;
+                    start = recalculated;
+                }
+            }
             for (auto& calc : calculators)
                 calc->calculate(trade, j, simMarket_, outputCube, outputCubeNettingSet, d, cubeDateIndex, sample,
                                 isCloseOutDate);
+            if (profiling_) {
+                tradeProfiles_[j].calculators += seconds(start, std::chrono::steady_clock::now());
+                if (!skipped)
+                    ++tradeProfiles_[j].pricings;
+            }
         } catch (const std::exception& e) {
             string expMsg = "date = " + ore::data::to_string(io::iso_date(d)) +
                             ", sample = " + ore::data::to_string(sample) + ", label = " + label + ": " + e.what();
@@ -354,7 +665,7 @@ void ValuationEngine::tradeExercisable(bool enable, const std::map<std::string,
 
 std::pair<double, double> ValuationEngine::populateCube(
     const QuantLib::Date& d, size_t cubeDateIndex, size_t sample, bool isValueDate, bool isStickyDate,
-    bool scenarioUpdated, const std::map<std::string, QuantLib::ext::shared_ptr<Trade>>& trades,
+    bool scenarioUpdated, bool restored, const std::map<std::string, QuantLib::ext::shared_ptr<Trade>>& trades,
     std::vector<bool>& tradeHasError, const std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>>& calculators,
     QuantLib::ext::shared_ptr<analytics::NPVCube>& outputCube, QuantLib::ext::shared_ptr<analytics::NPVCube>& outputCubeNettingSet,
     const std::map<string, Size>& counterparties,
@@ -365,25 +676,34 @@ std::pair<double, double> ValuationEngine::populateCube(
     QL_REQUIRE(cubeDateIndex >= 0, "first date should be a valuation date");
     cpu_timer timer;
     timer.start();
-    simMarket_->preUpdate();
-    if (isValueDate || !isStickyDate) {
-        simMarket_->updateDate(d);
-    }
-    // We can skip this step, if we have done that above in the close-out date section
-    if (!scenarioUpdated) {
-        simMarket_->updateScenario(d);
-    }
-    // Always with fixing update here, in contrast to the close-out date section
-    simMarket_->postUpdate(d, !isStickyDate || isValueDate);
-    // Aggregation scenario data update on valuation dates only
-    if (isValueDate) {
-        simMarket_->updateAsd(d);
+    {
+        ORE_TIMER("sim market update");
+        simMarket_->preUpdate();
+        if (isValueDate || !isStickyDate) {
+            simMarket_->updateDate(d);
+        }
+        // We can skip this step, if we have done that above in the close-out date section
+        if (!scenarioUpdated) {
+            simMarket_->updateScenario(d);
+        }
+        // Always with fixing update here, in contrast to the close-out date section
+        simMarket_->postUpdate(d, !isStickyDate || isValueDate);
+        if (!scenarioUpdated)
+            updateTradeRecalculation();
+        // Aggregation scenario data update on valuation dates only
+        if (isValueDate) {
+            simMarket_->updateAsd(d);
+        }
+        recalibrateModels();
     }
-    recalibrateModels();
 
     timer.stop();
     updateTime += timer.elapsed().wall * 1e-9;
 
+    // the results of restored samples are in the cube already, close-out values may be filled later
+    if (restored || (skipCloseOutPricing_ && !isValueDate))
+        return std::make_pair(pricingTime, updateTime);
+
     timer.start();
     if (isStickyDate && !isValueDate) // switch on again, if sticky
         tradeExercisable(false, trades);
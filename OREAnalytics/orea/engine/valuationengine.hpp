@@ -23,9 +23,12 @@
 
 #pragma once
 
+#include <orea/scenario/scenario.hpp>
+
 #include <ored/utilities/progressbar.hpp>
 
 #include <ql/time/date.hpp>
+#include <ql/utilities/null.hpp>
 
 #include <map>
 #include <set>
@@ -45,6 +48,9 @@ namespace analytics {
 
 class NPVCube;
 class CounterpartyCalculator;
+class CubeCheckpoint;
+class ObserverGraph;
+class SampleConsumer;
 class ValuationCalculator;
 class SimMarket;
 
@@ -64,6 +70,13 @@ using std::set;
   In addition to storing the resulting NPVs it can be given any number of calculators
   that can store additional values in the cube.
 
+  If skipping of unaffected trades is enabled, see setSkipUnaffectedTrades(), the engine determines before the
+  first sample which risk factors (key type and name) each trade depends on. This is done by notifying the sim data
+  quotes of each risk factor in turn and recording which trade instruments receive the notification. In observation
+  mode Disable, trades are then only recalculated if one of their risk factors changed since their last
+  calculation. Otherwise the NPV cached in the instrument is passed to the calculators, which for sensitivity and
+  stress scenarios is the base NPV. This requires a ScenarioSimMarket and a single valuation date.
+
   \ingroup simulation
 */
 class ValuationEngine : public ore::data::ProgressReporter {
@@ -97,12 +110,88 @@ public:
         //! Calculators for filling counterparty-level results
         std::vector<QuantLib::ext::shared_ptr<CounterpartyCalculator>> cptyCalculators = {},
         //! Limit samples to one and fill the rest of the cube with random values
-        bool dryRun = false);
+        bool dryRun = false,
+        /*! First sample to compute. If this is > 0 the scenario generator of the sim market must be positioned
+            such that it delivers the paths starting at this sample. T0 values are only written if firstSample = 0. */
+        const QuantLib::Size firstSample = 0,
+        /*! Number of samples to compute. If not given, all samples in the output cube starting at firstSample are
+            computed. If given, the engine does not zero the results of failed trades in the output cube, this is
+            left to the caller, see failedTrades(). */
+        const QuantLib::Size numberOfSamples = QuantLib::Null<QuantLib::Size>());
+
+    //! Ids of the trades for which errors occured during the last buildCube() call
+    const std::set<std::string>& failedTrades() const { return failedTrades_; }
+
+    //! Enable skipping of the recalculation of trades that do not depend on the risk factors changed by a scenario
+    void setSkipUnaffectedTrades(const bool b) { skipUnaffectedTrades_ = b; }
+
+    /*! Enable the recording of notification statistics per trade and risk factor, see ObserverGraph. Requires a
+        ScenarioSimMarket. */
+    void setObserverStatistics(const bool b) { observerStatistics_ = b; }
+
+    /*! Enable the pruning of risk factors that no trade depends on, see ObserverGraph. Their quotes are excluded from
+        the scenario updates of the sim market, so that they do not send notifications. FX spots and the risk factors
+        required by the aggregation scenario data are never pruned. Requires a ScenarioSimMarket and is not supported
+        with counterparty calculators. */
+    void setPruneObservers(const bool b) { pruneObservers_ = b; }
+
+    //! The observer graph of the last buildCube() call, null if neither statistics nor pruning nor skipping is enabled
+    const QuantLib::ext::shared_ptr<ObserverGraph>& observerGraph() const { return observerGraph_; }
+
+    /*! Pass the completed samples of the output cube to the consumer in blocks of \p blockSize samples. If the
+        consumer returns false, the engine stops after the current block, see completedSamples(). Not used in dry
+        runs. */
+    void registerSampleConsumer(const QuantLib::ext::shared_ptr<SampleConsumer>& consumer,
+                                const QuantLib::Size blockSize = 100);
+
+    //! The number of samples computed by the last buildCube() call, starting at firstSample
+    QuantLib::Size completedSamples() const { return completedSamples_; }
+
+    /*! Save the completed samples of the output cube to the checkpoint in blocks of \p blockSize samples. The samples
+        restored from the checkpoint at the start of buildCube() are not priced again, the simulation market is
+        still updated for them, so that the scenario generator and the aggregation scenario data are in the same state
+        as in an uninterrupted run. Not used in dry runs and not supported with netting set or counterparty cubes. */
+    void setCheckpoint(const QuantLib::ext::shared_ptr<CubeCheckpoint>& checkpoint,
+                       const QuantLib::Size blockSize = 100);
+
+    //! Time spent on the pricings of a trade, in seconds
+    struct PricingProfile {
+        std::string tradeType, pricingEngine;
+        //! number of pricings, excluding the dates on which the trade was skipped as its risk factors did not change
+        QuantLib::Size pricings = 0;
+        //! instrument update, i.e. observer notification in observation modes Disable and Unregister
+        double notification = 0.0;
+        //! recalculation of the market objects (term structures, vol surfaces, ...) the trade triggers
+        double marketRecalculation = 0.0;
+        //! pricing engine calculation
+        double engine = 0.0;
+        //! valuation calculators, e.g. additional instruments and cash flow generation
+        double calculators = 0.0;
+        double total() const { return notification + marketRecalculation + engine + calculators; }
+        PricingProfile& operator+=(const PricingProfile& p);
+    };
+
+    /*! Enable the profiling of the trade pricings. The time of each pricing is attributed to the observer
+        notification, the market object recalculation triggered by the trade, the pricing engine and the valuation
+        calculators. To separate the market object recalculation from the engine, the instrument is recalculated a
+        second time after its first calculation on each date, so that profiling runs take longer. The notification
+        of the sim market quotes in observation mode None is not attributable to trades and part of the market update
+        time. */
+    void setProfiling(const bool b) { profiling_ = b; }
+
+    //! The pricing profiles of the trades by trade id from the last buildCube() call, if profiling is enabled
+    const std::map<std::string, PricingProfile>& pricingProfiles() const { return pricingProfiles_; }
+
+    /*! Skip the trade pricing on close-out dates. The sim market is still updated on these dates to keep the scenario
+        generation in sync, the close-out values are filled after the cube build, see CloseOutRegression. */
+    void setSkipCloseOutPricing(const bool b) { skipCloseOutPricing_ = b; }
 
 private:
     void recalibrateModels();
+    void initTradeRiskFactors(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio, bool allowPruning);
+    void updateTradeRecalculation();
     std::pair<double, double> populateCube(const QuantLib::Date& d, size_t cubeDateIndex, size_t sample,
-                                           bool isValueDate, bool isStickyDate, bool scenarioUpdated,
+                                           bool isValueDate, bool isStickyDate, bool scenarioUpdated, bool restored,
                                            const std::map<std::string, QuantLib::ext::shared_ptr<ore::data::Trade>>& trades,
                                            std::vector<bool>& tradeHasError,
                                            const std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>>& calculators,
@@ -126,6 +215,26 @@ private:
     QuantLib::ext::shared_ptr<ore::data::DateGrid> dg_;
     QuantLib::ext::shared_ptr<ore::analytics::SimMarket> simMarket_;
     set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>> modelBuilders_;
+    std::set<std::string> failedTrades_;
+
+    bool skipUnaffectedTrades_ = false;
+    bool observerStatistics_ = false;
+    bool pruneObservers_ = false;
+    QuantLib::ext::shared_ptr<ObserverGraph> observerGraph_;
+    // trade indices depending on each risk factor, trades that need a recalculation (empty if skipping is not active)
+    std::map<std::pair<RiskFactorKey::KeyType, std::string>, std::vector<QuantLib::Size>> riskFactorTrades_;
+    std::vector<bool> tradeRecalculation_;
+    std::vector<bool> tradeAlwaysRecalculated_;
+    QuantLib::Size skippedCalculations_ = 0;
+    QuantLib::ext::shared_ptr<SampleConsumer> sampleConsumer_;
+    QuantLib::Size sampleConsumerBlockSize_ = 100;
+    QuantLib::Size completedSamples_ = 0;
+    QuantLib::ext::shared_ptr<CubeCheckpoint> checkpoint_;
+    QuantLib::Size checkpointBlockSize_ = 100;
+    bool profiling_ = false;
+    bool skipCloseOutPricing_ = false;
+    std::vector<PricingProfile> tradeProfiles_;
+    std::map<std::string, PricingProfile> pricingProfiles_;
 };
 } // namespace analytics
 } // namespace ore
@@ -36,8 +36,6 @@ void VarReport::createReports(const ext::shared_ptr<MarketRiskReport::Reports>&
     report->addColumn("Portfolio", string()).addColumn("RiskClass", string()).addColumn("RiskType", string());
     for (Size i = 0; i < p_.size(); ++i)
         report->addColumn("Quantile_" + std::to_string(p_[i]), double(), 6);
-
-    createVarCalculator();
 }
 
 void VarReport::writeReports(const ext::shared_ptr<MarketRiskReport::Reports>& reports,
@@ -50,19 +48,19 @@ void VarReport::writeReports(const ext::shared_ptr<MarketRiskReport::Reports>& r
     auto rg = ext::dynamic_pointer_cast<MarketRiskGroup>(riskGroup);
     auto tg = ext::dynamic_pointer_cast<TradeGroup>(tradeGroup);
 
-    std::vector<Real> var;
-    auto quantiles = p();
-    for (auto q : quantiles)
-        var.push_back(varCalculator_->var(q));
-
-    if (!close_enough(QuantExt::detail::absMax(var), 0.0)) {
-        report->next();
-        report->add(tg->portfolioId());
-        report->add(to_string(rg->riskClass()));
-        report->add(to_string(rg->riskType()));
-        for (auto const& v : var)
-            report->add(v);
-    }
+    // the VaR is computed in parallel with the other trade groups of the risk group, the rows are written in order
+    auto var = QuantLib::ext::make_shared<std::vector<Real>>();
+    addBreakdownTask([var, f = varFunction()]() { *var = f(); },
+                     [report, rg, tg, var]() {
+                         if (!close_enough(QuantExt::detail::absMax(*var), 0.0)) {
+                             report->next();
+                             report->add(tg->portfolioId());
+                             report->add(to_string(rg->riskClass()));
+                             report->add(to_string(rg->riskType()));
+                             for (auto const& v : *var)
+                                 report->add(v);
+                         }
+                     });
 }
 
 } // namespace analytics
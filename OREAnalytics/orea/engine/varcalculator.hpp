@@ -37,6 +37,15 @@ public:
 
     virtual QuantLib::Real var(QuantLib::Real confidence, const bool isCall = true, 
         const std::set<std::pair<std::string, QuantLib::Size>>& tradeIds = {}) = 0;
+
+    //! The VaR for each of the given confidence levels, by default var() is called for each level
+    virtual std::vector<QuantLib::Real> vars(const std::vector<QuantLib::Real>& confidences, const bool isCall = true,
+                                             const std::set<std::pair<std::string, QuantLib::Size>>& tradeIds = {}) {
+        std::vector<QuantLib::Real> result;
+        for (auto const& c : confidences)
+            result.push_back(var(c, isCall, tradeIds));
+        return result;
+    }
 };
 
 class VarReport : public MarketRiskReport {
@@ -54,9 +63,10 @@ public:
     const std::vector<Real>& p() const { return p_; }
 
 protected:
-    QuantLib::ext::shared_ptr<VarCalculator> varCalculator_;
-    
-    virtual void createVarCalculator() = 0;
+    /*! The VaR of the current risk and trade group for each of the quantiles p(). The function is called on one of the
+        breakdown threads, see MarketRiskReport::addBreakdownTask(), so it must own copies of its inputs. */
+    virtual std::function<std::vector<QuantLib::Real>()> varFunction() = 0;
+
     void writeReports(const QuantLib::ext::shared_ptr<MarketRiskReport::Reports>& report,
                          const QuantLib::ext::shared_ptr<MarketRiskGroupBase>& riskGroup,
                          const QuantLib::ext::shared_ptr<TradeGroupBase>& tradeGroup) override;
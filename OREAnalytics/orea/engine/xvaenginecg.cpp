@@ -37,6 +37,8 @@
 #include <qle/math/randomvariable_ops.hpp>
 #include <qle/methods/multipathvariategenerator.hpp>
 
+#include <ql/math/comparison.hpp>
+
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/weighted_sum.hpp>
@@ -65,20 +67,27 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
                          const QuantLib::ext::shared_ptr<ore::analytics::SensitivityScenarioData>& sensitivityData,
                          const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
                          const IborFallbackConfig& iborFallbackConfig, const bool bumpCvaSensis,
+                         const bool forwardCvaSensis, const bool exposureSensis, const bool profileEvaluation,
                          const bool useExternalComputeDevice, const bool externalDeviceCompatibilityMode,
                          const bool useDoublePrecisionForExternalCalculation, const std::string& externalComputeDevice,
                          const bool continueOnCalibrationError, const bool continueOnError, const std::string& context)
-    : asof_(asof), loader_(loader), curveConfigs_(curveConfigs), todaysMarketParams_(todaysMarketParams),
+    : nThreads_(nThreads), asof_(asof), loader_(loader), curveConfigs_(curveConfigs), todaysMarketParams_(todaysMarketParams),
       simMarketData_(simMarketData), engineData_(engineData), crossAssetModelData_(crossAssetModelData),
       scenarioGeneratorData_(scenarioGeneratorData), portfolio_(portfolio), marketConfiguration_(marketConfiguration),
       marketConfigurationInCcy_(marketConfigurationInCcy), sensitivityData_(sensitivityData),
       referenceData_(referenceData), iborFallbackConfig_(iborFallbackConfig), bumpCvaSensis_(bumpCvaSensis),
+      forwardCvaSensis_(forwardCvaSensis), exposureSensis_(exposureSensis), profileEvaluation_(profileEvaluation),
       useExternalComputeDevice_(useExternalComputeDevice),
       externalDeviceCompatibilityMode_(externalDeviceCompatibilityMode),
       useDoublePrecisionForExternalCalculation_(useDoublePrecisionForExternalCalculation),
       externalComputeDevice_(externalComputeDevice), continueOnCalibrationError_(continueOnCalibrationError),
       continueOnError_(continueOnError), context_(context) {
 
+    QL_REQUIRE(!bumpCvaSensis_ || !forwardCvaSensis_,
+               "XvaEngineCG: bumpCvaSensis and forwardCvaSensis can not be both enabled.");
+    QL_REQUIRE(!forwardCvaSensis_ || !useExternalComputeDevice_,
+               "XvaEngineCG: forwardCvaSensis is not supported on external compute devices.");
+
     // Just for performance testing, duplicate the trades in input portfolio as specified by env var N
 
     if (auto param_N = getenv("XVA_ENGINE_CG_N")) {
@@ -163,6 +172,7 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
         camBuilder_->model(), scenarioGeneratorData_->samples(), currencies, curves, fxSpots, irIndices, infIndices,
         indices, indexCurrencies, simulationDates, timeStepsPerYear, iborFallbackConfig, std::vector<Size>(),
         std::vector<std::string>(), true);
+    model_->computationGraph()->enableCommonSubexpressionElimination();
     model_->calculate();
     boost::timer::nanosecond_type timing3 = timer.elapsed().wall;
 
@@ -193,6 +203,7 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
     LOG("XvaEngineCG: build computation graph for all trades");
 
     std::vector<std::vector<std::size_t>> amcNpvNodes; // includes time zero npv
+    std::vector<std::pair<std::size_t, std::string>> tradeRedBlockIds;  // for profiling
 
     auto g = model_->computationGraph();
 
@@ -203,6 +214,7 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
         QL_REQUIRE(engine, "XvaEngineCG: expected to get ScriptedInstrumentPricingEngineCG, trade '"
                                << id << "' has a different engine.");
         g->startRedBlock();
+        tradeRedBlockIds.push_back(std::make_pair(g->redBlockRanges().size(), id));
         engine->buildComputationGraph();
         std::vector<std::size_t> tmp;
         tmp.push_back(g->variable(engine->npvName() + "_0"));
@@ -274,11 +286,12 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
     ComputeContext::Settings externalComputeDeviceSettings;
     if (useExternalComputeDevice_) {
         ComputeEnvironment::instance().selectContext(externalComputeDevice_);
-        externalComputeDeviceSettings.debug = false;
+        externalComputeDeviceSettings.debug = profileEvaluation_;
         externalComputeDeviceSettings.useDoublePrecision = useDoublePrecisionForExternalCalculation_;
         externalComputeDeviceSettings.rngSequenceType = scenarioGeneratorData_->sequenceType();
         externalComputeDeviceSettings.rngSeed = scenarioGeneratorData_->seed();
         externalComputeDeviceSettings.regressionOrder = 4;
+        externalComputeDeviceSettings.nThreads = nThreads_;
         externalCalculationId_ = ComputeEnvironment::instance()
                                      .context()
                                      .initiateCalculation(model_->size(), 0, 0, externalComputeDeviceSettings)
@@ -349,9 +362,9 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
             keepNodes[n] = true;
         }
 
-        // make sure we can revalue for bump sensis
+        // make sure we can revalue for bump and forward sensis
 
-        if (bumpCvaSensis_) {
+        if (bumpCvaSensis_ || forwardCvaSensis_) {
             for (auto const& rv : model_->randomVariates())
                 for (auto const& v : rv)
                     keepNodes[v] = true;
@@ -364,14 +377,39 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
 
     keepNodes[cvaNode] = true;
 
+    // nodes that do not contribute to the kept nodes are skipped in the evaluation
+
+    std::vector<std::size_t> activeNodes = deadNodeElimination(*g, keepNodes);
+    std::size_t numberOfDeadNodes = std::count(activeNodes.begin(), activeNodes.end(), ComputationGraph::nan);
+
     std::vector<bool> rvOpAllowsPredeletion = QuantExt::getRandomVariableOpAllowsPredeletion();
 
+    // regions for profiling: the model (part A), the trades (part B, one region per trade red block) and the
+    // aggregation over the trades and the cva calculation (part C, D)
+
+    EvaluationProfile profile(model_->size());
+    if (profileEvaluation_) {
+        std::size_t firstTradeNode =
+            tradeRedBlockIds.empty() ? g->size() : g->redBlockRanges()[tradeRedBlockIds.front().first - 1].first;
+        std::size_t aggregationRegion = g->redBlockRanges().size() + 1;
+        profile.regionNames.resize(aggregationRegion + 1, "other");
+        profile.regionNames.front() = "model";
+        profile.regionNames.back() = "aggregation";
+        for (auto const& [redBlockId, tradeId] : tradeRedBlockIds)
+            profile.regionNames[redBlockId] = tradeId;
+        profile.nodeRegion.resize(g->size());
+        for (std::size_t n = 0; n < g->size(); ++n) {
+            profile.nodeRegion[n] =
+                g->redBlockId(n) != 0 ? g->redBlockId(n) : (n < firstTradeNode ? 0 : aggregationRegion);
+        }
+    }
+
     std::vector<std::vector<double>> externalOutput;
     std::vector<double*> externalOutputPtr;
     if (useExternalComputeDevice_) {
         forwardEvaluation(*g, valuesExternal, opsExternal_, ExternalRandomVariable::deleter, !bumpCvaSensis_,
                           opNodeRequirements_, keepNodes, 0, ComputationGraph::nan, false,
-                          ExternalRandomVariable::preDeleter, rvOpAllowsPredeletion);
+                          ExternalRandomVariable::preDeleter, rvOpAllowsPredeletion, activeNodes);
         for (Size i = 0; i < pfExposureNodes.size(); ++i) {
             valuesExternal[pfExposureNodes[i]].declareAsOutput();
         }
@@ -387,7 +425,54 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
         }
         values[cvaNode] = RandomVariable(model_->size(), externalOutputPtr.back());
     } else {
-        forwardEvaluation(*g, values, ops_, RandomVariable::deleter, !bumpCvaSensis_, opNodeRequirements_, keepNodes);
+        // the trade red blocks are independent given the model nodes, they are evaluated concurrently
+        forwardEvaluation(*g, values, ops_, RandomVariable::deleter, !bumpCvaSensis_ && !forwardCvaSensis_,
+                          opNodeRequirements_, keepNodes, 0, ComputationGraph::nan, false, {}, {}, activeNodes,
+                          nThreads_, profileEvaluation_ ? &profile : nullptr);
+    }
+
+    if (profileEvaluation_) {
+        profileReport_ = QuantLib::ext::make_shared<InMemoryReport>();
+        profileReport_->addColumn("Category", string())
+            .addColumn("Name", string())
+            .addColumn("Nodes", Size())
+            .addColumn("Flops", double(), 0)
+            .addColumn("TimeMs", double(), 3);
+        auto opLabels = getRandomVariableOpLabels();
+        if (useExternalComputeDevice_) {
+            // the device does not provide timings by op
+            for (auto const& [op, n] :
+                 ComputeEnvironment::instance().context().debugInfo().numberOfOperationsByOpCode) {
+                profileReport_->next()
+                    .add(string("DeviceOp"))
+                    .add(op < opLabels.size() ? opLabels[op] : std::to_string(op))
+                    .add(static_cast<Size>(n / model_->size()))
+                    .add(static_cast<double>(n))
+                    .add(0.0);
+            }
+        } else {
+            for (Size i = 0; i < profile.byOpId.size(); ++i) {
+                if (profile.byOpId[i].numberOfNodes == 0)
+                    continue;
+                profileReport_->next()
+                    .add(string("Op"))
+                    .add(i < opLabels.size() ? opLabels[i] : std::to_string(i))
+                    .add(profile.byOpId[i].numberOfNodes)
+                    .add(profile.flops(profile.byOpId[i]))
+                    .add(profile.byOpId[i].nanoSeconds / 1E6);
+            }
+            for (Size i = 0; i < profile.byRegion.size(); ++i) {
+                if (profile.byRegion[i].numberOfNodes == 0)
+                    continue;
+                profileReport_->next()
+                    .add(string("Region"))
+                    .add(profile.regionNames[i])
+                    .add(profile.byRegion[i].numberOfNodes)
+                    .add(profile.flops(profile.byRegion[i]))
+                    .add(profile.byRegion[i].nanoSeconds / 1E6);
+            }
+        }
+        profileReport_->end();
     }
 
     boost::timer::nanosecond_type timing10 = timer.elapsed().wall;
@@ -418,7 +503,8 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
 
     if (sensitivityData_) {
 
-        LOG("XvaEngineCG: Calculate sensitivities (bump = " << std::boolalpha << bumpCvaSensis_);
+        LOG("XvaEngineCG: Calculate sensitivities (bump = " << std::boolalpha << bumpCvaSensis_
+                                                            << ", forward = " << forwardCvaSensis_ << ")");
 
         // Do backward derivatives run
 
@@ -426,36 +512,76 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
 
         std::vector<double> modelParamDerivatives(baseModelParams_.size());
 
-        if (!bumpCvaSensis_) {
+        // model param derivatives of the epe and ene per date, if exposure sensis are requested
+
+        std::vector<std::vector<double>> exposureModelParamDerivatives;
+
+        if (!bumpCvaSensis_ && !forwardCvaSensis_) {
 
             LOG("XvaEngineCG: run backward derivatives");
 
-            derivatives[cvaNode] = RandomVariable(model_->size(), 1.0);
+            // the outputs are the cva and, if requested, the epe and ene per date, their adjoint seeds are the
+            // pathwise derivatives of max(+-exposure, 0)
+
+            std::vector<std::pair<std::size_t, RandomVariable>> seeds;
+            seeds.push_back(std::make_pair(cvaNode, RandomVariable(model_->size(), 1.0)));
+            if (exposureSensis_) {
+                RandomVariable zero(model_->size(), 0.0);
+                for (auto const n : pfExposureNodes) {
+                    seeds.push_back(std::make_pair(n, indicatorGt(values[n], zero)));
+                    seeds.push_back(std::make_pair(n, -indicatorGt(zero, values[n])));
+                }
+            }
 
             std::vector<bool> keepNodesDerivatives(g->size(), false);
 
             for (auto const& [n, _] : baseModelParams_)
                 keepNodesDerivatives[n] = true;
 
-            // backward derivatives run
+            // backward derivatives runs, each propagating the adjoints of up to maxOutputsPerSweep outputs, the first
+            // run reuses the derivatives container for the cva
 
-            backwardDerivatives(*g, values, derivatives, grads_, RandomVariable::deleter, keepNodesDerivatives, ops_,
-                                opNodeRequirements_, keepNodes, RandomVariableOpCode::ConditionalExpectation,
-                                ops_[RandomVariableOpCode::ConditionalExpectation]);
+            constexpr Size maxOutputsPerSweep = 8;
 
-            // read model param derivatives
+            for (Size b = 0; b < seeds.size(); b += maxOutputsPerSweep) {
+                Size nOutputs = std::min(maxOutputsPerSweep, seeds.size() - b);
+                std::vector<std::vector<RandomVariable>> adjoints(nOutputs);
+                for (Size d = 0; d < nOutputs; ++d) {
+                    if (b + d == 0)
+                        adjoints[d].swap(derivatives);
+                    else
+                        adjoints[d].resize(g->size(), RandomVariable(model_->size(), 0.0));
+                    adjoints[d][seeds[b + d].first] = seeds[b + d].second;
+                }
 
-            Size i = 0;
-            for (auto const& [n, v] : baseModelParams_) {
-                modelParamDerivatives[i++] = expectation(derivatives[n]).at(0);
-            }
+                backwardDerivatives(*g, values, adjoints, grads_, RandomVariable::deleter, keepNodesDerivatives, ops_,
+                                    opNodeRequirements_, keepNodes, RandomVariableOpCode::ConditionalExpectation,
+                                    ops_[RandomVariableOpCode::ConditionalExpectation], {}, activeNodes);
+
+                // read model param derivatives
+
+                for (Size d = 0; d < nOutputs; ++d) {
+                    std::vector<double> tmp(baseModelParams_.size());
+                    Size i = 0;
+                    for (auto const& [n, v] : baseModelParams_) {
+                        tmp[i++] = expectation(adjoints[d][n]).at(0);
+                    }
+                    if (b + d == 0)
+                        modelParamDerivatives = tmp;
+                    else
+                        exposureModelParamDerivatives.push_back(tmp);
+                }
 
-            // get mem consumption
+                // get mem consumption
 
-            rvMemMax = std::max(rvMemMax, numberOfStochasticRvs(values) + numberOfStochasticRvs(derivatives));
+                std::size_t rvMem = numberOfStochasticRvs(values);
+                for (auto const& a : adjoints)
+                    rvMem += numberOfStochasticRvs(a);
+                rvMemMax = std::max(rvMemMax, rvMem);
+            }
 
-            LOG("XvaEngineCG: got " << modelParamDerivatives.size()
-                                    << " model parameter derivatives from run backward derivatives");
+            LOG("XvaEngineCG: got " << modelParamDerivatives.size() << " model parameter derivatives for "
+                                    << seeds.size() << " outputs from run backward derivatives");
 
             timing11 = timer.elapsed().wall;
 
@@ -483,6 +609,20 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
 
         model_->alwaysForwardNotifications();
 
+        // first order change of the exposures per scenario, from the forward sensis or the exposure sensis
+
+        if (forwardCvaSensis_ || !exposureModelParamDerivatives.empty()) {
+            exposureSensiReport_ = QuantLib::ext::make_shared<InMemoryReport>();
+            exposureSensiReport_->addColumn("Scenario", string())
+                .addColumn("Date", Date())
+                .addColumn("dEPE", double(), 4)
+                .addColumn("dENE", double(), 4);
+        }
+
+        // model parameter shifts of the active scenarios for forward sensis, as (sample, shifts)
+
+        std::vector<std::pair<Size, std::vector<double>>> tangentDirections;
+
         Size activeScenarios = 0;
         for (Size sample = 0; sample < resultCube->samples(); ++sample) {
 
@@ -505,7 +645,17 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
                 model_->calculate();
                 ++activeScenarios;
 
-                if (!bumpCvaSensis_) {
+                if (forwardCvaSensis_) {
+
+                    // collect the model parameter shifts, the sensi is calculated in the forward sweeps below
+
+                    auto modelParameters = model_->modelParameters();
+                    std::vector<double> shifts(baseModelParams_.size());
+                    for (Size i = 0; i < baseModelParams_.size(); ++i)
+                        shifts[i] = modelParameters[i].second - baseModelParams_[i].second;
+                    tangentDirections.push_back(std::make_pair(sample, shifts));
+
+                } else if (!bumpCvaSensis_) {
 
                     // calcuate CVA sensi using ad derivatives
 
@@ -521,6 +671,25 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
                     }
                     sensi = boost::accumulators::weighted_sum(acc);
 
+                    // first order change of the epe and ene per date
+
+                    if (!exposureModelParamDerivatives.empty()) {
+                        string scenario = sensiScenarioGenerator_->scenarioDescriptions()[sample].factors();
+                        for (Size d = 0; d < simulationDates.size() + 1; ++d) {
+                            Real dEpe = 0.0, dEne = 0.0;
+                            for (Size j = 0; j < baseModelParams_.size(); ++j) {
+                                Real shift = modelParameters[j].second - baseModelParams_[j].second;
+                                dEpe += exposureModelParamDerivatives[2 * d][j] * shift;
+                                dEne += exposureModelParamDerivatives[2 * d + 1][j] * shift;
+                            }
+                            exposureSensiReport_->next();
+                            exposureSensiReport_->add(scenario)
+                                .add(d == 0 ? model_->referenceDate() : *std::next(simulationDates.begin(), d - 1))
+                                .add(dEpe)
+                                .add(dEne);
+                        }
+                    }
+
                 } else {
 
                     // calcuate CVA sensi doing full recalc of CVA
@@ -535,7 +704,8 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
                     } else {
                         populateModelParameters(model_->modelParameters(), values, valuesExternal);
                         forwardEvaluation(*g, values, ops_, RandomVariable::deleter, true, opNodeRequirements_,
-                                          keepNodes);
+                                          keepNodes, 0, ComputationGraph::nan, false, {}, {}, activeNodes,
+                                          nThreads_);
                     }
                     sensi = expectation(values[cvaNode]).at(0) - cva;
                 }
@@ -546,6 +716,56 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
             resultCube->set(cva + sensi, 0, 0, sample, 0);
         }
 
+        // vector forward mode: propagate the model parameter shifts of several scenarios as tangents through the
+        // graph in one sweep, this yields the CVA sensi and the first order change of the exposures per date
+
+        if (forwardCvaSensis_) {
+
+            LOG("XvaEngineCG: run forward derivatives for " << tangentDirections.size() << " scenarios");
+
+            constexpr Size maxDirectionsPerSweep = 8;
+
+            RandomVariable zero(model_->size(), 0.0);
+            for (Size b = 0; b < tangentDirections.size(); b += maxDirectionsPerSweep) {
+                Size nDirections = std::min(maxDirectionsPerSweep, tangentDirections.size() - b);
+                std::vector<std::vector<RandomVariable>> tangents(nDirections,
+                                                                  std::vector<RandomVariable>(g->size()));
+                for (Size d = 0; d < nDirections; ++d) {
+                    Size i = 0;
+                    for (auto const& [n, _] : baseModelParams_) {
+                        if (!QuantLib::close_enough(tangentDirections[b + d].second[i], 0.0))
+                            tangents[d][n] = RandomVariable(model_->size(), tangentDirections[b + d].second[i]);
+                        ++i;
+                    }
+                }
+                forwardEvaluationAndDerivatives(*g, values, tangents, ops_, grads_, RandomVariable::deleter, keepNodes,
+                                                RandomVariableOpCode::ConditionalExpectation,
+                                                ops_[RandomVariableOpCode::ConditionalExpectation], activeNodes);
+                std::size_t rvMem = numberOfStochasticRvs(values);
+                for (auto const& t : tangents)
+                    rvMem += numberOfStochasticRvs(t);
+                rvMemMax = std::max(rvMemMax, rvMem);
+                for (Size d = 0; d < nDirections; ++d) {
+                    Size sample = tangentDirections[b + d].first;
+                    Real sensi = tangents[d][cvaNode].initialised() ? expectation(tangents[d][cvaNode]).at(0) : 0.0;
+                    resultCube->set(cva + sensi, 0, 0, sample, 0);
+                    string scenario = sensiScenarioGenerator_->scenarioDescriptions()[sample].factors();
+                    for (Size i = 0; i < simulationDates.size() + 1; ++i) {
+                        auto const& v = values[pfExposureNodes[i]];
+                        auto const& t = tangents[d][pfExposureNodes[i]];
+                        exposureSensiReport_->next();
+                        exposureSensiReport_->add(scenario)
+                            .add(i == 0 ? model_->referenceDate() : *std::next(simulationDates.begin(), i - 1))
+                            .add(t.initialised() ? expectation(indicatorGt(v, zero) * t).at(0) : 0.0)
+                            .add(t.initialised() ? expectation(indicatorGt(zero, v) * -t).at(0) : 0.0);
+                    }
+                }
+            }
+        }
+
+        if (exposureSensiReport_)
+            exposureSensiReport_->end();
+
         timing12 = timer.elapsed().wall;
 
         LOG("XvaEngineCG: finished running " << resultCube->samples() << " sensi scenarios, thereof " << activeScenarios
@@ -570,6 +790,8 @@ XvaEngineCG::XvaEngineCG(const Size nThreads, const Date& asof,
     LOG("XvaEngineCG: graph size               : " << g->size());
     LOG("XvaEngineCG: red nodes                : " << sumRedNodes);
     LOG("XvaEngineCG: red node dependendices   : " << g->redBlockDependencies().size());
+    LOG("XvaEngineCG: eliminated subexpressions: " << g->numberOfEliminatedSubexpressions());
+    LOG("XvaEngineCG: skipped dead nodes       : " << numberOfDeadNodes);
     LOG("XvaEngineCG: Peak mem usage           : " << ore::data::os::getPeakMemoryUsageBytes() / 1024 / 1024 << " MB");
     LOG("XvaEngineCG: Peak theoretical rv mem  : " << static_cast<double>(rvMemMax) / 1024 / 1024 * 8 * model_->size()
                                                    << " MB");
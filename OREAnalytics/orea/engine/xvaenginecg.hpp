@@ -62,7 +62,9 @@ public:
                 const QuantLib::ext::shared_ptr<ore::analytics::SensitivityScenarioData>& sensitivityData = nullptr,
                 const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData = nullptr,
                 const IborFallbackConfig& iborFallbackConfig = IborFallbackConfig::defaultConfig(),
-                const bool bumpCvaSensis = false, const bool useExternalComputeDevice = false,
+                const bool bumpCvaSensis = false, const bool forwardCvaSensis = false,
+                const bool exposureSensis = false, const bool profileEvaluation = false,
+                const bool useExternalComputeDevice = false,
                 const bool externalDeviceCompatibilityMode = false,
                 const bool useDoublePrecisionForExternalCalculation = false,
                 const std::string& externalComputeDevice = std::string(), const bool continueOnCalibrationError = true,
@@ -70,6 +72,10 @@ public:
 
     QuantLib::ext::shared_ptr<InMemoryReport> exposureReport() { return epeReport_; }
     QuantLib::ext::shared_ptr<InMemoryReport> sensiReport() { return sensiReport_; }
+    //! only available if forward sensis or exposure sensis are computed
+    QuantLib::ext::shared_ptr<InMemoryReport> exposureSensiReport() { return exposureSensiReport_; }
+    //! only available if profileEvaluation is true, time and flops of the forward evaluation by op and by region
+    QuantLib::ext::shared_ptr<InMemoryReport> profileReport() { return profileReport_; }
 
 private:
     void populateRandomVariates(std::vector<RandomVariable>& values,
@@ -81,6 +87,7 @@ private:
                                  std::vector<ExternalRandomVariable>& valuesExternal) const;
 
     // input parameters
+    Size nThreads_;
     Date asof_;
     QuantLib::ext::shared_ptr<ore::data::Loader> loader_;
     QuantLib::ext::shared_ptr<ore::data::CurveConfigurations> curveConfigs_;
@@ -96,6 +103,9 @@ private:
     QuantLib::ext::shared_ptr<ReferenceDataManager> referenceData_;
     IborFallbackConfig iborFallbackConfig_;
     bool bumpCvaSensis_;
+    bool forwardCvaSensis_;
+    bool exposureSensis_;
+    bool profileEvaluation_;
     bool useExternalComputeDevice_;
     bool externalDeviceCompatibilityMode_;
     bool useDoublePrecisionForExternalCalculation_;
@@ -119,7 +129,7 @@ private:
     std::size_t externalCalculationId_;
 
     // output reports
-    QuantLib::ext::shared_ptr<InMemoryReport> epeReport_, sensiReport_;
+    QuantLib::ext::shared_ptr<InMemoryReport> epeReport_, sensiReport_, exposureSensiReport_, profileReport_;
 };
 
 } // namespace analytics
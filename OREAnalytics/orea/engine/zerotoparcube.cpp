@@ -21,8 +21,12 @@
 #include <orea/app/structuredanalyticserror.hpp>
 #include <ored/utilities/to_string.hpp>
 
+#include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 
+#include <exception>
+#include <thread>
+
 using namespace QuantLib;
 using namespace ore::analytics;
 
@@ -36,15 +40,17 @@ namespace analytics {
 
 ZeroToParCube::ZeroToParCube(const QuantLib::ext::shared_ptr<SensitivityCube>& zeroCube,
                              const QuantLib::ext::shared_ptr<ParSensitivityConverter>& parConverter,
-                             const set<RiskFactorKey::KeyType>& typesDisabled, const bool continueOnError)
+                             const set<RiskFactorKey::KeyType>& typesDisabled, const bool continueOnError,
+                             const Size nThreads)
     : ZeroToParCube(std::vector<QuantLib::ext::shared_ptr<SensitivityCube>>{zeroCube}, parConverter, typesDisabled,
-                    continueOnError) {}
+                    continueOnError, nThreads) {}
 
 ZeroToParCube::ZeroToParCube(const std::vector<QuantLib::ext::shared_ptr<SensitivityCube>>& zeroCubes,
                              const QuantLib::ext::shared_ptr<ParSensitivityConverter>& parConverter,
-                             const set<RiskFactorKey::KeyType>& typesDisabled, const bool continueOnError)
+                             const set<RiskFactorKey::KeyType>& typesDisabled, const bool continueOnError,
+                             const Size nThreads)
     : zeroCubes_(zeroCubes), parConverter_(parConverter), typesDisabled_(typesDisabled),
-      continueOnError_(continueOnError) {
+      continueOnError_(continueOnError), nThreads_(std::max<Size>(nThreads, 1)) {
 
     Size counter = 0;
     for (auto const& k : parConverter_->rawKeys()) {
@@ -53,68 +59,115 @@ ZeroToParCube::ZeroToParCube(const std::vector<QuantLib::ext::shared_ptr<Sensiti
 }
 
 map<RiskFactorKey, Real> ZeroToParCube::parDeltas(QuantLib::Size cubeIdx, QuantLib::Size tradeIdx) const {
+    return parDeltas(cubeIdx, std::vector<Size>(1, tradeIdx)).front();
+}
 
-    DLOG("Calculating par deltas for trade index " << tradeIdx);
-
-    map<RiskFactorKey, Real> result;
+std::vector<map<RiskFactorKey, Real>> ZeroToParCube::parDeltas(QuantLib::Size cubeIdx,
+                                                               const std::vector<QuantLib::Size>& tradeIdx) const {
 
-    // Get the "par-convertible" zero deltas
-    boost::numeric::ublas::vector<Real> zeroDeltas(parConverter_->rawKeys().size(), 0.0);
+    DLOG("Calculating par deltas for " << tradeIdx.size() << " trade indices");
 
     QL_REQUIRE(cubeIdx < zeroCubes_.size(),
                "ZeroToParCube::parDeltas(): cubeIdx (" << cubeIdx << ") out of range 0..." << (zeroCubes_.size() - 1));
 
+    std::vector<map<RiskFactorKey, Real>> result(tradeIdx.size());
+
+    // one contiguous block of trades per worker, the cubes and the converter are only read
+    const Size nWorkers = std::min<Size>(nThreads_, tradeIdx.size());
+    if (nWorkers <= 1) {
+        convert(cubeIdx, tradeIdx, 0, tradeIdx.size(), result);
+    } else {
+        const Size blockSize = (tradeIdx.size() + nWorkers - 1) / nWorkers;
+        std::vector<std::exception_ptr> errors(nWorkers);
+        std::vector<std::thread> workers;
+        for (Size w = 0; w < nWorkers; ++w) {
+            workers.emplace_back([&, w]() {
+                try {
+                    convert(cubeIdx, tradeIdx, std::min(w * blockSize, tradeIdx.size()),
+                            std::min((w + 1) * blockSize, tradeIdx.size()), result);
+                } catch (...) {
+                    errors[w] = std::current_exception();
+                }
+            });
+        }
+        for (auto& t : workers)
+            t.join();
+        for (const auto& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+    }
+
+    DLOG("Finished calculating par deltas for cube index " << cubeIdx << ", " << tradeIdx.size()
+                                                           << " trade indices");
+
+    return result;
+}
+
+void ZeroToParCube::convert(QuantLib::Size cubeIdx, const std::vector<QuantLib::Size>& tradeIdx, QuantLib::Size begin,
+                            QuantLib::Size end, std::vector<map<RiskFactorKey, Real>>& result) const {
+
+    if (begin >= end)
+        return;
+
+    // Get the "par-convertible" zero deltas, one column per trade
+    boost::numeric::ublas::matrix<Real> zeroDeltas(parConverter_->rawKeys().size(), end - begin, 0.0);
+
     const QuantLib::ext::shared_ptr<SensitivityCube>& zeroCube = zeroCubes_[cubeIdx];
     const QuantLib::ext::shared_ptr<NPVSensiCube>& sensiCube = zeroCube->npvCube();
 
-    std::set<RiskFactorKey> rkeys;
-    for (auto const& kv : sensiCube->getTradeNPVs(tradeIdx)) {
-        if (auto k = zeroCube->upDownFactor(kv.first); k.keytype != RiskFactorKey::KeyType::None)
-            rkeys.insert(k);
-    }
+    std::vector<std::set<RiskFactorKey>> rkeys(end - begin);
+    for (Size t = 0; t < end - begin; ++t) {
+        for (auto const& kv : sensiCube->getTradeNPVs(tradeIdx[begin + t])) {
+            if (auto k = zeroCube->upDownFactor(kv.first); k.keytype != RiskFactorKey::KeyType::None)
+                rkeys[t].insert(k);
+        }
 
-    for (auto const& rk : rkeys) {
-        auto it = factorToIndex_.find(rk);
-        if (it == factorToIndex_.end()) {
-            if (ParSensitivityAnalysis::isParType(rk.keytype) && typesDisabled_.count(rk.keytype) != 1) {
-                if (continueOnError_) {
-                    StructuredAnalyticsErrorMessage("Par conversion", "",
-                                                    "Par factor " + ore::data::to_string(rk) +
-                                                        " not found in factorToIndex map")
-                        .log();
-                } else {
-                    QL_REQUIRE(!ParSensitivityAnalysis::isParType(rk.keytype) || typesDisabled_.count(rk.keytype) == 1,
-                               "ZeroToParCube::parDeltas(): par factor " << rk << " not found in factorToIndex map");
+        for (auto const& rk : rkeys[t]) {
+            auto it = factorToIndex_.find(rk);
+            if (it == factorToIndex_.end()) {
+                if (ParSensitivityAnalysis::isParType(rk.keytype) && typesDisabled_.count(rk.keytype) != 1) {
+                    if (continueOnError_) {
+                        StructuredAnalyticsErrorMessage("Par conversion", "",
+                                                        "Par factor " + ore::data::to_string(rk) +
+                                                            " not found in factorToIndex map")
+                            .log();
+                    } else {
+                        QL_REQUIRE(!ParSensitivityAnalysis::isParType(rk.keytype) ||
+                                       typesDisabled_.count(rk.keytype) == 1,
+                                   "ZeroToParCube::parDeltas(): par factor " << rk
+                                                                             << " not found in factorToIndex map");
+                    }
                 }
+            } else {
+                zeroDeltas(it->second, t) = zeroCube->delta(tradeIdx[begin + t], rk);
             }
-        } else {
-            zeroDeltas[it->second] = zeroCube->delta(tradeIdx, rk);
         }
     }
 
     // Convert the zero deltas to par deltas
-    boost::numeric::ublas::vector<Real> parDeltas = parConverter_->convertSensitivity(zeroDeltas);
-    Size counter = 0;
-    for (const auto& key : parConverter_->parKeys()) {
-        if (!close(parDeltas[counter], 0.0)) {
-            result[key] = parDeltas[counter];
+    boost::numeric::ublas::matrix<Real> parDeltas = parConverter_->convertSensitivities(zeroDeltas);
+
+    for (Size t = 0; t < end - begin; ++t) {
+        auto& deltas = result[begin + t];
+        Size counter = 0;
+        for (const auto& key : parConverter_->parKeys()) {
+            if (!close(parDeltas(counter, t), 0.0)) {
+                deltas[key] = parDeltas(counter, t);
+            }
+            counter++;
         }
-        counter++;
-    }
 
-    // Add non-zero deltas that do not need to be converted from underlying zero cube
-    for (const auto& f : rkeys) {
-        if (!ParSensitivityAnalysis::isParType(f.keytype) || typesDisabled_.count(f.keytype) == 1) {
-            Real delta = zeroCube->delta(tradeIdx, f);
-            if (!close(delta, 0.0)) {
-                result[f] = delta;
+        // Add non-zero deltas that do not need to be converted from underlying zero cube
+        for (const auto& f : rkeys[t]) {
+            if (!ParSensitivityAnalysis::isParType(f.keytype) || typesDisabled_.count(f.keytype) == 1) {
+                Real delta = zeroCube->delta(tradeIdx[begin + t], f);
+                if (!close(delta, 0.0)) {
+                    deltas[f] = delta;
+                }
             }
         }
     }
-
-    DLOG("Finished calculating par deltas for cube index " << cubeIdx << ", trade index " << tradeIdx);
-
-    return result;
 }
 
 map<RiskFactorKey, Real> ZeroToParCube::parDeltas(const string& tradeId) const {
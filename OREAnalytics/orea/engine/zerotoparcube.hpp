@@ -24,6 +24,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <orea/cube/sensitivitycube.hpp>
 #include <orea/engine/parsensitivityanalysis.hpp>
@@ -34,6 +35,9 @@ namespace analytics {
 //! ZeroToParCube class
 /*! Takes a cube of zero sensitivities, a par sensitivity converter and can return the
     par deltas for a given trade ID from the cube.
+
+    Batches of trades are split into blocks of columns that are converted on up to \p nThreads threads, each block
+    as one product with the par conversion matrix.
  */
 class ZeroToParCube {
 public:
@@ -41,12 +45,12 @@ public:
     ZeroToParCube(const QuantLib::ext::shared_ptr<ore::analytics::SensitivityCube>& zeroCube,
                   const QuantLib::ext::shared_ptr<ParSensitivityConverter>& parConverter,
                   const std::set<ore::analytics::RiskFactorKey::KeyType>& typesDisabled = {},
-                  const bool continueOnError = false);
+                  const bool continueOnError = false, const QuantLib::Size nThreads = 1);
     //! Another Constructor!
     ZeroToParCube(const std::vector<QuantLib::ext::shared_ptr<ore::analytics::SensitivityCube>>& zeroCubes,
                   const QuantLib::ext::shared_ptr<ParSensitivityConverter>& parConverter,
                   const std::set<ore::analytics::RiskFactorKey::KeyType>& typesDisabled = {},
-                  const bool continueOnError = false);
+                  const bool continueOnError = false, const QuantLib::Size nThreads = 1);
 
     //! Inspectors
     //@{
@@ -56,6 +60,8 @@ public:
     const QuantLib::ext::shared_ptr<ParSensitivityConverter>& parConverter() const { return parConverter_; }
     //! The par risk factor types that are disabled for this instance of ZeroToParCube.
     const std::set<ore::analytics::RiskFactorKey::KeyType>& typesDisabled() const { return typesDisabled_; }
+    //! Number of threads used for the conversion of a batch of trades
+    QuantLib::Size nThreads() const { return nThreads_; }
     //@}
 
     //! Return the non-zero par deltas for the given \p tradeId
@@ -65,7 +71,16 @@ public:
     std::map<ore::analytics::RiskFactorKey, QuantLib::Real> parDeltas(QuantLib::Size cubeIdx,
                                                                       QuantLib::Size tradeIdx) const;
 
+    //! Return the non-zero par deltas for several trade indices of the given cube, converted in one batch
+    std::vector<std::map<ore::analytics::RiskFactorKey, QuantLib::Real>>
+    parDeltas(QuantLib::Size cubeIdx, const std::vector<QuantLib::Size>& tradeIdx) const;
+
 private:
+    //! Convert the trades tradeIdx[begin], ..., tradeIdx[end - 1] and write them to the same positions in \p result
+    void convert(QuantLib::Size cubeIdx, const std::vector<QuantLib::Size>& tradeIdx, QuantLib::Size begin,
+                 QuantLib::Size end,
+                 std::vector<std::map<ore::analytics::RiskFactorKey, QuantLib::Real>>& result) const;
+
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::SensitivityCube>> zeroCubes_;
     QuantLib::ext::shared_ptr<ParSensitivityConverter> parConverter_;
     std::map<ore::analytics::RiskFactorKey, Size> factorToIndex_;
@@ -73,6 +88,7 @@ private:
     //! Set of risk factor types available for par conversion but that are disabled for this instance of ZeroToParCube.
     std::set<ore::analytics::RiskFactorKey::KeyType> typesDisabled_;
     const bool continueOnError_;
+    QuantLib::Size nThreads_;
 };
 
 } // namespace analytics
@@ -17,6 +17,7 @@
 #include <orea/aggregation/dynamiccreditxvacalculator.hpp>
 #include <orea/aggregation/exposureallocator.hpp>
 #include <orea/aggregation/exposurecalculator.hpp>
+#include <orea/aggregation/exposureconvergence.hpp>
 #include <orea/aggregation/nettedexposurecalculator.hpp>
 #include <orea/aggregation/postprocess.hpp>
 #include <orea/aggregation/staticcreditxvacalculator.hpp>
@@ -42,11 +43,14 @@
 #include <orea/app/cleanupsingletons.hpp>
 #include <orea/app/initbuilders.hpp>
 #include <orea/app/inputparameters.hpp>
+#include <orea/app/marketcache.hpp>
 #include <orea/app/marketcalibrationreport.hpp>
 #include <orea/app/marketdatacsvloader.hpp>
 #include <orea/app/marketdatainmemoryloader.hpp>
 #include <orea/app/marketdataloader.hpp>
+#include <orea/app/multithreadedreportwriter.hpp>
 #include <orea/app/oreapp.hpp>
+#include <orea/app/oreservice.hpp>
 #include <orea/app/parameters.hpp>
 #include <orea/app/reportwriter.hpp>
 #include <orea/app/sensitivityrunner.hpp>
@@ -54,6 +58,8 @@
 #include <orea/app/structuredanalyticswarning.hpp>
 #include <orea/app/xvarunner.hpp>
 #include <orea/app/zerosensitivityloader.hpp>
+#include <orea/cube/contiguouscube.hpp>
+#include <orea/cube/creditstatenpvcube.hpp>
 #include <orea/cube/cube_io.hpp>
 #include <orea/cube/cubecsvreader.hpp>
 #include <orea/cube/cubeinterpretation.hpp>
@@ -62,15 +68,20 @@
 #include <orea/cube/jaggedcube.hpp>
 #include <orea/cube/jointnpvcube.hpp>
 #include <orea/cube/jointnpvsensicube.hpp>
+#include <orea/cube/mappedfilecube.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <orea/cube/npvsensicube.hpp>
+#include <orea/cube/sampletruncatedcube.hpp>
 #include <orea/cube/sensicube.hpp>
 #include <orea/cube/sensitivitycube.hpp>
 #include <orea/cube/sparsenpvcube.hpp>
 #include <orea/engine/amcvaluationengine.hpp>
 #include <orea/engine/bufferedsensitivitystream.hpp>
+#include <orea/engine/closeoutregression.hpp>
 #include <orea/engine/cptycalculator.hpp>
+#include <orea/engine/cubecheckpoint.hpp>
 #include <orea/engine/decomposedsensitivitystream.hpp>
+#include <orea/engine/distributedvaluationengine.hpp>
 #include <orea/engine/filteredsensitivitystream.hpp>
 #include <orea/engine/historicalpnlgenerator.hpp>
 #include <orea/engine/historicalsensipnlcalculator.hpp>
@@ -82,6 +93,7 @@
 #include <orea/engine/multithreadedvaluationengine.hpp>
 #include <orea/engine/npvrecord.hpp>
 #include <orea/engine/observationmode.hpp>
+#include <orea/engine/observergraph.hpp>
 #include <orea/engine/parametricvar.hpp>
 #include <orea/engine/parsensitivityanalysis.hpp>
 #include <orea/engine/parsensitivitycubestream.hpp>
@@ -91,9 +103,12 @@
 #include <orea/engine/parstressscenarioconverter.hpp>
 #include <orea/engine/pnlexplainreport.hpp>
 #include <orea/engine/riskfilter.hpp>
+#include <orea/engine/sampleconsumer.hpp>
 #include <orea/engine/sensitivityaggregator.hpp>
 #include <orea/engine/sensitivityanalysis.hpp>
+#include <orea/engine/sensitivitycolumns.hpp>
 #include <orea/engine/sensitivitycubestream.hpp>
+#include <orea/engine/sensitivityenginecg.hpp>
 #include <orea/engine/sensitivityfilestream.hpp>
 #include <orea/engine/sensitivityinmemorystream.hpp>
 #include <orea/engine/sensitivityrecord.hpp>
@@ -108,12 +123,15 @@
 #include <orea/engine/zerotoparcube.hpp>
 #include <orea/engine/zerotoparshift.hpp>
 #include <orea/scenario/aggregationscenariodata.hpp>
+#include <orea/scenario/binaryscenariofile.hpp>
 #include <orea/scenario/clonedscenariogenerator.hpp>
 #include <orea/scenario/clonescenariofactory.hpp>
+#include <orea/scenario/compactscenariostore.hpp>
 #include <orea/scenario/crossassetmodelscenariogenerator.hpp>
 #include <orea/scenario/csvscenariogenerator.hpp>
 #include <orea/scenario/deltascenario.hpp>
 #include <orea/scenario/deltascenariofactory.hpp>
+#include <orea/scenario/historicalscenariobinaryreader.hpp>
 #include <orea/scenario/historicalscenariofilereader.hpp>
 #include <orea/scenario/historicalscenariogenerator.hpp>
 #include <orea/scenario/historicalscenarioloader.hpp>
@@ -138,6 +156,7 @@
 #include <orea/scenario/simplescenariofactory.hpp>
 #include <orea/scenario/stressscenariodata.hpp>
 #include <orea/scenario/stressscenariogenerator.hpp>
+#include <orea/simm/compactcrif.hpp>
 #include <orea/simm/crif.hpp>
 #include <orea/simm/crifconfiguration.hpp>
 #include <orea/simm/crifloader.hpp>
@@ -27,6 +27,8 @@
 #include <ql/types.hpp>
 #include <ql/patterns/observable.hpp>
 
+#include <qle/utilities/memoryaccounting.hpp>
+
 #include <fstream>
 #include <map>
 #include <vector>
@@ -49,6 +51,27 @@ enum class AggregationScenarioDataType : unsigned int {
     Generic = 6
 };
 
+inline std::ostream& operator<<(std::ostream& out, const AggregationScenarioDataType& t) {
+    switch (t) {
+    case AggregationScenarioDataType::IndexFixing:
+        return out << "IndexFixing";
+    case AggregationScenarioDataType::FXSpot:
+        return out << "FXSpot";
+    case AggregationScenarioDataType::Numeraire:
+        return out << "Numeraire";
+    case AggregationScenarioDataType::CreditState:
+        return out << "CreditState";
+    case AggregationScenarioDataType::SurvivalWeight:
+        return out << "SurvivalWeight";
+    case AggregationScenarioDataType::RecoveryRate:
+        return out << "RecoveryRate";
+    case AggregationScenarioDataType::Generic:
+        return out << "Generic";
+    default:
+        return out << "Unknown aggregation scenario data type";
+    }
+}
+
 //! Container for storing simulated market data
 /*! The indexes for dates and samples are (by convention) the
     same as in the npv cube
@@ -79,6 +102,21 @@ public:
     virtual void set(Size dateIndex, Size sampleIndex, Real value, const AggregationScenarioDataType& type,
                      const string& qualifier = "") = 0;
 
+    /*! \name Slot access
+        The (type, qualifier) key resolved to an integer slot once, e.g. before a loop over dates and samples, avoids
+        the key lookup on each get() and set() call
+    */
+    //@{
+    //! The slot of an existing key, throws if there is no data for the key
+    virtual Size slot(const AggregationScenarioDataType& type, const string& qualifier = "") const = 0;
+    //! The slot of a key, the key is added if not yet present
+    virtual Size addSlot(const AggregationScenarioDataType& type, const string& qualifier = "") = 0;
+    //! Get a value from the cube by slot
+    virtual Real get(Size dateIndex, Size sampleIndex, Size slot) const = 0;
+    //! Set a value in the cube by slot
+    virtual void set(Size dateIndex, Size sampleIndex, Real value, Size slot) = 0;
+    //@}
+
     // Get available keys (type, qualifier)
     virtual std::vector<std::pair<AggregationScenarioDataType, std::string>> keys() const = 0;
 
@@ -86,6 +124,8 @@ public:
     virtual void set(Real value, const AggregationScenarioDataType& type, const string& qualifier = "") {
         set(dIndex_, sIndex_, value, type, qualifier);
     }
+    //! Set a value in the cube by slot, assumes normal traversal of the cube (dates then samples)
+    virtual void set(Real value, Size slot) { set(dIndex_, sIndex_, value, slot); }
     //! Go to the next point on the cube
     /*! Go to the next point on the cube, assumes we do date, then samples
      */
@@ -101,78 +141,102 @@ private:
 };
 
 //! A concrete in memory implementation of AggregationScenarioData
-/*! \ingroup scenario
+/*! The keys are resolved to slots in the order they are added, the values are stored in one contiguous buffer of
+    slots x dimDates() x dimSamples() values of type T, the sample index running fastest.
+
+    \ingroup scenario
  */
-class InMemoryAggregationScenarioData : public AggregationScenarioData {
+template <typename T> class InMemoryAggregationScenarioDataBase : public AggregationScenarioData {
 public:
-    InMemoryAggregationScenarioData() : AggregationScenarioData(), dimDates_(0), dimSamples_(0) {}
-    InMemoryAggregationScenarioData(Size dimDates, Size dimSamples)
-        : AggregationScenarioData(), dimDates_(dimDates), dimSamples_(dimSamples) {}
+    InMemoryAggregationScenarioDataBase()
+        : AggregationScenarioData(), dimDates_(0), dimSamples_(0),
+          memory_(QuantExt::MemoryAccounting::instance().account("AggregationScenarioData")) {}
+    InMemoryAggregationScenarioDataBase(Size dimDates, Size dimSamples)
+        : AggregationScenarioData(), dimDates_(dimDates), dimSamples_(dimSamples),
+          memory_(QuantExt::MemoryAccounting::instance().account("AggregationScenarioData")) {}
     Size dimDates() const override { return dimDates_; }
     Size dimSamples() const override { return dimSamples_; }
 
     bool has(const AggregationScenarioDataType& type, const string& qualifier = "") const override {
-        return data_.find(std::make_pair(type, qualifier)) != data_.end();
+        return slots_.find(std::make_pair(type, qualifier)) != slots_.end();
     }
 
-    /*! might throw (the underlying's container exception),
-      if type is not known */
+    //! throws if type is not known
     Real get(Size dateIndex, Size sampleIndex, const AggregationScenarioDataType& type,
              const string& qualifier = "") const override {
-        check(dateIndex, sampleIndex, type, qualifier);
-        return data_.at(std::make_pair(type, qualifier))[dateIndex][sampleIndex];
+        return get(dateIndex, sampleIndex, slot(type, qualifier));
+    }
+
+    Real get(Size dateIndex, Size sampleIndex, Size slot) const override {
+        check(dateIndex, sampleIndex, slot);
+        return data_[(slot * dimDates_ + dateIndex) * dimSamples_ + sampleIndex];
+    }
+
+    /*! The values for the given type and qualifier in a contiguous buffer of dimDates() x dimSamples() values, the
+        sample index running fastest, or nullptr if there are no values. The buffer is valid until a new key is added
+        or this object is destroyed. */
+    const T* data(const AggregationScenarioDataType& type, const string& qualifier = "") const {
+        auto it = slots_.find(std::make_pair(type, qualifier));
+        return it == slots_.end() ? nullptr : data_.data() + it->second * dimDates_ * dimSamples_;
     }
 
     std::vector<std::pair<AggregationScenarioDataType, std::string>> keys() const override {
         std::vector<std::pair<AggregationScenarioDataType, std::string>> res;
-        for (auto const& k : data_)
+        for (auto const& k : slots_)
             res.push_back(k.first);
         return res;
     }
 
     void set(Size dateIndex, Size sampleIndex, Real value, const AggregationScenarioDataType& type,
              const string& qualifier = "") override {
-        check(dateIndex, sampleIndex, type, qualifier);
-        auto key = std::make_pair(type, qualifier);
-        auto it = data_.find(key);
-        if (it == data_.end()) {
-            data_.insert(make_pair(key, vector<vector<Real>>(dimDates_, vector<Real>(dimSamples_, 0.0))));
-        }
-        data_[key][dateIndex][sampleIndex] = value;
+        // check the indices before a new key is added
+        check(dateIndex, sampleIndex);
+        set(dateIndex, sampleIndex, value, addSlot(type, qualifier));
+    }
+
+    void set(Size dateIndex, Size sampleIndex, Real value, Size slot) override {
+        check(dateIndex, sampleIndex, slot);
+        data_[(slot * dimDates_ + dateIndex) * dimSamples_ + sampleIndex] = static_cast<T>(value);
+    }
+
+    Size slot(const AggregationScenarioDataType& type, const string& qualifier = "") const override {
+        auto it = slots_.find(std::make_pair(type, qualifier));
+        QL_REQUIRE(it != slots_.end(), "InMemoryAggregationScenarioData: no data for " << type << " '" << qualifier
+                                                                                       << "'");
+        return it->second;
+    }
+
+    Size addSlot(const AggregationScenarioDataType& type, const string& qualifier = "") override {
+        auto it = slots_.find(std::make_pair(type, qualifier));
+        if (it != slots_.end())
+            return it->second;
+        Size slot = slots_.size();
+        memory_.resize(memory_.bytes() + dimDates_ * dimSamples_ * sizeof(T));
+        data_.resize(data_.size() + dimDates_ * dimSamples_, T(0.0));
+        slots_.insert(std::make_pair(std::make_pair(type, qualifier), slot));
+        return slot;
     }
 
+    using AggregationScenarioData::set;
+
 private:
-    void check(Size dateIndex, Size sampleIndex, const AggregationScenarioDataType& type,
-               const string& qualifier) const {
+    void check(Size dateIndex, Size sampleIndex) const {
         QL_REQUIRE(dateIndex < dimDates_, "dateIndex (" << dateIndex << ") out of range 0..." << dimDates_ - 1);
         QL_REQUIRE(sampleIndex < dimSamples_,
                    "sampleIndex (" << sampleIndex << ") out of range 0..." << dimSamples_ - 1);
-        return;
+    }
+    void check(Size dateIndex, Size sampleIndex, Size slot) const {
+        check(dateIndex, sampleIndex);
+        QL_REQUIRE(slot < slots_.size(), "slot (" << slot << ") out of range 0..." << slots_.size() - 1);
     }
     Size dimDates_, dimSamples_;
-    map<std::pair<AggregationScenarioDataType, string>, vector<vector<Real>>> data_;
+    map<std::pair<AggregationScenarioDataType, string>, Size> slots_;
+    vector<T> data_;
+    QuantExt::AccountedMemory memory_;
 };
 
-inline std::ostream& operator<<(std::ostream& out, const AggregationScenarioDataType& t) {
-    switch (t) {
-    case AggregationScenarioDataType::IndexFixing:
-        return out << "IndexFixing";
-    case AggregationScenarioDataType::FXSpot:
-        return out << "FXSpot";
-    case AggregationScenarioDataType::Numeraire:
-        return out << "Numeraire";
-    case AggregationScenarioDataType::CreditState:
-        return out << "CreditState";
-    case AggregationScenarioDataType::SurvivalWeight:
-        return out << "SurvivalWeight";
-    case AggregationScenarioDataType::RecoveryRate:
-        return out << "RecoveryRate";
-    case AggregationScenarioDataType::Generic:
-        return out << "Generic";
-    default:
-        return out << "Unknown aggregation scenario data type";
-    }
-}
+using InMemoryAggregationScenarioData = InMemoryAggregationScenarioDataBase<Real>;
+using SinglePrecisionInMemoryAggregationScenarioData = InMemoryAggregationScenarioDataBase<float>;
 
 } // namespace analytics
 } // namespace ore
@@ -0,0 +1,301 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/scenario/binaryscenariofile.hpp>
+
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/parsers.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace ore {
+namespace analytics {
+
+namespace {
+
+const char binaryScenarioMagic[8] = {'O', 'R', 'E', 'S', 'C', 'E', 'N', '\0'};
+const std::uint32_t binaryScenarioVersion = 1;
+const std::size_t binaryScenarioAlignment = 8;
+const std::size_t binaryScenarioPreambleSize =
+    sizeof(binaryScenarioMagic) + 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t);
+
+/* text header: one line "keys <n>" followed by n lines with the keys, one line "coordinates <m>" followed by m
+   entries, each consisting of a line "<keytype>\t<name>\t<dimension>" and one line of space separated values per
+   dimension */
+
+std::string writeHeaderText(const SimpleScenario::SharedData& data) {
+    std::ostringstream out;
+    out << std::setprecision(17);
+    out << "keys " << data.keys.size() << "\n";
+    for (auto const& k : data.keys)
+        out << k << "\n";
+    out << "coordinates " << data.coordinates.size() << "\n";
+    for (auto const& [c, values] : data.coordinates) {
+        out << c.first << "\t" << c.second << "\t" << values.size() << "\n";
+        for (auto const& v : values) {
+            for (Size i = 0; i < v.size(); ++i)
+                out << (i == 0 ? "" : " ") << v[i];
+            out << "\n";
+        }
+    }
+    return out.str();
+}
+
+Size readCount(std::istream& in, const std::string& tag, const std::string& filename) {
+    std::string line;
+    QL_REQUIRE(std::getline(in, line), "BinaryScenarioGenerator: unexpected end of header in '" << filename << "'");
+    std::vector<std::string> tokens;
+    boost::split(tokens, line, boost::is_any_of(" "));
+    QL_REQUIRE(tokens.size() == 2 && tokens[0] == tag,
+               "BinaryScenarioGenerator: expected '" << tag << " <n>' in header of '" << filename << "', got '"
+                                                     << line << "'");
+    return ore::data::parseInteger(tokens[1]);
+}
+
+void readHeaderText(const std::string& header, SimpleScenario::SharedData& data, const std::string& filename) {
+    std::istringstream in(header);
+    std::string line;
+    Size nKeys = readCount(in, "keys", filename);
+    data.keys.reserve(nKeys);
+    for (Size i = 0; i < nKeys; ++i) {
+        QL_REQUIRE(std::getline(in, line), "BinaryScenarioGenerator: unexpected end of keys in '" << filename << "'");
+        RiskFactorKey key = parseRiskFactorKey(line);
+        QL_REQUIRE(data.keyIndex.emplace(key, i).second,
+                   "BinaryScenarioGenerator: duplicate key " << key << " in '" << filename << "'");
+        data.keys.push_back(key);
+        boost::hash_combine(data.keysHash, key);
+    }
+    Size nCoordinates = readCount(in, "coordinates", filename);
+    for (Size i = 0; i < nCoordinates; ++i) {
+        QL_REQUIRE(std::getline(in, line),
+                   "BinaryScenarioGenerator: unexpected end of coordinates in '" << filename << "'");
+        std::vector<std::string> tokens;
+        boost::split(tokens, line, boost::is_any_of("\t"));
+        QL_REQUIRE(tokens.size() == 3,
+                   "BinaryScenarioGenerator: invalid coordinates line '" << line << "' in '" << filename << "'");
+        Size dim = ore::data::parseInteger(tokens[2]);
+        std::vector<std::vector<Real>> values(dim);
+        for (Size d = 0; d < dim; ++d) {
+            QL_REQUIRE(std::getline(in, line),
+                       "BinaryScenarioGenerator: unexpected end of coordinates in '" << filename << "'");
+            std::istringstream vs(line);
+            Real v;
+            while (vs >> v)
+                values[d].push_back(v);
+        }
+        data.coordinates[std::make_pair(parseRiskFactorKeyType(tokens[0]), tokens[1])] = values;
+    }
+}
+
+} // namespace
+
+BinaryScenarioWriter::BinaryScenarioWriter(const QuantLib::ext::shared_ptr<ScenarioGenerator>& src,
+                                           const std::string& filename)
+    : src_(src), filename_(filename), out_(filename, std::ios::binary | std::ios::out | std::ios::trunc) {
+    QL_REQUIRE(out_.is_open(), "Error opening file " << filename << " for scenarios");
+}
+
+BinaryScenarioWriter::BinaryScenarioWriter(const std::string& filename) : BinaryScenarioWriter(nullptr, filename) {}
+
+BinaryScenarioWriter::~BinaryScenarioWriter() { close(); }
+
+void BinaryScenarioWriter::reset() {
+    if (src_)
+        src_->reset();
+    // a reset before the first scenario (e.g. by a ClonedScenarioGenerator) does not end the first pass
+    if (sharedData_ != nullptr)
+        close();
+}
+
+void BinaryScenarioWriter::close() {
+    if (out_.is_open())
+        out_.close();
+}
+
+QuantLib::ext::shared_ptr<Scenario> BinaryScenarioWriter::next(const Date& d) {
+    QL_REQUIRE(src_, "No ScenarioGenerator found.");
+    QuantLib::ext::shared_ptr<Scenario> s = src_->next(d);
+    if (out_.is_open())
+        writeScenario(*s);
+    return s;
+}
+
+void BinaryScenarioWriter::writeHeader(const Scenario& s) {
+    sharedData_ = QuantLib::ext::make_shared<SimpleScenario::SharedData>();
+    if (auto ss = dynamic_cast<const SimpleScenario*>(&s)) {
+        sharedData_->keys = ss->keys();
+        sharedData_->coordinates = ss->coordinates();
+    } else {
+        sharedData_->keys = s.keys();
+        sharedData_->coordinates = s.coordinates();
+    }
+    QL_REQUIRE(!sharedData_->keys.empty(), "No keys in scenario");
+    keys_ = sharedData_->keys;
+    isAbsolute_ = s.isAbsolute();
+    buffer_.resize(keys_.size() + 2);
+
+    std::string header = writeHeaderText(*sharedData_);
+    std::uint32_t version = binaryScenarioVersion;
+    std::uint32_t flags = isAbsolute_ ? 1 : 0;
+    std::uint64_t headerSize = header.size();
+    out_.write(binaryScenarioMagic, sizeof(binaryScenarioMagic));
+    out_.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out_.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+    out_.write(reinterpret_cast<const char*>(&headerSize), sizeof(headerSize));
+    out_.write(header.data(), header.size());
+    std::size_t pos = binaryScenarioPreambleSize + header.size();
+    std::size_t padding = (binaryScenarioAlignment - pos % binaryScenarioAlignment) % binaryScenarioAlignment;
+    const char zeros[binaryScenarioAlignment] = {};
+    out_.write(zeros, padding);
+}
+
+void BinaryScenarioWriter::writeScenario(const Scenario& s) {
+    QL_REQUIRE(out_.is_open(), "BinaryScenarioWriter: file " << filename_ << " is closed");
+    if (sharedData_ == nullptr)
+        writeHeader(s);
+    QL_REQUIRE(s.isAbsolute() == isAbsolute_, "BinaryScenarioWriter: scenario absolute flag ("
+                                                  << std::boolalpha << s.isAbsolute()
+                                                  << ") does not match the first scenario written to " << filename_);
+
+    // the asof date and numeraire are part of the block, the date serial number is stored as a double bit pattern
+    std::int64_t serial = s.asof().serialNumber();
+    std::memcpy(&buffer_[0], &serial, sizeof(serial));
+    buffer_[1] = s.getNumeraire();
+
+    // fast path for SimpleScenarios with the key layout of the first scenario, otherwise look up every key
+    auto ss = dynamic_cast<const SimpleScenario*>(&s);
+    if (ss && ss->data().size() == keys_.size() && ss->keys() == keys_) {
+        std::copy(ss->data().begin(), ss->data().end(), buffer_.begin() + 2);
+    } else {
+        for (Size k = 0; k < keys_.size(); ++k)
+            buffer_[k + 2] = s.get(keys_[k]);
+    }
+    out_.write(reinterpret_cast<const char*>(buffer_.data()), buffer_.size() * sizeof(double));
+    QL_REQUIRE(out_.good(), "BinaryScenarioWriter: error writing to " << filename_);
+}
+
+BinaryScenarioGenerator::BinaryScenarioGenerator(const std::string& filename)
+    : filename_(filename), sharedData_(QuantLib::ext::make_shared<SimpleScenario::SharedData>()) {
+    QL_REQUIRE(boost::filesystem::exists(filename), "BinaryScenarioGenerator: file '" << filename << "' not found");
+    QL_REQUIRE(boost::filesystem::file_size(filename) >= binaryScenarioPreambleSize,
+               "BinaryScenarioGenerator: file '" << filename << "' is too small for a binary scenario file");
+    file_.open(filename);
+    const char* p = file_.data();
+    const std::size_t fileSize = file_.size();
+
+    std::uint32_t version, flags;
+    std::uint64_t headerSize;
+    QL_REQUIRE(std::memcmp(p, binaryScenarioMagic, sizeof(binaryScenarioMagic)) == 0,
+               "BinaryScenarioGenerator: file '" << filename << "' is not a binary scenario file");
+    p += sizeof(binaryScenarioMagic);
+    std::memcpy(&version, p, sizeof(version));
+    p += sizeof(version);
+    std::memcpy(&flags, p, sizeof(flags));
+    p += sizeof(flags);
+    std::memcpy(&headerSize, p, sizeof(headerSize));
+    p += sizeof(headerSize);
+    QL_REQUIRE(version == binaryScenarioVersion, "BinaryScenarioGenerator: version "
+                                                     << version << " not supported, expected "
+                                                     << binaryScenarioVersion);
+    QL_REQUIRE(fileSize >= binaryScenarioPreambleSize + headerSize,
+               "BinaryScenarioGenerator: file '" << filename << "' truncated");
+    isAbsolute_ = (flags & 1) != 0;
+
+    readHeaderText(std::string(p, headerSize), *sharedData_, filename);
+
+    std::size_t offset = binaryScenarioPreambleSize + headerSize;
+    offset = (offset + binaryScenarioAlignment - 1) / binaryScenarioAlignment * binaryScenarioAlignment;
+    blocks_ = file_.data() + offset;
+    blockSize_ = (sharedData_->keys.size() + 2) * sizeof(double);
+    QL_REQUIRE(fileSize >= offset && (fileSize - offset) % blockSize_ == 0,
+               "BinaryScenarioGenerator: file '" << filename << "' has size " << fileSize
+                                                  << ", which is not a multiple of the block size " << blockSize_
+                                                  << " after the header");
+    size_ = (fileSize - offset) / blockSize_;
+
+    LOG("BinaryScenarioGenerator: opened " << filename << " with " << size_ << " scenarios and "
+                                           << sharedData_->keys.size() << " keys");
+}
+
+QuantLib::ext::shared_ptr<SimpleScenario> BinaryScenarioGenerator::scenario(const Size i) const {
+    QL_REQUIRE(i < size_, "BinaryScenarioGenerator: scenario index " << i << " out of range, file '" << filename_
+                                                                     << "' contains " << size_ << " scenarios");
+    const char* block = blocks_ + i * blockSize_;
+    std::int64_t serial;
+    Real numeraire;
+    std::memcpy(&serial, block, sizeof(serial));
+    std::memcpy(&numeraire, block + sizeof(double), sizeof(numeraire));
+    std::vector<Real> values(sharedData_->keys.size());
+    std::memcpy(values.data(), block + 2 * sizeof(double), values.size() * sizeof(double));
+    auto s = QuantLib::ext::make_shared<SimpleScenario>(Date(static_cast<Date::serial_type>(serial)), std::string(),
+                                                        numeraire, sharedData_);
+    s->setAbsolute(isAbsolute_);
+    s->setData(std::move(values));
+    return s;
+}
+
+Date BinaryScenarioGenerator::asof(const Size i) const {
+    QL_REQUIRE(i < size_, "BinaryScenarioGenerator: scenario index " << i << " out of range, file '" << filename_
+                                                                     << "' contains " << size_ << " scenarios");
+    std::int64_t serial;
+    std::memcpy(&serial, blocks_ + i * blockSize_, sizeof(serial));
+    return Date(static_cast<Date::serial_type>(serial));
+}
+
+Real BinaryScenarioGenerator::numeraire(const Size i) const {
+    QL_REQUIRE(i < size_, "BinaryScenarioGenerator: scenario index " << i << " out of range, file '" << filename_
+                                                                     << "' contains " << size_ << " scenarios");
+    Real numeraire;
+    std::memcpy(&numeraire, blocks_ + i * blockSize_ + sizeof(double), sizeof(numeraire));
+    return numeraire;
+}
+
+Real BinaryScenarioGenerator::value(const Size i, const Size k) const {
+    QL_REQUIRE(i < size_ && k < sharedData_->keys.size(),
+               "BinaryScenarioGenerator: scenario index " << i << " or key index " << k << " out of range, file '"
+                                                          << filename_ << "' contains " << size_ << " scenarios and "
+                                                          << sharedData_->keys.size() << " keys");
+    Real value;
+    std::memcpy(&value, blocks_ + i * blockSize_ + (k + 2) * sizeof(double), sizeof(value));
+    return value;
+}
+
+QuantLib::ext::shared_ptr<Scenario> BinaryScenarioGenerator::next(const Date& d) {
+    QL_REQUIRE(current_ < size_, "BinaryScenarioGenerator: unexpected end of scenario file " << filename_);
+    auto s = scenario(current_++);
+    QL_REQUIRE(s->asof() == d, "BinaryScenarioGenerator: incompatible date " << s->asof() << " in " << filename_
+                                                                              << ", expected " << d);
+    return s;
+}
+
+bool isBinaryScenarioFile(const std::string& filename) {
+    std::ifstream in(filename, std::ios::binary);
+    char magic[sizeof(binaryScenarioMagic)];
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, binaryScenarioMagic, sizeof(magic)) == 0;
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,141 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file scenario/binaryscenariofile.hpp
+    \brief Binary, memory mappable scenario file writer and generator
+    \ingroup scenario
+*/
+
+#pragma once
+
+#include <orea/scenario/scenariogenerator.hpp>
+#include <orea/scenario/simplescenario.hpp>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <fstream>
+
+namespace ore {
+namespace analytics {
+
+/*! Writer for binary scenario files
+
+    The file layout is
+    - the magic "ORESCEN\0", a uint32 version and uint32 flags (bit 0 = absolute scenarios)
+    - a uint64 header size followed by a text header with the keys and coordinates of the scenarios
+    - padding to a multiple of 8 bytes
+    - one block per scenario, containing the asof date serial number (int64), the numeraire (double) and the values
+      for all keys in header order (double)
+
+    All scenarios must provide values for the keys of the first scenario written. Labels are not stored. The values
+    are written in native byte order, i.e. the files are not portable between platforms with different endianness.
+
+    Analogous to the ScenarioWriter, the writer can wrap a scenario generator. In this case the scenarios returned by
+    next() are written until reset() is called after the first scenario, i.e. the file contains the scenarios of the
+    first pass through the source generator.
+
+    \ingroup scenario
+ */
+class BinaryScenarioWriter : public ScenarioGenerator {
+public:
+    //! Constructor wrapping a scenario generator
+    BinaryScenarioWriter(const QuantLib::ext::shared_ptr<ScenarioGenerator>& src, const std::string& filename);
+
+    //! Constructor to write single scenarios
+    explicit BinaryScenarioWriter(const std::string& filename);
+
+    //! Destructor
+    ~BinaryScenarioWriter() override;
+
+    //! Return the next scenario of the source generator and write it to the file
+    QuantLib::ext::shared_ptr<Scenario> next(const Date& d) override;
+
+    //! Reset the source generator and close the file, unless no scenario was written yet
+    void reset() override;
+
+    //! Write a single scenario
+    void writeScenario(const Scenario& s);
+
+    //! Close the file if it is open, not normally needed by client code
+    void close();
+
+private:
+    void writeHeader(const Scenario& s);
+
+    QuantLib::ext::shared_ptr<ScenarioGenerator> src_;
+    std::string filename_;
+    std::ofstream out_;
+    std::vector<RiskFactorKey> keys_;
+    QuantLib::ext::shared_ptr<SimpleScenario::SharedData> sharedData_;
+    bool isAbsolute_ = true;
+    std::vector<double> buffer_;
+};
+
+/*! Scenario generator reading a file written by the BinaryScenarioWriter
+
+    The file is memory mapped, next() copies the values of the next block into a SimpleScenario sharing one data block
+    for all scenarios, so that the ScenarioSimMarket applies them using its key binding.
+
+    \ingroup scenario
+ */
+class BinaryScenarioGenerator : public ScenarioGenerator {
+public:
+    explicit BinaryScenarioGenerator(const std::string& filename);
+
+    //! Return the next scenario in the file, the asof date must match the given date
+    QuantLib::ext::shared_ptr<Scenario> next(const Date& d) override;
+
+    //! Reset the generator so calls to next() return the first scenario
+    void reset() override { current_ = 0; }
+
+    //! Number of scenarios in the file
+    Size size() const { return size_; }
+
+    //! The ith scenario in the file
+    QuantLib::ext::shared_ptr<SimpleScenario> scenario(const Size i) const;
+
+    //! Shared data block of the scenarios in the file
+    const QuantLib::ext::shared_ptr<SimpleScenario::SharedData>& sharedData() const { return sharedData_; }
+
+    //! \name Direct access to the mapped file, without building a scenario
+    //@{
+    bool isAbsolute() const { return isAbsolute_; }
+    //! asof date of the ith scenario
+    Date asof(const Size i) const;
+    //! numeraire of the ith scenario
+    Real numeraire(const Size i) const;
+    //! value of the kth key in header order of the ith scenario
+    Real value(const Size i, const Size k) const;
+    //@}
+
+private:
+    std::string filename_;
+    boost::iostreams::mapped_file_source file_;
+    QuantLib::ext::shared_ptr<SimpleScenario::SharedData> sharedData_;
+    bool isAbsolute_ = true;
+    const char* blocks_ = nullptr;
+    Size blockSize_ = 0;
+    Size size_ = 0;
+    Size current_ = 0;
+};
+
+//! Return true if the file starts with the magic of a binary scenario file
+bool isBinaryScenarioFile(const std::string& filename);
+
+} // namespace analytics
+} // namespace ore
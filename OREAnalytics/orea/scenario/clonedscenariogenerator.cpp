@@ -24,13 +24,28 @@ namespace ore {
 namespace analytics {
 
 ClonedScenarioGenerator::ClonedScenarioGenerator(const QuantLib::ext::shared_ptr<ScenarioGenerator>& scenarioGenerator,
-                                                 const std::vector<Date>& dates, const Size nSamples) {
-    DLOG("Build cloned scenario generator for " << dates.size() << " dates and " << nSamples << " samples.");
+                                                 const std::vector<Date>& dates, const Size nSamples,
+                                                 const bool compact) {
+    DLOG("Build cloned scenario generator for " << dates.size() << " dates and " << nSamples << " samples"
+                                                << (compact ? " (compact storage)." : "."));
     for (size_t i = 0; i < dates.size(); ++i) {
         dates_[dates[i]] = i;
     }
     firstDate_ = dates.front();
     scenarioGenerator->reset();
+    if (compact) {
+        auto store = QuantLib::ext::make_shared<CompactScenarioStore>();
+        for (Size i = 0; i < nSamples; ++i) {
+            for (Size j = 0; j < dates.size(); ++j) {
+                auto s = scenarioGenerator->next(dates[j]);
+                if (store->size() == 0)
+                    store->reserve(nSamples * dates.size(), s->keys().size());
+                store->add(*s);
+            }
+        }
+        compactScenarios_ = store;
+        return;
+    }
     scenarios_.resize(nSamples * dates_.size());
     for (Size i = 0; i < nSamples; ++i) {
         for (Size j = 0; j < dates.size(); ++j) {
@@ -39,6 +54,13 @@ ClonedScenarioGenerator::ClonedScenarioGenerator(const QuantLib::ext::shared_ptr
     }
 }
 
+ClonedScenarioGenerator::ClonedScenarioGenerator(const ClonedScenarioGenerator& other, const Size sampleOffset)
+    : dates_(other.dates_), firstDate_(other.firstDate_), nSim_(0), sampleOffset_(sampleOffset),
+      scenarios_(other.scenarios_), compactScenarios_(other.compactScenarios_) {
+    QL_REQUIRE(sampleOffset_ * dates_.size() <= numberOfScenarios(),
+               "ClonedScenarioGenerator: sample offset " << sampleOffset_ << " exceeds number of stored samples");
+}
+
 QuantLib::ext::shared_ptr<Scenario> ClonedScenarioGenerator::next(const Date& d) {
     if (d == firstDate_) { // new path
         ++nSim_;
@@ -46,12 +68,18 @@ QuantLib::ext::shared_ptr<Scenario> ClonedScenarioGenerator::next(const Date& d)
     auto stepIdx = dates_.find(d);
     QL_REQUIRE(stepIdx != dates_.end(), "ClonedScenarioGenerator::next(" << d << "): invalid date " << d);
     size_t timePos = stepIdx->second;
-    size_t currentStep = (nSim_ - 1) * dates_.size() + timePos;
-    QL_REQUIRE(currentStep < scenarios_.size(),
+    size_t currentStep = (sampleOffset_ + nSim_ - 1) * dates_.size() + timePos;
+    QL_REQUIRE(currentStep < numberOfScenarios(),
                "ClonedScenarioGenerator::next(" << d << "): no more scenarios stored.");
+    if (compactScenarios_)
+        return compactScenarios_->get(currentStep);
     return scenarios_[currentStep];
 }
 
+Size ClonedScenarioGenerator::numberOfScenarios() const {
+    return compactScenarios_ ? compactScenarios_->size() : scenarios_.size();
+}
+
 void ClonedScenarioGenerator::reset() { 
     nSim_ = 0;
 }
@@ -23,23 +23,33 @@
 
 #pragma once
 
+#include <orea/scenario/compactscenariostore.hpp>
 #include <orea/scenario/scenariogenerator.hpp>
 
 namespace ore {
 namespace analytics {
 
+/*! Scenario generator that stores all scenarios of a given generator for the given dates and samples and replays
+    them. If compact is true, the scenarios are held in a CompactScenarioStore (single precision differences to the
+    first scenario), which halves the memory needed, and a new SimpleScenario is built on each call to next(). */
 class ClonedScenarioGenerator : public ScenarioGenerator {
 public:
     ClonedScenarioGenerator(const QuantLib::ext::shared_ptr<ScenarioGenerator>& scenarioGenerator,
-                            const std::vector<Date>& dates, const Size nSamples);
+                            const std::vector<Date>& dates, const Size nSamples, const bool compact = false);
+    /*! Builds a generator sharing the scenarios with the given one, but starting at the given sample, i.e. the first
+        path delivered after construction or reset() is the path with index sampleOffset of the original generator */
+    ClonedScenarioGenerator(const ClonedScenarioGenerator& other, const Size sampleOffset);
     QuantLib::ext::shared_ptr<Scenario> next(const Date& d) override;
     virtual void reset() override;
 
 private:
+    Size numberOfScenarios() const;
     std::map<Date, size_t> dates_;
     Date firstDate_;
     Size nSim_ = 0;
+    Size sampleOffset_ = 0;
     std::vector<QuantLib::ext::shared_ptr<Scenario>> scenarios_;
+    QuantLib::ext::shared_ptr<const CompactScenarioStore> compactScenarios_;
 };
 
 } // namespace analytics
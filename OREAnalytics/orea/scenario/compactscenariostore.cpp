@@ -0,0 +1,123 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/scenario/compactscenariostore.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/utilities/null.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace ore {
+namespace analytics {
+
+void CompactScenarioStore::reserve(const Size nScenarios, const Size nKeys) {
+    data_.reserve(nScenarios * nKeys);
+    asof_.reserve(nScenarios);
+    numeraire_.reserve(nScenarios);
+    label_.reserve(nScenarios);
+}
+
+void CompactScenarioStore::add(const Scenario& scenario) {
+    auto s = dynamic_cast<const SimpleScenario*>(&scenario);
+
+    if (sharedData_ == nullptr) {
+
+        // the first scenario defines the key layout and the reference values
+
+        sharedData_ = QuantLib::ext::make_shared<SimpleScenario::SharedData>();
+        if (s) {
+            *sharedData_ = *s->sharedData();
+        } else {
+            for (auto const& key : scenario.keys()) {
+                sharedData_->keyIndex[key] = sharedData_->keys.size();
+                sharedData_->keys.push_back(key);
+                boost::hash_combine(sharedData_->keysHash, key);
+            }
+            sharedData_->coordinates = scenario.coordinates();
+        }
+        isAbsolute_ = scenario.isAbsolute();
+        reference_.resize(sharedData_->keys.size());
+        for (Size k = 0; k < reference_.size(); ++k) {
+            Real v = s ? s->data()[k] : scenario.get(sharedData_->keys[k]);
+            reference_[k] = v == QuantLib::Null<Real>() ? 0.0 : v;
+        }
+    }
+
+    QL_REQUIRE(scenario.isAbsolute() == isAbsolute_,
+               "CompactScenarioStore::add(): scenario absolute flag (" << std::boolalpha << scenario.isAbsolute()
+                                                                        << ") does not match the stored scenarios");
+
+    const Size n = reference_.size();
+    const Size offset = data_.size();
+    data_.resize(offset + n);
+
+    // fast path for SimpleScenarios with the same key layout, otherwise look up every key
+
+    const std::vector<Real>* values = nullptr;
+    if (s && s->keys().size() == n &&
+        (s->sharedData() == sharedData_ || s->keys() == sharedData_->keys))
+        values = &s->data();
+
+    try {
+        for (Size k = 0; k < n; ++k) {
+            Real v;
+            if (values)
+                v = k < values->size() ? (*values)[k] : QuantLib::Null<Real>();
+            else
+                v = scenario.get(sharedData_->keys[k]);
+            data_[offset + k] = v == QuantLib::Null<Real>() ? std::numeric_limits<float>::quiet_NaN()
+                                                            : static_cast<float>(v - reference_[k]);
+        }
+    } catch (...) {
+        data_.resize(offset);
+        throw;
+    }
+
+    asof_.push_back(scenario.asof());
+    numeraire_.push_back(scenario.getNumeraire());
+    label_.push_back(scenario.label());
+}
+
+const std::vector<RiskFactorKey>& CompactScenarioStore::keys() const {
+    static const std::vector<RiskFactorKey> empty;
+    return sharedData_ ? sharedData_->keys : empty;
+}
+
+void CompactScenarioStore::data(const Size i, std::vector<Real>& values) const {
+    QL_REQUIRE(i < size(), "CompactScenarioStore::data(): index " << i << " out of range, size is " << size());
+    const Size n = reference_.size();
+    const float* d = data_.data() + i * n;
+    values.resize(n);
+    for (Size k = 0; k < n; ++k)
+        values[k] = std::isnan(d[k]) ? QuantLib::Null<Real>() : reference_[k] + static_cast<Real>(d[k]);
+}
+
+QuantLib::ext::shared_ptr<SimpleScenario> CompactScenarioStore::get(const Size i) const {
+    QL_REQUIRE(i < size(), "CompactScenarioStore::get(): index " << i << " out of range, size is " << size());
+    auto scenario = QuantLib::ext::make_shared<SimpleScenario>(asof_[i], label_[i], numeraire_[i], sharedData_);
+    scenario->setAbsolute(isAbsolute_);
+    std::vector<Real> values;
+    data(i, values);
+    scenario->setData(std::move(values));
+    return scenario;
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,85 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file scenario/compactscenariostore.hpp
+    \brief Compact single precision storage of scenarios sharing one key layout
+    \ingroup scenario
+*/
+
+#pragma once
+
+#include <orea/scenario/simplescenario.hpp>
+
+namespace ore {
+namespace analytics {
+
+//! Compact storage of a set of scenarios sharing one key layout
+/*! The first scenario added defines the key layout and serves as the reference scenario, its values are kept in
+    double precision. All scenarios are stored as single precision differences to the reference values in one flat
+    buffer, so the error of a stored value is bounded by its distance to the reference value times the float
+    epsilon, rather than by its absolute size, which matters for e.g. discount factors close to one.
+
+    Compared to a vector of SimpleScenario instances with a common shared data block, this halves the memory
+    needed for the scenario data. Asof dates, numeraires and labels are stored in full.
+
+    Scenarios are retrieved as SimpleScenario instances sharing the store's shared data block, so that the
+    ScenarioSimMarket applies them using its key binding, and they can be passed e.g. to the scenario writers.
+
+    Null values are stored as NaN and restored as Null<Real>(), i.e. NaN scenario values are not preserved.
+
+    \ingroup scenario
+ */
+class CompactScenarioStore {
+public:
+    CompactScenarioStore() = default;
+
+    //! reserve memory for the given number of scenarios with the given number of keys
+    void reserve(const Size nScenarios, const Size nKeys);
+
+    /*! append a scenario, the first one defines the key layout and all others must provide values for all of its
+        keys and must have the same absolute / spread type */
+    void add(const Scenario& scenario);
+
+    //! number of stored scenarios
+    Size size() const { return asof_.size(); }
+    //! number of keys per scenario
+    Size numberOfKeys() const { return reference_.size(); }
+    //! keys of the stored scenarios
+    const std::vector<RiskFactorKey>& keys() const;
+
+    //! retrieve the ith scenario as a SimpleScenario sharing the store's shared data block
+    QuantLib::ext::shared_ptr<SimpleScenario> get(const Size i) const;
+
+    //! get the data of the ith scenario, order is the same as in keys()
+    void data(const Size i, std::vector<Real>& values) const;
+
+    //! shared data block of the scenarios returned by get()
+    const QuantLib::ext::shared_ptr<SimpleScenario::SharedData>& sharedData() const { return sharedData_; }
+
+private:
+    QuantLib::ext::shared_ptr<SimpleScenario::SharedData> sharedData_;
+    bool isAbsolute_ = true;
+    std::vector<Real> reference_;
+    std::vector<float> data_;
+    std::vector<Date> asof_;
+    std::vector<Real> numeraire_;
+    std::vector<std::string> label_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -34,10 +34,10 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
     QuantLib::ext::shared_ptr<QuantExt::MultiPathGeneratorBase> pathGenerator,
     QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory, QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> simMarketConfig,
     Date today, QuantLib::ext::shared_ptr<DateGrid> grid, QuantLib::ext::shared_ptr<ore::data::Market> initMarket,
-    const std::string& configuration)
+    const std::string& configuration, const Size batchSize)
     : ScenarioPathGenerator(today, grid->dates(), grid->timeGrid()), model_(model), pathGenerator_(pathGenerator),
       scenarioFactory_(scenarioFactory), simMarketConfig_(simMarketConfig), initMarket_(initMarket),
-      configuration_(configuration) {
+      configuration_(configuration), batchSize_(batchSize) {
 
     LOG("CrossAssetModelScenarioGenerator ctor called");
     
@@ -233,6 +233,7 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
         auto impliedFwdCurve = QuantLib::ext::make_shared<ModelImpliedYtsFwdFwdCorrected>(
             model_->irModel(model_->ccyIndex(index->currency())), fts, dc, false);
         fwdCurves_.push_back(impliedFwdCurve);
+        fwdCurveTargets_.push_back(fts);
         indices_.push_back(index->clone(Handle<YieldTermStructure>(impliedFwdCurve)));
     }
 
@@ -243,6 +244,7 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
         auto impliedYieldCurve =
             QuantLib::ext::make_shared<ModelImpliedYtsFwdFwdCorrected>(model_->irModel(model_->ccyIndex(ccy)), yts, dc, false);
         yieldCurves_.push_back(impliedYieldCurve);
+        yieldCurveTargets_.push_back(yts);
         yieldCurveCurrency_.push_back(ccy);
     }
 
@@ -310,6 +312,30 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
         }
     }
 
+    // batch mode, only for LGM1F ir models, for which we have vectorised formulas
+
+    if (batchSize_ > 1) {
+        vectorised_ = true;
+        for (Size j = 0; j < n_ccy_; ++j) {
+            if (model_->modelType(CrossAssetModel::AssetType::IR, j) != CrossAssetModel::ModelType::LGM1F) {
+                WLOG("CrossAssetModelScenarioGenerator: path batch size "
+                     << batchSize_ << " is ignored, since the ir model for "
+                     << model_->parametrizations()[j]->currency().code() << " is not LGM1F");
+                vectorised_ = false;
+                break;
+            }
+            lgmVectorised_.push_back(LgmVectorised(model_->irlgm1f(j)));
+        }
+        if (!vectorised_)
+            lgmVectorised_.clear();
+        for (Size j = 0; j < n_indices_; ++j)
+            indexCcyIdx_.push_back(model_->ccyIndex(indices_[j]->currency()));
+        for (Size j = 0; j < n_curves_; ++j)
+            yieldCurveCcyIdx_.push_back(model_->ccyIndex(yieldCurveCurrency_[j]));
+        LOG("CrossAssetModelScenarioGenerator: batch mode " << (vectorised_ ? "on" : "off") << ", batch size "
+                                                             << batchSize_);
+    }
+
     LOG("CrossAssetModelScenarioGenerator ctor done");
 }
 
@@ -321,8 +347,16 @@ void copyPathToArray(const MultiPath& p, Size t, Size a, Array& target) {
 } // namespace
 
 std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerator::nextPath() {
-    std::vector<QuantLib::ext::shared_ptr<Scenario>> scenarios(dates_.size());
     QL_REQUIRE(pathGenerator_ != nullptr, "CrossAssetModelScenarioGenerator::nextPath(): pathGenerator is null");
+
+    // in batch mode, serve the path from the current batch, generate a new batch if it is exhausted
+    if (vectorised_) {
+        if (batchPos_ == batch_.size())
+            generateBatch();
+        return std::move(batch_[batchPos_++]);
+    }
+
+    std::vector<QuantLib::ext::shared_ptr<Scenario>> scenarios(dates_.size());
     Sample<MultiPath> sample = pathGenerator_->next();
     DayCounter dc = model_->irModel(0)->termStructure()->dayCounter();
 
@@ -355,225 +389,317 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
         // Set numeraire from domestic ir process
         scenarios[i]->setNumeraire(model_->numeraire(0, t, ir_state[0], Handle<YieldTermStructure>(), ir_state_aux));
 
+        // the discount factors of all pillars of a curve are computed in one call
+        auto addCurve = [&dc, &scenarios, i, this](const ModelImpliedYieldTermStructure& curve,
+                                                  const std::vector<Period>& tenors,
+                                                  const std::vector<RiskFactorKey>& keys, const Size offset) {
+            std::vector<Time> T(tenors.size());
+            for (Size k = 0; k < tenors.size(); ++k)
+                T[k] = dc.yearFraction(dates_[i], dates_[i] + tenors[k]);
+            std::vector<Real> discounts = curve.discounts(T);
+            for (Size k = 0; k < tenors.size(); ++k)
+                scenarios[i]->add(keys[offset + k], std::max(discounts[k], 0.00001));
+        };
+
         // Discount curves
         for (Size j = 0; j < n_ccy_; j++) {
             curves_[j]->move(t, ir_state[j]);
-            for (Size k = 0; k < ten_dsc_[j].size(); k++) {
-                Date d = dates_[i] + ten_dsc_[j][k];
-                Time T = dc.yearFraction(dates_[i], d);
-                Real discount = std::max(curves_[j]->discount(T), 0.00001);
-                scenarios[i]->add(discountCurveKeys_[j * ten_dsc_[j].size() + k], discount);
-            }
+            addCurve(*curves_[j], ten_dsc_[j], discountCurveKeys_, j * ten_dsc_[j].size());
         }
 
         // Index curves and Index fixings
         for (Size j = 0; j < n_indices_; ++j) {
             fwdCurves_[j]->move(dates_[i], ir_state[indexCcyIdx[j]]);
-            for (Size k = 0; k < ten_idx_[j].size(); ++k) {
-                Date d = dates_[i] + ten_idx_[j][k];
-                Time T = dc.yearFraction(dates_[i], d);
-                Real discount = std::max(fwdCurves_[j]->discount(T), 0.00001);
-                scenarios[i]->add(indexCurveKeys_[j * ten_idx_[j].size() + k], discount);
-            }
+            addCurve(*fwdCurves_[j], ten_idx_[j], indexCurveKeys_, j * ten_idx_[j].size());
         }
 
         // Yield curves
         for (Size j = 0; j < n_curves_; ++j) {
             yieldCurves_[j]->move(dates_[i], ir_state[yieldCurveCcyIdx[j]]);
-            for (Size k = 0; k < ten_yc_[j].size(); ++k) {
-                Date d = dates_[i] + ten_yc_[j][k];
-                Time T = dc.yearFraction(dates_[i], d);
-                Real discount = std::max(yieldCurves_[j]->discount(T), 0.00001);
-                scenarios[i]->add(yieldCurveKeys_[j * ten_yc_[j].size() + k], discount);
-            }
+            addCurve(*yieldCurves_[j], ten_yc_[j], yieldCurveKeys_, j * ten_yc_[j].size());
         }
 
-        // FX rates
-        for (Size k = 0; k < n_ccy_ - 1; k++) {
-            Real fx = std::exp(sample.value[model_->pIdx(CrossAssetModel::AssetType::FX, k)][i + 1]);
-            scenarios[i]->add(fxKeys_[k], fx);
-        }
+        addNonCurveValues(i, sample.value, ir_state, *scenarios[i]);
+    }
+    return scenarios;
+}
 
-        // FX vols
-        if (simMarketConfig_->simulateFXVols()) {
-            for (Size k = 0; k < simMarketConfig_->fxVolCcyPairs().size(); k++) {
-                const string ccyPair = simMarketConfig_->fxVolCcyPairs()[k];
-                const vector<Period>& expires = simMarketConfig_->fxVolExpiries(ccyPair);
+void CrossAssetModelScenarioGenerator::generateBatch() {
+    const Size n = batchSize_;
+    std::vector<Sample<MultiPath>> samples;
+    samples.reserve(n);
+    for (Size p = 0; p < n; ++p)
+        samples.push_back(pathGenerator_->next());
+    DayCounter dc = model_->irModel(0)->termStructure()->dayCounter();
 
-                Size fxIndex = fxVols_[k]->fxIndex();
-                Real zFor = sample.value[fxIndex + 1][i + 1];
-                Real logFx = sample.value[n_ccy_ + fxIndex][i + 1]; // multiplies USD amount to get EUR
-                fxVols_[k]->move(dates_[i], ir_state[0][0], zFor, logFx);
+    batch_.assign(n, std::vector<QuantLib::ext::shared_ptr<Scenario>>(dates_.size()));
+    batchPos_ = 0;
 
-                for (Size j = 0; j < expires.size(); j++) {
-                    Real vol = fxVols_[k]->blackVol(dates_[i] + expires[j], Null<Real>(), true);
-                    scenarios[i]->add(RiskFactorKey(RiskFactorKey::KeyType::FXVolatility, ccyPair, j), vol);
-                }
+    // per path ir states (for the scalar numeraire and the non-curve values) and their vectorised counterparts
+
+    std::vector<std::vector<Array>> ir_state(n, std::vector<Array>(n_ccy_, Array(1)));
+    Array ir_state_aux(model_->irModel(0)->n_aux());
+    std::vector<RandomVariable> x(n_ccy_, RandomVariable(n));
+
+    for (Size i = 0; i < dates_.size(); i++) {
+        Real t = timeGrid_[i + 1]; // recall: time grid has inserted t=0
+
+        for (Size p = 0; p < n; ++p) {
+            const MultiPath& path = samples[p].value;
+            batch_[p][i] = scenarioFactory_->buildScenario(dates_[i], true);
+            for (Size j = 0; j < n_ccy_; ++j) {
+                ir_state[p][j][0] = path[model_->pIdx(CrossAssetModel::AssetType::IR, j)][i + 1];
+                x[j].set(p, ir_state[p][j][0]);
             }
+            copyPathToArray(path, i + 1, model_->pIdx(CrossAssetModel::AssetType::IR, 0) + 1, ir_state_aux);
+            batch_[p][i]->setNumeraire(
+                model_->numeraire(0, t, ir_state[p][0], Handle<YieldTermStructure>(), ir_state_aux));
         }
 
-        // Equity spots
-        for (Size k = 0; k < n_eq_; k++) {
-            Real eqSpot = std::exp(sample.value[model_->pIdx(CrossAssetModel::AssetType::EQ, k)][i + 1]);
-            scenarios[i]->add(eqKeys_[k], eqSpot);
+        // add the curve values across the batch, the order of keys per scenario is the same as in nextPath()
+
+        RandomVariable floor(n, 0.00001);
+        auto addCurve = [this, &dc, &floor, n, i](const Time tRel, const RandomVariable& xj,
+                                                  const LgmVectorised& lgm, const Handle<YieldTermStructure>& target,
+                                                  const std::vector<Period>& tenors,
+                                                  const std::vector<RiskFactorKey>& keys, const Size offset) {
+            std::vector<Time> T(tenors.size()), TAbs(tenors.size());
+            for (Size k = 0; k < tenors.size(); ++k) {
+                T[k] = dc.yearFraction(dates_[i], dates_[i] + tenors[k]);
+                TAbs[k] = tRel + T[k];
+            }
+            // as in ModelImpliedYtsFwdFwdCorrected, the target curve is used directly at relative time zero
+            bool useTarget = !target.empty() && QuantLib::close_enough(tRel, 0.0);
+            std::vector<RandomVariable> discounts;
+            if (!useTarget)
+                discounts = lgm.discountBonds(tRel, TAbs, xj, target);
+            for (Size k = 0; k < tenors.size(); ++k) {
+                RandomVariable discount =
+                    max(useTarget ? RandomVariable(n, target->discount(T[k])) : discounts[k], floor);
+                for (Size p = 0; p < n; ++p)
+                    batch_[p][i]->add(keys[offset + k], discount[p]);
+            }
+        };
+
+        // Discount curves
+        for (Size j = 0; j < n_ccy_; ++j)
+            addCurve(t, x[j], lgmVectorised_[j], Handle<YieldTermStructure>(), ten_dsc_[j], discountCurveKeys_,
+                     j * ten_dsc_[j].size());
+
+        // Index curves
+        for (Size j = 0; j < n_indices_; ++j) {
+            Size ccy = indexCcyIdx_[j];
+            Time tRel = dc.yearFraction(model_->irModel(ccy)->termStructure()->referenceDate(), dates_[i]);
+            addCurve(tRel, x[ccy], lgmVectorised_[ccy], fwdCurveTargets_[j], ten_idx_[j], indexCurveKeys_,
+                     j * ten_idx_[j].size());
         }
 
-        // Equity vols
-        if (simMarketConfig_->simulateEquityVols()) {
-            for (Size k = 0; k < simMarketConfig_->equityVolNames().size(); k++) {
-                const string equityName = simMarketConfig_->equityVolNames()[k];
+        // Yield curves
+        for (Size j = 0; j < n_curves_; ++j) {
+            Size ccy = yieldCurveCcyIdx_[j];
+            Time tRel = dc.yearFraction(model_->irModel(ccy)->termStructure()->referenceDate(), dates_[i]);
+            addCurve(tRel, x[ccy], lgmVectorised_[ccy], yieldCurveTargets_[j], ten_yc_[j], yieldCurveKeys_,
+                     j * ten_yc_[j].size());
+        }
 
-                const vector<Period>& expiries = simMarketConfig_->equityVolExpiries(equityName);
+        // all other values path by path
 
-                Size eqIndex = eqVols_[k]->equityIndex();
-                Size eqCcyIdx = eqVols_[k]->eqCcyIndex();
-                Real z_eqIr = sample.value[eqCcyIdx][i + 1];
-                Real logEq = sample.value[eqIndex][i + 1];
-                eqVols_[k]->move(dates_[i], z_eqIr, logEq);
+        for (Size p = 0; p < n; ++p)
+            addNonCurveValues(i, samples[p].value, ir_state[p], *batch_[p][i]);
+    }
+}
 
-                for (Size j = 0; j < expiries.size(); j++) {
-                    Real vol = eqVols_[k]->blackVol(dates_[i] + expiries[j], Null<Real>(), true);
-                    scenarios[i]->add(RiskFactorKey(RiskFactorKey::KeyType::EquityVolatility, equityName, j), vol);
-                }
-            }
-        }
+void CrossAssetModelScenarioGenerator::addNonCurveValues(const Size i, const MultiPath& path,
+                                                         const std::vector<Array>& ir_state, Scenario& scenario) {
+    DayCounter dc = model_->irModel(0)->termStructure()->dayCounter();
+    Real t = timeGrid_[i + 1]; // recall: time grid has inserted t=0
 
-        // Inflation index values
-        for (Size j = 0; j < n_inf_; j++) {
-
-            // Depending on type of model, i.e. DK or JY, z and y mean different things.
-            Real z = sample.value[model_->pIdx(CrossAssetModel::AssetType::INF, j, 0)][i + 1];
-            Real y = sample.value[model_->pIdx(CrossAssetModel::AssetType::INF, j, 1)][i + 1];
-
-            // Could possibly cache the model type outside the loop to improve performance.
-            Real cpi = 0.0;
-            if (model_->modelType(CrossAssetModel::AssetType::INF, j) == CrossAssetModel::ModelType::JY) {
-                cpi = std::exp(sample.value[model_->pIdx(CrossAssetModel::AssetType::INF, j, 1)][i + 1]);
-            } else if (model_->modelType(CrossAssetModel::AssetType::INF, j) == CrossAssetModel::ModelType::DK) {
-                auto index = *initMarket_->zeroInflationIndex(model_->inf(j)->name());
-                Date baseDate = index->zeroInflationTermStructure()->baseDate();
-                auto zts = index->zeroInflationTermStructure();
-                Time relativeTime = inflationYearFraction(zts->frequency(), false, zts->dayCounter(),
-                                                          baseDate, dates_[i] - zts->observationLag());
-                std::tie(cpi, std::ignore) = model_->infdkI(j, relativeTime, relativeTime, z, y);
-                cpi *= index->fixing(baseDate);
-            } else {
-                QL_FAIL("CrossAssetModelScenarioGenerator: expected inflation model to be JY or DK.");
-            }
+    // FX rates
+    for (Size k = 0; k < n_ccy_ - 1; k++) {
+        Real fx = std::exp(path[model_->pIdx(CrossAssetModel::AssetType::FX, k)][i + 1]);
+        scenario.add(fxKeys_[k], fx);
+    }
+
+    // FX vols
+    if (simMarketConfig_->simulateFXVols()) {
+        for (Size k = 0; k < simMarketConfig_->fxVolCcyPairs().size(); k++) {
+            const string ccyPair = simMarketConfig_->fxVolCcyPairs()[k];
+            const vector<Period>& expires = simMarketConfig_->fxVolExpiries(ccyPair);
 
-            scenarios[i]->add(cpiKeys_[j], cpi);
+            Size fxIndex = fxVols_[k]->fxIndex();
+            Real zFor = path[fxIndex + 1][i + 1];
+            Real logFx = path[n_ccy_ + fxIndex][i + 1]; // multiplies USD amount to get EUR
+            fxVols_[k]->move(dates_[i], ir_state[0][0], zFor, logFx);
+
+            for (Size j = 0; j < expires.size(); j++) {
+                Real vol = fxVols_[k]->blackVol(dates_[i] + expires[j], Null<Real>(), true);
+                scenario.add(RiskFactorKey(RiskFactorKey::KeyType::FXVolatility, ccyPair, j), vol);
+            }
         }
+    }
 
-        // Zero inflation curves
-        for (Size j = 0; j < zeroInfCurves_.size(); ++j) {
+    // Equity spots
+    for (Size k = 0; k < n_eq_; k++) {
+        Real eqSpot = std::exp(path[model_->pIdx(CrossAssetModel::AssetType::EQ, k)][i + 1]);
+        scenario.add(eqKeys_[k], eqSpot);
+    }
 
-            auto tup = zeroInfCurves_[j];
+    // Equity vols
+    if (simMarketConfig_->simulateEquityVols()) {
+        for (Size k = 0; k < simMarketConfig_->equityVolNames().size(); k++) {
+            const string equityName = simMarketConfig_->equityVolNames()[k];
 
-            // State variables needed depends on model, 3 for JY and 2 for DK.
-            auto idx = std::get<0>(tup);
-            Array state(3);
-            state[0] = sample.value[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 0)][i + 1];
-            state[1] = sample.value[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 1)][i + 1];
-            if (std::get<2>(tup) == CrossAssetModel::ModelType::DK) {
-                state.resize(2);
-            } else {
-                state[2] = ir_state[std::get<1>(tup)][0];
-            }
+            const vector<Period>& expiries = simMarketConfig_->equityVolExpiries(equityName);
 
-            // Update the term structure's date and state.
-            auto ts = std::get<3>(tup);
-            ts->move(dates_[i], state);
+            Size eqIndex = eqVols_[k]->equityIndex();
+            Size eqCcyIdx = eqVols_[k]->eqCcyIndex();
+            Real z_eqIr = path[eqCcyIdx][i + 1];
+            Real logEq = path[eqIndex][i + 1];
+            eqVols_[k]->move(dates_[i], z_eqIr, logEq);
 
-            // Populate the zero inflation scenario values based on the current date and state.
-            for (Size k = 0; k < ten_zinf_[j].size(); k++) {
-                Time T = dc.yearFraction(dates_[i], dates_[i] + ten_zinf_[j][k]);
-                scenarios[i]->add(zeroInflationKeys_[j * ten_zinf_[j].size() + k], ts->zeroRate(T));
+            for (Size j = 0; j < expiries.size(); j++) {
+                Real vol = eqVols_[k]->blackVol(dates_[i] + expiries[j], Null<Real>(), true);
+                scenario.add(RiskFactorKey(RiskFactorKey::KeyType::EquityVolatility, equityName, j), vol);
             }
         }
+    }
 
-        // YoY inflation curves
-        for (Size j = 0; j < yoyInfCurves_.size(); ++j) {
+    // Inflation index values
+    for (Size j = 0; j < n_inf_; j++) {
+
+        // Depending on type of model, i.e. DK or JY, z and y mean different things.
+        Real z = path[model_->pIdx(CrossAssetModel::AssetType::INF, j, 0)][i + 1];
+        Real y = path[model_->pIdx(CrossAssetModel::AssetType::INF, j, 1)][i + 1];
+
+        // Could possibly cache the model type outside the loop to improve performance.
+        Real cpi = 0.0;
+        if (model_->modelType(CrossAssetModel::AssetType::INF, j) == CrossAssetModel::ModelType::JY) {
+            cpi = std::exp(path[model_->pIdx(CrossAssetModel::AssetType::INF, j, 1)][i + 1]);
+        } else if (model_->modelType(CrossAssetModel::AssetType::INF, j) == CrossAssetModel::ModelType::DK) {
+            auto index = *initMarket_->zeroInflationIndex(model_->inf(j)->name());
+            Date baseDate = index->zeroInflationTermStructure()->baseDate();
+            auto zts = index->zeroInflationTermStructure();
+            Time relativeTime = inflationYearFraction(zts->frequency(), false, zts->dayCounter(),
+                                                      baseDate, dates_[i] - zts->observationLag());
+            std::tie(cpi, std::ignore) = model_->infdkI(j, relativeTime, relativeTime, z, y);
+            cpi *= index->fixing(baseDate);
+        } else {
+            QL_FAIL("CrossAssetModelScenarioGenerator: expected inflation model to be JY or DK.");
+        }
 
-            auto tup = yoyInfCurves_[j];
+        scenario.add(cpiKeys_[j], cpi);
+    }
 
-            // For YoY model implied term structure, JY and DK both need 3 state variables.
-            auto idx = std::get<0>(tup);
-            Array state(3);
-            state[0] = sample.value[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 0)][i + 1];
-            state[1] = sample.value[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 1)][i + 1];
+    // Zero inflation curves
+    for (Size j = 0; j < zeroInfCurves_.size(); ++j) {
+
+        auto tup = zeroInfCurves_[j];
+
+        // State variables needed depends on model, 3 for JY and 2 for DK.
+        auto idx = std::get<0>(tup);
+        Array state(3);
+        state[0] = path[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 0)][i + 1];
+        state[1] = path[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 1)][i + 1];
+        if (std::get<2>(tup) == CrossAssetModel::ModelType::DK) {
+            state.resize(2);
+        } else {
             state[2] = ir_state[std::get<1>(tup)][0];
+        }
 
-            // Update the term structure's date and state.
-            auto ts = std::get<3>(tup);
-            ts->move(dates_[i], state);
+        // Update the term structure's date and state.
+        auto ts = std::get<3>(tup);
+        ts->move(dates_[i], state);
+
+        // Populate the zero inflation scenario values based on the current date and state.
+        vector<Time> T(ten_zinf_[j].size());
+        for (Size k = 0; k < T.size(); k++)
+            T[k] = dc.yearFraction(dates_[i], dates_[i] + ten_zinf_[j][k]);
+        vector<Real> zeroRates = ts->zeroRates(T);
+        for (Size k = 0; k < T.size(); k++)
+            scenario.add(zeroInflationKeys_[j * T.size() + k], zeroRates[k]);
+    }
 
-            // Create the YoY pillar dates from the tenors.
-            vector<Date> pillarDates(ten_yinf_[j].size());
-            for (Size k = 0; k < pillarDates.size(); ++k)
-                pillarDates[k] = dates_[i] + ten_yinf_[j][k];
+    // YoY inflation curves
+    for (Size j = 0; j < yoyInfCurves_.size(); ++j) {
 
-            // Use the YoY term structure's YoY rates to populate the scenarios.
-            auto yoyRates = ts->yoyRates(pillarDates);
-            for (Size k = 0; k < pillarDates.size(); ++k) {
-                scenarios[i]->add(yoyInflationKeys_[j * ten_yinf_[j].size() + k], yoyRates.at(pillarDates[k]));
-            }
-        }
+        auto tup = yoyInfCurves_[j];
 
-        // Credit curves
-        for (Size j = 0; j < n_cr_; ++j) {
-            if (model_->modelType(CrossAssetModel::AssetType::CR, j) == CrossAssetModel::ModelType::LGM1F) {
-                Real z = sample.value[model_->pIdx(CrossAssetModel::AssetType::CR, j, 0)][i + 1];
-                Real y = sample.value[model_->pIdx(CrossAssetModel::AssetType::CR, j, 1)][i + 1];
-                lgmDefaultCurves_[j]->move(dates_[i], z, y);
-                for (Size k = 0; k < ten_dfc_[j].size(); k++) {
-                    Date d = dates_[i] + ten_dfc_[j][k];
-                    Time T = dc.yearFraction(dates_[i], d);
-                    Real survProb = std::max(lgmDefaultCurves_[j]->survivalProbability(T), 0.00001);
-                    scenarios[i]->add(defaultCurveKeys_[j * ten_dfc_[j].size() + k], survProb);
-                }
-            } else if (model_->modelType(CrossAssetModel::AssetType::CR, j) == CrossAssetModel::ModelType::CIRPP) {
-                Real y = sample.value[model_->pIdx(CrossAssetModel::AssetType::CR, j, 0)][i + 1];
-                cirppDefaultCurves_[j]->move(dates_[i], y);
-                for (Size k = 0; k < ten_dfc_[j].size(); k++) {
-                    Date d = dates_[i] + ten_dfc_[j][k];
-                    Time T = dc.yearFraction(dates_[i], d);
-                    Real survProb = std::max(cirppDefaultCurves_[j]->survivalProbability(T), 0.00001);
-                    scenarios[i]->add(defaultCurveKeys_[j * ten_dfc_[j].size() + k], survProb);
-                }
-            }
+        // For YoY model implied term structure, JY and DK both need 3 state variables.
+        auto idx = std::get<0>(tup);
+        Array state(3);
+        state[0] = path[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 0)][i + 1];
+        state[1] = path[model_->pIdx(CrossAssetModel::AssetType::INF, idx, 1)][i + 1];
+        state[2] = ir_state[std::get<1>(tup)][0];
+
+        // Update the term structure's date and state.
+        auto ts = std::get<3>(tup);
+        ts->move(dates_[i], state);
+
+        // Create the YoY pillar dates from the tenors.
+        vector<Date> pillarDates(ten_yinf_[j].size());
+        for (Size k = 0; k < pillarDates.size(); ++k)
+            pillarDates[k] = dates_[i] + ten_yinf_[j][k];
+
+        // Use the YoY term structure's YoY rates to populate the scenarios.
+        auto yoyRates = ts->yoyRates(pillarDates);
+        for (Size k = 0; k < pillarDates.size(); ++k) {
+            scenario.add(yoyInflationKeys_[j * ten_yinf_[j].size() + k], yoyRates.at(pillarDates[k]));
         }
+    }
 
-        // Commodity curves
-        Array comState(1, 0.0); // FIXME: single-factor for now
-        for (Size j = 0; j < n_com_; j++) {
-            comState[0] = sample.value[model_->pIdx(CrossAssetModel::AssetType::COM, j)][i + 1];
-            comCurves_[j]->move(t, comState);
-            for (Size k = 0; k < ten_com_[j].size(); k++) {
-                Date d = dates_[i] + ten_com_[j][k];
+    // Credit curves
+    for (Size j = 0; j < n_cr_; ++j) {
+        if (model_->modelType(CrossAssetModel::AssetType::CR, j) == CrossAssetModel::ModelType::LGM1F) {
+            Real z = path[model_->pIdx(CrossAssetModel::AssetType::CR, j, 0)][i + 1];
+            Real y = path[model_->pIdx(CrossAssetModel::AssetType::CR, j, 1)][i + 1];
+            lgmDefaultCurves_[j]->move(dates_[i], z, y);
+            for (Size k = 0; k < ten_dfc_[j].size(); k++) {
+                Date d = dates_[i] + ten_dfc_[j][k];
                 Time T = dc.yearFraction(dates_[i], d);
-                Real price = std::max(comCurves_[j]->price(T), 0.00001);
-                scenarios[i]->add(commodityCurveKeys_[j * ten_com_[j].size() + k], price);
+                Real survProb = std::max(lgmDefaultCurves_[j]->survivalProbability(T), 0.00001);
+                scenario.add(defaultCurveKeys_[j * ten_dfc_[j].size() + k], survProb);
+            }
+        } else if (model_->modelType(CrossAssetModel::AssetType::CR, j) == CrossAssetModel::ModelType::CIRPP) {
+            Real y = path[model_->pIdx(CrossAssetModel::AssetType::CR, j, 0)][i + 1];
+            cirppDefaultCurves_[j]->move(dates_[i], y);
+            for (Size k = 0; k < ten_dfc_[j].size(); k++) {
+                Date d = dates_[i] + ten_dfc_[j][k];
+                Time T = dc.yearFraction(dates_[i], d);
+                Real survProb = std::max(cirppDefaultCurves_[j]->survivalProbability(T), 0.00001);
+                scenario.add(defaultCurveKeys_[j * ten_dfc_[j].size() + k], survProb);
             }
         }
+    }
 
-        // Credit States
-        for (Size k = 0; k < n_crstates_; ++k) {
-            Real z = sample.value[model_->pIdx(CrossAssetModel::AssetType::CrState, k)][i + 1];
-            scenarios[i]->add(crStateKeys_[k], z);
+    // Commodity curves
+    Array comState(1, 0.0); // FIXME: single-factor for now
+    for (Size j = 0; j < n_com_; j++) {
+        comState[0] = path[model_->pIdx(CrossAssetModel::AssetType::COM, j)][i + 1];
+        comCurves_[j]->move(t, comState);
+        for (Size k = 0; k < ten_com_[j].size(); k++) {
+            Date d = dates_[i] + ten_com_[j][k];
+            Time T = dc.yearFraction(dates_[i], d);
+            Real price = std::max(comCurves_[j]->price(T), 0.00001);
+            scenario.add(commodityCurveKeys_[j * ten_com_[j].size() + k], price);
         }
+    }
 
-        // Survival Weights, stochastic cumulative survival probability, Recovery Rates
-        for (Size k = 0; k < n_survivalweights_; ++k) {
-            string name = simMarketConfig_->additionalScenarioDataSurvivalWeights()[k];
-            Real rr = survivalWeightsDefaultCurves_[k]->recovery().empty()
-                          ? 0.0
-                          : survivalWeightsDefaultCurves_[k]->recovery()->value();
-            scenarios[i]->add(survivalWeightKeys_[k],
-                              survivalWeightsDefaultCurves_[k]->curve()->survivalProbability(dates_[i]));
-            scenarios[i]->add(recoveryRateKeys_[k], rr);
-        }
+    // Credit States
+    for (Size k = 0; k < n_crstates_; ++k) {
+        Real z = path[model_->pIdx(CrossAssetModel::AssetType::CrState, k)][i + 1];
+        scenario.add(crStateKeys_[k], z);
+    }
+
+    // Survival Weights, stochastic cumulative survival probability, Recovery Rates
+    for (Size k = 0; k < n_survivalweights_; ++k) {
+        string name = simMarketConfig_->additionalScenarioDataSurvivalWeights()[k];
+        Real rr = survivalWeightsDefaultCurves_[k]->recovery().empty()
+                      ? 0.0
+                      : survivalWeightsDefaultCurves_[k]->recovery()->value();
+        scenario.add(survivalWeightKeys_[k],
+                          survivalWeightsDefaultCurves_[k]->curve()->survivalProbability(dates_[i]));
+        scenario.add(recoveryRateKeys_[k], rr);
     }
-    return scenarios;
 }
 } // namespace analytics
 } // namespace ore
@@ -30,6 +30,7 @@
 #include <ored/marketdata/market.hpp>
 #include <ored/utilities/dategrid.hpp>
 
+#include <qle/math/randomvariable.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
 #include <qle/models/cirppimplieddefaulttermstructure.hpp>
 #include <qle/models/crossassetmodel.hpp>
@@ -40,6 +41,7 @@
 #include <qle/models/jyimpliedyoyinflationtermstructure.hpp>
 #include <qle/models/jyimpliedzeroinflationtermstructure.hpp>
 #include <qle/models/lgmimplieddefaulttermstructure.hpp>
+#include <qle/models/lgmvectorised.hpp>
 #include <qle/models/modelimpliedyieldtermstructure.hpp>
 #include <qle/models/modelimpliedpricetermstructure.hpp>
 
@@ -60,6 +62,12 @@ using namespace QuantExt;
   - a simulation date grid that starts in the future, i.e. does not include today's date
   - the associated time grid including t=0
 
+  If batchSize > 1 and all ir models are LGM1F, paths are drawn in batches of the given size. The discount, index
+  and yield curve values, which usually make up the bulk of a scenario, are then computed with the vectorised LGM
+  formulas across the paths of a batch, all other values are computed path by path as before. nextPath() returns the
+  paths of the current batch one by one. Note that the path generator is advanced by whole batches, i.e. up to
+  batchSize - 1 paths are generated without being used if the number of samples is not a multiple of the batch size.
+
   \ingroup scenario
  */
 class CrossAssetModelScenarioGenerator : public ScenarioPathGenerator {
@@ -71,13 +79,29 @@ public:
                                      QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> simMarketConfig,
                                      QuantLib::Date today, QuantLib::ext::shared_ptr<DateGrid> grid,
                                      QuantLib::ext::shared_ptr<ore::data::Market> initMarket,
-                                     const std::string& configuration = Market::defaultConfiguration);
+                                     const std::string& configuration = Market::defaultConfiguration,
+                                     const Size batchSize = 0);
     //! Default destructor
     ~CrossAssetModelScenarioGenerator(){};
     std::vector<QuantLib::ext::shared_ptr<Scenario>> nextPath() override;
-    void reset() override { pathGenerator_->reset(); }
+    void reset() override {
+        pathGenerator_->reset();
+        batch_.clear();
+        batchPos_ = 0;
+    }
+    //! uses MultiPathGeneratorBase::skipTo(), the paths of the skipped samples are not generated
+    bool skipTo(const Size sample) override {
+        pathGenerator_->skipTo(sample);
+        batch_.clear();
+        batchPos_ = 0;
+        return true;
+    }
 
 private:
+    void addNonCurveValues(const Size i, const MultiPath& path, const std::vector<Array>& ir_state,
+                           Scenario& scenario);
+    void generateBatch();
+
     QuantLib::ext::shared_ptr<QuantExt::CrossAssetModel> model_;
     QuantLib::ext::shared_ptr<QuantExt::MultiPathGeneratorBase> pathGenerator_;
     QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory_;
@@ -107,6 +131,15 @@ private:
     vector<QuantLib::ext::shared_ptr<QuantExt::LgmImpliedDefaultTermStructure>> lgmDefaultCurves_;
     vector<QuantLib::ext::shared_ptr<QuantExt::CirppImpliedDefaultTermStructure>> cirppDefaultCurves_;
     vector<QuantLib::ext::shared_ptr<QuantExt::CreditCurve>> survivalWeightsDefaultCurves_;
+
+    // batch mode
+    Size batchSize_;
+    bool vectorised_ = false;
+    std::vector<QuantExt::LgmVectorised> lgmVectorised_;
+    std::vector<Handle<YieldTermStructure>> fwdCurveTargets_, yieldCurveTargets_;
+    std::vector<Size> indexCcyIdx_, yieldCurveCcyIdx_;
+    std::vector<std::vector<QuantLib::ext::shared_ptr<Scenario>>> batch_;
+    Size batchPos_ = 0;
 };
 
 } // namespace analytics
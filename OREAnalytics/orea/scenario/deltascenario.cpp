@@ -36,8 +36,22 @@ DeltaScenario::DeltaScenario(const QuantLib::ext::shared_ptr<ore::analytics::Sce
 
 void DeltaScenario::add(const ore::analytics::RiskFactorKey& key, Real value) {
     QL_REQUIRE(baseScenario_->has(key), "base scenario must also possess key");
-    if (baseScenario_->get(key) != value)
+    if (baseScenario_->get(key) != value) {
         delta_->add(key, value);
+        resolved_ = false;
+        resolvedDelta_.clear();
+    }
+}
+
+void DeltaScenario::resolveDelta(const std::map<RiskFactorKey, Size>& baseKeyIndex) {
+    resolvedDelta_.clear();
+    resolvedDelta_.reserve(delta_->keys().size());
+    for (auto const& key : delta_->keys()) {
+        auto it = baseKeyIndex.find(key);
+        QL_REQUIRE(it != baseKeyIndex.end(), "DeltaScenario::resolveDelta(): key " << key << " not found in base keys");
+        resolvedDelta_.push_back(std::make_pair(it->second, delta_->get(key)));
+    }
+    resolved_ = true;
 }
 
 Real DeltaScenario::get(const ore::analytics::RiskFactorKey& key) const {
@@ -51,7 +65,10 @@ Real DeltaScenario::get(const ore::analytics::RiskFactorKey& key) const {
 QuantLib::ext::shared_ptr<ore::analytics::Scenario> DeltaScenario::clone() const {
     // NOTE - we are not cloning the base here (is this appropriate?)
     QuantLib::ext::shared_ptr<Scenario> newDelta = delta_->clone();
-    return QuantLib::ext::make_shared<DeltaScenario>(baseScenario_, newDelta);
+    auto result = QuantLib::ext::make_shared<DeltaScenario>(baseScenario_, newDelta);
+    result->resolved_ = resolved_;
+    result->resolvedDelta_ = resolvedDelta_;
+    return result;
 }
 
 Real DeltaScenario::getNumeraire() const {
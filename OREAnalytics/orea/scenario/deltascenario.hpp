@@ -25,6 +25,9 @@
 
 #include <orea/scenario/scenario.hpp>
 
+#include <map>
+#include <vector>
+
 namespace ore {
 namespace analytics {
 using namespace QuantLib;
@@ -36,6 +39,9 @@ using namespace QuantLib;
   This is intended as an efficient storage mechanism for e.g. sensitivity scenarios,
   where many scenario instances are managed in memory but the actual differences are minor.
 
+  The delta keys can optionally be resolved to their positions in the base scenario's keys(), see resolveDelta().
+  This allows consumers like the ScenarioSimMarket to apply the scenario without any key lookups.
+
   \ingroup scenario
 */
 class DeltaScenario : public virtual ore::analytics::Scenario {
@@ -79,6 +85,14 @@ public:
     //! Get delta
     QuantLib::ext::shared_ptr<Scenario> delta() const { return delta_; }
 
+    /*! Resolve the delta keys to their positions in base()->keys(), \p baseKeyIndex maps the base keys to their
+        positions. The resolution is invalidated by add(), changes made directly to delta() are not detected. */
+    void resolveDelta(const std::map<RiskFactorKey, Size>& baseKeyIndex);
+    //! Is the resolved delta available
+    bool isResolved() const { return resolved_; }
+    //! The delta values together with the positions of their keys in base()->keys(), only valid if isResolved()
+    const std::vector<std::pair<Size, Real>>& resolvedDelta() const { return resolvedDelta_; }
+
     QuantLib::ext::shared_ptr<Scenario> clone() const override;
 
     bool isCloseEnough(const QuantLib::ext::shared_ptr<Scenario>& s) const override;
@@ -86,6 +100,8 @@ public:
 protected:
     QuantLib::ext::shared_ptr<Scenario> baseScenario_;
     QuantLib::ext::shared_ptr<Scenario> delta_;
+    bool resolved_ = false;
+    std::vector<std::pair<Size, Real>> resolvedDelta_;
 };
 
 } // namespace sensitivity
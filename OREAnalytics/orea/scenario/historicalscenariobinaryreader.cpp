@@ -0,0 +1,191 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/scenario/historicalscenariobinaryreader.hpp>
+
+#include <ored/utilities/csvfilereader.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/parsers.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/timer/timer.hpp>
+
+#include <exception>
+#include <map>
+#include <set>
+#include <thread>
+
+using namespace QuantLib;
+
+namespace ore {
+namespace analytics {
+
+HistoricalScenarioBinaryReader::HistoricalScenarioBinaryReader(const std::string& fileName, const Size nThreads)
+    : file_(fileName), nThreads_(std::max<Size>(nThreads, 1)) {
+    load(nullptr, nullptr);
+}
+
+void HistoricalScenarioBinaryReader::load(
+    const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& simParams,
+    const QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>&) {
+
+    boost::timer::cpu_timer timer;
+
+    // keys of types the simulation market configures by name are restricted to these names
+    const auto& fileKeys = file_.sharedData()->keys;
+    std::map<RiskFactorKey::KeyType, std::set<std::string>> names;
+    if (simParams) {
+        for (auto const& k : fileKeys) {
+            if (names.find(k.keytype) == names.end()) {
+                auto n = simParams->paramsLookup(k.keytype);
+                names[k.keytype] = std::set<std::string>(n.begin(), n.end());
+            }
+        }
+    }
+
+    sharedData_ = QuantLib::ext::make_shared<SimpleScenario::SharedData>();
+    columns_.clear();
+    for (Size k = 0; k < fileKeys.size(); ++k) {
+        if (auto n = names.find(fileKeys[k].keytype);
+            n != names.end() && !n->second.empty() && n->second.count(fileKeys[k].name) == 0)
+            continue;
+        sharedData_->keyIndex[fileKeys[k]] = columns_.size();
+        sharedData_->keys.push_back(fileKeys[k]);
+        boost::hash_combine(sharedData_->keysHash, fileKeys[k]);
+        columns_.push_back(k);
+        if (auto c = file_.sharedData()->coordinates.find(std::make_pair(fileKeys[k].keytype, fileKeys[k].name));
+            c != file_.sharedData()->coordinates.end())
+            sharedData_->coordinates.insert(*c);
+    }
+
+    scenarios_.clear();
+    current_ = 0;
+    started_ = false;
+
+    // build all scenarios upfront on several threads, each worker building every nWorkers-th scenario
+    const Size nWorkers = std::min(nThreads_, size());
+    if (nWorkers > 1) {
+        scenarios_.resize(size());
+        std::vector<std::exception_ptr> errors(nWorkers);
+        std::vector<std::thread> workers;
+        for (Size w = 0; w < nWorkers; ++w) {
+            workers.emplace_back([this, w, nWorkers, &errors]() {
+                try {
+                    for (Size i = w; i < scenarios_.size(); i += nWorkers)
+                        scenarios_[i] = buildScenario(i);
+                } catch (...) {
+                    errors[w] = std::current_exception();
+                }
+            });
+        }
+        for (auto& t : workers)
+            t.join();
+        for (const auto& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+    }
+
+    LOG("HistoricalScenarioBinaryReader: using " << sharedData_->keys.size() << " of " << fileKeys.size()
+                                                 << " keys for " << size() << " scenarios, " << scenarios_.size()
+                                                 << " scenarios built upfront in " << timer.format(2, "%w") << " s");
+}
+
+bool HistoricalScenarioBinaryReader::next() {
+    if (started_ && current_ < size())
+        ++current_;
+    started_ = true;
+    return current_ < size();
+}
+
+Date HistoricalScenarioBinaryReader::date() const {
+    return started_ && current_ < size() ? file_.asof(current_) : Null<Date>();
+}
+
+QuantLib::ext::shared_ptr<Scenario> HistoricalScenarioBinaryReader::scenario() const {
+    if (!started_ || current_ >= size())
+        return nullptr;
+    return scenarios_.empty() ? buildScenario(current_) : scenarios_[current_];
+}
+
+QuantLib::ext::shared_ptr<Scenario> HistoricalScenarioBinaryReader::buildScenario(const Size i) const {
+    TLOG("Creating scenario for date " << io::iso_date(file_.asof(i)));
+    std::vector<Real> values(columns_.size());
+    bool complete = true;
+    for (Size k = 0; k < columns_.size(); ++k) {
+        values[k] = file_.value(i, columns_[k]);
+        complete = complete && values[k] != Null<Real>();
+    }
+    // scenarios with missing values get their own keys, so that has() is false for the missing keys
+    if (complete) {
+        auto s = QuantLib::ext::make_shared<SimpleScenario>(file_.asof(i), std::string(), file_.numeraire(i),
+                                                            sharedData_);
+        s->setAbsolute(file_.isAbsolute());
+        s->setData(std::move(values));
+        return s;
+    }
+    auto s = QuantLib::ext::make_shared<SimpleScenario>(file_.asof(i), std::string(), file_.numeraire(i));
+    s->setAbsolute(file_.isAbsolute());
+    for (Size k = 0; k < columns_.size(); ++k) {
+        if (values[k] != Null<Real>())
+            s->add(sharedData_->keys[k], values[k]);
+    }
+    return s;
+}
+
+void convertHistoricalScenarioFile(const std::string& csvFileName, const std::string& binaryFileName) {
+    ore::data::CSVFileReader file(csvFileName, true);
+    QL_REQUIRE(file.fields().size() >= 4, "Need at least 4 columns in the file " << csvFileName);
+    QL_REQUIRE(file.fields()[0] == "Date", "First column must be 'Date' in the file " << csvFileName);
+    QL_REQUIRE(file.fields()[1] == "Scenario", "Second column should be 'Scenario' in the file " << csvFileName);
+    QL_REQUIRE(file.fields()[2] == "Numeraire", "Third column should be 'Numeraire' in the file " << csvFileName);
+
+    auto sharedData = QuantLib::ext::make_shared<SimpleScenario::SharedData>();
+    for (Size k = 3; k < file.fields().size(); ++k) {
+        RiskFactorKey key = parseRiskFactorKey(file.fields()[k]);
+        QL_REQUIRE(sharedData->keyIndex.emplace(key, k - 3).second,
+                   "convertHistoricalScenarioFile(): duplicate key " << key << " in " << csvFileName);
+        sharedData->keys.push_back(key);
+        boost::hash_combine(sharedData->keysHash, key);
+    }
+
+    BinaryScenarioWriter writer(binaryFileName);
+    Size n = 0;
+    while (file.next()) {
+        SimpleScenario s(ore::data::parseDate(file.get(0)), std::string(), ore::data::parseReal(file.get(2)),
+                         sharedData);
+        std::vector<Real> values(sharedData->keys.size(), Null<Real>());
+        for (Size k = 0; k < values.size(); ++k) {
+            Real value;
+            if (ore::data::tryParseReal(file.get(k + 3), value))
+                values[k] = value;
+        }
+        s.setData(std::move(values));
+        writer.writeScenario(s);
+        ++n;
+    }
+    file.close();
+    writer.close();
+    QL_REQUIRE(n > 0, "convertHistoricalScenarioFile(): no scenarios in " << csvFileName);
+    LOG("convertHistoricalScenarioFile(): wrote " << n << " scenarios with " << sharedData->keys.size()
+                                                  << " keys from " << csvFileName << " to " << binaryFileName);
+}
+
+} // namespace analytics
+} // namespace ore
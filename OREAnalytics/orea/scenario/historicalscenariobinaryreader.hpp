@@ -0,0 +1,85 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/scenario/historicalscenariobinaryreader.hpp
+    \brief Class for reading historical scenarios from a binary scenario file
+    \ingroup scenario
+*/
+
+#pragma once
+
+#include <orea/scenario/binaryscenariofile.hpp>
+#include <orea/scenario/historicalscenarioreader.hpp>
+
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+//! Class for reading historical scenarios from a binary scenario file
+/*! The file is written by the BinaryScenarioWriter, e.g. converted from a csv file read by the
+    HistoricalScenarioFileReader using convertHistoricalScenarioFile(). It is memory mapped, the dates are read
+    without decoding the scenarios and only the scenarios requested via scenario() are built.
+
+    load() restricts the scenarios to the risk factors of the simulation market parameters: keys whose type is
+    configured in the parameters, but whose name is not, are skipped. If more than one thread is given, load() also
+    builds all scenarios of the file in parallel upfront. Each call to load() resets the reader to the first scenario.
+
+    Missing values are stored as Null<Real>() in the file and are not added to the scenario, as for the csv reader.
+
+    \ingroup scenario
+*/
+class HistoricalScenarioBinaryReader : public HistoricalScenarioReader {
+public:
+    explicit HistoricalScenarioBinaryReader(const std::string& fileName, const QuantLib::Size nThreads = 1);
+
+    //! Return true if there is another Scenario to read and move to it
+    bool next() override;
+    //! Return the current scenario's date if reader is still valid and `Null<Date>()` otherwise
+    QuantLib::Date date() const override;
+    //! Return the current scenario if reader is still valid and `nullptr` otherwise
+    QuantLib::ext::shared_ptr<Scenario> scenario() const override;
+    //! Filter the keys to the simulation market and reset the reader
+    void load(const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& simParams,
+              const QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters>& marketParams) override;
+
+    //! Number of scenarios in the file
+    QuantLib::Size size() const { return file_.size(); }
+    //! The keys of the scenarios returned by the reader
+    const std::vector<RiskFactorKey>& keys() const { return sharedData_->keys; }
+
+private:
+    QuantLib::ext::shared_ptr<Scenario> buildScenario(const QuantLib::Size i) const;
+
+    BinaryScenarioGenerator file_;
+    QuantLib::Size nThreads_;
+    // the positions of the returned keys in the file header
+    std::vector<QuantLib::Size> columns_;
+    QuantLib::ext::shared_ptr<SimpleScenario::SharedData> sharedData_;
+    // scenarios built by load(), if built upfront
+    std::vector<QuantLib::ext::shared_ptr<Scenario>> scenarios_;
+    QuantLib::Size current_ = 0;
+    bool started_ = false;
+};
+
+//! Convert a historical scenario csv file in the format read by the HistoricalScenarioFileReader to a binary file
+void convertHistoricalScenarioFile(const std::string& csvFileName, const std::string& binaryFileName);
+
+} // namespace analytics
+} // namespace ore
@@ -26,6 +26,8 @@
 
 #include <boost/algorithm/string/find.hpp>
 
+#include <set>
+
 using namespace QuantLib;
 
 namespace ore {
@@ -103,10 +105,16 @@ Real ReturnConfiguration::applyReturn(const RiskFactorKey& key, const Real baseV
     // Checks
     check(key);
 
+    return applyReturn(key, returnType_.at(key.keytype), baseValue, returnValue);
+}
+
+Real ReturnConfiguration::applyReturn(const RiskFactorKey& key, const ReturnType returnType, const Real baseValue,
+                                      const Real returnValue) {
+
     // Apply the return to the base value to generate the return value
     auto keyType = key.keytype;
     Real value;
-    switch (returnType_.at(keyType)) {
+    switch (returnType) {
     case ReturnConfiguration::ReturnType::Absolute:
         value = baseValue + returnValue;
         break;
@@ -250,10 +258,136 @@ Real HistoricalScenarioGenerator::adjustedPrice(RiskFactorKey key, Date d, Real
     return price;
 }
 
+void HistoricalScenarioGenerator::useReturnMatrix(const bool b) {
+    if (!b)
+        returnMatrix_ = nullptr;
+    else if (returnMatrix_ == nullptr)
+        returnMatrix_ = QuantLib::ext::make_shared<ReturnMatrix>();
+}
+
+void HistoricalScenarioGenerator::buildReturnMatrix() {
+    QL_REQUIRE(returnMatrix_, "HistoricalScenarioGenerator::buildReturnMatrix(): return matrix not enabled");
+    ReturnMatrix& m = *returnMatrix_;
+    m = ReturnMatrix();
+
+    const vector<RiskFactorKey>& keys = baseScenario_->keys();
+    const Size nKeys = keys.size();
+    const Size nScen = numScenarios();
+    LOG("HistoricalScenarioGenerator: build return matrix for " << nScen << " scenarios and " << nKeys << " keys");
+
+    // return type per key, this also performs the checks done in ReturnConfiguration::returnValue()
+    auto returnTypes = returnConfiguration_.returnTypes();
+    m.returnTypes.reserve(nKeys);
+    for (auto const& key : keys) {
+        QL_REQUIRE(key.keytype != RiskFactorKey::KeyType::None, "unsupported key type none for key " << key);
+        auto t = returnTypes.find(key.keytype);
+        QL_REQUIRE(t != returnTypes.end(),
+                   "ReturnConfiguration: key type " << key.keytype << " for key " << key << " not found");
+        m.returnTypes.push_back(t->second);
+    }
+
+    // adjusted historical values for all relevant dates
+    std::set<Date> dates(startDates_.begin(), startDates_.end());
+    dates.insert(endDates_.begin(), endDates_.end());
+    m.dates.assign(dates.begin(), dates.end());
+    m.values.resize(m.dates.size() * nKeys);
+    for (Size j = 0; j < m.dates.size(); ++j) {
+        QuantLib::ext::shared_ptr<Scenario> s = historicalScenarioLoader_->getHistoricalScenario(m.dates[j]);
+        for (Size k = 0; k < nKeys; ++k) {
+            m.values[j * nKeys + k] =
+                s->has(keys[k]) ? adjustedPrice(keys[k], m.dates[j], s->get(keys[k])) : Null<Real>();
+        }
+    }
+
+    // unscaled returns for all scenarios
+    m.startIndex.resize(nScen);
+    m.endIndex.resize(nScen);
+    m.returns.resize(nScen * nKeys);
+    for (Size i = 0; i < nScen; ++i) {
+        m.startIndex[i] = std::distance(m.dates.begin(), std::lower_bound(m.dates.begin(), m.dates.end(), startDates_[i]));
+        m.endIndex[i] = std::distance(m.dates.begin(), std::lower_bound(m.dates.begin(), m.dates.end(), endDates_[i]));
+        const Real* v1 = &m.values[m.startIndex[i] * nKeys];
+        const Real* v2 = &m.values[m.endIndex[i] * nKeys];
+        Real* r = &m.returns[i * nKeys];
+        for (Size k = 0; k < nKeys; ++k) {
+            if (v1[k] == Null<Real>() || v2[k] == Null<Real>()) {
+                DLOG("Missing key in historical scenario (" << io::iso_date(startDates_[i]) << ","
+                                                            << io::iso_date(endDates_[i]) << "): " << keys[k]
+                                                            << " => no move in this factor");
+                r[k] = returnConfiguration_.returnValue(keys[k], 1.0, 1.0, startDates_[i], endDates_[i]);
+            } else {
+                r[k] = returnConfiguration_.returnValue(keys[k], v1[k], v2[k], startDates_[i], endDates_[i]);
+            }
+        }
+    }
+
+    // set the keys last, so that an exception above leaves the matrix in the not built state
+    m.keys = keys;
+    LOG("HistoricalScenarioGenerator: return matrix built");
+}
+
+QuantLib::ext::shared_ptr<Scenario> HistoricalScenarioGenerator::nextFromReturnMatrix(const Date& d) {
+
+    QL_REQUIRE(i_ < numScenarios(),
+               "Cannot generate any more scenarios (i=" << i_ << " numScenarios=" << numScenarios() << ")");
+
+    const vector<RiskFactorKey>& keys = baseScenario_->keys();
+    if (returnMatrix_->keys != keys)
+        buildReturnMatrix();
+    const ReturnMatrix& m = *returnMatrix_;
+    const Size nKeys = keys.size();
+
+    QL_REQUIRE(d >= baseScenario_->asof(), "Cannot generate a scenario in the past");
+    QuantLib::ext::shared_ptr<Scenario> scen = scenarioFactory_->buildScenario(d, true, std::string(), 1.0);
+
+    const Date& d1 = m.dates[m.startIndex[i_]];
+    const Date& d2 = m.dates[m.endIndex[i_]];
+    const Real* v1 = &m.values[m.startIndex[i_] * nKeys];
+    const Real* v2 = &m.values[m.endIndex[i_] * nKeys];
+    const Real* r = &m.returns[i_ * nKeys];
+
+    calculationDetails_.resize(nKeys);
+    for (Size k = 0; k < nKeys; ++k) {
+        const RiskFactorKey& key = keys[k];
+        Real base = baseScenario_->get(key);
+        bool missing = v1[k] == Null<Real>() || v2[k] == Null<Real>();
+        Real returnVal = r[k];
+        Real scaling = this->scaling(key, returnVal);
+        returnVal = returnVal * scaling;
+        Real value = ReturnConfiguration::applyReturn(key, m.returnTypes[k], base, returnVal);
+        if (std::isinf(value)) {
+            ALOG("Value is inf for " << key << " from date " << d1 << " to " << d2);
+        }
+        scen->add(key, value);
+        auto& cd = calculationDetails_[k];
+        cd.scenarioDate1 = d1;
+        cd.scenarioDate2 = d2;
+        cd.key = key;
+        cd.baseValue = base;
+        cd.adjustmentFactor1 = adjFactors_ ? adjFactors_->getFactor(key.name, d1) : 1.0;
+        cd.adjustmentFactor2 = adjFactors_ ? adjFactors_->getFactor(key.name, d2) : 1.0;
+        cd.scenarioValue1 = missing ? 1.0 : v1[k];
+        cd.scenarioValue2 = missing ? 1.0 : v2[k];
+        cd.returnType = m.returnTypes[k];
+        cd.scaling = scaling;
+        cd.returnValue = returnVal;
+        cd.scenarioValue = value;
+    }
+
+    scen->label(labelPrefix_ + ore::data::to_string(io::iso_date(d1)) + "_" +
+                ore::data::to_string(io::iso_date(d2)));
+
+    ++i_;
+    return scen;
+}
+
 QuantLib::ext::shared_ptr<Scenario> HistoricalScenarioGenerator::next(const Date& d) {
 
     QL_REQUIRE(baseScenario_ != nullptr, "HistoricalScenarioGenerator: base scenario not set");
 
+    if (returnMatrix_)
+        return nextFromReturnMatrix(d);
+
     std::pair<QuantLib::ext::shared_ptr<Scenario>, QuantLib::ext::shared_ptr<Scenario>> scens = scenarioPair();
     QuantLib::ext::shared_ptr<Scenario> s1 = scens.first;
     QuantLib::ext::shared_ptr<Scenario> s2 = scens.second;
@@ -59,6 +59,10 @@ public:
     QuantLib::Real applyReturn(const RiskFactorKey& key, const QuantLib::Real baseValue,
         const QuantLib::Real returnValue) const;
 
+    //! apply return to base value for a given return type, the key is not checked against the configuration
+    static QuantLib::Real applyReturn(const RiskFactorKey& key, const ReturnType returnType,
+                                      const QuantLib::Real baseValue, const QuantLib::Real returnValue);
+
     //! get return types
     const std::map<RiskFactorKey::KeyType, ReturnType> returnTypes() const;
 
@@ -193,6 +197,14 @@ public:
     //! Get the scenario label prefix
     const std::string& labelPrefix() const { return labelPrefix_; }
 
+    /*! If enabled, the adjusted historical values and the returns for all scenarios are computed once on the first
+        call to next() and scenarios are then generated from this dense (scenario x risk factor) matrix. Copies of the
+        generator share the matrix. This requires memory for (number of historical dates + number of scenarios) x
+        number of risk factors doubles. The matrix is rebuilt if the keys of the base scenario change. */
+    void useReturnMatrix(const bool b);
+    //! Is the return matrix used
+    bool useReturnMatrix() const { return returnMatrix_ != nullptr; }
+
 protected:
     // to be managed in derived classes, if next is overwritten
     Size i_;
@@ -215,6 +227,24 @@ protected:
     // details on the last generated scenario
     std::vector<HistoricalScenarioCalculationDetails> calculationDetails_;
 
+    //! Dense historical values and returns
+    struct ReturnMatrix {
+        //! keys of the base scenario the matrix was built for (empty if not built yet)
+        std::vector<RiskFactorKey> keys;
+        std::vector<ReturnConfiguration::ReturnType> returnTypes;
+        //! the union of start and end dates, sorted
+        std::vector<QuantLib::Date> dates;
+        //! indices of startDates_[i], endDates_[i] in dates
+        std::vector<QuantLib::Size> startIndex, endIndex;
+        //! adjusted historical values, dates x keys, Null<Real>() if the key is missing in a historical scenario
+        std::vector<QuantLib::Real> values;
+        //! unscaled returns, scenarios x keys
+        std::vector<QuantLib::Real> returns;
+    };
+    QuantLib::ext::shared_ptr<ReturnMatrix> returnMatrix_;
+    void buildReturnMatrix();
+    QuantLib::ext::shared_ptr<Scenario> nextFromReturnMatrix(const QuantLib::Date& d);
+
 protected:
     QuantLib::Calendar cal_;
     QuantLib::Size mporDays_ = 10;
@@ -272,6 +302,7 @@ public:
                                       hsg->labelPrefix()),
           simMarket_(simMarket), simMarketConfig_(simMarketConfig) {
         baseScenario_ = hsg->baseScenario();
+        useReturnMatrix(hsg->useReturnMatrix());
     }
 
     QuantLib::ext::shared_ptr<Scenario> next(const QuantLib::Date& d) override;
@@ -89,5 +89,22 @@ private:
     std::vector<ScenarioFilter> filters_;
 };
 
+//! Filter excluding the given risk factors (key type and name) from the keys allowed by another filter
+class ExcludedRiskFactorScenarioFilter : public ScenarioFilter {
+public:
+    ExcludedRiskFactorScenarioFilter(const QuantLib::ext::shared_ptr<ScenarioFilter>& filter,
+                                     const std::set<std::pair<RiskFactorKey::KeyType, std::string>>& excluded)
+        : filter_(filter), excluded_(excluded) {}
+
+    bool allow(const RiskFactorKey& key) const override {
+        return excluded_.find(std::make_pair(key.keytype, key.name)) == excluded_.end() &&
+               (filter_ == nullptr || filter_->allow(key));
+    }
+
+private:
+    QuantLib::ext::shared_ptr<ScenarioFilter> filter_;
+    std::set<std::pair<RiskFactorKey::KeyType, std::string>> excluded_;
+};
+
 } // namespace analytics
 } // namespace oreplus
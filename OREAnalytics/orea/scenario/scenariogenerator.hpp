@@ -50,6 +50,9 @@ public:
     //! Reset the generator so calls to next() return the first scenario.
     /*! This allows re-generation of scenarios if required. */
     virtual void reset() = 0;
+    //! Position the generator so that the next path is the path with the given index (counting from 0)
+    /*! Returns false if the generator does not support skip-ahead, the generator is not modified in this case. */
+    virtual bool skipTo(const Size sample) { return false; }
 };
 
 //! Scenario generator that generates an entire path
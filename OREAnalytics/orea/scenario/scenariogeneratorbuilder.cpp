@@ -59,7 +59,8 @@ ScenarioGeneratorBuilder::build(QuantLib::ext::shared_ptr<QuantExt::CrossAssetMo
                              data_->ordering(), data_->directionIntegers());
 
     return QuantLib::ext::make_shared<CrossAssetModelScenarioGenerator>(model, pathGen, scenarioFactory, marketConfig, asof,
-                                                                data_->getGrid(), initMarket, configuration);
+                                                                data_->getGrid(), initMarket, configuration,
+                                                                data_->pathBatchSize());
 }
 } // namespace analytics
 } // namespace ore
@@ -110,6 +110,12 @@ void ScenarioGeneratorData::fromXML(XMLNode* root) {
     else
         directionIntegers_ = SobolRsg::JoeKuoD7;
 
+    pathBatchSize_ = 0;
+    if (auto n = XMLUtils::getChildNode(node, "PathBatchSize")) {
+        pathBatchSize_ = parseInteger(XMLUtils::getNodeValue(n));
+        LOG("ScenarioGeneratorData path batch size = " << pathBatchSize_);
+    }
+
     withCloseOutLag_ = false;
     if (XMLUtils::getChildNode(node, "CloseOutLag") != NULL) {
         withCloseOutLag_ = true;
@@ -155,6 +161,9 @@ XMLNode* ScenarioGeneratorData::toXML(XMLDocument& doc) const {
     XMLUtils::addChild(doc, pNode, "Ordering", ore::data::to_string((SobolBrownianGenerator::Ordering) ordering_) );
     XMLUtils::addChild(doc, pNode, "DirectionIntegers", ore::data::to_string(directionIntegers_));
 
+    if (pathBatchSize_ > 0)
+        XMLUtils::addChild(doc, pNode, "PathBatchSize", to_string(pathBatchSize_));
+
     if (withCloseOutLag_) {
         XMLUtils::addChild(doc, pNode, "CloseOutLag", closeOutLag_);
     }
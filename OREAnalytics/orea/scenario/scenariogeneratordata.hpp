@@ -54,7 +54,7 @@ public:
     ScenarioGeneratorData()
         : grid_(QuantLib::ext::make_shared<DateGrid>()), sequenceType_(SobolBrownianBridge), seed_(0), samples_(0),
           ordering_(SobolBrownianGenerator::Steps), directionIntegers_(SobolRsg::JoeKuoD7), withCloseOutLag_(false),
-          withMporStickyDate_(false) {}
+          withMporStickyDate_(false), pathBatchSize_(0) {}
 
     //! Constructor
     ScenarioGeneratorData(QuantLib::ext::shared_ptr<DateGrid> dateGrid, SequenceType sequenceType, long seed, Size samples,
@@ -62,7 +62,8 @@ public:
                           SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7,
                           bool withCloseOutLag = false, bool withMporStickyDate = false)
         : sequenceType_(sequenceType), seed_(seed), samples_(samples), ordering_(ordering),
-          directionIntegers_(directionIntegers), withCloseOutLag_(false), withMporStickyDate_(false) {
+          directionIntegers_(directionIntegers), withCloseOutLag_(false), withMporStickyDate_(false),
+          pathBatchSize_(0) {
         setGrid(dateGrid);
     }
 
@@ -86,6 +87,7 @@ public:
     bool withCloseOutLag() const { return withCloseOutLag_; }
     bool withMporStickyDate() const { return withMporStickyDate_; }
     Period closeOutLag() const { return closeOutLag_; }
+    Size pathBatchSize() const { return pathBatchSize_; }
     //@}
 
     //! \name Setters
@@ -99,6 +101,7 @@ public:
     bool& withCloseOutLag() { return withCloseOutLag_; }
     bool& withMporStickyDate() { return withMporStickyDate_; }
     Period& closeOutLag() { return closeOutLag_; }
+    Size& pathBatchSize() { return pathBatchSize_; }
     //@}
 private:
     QuantLib::ext::shared_ptr<DateGrid> grid_;
@@ -111,6 +114,7 @@ private:
     bool withCloseOutLag_;
     bool withMporStickyDate_;
     Period closeOutLag_;
+    Size pathBatchSize_;
     MporCashFlowMode mporCashFlowMode_;
     string gridString_;
 };
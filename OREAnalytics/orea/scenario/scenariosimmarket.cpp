@@ -33,6 +33,7 @@
 #include <ored/utilities/indexparser.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/parsers.hpp>
+#include <ored/utilities/timers.hpp>
 #include <ored/utilities/to_string.hpp>
 
 #include <qle/indexes/fallbackiborindex.hpp>
@@ -57,6 +58,7 @@
 #include <qle/termstructures/interpolatedcpivolatilitysurface.hpp>
 #include <qle/termstructures/interpolateddiscountcurve.hpp>
 #include <qle/termstructures/interpolateddiscountcurve2.hpp>
+#include <qle/termstructures/parametricvolatilitysmilesection.hpp>
 #include <qle/termstructures/pricecurve.hpp>
 #include <qle/termstructures/pricetermstructureadapter.hpp>
 #include <qle/termstructures/proxyoptionletvolatility.hpp>
@@ -75,6 +77,7 @@
 #include <qle/termstructures/strippedoptionletadapter.hpp>
 #include <qle/termstructures/strippedyoyinflationoptionletvol.hpp>
 #include <qle/termstructures/survivalprobabilitycurve.hpp>
+#include <qle/termstructures/swaptionsabrcube.hpp>
 #include <qle/termstructures/swaptionvolatilityconverter.hpp>
 #include <qle/termstructures/swaptionvolconstantspread.hpp>
 #include <qle/termstructures/swaptionvolcube2.hpp>
@@ -765,6 +768,26 @@ ScenarioSimMarket::ScenarioSimMarket(
                                                                             *shortSwapIndex, Normal);
                             }
 
+                            /* parametric (e.g. sabr) smiles are evaluated for all strikes of a smile at once, this
+                               populates the strike cache of the smile sections used by the volatility calls below */
+                            if (!convertToNormal && !simulateAtmOnly &&
+                                QuantLib::ext::dynamic_pointer_cast<SwaptionSabrCube>(cube)) {
+                                for (Size i = 0; i < optionTenors.size(); ++i) {
+                                    for (Size j = 0; j < underlyingTenors.size(); ++j) {
+                                        auto section = QuantLib::ext::dynamic_pointer_cast<
+                                            ParametricVolatilitySmileSection>(
+                                            wrapper->smileSection(optionTenors[i], underlyingTenors[j], true));
+                                        if (!section)
+                                            continue;
+                                        Real atm = cube->atmStrike(optionTenors[i], underlyingTenors[j]);
+                                        std::vector<Real> strikes;
+                                        for (auto const& s : strikeSpreads)
+                                            strikes.push_back(atm + s);
+                                        section->volatilities(strikes);
+                                    }
+                                }
+                            }
+
                             for (Size k = 0; k < strikeSpreads.size(); ++k) {
                                 for (Size i = 0; i < optionTenors.size(); ++i) {
                                     for (Size j = 0; j < underlyingTenors.size(); ++j) {
@@ -2954,16 +2977,19 @@ void ScenarioSimMarket::reset() {
     filter_ = QuantLib::ext::make_shared<ScenarioFilter>();
     // reset eval date
     Settings::instance().evaluationDate() = baseScenario_->asof();
+    marketChanged_ = true;
     // reset numeraire and label
     numeraire_ = baseScenario_->getNumeraire();
     label_ = baseScenario_->label();
     // delete the sim data cache
     cachedSimData_.clear();
-    cachedSimDataActive_.clear();
+    cachedSimDataSharedData_.reset();
+    cachedSimDataFilter_ = nullptr;
     // reset term structures
     applyScenario(baseScenario_);
     // clear delta scenario keys
     diffToBaseKeys_.clear();
+    diffToBaseIndices_.clear();
     // see the comment in update() for why this is necessary...
     if (ObservationMode::instance().mode() == ObservationMode::Mode::Unregister) {
         QuantLib::ext::shared_ptr<QuantLib::Observable> obs = QuantLib::Settings::instance().evaluationDate();
@@ -2975,9 +3001,15 @@ void ScenarioSimMarket::reset() {
     filter_ = filterBackup;
 }
 
+void ScenarioSimMarket::trackChangedKeys(const bool b) {
+    trackChangedKeys_ = b;
+    changedKeys_.clear();
+}
+
 void ScenarioSimMarket::applyScenario(const QuantLib::ext::shared_ptr<Scenario>& scenario) {
 
     currentScenario_ = scenario;
+    changedKeys_.clear();
 
     // 1 handle delta scenario
 
@@ -2986,14 +3018,47 @@ void ScenarioSimMarket::applyScenario(const QuantLib::ext::shared_ptr<Scenario>&
     /*! our assumption is that either all or none of the scenarios we apply are 
         delta scenarios or the base scenario */
 
+    // all quotes are updated in one batch, observers are notified once at the end
+
+    QuoteUpdateBatch batch(*this);
+
     if (deltaScenario != nullptr) {
+        // restore the base values of the keys set by the previous delta scenario
+        for (auto i : diffToBaseIndices_) {
+            if (batch.set(*deltaSimData_[i], deltaSimDataBase_[i]) && trackChangedKeys_)
+                changedKeys_.push_back(baseScenario_->keys()[i]);
+        }
+        diffToBaseIndices_.clear();
         for (auto const& key : diffToBaseKeys_) {
             auto it = simData_.find(key);
             if (it != simData_.end()) {
-                it->second->setValue(baseScenario_->get(key));
+                if (batch.set(*it->second, baseScenario_->get(key)) && trackChangedKeys_)
+                    changedKeys_.push_back(key);
             }
         }
         diffToBaseKeys_.clear();
+
+        // 1a resolved delta scenario on our base scenario, only touch the shifted keys via their positions
+
+        if (deltaScenario->isResolved() && deltaScenario->base() == baseScenario_) {
+            if (filter_.get() != deltaSimDataFilter_ || deltaSimData_.size() != baseScenario_->keys().size())
+                bindDeltaSimData();
+            bool missingPoint = false;
+            for (auto const& [i, value] : deltaScenario->resolvedDelta()) {
+                if (deltaSimDataMissing_[i]) {
+                    ALOG("simulation data point missing for key " << baseScenario_->keys()[i]);
+                    missingPoint = true;
+                } else if (SimpleQuote* q = deltaSimData_[i]) {
+                    if (batch.set(*q, value) && trackChangedKeys_)
+                        changedKeys_.push_back(baseScenario_->keys()[i]);
+                    diffToBaseIndices_.push_back(i);
+                }
+            }
+            QL_REQUIRE(!missingPoint, "simulation data points missing from scenario, exit.");
+            batch.finish();
+            return;
+        }
+
         auto delta = deltaScenario->delta();
         bool missingPoint = false;
         for (auto const& key : delta->keys()) {
@@ -3003,59 +3068,43 @@ void ScenarioSimMarket::applyScenario(const QuantLib::ext::shared_ptr<Scenario>&
                 missingPoint = true;
             } else {
                 if (filter_->allow(key)) {
-                    it->second->setValue(delta->get(key));
+                    if (batch.set(*it->second, delta->get(key)) && trackChangedKeys_)
+                        changedKeys_.push_back(key);
                     diffToBaseKeys_.insert(key);
                 }
             }
         }
         QL_REQUIRE(!missingPoint, "simulation data points missing from scenario, exit.");
 
+        batch.finish();
         return;
     }
 
-    // 2 apply scenario based on cached indices for simData_ for a SimpleScenario
-    //   the scenario's keysHash() is used to make sure consistent keys are used
-    //   if keysHash() is zero, this check is not effective (for backwards compatibility)
-    if (cacheSimData_) {
-        if (auto s = QuantLib::ext::dynamic_pointer_cast<SimpleScenario>(scenario)) {
-
-            // fill cache
-
-            if (cachedSimData_.empty() || s->keysHash() != cachedSimDataKeysHash_) {
-                cachedSimData_.clear();
-                cachedSimDataKeysHash_ = s->keysHash();
-                Size count = 0;
-                for (auto const& key : s->keys()) {
-                    auto it = simData_.find(key);
-                    if (it == simData_.end()) {
-                        WLOG("simulation data point missing for key " << key);
-                        cachedSimData_.push_back(QuantLib::ext::shared_ptr<SimpleQuote>());
-                        cachedSimDataActive_.push_back(false);
-                    } else {
-                        ++count;
-                        cachedSimData_.push_back(it->second);
-                        cachedSimDataActive_.push_back(filter_->allow(key));
-                    }
+    // 2 apply scenario based on a binding of the keys to the simData_ quotes for a SimpleScenario
+    //   the binding is reused as long as the filter is unchanged and the scenario shares its data block with the
+    //   scenario the binding was built for, or if cacheSimData is true, the scenario's keysHash() matches
+    //   if keysHash() is zero, the latter check is not effective (for backwards compatibility)
+    if (auto s = QuantLib::ext::dynamic_pointer_cast<SimpleScenario>(scenario)) {
+        const auto& sharedData = s->sharedData();
+        if (cacheSimData_ || sharedData.use_count() > 1) {
+            bool valid = filter_.get() == cachedSimDataFilter_ &&
+                         ((sharedData == cachedSimDataSharedData_.lock() && s->keys().size() == cachedSimData_.size()) ||
+                          (cacheSimData_ && !cachedSimData_.empty() && s->keysHash() == cachedSimDataKeysHash_));
+            if (!valid)
+                bindSimData(*s);
+
+            // apply scenario data according to the binding, this is a linear pass over the data
+
+            const std::vector<Real>& data = s->data();
+            const Size n = std::min(data.size(), cachedSimData_.size());
+            for (Size i = 0; i < n; ++i) {
+                if (SimpleQuote* q = cachedSimData_[i]) {
+                    if (batch.set(*q, data[i]) && trackChangedKeys_)
+                        changedKeys_.push_back(s->keys()[i]);
                 }
-                if (count != simData_.size() && !allowPartialScenarios_) {
-                    ALOG("mismatch between scenario and sim data size, " << count << " vs " << simData_.size());
-                    for (auto it : simData_) {
-                        if (!scenario->has(it.first))
-                            WLOG("Key " << it.first << " missing in scenario");
-                    }
-                    QL_FAIL("mismatch between scenario and sim data size, exit.");
-                }
-            }
-
-            // apply scenario data according to cached indices
-
-            Size i = 0;
-            for (auto const& q : s->data()) {
-                if (cachedSimDataActive_[i])
-                    cachedSimData_[i]->setValue(q);
-                ++i;
             }
 
+            batch.finish();
             return;
         }
     }
@@ -3076,7 +3125,8 @@ void ScenarioSimMarket::applyScenario(const QuantLib::ext::shared_ptr<Scenario>&
             WLOG("simulation data point missing for key " << key);
         } else {
             if (filter_->allow(key)) {
-                it->second->setValue(scenario->get(key));
+                if (batch.set(*it->second, scenario->get(key)) && trackChangedKeys_)
+                    changedKeys_.push_back(key);
             }
             count++;
         }
@@ -3090,6 +3140,63 @@ void ScenarioSimMarket::applyScenario(const QuantLib::ext::shared_ptr<Scenario>&
         }
         QL_FAIL("mismatch between scenario and sim data size, exit.");
     }
+
+    batch.finish();
+}
+
+void ScenarioSimMarket::bindDeltaSimData() {
+    const auto& keys = baseScenario_->keys();
+    deltaSimData_.assign(keys.size(), nullptr);
+    deltaSimDataMissing_.assign(keys.size(), false);
+    deltaSimDataBase_.resize(keys.size());
+    for (Size i = 0; i < keys.size(); ++i) {
+        deltaSimDataBase_[i] = baseScenario_->get(keys[i]);
+        auto it = simData_.find(keys[i]);
+        if (it == simData_.end())
+            deltaSimDataMissing_[i] = true;
+        else if (filter_->allow(keys[i]))
+            deltaSimData_[i] = it->second.get();
+    }
+    deltaSimDataFilter_ = filter_.get();
+    updateAccountedMemory();
+}
+
+void ScenarioSimMarket::updateAccountedMemory() {
+    memory_.resize(simData_.size() * (sizeof(std::pair<const RiskFactorKey, QuantLib::ext::shared_ptr<SimpleQuote>>) +
+                                      sizeof(SimpleQuote)) +
+                   cachedSimData_.capacity() * sizeof(SimpleQuote*) + deltaSimData_.capacity() * sizeof(SimpleQuote*) +
+                   deltaSimDataMissing_.capacity() / 8 + deltaSimDataBase_.capacity() * sizeof(Real) +
+                   diffToBaseIndices_.capacity() * sizeof(Size));
+}
+
+void ScenarioSimMarket::bindSimData(const SimpleScenario& scenario) {
+    cachedSimData_.clear();
+    cachedSimDataSharedData_.reset();
+    cachedSimDataFilter_ = nullptr;
+    Size count = 0;
+    for (auto const& key : scenario.keys()) {
+        auto it = simData_.find(key);
+        if (it == simData_.end()) {
+            WLOG("simulation data point missing for key " << key);
+            cachedSimData_.push_back(nullptr);
+        } else {
+            ++count;
+            cachedSimData_.push_back(filter_->allow(key) ? it->second.get() : nullptr);
+        }
+    }
+    if (count != simData_.size() && !allowPartialScenarios_) {
+        ALOG("mismatch between scenario and sim data size, " << count << " vs " << simData_.size());
+        for (auto it : simData_) {
+            if (!scenario.has(it.first))
+                WLOG("Key " << it.first << " missing in scenario");
+        }
+        cachedSimData_.clear();
+        QL_FAIL("mismatch between scenario and sim data size, exit.");
+    }
+    cachedSimDataKeysHash_ = scenario.keysHash();
+    cachedSimDataSharedData_ = scenario.sharedData();
+    cachedSimDataFilter_ = filter_.get();
+    updateAccountedMemory();
 }
 
 void ScenarioSimMarket::preUpdate() {
@@ -3102,9 +3209,10 @@ void ScenarioSimMarket::preUpdate() {
 
 void ScenarioSimMarket::updateDate(const Date& d) {
     ObservationMode::Mode om = ObservationMode::instance().mode();
-    if (d != Settings::instance().evaluationDate())
+    if (d != Settings::instance().evaluationDate()) {
         Settings::instance().evaluationDate() = d;
-    else if (om == ObservationMode::Mode::Unregister) {
+        marketChanged_ = true;
+    } else if (om == ObservationMode::Mode::Unregister) {
         // Due to some of the notification chains having been unregistered,
         // it is possible that some lazy objects might be missed in the case
         // that the evaluation date has not been updated. Therefore, we
@@ -3118,7 +3226,11 @@ void ScenarioSimMarket::updateDate(const Date& d) {
 
 void ScenarioSimMarket::updateScenario(const Date& d) {
     QL_REQUIRE(scenarioGenerator_ != nullptr, "ScenarioSimMarket::update: no scenario generator set");
-    auto scenario = scenarioGenerator_->next(d);
+    QuantLib::ext::shared_ptr<Scenario> scenario;
+    {
+        ORE_TIMER("scenario generation");
+        scenario = scenarioGenerator_->next(d);
+    }
     QL_REQUIRE(scenario->asof() == d,
                "Invalid Scenario date " << scenario->asof() << ", expected " << d);
     numeraire_ = scenario->getNumeraire();
@@ -3130,8 +3242,13 @@ void ScenarioSimMarket::postUpdate(const Date& d, bool withFixings) {
     ObservationMode::Mode om = ObservationMode::instance().mode();
 
     // Observation Mode - key to update these before fixings are set
+    // In Disable mode the term structures have not seen any notifications, they are refreshed, unless neither the
+    // evaluation date nor any quote has changed since the last refresh
     if (om == ObservationMode::Mode::Disable) {
-        refresh();
+        if (marketChanged_) {
+            refresh();
+            marketChanged_ = false;
+        }
         ObservableSettings::instance().enableUpdates();
     } else if (om == ObservationMode::Mode::Defer) {
         ObservableSettings::instance().enableUpdates();
@@ -3144,6 +3261,26 @@ void ScenarioSimMarket::postUpdate(const Date& d, bool withFixings) {
 
 void ScenarioSimMarket::updateAsd(const Date& d) {
     if (asd_) {
+        // resolve the slots once per scenario data container, the order must match the set() calls below
+        if (asdSlotsData_.lock() != asd_) {
+            asdSlots_.clear();
+            for (auto i : parameters_->additionalScenarioDataIndices())
+                asdSlots_.push_back(asd_->addSlot(AggregationScenarioDataType::IndexFixing, i));
+            for (auto c : parameters_->additionalScenarioDataCcys()) {
+                if (c != parameters_->baseCcy())
+                    asdSlots_.push_back(asd_->addSlot(AggregationScenarioDataType::FXSpot, c));
+            }
+            for (Size i = 0; i < parameters_->additionalScenarioDataNumberOfCreditStates(); ++i)
+                asdSlots_.push_back(asd_->addSlot(AggregationScenarioDataType::CreditState, std::to_string(i)));
+            for (const auto& n : parameters_->additionalScenarioDataSurvivalWeights()) {
+                asdSlots_.push_back(asd_->addSlot(AggregationScenarioDataType::SurvivalWeight, n));
+                asdSlots_.push_back(asd_->addSlot(AggregationScenarioDataType::RecoveryRate, n));
+            }
+            asdSlots_.push_back(asd_->addSlot(AggregationScenarioDataType::Numeraire));
+            asdSlotsData_ = asd_;
+        }
+        auto slot = asdSlots_.begin();
+
         // add additional scenario data to the given container, if required
         for (auto i : parameters_->additionalScenarioDataIndices()) {
             QuantLib::ext::shared_ptr<QuantLib::Index> index;
@@ -3160,30 +3297,30 @@ void ScenarioSimMarket::updateAsd(const Date& d) {
                 // proxy fallback ibor index by its rfr index's fixing
                 index = fb->rfrIndex();
             }
-            asd_->set(index->fixing(index->fixingCalendar().adjust(d)), AggregationScenarioDataType::IndexFixing, i);
+            asd_->set(index->fixing(index->fixingCalendar().adjust(d)), *slot++);
         }
 
         for (auto c : parameters_->additionalScenarioDataCcys()) {
             if (c != parameters_->baseCcy())
-                asd_->set(fxSpot(c + parameters_->baseCcy())->value(), AggregationScenarioDataType::FXSpot, c);
+                asd_->set(fxSpot(c + parameters_->baseCcy())->value(), *slot++);
         }
 
         for (Size i = 0; i < parameters_->additionalScenarioDataNumberOfCreditStates(); ++i) {
             RiskFactorKey key(RiskFactorKey::KeyType::CreditState, std::to_string(i));
             QL_REQUIRE(currentScenario_->has(key), "scenario does not have key " << key);
-            asd_->set(currentScenario_->get(key), AggregationScenarioDataType::CreditState, std::to_string(i));
+            asd_->set(currentScenario_->get(key), *slot++);
         }
 
         for (const auto& n : parameters_->additionalScenarioDataSurvivalWeights()) {
             RiskFactorKey key(RiskFactorKey::KeyType::SurvivalWeight, n);
             QL_REQUIRE(currentScenario_->has(key), "scenario does not have key " << key);
-            asd_->set(currentScenario_->get(key), AggregationScenarioDataType::SurvivalWeight, n);
+            asd_->set(currentScenario_->get(key), *slot++);
             RiskFactorKey rrKey(RiskFactorKey::KeyType::RecoveryRate, n);
             QL_REQUIRE(currentScenario_->has(rrKey), "scenario does not have key " << key);
-            asd_->set(currentScenario_->get(rrKey), AggregationScenarioDataType::RecoveryRate, n);
+            asd_->set(currentScenario_->get(rrKey), *slot++);
         }
 
-        asd_->set(numeraire_, AggregationScenarioDataType::Numeraire);
+        asd_->set(numeraire_, *slot);
 
         asd_->next();
     }
@@ -26,11 +26,14 @@
 #include <orea/scenario/scenario.hpp>
 #include <orea/scenario/scenariogenerator.hpp>
 #include <orea/scenario/scenariosimmarketparameters.hpp>
+#include <orea/scenario/simplescenario.hpp>
 #include <orea/simulation/simmarket.hpp>
 #include <ored/configuration/conventions.hpp>
 #include <ored/configuration/curveconfigurations.hpp>
 #include <ored/configuration/iborfallbackconfig.hpp>
 
+#include <qle/utilities/memoryaccounting.hpp>
+
 #include <map>
 
 namespace ore {
@@ -60,7 +63,10 @@ public:
 /*! If useSpreadedTermStructures is true, spreaded term structures over the initMarket for supported risk factors will
   be generated. This is used by the SensitivityScenarioGenerator.
 
-  If cacheSimData is true, the scenario application is optimised. This requires that all scenarios are SimpleScenario
+  SimpleScenario instances sharing a shared data block with other scenarios (e.g. created by a SimpleScenarioFactory
+  using a common shared data block) are applied using a binding of their keys to the simulation data quotes, which is
+  built once per key layout and filter. If cacheSimData is true, this binding is also reused for scenarios with own
+  shared data blocks, as long as their keysHash() matches. This requires that all scenarios are SimpleScenario
   instances with identical key structure in their data.
 
   If allowPartialScenarios is true, the check that all simData_ is touched by a scenario is disabled.
@@ -103,6 +109,9 @@ public:
     //! Get aggregation data
     virtual const QuantLib::ext::shared_ptr<AggregationScenarioData>& aggregationScenarioData() const { return asd_; }
 
+    //! The simulation market parameters
+    const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& parameters() const { return parameters_; }
+
     //! Set scenarioFilter
     virtual QuantLib::ext::shared_ptr<ScenarioFilter>& filter() { return filter_; }
     //! Get scenarioFilter
@@ -141,6 +150,17 @@ public:
 
     void applyScenario(const QuantLib::ext::shared_ptr<Scenario>& scenario);
 
+    //! The simulation data quotes
+    const std::map<RiskFactorKey, QuantLib::ext::shared_ptr<SimpleQuote>>& simData() const { return simData_; }
+
+    /*! If enabled, applyScenario() records the keys whose quotes changed, see changedKeys(). This is off by default,
+        since recording the keys has a cost for scenarios that change most of the quotes. */
+    void trackChangedKeys(const bool b);
+    //! Is tracking of changed keys enabled
+    bool trackChangedKeys() const { return trackChangedKeys_; }
+    //! Keys whose quotes were changed by the last applyScenario() call, only populated if tracking is enabled
+    const std::vector<RiskFactorKey>& changedKeys() const { return changedKeys_; }
+
 protected:
     
 
@@ -173,9 +193,16 @@ protected:
     QuantLib::ext::shared_ptr<Scenario> baseScenario_;
     QuantLib::ext::shared_ptr<Scenario> baseScenarioAbsolute_;
 
-    std::vector<QuantLib::ext::shared_ptr<SimpleQuote>> cachedSimData_;
-    std::vector<bool> cachedSimDataActive_;
+    // binding of SimpleScenario data to simData_, null for keys that are not simulated or filtered out
+    void bindSimData(const SimpleScenario& scenario);
+    std::vector<SimpleQuote*> cachedSimData_;
     std::size_t cachedSimDataKeysHash_ = 0;
+    QuantLib::ext::weak_ptr<SimpleScenario::SharedData> cachedSimDataSharedData_;
+
+    // slots of the additional scenario data in asd_ in the order they are written in updateAsd()
+    std::vector<Size> asdSlots_;
+    QuantLib::ext::weak_ptr<AggregationScenarioData> asdSlotsData_;
+    const ScenarioFilter* cachedSimDataFilter_ = nullptr;
 
     std::set<RiskFactorKey::KeyType> nonSimulatedFactors_;
 
@@ -189,13 +216,30 @@ protected:
 
     bool cacheSimData_;
     bool allowPartialScenarios_;
+    bool trackChangedKeys_ = false;
+    std::vector<RiskFactorKey> changedKeys_;
     IborFallbackConfig iborFallbackConfig_;
 
     // for delta scenario application
     std::set<ore::analytics::RiskFactorKey> diffToBaseKeys_;
 
+    // binding of the base scenario keys to simData_ for resolved delta scenarios, the quote is null for keys that
+    // are not simulated or filtered out, missing flags keys that are not simulated, the base values are cached
+    void bindDeltaSimData();
+    std::vector<SimpleQuote*> deltaSimData_;
+    std::vector<bool> deltaSimDataMissing_;
+    std::vector<Real> deltaSimDataBase_;
+    const ScenarioFilter* deltaSimDataFilter_ = nullptr;
+    // positions in the base scenario keys set by the last resolved delta scenario
+    std::vector<Size> diffToBaseIndices_;
+
     mutable QuantLib::ext::shared_ptr<Scenario> currentScenario_;
     QuantLib::ext::shared_ptr<Scenario> offsetScenario_;
+
+    // the sim data quotes and their bindings, updated when a binding is built
+    void updateAccountedMemory();
+    QuantExt::AccountedMemory memory_ =
+        QuantExt::AccountedMemory(QuantExt::MemoryAccounting::instance().account("ScenarioSimMarket"));
 };
 } // namespace analytics
 } // namespace ore
@@ -25,6 +25,7 @@
 
 using ore::analytics::RiskFactorKey;
 using ore::data::parseBool;
+using ore::data::parseInteger;
 using ore::data::to_string;
 using ore::data::XMLDocument;
 using std::string;
@@ -518,6 +519,8 @@ void SensitivityScenarioData::fromXML(XMLNode* root) {
             QL_REQUIRE(tokens.size() == 2, "expected 2 tokens, found " << tokens.size() << " in " << filter[i]);
             crossGammaFilter_.push_back(pair<string, string>(tokens[0], tokens[1]));
         }
+        if (auto n = XMLUtils::getChildNode(CGF, "MaxIndexDistance"))
+            crossGammaMaxIndexDistance_ = parseInteger(XMLUtils::getNodeValue(n));
     }
 
     DLOG("Get compute gamma flag");
@@ -894,6 +897,8 @@ XMLNode* SensitivityScenarioData::toXML(XMLDocument& doc) const {
         for (const auto& crossGamma : crossGammaFilter_) {
             XMLUtils::addChild(doc, parent, "Pair", crossGamma.first + "," + crossGamma.second);
         }
+        if (crossGammaMaxIndexDistance_ != QuantLib::Null<Size>())
+            XMLUtils::addChild(doc, parent, "MaxIndexDistance", static_cast<int>(crossGammaMaxIndexDistance_));
     }
 
     XMLUtils::addChild(doc, root, "ComputeGamma", computeGamma_);
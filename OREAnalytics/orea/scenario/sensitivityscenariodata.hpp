@@ -184,6 +184,10 @@ public:
     const map<string, SpotShiftData>& securityShiftData() const { return securityShiftData_; }
 
     const vector<pair<string, string>>& crossGammaFilter() const { return crossGammaFilter_; }
+    /*! If not null, cross gammas between two factors of term structures or surfaces are only computed if the factor
+        indices (e.g. the curve pillars) differ by at most this number. Pairs involving a scalar factor (e.g. a fx spot)
+        are not restricted. */
+    QuantLib::Size crossGammaMaxIndexDistance() const { return crossGammaMaxIndexDistance_; }
     const bool computeGamma() const { return computeGamma_; }
     const bool useSpreadedTermStructures() const { return useSpreadedTermStructures_; }
 
@@ -227,6 +231,7 @@ public:
     map<string, SpotShiftData>& securityShiftData() { return securityShiftData_; }
 
     vector<pair<string, string>>& crossGammaFilter() { return crossGammaFilter_; }
+    QuantLib::Size& crossGammaMaxIndexDistance() { return crossGammaMaxIndexDistance_; }
     bool& computeGamma() { return computeGamma_; }
     bool& useSpreadedTermStructures() { return useSpreadedTermStructures_; }
     //@}
@@ -287,6 +292,7 @@ protected:
     map<string, SpotShiftData> securityShiftData_; // key: security name
 
     vector<pair<string, string>> crossGammaFilter_;
+    QuantLib::Size crossGammaMaxIndexDistance_ = QuantLib::Null<QuantLib::Size>();
     bool computeGamma_;
     bool useSpreadedTermStructures_;
     bool parConversion_;
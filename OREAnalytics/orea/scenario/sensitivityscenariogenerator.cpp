@@ -17,6 +17,7 @@
 */
 
 #include <orea/app/structuredanalyticserror.hpp>
+#include <orea/scenario/deltascenario.hpp>
 #include <orea/scenario/sensitivityscenariogenerator.hpp>
 
 #include <ored/utilities/indexparser.hpp>
@@ -202,7 +203,20 @@ void SensitivityScenarioGenerator::generateScenarios() {
 
     // add simultaneous up-moves in two risk factors for cross gamma calculation
 
-    for (Size i = 0; i < scenarios_.size(); ++i) {
+    // number of up scenarios per key name, to identify scalar factors which are exempt from the index distance
+    // restriction of the cross gamma pairs
+    Size maxIndexDistance = sensitivityData_->crossGammaMaxIndexDistance();
+    std::map<string, Size> upFactorsPerKeyName;
+    if (maxIndexDistance != Null<Size>()) {
+        for (auto const& d : scenarioDescriptions_) {
+            if (d.type() == ScenarioDescription::Type::Up)
+                ++upFactorsPerKeyName[d.keyName1()];
+        }
+    }
+    Size nScenarios = scenarios_.size();
+    Size skippedCrossScenarios = 0;
+
+    for (Size i = 0; i < nScenarios; ++i) {
         ScenarioDescription iDesc = scenarioDescriptions_[i];
         if (iDesc.type() != ScenarioDescription::Type::Up)
             continue;
@@ -213,7 +227,7 @@ void SensitivityScenarioGenerator::generateScenarios() {
                     findFactor(iKeyName)) == sensitivityData_->crossGammaFilter().end())
             continue;
 
-        for (Size j = i + 1; j < scenarios_.size(); ++j) {
+        for (Size j = i + 1; j < nScenarios; ++j) {
             ScenarioDescription jDesc = scenarioDescriptions_[j];
             if (jDesc.type() != ScenarioDescription::Type::Up)
                 continue;
@@ -224,6 +238,16 @@ void SensitivityScenarioGenerator::generateScenarios() {
                         findPair(iKeyName, jKeyName)) == sensitivityData_->crossGammaFilter().end())
                 continue;
 
+            // skip pairs of term structure or surface factors which are too far apart
+            if (maxIndexDistance != Null<Size>() && upFactorsPerKeyName[iKeyName] > 1 &&
+                upFactorsPerKeyName[jKeyName] > 1) {
+                Size iIndex = iDesc.key1().index, jIndex = jDesc.key1().index;
+                if ((iIndex > jIndex ? iIndex - jIndex : jIndex - iIndex) > maxIndexDistance) {
+                    ++skippedCrossScenarios;
+                    continue;
+                }
+            }
+
             // build cross scenario
             QuantLib::ext::shared_ptr<Scenario> crossScenario =
                 sensiScenarioFactory_->buildScenario(asof, !sensitivityData_->useSpreadedTermStructures());
@@ -244,6 +268,25 @@ void SensitivityScenarioGenerator::generateScenarios() {
         }
     }
 
+    if (maxIndexDistance != Null<Size>()) {
+        LOG("Generated " << scenarios_.size() - nScenarios << " cross gamma scenarios, skipped "
+                         << skippedCrossScenarios << " pairs with an index distance greater than " << maxIndexDistance
+                         << " (" << scenarios_.size() << " scenarios in total)");
+    }
+
+    // resolve the delta keys to positions in the base scenario keys, so that the sim market can apply the
+    // scenarios without key lookups
+
+    std::map<RiskFactorKey, Size> baseKeyIndex;
+    for (Size i = 0; i < baseScenario_->keys().size(); ++i)
+        baseKeyIndex[baseScenario_->keys()[i]] = i;
+    for (auto const& s : scenarios_) {
+        if (auto d = QuantLib::ext::dynamic_pointer_cast<DeltaScenario>(s)) {
+            if (d->base() == baseScenario_)
+                d->resolveDelta(baseKeyIndex);
+        }
+    }
+
     LOG("sensitivity scenario generator finished generating scenarios.");
 }
 
@@ -27,6 +27,11 @@
 namespace ore {
 namespace analytics {
 
+QuantExt::MemoryAccount& SimpleScenario::memoryAccount() {
+    static QuantExt::MemoryAccount& account = QuantExt::MemoryAccounting::instance().account("Scenario");
+    return account;
+}
+
 SimpleScenario::SimpleScenario(Date asof, const std::string& label, Real numeraire,
                                const boost::shared_ptr<SharedData>& sharedData)
     : sharedData_(sharedData == nullptr ? QuantLib::ext::make_shared<SharedData>() : sharedData), asof_(asof),
@@ -46,8 +51,10 @@ void SimpleScenario::add(const RiskFactorKey& key, Real value) {
         boost::hash_combine(sharedData_->keysHash, key);
     }
 
-    if (data_.size() <= dataIndex)
+    if (data_.size() <= dataIndex) {
         data_.resize(dataIndex + 1, QuantLib::Null<Real>());
+        memory_.resize(data_.capacity() * sizeof(Real));
+    }
 
     data_[dataIndex] = value;
 }
@@ -58,6 +65,14 @@ Real SimpleScenario::get(const RiskFactorKey& key) const {
     return data_[i->second];
 }
 
+void SimpleScenario::setData(std::vector<Real> data) {
+    QL_REQUIRE(data.size() <= sharedData_->keys.size(), "SimpleScenario::setData(): data size ("
+                                                            << data.size() << ") exceeds number of keys ("
+                                                            << sharedData_->keys.size() << ")");
+    memory_.resize(data.capacity() * sizeof(Real));
+    data_ = std::move(data);
+}
+
 QuantLib::ext::shared_ptr<Scenario> SimpleScenario::clone() const {
     return QuantLib::ext::make_shared<SimpleScenario>(*this);
 }
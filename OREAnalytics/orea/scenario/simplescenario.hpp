@@ -25,6 +25,8 @@
 
 #include <orea/scenario/scenario.hpp>
 
+#include <qle/utilities/memoryaccounting.hpp>
+
 namespace ore {
 namespace analytics {
 using std::string;
@@ -80,13 +82,20 @@ public:
     //! get data, order is the same as in keys()
     const std::vector<Real>& data() const { return data_; }
 
+    //! set data, order is the same as in keys(), the size must not exceed the number of keys
+    void setData(std::vector<Real> data);
+
 private:
+    static QuantExt::MemoryAccount& memoryAccount();
+
     QuantLib::ext::shared_ptr<SharedData> sharedData_;
     bool isAbsolute_ = true;
     Date asof_;
     std::string label_;
     Real numeraire_ = 0.0;
     std::vector<Real> data_;
+    // the capacity of data_, the shared data is not accounted for
+    QuantExt::AccountedMemory memory_ = QuantExt::AccountedMemory(memoryAccount());
 };
 
 } // namespace analytics
@@ -0,0 +1,207 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/simm/compactcrif.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <limits>
+
+namespace ore {
+namespace analytics {
+
+namespace {
+// placeholder for the FRTB only key fields of SIMM records
+const std::uint32_t noId = std::numeric_limits<std::uint32_t>::max();
+} // namespace
+
+std::size_t CompactCrif::KeyHash::operator()(const Key& k) const { return boost::hash_range(k.begin(), k.end()); }
+
+CompactCrif::Id CompactCrif::intern(const std::string& s) {
+    auto it = stringIds_.find(s);
+    if (it != stringIds_.end())
+        return it->second;
+    QL_REQUIRE(strings_.size() < noId, "CompactCrif: too many distinct strings");
+    Id id = static_cast<Id>(strings_.size());
+    strings_.push_back(s);
+    stringIds_.emplace(s, id);
+    return id;
+}
+
+CompactCrif::Key CompactCrif::key(const PackedRecord& r, const bool frtb) const {
+    auto frtbOnly = [&r, frtb](const Field f) { return frtb ? r.ids[f] : noId; };
+    return {r.ids[TradeId],
+            r.ids[NettingSet],
+            r.productClass,
+            r.riskType,
+            r.ids[Qualifier],
+            r.ids[Bucket],
+            r.ids[Label1],
+            r.ids[Label2],
+            frtbOnly(Label3),
+            frtbOnly(EndDate),
+            frtbOnly(CreditQuality),
+            frtbOnly(LongShortInd),
+            frtbOnly(CoveredBondInd),
+            frtbOnly(TrancheThickness),
+            frtbOnly(BbRw),
+            r.ids[AmountCurrency],
+            r.ids[CollectRegulations],
+            r.ids[PostRegulations]};
+}
+
+void CompactCrif::addRecord(const CrifRecord& cr) {
+
+    // SIMM parameters and generic records are aggregated by Crif::addRecord() when converting to a Crif
+
+    CrifRecord::RecordType recordType = cr.type();
+    bool frtb = recordType == CrifRecord::RecordType::FRTB;
+    if (!frtb && (recordType != CrifRecord::RecordType::SIMM || cr.isSimmParameter())) {
+        otherRecords_.push_back(cr);
+        return;
+    }
+
+    if (frtb) {
+        QL_REQUIRE(type_ == Crif::CrifType::Empty || type_ == Crif::CrifType::Frtb,
+                   "Can not add a FRTB crif record to a SIMM Crif");
+        type_ = Crif::CrifType::Frtb;
+    } else {
+        QL_REQUIRE(type_ == Crif::CrifType::Empty || type_ == Crif::CrifType::Simm,
+                   "Can not add a Simm crif record to a Frtb Crif");
+        type_ = Crif::CrifType::Simm;
+    }
+
+    // sort the fx vol qualifier, as Crif::addRecord() does
+
+    std::string qualifier = cr.qualifier;
+    if (!frtb && cr.riskType == CrifRecord::RiskType::FXVol) {
+        auto ccy_1 = qualifier.substr(0, 3);
+        auto ccy_2 = qualifier.substr(3);
+        if (ccy_1 > ccy_2)
+            ccy_1.swap(ccy_2);
+        qualifier = ccy_1 + ccy_2;
+    }
+
+    PackedRecord r;
+    r.ids[TradeId] = intern(cr.tradeId);
+    r.ids[TradeType] = intern(cr.tradeType);
+    r.ids[PortfolioId] = intern(cr.portfolioId);
+    auto nsd = nettingSetIds_.find(cr.nettingSetDetails);
+    if (nsd == nettingSetIds_.end()) {
+        nsd = nettingSetIds_.emplace(cr.nettingSetDetails, static_cast<Id>(nettingSets_.size())).first;
+        nettingSets_.push_back(cr.nettingSetDetails);
+    }
+    r.ids[NettingSet] = nsd->second;
+    r.ids[Qualifier] = intern(qualifier);
+    r.ids[Bucket] = intern(cr.bucket);
+    r.ids[Label1] = intern(cr.label1);
+    r.ids[Label2] = intern(cr.label2);
+    r.ids[Label3] = intern(cr.label3);
+    r.ids[AmountCurrency] = intern(cr.amountCurrency);
+    r.ids[ResultCurrency] = intern(cr.resultCurrency);
+    r.ids[ImModel] = intern(cr.imModel);
+    r.ids[CollectRegulations] = intern(cr.collectRegulations);
+    r.ids[PostRegulations] = intern(cr.postRegulations);
+    r.ids[EndDate] = intern(cr.endDate);
+    r.ids[CreditQuality] = intern(cr.creditQuality);
+    r.ids[LongShortInd] = intern(cr.longShortInd);
+    r.ids[CoveredBondInd] = intern(cr.coveredBondInd);
+    r.ids[TrancheThickness] = intern(cr.trancheThickness);
+    r.ids[BbRw] = intern(cr.bb_rw);
+    r.ids[AgreementType] = intern(cr.agreementType);
+    r.ids[CallType] = intern(cr.callType);
+    r.ids[InitialMarginType] = intern(cr.initialMarginType);
+    r.ids[LegalEntityId] = intern(cr.legalEntityId);
+    r.ids[AdditionalFields] = 0;
+    r.productClass = static_cast<std::uint8_t>(cr.productClass);
+    r.riskType = static_cast<std::uint8_t>(cr.riskType);
+    r.amount = cr.amount;
+    r.amountUsd = cr.amountUsd;
+    r.amountResultCcy = cr.amountResultCcy;
+
+    auto [it, inserted] = index_.emplace(key(r, frtb), records_.size());
+    if (inserted) {
+        if (!cr.additionalFields.empty()) {
+            additionalFields_.push_back(cr.additionalFields);
+            r.ids[AdditionalFields] = static_cast<Id>(additionalFields_.size());
+        }
+        records_.push_back(r);
+        return;
+    }
+
+    // update the amounts of the existing record like Crif::updateAmountExistingRecord()
+
+    PackedRecord& existing = records_[it->second];
+    if (cr.hasAmountUsd())
+        existing.amountUsd += cr.amountUsd;
+    if (cr.hasAmount() && cr.hasAmountCcy() && existing.ids[AmountCurrency] == r.ids[AmountCurrency])
+        existing.amount += cr.amount;
+    if (cr.hasAmountResultCcy() && cr.hasResultCcy() && existing.ids[ResultCurrency] == r.ids[ResultCurrency])
+        existing.amountResultCcy += cr.amountResultCcy;
+}
+
+CrifRecord CompactCrif::record(const QuantLib::Size i) const {
+    QL_REQUIRE(i < records_.size(), "CompactCrif::record(): index " << i << " out of range, have "
+                                                                    << records_.size() << " packed records");
+    const PackedRecord& r = records_[i];
+    CrifRecord cr;
+    cr.tradeId = strings_[r.ids[TradeId]];
+    cr.tradeType = strings_[r.ids[TradeType]];
+    cr.portfolioId = strings_[r.ids[PortfolioId]];
+    cr.nettingSetDetails = nettingSets_[r.ids[NettingSet]];
+    cr.productClass = static_cast<CrifRecord::ProductClass>(r.productClass);
+    cr.riskType = static_cast<CrifRecord::RiskType>(r.riskType);
+    cr.qualifier = strings_[r.ids[Qualifier]];
+    cr.bucket = strings_[r.ids[Bucket]];
+    cr.label1 = strings_[r.ids[Label1]];
+    cr.label2 = strings_[r.ids[Label2]];
+    cr.label3 = strings_[r.ids[Label3]];
+    cr.amountCurrency = strings_[r.ids[AmountCurrency]];
+    cr.amount = r.amount;
+    cr.amountUsd = r.amountUsd;
+    cr.resultCurrency = strings_[r.ids[ResultCurrency]];
+    cr.amountResultCcy = r.amountResultCcy;
+    cr.agreementType = strings_[r.ids[AgreementType]];
+    cr.callType = strings_[r.ids[CallType]];
+    cr.initialMarginType = strings_[r.ids[InitialMarginType]];
+    cr.legalEntityId = strings_[r.ids[LegalEntityId]];
+    cr.imModel = strings_[r.ids[ImModel]];
+    cr.collectRegulations = strings_[r.ids[CollectRegulations]];
+    cr.postRegulations = strings_[r.ids[PostRegulations]];
+    cr.endDate = strings_[r.ids[EndDate]];
+    cr.creditQuality = strings_[r.ids[CreditQuality]];
+    cr.longShortInd = strings_[r.ids[LongShortInd]];
+    cr.coveredBondInd = strings_[r.ids[CoveredBondInd]];
+    cr.trancheThickness = strings_[r.ids[TrancheThickness]];
+    cr.bb_rw = strings_[r.ids[BbRw]];
+    if (r.ids[AdditionalFields] > 0)
+        cr.additionalFields = additionalFields_[r.ids[AdditionalFields] - 1];
+    return cr;
+}
+
+Crif CompactCrif::toCrif() const {
+    Crif crif;
+    for (QuantLib::Size i = 0; i < records_.size(); ++i)
+        crif.addRecord(record(i));
+    for (auto const& cr : otherRecords_)
+        crif.addRecord(cr);
+    return crif;
+}
+
+} // namespace analytics
+} // namespace ore
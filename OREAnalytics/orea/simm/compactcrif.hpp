@@ -0,0 +1,131 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/simm/compactcrif.hpp
+    \brief Memory efficient store for aggregating CRIF records
+*/
+
+#pragma once
+
+#include <orea/simm/crif.hpp>
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+/*! A store for CRIF records that is used to load and aggregate large CRIF sets.
+
+    All string fields are interned, i.e. each distinct string is stored once and the records hold 32 bit ids. The
+    records are packed in a vector and duplicate records are aggregated via a hash map on their key. The key and the
+    aggregation of the amounts are the same as in Crif::addRecord() with the default arguments, i.e. for SIMM and FRTB
+    sensitivity records. SIMM parameter records are kept as they are and aggregated when converting to a Crif.
+
+    The store is an aggregation buffer for the loaders, the SIMM and FRTB calculators consume a Crif retrieved via
+    toCrif(). The gain is in the loading, where each line is aggregated by a hash lookup and only the distinct records
+    are inserted into the Crif. The memory of the resulting Crif is not reduced, to bound the peak memory for large
+    inputs load the CRIF one netting set at a time, see StringStreamCrifLoader::loadCrifByNettingSet().
+*/
+class CompactCrif {
+public:
+    CompactCrif() = default;
+
+    //! Add a record, aggregating it into an existing record with the same key
+    void addRecord(const CrifRecord& record);
+
+    //! Number of distinct records
+    QuantLib::Size size() const { return records_.size() + otherRecords_.size(); }
+    bool empty() const { return size() == 0; }
+
+    //! Number of distinct strings held in the string pool
+    QuantLib::Size numberOfStrings() const { return strings_.size(); }
+
+    //! Reconstruct the i-th packed record, i < size() - number of SIMM parameter records
+    CrifRecord record(const QuantLib::Size i) const;
+
+    //! Convert to a Crif
+    Crif toCrif() const;
+
+private:
+    using Id = std::uint32_t;
+
+    enum Field {
+        TradeId,
+        TradeType,
+        PortfolioId,
+        NettingSet,
+        Qualifier,
+        Bucket,
+        Label1,
+        Label2,
+        Label3,
+        AmountCurrency,
+        ResultCurrency,
+        ImModel,
+        CollectRegulations,
+        PostRegulations,
+        EndDate,
+        CreditQuality,
+        LongShortInd,
+        CoveredBondInd,
+        TrancheThickness,
+        BbRw,
+        AgreementType,
+        CallType,
+        InitialMarginType,
+        LegalEntityId,
+        AdditionalFields,
+        NumberOfFields
+    };
+
+    struct PackedRecord {
+        std::array<Id, NumberOfFields> ids;
+        std::uint8_t productClass;
+        std::uint8_t riskType;
+        QuantLib::Real amount, amountUsd, amountResultCcy;
+    };
+
+    //! the fields defining the key of a record, see CrifRecord::operator==()
+    using Key = std::array<Id, 18>;
+    struct KeyHash {
+        std::size_t operator()(const Key& k) const;
+    };
+
+    Id intern(const std::string& s);
+    Key key(const PackedRecord& r, const bool frtb) const;
+
+    std::vector<std::string> strings_;
+    std::unordered_map<std::string, Id> stringIds_;
+    std::vector<NettingSetDetails> nettingSets_;
+    std::map<NettingSetDetails, Id> nettingSetIds_;
+    std::vector<std::map<std::string, std::variant<std::string, double, bool>>> additionalFields_;
+
+    std::vector<PackedRecord> records_;
+    std::unordered_map<Key, QuantLib::Size, KeyHash> index_;
+    std::vector<CrifRecord> otherRecords_;
+    Crif::CrifType type_ = Crif::CrifType::Empty;
+};
+
+} // namespace analytics
+} // namespace ore
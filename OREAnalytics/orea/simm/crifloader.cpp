@@ -25,6 +25,7 @@
 #include <ored/utilities/parsers.hpp>
 
 #include <algorithm>
+#include <memory>
 #include <boost/algorithm/string.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include <boost/range/adaptor/indexed.hpp>
@@ -32,6 +33,7 @@
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/parsers.hpp>
 #include <ored/utilities/to_string.hpp>
+#include <ored/utilities/workergroup.hpp>
 
 using ore::data::checkCurrency;
 using ore::data::parseListOfValues;
@@ -39,6 +41,7 @@ using ore::data::parseReal;
 using ore::data::parseBool;
 using ore::data::to_string;
 using ore::data::Report;
+using ore::data::WorkerGroup;
 using QuantLib::Size;
 using QuantLib::Real;
 using std::exception;
@@ -92,7 +95,7 @@ map<Size, set<string>> CrifLoader::optionalHeaders = {
 using RiskType = CrifRecord::RiskType;
 using ProductClass = CrifRecord::ProductClass;
 
-void CrifLoader::addRecordToCrif(Crif& crif, CrifRecord&& recordToAdd) const {
+void CrifLoader::prepareRecord(CrifRecord& recordToAdd) const {
     bool add = recordToAdd.type() != CrifRecord::RecordType::Generic;
     if (recordToAdd.type() == CrifRecord::RecordType::SIMM) {
         validateSimmRecord(recordToAdd);
@@ -102,11 +105,18 @@ void CrifLoader::addRecordToCrif(Crif& crif, CrifRecord&& recordToAdd) const {
     if (aggregateTrades_) {
         recordToAdd.tradeId = "";
     }
-    if (add) {
-        crif.addRecord(recordToAdd);
-    } else {
-        QL_FAIL("Risk type string " << recordToAdd.riskType << " does not correspond to a valid SimmConfiguration::RiskType");
-    }
+    QL_REQUIRE(add, "Risk type string " << recordToAdd.riskType
+                                        << " does not correspond to a valid SimmConfiguration::RiskType");
+}
+
+void CrifLoader::addRecordToCrif(Crif& crif, CrifRecord&& recordToAdd) const {
+    prepareRecord(recordToAdd);
+    crif.addRecord(recordToAdd);
+}
+
+void CrifLoader::addRecordToCrif(CompactCrif& crif, CrifRecord&& recordToAdd) const {
+    prepareRecord(recordToAdd);
+    crif.addRecord(recordToAdd);
 }
 
 void CrifLoader::validateSimmRecord(const CrifRecord& cr) const {   
@@ -230,16 +240,142 @@ std::stringstream CsvBufferCrifLoader::stream() const {
     return csvStream;
 }
 
+std::unique_ptr<std::istream> StringStreamCrifLoader::inputStream() const {
+    return std::make_unique<std::stringstream>(stream());
+}
+
+std::unique_ptr<std::istream> CsvFileCrifLoader::inputStream() const {
+    // Read the file line by line instead of buffering it as a whole
+    auto file = std::make_unique<ifstream>(filename_);
+    QL_REQUIRE(file->is_open(), "error opening file " << filename_);
+    return file;
+}
+
 Crif StringStreamCrifLoader::loadFromStream(std::stringstream&& stream) {
+    // the lines are aggregated in a compact store and only the distinct records are converted to a Crif at the end
+    CompactCrif result;
+    readLines(stream, [this, &result](const vector<string>& entries, Size maxIndex, Size currentLine) {
+        return process(entries, maxIndex, currentLine, result);
+    });
+    LOG("Aggregated to " << result.size() << " CRIF records with " << result.numberOfStrings() << " distinct strings.");
+    return result.toCrif();
+}
+
+void StringStreamCrifLoader::loadCrifByNettingSet(const std::function<void(Crif&&)>& processBlock) {
+    CompactCrif block;
+    string currentKey;
+    bool first = true;
+    Size nBlocks = 0;
+
+    auto flush = [this, &block, &processBlock, &nBlocks]() {
+        if (block.size() == 0)
+            return;
+        Crif crif = block.toCrif();
+        block = CompactCrif();
+        if (updateMapper_ && configuration_->bucketMapper() != nullptr)
+            configuration_->bucketMapper()->updateFromCrif(crif);
+        ++nBlocks;
+        processBlock(std::move(crif));
+    };
+
+    // The columns identifying the netting set of a record, resolved from the header on the first line
+    vector<Size> keyColumns;
+    bool keyColumnsResolved = false;
+    auto stream = inputStream();
+    readLines(*stream, [&](const vector<string>& entries, Size maxIndex, Size currentLine) {
+        if (!keyColumnsResolved) {
+            keyColumns = nettingSetColumns();
+            keyColumnsResolved = true;
+        }
+        if (entries.size() > maxIndex) {
+            string key;
+            for (Size c : keyColumns)
+                key += entries[c] + '\x1f';
+            if (!first && key != currentKey)
+                flush();
+            currentKey = key;
+            first = false;
+        }
+        return process(entries, maxIndex, currentLine, block);
+    });
+    flush();
+    LOG("Processed CRIF in " << nBlocks << " netting set blocks.");
+}
+
+vector<Size> StringStreamCrifLoader::nettingSetColumns() const {
+    // The portfolio id and the netting set details fields, looked up by their header names
+    vector<string> names = {"portfolioid"};
+    for (const string& field : NettingSetDetails::optionalFieldNames())
+        names.push_back(boost::to_lower_copy(field));
+    vector<Size> columns;
+    for (const string& name : names) {
+        for (const auto* headers : {&requiredHeaders, &optionalHeaders}) {
+            for (const auto& [index, alternatives] : *headers) {
+                if (alternatives.count(name) == 0)
+                    continue;
+                if (auto it = columnIndex_.find(index); it != columnIndex_.end())
+                    columns.push_back(it->second);
+            }
+        }
+    }
+    return columns;
+}
+
+void StringStreamCrifLoader::readLines(
+    std::istream& stream, const std::function<bool(const vector<string>&, Size, Size)>& processLine) {
     string line;
-    vector<string> entries;
     bool headerProcessed = false;
     Size emptyLines = 0;
     Size validLines = 0;
     Size invalidLines = 0;
     Size maxIndex = 0;
     Size currentLine = 0;
-    Crif result;
+
+    // The lines are read in chunks, the chunk is broken up in to elements on worker threads if more than one thread
+    // is set. The elements are then processed sequentially in file order. The worker threads are reused for all
+    // chunks.
+    Size chunkSize = nThreads_ == 1 ? 1 : 4096 * nThreads_;
+    vector<string> lines;
+    vector<Size> lineNumbers;
+    vector<vector<string>> chunkEntries;
+    std::unique_ptr<WorkerGroup> workers;
+    if (nThreads_ > 1)
+        workers = std::make_unique<WorkerGroup>(nThreads_);
+
+    auto processChunk = [&]() {
+        chunkEntries.resize(lines.size());
+        auto split = [this, &lines, &chunkEntries](Size i) {
+            chunkEntries[i] = parseListOfValues(lines[i], escapeChar_, delim_, quoteChar_);
+        };
+        if (workers)
+            workers->run(lines.size(), split);
+        else
+            for (Size i = 0; i < lines.size(); ++i)
+                split(i);
+
+        for (Size i = 0; i < lines.size(); ++i) {
+            const vector<string>& entries = chunkEntries[i];
+            if (headerProcessed) {
+                // Process a regular line of the CRIF file
+                if (processLine(entries, maxIndex, lineNumbers[i])) {
+                    ++validLines;
+                } else {
+                    ++invalidLines;
+                }
+            } else {
+                // Process the header line of the CRIF file
+                processHeader(entries);
+                headerProcessed = true;
+                auto maxPair = max_element(
+                    columnIndex_.begin(), columnIndex_.end(),
+                    [](const pair<Size, Size>& p1, const pair<Size, Size>& p2) { return p1.second < p2.second; });
+                maxIndex = maxPair->second;
+            }
+        }
+        lines.clear();
+        lineNumbers.clear();
+    };
+
     while (getline(stream, line, eol_)) {
 
         // Keep track of current line number for messages
@@ -254,30 +390,15 @@ Crif StringStreamCrifLoader::loadFromStream(std::stringstream&& stream) {
             continue;
         }
 
-        // Break line up in to its elements.
-        entries = parseListOfValues(line, escapeChar_, delim_, quoteChar_);
-
-        if (headerProcessed) {
-            // Process a regular line of the CRIF file
-            if (process(entries, maxIndex, currentLine, result)) {
-                ++validLines;
-            } else {
-                ++invalidLines;
-            }
-        } else {
-            // Process the header line of the CRIF file
-            processHeader(entries);
-            headerProcessed = true;
-            auto maxPair = max_element(
-                columnIndex_.begin(), columnIndex_.end(),
-                [](const pair<Size, Size>& p1, const pair<Size, Size>& p2) { return p1.second < p2.second; });
-            maxIndex = maxPair->second;
-        }
+        lines.push_back(line);
+        lineNumbers.push_back(currentLine);
+        if (lines.size() == chunkSize)
+            processChunk();
     }
+    processChunk();
 
     LOG("Out of " << currentLine << " lines, there were " << validLines << " valid lines, " << invalidLines
                   << " invalid lines and " << emptyLines << " empty lines.");
-    return result;
 }
 
 
@@ -333,7 +454,8 @@ void StringStreamCrifLoader::processHeader(const vector<string>& headers) {
     }
 }
 
-bool StringStreamCrifLoader::process(const vector<string>& entries, Size maxIndex, Size currentLine, Crif& result) {
+bool StringStreamCrifLoader::process(const vector<string>& entries, Size maxIndex, Size currentLine,
+                                     CompactCrif& result) {
     CrifRecord cr;
     // Return early if there are not enough entries in the line
     if (entries.size() <= maxIndex) {
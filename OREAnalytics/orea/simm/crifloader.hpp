@@ -22,11 +22,16 @@
 
 #pragma once
 
+#include <algorithm>
 #include <map>
+#include <orea/simm/compactcrif.hpp>
 #include <orea/simm/crif.hpp>
 #include <orea/simm/simmconfiguration.hpp>
 #include <ored/marketdata/market.hpp>
 #include <ored/report/report.hpp>
+#include <functional>
+#include <istream>
+#include <memory>
 #include <tuple>
 
 #include <ql/types.hpp>
@@ -67,6 +72,9 @@ protected:
     virtual Crif loadCrifImpl() = 0;
 
     void addRecordToCrif(Crif& crif, CrifRecord&& recordToAdd) const;
+    void addRecordToCrif(CompactCrif& crif, CrifRecord&& recordToAdd) const;
+    //! Validate the record and apply the configured overrides before it is added
+    void prepareRecord(CrifRecord& recordToAdd) const;
 
     //! Check if the record is a valid Simm Crif Record
     void validateSimmRecord(const CrifRecord& cr) const;
@@ -105,13 +113,34 @@ public:
                            bool aggregateTrades = true, char eol = '\n', char delim = '\t', char quoteChar = '\0',
                            char escapeChar = '\\', const std::string& nullString = "#N/A");
 
+    //! Set the number of threads used to break the CRIF lines up in to their elements, defaults to 1
+    void setThreads(const QuantLib::Size nThreads) { nThreads_ = std::max<QuantLib::Size>(nThreads, 1); }
+
+    /*! Stream the CRIF one netting set at a time. The input is expected to be sorted by netting set, i.e. by
+        portfolio id and the netting set details. Whenever the netting set changes from one line to the next, the
+        records read so far are passed to \p processBlock as a Crif and released, so that the peak memory is bounded
+        by the largest netting set rather than the whole input. A netting set that appears in several separate runs
+        of lines is passed in several blocks. The bucket mapper is updated per block if requested.
+    */
+    void loadCrifByNettingSet(const std::function<void(Crif&&)>& processBlock);
+
 protected:
     Crif loadCrifImpl() override { return loadFromStream(stream()); }
 
     //! Core CRIF loader from generic istream
     Crif loadFromStream(std::stringstream&& stream);
 
+    /*! Read the lines of \p stream, process the header and pass each further non-empty line broken up into its
+        elements to \p processLine together with the maximum column index and the line number. \p processLine
+        returns true for a valid line.
+    */
+    void readLines(std::istream& stream,
+                   const std::function<bool(const std::vector<std::string>&, QuantLib::Size, QuantLib::Size)>&
+                       processLine);
+
     virtual std::stringstream stream() const = 0;
+    //! The stream read by loadCrifByNettingSet, defaults to stream()
+    virtual std::unique_ptr<std::istream> inputStream() const;
     /*! Internal map from known index of CRIF record member to file column
         For example, give trade ID an index of 0 and find the column index of
         trade ID in the CRIF file e.g. n. The map entry would be [0, n]
@@ -124,15 +153,22 @@ protected:
     //! Process the elements of a header line of a CRIF file
     void processHeader(const std::vector<std::string>& headers);
 
+    /*! The file columns of the portfolio id and the netting set details present in the processed header, resolved
+        from the header names
+    */
+    std::vector<QuantLib::Size> nettingSetColumns() const;
+
     /*! Process a line of a CRIF file and return true if valid line
         or false if an invalid line
     */
-    bool process(const std::vector<std::string>& entries, QuantLib::Size maxIndex, QuantLib::Size currentLine, Crif& result);
+    bool process(const std::vector<std::string>& entries, QuantLib::Size maxIndex, QuantLib::Size currentLine,
+                 CompactCrif& result);
     char eol_;
     char delim_;
     char quoteChar_;
     char escapeChar_;
     std::string nullString_;
+    QuantLib::Size nThreads_ = 1;
 };
 
 class CsvFileCrifLoader : public StringStreamCrifLoader {
@@ -148,6 +184,7 @@ public:
 protected:
     std::string filename_;
     std::stringstream stream() const override;
+    std::unique_ptr<std::istream> inputStream() const override;
 };
 
 class CsvBufferCrifLoader : public StringStreamCrifLoader {
@@ -31,6 +31,9 @@
 #include <ql/math/comparison.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
 
+#include <exception>
+#include <thread>
+
 using std::map;
 using std::pair;
 using std::max;
@@ -55,7 +58,8 @@ IMScheduleCalculator::IMScheduleCalculator(const Crif& crif, const string& calcu
                                            const bool determineWinningRegulations, const bool enforceIMRegulations,
                                            const bool quiet,
                                            const map<SimmSide, set<NettingSetDetails>>& hasSEC,
-                                           const map<SimmSide, set<NettingSetDetails>>& hasCFTC)
+                                           const map<SimmSide, set<NettingSetDetails>>& hasCFTC,
+                                           const QuantLib::Size nThreads)
     : crif_(crif), calculationCcy_(calculationCcy), market_(market), quiet_(quiet),
       hasSEC_(hasSEC), hasCFTC_(hasCFTC) {
 
@@ -63,7 +67,6 @@ IMScheduleCalculator::IMScheduleCalculator(const Crif& crif, const string& calcu
                "The calculation currency (" << calculationCcy_ << ") must be a valid ISO currency code");
 
     QuantLib::Date today = QuantLib::Settings::instance().evaluationDate();
-    QuantLib::DayCounter dayCounter = QuantLib::ActualActual(QuantLib::ActualActual::ISDA);
 
     // Collect Schedule CRIF records
     Crif tmp;
@@ -98,126 +101,75 @@ IMScheduleCalculator::IMScheduleCalculator(const Crif& crif, const string& calcu
     crif_ = tmp;
 
 
-    // Separate out CRIF records by regulations and collect per-trade data
+    // Separate out CRIF records by regulations and collect per-trade data. The end dates and regulation strings
+    // are parsed once, since the distinct values are shared by many records.
     LOG("IMScheduleCalculator: Collecting CRIF trade data");
-    for (const auto& crifRecord : crif_)
-        collectTradeData(crifRecord, enforceIMRegulations);
-
-    // Remove (or modify) trades with incomplete data
-    for (auto& sv : nettingSetRegTradeData_) {
-        const SimmSide& side = sv.first;
-
-        for (auto& nv : sv.second) {
-            const NettingSetDetails& nsd = nv.first;
-
-            for (auto& rv : nv.second) {
-                const string& regulation = rv.first;
-                auto& tradeDataMap = rv.second;
-
-                // Remove (or modify) trades with incomplete Schedule data
-                set<string> tradesToRemove;
-                for (auto& td : tradeDataMap) {
-                    if (td.second.incomplete()) {
-                        auto subFields = map<string, string>({{"tradeId", td.first}});
-                        // If missing PV, assume PV = 0
-                        if (td.second.missingPVData()) {
-                            td.second.presentValue = 0.0;
-                            td.second.presentValueUsd = 0.0;
-                            td.second.presentValueCcy = td.second.notionalCcy;
-                        }
-                        // If missing Notional, do not process the trade
-                        if (td.second.missingNotionalData()) {
-                            ore::analytics::StructuredAnalyticsWarningMessage(
-                                "IMSchedule", "Incomplete CRIF trade data",
-                                "Missing Notional data. The trade will not be processed.", subFields)
-                                .log();
-                            tradesToRemove.insert(td.first);
-                        }
-                    }
-                }
-
-                for (const string& tid : tradesToRemove) {
-                    tradeDataMap.erase(tid);
-                    tradeIds_.at(side).at(nsd).at(regulation).erase(tid);
-                }
+    map<string, QuantLib::Date> endDates;
+    map<string, set<string>> regulations;
+    auto parsedRegulations = [&regulations, enforceIMRegulations](const string& regs) -> const set<string>& {
+        const string& s = enforceIMRegulations ? regs : string();
+        auto it = regulations.find(s);
+        if (it == regulations.end())
+            it = regulations.emplace(s, parseRegulationString(s)).first;
+        return it->second;
+    };
+    for (const auto& crifRecord : crif_) {
+        auto d = endDates.find(crifRecord.endDate);
+        if (d == endDates.end())
+            d = endDates.emplace(crifRecord.endDate, parseDate(crifRecord.endDate)).first;
+        collectTradeData(crifRecord, d->second, parsedRegulations(crifRecord.collectRegulations),
+                         parsedRegulations(crifRecord.postRegulations), enforceIMRegulations);
+    }
 
-                // Calculate Schedule data for each trade data obj
-                for (auto& td : tradeDataMap) {
-                    IMScheduleTradeData& tradeData = td.second;
-
-                    // Calculate gross IM for each IM Schedule trade
-                    tradeData.maturity = dayCounter.yearFraction(today, tradeData.endDate);
-                    tradeData.label = label(tradeData.productClass, tradeData.maturity);
-                    tradeData.labelString = labelString(tradeData.label);
-                    tradeData.multiplier = multiplier(tradeData.label);
-                    tradeData.grossMarginUsd = tradeData.multiplier * tradeData.notionalUsd;
-
-                    // Convert some trade data values into calculation currency
-                    const Real usdSpot = calculationCcy_ != "USD" ? market_->fxRate(calculationCcy_ + "USD")->value() : 1.0;
-                    tradeData.notionalCalc = tradeData.notionalUsd / usdSpot;
-                    tradeData.presentValueCalc = tradeData.presentValueUsd / usdSpot;
-                    tradeData.grossMarginCalc = tradeData.grossMarginUsd / usdSpot;
-                    if (side == SimmSide::Call)
-                        tradeData.collectRegulations = regulation;
-                    if (side == SimmSide::Post)
-                        tradeData.postRegulations = regulation;
-                }
-            }
+    // The FX spot for the conversion into the calculation currency is read once
+    const Real usdSpot = calculationCcy_ != "USD" && !nettingSetRegTradeData_.empty()
+                             ? market_->fxRate(calculationCcy_ + "USD")->value()
+                             : 1.0;
+
+    // Process the netting sets, each netting set only modifies its own entries of the containers, which are
+    // created upfront
+    std::vector<std::pair<SimmSide, const NettingSetDetails*>> tasks;
+    for (auto& [side, nettingSetData] : nettingSetRegTradeData_) {
+        for (auto& [nsd, _] : nettingSetData) {
+            imScheduleResults_[side][nsd];
+            tasks.push_back(std::make_pair(side, &nsd));
         }
     }
 
-    // Some additional processing depending on the regulations applicable to each netting set
-    for (auto& sv : nettingSetRegTradeData_) {
-        const SimmSide& side = sv.first;
-    
-        for (auto& s : sv.second) {
-            const NettingSetDetails& nettingDetails = s.first;
-
-            // Where there is SEC and CFTC in the portfolio, we add the CFTC trades to SEC,
-            // but still continue with CFTC calculations
-            const bool hasCFTCGlobal = hasCFTC_.at(side).find(nettingDetails) != hasCFTC_.at(side).end();
-            const bool hasSECGlobal = hasSEC_.at(side).find(nettingDetails) != hasSEC_.at(side).end();
-            const bool hasCFTCLocal = s.second.count("CFTC") > 0;
-            const bool hasSECLocal = s.second.count("SEC") > 0;
-
-            if ((hasSECLocal && hasCFTCLocal) || (hasCFTCGlobal && hasSECGlobal)) {
-                if (!hasSECLocal && !hasCFTCLocal)
-                    continue;
-
-                if (hasCFTCLocal) {
-                    // At this point, we expect to have CFTC trade data at least for the netting set
-                    const map<string, IMScheduleTradeData>& tradeDataMapCFTC = s.second.at("CFTC");
-                    map<string, IMScheduleTradeData>& tradeDataMapSEC = s.second["SEC"];
-                    for (const auto& kv : tradeDataMapCFTC) {
-                        // Only add CFTC records to SEC if the record was not already in SEC,
-                        // i.e. we skip over CRIF records with regulations specified as e.g. "..., CFTC, SEC, ..."
-                        if (tradeDataMapSEC.find(kv.first) == tradeDataMapSEC.end()) {
-                            tradeDataMapSEC[kv.first] = kv.second;
-                        }
-                    }
+    const QuantLib::Size nWorkers = std::min<QuantLib::Size>(std::max<QuantLib::Size>(nThreads, 1), tasks.size());
+    if (nWorkers <= 1) {
+        for (const auto& [side, nsd] : tasks)
+            processNettingSet(side, *nsd, today, usdSpot);
+    } else {
+        LOG("IMScheduleCalculator: Processing " << tasks.size() << " side-nettingSet combinations on " << nWorkers
+                                                << " threads");
+        std::vector<std::exception_ptr> errors(nWorkers);
+        std::vector<std::thread> workers;
+        for (QuantLib::Size w = 0; w < nWorkers; ++w) {
+            workers.emplace_back([&, w]() {
+                try {
+                    for (QuantLib::Size i = w; i < tasks.size(); i += nWorkers)
+                        processNettingSet(tasks[i].first, *tasks[i].second, today, usdSpot);
+                } catch (...) {
+                    errors[w] = std::current_exception();
                 }
-            }
-
-            // If netting set has "Unspecified" plus other regulations, the "Unspecified" sensis are to be excluded.
-            // If netting set only has "Unspecified", then no regulations were ever specified, so all trades are
-            // included.
-            if (s.second.count("Unspecified") > 0 && s.second.size() > 1)
-                s.second.erase("Unspecified");
+            });
+        }
+        for (auto& t : workers)
+            t.join();
+        for (const auto& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
         }
     }
 
-    // Calculate the higher level margins
-    LOG("IMScheduleCalculator: Populating higher level results")
-    for (const auto& sv : nettingSetRegTradeData_) {
-        const SimmSide side = sv.first;
-
-        for (const auto& nv : sv.second) {
-            const NettingSetDetails& nsd = nv.first;
-
-            for (const auto& rv : nv.second) {
-                const string& regulation = rv.first;
-                populateResults(nsd, regulation, side);
-            }
+    // Drop netting sets without any results, e.g. if all trades were removed
+    for (auto& [side, nettingSetResults] : imScheduleResults_) {
+        for (auto it = nettingSetResults.begin(); it != nettingSetResults.end();) {
+            if (it->second.empty())
+                it = nettingSetResults.erase(it);
+            else
+                ++it;
         }
     }
 
@@ -387,7 +339,102 @@ const string IMScheduleCalculator::labelString(const IMScheduleLabel& label) {
     return labelStringMap_.at(label);
 }
 
-void IMScheduleCalculator::collectTradeData(const CrifRecord& cr, const bool enforceIMRegulations) {
+void IMScheduleCalculator::processNettingSet(const SimmSide& side, const NettingSetDetails& nsd,
+                                             const QuantLib::Date& today, const Real usdSpot) {
+
+    QuantLib::DayCounter dayCounter = QuantLib::ActualActual(QuantLib::ActualActual::ISDA);
+    auto& regTradeData = nettingSetRegTradeData_.at(side).at(nsd);
+
+    for (auto& rv : regTradeData) {
+        const string& regulation = rv.first;
+        auto& tradeDataMap = rv.second;
+
+        // Remove (or modify) trades with incomplete Schedule data
+        set<string> tradesToRemove;
+        for (auto& td : tradeDataMap) {
+            if (td.second.incomplete()) {
+                auto subFields = map<string, string>({{"tradeId", td.first}});
+                // If missing PV, assume PV = 0
+                if (td.second.missingPVData()) {
+                    td.second.presentValue = 0.0;
+                    td.second.presentValueUsd = 0.0;
+                    td.second.presentValueCcy = td.second.notionalCcy;
+                }
+                // If missing Notional, do not process the trade
+                if (td.second.missingNotionalData()) {
+                    ore::analytics::StructuredAnalyticsWarningMessage(
+                        "IMSchedule", "Incomplete CRIF trade data",
+                        "Missing Notional data. The trade will not be processed.", subFields)
+                        .log();
+                    tradesToRemove.insert(td.first);
+                }
+            }
+        }
+
+        for (const string& tid : tradesToRemove) {
+            tradeDataMap.erase(tid);
+            tradeIds_.at(side).at(nsd).at(regulation).erase(tid);
+        }
+
+        // Calculate Schedule data for each trade data obj
+        for (auto& td : tradeDataMap) {
+            IMScheduleTradeData& tradeData = td.second;
+
+            // Calculate gross IM for each IM Schedule trade
+            tradeData.maturity = dayCounter.yearFraction(today, tradeData.endDate);
+            tradeData.label = label(tradeData.productClass, tradeData.maturity);
+            tradeData.labelString = labelString(tradeData.label);
+            tradeData.multiplier = multiplier(tradeData.label);
+            tradeData.grossMarginUsd = tradeData.multiplier * tradeData.notionalUsd;
+
+            // Convert some trade data values into calculation currency
+            tradeData.notionalCalc = tradeData.notionalUsd / usdSpot;
+            tradeData.presentValueCalc = tradeData.presentValueUsd / usdSpot;
+            tradeData.grossMarginCalc = tradeData.grossMarginUsd / usdSpot;
+            if (side == SimmSide::Call)
+                tradeData.collectRegulations = regulation;
+            if (side == SimmSide::Post)
+                tradeData.postRegulations = regulation;
+        }
+    }
+
+    // Where there is SEC and CFTC in the portfolio, we add the CFTC trades to SEC,
+    // but still continue with CFTC calculations
+    const bool hasCFTCGlobal = hasCFTC_.at(side).find(nsd) != hasCFTC_.at(side).end();
+    const bool hasSECGlobal = hasSEC_.at(side).find(nsd) != hasSEC_.at(side).end();
+    const bool hasCFTCLocal = regTradeData.count("CFTC") > 0;
+    const bool hasSECLocal = regTradeData.count("SEC") > 0;
+
+    const bool hasSECAndCFTC = (hasSECLocal && hasCFTCLocal) || (hasCFTCGlobal && hasSECGlobal);
+
+    if (hasSECAndCFTC && hasCFTCLocal) {
+        // At this point, we expect to have CFTC trade data at least for the netting set
+        const map<string, IMScheduleTradeData>& tradeDataMapCFTC = regTradeData.at("CFTC");
+        map<string, IMScheduleTradeData>& tradeDataMapSEC = regTradeData["SEC"];
+        for (const auto& kv : tradeDataMapCFTC) {
+            // Only add CFTC records to SEC if the record was not already in SEC,
+            // i.e. we skip over CRIF records with regulations specified as e.g. "..., CFTC, SEC, ..."
+            if (tradeDataMapSEC.find(kv.first) == tradeDataMapSEC.end()) {
+                tradeDataMapSEC[kv.first] = kv.second;
+            }
+        }
+    }
+
+    // If netting set has "Unspecified" plus other regulations, the "Unspecified" sensis are to be excluded.
+    // If netting set only has "Unspecified", then no regulations were ever specified, so all trades are
+    // included. As before, this is skipped for netting sets with SEC and CFTC globally but neither of them locally.
+    if (!(hasSECAndCFTC && !hasSECLocal && !hasCFTCLocal) && regTradeData.count("Unspecified") > 0 &&
+        regTradeData.size() > 1)
+        regTradeData.erase("Unspecified");
+
+    // Calculate the higher level margins
+    for (const auto& rv : regTradeData)
+        populateResults(nsd, rv.first, side);
+}
+
+void IMScheduleCalculator::collectTradeData(const CrifRecord& cr, const QuantLib::Date& endDate,
+                                            const set<string>& collectRegs, const set<string>& postRegs,
+                                            const bool enforceIMRegulations) {
 
     DLOG("Processing CRIF record for IMSchedule calculation: trade ID \'"
          << cr.tradeId << "\', portfolio [" << cr.nettingSetDetails << "], product class " << cr.productClass
@@ -405,10 +452,7 @@ void IMScheduleCalculator::collectTradeData(const CrifRecord& cr, const bool enf
         if (postRegsIsEmpty_.find(cr.nettingSetDetails) != postRegsIsEmpty_.end())
             postRegsIsEmpty = postRegsIsEmpty_.at(cr.nettingSetDetails);
 
-        string regsString;
-        if (enforceIMRegulations)
-            regsString = side == SimmSide::Call ? cr.collectRegulations : cr.postRegulations;
-        set<string> regs = parseRegulationString(regsString);
+        const set<string>& regs = side == SimmSide::Call ? collectRegs : postRegs;
 
         for (const string& r : regs) {
             if (r == "Unspecified" && enforceIMRegulations && !(collectRegsIsEmpty && postRegsIsEmpty)) {
@@ -425,9 +469,8 @@ void IMScheduleCalculator::collectTradeData(const CrifRecord& cr, const bool enf
                     QL_REQUIRE(cr.productClass == tradeData.productClass, "Product class is not matching for trade ID "
                                                                               << cr.tradeId << ": " << cr.productClass
                                                                               << " and " << tradeData.productClass);
-                    QuantLib::Date incomingDate = parseDate(cr.endDate);
-                    QL_REQUIRE(incomingDate == tradeData.endDate, "End date is not matching for trade ID "
-                                                                      << cr.tradeId << ": " << incomingDate << " and "
+                    QL_REQUIRE(endDate == tradeData.endDate, "End date is not matching for trade ID "
+                                                                 << cr.tradeId << ": " << endDate << " and "
                                                                       << tradeData.endDate);
                     if (cr.riskType == RiskType::PV) {
                         QL_REQUIRE(tradeData.missingPVData(), "Adding PV data for trade that already has PV data, i.e. "
@@ -446,12 +489,12 @@ void IMScheduleCalculator::collectTradeData(const CrifRecord& cr, const bool enf
                         tradeData.notionalCcy = cr.amountCurrency;
                     }
                 } else {
-                    const string collectRegs = side == SimmSide::Call ? cr.collectRegulations : "";
-                    const string postRegs = side == SimmSide::Post ? cr.postRegulations : "";
+                    const string collectRegsString = side == SimmSide::Call ? cr.collectRegulations : "";
+                    const string postRegsString = side == SimmSide::Post ? cr.postRegulations : "";
                     tradeDataMap.insert(
                         {cr.tradeId, IMScheduleTradeData(cr.tradeId, cr.nettingSetDetails, cr.riskType, cr.productClass,
                                                          cr.amount, cr.amountCurrency, cr.amountUsd,
-                                                         parseDate(cr.endDate), calculationCcy_, collectRegs, postRegs)});
+                                                         endDate, calculationCcy_, collectRegsString, postRegsString)});
                 }
             }
         }
@@ -578,7 +621,9 @@ void IMScheduleCalculator::add(const SimmSide& side, const NettingSetDetails& ns
                                const Real& netRC, const Real& ngr, const Real& scheduleIM) {
     
     QuantLib::Real netToGrossRatio = ngr != Null<Real>() && close_enough(ngr, 0.0) ? 0.0 : ngr;
-    imScheduleResults_[side][nsd][regulation].add(pc, calcCcy, grossIM, grossRC, netRC, netToGrossRatio, scheduleIM);
+    // The side and netting set entries are created upfront, only the netting set's own map is modified here
+    imScheduleResults_.at(side).at(nsd)[regulation].add(pc, calcCcy, grossIM, grossRC, netRC, netToGrossRatio,
+                                                        scheduleIM);
 }
 
 } // namespace analytics
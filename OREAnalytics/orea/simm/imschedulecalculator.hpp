@@ -106,7 +106,11 @@ public:
               endDate(QuantLib::Date()), calculationCcy(""), collectRegulations(""), postRegulations("") {}
     };
 
-    //! Construct the IMScheduleCalculator from a container of netted CRIF records.
+    /*! Construct the IMScheduleCalculator from a container of netted CRIF records.
+
+        If \p nThreads is greater than one, the netting sets are processed on up to \p nThreads threads. The results
+        are identical to the single threaded calculation.
+    */
     IMScheduleCalculator(const Crif& crif, const std::string& calculationCcy = "USD",
                          const QuantLib::ext::shared_ptr<ore::data::Market> market = nullptr,
                          const bool determineWinningRegulations = true, const bool enforceIMRegulations = false,
@@ -114,7 +118,8 @@ public:
                          const std::map<SimmSide, std::set<NettingSetDetails>>& hasSEC =
                              std::map<SimmSide, std::set<NettingSetDetails>>(),
                          const std::map<SimmSide, std::set<NettingSetDetails>>& hasCFTC =
-                             std::map<SimmSide, std::set<NettingSetDetails>>());
+                             std::map<SimmSide, std::set<NettingSetDetails>>(),
+                         const QuantLib::Size nThreads = 1);
 
     //! Give back the set of portfolio IDs and trade IDs for which we have IM results
     //const std::set<std::string>& tradeIds() const { return tradeIds_; }
@@ -217,10 +222,19 @@ private:
         // clang-format on
     });
 
-    QuantLib::Real multiplier(const IMScheduleLabel& label) { return multiplierMap_[label]; }
+    QuantLib::Real multiplier(const IMScheduleLabel& label) const { return multiplierMap_.at(label); }
 
-    //! Collect trade data as defined by the CRIF records
-    void collectTradeData(const CrifRecord& cr, const bool enforceIMRegulations);
+    /*! Collect trade data as defined by the CRIF records, with the record's end date and collect / post regulations
+        already parsed
+    */
+    void collectTradeData(const CrifRecord& cr, const QuantLib::Date& endDate, const std::set<std::string>& collectRegs,
+                          const std::set<std::string>& postRegs, const bool enforceIMRegulations);
+
+    /*! Calculate the trade level Schedule data and the higher level results for one side and netting set. This only
+        modifies the entries of the given netting set in the containers.
+    */
+    void processNettingSet(const SimmSide& side, const ore::data::NettingSetDetails& nsd, const QuantLib::Date& today,
+                           const QuantLib::Real usdSpot);
 
     /*! Populate the results structure with the higher level results after the IMs have been
         calculated at the (product class, maturity) level for each portfolio
@@ -25,6 +25,7 @@
 #include <orea/simm/crif.hpp>
 #include <ql/time/date.hpp>
 
+#include <cstddef>
 #include <string>
 
 namespace ore {
@@ -64,6 +65,12 @@ public:
 
     virtual const std::set<FailedMapping>& failedMappings() const = 0;
 
+    /*! A counter that changes whenever the mappings change, so that bucket dependent lookups, e.g. the risk weights
+        and concentration thresholds of a SIMM configuration, can be cached. Implementations whose mappings can change
+        must override this, the default is for fixed mappings.
+    */
+    virtual std::size_t version() const { return 0; }
+
     void updateFromCrif(const ore::analytics::Crif& crif) {
         for (const auto& cr : crif) {
             if (!cr.isSimmParameter() && hasBuckets(cr.riskType)) {
@@ -87,6 +87,14 @@ QuantLib::Date BucketMapping::validFromDate() const {
 string SimmBucketMapperBase::bucket(const RiskType& riskType, const string& qualifier) const {
 
     auto key = std::make_pair(riskType, qualifier);
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cacheMutex_);
+        if (auto b = cache_.find(key); b != cache_.end())
+            return b->second;
+    }
+
+    // Cache miss, the lookup below is serialised since it updates the cache and the failed mappings
+    boost::unique_lock<boost::shared_mutex> lock(cacheMutex_);
     if (auto b = cache_.find(key); b != cache_.end())
         return b->second;
 
@@ -324,6 +332,7 @@ void SimmBucketMapperBase::addMapping(const RiskType& riskType, const string& qu
                                       const string& validFrom, const string& validTo, bool fallback) {
 
     cache_.clear();
+    ++version_;
 
     // Possibly map to non-vol counterpart for lookup
     RiskType rt = riskType;
@@ -387,6 +396,7 @@ void SimmBucketMapperBase::checkRiskType(const RiskType& riskType) const {
 
 void SimmBucketMapperBase::reset() {
     cache_.clear();
+    ++version_;
     // Clear the bucket mapper and add back the commodity mappings
     bucketMapping_.clear();
     failedMappings_.clear();
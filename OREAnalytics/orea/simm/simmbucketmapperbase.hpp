@@ -28,6 +28,9 @@
 #include <ored/utilities/xmlutils.hpp>
 #include <ored/portfolio/referencedata.hpp>
 
+#include <boost/thread/shared_mutex.hpp>
+
+#include <atomic>
 #include <map>
 #include <set>
 #include <string>
@@ -97,6 +100,8 @@ public:
 
     const std::set<FailedMapping>& failedMappings() const override { return failedMappings_; }
 
+    std::size_t version() const override { return version_; }
+
 protected:
     /*! Simple logic for RiskType Risk_IRCurve. Qualifier is a currency code and
         this is checked here.
@@ -117,6 +122,9 @@ protected:
 private:
     mutable std::map<std::pair<CrifRecord::RiskType, std::string>, std::string> cache_;
 
+    //! Guards cache_ and failedMappings_, bucket() may be called concurrently by the SIMM calculator
+    mutable boost::shared_mutex cacheMutex_;
+
     //! Reset the SIMM bucket mapper i.e. clears all mappings and adds the initial hard-coded commodity mappings
     void reset();
 
@@ -127,6 +135,9 @@ private:
     QuantLib::ext::shared_ptr<SimmBasicNameMapper> nameMapper_;
 
     mutable std::set<FailedMapping> failedMappings_;
+
+    //! Incremented on every change of the mappings
+    std::atomic<std::size_t> version_{0};
 };
 
 } // namespace analytics
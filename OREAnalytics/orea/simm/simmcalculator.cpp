@@ -22,12 +22,15 @@
 #include <orea/simm/utilities.hpp>
 #include <orea/simm/simmconfigurationbase.hpp>
 
+#include <algorithm>
 #include <boost/math/distributions/normal.hpp>
 #include <numeric>
+#include <thread>
 #include <ored/portfolio/structuredtradewarning.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/to_string.hpp>
 #include <ored/utilities/parsers.hpp>
+#include <ql/math/array.hpp>
 #include <ql/math/comparison.hpp>
 #include <ql/quote.hpp>
 
@@ -42,14 +45,19 @@ using std::pair;
 using std::set;
 using std::sqrt;
 using std::string;
+using std::vector;
 
 using ore::data::checkCurrency;
 using ore::data::NettingSetDetails;
 using ore::data::Market;
 using ore::data::to_string;
 using ore::data::parseBool;
+using QuantLib::Array;
 using QuantLib::close_enough;
+using QuantLib::Matrix;
+using QuantLib::Null;
 using QuantLib::Real;
+using QuantLib::Size;
 
 namespace ore {
 namespace analytics {
@@ -62,16 +70,29 @@ typedef CrifRecord::RiskType RiskType;
 typedef SimmConfiguration::Regulation Regulation;
 typedef SimmConfiguration::SimmSide SimmSide;
 
+namespace {
+
+// Derivatives of a bucket margin $K_b$ and of the bucket's sum of weighted sensitivities with respect to the amount
+// in result currency of one of the bucket's records
+struct BucketGradient {
+    CrifRecord::SimmAmountCcyKey key;
+    Real dK;
+    Real dSumWs;
+};
+
+} // namespace
+
 SimmCalculator::SimmCalculator(const ore::analytics::Crif& crif,
                                const QuantLib::ext::shared_ptr<SimmConfiguration>& simmConfiguration,
                                const string& calculationCcyCall, const string& calculationCcyPost,
                                const string& resultCcy, const QuantLib::ext::shared_ptr<Market> market,
                                const bool determineWinningRegulations, const bool enforceIMRegulations,
                                const bool quiet, const map<SimmSide, set<NettingSetDetails>>& hasSEC,
-                               const map<SimmSide, set<NettingSetDetails>>& hasCFTC)
+                               const map<SimmSide, set<NettingSetDetails>>& hasCFTC, const Size nThreads)
     : simmConfiguration_(simmConfiguration), calculationCcyCall_(calculationCcyCall),
       calculationCcyPost_(calculationCcyPost), resultCcy_(resultCcy.empty() ? calculationCcyCall_ : resultCcy),
-      market_(market), quiet_(quiet), hasSEC_(hasSEC), hasCFTC_(hasCFTC) {
+      market_(market), quiet_(quiet), enforceIMRegulations_(enforceIMRegulations), hasSEC_(hasSEC),
+      hasCFTC_(hasCFTC) {
 
     QL_REQUIRE(checkCurrency(calculationCcyCall_), "SIMM Calculator: The Call side calculation currency ("
                                                    << calculationCcyCall_ << ") must be a valid ISO currency code");
@@ -109,19 +130,7 @@ SimmCalculator::SimmCalculator(const ore::analytics::Crif& crif,
         }
 
         // Make sure we have CRIF amount denominated in the result ccy
-        CrifRecord newCrifRecord = cr;
-        
-        if (cr.requiresAmountUsd() && resultCcy_ == "USD" && cr.hasAmountUsd()) {
-            newCrifRecord.amountResultCcy = newCrifRecord.amountUsd;
-        } else if(cr.requiresAmountUsd()) {
-            // ProductClassMultiplier and AddOnNotionalFactor  don't have a currency and dont need to be converted,
-            // we use the amount
-            const Real fxSpot = market_->fxRate(newCrifRecord.amountCurrency + resultCcy_)->value();
-            newCrifRecord.amountResultCcy = fxSpot * newCrifRecord.amount;
-        }
-        newCrifRecord.resultCurrency = resultCcy_;
-
-        crif_.addRecord(newCrifRecord);
+        crif_.addRecord(resultCcyRecord(cr));
     }
 
     // If there are no CRIF records to process
@@ -133,7 +142,7 @@ SimmCalculator::SimmCalculator(const ore::analytics::Crif& crif,
         LOG("SimmCalculator: Splitting up original CRIF records into their respective collect/post regulations");
     }
     
-    splitCrifByRegulationsAndPortfolios(crif_, enforceIMRegulations);
+    splitCrifByRegulationsAndPortfolios(crif_);
 
     // Some additional processing depending on the regulations applicable to each netting set
     for (auto& [side, nettingsSetCrifMap] : regSensitivities_) {
@@ -185,10 +194,20 @@ SimmCalculator::SimmCalculator(const ore::analytics::Crif& crif,
         }
     }
 
-    // Calculate SIMM call and post for each regulation under each netting set
+    // Read the FX spot for the concentration thresholds once, the market is not accessed during the calculation
+    if (resultCcy_ != "USD" && market_)
+        usdSpot_ = market_->fxRate("USD" + resultCcy_)->value();
+
+    // Collect the side-nettingSet-regulation combinations for which SIMM is calculated
+    struct Task {
+        SimmSide side;
+        const NettingSetDetails* nsd;
+        const string* regulation;
+        const Crif* crif;
+    };
+    std::vector<Task> tasks;
     for (const auto& [side, nettingSetRegulationCrifMap] : regSensitivities_) {
         for (const auto& [nsd, regulationCrifMap] : nettingSetRegulationCrifMap) {
-            // Calculate SIMM for particular side-nettingSet-regulation combination
             for (const auto& [regulation, crif] : regulationCrifMap) {
                 bool hasFixedAddOn = false;
                 for (const auto& sp : crif) {
@@ -198,11 +217,51 @@ SimmCalculator::SimmCalculator(const ore::analytics::Crif& crif,
                     }
                 }
                 if (crif.hasCrifRecords() || hasFixedAddOn)
-                    calculateRegulationSimm(crif, nsd, regulation, side);
+                    tasks.push_back({side, &nsd, &regulation, &crif});
             }
         }
     }
 
+    // Calculate SIMM call and post for each regulation under each netting set
+    const Size nWorkers = std::min<Size>(std::max<Size>(nThreads, 1), tasks.size());
+    if (nWorkers <= 1) {
+        for (const auto& t : tasks)
+            calculateRegulationSimm(*t.crif, *t.nsd, *t.regulation, t.side, simmParameters_);
+    } else {
+        if (!quiet_) {
+            LOG("SimmCalculator: Calculating SIMM for " << tasks.size() << " side-nettingSet-regulation combinations on "
+                                                        << nWorkers << " threads");
+        }
+        // Create all result containers upfront, so that the workers only modify their own SimmResults
+        for (const auto& t : tasks)
+            simmResults_[t.side][*t.nsd][*t.regulation];
+        std::vector<Crif> taskSimmParameters(tasks.size());
+        std::vector<std::exception_ptr> errors(nWorkers);
+        std::vector<std::thread> workers;
+        for (Size w = 0; w < nWorkers; ++w) {
+            workers.emplace_back([&, w]() {
+                try {
+                    for (Size i = w; i < tasks.size(); i += nWorkers)
+                        calculateRegulationSimm(*tasks[i].crif, *tasks[i].nsd, *tasks[i].regulation, tasks[i].side,
+                                                taskSimmParameters[i]);
+                } catch (...) {
+                    errors[w] = std::current_exception();
+                }
+            });
+        }
+        for (auto& t : workers)
+            t.join();
+        for (const auto& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+        // Merge the SIMM parameters in the order of the sequential calculation
+        for (const auto& sp : taskSimmParameters) {
+            for (const auto& cr : sp)
+                simmParameters_.addRecord(cr);
+        }
+    }
+
     // Determine winning call and post regulations
     if (determineWinningRegulations) {
         if (!quiet_) {
@@ -251,129 +310,126 @@ SimmCalculator::SimmCalculator(const ore::analytics::Crif& crif,
 const void SimmCalculator::calculateRegulationSimm(const Crif& crif,
                                                    const NettingSetDetails& nettingSetDetails, const string& regulation,
                                                    const SimmSide& side) {
+    if (resultCcy_ != "USD" && market_ && usdSpot_ == Null<Real>())
+        usdSpot_ = market_->fxRate("USD" + resultCcy_)->value();
+    calculateRegulationSimm(crif, nettingSetDetails, regulation, side, simmParameters_);
+}
+
+void SimmCalculator::calculateRegulationSimm(const Crif& crif, const NettingSetDetails& nettingSetDetails,
+                                             const string& regulation, const SimmSide& side, Crif& simmParameters) {
 
     if (!quiet_) {
         LOG("SimmCalculator: Calculating SIMM " << side << " for portfolio [" << nettingSetDetails << "], regulation "
                                                 << regulation);
     }
-    // Loop over portfolios and product classes
-   for(const auto  productClass : crif.ProductClassesByNettingSetDetails(nettingSetDetails)){
-        if (!quiet_) {
-            LOG("SimmCalculator: Calculating SIMM for product class " << productClass);
-        }
-
-        // Delta margin components
-        RiskClass rc = RiskClass::InterestRate;
-        MarginType mt = MarginType::Delta;
-        auto p = irDeltaMargin(nettingSetDetails, productClass, crif, side);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
-
-        rc = RiskClass::FX;
-        p = margin(nettingSetDetails, productClass, RiskType::FX, crif, side);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
-
-        rc = RiskClass::CreditQualifying;
-        p = margin(nettingSetDetails, productClass, RiskType::CreditQ, crif, side);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
-
-        rc = RiskClass::CreditNonQualifying;
-        p = margin(nettingSetDetails, productClass, RiskType::CreditNonQ, crif, side);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
-
-        rc = RiskClass::Equity;
-        p = margin(nettingSetDetails, productClass, RiskType::Equity, crif, side);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
-
-        rc = RiskClass::Commodity;
-        p = margin(nettingSetDetails, productClass, RiskType::Commodity, crif, side);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
-
-        // Vega margin components
-        mt = MarginType::Vega;
-        rc = RiskClass::InterestRate;
-        p = irVegaMargin(nettingSetDetails, productClass, crif, side);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
-
-        rc = RiskClass::FX;
-        p = margin(nettingSetDetails, productClass, RiskType::FXVol, crif, side);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
-
-        rc = RiskClass::CreditQualifying;
-        p = margin(nettingSetDetails, productClass, RiskType::CreditVol, crif, side);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
 
-        rc = RiskClass::CreditNonQualifying;
-        p = margin(nettingSetDetails, productClass, RiskType::CreditVolNonQ, crif, side);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
-
-        rc = RiskClass::Equity;
-        p = margin(nettingSetDetails, productClass, RiskType::EquityVol, crif, side);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
-
-        rc = RiskClass::Commodity;
-        p = margin(nettingSetDetails, productClass, RiskType::CommodityVol, crif, side);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
+    // Reference to SIMM results for this portfolio
+    auto& results = simmResults_[side][nettingSetDetails][regulation];
 
-        // Curvature margin components for sides call and post
-        mt = MarginType::Curvature;
-        rc = RiskClass::InterestRate;
+    // Loop over portfolios and product classes
+    const auto riskClasses = SimmConfiguration::riskClasses(false);
+    for (const auto productClass : crif.ProductClassesByNettingSetDetails(nettingSetDetails))
+        calculateMargins(results, crif, nettingSetDetails, side, productClass, riskClasses);
 
-        p = irCurvatureMargin(nettingSetDetails, productClass, side, crif);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
+    // Calculate the higher level margins
+    populateResults(results, side, nettingSetDetails);
 
-        rc = RiskClass::FX;
-        p = curvatureMargin(nettingSetDetails, productClass, RiskType::FXVol, side, crif, false);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
+    // For each portfolio, calculate the additional margin
+    calcAddMargin(results, side, nettingSetDetails, regulation, crif, simmParameters);
+}
 
-        rc = RiskClass::CreditQualifying;
-        p = curvatureMargin(nettingSetDetails, productClass, RiskType::CreditVol, side, crif);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
+void SimmCalculator::calculateMargins(SimmResults& results, const Crif& crif,
+                                      const NettingSetDetails& nettingSetDetails, const SimmSide& side,
+                                      const ProductClass& productClass, const set<RiskClass>& riskClasses,
+                                      map<pair<RiskClass, MarginType>, Gradients>* gradients) const {
 
-        rc = RiskClass::CreditNonQualifying;
-        p = curvatureMargin(nettingSetDetails, productClass, RiskType::CreditVolNonQ, side, crif);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
+    if (!quiet_) {
+        LOG("SimmCalculator: Calculating SIMM for product class " << productClass);
+    }
 
-        rc = RiskClass::Equity;
-        p = curvatureMargin(nettingSetDetails, productClass, RiskType::EquityVol, side, crif, false);
+    auto addMargins = [&](const RiskClass& rc, const MarginType& mt, const pair<map<string, Real>, bool>& p) {
         if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
+            add(results, nettingSetDetails, productClass, rc, mt, p.first, side);
+    };
+
+    // Gradients container for the given risk class and margin type, if gradients are requested
+    auto g = [&gradients](const RiskClass& rc, const MarginType& mt) -> Gradients* {
+        return gradients ? &(*gradients)[make_pair(rc, mt)] : nullptr;
+    };
+
+    // Delta, vega and curvature margin components for each risk class
+    if (riskClasses.count(RiskClass::InterestRate) > 0) {
+        const RiskClass rc = RiskClass::InterestRate;
+        addMargins(rc, MarginType::Delta,
+                   irDeltaMargin(nettingSetDetails, productClass, crif, side, g(rc, MarginType::Delta)));
+        addMargins(rc, MarginType::Vega,
+                   irVegaMargin(nettingSetDetails, productClass, crif, side, g(rc, MarginType::Vega)));
+        addMargins(rc, MarginType::Curvature,
+                   irCurvatureMargin(nettingSetDetails, productClass, side, crif, g(rc, MarginType::Curvature)));
+    }
 
-        rc = RiskClass::Commodity;
-        p = curvatureMargin(nettingSetDetails, productClass, RiskType::CommodityVol, side, crif, false);
-        if (p.second)
-            add(nettingSetDetails, regulation, productClass, rc, mt, p.first, side);
+    if (riskClasses.count(RiskClass::FX) > 0) {
+        const RiskClass rc = RiskClass::FX;
+        addMargins(rc, MarginType::Delta,
+                   margin(nettingSetDetails, productClass, RiskType::FX, crif, side, g(rc, MarginType::Delta)));
+        addMargins(rc, MarginType::Vega,
+                   margin(nettingSetDetails, productClass, RiskType::FXVol, crif, side, g(rc, MarginType::Vega)));
+        addMargins(rc, MarginType::Curvature,
+                   curvatureMargin(nettingSetDetails, productClass, RiskType::FXVol, side, crif, false,
+                                   g(rc, MarginType::Curvature)));
+    }
 
+    if (riskClasses.count(RiskClass::CreditQualifying) > 0) {
+        const RiskClass rc = RiskClass::CreditQualifying;
+        addMargins(rc, MarginType::Delta,
+                   margin(nettingSetDetails, productClass, RiskType::CreditQ, crif, side, g(rc, MarginType::Delta)));
+        addMargins(rc, MarginType::Vega,
+                   margin(nettingSetDetails, productClass, RiskType::CreditVol, crif, side, g(rc, MarginType::Vega)));
+        addMargins(rc, MarginType::Curvature,
+                   curvatureMargin(nettingSetDetails, productClass, RiskType::CreditVol, side, crif, true,
+                                   g(rc, MarginType::Curvature)));
         // Base correlation margin components. This risk type came later so need to check
         // first if it is valid under the configuration
-        if (simmConfiguration_->isValidRiskType(RiskType::BaseCorr)) {
-            p = margin(nettingSetDetails, productClass, RiskType::BaseCorr, crif, side);
-            if (p.second)
-                add(nettingSetDetails, regulation, productClass, RiskClass::CreditQualifying, MarginType::BaseCorr,
-                    p.first, side);
-        }
+        if (simmConfiguration_->isValidRiskType(RiskType::BaseCorr))
+            addMargins(rc, MarginType::BaseCorr,
+                       margin(nettingSetDetails, productClass, RiskType::BaseCorr, crif, side,
+                              g(rc, MarginType::BaseCorr)));
     }
 
-    // Calculate the higher level margins
-    populateResults(side, nettingSetDetails, regulation);
+    if (riskClasses.count(RiskClass::CreditNonQualifying) > 0) {
+        const RiskClass rc = RiskClass::CreditNonQualifying;
+        addMargins(rc, MarginType::Delta,
+                   margin(nettingSetDetails, productClass, RiskType::CreditNonQ, crif, side, g(rc, MarginType::Delta)));
+        addMargins(rc, MarginType::Vega,
+                   margin(nettingSetDetails, productClass, RiskType::CreditVolNonQ, crif, side,
+                          g(rc, MarginType::Vega)));
+        addMargins(rc, MarginType::Curvature,
+                   curvatureMargin(nettingSetDetails, productClass, RiskType::CreditVolNonQ, side, crif, true,
+                                   g(rc, MarginType::Curvature)));
+    }
 
-    // For each portfolio, calculate the additional margin
-    calcAddMargin(side, nettingSetDetails, regulation, crif);
+    if (riskClasses.count(RiskClass::Equity) > 0) {
+        const RiskClass rc = RiskClass::Equity;
+        addMargins(rc, MarginType::Delta,
+                   margin(nettingSetDetails, productClass, RiskType::Equity, crif, side, g(rc, MarginType::Delta)));
+        addMargins(rc, MarginType::Vega,
+                   margin(nettingSetDetails, productClass, RiskType::EquityVol, crif, side, g(rc, MarginType::Vega)));
+        addMargins(rc, MarginType::Curvature,
+                   curvatureMargin(nettingSetDetails, productClass, RiskType::EquityVol, side, crif, false,
+                                   g(rc, MarginType::Curvature)));
+    }
+
+    if (riskClasses.count(RiskClass::Commodity) > 0) {
+        const RiskClass rc = RiskClass::Commodity;
+        addMargins(rc, MarginType::Delta,
+                   margin(nettingSetDetails, productClass, RiskType::Commodity, crif, side, g(rc, MarginType::Delta)));
+        addMargins(rc, MarginType::Vega,
+                   margin(nettingSetDetails, productClass, RiskType::CommodityVol, crif, side,
+                          g(rc, MarginType::Vega)));
+        addMargins(rc, MarginType::Curvature,
+                   curvatureMargin(nettingSetDetails, productClass, RiskType::CommodityVol, side, crif, false,
+                                   g(rc, MarginType::Curvature)));
+    }
 }
 
 const string& SimmCalculator::winningRegulations(const SimmSide& side, const NettingSetDetails& nettingSetDetails) const {
@@ -443,7 +499,7 @@ const map<SimmSide, map<NettingSetDetails, pair<string, SimmResults>>>& SimmCalc
 
 pair<map<string, Real>, bool> SimmCalculator::irDeltaMargin(const NettingSetDetails& nettingSetDetails,
                                                             const ProductClass& pc, const Crif& crif,
-                                                            const SimmSide& side) const {
+                                                            const SimmSide& side, Gradients* gradients) const {
     const string& calcCcy = side == SimmSide::Call ? calculationCcyCall_ : calculationCcyPost_;
 
     // "Bucket" here referse to exposures under the CRIF qualifiers
@@ -465,8 +521,9 @@ pair<map<string, Real>, bool> SimmCalculator::irDeltaMargin(const NettingSetDeta
     map<string, Real> deltaMargin;
     // The sum of the weighted sensitivities for each currency i.e. $\sum_{i,k} WS_{k,i}$ from SIMM docs
     map<string, Real> sumWeightedSensis;
+    // The derivatives of $K_b$ for each currency, if gradients are requested
+    map<string, vector<BucketGradient>> bucketGradients;
 
-    // Loop over the qualifiers i.e. currencies
     // Loop over the qualifiers i.e. currencies
     for (const auto& qualifier : qualifiers) {
         // Pair of iterators to start and end of IRCurve sensitivities with current qualifier
@@ -500,41 +557,33 @@ pair<map<string, Real>, bool> SimmCalculator::irDeltaMargin(const NettingSetDeta
         // Divide by the concentration risk threshold
         Real concThreshold = simmConfiguration_->concentrationThreshold(RiskType::IRCurve, qualifier);
         if (resultCcy_ != "USD")
-            concThreshold *= market_->fxRate("USD" + resultCcy_)->value();
+            concThreshold *= concentrationThresholdFx();
         concentrationRisk[qualifier] /= concThreshold;
         // Final concentration risk amount
         concentrationRisk[qualifier] = max(1.0, sqrt(std::abs(concentrationRisk[qualifier])));
 
-        // Calculate the delta margin piece for this qualifier i.e. $K_b$ from SIMM docs
-        for (auto itOuter = pIrQualifier.begin(); itOuter != pIrQualifier.end(); ++itOuter) {
-            // Risk weight i.e. $RW_k$ from SIMM docs
-            Real rwOuter = simmConfiguration_->weight(RiskType::IRCurve, qualifier, itOuter->label1);
-            // Weighted sensitivity i.e. $WS_{k,i}$ from SIMM docs
-            Real wsOuter = rwOuter * itOuter->amountResultCcy * concentrationRisk[qualifier];
+        // Weighted sensitivities i.e. $WS_{k,i}$ from SIMM docs, with risk weight $RW_k$
+        vector<const CrifRecord*> irRecords;
+        vector<Real> irWs, irRws;
+        for (const auto& it : pIrQualifier) {
+            Real rw = simmConfiguration_->weight(RiskType::IRCurve, qualifier, it.label1, calcCcy);
+            irRecords.push_back(&it);
+            irWs.push_back(rw * it.amountResultCcy * concentrationRisk[qualifier]);
+            irRws.push_back(rw);
             // Update weighted sensitivity sum
-            sumWeightedSensis[qualifier] += wsOuter;
-            // Add diagonal element to delta margin
-            deltaMargin[qualifier] += wsOuter * wsOuter;
-            // Add the cross elements to the delta margin
-            for (auto itInner = pIrQualifier.begin(); itInner != itOuter; ++itInner) {
-                // Label2 level correlation i.e. $\phi_{i,j}$ from SIMM docs
-                Real subCurveCorr = simmConfiguration_->correlation(RiskType::IRCurve, qualifier, "", itOuter->label2,
-                                                                    RiskType::IRCurve, qualifier, "", itInner->label2);
-                // Label1 level correlation i.e. $\rho_{k,l}$ from SIMM docs
-                Real tenorCorr = simmConfiguration_->correlation(RiskType::IRCurve, qualifier, itOuter->label1, "",
-                                                                 RiskType::IRCurve, qualifier, itInner->label1, "");
-                // Add cross element to delta margin
-                Real rwInner = simmConfiguration_->weight(RiskType::IRCurve, qualifier, itInner->label1);
-                Real wsInner = rwInner * itInner->amountResultCcy * concentrationRisk[qualifier];
-                deltaMargin[qualifier] += 2 * subCurveCorr * tenorCorr * wsOuter * wsInner;
-            }
+            sumWeightedSensis[qualifier] += irWs.back();
         }
 
+        // Calculate the delta margin piece for this qualifier i.e. $K_b$ from SIMM docs
+        vector<Real> irCorrWs;
+        deltaMargin[qualifier] += irTenorAggregation(RiskType::IRCurve, qualifier, irRecords, irWs, true,
+                                                     gradients ? &irCorrWs : nullptr);
+
         // Add the Inflation component, if any
-        Real wsInflation = 0.0;
+        Real wsInflation = 0.0, rwInflation = 0.0, corrInflation = 0.0;
         if (itInflation != crif.end()) {
             // Risk weight
-            Real rwInflation = simmConfiguration_->weight(RiskType::Inflation, qualifier, itInflation->label1);
+            rwInflation = simmConfiguration_->weight(RiskType::Inflation, qualifier, itInflation->label1);
             // Weighted sensitivity
             wsInflation = rwInflation * itInflation->amountResultCcy * concentrationRisk[qualifier];
             // Update weighted sensitivity sum
@@ -543,48 +592,67 @@ pair<map<string, Real>, bool> SimmCalculator::irDeltaMargin(const NettingSetDeta
             deltaMargin[qualifier] += wsInflation * wsInflation;
             // Add the cross elements (Inflation with IRCurve tenors) to the delta margin
             // Correlation (know that Label1 and Label2 do not matter)
-            Real corr = simmConfiguration_->correlation(RiskType::IRCurve, qualifier, "", "", RiskType::Inflation,
-                                                        qualifier, "", "");
-            for (auto it = pIrQualifier.begin(); it != pIrQualifier.end(); ++it) {
+            corrInflation = simmConfiguration_->correlation(RiskType::IRCurve, qualifier, "", "", RiskType::Inflation,
+                                                            qualifier, "", "");
+            for (const Real ws : irWs) {
                 // Add cross element to delta margin
-                Real rw = simmConfiguration_->weight(RiskType::IRCurve, qualifier, it->label1);
-                Real ws = rw * it->amountResultCcy * concentrationRisk[qualifier];
-                deltaMargin[qualifier] += 2 * corr * ws * wsInflation;
+                deltaMargin[qualifier] += 2 * corrInflation * ws * wsInflation;
             }
         }
 
         // Add the XccyBasis component, if any
+        Real wsXccy = 0.0, rwXccy = 0.0, corrXccy = 0.0, corrInflationXccy = 0.0;
         if (itXccy != crif.end()) {
             // Risk weight
-            Real rwXccy = simmConfiguration_->weight(RiskType::XCcyBasis, qualifier, itXccy->label1);
+            rwXccy = simmConfiguration_->weight(RiskType::XCcyBasis, qualifier, itXccy->label1);
             // Weighted sensitivity (no concentration risk here)
-            Real wsXccy = rwXccy * itXccy->amountResultCcy;
+            wsXccy = rwXccy * itXccy->amountResultCcy;
             // Update weighted sensitivity sum
             sumWeightedSensis[qualifier] += wsXccy;
             // Add diagonal element to delta margin
             deltaMargin[qualifier] += wsXccy * wsXccy;
             // Add the cross elements (XccyBasis with IRCurve tenors) to the delta margin
             // Correlation (know that Label1 and Label2 do not matter)
-            Real corr = simmConfiguration_->correlation(RiskType::IRCurve, qualifier, "", "", RiskType::XCcyBasis,
-                                                        qualifier, "", "");
-            for (auto it = pIrQualifier.begin(); it != pIrQualifier.end(); ++it) {
+            corrXccy = simmConfiguration_->correlation(RiskType::IRCurve, qualifier, "", "", RiskType::XCcyBasis,
+                                                       qualifier, "", "");
+            for (const Real ws : irWs) {
                 // Add cross element to delta margin
-                Real rw = simmConfiguration_->weight(RiskType::IRCurve, qualifier, it->label1, calcCcy);
-                Real ws = rw * it->amountResultCcy * concentrationRisk[qualifier];
-                deltaMargin[qualifier] += 2 * corr * ws * wsXccy;
+                deltaMargin[qualifier] += 2 * corrXccy * ws * wsXccy;
             }
 
             // Inflation vs. XccyBasis cross component if any
             if (itInflation != crif.end()) {
                 // Correlation (know that Label1 and Label2 do not matter)
-                Real corr = simmConfiguration_->correlation(RiskType::Inflation, qualifier, "", "", RiskType::XCcyBasis,
-                                                            qualifier, "", "");
-                deltaMargin[qualifier] += 2 * corr * wsInflation * wsXccy;
+                corrInflationXccy = simmConfiguration_->correlation(RiskType::Inflation, qualifier, "", "",
+                                                                    RiskType::XCcyBasis, qualifier, "", "");
+                deltaMargin[qualifier] += 2 * corrInflationXccy * wsInflation * wsXccy;
             }
         }
 
         // Finally have the value of $K_b$
         deltaMargin[qualifier] = sqrt(max(deltaMargin[qualifier], 0.0));
+
+        // Derivatives of $K_b$ and of the sum of weighted sensitivities with respect to the amounts
+        if (gradients) {
+            const Real kb = deltaMargin[qualifier];
+            const Real cr = concentrationRisk[qualifier];
+            const Real sumIrWs = accumulate(irWs.begin(), irWs.end(), 0.0);
+            auto& bg = bucketGradients[qualifier];
+            for (Size i = 0; i < irRecords.size(); ++i) {
+                Real corrWs = irCorrWs[i] + corrInflation * wsInflation + corrXccy * wsXccy;
+                bg.push_back({irRecords[i]->getSimmAmountCcyKey(), kb > 0.0 ? corrWs / kb * irRws[i] * cr : 0.0,
+                              irRws[i] * cr});
+            }
+            if (itInflation != crif.end()) {
+                Real corrWs = wsInflation + corrInflation * sumIrWs + corrInflationXccy * wsXccy;
+                bg.push_back({itInflation->getSimmAmountCcyKey(), kb > 0.0 ? corrWs / kb * rwInflation * cr : 0.0,
+                              rwInflation * cr});
+            }
+            if (itXccy != crif.end()) {
+                Real corrWs = wsXccy + corrXccy * sumIrWs + corrInflationXccy * wsInflation;
+                bg.push_back({itXccy->getSimmAmountCcyKey(), kb > 0.0 ? corrWs / kb * rwXccy : 0.0, rwXccy});
+            }
+        }
     }
 
     // Now calculate final IR delta margin by aggregating across currencies
@@ -605,6 +673,28 @@ pair<map<string, Real>, bool> SimmCalculator::irDeltaMargin(const NettingSetDeta
     }
     margin = sqrt(max(margin, 0.0));
 
+    // Chain the derivatives of $K_b$ with the derivatives of the aggregation across currencies
+    if (gradients) {
+        vector<string> qs(qualifiers.begin(), qualifiers.end());
+        vector<Real> k, sumWs, dK, dSumWs;
+        Matrix gamma(qs.size(), qs.size(), 0.0);
+        for (Size i = 0; i < qs.size(); ++i) {
+            k.push_back(deltaMargin.at(qs[i]));
+            sumWs.push_back(sumWeightedSensis.at(qs[i]));
+            for (Size j = 0; j < i; ++j) {
+                Real g = min(concentrationRisk.at(qs[i]), concentrationRisk.at(qs[j])) /
+                         max(concentrationRisk.at(qs[i]), concentrationRisk.at(qs[j]));
+                gamma[i][j] = gamma[j][i] = g * simmConfiguration_->correlation(RiskType::IRCurve, qs[i], "", "",
+                                                                                RiskType::IRCurve, qs[j], "", "");
+            }
+        }
+        aggregationGradients(k, sumWs, gamma, dK, dSumWs);
+        for (Size i = 0; i < qs.size(); ++i) {
+            for (const auto& bg : bucketGradients[qs[i]])
+                (*gradients)[bg.key] += dK[i] * bg.dK + dSumWs[i] * bg.dSumWs;
+        }
+    }
+
     for (const auto& m : deltaMargin)
         bucketMargins[m.first] = m.second;
     bucketMargins["All"] = margin;
@@ -614,7 +704,7 @@ pair<map<string, Real>, bool> SimmCalculator::irDeltaMargin(const NettingSetDeta
 
 pair<map<string, Real>, bool> SimmCalculator::irVegaMargin(const NettingSetDetails& nettingSetDetails,
                                                            const CrifRecord::ProductClass& pc, const Crif& crif,
-                                                           const SimmSide& side) const {
+                                                           const SimmSide& side, Gradients* gradients) const {
 
     const string& calcCcy = side == SimmSide::Call ? calculationCcyCall_ : calculationCcyPost_;
 
@@ -636,6 +726,8 @@ pair<map<string, Real>, bool> SimmCalculator::irVegaMargin(const NettingSetDetai
     map<string, Real> vegaMargin;
     // The sum of the weighted sensitivities for each currency i.e. $\sum_{k=1}^K VR_{k}$ from SIMM docs
     map<string, Real> sumWeightedSensis;
+    // The derivatives of $K_b$ for each currency, if gradients are requested
+    map<string, vector<BucketGradient>> bucketGradients;
 
     // Loop over the qualifiers i.e. currencies
     for (const auto& qualifier : qualifiers) {
@@ -655,35 +747,30 @@ pair<map<string, Real>, bool> SimmCalculator::irVegaMargin(const NettingSetDetai
         // Divide by the concentration risk threshold
         Real concThreshold = simmConfiguration_->concentrationThreshold(RiskType::IRVol, qualifier);
         if (resultCcy_ != "USD")
-            concThreshold *= market_->fxRate("USD" + resultCcy_)->value();
+            concThreshold *= concentrationThresholdFx();
         concentrationRisk[qualifier] /= concThreshold;
 
         // Final concentration risk amount
         concentrationRisk[qualifier] = max(1.0, sqrt(std::abs(concentrationRisk[qualifier])));
 
-        // Calculate the margin piece for this qualifier i.e. $K_b$ from SIMM docs
-        // Start with IRVol vs. IRVol components
-        for (auto itOuter = pIrQualifier.begin(); itOuter != pIrQualifier.end(); ++itOuter) {
-            // Risk weight i.e. $RW_k$ from SIMM docs
-            Real rwOuter = simmConfiguration_->weight(RiskType::IRVol, qualifier, itOuter->label1);
-            // Weighted sensitivity i.e. $WS_{k,i}$ from SIMM docs
-            Real wsOuter = rwOuter * itOuter->amountResultCcy * concentrationRisk[qualifier];
+        // Weighted sensitivities i.e. $WS_{k,i}$ from SIMM docs, with risk weight $RW_k$
+        vector<const CrifRecord*> irRecords;
+        vector<Real> irWs, irRws;
+        for (const auto& it : pIrQualifier) {
+            Real rw = simmConfiguration_->weight(RiskType::IRVol, qualifier, it.label1);
+            irRecords.push_back(&it);
+            irWs.push_back(rw * it.amountResultCcy * concentrationRisk[qualifier]);
+            irRws.push_back(rw);
             // Update weighted sensitivity sum
-            sumWeightedSensis[qualifier] += wsOuter;
-            // Add diagonal element to vega margin
-            vegaMargin[qualifier] += wsOuter * wsOuter;
-            // Add the cross elements to the vega margin
-            for (auto itInner = pIrQualifier.begin(); itInner != itOuter; ++itInner) {
-                // Label1 level correlation i.e. $\rho_{k,l}$ from SIMM docs
-                Real corr = simmConfiguration_->correlation(RiskType::IRVol, qualifier, itOuter->label1, "",
-                                                            RiskType::IRVol, qualifier, itInner->label1, "");
-                // Add cross element to vega margin
-                Real rwInner = simmConfiguration_->weight(RiskType::IRVol, qualifier, itInner->label1);
-                Real wsInner = rwInner * itInner->amountResultCcy * concentrationRisk[qualifier];
-                vegaMargin[qualifier] += 2 * corr * wsOuter * wsInner;
-            }
+            sumWeightedSensis[qualifier] += irWs.back();
         }
 
+        // Calculate the margin piece for this qualifier i.e. $K_b$ from SIMM docs
+        // Start with IRVol vs. IRVol components
+        vector<Real> irCorrWs, infCorrWs(pInfQualifier.size(), 0.0), infRws(pInfQualifier.size(), 0.0);
+        vegaMargin[qualifier] +=
+            irTenorAggregation(RiskType::IRVol, qualifier, irRecords, irWs, false, gradients ? &irCorrWs : nullptr);
+
         // Now deal with inflation component
         // To be generic/future-proof, assume that we don't know correlation structure. The way SIMM is
         // currently, we could just sum over the InflationVol numbers within qualifier and use this.
@@ -696,16 +783,21 @@ pair<map<string, Real>, bool> SimmCalculator::irVegaMargin(const NettingSetDetai
             sumWeightedSensis[qualifier] += wsOuter;
             // Add diagonal element to vega margin
             vegaMargin[qualifier] += wsOuter * wsOuter;
+            const Size m = std::distance(pInfQualifier.begin(), itOuter);
+            infRws[m] = rwOuter;
+            infCorrWs[m] += wsOuter;
             // Add the cross elements to the vega margin
             // Firstly, against all IRVol components
-            for (auto itInner = pIrQualifier.begin(); itInner != pIrQualifier.end(); ++itInner) {
+            for (Size i = 0; i < irRecords.size(); ++i) {
                 // Correlation i.e. $\rho_{k,l}$ from SIMM docs
                 Real corr = simmConfiguration_->correlation(RiskType::InflationVol, qualifier, itOuter->label1, "",
-                                                            RiskType::IRVol, qualifier, itInner->label1, "");
+                                                            RiskType::IRVol, qualifier, irRecords[i]->label1, "");
                 // Add cross element to vega margin
-                Real rwInner = simmConfiguration_->weight(RiskType::IRVol, qualifier, itInner->label1);
-                Real wsInner = rwInner * itInner->amountResultCcy * concentrationRisk[qualifier];
-                vegaMargin[qualifier] += 2 * corr * wsOuter * wsInner;
+                vegaMargin[qualifier] += 2 * corr * wsOuter * irWs[i];
+                if (gradients) {
+                    irCorrWs[i] += corr * wsOuter;
+                    infCorrWs[m] += corr * irWs[i];
+                }
             }
             // Secondly, against all previous InflationVol components
             for (auto itInner = pInfQualifier.begin(); itInner != itOuter; ++itInner) {
@@ -716,11 +808,26 @@ pair<map<string, Real>, bool> SimmCalculator::irVegaMargin(const NettingSetDetai
                 Real rwInner = simmConfiguration_->weight(RiskType::InflationVol, qualifier, itInner->label1);
                 Real wsInner = rwInner * itInner->amountResultCcy * concentrationRisk[qualifier];
                 vegaMargin[qualifier] += 2 * corr * wsOuter * wsInner;
+                infCorrWs[m] += corr * wsInner;
+                infCorrWs[std::distance(pInfQualifier.begin(), itInner)] += corr * wsOuter;
             }
         }
 
         // Finally have the value of $K_b$
         vegaMargin[qualifier] = sqrt(max(vegaMargin[qualifier], 0.0));
+
+        // Derivatives of $K_b$ and of the sum of weighted sensitivities with respect to the amounts
+        if (gradients) {
+            const Real kb = vegaMargin[qualifier];
+            const Real cr = concentrationRisk[qualifier];
+            auto& bg = bucketGradients[qualifier];
+            for (Size i = 0; i < irRecords.size(); ++i)
+                bg.push_back({irRecords[i]->getSimmAmountCcyKey(), kb > 0.0 ? irCorrWs[i] / kb * irRws[i] * cr : 0.0,
+                              irRws[i] * cr});
+            for (Size m = 0; m < pInfQualifier.size(); ++m)
+                bg.push_back({pInfQualifier[m].getSimmAmountCcyKey(),
+                              kb > 0.0 ? infCorrWs[m] / kb * infRws[m] * cr : 0.0, infRws[m] * cr});
+        }
     }
 
     // Now calculate final vega margin by aggregating across currencies
@@ -741,6 +848,29 @@ pair<map<string, Real>, bool> SimmCalculator::irVegaMargin(const NettingSetDetai
     }
     margin = sqrt(max(margin, 0.0));
 
+    // Chain the derivatives of $K_b$ with the derivatives of the aggregation across currencies
+    if (gradients) {
+        vector<string> qs(qualifiers.begin(), qualifiers.end());
+        vector<Real> k, sumWs, dK, dSumWs;
+        Matrix gamma(qs.size(), qs.size(), 0.0);
+        for (Size i = 0; i < qs.size(); ++i) {
+            k.push_back(vegaMargin.at(qs[i]));
+            sumWs.push_back(sumWeightedSensis.at(qs[i]));
+            for (Size j = 0; j < i; ++j) {
+                Real g = min(concentrationRisk.at(qs[i]), concentrationRisk.at(qs[j])) /
+                         max(concentrationRisk.at(qs[i]), concentrationRisk.at(qs[j]));
+                gamma[i][j] = gamma[j][i] = g * simmConfiguration_->correlation(RiskType::IRVol, qs[i], "", "",
+                                                                                RiskType::IRVol, qs[j], "", "",
+                                                                                calcCcy);
+            }
+        }
+        aggregationGradients(k, sumWs, gamma, dK, dSumWs);
+        for (Size i = 0; i < qs.size(); ++i) {
+            for (const auto& bg : bucketGradients[qs[i]])
+                (*gradients)[bg.key] += dK[i] * bg.dK + dSumWs[i] * bg.dSumWs;
+        }
+    }
+
     for (const auto& m : vegaMargin)
         bucketMargins[m.first] = m.second;
     bucketMargins["All"] = margin;
@@ -750,7 +880,8 @@ pair<map<string, Real>, bool> SimmCalculator::irVegaMargin(const NettingSetDetai
 
 pair<map<string, Real>, bool> SimmCalculator::irCurvatureMargin(const NettingSetDetails& nettingSetDetails,
                                                                 const CrifRecord::ProductClass& pc,
-                                                                const SimmSide& side, const Crif& crif) const {
+                                                                const SimmSide& side, const Crif& crif,
+                                                                Gradients* gradients) const {
 
     // "Bucket" here refers to exposures under the CRIF qualifiers
     map<string, Real> bucketMargins;
@@ -775,6 +906,8 @@ pair<map<string, Real>, bool> SimmCalculator::irCurvatureMargin(const NettingSet
     Real sumWs = 0.0;
     // The sum of the absolute value of weighted sensitivities across currencies and risk factors
     Real sumAbsWs = 0.0;
+    // The derivatives of $K_b$ for each currency, if gradients are requested
+    map<string, vector<BucketGradient>> bucketGradients;
 
     // Loop over the qualifiers i.e. currencies
     for (const auto& qualifier : qualifiers) {
@@ -785,6 +918,9 @@ pair<map<string, Real>, bool> SimmCalculator::irCurvatureMargin(const NettingSet
         auto pInfQualifier =
             crif.filterByQualifier(nettingSetDetails, pc, RiskType::InflationVol, qualifier);
 
+        // Correlated curvature sensitivities $\sum_l \rho_{k,l}^2 CVR_l$, and the $CVR_k$ per unit amount
+        vector<Real> irCorrWs(pIrQualifier.size(), 0.0), irSfs(pIrQualifier.size(), 0.0);
+
         // Calculate the margin piece for this qualifier i.e. $K_b$ from SIMM docs
         // Start with IRVol vs. IRVol components
         for (auto itOuter = pIrQualifier.begin(); itOuter != pIrQualifier.end(); ++itOuter) {
@@ -798,6 +934,9 @@ pair<map<string, Real>, bool> SimmCalculator::irCurvatureMargin(const NettingSet
             sumAbsWs += std::abs(wsOuter);
             // Add diagonal element to curvature margin
             curvatureMargin[qualifier] += wsOuter * wsOuter;
+            const Size i = std::distance(pIrQualifier.begin(), itOuter);
+            irSfs[i] = sfOuter * multiplier;
+            irCorrWs[i] += wsOuter;
             // Add the cross elements to the curvature margin
             for (auto itInner = pIrQualifier.begin(); itInner != itOuter; ++itInner) {
                 // Label1 level correlation i.e. $\rho_{k,l}$ from SIMM docs
@@ -807,13 +946,18 @@ pair<map<string, Real>, bool> SimmCalculator::irCurvatureMargin(const NettingSet
                 Real sfInner = simmConfiguration_->curvatureWeight(RiskType::IRVol, itInner->label1);
                 Real wsInner = sfInner * (itInner->amountResultCcy * multiplier);
                 curvatureMargin[qualifier] += 2 * corr * corr * wsOuter * wsInner;
+                irCorrWs[i] += corr * corr * wsInner;
+                irCorrWs[std::distance(pIrQualifier.begin(), itInner)] += corr * corr * wsOuter;
             }
         }
 
         // Now deal with inflation component
         const string simmVersion = simmConfiguration_->version();
         SimmVersion thresholdVersion = SimmVersion::V1_0;
-        if (simmConfiguration_->isSimmConfigCalibration() || parseSimmVersion(simmVersion) > thresholdVersion) {
+        const bool hasInflation =
+            simmConfiguration_->isSimmConfigCalibration() || parseSimmVersion(simmVersion) > thresholdVersion;
+        Real infCorrWs = 0.0;
+        if (hasInflation) {
             // Weighted sensitivity i.e. $WS_{k,i}$ from SIMM docs
             Real infWs = 0.0;
             for (auto infIt = pInfQualifier.begin(); infIt != pInfQualifier.end(); ++infIt) {
@@ -828,6 +972,7 @@ pair<map<string, Real>, bool> SimmCalculator::irCurvatureMargin(const NettingSet
 
             // Add diagonal element to curvature margin - there is only one element for inflationVol
             curvatureMargin[qualifier] += infWs * infWs;
+            infCorrWs += infWs;
 
             // Add the cross elements to the curvature margin against IRVol components.
             // There are no cross elements against InflationVol since we only have one element.
@@ -839,11 +984,29 @@ pair<map<string, Real>, bool> SimmCalculator::irCurvatureMargin(const NettingSet
                 Real irSf = simmConfiguration_->curvatureWeight(RiskType::IRVol, irIt->label1);
                 Real irWs = irSf * (irIt->amountResultCcy * multiplier);
                 curvatureMargin[qualifier] += 2 * corr * corr * infWs * irWs;
+                infCorrWs += corr * corr * irWs;
+                irCorrWs[std::distance(pIrQualifier.begin(), irIt)] += corr * corr * infWs;
             }
         }
 
         // Finally have the value of $K_b$
         curvatureMargin[qualifier] = sqrt(max(curvatureMargin[qualifier], 0.0));
+
+        // Derivatives of $K_b$ and of the sum of curvature sensitivities with respect to the amounts
+        if (gradients) {
+            const Real kb = curvatureMargin[qualifier];
+            auto& bg = bucketGradients[qualifier];
+            for (Size i = 0; i < pIrQualifier.size(); ++i)
+                bg.push_back({pIrQualifier[i].getSimmAmountCcyKey(), kb > 0.0 ? irCorrWs[i] / kb * irSfs[i] : 0.0,
+                              irSfs[i]});
+            if (hasInflation) {
+                for (const auto& infRecord : pInfQualifier) {
+                    Real infSf = simmConfiguration_->curvatureWeight(RiskType::InflationVol, infRecord.label1) *
+                                 multiplier;
+                    bg.push_back({infRecord.getSimmAmountCcyKey(), kb > 0.0 ? infCorrWs / kb * infSf : 0.0, infSf});
+                }
+            }
+        }
     }
 
     // If sum of absolute value of all individual curvature risks is zero, we can return 0.0
@@ -877,6 +1040,29 @@ pair<map<string, Real>, bool> SimmCalculator::irCurvatureMargin(const NettingSet
 
     Real scaling = simmConfiguration_->curvatureMarginScaling();
     Real totalCurvatureMargin = scaling * max(margin, 0.0);
+
+    // Chain the derivatives of $K_b$ with the derivatives of the aggregation across currencies, keeping
+    // $\lambda(\theta)$ fixed
+    if (gradients && margin > 0.0) {
+        vector<string> qs(qualifiers.begin(), qualifiers.end());
+        vector<Real> k, sumWsBucket, dK, dSumWs;
+        Matrix gamma(qs.size(), qs.size(), 0.0);
+        for (Size i = 0; i < qs.size(); ++i) {
+            k.push_back(curvatureMargin.at(qs[i]));
+            sumWsBucket.push_back(sumWeightedSensis.at(qs[i]));
+            for (Size j = 0; j < i; ++j) {
+                Real corr =
+                    simmConfiguration_->correlation(RiskType::IRVol, qs[i], "", "", RiskType::IRVol, qs[j], "", "");
+                gamma[i][j] = gamma[j][i] = corr * corr;
+            }
+        }
+        aggregationGradients(k, sumWsBucket, gamma, dK, dSumWs);
+        const Real l = lambda(theta);
+        for (Size i = 0; i < qs.size(); ++i) {
+            for (const auto& bg : bucketGradients[qs[i]])
+                (*gradients)[bg.key] += scaling * (bg.dSumWs + l * (dK[i] * bg.dK + dSumWs[i] * bg.dSumWs));
+        }
+    }
     // TODO: Review, should we return the pre-scaled value instead?
     bucketMargins["All"] = totalCurvatureMargin;
 
@@ -884,7 +1070,8 @@ pair<map<string, Real>, bool> SimmCalculator::irCurvatureMargin(const NettingSet
 }
 
 pair<map<string, Real>, bool> SimmCalculator::margin(const NettingSetDetails& nettingSetDetails, const ProductClass& pc,
-                                                     const RiskType& rt, const Crif& crif, const SimmSide& side) const {
+                                                     const RiskType& rt, const Crif& crif, const SimmSide& side,
+                                                     Gradients* gradients) const {
 
     const string& calcCcy = side == SimmSide::Call ? calculationCcyCall_ : calculationCcyPost_;
     
@@ -921,6 +1108,8 @@ pair<map<string, Real>, bool> SimmCalculator::margin(const NettingSetDetails& ne
     map<string, Real> sumWeightedSensis;
     // The historical volatility ratio for the risk type - will be 1.0 if not applicable
     Real hvr = simmConfiguration_->historicalVolatilityRatio(rt);
+    // The derivatives of $K_b$ for each bucket, if gradients are requested
+    map<string, vector<BucketGradient>> bucketGradients;
 
     // Loop over the buckets
     for (const auto& kv : buckets) {
@@ -956,7 +1145,7 @@ pair<map<string, Real>, bool> SimmCalculator::margin(const NettingSetDetails& ne
             // Divide by the concentration risk threshold
             Real concThreshold = simmConfiguration_->concentrationThreshold(rt, qualifier);
             if (resultCcy_ != "USD")
-                concThreshold *= market_->fxRate("USD" + resultCcy_)->value();
+                concThreshold *= concentrationThresholdFx();
             concentrationRisk[qualifier] /= concThreshold;
             // Final concentration risk amount
             concentrationRisk[qualifier] = max(1.0, sqrt(std::abs(concentrationRisk[qualifier])));
@@ -964,63 +1153,47 @@ pair<map<string, Real>, bool> SimmCalculator::margin(const NettingSetDetails& ne
 
 
         // Calculate the margin component for the current bucket
-        // Pair of iterators to start and end of sensitivities within current bucket
-        auto pBucket = crifByBucket[bucket];
-        for (auto itOuter = pBucket.begin(); itOuter != pBucket.end(); ++itOuter) {
+        // Weighted sensitivities within the current bucket
+        vector<const CrifRecord*> records;
+        vector<Real> ws, dWs;
+        for (const auto& it : crifByBucket[bucket]) {
             // Do not include Risk_FX components in the calculation currency in the SIMM calculation
-            if (rt == RiskType::FX && itOuter->qualifier == calcCcy) {
+            if (rt == RiskType::FX && it.qualifier == calcCcy) {
                 if (!quiet_) {
-                    DLOG("Skipping qualifier " << itOuter->qualifier << " of risk type " << rt
+                    DLOG("Skipping qualifier " << it.qualifier << " of risk type " << rt
                                                << " since the qualifier equals the SIMM calculation currency "
                                                << calcCcy);
                 }
                 continue;
             }
             // Risk weight i.e. $RW_k$ from SIMM docs
-            Real rwOuter = simmConfiguration_->weight(rt, itOuter->qualifier, itOuter->label1, calcCcy);
+            Real rw = simmConfiguration_->weight(rt, it.qualifier, it.label1, calcCcy);
             // Get the sigma value if applicable - returns 1.0 if not applicable
-            Real sigmaOuter = simmConfiguration_->sigma(rt, itOuter->qualifier, itOuter->label1, calcCcy);
+            Real sigma = simmConfiguration_->sigma(rt, it.qualifier, it.label1, calcCcy);
             // Weighted sensitivity i.e. $WS_{k}$ from SIMM docs
-            Real wsOuter =
-                rwOuter * (itOuter->amountResultCcy * sigmaOuter * hvr) * concentrationRisk[itOuter->qualifier];
-            // Get concentration risk for outer qualifier
-            Real outerConcentrationRisk = concentrationRisk.at(itOuter->qualifier);
+            records.push_back(&it);
+            ws.push_back(rw * (it.amountResultCcy * sigma * hvr) * concentrationRisk[it.qualifier]);
+            dWs.push_back(rw * sigma * hvr * concentrationRisk[it.qualifier]);
             // Update weighted sensitivity sum
-            sumWeightedSensis[bucket] += wsOuter;
-            // Add diagonal element to bucket margin
-            bucketMargin[bucket] += wsOuter * wsOuter;
-            // Add the cross elements to the bucket margin
-            for (auto itInner = pBucket.begin(); itInner != itOuter; ++itInner) {
-                // Do not include Risk_FX components in the calculation currency in the SIMM calculation
-                if (rt == RiskType::FX && itInner->qualifier == calcCcy) {
-                    if (!quiet_) {
-                        DLOG("Skipping qualifier " << itInner->qualifier << " of risk type " << rt
-                                                   << " since the qualifier equals the SIMM calculation currency "
-                                                   << calcCcy);
-                    }
-                    continue;
-                }
-                // Correlation, $\rho_{k,l}$ in the SIMM docs
-                Real corr =
-                    simmConfiguration_->correlation(rt, itOuter->qualifier, itOuter->label1, itOuter->label2, rt,
-                                                    itInner->qualifier, itInner->label1, itInner->label2, calcCcy);
-                // $f_{k,l}$ from the SIMM docs
-                Real f = min(outerConcentrationRisk, concentrationRisk.at(itInner->qualifier)) /
-                         max(outerConcentrationRisk, concentrationRisk.at(itInner->qualifier));
-                // Add cross element to delta margin
-                Real sigmaInner = simmConfiguration_->sigma(rt, itInner->qualifier, itInner->label1, calcCcy);
-                Real rwInner = simmConfiguration_->weight(rt, itInner->qualifier, itInner->label1, calcCcy);
-                Real wsInner =
-                    rwInner * (itInner->amountResultCcy * sigmaInner * hvr) * concentrationRisk[itInner->qualifier];
-                bucketMargin[bucket] += 2 * corr * f * wsOuter * wsInner;
-            }
+            sumWeightedSensis[bucket] += ws.back();
             // For FX risk class, results are broken down by qualifier, i.e. currency, instead of bucket, which is not used for Risk_FX
             if (riskClassIsFX)
-                bucketMargins[itOuter->qualifier] += wsOuter;
+                bucketMargins[it.qualifier] += ws.back();
         }
+        vector<Real> corrWs;
+        bucketMargin[bucket] += intraBucketAggregation(rt, bucket, records, ws, concentrationRisk, calcCcy,
+                                                       gradients ? &corrWs : nullptr);
 
         // Finally have the value of $K_b$
         bucketMargin[bucket] = sqrt(max(bucketMargin[bucket], 0.0));
+
+        // Derivatives of $K_b$ and of the sum of weighted sensitivities with respect to the amounts
+        if (gradients) {
+            const Real kb = bucketMargin[bucket];
+            auto& bg = bucketGradients[bucket];
+            for (Size i = 0; i < records.size(); ++i)
+                bg.push_back({records[i]->getSimmAmountCcyKey(), kb > 0.0 ? corrWs[i] / kb * dWs[i] : 0.0, dWs[i]});
+        }
     }
 
     // If there is a "Residual" bucket entry store it separately
@@ -1055,6 +1228,33 @@ pair<map<string, Real>, bool> SimmCalculator::margin(const NettingSetDetails& ne
     }
     margin = sqrt(max(margin, 0.0));
 
+    // Chain the derivatives of $K_b$ with the derivatives of the aggregation across buckets, the residual margin
+    // is added as is
+    if (gradients) {
+        vector<string> bs;
+        vector<Real> k, sumWs, dK, dSumWs;
+        for (const auto& [b, kb] : bucketMargin) {
+            bs.push_back(b);
+            k.push_back(kb);
+            sumWs.push_back(sumWeightedSensis.at(b));
+        }
+        Matrix gamma(bs.size(), bs.size(), 0.0);
+        for (Size i = 0; i < bs.size(); ++i) {
+            for (Size j = 0; j < i; ++j) {
+                gamma[i][j] = gamma[j][i] =
+                    simmConfiguration_->correlation(rt, *buckets.at(bs[i]).begin(), "", "", rt,
+                                                    *buckets.at(bs[j]).begin(), "", "", calcCcy);
+            }
+        }
+        aggregationGradients(k, sumWs, gamma, dK, dSumWs);
+        for (Size i = 0; i < bs.size(); ++i) {
+            for (const auto& bg : bucketGradients[bs[i]])
+                (*gradients)[bg.key] += dK[i] * bg.dK + dSumWs[i] * bg.dSumWs;
+        }
+        for (const auto& bg : bucketGradients["Residual"])
+            (*gradients)[bg.key] += bg.dK;
+    }
+
     // Now add the residual component back in
     margin += residualMargin;
     if (!close_enough(residualMargin, 0.0))
@@ -1074,7 +1274,7 @@ pair<map<string, Real>, bool> SimmCalculator::margin(const NettingSetDetails& ne
 
 pair<map<string, Real>, bool>
 SimmCalculator::curvatureMargin(const NettingSetDetails& nettingSetDetails, const ProductClass& pc, const RiskType& rt,
-                                const SimmSide& side, const Crif& crif, bool rfLabels) const {
+                                const SimmSide& side, const Crif& crif, bool rfLabels, Gradients* gradients) const {
 
     const string& calcCcy = side == SimmSide::Call ? calculationCcyCall_ : calculationCcyPost_;
 
@@ -1108,6 +1308,8 @@ SimmCalculator::curvatureMargin(const NettingSetDetails& nettingSetDetails, cons
     map<string, Real> sumWeightedSensis;
     map<string, map<string, Real>> sumAbsTemp;
     map<string, Real> sumAbsWeightedSensis;
+    // The derivatives of $K_b$ for each bucket, if gradients are requested
+    map<string, vector<BucketGradient>> bucketGradients;
 
     // Loop over the buckets
     for (const auto& kv : buckets) {
@@ -1117,6 +1319,8 @@ SimmCalculator::curvatureMargin(const NettingSetDetails& nettingSetDetails, cons
         // Calculate the margin component for the current bucket
         // Pair of iterators to start and end of sensitivities within current bucket
         auto pBucket = crif.filterByBucket(nettingSetDetails, pc, rt, bucket);
+        // Correlated curvature sensitivities $\sum_l \rho_{k,l}^2 CVR_l$, and the $CVR_k$ per unit amount
+        vector<Real> corrWs(pBucket.size(), 0.0), dWs(pBucket.size(), 0.0);
         for (auto itOuter = pBucket.begin(); itOuter != pBucket.end(); ++itOuter) {
             // Curvature weight i.e. $SF(t_{kj})$ from SIMM docs
             Real sfOuter = simmConfiguration_->curvatureWeight(rt, itOuter->label1);
@@ -1129,15 +1333,19 @@ SimmCalculator::curvatureMargin(const NettingSetDetails& nettingSetDetails, cons
             // for ISDA SIMM 2.2 or higher, this $CVR_{ik}$ for EQ bucket 12 is zero
             const string simmVersion = simmConfiguration_->version();
             SimmVersion thresholdVersion = SimmVersion::V2_2;
+            const Size k = std::distance(pBucket.begin(), itOuter);
+            dWs[k] = sfOuter * multiplier * sigmaOuter;
             if ((simmConfiguration_->isSimmConfigCalibration() || parseSimmVersion(simmVersion) >= thresholdVersion) &&
                 bucket == "12" && rt == RiskType::EquityVol) {
                 wsOuter = 0.0;
+                dWs[k] = 0.0;
             }
             // Update weighted sensitivity sum
             sumWeightedSensis[bucket] += wsOuter;
             sumAbsTemp[bucket][itOuter->qualifier] += rfLabels ? std::abs(wsOuter) : wsOuter;
             // Add diagonal element to curvature margin
             curvatureMargin[bucket] += wsOuter * wsOuter;
+            corrWs[k] += wsOuter;
             // Add the cross elements to the curvature margin
             for (auto itInner = pBucket.begin(); itInner != itOuter; ++itInner) {
                 // Correlation, $\rho_{k,l}$ in the SIMM docs
@@ -1149,6 +1357,8 @@ SimmCalculator::curvatureMargin(const NettingSetDetails& nettingSetDetails, cons
                 Real sigmaInner = simmConfiguration_->sigma(rt, itInner->qualifier, itInner->label1, calcCcy);
                 Real wsInner = sfInner * ((itInner->amountResultCcy * multiplier) * sigmaInner);
                 curvatureMargin[bucket] += 2 * corr * corr * wsOuter * wsInner;
+                corrWs[k] += corr * corr * wsInner;
+                corrWs[std::distance(pBucket.begin(), itInner)] += corr * corr * wsOuter;
             }
             // For FX risk class, results are broken down by qualifier, i.e. currency, instead of bucket, which is not
             // used for Risk_FX
@@ -1160,6 +1370,14 @@ SimmCalculator::curvatureMargin(const NettingSetDetails& nettingSetDetails, cons
         Real bucketCurvatureMargin = sqrt(max(curvatureMargin[bucket], 0.0));
         curvatureMargin[bucket] = bucketCurvatureMargin;
 
+        // Derivatives of $K_b$ and of the sum of curvature sensitivities with respect to the amounts
+        if (gradients) {
+            auto& bg = bucketGradients[bucket];
+            for (Size k = 0; k < pBucket.size(); ++k)
+                bg.push_back({pBucket[k].getSimmAmountCcyKey(),
+                              bucketCurvatureMargin > 0.0 ? corrWs[k] / bucketCurvatureMargin * dWs[k] : 0.0, dWs[k]});
+        }
+
         // Bucket level absolute sensitivity
         for (const auto& kv : sumAbsTemp[bucket]) {
             sumAbsWeightedSensis[bucket] += std::abs(kv.second);
@@ -1212,6 +1430,32 @@ SimmCalculator::curvatureMargin(const NettingSetDetails& nettingSetDetails, cons
             }
         }
         margin = max(sumSensis + lambda(theta) * sqrt(max(margin, 0.0)), 0.0);
+
+        // Chain the derivatives of $K_b$ with the derivatives of the aggregation across buckets, keeping
+        // $\lambda(\theta)$ fixed
+        if (gradients && margin > 0.0) {
+            vector<string> bs;
+            vector<Real> k, sumWs, dK, dSumWs;
+            for (const auto& [b, kb] : curvatureMargin) {
+                bs.push_back(b);
+                k.push_back(kb);
+                sumWs.push_back(sumWeightedSensis.at(b));
+            }
+            Matrix gamma(bs.size(), bs.size(), 0.0);
+            for (Size i = 0; i < bs.size(); ++i) {
+                for (Size j = 0; j < i; ++j) {
+                    Real corr = simmConfiguration_->correlation(rt, *buckets.at(bs[i]).begin(), "", "", rt,
+                                                                *buckets.at(bs[j]).begin(), "", "", calcCcy);
+                    gamma[i][j] = gamma[j][i] = corr * corr;
+                }
+            }
+            aggregationGradients(k, sumWs, gamma, dK, dSumWs);
+            const Real l = lambda(theta);
+            for (Size i = 0; i < bs.size(); ++i) {
+                for (const auto& bg : bucketGradients[bs[i]])
+                    (*gradients)[bg.key] += bg.dSumWs + l * (dK[i] * bg.dK + dSumWs[i] * bg.dSumWs);
+            }
+        }
     }
 
     // Second, the residual bucket if necessary, and add "Residual" bucket back in to be added to the SIMM results
@@ -1219,6 +1463,12 @@ SimmCalculator::curvatureMargin(const NettingSetDetails& nettingSetDetails, cons
         Real theta = min(residualSum / residualAbsSum, 0.0);
         curvatureMargin["Residual"] = max(residualSum + lambda(theta) * residualMargin, 0.0);
         margin += curvatureMargin["Residual"];
+
+        if (gradients && curvatureMargin["Residual"] > 0.0) {
+            const Real l = lambda(theta);
+            for (const auto& bg : bucketGradients["Residual"])
+                (*gradients)[bg.key] += bg.dSumWs + l * bg.dK;
+        }
     }
 
     // For non-FX risk class, results are broken down by buckets
@@ -1233,11 +1483,9 @@ SimmCalculator::curvatureMargin(const NettingSetDetails& nettingSetDetails, cons
     return make_pair(bucketMargins, true);
 }
 
-void SimmCalculator::calcAddMargin(const SimmSide& side, const NettingSetDetails& nettingSetDetails,
-                                   const string& regulation, const Crif& crif) {
-
-    // Reference to SIMM results for this portfolio
-    auto& results = simmResults_[side][nettingSetDetails][regulation];
+void SimmCalculator::calcAddMargin(SimmResults& results, const SimmSide& side,
+                                   const NettingSetDetails& nettingSetDetails, const string& regulation,
+                                   const Crif& crif, Crif& simmParameters) const {
 
     const bool overwrite = false;
 
@@ -1261,23 +1509,23 @@ void SimmCalculator::calcAddMargin(const SimmSide& side, const NettingSetDetails
             QL_REQUIRE(factor >= 0.0, "SIMM Calculator: Amount for risk type "
                 << rt << " must be greater than or equal to 0 but we got " << factor);
             Real pcmMargin = (factor - 1.0) * im;
-            add(nettingSetDetails, regulation, qpc, RiskClass::All, MarginType::AdditionalIM, "All", pcmMargin, side,
+            add(results, nettingSetDetails, qpc, RiskClass::All, MarginType::AdditionalIM, "All", pcmMargin, side,
                 overwrite);
 
             // Add to aggregation at margin type level
-            add(nettingSetDetails, regulation, qpc, RiskClass::All, MarginType::All, "All", pcmMargin, side, overwrite);
+            add(results, nettingSetDetails, qpc, RiskClass::All, MarginType::All, "All", pcmMargin, side, overwrite);
             // Add to aggregation at product class level
-            add(nettingSetDetails, regulation, ProductClass::All, RiskClass::All, MarginType::AdditionalIM, "All", pcmMargin,
+            add(results, nettingSetDetails, ProductClass::All, RiskClass::All, MarginType::AdditionalIM, "All", pcmMargin,
                 side, overwrite);
             // Add to aggregation at portfolio level
-            add(nettingSetDetails, regulation, ProductClass::All, RiskClass::All, MarginType::All, "All", pcmMargin, side,
+            add(results, nettingSetDetails, ProductClass::All, RiskClass::All, MarginType::All, "All", pcmMargin, side,
                 overwrite);
             CrifRecord spRecord = it;
             if (side == SimmSide::Call)
                 spRecord.collectRegulations = regulation;
             else
                 spRecord.postRegulations = regulation;
-            simmParameters_.addRecord(spRecord);
+            simmParameters.addRecord(spRecord);
         }
     }
 
@@ -1285,25 +1533,25 @@ void SimmCalculator::calcAddMargin(const SimmSide& side, const NettingSetDetails
     pIt = crif.filterBy(nettingSetDetails, pc, RiskType::AddOnFixedAmount);
     for(const auto& it : pIt){
         Real fixedMargin = it.amountResultCcy;
-        add(nettingSetDetails, regulation, ProductClass::AddOnFixedAmount, RiskClass::All, MarginType::AdditionalIM,
+        add(results, nettingSetDetails, ProductClass::AddOnFixedAmount, RiskClass::All, MarginType::AdditionalIM,
             "All", fixedMargin, side, overwrite);
 
         // Add to aggregation at margin type level
-        add(nettingSetDetails, regulation, ProductClass::AddOnFixedAmount, RiskClass::All, MarginType::All, "All",
+        add(results, nettingSetDetails, ProductClass::AddOnFixedAmount, RiskClass::All, MarginType::All, "All",
             fixedMargin,
             side, overwrite);
         // Add to aggregation at product class level
-        add(nettingSetDetails, regulation, ProductClass::All, RiskClass::All, MarginType::AdditionalIM, "All",
+        add(results, nettingSetDetails, ProductClass::All, RiskClass::All, MarginType::AdditionalIM, "All",
             fixedMargin, side, overwrite);
         // Add to aggregation at portfolio level
-        add(nettingSetDetails, regulation, ProductClass::All, RiskClass::All, MarginType::All, "All", fixedMargin, side,
+        add(results, nettingSetDetails, ProductClass::All, RiskClass::All, MarginType::All, "All", fixedMargin, side,
             overwrite);
         CrifRecord spRecord = it;
         if (side == SimmSide::Call)
             spRecord.collectRegulations = regulation;
         else
             spRecord.postRegulations = regulation;
-        simmParameters_.addRecord(spRecord);
+        simmParameters.addRecord(spRecord);
     }
 
     // Third, add percentage of notional amounts IM, using "AddOnNotionalFactor"
@@ -1324,18 +1572,18 @@ void SimmCalculator::calcAddMargin(const SimmSide& side, const NettingSetDetails
             Real factor = it.amount;
             Real notionalFactorMargin = notional * factor / 100.0;
 
-            add(nettingSetDetails, regulation, ProductClass::AddOnNotionalFactor, RiskClass::All,
+            add(results, nettingSetDetails, ProductClass::AddOnNotionalFactor, RiskClass::All,
                 MarginType::AdditionalIM, "All", notionalFactorMargin, side, overwrite);
 
             // Add to aggregation at margin type level
-            add(nettingSetDetails, regulation, ProductClass::AddOnNotionalFactor, RiskClass::All, MarginType::All,
+            add(results, nettingSetDetails, ProductClass::AddOnNotionalFactor, RiskClass::All, MarginType::All,
                 "All",
                 notionalFactorMargin, side, overwrite);
             // Add to aggregation at product class level
-            add(nettingSetDetails, regulation, ProductClass::All, RiskClass::All, MarginType::AdditionalIM, "All",
+            add(results, nettingSetDetails, ProductClass::All, RiskClass::All, MarginType::AdditionalIM, "All",
                 notionalFactorMargin, side, overwrite);
             // Add to aggregation at portfolio level
-            add(nettingSetDetails, regulation, ProductClass::All, RiskClass::All, MarginType::All, "All",
+            add(results, nettingSetDetails, ProductClass::All, RiskClass::All, MarginType::All, "All",
                 notionalFactorMargin,
                 side, overwrite);
             CrifRecord spRecord = it;
@@ -1343,13 +1591,13 @@ void SimmCalculator::calcAddMargin(const SimmSide& side, const NettingSetDetails
                 spRecord.collectRegulations = regulation;
             else
                 spRecord.postRegulations = regulation;
-            simmParameters_.addRecord(spRecord);
+            simmParameters.addRecord(spRecord);
         }
     }
 }
 
-void SimmCalculator::populateResults(const SimmSide& side, const NettingSetDetails& nettingSetDetails,
-                                     const string& regulation) {
+void SimmCalculator::populateResults(SimmResults& results, const SimmSide& side,
+                                     const NettingSetDetails& nettingSetDetails) const {
 
     if (!quiet_) {
         LOG("SimmCalculator: Populating higher level results")
@@ -1362,9 +1610,6 @@ void SimmCalculator::populateResults(const SimmSide& side, const NettingSetDetai
 
     // Populate netting set level results for each portfolio
 
-    // Reference to SIMM results for this portfolio
-    auto& results = simmResults_[side][nettingSetDetails][regulation];
-
     // Fill in the margin within each (product class, risk class) combination
     for (const auto& pc : pcs) {
         for (const auto& rc : rcs) {
@@ -1382,7 +1627,7 @@ void SimmCalculator::populateResults(const SimmSide& side, const NettingSetDetai
 
             // Add the margin to the results if it was calculated
             if (hasRiskClass) {
-                add(nettingSetDetails, regulation, pc, rc, MarginType::All, "All", riskClassMargin, side);
+                add(results, nettingSetDetails, pc, rc, MarginType::All, "All", riskClassMargin, side);
             }
         }
     }
@@ -1420,7 +1665,7 @@ void SimmCalculator::populateResults(const SimmSide& side, const NettingSetDetai
         // Add the margin to the results if it was calculated
         if (hasProductClass) {
             productClassMargin = sqrt(max(productClassMargin, 0.0));
-            add(nettingSetDetails, regulation, pc, RiskClass::All, MarginType::All, "All", productClassMargin, side);
+            add(results, nettingSetDetails, pc, RiskClass::All, MarginType::All, "All", productClassMargin, side);
         }
     }
 
@@ -1432,7 +1677,7 @@ void SimmCalculator::populateResults(const SimmSide& side, const NettingSetDetai
             im += results.get(pc, RiskClass::All, MarginType::All, "All");
         }
     }
-    add(nettingSetDetails, regulation, ProductClass::All, RiskClass::All, MarginType::All, "All", im, side);
+    add(results, nettingSetDetails, ProductClass::All, RiskClass::All, MarginType::All, "All", im, side);
 
     // Combinations outside of the natural SIMM hierarchy
 
@@ -1470,7 +1715,7 @@ void SimmCalculator::populateResults(const SimmSide& side, const NettingSetDetai
             // Add the margin to the results if it was calculated
             if (hasPcMt) {
                 margin = sqrt(max(margin, 0.0));
-                add(nettingSetDetails, regulation, pc, RiskClass::All, mt, "All", margin, side);
+                add(results, nettingSetDetails, pc, RiskClass::All, mt, "All", margin, side);
             }
         }
     }
@@ -1495,7 +1740,7 @@ void SimmCalculator::populateResults(const SimmSide& side, const NettingSetDetai
 
             // Add the margin to the results if it was calculated
             if (hasRcMt) {
-                add(nettingSetDetails, regulation, ProductClass::All, rc, mt, "All", margin, side);
+                add(results, nettingSetDetails, ProductClass::All, rc, mt, "All", margin, side);
             }
         }
     }
@@ -1520,7 +1765,7 @@ void SimmCalculator::populateResults(const SimmSide& side, const NettingSetDetai
 
         // Add the margin to the results if it was calculated
         if (hasRc) {
-            add(nettingSetDetails, regulation, ProductClass::All, rc, MarginType::All, "All", margin, side);
+            add(results, nettingSetDetails, ProductClass::All, rc, MarginType::All, "All", margin, side);
         }
     }
 
@@ -1544,7 +1789,7 @@ void SimmCalculator::populateResults(const SimmSide& side, const NettingSetDetai
 
         // Add the margin to the results if it was calculated
         if (hasMt) {
-            add(nettingSetDetails, regulation, ProductClass::All, RiskClass::All, mt, "All", margin, side);
+            add(results, nettingSetDetails, ProductClass::All, RiskClass::All, mt, "All", margin, side);
         }
     }
 }
@@ -1596,9 +1841,9 @@ void SimmCalculator::populateFinalResults() {
     populateFinalResults(winningRegulations_);
 }
 
-void SimmCalculator::add(const NettingSetDetails& nettingSetDetails, const string& regulation, const ProductClass& pc,
+void SimmCalculator::add(SimmResults& results, const NettingSetDetails& nettingSetDetails, const ProductClass& pc,
                          const RiskClass& rc, const MarginType& mt, const string& b, Real margin, SimmSide side,
-                         const bool overwrite) {
+                         const bool overwrite) const {
     if (!quiet_) {
         DLOG("Calculated " << side << " margin for [netting set details, product class, risk class, margin type] = ["
                            << "[" << NettingSetDetails(nettingSetDetails) << "]"
@@ -1606,54 +1851,552 @@ void SimmCalculator::add(const NettingSetDetails& nettingSetDetails, const strin
     }
 
     const string& calculationCcy = side == SimmSide::Call ? calculationCcyCall_ : calculationCcyPost_;
-    simmResults_[side][nettingSetDetails][regulation].add(pc, rc, mt, b, margin, resultCcy_, calculationCcy, overwrite);
+    results.add(pc, rc, mt, b, margin, resultCcy_, calculationCcy, overwrite);
 }
 
-void SimmCalculator::add(const NettingSetDetails& nettingSetDetails, const string& regulation, const ProductClass& pc,
+void SimmCalculator::add(SimmResults& results, const NettingSetDetails& nettingSetDetails, const ProductClass& pc,
                          const RiskClass& rc, const MarginType& mt, const map<string, Real>& margins, SimmSide side,
-                         const bool overwrite) {
+                         const bool overwrite) const {
 
     for (const auto& kv : margins)
-        add(nettingSetDetails, regulation, pc, rc, mt, kv.first, kv.second, side, overwrite);
+        add(results, nettingSetDetails, pc, rc, mt, kv.first, kv.second, side, overwrite);
 }
 
-void SimmCalculator::splitCrifByRegulationsAndPortfolios(const Crif& crif, const bool enforceIMRegulations) {
+void SimmCalculator::splitCrifByRegulationsAndPortfolios(const Crif& crif) {
     for (const auto& crifRecord : crif) {
         for (const auto& side : {SimmSide::Call, SimmSide::Post}) {
             const NettingSetDetails& nettingSetDetails = crifRecord.nettingSetDetails;
 
-            bool collectRegsIsEmpty = false;
-            bool postRegsIsEmpty = false;
-            if (collectRegsIsEmpty_.find(crifRecord.nettingSetDetails) != collectRegsIsEmpty_.end())
-                collectRegsIsEmpty = collectRegsIsEmpty_.at(crifRecord.nettingSetDetails);
-            if (postRegsIsEmpty_.find(crifRecord.nettingSetDetails) != postRegsIsEmpty_.end())
-                postRegsIsEmpty = postRegsIsEmpty_.at(crifRecord.nettingSetDetails);
-
-            string regsString;
-            if (enforceIMRegulations)
-                regsString = side == SimmSide::Call ? crifRecord.collectRegulations : crifRecord.postRegulations;
-            set<string> regs = parseRegulationString(regsString);
-
             auto newCrifRecord = crifRecord;
             newCrifRecord.collectRegulations.clear();
             newCrifRecord.postRegulations.clear();
-            for (const string& r : regs) {
-                if (r == "Excluded" ||
-                    (r == "Unspecified" && enforceIMRegulations && !(collectRegsIsEmpty && postRegsIsEmpty))) {
+            for (const string& r : recordRegulations(crifRecord, side)) {
+                // Keep a record of trade IDs for each regulation
+                if (!newCrifRecord.isSimmParameter())
+                    tradeIds_[side][nettingSetDetails][r].insert(newCrifRecord.tradeId);
+                // We make sure to ignore amountCcy when aggregating the records, since we will only be using
+                // amountResultCcy, and we may have CRIF records that are equal everywhere except for the amountCcy,
+                // and this will fail in the case of Risk_XCcyBasis and Risk_Inflation.
+                const bool onDiffAmountCcy = true;
+                regSensitivities_[side][nettingSetDetails][r].addRecord(newCrifRecord, onDiffAmountCcy);
+            }
+        }
+    }
+}
+
+set<string> SimmCalculator::recordRegulations(const CrifRecord& cr, const SimmSide& side) const {
+
+    bool collectRegsIsEmpty = false;
+    bool postRegsIsEmpty = false;
+    if (collectRegsIsEmpty_.find(cr.nettingSetDetails) != collectRegsIsEmpty_.end())
+        collectRegsIsEmpty = collectRegsIsEmpty_.at(cr.nettingSetDetails);
+    if (postRegsIsEmpty_.find(cr.nettingSetDetails) != postRegsIsEmpty_.end())
+        postRegsIsEmpty = postRegsIsEmpty_.at(cr.nettingSetDetails);
+
+    string regsString;
+    if (enforceIMRegulations_)
+        regsString = side == SimmSide::Call ? cr.collectRegulations : cr.postRegulations;
+
+    set<string> regs;
+    for (const string& r : parseRegulationString(regsString)) {
+        if (r == "Excluded" ||
+            (r == "Unspecified" && enforceIMRegulations_ && !(collectRegsIsEmpty && postRegsIsEmpty)))
+            continue;
+        regs.insert(r);
+    }
+    return regs;
+}
+
+CrifRecord SimmCalculator::resultCcyRecord(const CrifRecord& cr) const {
+    CrifRecord newCrifRecord = cr;
+
+    if (cr.requiresAmountUsd() && resultCcy_ == "USD" && cr.hasAmountUsd()) {
+        newCrifRecord.amountResultCcy = newCrifRecord.amountUsd;
+    } else if(cr.requiresAmountUsd()) {
+        // ProductClassMultiplier and AddOnNotionalFactor  don't have a currency and dont need to be converted,
+        // we use the amount
+        const Real fxSpot = market_->fxRate(newCrifRecord.amountCurrency + resultCcy_)->value();
+        newCrifRecord.amountResultCcy = fxSpot * newCrifRecord.amount;
+    }
+    newCrifRecord.resultCurrency = resultCcy_;
+
+    return newCrifRecord;
+}
+
+SimmResults SimmCalculator::whatIfSimm(const Crif& delta, const SimmSide& side, const NettingSetDetails& nsd,
+                                       const string& regulation) const {
+
+    // Current netted sensitivities and results for the netting set and regulation, if any
+    const Crif* sensitivities = nullptr;
+    const SimmResults* current = nullptr;
+    if (auto s = regSensitivities_.find(side); s != regSensitivities_.end()) {
+        if (auto n = s->second.find(nsd); n != s->second.end()) {
+            if (auto r = n->second.find(regulation); r != n->second.end())
+                sensitivities = &r->second;
+        }
+    }
+    if (auto s = simmResults_.find(side); s != simmResults_.end()) {
+        if (auto n = s->second.find(nsd); n != s->second.end()) {
+            if (auto r = n->second.find(regulation); r != n->second.end())
+                current = &r->second;
+        }
+    }
+
+    // Prepare the delta records in the same way as the records passed to the constructor and collect the
+    // (product class, risk class) combinations affected by them
+    vector<CrifRecord> deltaRecords;
+    set<pair<ProductClass, RiskClass>> affected;
+    for (const CrifRecord& cr : delta) {
+        if (cr.riskType == RiskType::Empty || cr.imModel == "Schedule")
+            continue;
+        CrifRecord newCrifRecord = resultCcyRecord(cr);
+        newCrifRecord.nettingSetDetails = nsd;
+        newCrifRecord.collectRegulations.clear();
+        newCrifRecord.postRegulations.clear();
+        newCrifRecord.tradeId = "";
+        if (!newCrifRecord.isSimmParameter() && newCrifRecord.riskType != RiskType::Notional)
+            affected.insert(make_pair(newCrifRecord.productClass,
+                                      SimmConfiguration::riskTypeToRiskClass(newCrifRecord.riskType)));
+        deltaRecords.push_back(std::move(newCrifRecord));
+    }
+
+    // Only the current sensitivities of the affected combinations are copied, together with the SIMM parameters and
+    // notionals used for the additional margin. The delta records are netted into them.
+    Crif crif;
+    if (sensitivities) {
+        const set<RiskType> simmRiskTypes = SimmConfiguration::riskTypes();
+        for (const CrifRecord& cr : *sensitivities) {
+            bool needed = cr.isSimmParameter() || cr.riskType == RiskType::Notional;
+            if (!needed && cr.riskType != RiskType::PV && simmRiskTypes.count(cr.riskType) > 0)
+                needed = affected.count(
+                             make_pair(cr.productClass, SimmConfiguration::riskTypeToRiskClass(cr.riskType))) > 0;
+            if (needed)
+                crif.addRecord(cr, true);
+        }
+    }
+    for (const CrifRecord& cr : deltaRecords)
+        crif.addRecord(cr, true);
+
+    const string& calculationCcy = side == SimmSide::Call ? calculationCcyCall_ : calculationCcyPost_;
+    SimmResults results(resultCcy_, calculationCcy);
+
+    // Keep the cached margins at (product class, risk class, margin type) level that are not affected. The higher
+    // levels and the additional margins are recalculated below.
+    if (current) {
+        for (const auto& [key, im] : current->data()) {
+            const auto& [pc, rc, mt, b] = key;
+            if (pc == ProductClass::All || rc == RiskClass::All || mt == MarginType::All ||
+                mt == MarginType::AdditionalIM || affected.count(make_pair(pc, rc)) > 0)
+                continue;
+            results.add(key, im, resultCcy_, calculationCcy, true);
+        }
+    }
+
+    // Recalculate the affected margins
+    map<ProductClass, set<RiskClass>> riskClasses;
+    for (const auto& [pc, rc] : affected)
+        riskClasses[pc].insert(rc);
+    for (const auto& [pc, rcs] : riskClasses)
+        calculateMargins(results, crif, nsd, side, pc, rcs);
+
+    // Higher level results and additional margin, as in calculateRegulationSimm()
+    Crif simmParameters;
+    populateResults(results, side, nsd);
+    calcAddMargin(results, side, nsd, regulation, crif, simmParameters);
+
+    return results;
+}
+
+Real SimmCalculator::marginalSimm(const Crif& delta, const SimmSide& side, const NettingSetDetails& nsd,
+                                  const string& regulation) const {
+    SimmResults results = whatIfSimm(delta, side, nsd, regulation);
+    Real whatIf = results.has(ProductClass::All, RiskClass::All, MarginType::All, "All")
+                      ? results.get(ProductClass::All, RiskClass::All, MarginType::All, "All")
+                      : 0.0;
+    Real current = 0.0;
+    if (auto s = simmResults_.find(side); s != simmResults_.end()) {
+        if (auto n = s->second.find(nsd); n != s->second.end()) {
+            if (auto r = n->second.find(regulation); r != n->second.end()) {
+                if (r->second.has(ProductClass::All, RiskClass::All, MarginType::All, "All"))
+                    current = r->second.get(ProductClass::All, RiskClass::All, MarginType::All, "All");
+            }
+        }
+    }
+    return whatIf - current;
+}
+
+SimmCalculator::Gradients SimmCalculator::simmGradients(const SimmSide& side, const NettingSetDetails& nsd,
+                                                        const string& regulation) const {
+
+    Gradients gradients;
+
+    // Netted sensitivities for the netting set and regulation
+    const Crif* crif = nullptr;
+    if (auto s = regSensitivities_.find(side); s != regSensitivities_.end()) {
+        if (auto n = s->second.find(nsd); n != s->second.end()) {
+            if (auto r = n->second.find(regulation); r != n->second.end())
+                crif = &r->second;
+        }
+    }
+    if (!crif)
+        return gradients;
+
+    const auto riskClasses = SimmConfiguration::riskClasses(false);
+    const auto marginTypes = simmConfiguration_->marginTypes(false);
+    for (const auto pc : crif->ProductClassesByNettingSetDetails(nsd)) {
+        // Margins and their gradients for each risk class and margin type
+        SimmResults results(resultCcy_);
+        map<pair<RiskClass, MarginType>, Gradients> marginGradients;
+        calculateMargins(results, *crif, nsd, side, pc, riskClasses, &marginGradients);
+
+        // Risk class margins $K_r$, i.e. the sum over the margin types
+        vector<RiskClass> rcs;
+        vector<Real> k;
+        for (const auto& rc : riskClasses) {
+            Real m = 0.0;
+            bool hasRiskClass = false;
+            for (const auto& mt : marginTypes) {
+                if (results.has(pc, rc, mt, "All")) {
+                    m += results.get(pc, rc, mt, "All");
+                    hasRiskClass = true;
+                }
+            }
+            if (hasRiskClass) {
+                rcs.push_back(rc);
+                k.push_back(m);
+            }
+        }
+
+        // Product class margin $\sqrt{\sum_{r,s} \psi_{r,s} K_r K_s}$ and $\sum_s \psi_{r,s} K_s$
+        Real im = 0.0;
+        vector<Real> psiK(k.size(), 0.0);
+        for (Size i = 0; i < k.size(); ++i) {
+            for (Size j = 0; j < k.size(); ++j)
+                psiK[i] += (i == j ? 1.0 : simmConfiguration_->correlationRiskClasses(rcs[i], rcs[j])) * k[j];
+            im += k[i] * psiK[i];
+        }
+        if (im <= 0.0)
+            continue;
+        im = sqrt(im);
+
+        // The product class multipliers scale the product class margin, see calcAddMargin()
+        Real factor = 1.0;
+        for (const auto& r : crif->filterBy(nsd, ProductClass::Empty, RiskType::ProductClassMultiplier)) {
+            if (parseProductClass(r.qualifier) == pc)
+                factor *= r.amount;
+        }
+
+        for (Size i = 0; i < rcs.size(); ++i) {
+            for (const auto& mt : marginTypes) {
+                auto g = marginGradients.find(make_pair(rcs[i], mt));
+                if (g == marginGradients.end() || !results.has(pc, rcs[i], mt, "All"))
                     continue;
-                } else if (r != "Excluded") {
-                    // Keep a record of trade IDs for each regulation
-                    if (!newCrifRecord.isSimmParameter())
-                        tradeIds_[side][nettingSetDetails][r].insert(newCrifRecord.tradeId);
-                    // We make sure to ignore amountCcy when aggregating the records, since we will only be using
-                    // amountResultCcy, and we may have CRIF records that are equal everywhere except for the amountCcy,
-                    // and this will fail in the case of Risk_XCcyBasis and Risk_Inflation.
-                    const bool onDiffAmountCcy = true;
-                    regSensitivities_[side][nettingSetDetails][r].addRecord(newCrifRecord, onDiffAmountCcy);
+                for (const auto& [key, d] : g->second)
+                    gradients[key] += factor * psiK[i] / im * d;
+            }
+        }
+    }
+
+    // The fixed amount add-ons are linear in their amounts, the notional add-ons linear in the notionals
+    for (const auto& r : crif->filterBy(nsd, ProductClass::Empty, RiskType::AddOnFixedAmount))
+        gradients[r.getSimmAmountCcyKey()] += 1.0;
+    for (const auto& r : crif->filterBy(nsd, ProductClass::Empty, RiskType::AddOnNotionalFactor)) {
+        for (const auto& n : crif->filterByQualifier(nsd, ProductClass::Empty, RiskType::Notional, r.qualifier))
+            gradients[n.getSimmAmountCcyKey()] += r.amount / 100.0;
+    }
+
+    return gradients;
+}
+
+map<string, Real> SimmCalculator::tradeAllocations(const SimmSide& side, const NettingSetDetails& nsd,
+                                                   const string& regulation) const {
+
+    const Gradients gradients = simmGradients(side, nsd, regulation);
+
+    map<string, Real> allocations;
+    if (auto s = tradeIds_.find(side); s != tradeIds_.end()) {
+        if (auto n = s->second.find(nsd); n != s->second.end()) {
+            if (auto r = n->second.find(regulation); r != n->second.end()) {
+                for (const auto& tradeId : r->second)
+                    allocations[tradeId] = 0.0;
+            }
+        }
+    }
+
+    for (const auto& cr : crif_) {
+        if (cr.nettingSetDetails != nsd)
+            continue;
+        // The CFTC sensitivities are part of the SEC sensitivities as well, see the constructor
+        const set<string> regs = recordRegulations(cr, side);
+        if (regs.count(regulation) == 0 && !(regulation == "SEC" && regs.count("CFTC") > 0))
+            continue;
+        // Look up the gradient of the netted record this record contributes to
+        CrifRecord netRecord = cr;
+        netRecord.tradeId = "";
+        netRecord.collectRegulations.clear();
+        netRecord.postRegulations.clear();
+        if (auto g = gradients.find(netRecord.getSimmAmountCcyKey()); g != gradients.end())
+            allocations[cr.tradeId] += cr.amountResultCcy * g->second;
+    }
+
+    return allocations;
+}
+
+Real SimmCalculator::irTenorAggregation(const RiskType& rt, const string& qualifier,
+                                        const vector<const CrifRecord*>& records, const vector<Real>& ws,
+                                        const bool subCurves, vector<Real>* corrWs) const {
+
+    QL_REQUIRE(records.size() == ws.size(), "SimmCalculator::irTenorAggregation(): expected as many weighted "
+                                                << "sensitivities (" << ws.size() << ") as records (" << records.size()
+                                                << ")");
+
+    // Tenor, i.e. Label1, and sub curve, i.e. Label2, ids of the records
+    const Matrix& tenorCorr = simmConfiguration_->label1Correlations(rt);
+    bool compiled = !tenorCorr.empty();
+    vector<Size> tenors(records.size()), curves(records.size(), 0);
+    map<string, Size> curveIds;
+    vector<string> curveLabels;
+    for (Size i = 0; i < records.size() && compiled; ++i) {
+        tenors[i] = simmConfiguration_->label1Index(rt, records[i]->label1);
+        compiled = tenors[i] != Null<Size>();
+        if (subCurves) {
+            auto c = curveIds.emplace(records[i]->label2, curveLabels.size());
+            if (c.second)
+                curveLabels.push_back(records[i]->label2);
+            curves[i] = c.first->second;
+        }
+    }
+
+    Real result = 0.0;
+    if (corrWs)
+        corrWs->assign(records.size(), 0.0);
+
+    if (!compiled) {
+        // No dense tenor correlations, use the pairwise correlations of the configuration
+        for (Size i = 0; i < records.size(); ++i) {
+            result += ws[i] * ws[i];
+            if (corrWs)
+                (*corrWs)[i] += ws[i];
+            for (Size j = 0; j < i; ++j) {
+                Real corr = simmConfiguration_->correlation(rt, qualifier, records[i]->label1, "", rt, qualifier,
+                                                            records[j]->label1, "");
+                if (subCurves)
+                    corr *= simmConfiguration_->correlation(rt, qualifier, "", records[i]->label2, rt, qualifier, "",
+                                                            records[j]->label2);
+                result += 2 * corr * ws[i] * ws[j];
+                if (corrWs) {
+                    (*corrWs)[i] += corr * ws[j];
+                    (*corrWs)[j] += corr * ws[i];
+                }
+            }
+        }
+        return result;
+    }
+
+    // Net the weighted sensitivities per sub curve and tenor, the correlation between records with the same
+    // sub curve and tenor is 1
+    const Size nCurves = std::max<Size>(curveLabels.size(), 1);
+    vector<Array> netWs(nCurves, Array(tenorCorr.rows(), 0.0));
+    for (Size i = 0; i < records.size(); ++i)
+        netWs[curves[i]][tenors[i]] += ws[i];
+
+    // $\sum_{i,j} \phi_{i,j} \rho_{k,l} WS_{k,i} WS_{l,j}$ as matrix-vector products per pair of sub curves
+    vector<Array> tenorCorrWs(nCurves);
+    Matrix subCurveCorr(nCurves, nCurves, 1.0);
+    for (Size a = 0; a < nCurves; ++a) {
+        tenorCorrWs[a] = tenorCorr * netWs[a];
+        result += DotProduct(netWs[a], tenorCorrWs[a]);
+        for (Size b = 0; b < a; ++b) {
+            subCurveCorr[a][b] = subCurveCorr[b][a] = simmConfiguration_->correlation(
+                rt, qualifier, "", curveLabels[a], rt, qualifier, "", curveLabels[b]);
+            result += 2 * subCurveCorr[a][b] * DotProduct(netWs[b], tenorCorrWs[a]);
+        }
+    }
+
+    // The correlated weighted sensitivity of a record only depends on its sub curve and tenor
+    if (corrWs) {
+        for (Size i = 0; i < records.size(); ++i) {
+            for (Size b = 0; b < nCurves; ++b)
+                (*corrWs)[i] += subCurveCorr[curves[i]][b] * tenorCorrWs[b][tenors[i]];
+        }
+    }
+
+    return result;
+}
+
+Real SimmCalculator::intraBucketAggregation(const RiskType& rt, const string& bucket,
+                                            const vector<const CrifRecord*>& records, const vector<Real>& ws,
+                                            const map<string, Real>& concentrationRisk, const string& calcCcy,
+                                            vector<Real>* corrWs) const {
+
+    QL_REQUIRE(records.size() == ws.size(), "SimmCalculator::intraBucketAggregation(): expected as many weighted "
+                                                << "sensitivities (" << ws.size() << ") as records (" << records.size()
+                                                << ")");
+
+    // Correlation, $\rho_{k,l}$ in the SIMM docs, between two of the records
+    auto corr = [this, &rt, &records, &calcCcy](const Size i, const Size j) {
+        return simmConfiguration_->correlation(rt, records[i]->qualifier, records[i]->label1, records[i]->label2, rt,
+                                               records[j]->qualifier, records[j]->label1, records[j]->label2, calcCcy);
+    };
+
+    // Group the records by qualifier
+    map<string, vector<Size>> qualifierRecords;
+    for (Size i = 0; i < records.size(); ++i)
+        qualifierRecords[records[i]->qualifier].push_back(i);
+
+    // Correlation between different qualifiers if it is constant within the bucket. The configuration derives the
+    // bucket from the qualifier, so we require that this agrees with the CRIF bucket.
+    Real rho = Null<Real>();
+    if (qualifierRecords.size() > 1) {
+        rho = simmConfiguration_->constantIntraBucketCorrelation(rt, bucket);
+        if (rho != Null<Real>() && simmConfiguration_->hasBuckets(rt)) {
+            for (const auto& [qualifier, _] : qualifierRecords) {
+                if (simmConfiguration_->bucket(rt, qualifier) != bucket) {
+                    rho = Null<Real>();
+                    break;
+                }
+            }
+        }
+    }
+
+    Real result = 0.0;
+    if (corrWs)
+        corrWs->assign(records.size(), 0.0);
+
+    if (qualifierRecords.size() > 1 && rho == Null<Real>()) {
+        // General case, quadratic in the number of records
+        for (Size i = 0; i < records.size(); ++i) {
+            const Real cri = concentrationRisk.at(records[i]->qualifier);
+            result += ws[i] * ws[i];
+            if (corrWs)
+                (*corrWs)[i] += ws[i];
+            for (Size j = 0; j < i; ++j) {
+                // $f_{k,l}$ from the SIMM docs
+                const Real crj = concentrationRisk.at(records[j]->qualifier);
+                const Real f = min(cri, crj) / max(cri, crj);
+                const Real c = corr(i, j) * f;
+                result += 2 * c * ws[i] * ws[j];
+                if (corrWs) {
+                    (*corrWs)[i] += c * ws[j];
+                    (*corrWs)[j] += c * ws[i];
+                }
+            }
+        }
+        return result;
+    }
+
+    // Pairs with the same qualifier, for which $f_{k,l} = 1$, and the net weighted sensitivity per qualifier
+    vector<Real> netWs, cr;
+    for (const auto& [qualifier, indices] : qualifierRecords) {
+        Real s = 0.0;
+        for (Size a = 0; a < indices.size(); ++a) {
+            const Size i = indices[a];
+            s += ws[i];
+            result += ws[i] * ws[i];
+            if (corrWs)
+                (*corrWs)[i] += ws[i];
+            for (Size b = 0; b < a; ++b) {
+                const Real c = corr(i, indices[b]);
+                result += 2 * c * ws[i] * ws[indices[b]];
+                if (corrWs) {
+                    (*corrWs)[i] += c * ws[indices[b]];
+                    (*corrWs)[indices[b]] += c * ws[i];
                 }
             }
         }
+        netWs.push_back(s);
+        cr.push_back(concentrationRisk.at(qualifier));
     }
+
+    if (netWs.size() < 2)
+        return result;
+
+    // Pairs with different qualifiers, $\rho \sum_{k \neq l} f_{k,l} WS_k WS_l$ with
+    // $f_{k,l} = \min(CR_k, CR_l) / \max(CR_k, CR_l)$. With the qualifiers sorted by ascending concentration
+    // risk this is $2 \rho \sum_l WS_l / CR_l \sum_{k < l} CR_k WS_k$, i.e. linear in the number of qualifiers.
+    vector<Size> order(netWs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&cr](const Size a, const Size b) { return cr[a] < cr[b]; });
+    Real prefix = 0.0, cross = 0.0;
+    for (const Size l : order) {
+        cross += netWs[l] / cr[l] * prefix;
+        prefix += cr[l] * netWs[l];
+    }
+    result += 2 * rho * cross;
+
+    // The correlated weighted sensitivity of a record from the other qualifiers is
+    // $\rho (\sum_{k < l} CR_k WS_k / CR_l + CR_l \sum_{k > l} WS_k / CR_k)$ in the sorted order
+    if (corrWs) {
+        vector<Real> otherWs(netWs.size(), 0.0);
+        Real lower = 0.0;
+        for (const Size l : order) {
+            otherWs[l] += lower / cr[l];
+            lower += cr[l] * netWs[l];
+        }
+        Real upper = 0.0;
+        for (auto l = order.rbegin(); l != order.rend(); ++l) {
+            otherWs[*l] += cr[*l] * upper;
+            upper += netWs[*l] / cr[*l];
+        }
+        Size q = 0;
+        for (const auto& [qualifier, indices] : qualifierRecords) {
+            for (const Size i : indices)
+                (*corrWs)[i] += rho * otherWs[q];
+            ++q;
+        }
+    }
+
+    return result;
+}
+
+void SimmCalculator::aggregationGradients(const vector<Real>& k, const vector<Real>& sumWs, const Matrix& gamma,
+                                          vector<Real>& dK, vector<Real>& dSumWs) const {
+
+    const Size n = k.size();
+    QL_REQUIRE(sumWs.size() == n && gamma.rows() == n && gamma.columns() == n,
+               "SimmCalculator::aggregationGradients(): inconsistent sizes, expected " << n);
+    dK.assign(n, 0.0);
+    dSumWs.assign(n, 0.0);
+
+    // $S_b$ and which of $K_b$ and the sum of weighted sensitivities it depends on
+    vector<Real> s(n), dS_dK(n, 0.0), dS_dSumWs(n, 0.0);
+    for (Size i = 0; i < n; ++i) {
+        if (sumWs[i] > k[i]) {
+            s[i] = k[i];
+            dS_dK[i] = 1.0;
+        } else if (sumWs[i] < -k[i]) {
+            s[i] = -k[i];
+            dS_dK[i] = -1.0;
+        } else {
+            s[i] = sumWs[i];
+            dS_dSumWs[i] = 1.0;
+        }
+    }
+
+    // $\sum_{c \neq b} \gamma_{b,c} S_c$ and the aggregated margin
+    Real m = 0.0;
+    vector<Real> gammaS(n, 0.0);
+    for (Size i = 0; i < n; ++i) {
+        for (Size j = 0; j < n; ++j) {
+            if (j != i)
+                gammaS[i] += gamma[i][j] * s[j];
+        }
+        m += k[i] * k[i] + s[i] * gammaS[i];
+    }
+    if (m <= 0.0)
+        return;
+    m = sqrt(m);
+
+    for (Size i = 0; i < n; ++i) {
+        dK[i] = (k[i] + gammaS[i] * dS_dK[i]) / m;
+        dSumWs[i] = gammaS[i] * dS_dSumWs[i] / m;
+    }
+}
+
+Real SimmCalculator::concentrationThresholdFx() const {
+    QL_REQUIRE(usdSpot_ != Null<Real>(), "SimmCalculator: need a market to convert the concentration thresholds from USD to "
+                                             << resultCcy_);
+    return usdSpot_;
 }
 
 Real SimmCalculator::lambda(Real theta) const {
@@ -26,6 +26,7 @@
 #include <orea/simm/crifloader.hpp>
 #include <orea/simm/simmresults.hpp>
 #include <ored/marketdata/market.hpp>
+#include <ql/math/matrix.hpp>
 
 #include <map>
 
@@ -44,6 +45,10 @@ public:
         \p calculationCcy is not USD then the \p usdSpot parameter must be used to
         give the FX spot rate between USD and the \p calculationCcy. This spot rate is
         interpreted as the number of USD per unit of \p calculationCcy.
+
+        If \p nThreads is greater than one, the SIMM for the individual (side, netting set,
+        regulation) combinations is calculated on up to \p nThreads threads. The results
+        are identical to the single threaded calculation.
     */
     SimmCalculator(const ore::analytics::Crif& crif,
                    const QuantLib::ext::shared_ptr<SimmConfiguration>& simmConfiguration,
@@ -56,12 +61,50 @@ public:
                    const std::map<SimmSide, std::set<NettingSetDetails>>& hasSEC =
                        std::map<SimmSide, std::set<NettingSetDetails>>(),
                    const std::map<SimmSide, std::set<NettingSetDetails>>& hasCFTC =
-                       std::map<SimmSide, std::set<NettingSetDetails>>());
+                       std::map<SimmSide, std::set<NettingSetDetails>>(),
+                   const QuantLib::Size nThreads = 1);
 
     //! Calculates SIMM for a given regulation under a given netting set
     const void calculateRegulationSimm(const ore::analytics::Crif& crif, const ore::data::NettingSetDetails& nsd,
                                        const string& regulation, const SimmSide& side);
 
+    /*! What-if SIMM for the given \p side, netting set \p nsd and \p regulation if the CRIF records in \p delta,
+        e.g. the sensitivities of a candidate trade, are added to the netting set's sensitivities. Sensitivities are
+        removed by passing records with negated amounts. The netting set details and regulations of the \p delta
+        records are ignored.
+
+        Only the (product class, risk class) margins touched by \p delta are recalculated from the updated
+        sensitivities, all other margins are taken from the results of this calculator. Only the sensitivities of
+        the touched combinations and the SIMM parameters are copied. The calculator itself is not changed.
+    */
+    SimmResults whatIfSimm(const ore::analytics::Crif& delta, const SimmSide& side,
+                           const ore::data::NettingSetDetails& nsd, const std::string& regulation) const;
+
+    //! Marginal SIMM of \p delta, i.e. the total what-if SIMM less the current total SIMM, see whatIfSimm()
+    QuantLib::Real marginalSimm(const ore::analytics::Crif& delta, const SimmSide& side,
+                                const ore::data::NettingSetDetails& nsd, const std::string& regulation) const;
+
+    //! Gradients with respect to the amounts in result currency of CRIF records, keyed by the records' amount ccy key
+    typedef std::map<CrifRecord::SimmAmountCcyKey, QuantLib::Real> Gradients;
+
+    /*! Gradients \f$\partial IM / \partial s_k\f$ of the total SIMM for the given \p side, netting set \p nsd and
+        \p regulation with respect to the amounts in result currency \f$s_k\f$ of its netted sensitivities, calculated
+        analytically in a single pass. The concentration risk factors, the curvature \f$\lambda(\theta)\f$ and the
+        active branches of the caps and floors in the aggregation are held fixed, i.e. SIMM is treated as a
+        homogeneous function of order one in the sensitivities, and \f$IM = \sum_k s_k \partial IM / \partial s_k\f$.
+    */
+    Gradients simmGradients(const SimmSide& side, const ore::data::NettingSetDetails& nsd,
+                            const std::string& regulation) const;
+
+    /*! Euler allocation of the total SIMM for the given \p side, netting set \p nsd and \p regulation to the trades,
+        i.e. \f$\sum_{k \in t} s_k \partial IM / \partial s_k\f$ over the CRIF records of each trade \f$t\f$, see
+        simmGradients(). The allocations add up to the total SIMM. Add-on records without a trade ID are allocated to
+        an empty trade ID.
+    */
+    std::map<std::string, QuantLib::Real> tradeAllocations(const SimmSide& side,
+                                                           const ore::data::NettingSetDetails& nsd,
+                                                           const std::string& regulation) const;
+
     //! Return the winning regulation for each netting set
     const std::string& winningRegulations(const SimmSide& side,
                                           const ore::data::NettingSetDetails& nettingSetDetails) const;
@@ -129,9 +172,15 @@ private:
     //! Market data for FX rates to use for converting amounts to USD
     QuantLib::ext::shared_ptr<ore::data::Market> market_;
 
+    //! USD-resultCcy spot used to convert the concentration thresholds, read once before the margin calculation
+    QuantLib::Real usdSpot_ = QuantLib::Null<QuantLib::Real>();
+
     //! If true, no logging is written out
     bool quiet_;
 
+    //! If true, the collect/post regulations of the CRIF records are taken into account
+    bool enforceIMRegulations_;
+
     std::map<SimmSide, std::set<NettingSetDetails>> hasSEC_, hasCFTC_;
 
     //! For each netting set, whether all CRIF records' collect regulations are empty
@@ -165,27 +214,32 @@ private:
     //! Calculate the Interest Rate delta margin component for the given portfolio and product class
     std::pair<std::map<std::string, QuantLib::Real>, bool>
     irDeltaMargin(const ore::data::NettingSetDetails& nettingSetDetails, const CrifRecord::ProductClass& pc,
-                  const ore::analytics::Crif& netRecords, const SimmSide& side) const;
+                  const ore::analytics::Crif& netRecords, const SimmSide& side,
+                  Gradients* gradients = nullptr) const;
 
     //! Calculate the Interest Rate vega margin component for the given portfolio and product class
     std::pair<std::map<std::string, QuantLib::Real>, bool>
     irVegaMargin(const ore::data::NettingSetDetails& nettingSetDetails, const CrifRecord::ProductClass& pc,
-                 const ore::analytics::Crif& netRecords, const SimmSide& side) const;
+                 const ore::analytics::Crif& netRecords, const SimmSide& side, Gradients* gradients = nullptr) const;
 
     //! Calculate the Interest Rate curvature margin component for the given portfolio and product class
     std::pair<std::map<std::string, QuantLib::Real>, bool>
     irCurvatureMargin(const ore::data::NettingSetDetails& nettingSetDetails, const CrifRecord::ProductClass& pc,
-                      const SimmSide& side, const ore::analytics::Crif& crif) const;
+                      const SimmSide& side, const ore::analytics::Crif& crif, Gradients* gradients = nullptr) const;
 
     /*! Calculate the (delta or vega) margin component for the given portfolio, product class and risk type
         Used to calculate delta or vega or base correlation margin for all risk types except IR, IRVol
         (and by association, Inflation, XccyBasis and InflationVol)
+
+        The margin functions add the gradients of the margin with respect to the amounts of the records to
+        \p gradients if given, see simmGradients().
     */
     std::pair<std::map<std::string, QuantLib::Real>, bool> margin(const ore::data::NettingSetDetails& nettingSetDetails,
                                                                   const CrifRecord::ProductClass& pc,
                                                                   const CrifRecord::RiskType& rt,
                                                                   const ore::analytics::Crif& netRecords,
-                                                                  const SimmSide& side) const;
+                                                                  const SimmSide& side,
+                                                                  Gradients* gradients = nullptr) const;
 
     /*! Calculate the curvature margin component for the given portfolio, product class and risk type
         Used to calculate curvature margin for all risk types except IR
@@ -193,16 +247,72 @@ private:
     std::pair<std::map<std::string, QuantLib::Real>, bool>
     curvatureMargin(const ore::data::NettingSetDetails& nettingSetDetails, const CrifRecord::ProductClass& pc,
                     const CrifRecord::RiskType& rt, const SimmSide& side, const ore::analytics::Crif& netRecords,
-                    bool rfLabels = true) const;
+                    bool rfLabels = true, Gradients* gradients = nullptr) const;
+
+    //! Calculates SIMM for a given regulation under a given netting set, SIMM parameters used are added to \p simmParameters
+    void calculateRegulationSimm(const ore::analytics::Crif& crif, const ore::data::NettingSetDetails& nsd,
+                                 const string& regulation, const SimmSide& side,
+                                 ore::analytics::Crif& simmParameters);
+
+    /*! Calculate the delta, vega, curvature and base correlation margins of the given \p riskClasses for the
+        product class \p pc and add them to \p results. If \p gradients is given, the gradients of each margin
+        are added to it.
+    */
+    void calculateMargins(SimmResults& results, const ore::analytics::Crif& crif,
+                          const ore::data::NettingSetDetails& nsd, const SimmSide& side,
+                          const CrifRecord::ProductClass& pc, const std::set<SimmConfiguration::RiskClass>& riskClasses,
+                          std::map<std::pair<SimmConfiguration::RiskClass, SimmConfiguration::MarginType>, Gradients>*
+                              gradients = nullptr) const;
 
     //! Calculate the additional initial margin for the portfolio ID and regulation
-    void calcAddMargin(const SimmSide& side, const ore::data::NettingSetDetails& nsd, const string& regulation, const ore::analytics::Crif& netRecords);
+    void calcAddMargin(SimmResults& results, const SimmSide& side, const ore::data::NettingSetDetails& nsd,
+                       const string& regulation, const ore::analytics::Crif& netRecords,
+                       ore::analytics::Crif& simmParameters) const;
+
+    /*! Aggregate the weighted sensitivities \p ws of the IRCurve or IRVol \p records of a single \p qualifier
+        over tenors and, if \p subCurves is true, sub curves, i.e. give back
+        \f$\sum_{i,j} \phi_{i,j} \rho_{k,l} WS_{k,i} WS_{l,j}\f$. Uses the dense tenor correlations of the
+        configuration where available. If \p corrWs is given, it is set to the correlated weighted sensitivities
+        \f$\sum_{j,l} \phi_{i,j} \rho_{k,l} WS_{l,j}\f$ of the records, i.e. half the gradient of the result.
+    */
+    QuantLib::Real irTenorAggregation(const CrifRecord::RiskType& rt, const std::string& qualifier,
+                                      const std::vector<const CrifRecord*>& records,
+                                      const std::vector<QuantLib::Real>& ws, const bool subCurves,
+                                      std::vector<QuantLib::Real>* corrWs = nullptr) const;
+
+    /*! Aggregate the weighted sensitivities \p ws of the \p records in a \p bucket of risk type \p rt, i.e. give
+        back \f$\sum_{k,l} \rho_{k,l} f_{k,l} WS_k WS_l\f$. If the configuration has a constant correlation
+        between different qualifiers of the bucket, only pairs of records with the same qualifier are visited.
+        If \p corrWs is given, it is set to \f$\sum_l \rho_{k,l} f_{k,l} WS_l\f$ for each record, i.e. half the
+        gradient of the result.
+    */
+    QuantLib::Real intraBucketAggregation(const CrifRecord::RiskType& rt, const std::string& bucket,
+                                          const std::vector<const CrifRecord*>& records,
+                                          const std::vector<QuantLib::Real>& ws,
+                                          const std::map<std::string, QuantLib::Real>& concentrationRisk,
+                                          const std::string& calcCcy,
+                                          std::vector<QuantLib::Real>* corrWs = nullptr) const;
+
+    /*! Derivatives of \f$\sqrt{\sum_b K_b^2 + \sum_{b \neq c} \gamma_{b,c} S_b S_c}\f$ with
+        \f$S_b = \max(\min(\sum_k WS_{b,k}, K_b), -K_b)\f$ with respect to the bucket margins \f$K_b\f$ and to
+        the sums of weighted sensitivities \f$\sum_k WS_{b,k}\f$, given in \p k and \p sumWs, with the symmetric
+        correlations \p gamma. The derivatives are written to \p dK and \p dSumWs.
+    */
+    void aggregationGradients(const std::vector<QuantLib::Real>& k, const std::vector<QuantLib::Real>& sumWs,
+                              const QuantLib::Matrix& gamma, std::vector<QuantLib::Real>& dK,
+                              std::vector<QuantLib::Real>& dSumWs) const;
+
+    //! Regulations under which the CRIF record \p cr enters the netted sensitivities of the given \p side
+    std::set<std::string> recordRegulations(const CrifRecord& cr, const SimmSide& side) const;
+
+    //! FX spot to convert the USD denominated concentration thresholds to the result currency
+    QuantLib::Real concentrationThresholdFx() const;
 
     /*! Populate the results structure with the higher level results after the IMs have been
         calculated at the (product class, risk class, margin type) level for the given
         regulation under the given portfolio
     */
-    void populateResults(const SimmSide& side, const ore::data::NettingSetDetails& nsd, const string& regulation);
+    void populateResults(SimmResults& results, const SimmSide& side, const ore::data::NettingSetDetails& nsd) const;
 
     /*! Populate final (i.e. winning regulators') using own list of winning regulators, which were determined
         solely by the SIMM results (i.e. not including any external IMSchedule results)
@@ -214,18 +324,21 @@ private:
 
         \remark all additions to the results containers should happen in this method
     */
-    void add(const ore::data::NettingSetDetails& nettingSetDetails, const string& regulation,
+    void add(SimmResults& results, const ore::data::NettingSetDetails& nettingSetDetails,
              const CrifRecord::ProductClass& pc, const SimmConfiguration::RiskClass& rc,
              const SimmConfiguration::MarginType& mt, const std::string& b, QuantLib::Real margin, SimmSide side,
-             const bool overwrite = true);
+             const bool overwrite = true) const;
 
-    void add(const ore::data::NettingSetDetails& nettingSetDetails, const string& regulation,
+    void add(SimmResults& results, const ore::data::NettingSetDetails& nettingSetDetails,
              const CrifRecord::ProductClass& pc, const SimmConfiguration::RiskClass& rc,
              const SimmConfiguration::MarginType& mt, const std::map<std::string, QuantLib::Real>& margins, SimmSide side,
-             const bool overwrite = true);
+             const bool overwrite = true) const;
+
+    //! Give back a copy of \p cr with the amount in the result currency populated
+    CrifRecord resultCcyRecord(const CrifRecord& cr) const;
 
     //! Add CRIF record to the CRIF records container that correspondsd to the given regulation/s and portfolio ID
-    void splitCrifByRegulationsAndPortfolios(const Crif& crif, const bool enforceIMRegulations);
+    void splitCrifByRegulationsAndPortfolios(const Crif& crif);
 
     //! Give the \f$\lambda\f$ used in the curvature margin calculation
     QuantLib::Real lambda(QuantLib::Real theta) const;
@@ -88,6 +88,17 @@ const Size SimmConfiguration::numberOfRiskClasses = riskClassMap.size();
 const Size SimmConfiguration::numberOfMarginTypes = marginTypeMap.size();
 const Size SimmConfiguration::numberOfRegulations = regulationsMap.size();
 
+const Matrix& SimmConfiguration::label1Correlations(const CrifRecord::RiskType&) const {
+    static const Matrix empty;
+    return empty;
+}
+
+Size SimmConfiguration::label1Index(const CrifRecord::RiskType&, const string&) const { return Null<Size>(); }
+
+Real SimmConfiguration::constantIntraBucketCorrelation(const CrifRecord::RiskType&, const string&) const {
+    return Null<Real>();
+}
+
 set<SimmConfiguration::RiskClass> SimmConfiguration::riskClasses(bool includeAll) {
 
     // This only works if 'All' is the last enum value
@@ -30,6 +30,7 @@
 #include <orea/simm/crifconfiguration.hpp>
 #include <orea/simm/crifrecord.hpp>
 #include <ql/indexes/interestrateindex.hpp>
+#include <ql/math/matrix.hpp>
 #include <ql/types.hpp>
 
 namespace ore {
@@ -228,6 +229,22 @@ public:
                                        const std::string& secondLabel_1, const std::string& secondLabel_2,
                                        const std::string& calculationCurrency = "") const = 0;
 
+    /*! Return the Label1 level correlations between sensitivities of risk type \p rt with the same qualifier,
+        i.e. the IR tenor correlations, as a dense matrix indexed by label1Index(). An empty matrix is returned
+        if the correlations are not available in this form, in which case correlation() has to be used.
+    */
+    virtual const QuantLib::Matrix& label1Correlations(const CrifRecord::RiskType& rt) const;
+
+    //! Return the index of \p label_1 in label1Correlations(\p rt), or Null<Size>() if there is none
+    virtual QuantLib::Size label1Index(const CrifRecord::RiskType& rt, const std::string& label_1) const;
+
+    /*! Return the correlation between sensitivities of risk type \p rt with different qualifiers in \p bucket
+        if it is the same for all such pairs, i.e. does not depend on the qualifiers or labels. Return
+        Null<Real>() otherwise, in which case correlation() has to be used.
+    */
+    virtual QuantLib::Real constantIntraBucketCorrelation(const CrifRecord::RiskType& rt,
+                                                          const std::string& bucket) const;
+
     virtual bool isSimmConfigCalibration() const { return false; }
 
 protected:
@@ -105,8 +105,54 @@ vector<string> SimmConfigurationBase::labels2(const RiskType& rt) const {
     return lookup(rt, mapLabels_2_);
 }
 
+void SimmConfigurationBase::resetStaleCaches() const {
+    std::size_t version = simmBucketMapper_ ? simmBucketMapper_->version() : 0;
+    if (version != cacheVersion_) {
+        weightCache_.clear();
+        thresholdCache_.clear();
+        cacheVersion_ = version;
+    }
+}
+
 QuantLib::Real SimmConfigurationBase::weight(const RiskType& rt, boost::optional<string> qualifier,
                                              boost::optional<std::string> label_1, const std::string&) const {
+    auto key = std::make_tuple(rt, qualifier, label_1);
+    std::size_t version = simmBucketMapper_ ? simmBucketMapper_->version() : 0;
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cacheMutex_);
+        if (version == cacheVersion_) {
+            auto it = weightCache_.find(key);
+            if (it != weightCache_.end())
+                return it->second;
+        }
+    }
+    Real w = weightImpl(rt, qualifier, label_1);
+    boost::unique_lock<boost::shared_mutex> lock(cacheMutex_);
+    resetStaleCaches();
+    weightCache_[key] = w;
+    return w;
+}
+
+Real SimmConfigurationBase::concentrationThreshold(const RiskType& rt, const string& qualifier) const {
+    auto key = std::make_pair(rt, qualifier);
+    std::size_t version = simmBucketMapper_ ? simmBucketMapper_->version() : 0;
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cacheMutex_);
+        if (version == cacheVersion_) {
+            auto it = thresholdCache_.find(key);
+            if (it != thresholdCache_.end())
+                return it->second;
+        }
+    }
+    Real t = simmConcentration_->threshold(rt, qualifier);
+    boost::unique_lock<boost::shared_mutex> lock(cacheMutex_);
+    resetStaleCaches();
+    thresholdCache_[key] = t;
+    return t;
+}
+
+QuantLib::Real SimmConfigurationBase::weightImpl(const RiskType& rt, const boost::optional<string>& qualifier,
+                                                 const boost::optional<std::string>& label_1) const {
 
     QL_REQUIRE(isValidRiskType(rt),
                "The risk type " << rt << " is not valid for SIMM configuration with name" << name_);
@@ -459,6 +505,83 @@ Size SimmConfigurationBase::labelIndex(const string& label, const vector<string>
     return std::distance(labels.begin(), it);
 }
 
+const Matrix& SimmConfigurationBase::label1Correlations(const RiskType& rt) const {
+    if (rt != RiskType::IRCurve && rt != RiskType::IRVol)
+        return SimmConfiguration::label1Correlations(rt);
+    std::call_once(compileFlag_, [this]() { compileTables(); });
+    return irTenorCorrelation_;
+}
+
+Size SimmConfigurationBase::label1Index(const RiskType& rt, const string& label_1) const {
+    if (rt != RiskType::IRCurve && rt != RiskType::IRVol)
+        return SimmConfiguration::label1Index(rt, label_1);
+    std::call_once(compileFlag_, [this]() { compileTables(); });
+    auto it = irTenorIndex_.find(label_1);
+    return it == irTenorIndex_.end() ? Null<Size>() : it->second;
+}
+
+Real SimmConfigurationBase::constantIntraBucketCorrelation(const RiskType& rt, const string& bucket) const {
+
+    // Intra bucket correlation looked up by bucket, Null if there is none
+    auto intraBucket = [this, &bucket](const RiskType& deltaRt) {
+        auto corrs = intraBucketCorrelation_.find(deltaRt);
+        if (corrs == intraBucketCorrelation_.end())
+            return Null<Real>();
+        auto c = corrs->second.find(makeKey(bucket, "", ""));
+        return c == corrs->second.end() ? Null<Real>() : c->second;
+    };
+
+    switch (rt) {
+    case RiskType::Equity:
+    case RiskType::EquityVol:
+        return bucket == "Residual" ? 0.0 : intraBucket(RiskType::Equity);
+    case RiskType::Commodity:
+    case RiskType::CommodityVol:
+        return intraBucket(RiskType::Commodity);
+    case RiskType::CreditQ:
+    case RiskType::CreditVol:
+        return bucket == "Residual" ? crqResidualIntraCorr_ : crqDiffIntraCorr_;
+    case RiskType::CreditNonQ:
+    case RiskType::CreditVolNonQ:
+        if (bucket == "Residual")
+            return crnqResidualIntraCorr_;
+        // From ISDA SIMM 2.2 the correlation depends on the Label2 values
+        if (isSimmConfigCalibration() || parseSimmVersion(version_) >= SimmVersion::V2_2)
+            return Null<Real>();
+        return crnqDiffIntraCorr_;
+    case RiskType::BaseCorr:
+        return basecorrCorr_;
+    default:
+        return SimmConfiguration::constantIntraBucketCorrelation(rt, bucket);
+    }
+}
+
+void SimmConfigurationBase::compileTables() const {
+    auto labels = mapLabels_1_.find(RiskType::IRCurve);
+    auto corrs = intraBucketCorrelation_.find(RiskType::IRCurve);
+    if (labels == mapLabels_1_.end() || corrs == intraBucketCorrelation_.end() || labels->second.empty())
+        return;
+
+    const vector<string>& tenors = labels->second;
+    Matrix m(tenors.size(), tenors.size(), 1.0);
+    for (Size i = 0; i < tenors.size(); ++i) {
+        for (Size j = 0; j < tenors.size(); ++j) {
+            if (i == j)
+                continue;
+            auto c = corrs->second.find(makeKey("", tenors[i], tenors[j]));
+            if (c == corrs->second.end()) {
+                // Incomplete table, the callers fall back to correlation() which reports the missing entry
+                return;
+            }
+            m[i][j] = c->second;
+        }
+    }
+
+    irTenorCorrelation_ = m;
+    for (Size i = 0; i < tenors.size(); ++i)
+        irTenorIndex_[tenors[i]] = i;
+}
+
 void SimmConfigurationBase::addLabels2Impl(const RiskType& rt, const string& label_2) {
     // Only currently need this for risk type CreditQ
     QL_REQUIRE(rt == RiskType::CreditQ, "addLabels2 only supported for RiskType_CreditQ");
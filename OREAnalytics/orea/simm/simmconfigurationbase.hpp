@@ -30,6 +30,10 @@
 #include <ql/math/matrix.hpp>
 
 #include <map>
+#include <mutex>
+#include <tuple>
+
+#include <boost/thread/shared_mutex.hpp>
 
 namespace ore {
 namespace analytics {
@@ -79,6 +83,10 @@ public:
            so need \p rt and \p qualifier
         -# there is a qualifier-dependent and label1-dependent risk weight for the risk
            factor's RiskType so need all three parameters
+
+        The risk weights are cached by (risk type, qualifier, Label1), so that repeated calculations, e.g. for many
+        scenario shifted CRIFs sharing this configuration, do not repeat the bucket lookups. The cache is reset when
+        the bucket mapper's mappings change.
     */
     QuantLib::Real weight(const CrifRecord::RiskType& rt, boost::optional<std::string> qualifier = boost::none,
                           boost::optional<std::string> label_1 = boost::none,
@@ -120,11 +128,9 @@ public:
     QuantLib::Real curvatureMarginScaling() const override { return 2.3; }
 
     /*! Give back the SIMM <em>concentration threshold</em> for the risk type \p rt and the
-        SIMM \p qualifier
+        SIMM \p qualifier, cached in the same way as the risk weights
     */
-    QuantLib::Real concentrationThreshold(const CrifRecord::RiskType& rt, const std::string& qualifier) const override {
-        return simmConcentration_->threshold(rt, qualifier);
-    }
+    QuantLib::Real concentrationThreshold(const CrifRecord::RiskType& rt, const std::string& qualifier) const override;
 
     /*! Return true if \p rt is a valid SIMM <em>RiskType</em> under the current configuration.
         Otherwise, return false.
@@ -152,6 +158,21 @@ public:
                                const std::string& secondLabel_1, const std::string& secondLabel_2,
                                const std::string& calculationCurrency = "") const override;
 
+    /*! Return the IR tenor correlations for \p rt IRCurve or IRVol, compiled on first use from the
+        Label1 level entries in intraBucketCorrelation_. Both risk types use the IRCurve tenor correlations
+        and the IRCurve Label1 values, in line with correlation().
+    */
+    const QuantLib::Matrix& label1Correlations(const CrifRecord::RiskType& rt) const override;
+
+    //! Return the index of \p label_1 in the IRCurve Label1 values for \p rt IRCurve or IRVol
+    QuantLib::Size label1Index(const CrifRecord::RiskType& rt, const std::string& label_1) const override;
+
+    /*! Return the constant correlation between different qualifiers in the same bucket for the Equity, Commodity,
+        CreditQ and CreditNonQ delta and vega risk types and for BaseCorr, consistent with correlation()
+    */
+    QuantLib::Real constantIntraBucketCorrelation(const CrifRecord::RiskType& rt,
+                                                  const std::string& bucket) const override;
+
     //! MPOR in days
     QuantLib::Size mporDays() const { return mporDays_; }
 
@@ -161,6 +182,34 @@ private:
     //! Calculate variable for use in sigma method
     QuantLib::Real sigmaMultiplier() const;
 
+    /*! Compile the dense IR tenor correlation table. The tables are populated by the derived class constructors, so
+        this happens lazily on first use, guarded by compileFlag_ since the SIMM calculation may be multi-threaded.
+    */
+    void compileTables() const;
+    mutable std::once_flag compileFlag_;
+    //! IR tenor correlations, empty if some tenor pair has no correlation
+    mutable QuantLib::Matrix irTenorCorrelation_;
+    //! Index of the IRCurve Label1 values in irTenorCorrelation_
+    mutable std::map<std::string, QuantLib::Size> irTenorIndex_;
+
+    //! Uncached risk weight lookup
+    QuantLib::Real weightImpl(const CrifRecord::RiskType& rt, const boost::optional<std::string>& qualifier,
+                              const boost::optional<std::string>& label_1) const;
+
+    //! Clear the caches if the bucket mapper's mappings have changed, requires a unique lock on cacheMutex_
+    void resetStaleCaches() const;
+
+    //! Risk weights by risk type, qualifier and Label1
+    mutable std::map<std::tuple<CrifRecord::RiskType, boost::optional<std::string>, boost::optional<std::string>>,
+                     QuantLib::Real>
+        weightCache_;
+    //! Concentration thresholds by risk type and qualifier
+    mutable std::map<std::pair<CrifRecord::RiskType, std::string>, QuantLib::Real> thresholdCache_;
+    //! The bucket mapper version the caches are valid for
+    mutable std::size_t cacheVersion_ = 0;
+    //! Guards the caches, the lookups may be called concurrently by the SIMM calculator
+    mutable boost::shared_mutex cacheMutex_;
+
 protected:
     //! Constructor taking the SIMM configuration \p name and \p version
     SimmConfigurationBase(const QuantLib::ext::shared_ptr<SimmBucketMapper>& simmBucketMapper, const std::string& name,
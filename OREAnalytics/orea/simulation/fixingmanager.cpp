@@ -39,6 +39,8 @@
 #include <ql/experimental/coupons/cmsspreadcoupon.hpp>
 #include <ql/experimental/coupons/digitalcmsspreadcoupon.hpp>
 
+#include <algorithm>
+
 using namespace std;
 using namespace QuantLib;
 using namespace QuantExt;
@@ -58,62 +60,84 @@ Date nextValidFixingDate(Date d, const QuantLib::ext::shared_ptr<Index>& index,
     QL_FAIL("no valid fixing date found for index " << index->name() << " within gap from " << io::iso_date(d));
 }
 
-FixingManager::FixingManager(Date today) : today_(today), fixingsEnd_(today), modifiedFixingHistory_(false) {}
+FixingManager::FixingManager(Date today) : today_(today), fixingsEnd_(today) {}
 
 //! Initialise the manager-
 
 void FixingManager::initialise(const QuantLib::ext::shared_ptr<Portfolio>& portfolio, const QuantLib::ext::shared_ptr<Market>& market,
                                const std::string& configuration) {
 
-    // populate the map "Index -> set of required fixing dates", where the index on the LHS is linked to curves
+    // collect the required fixing dates per index name over all trades first, so that each index is parsed and
+    // looked up in the market only once
+
+    std::map<std::string, std::set<Date>> requiredDates;
     for (auto const& [tradeId,t] : portfolio->trades()) {
         auto r = t->requiredFixings();
         r.unsetPayDates();
         for (auto const& [name, fixingDates] : r.fixingDatesIndices(QuantLib::Date::maxDate())) {
-            std::set<Date> dates;
+            auto& dates = requiredDates[name];
             for (const auto& [d, _] : fixingDates) {
-                dates.insert(d);
+                dates.insert(dates.end(), d);
             }
-            try {
-                auto rawIndex = parseIndex(name);
-                if (auto index = QuantLib::ext::dynamic_pointer_cast<EquityIndex2>(rawIndex)) {
-                    
-                    fixingMap_[*market->equityCurve(index->familyName(), configuration)].insert(dates.begin(),
-                                                                                                dates.end());
-                } else if (auto index = QuantLib::ext::dynamic_pointer_cast<BondIndex>(rawIndex)) {
-                    QL_FAIL("BondIndex not handled");
-                } else if (auto index = QuantLib::ext::dynamic_pointer_cast<CommodityIndex>(rawIndex)) {
-                    // for comm indices with non-daily expiries the expiry date's day of month is 1 always
-                    Date safeExpiryDate = index->expiryDate();
-                    if (safeExpiryDate != Date() && !index->keepDays()) {
-                        safeExpiryDate = Date::endOfMonth(safeExpiryDate);
-                    }
-                    fixingMap_[index->clone(safeExpiryDate,
-                                            market->commodityPriceCurve(index->underlyingName(), configuration))]
-                        .insert(dates.begin(), dates.end());
-                } else if (auto index = QuantLib::ext::dynamic_pointer_cast<FxIndex>(rawIndex)) {
-                    fixingMap_[*market->fxIndex(index->oreName(), configuration)].insert(dates.begin(), dates.end());
-                } else if (auto index = QuantLib::ext::dynamic_pointer_cast<GenericIndex>(rawIndex)) {
-                    QL_FAIL("GenericIndex not handled");
-                } else if (auto index = QuantLib::ext::dynamic_pointer_cast<ConstantMaturityBondIndex>(rawIndex)) {
-                    QL_FAIL("ConstantMaturityBondIndex not handled");
-                } else if (auto index = QuantLib::ext::dynamic_pointer_cast<IborIndex>(rawIndex)) {
-                    fixingMap_[*market->iborIndex(name, configuration)].insert(dates.begin(), dates.end());
-                } else if (auto index = QuantLib::ext::dynamic_pointer_cast<SwapIndex>(rawIndex)) {
-                    fixingMap_[*market->swapIndex(name, configuration)].insert(dates.begin(), dates.end());
-                } else if (auto index = QuantLib::ext::dynamic_pointer_cast<ZeroInflationIndex>(rawIndex)) {
-                    fixingMap_[*market->zeroInflationIndex(name, configuration)].insert(dates.begin(), dates.end());
+        }
+    }
+
+    // populate the map "Index -> set of required fixing dates", where the index on the LHS is linked to curves
+    for (auto const& [name, dates] : requiredDates) {
+        try {
+            auto rawIndex = parseIndex(name);
+            if (auto index = QuantLib::ext::dynamic_pointer_cast<EquityIndex2>(rawIndex)) {
+                
+                fixingMap_[*market->equityCurve(index->familyName(), configuration)].insert(dates.begin(),
+                                                                                            dates.end());
+            } else if (auto index = QuantLib::ext::dynamic_pointer_cast<BondIndex>(rawIndex)) {
+                QL_FAIL("BondIndex not handled");
+            } else if (auto index = QuantLib::ext::dynamic_pointer_cast<CommodityIndex>(rawIndex)) {
+                // for comm indices with non-daily expiries the expiry date's day of month is 1 always
+                Date safeExpiryDate = index->expiryDate();
+                if (safeExpiryDate != Date() && !index->keepDays()) {
+                    safeExpiryDate = Date::endOfMonth(safeExpiryDate);
                 }
-            } catch (const std::exception& e) {
-                ALOG("FixingManager: error " << e.what() << " - no fixings are added for '" << name << "'");
+                fixingMap_[index->clone(safeExpiryDate,
+                                        market->commodityPriceCurve(index->underlyingName(), configuration))]
+                    .insert(dates.begin(), dates.end());
+            } else if (auto index = QuantLib::ext::dynamic_pointer_cast<FxIndex>(rawIndex)) {
+                fixingMap_[*market->fxIndex(index->oreName(), configuration)].insert(dates.begin(), dates.end());
+            } else if (auto index = QuantLib::ext::dynamic_pointer_cast<GenericIndex>(rawIndex)) {
+                QL_FAIL("GenericIndex not handled");
+            } else if (auto index = QuantLib::ext::dynamic_pointer_cast<ConstantMaturityBondIndex>(rawIndex)) {
+                QL_FAIL("ConstantMaturityBondIndex not handled");
+            } else if (auto index = QuantLib::ext::dynamic_pointer_cast<IborIndex>(rawIndex)) {
+                fixingMap_[*market->iborIndex(name, configuration)].insert(dates.begin(), dates.end());
+            } else if (auto index = QuantLib::ext::dynamic_pointer_cast<SwapIndex>(rawIndex)) {
+                fixingMap_[*market->swapIndex(name, configuration)].insert(dates.begin(), dates.end());
+            } else if (auto index = QuantLib::ext::dynamic_pointer_cast<ZeroInflationIndex>(rawIndex)) {
+                fixingMap_[*market->zeroInflationIndex(name, configuration)].insert(dates.begin(), dates.end());
             }
-            TLOG("Added " << dates.size() << " fixing dates for '" << name << "'");
+        } catch (const std::exception& e) {
+            ALOG("FixingManager: error " << e.what() << " - no fixings are added for '" << name << "'");
         }
+        TLOG("Added " << dates.size() << " fixing dates for '" << name << "'");
     }
 
-    // Now cache the original fixings so we can re-write on reset()
-    for (auto const& m : fixingMap_) {
-        fixingCache_[m.first] = IndexManager::instance().getHistory(m.first->name());
+    // Now set up the slots with the valid fixing dates and the original fixings so we can re-write on reset(), the
+    // compiled fixing actions refer to the slots and are discarded
+    rollbackFixings();
+    fixingActions_.clear();
+    fixingSlots_.clear();
+    fixingSlots_.reserve(fixingMap_.size());
+    for (auto const& [index, dates] : fixingMap_) {
+        FixingSlot slot;
+        slot.index = index;
+        const TimeSeries<Real>& history = IndexManager::instance().getHistory(index->name());
+        for (auto const& d : dates) {
+            // Fixing dates include the valuation grid dates which might not be valid fixing dates (BMA/SIFMA)
+            if (index->isValidFixingDate(d)) {
+                slot.dates.push_back(d);
+                slot.original.push_back(history[d]);
+            }
+        }
+        fixingSlots_.push_back(slot);
     }
 }
 
@@ -131,28 +155,88 @@ void FixingManager::update(Date d) {
 
 //! Reset fixings to t0 (today)
 void FixingManager::reset() {
-    if (modifiedFixingHistory_) {
-        for (auto& kv : fixingCache_)
-            IndexManager::instance().setHistory(kv.first->name(), kv.second);
-        modifiedFixingHistory_ = false;
-    }
+    rollbackFixings();
     fixingsEnd_ = today_;
 }
 
-void FixingManager::applyFixings(Date start, Date end) {
-    // Loop over all indices
-    for (auto const& m : fixingMap_) {
+void FixingManager::rollbackFixings() {
+    if (appliedActions_.empty())
+        return;
+
+    // collect the dates we have written per slot
+    std::map<Size, std::vector<bool>> written;
+    for (auto const a : appliedActions_) {
+        auto& w = written[a->slot];
+        w.resize(fixingSlots_[a->slot].dates.size(), false);
+        std::fill(w.begin() + a->begin, w.begin() + a->end, true);
+    }
+    appliedActions_.clear();
+
+    // restore the original fixings with one call per index, dates without an original fixing are removed again
+    for (auto const& [s, w] : written) {
+        const FixingSlot& slot = fixingSlots_[s];
+        std::vector<Date> dates;
+        std::vector<Real> values;
+        bool erase = false;
+        for (Size i = 0; i < w.size(); ++i) {
+            if (!w[i])
+                continue;
+            if (slot.original[i] == Null<Real>()) {
+                erase = true;
+            } else {
+                dates.push_back(slot.dates[i]);
+                values.push_back(slot.original[i]);
+            }
+        }
+        if (!erase) {
+            slot.index->addFixings(dates.begin(), dates.end(), values.begin(), true);
+            continue;
+        }
+        // a time series does not support erasing single dates, so the history is rebuilt without the added dates
+        const TimeSeries<Real>& history = IndexManager::instance().getHistory(slot.index->name());
+        dates.clear();
+        values.clear();
+        dates.reserve(history.size());
+        values.reserve(history.size());
+        Size i = 0;
+        for (auto const& [d, v] : history) {
+            while (i < slot.dates.size() && slot.dates[i] < d)
+                ++i;
+            if (i < slot.dates.size() && slot.dates[i] == d && w[i]) {
+                if (slot.original[i] != Null<Real>()) {
+                    dates.push_back(d);
+                    values.push_back(slot.original[i]);
+                }
+            } else {
+                dates.push_back(d);
+                values.push_back(v);
+            }
+        }
+        IndexManager::instance().setHistory(slot.index->name(),
+                                            TimeSeries<Real>(dates.begin(), dates.end(), values.begin()));
+    }
+}
+
+const std::vector<FixingManager::FixingAction>& FixingManager::fixingActions(Date start, Date end) {
+    auto a = fixingActions_.find(std::make_pair(start, end));
+    if (a != fixingActions_.end())
+        return a->second;
+
+    // compile the actions for this step, they are the same for all paths
+    std::vector<FixingAction> actions;
+    for (Size i = 0; i < fixingSlots_.size(); ++i) {
+        const FixingSlot& slot = fixingSlots_[i];
         Date fixStart = start;
         Date fixEnd = end;
         Date currentFixingDate;
-        if (auto zii = QuantLib::ext::dynamic_pointer_cast<ZeroInflationIndex>(m.first)) {
+        if (auto zii = QuantLib::ext::dynamic_pointer_cast<ZeroInflationIndex>(slot.index)) {
             fixStart =
                 inflationPeriod(fixStart - zii->zeroInflationTermStructure()->observationLag(), zii->frequency()).first;
             fixEnd =
                 inflationPeriod(fixEnd - zii->zeroInflationTermStructure()->observationLag(), zii->frequency()).first +
                 1;
             currentFixingDate = fixEnd;
-        } else if (auto yii = QuantLib::ext::dynamic_pointer_cast<YoYInflationIndex>(m.first)) {
+        } else if (auto yii = QuantLib::ext::dynamic_pointer_cast<YoYInflationIndex>(slot.index)) {
             fixStart =
                 inflationPeriod(fixStart - yii->yoyInflationTermStructure()->observationLag(), yii->frequency()).first;
             fixEnd =
@@ -160,45 +244,40 @@ void FixingManager::applyFixings(Date start, Date end) {
                 1;
             currentFixingDate = fixEnd;
         } else {
-            currentFixingDate = m.first->fixingCalendar().adjust(fixEnd, Following);
+            currentFixingDate = slot.index->fixingCalendar().adjust(fixEnd, Following);
             // This date is a business day but may not be a valid fixing date in case of BMA/SIFMA
-            if (!m.first->isValidFixingDate(currentFixingDate))
-                currentFixingDate = nextValidFixingDate(currentFixingDate, m.first);
+            if (!slot.index->isValidFixingDate(currentFixingDate))
+                currentFixingDate = nextValidFixingDate(currentFixingDate, slot.index);
         }
 
         // Add we have a coupon between start and asof.
-        bool needFixings = false;
-        for (auto const& d : m.second) {
-            if (d >= fixStart && d < fixEnd) {
-                needFixings = true;
-                break;
-            }
+        Size begin = std::lower_bound(slot.dates.begin(), slot.dates.end(), fixStart) - slot.dates.begin();
+        Size end = std::lower_bound(slot.dates.begin() + begin, slot.dates.end(), fixEnd) - slot.dates.begin();
+        if (begin < end) {
+            auto comm = QuantLib::ext::dynamic_pointer_cast<QuantExt::CommodityIndex>(slot.index);
+            actions.push_back({i, currentFixingDate, comm != nullptr && comm->expiryDate() < currentFixingDate, begin,
+                               end});
         }
+    }
 
-        if (needFixings) {
-            Rate currentFixing;
-            if (auto comm = QuantLib::ext::dynamic_pointer_cast<QuantExt::CommodityIndex>(m.first);
-                comm != nullptr && comm->expiryDate() < currentFixingDate) {
-                currentFixing = comm->priceCurve()->price(currentFixingDate);
-            } else {
-                currentFixing = m.first->fixing(currentFixingDate);
-            }
-            // if we read the fixing from an inverted FxIndex we have to undo the inversion
-            TimeSeries<Real> history;
-            for (auto const& d : m.second) {
-                if (d >= fixStart && d < fixEnd) {
-                    // Fixing dates include the valuation grid dates which might not be valid fixing dates (BMA/SIFMA)
-                    bool valid = m.first->isValidFixingDate(d);
-                    if (valid) {
-                        history[d] = currentFixing;
-                        modifiedFixingHistory_ = true;
-                    }
-                }
-                if (d >= fixEnd)
-                    break;
-            }
-            m.first->addFixings(history, true);
+    TLOG("FixingManager: compiled " << actions.size() << " fixing actions for " << io::iso_date(start) << " - "
+                                    << io::iso_date(end));
+    return fixingActions_.emplace(std::make_pair(start, end), std::move(actions)).first->second;
+}
+
+void FixingManager::applyFixings(Date start, Date end) {
+    for (auto const& a : fixingActions(start, end)) {
+        const FixingSlot& slot = fixingSlots_[a.slot];
+        Rate currentFixing;
+        if (a.commodityPrice) {
+            auto comm = QuantLib::ext::static_pointer_cast<QuantExt::CommodityIndex>(slot.index);
+            currentFixing = comm->priceCurve()->price(a.fixingDate);
+        } else {
+            currentFixing = slot.index->fixing(a.fixingDate);
         }
+        std::vector<Real> values(a.end - a.begin, currentFixing);
+        slot.index->addFixings(slot.dates.begin() + a.begin, slot.dates.begin() + a.end, values.begin(), true);
+        appliedActions_.push_back(&a);
     }
 }
 
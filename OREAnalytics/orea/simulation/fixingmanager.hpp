@@ -52,6 +52,11 @@ struct IndexComparator {
   When stepping between simulation dated t_(n-1) and t_(n) and update a fixing t with t_(n-1) < t < t(n) than the fixing
   from t(n) will be backfilled. There is currently no interpolation of fixings.
 
+  The fixings to set for a step (t_(n-1), t_(n)) only depend on the step, not on the path. They are compiled into a
+  list of actions on the first visit of the step and reused for all subsequent paths. On reset() only the fixings
+  added since the last reset are rolled back, each index is restored in one call and dates without an original fixing
+  are removed from the history again.
+
   \ingroup simulation
  */
 class FixingManager {
@@ -74,15 +79,32 @@ public:
     using FixingMap = std::map<QuantLib::ext::shared_ptr<Index>, std::set<Date>, detail::IndexComparator>;
 
 private:
+    //! An index with its required valid fixing dates and the original fixings on these dates (or Null)
+    struct FixingSlot {
+        QuantLib::ext::shared_ptr<Index> index;
+        std::vector<Date> dates;
+        std::vector<Real> original;
+    };
+
+    //! Set the fixings on the dates [begin, end) of a slot to the index fixing on fixingDate
+    struct FixingAction {
+        Size slot;
+        Date fixingDate;
+        bool commodityPrice;
+        Size begin, end;
+    };
+
     void applyFixings(Date start, Date end);
+    const std::vector<FixingAction>& fixingActions(Date start, Date end);
+    void rollbackFixings();
 
     Date today_, fixingsEnd_;
-    bool modifiedFixingHistory_;
-
-    using FixingCache = std::map<QuantLib::ext::shared_ptr<Index>, TimeSeries<Real>, detail::IndexComparator>;
 
     FixingMap fixingMap_;
-    FixingCache fixingCache_;
+    std::vector<FixingSlot> fixingSlots_;
+    std::map<std::pair<Date, Date>, std::vector<FixingAction>> fixingActions_;
+    // the actions applied since the last reset
+    std::vector<const FixingAction*> appliedActions_;
 };
 
 } // namespace analytics
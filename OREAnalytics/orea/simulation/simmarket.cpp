@@ -18,6 +18,36 @@
 
 #include <orea/simulation/simmarket.hpp>
 
+#include <ql/patterns/observable.hpp>
+
 namespace ore {
-namespace analytics {}
+namespace analytics {
+
+SimMarket::QuoteUpdateBatch::QuoteUpdateBatch(SimMarket& market)
+    : market_(market), deferred_(ObservableSettings::instance().updatesEnabled()) {
+    if (deferred_)
+        ObservableSettings::instance().disableUpdates(true);
+}
+
+SimMarket::QuoteUpdateBatch::~QuoteUpdateBatch() {
+    if (!finished_ && deferred_) {
+        try {
+            ObservableSettings::instance().enableUpdates();
+        } catch (...) {
+        }
+    }
+}
+
+Size SimMarket::QuoteUpdateBatch::finish() {
+    QL_REQUIRE(!finished_, "SimMarket::QuoteUpdateBatch::finish(): batch already finished");
+    finished_ = true;
+    market_.changedQuotes_ = changed_;
+    if (changed_ > 0)
+        market_.marketChanged_ = true;
+    if (deferred_)
+        ObservableSettings::instance().enableUpdates();
+    return changed_;
+}
+
+} // namespace analytics
 } // namespace ore
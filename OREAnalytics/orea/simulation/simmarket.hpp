@@ -28,6 +28,8 @@
 #include <ored/configuration/conventions.hpp>
 #include <ored/marketdata/marketimpl.hpp>
 
+#include <ql/quotes/simplequote.hpp>
+
 namespace ore {
 namespace analytics {
 using namespace ore::data;
@@ -39,6 +41,10 @@ using namespace ore::data;
   to apply the scenario to its term structures and to notify all termstructures and
   instruments of this change so that the instruments are recalculated with the NPV call.
 
+  Quote updates belonging to one scenario should be applied through a QuoteUpdateBatch, so that observers are
+  notified once per scenario rather than once per changed quote, and so that a market wide refresh can be skipped
+  if a scenario does not change anything.
+
   \ingroup simulation
  */
 class SimMarket : public ore::data::MarketImpl {
@@ -81,9 +87,54 @@ public:
     //! Get the fixing manager
     virtual const QuantLib::ext::shared_ptr<FixingManager>& fixingManager() const = 0;
 
+    //! Batch of quote updates with a single notification pass
+    /*! If observable updates are enabled on construction, notifications are deferred until finish() is called. The
+        deferred observers are collected in a set by QuantLib, so each term structure or instrument depending on the
+        updated quotes is notified exactly once, no matter how many of its quotes changed. If updates are already
+        disabled or deferred (ObservationMode Disable, Defer), the batch leaves the observable settings alone.
+
+        Quotes whose value does not change do not notify at all. The number of changed quotes is recorded on the
+        market, see changedQuotes() and marketChanged(). */
+    class QuoteUpdateBatch {
+    public:
+        explicit QuoteUpdateBatch(SimMarket& market);
+        //! re-enables updates if finish() was not called, e.g. because an exception was thrown
+        ~QuoteUpdateBatch();
+        QuoteUpdateBatch(const QuoteUpdateBatch&) = delete;
+        QuoteUpdateBatch& operator=(const QuoteUpdateBatch&) = delete;
+
+        //! Set the quote's value, observers are only notified if the value changes, returns true if it changed
+        bool set(SimpleQuote& quote, const Real value) {
+            if (quote.setValue(value) != 0.0) {
+                ++changed_;
+                return true;
+            }
+            return false;
+        }
+        //! Number of quotes changed so far in this batch
+        Size changed() const { return changed_; }
+        //! Notify the deferred observers, returns the number of changed quotes
+        Size finish();
+
+    private:
+        SimMarket& market_;
+        bool deferred_;
+        bool finished_ = false;
+        Size changed_ = 0;
+    };
+
+    //! Number of quotes changed by the last QuoteUpdateBatch
+    Size changedQuotes() const { return changedQuotes_; }
+
+    /*! True if quotes or the evaluation date have changed since the last call to refresh(), i.e. if term structures
+        with disabled notifications might be stale */
+    bool marketChanged() const { return marketChanged_; }
+
 protected:
     Real numeraire_;
     std::string label_;
+    Size changedQuotes_ = 0;
+    bool marketChanged_ = true;
 };
 } // namespace analytics
 } // namespace ore
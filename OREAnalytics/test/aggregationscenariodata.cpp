@@ -63,6 +63,44 @@ BOOST_AUTO_TEST_CASE(testInMemoryAggregationScenarioData) {
             BOOST_CHECK_CLOSE(data.get(i, j, AggregationScenarioDataType::FXSpot, "EURGBP"), 2.0 + i + 0.1 * j, tol);
         }
     }
+
+    // contiguous access
+    const Real* fx = data.data(AggregationScenarioDataType::FXSpot, "EURUSD");
+    BOOST_REQUIRE(fx != nullptr);
+    BOOST_CHECK_CLOSE(fx[2 * 5 + 3], 2.3, tol);
+    BOOST_CHECK(data.data(AggregationScenarioDataType::Generic, "blabla") == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(testInMemoryAggregationScenarioDataSlots) {
+    SinglePrecisionInMemoryAggregationScenarioData data(3, 5);
+
+    Size numeraire = data.addSlot(AggregationScenarioDataType::Numeraire);
+    Size fx = data.addSlot(AggregationScenarioDataType::FXSpot, "EURUSD");
+    BOOST_CHECK_EQUAL(data.addSlot(AggregationScenarioDataType::Numeraire), numeraire);
+    BOOST_CHECK_EQUAL(data.slot(AggregationScenarioDataType::FXSpot, "EURUSD"), fx);
+    BOOST_CHECK_THROW(data.slot(AggregationScenarioDataType::FXSpot, "EURGBP"), std::exception);
+
+    // traversal by slot, dates then samples
+    for (Size j = 0; j < 5; ++j) {
+        for (Size i = 0; i < 3; ++i) {
+            data.set(1.0 + 0.1 * i + 0.01 * j, numeraire);
+            data.set(i + 0.1 * j, fx);
+            data.next();
+        }
+    }
+
+    BOOST_CHECK_THROW(data.get(0, 0, 2), std::exception);
+    Real tol = 1.0E-4;
+    for (Size i = 0; i < 3; ++i) {
+        for (Size j = 0; j < 5; ++j) {
+            BOOST_CHECK_CLOSE(data.get(i, j, numeraire), 1.0 + 0.1 * i + 0.01 * j, tol);
+            BOOST_CHECK_CLOSE(data.get(i, j, AggregationScenarioDataType::FXSpot, "EURUSD"), i + 0.1 * j, tol);
+        }
+    }
+
+    const float* n = data.data(AggregationScenarioDataType::Numeraire);
+    BOOST_REQUIRE(n != nullptr);
+    BOOST_CHECK_CLOSE(n[2 * 5 + 3], 1.23, tol);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/app/analyticsmanager.hpp>
+#include <orea/app/initbuilders.hpp>
+#include <orea/app/inputparameters.hpp>
+#include <orea/app/marketdatacsvloader.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/report/inmemoryreport.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+using namespace ore::analytics;
+using namespace ore::data;
+using namespace QuantLib;
+
+namespace {
+
+// runs the NPV and STRESS analytics with the given number of analytics threads
+Analytic::analytic_reports runAnalytics(const Size nAnalyticsThreads) {
+    auto inputs = QuantLib::ext::make_shared<InputParameters>();
+    inputs->setAsOfDate("2016-02-05");
+    inputs->setBaseCurrency("EUR");
+    inputs->setThreads(2);
+    inputs->setAnalyticsThreads(nAnalyticsThreads);
+    inputs->setConventionsFromFile(TEST_INPUT_FILE("conventions.xml"));
+    inputs->setCurveConfigsFromFile(TEST_INPUT_FILE("curveconfig.xml"));
+    inputs->setTodaysMarketParamsFromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+    inputs->setPricingEngineFromFile(TEST_INPUT_FILE("pricingengine.xml"));
+    inputs->setPortfolioFromFile("portfolio.xml", TEST_INPUT_PATH.string());
+    inputs->setStressSimMarketParamsFromFile(TEST_INPUT_FILE("simulation.xml"));
+    inputs->setStressScenarioDataFromFile(TEST_INPUT_FILE("stresstest.xml"));
+    inputs->setStressPricingEngineFromFile(TEST_INPUT_FILE("pricingengine.xml"));
+    inputs->setStressThreshold(0.0);
+    inputs->insertAnalytic("NPV");
+    inputs->insertAnalytic("STRESS");
+
+    auto loader = QuantLib::ext::make_shared<MarketDataCsvLoader>(
+        inputs, QuantLib::ext::make_shared<CSVLoader>(TEST_INPUT_FILE("market.txt"), TEST_INPUT_FILE("fixings.txt"),
+                                                      false));
+    AnalyticsManager manager(inputs, loader);
+    manager.runAnalytics();
+    return manager.reports();
+}
+
+void checkReportsEqual(const QuantLib::ext::shared_ptr<InMemoryReport>& r1,
+                       const QuantLib::ext::shared_ptr<InMemoryReport>& r2) {
+    BOOST_REQUIRE(r1 && r2);
+    BOOST_REQUIRE_EQUAL(r1->columns(), r2->columns());
+    BOOST_REQUIRE_EQUAL(r1->rows(), r2->rows());
+    BOOST_CHECK(r1->rows() > 0);
+    for (Size i = 0; i < r1->columns(); ++i) {
+        BOOST_CHECK_EQUAL(r1->header(i), r2->header(i));
+        for (Size j = 0; j < r1->rows(); ++j) {
+            auto const& v1 = r1->data(i, j);
+            auto const& v2 = r2->data(i, j);
+            if (const Real* x = boost::get<Real>(&v1)) {
+                const Real* y = boost::get<Real>(&v2);
+                BOOST_REQUIRE(y);
+                BOOST_CHECK_SMALL(*x - *y, 1E-8);
+            } else {
+                BOOST_CHECK(v1 == v2);
+            }
+        }
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(AnalyticsManagerTest)
+
+BOOST_AUTO_TEST_CASE(testConcurrentAnalytics) {
+
+    BOOST_TEST_MESSAGE("Testing analytics run concurrently against a sequential run...");
+
+    initBuilders();
+
+    // without sessions the analytics manager falls back to the sequential run in both cases
+
+    auto sequential = runAnalytics(1);
+    auto concurrent = runAnalytics(2);
+
+    for (auto const& [type, name] : std::vector<std::pair<std::string, std::string>>{{"NPV", "npv"},
+                                                                                     {"STRESS", "stress"}}) {
+        BOOST_TEST_MESSAGE("Comparing report " << type << "/" << name);
+        BOOST_REQUIRE(sequential.count(type) && sequential[type].count(name));
+        BOOST_REQUIRE(concurrent.count(type) && concurrent[type].count(name));
+        checkReportsEqual(sequential[type][name], concurrent[type][name]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -18,10 +18,16 @@
 
 #include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
+#include <orea/cube/contiguouscube.hpp>
+#include <orea/cube/creditstatenpvcube.hpp>
 #include <orea/cube/inmemorycube.hpp>
 #include <orea/cube/cube_io.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <orea/cube/jaggedcube.hpp>
+#include <orea/cube/mappedfilecube.hpp>
+#include <orea/cube/sampletruncatedcube.hpp>
+#include <orea/engine/closeoutregression.hpp>
+#include <orea/engine/cubecheckpoint.hpp>
 #include <orea/engine/filteredsensitivitystream.hpp>
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/parametricvar.hpp>
@@ -36,6 +42,7 @@
 #include <orea/engine/stresstest.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 #include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
 #include <orea/scenario/crossassetmodelscenariogenerator.hpp>
 #include <orea/scenario/scenariosimmarket.hpp>
 #include <orea/scenario/scenariosimmarketparameters.hpp>
@@ -116,12 +123,12 @@ void testCube(NPVCube& cube, const std::string& cubeName, Real tolerance) {
 
 template <class T>
 void testCubeFileIO(QuantLib::ext::shared_ptr<NPVCube> cube, const std::string& cubeName, Real tolerance,
-                    bool doublePrecision) {
+                    bool doublePrecision, const std::string& extension = "") {
 
     initCube(*cube);
 
-    // get a random filename
-    string filename = boost::filesystem::unique_path().string();
+    // get a random filename, the extension determines the file format
+    string filename = boost::filesystem::unique_path().string() + extension;
     BOOST_TEST_MESSAGE("Saving cube " << cubeName << " to file " << filename);
     saveCube(filename, NPVCubeWithMetaData{cube, nullptr, boost::none, boost::none}, doublePrecision);
 
@@ -442,6 +449,18 @@ BOOST_AUTO_TEST_CASE(testDoublePrecisionInMemoryCubeN) {
     testCube(c, "DoublePrecisionInMemoryCubeN", 1e-14);
 }
 
+BOOST_AUTO_TEST_CASE(testDoublePrecisionInMemoryCubeNSampleMajor) {
+    std::set<string> ids{"id1", "id2", "id3"};
+    vector<Date> dates(20, Date());
+    Size samples = 100;
+    Size depth = 4;
+    DoublePrecisionInMemoryCubeN c(Date(), ids, dates, samples, depth, 0.0, InMemoryCubeLayout::SampleMajor);
+    testCube(c, "DoublePrecisionInMemoryCubeN (sample major)", 1e-14);
+    // values of one (date, sample) are contiguous
+    BOOST_CHECK_EQUAL(c.index(1, 2, 3, 0) - c.index(0, 2, 3, 0), depth);
+    BOOST_CHECK_EQUAL(c.data()[c.index(1, 2, 3, 1)], c.get(1, 2, 3, 1));
+}
+
 BOOST_AUTO_TEST_CASE(testDoublePrecisionInMemoryCubeFileIO) {
     std::set<string> ids{string("id")}; // the overlap doesn't matter
     Date d(1, QuantLib::Jan, 2016);        // need a real date here
@@ -461,6 +480,64 @@ BOOST_AUTO_TEST_CASE(testDoublePrecisionInMemoryCubeFileNIO) {
     testCubeFileIO<DoublePrecisionInMemoryCubeN>(c, "DoublePrecisionInMemoryCubeN", 1e-14, true);
 }
 
+BOOST_AUTO_TEST_CASE(testSinglePrecisionInMemoryCubeBinaryFileIO) {
+    std::set<string> ids{string("id")}; // the overlap doesn't matter
+    Date d(1, QuantLib::Jan, 2016);        // need a real date here
+    vector<Date> dates(100, d);
+    Size samples = 1000;
+    auto c = QuantLib::ext::make_shared<SinglePrecisionInMemoryCube>(d, ids, dates, samples);
+    testCubeFileIO<SinglePrecisionInMemoryCube>(c, "SinglePrecisionInMemoryCube", 1e-5, false, ".bin");
+}
+
+BOOST_AUTO_TEST_CASE(testDoublePrecisionInMemoryCubeBinaryFileNIO) {
+    std::set<string> ids{string("id")}; // the overlap doesn't matter
+    Date d(1, QuantLib::Jan, 2016);        // need a real date here
+    vector<Date> dates(50, d);
+    Size samples = 200;
+    Size depth = 6;
+    auto c = QuantLib::ext::make_shared<DoublePrecisionInMemoryCubeN>(d, ids, dates, samples, depth);
+    testCubeFileIO<DoublePrecisionInMemoryCubeN>(c, "DoublePrecisionInMemoryCubeN", 1e-14, true, ".bin");
+}
+
+BOOST_AUTO_TEST_CASE(testMemoryMappedBinaryCubeFile) {
+    BOOST_TEST_MESSAGE("Testing memory mapped loading of binary cube files");
+    std::set<string> ids{"id1", "id2", "id3"};
+    Date d(1, QuantLib::Jan, 2016);
+    vector<Date> dates(20, d);
+    Size samples = 100;
+    Size depth = 2;
+    for (bool doublePrecision : {false, true}) {
+        auto cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCubeN>(d, ids, dates, samples, depth);
+        initCube(*cube);
+        for (Size i = 0; i < ids.size(); ++i)
+            cube->setT0(i + 0.5, i, 1);
+        string filename = boost::filesystem::unique_path().string() + ".bin";
+        saveCube(filename, NPVCubeWithMetaData{cube, nullptr, boost::none, boost::none}, doublePrecision);
+        Real tolerance = doublePrecision ? 1e-14 : 1e-5;
+        {
+            auto mapped = loadCube(filename, true, true).cube;
+            if (doublePrecision)
+                BOOST_CHECK(QuantLib::ext::dynamic_pointer_cast<MappedBinaryCube<double>>(mapped));
+            else
+                BOOST_CHECK(QuantLib::ext::dynamic_pointer_cast<MappedBinaryCube<float>>(mapped));
+            BOOST_CHECK_EQUAL(mapped->numIds(), ids.size());
+            BOOST_CHECK_EQUAL(mapped->numDates(), dates.size());
+            BOOST_CHECK_EQUAL(mapped->samples(), samples);
+            BOOST_CHECK_EQUAL(mapped->depth(), depth);
+            BOOST_CHECK(mapped->idsAndIndexes() == cube->idsAndIndexes());
+            checkCube(*mapped, tolerance);
+            for (Size i = 0; i < ids.size(); ++i)
+                BOOST_CHECK_CLOSE(mapped->getT0(i, 1), i + 0.5, tolerance);
+
+            // changes are private to the cube and not written back to the file
+            mapped->set(42.0, 1, 3, 4, 1);
+            BOOST_CHECK_CLOSE(mapped->get(1, 3, 4, 1), 42.0, tolerance);
+        }
+        checkCube(*loadCube(filename, doublePrecision).cube, tolerance);
+        boost::filesystem::remove(filename);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testInMemoryCubeGetSetbyDateID) {
     std::set<string> ids = {"id1", "id2", "id3"}; // the overlap doesn't matter
     Date today = Date::todaysDate();
@@ -471,6 +548,195 @@ BOOST_AUTO_TEST_CASE(testInMemoryCubeGetSetbyDateID) {
     testCubeGetSetbyDateID(cube, 1e-14);
 }
 
+BOOST_AUTO_TEST_CASE(testDoublePrecisionContiguousInMemoryCube) {
+    std::set<string> ids{string("id")}; // the overlap doesn't matter
+    vector<Date> dates(50, Date());
+    Size samples = 200;
+    Size depth = 6;
+    DoublePrecisionContiguousInMemoryCube c(Date(), ids, dates, samples, depth);
+    testCube(c, "DoublePrecisionContiguousInMemoryCube", 1e-14);
+}
+
+BOOST_AUTO_TEST_CASE(testContiguousInMemoryCubeSlices) {
+    BOOST_TEST_MESSAGE("Testing slices of ContiguousInMemoryCube");
+    std::set<string> ids{"id1", "id2", "id3", "id4", "id5"};
+    vector<Date> dates(10, Date());
+    Size samples = 20;
+    Size depth = 3;
+    DoublePrecisionContiguousInMemoryCube c(Date(), ids, dates, samples, depth);
+
+    // populate the cube via two slices
+    auto s1 = c.slice({"id1", "id3", "id5"});
+    auto s2 = c.slice({"id2", "id4"});
+    BOOST_CHECK_EQUAL(s1->numIds(), 3);
+    BOOST_CHECK_EQUAL(s2->numIds(), 2);
+    BOOST_CHECK_THROW(c.slice({"id6"}), std::exception);
+    for (auto const& s : {s1, s2}) {
+        for (auto const& [id, i] : s->idsAndIndexes()) {
+            Size pos = c.idsAndIndexes().at(id);
+            for (Size d = 0; d < depth; ++d) {
+                s->setT0(pos * 10.0 + d, i, d);
+                for (Size j = 0; j < dates.size(); ++j)
+                    for (Size k = 0; k < samples; ++k)
+                        s->set(pos * 1000000.0 + j + k / 1000000.0 + d * 3, i, j, k, d);
+            }
+        }
+    }
+
+    // check the values in the full cube and the slices
+    checkCube(c, 1e-14);
+    for (Size i = 0; i < c.numIds(); ++i)
+        for (Size d = 0; d < depth; ++d)
+            BOOST_CHECK_CLOSE(c.getT0(i, d), i * 10.0 + d, 1e-14);
+    BOOST_CHECK_CLOSE(s2->get("id4", Date(), 3, 1), c.get("id4", Date(), 3, 1), 1e-14);
+}
+
+BOOST_AUTO_TEST_CASE(testMappedFileCube) {
+    BOOST_TEST_MESSAGE("Testing MappedFileCube");
+    std::set<string> ids{"id1", "id2", "id3"};
+    vector<Date> dates(20, Date());
+    Size samples = 100;
+    Size depth = 2;
+    string filename;
+    {
+        SinglePrecisionMappedFileCube c("", Date(), ids, dates, samples, depth);
+        filename = c.filename();
+        BOOST_CHECK(boost::filesystem::exists(filename));
+        BOOST_CHECK_EQUAL(boost::filesystem::file_size(filename),
+                          (ids.size() * depth * (1 + dates.size() * samples)) * sizeof(float));
+        testCube(c, "SinglePrecisionMappedFileCube", 1e-5);
+
+        // a slice writes through to the file
+        auto s = c.slice({"id2"});
+        s->set(42.0, 0, 3, 4, 1);
+        BOOST_CHECK_CLOSE(c.get(1, 3, 4, 1), 42.0, 1e-5);
+    }
+    // the file is removed with the cube
+    BOOST_CHECK(!boost::filesystem::exists(filename));
+}
+
+BOOST_AUTO_TEST_CASE(testCreditStateNpvCube) {
+    BOOST_TEST_MESSAGE("Testing CreditStateNpvCube");
+    std::set<string> ids{"id1", "id2", "id3"};
+    vector<Date> dates(5, Date());
+    Size samples = 10;
+    Size states = 4;
+    // depth 0 = npv, depth 1 = flows, depths 2 to 5 = credit states
+    auto dense = QuantLib::ext::make_shared<DoublePrecisionInMemoryCubeN>(Date(), ids, dates, samples, 3);
+    CreditStateNpvCube c(dense, states);
+    BOOST_CHECK_EQUAL(c.depth(), 6);
+
+    // id1 does not depend on the credit state, id2 does, id3 sets the first state last
+    for (Size i = 0; i < 3; ++i) {
+        for (Size j = 0; j < dates.size(); ++j) {
+            for (Size k = 0; k < samples; ++k) {
+                Real npv = i * 100.0 + j + k / 100.0;
+                c.set(npv, i, j, k, 0);
+                c.set(1.0, i, j, k, 1);
+                for (Size s = 0; s < states; ++s) {
+                    Real stateNpv = i == 0 ? npv : npv - s;
+                    if (i == 2 && s == 0)
+                        continue;
+                    c.set(stateNpv, i, j, k, 2 + s);
+                }
+                if (i == 2)
+                    c.set(npv, i, j, k, 2);
+            }
+        }
+    }
+
+    BOOST_CHECK_EQUAL(c.stateDependentEntries(), 2 * dates.size());
+    for (Size j = 0; j < dates.size(); ++j) {
+        BOOST_CHECK(!c.stateDependent(0, j));
+        BOOST_CHECK(c.stateDependent(1, j));
+    }
+    for (Size i = 0; i < 3; ++i) {
+        for (Size j = 0; j < dates.size(); ++j) {
+            for (Size k = 0; k < samples; ++k) {
+                Real npv = i * 100.0 + j + k / 100.0;
+                BOOST_CHECK_CLOSE(c.get(i, j, k, 0), npv, 1e-12);
+                BOOST_CHECK_CLOSE(c.get(i, j, k, 1), 1.0, 1e-12);
+                for (Size s = 0; s < states; ++s)
+                    BOOST_CHECK_SMALL(c.get(i, j, k, 2 + s) - (i == 0 ? npv : npv - s), 1e-4);
+            }
+        }
+    }
+    BOOST_CHECK_THROW(c.get(0, 0, 0, 6), std::exception);
+
+    c.remove(1);
+    BOOST_CHECK_EQUAL(c.stateDependentEntries(), dates.size());
+    BOOST_CHECK_SMALL(c.get(1, 2, 3, 5), 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(testSampleTruncatedCube) {
+    BOOST_TEST_MESSAGE("Testing SampleTruncatedCube");
+    std::set<string> ids{"id1", "id2"};
+    vector<Date> dates(5, Date());
+    auto full = QuantLib::ext::make_shared<DoublePrecisionInMemoryCubeN>(Date(), ids, dates, 10, 2);
+    for (Size i = 0; i < 2; ++i)
+        for (Size j = 0; j < dates.size(); ++j)
+            for (Size k = 0; k < 10; ++k)
+                full->set(i + j + k / 10.0, i, j, k, 1);
+
+    SampleTruncatedCube c(full, 4);
+    BOOST_CHECK_EQUAL(c.samples(), 4);
+    BOOST_CHECK_EQUAL(c.depth(), 2);
+    BOOST_CHECK_EQUAL(c.numIds(), 2);
+    BOOST_CHECK_CLOSE(c.get(1, 3, 2, 1), 4.2, 1e-12);
+    BOOST_CHECK_THROW(c.get(1, 3, 4, 1), std::exception);
+    c.set(7.0, 0, 0, 3, 0);
+    BOOST_CHECK_EQUAL(full->get(0, 0, 3, 0), 7.0);
+    BOOST_CHECK_THROW(SampleTruncatedCube(full, 11), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(testCubeCheckpoint) {
+    BOOST_TEST_MESSAGE("Testing CubeCheckpoint");
+    std::set<string> ids{"id1", "id2", "id3"};
+    vector<Date> dates(4, Date());
+    Size samples = 10, depth = 2;
+    auto dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("checkpoint-%%%%-%%%%");
+
+    auto c = QuantLib::ext::make_shared<DoublePrecisionInMemoryCubeN>(Date(), ids, dates, samples, depth);
+    for (Size i = 0; i < ids.size(); ++i)
+        for (Size j = 0; j < dates.size(); ++j)
+            for (Size k = 0; k < samples; ++k)
+                for (Size d = 0; d < depth; ++d)
+                    c->set(i * 1000.0 + j * 100.0 + k + d / 10.0, i, j, k, d);
+
+    {
+        // a new checkpoint restores nothing, then save two blocks as an interrupted run would
+        CubeCheckpoint cp(dir.string(), "key");
+        std::set<string> failed;
+        BOOST_CHECK_EQUAL(cp.restore(c, 0, samples, failed), 0);
+        cp.save(c, 0, 3, {});
+        cp.save(c, 3, 6, {"id2"});
+    }
+
+    // resume with the same key
+    auto r = QuantLib::ext::make_shared<DoublePrecisionInMemoryCubeN>(Date(), ids, dates, samples, depth);
+    std::set<string> failed;
+    CubeCheckpoint cp(dir.string(), "key");
+    BOOST_CHECK_EQUAL(cp.restore(r, 0, samples, failed), 6);
+    BOOST_CHECK_EQUAL(failed.size(), 1);
+    BOOST_CHECK(failed.count("id2") == 1);
+    for (Size i = 0; i < ids.size(); ++i)
+        for (Size j = 0; j < dates.size(); ++j)
+            for (Size k = 0; k < samples; ++k)
+                for (Size d = 0; d < depth; ++d)
+                    BOOST_CHECK_EQUAL(r->get(i, j, k, d), k < 6 ? c->get(i, j, k, d) : 0.0);
+
+    // a sample slice starting inside the checkpointed samples is not restored, a slice ending early is cut
+    BOOST_CHECK_EQUAL(cp.restore(r, 1, samples, failed), 0);
+    BOOST_CHECK_EQUAL(cp.restore(r, 0, 4, failed), 4);
+
+    // a different key discards the checkpoint
+    CubeCheckpoint other(dir.string(), "other key");
+    BOOST_CHECK_EQUAL(other.restore(r, 0, samples, failed), 0);
+    BOOST_CHECK_EQUAL(CubeCheckpoint(dir.string(), "key").restore(r, 0, samples, failed), 0);
+
+    boost::filesystem::remove_all(dir);
+}
+
 BOOST_AUTO_TEST_CASE(testSinglePrecisionJaggedCube) {
 
     SavedSettings backup;
@@ -539,6 +805,99 @@ BOOST_AUTO_TEST_CASE(testDoublePrecisionJaggedCube) {
     IndexManager::instance().clearHistories();
 }
 
+BOOST_AUTO_TEST_CASE(testMaturityTruncatedJaggedCube) {
+    BOOST_TEST_MESSAGE("Testing JaggedCube truncated at given maturities");
+    Date today(15, December, 2016);
+    vector<Date> dates{today + 30, today + 60, today + 90, today + 120};
+    std::set<string> ids{"id1", "id2", "id3"};
+    std::map<string, Date> maturities{{"id1", today + 45}, {"id2", today + 90}};
+
+    SinglePrecisionJaggedCube c(today, ids, dates, 5, 2, maturities);
+    BOOST_CHECK_EQUAL(c.numIds(), 3);
+    BOOST_CHECK_EQUAL(c.numDates(), 4);
+    BOOST_CHECK_EQUAL(c.depth(), 2);
+    // id1 is stored up to today + 60, id2 up to today + 90, id3 without maturity on all dates
+    BOOST_CHECK_CLOSE(c.avgDateLen(), 3.0, 1e-12);
+
+    c.set(1.5, 0, 1, 4, 1);
+    c.set(2.5, 1, 2, 0, 0);
+    c.set(3.5, 2, 3, 2, 1);
+    BOOST_CHECK_CLOSE(c.get(0, 1, 4, 1), 1.5, 1e-5);
+    BOOST_CHECK_CLOSE(c.get(1, 2, 0, 0), 2.5, 1e-5);
+    BOOST_CHECK_CLOSE(c.get(2, 3, 2, 1), 3.5, 1e-5);
+
+    // beyond the maturity zeros are returned and only zeros can be set
+    BOOST_CHECK_EQUAL(c.get(0, 2, 4, 1), 0.0);
+    BOOST_CHECK_NO_THROW(c.set(0.0, 0, 3, 0, 0));
+    BOOST_CHECK_THROW(c.set(1.0, 0, 2, 0, 0), std::exception);
+    BOOST_CHECK_THROW(c.set(1.0, 1, 3, 0, 0), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(testCloseOutRegression) {
+    BOOST_TEST_MESSAGE("Testing close-out values estimated from the valuation date values");
+    SavedSettings backup;
+    Date today(15, December, 2016);
+    Settings::instance().evaluationDate() = today;
+    auto grid = QuantLib::ext::make_shared<DateGrid>("5,1Y");
+    grid->addCloseOutDates(3 * Months);
+    vector<Date> dates = grid->valuationDates();
+    Size samples = 50;
+
+    // the values drift by 10 per period on each path, the numeraire grows by 10% per period
+    auto cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCubeN>(today, std::set<string>{"id"}, dates, samples,
+                                                                         2, 0.0);
+    auto asd = QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(dates.size(), samples);
+    for (Size j = 0; j < dates.size(); ++j) {
+        for (Size k = 0; k < samples; ++k) {
+            cube->set(k + 10.0 * j, 0, j, k, 0);
+            asd->set(j, k, std::pow(1.1, j), AggregationScenarioDataType::Numeraire);
+        }
+    }
+
+    CloseOutRegression(grid, 0, 1).fill(cube, asd);
+
+    for (Size j = 0; j < dates.size(); ++j) {
+        Date c = grid->closeOutDateFromValuationDate(dates[j]);
+        Real a = j + 1 < dates.size() ? static_cast<Real>(c - dates[j]) / (dates[j + 1] - dates[j]) : 0.0;
+        for (Size k = 0; k < samples; k += 7) {
+            Real expected = (k + 10.0 * (j + a)) * std::pow(1.1, j + a);
+            BOOST_CHECK_CLOSE(cube->get(0, j, k, 1), expected, 1e-8);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testCloseOutRegressionConstantTrade) {
+    BOOST_TEST_MESSAGE("Testing close-out values of a trade without dispersion across the samples");
+    SavedSettings backup;
+    Date today(15, December, 2016);
+    Settings::instance().evaluationDate() = today;
+    auto grid = QuantLib::ext::make_shared<DateGrid>("5,1Y");
+    grid->addCloseOutDates(3 * Months);
+    vector<Date> dates = grid->valuationDates();
+    Size samples = 50;
+
+    // the value is the same on all paths and grows by 10 per period, the regressor has no dispersion
+    auto cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCubeN>(today, std::set<string>{"id"}, dates, samples,
+                                                                         2, 0.0);
+    auto asd = QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(dates.size(), samples);
+    for (Size j = 0; j < dates.size(); ++j) {
+        for (Size k = 0; k < samples; ++k) {
+            cube->set(100.0 + 10.0 * j, 0, j, k, 0);
+            asd->set(j, k, std::pow(1.1, j), AggregationScenarioDataType::Numeraire);
+        }
+    }
+
+    CloseOutRegression(grid, 0, 1).fill(cube, asd);
+
+    for (Size j = 0; j < dates.size(); ++j) {
+        Date c = grid->closeOutDateFromValuationDate(dates[j]);
+        Real a = j + 1 < dates.size() ? static_cast<Real>(c - dates[j]) / (dates[j + 1] - dates[j]) : 0.0;
+        Real expected = (100.0 + 10.0 * (j + a)) * std::pow(1.1, j + a);
+        for (Size k = 0; k < samples; ++k)
+            BOOST_CHECK_CLOSE(cube->get(0, j, k, 1), expected, 1e-8);
+    }
+}
+
 string writeCube(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size bufferSize) {
     auto report = QuantLib::ext::make_shared<InMemoryReport>(bufferSize);
     ReportWriter().writeCube(*report, cube);
@@ -582,6 +941,60 @@ BOOST_AUTO_TEST_CASE(testInMemoryReportBuffer) {
     diffFiles(filename_0, filename_100000);
 }
 
+// Test the typed column storage of class InMemoryReport
+BOOST_AUTO_TEST_CASE(testInMemoryReportColumns) {
+
+    InMemoryReport report(0);
+    report.addColumn("Size", Size())
+        .addColumn("Real", Real(), 4)
+        .addColumn("String", string())
+        .addColumn("Date", Date())
+        .addColumn("Period", Period());
+    for (Size i = 0; i < 10; ++i) {
+        report.next()
+            .add(i)
+            .add(0.5 * i)
+            .add(i % 2 == 0 ? string("even") : string("odd"))
+            .add(Date(1, January, 2024) + i)
+            .add(Period(i, Months));
+    }
+    report.end();
+
+    BOOST_CHECK_EQUAL(report.rows(), 10);
+    BOOST_CHECK_EQUAL(boost::get<Size>(report.data(0, 7)), 7);
+    BOOST_CHECK_EQUAL(boost::get<Real>(report.data(1, 3)), 1.5);
+    BOOST_CHECK_EQUAL(boost::get<string>(report.data(2, 4)), "even");
+    BOOST_CHECK_EQUAL(boost::get<string>(report.data(2, 5)), "odd");
+    BOOST_CHECK_EQUAL(boost::get<Date>(report.data(3, 9)), Date(10, January, 2024));
+    BOOST_CHECK_EQUAL(boost::get<Period>(report.data(4, 2)), Period(2, Months));
+    BOOST_CHECK_THROW(report.data(0, 10), QuantLib::Error);
+
+    // typed access to the column storage
+
+    BOOST_REQUIRE_EQUAL(report.realColumn(1).size(), 10);
+    BOOST_CHECK_EQUAL(report.realColumn(1)[3], 1.5);
+    BOOST_CHECK_EQUAL(report.sizeColumn(0)[7], 7);
+    BOOST_REQUIRE_EQUAL(report.stringDictionary(2).size(), 2);
+    BOOST_CHECK_EQUAL(report.stringDictionary(2)[report.stringColumn(2)[5]], "odd");
+    BOOST_CHECK_THROW(report.realColumn(0), QuantLib::Error);
+
+    // the column view is extended by rows added after the first access
+
+    BOOST_CHECK_EQUAL(report.data(2).size(), 10);
+    report.next().add(Size(10)).add(5.0).add(string("new")).add(Date(11, January, 2024)).add(Period(10, Months));
+    const auto& strings = report.data(2);
+    BOOST_REQUIRE_EQUAL(strings.size(), 11);
+    BOOST_CHECK_EQUAL(boost::get<string>(strings[9]), "odd");
+    BOOST_CHECK_EQUAL(boost::get<string>(strings[10]), "new");
+
+    // reports can be combined
+
+    InMemoryReport combined(report);
+    combined.add(report);
+    BOOST_CHECK_EQUAL(combined.rows(), 22);
+    BOOST_CHECK_EQUAL(boost::get<string>(combined.data(2, 21)), "new");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+
+#include <orea/aggregation/dimregressioncalculator.hpp>
+#include <orea/app/inputparameters.hpp>
+#include <orea/cube/cubeinterpretation.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/portfolio/swap.hpp>
+
+#include <oret/toplevelfixture.hpp>
+
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(DimRegressionCalculatorTest)
+
+BOOST_AUTO_TEST_CASE(testThreadsIndependence) {
+
+    BOOST_TEST_MESSAGE("Testing that the regression DIM does not depend on the number of threads");
+
+    Date today(14, April, 2016);
+
+    // six trades in two netting sets, the npvs are driven by a random walk index fixing
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    for (Size i = 0; i < 6; ++i) {
+        auto trade = QuantLib::ext::make_shared<ore::data::Swap>(Envelope("CPTY_A", "NS" + std::to_string(i % 2 + 1)));
+        trade->id() = "T" + std::to_string(i + 1);
+        portfolio->add(trade);
+    }
+    vector<Date> dates;
+    for (Size j = 1; j <= 12; ++j)
+        dates.push_back(today + j * Months);
+    Size samples = 500;
+    auto cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(today, portfolio->ids(), dates, samples);
+    auto asd = QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(dates.size(), samples);
+    MersenneTwisterUniformRng rng(42);
+    InverseCumulativeNormal icn;
+    for (Size i = 0; i < portfolio->size(); ++i)
+        cube->setT0(100.0 * i, i);
+    for (Size k = 0; k < samples; ++k) {
+        Real x = 0.02;
+        for (Size j = 0; j < dates.size(); ++j) {
+            x += 0.002 * icn(rng.nextReal());
+            asd->set(j, k, x, AggregationScenarioDataType::IndexFixing, "EUR-EURIBOR-6M");
+            asd->set(j, k, 1.0 + 0.01 * j + 0.001 * icn(rng.nextReal()), AggregationScenarioDataType::Numeraire);
+            for (Size i = 0; i < portfolio->size(); ++i)
+                cube->set(1E6 * (i + 1.0) * (x - 0.02) + 100.0 * icn(rng.nextReal()), i, j, k);
+        }
+    }
+    auto cubeInterpreter = QuantLib::ext::make_shared<CubeInterpretation>(false, false,
+                                                                          Handle<AggregationScenarioData>(asd));
+
+    auto check = [](const vector<Real>& actual, const vector<Real>& expected, const string& label) {
+        BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+        for (Size i = 0; i < expected.size(); ++i)
+            BOOST_CHECK_MESSAGE(actual[i] == expected[i],
+                                label << " at " << i << ": " << actual[i] << ", single-threaded " << expected[i]);
+    };
+
+    for (auto const& regressors : vector<vector<string>>{{}, {"EUR-EURIBOR-6M"}}) {
+        auto run = [&](Size nThreads) {
+            auto inputs = QuantLib::ext::make_shared<InputParameters>();
+            inputs->setThreads(nThreads);
+            auto dim = QuantLib::ext::make_shared<RegressionDynamicInitialMarginCalculator>(
+                inputs, portfolio, cube, cubeInterpreter, asd, 0.99, 14, 2, regressors, 50, 0.25);
+            dim->build();
+            return dim;
+        };
+        auto dim1 = run(1);
+        for (Size nThreads : {2, 4}) {
+            auto dimN = run(nThreads);
+            for (auto const& n : {"NS1", "NS2"}) {
+                string label = string(n) + " (" + std::to_string(regressors.size()) + " regressors, " +
+                               std::to_string(nThreads) + " threads)";
+                check(dimN->expectedIM(n), dim1->expectedIM(n), label + " expected DIM");
+                check(dimN->zeroOrderResults(n), dim1->zeroOrderResults(n), label + " zero order DIM");
+                check(dimN->simpleResultsUpper(n), dim1->simpleResultsUpper(n), label + " simple DIM upper");
+                check(dimN->simpleResultsLower(n), dim1->simpleResultsLower(n), label + " simple DIM lower");
+                for (Size j = 0; j < dates.size(); ++j) {
+                    check(dimN->dynamicIM(n)[j], dim1->dynamicIM(n)[j], label + " DIM date " + std::to_string(j));
+                    check(dimN->localRegressionResults(n)[j], dim1->localRegressionResults(n)[j],
+                          label + " local DIM date " + std::to_string(j));
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,184 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/distributedvaluationengine.hpp>
+#include <orea/engine/valuationcalculator.hpp>
+#include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/scenariogeneratorbuilder.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/simplescenariofactory.hpp>
+
+#include <ored/configuration/conventions.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/model/crossassetmodelbuilder.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include <cmath>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+// the value of the command line argument --name=value after the -- separator, empty if not given
+string argument(const string& name) {
+    int argc = framework::master_test_suite().argc;
+    char** argv = framework::master_test_suite().argv;
+    string prefix = "--" + name + "=";
+    for (int i = 1; i < argc; ++i) {
+        if (boost::starts_with(argv[i], prefix))
+            return string(argv[i]).substr(prefix.size());
+    }
+    return string();
+}
+
+struct DistributedValuationData {
+    DistributedValuationData() {
+        Settings::instance().evaluationDate() = asof;
+        auto conventions = QuantLib::ext::make_shared<Conventions>();
+        conventions->fromFile(TEST_INPUT_FILE("conventions.xml"));
+        InstrumentConventions::instance().setConventions(conventions);
+        curveConfigs->fromFile(TEST_INPUT_FILE("curveconfig.xml"));
+        todaysMarketParams->fromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+        engineData->fromFile(TEST_INPUT_FILE("pricingengine.xml"));
+        simMarketData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+        scenarioGeneratorData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+        crossAssetModelData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+        loader = QuantLib::ext::make_shared<CSVLoader>(TEST_INPUT_FILE("market.txt"), TEST_INPUT_FILE("fixings.txt"),
+                                                       false);
+    }
+
+    // the portfolio, not built
+    QuantLib::ext::shared_ptr<Portfolio> portfolio() const {
+        auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+        portfolio->fromFile(TEST_INPUT_FILE("portfolio.xml"));
+        return portfolio;
+    }
+
+    // the cube generated in this process, set up as in runDistributedValuationWorker()
+    QuantLib::ext::shared_ptr<NPVCube> singleProcessCube() const {
+        auto market = QuantLib::ext::make_shared<TodaysMarket>(asof, todaysMarketParams, loader, curveConfigs);
+        CrossAssetModelBuilder modelBuilder(market, crossAssetModelData);
+        ScenarioGeneratorBuilder sgb(scenarioGeneratorData);
+        auto scenarioGenerator = sgb.build(*modelBuilder.model(),
+                                           QuantLib::ext::make_shared<SimpleScenarioFactory>(true), simMarketData,
+                                           asof, market, Market::defaultConfiguration);
+        auto simMarket = QuantLib::ext::make_shared<ScenarioSimMarket>(
+            market, simMarketData, Market::defaultConfiguration, *curveConfigs, *todaysMarketParams, true, false,
+            false, false, IborFallbackConfig::defaultConfig(), false);
+        simMarket->scenarioGenerator() = scenarioGenerator;
+        auto engineFactory = QuantLib::ext::make_shared<EngineFactory>(engineData, simMarket);
+        auto p = portfolio();
+        p->build(engineFactory, "distributed valuation test");
+        auto grid = scenarioGeneratorData->getGrid();
+        auto cube = QuantLib::ext::make_shared<SinglePrecisionInMemoryCube>(
+            asof, p->ids(), grid->valuationDates(), scenarioGeneratorData->samples(), 0.0f);
+        ValuationEngine engine(asof, grid, simMarket, engineFactory->modelBuilders());
+        engine.buildCube(p, cube, {QuantLib::ext::make_shared<NPVCalculator>("EUR")},
+                         scenarioGeneratorData->withMporStickyDate());
+        return cube;
+    }
+
+    Date asof = Date(5, February, 2016);
+    QuantLib::ext::shared_ptr<CurveConfigurations> curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+    QuantLib::ext::shared_ptr<TodaysMarketParameters> todaysMarketParams =
+        QuantLib::ext::make_shared<TodaysMarketParameters>();
+    QuantLib::ext::shared_ptr<EngineData> engineData = QuantLib::ext::make_shared<EngineData>();
+    QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> simMarketData =
+        QuantLib::ext::make_shared<ScenarioSimMarketParameters>();
+    QuantLib::ext::shared_ptr<ScenarioGeneratorData> scenarioGeneratorData =
+        QuantLib::ext::make_shared<ScenarioGeneratorData>();
+    QuantLib::ext::shared_ptr<CrossAssetModelData> crossAssetModelData =
+        QuantLib::ext::make_shared<CrossAssetModelData>();
+    QuantLib::ext::shared_ptr<Loader> loader;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(DistributedValuationTest)
+
+/* The worker processes of testMergedCube run this test suite executable with this test case only and the job
+   directory and partition as arguments. Without these arguments the test case does nothing. */
+BOOST_AUTO_TEST_CASE(testWorker) {
+    string job = argument("distributed_worker_job");
+    if (job.empty())
+        return;
+    Size partition = std::stoul(argument("distributed_worker_partition"));
+    BOOST_TEST_MESSAGE("Running distributed valuation worker for partition " << partition << " of job " << job);
+    BOOST_CHECK(runDistributedValuationWorker(job, partition));
+}
+
+BOOST_AUTO_TEST_CASE(testMergedCube) {
+
+    BOOST_TEST_MESSAGE("Testing the merged mini-cubes of local worker processes against a single process cube");
+
+    DistributedValuationData data;
+    auto expected = data.singleProcessCube();
+
+    // the workers are local processes running the testWorker case of this executable
+    string command = "\"" + string(framework::master_test_suite().argv[0]) +
+                     "\" --run_test=OREAnalyticsTestSuite/DistributedValuationTest/testWorker -- --base_data_path=" +
+                     basePath + " --distributed_worker_job={job} --distributed_worker_partition={partition}";
+    DistributedValuationEngine engine(command, 2, 0, TEST_OUTPUT_FILE("job"), data.asof, data.loader,
+                                      data.engineData, data.curveConfigs, data.todaysMarketParams, data.simMarketData,
+                                      data.scenarioGeneratorData, data.crossAssetModelData, {}, "EUR");
+    auto portfolio = data.portfolio();
+    auto grid = data.scenarioGeneratorData->getGrid();
+    auto merged = QuantLib::ext::make_shared<SinglePrecisionInMemoryCube>(
+        data.asof, portfolio->ids(), grid->valuationDates(), data.scenarioGeneratorData->samples(), 0.0f);
+    engine.buildCube(portfolio, merged);
+
+    BOOST_CHECK(engine.failedTrades().empty());
+    BOOST_REQUIRE_EQUAL(merged->numIds(), expected->numIds());
+    BOOST_REQUIRE_EQUAL(merged->numDates(), expected->numDates());
+    BOOST_REQUIRE_EQUAL(merged->samples(), expected->samples());
+    Real tolerance = 1E-6;
+    for (auto const& [id, i] : expected->idsAndIndexes()) {
+        Size j = merged->getTradeIndex(id);
+        Real t0 = expected->getT0(i);
+        BOOST_CHECK_MESSAGE(std::fabs(merged->getT0(j) - t0) <= tolerance * std::max(1.0, std::fabs(t0)),
+                            "T0 NPV of " << id << ": " << merged->getT0(j) << ", expected " << t0);
+        BOOST_CHECK(t0 != 0.0);
+        for (Size d = 0; d < expected->numDates(); ++d) {
+            for (Size s = 0; s < expected->samples(); ++s) {
+                Real npv = expected->get(i, d, s);
+                BOOST_CHECK_MESSAGE(std::fabs(merged->get(j, d, s) - npv) <= tolerance * std::max(1.0, std::fabs(npv)),
+                                    "NPV of " << id << " at date " << d << " sample " << s << ": "
+                                              << merged->get(j, d, s) << ", expected " << npv);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
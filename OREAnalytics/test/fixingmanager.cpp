@@ -0,0 +1,143 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+
+#include <orea/simulation/fixingmanager.hpp>
+
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/portfolio.hpp>
+
+#include <oret/toplevelfixture.hpp>
+
+#include <ql/cashflows/floatingratecoupon.hpp>
+#include <ql/indexes/indexmanager.hpp>
+
+#include "testmarket.hpp"
+#include "testportfolio.hpp"
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+void checkHistory(const TimeSeries<Real>& history, const TimeSeries<Real>& expected, const string& label) {
+    BOOST_CHECK_MESSAGE(history.size() == expected.size(), label << ": history has " << history.size()
+                                                                 << " fixings, expected " << expected.size());
+    auto h = history.begin();
+    for (auto e = expected.begin(); e != expected.end() && h != history.end(); ++e, ++h) {
+        BOOST_CHECK_MESSAGE(h->first == e->first && h->second == e->second,
+                            label << ": fixing " << io::iso_date(h->first) << " " << h->second << ", expected "
+                                  << io::iso_date(e->first) << " " << e->second);
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(FixingManagerTest)
+
+BOOST_AUTO_TEST_CASE(testResetAcrossPaths) {
+
+    BOOST_TEST_MESSAGE("Testing that the fixing manager restores the fixing histories between paths...");
+
+    SavedSettings backup;
+
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    QuantLib::ext::shared_ptr<Market> market = QuantLib::ext::make_shared<testsuite::TestMarket>(today);
+    QuantLib::ext::shared_ptr<EngineData> data = QuantLib::ext::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    QuantLib::ext::shared_ptr<EngineFactory> factory = QuantLib::ext::make_shared<EngineFactory>(data, market);
+
+    QuantLib::ext::shared_ptr<Portfolio> portfolio = QuantLib::ext::make_shared<Portfolio>();
+    portfolio->add(testsuite::buildSwap("SWAP", "EUR", true, 1000000.0, 0, 5, 0.02, 0.0, "1Y", "30/360", "6M", "A360",
+                                        "EUR-EURIBOR-6M"));
+    portfolio->build(factory);
+
+    // the future fixing dates of the floating coupons
+    auto index = *market->iborIndex("EUR-EURIBOR-6M");
+    vector<Date> fixingDates;
+    for (auto const& leg : portfolio->trades().begin()->second->legs()) {
+        for (auto const& c : leg) {
+            auto frc = QuantLib::ext::dynamic_pointer_cast<FloatingRateCoupon>(c);
+            if (frc && frc->fixingDate() >= today)
+                fixingDates.push_back(frc->fixingDate());
+        }
+    }
+    BOOST_REQUIRE(fixingDates.size() > 4);
+
+    // a historical fixing that is never touched and a future fixing that is overwritten on the later steps
+    Date pastDate = index->fixingCalendar().advance(today, -5 * Days);
+    Date overwrittenDate = fixingDates[fixingDates.size() - 2];
+    index->addFixing(pastDate, 0.01);
+    index->addFixing(overwrittenDate, 0.5);
+    const TimeSeries<Real> original = IndexManager::instance().getHistory(index->name());
+
+    FixingManager fixingManager(today);
+    fixingManager.initialise(portfolio, market);
+
+    vector<Date> grid;
+    for (Size i = 1; i <= 20; ++i)
+        grid.push_back(today + (3 * i) * Months);
+
+    // full path, partial path, full path
+    vector<Size> pathLength = {grid.size(), grid.size() / 2, grid.size()};
+    vector<TimeSeries<Real>> fullPathHistory;
+    for (Size p = 0; p < pathLength.size(); ++p) {
+        for (Size i = 0; i < pathLength[p]; ++i) {
+            Settings::instance().evaluationDate() = grid[i];
+            fixingManager.update(grid[i]);
+        }
+        Date end = grid[pathLength[p] - 1];
+        TimeSeries<Real> history = IndexManager::instance().getHistory(index->name());
+        for (auto const& d : fixingDates) {
+            if (d < end) {
+                BOOST_CHECK_MESSAGE(history[d] != Null<Real>() && history[d] != 0.5,
+                                    "path " << p << ": no simulated fixing on " << io::iso_date(d));
+            } else {
+                BOOST_CHECK_MESSAGE(history[d] == original[d],
+                                    "path " << p << ": fixing on " << io::iso_date(d) << " beyond the path end is "
+                                            << history[d] << ", expected " << original[d]);
+            }
+        }
+        BOOST_CHECK_EQUAL(history[pastDate], 0.01);
+        if (pathLength[p] == grid.size())
+            fullPathHistory.push_back(history);
+
+        fixingManager.reset();
+        Settings::instance().evaluationDate() = today;
+        checkHistory(IndexManager::instance().getHistory(index->name()), original,
+                     "after reset of path " + std::to_string(p));
+    }
+
+    // the static market gives the same fixings on both full paths
+    BOOST_REQUIRE_EQUAL(fullPathHistory.size(), 2);
+    checkHistory(fullPathHistory[1], fullPathHistory[0], "second full path");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,169 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/historicalpnlgenerator.hpp>
+#include <orea/engine/observationmode.hpp>
+#include <orea/engine/sensitivityinmemorystream.hpp>
+#include <orea/scenario/historicalscenariogenerator.hpp>
+#include <orea/scenario/scenarioshiftcalculator.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/simplescenario.hpp>
+#include <orea/scenario/simplescenariofactory.hpp>
+
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/portfolio.hpp>
+
+#include <oret/toplevelfixture.hpp>
+
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+#include "testmarket.hpp"
+#include "testportfolio.hpp"
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(HistoricalPnlGeneratorTest)
+
+BOOST_AUTO_TEST_CASE(testSensitivityPnlClassification) {
+
+    BOOST_TEST_MESSAGE("Testing the classification of trades with sensitivity based historical P&L...");
+
+    SavedSettings backup;
+    ObservationMode::Mode backupMode = ObservationMode::instance().mode();
+    ObservationMode::instance().setMode(ObservationMode::Mode::None);
+
+    Date today(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    auto initMarket = QuantLib::ext::make_shared<testsuite::TestMarket>(today);
+    auto simMarketData = testsuite::TestConfigurationObjects::setupSimMarketData2();
+    auto sensiData = testsuite::TestConfigurationObjects::setupSensitivityScenarioData2();
+    auto simMarket = QuantLib::ext::make_shared<ScenarioSimMarket>(initMarket, simMarketData);
+
+    auto data = QuantLib::ext::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    auto factory = QuantLib::ext::make_shared<EngineFactory>(data, simMarket);
+
+    // one trade per bucket, all of them can be revalued in full
+    vector<string> ids = {"Linear", "Convex", "Foreign", "NoShift", "NoSensi"};
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    for (Size i = 0; i < ids.size(); ++i)
+        portfolio->add(testsuite::buildSwap(ids[i], "EUR", true, 1000000.0, 0, 5 + i, 0.02, 0.0, "1Y", "30/360",
+                                            "6M", "A360", "EUR-EURIBOR-6M"));
+    portfolio->build(factory);
+
+    // historical EUR discount curves with zero rates 0.01 + 0.0005 i^2 on consecutive business days, so that the
+    // shift of the zero rates in the i-th scenario is 5 (2i + 1) basis points on every tenor
+    DayCounter dc = Actual365Fixed();
+    const vector<Period>& tenors = simMarketData->yieldCurveTenors("EUR");
+    auto loader = QuantLib::ext::make_shared<HistoricalScenarioLoader>();
+    Date d = TARGET().advance(today, -10 * Days);
+    for (Size i = 0; i < 6; ++i, d = TARGET().advance(d, 1 * Days)) {
+        auto s = QuantLib::ext::make_shared<SimpleScenario>(d);
+        for (Size j = 0; j < tenors.size(); ++j) {
+            Real t = dc.yearFraction(today, today + tenors[j]);
+            s->add(RiskFactorKey(RiskFactorKey::KeyType::DiscountCurve, "EUR", j),
+                   std::exp(-(0.01 + 0.0005 * i * i) * t));
+        }
+        loader->historicalScenarios().push_back(s);
+        loader->dates().push_back(d);
+    }
+    auto hisScenGen = QuantLib::ext::make_shared<HistoricalScenarioGenerator>(
+        loader, QuantLib::ext::make_shared<SimpleScenarioFactory>(true), TARGET(), nullptr, 1);
+    hisScenGen->baseScenario() = simMarket->baseScenario();
+    const Size nScen = hisScenGen->numScenarios();
+    BOOST_REQUIRE_EQUAL(nScen, 5);
+
+    // - Linear: small gamma, delta-gamma P&L
+    // - Convex: gamma P&L above the threshold, revalued
+    // - Foreign: sensitivities in a currency other than the base currency, revalued
+    // - NoShift: no shift can be computed for the USD discount curve, revalued
+    // - NoSensi: no sensitivities, revalued
+    // - Unknown: not in the portfolio, ignored
+    RiskFactorKey eur5y(RiskFactorKey::KeyType::DiscountCurve, "EUR", 6);
+    RiskFactorKey usd5y(RiskFactorKey::KeyType::DiscountCurve, "USD", 6);
+    Real linearNpv = 1234.5, linearDelta = 100.0, linearGamma = 0.01;
+    auto ss = QuantLib::ext::make_shared<SensitivityInMemoryStream>();
+    ss->add(SensitivityRecord("Linear", false, eur5y, "", 0.0001, {}, "", 0.0, "EUR", linearNpv, linearDelta,
+                              linearGamma));
+    ss->add(SensitivityRecord("Convex", false, eur5y, "", 0.0001, {}, "", 0.0, "EUR", 2000.0, 100.0, 1000.0));
+    ss->add(SensitivityRecord("Foreign", false, eur5y, "", 0.0001, {}, "", 0.0, "GBP", 3000.0, 100.0, 0.0));
+    ss->add(SensitivityRecord("NoShift", false, eur5y, "", 0.0001, {}, "", 0.0, "EUR", 4000.0, 100.0, 0.0));
+    ss->add(SensitivityRecord("NoShift", false, usd5y, "", 0.0001, {}, "", 0.0, "EUR", 4000.0, 100.0, 0.0));
+    ss->add(SensitivityRecord("Unknown", false, eur5y, "", 0.0001, {}, "", 0.0, "EUR", 5000.0, 100.0, 0.0));
+    auto shiftCalculator = QuantLib::ext::make_shared<ScenarioShiftCalculator>(sensiData, simMarketData);
+
+    // full revaluation as reference
+    auto fullCube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(today, portfolio->ids(),
+                                                                            vector<Date>(1, today), nScen);
+    HistoricalPnlGenerator fullGen("EUR", portfolio, simMarket, hisScenGen, fullCube, factory->modelBuilders());
+    fullGen.generateCube(nullptr);
+    BOOST_CHECK(fullGen.sensitivityPnlTrades().empty());
+
+    auto cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(today, portfolio->ids(), vector<Date>(1, today),
+                                                                        nScen);
+    HistoricalPnlGenerator gen("EUR", portfolio, simMarket, hisScenGen, cube, factory->modelBuilders());
+    gen.setSensitivityPnl(ss, shiftCalculator, 0.01);
+    gen.generateCube(nullptr);
+
+    BOOST_CHECK_MESSAGE(gen.sensitivityPnlTrades() == set<string>({"Linear"}),
+                        "expected exactly one trade with sensitivity based P&L (Linear), got "
+                            << gen.sensitivityPnlTrades().size());
+
+    // the near-linear trade has the delta-gamma P&L on top of the base NPV from the sensitivity records
+    Size linearIdx = cube->idsAndIndexes().at("Linear");
+    BOOST_CHECK_CLOSE(cube->getT0(linearIdx), linearNpv, 1E-12);
+    for (Size s = 0; s < nScen; ++s) {
+        Real shift = 5.0 * (2.0 * s + 1.0);
+        Real expected = linearNpv + linearDelta * shift + 0.5 * linearGamma * shift * shift;
+        BOOST_CHECK_MESSAGE(std::abs(cube->get(linearIdx, 0, s) - expected) < 1E-6,
+                            "Linear, scenario " << s << ": value " << cube->get(linearIdx, 0, s) << ", expected "
+                                                << expected);
+    }
+
+    // the other trades are revalued in full
+    for (auto const& id : ids) {
+        if (id == "Linear")
+            continue;
+        Size i = cube->idsAndIndexes().at(id);
+        Size j = fullCube->idsAndIndexes().at(id);
+        BOOST_CHECK_CLOSE(cube->getT0(i), fullCube->getT0(j), 1E-10);
+        for (Size s = 0; s < nScen; ++s)
+            BOOST_CHECK_MESSAGE(std::abs(cube->get(i, 0, s) - fullCube->get(j, 0, s)) < 1E-8,
+                                id << ", scenario " << s << ": value " << cube->get(i, 0, s)
+                                   << ", full revaluation " << fullCube->get(j, 0, s));
+    }
+
+    ObservationMode::instance().setMode(backupMode);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
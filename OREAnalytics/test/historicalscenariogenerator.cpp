@@ -105,6 +105,76 @@ BOOST_AUTO_TEST_CASE(testHistoricalScenarioGeneratorTransform) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testHistoricalScenarioGeneratorReturnMatrix) {
+
+    BOOST_TEST_MESSAGE("Checking Historical Scenario Generator with precomputed return matrix...");
+
+    Date asof(14, April, 2016);
+    Settings::instance().evaluationDate() = asof;
+
+    vector<RiskFactorKey> keys = {{RiskFactorKey::KeyType::DiscountCurve, "EUR", 0},
+                                  {RiskFactorKey::KeyType::DiscountCurve, "EUR", 1},
+                                  {RiskFactorKey::KeyType::FXSpot, "USDEUR", 0},
+                                  {RiskFactorKey::KeyType::SwaptionVolatility, "EUR", 0},
+                                  {RiskFactorKey::KeyType::RecoveryRate, "dc", 0}};
+
+    // historical scenarios on consecutive business days, the fx spot is missing in one of them
+    auto loader = QuantLib::ext::make_shared<HistoricalScenarioLoader>();
+    Date d = TARGET().advance(asof, -20 * Days);
+    for (Size i = 0; i < 20; ++i, d = TARGET().advance(d, 1 * Days)) {
+        auto s = QuantLib::ext::make_shared<SimpleScenario>(d);
+        s->add(keys[0], 0.99 - 0.001 * std::sin(static_cast<Real>(i)));
+        s->add(keys[1], 0.95 - 0.002 * std::cos(static_cast<Real>(i)));
+        if (i != 7)
+            s->add(keys[2], 1.1 + 0.01 * i);
+        s->add(keys[3], 0.2 + 0.005 * (i % 3));
+        s->add(keys[4], 0.4 + 0.01 * (i % 4));
+        loader->historicalScenarios().push_back(s);
+        loader->dates().push_back(d);
+    }
+
+    auto base = QuantLib::ext::make_shared<SimpleScenario>(asof);
+    base->add(keys[0], 0.995);
+    base->add(keys[1], 0.96);
+    base->add(keys[2], 1.2);
+    base->add(keys[3], 0.25);
+    base->add(keys[4], 0.4);
+
+    auto gen1 = QuantLib::ext::make_shared<HistoricalScenarioGenerator>(
+        loader, QuantLib::ext::make_shared<SimpleScenarioFactory>(true), TARGET(), nullptr, 3);
+    auto gen2 = QuantLib::ext::make_shared<HistoricalScenarioGenerator>(
+        loader, QuantLib::ext::make_shared<SimpleScenarioFactory>(true), TARGET(), nullptr, 3);
+    gen1->baseScenario() = base;
+    gen2->baseScenario() = base;
+    gen2->useReturnMatrix(true);
+    BOOST_REQUIRE(gen1->numScenarios() > 0);
+    BOOST_REQUIRE_EQUAL(gen1->numScenarios(), gen2->numScenarios());
+
+    // two passes to check reset() and reuse of the matrix
+    for (Size pass = 0; pass < 2; ++pass) {
+        gen1->reset();
+        gen2->reset();
+        for (Size i = 0; i < gen1->numScenarios(); ++i) {
+            auto s1 = gen1->next(asof);
+            auto s2 = gen2->next(asof);
+            BOOST_CHECK_EQUAL(s1->label(), s2->label());
+            for (auto const& k : keys)
+                BOOST_CHECK_CLOSE(s1->get(k), s2->get(k), 1E-12);
+            const auto& cd1 = gen1->lastHistoricalScenarioCalculationDetails();
+            const auto& cd2 = gen2->lastHistoricalScenarioCalculationDetails();
+            BOOST_REQUIRE_EQUAL(cd1.size(), cd2.size());
+            for (Size k = 0; k < cd1.size(); ++k) {
+                BOOST_CHECK_EQUAL(cd1[k].key, cd2[k].key);
+                BOOST_CHECK_EQUAL(cd1[k].scenarioDate1, cd2[k].scenarioDate1);
+                BOOST_CHECK_EQUAL(cd1[k].scenarioDate2, cd2[k].scenarioDate2);
+                BOOST_CHECK_EQUAL(cd1[k].scenarioValue1, cd2[k].scenarioValue1);
+                BOOST_CHECK_EQUAL(cd1[k].scenarioValue2, cd2[k].scenarioValue2);
+                BOOST_CHECK_CLOSE(cd1[k].returnValue, cd2[k].returnValue, 1E-12);
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/historicalsimulationvar.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+#include <boost/accumulators/accumulators.hpp>
+#include <boost/accumulators/statistics.hpp>
+#include <boost/accumulators/statistics/tail_quantile.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+
+using namespace std;
+using namespace ore::analytics;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+// the quantile as computed before the selection with nth_element
+Real tailQuantileVar(const vector<Real>& pnls, const Real confidence, const bool isCall) {
+    using namespace boost::accumulators;
+    Size c = static_cast<Size>(std::floor(pnls.size() * (1.0 - confidence) + 0.5)) + 2;
+    typedef accumulator_set<double, stats<tag::tail_quantile<right>>> accumulator;
+    accumulator acc(tag::tail<right>::cache_size = c);
+    for (const auto& pnl : pnls)
+        acc(isCall ? pnl : -pnl);
+    return quantile(acc, quantile_probability = confidence);
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(HistoricalSimulationVarTest)
+
+BOOST_AUTO_TEST_CASE(testQuantilesAgainstTailQuantile) {
+
+    BOOST_TEST_MESSAGE("Testing historical simulation VaR against the boost right tail quantile");
+
+    // the confidence levels are not sorted and contain a repeated level
+    vector<Real> confidences = {0.99, 0.5, 0.9, 0.975, 0.95, 0.99, 0.999, 0.01};
+    MersenneTwisterUniformRng rng(42);
+
+    for (Size n : {2, 7, 100, 250, 1000}) {
+        for (bool repeatedValues : {false, true}) {
+            // integer pnls give repeated values and thus ties at the quantile positions
+            vector<Real> pnls(n);
+            for (auto& p : pnls)
+                p = repeatedValues ? std::floor(rng.nextReal() * 20.0) - 10.0 : rng.nextReal() * 2.0 - 1.0;
+            for (bool isCall : {true, false}) {
+                HistoricalSimulationVarCalculator calculator(pnls);
+                vector<Real> vars = calculator.vars(confidences, isCall);
+                BOOST_REQUIRE_EQUAL(vars.size(), confidences.size());
+                for (Size i = 0; i < confidences.size(); ++i) {
+                    // the tail quantile is NaN if the position is the smallest pnl, vars() returns the smallest pnl
+                    if (static_cast<Size>(std::ceil(n * (1.0 - confidences[i]))) >= n)
+                        continue;
+                    Real expected = tailQuantileVar(pnls, confidences[i], isCall);
+                    BOOST_CHECK_MESSAGE(vars[i] == expected, "n = " << n << ", repeated values = " << repeatedValues
+                                                                    << ", isCall = " << isCall << ", confidence = "
+                                                                    << confidences[i] << ": var " << vars[i]
+                                                                    << ", tail quantile " << expected);
+                    BOOST_CHECK_EQUAL(calculator.var(confidences[i], isCall), expected);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
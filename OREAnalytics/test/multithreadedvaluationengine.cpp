@@ -0,0 +1,308 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/multithreadedvaluationengine.hpp>
+#include <orea/engine/valuationcalculator.hpp>
+#include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+#include <orea/scenario/scenariogeneratorbuilder.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/simplescenariofactory.hpp>
+
+#include <ored/configuration/conventions.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/model/crossassetmodelbuilder.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+struct MultiThreadedValuationData {
+    MultiThreadedValuationData() {
+        Settings::instance().evaluationDate() = asof;
+        auto conventions = QuantLib::ext::make_shared<Conventions>();
+        conventions->fromFile(TEST_INPUT_FILE("conventions.xml"));
+        InstrumentConventions::instance().setConventions(conventions);
+        curveConfigs->fromFile(TEST_INPUT_FILE("curveconfig.xml"));
+        todaysMarketParams->fromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+        engineData->fromFile(TEST_INPUT_FILE("pricingengine.xml"));
+        simMarketData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+        scenarioGeneratorData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+        crossAssetModelData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+        loader = QuantLib::ext::make_shared<CSVLoader>(TEST_INPUT_FILE("market.txt"), TEST_INPUT_FILE("fixings.txt"),
+                                                       false);
+        market = QuantLib::ext::make_shared<TodaysMarket>(asof, todaysMarketParams, loader, curveConfigs);
+        grid = scenarioGeneratorData->getGrid();
+    }
+
+    // the portfolio, not built
+    QuantLib::ext::shared_ptr<Portfolio> portfolio() const {
+        auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+        portfolio->fromFile(TEST_INPUT_FILE("portfolio.xml"));
+        return portfolio;
+    }
+
+    // a new scenario generator, all generators built here produce the same paths
+    QuantLib::ext::shared_ptr<ScenarioGenerator> scenarioGenerator() const { return scenarioGenerator(market); }
+
+    QuantLib::ext::shared_ptr<ScenarioGenerator>
+    scenarioGenerator(const QuantLib::ext::shared_ptr<Market>& initMarket) const {
+        CrossAssetModelBuilder modelBuilder(initMarket, crossAssetModelData);
+        ScenarioGeneratorBuilder sgb(scenarioGeneratorData);
+        return sgb.build(*modelBuilder.model(), QuantLib::ext::make_shared<SimpleScenarioFactory>(true), simMarketData,
+                         asof, initMarket, Market::defaultConfiguration);
+    }
+
+    QuantLib::ext::shared_ptr<AggregationScenarioData> aggregationScenarioData() const {
+        return QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(grid->valuationDates().size(),
+                                                                           scenarioGeneratorData->samples());
+    }
+
+    // the cube and aggregation scenario data generated by the single-threaded valuation engine
+    QuantLib::ext::shared_ptr<NPVCube>
+    singleThreadedCube(const QuantLib::ext::shared_ptr<AggregationScenarioData>& asd) const {
+        auto simMarket = QuantLib::ext::make_shared<ScenarioSimMarket>(
+            market, simMarketData, Market::defaultConfiguration, *curveConfigs, *todaysMarketParams, true, false,
+            false, false, IborFallbackConfig::defaultConfig(), false);
+        simMarket->scenarioGenerator() = scenarioGenerator();
+        simMarket->aggregationScenarioData() = asd;
+        auto engineFactory = QuantLib::ext::make_shared<EngineFactory>(engineData, simMarket);
+        auto p = portfolio();
+        p->build(engineFactory, "multi-threaded valuation test");
+        auto cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(asof, p->ids(), grid->valuationDates(),
+                                                                            scenarioGeneratorData->samples());
+        ValuationEngine engine(asof, grid, simMarket, engineFactory->modelBuilders());
+        engine.buildCube(p, cube, {QuantLib::ext::make_shared<NPVCalculator>("EUR")},
+                         scenarioGeneratorData->withMporStickyDate());
+        return cube;
+    }
+
+    QuantLib::ext::shared_ptr<MultiThreadedValuationEngine> multiThreadedEngine(Size nThreads) const {
+        return QuantLib::ext::make_shared<MultiThreadedValuationEngine>(
+            nThreads, asof, grid, scenarioGeneratorData->samples(), loader, scenarioGenerator(), engineData,
+            curveConfigs, todaysMarketParams, Market::defaultConfiguration, simMarketData, false, false,
+            QuantLib::ext::make_shared<ScenarioFilter>(), nullptr, IborFallbackConfig::defaultConfig(), true, false,
+            false);
+    }
+
+    void buildCube(MultiThreadedValuationEngine& engine) const {
+        engine.buildCube(
+            portfolio(),
+            []() {
+                return std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>>{
+                    QuantLib::ext::make_shared<NPVCalculator>("EUR")};
+            },
+            {}, scenarioGeneratorData->withMporStickyDate());
+    }
+
+    Date asof = Date(5, February, 2016);
+    QuantLib::ext::shared_ptr<CurveConfigurations> curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+    QuantLib::ext::shared_ptr<TodaysMarketParameters> todaysMarketParams =
+        QuantLib::ext::make_shared<TodaysMarketParameters>();
+    QuantLib::ext::shared_ptr<EngineData> engineData = QuantLib::ext::make_shared<EngineData>();
+    QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> simMarketData =
+        QuantLib::ext::make_shared<ScenarioSimMarketParameters>();
+    QuantLib::ext::shared_ptr<ScenarioGeneratorData> scenarioGeneratorData =
+        QuantLib::ext::make_shared<ScenarioGeneratorData>();
+    QuantLib::ext::shared_ptr<CrossAssetModelData> crossAssetModelData =
+        QuantLib::ext::make_shared<CrossAssetModelData>();
+    QuantLib::ext::shared_ptr<Loader> loader;
+    QuantLib::ext::shared_ptr<Market> market;
+    QuantLib::ext::shared_ptr<DateGrid> grid;
+};
+
+// compare the trade results of the given cubes, each trade is looked up in the cube that contains it
+void checkCubes(const std::vector<QuantLib::ext::shared_ptr<NPVCube>>& cubes,
+                const QuantLib::ext::shared_ptr<NPVCube>& expected, Real tolerance) {
+    for (auto const& [id, i] : expected->idsAndIndexes()) {
+        auto c = std::find_if(cubes.begin(), cubes.end(), [&id](const QuantLib::ext::shared_ptr<NPVCube>& c) {
+            return c->idsAndIndexes().count(id) > 0;
+        });
+        BOOST_REQUIRE_MESSAGE(c != cubes.end(), "trade " << id << " not found in the output cubes");
+        Size j = (*c)->getTradeIndex(id);
+        BOOST_REQUIRE_EQUAL((*c)->numDates(), expected->numDates());
+        BOOST_REQUIRE_EQUAL((*c)->samples(), expected->samples());
+        BOOST_CHECK_CLOSE((*c)->getT0(j), expected->getT0(i), tolerance);
+        for (Size d = 0; d < expected->numDates(); ++d) {
+            for (Size s = 0; s < expected->samples(); ++s) {
+                Real npv = expected->get(i, d, s);
+                BOOST_CHECK_MESSAGE(std::fabs((*c)->get(j, d, s) - npv) <= tolerance * std::max(1.0, std::fabs(npv)),
+                                    "NPV of " << id << " at date " << d << " sample " << s << ": "
+                                              << (*c)->get(j, d, s) << ", expected " << npv);
+            }
+        }
+    }
+}
+
+void checkAggregationScenarioData(const QuantLib::ext::shared_ptr<AggregationScenarioData>& asd,
+                                  const QuantLib::ext::shared_ptr<AggregationScenarioData>& expected,
+                                  Real tolerance) {
+    BOOST_REQUIRE(!expected->keys().empty());
+    BOOST_REQUIRE_EQUAL(asd->keys().size(), expected->keys().size());
+    for (auto const& [type, qualifier] : expected->keys()) {
+        BOOST_REQUIRE_MESSAGE(asd->has(type, qualifier), "aggregation scenario data " << type << " " << qualifier
+                                                                                      << " not populated");
+        for (Size d = 0; d < expected->dimDates(); ++d) {
+            for (Size s = 0; s < expected->dimSamples(); ++s) {
+                Real v = expected->get(d, s, type, qualifier);
+                BOOST_CHECK(v != 0.0);
+                BOOST_CHECK_MESSAGE(std::fabs(asd->get(d, s, type, qualifier) - v) <= tolerance,
+                                    type << " " << qualifier << " at date " << d << " sample " << s << ": "
+                                         << asd->get(d, s, type, qualifier) << ", expected " << v);
+            }
+        }
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(MultiThreadedValuationEngineTest)
+
+BOOST_AUTO_TEST_CASE(testAggregationScenarioDataMoreThreadsThanParts) {
+
+    BOOST_TEST_MESSAGE("Testing the aggregation scenario data of the multi-threaded valuation engine with more threads "
+                       "than portfolio parts");
+
+#ifndef QL_ENABLE_SESSIONS
+    BOOST_TEST_MESSAGE("Skipped, the multi-threaded valuation engine requires QL_ENABLE_SESSIONS = ON");
+    return;
+#endif
+
+    MultiThreadedValuationData data;
+    auto expectedAsd = data.aggregationScenarioData();
+    auto expected = data.singleThreadedCube(expectedAsd);
+
+    // one trade per part, so that there are less parts than threads and part 0 might go to any thread
+    for (Size run = 0; run < 5; ++run) {
+        auto engine = data.multiThreadedEngine(8);
+        engine->setTradeChunkSize(1);
+        auto asd = data.aggregationScenarioData();
+        engine->setAggregationScenarioData(asd);
+        data.buildCube(*engine);
+        BOOST_CHECK_EQUAL(engine->outputCubes().size(), data.portfolio()->size());
+        checkCubes(engine->outputCubes(), expected, 1E-10);
+        checkAggregationScenarioData(asd, expectedAsd, 1E-12);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testSplitSamples) {
+
+    BOOST_TEST_MESSAGE("Testing the split samples cube of the multi-threaded valuation engine against a "
+                       "single-threaded cube");
+
+#ifndef QL_ENABLE_SESSIONS
+    BOOST_TEST_MESSAGE("Skipped, the multi-threaded valuation engine requires QL_ENABLE_SESSIONS = ON");
+    return;
+#endif
+
+    MultiThreadedValuationData data;
+    auto expectedAsd = data.aggregationScenarioData();
+    auto expected = data.singleThreadedCube(expectedAsd);
+
+    // the sample slices are not of equal size for 3 threads and 50 samples
+    auto engine = data.multiThreadedEngine(3);
+    engine->setSplitSamples(true);
+    auto asd = data.aggregationScenarioData();
+    engine->setAggregationScenarioData(asd);
+    data.buildCube(*engine);
+    BOOST_REQUIRE_EQUAL(engine->outputCubes().size(), 1);
+    BOOST_CHECK_EQUAL(engine->outputCubes().front()->numIds(), expected->numIds());
+    checkCubes(engine->outputCubes(), expected, 1E-10);
+    checkAggregationScenarioData(asd, expectedAsd, 1E-12);
+}
+
+BOOST_AUTO_TEST_CASE(testSplitSamplesSkipAhead) {
+
+    BOOST_TEST_MESSAGE("Testing the split samples of the multi-threaded valuation engine with scenario generators "
+                       "skipping to the first sample of their slice");
+
+    MultiThreadedValuationData data;
+    Size samples = data.scenarioGeneratorData->samples();
+    const vector<Date>& dates = data.grid->dates();
+
+    // the sequential scenarios
+
+    auto generator = data.scenarioGenerator();
+    vector<vector<QuantLib::ext::shared_ptr<Scenario>>> expectedScenarios(samples);
+    for (Size k = 0; k < samples; ++k) {
+        for (auto const& d : dates)
+            expectedScenarios[k].push_back(generator->next(d));
+    }
+
+    // generators positioned at the first sample of a slice reproduce them bit for bit
+
+    for (Size firstSample : {0, 17, 33}) {
+        auto g = data.scenarioGenerator();
+        BOOST_REQUIRE(g->skipTo(firstSample));
+        for (Size k = firstSample; k < samples; ++k) {
+            for (Size j = 0; j < dates.size(); ++j) {
+                auto s = g->next(dates[j]);
+                auto const& e = expectedScenarios[k][j];
+                BOOST_CHECK_EQUAL(s->getNumeraire(), e->getNumeraire());
+                BOOST_REQUIRE_EQUAL(s->keys().size(), e->keys().size());
+                for (auto const& key : e->keys()) {
+                    BOOST_CHECK_MESSAGE(s->get(key) == e->get(key), "first sample " << firstSample << ", sample " << k
+                                                                                      << ", date " << j << ", key "
+                                                                                      << key << ": " << s->get(key)
+                                                                                      << ", expected " << e->get(key));
+                }
+            }
+        }
+    }
+
+#ifndef QL_ENABLE_SESSIONS
+    BOOST_TEST_MESSAGE("Skipped the multi-threaded part, the engine requires QL_ENABLE_SESSIONS = ON");
+    return;
+#endif
+
+    // the threads build their own generators and produce the single-threaded cube bit for bit
+
+    auto expectedAsd = data.aggregationScenarioData();
+    auto expected = data.singleThreadedCube(expectedAsd);
+    auto engine = data.multiThreadedEngine(3);
+    engine->setSplitSamples(true);
+    engine->setScenarioGeneratorBuilder(
+        [&data](const QuantLib::ext::shared_ptr<Market>& initMarket) { return data.scenarioGenerator(initMarket); });
+    auto asd = data.aggregationScenarioData();
+    engine->setAggregationScenarioData(asd);
+    data.buildCube(*engine);
+    BOOST_REQUIRE_EQUAL(engine->outputCubes().size(), 1);
+    checkCubes(engine->outputCubes(), expected, 0.0);
+    checkAggregationScenarioData(asd, expectedAsd, 0.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
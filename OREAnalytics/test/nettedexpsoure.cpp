@@ -49,6 +49,9 @@
 #include <orea/aggregation/nettedexposurecalculator.hpp>
 #include <orea/aggregation/dimcalculator.hpp>
 #include <orea/aggregation/dimregressioncalculator.hpp>
+#include <orea/aggregation/exposureconvergence.hpp>
+#include <orea/engine/sampleconsumer.hpp>
+#include <ored/report/inmemoryreport.hpp>
 #include <orea/scenario/scenariogeneratordata.hpp>
 #include <orea/scenario/aggregationscenariodata.hpp>
 #include <ored/portfolio/nettingsetdetails.hpp>
@@ -90,7 +93,9 @@ QuantLib::ext::shared_ptr<data::Conventions> convs() {
     return conventions;
 }
 
-QuantLib::ext::shared_ptr<Portfolio> buildPortfolio(Size portfolioSize, QuantLib::ext::shared_ptr<EngineFactory>& factory) {
+QuantLib::ext::shared_ptr<Portfolio> buildPortfolio(Size portfolioSize,
+                                                    QuantLib::ext::shared_ptr<EngineFactory>& factory,
+                                                    Size nettingSets = 1) {
 
     QuantLib::ext::shared_ptr<Portfolio> portfolio(new Portfolio());
 
@@ -146,7 +151,7 @@ QuantLib::ext::shared_ptr<Portfolio> buildPortfolio(Size portfolioSize, QuantLib
         string fixFreq = "1Y";
 
         // envelope
-        Envelope env("CP", "NettingSet1");
+        Envelope env("CP", "NettingSet" + std::to_string(i % nettingSets + 1));
 
         // Schedules
         ScheduleData floatSchedule(ScheduleRules(start, end, floatFreq, calStr, conv, conv, rule));
@@ -698,5 +703,214 @@ BOOST_AUTO_TEST_CASE(NettedExposureCalculatorTest) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testCollateralBalancesAgainstAccounts) {
+
+    BOOST_TEST_MESSAGE("Testing collateral balances evolved over all samples against the collateral account paths");
+
+    Date today(15, January, 2025);
+    vector<Date> dateGrid;
+    for (Size i = 1; i <= 40; ++i)
+        dateGrid.push_back(today + (7 * i + i % 3) * Days);
+    Date maturity = today + 210 * Days;
+
+    Size samples = 50;
+    MersenneTwisterUniformRng rng(42);
+    vector<vector<Real>> values(dateGrid.size(), vector<Real>(samples));
+    vector<vector<Real>> fxRates(dateGrid.size(), vector<Real>(samples));
+    vector<vector<Real>> rates(dateGrid.size(), vector<Real>(samples));
+    for (Size j = 0; j < dateGrid.size(); ++j) {
+        for (Size k = 0; k < samples; ++k) {
+            values[j][k] = 200.0 * (rng.nextReal() - 0.5) + j;
+            fxRates[j][k] = 1.0 + 0.1 * rng.nextReal();
+            rates[j][k] = 0.02 + 0.01 * (rng.nextReal() - 0.5);
+        }
+    }
+    auto balance = QuantLib::ext::make_shared<CollateralBalance>(NettingSetDetails("CPTY_A"), "EUR", 0.0, 12.0);
+
+    std::vector<std::string> elgColls = {"EUR"};
+    for (auto const& [threshold, mta, callFrequency, postFrequency, mpor] :
+         std::vector<std::tuple<Real, Real, string, string, string>>{{0.0, 0.0, "1D", "1D", "2W"},
+                                                                     {10.0, 3.0, "2D", "3D", "10D"},
+                                                                     {20.0, 5.0, "1W", "1D", "3D"}}) {
+        auto nettingSetDefinition = QuantLib::ext::make_shared<NettingSetDefinition>(
+            NettingSetDetails("CPTY_A"), "Bilateral", "EUR", "EUR-EONIA", threshold, threshold / 2.0, mta, mta, 7.0,
+            "FIXED", callFrequency, postFrequency, mpor, 0.001, 0.002, elgColls);
+        for (auto calcType : {CollateralExposureHelper::Symmetric, CollateralExposureHelper::AsymmetricCVA,
+                              CollateralExposureHelper::AsymmetricDVA, CollateralExposureHelper::NoLag}) {
+            auto accounts = CollateralExposureHelper::collateralBalancePaths(
+                nettingSetDefinition, 5.0, today, values, maturity, dateGrid, 1.1, fxRates, 0.02, rates, calcType,
+                balance);
+            vector<vector<Real>> balances = CollateralExposureHelper::collateralBalances(
+                nettingSetDefinition, 5.0, today, values, maturity, dateGrid, 1.1, fxRates, 0.02, rates, calcType,
+                balance);
+            BOOST_REQUIRE_EQUAL(balances.size(), dateGrid.size());
+            for (Size j = 0; j < dateGrid.size(); ++j) {
+                for (Size k = 0; k < samples; ++k) {
+                    BOOST_CHECK_CLOSE(balances[j][k], accounts->at(k)->accountBalance(dateGrid[j]), 1E-10);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testExposureConvergenceMonitor) {
+
+    BOOST_TEST_MESSAGE("Testing the convergence monitor of the netting set EPE and CVA");
+
+    // two trades in netting set NS1 with noisy npvs, one trade in NS2 with constant npvs
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    vector<pair<string, string>> trades = {{"T1", "NS1"}, {"T2", "NS1"}, {"T3", "NS2"}};
+    for (auto const& [id, nettingSet] : trades) {
+        auto trade = QuantLib::ext::make_shared<ore::data::Swap>(Envelope("CPTY_A", nettingSet));
+        trade->id() = id;
+        portfolio->add(trade);
+    }
+    Size samples = 2000;
+    vector<Date> dates(10, Date());
+    auto cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(Date(), portfolio->ids(), dates, samples);
+    MersenneTwisterUniformRng rng(42);
+    for (Size j = 0; j < dates.size(); ++j) {
+        for (Size k = 0; k < samples; ++k) {
+            cube->set(100.0 * (rng.nextReal() - 0.3), 0, j, k);
+            cube->set(50.0 * (rng.nextReal() - 0.3), 1, j, k);
+            cube->set(10.0, 2, j, k);
+        }
+    }
+
+    ExposureConvergenceMonitor loose(portfolio, 0.05, 100);
+    loose.setCvaWeights("NS1", vector<Real>(dates.size(), 0.01));
+    Size blocks = 0;
+    for (Size k = 0; k < samples; k += 100) {
+        ++blocks;
+        if (!loose.consume(cube, k, k + 100))
+            break;
+    }
+    BOOST_CHECK(loose.converged());
+    BOOST_CHECK_EQUAL(loose.samples(), blocks * 100);
+    BOOST_CHECK(loose.samples() < samples);
+    for (auto const& e : loose.epe("NS2"))
+        BOOST_CHECK_CLOSE(e, 10.0, 1E-10);
+    for (auto const& se : loose.epeStandardError("NS2"))
+        BOOST_CHECK_SMALL(se, 1E-10);
+    BOOST_CHECK_SMALL(loose.cva("NS2"), 1E-10);
+    Real cvaEpe = 0.0;
+    for (auto const& e : loose.epe("NS1"))
+        cvaEpe += 0.01 * e;
+    BOOST_CHECK_CLOSE(loose.cva("NS1"), cvaEpe, 1E-10);
+    BOOST_CHECK(loose.cvaStandardError("NS1") <= 0.05 * loose.cva("NS1"));
+
+    // a tight tolerance is not met, the background consumer sees all samples
+    auto tight = QuantLib::ext::make_shared<ExposureConvergenceMonitor>(portfolio, 1E-4, 100);
+    AsyncSampleConsumer async(tight);
+    for (Size k = 0; k < samples; k += 100)
+        BOOST_CHECK(async.consume(cube, k, k + 100));
+    async.finish();
+    BOOST_CHECK(!tight->converged());
+    BOOST_CHECK_EQUAL(tight->samples(), samples);
+
+    InMemoryReport report;
+    tight->exportConvergence(report);
+    BOOST_CHECK_EQUAL(report.rows(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(testExposureThreadsIndependence) {
+
+    BOOST_TEST_MESSAGE("Testing that the trade and netting set exposures do not depend on the number of threads");
+
+    SavedSettings backup;
+    Date today(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    QuantLib::ext::shared_ptr<Market> initMarket = QuantLib::ext::make_shared<TestMarket>(today);
+    convs();
+    auto data = QuantLib::ext::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    auto factory = QuantLib::ext::make_shared<EngineFactory>(data, initMarket);
+    QuantLib::ext::shared_ptr<Portfolio> portfolio = buildPortfolio(9, factory, 3);
+
+    // noisy npvs on a monthly grid, the numeraire and the CSA index fixings vary over dates and samples
+    auto dateGrid = QuantLib::ext::make_shared<DateGrid>("12,1M");
+    Size samples = 200;
+    auto cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(today, portfolio->ids(),
+                                                                        dateGrid->valuationDates(), samples);
+    auto asd = QuantLib::ext::make_shared<InMemoryAggregationScenarioData>(dateGrid->valuationDates().size(), samples);
+    MersenneTwisterUniformRng rng(42);
+    for (Size i = 0; i < portfolio->size(); ++i) {
+        cube->setT0(1000.0 * (rng.nextReal() - 0.5), i);
+        for (Size j = 0; j < cube->dates().size(); ++j)
+            for (Size k = 0; k < samples; ++k)
+                cube->set(10000.0 * (rng.nextReal() - 0.5 + 0.02 * i), i, j, k);
+    }
+    for (Size j = 0; j < cube->dates().size(); ++j) {
+        for (Size k = 0; k < samples; ++k) {
+            asd->set(j, k, 1.0 + 0.1 * rng.nextReal(), AggregationScenarioDataType::Numeraire);
+            asd->set(j, k, 0.01 + 0.01 * rng.nextReal(), AggregationScenarioDataType::IndexFixing, "EUR-EONIA");
+        }
+    }
+    Handle<AggregationScenarioData> scenarioData(asd);
+    auto cubeInterpreter = QuantLib::ext::make_shared<CubeInterpretation>(false, false, scenarioData);
+
+    // one uncollateralised and two collateralised netting sets
+    std::vector<std::string> elgColls = {"EUR"};
+    auto nettingSetManager = QuantLib::ext::make_shared<NettingSetManager>();
+    nettingSetManager->add(QuantLib::ext::make_shared<NettingSetDefinition>(NettingSetDetails("NettingSet1")));
+    nettingSetManager->add(QuantLib::ext::make_shared<NettingSetDefinition>(
+        NettingSetDetails("NettingSet2"), "Bilateral", "EUR", "EUR-EONIA", 0.0, 0.0, 0.0, 0.0, 0.0, "FIXED", "1D",
+        "1D", "2W", 0.0, 0.0, elgColls));
+    nettingSetManager->add(QuantLib::ext::make_shared<NettingSetDefinition>(
+        NettingSetDetails("NettingSet3"), "Bilateral", "EUR", "EUR-EONIA", 500.0, 300.0, 100.0, 100.0, 0.0, "FIXED",
+        "1W", "1D", "1W", 0.001, 0.002, elgColls));
+    auto collateralBalances = QuantLib::ext::make_shared<CollateralBalances>();
+
+    auto run = [&](Size nThreads) {
+        auto exposureCalculator = QuantLib::ext::make_shared<ExposureCalculator>(
+            portfolio, cube, cubeInterpreter, initMarket, false, "EUR", "Market", 0.95,
+            CollateralExposureHelper::Symmetric, false, false, false, nThreads);
+        exposureCalculator->build();
+        auto nettedExposureCalculator = QuantLib::ext::make_shared<NettedExposureCalculator>(
+            portfolio, initMarket, cube, "EUR", "Market", 0.95, CollateralExposureHelper::Symmetric, false,
+            nettingSetManager, collateralBalances, exposureCalculator->nettingSetDefaultValue(),
+            exposureCalculator->nettingSetCloseOutValue(), exposureCalculator->nettingSetMporPositiveFlow(),
+            exposureCalculator->nettingSetMporNegativeFlow(), asd, cubeInterpreter, false, nullptr, false,
+            true, 0.1, exposureCalculator->exposureCube(), ExposureCalculator::allocatedEPE,
+            ExposureCalculator::allocatedENE, false, false, MporCashFlowMode::Unspecified, false, nThreads);
+        nettedExposureCalculator->build();
+        return std::make_pair(exposureCalculator, nettedExposureCalculator);
+    };
+
+    auto check = [](const vector<Real>& actual, const vector<Real>& expected, const string& label) {
+        BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+        for (Size i = 0; i < expected.size(); ++i)
+            BOOST_CHECK_MESSAGE(actual[i] == expected[i],
+                                label << " at " << i << ": " << actual[i] << ", single-threaded " << expected[i]);
+    };
+
+    auto [exposure1, netted1] = run(1);
+    for (Size nThreads : {2, 4}) {
+        auto [exposureN, nettedN] = run(nThreads);
+        for (auto const& id : portfolio->ids()) {
+            check(exposureN->epe(id), exposure1->epe(id), id + " epe");
+            check(exposureN->ene(id), exposure1->ene(id), id + " ene");
+            check(exposureN->ee_b(id), exposure1->ee_b(id), id + " ee_b");
+            check(exposureN->eee_b(id), exposure1->eee_b(id), id + " eee_b");
+            check(exposureN->allocatedEpe(id), exposure1->allocatedEpe(id), id + " allocated epe");
+            check(exposureN->allocatedEne(id), exposure1->allocatedEne(id), id + " allocated ene");
+        }
+        for (auto const& id : {"NettingSet1", "NettingSet2", "NettingSet3"}) {
+            string nid = id;
+            check(nettedN->epe(nid), netted1->epe(nid), nid + " epe");
+            check(nettedN->ene(nid), netted1->ene(nid), nid + " ene");
+            check(nettedN->ee_b(nid), netted1->ee_b(nid), nid + " ee_b");
+            check(nettedN->eee_b(nid), netted1->eee_b(nid), nid + " eee_b");
+            check(nettedN->pfe(nid), netted1->pfe(nid), nid + " pfe");
+            check(nettedN->expectedCollateral(nid), netted1->expectedCollateral(nid), nid + " expected collateral");
+            check(nettedN->colvaIncrements(nid), netted1->colvaIncrements(nid), nid + " colva increments");
+            check({nettedN->epe_b(nid), nettedN->eepe_b(nid), nettedN->colva(nid)},
+                  {netted1->epe_b(nid), netted1->eepe_b(nid), netted1->colva(nid)}, nid + " epe_b, eepe_b, colva");
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
@@ -23,6 +23,7 @@
 #include <orea/cube/npvcube.hpp>
 #include <orea/engine/filteredsensitivitystream.hpp>
 #include <orea/engine/observationmode.hpp>
+#include <orea/engine/observergraph.hpp>
 #include <orea/engine/parametricvar.hpp>
 #include <orea/engine/riskfilter.hpp>
 #include <orea/engine/sensitivityaggregator.hpp>
@@ -144,7 +145,9 @@ QuantLib::ext::shared_ptr<Portfolio> buildPortfolio(QuantLib::ext::shared_ptr<En
     return portfolio;
 }
 
-void simulation(string dateGridString, bool checkFixings) {
+QuantLib::ext::shared_ptr<NPVCube> simulation(string dateGridString, bool checkFixings, bool profiling = false,
+                                           bool observerStatistics = false, bool pruneObservers = false,
+                                           bool skipUnaffectedTrades = false) {
     SavedSettings backup;
 
     // Log::instance().registerLogger(QuantLib::ext::make_shared<StderrLogger>());
@@ -316,6 +319,10 @@ void simulation(string dateGridString, bool checkFixings) {
 
     // Now calculate exposure
     ValuationEngine valEngine(today, dg, simMarket);
+    valEngine.setProfiling(profiling);
+    valEngine.setObserverStatistics(observerStatistics);
+    valEngine.setPruneObservers(pruneObservers);
+    valEngine.setSkipUnaffectedTrades(skipUnaffectedTrades);
 
     // Calculate Cube
     cpu_timer t;
@@ -328,6 +335,37 @@ void simulation(string dateGridString, bool checkFixings) {
 
     BOOST_TEST_MESSAGE("Cube generated in " << t.format(default_places, "%w") << " seconds");
 
+    if (profiling) {
+        BOOST_REQUIRE_EQUAL(valEngine.pricingProfiles().size(), portfolio->size());
+        for (auto const& [tradeId, p] : valEngine.pricingProfiles()) {
+            BOOST_CHECK_EQUAL(p.tradeType, "Swap");
+            BOOST_CHECK_EQUAL(p.pricingEngine, "DiscountedCashflows/DiscountingSwapEngine");
+            if (skipUnaffectedTrades)
+                BOOST_CHECK(p.pricings <= dg->size() * samples);
+            else
+                BOOST_CHECK_EQUAL(p.pricings, dg->size() * samples);
+            BOOST_CHECK(p.engine > 0.0);
+            BOOST_CHECK(p.marketRecalculation >= 0.0);
+        }
+    } else {
+        BOOST_CHECK(valEngine.pricingProfiles().empty());
+    }
+
+    if (observerStatistics) {
+        BOOST_REQUIRE(valEngine.observerGraph());
+        auto tradeStatistics = valEngine.observerGraph()->tradeStatistics();
+        BOOST_REQUIRE_EQUAL(tradeStatistics.size(), portfolio->size());
+        for (auto const& [tradeId, s] : tradeStatistics) {
+            BOOST_CHECK(s.riskFactors > 0);
+            BOOST_CHECK_EQUAL(s.pricings, dg->size() * samples);
+            BOOST_CHECK(s.recalculations <= s.pricings);
+        }
+        for (auto const& [rf, s] : valEngine.observerGraph()->riskFactorStatistics()) {
+            if (s.pruned)
+                BOOST_CHECK_EQUAL(s.trades, 0);
+        }
+    }
+
     map<string, vector<Real>> referenceFixings;
     // First 10 EUR-EURIBOR-6M fixings at dateIndex 5, date grid 11,1Y
     referenceFixings["11,1Y"] = {0.00739033, 0.0281673, 0.0344399, 0.03362,   0.0325276, 0.030573,
@@ -353,6 +391,8 @@ void simulation(string dateGridString, bool checkFixings) {
                 BOOST_FAIL("Stored fixing differs from reference value, found " << fix << ", expected " << ref);
         }
     }
+
+    return cube;
 }
 
 BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
@@ -432,6 +472,51 @@ BOOST_AUTO_TEST_CASE(testDefer) {
     simulation("10,1Y", true);
 }
 
+BOOST_AUTO_TEST_CASE(testProfiling) {
+    ObservationMode::instance().setMode(ObservationMode::Mode::Disable);
+    setConventions();
+
+    BOOST_TEST_MESSAGE("Testing that profiling the pricings does not change the cube");
+    auto cube = simulation("10,1Y", false);
+    auto profiledCube = simulation("10,1Y", false, true);
+
+    BOOST_REQUIRE_EQUAL(cube->numIds(), profiledCube->numIds());
+    for (Size i = 0; i < cube->numIds(); ++i)
+        for (Size j = 0; j < cube->numDates(); ++j)
+            for (Size k = 0; k < cube->samples(); ++k)
+                BOOST_CHECK_SMALL(cube->get(i, j, k) - profiledCube->get(i, j, k), 1E-10);
+}
+
+BOOST_AUTO_TEST_CASE(testProfilingSkippedTrades) {
+    ObservationMode::instance().setMode(ObservationMode::Mode::Disable);
+    setConventions();
+
+    BOOST_TEST_MESSAGE("Testing that profiling does not recalculate trades skipped as unaffected by the scenario");
+    auto cube = simulation("10,1Y", false, false, false, false, true);
+    auto profiledCube = simulation("10,1Y", false, true, false, false, true);
+
+    BOOST_REQUIRE_EQUAL(cube->numIds(), profiledCube->numIds());
+    for (Size i = 0; i < cube->numIds(); ++i)
+        for (Size j = 0; j < cube->numDates(); ++j)
+            for (Size k = 0; k < cube->samples(); ++k)
+                BOOST_CHECK_SMALL(cube->get(i, j, k) - profiledCube->get(i, j, k), 1E-10);
+}
+
+BOOST_AUTO_TEST_CASE(testObserverPruning) {
+    ObservationMode::instance().setMode(ObservationMode::Mode::None);
+    setConventions();
+
+    BOOST_TEST_MESSAGE("Testing that pruning unobserved risk factors does not change the cube");
+    auto cube = simulation("10,1Y", false);
+    auto prunedCube = simulation("10,1Y", false, false, true, true);
+
+    BOOST_REQUIRE_EQUAL(cube->numIds(), prunedCube->numIds());
+    for (Size i = 0; i < cube->numIds(); ++i)
+        for (Size j = 0; j < cube->numDates(); ++j)
+            for (Size k = 0; k < cube->samples(); ++k)
+                BOOST_CHECK_SMALL(cube->get(i, j, k) - prunedCube->get(i, j, k), 1E-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -34,6 +34,10 @@
 #include <orea/scenario/sensitivityscenariodata.hpp>
 #include <orea/scenario/sensitivityscenariogenerator.hpp>
 
+#include <ored/configuration/conventions.hpp>
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/marketdata/inmemoryloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
 #include <ored/model/lgmdata.hpp>
 #include <ored/portfolio/builders/bond.hpp>
 #include <ored/portfolio/builders/capfloor.hpp>
@@ -57,6 +61,7 @@
 
 #include <test/oreatoplevelfixture.hpp>
 
+#include <boost/filesystem.hpp>
 #include <boost/timer/timer.hpp>
 
 using namespace std;
@@ -1186,6 +1191,23 @@ void testParConversion(ObservationMode::Mode om) {
         }
     }
 
+    // a batch converted on several threads matches the trade by trade conversion
+    ZeroToParCube parCubeMt(sensiCube, parConverter, {}, false, 4);
+    std::vector<Size> tradeIndices;
+    for (const auto& [tradeId, tradeIdx] : sensiCube->tradeIdx())
+        tradeIndices.push_back(tradeIdx);
+    auto batchDeltas = parCubeMt.parDeltas(0, tradeIndices);
+    BOOST_REQUIRE_EQUAL(batchDeltas.size(), tradeIndices.size());
+    for (Size t = 0; t < tradeIndices.size(); ++t) {
+        auto expected = parCube.parDeltas(0, tradeIndices[t]);
+        BOOST_CHECK_EQUAL(batchDeltas[t].size(), expected.size());
+        for (const auto& [key, delta] : expected) {
+            auto it = batchDeltas[t].find(key);
+            BOOST_REQUIRE(it != batchDeltas[t].end());
+            BOOST_CHECK_CLOSE(it->second, delta, 1e-10);
+        }
+    }
+
     struct Results {
         string id;
         string label;
@@ -1567,6 +1589,166 @@ void ParSensitivityAnalysisTest::test2dZeroShifts() {
     IndexManager::instance().clearHistories();
 }
 
+namespace {
+
+/* EUR discount and Euribor 6M curves built from discount factor quotes in a loader, the multi-threaded par
+   sensitivity computation builds the worker markets from the loader, \p shift moves all zero rates */
+struct LoaderMarket {
+    LoaderMarket(const Date& asof, const std::vector<Period>& tenors, const Real shift = 0.0) : asof(asof) {
+        TestConfigurationObjects::setConventions();
+        InstrumentConventions::instance().conventions()->add(QuantLib::ext::make_shared<ZeroRateConvention>(
+            "EUR-ZERO-CONVENTIONS", "A365", "TARGET", "Continuous", "Annual", "0", "TARGET", "Following", "false"));
+
+        loader = QuantLib::ext::make_shared<InMemoryLoader>();
+        curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+        std::vector<std::pair<std::string, Real>> curves{{"EUR1D", 0.0}, {"EUR6M", 0.003}};
+        for (auto const& [curveId, spread] : curves) {
+            std::vector<std::string> quotes;
+            for (auto const& p : tenors) {
+                std::string name = "DISCOUNT/RATE/EUR/" + curveId + "/" + ore::data::to_string(p);
+                Real t = years(p);
+                loader->add(asof, name, std::exp(-(0.02 + spread + shift + 0.001 * t) * t));
+                quotes.push_back(name);
+            }
+            std::vector<QuantLib::ext::shared_ptr<YieldCurveSegment>> segments{
+                QuantLib::ext::make_shared<DirectYieldCurveSegment>("Discount", "EUR-ZERO-CONVENTIONS", quotes)};
+            curveConfigs->add(CurveSpec::CurveType::Yield, curveId,
+                              QuantLib::ext::make_shared<YieldCurveConfig>(curveId, curveId, "EUR", "", segments));
+        }
+
+        todaysMarketParams = QuantLib::ext::make_shared<TodaysMarketParameters>();
+        todaysMarketParams->addConfiguration(Market::defaultConfiguration, MarketConfiguration());
+        todaysMarketParams->addMarketObject(MarketObject::DiscountCurve, Market::defaultConfiguration,
+                                            {{"EUR", "Yield/EUR/EUR1D"}});
+        todaysMarketParams->addMarketObject(MarketObject::IndexCurve, Market::defaultConfiguration,
+                                            {{"EUR-EURIBOR-6M", "Yield/EUR/EUR6M"}});
+    }
+
+    QuantLib::ext::shared_ptr<ScenarioSimMarket>
+    simMarket(const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& simMarketData) const {
+        auto market = QuantLib::ext::make_shared<TodaysMarket>(asof, todaysMarketParams, loader, curveConfigs);
+        return QuantLib::ext::make_shared<ScenarioSimMarket>(market, simMarketData, Market::defaultConfiguration,
+                                                             *curveConfigs, *todaysMarketParams);
+    }
+
+    Date asof;
+    QuantLib::ext::shared_ptr<InMemoryLoader> loader;
+    QuantLib::ext::shared_ptr<CurveConfigurations> curveConfigs;
+    QuantLib::ext::shared_ptr<TodaysMarketParameters> todaysMarketParams;
+};
+
+std::vector<Period> loaderMarketTenors() {
+    return {6 * Months, 1 * Years, 2 * Years, 3 * Years, 5 * Years, 7 * Years, 10 * Years, 15 * Years, 20 * Years};
+}
+
+QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> setupLoaderMarketSimMarketData() {
+    auto simMarketData = QuantLib::ext::make_shared<ScenarioSimMarketParameters>();
+    simMarketData->baseCcy() = "EUR";
+    simMarketData->setDiscountCurveNames({"EUR"});
+    simMarketData->setYieldCurveTenors("", loaderMarketTenors());
+    simMarketData->setIndices({"EUR-EURIBOR-6M"});
+    simMarketData->interpolation() = "LogLinear";
+    return simMarketData;
+}
+
+QuantLib::ext::shared_ptr<SensitivityScenarioData> setupLoaderMarketSensitivityScenarioData() {
+    auto sensiData = QuantLib::ext::make_shared<SensitivityScenarioData>(true);
+    SensitivityScenarioData::CurveShiftParData discountData = createCurveShiftData();
+    discountData.parInstrumentSingleCurve = true;
+    discountData.parInstrumentConventions["DEP"] = "EUR-DEP-CONVENTIONS";
+    discountData.parInstrumentConventions["IRS"] = "EUR-6M-SWAP-CONVENTIONS";
+    sensiData->discountCurveShiftData()["EUR"] =
+        QuantLib::ext::make_shared<SensitivityScenarioData::CurveShiftParData>(discountData);
+    SensitivityScenarioData::CurveShiftParData indexData = createCurveShiftData();
+    indexData.parInstrumentSingleCurve = false;
+    indexData.parInstrumentConventions["DEP"] = "EUR-DEP-CONVENTIONS";
+    indexData.parInstrumentConventions["IRS"] = "EUR-6M-SWAP-CONVENTIONS";
+    sensiData->indexCurveShiftData()["EUR-EURIBOR-6M"] =
+        QuantLib::ext::make_shared<SensitivityScenarioData::CurveShiftParData>(indexData);
+    return sensiData;
+}
+
+// par sensitivities on the loader market computed with nThreads threads, using the given cache file if not empty
+ore::analytics::ParSensitivityAnalysis::ParContainer
+loaderMarketParSensitivities(const LoaderMarket& m, const Size nThreads, const std::string& cacheFile = "",
+                             const Real cacheTolerance = 1E-6) {
+    auto simMarketData = setupLoaderMarketSimMarketData();
+    auto sensiData = setupLoaderMarketSensitivityScenarioData();
+    auto simMarket = m.simMarket(simMarketData);
+    auto baseScenario = simMarket->baseScenario();
+    simMarket->scenarioGenerator() = QuantLib::ext::make_shared<SensitivityScenarioGenerator>(
+        sensiData, baseScenario, simMarketData, simMarket,
+        QuantLib::ext::make_shared<ore::analytics::DeltaScenarioFactory>(baseScenario), false);
+    ore::analytics::ParSensitivityAnalysis parAnalysis(m.asof, simMarketData, *sensiData,
+                                                       Market::defaultConfiguration);
+    if (!cacheFile.empty())
+        parAnalysis.setCache(cacheFile, "LoaderMarket", cacheTolerance);
+    parAnalysis.computeParInstrumentSensitivities(nThreads, simMarket, m.loader, m.curveConfigs,
+                                                  m.todaysMarketParams);
+    return parAnalysis.parSensitivities();
+}
+
+void checkSameParSensitivities(const ore::analytics::ParSensitivityAnalysis::ParContainer& expected,
+                               const ore::analytics::ParSensitivityAnalysis::ParContainer& actual) {
+    BOOST_REQUIRE(!expected.empty());
+    BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+    for (auto const& [key, value] : expected) {
+        auto a = actual.find(key);
+        BOOST_REQUIRE_MESSAGE(a != actual.end(), "par sensitivity " << key.first << " w.r.t. " << key.second
+                                                                    << " missing");
+        BOOST_CHECK_CLOSE(a->second, value, 1E-10);
+    }
+}
+
+} // namespace
+
+void ParSensitivityAnalysisTest::testMultiThreadedParSensitivities() {
+    BOOST_TEST_MESSAGE("Testing multi-threaded against single-threaded par sensitivities");
+
+    SavedSettings backup;
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    LoaderMarket m(today, loaderMarketTenors());
+    checkSameParSensitivities(loaderMarketParSensitivities(m, 1), loaderMarketParSensitivities(m, 3));
+    IndexManager::instance().clearHistories();
+}
+
+void ParSensitivityAnalysisTest::testParSensitivityCache() {
+    BOOST_TEST_MESSAGE("Testing the par sensitivity cache file");
+
+    SavedSettings backup;
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    LoaderMarket market(today, loaderMarketTenors());
+    LoaderMarket movedMarket(today, loaderMarketTenors(), 0.0005);
+    auto expected = loaderMarketParSensitivities(market, 1);
+    auto expectedMoved = loaderMarketParSensitivities(movedMarket, 1);
+    std::string cacheFile = boost::filesystem::unique_path().string();
+
+    // the first run writes the cache, the second one reads it back
+    checkSameParSensitivities(expected, loaderMarketParSensitivities(market, 1, cacheFile));
+    BOOST_REQUIRE(boost::filesystem::exists(cacheFile));
+    checkSameParSensitivities(expected, loaderMarketParSensitivities(market, 1, cacheFile));
+
+    // the cache is reused if the par rates moved within the tolerance ...
+    checkSameParSensitivities(expected, loaderMarketParSensitivities(movedMarket, 1, cacheFile, 1.0));
+    bool differs = false;
+    for (auto const& [key, value] : expected) {
+        auto m = expectedMoved.find(key);
+        differs = differs || m == expectedMoved.end() || !close_enough(m->second, value);
+    }
+    BOOST_CHECK_MESSAGE(differs, "par sensitivities do not depend on the market, the cache reuse is not tested");
+
+    // ... and recomputed otherwise
+    loaderMarketParSensitivities(market, 1, cacheFile);
+    checkSameParSensitivities(expectedMoved, loaderMarketParSensitivities(movedMarket, 1, cacheFile));
+
+    boost::filesystem::remove(cacheFile);
+    IndexManager::instance().clearHistories();
+}
+
 BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
 
 BOOST_AUTO_TEST_SUITE(ParSensitivityAnalysis)
@@ -1606,6 +1788,16 @@ BOOST_AUTO_TEST_CASE(ParConversionUnregisterObs) {
     ParSensitivityAnalysisTest::testParConversionUnregisterObs();
 }
 
+BOOST_AUTO_TEST_CASE(MultiThreadedParSensitivities) {
+    BOOST_TEST_MESSAGE("Testing Multi-Threaded Par Sensitivities");
+    ParSensitivityAnalysisTest::testMultiThreadedParSensitivities();
+}
+
+BOOST_AUTO_TEST_CASE(ParSensitivityCache) {
+    BOOST_TEST_MESSAGE("Testing Par Sensitivity Cache");
+    ParSensitivityAnalysisTest::testParSensitivityCache();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -49,6 +49,10 @@ public:
     static void testParConversionDeferObs();
     //! Test par conversion of sensitivities ("Unregister" observation mode)
     static void testParConversionUnregisterObs();
+    //! Test that the multi-threaded par sensitivity computation reproduces the single-threaded one
+    static void testMultiThreadedParSensitivities();
+    //! Test that par sensitivities read from the cache file match the computed ones and that moves invalidate them
+    static void testParSensitivityCache();
     static boost::unit_test_framework::test_suite* suite();
 };
 } // namespace testsuite
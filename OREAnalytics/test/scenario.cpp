@@ -9,6 +9,17 @@ All rights reserved.
 #include <orea/scenario/simplescenario.hpp>
 #include <orea/scenario/simplescenariofactory.hpp>
 #include <orea/scenario/csvscenariogenerator.hpp>
+#include <orea/scenario/binaryscenariofile.hpp>
+#include <orea/scenario/clonedscenariogenerator.hpp>
+#include <orea/scenario/compactscenariostore.hpp>
+#include <orea/scenario/deltascenario.hpp>
+#include <orea/scenario/historicalscenariobinaryreader.hpp>
+#include <orea/scenario/historicalscenariofilereader.hpp>
+#include <orea/scenario/scenariosimmarketparameters.hpp>
+#include <orea/app/reportwriter.hpp>
+#include <ored/report/inmemoryreport.hpp>
+
+#include <fstream>
 
 using namespace boost::unit_test_framework;
 using namespace QuantLib;
@@ -89,4 +100,343 @@ BOOST_AUTO_TEST_CASE(testCSVScenarioGenerator) {
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE(CompactScenarioStoreTest)
+
+BOOST_AUTO_TEST_CASE(testCompactScenarioStore) {
+
+    BOOST_TEST_MESSAGE("Testing compact scenario store...");
+
+    Date d(21, Dec, 2016);
+    vector<RiskFactorKey> rfks = {{RiskFactorKey::KeyType::DiscountCurve, "EUR", 0},
+                                  {RiskFactorKey::KeyType::DiscountCurve, "EUR", 1},
+                                  {RiskFactorKey::KeyType::IndexCurve, "EUR-EURIBOR-6M", 0},
+                                  {RiskFactorKey::KeyType::FXSpot, "USDEUR"}};
+    vector<Real> baseValues = {0.999, 0.95, 0.998, 0.9};
+
+    // scenarios sharing one data block, the last one is filled with keys in a different order
+
+    auto sharedData = QuantLib::ext::make_shared<SimpleScenario::SharedData>();
+    vector<QuantLib::ext::shared_ptr<SimpleScenario>> scenarios;
+    for (Size i = 0; i < 10; ++i) {
+        auto s = QuantLib::ext::make_shared<SimpleScenario>(d + i, "label_" + std::to_string(i), 1.0 + 0.01 * i,
+                                                            sharedData);
+        for (Size k = 0; k < rfks.size(); ++k)
+            s->add(rfks[k], baseValues[k] * (1.0 + 0.001 * i * (k + 1)));
+        scenarios.push_back(s);
+    }
+    auto other = QuantLib::ext::make_shared<SimpleScenario>(d + 10, "other", 2.0);
+    for (Size k = rfks.size(); k > 0; --k)
+        other->add(rfks[k - 1], 2.0 * baseValues[k - 1]);
+
+    CompactScenarioStore store;
+    for (auto const& s : scenarios)
+        store.add(*s);
+    store.add(*other);
+
+    BOOST_REQUIRE_EQUAL(store.size(), scenarios.size() + 1);
+    BOOST_REQUIRE_EQUAL(store.numberOfKeys(), rfks.size());
+    BOOST_CHECK_EQUAL(store.sharedData()->keysHash, sharedData->keysHash);
+
+    scenarios.push_back(other);
+    for (Size i = 0; i < store.size(); ++i) {
+        auto s = store.get(i);
+        BOOST_CHECK_EQUAL(s->asof(), scenarios[i]->asof());
+        BOOST_CHECK_EQUAL(s->label(), scenarios[i]->label());
+        BOOST_CHECK_EQUAL(s->getNumeraire(), scenarios[i]->getNumeraire());
+        BOOST_CHECK(s->sharedData() == store.sharedData());
+        for (auto const& k : rfks) {
+            // single precision relative to the distance to the first scenario
+            BOOST_CHECK_SMALL(s->get(k) - scenarios[i]->get(k), 1E-7 * std::abs(scenarios[i]->get(k)));
+        }
+    }
+
+    // the first scenario is reproduced exactly
+    for (auto const& k : rfks)
+        BOOST_CHECK_EQUAL(store.get(0)->get(k), scenarios[0]->get(k));
+
+    // a scenario without a value for one of the keys can not be added
+    auto incomplete = QuantLib::ext::make_shared<SimpleScenario>(d, "", 1.0);
+    incomplete->add(rfks[0], 1.0);
+    BOOST_CHECK_THROW(store.add(*incomplete), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_CASE(testClonedScenarioGeneratorCompact) {
+
+    BOOST_TEST_MESSAGE("Testing cloned scenario generator with compact storage...");
+
+    vector<Date> dates = {Date(21, Dec, 2016), Date(21, Dec, 2017)};
+    vector<RiskFactorKey> rfks = {{RiskFactorKey::KeyType::DiscountCurve, "EUR", 0},
+                                  {RiskFactorKey::KeyType::DiscountCurve, "EUR", 1}};
+
+    auto tsg = QuantLib::ext::make_shared<TestScenarioGenerator>();
+    const Size nSamples = 3;
+    for (Size i = 0; i < nSamples; ++i) {
+        for (auto const& d : dates) {
+            auto s = QuantLib::ext::make_shared<SimpleScenario>(d);
+            for (Size k = 0; k < rfks.size(); ++k)
+                s->add(rfks[k], 0.9 + 0.01 * i + 0.001 * k);
+            tsg->addScenario(s);
+        }
+    }
+
+    ClonedScenarioGenerator full(tsg, dates, nSamples), compact(tsg, dates, nSamples, true);
+    ClonedScenarioGenerator compactOffset(compact, 1);
+    for (Size i = 0; i < nSamples; ++i) {
+        for (auto const& d : dates) {
+            auto s1 = full.next(d);
+            auto s2 = compact.next(d);
+            for (auto const& k : rfks)
+                BOOST_CHECK_CLOSE(s1->get(k), s2->get(k), 1E-5);
+            if (i + 1 < nSamples) {
+                auto s3 = compactOffset.next(d);
+                for (auto const& k : rfks)
+                    BOOST_CHECK_CLOSE(tsg->scenarios[(i + 1) * dates.size() + (d == dates[0] ? 0 : 1)]->get(k),
+                                      s3->get(k), 1E-5);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(BinaryScenarioFileTest)
+
+BOOST_AUTO_TEST_CASE(testBinaryScenarioFile) {
+
+    BOOST_TEST_MESSAGE("Testing binary scenario file writer and generator...");
+
+    vector<Date> dates = {Date(21, Dec, 2016), Date(21, Mar, 2017)};
+    vector<RiskFactorKey> rfks = {{RiskFactorKey::KeyType::DiscountCurve, "EUR", 0},
+                                  {RiskFactorKey::KeyType::DiscountCurve, "EUR", 1},
+                                  {RiskFactorKey::KeyType::IndexCurve, "EUR-EURIBOR-6M", 0},
+                                  {RiskFactorKey::KeyType::FXSpot, "USDEUR"}};
+
+    auto tsg = QuantLib::ext::make_shared<TestScenarioGenerator>();
+    auto sharedData = QuantLib::ext::make_shared<SimpleScenario::SharedData>();
+    const Size nSamples = 3;
+    for (Size i = 0; i < nSamples; ++i) {
+        for (auto const& d : dates) {
+            auto s = QuantLib::ext::make_shared<SimpleScenario>(d, "", 1.0 + 0.1 * i, sharedData);
+            for (auto const& k : rfks)
+                s->add(k, rand());
+            tsg->addScenario(s);
+        }
+    }
+    QuantLib::ext::dynamic_pointer_cast<SimpleScenario>(tsg->scenarios.front())
+        ->setCoordinates(RiskFactorKey::KeyType::DiscountCurve, "EUR", {{0.5, 1.0}});
+
+    // write the scenarios by passing them through the writer
+
+    string filename = "test_binary_scenario_file.bin";
+    {
+        auto writer = QuantLib::ext::make_shared<BinaryScenarioWriter>(tsg, filename);
+        writer->reset();
+        for (Size i = 0; i < nSamples; ++i)
+            for (auto const& d : dates)
+                writer->next(d);
+        writer->reset();
+        // scenarios after the reset are not written
+        writer->next(dates.front());
+    }
+
+    // read them back, the file is unmapped before it is removed
+    {
+        BinaryScenarioGenerator gen(filename);
+        BOOST_REQUIRE_EQUAL(gen.size(), tsg->scenarios.size());
+        BOOST_CHECK_EQUAL(gen.sharedData()->keysHash, sharedData->keysHash);
+        BOOST_CHECK(gen.sharedData()->coordinates == sharedData->coordinates);
+        for (Size pass = 0; pass < 2; ++pass) {
+            gen.reset();
+            for (Size i = 0; i < tsg->scenarios.size(); ++i) {
+                auto s = gen.next(dates[i % dates.size()]);
+                auto const& ref = tsg->scenarios[i];
+                BOOST_CHECK_EQUAL(s->asof(), ref->asof());
+                BOOST_CHECK_EQUAL(s->getNumeraire(), ref->getNumeraire());
+                BOOST_CHECK_EQUAL_COLLECTIONS(s->keys().begin(), s->keys().end(), ref->keys().begin(),
+                                              ref->keys().end());
+                for (auto const& k : rfks)
+                    BOOST_CHECK_EQUAL(s->get(k), ref->get(k));
+            }
+            BOOST_CHECK_THROW(gen.next(dates.front()), QuantLib::Error);
+        }
+
+        // a date mismatch is detected
+        gen.reset();
+        BOOST_CHECK_THROW(gen.next(dates.back()), QuantLib::Error);
+    }
+
+    remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(testHistoricalScenarioBinaryReader) {
+
+    BOOST_TEST_MESSAGE("Testing conversion of historical scenarios to a binary file...");
+
+    string csvFile = "test_historical_scenarios.csv";
+    string binFile = "test_historical_scenarios.bin";
+    {
+        std::ofstream out(csvFile);
+        out << "Date,Scenario,Numeraire,DiscountCurve/EUR/0,DiscountCurve/USD/0,FXSpot/USDEUR/0\n";
+        out << "2016-12-20,,1,0.99,0.98,1.05\n";
+        out << "2016-12-21,,1,0.991,#N/A,1.06\n";
+        out << "2016-12-22,,1,0.992,0.982,1.07\n";
+    }
+    convertHistoricalScenarioFile(csvFile, binFile);
+    BOOST_CHECK(isBinaryScenarioFile(binFile));
+    BOOST_CHECK(!isBinaryScenarioFile(csvFile));
+
+    for (Size nThreads : {1, 2}) {
+        HistoricalScenarioFileReader csvReader(csvFile, QuantLib::ext::make_shared<SimpleScenarioFactory>(false));
+        HistoricalScenarioBinaryReader binReader(binFile, nThreads);
+        BOOST_REQUIRE_EQUAL(binReader.size(), 3);
+        BOOST_CHECK(binReader.date() == Null<Date>());
+        while (csvReader.next()) {
+            BOOST_REQUIRE(binReader.next());
+            BOOST_CHECK_EQUAL(binReader.date(), csvReader.date());
+            auto s = binReader.scenario();
+            auto ref = csvReader.scenario();
+            BOOST_CHECK_EQUAL(s->getNumeraire(), ref->getNumeraire());
+            BOOST_CHECK_EQUAL_COLLECTIONS(s->keys().begin(), s->keys().end(), ref->keys().begin(),
+                                          ref->keys().end());
+            for (auto const& k : ref->keys())
+                BOOST_CHECK_EQUAL(s->get(k), ref->get(k));
+        }
+        BOOST_CHECK(!binReader.next());
+        BOOST_CHECK(binReader.scenario() == nullptr);
+
+        // the keys are restricted to the simulation market, load() resets the reader
+        auto simParams = QuantLib::ext::make_shared<ScenarioSimMarketParameters>();
+        simParams->setDiscountCurveNames({"EUR"});
+        binReader.load(simParams, nullptr);
+        BOOST_CHECK_EQUAL(binReader.keys().size(), 2);
+        BOOST_REQUIRE(binReader.next());
+        BOOST_CHECK_EQUAL(binReader.date(), Date(20, Dec, 2016));
+        BOOST_CHECK(!binReader.scenario()->has(RiskFactorKey(RiskFactorKey::KeyType::DiscountCurve, "USD", 0)));
+        BOOST_CHECK(binReader.scenario()->has(RiskFactorKey(RiskFactorKey::KeyType::FXSpot, "USDEUR", 0)));
+    }
+
+    remove(csvFile.c_str());
+    remove(binFile.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(ScenarioStatisticsTest)
+
+BOOST_AUTO_TEST_CASE(testScenarioStatisticsAndDistributions) {
+
+    BOOST_TEST_MESSAGE("Testing scenario statistics and distribution reports...");
+
+    vector<Date> dates = {Date(21, Dec, 2016), Date(21, Mar, 2017)};
+    vector<RiskFactorKey> rfks = {{RiskFactorKey::KeyType::DiscountCurve, "EUR", 0},
+                                  {RiskFactorKey::KeyType::FXSpot, "USDEUR"},
+                                  {RiskFactorKey::KeyType::EquitySpot, "SP5"}};
+
+    // the first key takes the values 0, ..., 49, the second is constant, the third random
+    const Size nPaths = 50;
+    auto tsg = QuantLib::ext::make_shared<TestScenarioGenerator>();
+    for (Size i = 0; i < nPaths; ++i) {
+        for (auto const& d : dates) {
+            auto s = QuantLib::ext::make_shared<SimpleScenario>(d);
+            s->add(rfks[0], static_cast<Real>(i));
+            s->add(rfks[1], 1.2);
+            s->add(rfks[2], rand());
+            tsg->addScenario(s);
+        }
+    }
+
+    const Size steps = 5;
+    std::vector<QuantLib::ext::shared_ptr<ore::data::InMemoryReport>> stats, dists;
+    for (Size nThreads : {1, 3}) {
+        stats.push_back(QuantLib::ext::make_shared<ore::data::InMemoryReport>());
+        dists.push_back(QuantLib::ext::make_shared<ore::data::InMemoryReport>());
+        tsg->reset();
+        ReportWriter().writeScenarioStatistics(tsg, rfks, nPaths, dates, *stats.back(), nThreads);
+        tsg->reset();
+        ReportWriter().writeScenarioDistributions(tsg, rfks, nPaths, dates, steps, *dists.back(), nThreads);
+    }
+
+    // the results do not depend on the number of threads
+    for (Size r = 1; r < stats.size(); ++r) {
+        BOOST_REQUIRE_EQUAL(stats[r]->rows(), stats[0]->rows());
+        BOOST_REQUIRE_EQUAL(dists[r]->rows(), dists[0]->rows());
+        for (Size i = 0; i < stats[0]->columns(); ++i)
+            for (Size j = 0; j < stats[0]->rows(); ++j)
+                BOOST_CHECK(stats[r]->data(i, j) == stats[0]->data(i, j));
+        for (Size i = 0; i < dists[0]->columns(); ++i)
+            for (Size j = 0; j < dists[0]->rows(); ++j)
+                BOOST_CHECK(dists[r]->data(i, j) == dists[0]->data(i, j));
+    }
+
+    // statistics rows are ordered by date and key, columns Date, Key, min, mean, max, ...
+    BOOST_REQUIRE_EQUAL(stats[0]->rows(), dates.size() * rfks.size());
+    for (Size d = 0; d < dates.size(); ++d) {
+        Size row = d * rfks.size();
+        BOOST_CHECK_CLOSE(boost::get<Real>(stats[0]->data(2, row)), 0.0, 1e-12);
+        BOOST_CHECK_CLOSE(boost::get<Real>(stats[0]->data(3, row)), 24.5, 1e-12);
+        BOOST_CHECK_CLOSE(boost::get<Real>(stats[0]->data(4, row)), 49.0, 1e-12);
+    }
+
+    // distribution rows are ordered by date, key and bucket, columns Date, Key, Bound, Count
+    BOOST_REQUIRE_EQUAL(dists[0]->rows(), dates.size() * rfks.size() * steps);
+    for (Size d = 0; d < dates.size(); ++d) {
+        for (Size k = 0; k < rfks.size(); ++k) {
+            Size total = 0;
+            for (Size i = 0; i < steps; ++i) {
+                Size row = (d * rfks.size() + k) * steps + i;
+                Size count = boost::get<Size>(dists[0]->data(3, row));
+                total += count;
+                if (k == 0)
+                    BOOST_CHECK_EQUAL(count, nPaths / steps);
+                if (k == 1)
+                    BOOST_CHECK_EQUAL(count, i == 0 ? nPaths : 0);
+            }
+            BOOST_CHECK_EQUAL(total, nPaths);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(DeltaScenarioTest)
+
+BOOST_AUTO_TEST_CASE(testResolveDelta) {
+
+    BOOST_TEST_MESSAGE("Testing resolution of delta scenario keys...");
+
+    Date d(21, Dec, 2016);
+    vector<RiskFactorKey> rfks = {{RiskFactorKey::KeyType::DiscountCurve, "EUR", 0},
+                                  {RiskFactorKey::KeyType::DiscountCurve, "EUR", 1},
+                                  {RiskFactorKey::KeyType::DiscountCurve, "EUR", 2},
+                                  {RiskFactorKey::KeyType::FXSpot, "USDEUR", 0}};
+    auto base = QuantLib::ext::make_shared<SimpleScenario>(d, "base");
+    for (Size i = 0; i < rfks.size(); ++i)
+        base->add(rfks[i], 1.0 + i);
+    std::map<RiskFactorKey, Size> baseKeyIndex;
+    for (Size i = 0; i < base->keys().size(); ++i)
+        baseKeyIndex[base->keys()[i]] = i;
+
+    DeltaScenario delta(base, QuantLib::ext::make_shared<SimpleScenario>(d, "delta"));
+    delta.add(rfks[1], 5.0);
+    delta.add(rfks[3], 4.0); // equal to base, not stored
+    BOOST_CHECK(!delta.isResolved());
+
+    delta.resolveDelta(baseKeyIndex);
+    BOOST_REQUIRE(delta.isResolved());
+    BOOST_REQUIRE_EQUAL(delta.resolvedDelta().size(), 1u);
+    BOOST_CHECK(base->keys()[delta.resolvedDelta()[0].first] == rfks[1]);
+    BOOST_CHECK_EQUAL(delta.resolvedDelta()[0].second, 5.0);
+
+    // the resolution is kept on cloning and invalidated by add()
+    auto cloned = QuantLib::ext::dynamic_pointer_cast<DeltaScenario>(delta.clone());
+    BOOST_REQUIRE(cloned);
+    BOOST_CHECK(cloned->isResolved());
+    BOOST_CHECK_EQUAL(cloned->resolvedDelta().size(), 1u);
+    delta.add(rfks[2], 7.0);
+    BOOST_CHECK(!delta.isResolved());
+    BOOST_CHECK(cloned->isResolved());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -481,6 +481,54 @@ BOOST_AUTO_TEST_CASE(testCrossAssetLowDiscrepancyBrownianBridge) {
     test_crossasset(true, false, true);
 }
 
+BOOST_AUTO_TEST_CASE(testCrossAssetBatchMode) {
+    BOOST_TEST_MESSAGE("Testing CrossAssetScenarioGenerator in batch mode against path by path generation...");
+    setConventions();
+
+    TestData d;
+    Date today = d.referenceDate;
+    QuantLib::ext::shared_ptr<DateGrid> grid = QuantLib::ext::make_shared<DateGrid>("10,1Y");
+    QuantLib::ext::shared_ptr<QuantExt::CrossAssetModel> model = d.ccLgm;
+    QuantLib::ext::shared_ptr<StochasticProcess> stateProcess = model->stateProcess();
+
+    QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> simMarketConfig(new ScenarioSimMarketParameters);
+    simMarketConfig->setYieldCurveTenors("", {3 * Months, 1 * Years, 5 * Years, 10 * Years, 30 * Years});
+    simMarketConfig->setSimulateFXVols(false);
+    simMarketConfig->setSimulateEquityVols(false);
+    simMarketConfig->setZeroInflationTenors("", {1 * Years, 5 * Years, 10 * Years});
+
+    if (auto tmp = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(stateProcess)) {
+        tmp->resetCache(grid->timeGrid().size() - 1);
+    }
+
+    // batch size not dividing the number of samples, to test the transition between batches
+    const Size samples = 20, batchSize = 7;
+    auto pathGen1 = QuantLib::ext::make_shared<MultiPathGeneratorMersenneTwister>(stateProcess, grid->timeGrid(), 42);
+    auto pathGen2 = QuantLib::ext::make_shared<MultiPathGeneratorMersenneTwister>(stateProcess, grid->timeGrid(), 42);
+    auto scenGen1 = QuantLib::ext::make_shared<CrossAssetModelScenarioGenerator>(
+        model, pathGen1, QuantLib::ext::make_shared<SimpleScenarioFactory>(), simMarketConfig, today, grid, d.market);
+    auto scenGen2 = QuantLib::ext::make_shared<CrossAssetModelScenarioGenerator>(
+        model, pathGen2, QuantLib::ext::make_shared<SimpleScenarioFactory>(), simMarketConfig, today, grid, d.market,
+        Market::defaultConfiguration, batchSize);
+
+    for (Size pass = 0; pass < 2; ++pass) {
+        scenGen1->reset();
+        scenGen2->reset();
+        for (Size i = 0; i < samples; i++) {
+            for (Date d : grid->dates()) {
+                auto s1 = scenGen1->next(d);
+                auto s2 = scenGen2->next(d);
+                BOOST_REQUIRE_EQUAL(s1->keys().size(), s2->keys().size());
+                BOOST_CHECK_CLOSE(s1->getNumeraire(), s2->getNumeraire(), 1E-10);
+                for (Size k = 0; k < s1->keys().size(); ++k) {
+                    BOOST_CHECK_EQUAL(s1->keys()[k], s2->keys()[k]);
+                    BOOST_CHECK_CLOSE(s1->get(s1->keys()[k]), s2->get(s1->keys()[k]), 1E-10);
+                }
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testCrossAssetSimMarket) {
     BOOST_TEST_MESSAGE("Testing CrossAssetScenarioGenerator via SimMarket (Martingale tests)...");
     setConventions();
@@ -17,6 +17,8 @@
 */
 
 #include <boost/test/unit_test.hpp>
+#include <orea/engine/bufferedsensitivitystream.hpp>
+#include <orea/engine/filteredsensitivitystream.hpp>
 #include <orea/engine/sensitivityaggregator.hpp>
 #include <orea/engine/sensitivityinmemorystream.hpp>
 #include <oret/toplevelfixture.hpp>
@@ -27,7 +29,10 @@ using namespace boost::unit_test_framework;
 using namespace std;
 
 using ore::analytics::RiskFactorKey;
+using ore::analytics::BufferedSensitivityStream;
+using ore::analytics::FilteredSensitivityStream;
 using ore::analytics::SensitivityAggregator;
+using ore::analytics::SensitivityColumns;
 using ore::analytics::SensitivityInMemoryStream;
 using ore::analytics::SensitivityRecord;
 using std::function;
@@ -240,6 +245,73 @@ BOOST_AUTO_TEST_CASE(testGeneralAggregationFunctionCategories) {
     check(expAggregationAll, res, "all_except_002");
 }
 
+BOOST_AUTO_TEST_CASE(testColumnarAggregation) {
+
+    BOOST_TEST_MESSAGE("Testing aggregation from columnar sensitivity store");
+
+    // Columnar copy of the records
+    SensitivityInMemoryStream ss(records.begin(), records.end());
+    SensitivityColumns columns(ss);
+    BOOST_REQUIRE_EQUAL(columns.size(), records.size());
+    BOOST_CHECK_EQUAL(columns.tradeIds().size(), 6);
+    set<SensitivityRecord> roundTrip;
+    for (QuantLib::Size i = 0; i < columns.size(); ++i)
+        roundTrip.insert(columns.record(i));
+    BOOST_CHECK_EQUAL_COLLECTIONS(records.begin(), records.end(), roundTrip.begin(), roundTrip.end());
+
+    // Categories for aggregator
+    map<string, set<std::pair<std::string, QuantLib::Size>>> categories;
+    set<pair<string, QuantLib::Size>> trades = {make_pair("trade_001", 0), make_pair("trade_003", 1),
+                                                make_pair("trade_004", 2), make_pair("trade_005", 3),
+                                                make_pair("trade_006", 4)};
+    for (const auto& trade : trades) {
+        categories[trade.first] = {trade};
+    }
+    categories["all_except_002"] = trades;
+
+    // Aggregate from the columns and compare against the stream based aggregation
+    SensitivityAggregator sAgg(categories);
+    sAgg.aggregate(columns);
+    SensitivityAggregator sAggStream(categories);
+    sAggStream.aggregate(ss);
+
+    for (const auto& kv : categories) {
+        BOOST_TEST_MESSAGE("Testing for category " << kv.first);
+        check(sAggStream.sensitivities(kv.first), sAgg.sensitivities(kv.first), kv.first);
+    }
+    check(expAggregationAll, sAgg.sensitivities("all_except_002"), "all_except_002");
+}
+
+BOOST_AUTO_TEST_CASE(testBlockStreaming) {
+
+    BOOST_TEST_MESSAGE("Testing block streaming of sensitivity records");
+
+    auto ss = QuantLib::ext::make_shared<SensitivityInMemoryStream>(records.begin(), records.end());
+    auto filtered = QuantLib::ext::make_shared<FilteredSensitivityStream>(ss, 1.0);
+    BufferedSensitivityStream buffered(filtered);
+
+    // Records read one by one
+    vector<SensitivityRecord> exp;
+    while (SensitivityRecord sr = buffered.next())
+        exp.push_back(sr);
+    BOOST_CHECK(!exp.empty());
+
+    // Records read in blocks of various sizes, from the buffer and from the filtered stream
+    for (QuantLib::Size blockSize : {1, 3, 7, 100}) {
+        for (bool fromBuffer : {true, false}) {
+            ore::analytics::SensitivityStream& stream =
+                fromBuffer ? static_cast<ore::analytics::SensitivityStream&>(buffered) : *filtered;
+            stream.reset();
+            vector<SensitivityRecord> res, block;
+            while (stream.nextBlock(block, blockSize) > 0) {
+                BOOST_CHECK(block.size() <= blockSize);
+                res.insert(res.end(), block.begin(), block.end());
+            }
+            BOOST_CHECK_EQUAL_COLLECTIONS(exp.begin(), exp.end(), res.begin(), res.end());
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -1993,6 +1993,234 @@ BOOST_AUTO_TEST_CASE(testCrossGamma) {
     IndexManager::instance().clearHistories();
 }
 
+BOOST_AUTO_TEST_CASE(testCrossGammaMaxIndexDistance) {
+
+    BOOST_TEST_MESSAGE("Testing restriction of cross gamma scenarios by factor index distance");
+
+    SavedSettings backup;
+
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    QuantLib::ext::shared_ptr<Market> initMarket = QuantLib::ext::make_shared<TestMarket>(today);
+    QuantLib::ext::shared_ptr<analytics::ScenarioSimMarketParameters> simMarketData =
+        TestConfigurationObjects::setupSimMarketData5();
+    QuantLib::ext::shared_ptr<analytics::ScenarioSimMarket> simMarket =
+        QuantLib::ext::make_shared<analytics::ScenarioSimMarket>(initMarket, simMarketData);
+    QuantLib::ext::shared_ptr<Scenario> baseScenario = simMarket->baseScenario();
+    QuantLib::ext::shared_ptr<ScenarioFactory> scenarioFactory =
+        QuantLib::ext::make_shared<CloneScenarioFactory>(baseScenario);
+
+    // count the cross scenarios and the maximum index distance between two curve pillars
+    auto crossScenarios = [&](const Size maxIndexDistance, Size& maxCurveDistance) {
+        QuantLib::ext::shared_ptr<SensitivityScenarioData> sensiData =
+            TestConfigurationObjects::setupSensitivityScenarioData5();
+        sensiData->crossGammaFilter() = {{"DiscountCurve/EUR", "DiscountCurve/EUR"},
+                                         {"DiscountCurve/EUR", "IndexCurve/EUR"},
+                                         {"FXSpot/EURUSD", "DiscountCurve/EUR"}};
+        sensiData->crossGammaMaxIndexDistance() = maxIndexDistance;
+        SensitivityScenarioGenerator generator(sensiData, baseScenario, simMarketData, simMarket, scenarioFactory,
+                                               false);
+        Size n = 0, nFx = 0;
+        maxCurveDistance = 0;
+        for (auto const& d : generator.scenarioDescriptions()) {
+            if (d.type() != ShiftScenarioGenerator::ScenarioDescription::Type::Cross)
+                continue;
+            ++n;
+            if (d.key1().keytype == RiskFactorKey::KeyType::FXSpot ||
+                d.key2().keytype == RiskFactorKey::KeyType::FXSpot) {
+                ++nFx;
+                continue;
+            }
+            Size i1 = d.key1().index, i2 = d.key2().index;
+            maxCurveDistance = std::max(maxCurveDistance, i1 > i2 ? i1 - i2 : i2 - i1);
+        }
+        BOOST_TEST_MESSAGE("max index distance " << maxIndexDistance << ": " << n << " cross scenarios, " << nFx
+                                                 << " involving fx spot");
+        return std::make_pair(n, nFx);
+    };
+
+    Size fullDistance, restrictedDistance;
+    auto full = crossScenarios(Null<Size>(), fullDistance);
+    auto restricted = crossScenarios(1, restrictedDistance);
+
+    BOOST_CHECK_LT(restricted.first, full.first);
+    BOOST_CHECK_GT(fullDistance, 1);
+    BOOST_CHECK_LE(restrictedDistance, 1);
+    // pairs with the scalar fx spot factor are not restricted
+    BOOST_CHECK_GT(full.second, 0);
+    BOOST_CHECK_EQUAL(restricted.second, full.second);
+}
+
+BOOST_AUTO_TEST_CASE(testAadDeltas) {
+    BOOST_TEST_MESSAGE("Testing aad deltas against bump and revalue deltas");
+
+    SavedSettings backup;
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    QuantLib::ext::shared_ptr<Market> initMarket = QuantLib::ext::make_shared<TestMarket>(today);
+    QuantLib::ext::shared_ptr<analytics::ScenarioSimMarketParameters> simMarketData =
+        TestConfigurationObjects::setupSimMarketData5();
+    QuantLib::ext::shared_ptr<SensitivityScenarioData> sensiData = TestConfigurationObjects::setupSensitivityScenarioData5();
+
+    QuantLib::ext::shared_ptr<EngineData> data = QuantLib::ext::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+
+    auto buildPortfolio = []() {
+        auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+        portfolio->add(buildSwap("1_Swap_EUR", "EUR", true, 10000000.0, 0, 10, 0.03, 0.00, "1Y", "30/360", "6M",
+                                 "A360", "EUR-EURIBOR-6M"));
+        portfolio->add(buildSwap("2_Swap_USD", "USD", true, 10000000.0, 0, 15, 0.02, 0.00, "6M", "30/360", "3M",
+                                 "A360", "USD-LIBOR-3M"));
+        portfolio->add(buildSwap("3_Swap_GBP", "GBP", false, 10000000.0, 0, 20, 0.04, 0.00, "6M", "30/360", "3M",
+                                 "A360", "GBP-LIBOR-6M"));
+        return portfolio;
+    };
+
+    auto bump = QuantLib::ext::make_shared<SensitivityAnalysis>(buildPortfolio(), initMarket, Market::defaultConfiguration,
+                                                                data, simMarketData, sensiData, false);
+    bump->generateSensitivities();
+
+    auto aad = QuantLib::ext::make_shared<SensitivityAnalysis>(buildPortfolio(), initMarket, Market::defaultConfiguration,
+                                                               data, simMarketData, sensiData, false);
+    aad->useAadDeltas(true);
+    aad->generateSensitivities();
+
+    Size count = 0;
+    for (auto const& [id, _] : bump->portfolio()->trades()) {
+        BOOST_CHECK_CLOSE(aad->sensiCube()->npv(id), bump->sensiCube()->npv(id), 1E-8);
+        for (auto const& f : bump->sensiCube()->factors()) {
+            Real bumpDelta = bump->sensiCube()->delta(id, f);
+            Real aadDelta = aad->sensiCube()->delta(id, f);
+            // the bump and revalue delta includes the curvature of a 1bp shift
+            BOOST_CHECK_MESSAGE(std::abs(aadDelta - bumpDelta) < 1E-2 * std::abs(bumpDelta) + 1.0,
+                                "aad delta " << aadDelta << " does not match bump delta " << bumpDelta << " for trade "
+                                             << id << " factor " << f);
+            if (!close_enough(bumpDelta, 0.0))
+                ++count;
+        }
+    }
+    BOOST_CHECK(count > 0);
+}
+
+BOOST_AUTO_TEST_CASE(testSkipUnaffectedTrades) {
+    BOOST_TEST_MESSAGE("Testing sensitivities with and without skipping of unaffected trades");
+
+    SavedSettings backup;
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+    ObservationMode::Mode backupMode = ObservationMode::instance().mode();
+    ObservationMode::instance().setMode(ObservationMode::Mode::Disable);
+
+    QuantLib::ext::shared_ptr<Market> initMarket = QuantLib::ext::make_shared<TestMarket>(today);
+    QuantLib::ext::shared_ptr<analytics::ScenarioSimMarketParameters> simMarketData =
+        TestConfigurationObjects::setupSimMarketData5();
+    QuantLib::ext::shared_ptr<SensitivityScenarioData> sensiData = TestConfigurationObjects::setupSensitivityScenarioData5();
+
+    QuantLib::ext::shared_ptr<EngineData> data = QuantLib::ext::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    data->model("FxOption") = "GarmanKohlhagen";
+    data->engine("FxOption") = "AnalyticEuropeanEngine";
+
+    auto buildPortfolio = []() {
+        auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+        portfolio->add(buildSwap("1_Swap_EUR", "EUR", true, 10000000.0, 0, 10, 0.03, 0.00, "1Y", "30/360", "6M",
+                                 "A360", "EUR-EURIBOR-6M"));
+        portfolio->add(buildSwap("2_Swap_USD", "USD", true, 10000000.0, 0, 15, 0.02, 0.00, "6M", "30/360", "3M",
+                                 "A360", "USD-LIBOR-3M"));
+        portfolio->add(buildSwap("3_Swap_GBP", "GBP", false, 10000000.0, 0, 20, 0.04, 0.00, "6M", "30/360", "3M",
+                                 "A360", "GBP-LIBOR-6M"));
+        portfolio->add(buildFxOption("4_FxOption_EUR_USD", "Long", "Call", 3, "EUR", 10000000.0, "USD", 11000000.0));
+        return portfolio;
+    };
+
+    auto full = QuantLib::ext::make_shared<SensitivityAnalysis>(buildPortfolio(), initMarket, Market::defaultConfiguration,
+                                                                data, simMarketData, sensiData, false);
+    full->generateSensitivities();
+
+    auto skip = QuantLib::ext::make_shared<SensitivityAnalysis>(buildPortfolio(), initMarket, Market::defaultConfiguration,
+                                                                data, simMarketData, sensiData, false);
+    skip->skipUnaffectedTrades(true);
+    skip->generateSensitivities();
+
+    auto const& fullCube = full->sensiCube()->npvCube();
+    auto const& skipCube = skip->sensiCube()->npvCube();
+    BOOST_REQUIRE_EQUAL(skipCube->numIds(), fullCube->numIds());
+    BOOST_REQUIRE_EQUAL(skipCube->samples(), fullCube->samples());
+    for (auto const& [id, idx] : fullCube->idsAndIndexes()) {
+        BOOST_CHECK_CLOSE(skipCube->getT0(id), fullCube->getT0(idx), 1E-10);
+        for (Size s = 0; s < fullCube->samples(); ++s) {
+            Real expected = fullCube->get(idx, 0, s);
+            Real actual = skipCube->get(skipCube->index(id), 0, s);
+            BOOST_CHECK_MESSAGE(std::abs(actual - expected) < 1E-8 * std::max(1.0, std::abs(expected)),
+                                "npv " << actual << " for trade " << id << " scenario " << s
+                                       << " does not match the full revaluation " << expected);
+        }
+    }
+
+    ObservationMode::instance().setMode(backupMode);
+}
+
+BOOST_AUTO_TEST_CASE(testIncrementalUpdate) {
+    BOOST_TEST_MESSAGE("Testing incremental sensitivity update against a full run");
+
+    SavedSettings backup;
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    QuantLib::ext::shared_ptr<Market> initMarket = QuantLib::ext::make_shared<TestMarket>(today);
+    QuantLib::ext::shared_ptr<analytics::ScenarioSimMarketParameters> simMarketData =
+        TestConfigurationObjects::setupSimMarketData5();
+    QuantLib::ext::shared_ptr<SensitivityScenarioData> sensiData = TestConfigurationObjects::setupSensitivityScenarioData5();
+
+    QuantLib::ext::shared_ptr<EngineData> data = QuantLib::ext::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+
+    auto portfolio = QuantLib::ext::make_shared<Portfolio>();
+    portfolio->add(buildSwap("1_Swap_EUR", "EUR", true, 10000000.0, 0, 10, 0.03, 0.00, "1Y", "30/360", "6M", "A360",
+                             "EUR-EURIBOR-6M"));
+    portfolio->add(buildSwap("2_Swap_USD", "USD", true, 10000000.0, 0, 15, 0.02, 0.00, "6M", "30/360", "3M", "A360",
+                             "USD-LIBOR-3M"));
+    portfolio->add(buildSwap("3_Swap_GBP", "GBP", false, 10000000.0, 0, 20, 0.04, 0.00, "6M", "30/360", "3M", "A360",
+                             "GBP-LIBOR-6M"));
+
+    // amend 1_Swap_EUR, remove 2_Swap_USD, add 4_Swap_EUR, keep 3_Swap_GBP
+    auto buildUpdatedPortfolio = []() {
+        auto updated = QuantLib::ext::make_shared<Portfolio>();
+        updated->add(buildSwap("1_Swap_EUR", "EUR", true, 20000000.0, 0, 10, 0.025, 0.00, "1Y", "30/360", "6M",
+                               "A360", "EUR-EURIBOR-6M"));
+        updated->add(buildSwap("3_Swap_GBP", "GBP", false, 10000000.0, 0, 20, 0.04, 0.00, "6M", "30/360", "3M",
+                               "A360", "GBP-LIBOR-6M"));
+        updated->add(buildSwap("4_Swap_EUR", "EUR", false, 5000000.0, 0, 5, 0.02, 0.00, "1Y", "30/360", "6M", "A360",
+                               "EUR-EURIBOR-6M"));
+        return updated;
+    };
+
+    auto incremental = QuantLib::ext::make_shared<SensitivityAnalysis>(
+        portfolio, initMarket, Market::defaultConfiguration, data, simMarketData, sensiData, false);
+    incremental->generateSensitivities();
+    incremental->updateSensitivities(buildUpdatedPortfolio(), {"1_Swap_EUR", "4_Swap_EUR"});
+
+    auto full = QuantLib::ext::make_shared<SensitivityAnalysis>(buildUpdatedPortfolio(), initMarket,
+                                                                Market::defaultConfiguration, data, simMarketData,
+                                                                sensiData, false);
+    full->generateSensitivities();
+
+    BOOST_CHECK_EQUAL(incremental->sensiCube()->tradeIdx().size(), 3);
+    BOOST_CHECK(incremental->sensiCube()->tradeIdx().count("2_Swap_USD") == 0);
+    for (auto const& [id, _] : full->portfolio()->trades()) {
+        BOOST_CHECK_CLOSE(incremental->sensiCube()->npv(id), full->sensiCube()->npv(id), 1E-10);
+        for (auto const& f : full->sensiCube()->factors()) {
+            BOOST_CHECK_SMALL(incremental->sensiCube()->delta(id, f) - full->sensiCube()->delta(id, f), 1E-8);
+            BOOST_CHECK_SMALL(incremental->sensiCube()->gamma(id, f) - full->sensiCube()->gamma(id, f), 1E-8);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
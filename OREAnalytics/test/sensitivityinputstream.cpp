@@ -0,0 +1,121 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/engine/sensitivityfilestream.hpp>
+#include <orea/scenario/shiftscenariogenerator.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <sstream>
+
+using namespace boost::unit_test_framework;
+using namespace std;
+
+using ore::analytics::reconstructFactor;
+using ore::analytics::RiskFactorKey;
+using ore::analytics::SensitivityBufferStream;
+using ore::analytics::SensitivityRecord;
+using QuantLib::Size;
+
+using RFType = RiskFactorKey::KeyType;
+
+namespace {
+
+//! Sensitivity file content with \p n delta and cross gamma records, the comment and empty lines are skipped
+string sensitivityBuffer(const Size n) {
+    ostringstream out;
+    out << "#TradeId,IsPar,Factor_1,ShiftSize_1,Factor_2,ShiftSize_2,Currency,Base NPV,Delta,Gamma\n";
+    vector<string> tenors = {"1M", "3M", "6M", "1Y", "2Y", "5Y", "10Y"};
+    for (Size i = 0; i < n; ++i) {
+        string trade = "trade_" + to_string(i / 10);
+        Size t = i % tenors.size();
+        string factor1 = reconstructFactor(RiskFactorKey(RFType::DiscountCurve, "EUR", t), tenors[t]);
+        string factor2 = i % 3 == 0 ? reconstructFactor(RiskFactorKey(RFType::FXSpot, "USDEUR", 0), "spot") : "";
+        out << trade << ",false," << factor1 << ",0.0001," << factor2 << "," << (factor2.empty() ? "" : "0.01")
+            << ",EUR," << 1000.0 + i << "," << 0.5 * i - 3.0 << "," << (i % 5 == 0 ? "#N/A" : to_string(0.01 * i))
+            << "\n";
+        if (i % 1000 == 0)
+            out << "\n# comment\n";
+    }
+    return out.str();
+}
+
+//! Read all records from \p stream in blocks of size \p blockSize
+vector<SensitivityRecord> readBlocks(SensitivityBufferStream& stream, const Size blockSize) {
+    vector<SensitivityRecord> result, block;
+    while (stream.nextBlock(block, blockSize) > 0)
+        result.insert(result.end(), block.begin(), block.end());
+    return result;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(SensitivityInputStreamTest)
+
+BOOST_AUTO_TEST_CASE(testMultiThreadedParsing) {
+
+    BOOST_TEST_MESSAGE("Testing that multi threaded parsing of a sensitivity stream matches single threaded parsing");
+
+    // More lines than one parse ahead chunk of 4096 * nThreads to reuse the worker threads across chunks
+    const Size nThreads = 3, nRecords = 4096 * nThreads * 2 + 17;
+    string buffer = sensitivityBuffer(nRecords);
+
+    SensitivityBufferStream single(buffer);
+    vector<SensitivityRecord> expected;
+    while (SensitivityRecord sr = single.next())
+        expected.push_back(sr);
+    BOOST_REQUIRE_EQUAL(expected.size(), nRecords);
+
+    SensitivityBufferStream multi(buffer);
+    multi.setThreads(nThreads);
+    for (Size blockSize : {Size(1000), Size(50000)}) {
+        vector<SensitivityRecord> actual = readBlocks(multi, blockSize);
+        BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+        for (Size i = 0; i < expected.size(); ++i)
+            BOOST_CHECK_MESSAGE(actual[i] == expected[i], "record " << i << " differs: " << actual[i] << " vs "
+                                                                    << expected[i]);
+        multi.reset();
+    }
+
+    // Records parsed ahead in nextBlock() are returned by next() first
+    vector<SensitivityRecord> block;
+    BOOST_REQUIRE_EQUAL(multi.nextBlock(block, 10), 10);
+    BOOST_CHECK(multi.next() == expected[10]);
+}
+
+BOOST_AUTO_TEST_CASE(testMultiThreadedParsingError) {
+
+    BOOST_TEST_MESSAGE("Testing that a parse error on a worker thread is rethrown by nextBlock()");
+
+    string buffer = sensitivityBuffer(20000) + "trade_x,false,too,few,entries\n";
+    SensitivityBufferStream multi(buffer);
+    multi.setThreads(4);
+    vector<SensitivityRecord> block;
+    BOOST_CHECK_THROW(
+        {
+            while (multi.nextBlock(block, 5000) > 0) {
+            }
+        },
+        QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,670 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/simm/compactcrif.hpp>
+#include <orea/simm/crif.hpp>
+#include <orea/simm/crifloader.hpp>
+#include <orea/simm/imschedulecalculator.hpp>
+#include <orea/simm/simmbucketmapperbase.hpp>
+#include <orea/simm/simmcalculator.hpp>
+#include <orea/simm/simmconfigurationisdav2_6.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/math/comparison.hpp>
+#include <ql/settings.hpp>
+#include <ql/time/daycounters/actualactual.hpp>
+
+#include <sstream>
+
+using namespace std;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace ore::data;
+using namespace ore::analytics;
+
+using ProductClass = CrifRecord::ProductClass;
+using RiskType = CrifRecord::RiskType;
+using SimmSide = SimmConfiguration::SimmSide;
+using RiskClass = SimmConfiguration::RiskClass;
+using MarginType = SimmConfiguration::MarginType;
+
+namespace {
+
+const vector<string> simmTenors = {"2w", "1m", "3m", "6m", "1y", "2y", "3y", "5y", "10y", "15y", "20y", "30y"};
+
+//! SIMM 2.6 configuration without the dense tenor correlations and constant intra bucket correlations, i.e. using
+//! the pairwise correlation() calls
+class PairwiseSimmConfiguration : public SimmConfiguration_ISDA_V2_6 {
+public:
+    using SimmConfiguration_ISDA_V2_6::SimmConfiguration_ISDA_V2_6;
+    const Matrix& label1Correlations(const RiskType& rt) const override {
+        return SimmConfiguration::label1Correlations(rt);
+    }
+    Real constantIntraBucketCorrelation(const RiskType& rt, const string& bucket) const override {
+        return SimmConfiguration::constantIntraBucketCorrelation(rt, bucket);
+    }
+};
+
+QuantLib::ext::shared_ptr<SimmBucketMapper> bucketMapper() {
+    return QuantLib::ext::make_shared<SimmBucketMapperBase>();
+}
+
+//! IR delta and vega sensitivities on several sub curves and tenors in two currencies for two trades
+Crif irCrif(const NettingSetDetails& nsd = NettingSetDetails("CPTY_A")) {
+    Crif crif;
+    Size n = 0;
+    for (const string& ccy : {"USD", "EUR"}) {
+        for (const string& subCurve : {"OIS", "Libor3m", "Libor6m"}) {
+            for (const string& tenor : simmTenors) {
+                string tradeId = n % 3 == 0 ? "trade_2" : "trade_1";
+                Real amount = 1000.0 * (1.0 + n % 7) * (n % 4 == 0 ? -1.0 : 1.0);
+                crif.addRecord(CrifRecord(tradeId, "Swap", nsd, ProductClass::RatesFX, RiskType::IRCurve, ccy, "",
+                                          tenor, subCurve, "USD", amount, amount));
+                ++n;
+            }
+        }
+        for (const string& tenor : simmTenors) {
+            Real amount = 50000.0 * (1.0 + n % 5) * (n % 3 == 0 ? -1.0 : 1.0);
+            crif.addRecord(CrifRecord("trade_1", "Swaption", nsd, ProductClass::RatesFX, RiskType::IRVol, ccy, "",
+                                      tenor, "", "USD", amount, amount));
+            ++n;
+        }
+    }
+    return crif;
+}
+
+//! Check that two calculators produce the same margins for all sides, netting sets and regulations
+void checkSameResults(const SimmCalculator& expected, const SimmCalculator& actual, const Real tolerance = 1.0e-8) {
+    BOOST_REQUIRE_EQUAL(expected.simmResults().size(), actual.simmResults().size());
+    for (const auto& [side, nettingSets] : expected.simmResults()) {
+        for (const auto& [nsd, regulations] : nettingSets) {
+            for (const auto& [regulation, results] : regulations) {
+                const SimmResults& other = actual.simmResults(side, nsd, regulation);
+                BOOST_REQUIRE_EQUAL(results.data().size(), other.data().size());
+                for (const auto& [key, im] : results.data()) {
+                    auto it = other.data().find(key);
+                    BOOST_REQUIRE(it != other.data().end());
+                    BOOST_CHECK_CLOSE(im, it->second, tolerance);
+                }
+            }
+        }
+    }
+}
+
+//! Tab delimited CRIF with \p n IR delta lines over several trades, portfolios, currencies, tenors and sub curves
+string irCrifBuffer(const Size n) {
+    ostringstream out;
+    out << "TradeID\tPortfolioID\tProductClass\tRiskType\tQualifier\tBucket\tLabel1\tLabel2\tAmountCurrency\tAmount"
+        << "\tAmountUSD\n";
+    vector<string> ccys = {"USD", "EUR", "GBP"}, subCurves = {"OIS", "Libor3m", "Libor6m"};
+    for (Size i = 0; i < n; ++i) {
+        Real amount = 100.0 * (1.0 + i % 11) * (i % 4 == 0 ? -1.0 : 1.0);
+        out << "trade_" << i % 97 << "\tCPTY_" << (i % 5 == 0 ? "A" : "B") << "\tRatesFX\tRisk_IRCurve\t"
+            << ccys[i % ccys.size()] << "\t1\t" << simmTenors[i % simmTenors.size()] << "\t"
+            << subCurves[(i / 7) % subCurves.size()] << "\tUSD\t" << amount << "\t" << amount << "\n";
+        if (i % 2000 == 0)
+            out << "\n";
+    }
+    return out.str();
+}
+
+//! Equity, commodity and credit delta and vega sensitivities on several qualifiers per bucket, the amounts of the
+//! qualifiers span several orders of magnitude so that some exceed the concentration thresholds. The buckets are
+//! added to \p mapper.
+Crif bucketedCrif(const QuantLib::ext::shared_ptr<SimmBucketMapper>& mapper, const Real scale = 1.0) {
+    Crif crif;
+    NettingSetDetails nsd("CPTY_A");
+    vector<std::tuple<ProductClass, RiskType, RiskType, string>> riskTypes = {
+        {ProductClass::Equity, RiskType::Equity, RiskType::EquityVol, "EQ"},
+        {ProductClass::Commodity, RiskType::Commodity, RiskType::CommodityVol, "COMM"},
+        {ProductClass::Credit, RiskType::CreditQ, RiskType::CreditVol, "ISSUER"}};
+    Size n = 0;
+    for (const auto& [pc, deltaRt, vegaRt, prefix] : riskTypes) {
+        for (const string& bucket : {"1", "2"}) {
+            for (Size q = 0; q < 6; ++q) {
+                string qualifier = prefix + "_" + bucket + "_" + std::to_string(q);
+                mapper->addMapping(deltaRt, qualifier, bucket);
+                mapper->addMapping(vegaRt, qualifier, bucket);
+                Real amount = std::pow(10.0, 3.0 + q) * (q % 2 == 0 ? 1.0 : -0.7) * (q == 5 ? scale : 1.0);
+                string label1 = deltaRt == RiskType::CreditQ ? (n % 2 == 0 ? "2y" : "5y") : "";
+                crif.addRecord(CrifRecord("trade_1", "Swap", nsd, pc, deltaRt, qualifier, bucket, label1, "", "USD",
+                                          amount, amount));
+                if (deltaRt == RiskType::CreditQ)
+                    crif.addRecord(CrifRecord("trade_2", "Swap", nsd, pc, deltaRt, qualifier, bucket, "10y", "",
+                                              "USD", -0.3 * amount, -0.3 * amount));
+                crif.addRecord(CrifRecord("trade_2", "Option", nsd, pc, vegaRt, qualifier, bucket, "1y", "", "USD",
+                                          0.1 * amount, 0.1 * amount));
+                ++n;
+            }
+        }
+    }
+    return crif;
+}
+
+//! Total SIMM of a \p side, netting set \p nsd and \p regulation, zero if there is none
+Real totalSimm(const SimmCalculator& calculator, const SimmSide& side, const NettingSetDetails& nsd,
+               const string& regulation) {
+    const auto& results = calculator.simmResults();
+    if (results.count(side) == 0 || results.at(side).count(nsd) == 0 || results.at(side).at(nsd).count(regulation) == 0)
+        return 0.0;
+    const SimmResults& r = results.at(side).at(nsd).at(regulation);
+    return r.has(ProductClass::All, RiskClass::All, MarginType::All, "All")
+               ? r.get(ProductClass::All, RiskClass::All, MarginType::All, "All")
+               : 0.0;
+}
+
+//! A Schedule trade, i.e. a notional and a PV record
+struct ScheduleTrade {
+    string tradeId;
+    NettingSetDetails nsd;
+    ProductClass productClass;
+    Real notional, pv;
+    string endDate, collectRegulations, postRegulations;
+};
+
+//! Schedule trades in three netting sets over several product classes, sharing end dates and regulation strings
+vector<ScheduleTrade> scheduleTrades() {
+    vector<ScheduleTrade> trades;
+    vector<ProductClass> productClasses = {ProductClass::Rates, ProductClass::Credit, ProductClass::FX,
+                                           ProductClass::Equity, ProductClass::Commodity};
+    vector<string> endDates = {"2027-03-20", "2029-06-20", "2036-12-20"};
+    for (Size i = 0; i < 30; ++i) {
+        trades.push_back({"trade_" + std::to_string(i), NettingSetDetails("CPTY_" + std::to_string(i % 3)),
+                          productClasses[i % productClasses.size()], 1.0e6 * (1.0 + i % 4),
+                          1.0e4 * (i % 3 == 0 ? -1.0 : 2.0) * (1.0 + i % 5), endDates[i % endDates.size()],
+                          i % 2 == 0 ? "SEC,ESA" : "ESA,SEC", "USPR"});
+    }
+    return trades;
+}
+
+Crif scheduleCrif(const vector<ScheduleTrade>& trades) {
+    Crif crif;
+    for (const ScheduleTrade& t : trades) {
+        crif.addRecord(CrifRecord(t.tradeId, "Swap", t.nsd, t.productClass, RiskType::Notional, "", "", "", "", "USD",
+                                  t.notional, t.notional, "Schedule", t.collectRegulations, t.postRegulations,
+                                  t.endDate));
+        crif.addRecord(CrifRecord(t.tradeId, "Swap", t.nsd, t.productClass, RiskType::PV, "", "", "", "", "USD", t.pv,
+                                  t.pv, "Schedule", t.collectRegulations, t.postRegulations, t.endDate));
+    }
+    return crif;
+}
+
+//! Schedule IM of the trades of a netting set on a side, calculated directly from the schedule
+Real expectedScheduleIm(const vector<ScheduleTrade>& trades, const NettingSetDetails& nsd, const SimmSide& side) {
+    ActualActual dc(ActualActual::ISDA);
+    Date today = Settings::instance().evaluationDate();
+    Real gross = 0.0, grossRc = 0.0, pv = 0.0;
+    for (const ScheduleTrade& t : trades) {
+        if (!(t.nsd == nsd))
+            continue;
+        Real m = dc.yearFraction(today, parseDate(t.endDate));
+        Real multiplier = 0.0;
+        switch (t.productClass) {
+        case ProductClass::Rates:
+            multiplier = m < 2.0 ? 0.01 : m < 5.0 ? 0.02 : 0.04;
+            break;
+        case ProductClass::Credit:
+            multiplier = m < 2.0 ? 0.02 : m < 5.0 ? 0.05 : 0.10;
+            break;
+        case ProductClass::FX:
+            multiplier = 0.06;
+            break;
+        default:
+            multiplier = 0.15;
+        }
+        gross += multiplier * t.notional;
+        grossRc += side == SimmSide::Call ? std::max(0.0, t.pv) : std::min(0.0, t.pv);
+        pv += t.pv;
+    }
+    Real netRc = side == SimmSide::Call ? std::max(0.0, pv) : std::min(0.0, pv);
+    Real ngr = close_enough(grossRc, 0.0) ? 1.0 : netRc / grossRc;
+    return gross * (0.4 + 0.6 * ngr);
+}
+
+//! Schedule IM of a netting set, side and regulation
+Real scheduleIm(const IMScheduleCalculator& calculator, const SimmSide& side, const NettingSetDetails& nsd,
+                const string& regulation) {
+    return calculator.imScheduleSummaryResults(side, nsd).at(regulation).get(ProductClass::All).scheduleIM;
+}
+
+//! Check that two CRIFs contain the same records with the same amounts
+void checkSameCrif(const Crif& expected, const Crif& actual) {
+    BOOST_REQUIRE_EQUAL(expected.size(), actual.size());
+    auto it = actual.begin();
+    for (const auto& cr : expected) {
+        BOOST_CHECK(cr == *it);
+        BOOST_CHECK_EQUAL(cr.amount, it->amount);
+        BOOST_CHECK_EQUAL(cr.amountUsd, it->amountUsd);
+        ++it;
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(SimmCalculatorTest)
+
+BOOST_AUTO_TEST_CASE(testDenseIrTenorAggregation) {
+
+    BOOST_TEST_MESSAGE("Testing SIMM IR aggregation with dense tenor correlations against the pairwise aggregation");
+
+    auto dense = QuantLib::ext::make_shared<SimmConfiguration_ISDA_V2_6>(bucketMapper());
+    auto pairwise = QuantLib::ext::make_shared<PairwiseSimmConfiguration>(bucketMapper());
+    BOOST_REQUIRE(!dense->label1Correlations(RiskType::IRCurve).empty());
+    BOOST_REQUIRE(pairwise->label1Correlations(RiskType::IRCurve).empty());
+
+    Crif crif = irCrif();
+    SimmCalculator expected(crif, pairwise, "USD", "USD", "USD", nullptr, true, false, true);
+    SimmCalculator actual(crif, dense, "USD", "USD", "USD", nullptr, true, false, true);
+
+    BOOST_REQUIRE(!expected.simmResults().empty());
+    checkSameResults(expected, actual);
+}
+
+BOOST_AUTO_TEST_CASE(testMultiThreadedCrifLoading) {
+
+    BOOST_TEST_MESSAGE("Testing that the multi threaded CRIF loading matches the single threaded one");
+
+    // More lines than one chunk of 4096 * nThreads so that the worker threads are reused across chunks
+    const Size nThreads = 3;
+    string buffer = irCrifBuffer(4096 * nThreads * 2 + 17);
+    auto config = QuantLib::ext::make_shared<SimmConfiguration_ISDA_V2_6>(bucketMapper());
+
+    for (bool aggregateTrades : {true, false}) {
+        CsvBufferCrifLoader single(buffer, config, {}, false, aggregateTrades);
+        Crif expected = single.loadCrif();
+        BOOST_REQUIRE(!expected.empty());
+
+        CsvBufferCrifLoader multi(buffer, config, {}, false, aggregateTrades);
+        multi.setThreads(nThreads);
+        checkSameCrif(expected, multi.loadCrif());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testCompactCrifRoundTrip) {
+
+    BOOST_TEST_MESSAGE("Testing that a CompactCrif converts to the same Crif as adding the records to a Crif");
+
+    // duplicate keys, fx vol qualifiers in both orders, additional fields and SIMM parameters
+    vector<CrifRecord> records;
+    for (const CrifRecord& cr : irCrif())
+        records.push_back(cr);
+    for (const CrifRecord& cr : irCrif(NettingSetDetails("CPTY_B")))
+        records.push_back(cr);
+    for (const CrifRecord& cr : irCrif())
+        records.push_back(cr);
+    for (const string& qualifier : {"EURUSD", "USDEUR", "GBPUSD"}) {
+        records.push_back(CrifRecord("trade_3", "FxOption", NettingSetDetails("CPTY_A"), ProductClass::RatesFX,
+                                     RiskType::FXVol, qualifier, "", "1y", "", "USD", 1500.0, 1500.0, "SIMM", "SEC",
+                                     "SEC", "", {{"Desk", "FX"}}));
+    }
+    records.push_back(CrifRecord("", "", NettingSetDetails("CPTY_A"), ProductClass::AddOnFixedAmount,
+                                 RiskType::AddOnFixedAmount, "", "", "", "", "USD", 1.0e5, 1.0e5));
+    records.push_back(CrifRecord("", "", NettingSetDetails("CPTY_A"), ProductClass::AddOnFixedAmount,
+                                 RiskType::AddOnFixedAmount, "", "", "", "", "USD", 2.0e5, 2.0e5));
+    records.push_back(CrifRecord("", "", NettingSetDetails("CPTY_A"), ProductClass::Empty,
+                                 RiskType::ProductClassMultiplier, "RatesFX", "", "", "", "", 1.2, Null<Real>()));
+
+    Crif expected;
+    CompactCrif compact;
+    for (const CrifRecord& cr : records) {
+        expected.addRecord(cr);
+        compact.addRecord(cr);
+    }
+    BOOST_CHECK_LT(compact.size(), records.size());
+
+    Crif actual = compact.toCrif();
+    checkSameCrif(expected, actual);
+    for (auto it = expected.begin(), jt = actual.begin(); it != expected.end(); ++it, ++jt) {
+        BOOST_CHECK_EQUAL(it->tradeType, jt->tradeType);
+        BOOST_CHECK_EQUAL(it->imModel, jt->imModel);
+        BOOST_CHECK(it->additionalFields == jt->additionalFields);
+    }
+
+    // the margins on the round tripped Crif are the same, too
+    auto config = QuantLib::ext::make_shared<SimmConfiguration_ISDA_V2_6>(bucketMapper());
+    SimmCalculator simmExpected(expected, config, "USD", "USD", "USD", nullptr, true, false, true);
+    SimmCalculator simmActual(actual, config, "USD", "USD", "USD", nullptr, true, false, true);
+    checkSameResults(simmExpected, simmActual);
+}
+
+BOOST_AUTO_TEST_CASE(testMultiThreadedCalculation) {
+
+    BOOST_TEST_MESSAGE("Testing that the multi threaded SIMM calculation matches the single threaded one");
+
+    // several netting sets with different collect and post regulations and an add-on
+    Crif crif;
+    vector<pair<string, string>> regulations = {{"SEC,CFTC", "USPR"}, {"ESA", "SEC"}, {"", ""}, {"SEC", "ESA,JFSA"}};
+    for (Size i = 0; i < 5; ++i) {
+        NettingSetDetails nsd("CPTY_" + std::to_string(i));
+        for (CrifRecord cr : irCrif(nsd)) {
+            cr.collectRegulations = regulations[i % regulations.size()].first;
+            cr.postRegulations = regulations[i % regulations.size()].second;
+            cr.amountUsd *= 1.0 + 0.1 * i;
+            cr.amount = cr.amountUsd;
+            crif.addRecord(cr);
+        }
+    }
+    crif.addRecord(CrifRecord("", "", NettingSetDetails("CPTY_1"), ProductClass::AddOnFixedAmount,
+                              RiskType::AddOnFixedAmount, "", "", "", "", "USD", 1.0e5, 1.0e5, "SIMM", "ESA", "SEC"));
+
+    auto config = QuantLib::ext::make_shared<SimmConfiguration_ISDA_V2_6>(bucketMapper());
+    SimmCalculator expected(crif, config, "USD", "USD", "USD", nullptr, true, false, true, {}, {}, 1);
+    BOOST_REQUIRE(!expected.simmResults().empty());
+
+    for (Size nThreads : {2, 3, 8}) {
+        SimmCalculator actual(crif, config, "USD", "USD", "USD", nullptr, true, false, true, {}, {}, nThreads);
+        checkSameResults(expected, actual, 0.0);
+        BOOST_CHECK(expected.winningRegulations() == actual.winningRegulations());
+        for (const auto& [side, nettingSets] : expected.finalSimmResults()) {
+            for (const auto& [nsd, result] : nettingSets) {
+                const auto& other = actual.finalSimmResults(side, nsd);
+                BOOST_CHECK_EQUAL(result.first, other.first);
+                BOOST_CHECK(result.second.data() == other.second.data());
+            }
+        }
+        BOOST_CHECK_EQUAL(expected.simmParameters().size(), actual.simmParameters().size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testConstantIntraBucketAggregation) {
+
+    BOOST_TEST_MESSAGE("Testing SIMM intra bucket aggregation with constant correlations against the pairwise one");
+
+    auto mapper = bucketMapper();
+    Crif crif = bucketedCrif(mapper);
+    auto structured = QuantLib::ext::make_shared<SimmConfiguration_ISDA_V2_6>(mapper);
+    auto pairwise = QuantLib::ext::make_shared<PairwiseSimmConfiguration>(mapper);
+    BOOST_REQUIRE(structured->constantIntraBucketCorrelation(RiskType::Equity, "1") != Null<Real>());
+    BOOST_REQUIRE(pairwise->constantIntraBucketCorrelation(RiskType::Equity, "1") == Null<Real>());
+
+    // the constant correlation agrees with the pairwise correlation between different qualifiers
+    for (const auto& [rt, prefix] : vector<pair<RiskType, string>>{
+             {RiskType::Equity, "EQ"}, {RiskType::Commodity, "COMM"}, {RiskType::CreditQ, "ISSUER"}}) {
+        BOOST_CHECK_CLOSE(structured->constantIntraBucketCorrelation(rt, "2"),
+                          structured->correlation(rt, prefix + "_2_0", "", "", rt, prefix + "_2_1", "", ""), 1.0e-12);
+    }
+
+    auto check = [&pairwise, &structured](const Crif& crif) {
+        SimmCalculator expected(crif, pairwise, "USD", "USD", "USD", nullptr, true, false, true);
+        SimmCalculator actual(crif, structured, "USD", "USD", "USD", nullptr, true, false, true);
+        BOOST_REQUIRE(!expected.simmResults().empty());
+        checkSameResults(expected, actual);
+    };
+    check(crif);
+
+    // changing the amounts changes the order of the qualifiers by concentration risk
+    check(bucketedCrif(mapper, 1.0e-4));
+
+    // a CRIF bucket that differs from the configured bucket falls back to the pairwise aggregation
+    mapper->addMapping(RiskType::Equity, "EQ_X", "2");
+    crif.addRecord(CrifRecord("trade_1", "Swap", NettingSetDetails("CPTY_A"), ProductClass::Equity, RiskType::Equity,
+                              "EQ_X", "1", "", "", "USD", 5.0e6, 5.0e6));
+    check(crif);
+}
+
+BOOST_AUTO_TEST_CASE(testRiskWeightCache) {
+
+    BOOST_TEST_MESSAGE("Testing the cached SIMM risk weights and concentration thresholds");
+
+    auto mapper = QuantLib::ext::make_shared<SimmBucketMapperBase>();
+    mapper->addMapping(RiskType::Equity, "EQ_Y", "1");
+    mapper->addMapping(RiskType::EquityVol, "EQ_Y", "1");
+    auto config = QuantLib::ext::make_shared<SimmConfiguration_ISDA_V2_6>(mapper);
+
+    // a configuration built after a change of the mappings has empty caches and serves as the uncached reference
+    auto check = [&mapper, &config]() {
+        SimmConfiguration_ISDA_V2_6 uncached(mapper);
+        for (Size i = 0; i < 2; ++i) {
+            BOOST_CHECK_EQUAL(config->weight(RiskType::Equity, string("EQ_Y")),
+                              uncached.weight(RiskType::Equity, string("EQ_Y")));
+            BOOST_CHECK_EQUAL(config->weight(RiskType::IRCurve, string("USD"), string("5y")),
+                              uncached.weight(RiskType::IRCurve, string("USD"), string("5y")));
+            for (RiskType rt : {RiskType::Equity, RiskType::EquityVol})
+                BOOST_CHECK_EQUAL(config->concentrationThreshold(rt, "EQ_Y"),
+                                  uncached.concentrationThreshold(rt, "EQ_Y"));
+        }
+        return std::make_pair(config->weight(RiskType::Equity, string("EQ_Y")),
+                              config->concentrationThreshold(RiskType::Equity, "EQ_Y"));
+    };
+
+    auto bucket1 = check();
+
+    // after a reset EQ_Y is not mapped anymore and falls into the residual bucket
+    std::size_t version = mapper->version();
+    mapper->reset();
+    BOOST_CHECK(mapper->version() != version);
+    auto residual = check();
+    BOOST_CHECK(residual.first != bucket1.first);
+    BOOST_CHECK(residual.second != bucket1.second);
+
+    // adding the mapping again restores the bucket 1 values
+    version = mapper->version();
+    mapper->addMapping(RiskType::Equity, "EQ_Y", "1");
+    mapper->addMapping(RiskType::EquityVol, "EQ_Y", "1");
+    BOOST_CHECK(mapper->version() != version);
+    auto remapped = check();
+    BOOST_CHECK_EQUAL(remapped.first, bucket1.first);
+    BOOST_CHECK_EQUAL(remapped.second, bucket1.second);
+}
+
+BOOST_AUTO_TEST_CASE(testMarginalSimm) {
+
+    BOOST_TEST_MESSAGE("Testing that the marginal SIMM equals the difference of two full SIMM calculations");
+
+    auto mapper = bucketMapper();
+    auto config = QuantLib::ext::make_shared<SimmConfiguration_ISDA_V2_6>(mapper);
+    NettingSetDetails nsd("CPTY_A");
+    Crif crif = irCrif(nsd);
+    crif.addRecords(bucketedCrif(mapper));
+    SimmCalculator calculator(crif, config, "USD", "USD", "USD", nullptr, true, false, true);
+    const auto& regulations = calculator.simmResults().at(SimmSide::Call).at(nsd);
+    BOOST_REQUIRE(!regulations.empty());
+    const string regulation = regulations.begin()->first;
+
+    // a candidate trade touching the IR, FX and equity risk classes
+    Crif candidate;
+    for (const string& tenor : {"1y", "5y", "10y"})
+        candidate.addRecord(CrifRecord("trade_new", "Swap", nsd, ProductClass::RatesFX, RiskType::IRCurve, "USD", "",
+                                       tenor, "OIS", "USD", -2.0e4, -2.0e4));
+    candidate.addRecord(CrifRecord("trade_new", "FxForward", nsd, ProductClass::RatesFX, RiskType::FX, "EUR", "", "",
+                                   "", "USD", 3.0e6, 3.0e6));
+    candidate.addRecord(CrifRecord("trade_new", "EquityOption", nsd, ProductClass::Equity, RiskType::Equity, "EQ_1_2",
+                                   "1", "", "", "USD", 4.0e5, 4.0e5));
+
+    Crif withCandidate = crif;
+    withCandidate.addRecords(candidate);
+    SimmCalculator full(withCandidate, config, "USD", "USD", "USD", nullptr, true, false, true);
+    for (const SimmSide side : {SimmSide::Call, SimmSide::Post}) {
+        Real expected = totalSimm(full, side, nsd, regulation) - totalSimm(calculator, side, nsd, regulation);
+        BOOST_CHECK_CLOSE(calculator.marginalSimm(candidate, side, nsd, regulation), expected, 1.0e-8);
+    }
+
+    // removing a trade by passing its negated sensitivities
+    Crif removal, withoutTrade;
+    for (const CrifRecord& cr : crif) {
+        if (cr.tradeId == "trade_2") {
+            CrifRecord negated = cr;
+            negated.amount = -cr.amount;
+            negated.amountUsd = -cr.amountUsd;
+            removal.addRecord(negated);
+        } else {
+            withoutTrade.addRecord(cr);
+        }
+    }
+    BOOST_REQUIRE(!removal.empty());
+    SimmCalculator reduced(withoutTrade, config, "USD", "USD", "USD", nullptr, true, false, true);
+    Real expected = totalSimm(reduced, SimmSide::Call, nsd, regulation) -
+                    totalSimm(calculator, SimmSide::Call, nsd, regulation);
+    BOOST_CHECK_CLOSE(calculator.marginalSimm(removal, SimmSide::Call, nsd, regulation), expected, 1.0e-8);
+
+    // the calculator is not changed by the what-if calculations
+    SimmCalculator fresh(crif, config, "USD", "USD", "USD", nullptr, true, false, true);
+    checkSameResults(fresh, calculator, 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(testTradeAllocations) {
+
+    BOOST_TEST_MESSAGE("Testing the Euler allocation of SIMM to trades");
+
+    auto mapper = bucketMapper();
+    auto config = QuantLib::ext::make_shared<SimmConfiguration_ISDA_V2_6>(mapper);
+    NettingSetDetails nsd("CPTY_A");
+
+    // CRIF with the trades scaled by the given factors
+    auto scaled = [](const Crif& crif, const map<string, Real>& factors) {
+        Crif result;
+        for (const CrifRecord& cr : crif) {
+            CrifRecord r = cr;
+            if (auto f = factors.find(cr.tradeId); f != factors.end()) {
+                r.amount *= f->second;
+                r.amountUsd *= f->second;
+            }
+            result.addRecord(r);
+        }
+        return result;
+    };
+
+    // the allocations add up to the total SIMM, including curvature and concentration
+    Crif crif = irCrif(nsd);
+    crif.addRecords(bucketedCrif(mapper));
+    SimmCalculator calculator(crif, config, "USD", "USD", "USD", nullptr, true, false, true);
+    const string regulation = calculator.simmResults().at(SimmSide::Call).at(nsd).begin()->first;
+    for (const SimmSide side : {SimmSide::Call, SimmSide::Post}) {
+        map<string, Real> allocations = calculator.tradeAllocations(side, nsd, regulation);
+        BOOST_CHECK_EQUAL(allocations.size(), 2);
+        Real sum = 0.0;
+        for (const auto& [tradeId, a] : allocations)
+            sum += a;
+        BOOST_CHECK_CLOSE(sum, totalSimm(calculator, side, nsd, regulation), 1.0e-8);
+    }
+
+    // the allocations match the finite difference derivatives of the total SIMM with respect to the trade sizes for
+    // delta sensitivities below the concentration thresholds, for which SIMM is homogeneous of order one
+    Crif deltaCrif;
+    for (const CrifRecord& cr : irCrif(nsd)) {
+        if (cr.riskType == RiskType::IRCurve)
+            deltaCrif.addRecord(cr);
+    }
+    SimmCalculator deltaCalculator(deltaCrif, config, "USD", "USD", "USD", nullptr, true, false, true);
+    map<string, Real> allocations = deltaCalculator.tradeAllocations(SimmSide::Call, nsd, regulation);
+    BOOST_REQUIRE_EQUAL(allocations.size(), 2);
+    const Real h = 1.0e-5;
+    for (const auto& [tradeId, a] : allocations) {
+        SimmCalculator up(scaled(deltaCrif, {{tradeId, 1.0 + h}}), config, "USD", "USD", "USD", nullptr, true, false,
+                          true);
+        SimmCalculator down(scaled(deltaCrif, {{tradeId, 1.0 - h}}), config, "USD", "USD", "USD", nullptr, true, false,
+                            true);
+        Real fd = (totalSimm(up, SimmSide::Call, nsd, regulation) - totalSimm(down, SimmSide::Call, nsd, regulation)) /
+                  (2.0 * h);
+        BOOST_CHECK_CLOSE(a, fd, 1.0e-4);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testCrifByNettingSet) {
+
+    BOOST_TEST_MESSAGE("Testing loading a CRIF by netting set with the netting set columns in any position");
+
+    // the netting set columns are not at their default positions and use alternative header names, the netting sets
+    // differ in the call type and agreement type only
+    vector<tuple<string, string, string>> nettingSets = {
+        {"CPTY_A", "ISDA", "Bilateral"}, {"CPTY_A", "ISDA", "Unilateral"}, {"CPTY_A", "CSA", "Unilateral"}};
+    ostringstream out;
+    out << "call_type\tAmountUSD\tQualifier\tTradeID\tAgreementType\tRiskType\tportfolio_id\tBucket\tLabel1\tLabel2"
+        << "\tProductClass\tAmountCurrency\tAmount\n";
+    Size n = 0;
+    for (const auto& [portfolio, agreement, callType] : nettingSets) {
+        for (const string& tenor : simmTenors) {
+            Real amount = 1000.0 * (1.0 + n % 7);
+            out << callType << "\t" << amount << "\tUSD\ttrade_" << n % 3 << "\t" << agreement
+                << "\tRisk_IRCurve\t" << portfolio << "\t1\t" << tenor << "\tOIS\tRatesFX\tUSD\t" << amount
+                << "\n";
+            ++n;
+        }
+    }
+    auto config = QuantLib::ext::make_shared<SimmConfiguration_ISDA_V2_6>(bucketMapper());
+
+    CsvBufferCrifLoader loader(out.str(), config, {}, false, false);
+    Crif expected = loader.loadCrif();
+    BOOST_REQUIRE_EQUAL(expected.size(), n);
+
+    vector<Crif> blocks;
+    CsvBufferCrifLoader blockLoader(out.str(), config, {}, false, false);
+    blockLoader.loadCrifByNettingSet([&blocks](Crif&& crif) { blocks.push_back(std::move(crif)); });
+    BOOST_REQUIRE_EQUAL(blocks.size(), nettingSets.size());
+
+    Crif merged;
+    set<NettingSetDetails> seen;
+    for (Size i = 0; i < blocks.size(); ++i) {
+        const auto& [portfolio, agreement, callType] = nettingSets[i];
+        NettingSetDetails nsd(portfolio, agreement, callType);
+        BOOST_CHECK_EQUAL(blocks[i].size(), simmTenors.size());
+        for (const CrifRecord& cr : blocks[i]) {
+            BOOST_CHECK_EQUAL(cr.nettingSetDetails, nsd);
+            merged.addRecord(cr);
+        }
+        BOOST_CHECK(seen.insert(nsd).second);
+    }
+    checkSameCrif(expected, merged);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(IMScheduleCalculatorTest)
+
+BOOST_AUTO_TEST_CASE(testScheduleIm) {
+
+    BOOST_TEST_MESSAGE("Testing the IM Schedule calculator against the schedule and across thread counts");
+
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Date(15, June, 2026);
+
+    map<SimmSide, set<NettingSetDetails>> none = {{SimmSide::Call, {}}, {SimmSide::Post, {}}};
+    auto check = [&none](const vector<ScheduleTrade>& trades) {
+        Crif crif = scheduleCrif(trades);
+        IMScheduleCalculator single(crif, "USD", nullptr, true, true, true, none, none, 1);
+        IMScheduleCalculator multi(crif, "USD", nullptr, true, true, true, none, none, 4);
+        for (const string& ns : {"CPTY_0", "CPTY_1", "CPTY_2"}) {
+            NettingSetDetails nsd(ns);
+            // the permutations of the regulation strings are parsed to the same regulations
+            for (const auto& [side, regulations] : map<SimmSide, vector<string>>{
+                     {SimmSide::Call, {"ESA", "SEC"}}, {SimmSide::Post, {"USPR"}}}) {
+                BOOST_CHECK_EQUAL(single.imScheduleSummaryResults(side, nsd).size(), regulations.size());
+                Real expected = expectedScheduleIm(trades, nsd, side);
+                for (const string& regulation : regulations) {
+                    BOOST_CHECK_CLOSE(scheduleIm(single, side, nsd, regulation), expected, 1.0e-10);
+                    BOOST_CHECK_EQUAL(scheduleIm(multi, side, nsd, regulation),
+                                      scheduleIm(single, side, nsd, regulation));
+                }
+            }
+        }
+    };
+
+    vector<ScheduleTrade> trades = scheduleTrades();
+    check(trades);
+
+    // changing the end dates of some trades, the other trades with the same end date keep theirs
+    for (Size i = 0; i < trades.size(); i += 4)
+        trades[i].endDate = trades[i].endDate == "2027-03-20" ? "2031-09-20" : "2027-03-20";
+    check(trades);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
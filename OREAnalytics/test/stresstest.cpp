@@ -37,6 +37,9 @@
 #include <orea/scenario/scenariosimmarket.hpp>
 #include <orea/scenario/scenariosimmarketparameters.hpp>
 #include <orea/scenario/stressscenariogenerator.hpp>
+#include <ored/configuration/conventions.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
 #include <ored/model/lgmdata.hpp>
 #include <ored/portfolio/builders/capfloor.hpp>
 #include <ored/portfolio/builders/fxforward.hpp>
@@ -48,6 +51,7 @@
 #include <ored/portfolio/swaption.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/osutils.hpp>
+#include <oret/datapaths.hpp>
 #include <oret/toplevelfixture.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/time/calendars/target.hpp>
@@ -381,6 +385,132 @@ BOOST_AUTO_TEST_CASE(regression) {
     IndexManager::instance().clearHistories();
 }
 
+BOOST_AUTO_TEST_CASE(testSkipUnaffectedTrades) {
+    BOOST_TEST_MESSAGE("Testing stress results with and without skipping of unaffected trades");
+
+    SavedSettings backup;
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+    ObservationMode::Mode backupMode = ObservationMode::instance().mode();
+    ObservationMode::instance().setMode(ObservationMode::Mode::Disable);
+
+    QuantLib::ext::shared_ptr<Market> initMarket = QuantLib::ext::make_shared<TestMarket>(today);
+    QuantLib::ext::shared_ptr<analytics::ScenarioSimMarketParameters> simMarketData = setupStressSimMarketData();
+    QuantLib::ext::shared_ptr<StressTestScenarioData> stressData = setupStressScenarioData();
+    stressConv();
+
+    QuantLib::ext::shared_ptr<EngineData> engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->model("Swap") = "DiscountedCashflows";
+    engineData->engine("Swap") = "DiscountingSwapEngine";
+    engineData->model("FxOption") = "GarmanKohlhagen";
+    engineData->engine("FxOption") = "AnalyticEuropeanEngine";
+    engineData->model("CapFloor") = "IborCapModel";
+    engineData->engine("CapFloor") = "IborCapEngine";
+
+    QuantLib::ext::shared_ptr<Portfolio> portfolio(new Portfolio());
+    portfolio->add(buildSwap("1_Swap_EUR", "EUR", true, 10000000.0, 0, 10, 0.03, 0.00, "1Y", "30/360", "6M", "A360",
+                             "EUR-EURIBOR-6M"));
+    portfolio->add(buildSwap("2_Swap_USD", "USD", true, 10000000.0, 0, 15, 0.02, 0.00, "6M", "30/360", "3M", "A360",
+                             "USD-LIBOR-3M"));
+    portfolio->add(buildSwap("4_Swap_JPY", "JPY", true, 1000000000.0, 0, 5, 0.01, 0.00, "6M", "30/360", "3M", "A360",
+                             "JPY-LIBOR-6M"));
+    portfolio->add(buildFxOption("7_FxOption_EUR_USD", "Long", "Call", 3, "EUR", 10000000.0, "USD", 11000000.0));
+    portfolio->add(buildCap("9_Cap_EUR", "EUR", "Long", 0.05, 1000000.0, 0, 10, "6M", "A360", "EUR-EURIBOR-6M"));
+
+    // the stress test rebuilds the portfolio, so both runs can share it
+    ore::analytics::StressTest full(portfolio, initMarket, "default", engineData, simMarketData, stressData);
+    ore::analytics::StressTest skip(portfolio, initMarket, "default", engineData, simMarketData, stressData,
+                                    CurveConfigurations(), TodaysMarketParameters(), nullptr, nullptr,
+                                    IborFallbackConfig::defaultConfig(), false, true);
+
+    BOOST_REQUIRE_EQUAL(skip.baseNPV().size(), full.baseNPV().size());
+    for (auto const& [id, npv] : full.baseNPV())
+        BOOST_CHECK_CLOSE(skip.baseNPV().at(id), npv, 1E-10);
+    BOOST_REQUIRE_EQUAL(skip.shiftedNPV().size(), full.shiftedNPV().size());
+    BOOST_REQUIRE(!full.shiftedNPV().empty());
+    for (auto const& [key, npv] : full.shiftedNPV()) {
+        Real actual = skip.shiftedNPV().at(key);
+        BOOST_CHECK_MESSAGE(std::abs(actual - npv) < 1E-8 * std::max(1.0, std::abs(npv)),
+                            "shifted npv " << actual << " for trade " << key.first << " scenario " << key.second
+                                           << " does not match the full revaluation " << npv);
+    }
+
+    ObservationMode::instance().setMode(backupMode);
+    IndexManager::instance().clearHistories();
+}
+
+BOOST_AUTO_TEST_CASE(testMultiThreaded) {
+    BOOST_TEST_MESSAGE("Testing the multi-threaded stress test against the single-threaded stress test");
+
+#ifndef QL_ENABLE_SESSIONS
+    BOOST_TEST_MESSAGE("Skipped, the multi-threaded valuation engine requires QL_ENABLE_SESSIONS = ON");
+    return;
+#endif
+
+    SavedSettings backup;
+    Date today(5, February, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    auto conventions = QuantLib::ext::make_shared<Conventions>();
+    conventions->fromFile(TEST_INPUT_FILE("conventions.xml"));
+    InstrumentConventions::instance().setConventions(conventions);
+    auto curveConfigs = QuantLib::ext::make_shared<CurveConfigurations>();
+    curveConfigs->fromFile(TEST_INPUT_FILE("curveconfig.xml"));
+    auto todaysMarketParams = QuantLib::ext::make_shared<TodaysMarketParameters>();
+    todaysMarketParams->fromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+    auto engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->fromFile(TEST_INPUT_FILE("pricingengine.xml"));
+    auto simMarketData = QuantLib::ext::make_shared<ScenarioSimMarketParameters>();
+    simMarketData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto loader =
+        QuantLib::ext::make_shared<CSVLoader>(TEST_INPUT_FILE("market.txt"), TEST_INPUT_FILE("fixings.txt"), false);
+    auto market = QuantLib::ext::make_shared<TodaysMarket>(today, todaysMarketParams, loader, curveConfigs);
+
+    // a parallel and a twist scenario on the EUR curves
+    auto stressData = QuantLib::ext::make_shared<StressTestScenarioData>();
+    vector<Period> tenors = {6 * Months, 1 * Years, 2 * Years, 5 * Years, 10 * Years};
+    vector<vector<Real>> shifts = {{0.001, 0.001, 0.001, 0.001, 0.001}, {-0.002, -0.001, 0.0, 0.001, 0.002}};
+    for (Size i = 0; i < shifts.size(); ++i) {
+        StressTestScenarioData::StressTestData data;
+        data.label = "stresstest_" + std::to_string(i + 1);
+        data.discountCurveShifts["EUR"].shiftType = ShiftType::Absolute;
+        data.discountCurveShifts["EUR"].shiftTenors = tenors;
+        data.discountCurveShifts["EUR"].shifts = shifts[i];
+        data.indexCurveShifts["EUR-EURIBOR-6M"] = data.discountCurveShifts["EUR"];
+        stressData->data().push_back(data);
+    }
+
+    auto portfolio = [] {
+        auto p = QuantLib::ext::make_shared<Portfolio>();
+        p->fromFile(TEST_INPUT_FILE("portfolio.xml"));
+        return p;
+    };
+
+    ore::analytics::StressTest single(portfolio(), market, Market::defaultConfiguration, engineData, simMarketData,
+                                      stressData, *curveConfigs, *todaysMarketParams);
+
+    // one trade per chunk, so that all threads get work
+    ore::analytics::StressTest multi(3, loader, portfolio(), market, Market::defaultConfiguration, engineData,
+                                     simMarketData, stressData, curveConfigs, todaysMarketParams, nullptr, nullptr,
+                                     IborFallbackConfig::defaultConfig(), false, false, 1);
+
+    BOOST_REQUIRE_EQUAL(single.baseNPV().size(), 3);
+    BOOST_CHECK(multi.trades() == single.trades());
+    BOOST_CHECK(multi.stressTests() == single.stressTests());
+    BOOST_REQUIRE_EQUAL(multi.baseNPV().size(), single.baseNPV().size());
+    for (auto const& [id, npv] : single.baseNPV())
+        BOOST_CHECK_CLOSE(multi.baseNPV().at(id), npv, 1E-10);
+    BOOST_REQUIRE_EQUAL(multi.shiftedNPV().size(), single.shiftedNPV().size());
+    BOOST_REQUIRE_EQUAL(single.shiftedNPV().size(), 6);
+    for (auto const& [key, npv] : single.shiftedNPV()) {
+        Real actual = multi.shiftedNPV().at(key);
+        BOOST_CHECK_MESSAGE(std::abs(actual - npv) < 1E-8 * std::max(1.0, std::abs(npv)),
+                            "multi-threaded shifted npv " << actual << " for trade " << key.first << " scenario "
+                                                          << key.second << " does not match the single-threaded npv "
+                                                          << npv);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
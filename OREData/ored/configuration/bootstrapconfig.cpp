@@ -25,10 +25,10 @@ namespace ore {
 namespace data {
 
 BootstrapConfig::BootstrapConfig(Real accuracy, Real globalAccuracy, bool dontThrow, Size maxAttempts, Real maxFactor,
-                                 Real minFactor, Size dontThrowSteps)
+                                 Real minFactor, Size dontThrowSteps, bool warmStart)
     : accuracy_(accuracy), globalAccuracy_(globalAccuracy == Null<Real>() ? accuracy_ : globalAccuracy),
       dontThrow_(dontThrow), maxAttempts_(maxAttempts), maxFactor_(maxFactor), minFactor_(minFactor),
-      dontThrowSteps_(dontThrowSteps) {}
+      dontThrowSteps_(dontThrowSteps), warmStart_(warmStart) {}
 
 void BootstrapConfig::fromXML(XMLNode* node) {
 
@@ -74,6 +74,11 @@ void BootstrapConfig::fromXML(XMLNode* node) {
         QL_REQUIRE(dontThrowSteps > 0, "DontThrowSteps (" << dontThrowSteps << ") must be a positive integer");
         dontThrowSteps_ = static_cast<Size>(dontThrowSteps);
     }
+
+    warmStart_ = false;
+    if (XMLNode* n = XMLUtils::getChildNode(node, "WarmStart")) {
+        warmStart_ = parseBool(XMLUtils::getNodeValue(n));
+    }
 }
 
 XMLNode* BootstrapConfig::toXML(XMLDocument& doc) const {
@@ -86,6 +91,8 @@ XMLNode* BootstrapConfig::toXML(XMLDocument& doc) const {
     XMLUtils::addChild(doc, node, "MaxFactor", maxFactor_);
     XMLUtils::addChild(doc, node, "MinFactor", minFactor_);
     XMLUtils::addChild(doc, node, "DontThrowSteps", static_cast<int>(dontThrowSteps_));
+    if (warmStart_)
+        XMLUtils::addChild(doc, node, "WarmStart", warmStart_);
 
     return node;
 }
@@ -37,7 +37,7 @@ public:
     //! Constructor
     BootstrapConfig(QuantLib::Real accuracy = 1.0e-12, QuantLib::Real globalAccuracy = QuantLib::Null<QuantLib::Real>(),
                     bool dontThrow = false, QuantLib::Size maxAttempts = 5, QuantLib::Real maxFactor = 2.0,
-                    QuantLib::Real minFactor = 2.0, QuantLib::Size dontThrowSteps = 10);
+                    QuantLib::Real minFactor = 2.0, QuantLib::Size dontThrowSteps = 10, bool warmStart = false);
 
     //! \name XMLSerializable interface
     //@{
@@ -54,6 +54,9 @@ public:
     QuantLib::Real maxFactor() const { return maxFactor_; }
     QuantLib::Real minFactor() const { return minFactor_; }
     QuantLib::Size dontThrowSteps() const { return dontThrowSteps_; }
+    /*! If true, the bootstrap starts from the pillar values of the last bootstrap of the same curve recorded in the
+        BootstrapSeeds store, if any, and records its own solution there. */
+    bool warmStart() const { return warmStart_; }
     //@}
 
 private:
@@ -64,6 +67,7 @@ private:
     QuantLib::Real maxFactor_;
     QuantLib::Real minFactor_;
     QuantLib::Size dontThrowSteps_;
+    bool warmStart_;
 };
 
 } // namespace data
@@ -94,6 +94,7 @@ void InstrumentConventions::setConventions(
     const QuantLib::ext::shared_ptr<ore::data::Conventions>& conventions, QuantLib::Date d) {
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     conventions_[d] = conventions;
+    ++generation_;
 }
 
 ZeroRateConvention::ZeroRateConvention(const string& id, const string& dayCounter, const string& compounding,
@@ -2285,6 +2286,7 @@ void CommodityFutureConvention::build() {
 
     QL_REQUIRE(!balanceOfTheMonth_ || isAveraging(), "Balance of the month make only sense for averaging futures");
 
+    expiryCache_ = QuantLib::ext::make_shared<ExpiryCache>();
 }
 
 Frequency CommodityFutureConvention::parseAndValidateFrequency(const std::string & strFrequency) {
@@ -40,6 +40,10 @@
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/thread/lock_types.hpp>
 
+#include <atomic>
+#include <map>
+#include <tuple>
+
 namespace ore {
 namespace data {
 using ore::data::XMLNode;
@@ -169,12 +173,18 @@ private:
     mutable std::map<QuantLib::Date, QuantLib::ext::shared_ptr<ore::data::Conventions>> conventions_;
     mutable boost::shared_mutex mutex_;
     mutable std::size_t numberOfEmittedWarnings_ = 0;
+    std::atomic<std::size_t> generation_ = 0;
 
 public:
     const QuantLib::ext::shared_ptr<ore::data::Conventions>& conventions(QuantLib::Date d = QuantLib::Date()) const;
     void setConventions(const QuantLib::ext::shared_ptr<ore::data::Conventions>& conventions,
                         QuantLib::Date d = QuantLib::Date());
-    void clear() { conventions_.clear(); }
+    void clear() {
+        conventions_.clear();
+        ++generation_;
+    }
+    //! increased whenever conventions are set or cleared, identifies the conventions in use e.g. for caches
+    std::size_t generation() const { return generation_; }
 };
 
 //! Container for storing Zero Rate conventions
@@ -1610,6 +1620,21 @@ public:
     const std::string& optionUnderlyingFutureConvention() const { return optionUnderlyingFutureConvention_; }
     //@}
 
+    /*! Expiry dates computed by the ConventionsBasedFutureExpiry for this convention, so that the curves and trades
+        sharing the convention share the date calculations. The cache is shared by copies of the convention and
+        replaced in build(). */
+    struct ExpiryCache {
+        boost::shared_mutex mutex;
+        //! expiries by day of month, contract month, contract year, month offset and option flag
+        std::map<std::tuple<QuantLib::Day, QuantLib::Month, QuantLib::Year, QuantLib::Natural, bool>, QuantLib::Date>
+            expiries;
+        //! next expiries by reference date and option flag
+        std::map<std::pair<QuantLib::Date, bool>, QuantLib::Date> nextExpiries;
+        //! hash of the added and removed holidays of the convention calendars when the dates were cached
+        std::size_t holidays = 0;
+    };
+    const QuantLib::ext::shared_ptr<ExpiryCache>& expiryCache() const { return expiryCache_; }
+
     //! Serialisation
     //@{
     void fromXML(XMLNode* node) override;
@@ -1684,6 +1709,7 @@ private:
     Calendar balanceOfTheMonthPricingCalendar_;
     //! Option Underlying Future convention
     std::string optionUnderlyingFutureConvention_;
+    QuantLib::ext::shared_ptr<ExpiryCache> expiryCache_;
     //! Populate and check frequency.
     Frequency parseAndValidateFrequency(const std::string& strFrequency);
 
@@ -333,7 +333,8 @@ void YieldCurveConfig::fromXML(XMLNode* node) {
         Real accuracy = XMLUtils::getChildValueAsDouble(node, "Tolerance", false);
         bootstrapConfig_ =
             BootstrapConfig(accuracy, accuracy, bootstrapConfig_.dontThrow(), bootstrapConfig_.maxAttempts(),
-                            bootstrapConfig_.maxFactor(), bootstrapConfig_.minFactor());
+                            bootstrapConfig_.maxFactor(), bootstrapConfig_.minFactor(),
+                            bootstrapConfig_.dontThrowSteps(), bootstrapConfig_.warmStart());
     }
 
     populateRequiredCurveIds();
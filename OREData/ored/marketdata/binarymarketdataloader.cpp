@@ -0,0 +1,332 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/marketdata/binarymarketdataloader.hpp>
+#include <ored/marketdata/marketdatumparser.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/parsers.hpp>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <tuple>
+
+namespace ore {
+namespace data {
+
+namespace {
+
+const char binaryMarketDataMagic[8] = {'O', 'R', 'E', 'M', 'K', 'T', 'D', '\0'};
+const std::uint32_t binaryMarketDataVersion = 1;
+const std::size_t binaryMarketDataAlignment = 8;
+const std::size_t binaryMarketDataPreambleSize =
+    sizeof(binaryMarketDataMagic) + 2 * sizeof(std::uint32_t) + 3 * sizeof(std::uint64_t);
+
+std::size_t padding(const std::size_t pos) {
+    return (binaryMarketDataAlignment - pos % binaryMarketDataAlignment) % binaryMarketDataAlignment;
+}
+
+template <class T> void writeColumn(std::ofstream& out, const std::vector<T>& v) {
+    out.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+}
+
+} // namespace
+
+void writeBinaryMarketDataFile(const std::vector<std::string>& marketFiles, const std::string& filename) {
+
+    // read the quotes without parsing the keys, keep the first of duplicate quotes
+
+    std::map<std::pair<Date, std::string>, Real> quotes;
+    for (auto const& marketFile : marketFiles) {
+        std::ifstream file(marketFile.c_str());
+        QL_REQUIRE(file.is_open(), "error opening file " << marketFile);
+        std::string line;
+        while (std::getline(file, line)) {
+            boost::trim(line);
+            // skip blank and comment lines
+            if (line.empty() || line[0] == '#')
+                continue;
+            std::vector<std::string> tokens;
+            boost::split(tokens, line, boost::is_any_of(",;\t "), boost::token_compress_on);
+            QL_REQUIRE(tokens.size() == 3, "Invalid market data line, 3 tokens expected " << line);
+            if (!quotes.emplace(std::make_pair(parseDate(tokens[0]), tokens[1]), parseReal(tokens[2])).second) {
+                WLOG("Skipped MarketDatum " << tokens[1] << " - this is already present.");
+            }
+        }
+    }
+
+    // build the name dictionary and the quote columns sorted by date and name
+
+    std::map<std::string, std::uint64_t> nameIndex;
+    for (auto const& q : quotes)
+        nameIndex.emplace(q.first.second, 0);
+    std::string names;
+    std::vector<std::uint64_t> nameOffsets;
+    for (auto& [name, index] : nameIndex) {
+        index = nameOffsets.size();
+        nameOffsets.push_back(names.size());
+        names.append(name);
+        names.push_back('\0');
+    }
+    names.append(padding(binaryMarketDataPreambleSize + names.size()), '\0');
+
+    std::vector<std::int64_t> dates;
+    std::vector<std::uint64_t> nameIndices;
+    std::vector<double> values;
+    dates.reserve(quotes.size());
+    nameIndices.reserve(quotes.size());
+    values.reserve(quotes.size());
+    for (auto const& [key, value] : quotes) {
+        dates.push_back(key.first.serialNumber());
+        nameIndices.push_back(nameIndex[key.second]);
+        values.push_back(value);
+    }
+
+    // write the file
+
+    std::ofstream out(filename, std::ios::binary | std::ios::out | std::ios::trunc);
+    QL_REQUIRE(out.is_open(), "Error opening file " << filename << " for binary market data");
+    std::uint32_t version = binaryMarketDataVersion, flags = 0;
+    std::uint64_t nNames = nameOffsets.size(), nQuotes = values.size(), namesSize = names.size();
+    out.write(binaryMarketDataMagic, sizeof(binaryMarketDataMagic));
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+    out.write(reinterpret_cast<const char*>(&nNames), sizeof(nNames));
+    out.write(reinterpret_cast<const char*>(&nQuotes), sizeof(nQuotes));
+    out.write(reinterpret_cast<const char*>(&namesSize), sizeof(namesSize));
+    out.write(names.data(), names.size());
+    writeColumn(out, nameOffsets);
+    writeColumn(out, dates);
+    writeColumn(out, nameIndices);
+    writeColumn(out, values);
+    QL_REQUIRE(out.good(), "Error writing binary market data to " << filename);
+    out.close();
+
+    LOG("Wrote " << nQuotes << " quotes with " << nNames << " distinct names to binary market data file "
+                 << filename);
+}
+
+BinaryMarketDataLoader::BinaryMarketDataLoader(const std::string& filename,
+                                               const QuantLib::ext::shared_ptr<Loader>& fixingLoader)
+    : filename_(filename), fixingLoader_(fixingLoader) {
+    QL_REQUIRE(boost::filesystem::exists(filename), "BinaryMarketDataLoader: file '" << filename << "' not found");
+    QL_REQUIRE(boost::filesystem::file_size(filename) >= binaryMarketDataPreambleSize,
+               "BinaryMarketDataLoader: file '" << filename << "' is too small for a binary market data file");
+    file_.open(filename);
+    const char* p = file_.data();
+    const std::size_t fileSize = file_.size();
+
+    std::uint32_t version, flags;
+    std::uint64_t nNames, nQuotes, namesSize;
+    QL_REQUIRE(std::memcmp(p, binaryMarketDataMagic, sizeof(binaryMarketDataMagic)) == 0,
+               "BinaryMarketDataLoader: file '" << filename << "' is not a binary market data file");
+    p += sizeof(binaryMarketDataMagic);
+    std::memcpy(&version, p, sizeof(version));
+    p += sizeof(version);
+    std::memcpy(&flags, p, sizeof(flags));
+    p += sizeof(flags);
+    std::memcpy(&nNames, p, sizeof(nNames));
+    p += sizeof(nNames);
+    std::memcpy(&nQuotes, p, sizeof(nQuotes));
+    p += sizeof(nQuotes);
+    std::memcpy(&namesSize, p, sizeof(namesSize));
+    p += sizeof(namesSize);
+    QL_REQUIRE(version == binaryMarketDataVersion, "BinaryMarketDataLoader: version "
+                                                       << version << " not supported, expected "
+                                                       << binaryMarketDataVersion);
+    QL_REQUIRE((binaryMarketDataPreambleSize + namesSize) % binaryMarketDataAlignment == 0,
+               "BinaryMarketDataLoader: invalid name dictionary size in '" << filename << "'");
+    QL_REQUIRE(fileSize == binaryMarketDataPreambleSize + namesSize + nNames * sizeof(std::uint64_t) +
+                               nQuotes * (sizeof(std::int64_t) + sizeof(std::uint64_t) + sizeof(double)),
+               "BinaryMarketDataLoader: file '" << filename << "' has size " << fileSize
+                                                 << ", which does not match " << nNames << " names and " << nQuotes
+                                                 << " quotes");
+
+    // the file is mapped at a page boundary and all columns are aligned to 8 bytes
+
+    nNames_ = nNames;
+    nQuotes_ = nQuotes;
+    names_ = p;
+    p += namesSize;
+    nameOffsets_ = reinterpret_cast<const std::uint64_t*>(p);
+    p += nNames * sizeof(std::uint64_t);
+    dates_ = reinterpret_cast<const std::int64_t*>(p);
+    p += nQuotes * sizeof(std::int64_t);
+    nameIndices_ = reinterpret_cast<const std::uint64_t*>(p);
+    p += nQuotes * sizeof(std::uint64_t);
+    values_ = reinterpret_cast<const double*>(p);
+
+    LOG("BinaryMarketDataLoader: opened " << filename << " with " << nQuotes_ << " quotes and " << nNames_
+                                          << " distinct names");
+}
+
+Size BinaryMarketDataLoader::nameIndex(const std::string& name) const {
+    Size lo = 0, hi = nNames_;
+    while (lo < hi) {
+        Size mid = lo + (hi - lo) / 2;
+        int c = std::strcmp(names_ + nameOffsets_[mid], name.c_str());
+        if (c == 0)
+            return mid;
+        if (c < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return nNames_;
+}
+
+std::pair<Size, Size> BinaryMarketDataLoader::dateRange(const Date& d) const {
+    auto r = std::equal_range(dates_, dates_ + nQuotes_, static_cast<std::int64_t>(d.serialNumber()));
+    return std::make_pair(r.first - dates_, r.second - dates_);
+}
+
+Size BinaryMarketDataLoader::quoteIndex(const std::pair<Size, Size>& range, const Size n) const {
+    auto it = std::lower_bound(nameIndices_ + range.first, nameIndices_ + range.second, n);
+    if (it == nameIndices_ + range.second || *it != n)
+        return nQuotes_;
+    return it - nameIndices_;
+}
+
+QuantLib::ext::shared_ptr<MarketDatum> BinaryMarketDataLoader::materialise(const Size i) const {
+    {
+        boost::shared_lock<boost::shared_mutex> lock(mutex_);
+        auto md = data_.find(i);
+        if (md != data_.end())
+            return md->second;
+    }
+
+    Date date(static_cast<Date::serial_type>(dates_[i]));
+    std::string name(names_ + nameOffsets_[nameIndices_[i]]);
+    QuantLib::ext::shared_ptr<MarketDatum> md;
+    try {
+        md = parseMarketDatum(date, name, values_[i]);
+    } catch (const std::exception& e) {
+        WLOG("Failed to parse MarketDatum " << name << ": " << e.what());
+    }
+
+    // skip FX spot quotes if the reverse quote is given in the dominant direction
+    if (auto fx = QuantLib::ext::dynamic_pointer_cast<FXSpotQuote>(md)) {
+        Size reverse = nameIndex("FX/RATE/" + fx->ccy() + "/" + fx->unitCcy());
+        if (reverse != nNames_ && quoteIndex(dateRange(date), reverse) != nQuotes_ &&
+            fxDominance(fx->unitCcy(), fx->ccy()) != fx->unitCcy() + fx->ccy()) {
+            TLOG("Skipped MarketDatum " << name << " - dominant FX quote is present.");
+            md = nullptr;
+        }
+    }
+
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    return data_.emplace(i, md).first->second;
+}
+
+Size BinaryMarketDataLoader::numberOfMaterialisedQuotes() const {
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return data_.size();
+}
+
+std::vector<QuantLib::ext::shared_ptr<MarketDatum>> BinaryMarketDataLoader::loadQuotes(const Date& d) const {
+    std::vector<QuantLib::ext::shared_ptr<MarketDatum>> result;
+    auto range = dateRange(d);
+    for (Size i = range.first; i < range.second; ++i) {
+        if (auto md = materialise(i))
+            result.push_back(md);
+    }
+    return result;
+}
+
+QuantLib::ext::shared_ptr<MarketDatum> BinaryMarketDataLoader::get(const std::string& name, const Date& d) const {
+    Size n = nameIndex(name);
+    Size i = n == nNames_ ? nQuotes_ : quoteIndex(dateRange(d), n);
+    QuantLib::ext::shared_ptr<MarketDatum> md = i == nQuotes_ ? nullptr : materialise(i);
+    QL_REQUIRE(md != nullptr, "No datum for " << name << " on date " << d);
+    return md;
+}
+
+std::set<QuantLib::ext::shared_ptr<MarketDatum>> BinaryMarketDataLoader::get(const std::set<std::string>& names,
+                                                                             const Date& asof) const {
+    std::set<QuantLib::ext::shared_ptr<MarketDatum>> result;
+    auto range = dateRange(asof);
+    for (auto const& name : names) {
+        Size n = nameIndex(name);
+        if (n == nNames_)
+            continue;
+        Size i = quoteIndex(range, n);
+        if (i == nQuotes_)
+            continue;
+        if (auto md = materialise(i))
+            result.insert(md);
+    }
+    return result;
+}
+
+std::set<QuantLib::ext::shared_ptr<MarketDatum>> BinaryMarketDataLoader::get(const Wildcard& wildcard,
+                                                                             const Date& asof) const {
+    if (!wildcard.hasWildcard()) {
+        // no wildcard => use get by name function
+        try {
+            return {get(wildcard.pattern(), asof)};
+        } catch (...) {
+        }
+        return {};
+    }
+    std::set<QuantLib::ext::shared_ptr<MarketDatum>> result;
+    auto range = dateRange(asof);
+    const std::uint64_t *it1 = nameIndices_ + range.first, *it2 = nameIndices_ + range.second;
+    if (wildcard.wildcardPos() != 0) {
+        // the names are sorted within a date, so we can restrict the search to the names starting with the prefix
+        std::string prefix = wildcard.pattern().substr(0, wildcard.wildcardPos());
+        auto compare = [this](const std::uint64_t n, const std::string& s) {
+            return std::strcmp(names_ + nameOffsets_[n], s.c_str()) < 0;
+        };
+        it1 = std::lower_bound(it1, it2, prefix, compare);
+        it2 = std::lower_bound(it1, it2, prefix + "\xFF", compare);
+    }
+    for (auto it = it1; it != it2; ++it) {
+        if (wildcard.isPrefix() || wildcard.matches(names_ + nameOffsets_[*it])) {
+            if (auto md = materialise(it - nameIndices_))
+                result.insert(md);
+        }
+    }
+    return result;
+}
+
+bool BinaryMarketDataLoader::has(const std::string& name, const Date& d) const {
+    Size n = nameIndex(name);
+    if (n == nNames_)
+        return false;
+    Size i = quoteIndex(dateRange(d), n);
+    return i != nQuotes_ && materialise(i) != nullptr;
+}
+
+bool BinaryMarketDataLoader::hasQuotes(const Date& d) const {
+    auto range = dateRange(d);
+    return range.second > range.first;
+}
+
+std::set<Fixing> BinaryMarketDataLoader::loadFixings() const {
+    return fixingLoader_ ? fixingLoader_->loadFixings() : std::set<Fixing>();
+}
+
+std::set<QuantExt::Dividend> BinaryMarketDataLoader::loadDividends() const {
+    return fixingLoader_ ? fixingLoader_->loadDividends() : std::set<QuantExt::Dividend>();
+}
+
+} // namespace data
+} // namespace ore
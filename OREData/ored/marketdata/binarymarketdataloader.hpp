@@ -0,0 +1,113 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/marketdata/binarymarketdataloader.hpp
+    \brief loader reading market quotes lazily from a memory mapped binary quote file
+    \ingroup marketdata
+*/
+
+#pragma once
+
+#include <ored/marketdata/loader.hpp>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
+#include <cstdint>
+#include <map>
+
+namespace ore {
+namespace data {
+
+/*! Convert market data files in the format read by the CSVLoader (date, key, value per line) to a binary quote file
+
+    The file layout is
+    - the magic "OREMKTD\0", a uint32 version and uint32 flags (currently unused)
+    - the number of names, the number of quotes and the size of the name dictionary (uint64 each)
+    - the name dictionary, i.e. the sorted distinct quote names, each terminated by \0, padded to a multiple of 8 bytes
+    - the offsets of the names in the dictionary (uint64)
+    - the quote columns, sorted by date and name: the date serial numbers (int64), the name indices (uint64) and the
+      values (double)
+
+    The quotes are not parsed into market datum instances, duplicate quotes are skipped with a warning, keeping the
+    first occurrence as the CSVLoader does. The values are written in native byte order, i.e. the files are not
+    portable between platforms with different endianness.
+*/
+void writeBinaryMarketDataFile(const std::vector<std::string>& marketFiles, const std::string& filename);
+
+//! Loader reading market quotes from a binary quote file written by writeBinaryMarketDataFile()
+/*! The file is memory mapped. Market datum instances are only created when quotes are requested and memoised, so
+    that repeated requests for the same quote return the same object. Quotes that can not be parsed are skipped with
+    a warning on first request. As in the CSVLoader, if both FX/RATE/CCY1/CCY2 and FX/RATE/CCY2/CCY1 are given for a
+    date, only the quote in the dominant direction is returned.
+
+    Fixings and dividends are forwarded to an optional loader, e.g. a CSVLoader without market files.
+
+    The memoisation is thread safe, so that instances can be shared between threads, e.g. as the source of
+    LazyClonedLoader instances.
+
+    \ingroup marketdata
+*/
+class BinaryMarketDataLoader : public Loader {
+public:
+    explicit BinaryMarketDataLoader(const std::string& filename,
+                                    const QuantLib::ext::shared_ptr<Loader>& fixingLoader = nullptr);
+
+    std::vector<QuantLib::ext::shared_ptr<MarketDatum>> loadQuotes(const QuantLib::Date& d) const override;
+    QuantLib::ext::shared_ptr<MarketDatum> get(const std::string& name, const QuantLib::Date& d) const override;
+    std::set<QuantLib::ext::shared_ptr<MarketDatum>> get(const std::set<std::string>& names,
+                                                         const QuantLib::Date& asof) const override;
+    std::set<QuantLib::ext::shared_ptr<MarketDatum>> get(const Wildcard& wildcard,
+                                                         const QuantLib::Date& asof) const override;
+    bool has(const std::string& name, const QuantLib::Date& d) const override;
+    bool hasQuotes(const QuantLib::Date& d) const override;
+    std::set<Fixing> loadFixings() const override;
+    std::set<QuantExt::Dividend> loadDividends() const override;
+
+    //! number of quotes in the file
+    QuantLib::Size numberOfQuotes() const { return nQuotes_; }
+
+    //! number of market datum instances created so far
+    QuantLib::Size numberOfMaterialisedQuotes() const;
+
+private:
+    // index of the name in the dictionary, nNames_ if not found
+    QuantLib::Size nameIndex(const std::string& name) const;
+    // range of quote indices for the given date
+    std::pair<QuantLib::Size, QuantLib::Size> dateRange(const QuantLib::Date& d) const;
+    // quote index for the given name index within the date range, nQuotes_ if not found
+    QuantLib::Size quoteIndex(const std::pair<QuantLib::Size, QuantLib::Size>& range, const QuantLib::Size n) const;
+    // market datum for the given quote index, null if it can not be parsed or is dominated by the reverse FX quote
+    QuantLib::ext::shared_ptr<MarketDatum> materialise(const QuantLib::Size i) const;
+
+    std::string filename_;
+    QuantLib::ext::shared_ptr<Loader> fixingLoader_;
+    boost::iostreams::mapped_file_source file_;
+    QuantLib::Size nNames_ = 0, nQuotes_ = 0;
+    const char* names_ = nullptr;
+    const std::uint64_t* nameOffsets_ = nullptr;
+    const std::int64_t* dates_ = nullptr;
+    const std::uint64_t* nameIndices_ = nullptr;
+    const double* values_ = nullptr;
+
+    mutable boost::shared_mutex mutex_;
+    mutable std::map<QuantLib::Size, QuantLib::ext::shared_ptr<MarketDatum>> data_;
+};
+
+} // namespace data
+} // namespace ore
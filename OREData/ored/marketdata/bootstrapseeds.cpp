@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/marketdata/bootstrapseeds.hpp>
+#include <ored/utilities/csvfilereader.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/parsers.hpp>
+#include <ored/utilities/to_string.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/thread/locks.hpp>
+
+#include <fstream>
+#include <iomanip>
+
+namespace ore {
+namespace data {
+
+BootstrapSeeds::Seed BootstrapSeeds::seed(const std::string& key) const {
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    if (auto s = seeds_.find(key); s != seeds_.end())
+        return s->second;
+    return Seed();
+}
+
+void BootstrapSeeds::set(const std::string& key, const Seed& seed) {
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    seeds_[key] = seed;
+}
+
+void BootstrapSeeds::clear() {
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    seeds_.clear();
+}
+
+QuantLib::Size BootstrapSeeds::size() const {
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return seeds_.size();
+}
+
+void BootstrapSeeds::save(const std::string& filename) const {
+    std::ofstream out(filename);
+    QL_REQUIRE(out.is_open(), "BootstrapSeeds::save(): error opening file '" << filename << "'");
+    out << "#Key,Date,Value\n" << std::setprecision(17);
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    for (auto const& [key, seed] : seeds_) {
+        QL_REQUIRE(key.find_first_of(",;\t") == std::string::npos,
+                   "BootstrapSeeds::save(): key '" << key << "' must not contain a delimiter (,;\\t)");
+        for (auto const& [date, value] : seed)
+            out << key << ',' << ore::data::to_string(date) << ',' << value << '\n';
+    }
+    QL_REQUIRE(out.good(), "BootstrapSeeds::save(): error writing file '" << filename << "'");
+    DLOG("Saved " << seeds_.size() << " bootstrap seeds to " << filename);
+}
+
+void BootstrapSeeds::load(const std::string& filename) {
+    CSVFileReader reader(filename, true);
+    std::map<std::string, Seed> seeds;
+    while (reader.next())
+        seeds[reader.get(0)][parseDate(reader.get(1))] = parseReal(reader.get(2));
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    for (auto& [key, seed] : seeds)
+        seeds_[key] = std::move(seed);
+    DLOG("Loaded " << seeds.size() << " bootstrap seeds from " << filename);
+}
+
+} // namespace data
+} // namespace ore
@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/marketdata/bootstrapseeds.hpp
+    \brief process wide store of bootstrapped curve pillar values used as initial guesses for later bootstraps
+    \ingroup marketdata
+*/
+
+#pragma once
+
+#include <ql/patterns/singleton.hpp>
+#include <ql/time/date.hpp>
+
+#include <boost/thread/shared_mutex.hpp>
+
+#include <map>
+#include <string>
+
+namespace ore {
+namespace data {
+
+/*! Holds the pillar values of the last bootstrap per curve, so that the next bootstrap of the same curve, e.g. in
+    an intraday market rebuild, can start from them, see BootstrapConfig::warmStart(). The values are stored in the
+    representation of the bootstrap traits (e.g. zero rates, discount factors or survival probabilities), the key
+    must therefore identify the curve and the traits.
+
+    The seeds can be saved to and loaded from a csv file with the columns Key, Date, Value, so that e.g. the
+    previous day's solution can be used for the first market build of the day. */
+class BootstrapSeeds : public QuantLib::Singleton<BootstrapSeeds, std::integral_constant<bool, true>> {
+public:
+    typedef std::map<QuantLib::Date, QuantLib::Real> Seed;
+
+    //! returns the seed for the given key, empty if there is none
+    Seed seed(const std::string& key) const;
+
+    //! stores the pillar values for the given key, replacing an existing seed
+    void set(const std::string& key, const Seed& seed);
+
+    //! clear the store
+    void clear();
+
+    //! number of stored seeds
+    QuantLib::Size size() const;
+
+    //! save the seeds to a csv file
+    void save(const std::string& filename) const;
+
+    //! load the seeds from a csv file, replacing existing seeds with the same keys
+    void load(const std::string& filename);
+
+private:
+    mutable boost::shared_mutex mutex_;
+    std::map<std::string, Seed> seeds_;
+};
+
+} // namespace data
+} // namespace ore
@@ -220,17 +220,16 @@ std::set<QuantLib::ext::shared_ptr<MarketDatum>> CSVLoader::get(const std::set<s
 
 std::set<QuantLib::ext::shared_ptr<MarketDatum>> CSVLoader::get(const Wildcard& wildcard,
                                                              const QuantLib::Date& asof) const {
-    if (!wildcard.hasWildcard()) {
-        // no wildcard => use get by name function
-        try {
-            return {get(wildcard.pattern(), asof)};
-        } catch (...) {
-        }
-        return {};
-    }
     auto it = data_.find(asof);
     if (it == data_.end())
         return {};
+    if (!wildcard.hasWildcard()) {
+        // no wildcard => look up the name, without the exception thrown by get() for missing quotes
+        auto it2 = it->second.find(makeDummyMarketDatum(asof, wildcard.pattern()));
+        if (it2 != it->second.end())
+            return {*it2};
+        return {};
+    }
     std::set<QuantLib::ext::shared_ptr<MarketDatum>> result;
     std::set<QuantLib::ext::shared_ptr<MarketDatum>>::iterator it1, it2;
     if (wildcard.wildcardPos() == 0) {
@@ -16,6 +16,7 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <ored/marketdata/bootstrapseeds.hpp>
 #include <ored/marketdata/defaultcurve.hpp>
 #include <ored/marketdata/yieldcurve.hpp>
 #include <ored/utilities/log.hpp>
@@ -483,12 +484,20 @@ void DefaultCurve::buildCdsCurve(const std::string& curveID, const DefaultCurveC
 
     } else {
 
-        // build single name curve
+        // build single name curve, warm starting from the last bootstrap of this curve if configured
+
+        bool warmStart = config.bootstrapConfig().warmStart();
+        BootstrapSeeds::Seed initialGuess;
+        if (warmStart) {
+            initialGuess = BootstrapSeeds::instance().seed(spec.name());
+            DLOG("DefaultCurve: warm start from " << initialGuess.size() << " seed pillars");
+        }
 
         QuantLib::ext::shared_ptr<DefaultProbabilityTermStructure> tmp = QuantLib::ext::make_shared<SpCurve>(
             asof, helpers, config.dayCounter(), LogLinear(),
             QuantExt::IterativeBootstrap<SpCurve>(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                  minFactor, dontThrowSteps));
+                                                  minFactor, dontThrowSteps, initialGuess));
+        BootstrapSeeds::Seed seed;
 
         // As for yield curves we need to copy the piecewise curve because on eval date changes the relative date
         // helpers with trigger a bootstrap.
@@ -501,6 +510,7 @@ void DefaultCurve::buildCdsCurve(const std::string& curveID, const DefaultCurveC
             if (helpers[i]->latestDate() > asof) {
                 Date pillarDate = helpers[i]->pillarDate();
                 Probability sp = tmp->survivalProbability(pillarDate);
+                seed[pillarDate] = sp;
 
                 // In some cases the bootstrapped survival probability at one tenor will be `close` to that at a
                 // previous tenor. Here we don't add that survival probability and date to avoid issues when creating
@@ -522,6 +532,8 @@ void DefaultCurve::buildCdsCurve(const std::string& curveID, const DefaultCurveC
             dates.push_back(dates.back() + 1);
             survivalProbs.push_back(survivalProbs.back());
         }
+        if (warmStart)
+            BootstrapSeeds::instance().set(spec.name(), seed);
         qlCurve = QuantLib::ext::make_shared<QuantExt::InterpolatedSurvivalProbabilityCurve<LogLinear>>(
             dates, survivalProbs, config.dayCounter(), Calendar(), std::vector<Handle<Quote>>(), std::vector<Date>(),
             LogLinear(), config.allowNegativeRates());
@@ -439,5 +439,69 @@ void DependencyGraph::buildDependencyGraph(const std::string& configuration,
 
 } // TodaysMarket::buildDependencyGraph
 
+QuantLib::ext::shared_ptr<TodaysMarketParameters> DependencyGraph::restrictedParameters(
+    const std::map<std::string, std::map<MarketObject, std::set<std::string>>>& objects,
+    std::map<std::string, std::string>& buildErrors) {
+
+    // market object => configuration id => (name => spec) to keep
+
+    std::map<MarketObject, std::map<std::string, std::map<std::string, std::string>>> keep;
+
+    // add the object (o, name) in the given configuration and its dependencies, returns false if not found
+
+    auto add = [this, &keep, &buildErrors](const std::string& configuration, const MarketObject o,
+                                           const std::string& name) {
+        if (!params_->hasConfiguration(configuration))
+            return false;
+        if (dependencies_.find(configuration) == dependencies_.end())
+            buildDependencyGraph(configuration, buildErrors);
+        Graph& g = dependencies_[configuration];
+        IndexMap index = QuantLib::ext::get(boost::vertex_index, g);
+        VertexIterator v, vend;
+        for (std::tie(v, vend) = boost::vertices(g); v != vend; ++v) {
+            if (g[*v].obj != o || g[*v].name != name)
+                continue;
+            std::vector<Vertex> closure;
+            bool foundCycle = false;
+            DfsVisitor<Vertex> dfs(closure, foundCycle);
+            auto colorMap = boost::make_vector_property_map<boost::default_color_type>(index);
+            boost::depth_first_visit(g, *v, dfs, colorMap);
+            for (auto const& w : closure)
+                keep[g[w].obj][params_->marketObjectId(g[w].obj, configuration)][g[w].name] = g[w].mapping;
+            return true;
+        }
+        return false;
+    };
+
+    for (auto const& [configuration, objs] : objects) {
+        for (auto const& [o, names] : objs) {
+            for (auto const& name : names) {
+                if (!add(configuration, o, name) && (configuration == Market::defaultConfiguration ||
+                                                     !add(Market::defaultConfiguration, o, name))) {
+                    WLOG("DependencyGraph::restrictedParameters(): market object " << o << " (" << name
+                                                                                    << ") not found in configuration '"
+                                                                                    << configuration << "' or default");
+                }
+            }
+        }
+    }
+
+    auto result = QuantLib::ext::make_shared<TodaysMarketParameters>();
+    for (auto const& c : params_->configurations())
+        result->addConfiguration(c.first, c.second);
+    Size count = 0;
+    for (auto const& [o, ids] : keep) {
+        for (auto const& [id, assignments] : ids) {
+            result->addMarketObject(o, id, assignments);
+            count += assignments.size();
+        }
+    }
+
+    DLOG("DependencyGraph::restrictedParameters(): restricted todays market parameters to " << count
+                                                                                            << " assignments");
+
+    return result;
+}
+
 } // namespace data
 } // namespace ore
@@ -111,6 +111,14 @@ public:
 
     std::map<std::string, Graph> dependencies() { return dependencies_; }
 
+    /*! Returns a copy of the todays market parameters restricted to the given market objects by configuration and
+        the objects they depend on, i.e. their transitive closure in the dependency graph. Objects that are not found
+        in a configuration are looked up in the default configuration. The dependency graphs are built for the
+        given configurations if not done yet. */
+    QuantLib::ext::shared_ptr<TodaysMarketParameters>
+    restrictedParameters(const std::map<std::string, std::map<MarketObject, std::set<std::string>>>& objects,
+                         std::map<std::string, std::string>& buildErrors);
+
 private:
     friend std::ostream& operator<<(std::ostream& o, const Node& n);
 
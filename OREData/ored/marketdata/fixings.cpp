@@ -22,10 +22,12 @@
 */
 
 #include <boost/timer/timer.hpp>
+#include <algorithm>
 #include <ored/marketdata/fixings.hpp>
 #include <ored/utilities/indexparser.hpp>
 #include <ored/utilities/log.hpp>
 #include <ql/index.hpp>
+#include <ql/indexes/indexmanager.hpp>
 #include <qle/indexes/equityindex.hpp>
 #include <qle/utilities/savedobservablesettings.hpp>
 
@@ -43,31 +45,70 @@ void applyFixings(const set<Fixing>& fixings) {
     QuantExt::SavedObservableSettings savedObservableSettings;
     ObservableSettings::instance().disableUpdates(true);
 
+    // the fixings are sorted by name, we add the fixings of each index in one go, so that the index manager history
+    // is read and written once per index instead of once per fixing
+
     Size count = 0;
     cpu_timer timer;
-    QuantLib::ext::shared_ptr<Index> index;
-    std::string lastIndexName;
-    for (auto& f : fixings) {
-        if(f.name.empty()) {
-            WLOG("Skipping fixing with empty name, value " << f.fixing << ", date " << f.date);
+    vector<Date> dates;
+    vector<Real> values;
+    for (auto f = fixings.begin(); f != fixings.end();) {
+        if (f->name.empty()) {
+            WLOG("Skipping fixing with empty name, value " << f->fixing << ", date " << f->date);
         }
+        auto fEnd = std::find_if(f, fixings.end(), [&f](const Fixing& g) { return g.name != f->name; });
+        QuantLib::ext::shared_ptr<Index> index;
         try {
-            if (lastIndexName != f.name) {
-                index = parseIndex(f.name);
-                lastIndexName = f.name;
-            }
-            index->addFixing(f.date, f.fixing, true);
-            TLOG("Added fixing for " << f.name << " (" << io::iso_date(f.date) << ") value:" << f.fixing);
-            ++count;
+            index = parseIndex(f->name);
         } catch (const std::exception& e) {
-            WLOG("Error during adding fixing for " << f.name << ": " << e.what());
+            for (auto g = f; g != fEnd; ++g)
+                WLOG("Error during adding fixing for " << g->name << ": " << e.what());
+            f = fEnd;
+            continue;
+        }
+        dates.clear();
+        values.clear();
+        for (auto g = f; g != fEnd; ++g) {
+            dates.push_back(g->date);
+            values.push_back(g->fixing);
+        }
+        try {
+            index->addFixings(dates.begin(), dates.end(), values.begin(), true);
+            count += dates.size();
+            TLOG("Added " << dates.size() << " fixings for " << f->name);
+        } catch (const std::exception&) {
+            // fall back to adding the fixings one by one to identify the invalid ones
+            for (auto g = f; g != fEnd; ++g) {
+                try {
+                    index->addFixing(g->date, g->fixing, true);
+                    ++count;
+                } catch (const std::exception& e) {
+                    WLOG("Error during adding fixing for " << g->name << ": " << e.what());
+                }
+            }
         }
+        f = fEnd;
     }
     timer.stop();
     LOG("Added " << count << " of " << fixings.size() << " fixings in " << timer.format(default_places, "%w")
                  << " seconds");
 }
 
+FixingHistories getFixingHistories() {
+    FixingHistories result;
+    for (auto const& name : IndexManager::instance().histories())
+        result[name] = IndexManager::instance().getHistory(name);
+    return result;
+}
+
+void applyFixingHistories(const FixingHistories& histories) {
+    QuantExt::SavedObservableSettings savedObservableSettings;
+    ObservableSettings::instance().disableUpdates(true);
+    for (auto const& [name, history] : histories)
+        IndexManager::instance().setHistory(name, history);
+    DLOG("Set " << histories.size() << " fixing histories in the index manager");
+}
+
 bool operator<(const Fixing& f1, const Fixing& f2) {
     if (f1.name != f2.name)
         return f1.name < f2.name;
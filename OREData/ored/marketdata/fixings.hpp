@@ -24,6 +24,7 @@
 #pragma once
 
 #include <ql/time/date.hpp>
+#include <ql/timeseries.hpp>
 
 #include <ored/configuration/conventions.hpp>
 #include <ored/marketdata/marketdatum.hpp>
@@ -32,6 +33,8 @@
 #include <boost/serialization/serialization.hpp>
 #include <ql/shared_ptr.hpp>
 
+#include <map>
+#include <set>
 #include <vector>
 
 namespace ore {
@@ -68,7 +71,18 @@ private:
 bool operator<(const Fixing& f1, const Fixing& f2);
 
 //! Utility to write a vector of fixings in the QuantLib index manager's fixing history
+/*! The fixings are added per index in one go, i.e. the index manager history of an index is updated once. */
 void applyFixings(const std::set<Fixing>& fixings);
 
+//! Fixing histories by index name as stored in the QuantLib index manager
+using FixingHistories = std::map<std::string, QuantLib::TimeSeries<QuantLib::Real>>;
+
+//! Utility to get a copy of all fixing histories in the QuantLib index manager
+/*! This can be used to apply the fixings once and share the result with other threads, see applyFixingHistories() */
+FixingHistories getFixingHistories();
+
+//! Utility to set fixing histories in the QuantLib index manager, existing histories of the same names are replaced
+void applyFixingHistories(const FixingHistories& histories);
+
 } // namespace data
 } // namespace ore
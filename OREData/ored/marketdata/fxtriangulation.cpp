@@ -32,6 +32,8 @@
 
 #include <boost/make_shared.hpp>
 
+#include <algorithm>
+
 using namespace QuantLib;
 using namespace QuantExt;
 
@@ -109,6 +111,30 @@ FXTriangulation::FXTriangulation(std::map<std::string, Handle<Quote>> quotes) :
         neighbours_[n2].insert(n1);
     }
 
+    /* precompute the shortest path trees from each currency by a breadth first search. Each level is processed in
+       the node order, so that ties between several shortest paths are resolved by the preferred currencies above. */
+
+    predecessors_.resize(nodeToCcy_.size(), std::vector<Size>(nodeToCcy_.size(), Null<Size>()));
+    for (Size source = 0; source < nodeToCcy_.size(); ++source) {
+        std::vector<bool> reached(nodeToCcy_.size(), false);
+        reached[source] = true;
+        std::vector<Size> level(1, source);
+        while (!level.empty()) {
+            std::vector<Size> next;
+            for (auto const u : level) {
+                for (auto const n : neighbours_[u]) {
+                    if (!reached[n]) {
+                        reached[n] = true;
+                        predecessors_[source][n] = u;
+                        next.push_back(n);
+                    }
+                }
+            }
+            std::sort(next.begin(), next.end());
+            level.swap(next);
+        }
+    }
+
     LOG("FXTriangulation: initialized with " << quotes_.size() << " quotes, " << ccys.size() << " currencies.");
 }
 
@@ -127,7 +153,7 @@ Handle<Quote> FXTriangulation::getQuote(const std::string& pair) const {
     // handle trivial case
 
     if (ccy1 == ccy2)
-        return Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(1.0));
+        return quoteCache_[pair] = Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(1.0));
 
     // get the path from ccy1 to ccy2
 
@@ -261,8 +287,6 @@ Handle<FxIndex> FXTriangulation::getIndex(const std::string& indexOrPair, const
 
 std::vector<std::string> FXTriangulation::getPath(const std::string& forCcy, const std::string& domCcy) const {
 
-    // see https://en.wikipedia.org/wiki/Dijkstra%27s_algorithm
-
     Size sourceNode, targetNode;
 
     if (auto it = ccyToNode_.find(forCcy); it != ccyToNode_.end()) {
@@ -281,55 +305,20 @@ std::vector<std::string> FXTriangulation::getPath(const std::string& forCcy, con
                 << "' is not available as one of the currencies in any of the quotes (" << getAllQuotes() << ")");
     }
 
-    // previous node on the current shortest path
-    std::vector<Size> prev(nodeToCcy_.size(), Null<Size>());
-    // distance per node
-    std::vector<Size> dist(nodeToCcy_.size(), std::numeric_limits<Size>::max());
-    // visited flag
-    std::vector<bool> visited(nodeToCcy_.size(), false);
-
-    // init source
-    dist[sourceNode] = 0;
-
-    // main loop
-    Size noVisited = 0;
-    while (noVisited < nodeToCcy_.size()) {
-        Size u = Null<Size>(), min = std::numeric_limits<Size>::max();
-        for (Size i = 0; i < dist.size(); ++i) {
-            if (!visited[i] && dist[i] < min) {
-                u = i;
-                min = dist[i];
-            }
-        }
-        QL_REQUIRE(u != Null<Size>(), "FXTriangulation: internal error, no minimum found in dist array for '"
-                                          << forCcy << "' to '" << domCcy << "'. Quotes = " << getAllQuotes());
-        if (u == targetNode)
-            break;
-        visited[u] = true;
-        ++noVisited;
-        for (auto const& n : neighbours_[u]) {
-            if (visited[n])
-                continue;
-            Size alt = dist[u] + 1;
-            if (alt < dist[n]) {
-                dist[n] = alt;
-                prev[n] = u;
-            }
-        }
-    }
+    // read the path from the precomputed shortest path tree
 
-    // did we find a path?
-    if (dist[targetNode] < std::numeric_limits<Size>::max()) {
+    if (sourceNode == targetNode || predecessors_[sourceNode][targetNode] != Null<Size>()) {
         std::vector<std::string> result;
         Size u = targetNode;
         while (u != sourceNode) {
-            result.insert(result.begin(), nodeToCcy_[u]);
-            u = prev[u];
+            result.push_back(nodeToCcy_[u]);
+            u = predecessors_[sourceNode][u];
             QL_REQUIRE(u != Null<Size>(), "FXTriangulation: internal error u == null for '"
                                               << forCcy << "' to '" << domCcy
                                               << "'. Contact dev. Quotes = " << getAllQuotes() << ".");
         }
-        result.insert(result.begin(), nodeToCcy_[sourceNode]);
+        result.push_back(nodeToCcy_[sourceNode]);
+        std::reverse(result.begin(), result.end());
         TLOG("FXTriangulation: found path of length "
              << result.size() - 1 << " from '" << forCcy << "' to '" << domCcy << "': "
              << std::accumulate(
@@ -31,6 +31,7 @@
 #include <ql/quote.hpp>
 #include <ql/types.hpp>
 
+#include <unordered_map>
 #include <vector>
 
 namespace ore {
@@ -58,6 +59,9 @@ public:
     QuantLib::Handle<QuantExt::FxIndex> getIndex(const std::string& indexOrPair, const Market* market,
                                                  const std::string& configuration) const;
 
+    /*! The input quotes ccypair => quote */
+    const std::map<std::string, QuantLib::Handle<QuantLib::Quote>>& quotes() const { return quotes_; }
+
 private:
     /* get path for conversion forCcy => domCcy, throws if such a path does not exist     */
     std::vector<std::string> getPath(const std::string& forCcy, const std::string& domCcy) const;
@@ -73,13 +77,17 @@ private:
     std::map<std::string, QuantLib::Handle<QuantLib::Quote>> quotes_;
 
     // caches to improve perfomance
-    mutable std::map<std::string, QuantLib::Handle<QuantLib::Quote>> quoteCache_;
+    mutable std::unordered_map<std::string, QuantLib::Handle<QuantLib::Quote>> quoteCache_;
     mutable std::map<std::pair<std::string, std::string>, QuantLib::Handle<QuantExt::FxIndex>> indexCache_;
 
     // internal data structure to represent the undirected graph of currencies
     std::vector<std::string> nodeToCcy_;
     std::map<std::string, std::size_t> ccyToNode_;
     std::vector<std::set<std::size_t>> neighbours_;
+
+    /* shortest path trees precomputed on construction: predecessors_[source][node] is the previous node on the
+       shortest path from source to node, or null if there is no such path */
+    std::vector<std::vector<std::size_t>> predecessors_;
 };
 
 } // namespace data
@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/marketdata/lazyclonedloader.hpp>
+
+namespace ore {
+namespace data {
+
+LazyClonedLoader::LazyClonedLoader(const QuantLib::Date& loaderDate, const QuantLib::ext::shared_ptr<Loader>& inLoader)
+    : loaderDate_(loaderDate), inLoader_(inLoader) {
+    QL_REQUIRE(inLoader_, "LazyClonedLoader: no source loader given");
+    actualDate_ = inLoader_->actualDate();
+}
+
+QuantLib::ext::shared_ptr<MarketDatum> LazyClonedLoader::clone(const QuantLib::ext::shared_ptr<MarketDatum>& md) const {
+    if (md == nullptr)
+        return md;
+    auto c = clones_.find(md.get());
+    if (c != clones_.end())
+        return c->second;
+    auto r = md->clone();
+    clones_[md.get()] = r;
+    return r;
+}
+
+std::vector<QuantLib::ext::shared_ptr<MarketDatum>> LazyClonedLoader::loadQuotes(const QuantLib::Date& d) const {
+    std::vector<QuantLib::ext::shared_ptr<MarketDatum>> result;
+    for (auto const& md : inLoader_->loadQuotes(d))
+        result.push_back(clone(md));
+    return result;
+}
+
+QuantLib::ext::shared_ptr<MarketDatum> LazyClonedLoader::get(const std::string& name, const QuantLib::Date& d) const {
+    return clone(inLoader_->get(name, d));
+}
+
+std::set<QuantLib::ext::shared_ptr<MarketDatum>> LazyClonedLoader::get(const std::set<std::string>& names,
+                                                                       const QuantLib::Date& asof) const {
+    std::set<QuantLib::ext::shared_ptr<MarketDatum>> result;
+    for (auto const& md : inLoader_->get(names, asof))
+        result.insert(clone(md));
+    return result;
+}
+
+std::set<QuantLib::ext::shared_ptr<MarketDatum>> LazyClonedLoader::get(const Wildcard& wildcard,
+                                                                       const QuantLib::Date& asof) const {
+    std::set<QuantLib::ext::shared_ptr<MarketDatum>> result;
+    for (auto const& md : inLoader_->get(wildcard, asof))
+        result.insert(clone(md));
+    return result;
+}
+
+bool LazyClonedLoader::has(const std::string& name, const QuantLib::Date& d) const { return inLoader_->has(name, d); }
+
+bool LazyClonedLoader::hasQuotes(const QuantLib::Date& d) const { return inLoader_->hasQuotes(d); }
+
+bool LazyClonedLoader::hasFixing(const string& name, const QuantLib::Date& d) const {
+    return inLoader_->hasFixing(name, d);
+}
+
+Fixing LazyClonedLoader::getFixing(const string& name, const QuantLib::Date& d) const {
+    return inLoader_->getFixing(name, d);
+}
+
+} // namespace data
+} // namespace ore
@@ -0,0 +1,76 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/marketdata/lazyclonedloader.hpp
+    \brief loader providing thread local clones of quotes stored in a shared loader
+    \ingroup marketdata
+*/
+
+#pragma once
+
+#include <ored/marketdata/loader.hpp>
+
+#include <map>
+
+namespace ore {
+namespace data {
+
+//! Loader that clones quotes from a shared loader on demand
+/*! In contrast to the ClonedLoader, which copies all quotes, fixings and dividends of the source loader on
+    construction, this loader only clones the quotes that are actually requested and forwards fixing and dividend
+    requests to the source loader. Cloned quotes are memoised, so that repeated requests for the same quote return
+    the same object.
+
+    This allows to share one set of parsed market data between several threads, each owning a LazyClonedLoader
+    instance. The source loader must not be modified while it is used by instances of this class. Instances of this
+    class itself are not thread safe and should be used by one thread only.
+
+    \ingroup marketdata
+*/
+class LazyClonedLoader : public Loader {
+public:
+    LazyClonedLoader(const QuantLib::Date& loaderDate, const QuantLib::ext::shared_ptr<Loader>& inLoader);
+
+    std::vector<QuantLib::ext::shared_ptr<MarketDatum>> loadQuotes(const QuantLib::Date& d) const override;
+    QuantLib::ext::shared_ptr<MarketDatum> get(const std::string& name, const QuantLib::Date& d) const override;
+    std::set<QuantLib::ext::shared_ptr<MarketDatum>> get(const std::set<std::string>& names,
+                                                         const QuantLib::Date& asof) const override;
+    std::set<QuantLib::ext::shared_ptr<MarketDatum>> get(const Wildcard& wildcard,
+                                                         const QuantLib::Date& asof) const override;
+    bool has(const std::string& name, const QuantLib::Date& d) const override;
+    bool hasQuotes(const QuantLib::Date& d) const override;
+    std::set<Fixing> loadFixings() const override { return inLoader_->loadFixings(); }
+    bool hasFixing(const string& name, const QuantLib::Date& d) const override;
+    Fixing getFixing(const string& name, const QuantLib::Date& d) const override;
+    std::set<QuantExt::Dividend> loadDividends() const override { return inLoader_->loadDividends(); }
+
+    const QuantLib::Date& getLoaderDate() const { return loaderDate_; };
+
+    //! number of quotes cloned so far
+    QuantLib::Size numberOfClonedQuotes() const { return clones_.size(); }
+
+private:
+    QuantLib::ext::shared_ptr<MarketDatum> clone(const QuantLib::ext::shared_ptr<MarketDatum>& md) const;
+
+    QuantLib::Date loaderDate_;
+    QuantLib::ext::shared_ptr<Loader> inLoader_;
+    mutable std::map<const MarketDatum*, QuantLib::ext::shared_ptr<MarketDatum>> clones_;
+};
+
+} // namespace data
+} // namespace ore
@@ -182,6 +182,9 @@ public:
     //! Send an explicit update() call to all term structures
     void refresh(const string& configuration = Market::defaultConfiguration) override;
 
+    //! The fx quote repository shared between all configurations
+    const QuantLib::ext::shared_ptr<FXTriangulation>& fxTriangulation() const { return fx_; }
+
 protected:
     /*! Require a market object, this can be used in derived classes to build objects lazily. If the
         method is not overwritten in a derived class, it is assumed that the class builds all market
@@ -0,0 +1,404 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/marketdata/marketsnapshot.hpp>
+#include <ored/marketdata/yieldcurve.hpp>
+#include <ored/utilities/indexparser.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/parsers.hpp>
+
+#include <qle/termstructures/creditcurve.hpp>
+#include <qle/termstructures/interpolatedsurvivalprobabilitycurve.hpp>
+
+#include <ql/math/comparison.hpp>
+#include <ql/math/interpolations/loginterpolation.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+
+namespace ore {
+namespace data {
+
+namespace {
+
+const char marketSnapshotMagic[8] = {'O', 'R', 'E', 'M', 'K', 'T', 'S', '\0'};
+const std::uint32_t marketSnapshotVersion = 1;
+
+enum class SnapshotCurveType : std::uint8_t { Yield = 0, Default = 1 };
+
+struct SnapshotCurve {
+    SnapshotCurveType type;
+    std::string dayCounter;
+    bool extrapolation;
+    std::vector<std::int64_t> dates;
+    std::vector<double> values;
+};
+
+struct SnapshotEntry {
+    MarketObject object;
+    std::string configuration, name, discountIndex;
+    std::int64_t curve = -1, rateCurve = -1;
+    double recovery = Null<Real>();
+};
+
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::ofstream& out) : out_(out) {}
+    template <class T> void write(const T& x) { out_.write(reinterpret_cast<const char*>(&x), sizeof(T)); }
+    void write(const std::string& s) {
+        write<std::uint64_t>(s.size());
+        out_.write(s.data(), s.size());
+    }
+    template <class T> void write(const std::vector<T>& v) {
+        write<std::uint64_t>(v.size());
+        out_.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+    }
+
+private:
+    std::ofstream& out_;
+};
+
+class SnapshotReader {
+public:
+    SnapshotReader(const std::vector<char>& buffer, const std::string& filename)
+        : buffer_(buffer), filename_(filename) {}
+    template <class T> T read() {
+        T x;
+        std::memcpy(&x, advance(sizeof(T)), sizeof(T));
+        return x;
+    }
+    std::string readString() {
+        std::size_t n = read<std::uint64_t>();
+        return std::string(advance(n), n);
+    }
+    template <class T> std::vector<T> readVector() {
+        std::size_t n = read<std::uint64_t>();
+        QL_REQUIRE(n <= (buffer_.size() - pos_) / sizeof(T), "SnapshotMarket: file '" << filename_ << "' is truncated");
+        std::vector<T> v(n);
+        std::memcpy(v.data(), advance(n * sizeof(T)), n * sizeof(T));
+        return v;
+    }
+    bool atEnd() const { return pos_ == buffer_.size(); }
+
+private:
+    const char* advance(const std::size_t n) {
+        QL_REQUIRE(n <= buffer_.size() - pos_, "SnapshotMarket: file '" << filename_ << "' is truncated");
+        const char* p = buffer_.data() + pos_;
+        pos_ += n;
+        return p;
+    }
+    const std::vector<char>& buffer_;
+    const std::string& filename_;
+    std::size_t pos_ = 0;
+};
+
+std::vector<Date> snapshotGrid(const Date& referenceDate, const Date& maxDate, const Period& dailyHorizon,
+                               const Period& maxHorizon) {
+    Date end = std::min(maxDate, referenceDate + maxHorizon);
+    Date dailyEnd = std::min(end, referenceDate + dailyHorizon);
+    std::vector<Date> grid;
+    for (Date d = referenceDate; d <= dailyEnd; ++d)
+        grid.push_back(d);
+    for (Size i = 1;; ++i) {
+        Date d = referenceDate + i * Months;
+        if (d > end)
+            break;
+        if (d > dailyEnd)
+            grid.push_back(d);
+    }
+    if (grid.back() < end)
+        grid.push_back(end);
+    // the interpolation requires at least two points
+    if (grid.size() == 1)
+        grid.push_back(referenceDate + 1);
+    return grid;
+}
+
+} // namespace
+
+void writeMarketSnapshot(const Market& market, const TodaysMarketParameters& params, const std::string& filename,
+                         const Period& dailyHorizon, const Period& maxHorizon) {
+
+    QL_REQUIRE(dailyHorizon <= maxHorizon, "writeMarketSnapshot(): daily horizon (" << dailyHorizon
+                                                                                    << ") must not exceed max horizon ("
+                                                                                    << maxHorizon << ")");
+
+    // collect the curves, term structures shared between market objects are written once
+
+    std::vector<SnapshotCurve> curves;
+    std::map<const TermStructure*, std::int64_t> curveIndex;
+
+    auto addCurve = [&curves, &curveIndex, &dailyHorizon, &maxHorizon](const TermStructure* ts,
+                                                                       const SnapshotCurveType type,
+                                                                       const std::function<Real(const Date&)>& value) {
+        if (auto c = curveIndex.find(ts); c != curveIndex.end())
+            return c->second;
+        SnapshotCurve curve{type, ts->dayCounter().name(), ts->allowsExtrapolation(), {}, {}};
+        for (auto const& d : snapshotGrid(ts->referenceDate(), ts->maxDate(), dailyHorizon, maxHorizon)) {
+            curve.dates.push_back(d.serialNumber());
+            curve.values.push_back(value(d));
+        }
+        // the restored curves require a value of exactly one on the reference date
+        QL_REQUIRE(close_enough(curve.values.front(), 1.0),
+                   "expected value 1 on reference date " << ts->referenceDate() << ", got " << curve.values.front());
+        curve.values.front() = 1.0;
+        curves.push_back(std::move(curve));
+        return curveIndex[ts] = curves.size() - 1;
+    };
+    auto addYieldCurve = [&addCurve](const Handle<YieldTermStructure>& h) {
+        QL_REQUIRE(!h.empty(), "empty yield curve");
+        return addCurve(h.currentLink().get(), SnapshotCurveType::Yield,
+                        [&h](const Date& d) { return h->discount(d, true); });
+    };
+    auto addDefaultCurve = [&addCurve](const Handle<DefaultProbabilityTermStructure>& h) {
+        QL_REQUIRE(!h.empty(), "empty default curve");
+        return addCurve(h.currentLink().get(), SnapshotCurveType::Default,
+                        [&h](const Date& d) { return h->survivalProbability(d, true); });
+    };
+
+    // collect the market objects per configuration
+
+    std::vector<SnapshotEntry> entries;
+    std::map<std::string, Real> fxSpots;
+    for (auto const& [configuration, _] : params.configurations()) {
+        for (auto const o : {MarketObject::DiscountCurve, MarketObject::YieldCurve, MarketObject::IndexCurve,
+                             MarketObject::DefaultCurve, MarketObject::SwapIndexCurve, MarketObject::FXSpot}) {
+            for (auto const& [name, mapping] : params.mapping(o, configuration)) {
+                try {
+                    SnapshotEntry entry{o, configuration, name};
+                    if (o == MarketObject::DiscountCurve) {
+                        entry.curve = addYieldCurve(market.discountCurve(name, configuration));
+                    } else if (o == MarketObject::YieldCurve) {
+                        entry.curve = addYieldCurve(market.yieldCurve(name, configuration));
+                    } else if (o == MarketObject::IndexCurve) {
+                        entry.curve = addYieldCurve(market.iborIndex(name, configuration)->forwardingTermStructure());
+                    } else if (o == MarketObject::DefaultCurve) {
+                        auto c = market.defaultCurve(name, configuration);
+                        entry.curve = addDefaultCurve(c->curve());
+                        if (!c->rateCurve().empty())
+                            entry.rateCurve = addYieldCurve(c->rateCurve());
+                        if (!c->recovery().empty())
+                            entry.recovery = c->recovery()->value();
+                    } else if (o == MarketObject::SwapIndexCurve) {
+                        market.swapIndex(name, configuration);
+                        entry.discountIndex = mapping;
+                    } else {
+                        fxSpots[name] = market.fxSpot(name, configuration)->value();
+                        continue;
+                    }
+                    entries.push_back(entry);
+                } catch (const std::exception& e) {
+                    WLOG("writeMarketSnapshot(): skipping " << o << " '" << name << "' in configuration '"
+                                                            << configuration << "': " << e.what());
+                }
+            }
+        }
+    }
+
+    // the input quotes of the fx triangulation take precedence over the mapped fx spots
+
+    if (auto m = dynamic_cast<const MarketImpl*>(&market); m && m->fxTriangulation()) {
+        for (auto const& [pair, quote] : m->fxTriangulation()->quotes()) {
+            if (!quote.empty() && quote->isValid())
+                fxSpots[pair] = quote->value();
+        }
+    }
+
+    // write the file
+
+    std::ofstream out(filename, std::ios::binary | std::ios::out | std::ios::trunc);
+    QL_REQUIRE(out.is_open(), "Error opening file " << filename << " for market snapshot");
+    SnapshotWriter writer(out);
+    out.write(marketSnapshotMagic, sizeof(marketSnapshotMagic));
+    writer.write(marketSnapshotVersion);
+    writer.write<std::int64_t>(market.asofDate().serialNumber());
+    writer.write<std::uint64_t>(curves.size());
+    for (auto const& c : curves) {
+        writer.write(static_cast<std::uint8_t>(c.type));
+        writer.write(c.dayCounter);
+        writer.write<std::uint8_t>(c.extrapolation ? 1 : 0);
+        writer.write(c.dates);
+        writer.write(c.values);
+    }
+    writer.write<std::uint64_t>(entries.size());
+    for (auto const& e : entries) {
+        writer.write(static_cast<std::uint8_t>(e.object));
+        writer.write(e.configuration);
+        writer.write(e.name);
+        writer.write(e.discountIndex);
+        writer.write(e.curve);
+        writer.write(e.rateCurve);
+        writer.write(e.recovery);
+    }
+    writer.write<std::uint64_t>(fxSpots.size());
+    for (auto const& [pair, value] : fxSpots) {
+        writer.write(pair);
+        writer.write(value);
+    }
+    QL_REQUIRE(out.good(), "Error writing market snapshot to " << filename);
+    out.close();
+
+    LOG("Wrote market snapshot with " << curves.size() << " curves, " << entries.size() << " market objects and "
+                                      << fxSpots.size() << " fx spots to " << filename);
+}
+
+SnapshotMarket::SnapshotMarket(const std::string& filename, const bool handlePseudoCurrencies)
+    : MarketImpl(handlePseudoCurrencies) {
+
+    QL_REQUIRE(boost::filesystem::exists(filename), "SnapshotMarket: file '" << filename << "' not found");
+    std::vector<char> buffer(boost::filesystem::file_size(filename));
+    {
+        std::ifstream in(filename, std::ios::binary);
+        QL_REQUIRE(in.is_open(), "SnapshotMarket: error opening file '" << filename << "'");
+        in.read(buffer.data(), buffer.size());
+        QL_REQUIRE(in.good(), "SnapshotMarket: error reading file '" << filename << "'");
+    }
+
+    SnapshotReader reader(buffer, filename);
+    QL_REQUIRE(buffer.size() >= sizeof(marketSnapshotMagic) &&
+                   std::memcmp(buffer.data(), marketSnapshotMagic, sizeof(marketSnapshotMagic)) == 0,
+               "SnapshotMarket: file '" << filename << "' is not a market snapshot");
+    for (Size i = 0; i < sizeof(marketSnapshotMagic); ++i)
+        reader.read<char>();
+    auto version = reader.read<std::uint32_t>();
+    QL_REQUIRE(version == marketSnapshotVersion, "SnapshotMarket: file '" << filename << "' has version " << version
+                                                                          << ", expected " << marketSnapshotVersion);
+    asof_ = Date(static_cast<Date::serial_type>(reader.read<std::int64_t>()));
+
+    // the curves
+
+    std::vector<Handle<YieldTermStructure>> yieldCurves;
+    std::vector<Handle<DefaultProbabilityTermStructure>> defaultCurves;
+    auto nCurves = reader.read<std::uint64_t>();
+    for (Size i = 0; i < nCurves; ++i) {
+        auto type = static_cast<SnapshotCurveType>(reader.read<std::uint8_t>());
+        std::string dayCounterName = reader.readString();
+        bool extrapolation = reader.read<std::uint8_t>() != 0;
+        std::vector<Date> dates;
+        for (auto const& d : reader.readVector<std::int64_t>())
+            dates.push_back(Date(static_cast<Date::serial_type>(d)));
+        auto values = reader.readVector<double>();
+        QL_REQUIRE(dates.size() == values.size() && dates.size() >= 2,
+                   "SnapshotMarket: invalid curve #" << i << " in file '" << filename << "'");
+        DayCounter dayCounter;
+        try {
+            dayCounter = parseDayCounter(dayCounterName);
+        } catch (const std::exception& e) {
+            WLOG("SnapshotMarket: could not parse day counter '" << dayCounterName << "' of curve #" << i
+                                                                 << ", using A365F: " << e.what());
+            dayCounter = Actual365Fixed();
+        }
+        QuantLib::ext::shared_ptr<TermStructure> ts;
+        if (type == SnapshotCurveType::Yield) {
+            auto yts = discountcurve(dates, values, dayCounter, YieldCurve::InterpolationMethod::LogLinear);
+            yieldCurves.push_back(Handle<YieldTermStructure>(yts));
+            defaultCurves.push_back(Handle<DefaultProbabilityTermStructure>());
+            ts = yts;
+        } else {
+            QL_REQUIRE(type == SnapshotCurveType::Default,
+                       "SnapshotMarket: unknown curve type of curve #" << i << " in file '" << filename << "'");
+            auto dts = QuantLib::ext::make_shared<QuantExt::InterpolatedSurvivalProbabilityCurve<LogLinear>>(
+                dates, values, dayCounter);
+            yieldCurves.push_back(Handle<YieldTermStructure>());
+            defaultCurves.push_back(Handle<DefaultProbabilityTermStructure>(dts));
+            ts = dts;
+        }
+        if (extrapolation)
+            ts->enableExtrapolation();
+    }
+
+    auto curve = [&yieldCurves, &filename](const std::int64_t i) {
+        QL_REQUIRE(i >= 0 && static_cast<Size>(i) < yieldCurves.size() && !yieldCurves[i].empty(),
+                   "SnapshotMarket: invalid yield curve reference " << i << " in file '" << filename << "'");
+        return yieldCurves[i];
+    };
+
+    // the market objects, swap indices are added last since they refer to ibor indices
+
+    std::vector<SnapshotEntry> swapIndices;
+    auto nEntries = reader.read<std::uint64_t>();
+    for (Size i = 0; i < nEntries; ++i) {
+        SnapshotEntry e;
+        e.object = static_cast<MarketObject>(reader.read<std::uint8_t>());
+        e.configuration = reader.readString();
+        e.name = reader.readString();
+        e.discountIndex = reader.readString();
+        e.curve = reader.read<std::int64_t>();
+        e.rateCurve = reader.read<std::int64_t>();
+        e.recovery = reader.read<double>();
+        if (e.object == MarketObject::DiscountCurve) {
+            yieldCurves_[std::make_tuple(e.configuration, YieldCurveType::Discount, e.name)] = curve(e.curve);
+        } else if (e.object == MarketObject::YieldCurve) {
+            yieldCurves_[std::make_tuple(e.configuration, YieldCurveType::Yield, e.name)] = curve(e.curve);
+        } else if (e.object == MarketObject::IndexCurve) {
+            iborIndices_[std::make_pair(e.configuration, e.name)] =
+                Handle<IborIndex>(parseIborIndex(e.name, curve(e.curve)));
+        } else if (e.object == MarketObject::DefaultCurve) {
+            QL_REQUIRE(e.curve >= 0 && static_cast<Size>(e.curve) < defaultCurves.size() &&
+                           !defaultCurves[e.curve].empty(),
+                       "SnapshotMarket: invalid default curve reference " << e.curve << " in file '" << filename
+                                                                          << "'");
+            Handle<Quote> recovery;
+            if (e.recovery != Null<Real>()) {
+                recovery = Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(e.recovery));
+                recoveryRates_[std::make_pair(e.configuration, e.name)] = recovery;
+            }
+            defaultCurves_[std::make_pair(e.configuration, e.name)] =
+                Handle<QuantExt::CreditCurve>(QuantLib::ext::make_shared<QuantExt::CreditCurve>(
+                    defaultCurves[e.curve],
+                    e.rateCurve >= 0 ? curve(e.rateCurve) : Handle<YieldTermStructure>(), recovery));
+        } else if (e.object == MarketObject::SwapIndexCurve) {
+            swapIndices.push_back(e);
+        } else {
+            QL_FAIL("SnapshotMarket: unexpected market object " << e.object << " in file '" << filename << "'");
+        }
+    }
+
+    for (auto const& e : swapIndices) {
+        try {
+            addSwapIndex(e.name, e.discountIndex, e.configuration);
+        } catch (const std::exception& ex) {
+            WLOG("SnapshotMarket: skipping swap index '" << e.name << "' in configuration '" << e.configuration
+                                                         << "': " << ex.what());
+        }
+    }
+
+    // the fx spots
+
+    std::map<std::string, Handle<Quote>> fxQuotes;
+    auto nFxSpots = reader.read<std::uint64_t>();
+    for (Size i = 0; i < nFxSpots; ++i) {
+        std::string pair = reader.readString();
+        fxQuotes[pair] = Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(reader.read<double>()));
+    }
+    fx_ = QuantLib::ext::make_shared<FXTriangulation>(fxQuotes);
+
+    QL_REQUIRE(reader.atEnd(), "SnapshotMarket: unexpected trailing data in file '" << filename << "'");
+
+    LOG("SnapshotMarket: restored " << nCurves << " curves, " << nEntries << " market objects and " << nFxSpots
+                                    << " fx spots as of " << asof_ << " from " << filename);
+}
+
+} // namespace data
+} // namespace ore
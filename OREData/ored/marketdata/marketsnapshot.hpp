@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/marketdata/marketsnapshot.hpp
+    \brief binary snapshot of the curves of a built market and a market restored from it
+    \ingroup marketdata
+*/
+
+#pragma once
+
+#include <ored/marketdata/marketimpl.hpp>
+#include <ored/marketdata/todaysmarketparameters.hpp>
+
+#include <ql/time/period.hpp>
+
+namespace ore {
+namespace data {
+
+/*! Write the curves of a built market to a binary snapshot file, which can be restored by a SnapshotMarket, e.g. in
+    worker processes or downstream jobs on the same as of date, to avoid the curve bootstrap in the TodaysMarket.
+
+    The snapshot contains, for all configurations of the given parameters
+    - the discount, yield and index curves, as discount factors
+    - the default curves, as survival probabilities, with their recovery rates and rate curves
+    - the swap indices with their discounting index names
+    - the fx spot quotes, i.e. the input quotes of the market's fx triangulation if the market is a MarketImpl and the
+      fx spots mapped in the parameters otherwise
+
+    The curves are sampled daily from their reference date up to \p dailyHorizon and monthly from there up to their
+    max date, which is capped at \p maxHorizon. The snapshot reproduces the curves on each date of the daily grid
+    exactly, beyond the daily horizon the values are log-linearly interpolated between the monthly samples. Term
+    structures shared between market objects are written once and are shared in the restored market, too.
+
+    Volatility structures, inflation, equity and commodity curves, correlations and calibrated models are not part
+    of the snapshot. Market objects that can not be retrieved from the market are skipped with a warning. The
+    values are written in native byte order, i.e. the files are not portable between platforms with different
+    endianness.
+*/
+void writeMarketSnapshot(const Market& market, const TodaysMarketParameters& params, const std::string& filename,
+                         const QuantLib::Period& dailyHorizon = 30 * QuantLib::Years,
+                         const QuantLib::Period& maxHorizon = 100 * QuantLib::Years);
+
+//! Market restored from a binary snapshot file written by writeMarketSnapshot()
+/*! The curves are log-linear interpolated discount curves and survival probability curves on the snapshot grid,
+    with the day counter and the extrapolation setting of the original curves. Ibor and swap indices are rebuilt
+    from their names on the restored curves, the latter require the swap index conventions to be set in the
+    InstrumentConventions. Ibor fallback indices are restored as the original ibor indices.
+
+    \ingroup marketdata
+*/
+class SnapshotMarket : public MarketImpl {
+public:
+    explicit SnapshotMarket(const std::string& filename, const bool handlePseudoCurrencies = true);
+};
+
+} // namespace data
+} // namespace ore
@@ -0,0 +1,128 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/marketdata/overlayloader.hpp
+    \brief Loader that overrides single quotes of an underlying loader
+    \ingroup marketdata
+*/
+
+#pragma once
+
+#include <ored/marketdata/loader.hpp>
+#include <ql/shared_ptr.hpp>
+
+#include <map>
+
+namespace ore {
+namespace data {
+
+/*! Loader returning the quotes added to it instead of the quotes with the same name and date of an underlying loader,
+    e.g. to rebuild a market on intraday quote changes without copying the underlying market data. Quotes that are not
+    in the underlying loader are added. Fixings and dividends are taken from the underlying loader.
+    \ingroup marketdata
+*/
+class OverlayLoader : public Loader {
+public:
+    explicit OverlayLoader(const QuantLib::ext::shared_ptr<Loader>& loader) : loader_(loader) {
+        QL_REQUIRE(loader_, "OverlayLoader(): underlying loader must not be null");
+    }
+
+    //! add a quote, replacing an earlier quote with the same name and date
+    void add(const QuantLib::ext::shared_ptr<MarketDatum>& md) { data_[md->asofDate()][md->name()] = md; }
+
+    std::vector<QuantLib::ext::shared_ptr<MarketDatum>> loadQuotes(const QuantLib::Date& d) const override {
+        auto o = data_.find(d);
+        if (o == data_.end())
+            return loader_->loadQuotes(d);
+        std::vector<QuantLib::ext::shared_ptr<MarketDatum>> result;
+        if (loader_->hasQuotes(d)) {
+            for (auto const& md : loader_->loadQuotes(d))
+                if (o->second.find(md->name()) == o->second.end())
+                    result.push_back(md);
+        }
+        for (auto const& md : o->second)
+            result.push_back(md.second);
+        return result;
+    }
+
+    QuantLib::ext::shared_ptr<MarketDatum> get(const std::string& name, const QuantLib::Date& d) const override {
+        if (auto md = overlay(name, d))
+            return md;
+        return loader_->get(name, d);
+    }
+
+    std::set<QuantLib::ext::shared_ptr<MarketDatum>> get(const std::set<std::string>& names,
+                                                         const QuantLib::Date& asof) const override {
+        auto o = data_.find(asof);
+        if (o == data_.end())
+            return loader_->get(names, asof);
+        std::set<QuantLib::ext::shared_ptr<MarketDatum>> result;
+        for (auto const& md : loader_->get(names, asof))
+            if (o->second.find(md->name()) == o->second.end())
+                result.insert(md);
+        for (auto const& n : names)
+            if (auto md = o->second.find(n); md != o->second.end())
+                result.insert(md->second);
+        return result;
+    }
+
+    std::set<QuantLib::ext::shared_ptr<MarketDatum>> get(const Wildcard& wildcard,
+                                                         const QuantLib::Date& asof) const override {
+        auto o = data_.find(asof);
+        if (o == data_.end())
+            return loader_->get(wildcard, asof);
+        std::set<QuantLib::ext::shared_ptr<MarketDatum>> result;
+        for (auto const& md : loader_->get(wildcard, asof))
+            if (o->second.find(md->name()) == o->second.end())
+                result.insert(md);
+        for (auto const& md : o->second)
+            if (wildcard.matches(md.first))
+                result.insert(md.second);
+        return result;
+    }
+
+    bool has(const std::string& name, const QuantLib::Date& d) const override {
+        return overlay(name, d) != nullptr || loader_->has(name, d);
+    }
+
+    bool hasQuotes(const QuantLib::Date& d) const override {
+        return data_.find(d) != data_.end() || loader_->hasQuotes(d);
+    }
+
+    std::set<Fixing> loadFixings() const override { return loader_->loadFixings(); }
+    bool hasFixing(const string& name, const QuantLib::Date& d) const override { return loader_->hasFixing(name, d); }
+    Fixing getFixing(const string& name, const QuantLib::Date& d) const override { return loader_->getFixing(name, d); }
+    std::set<QuantExt::Dividend> loadDividends() const override { return loader_->loadDividends(); }
+
+    //! the underlying loader
+    const QuantLib::ext::shared_ptr<Loader>& underlyingLoader() const { return loader_; }
+
+private:
+    QuantLib::ext::shared_ptr<MarketDatum> overlay(const std::string& name, const QuantLib::Date& d) const {
+        if (auto o = data_.find(d); o != data_.end())
+            if (auto md = o->second.find(name); md != o->second.end())
+                return md->second;
+        return nullptr;
+    }
+
+    const QuantLib::ext::shared_ptr<Loader> loader_;
+    std::map<QuantLib::Date, std::map<std::string, QuantLib::ext::shared_ptr<MarketDatum>>> data_;
+};
+
+} // namespace data
+} // namespace ore
@@ -34,6 +34,7 @@
 #include <ored/marketdata/fxvolcurve.hpp>
 #include <ored/marketdata/inflationcapfloorvolcurve.hpp>
 #include <ored/marketdata/inflationcurve.hpp>
+#include <ored/marketdata/overlayloader.hpp>
 #include <ored/marketdata/security.hpp>
 #include <ored/marketdata/structuredcurveerror.hpp>
 #include <ored/marketdata/swaptionvolcurve.hpp>
@@ -43,6 +44,7 @@
 #include <ored/utilities/indexparser.hpp>
 #include <ored/utilities/indexnametranslator.hpp>
 #include <ored/utilities/log.hpp>
+#include <ored/utilities/timers.hpp>
 #include <ored/utilities/to_string.hpp>
 #include <qle/indexes/dividendmanager.hpp>
 #include <qle/indexes/equityindex.hpp>
@@ -99,6 +101,7 @@ struct Count {
 
 void TodaysMarket::initialise(const Date& asof) {
 
+    ORE_TIMER("market build");
     std::map<std::string, boost::timer::nanosecond_type> timings;
     std::map<std::string, Count> counts;
     boost::timer::cpu_timer timer;
@@ -130,13 +133,7 @@ void TodaysMarket::initialise(const Date& asof) {
     // Add all FX quotes from the loader to Triangulation
     timer.start();
     if (loader_->hasQuotes(asof_)) {
-	std::map<std::string, Handle<Quote>> fxQuotes;
-        for (auto& md : loader_->get(Wildcard("FX/RATE/*"), asof_)) {
-            QuantLib::ext::shared_ptr<FXSpotQuote> q = QuantLib::ext::dynamic_pointer_cast<FXSpotQuote>(md);
-            QL_REQUIRE(q, "Failed to cast " << md->name() << " to FXSpotQuote");
-            fxQuotes[q->unitCcy() + q->ccy()] = q->quote();
-        }
-	fx_  = QuantLib::ext::make_shared<FXTriangulation>(fxQuotes);
+        buildFxTriangulation();
     } else {
         WLOG("TodaysMarket::Initialise: no quotes available for date " << asof_);
         return;
@@ -259,6 +256,16 @@ void TodaysMarket::initialise(const Date& asof) {
 
 } // TodaysMarket::initialise()
 
+void TodaysMarket::buildFxTriangulation() {
+    std::map<std::string, Handle<Quote>> fxQuotes;
+    for (auto& md : loader_->get(Wildcard("FX/RATE/*"), asof_)) {
+        QuantLib::ext::shared_ptr<FXSpotQuote> q = QuantLib::ext::dynamic_pointer_cast<FXSpotQuote>(md);
+        QL_REQUIRE(q, "Failed to cast " << md->name() << " to FXSpotQuote");
+        fxQuotes[q->unitCcy() + q->ccy()] = q->quote();
+    }
+    fx_ = QuantLib::ext::make_shared<FXTriangulation>(fxQuotes);
+}
+
 void TodaysMarket::buildNode(const std::string& configuration, Node& node) const {
 
     // if the node is already built, there is nothing to do
@@ -294,14 +301,22 @@ void TodaysMarket::buildNode(const std::string& configuration, Node& node) const
             QuantLib::ext::shared_ptr<Conventions> conventions = InstrumentConventions::instance().conventions();
 
             auto itr = requiredYieldCurves_.find(ycspec->name());
-            if (itr == requiredYieldCurves_.end()) {
+            auto outdated = outdatedYieldCurves_.find(ycspec->name());
+            if (itr == requiredYieldCurves_.end() || outdated != outdatedYieldCurves_.end()) {
                 DLOG("Building YieldCurve for asof " << asof_);
                 QuantLib::ext::shared_ptr<YieldCurve> yieldCurve = QuantLib::ext::make_shared<YieldCurve>(
                     asof_, *ycspec, *curveConfigs_, *loader_, requiredYieldCurves_, requiredDefaultCurves_, *fx_,
                     referenceData_, iborFallbackConfig_, preserveQuoteLinkage_, buildCalibrationInfo_, this);
                 calibrationInfo_->yieldCurveCalibrationInfo[ycspec->name()] = yieldCurve->calibrationInfo();
-                itr = requiredYieldCurves_.insert(make_pair(ycspec->name(), yieldCurve)).first;
-                DLOG("Added YieldCurve \"" << ycspec->name() << "\" to requiredYieldCurves map");
+                if (itr == requiredYieldCurves_.end()) {
+                    itr = requiredYieldCurves_.insert(make_pair(ycspec->name(), yieldCurve)).first;
+                    DLOG("Added YieldCurve \"" << ycspec->name() << "\" to requiredYieldCurves map");
+                } else {
+                    // rebuild on changed quotes, keep the existing curve so that its handle is relinked in place
+                    itr->second->relinkTo(*yieldCurve);
+                    outdatedYieldCurves_.erase(outdated);
+                    DLOG("Relinked YieldCurve \"" << ycspec->name() << "\" to rebuilt curve");
+                }
                 if (itr->second->currency().code() != ycspec->ccy()) {
                     WLOG("Warning: YieldCurve has ccy " << itr->second->currency() << " but spec has ccy "
                                                         << ycspec->ccy());
@@ -812,6 +827,241 @@ void TodaysMarket::buildNode(const std::string& configuration, Node& node) const
     node.built = true;
 } // TodaysMarket::buildNode()
 
+bool TodaysMarket::usesQuotes(const CurveSpec& spec, const std::set<std::string>& quotes, const bool fxChanged) const {
+    if (spec.baseType() == CurveSpec::CurveType::FX)
+        return fxChanged;
+    if (!curveConfigs_->has(spec.baseType(), spec.curveConfigID()))
+        return false;
+    for (auto const& q : curveConfigs_->get(spec.baseType(), spec.curveConfigID())->quotes()) {
+        if (quotes.find(q) != quotes.end())
+            return true;
+        if (Wildcard w(q); w.hasWildcard()) {
+            for (auto const& n : quotes)
+                if (w.matches(n))
+                    return true;
+        }
+    }
+    return false;
+}
+
+void TodaysMarket::invalidate(const CurveSpec& spec) const {
+    const std::string name = spec.name();
+    switch (spec.baseType()) {
+    case CurveSpec::CurveType::Yield:
+        // yield curves are rebuilt in place, see buildNode()
+        if (requiredYieldCurves_.find(name) != requiredYieldCurves_.end())
+            outdatedYieldCurves_.insert(name);
+        break;
+    case CurveSpec::CurveType::FX:
+        break;
+    case CurveSpec::CurveType::FXVolatility:
+        requiredFxVolCurves_.erase(name);
+        break;
+    case CurveSpec::CurveType::SwaptionVolatility:
+    case CurveSpec::CurveType::YieldVolatility:
+        requiredGenericYieldVolCurves_.erase(name);
+        break;
+    case CurveSpec::CurveType::CapFloorVolatility:
+        requiredCapFloorVolCurves_.erase(name);
+        break;
+    case CurveSpec::CurveType::Default:
+        requiredDefaultCurves_.erase(name);
+        break;
+    case CurveSpec::CurveType::CDSVolatility:
+        requiredCDSVolCurves_.erase(name);
+        break;
+    case CurveSpec::CurveType::BaseCorrelation:
+        requiredBaseCorrelationCurves_.erase(name);
+        break;
+    case CurveSpec::CurveType::Inflation:
+        requiredInflationCurves_.erase(name);
+        break;
+    case CurveSpec::CurveType::InflationCapFloorVolatility:
+        requiredInflationCapFloorVolCurves_.erase(name);
+        break;
+    case CurveSpec::CurveType::Equity:
+        requiredEquityCurves_.erase(name);
+        break;
+    case CurveSpec::CurveType::EquityVolatility:
+        requiredEquityVolCurves_.erase(name);
+        break;
+    case CurveSpec::CurveType::Security: {
+        auto securityspec = dynamic_cast<const SecuritySpec*>(&spec);
+        QL_REQUIRE(securityspec, "Failed to convert spec " << spec << " to security spec");
+        requiredSecurities_.erase(securityspec->securityID());
+        break;
+    }
+    case CurveSpec::CurveType::Commodity:
+        requiredCommodityCurves_.erase(name);
+        break;
+    case CurveSpec::CurveType::CommodityVolatility:
+        requiredCommodityVolCurves_.erase(name);
+        break;
+    case CurveSpec::CurveType::Correlation:
+        requiredCorrelationCurves_.erase(name);
+        break;
+    default:
+        QL_FAIL("Unhandled spec " << spec);
+    }
+}
+
+Size TodaysMarket::update(const std::vector<QuantLib::ext::shared_ptr<MarketDatum>>& quotes) {
+
+    updatedObjects_.clear();
+    if (quotes.empty())
+        return 0;
+
+    boost::timer::cpu_timer timer;
+
+    // overlay the changed quotes on the loader
+
+    if (!updatedQuotes_) {
+        updatedQuotes_ = QuantLib::ext::make_shared<OverlayLoader>(loader_);
+        loader_ = updatedQuotes_;
+    }
+
+    std::set<std::string> names;
+    bool fxChanged = false;
+    for (auto const& md : quotes) {
+        QL_REQUIRE(md, "TodaysMarket::update(): quote is null");
+        QL_REQUIRE(md->asofDate() == asof_, "TodaysMarket::update(): quote " << md->name() << " has date "
+                                                                             << io::iso_date(md->asofDate())
+                                                                             << ", expected " << io::iso_date(asof_));
+        updatedQuotes_->add(md);
+        names.insert(md->name());
+        fxChanged = fxChanged || md->instrumentType() == MarketDatum::InstrumentType::FX_SPOT;
+    }
+
+    // curves that are not rebuilt might refer to the current fx triangulation, so we keep it alive
+
+    if (fxChanged) {
+        previousFx_.push_back(fx_);
+        buildFxTriangulation();
+        updatedObjects_.insert(MarketObject::FXSpot);
+    }
+
+    // sort the graphs topologically, i.e. dependencies come before the nodes depending on them
+
+    map<string, string> buildErrors;
+    std::map<std::string, std::vector<Vertex>> orders;
+    for (auto& [configuration, g] : dependencies_) {
+        auto& order = orders[configuration];
+        try {
+            boost::topological_sort(g, std::back_inserter(order));
+        } catch (const std::exception& e) {
+            order.clear();
+            buildErrors["CurveDependencyGraph"] = "Topological sort of dependency graph failed for configuration " +
+                                                  configuration + " (" + ore::data::to_string(e.what()) +
+                                                  "). Got cycle(s): " + getCycles(g);
+        }
+    }
+
+    // identify the affected nodes, i.e. the nodes using the changed quotes and the nodes depending on them; a spec
+    // can appear in several configurations, so we iterate until the set of affected specs does not change anymore
+
+    std::map<std::string, bool> specUsesQuotes;
+    std::set<std::string> affectedSpecs;
+    std::map<std::string, std::set<Vertex>> affected;
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (auto& [configuration, g] : dependencies_) {
+            auto& a = affected[configuration];
+            for (auto const& v : orders[configuration]) {
+                if (a.find(v) != a.end())
+                    continue;
+                bool isAffected = false;
+                if (g[v].curveSpec) {
+                    const std::string spec = g[v].curveSpec->name();
+                    auto u = specUsesQuotes.find(spec);
+                    if (u == specUsesQuotes.end())
+                        u = specUsesQuotes.insert(std::make_pair(spec, usesQuotes(*g[v].curveSpec, names, fxChanged)))
+                                .first;
+                    isAffected = u->second || affectedSpecs.find(spec) != affectedSpecs.end();
+                }
+                boost::graph_traits<Graph>::out_edge_iterator e, eend;
+                for (std::tie(e, eend) = boost::out_edges(v, g); e != eend && !isAffected; ++e)
+                    isAffected = a.find(boost::target(*e, g)) != a.end();
+                if (isAffected) {
+                    a.insert(v);
+                    if (g[v].curveSpec && affectedSpecs.insert(g[v].curveSpec->name()).second)
+                        changed = true;
+                }
+            }
+        }
+    }
+
+    // invalidate the cached objects and reset the affected nodes that were built, the others are built on request
+
+    std::set<std::string> invalidated;
+    std::map<std::string, std::vector<Vertex>> rebuild;
+    for (auto& [configuration, g] : dependencies_) {
+        for (auto const& v : orders[configuration]) {
+            if (affected[configuration].find(v) == affected[configuration].end())
+                continue;
+            if (g[v].curveSpec && invalidated.insert(g[v].curveSpec->name()).second)
+                invalidate(*g[v].curveSpec);
+            if (g[v].built) {
+                g[v].built = false;
+                rebuild[configuration].push_back(v);
+            }
+        }
+    }
+
+    // rebuild the discount curves first, as in initialise(), then the remaining nodes in topological order
+
+    for (auto& [configuration, nodes] : rebuild) {
+        Graph& g = dependencies_[configuration];
+        for (auto const& v : nodes) {
+            if (g[v].obj == MarketObject::DiscountCurve && !g[v].built)
+                require(MarketObject::DiscountCurve, g[v].name, configuration, true);
+        }
+    }
+
+    Size countSuccess = 0, countError = 0;
+    for (auto& [configuration, nodes] : rebuild) {
+        Graph& g = dependencies_[configuration];
+        for (auto const& v : nodes) {
+            updatedObjects_.insert(g[v].obj);
+            if (g[v].built) {
+                ++countSuccess;
+                continue;
+            }
+            try {
+                buildNode(configuration, g[v]);
+                ++countSuccess;
+                DLOG("rebuilt node " << g[v] << " in configuration " << configuration);
+            } catch (const std::exception& e) {
+                if (g[v].curveSpec)
+                    buildErrors[g[v].curveSpec->name()] = e.what();
+                else
+                    buildErrors[g[v].name] = e.what();
+                ++countError;
+                ALOG("error while rebuilding node " << g[v] << " in configuration " << configuration << ": "
+                                                    << e.what());
+            }
+        }
+    }
+
+    LOG("TodaysMarket::update(): " << quotes.size() << " changed quotes, rebuilt " << countSuccess
+                                   << " market objects (" << countError << " errors) in "
+                                   << static_cast<double>(timer.elapsed().wall) / 1.0E6 << " ms");
+
+    if (!buildErrors.empty()) {
+        for (auto const& error : buildErrors) {
+            StructuredCurveErrorMessage(error.first, "Failed to Build Curve", error.second).log();
+        }
+        if (!continueOnError_) {
+            string errStr;
+            for (auto const& error : buildErrors) {
+                errStr += "(" + error.first + ": " + error.second + "); ";
+            }
+            QL_FAIL("Cannot rebuild all affected curves! Building failed for: " << errStr);
+        }
+    }
+
+    return countSuccess;
+} // TodaysMarket::update()
+
 void TodaysMarket::require(const MarketObject o, const string& name, const string& configuration,
                            const bool forceBuild) const {
 
@@ -879,6 +1129,8 @@ void TodaysMarket::require(const MarketObject o, const string& name, const strin
         return;
     }
 
+    requestedObjects_[configuration][o].insert(g[node].name);
+
     // if the node is already built, we are done
 
     if (g[node].built) {
@@ -61,6 +61,7 @@ class Security;
 class CommodityCurve;
 class CommodityVolCurve;
 class CorrelationCurve;
+class OverlayLoader;
 
 // TODO: rename class
 //! Today's Market
@@ -107,6 +108,32 @@ public:
 
     QuantLib::ext::shared_ptr<TodaysMarketCalibrationInfo> calibrationInfo() const { return calibrationInfo_; }
 
+    /*! The market objects requested from the market by configuration, only populated if the market is built lazily.
+        Together with DependencyGraph::restrictedParameters() this allows to set up a market that builds only the
+        objects a portfolio actually needs, e.g. by building the portfolio against a lazily built market first. */
+    const std::map<std::string, std::map<MarketObject, std::set<std::string>>>& requestedObjects() const {
+        return requestedObjects_;
+    }
+
+    /*! Updates the market on changed quotes, e.g. intraday ticks. The given quotes replace the loader quotes with the
+        same name and date. The market objects using the quotes and the objects depending on them are rebuilt in
+        dependency order, all other objects are kept. Yield curve handles, and hence the forwarding curves of indices,
+        are relinked in place, i.e. handles retrieved from the market before the update follow the rebuilt curves.
+        Other rebuilt objects replace the previous objects in the market, handles retrieved before the update keep
+        pointing to the previous objects. If a market object is built lazily, it is only rebuilt if it was requested
+        before, otherwise it will use the changed quotes when requested.
+
+        The quotes used by a market object are taken from its curve configuration, i.e. changes in quotes which are
+        not listed there are not detected. A change in an FX spot quote triggers the rebuild of all objects depending
+        on FX spots.
+
+        Returns the number of rebuilt market objects. */
+    QuantLib::Size update(const std::vector<QuantLib::ext::shared_ptr<MarketDatum>>& quotes);
+
+    /*! The types of the market objects rebuilt by the last update(), e.g. to decide whether handles retrieved
+        before the update are still current. A changed FX spot quote is reported as MarketObject::FXSpot. */
+    const std::set<MarketObject>& updatedObjects() const { return updatedObjects_; }
+
 private:
     // MarketImpl interface
     void require(const MarketObject o, const string& name, const string& configuration,
@@ -115,7 +142,7 @@ private:
     // input parameters
 
     const QuantLib::ext::shared_ptr<TodaysMarketParameters> params_;
-    const QuantLib::ext::shared_ptr<Loader> loader_;
+    QuantLib::ext::shared_ptr<Loader> loader_;
     const QuantLib::ext::shared_ptr<const CurveConfigurations> curveConfigs_;
 
     const bool continueOnError_;
@@ -129,6 +156,9 @@ private:
     // initialise market
     void initialise(const Date& asof);
 
+    // build the fx triangulation from the loader's fx spot quotes
+    void buildFxTriangulation();
+
     // some typedefs for graph related data types
     using Node = DependencyGraph::Node;
     using Graph = boost::directed_graph<Node>;
@@ -138,10 +168,19 @@ private:
 
     // the dependency graphs for each configuration
     mutable std::map<std::string, Graph> dependencies_;
+    mutable std::map<std::string, std::map<MarketObject, std::set<std::string>>> requestedObjects_;
 
     // build a single market object
     void buildNode(const std::string& configuration, Node& node) const;
 
+    // support for update()
+    bool usesQuotes(const CurveSpec& spec, const std::set<std::string>& quotes, const bool fxChanged) const;
+    void invalidate(const CurveSpec& spec) const;
+    QuantLib::ext::shared_ptr<OverlayLoader> updatedQuotes_;
+    std::vector<QuantLib::ext::shared_ptr<FXTriangulation>> previousFx_;
+    mutable std::set<std::string> outdatedYieldCurves_;
+    std::set<MarketObject> updatedObjects_;
+
     // calibration results
     QuantLib::ext::shared_ptr<TodaysMarketCalibrationInfo> calibrationInfo_;
 
@@ -125,6 +125,10 @@ public:
     QuantLib::ext::shared_ptr<YieldCurveCalibrationInfo> calibrationInfo() const { return calibrationInfo_; }
     //@}
 
+    /*! Relink the handle of this curve to the term structure of \p curve, e.g. a rebuild of this curve on changed
+        quotes, and take over its calibration info. Handles obtained from this curve follow the new term structure. */
+    void relinkTo(const YieldCurve& curve);
+
 private:
     Date asofDate_;
     Currency currency_;
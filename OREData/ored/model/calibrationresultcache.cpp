@@ -0,0 +1,126 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/model/calibrationresultcache.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <ql/errors.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace ore {
+namespace data {
+
+using QuantLib::Real;
+using QuantLib::Size;
+
+CalibrationResultCache& CalibrationResultCache::instance() {
+    static CalibrationResultCache cache;
+    return cache;
+}
+
+std::string CalibrationResultCache::key(const std::string& inputs) {
+    // 64 bit FNV-1a, unlike std::hash this is the same on all platforms and in all processes
+    std::uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : inputs) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    std::ostringstream os;
+    os << std::hex << std::setw(16) << std::setfill('0') << h;
+    return os.str();
+}
+
+bool CalibrationResultCache::get(const std::string& key, Entry& entry) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto e = entries_.find(key);
+    if (e == entries_.end())
+        return false;
+    entry = e->second;
+    return true;
+}
+
+void CalibrationResultCache::put(const std::string& key, const Entry& entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[key] = entry;
+}
+
+Size CalibrationResultCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void CalibrationResultCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+void CalibrationResultCache::load(const std::string& filename) {
+    std::ifstream file(filename);
+    QL_REQUIRE(file.is_open(), "CalibrationResultCache: error opening file " << filename);
+    // one entry per line: key, error, number of parameters, parameters
+    Size n = 0, lineNo = 0;
+    std::string line;
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (std::getline(file, line)) {
+        ++lineNo;
+        if (line.empty())
+            continue;
+        std::istringstream is(line);
+        std::string key;
+        Entry entry;
+        Size size;
+        if (!(is >> key >> entry.error >> size)) {
+            WLOG("CalibrationResultCache: ignore invalid line " << lineNo << " in " << filename);
+            continue;
+        }
+        entry.params.resize(size);
+        bool valid = true;
+        for (Size i = 0; i < size && valid; ++i)
+            valid = static_cast<bool>(is >> entry.params[i]);
+        if (!valid) {
+            WLOG("CalibrationResultCache: ignore invalid line " << lineNo << " in " << filename);
+            continue;
+        }
+        entries_[key] = entry;
+        ++n;
+    }
+    LOG("CalibrationResultCache: " << n << " entries loaded from " << filename);
+}
+
+void CalibrationResultCache::save(const std::string& filename) const {
+    std::ofstream file(filename);
+    QL_REQUIRE(file.is_open(), "CalibrationResultCache: error opening file " << filename);
+    file << std::setprecision(std::numeric_limits<Real>::max_digits10);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto const& [key, entry] : entries_) {
+        file << key << ' ' << entry.error << ' ' << entry.params.size();
+        for (auto const& p : entry.params)
+            file << ' ' << p;
+        file << '\n';
+    }
+    file.close();
+    LOG("CalibrationResultCache: " << entries_.size() << " entries written to " << filename);
+}
+
+} // namespace data
+} // namespace ore
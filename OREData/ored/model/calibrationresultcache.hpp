@@ -0,0 +1,86 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/model/calibrationresultcache.hpp
+    \brief cache of calibrated model parameters shared by all threads and optionally persisted to a file
+    \ingroup models
+*/
+
+#pragma once
+
+#include <ql/types.hpp>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace data {
+
+//! Cache of calibrated model parameters, keyed by a hash of the calibration inputs
+/*! Model builders look up the parameters calibrated to identical inputs (market data, basket, model configuration)
+    before they run an optimisation, so that e.g. the workers of a multi-threaded valuation, which build their own
+    models, and subsequent runs on the same market (if the cache is saved to and loaded from a file) do not repeat
+    the calibration. Since the key is a hash, a builder should verify a cached result by recomputing the calibration
+    error and comparing it to the stored one before using it.
+
+    The cache is disabled by default. Like the TimerRegistry it is a process wide singleton and not a
+    QuantLib::Singleton, so that it is shared by all threads also in builds with QL_ENABLE_SESSIONS = ON.
+
+    \ingroup models
+*/
+class CalibrationResultCache {
+public:
+    struct Entry {
+        std::vector<QuantLib::Real> params;
+        QuantLib::Real error;
+    };
+
+    static CalibrationResultCache& instance();
+
+    void enable(const bool b) { enabled_.store(b, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    //! A key derived from a string representation of all inputs of a calibration, stable across processes
+    static std::string key(const std::string& inputs);
+
+    //! Look up the entry for the given key, returns false if there is none
+    bool get(const std::string& key, Entry& entry) const;
+    //! Add or replace the entry for the given key
+    void put(const std::string& key, const Entry& entry);
+
+    QuantLib::Size size() const;
+    void clear();
+
+    //! Add the entries from a file written by save(), entries with an existing key are replaced
+    void load(const std::string& filename);
+    //! Write all entries to a file
+    void save(const std::string& filename) const;
+
+private:
+    CalibrationResultCache() {}
+
+    std::atomic<bool> enabled_ = false;
+    mutable std::mutex mutex_;
+    std::map<std::string, Entry> entries_;
+};
+
+} // namespace data
+} // namespace ore
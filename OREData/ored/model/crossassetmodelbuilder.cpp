@@ -16,6 +16,7 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <ored/marketdata/fixings.hpp>
 #include <ored/model/commodityschwartzmodelbuilder.hpp>
 #include <ored/model/crcirbuilder.hpp>
 #include <ored/model/crlgmbuilder.hpp>
@@ -61,6 +62,10 @@
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <atomic>
+#include <exception>
+#include <thread>
+
 using QuantExt::AnalyticJyCpiCapFloorEngine;
 using QuantExt::AnalyticJyYoYCapFloorEngine;
 using QuantExt::CpiCapFloorHelper;
@@ -75,20 +80,78 @@ using std::vector;
 namespace ore {
 namespace data {
 
+namespace {
+// recalibrate the builders, concurrently if several threads are requested and supported
+void recalibrate(const std::vector<QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>& builders, const Size nThreads) {
+    Size nWorkers = std::min(nThreads, builders.size());
+#ifndef QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN
+    if (nWorkers > 1) {
+        WLOG("CrossAssetModelBuilder: parallel calibration with "
+             << nThreads
+             << " threads requires a QuantLib build with QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN = ON, calibrating "
+                "sequentially.");
+        nWorkers = 1;
+    }
+#endif
+    if (nWorkers <= 1) {
+        for (auto const& b : builders)
+            b->recalibrate();
+        return;
+    }
+    DLOG("CrossAssetModelBuilder: calibrating " << builders.size() << " components with " << nWorkers << " threads");
+#ifdef QL_ENABLE_SESSIONS
+    // the singletons are thread local, copy the settings and fixings of this thread to the workers
+    Date evaluationDate = Settings::instance().evaluationDate();
+    bool includeReferenceDateEvents = Settings::instance().includeReferenceDateEvents();
+    auto includeTodaysCashFlows = Settings::instance().includeTodaysCashFlows();
+    bool enforcesTodaysHistoricFixings = Settings::instance().enforcesTodaysHistoricFixings();
+    FixingHistories fixingHistories = getFixingHistories();
+#endif
+    std::atomic<Size> next(0);
+    std::vector<std::exception_ptr> errors(builders.size());
+    std::vector<std::thread> workers;
+    for (Size w = 0; w < nWorkers; ++w) {
+        workers.emplace_back([&]() {
+#ifdef QL_ENABLE_SESSIONS
+            Settings::instance().evaluationDate() = evaluationDate;
+            Settings::instance().includeReferenceDateEvents() = includeReferenceDateEvents;
+            Settings::instance().includeTodaysCashFlows() = includeTodaysCashFlows;
+            Settings::instance().enforcesTodaysHistoricFixings() = enforcesTodaysHistoricFixings;
+            applyFixingHistories(fixingHistories);
+#endif
+            for (Size k = next++; k < builders.size(); k = next++) {
+                try {
+                    builders[k]->recalibrate();
+                } catch (...) {
+                    errors[k] = std::current_exception();
+                }
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    // rethrow the error of the first failing builder, as in a sequential calibration
+    for (const auto& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
+}
+} // namespace
+
 CrossAssetModelBuilder::CrossAssetModelBuilder(
     const QuantLib::ext::shared_ptr<ore::data::Market>& market, const QuantLib::ext::shared_ptr<CrossAssetModelData>& config,
     const std::string& configurationLgmCalibration, const std::string& configurationFxCalibration,
     const std::string& configurationEqCalibration, const std::string& configurationInfCalibration,
     const std::string& configurationCrCalibration, const std::string& configurationFinalModel, const bool dontCalibrate,
     const bool continueOnError, const std::string& referenceCalibrationGrid, const SalvagingAlgorithm::Type salvaging,
-    const std::string& id)
+    const std::string& id, const Size nThreads)
     : market_(market), config_(config), configurationLgmCalibration_(configurationLgmCalibration),
       configurationFxCalibration_(configurationFxCalibration), configurationEqCalibration_(configurationEqCalibration),
       configurationInfCalibration_(configurationInfCalibration),
       configurationCrCalibration_(configurationCrCalibration),
       configurationComCalibration_(Market::defaultConfiguration), configurationFinalModel_(configurationFinalModel),
       dontCalibrate_(dontCalibrate), continueOnError_(continueOnError),
-      referenceCalibrationGrid_(referenceCalibrationGrid), salvaging_(salvaging), id_(id),
+      referenceCalibrationGrid_(referenceCalibrationGrid), salvaging_(salvaging), id_(id), nThreads_(nThreads),
       optimizationMethod_(QuantLib::ext::shared_ptr<OptimizationMethod>(new LevenbergMarquardt(1E-8, 1E-8, 1E-8))),
       endCriteria_(EndCriteria(1000, 500, 1E-8, 1E-8, 1E-8)) {
     buildModel();
@@ -223,6 +286,7 @@ void CrossAssetModelBuilder::buildModel() const {
         fxOptionBaskets_.resize(config_->fxConfigs().size());
         fxOptionExpiries_.resize(config_->fxConfigs().size());
         fxOptionCalibrationErrors_.resize(config_->fxConfigs().size());
+        fxCalibrated_.resize(config_->fxConfigs().size(), false);
         eqOptionBaskets_.resize(config_->eqConfigs().size());
         eqOptionExpiries_.resize(config_->eqConfigs().size());
         eqOptionCalibrationErrors_.resize(config_->eqConfigs().size());
@@ -262,23 +326,48 @@ void CrossAssetModelBuilder::buildModel() const {
     std::vector<QuantLib::ext::shared_ptr<EqBsBuilder>> eqBuilder;
     std::vector<QuantLib::ext::shared_ptr<CommoditySchwartzModelBuilder>> csBuilder;
 
-    std::set<std::string> recalibratedCurrencies;
+    /* The IR components are calibrated by their own builders independently of each other, so that the calibrations
+       can run concurrently before the parametrizations are collected. The other components are calibrated against
+       the assembled cross asset model below and therefore sequentially. */
+    std::vector<QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>> irBuilders;
+    std::vector<bool> irRecalibration;
     for (Size i = 0; i < config_->irConfigs().size(); i++) {
         auto irConfig = config_->irConfigs()[i];
-        DLOG("IR Parametrization " << i << " qualifier " << irConfig->qualifier());
-
-        if (auto ir = QuantLib::ext::dynamic_pointer_cast<IrLgmData>(irConfig)) {
-            if (!buildersAreInitialized) {
+        if (!buildersAreInitialized) {
+            if (auto ir = QuantLib::ext::dynamic_pointer_cast<IrLgmData>(irConfig)) {
                 subBuilders_[CrossAssetModel::AssetType::IR][i] = QuantLib::ext::make_shared<LgmBuilder>(
                     market_, ir, configurationLgmCalibration_, config_->bootstrapTolerance(), continueOnError_,
-                    referenceCalibrationGrid_, false, id_);
+                    referenceCalibrationGrid_, false, id_, config_->warmStartCalibration());
+            } else if (auto ir = QuantLib::ext::dynamic_pointer_cast<HwModelData>(irConfig)) {
+                bool evaluateBankAccount = true; // updated in cross asset model for non-base ccys
+                bool setCalibrationInfo = false;
+                HwModel::Discretization discr = HwModel::Discretization::Euler;
+                subBuilders_[CrossAssetModel::AssetType::IR][i] = QuantLib::ext::make_shared<HwBuilder>(
+                    market_, ir, measure, discr, evaluateBankAccount, configurationLgmCalibration_,
+                    config_->bootstrapTolerance(), continueOnError_, referenceCalibrationGrid_, setCalibrationInfo);
             }
+        }
+        auto b = subBuilders_[CrossAssetModel::AssetType::IR].find(i);
+        if (b == subBuilders_[CrossAssetModel::AssetType::IR].end())
+            continue;
+        auto builder = b->second;
+        // lgm builders are frozen before, hw builders after their (first) calibration
+        if (dontCalibrate_ && QuantLib::ext::dynamic_pointer_cast<LgmBuilder>(builder))
+            builder->freeze();
+        irBuilders.push_back(builder);
+        irRecalibration.push_back(builder->requiresRecalibration());
+    }
+    recalibrate(irBuilders, nThreads_);
+
+    std::set<std::string> recalibratedCurrencies;
+    for (Size i = 0, k = 0; i < config_->irConfigs().size(); i++) {
+        auto irConfig = config_->irConfigs()[i];
+        DLOG("IR Parametrization " << i << " qualifier " << irConfig->qualifier());
+
+        if (auto ir = QuantLib::ext::dynamic_pointer_cast<IrLgmData>(irConfig)) {
             auto builder = QuantLib::ext::dynamic_pointer_cast<LgmBuilder>(subBuilders_[CrossAssetModel::AssetType::IR][i]);
             lgmBuilder.push_back(builder);
-            if (dontCalibrate_) {
-                builder->freeze();
-            }
-            if (builder->requiresRecalibration())
+            if (irRecalibration[k++])
                 recalibratedCurrencies.insert(builder->parametrization()->currency().code());
             auto parametrization = builder->parametrization();
             swaptionBaskets_[i] = builder->swaptionBasket();
@@ -292,17 +381,9 @@ void CrossAssetModelBuilder::buildModel() const {
             irDiscountCurves.push_back(builder->discountCurve());
             processInfo[CrossAssetModel::AssetType::IR].emplace_back(ir->ccy(), 1);
         } else if (auto ir = QuantLib::ext::dynamic_pointer_cast<HwModelData>(irConfig)) {
-            bool evaluateBankAccount = true; // updated in cross asset model for non-base ccys
-            bool setCalibrationInfo = false;
-            HwModel::Discretization discr = HwModel::Discretization::Euler;
-            if (!buildersAreInitialized) {
-                subBuilders_[CrossAssetModel::AssetType::IR][i] = QuantLib::ext::make_shared<HwBuilder>(
-                    market_, ir, measure, discr, evaluateBankAccount, configurationLgmCalibration_,
-                    config_->bootstrapTolerance(), continueOnError_, referenceCalibrationGrid_, setCalibrationInfo);
-            }
             auto builder = QuantLib::ext::dynamic_pointer_cast<HwBuilder>(subBuilders_[CrossAssetModel::AssetType::IR][i]);
             hwBuilder.push_back(builder);
-            if (builder->requiresRecalibration())
+            if (irRecalibration[k++])
                 recalibratedCurrencies.insert(builder->parametrization()->currency().code());
             auto parametrization = builder->parametrization();
             if (dontCalibrate_)
@@ -611,8 +692,12 @@ void CrossAssetModelBuilder::buildModel() const {
 
         if (!dontCalibrate_) {
 
-            // reset to initial params to ensure identical calibration outcomes for identical baskets
-            resetModelParams(CrossAssetModel::AssetType::FX, 0, i, Null<Size>());
+            /* reset to initial params to ensure identical calibration outcomes for identical baskets, unless we warm
+               start from the last successful calibration */
+            if (config_->warmStartCalibration() && fxCalibrated_[i])
+                DLOG("FX Calibration " << i << " warm starts from previously calibrated parameters");
+            else
+                resetModelParams(CrossAssetModel::AssetType::FX, 0, i, Null<Size>());
 
             if (fx->calibrationType() == CalibrationType::Bootstrap && fx->sigmaParamType() == ParamType::Piecewise)
                 model_->calibrateBsVolatilitiesIterative(CrossAssetModel::AssetType::FX, i, fxOptionBaskets_[i],
@@ -623,6 +708,8 @@ void CrossAssetModelBuilder::buildModel() const {
 
             DLOG("FX " << fx->foreignCcy() << " calibration errors:");
             fxOptionCalibrationErrors_[i] = getCalibrationError(fxOptionBaskets_[i]);
+            fxCalibrated_[i] = fx->calibrationType() != CalibrationType::Bootstrap ||
+                               fabs(fxOptionCalibrationErrors_[i]) < config_->bootstrapTolerance();
             if (fx->calibrationType() == CalibrationType::Bootstrap) {
                 if (fabs(fxOptionCalibrationErrors_[i]) < config_->bootstrapTolerance()) {
                     TLOGGERSTREAM("Calibration details:");
@@ -84,7 +84,11 @@ public:
 	//! salvaging algorithm to apply to correlation matrix
 	const SalvagingAlgorithm::Type salvaging = SalvagingAlgorithm::None,
         //! id of the builder
-        const std::string& id = "unknown");
+        const std::string& id = "unknown",
+        /*! number of threads calibrating the IR components concurrently, this requires a QuantLib build with
+            QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN = ON and market objects that are built upfront, i.e. not a
+            TodaysMarket with lazy building, see Portfolio::build() */
+        const QuantLib::Size nThreads = 1);
 
     //! Default destructor
     ~CrossAssetModelBuilder() {}
@@ -126,6 +130,8 @@ private:
     mutable std::vector<Array> comOptionExpiries_;
     mutable std::vector<Real> swaptionCalibrationErrors_;
     mutable std::vector<Real> fxOptionCalibrationErrors_;
+    // whether the last fx calibration succeeded, a warm start is only done from a successful calibration
+    mutable std::vector<bool> fxCalibrated_;
     mutable std::vector<Real> eqOptionCalibrationErrors_;
     mutable std::vector<Real> inflationCalibrationErrors_;
     mutable std::vector<Real> comOptionCalibrationErrors_;
@@ -145,6 +151,7 @@ private:
     const std::string referenceCalibrationGrid_;
     const SalvagingAlgorithm::Type salvaging_;
     const std::string id_;
+    const QuantLib::Size nThreads_;
 
     // TODO: Move CalibrationErrorType, optimizer and end criteria parameters to data
     QuantLib::ext::shared_ptr<OptimizationMethod> optimizationMethod_;
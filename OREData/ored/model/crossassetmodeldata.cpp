@@ -135,6 +135,7 @@ bool CrossAssetModelData::operator==(const CrossAssetModelData& rhs) {
 
     if (domesticCurrency_ != rhs.domesticCurrency_ || currencies_ != rhs.currencies_ || equities_ != rhs.equities_ ||
         infindices_ != rhs.infindices_ || bootstrapTolerance_ != rhs.bootstrapTolerance_ ||
+        warmStartCalibration_ != rhs.warmStartCalibration_ ||
         irConfigs_.size() != rhs.irConfigs_.size() || fxConfigs_.size() != rhs.fxConfigs_.size() ||
         eqConfigs_.size() != rhs.eqConfigs_.size() || infConfigs_.size() != rhs.infConfigs_.size() ||
         crLgmConfigs_.size() != rhs.crLgmConfigs_.size() || crCirConfigs_.size() != rhs.crCirConfigs_.size() ||
@@ -315,6 +316,9 @@ void CrossAssetModelData::fromXML(XMLNode* root) {
     bootstrapTolerance_ = XMLUtils::getChildValueAsDouble(modelNode, "BootstrapTolerance", true);
     LOG("CrossAssetModelData: bootstrap tolerance = " << bootstrapTolerance_);
 
+    warmStartCalibration_ = XMLUtils::getChildValueAsBool(modelNode, "WarmStartCalibration", false, false);
+    LOG("CrossAssetModelData: warm start calibration = " << std::boolalpha << warmStartCalibration_);
+
     measure_ = XMLUtils::getChildValue(modelNode, "Measure", false);
     LOG("CrossAssetModelData: measure = '" << measure_ << "'");
 
@@ -787,6 +791,8 @@ XMLNode* CrossAssetModelData::toXML(XMLDocument& doc) const {
     XMLUtils::addChild(doc, crossAssetModelNode, "Measure", measure_);
     XMLUtils::addChild(doc, crossAssetModelNode, "Discretization",
                        discretization_ == CrossAssetModel::Discretization::Exact ? "Exact" : "Euler");
+    if (warmStartCalibration_)
+        XMLUtils::addChild(doc, crossAssetModelNode, "WarmStartCalibration", warmStartCalibration_);
 
     XMLNode* interestRateModelsNode = XMLUtils::addChild(doc, crossAssetModelNode, "InterestRateModels");
     for (Size irConfigs_Iterator = 0; irConfigs_Iterator < irConfigs_.size(); irConfigs_Iterator++) {
@@ -235,6 +235,7 @@ public:
     Real bootstrapTolerance() const { return bootstrapTolerance_; }
     const std::string& measure() const { return measure_; }
     CrossAssetModel::Discretization discretization() const { return discretization_; }
+    bool warmStartCalibration() const { return warmStartCalibration_; }
     //@}
 
     //! \name Setters
@@ -259,6 +260,7 @@ public:
     Real& bootstrapTolerance() { return bootstrapTolerance_; }
     std::string& measure() { return measure_; }
     CrossAssetModel::Discretization& discretization() { return discretization_; }
+    bool& warmStartCalibration() { return warmStartCalibration_; }
     //@}
 
     //! \name Serialisation
@@ -313,6 +315,8 @@ private:
     Real bootstrapTolerance_;
     std::string measure_;
     CrossAssetModel::Discretization discretization_;
+    // recalibrate ir and fx components starting from their last successful calibration
+    bool warmStartCalibration_ = false;
 };
 
 CrossAssetModel::Discretization parseDiscretization(const string& s);
@@ -28,6 +28,7 @@
 #include <qle/models/marketobserver.hpp>
 #include <qle/pricingengines/analyticlgmswaptionengine.hpp>
 
+#include <ored/model/calibrationresultcache.hpp>
 #include <ored/model/lgmbuilder.hpp>
 #include <ored/model/structuredmodelerror.hpp>
 #include <ored/model/utilities.hpp>
@@ -37,6 +38,10 @@
 #include <ored/utilities/parsers.hpp>
 #include <ored/utilities/strike.hpp>
 
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -167,10 +172,10 @@ namespace data {
 LgmBuilder::LgmBuilder(const QuantLib::ext::shared_ptr<ore::data::Market>& market, const QuantLib::ext::shared_ptr<IrLgmData>& data,
                        const std::string& configuration, const Real bootstrapTolerance, const bool continueOnError,
                        const std::string& referenceCalibrationGrid, const bool setCalibrationInfo,
-                       const std::string& id)
+                       const std::string& id, const bool warmStart)
     : market_(market), configuration_(configuration), data_(data), bootstrapTolerance_(bootstrapTolerance),
       continueOnError_(continueOnError), referenceCalibrationGrid_(referenceCalibrationGrid),
-      setCalibrationInfo_(setCalibrationInfo), id_(id),
+      setCalibrationInfo_(setCalibrationInfo), id_(id), warmStart_(warmStart),
       optimizationMethod_(QuantLib::ext::shared_ptr<OptimizationMethod>(new LevenbergMarquardt(1E-8, 1E-8, 1E-8))),
       endCriteria_(EndCriteria(1000, 500, 1E-8, 1E-8, 1E-8)),
       calibrationErrorType_(BlackCalibrationHelper::RelativePriceError) {
@@ -354,11 +359,38 @@ void LgmBuilder::performCalculations() const {
         swaptionBasket_[j]->update();
     }
 
-    // reset model parameters to ensure identical results on identical market data input
-    model_->setParams(params_);
     parametrization_->shift() = 0.0;
     parametrization_->scaling() = 1.0;
 
+    /* use the parameters calibrated to the same inputs before, if any, since the cache key is a hash we only accept
+       them if they reproduce the calibration error stored with them */
+    auto& cache = CalibrationResultCache::instance();
+    std::string cacheKey;
+    bool fromCache = false;
+    if (cache.enabled()) {
+        cacheKey = calibrationCacheKey();
+        CalibrationResultCache::Entry entry;
+        if (cache.get(cacheKey, entry) && entry.params.size() == params_.size()) {
+            Array previousParams = model_->params();
+            model_->setParams(Array(entry.params.begin(), entry.params.end()));
+            fromCache = close_enough(getCalibrationError(swaptionBasket_), entry.error);
+            if (!fromCache) {
+                DLOG("Cached calibration result does not reproduce the calibration error, recalibrate");
+                model_->setParams(previousParams);
+            }
+        }
+    }
+
+    /* reset model parameters to ensure identical results on identical market data input, unless we warm start from
+       the last successful calibration, which is usually close to the solution for slightly changed market data */
+    if (fromCache) {
+        DLOG("Use cached calibration result");
+    } else if (warmStart_ && calibrated_) {
+        DLOG("Warm start calibration from previously calibrated parameters");
+    } else {
+        model_->setParams(params_);
+    }
+
     LgmCalibrationInfo calibrationInfo;
     error_ = QL_MAX_REAL;
     std::string errorTemplate =
@@ -366,7 +398,10 @@ void LgmBuilder::performCalculations() const {
         (continueOnError_ ? std::string("Calculation will proceed anyway - using the calibration as is!")
                           : std::string("Calculation will aborted."));
     try {
-        if (data_->calibrateA() && !data_->calibrateH() && data_->calibrationType() == CalibrationType::Bootstrap) {
+        if (fromCache) {
+            // nothing to calibrate
+        } else if (data_->calibrateA() && !data_->calibrateH() &&
+                   data_->calibrationType() == CalibrationType::Bootstrap) {
             DLOG("call calibrateVolatilitiesIterative for volatility calibration (bootstrap)");
             model_->calibrateVolatilitiesIterative(swaptionBasket_, *optimizationMethod_, endCriteria_);
         } else if (data_->calibrateH() && !data_->calibrateA() &&
@@ -395,8 +430,13 @@ void LgmBuilder::performCalculations() const {
         StructuredModelErrorMessage(errorTemplate, e.what(), id_).log();
     }
     calibrationInfo.rmse = error_;
-    if (fabs(error_) < bootstrapTolerance_ ||
-        (data_->calibrationType() == CalibrationType::BestFit && error_ != QL_MAX_REAL)) {
+    calibrated_ = fabs(error_) < bootstrapTolerance_ ||
+                  (data_->calibrationType() == CalibrationType::BestFit && error_ != QL_MAX_REAL);
+    if (calibrated_ && !cacheKey.empty() && !fromCache) {
+        Array p = model_->params();
+        cache.put(cacheKey, {std::vector<Real>(p.begin(), p.end()), error_});
+    }
+    if (calibrated_) {
         // we check the log level here to avoid unnecessary computations
         if (Log::instance().filter(ORE_DATA) || setCalibrationInfo_) {
             TLOGGERSTREAM("Basket details:");
@@ -671,6 +711,22 @@ void LgmBuilder::buildSwaptionBasket() const {
     swaptionBasketRefDate_ = calibrationDiscountCurve_->referenceDate();
 }
 
+std::string LgmBuilder::calibrationCacheKey() const {
+    // the model configuration, initial parameters and reference date and the market data the basket depends on
+    std::ostringstream os;
+    os << std::setprecision(std::numeric_limits<Real>::max_digits10);
+    os << "LGM " << calibrationDiscountCurve_->referenceDate().serialNumber() << ' ' << data_->toXMLString();
+    for (auto const& p : params_)
+        os << ' ' << p;
+    for (auto const& h : swaptionBasket_)
+        os << ' ' << h->marketValue();
+    for (auto const& t : swaptionExpiries_)
+        os << ' ' << t << ' ' << calibrationDiscountCurve_->discount(t);
+    for (auto const& t : swaptionMaturities_)
+        os << ' ' << t << ' ' << calibrationDiscountCurve_->discount(t);
+    return CalibrationResultCache::key(os.str());
+}
+
 std::string LgmBuilder::getBasketDetails(LgmCalibrationInfo& info) const {
     std::ostringstream log;
     log << std::right << std::setw(3) << "#" << std::setw(16) << "expiry" << std::setw(16) << "swapLength"
@@ -54,7 +54,10 @@ public:
     LgmBuilder(const QuantLib::ext::shared_ptr<ore::data::Market>& market, const QuantLib::ext::shared_ptr<IrLgmData>& data,
                const std::string& configuration = Market::defaultConfiguration, Real bootstrapTolerance = 0.001,
                const bool continueOnError = false, const std::string& referenceCalibrationGrid = "",
-               const bool setCalibrationInfo = false, const std::string& id = "unknwon");
+               const bool setCalibrationInfo = false, const std::string& id = "unknwon",
+               /*! start a recalibration from the previously calibrated parameters instead of the initial ones, if the
+                   previous calibration met the tolerance */
+               const bool warmStart = false);
     //! Return calibration error
     Real error() const;
 
@@ -82,6 +85,8 @@ private:
     void buildSwaptionBasket() const;
     void updateSwaptionBasketVols() const;
     std::string getBasketDetails(QuantExt::LgmCalibrationInfo& info) const;
+    // key of the calibration in the CalibrationResultCache
+    std::string calibrationCacheKey() const;
     // checks whether swaption vols have changed compared to cache and updates the cache if requested
     bool volSurfaceChanged(const bool updateCache) const;
     // populate expiry and term
@@ -98,10 +103,12 @@ private:
     const std::string referenceCalibrationGrid_;
     const bool setCalibrationInfo_;
     const std::string id_;
+    const bool warmStart_;
     bool requiresCalibration_ = false;
     std::string currency_; // derived from data->qualifier()
 
     mutable Real error_;
+    mutable bool calibrated_ = false;
     mutable QuantLib::ext::shared_ptr<QuantExt::LGM> model_;
     mutable Array params_;
     mutable QuantLib::ext::shared_ptr<QuantExt::IrLgm1fParametrization> parametrization_;
@@ -36,6 +36,8 @@
 #include <ored/marketdata/adjustedinmemoryloader.hpp>
 #include <ored/marketdata/adjustmentfactors.hpp>
 #include <ored/marketdata/basecorrelationcurve.hpp>
+#include <ored/marketdata/binarymarketdataloader.hpp>
+#include <ored/marketdata/bootstrapseeds.hpp>
 #include <ored/marketdata/bondspreadimply.hpp>
 #include <ored/marketdata/bondspreadimplymarket.hpp>
 #include <ored/marketdata/capfloorvolcurve.hpp>
@@ -62,11 +64,14 @@
 #include <ored/marketdata/inflationcapfloorvolcurve.hpp>
 #include <ored/marketdata/inflationcurve.hpp>
 #include <ored/marketdata/inmemoryloader.hpp>
+#include <ored/marketdata/lazyclonedloader.hpp>
 #include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/market.hpp>
 #include <ored/marketdata/marketdatum.hpp>
 #include <ored/marketdata/marketdatumparser.hpp>
 #include <ored/marketdata/marketimpl.hpp>
+#include <ored/marketdata/marketsnapshot.hpp>
+#include <ored/marketdata/overlayloader.hpp>
 #include <ored/marketdata/security.hpp>
 #include <ored/marketdata/strike.hpp>
 #include <ored/marketdata/structuredcurveerror.hpp>
@@ -86,6 +91,7 @@
 #include <ored/model/calibrationinstruments/yoycapfloor.hpp>
 #include <ored/model/calibrationinstruments/yoyswap.hpp>
 #include <ored/model/calibrationpointcache.hpp>
+#include <ored/model/calibrationresultcache.hpp>
 #include <ored/model/commodityschwartzmodelbuilder.hpp>
 #include <ored/model/commodityschwartzmodeldata.hpp>
 #include <ored/model/crcirbuilder.hpp>
@@ -287,6 +293,7 @@
 #include <ored/portfolio/inflationswap.hpp>
 #include <ored/portfolio/instrumentwrapper.hpp>
 #include <ored/portfolio/knockoutswap.hpp>
+#include <ored/portfolio/lazyreferencedatamanager.hpp>
 #include <ored/portfolio/legbuilders.hpp>
 #include <ored/portfolio/legdata.hpp>
 #include <ored/portfolio/legdatafactory.hpp>
@@ -309,6 +316,7 @@
 #include <ored/portfolio/referencedatafactory.hpp>
 #include <ored/portfolio/riskparticipationagreement.hpp>
 #include <ored/portfolio/schedule.hpp>
+#include <ored/portfolio/schedulecache.hpp>
 #include <ored/portfolio/scriptedtrade.hpp>
 #include <ored/portfolio/simmcreditqualifiermapping.hpp>
 #include <ored/portfolio/structuredconfigurationerror.hpp>
@@ -337,11 +345,11 @@
 #include <ored/portfolio/worstofbasketswap.hpp>
 #include <ored/report/csvreport.hpp>
 #include <ored/report/inmemoryreport.hpp>
+#include <ored/report/parquetreport.hpp>
 #include <ored/report/report.hpp>
 #include <ored/report/utilities.hpp>
 #include <ored/scripting/ast.hpp>
 #include <ored/scripting/astprinter.hpp>
-#include <ored/scripting/astresetter.hpp>
 #include <ored/scripting/asttoscriptconverter.hpp>
 #include <ored/scripting/computationgraphbuilder.hpp>
 #include <ored/scripting/context.hpp>
@@ -375,12 +383,15 @@
 #include <ored/scripting/paylog.hpp>
 #include <ored/scripting/randomastgenerator.hpp>
 #include <ored/scripting/safestack.hpp>
+#include <ored/scripting/scriptbytecode.hpp>
+#include <ored/scripting/scriptcache.hpp>
 #include <ored/scripting/scriptedinstrument.hpp>
 #include <ored/scripting/scriptengine.hpp>
 #include <ored/scripting/scriptparser.hpp>
 #include <ored/scripting/staticanalyser.hpp>
 #include <ored/scripting/utilities.hpp>
 #include <ored/scripting/value.hpp>
+#include <ored/utilities/binaryxml.hpp>
 #include <ored/utilities/bondindexbuilder.hpp>
 #include <ored/utilities/calendaradjustmentconfig.hpp>
 #include <ored/utilities/calendarparser.hpp>
@@ -394,6 +405,7 @@
 #include <ored/utilities/fileio.hpp>
 #include <ored/utilities/flowanalysis.hpp>
 #include <ored/utilities/formulaparser.hpp>
+#include <ored/utilities/indexcache.hpp>
 #include <ored/utilities/indexnametranslator.hpp>
 #include <ored/utilities/indexparser.hpp>
 #include <ored/utilities/inflationstartdate.hpp>
@@ -407,8 +419,11 @@
 #include <ored/utilities/serializationperiod.hpp>
 #include <ored/utilities/strike.hpp>
 #include <ored/utilities/timeperiod.hpp>
+#include <ored/utilities/timers.hpp>
 #include <ored/utilities/to_string.hpp>
 #include <ored/utilities/vectorutils.hpp>
 #include <ored/utilities/wildcard.hpp>
+#include <ored/utilities/workergroup.hpp>
+#include <ored/utilities/xmlstreamreader.hpp>
 #include <ored/utilities/xmlutils.hpp>
 #include <ored/version.hpp>
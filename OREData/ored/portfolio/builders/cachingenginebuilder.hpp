@@ -29,6 +29,10 @@
 #include <ql/cashflows/inflationcouponpricer.hpp>
 #include <qle/cashflows/cpicouponpricer.hpp>
 
+#include <boost/functional/hash.hpp>
+
+#include <unordered_map>
+
 namespace ore {
 namespace data {
 
@@ -39,7 +43,7 @@ namespace data {
  *  When the engine() method is called the CachingEngineBuilder first
  *  looks in it's cache to see if it has an engine or coupon pricer for this key already
  *  if so it is returned, otherwise a new engine or coupon pricer is created, stored and
- *  returned.
+ *  returned. The cache hits and misses are counted, see cacheStatistics().
  *
  *  The first template argument is the cache key type (e.g. a std::string)
  *  The second template argument is PricingEngine or FloatingRateCouponPricer
@@ -60,23 +64,41 @@ public:
 
     //! Return a PricingEngine or a FloatingRateCouponPricer
     QuantLib::ext::shared_ptr<U> engine(Args... params) {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
         T key = keyImpl(params...);
-        if (engines_.find(key) == engines_.end()) {
-            // build first (in case it throws)
-            QuantLib::ext::shared_ptr<U> engine = engineImpl(params...);
-            // then add to map
-            engines_[key] = engine;
+        if (auto e = engines_.find(key); e != engines_.end()) {
+            ++hits_;
+            return e->second;
         }
-        return engines_[key];
+        ++misses_;
+        // build first (in case it throws), then add to map
+        QuantLib::ext::shared_ptr<U> engine = engineImpl(params...);
+        engines_.emplace(std::move(key), engine);
+        return engine;
     }
 
-    void reset() override { engines_.clear(); }
+    void reset() override {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        engines_.clear();
+        hits_ = misses_ = 0;
+    }
+
+    CacheStatistics cacheStatistics() const override {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        CacheStatistics stats;
+        stats.hits = hits_;
+        stats.misses = misses_;
+        stats.size = engines_.size();
+        return stats;
+    }
 
 protected:
     virtual T keyImpl(Args...) = 0;
     virtual QuantLib::ext::shared_ptr<U> engineImpl(Args...) = 0;
 
-    map<T, QuantLib::ext::shared_ptr<U>> engines_;
+    // keys are hashed via boost::hash, custom key types must provide hash_value() consistent with operator==
+    std::unordered_map<T, QuantLib::ext::shared_ptr<U>, boost::hash<T>> engines_;
+    QuantLib::Size hits_ = 0, misses_ = 0;
 };
 
 template <class T, typename... Args>
@@ -31,6 +31,7 @@
 
 #include <ql/pricingengines/credit/midpointcdsengine.hpp>
 
+#include <boost/functional/hash.hpp>
 #include <boost/make_shared.hpp>
 
 #include <regex>
@@ -120,6 +121,14 @@ inline bool operator>(const CDSEngineKey& lhs, const CDSEngineKey& rhs) { return
 inline bool operator<=(const CDSEngineKey& lhs, const CDSEngineKey& rhs) { return !(lhs > rhs); }
 inline bool operator>=(const CDSEngineKey& lhs, const CDSEngineKey& rhs) { return !(lhs < rhs); }
 
+//! Hash consistent with operator==, the recovery rate is compared with a tolerance and therefore not hashed
+inline std::size_t hash_value(const CDSEngineKey& k) {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, k.creditCurveId());
+    boost::hash_combine(seed, k.currency().code());
+    return seed;
+}
+
 //! Engine builder base class for credit default swaps
 /*! Pricing engines are cached by CDSEngineKey
     \ingroup builders
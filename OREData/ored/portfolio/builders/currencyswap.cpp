@@ -98,6 +98,7 @@ QuantLib::ext::shared_ptr<PricingEngine> CamAmcCurrencySwapEngineBuilder::engine
 
     // build the pricing engine
 
+    std::string maxBasisSize = engineParameter("RegressionMaxBasisSize", {}, false, std::string());
     auto engine = QuantLib::ext::make_shared<McCamCurrencySwapEngine>(
         model, ccys, base, parseSequenceType(engineParameter("Training.Sequence")),
         parseSequenceType(engineParameter("Pricing.Sequence")), parseInteger(engineParameter("Training.Samples")),
@@ -108,7 +109,9 @@ QuantLib::ext::shared_ptr<PricingEngine> CamAmcCurrencySwapEngineBuilder::engine
         parseSobolRsgDirectionIntegers(engineParameter("SobolDirectionIntegers")), discountCurves, simulationDates_,
         externalModelIndices, parseBool(engineParameter("MinObsDate")),
         parseRegressorModel(engineParameter("RegressorModel", {}, false, "Simple")),
-        parseRealOrNull(engineParameter("RegressionVarianceCutoff", {}, false, std::string())));
+        parseRealOrNull(engineParameter("RegressionVarianceCutoff", {}, false, std::string())),
+        maxBasisSize.empty() ? Null<Size>() : static_cast<Size>(parseInteger(maxBasisSize)),
+        parseRealOrNull(engineParameter("RegressionSignificanceThreshold", {}, false, std::string())));
 
     return engine;
 }
@@ -71,6 +71,7 @@ QuantLib::ext::shared_ptr<PricingEngine> CamAmcFxForwardEngineBuilder::engineImp
     // build the pricing engine
 
     // NPV should be in domCcy, consistent with the npv currency of an ORE FX Forward Trade
+    std::string maxBasisSize = engineParameter("RegressionMaxBasisSize", {}, false, std::string());
     auto engine = QuantLib::ext::make_shared<McCamFxForwardEngine>(
         model, domCcy, forCcy, domCcy, parseSequenceType(engineParameter("Training.Sequence")),
         parseSequenceType(engineParameter("Pricing.Sequence")), parseInteger(engineParameter("Training.Samples")),
@@ -81,7 +82,9 @@ QuantLib::ext::shared_ptr<PricingEngine> CamAmcFxForwardEngineBuilder::engineImp
         parseSobolRsgDirectionIntegers(engineParameter("SobolDirectionIntegers")), discountCurves, simulationDates_,
         externalModelIndices, parseBool(engineParameter("MinObsDate")),
         parseRegressorModel(engineParameter("RegressorModel", {}, false, "Simple")),
-        parseRealOrNull(engineParameter("RegressionVarianceCutoff", {}, false, std::string())));
+        parseRealOrNull(engineParameter("RegressionVarianceCutoff", {}, false, std::string())),
+        maxBasisSize.empty() ? Null<Size>() : static_cast<Size>(parseInteger(maxBasisSize)),
+        parseRealOrNull(engineParameter("RegressionSignificanceThreshold", {}, false, std::string())));
 
     return engine;
 }
@@ -86,6 +86,7 @@ QuantLib::ext::shared_ptr<PricingEngine> CamAmcFxOptionEngineBuilder::engineImpl
     // build the pricing engine
 
     // NPV should be in domCcy, consistent with the npv currency of an ORE FX Option Trade
+    std::string maxBasisSize = engineParameter("RegressionMaxBasisSize", {}, false, std::string());
     auto engine = QuantLib::ext::make_shared<McCamFxOptionEngine>(
         model, domCcy, forCcy, domCcy, parseSequenceType(engineParameter("Training.Sequence")),
         parseSequenceType(engineParameter("Pricing.Sequence")), parseInteger(engineParameter("Training.Samples")),
@@ -96,7 +97,9 @@ QuantLib::ext::shared_ptr<PricingEngine> CamAmcFxOptionEngineBuilder::engineImpl
         parseSobolRsgDirectionIntegers(engineParameter("SobolDirectionIntegers")), discountCurves, simulationDates_,
         externalModelIndices, parseBool(engineParameter("MinObsDate")),
         parseRegressorModel(engineParameter("RegressorModel", {}, false, "Simple")),
-        parseRealOrNull(engineParameter("RegressionVarianceCutoff", {}, false, std::string())));
+        parseRealOrNull(engineParameter("RegressionVarianceCutoff", {}, false, std::string())),
+        maxBasisSize.empty() ? Null<Size>() : static_cast<Size>(parseInteger(maxBasisSize)),
+        parseRealOrNull(engineParameter("RegressionSignificanceThreshold", {}, false, std::string())));
 
     return engine;
 }
@@ -324,6 +324,7 @@ QuantLib::ext::shared_ptr<PricingEngine> CamAmcMultiLegOptionEngineBuilder::engi
 
     // build the pricing engine
 
+    std::string maxBasisSize = engineParameter("RegressionMaxBasisSize", {}, false, std::string());
     auto engine = QuantLib::ext::make_shared<McMultiLegOptionEngine>(
         model, parseSequenceType(engineParameter("Training.Sequence")),
         parseSequenceType(engineParameter("Pricing.Sequence")), parseInteger(engineParameter("Training.Samples")),
@@ -334,7 +335,9 @@ QuantLib::ext::shared_ptr<PricingEngine> CamAmcMultiLegOptionEngineBuilder::engi
         parseSobolRsgDirectionIntegers(engineParameter("SobolDirectionIntegers")), discountCurves, simulationDates_,
         externalModelIndices, parseBool(engineParameter("MinObsDate")),
         parseRegressorModel(engineParameter("RegressorModel", {}, false, "Simple")),
-        parseRealOrNull(engineParameter("RegressionVarianceCutoff", {}, false, std::string())));
+        parseRealOrNull(engineParameter("RegressionVarianceCutoff", {}, false, std::string())),
+        maxBasisSize.empty() ? Null<Size>() : static_cast<Size>(parseInteger(maxBasisSize)),
+        parseRealOrNull(engineParameter("RegressionSignificanceThreshold", {}, false, std::string())));
 
     return engine;
 }
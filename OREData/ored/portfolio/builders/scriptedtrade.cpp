@@ -28,6 +28,7 @@
 #include <ored/scripting/engines/scriptedinstrumentpricingenginecg.hpp>
 #include <ored/scripting/astprinter.hpp>
 #include <ored/scripting/context.hpp>
+#include <ored/scripting/scriptcache.hpp>
 #include <ored/scripting/scriptparser.hpp>
 #include <ored/scripting/scriptedinstrument.hpp>
 
@@ -117,16 +118,7 @@ ScriptedTradeEngineBuilder::engine(const std::string& id, const ScriptedTrade& s
     ScriptedTradeScriptData script =
         getScript(scriptedTrade, ScriptLibraryStorage::instance().get(), purpose, true).second;
 
-    auto f = astCache_.find(script.code());
-
-    if (f != astCache_.end()) {
-        ast_ = f->second;
-        DLOG("retrieved ast from cache");
-    } else {
-        ast_ = parseScript(script.code());
-        astCache_[script.code()] = ast_;
-        DLOGGERSTREAM("built ast:\n" << to_string(ast_));
-    }
+    ast_ = ScriptCache::instance().ast(script.code());
 
     // 4 set up context
 
@@ -145,9 +137,8 @@ ScriptedTradeEngineBuilder::engine(const std::string& id, const ScriptedTrade& s
 
     // 5 run static analyser
 
-    DLOG("Run static analyser on script");
-    staticAnalyser_ = QuantLib::ext::make_shared<StaticAnalyser>(ast_, context);
-    staticAnalyser_->run(script.code());
+    DLOG("Run static analyser on script (or retrieve results from cache)");
+    staticAnalyser_ = ScriptCache::instance().staticAnalyser(script.code(), ast_, context);
 
     // 6 extract eq, fx, ir indices from script
 
@@ -234,7 +225,25 @@ ScriptedTradeEngineBuilder::engine(const std::string& id, const ScriptedTrade& s
     if(staticAnalyser_->regressionDates().empty())
         mcParams_.trainingSamples = Null<Size>();
 
-    if (modelParam_ == "BlackScholes" && engineParam_ == "MC") {
+    /* if enabled, reuse a model built for a previous trade with the same model configuration, so that the paths
+       (MC) or the mesher, operator and time grid (FD) are set up once and the scripts of all trades are run against
+       them */
+
+    std::string sharedModelKey;
+    if (shareModels_ && (engineParam_ == "FD" || (engineParam_ == "MC" && !useCg_)) && !buildingAmc_ &&
+        !interactive_) {
+        sharedModelKey = modelKey(script.conditionalExpectationModelStates());
+        if (auto m = sharedModels_.find(sharedModelKey); m != sharedModels_.end()) {
+            model_ = m->second.first;
+            if (m->second.second)
+                modelBuilders_.insert(std::make_pair(id, m->second.second));
+            DLOG("reusing shared model (" << sharedModels_.size() << " shared models in total)");
+        }
+    }
+
+    if (model_) {
+        // model was retrieved from the shared models above
+    } else if (modelParam_ == "BlackScholes" && engineParam_ == "MC") {
         buildBlackScholes(id, iborFallbackConfig);
     } else if (modelParam_ == "BlackScholes" && engineParam_ == "FD") {
         buildFdBlackScholes(id, iborFallbackConfig);
@@ -258,11 +267,20 @@ ScriptedTradeEngineBuilder::engine(const std::string& id, const ScriptedTrade& s
 
     QL_REQUIRE(model_ != nullptr || modelCG_ != nullptr, "internal error: both model_ and modelCG_ are null");
 
+    if (!sharedModelKey.empty() && sharedModels_.find(sharedModelKey) == sharedModels_.end()) {
+        QuantLib::ext::shared_ptr<QuantExt::ModelBuilder> modelBuilder;
+        for (auto const& b : modelBuilders_)
+            if (b.first == id)
+                modelBuilder = b.second;
+        sharedModels_[sharedModelKey] = std::make_pair(model_, modelBuilder);
+    }
+
     // 21 log some summary information
 
     DLOG("built model          : " << modelParam_ << " / " << engineParam_);
     DLOG("useCg                = " << std::boolalpha << useCg_);
     DLOG("useAd                = " << std::boolalpha << useAd_);
+    DLOG("adGreeks             = " << std::boolalpha << adGreeks_);
     DLOG("useExternalDevice    = " << std::boolalpha << useExternalComputeDevice_);
     DLOG("useDblPrecExtCalc    = " << std::boolalpha << useDoublePrecisionForExternalCalculation_);
     DLOG("extDeviceCompatMode  = " << std::boolalpha << externalDeviceCompatibilityMode_);
@@ -291,6 +309,10 @@ ScriptedTradeEngineBuilder::engine(const std::string& id, const ScriptedTrade& s
         }
         DLOG("sobol bb ordering    = " << mcParams_.sobolOrdering);
         DLOG("sobol direction int. = " << mcParams_.sobolDirectionIntegers);
+        DLOG("smoothing width      = " << mcParams_.smoothingWidth);
+        if (mcParams_.pathChunkSize != Null<Size>()) {
+            DLOG("path chunk size      = " << mcParams_.pathChunkSize);
+        }
     } else if (engineParam_ == "FD") {
         DLOG("stateGridPoints      = " << modelSize_);
         DLOG("mesherEpsilon        = " << mesherEpsilon_);
@@ -322,12 +344,17 @@ ScriptedTradeEngineBuilder::engine(const std::string& id, const ScriptedTrade& s
         engine = QuantLib::ext::make_shared<ScriptedInstrumentPricingEngine>(
             script.npv(), script.results(), model_, ast_, context, script.code(), interactive_, amcCam_ != nullptr,
             std::set<std::string>(script.stickyCloseOutStates().begin(), script.stickyCloseOutStates().end()),
-            generateAdditionalResults, includePastCashflows_);
+            generateAdditionalResults, includePastCashflows_, sharedModelKey.empty(), script.controlVariates());
     } else if (modelCG_) {
+        if (!script.controlVariates().empty()) {
+            WLOG("Will not apply control variates to trade " << id
+                                                              << ", because they are not supported by the computation "
+                                                                 "graph engine");
+        }
         auto rt = globalParameters_.find("RunType");
         std::string runType = rt != globalParameters_.end() ? rt->second : "<<no run type set>>";
         bool useCachedSensis = useAd_ && (runType == "SensitivityDelta");
-        bool useExternalDev = useExternalComputeDevice_ && !generateAdditionalResults && !useCachedSensis;
+        bool useExternalDev = useExternalComputeDevice_ && !generateAdditionalResults && !useCachedSensis && !adGreeks_;
         if (useAd_ && !useCachedSensis) {
             WLOG("Will not apply AD although useAD is configured, because runType ("
                  << runType << ") does not match SensitivitiyDelta");
@@ -335,13 +362,14 @@ ScriptedTradeEngineBuilder::engine(const std::string& id, const ScriptedTrade& s
         if (useExternalComputeDevice_ && !useExternalDev) {
             WLOG("Will not use exxternal compute deivce although useExternalComputeDevice is configured, because we "
                  "are either applying AD ("
-                 << std::boolalpha << useCachedSensis << ") or we are generating add results ("
-                 << generateAdditionalResults << "), both of which do not support external devices at the moment.");
+                 << std::boolalpha << useCachedSensis << ", adGreeks = " << adGreeks_
+                 << ") or we are generating add results (" << generateAdditionalResults
+                 << "), both of which do not support external devices at the moment.");
         }
         engine = QuantLib::ext::make_shared<ScriptedInstrumentPricingEngineCG>(
             script.npv(), script.results(), modelCG_, ast_, context, mcParams_, script.code(), interactive_,
             generateAdditionalResults, includePastCashflows_, useCachedSensis, useExternalDev,
-            useDoublePrecisionForExternalCalculation_);
+            useDoublePrecisionForExternalCalculation_, adGreeks_);
         if (useExternalDev) {
             ComputeEnvironment::instance().selectContext(externalComputeDevice_);
         }
@@ -349,10 +377,67 @@ ScriptedTradeEngineBuilder::engine(const std::string& id, const ScriptedTrade& s
 
     LOG("engine built for model " << modelParam_ << " / " << engineParam_ << ", modelSize = " << modelSize_
                                   << ", interactive = " << interactive_ << ", amcEnabled = " << buildingAmc_
-                                  << ", generateAdditionalResults = " << generateAdditionalResults);
+                                  << ", generateAdditionalResults = " << generateAdditionalResults
+                                  << ", sharedModel = " << !sharedModelKey.empty());
     return engine;
 }
 
+void ScriptedTradeEngineBuilder::reset() { sharedModels_.clear(); }
+
+std::string
+ScriptedTradeEngineBuilder::modelKey(const std::vector<std::string>& conditionalExpectationModelStates) const {
+    std::ostringstream key;
+    key.precision(17);
+    key << modelParam_ << '|' << engineParam_ << '|' << resolvedProductTag_ << '|' << baseCcy_ << '|' << modelSize_
+        << '|' << timeStepsPerYear_ << '|' << fullDynamicFx_ << '|' << fullDynamicIr_ << '|' << infModelType_ << '|'
+        << zeroVolatility_ << '|' << calibrate_ << '|' << calibration_ << '|' << continueOnCalibrationError_ << '|'
+        << referenceCalibrationGrid_ << '|' << bootstrapTolerance_ << '|' << lastRelevantDate_.serialNumber() << '|';
+    key << mesherEpsilon_ << ',' << mesherScaling_ << ',' << mesherConcentration_ << ','
+        << mesherMaxConcentratingPoints_ << ',' << mesherIsStatic_ << '|';
+    key << mcParams_.seed << ',' << mcParams_.trainingSeed << ',' << mcParams_.trainingSamples << ','
+        << static_cast<int>(mcParams_.sequenceType) << ',' << static_cast<int>(mcParams_.trainingSequenceType) << ','
+        << mcParams_.externalDeviceCompatibilityMode << ',' << mcParams_.regressionOrder << ','
+        << static_cast<int>(mcParams_.polynomType) << ',' << static_cast<int>(mcParams_.sobolOrdering) << ','
+        << static_cast<int>(mcParams_.sobolDirectionIntegers) << ',' << mcParams_.regressionVarianceCutoff << ','
+        << mcParams_.pathChunkSize << '|';
+    for (auto const& c : modelCcys_)
+        key << c << ',';
+    key << '|';
+    for (auto const& c : payCcys_)
+        key << c << ',';
+    key << '|';
+    for (auto const& i : modelIndices_)
+        key << i << ',';
+    key << '|';
+    for (auto const& i : modelIrIndices_)
+        key << i.first << ',';
+    key << '|';
+    for (auto const& i : modelInfIndices_)
+        key << i.first << ',';
+    key << '|';
+    for (auto const& r : irReversions_)
+        key << r.first << ':' << r.second << ',';
+    key << '|';
+    for (auto const& m : calibrationMoneyness_)
+        key << m << ',';
+    key << '|';
+    for (auto const& s : calibrationStrikes_) {
+        key << s.first << ':';
+        for (auto const& k : s.second)
+            key << k << ',';
+    }
+    key << '|';
+    for (auto const& d : simulationDates_)
+        key << d.serialNumber() << ',';
+    key << '|';
+    for (auto const& d : addDates_)
+        key << d.serialNumber() << ',';
+    key << '|';
+    for (auto const& s : conditionalExpectationModelStates)
+        key << s << ',';
+    return key.str();
+}
+
 void ScriptedTradeEngineBuilder::clear() {
     fixings_.clear();
     eqIndices_.clear();
@@ -498,6 +583,7 @@ void ScriptedTradeEngineBuilder::populateModelParameters() {
     calibration_ = modelParameter("Calibration", {resolvedProductTag_}, false, "Deal");
     useCg_ = parseBool(engineParameter("UseCG", {resolvedProductTag_}, false, "false"));
     useAd_ = parseBool(engineParameter("UseAD", {resolvedProductTag_}, false, "false"));
+    adGreeks_ = parseBool(engineParameter("ADGreeks", {resolvedProductTag_}, false, "false"));
     useExternalComputeDevice_ =
         parseBool(engineParameter("UseExternalComputeDevice", {resolvedProductTag_}, false, "false"));
     useDoublePrecisionForExternalCalculation_ =
@@ -505,9 +591,15 @@ void ScriptedTradeEngineBuilder::populateModelParameters() {
     externalComputeDevice_ = engineParameter("ExternalComputeDevice", {}, false, "");
     externalDeviceCompatibilityMode_ = parseBool(engineParameter("ExternalDeviceCompatibilityMode", {}, false, "false"));
     includePastCashflows_ = parseBool(engineParameter("IncludePastCashflows", {resolvedProductTag_}, false, "false"));
+    shareModels_ = parseBool(engineParameter("ShareModels", {resolvedProductTag_}, false, "false"));
+
+    // usage of ad (for sensitivities or greeks) or an external device implies usage of cg
+    if (useAd_ || adGreeks_ || useExternalComputeDevice_)
+        useCg_ = true;
 
-    // usage of ad or an external device implies usage of cg
-    if (useAd_ || useExternalComputeDevice_)
+    // indicator smoothing is only available in the cg engine
+    if (engineParam_ == "MC" &&
+        !close_enough(parseReal(engineParameter("SmoothingWidth", {resolvedProductTag_}, false, "0.0")), 0.0))
         useCg_ = true;
 
     // default values for parameters that are only read for specific models
@@ -559,6 +651,12 @@ void ScriptedTradeEngineBuilder::populateModelParameters() {
         mcParams_.regressionVarianceCutoff =
             parseRealOrNull(engineParameter("RegressionVarianceCutoff", {resolvedProductTag_}, false, std::string()));
         mcParams_.externalDeviceCompatibilityMode = externalDeviceCompatibilityMode_;
+        mcParams_.smoothingWidth =
+            parseReal(engineParameter("SmoothingWidth", {resolvedProductTag_}, false, "0.0"));
+        if (auto tmp = engineParameter("PathChunkSize", {resolvedProductTag_}, false, ""); !tmp.empty())
+            mcParams_.pathChunkSize = parseInteger(tmp);
+        else
+            mcParams_.pathChunkSize = Null<Size>();
     } else if (engineParam_ == "FD") {
         modelSize_ = parseInteger(engineParameter("StateGridPoints", {resolvedProductTag_}));
         mesherEpsilon_ = parseReal(engineParameter("MesherEpsilon", {resolvedProductTag_}, false, "1.0E-4"));
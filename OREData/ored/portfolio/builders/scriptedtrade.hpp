@@ -65,6 +65,9 @@ public:
     const std::string& sensitivityTemplate() const { return sensitivityTemplate_; }
     const std::map<std::string, std::set<Date>>& fixings() const { return fixings_; }
 
+    //! clears the shared models
+    void reset() override;
+
 protected:
     // hook for correlation retrieval - by default the correlation for a pair of indices is queried from the market
     // other implementations might want to estimate the correlation on the fly based on historical data
@@ -99,6 +102,9 @@ protected:
     void addAmcGridToContext(QuantLib::ext::shared_ptr<Context>& context) const;
     void setupCalibrationStrikes(const ScriptedTradeScriptData& script, const QuantLib::ext::shared_ptr<Context>& context);
 
+    // key identifying the model configuration, trades with the same key can share one model instance
+    std::string modelKey(const std::vector<std::string>& conditionalExpectationModelStates) const;
+
     // gets eq ccy from market
     std::string getEqCcy(const IndexInfo& e);
 
@@ -111,8 +117,10 @@ protected:
     const QuantLib::ext::shared_ptr<ore::data::ModelCG> amcCgModel_;
     const std::vector<Date> amcGrid_;
 
-    // cache for parsed asts
-    std::map<std::string, ASTNodePtr> astCache_;
+    // models shared between trades with the same model configuration (if ShareModels is enabled), with their builders
+    std::map<std::string,
+             std::pair<QuantLib::ext::shared_ptr<Model>, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>>
+        sharedModels_;
 
     // populated by a call to engine()
     ASTNodePtr ast_;
@@ -159,11 +167,13 @@ protected:
     std::string calibration_;
     bool useCg_;
     bool useAd_;
+    bool adGreeks_;
     bool useExternalComputeDevice_;
     bool useDoublePrecisionForExternalCalculation_;
     bool externalDeviceCompatibilityMode_;
     std::string externalComputeDevice_;
     bool includePastCashflows_;
+    bool shareModels_;
 };
 
 } // namespace data
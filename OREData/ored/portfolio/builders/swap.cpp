@@ -36,6 +36,7 @@ QuantLib::ext::shared_ptr<PricingEngine> CamAmcSwapEngineBuilder::buildMcEngine(
                                                                         const std::vector<Date>& simulationDates,
                                                                         const std::vector<Size>& externalModelIndices) {
 
+    std::string maxBasisSize = engineParameter("RegressionMaxBasisSize", {}, false, std::string());
     return QuantLib::ext::make_shared<QuantExt::McLgmSwapEngine>(
         lgm, parseSequenceType(engineParameter("Training.Sequence")),
         parseSequenceType(engineParameter("Pricing.Sequence")), parseInteger(engineParameter("Training.Samples")),
@@ -46,7 +47,9 @@ QuantLib::ext::shared_ptr<PricingEngine> CamAmcSwapEngineBuilder::buildMcEngine(
         parseSobolRsgDirectionIntegers(engineParameter("SobolDirectionIntegers")), discountCurve, simulationDates,
         externalModelIndices, parseBool(engineParameter("MinObsDate")),
         parseRegressorModel(engineParameter("RegressorModel", {}, false, "Simple")),
-        parseRealOrNull(engineParameter("RegressionVarianceCutoff", {}, false, std::string())));
+        parseRealOrNull(engineParameter("RegressionVarianceCutoff", {}, false, std::string())),
+        maxBasisSize.empty() ? Null<Size>() : static_cast<Size>(parseInteger(maxBasisSize)),
+        parseRealOrNull(engineParameter("RegressionSignificanceThreshold", {}, false, std::string())));
 }
 
 QuantLib::ext::shared_ptr<PricingEngine> CamAmcSwapEngineBuilder::engineImpl(const Currency& ccy,
@@ -24,6 +24,8 @@
 #include <ored/utilities/to_string.hpp>
 
 #include <qle/methods/multipathgeneratorbase.hpp>
+#include <qle/models/lgmconvolutionsolver2.hpp>
+#include <qle/models/lgmfftsolver.hpp>
 #include <qle/pricingengines/blackmultilegoptionengine.hpp>
 #include <qle/pricingengines/mcmultilegoptionengine.hpp>
 #include <qle/pricingengines/numericlgmmultilegoptionengine.hpp>
@@ -44,6 +46,7 @@ QuantLib::ext::shared_ptr<PricingEngine> buildMcEngine(
     const QuantLib::ext::shared_ptr<LGM>& lgm, const Handle<YieldTermStructure>& discountCurve,
     const std::vector<Date>& simulationDates, const std::vector<Size>& externalModelIndices) {
 
+    std::string maxBasisSize = engineParameter("RegressionMaxBasisSize", {}, false, std::string());
     return QuantLib::ext::make_shared<QuantExt::McMultiLegOptionEngine>(
         lgm, parseSequenceType(engineParameter("Training.Sequence", {}, false, "SobolBrownianBridge")),
         parseSequenceType(engineParameter("Pricing.Sequence", {}, false, "SobolBrownianBridge")),
@@ -57,7 +60,9 @@ QuantLib::ext::shared_ptr<PricingEngine> buildMcEngine(
         parseSobolRsgDirectionIntegers(engineParameter("SobolDirectionIntegers", {}, false, "JoeKuoD7")), discountCurve,
         simulationDates, externalModelIndices, parseBool(engineParameter("MinObsDate", {}, false, "true")),
         parseRegressorModel(engineParameter("RegressorModel", {}, false, "Simple")),
-        parseRealOrNull(engineParameter("RegressionVarianceCutoff", {}, false, std::string())));
+        parseRealOrNull(engineParameter("RegressionVarianceCutoff", {}, false, std::string())),
+        maxBasisSize.empty() ? Null<Size>() : static_cast<Size>(parseInteger(maxBasisSize)),
+        parseRealOrNull(engineParameter("RegressionSignificanceThreshold", {}, false, std::string())));
 }
 } // namespace
 
@@ -248,9 +253,18 @@ LGMGridSwaptionEngineBuilder::engineImpl(const string& id, const string& key, co
     Size ny = parseInteger(engineParameter("ny"));
     Real sx = parseReal(engineParameter("sx"));
     Size nx = parseInteger(engineParameter("nx"));
+    std::string rollback = engineParameter("Rollback", {}, false, "Convolution");
 
     // Build engine
     DLOG("Build engine (configuration " << configuration(MarketContext::pricing) << ")");
+    QuantLib::ext::shared_ptr<QuantExt::LgmBackwardSolver> solver;
+    if (rollback == "Convolution")
+        solver = QuantLib::ext::make_shared<QuantExt::LgmConvolutionSolver2>(lgm, sy, ny, sx, nx);
+    else if (rollback == "FFT")
+        solver = QuantLib::ext::make_shared<QuantExt::LgmFftSolver>(lgm, sy, sx, nx);
+    else
+        QL_FAIL("LGMGridSwaptionEngineBuilder: engine parameter Rollback '" << rollback
+                                                                           << "' not recognised, expected Convolution, FFT");
     QuantLib::ext::shared_ptr<IborIndex> index;
     std::string ccy = tryParseIborIndex(key, index) ? index->currency().code() : key;
     Handle<YieldTermStructure> yts =
@@ -260,7 +274,7 @@ LGMGridSwaptionEngineBuilder::engineImpl(const string& id, const string& key, co
         yts = Handle<YieldTermStructure>(QuantLib::ext::make_shared<ZeroSpreadedTermStructure>(
             yts, market_->securitySpread(securitySpread, configuration(MarketContext::pricing))));
     return QuantLib::ext::make_shared<QuantExt::NumericLgmMultiLegOptionEngine>(
-        lgm, sy, ny, sx, nx, yts, isAmerican ? parseInteger(modelParameter("ExerciseTimeStepsPerYear")) : 0);
+        solver, yts, isAmerican ? parseInteger(modelParameter("ExerciseTimeStepsPerYear")) : 0);
 }
 
 QuantLib::ext::shared_ptr<PricingEngine>
@@ -36,6 +36,7 @@
 #include <ql/shared_ptr.hpp>
 
 #include <map>
+#include <mutex>
 #include <set>
 #include <vector>
 
@@ -124,6 +125,13 @@ public:
     //! reset the builder (e.g. clear cache)
     virtual void reset() {}
 
+    //! Engine cache statistics, see CachingEngineBuilder
+    struct CacheStatistics {
+        QuantLib::Size hits = 0, misses = 0, size = 0;
+    };
+    //! Return the engine cache statistics, all zero for builders without a cache
+    virtual CacheStatistics cacheStatistics() const { return CacheStatistics(); }
+
     //! Initialise this Builder with the market and parameters to use
     /*! This method should not be called directly, it is called by the EngineFactory
      *  before it is returned.
@@ -131,6 +139,7 @@ public:
     void init(const QuantLib::ext::shared_ptr<Market> market, const map<MarketContext, string>& configurations,
               const map<string, string>& modelParameters, const map<string, string>& engineParameters,
               const std::map<std::string, std::string>& globalParameters = {}) {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
         market_ = market;
         configurations_ = configurations;
         modelParameters_ = modelParameters;
@@ -158,6 +167,8 @@ protected:
     map<string, string> engineParameters_;
     std::map<std::string, std::string> globalParameters_;
     set<std::pair<string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>> modelBuilders_;
+    // guards the initialisation and the engine caches of derived builders, see Portfolio::build()
+    mutable std::recursive_mutex mutex_;
 };
 
 //! Delegating Engine Builder
@@ -290,6 +301,11 @@ public:
     //! return model builders
     set<std::pair<string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>> modelBuilders() const;
 
+    //! return the engine builders keyed by model, engine and trade types
+    const map<tuple<string, string, set<string>>, QuantLib::ext::shared_ptr<EngineBuilder>>& builders() const {
+        return builders_;
+    }
+
 private:
     QuantLib::ext::shared_ptr<Market> market_;
     QuantLib::ext::shared_ptr<EngineData> engineData_;
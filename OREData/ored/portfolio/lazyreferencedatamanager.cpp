@@ -0,0 +1,123 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/portfolio/lazyreferencedatamanager.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/xmlstreamreader.hpp>
+
+#include <fstream>
+
+using QuantLib::Size;
+
+namespace ore {
+namespace data {
+
+void LazyReferenceDataManager::appendData(const string& filename) {
+    LOG("LazyReferenceDataManager: indexing reference data file " << filename);
+    std::lock_guard<std::mutex> lock(mutex_);
+    XMLStreamReader reader(filename, "ReferenceDatum");
+    Size fileIndex = files_.size();
+    files_.push_back(filename);
+    std::string element;
+    Size count = 0;
+    while (reader.next(element)) {
+        QL_REQUIRE(reader.rootName() == "ReferenceData",
+                   "LazyReferenceDataManager: expected root element ReferenceData, got " << reader.rootName());
+        // only the type and id are read here, the datum itself is built on demand
+        XMLDocument doc;
+        doc.fromXMLString(element);
+        XMLNode* node = doc.getFirstNode("ReferenceDatum");
+        string type = XMLUtils::getChildValue(node, "Type", false);
+        string id = XMLUtils::getAttribute(node, "id");
+        if (type.empty()) {
+            ALOG("Found referenceDatum without Type - skipping");
+            continue;
+        }
+        if (id.empty()) {
+            ALOG("Found referenceDatum without id - skipping");
+            continue;
+        }
+        index_[std::make_pair(type, id)].push_back({fileIndex, reader.offset(), element.size()});
+        ++count;
+    }
+    LOG("LazyReferenceDataManager: indexed " << count << " reference data entries in file " << filename);
+}
+
+void LazyReferenceDataManager::load(const std::pair<string, string>& key) {
+    auto it = index_.find(key);
+    if (it == index_.end())
+        return;
+    // the entries are processed in file order, so that duplicates are detected as in the BasicReferenceDataManager
+    std::vector<Entry> entries;
+    entries.swap(it->second);
+    index_.erase(it);
+    std::ifstream file;
+    Size openFile = files_.size();
+    std::string element;
+    for (auto const& e : entries) {
+        if (e.file != openFile) {
+            file.close();
+            file.open(files_[e.file], std::ios::in | std::ios::binary);
+            QL_REQUIRE(file.is_open(), "LazyReferenceDataManager: error opening file '" << files_[e.file] << "'");
+            openFile = e.file;
+        }
+        element.resize(e.length);
+        file.seekg(e.offset);
+        file.read(&element[0], e.length);
+        QL_REQUIRE(file && static_cast<Size>(file.gcount()) == e.length,
+                   "LazyReferenceDataManager: error reading reference data for type='"
+                       << key.first << "', id='" << key.second << "' from file '" << files_[e.file] << "'");
+        XMLDocument doc;
+        doc.fromXMLString(element);
+        addFromXMLNode(doc.getFirstNode("ReferenceDatum"));
+    }
+}
+
+void LazyReferenceDataManager::loadAll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!index_.empty())
+        load(index_.begin()->first);
+}
+
+Size LazyReferenceDataManager::pendingSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+}
+
+bool LazyReferenceDataManager::hasData(const string& type, const string& id, const QuantLib::Date& asof) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    load(std::make_pair(type, id));
+    return BasicReferenceDataManager::hasData(type, id, asof);
+}
+
+QuantLib::ext::shared_ptr<ReferenceDatum> LazyReferenceDataManager::getData(const string& type, const string& id,
+                                                                            const QuantLib::Date& asof) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    load(std::make_pair(type, id));
+    return BasicReferenceDataManager::getData(type, id, asof);
+}
+
+void LazyReferenceDataManager::add(const QuantLib::ext::shared_ptr<ReferenceDatum>& referenceDatum) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // load the indexed entries first, so that the added datum overwrites them as in the BasicReferenceDataManager
+    load(std::make_pair(referenceDatum->type(), referenceDatum->id()));
+    BasicReferenceDataManager::add(referenceDatum);
+}
+
+} // namespace data
+} // namespace ore
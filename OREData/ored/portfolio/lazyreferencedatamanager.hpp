@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file portfolio/lazyreferencedatamanager.hpp
+    \brief reference data manager parsing the reference data on demand
+    \ingroup tradedata
+*/
+
+#pragma once
+
+#include <ored/portfolio/referencedata.hpp>
+
+#include <mutex>
+
+namespace ore {
+namespace data {
+
+//! Reference data manager parsing the reference data on demand
+/*! On construction the reference data files are scanned once to build an index from the type and id of each
+    ReferenceDatum to its position in the file, the reference data is not built. The first call to hasData() or
+    getData() for a type and id parses and builds all entries with this type and id and caches them, so that only
+    the reference data actually used is held in memory. Duplicates and build errors are treated as in the
+    BasicReferenceDataManager.
+
+    The files must not be modified while the manager is in use. toXML() writes the reference data loaded so far,
+    call loadAll() before to write all reference data.
+
+    \ingroup tradedata
+*/
+class LazyReferenceDataManager : public BasicReferenceDataManager {
+public:
+    LazyReferenceDataManager() {}
+    explicit LazyReferenceDataManager(const string& filename) { appendData(filename); }
+
+    //! Index the reference data in the given file, in addition to the files indexed so far
+    void appendData(const string& filename);
+
+    //! Parse and build all indexed reference data that is not loaded yet
+    void loadAll();
+
+    //! Number of (type, id) pairs indexed, but not loaded yet
+    QuantLib::Size pendingSize() const;
+
+    bool hasData(const string& type, const string& id,
+                 const QuantLib::Date& asof = QuantLib::Null<QuantLib::Date>()) override;
+    QuantLib::ext::shared_ptr<ReferenceDatum> getData(const string& type, const string& id,
+                                                      const QuantLib::Date& asof = QuantLib::Null<QuantLib::Date>()) override;
+    void add(const QuantLib::ext::shared_ptr<ReferenceDatum>& referenceDatum) override;
+
+private:
+    struct Entry {
+        QuantLib::Size file, offset, length;
+    };
+    // parse and build the entries for type and id if not loaded yet, the mutex must be held by the caller
+    void load(const std::pair<string, string>& key);
+
+    std::vector<string> files_;
+    // the entries per type and id, in file order, removed once loaded
+    map<std::pair<string, string>, std::vector<Entry>> index_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace data
+} // namespace ore
@@ -16,6 +16,7 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <ored/marketdata/fixings.hpp>
 #include <ored/portfolio/failedtrade.hpp>
 #include <ored/portfolio/fxforward.hpp>
 #include <ored/portfolio/portfolio.hpp>
@@ -23,11 +24,24 @@
 #include <ored/portfolio/structuredtradewarning.hpp>
 #include <ored/portfolio/swap.hpp>
 #include <ored/portfolio/swaption.hpp>
+#include <ored/utilities/binaryxml.hpp>
 #include <ored/utilities/log.hpp>
+#include <ored/utilities/timers.hpp>
+#include <ored/utilities/xmlstreamreader.hpp>
 #include <ored/utilities/xmlutils.hpp>
 #include <ql/errors.hpp>
+#include <ql/settings.hpp>
 #include <ql/time/date.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+
 using namespace QuantLib;
 using namespace std;
 
@@ -39,61 +53,138 @@ using namespace data;
 void Portfolio::clear() {
     trades_.clear();
     underlyingIndicesCache_.clear();
+    invalidateIndices();
 }
 
 void Portfolio::reset() {
     LOG("Reset portfolio of size " << trades_.size());
     for (auto [id, t] : trades_)
         t->reset();
+    invalidateIndices();
 }
 
 void Portfolio::fromXML(XMLNode* node) {
     XMLUtils::checkNode(node, "Portfolio");
     vector<XMLNode*> nodes = XMLUtils::getChildrenNodes(node, "Trade");
-    for (Size i = 0; i < nodes.size(); i++) {
-        string tradeType = XMLUtils::getChildValue(nodes[i], "TradeType", true);
-
-        // Get the id attribute
-        string id = XMLUtils::getAttribute(nodes[i], "id");
-        QL_REQUIRE(id != "", "No id attribute in Trade Node");
-        DLOG("Parsing trade id:" << id);
-        
+    for (Size i = 0; i < nodes.size(); i++)
+        loadTrade(nodes[i]);
+    LOG("Finished Parsing XML doc");
+}
+
+void Portfolio::fromFileStreaming(const std::string& filename,
+                                  const std::function<void(const QuantLib::ext::shared_ptr<Trade>&)>& onTrade) {
+    LOG("Streaming portfolio from file " << filename);
+    XMLStreamReader reader(filename, "Trade");
+    std::string tradeXml;
+    Size count = 0;
+    while (reader.next(tradeXml)) {
+        QL_REQUIRE(reader.rootName() == "Portfolio",
+                   "Portfolio::fromFileStreaming(): expected root element Portfolio, got " << reader.rootName());
         QuantLib::ext::shared_ptr<Trade> trade;
-        bool failedToLoad = true;
-        try {
-            trade = TradeFactory::instance().build(tradeType);
-            trade->fromXML(nodes[i]);
-            trade->id() = id;
-            add(trade);
-            DLOG("Added Trade " << id << " (" << trade->id() << ")"
-                                << " type:" << tradeType);
-            failedToLoad = false;
-        } catch (std::exception& ex) {
-            StructuredTradeErrorMessage(id, tradeType, "Error parsing Trade XML", ex.what()).log();
+        {
+            XMLDocument doc;
+            doc.fromXMLString(tradeXml);
+            trade = loadTrade(doc.getFirstNode("Trade"));
         }
+        ++count;
+        if (trade && onTrade)
+            onTrade(trade);
+    }
+    LOG("Finished streaming " << count << " trades from file " << filename);
+}
 
-        // If trade loading failed, then insert a dummy trade with same id and envelope
-        if (failedToLoad && buildFailedTrades_) {
-            try {
-                trade = TradeFactory::instance().build("Failed");
-                // this loads only type, id and envelope, but type will be set to the original trade's type
-                trade->fromXML(nodes[i]);
-                // create a dummy trade of type "Dummy"
-                QuantLib::ext::shared_ptr<FailedTrade> failedTrade = QuantLib::ext::make_shared<FailedTrade>();
-                // copy id and envelope
-                failedTrade->id() = id;
-                failedTrade->setUnderlyingTradeType(tradeType);
-                failedTrade->setEnvelope(trade->envelope());
-                // and add it to the portfolio
-                add(failedTrade);
-                WLOG("Added trade id " << failedTrade->id() << " type " << failedTrade->tradeType()
-                                       << " for original trade type " << trade->tradeType());
-            } catch (std::exception& ex) {
-                StructuredTradeErrorMessage(id, tradeType, "Error parsing type and envelope", ex.what()).log();
-            }
+namespace {
+const char binaryPortfolioMagic[8] = {'O', 'R', 'E', 'P', 'T', 'F', 'B', '\0'};
+const std::uint32_t binaryPortfolioVersion = 1;
+} // namespace
+
+std::string Portfolio::toBinaryString() const {
+    BinaryXMLWriter writer;
+    for (auto const& [id, t] : trades_) {
+        XMLDocument doc;
+        writer.write(t->toXML(doc));
+    }
+    std::string data(binaryPortfolioMagic, sizeof(binaryPortfolioMagic));
+    data.append(reinterpret_cast<const char*>(&binaryPortfolioVersion), sizeof(binaryPortfolioVersion));
+    data.append(writer.data());
+    return data;
+}
+
+void Portfolio::fromBinaryString(const std::string& data) {
+    Size headerSize = sizeof(binaryPortfolioMagic) + sizeof(binaryPortfolioVersion);
+    QL_REQUIRE(data.size() >= headerSize &&
+                   std::memcmp(data.data(), binaryPortfolioMagic, sizeof(binaryPortfolioMagic)) == 0,
+               "Portfolio::fromBinaryString(): data is not a binary portfolio");
+    std::uint32_t version;
+    std::memcpy(&version, data.data() + sizeof(binaryPortfolioMagic), sizeof(version));
+    QL_REQUIRE(version == binaryPortfolioVersion, "Portfolio::fromBinaryString(): unsupported version "
+                                                      << version << ", expected " << binaryPortfolioVersion);
+    BinaryXMLReader reader(data.data() + headerSize, data.size() - headerSize);
+    while (!reader.atEnd()) {
+        XMLDocument doc;
+        loadTrade(reader.read(doc));
+    }
+    LOG("Finished loading binary portfolio");
+}
+
+void Portfolio::toBinaryFile(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::out | std::ios::binary);
+    QL_REQUIRE(file.is_open(), "Portfolio::toBinaryFile(): error opening file " << filename);
+    std::string data = toBinaryString();
+    file.write(data.data(), data.size());
+    QL_REQUIRE(file.good(), "Portfolio::toBinaryFile(): error writing file " << filename);
+}
+
+void Portfolio::fromBinaryFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    QL_REQUIRE(file.is_open(), "Portfolio::fromBinaryFile(): error opening file " << filename);
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    fromBinaryString(data);
+}
+
+QuantLib::ext::shared_ptr<Trade> Portfolio::loadTrade(XMLNode* node) {
+    string tradeType = XMLUtils::getChildValue(node, "TradeType", true);
+
+    // Get the id attribute
+    string id = XMLUtils::getAttribute(node, "id");
+    QL_REQUIRE(id != "", "No id attribute in Trade Node");
+    DLOG("Parsing trade id:" << id);
+
+    QuantLib::ext::shared_ptr<Trade> trade;
+    try {
+        trade = TradeFactory::instance().build(tradeType);
+        trade->fromXML(node);
+        trade->id() = id;
+        add(trade);
+        DLOG("Added Trade " << id << " (" << trade->id() << ")"
+                            << " type:" << tradeType);
+        return trade;
+    } catch (std::exception& ex) {
+        StructuredTradeErrorMessage(id, tradeType, "Error parsing Trade XML", ex.what()).log();
+    }
+
+    // If trade loading failed, then insert a dummy trade with same id and envelope
+    if (buildFailedTrades_) {
+        try {
+            trade = TradeFactory::instance().build("Failed");
+            // this loads only type, id and envelope, but type will be set to the original trade's type
+            trade->fromXML(node);
+            // create a dummy trade of type "Dummy"
+            QuantLib::ext::shared_ptr<FailedTrade> failedTrade = QuantLib::ext::make_shared<FailedTrade>();
+            // copy id and envelope
+            failedTrade->id() = id;
+            failedTrade->setUnderlyingTradeType(tradeType);
+            failedTrade->setEnvelope(trade->envelope());
+            // and add it to the portfolio
+            add(failedTrade);
+            WLOG("Added trade id " << failedTrade->id() << " type " << failedTrade->tradeType()
+                                   << " for original trade type " << trade->tradeType());
+            return failedTrade;
+        } catch (std::exception& ex) {
+            StructuredTradeErrorMessage(id, tradeType, "Error parsing type and envelope", ex.what()).log();
         }
     }
-    LOG("Finished Parsing XML doc");
+    return nullptr;
 }
 
 XMLNode* Portfolio::toXML(XMLDocument& doc) const {
@@ -105,29 +196,91 @@ XMLNode* Portfolio::toXML(XMLDocument& doc) const {
 
 bool Portfolio::remove(const std::string& tradeID) {
     underlyingIndicesCache_.clear();
+    invalidateIndices();
     return trades_.erase(tradeID) > 0;
 }
 
 void Portfolio::removeMatured(const Date& asof) {
-    for (auto it = trades_.begin(); it != trades_.end(); /* manual */) {
-        if ((*it).second->isExpired(asof)) {
-            StructuredTradeWarningMessage((*it).second, "", "Trade is Matured").log();
-            it=trades_.erase(it);
-        } else {
-            ++it;
+    // only trades maturing on or before asof can be expired, check these in the order of their ids
+    const auto& maturities = indices().maturities;
+    std::set<std::string> candidates;
+    for (auto m = maturities.begin(); m != maturities.end() && m->first <= asof; ++m)
+        candidates.insert(m->second);
+    bool removed = false;
+    for (auto const& id : candidates) {
+        auto it = trades_.find(id);
+        if (it->second->isExpired(asof)) {
+            StructuredTradeWarningMessage(it->second, "", "Trade is Matured").log();
+            trades_.erase(it);
+            removed = true;
         }
     }
+    if (removed)
+        invalidateIndices();
 }
 
 void Portfolio::build(const QuantLib::ext::shared_ptr<EngineFactory>& engineFactory, const std::string& context,
-                      const bool emitStructuredError) {
+                      const bool emitStructuredError, const Size nThreads) {
     LOG("Building Portfolio of size " << trades_.size() << " for context = '" << context << "'");
+    ORE_TIMER("portfolio build");
+    ORE_COUNTER("trades", static_cast<double>(trades_.size()));
+
+    // build the trades, concurrently if several threads are requested and supported
+
+    std::vector<std::pair<QuantLib::ext::shared_ptr<Trade>, bool>> results(trades_.size());
+    Size nWorkers = std::min(nThreads, trades_.size());
+#ifndef QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN
+    if (nWorkers > 1) {
+        WLOG("Portfolio::build(): parallel build with " << nThreads
+                                                        << " threads requires a QuantLib build with "
+                                                           "QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN = ON, building "
+                                                           "the trades sequentially.");
+        nWorkers = 1;
+    }
+#endif
+    std::vector<QuantLib::ext::shared_ptr<Trade>*> tradesToBuild;
+    for (auto& t : trades_)
+        tradesToBuild.push_back(&t.second);
+    if (nWorkers > 1) {
+        LOG("Building trades with " << nWorkers << " threads");
+#ifdef QL_ENABLE_SESSIONS
+        // the singletons are thread local, copy the settings and fixings of this thread to the workers
+        Date evaluationDate = Settings::instance().evaluationDate();
+        bool includeReferenceDateEvents = Settings::instance().includeReferenceDateEvents();
+        auto includeTodaysCashFlows = Settings::instance().includeTodaysCashFlows();
+        bool enforcesTodaysHistoricFixings = Settings::instance().enforcesTodaysHistoricFixings();
+        FixingHistories fixingHistories = getFixingHistories();
+#endif
+        std::atomic<Size> next(0);
+        std::vector<std::thread> workers;
+        for (Size i = 0; i < nWorkers; ++i) {
+            workers.emplace_back([&]() {
+#ifdef QL_ENABLE_SESSIONS
+                Settings::instance().evaluationDate() = evaluationDate;
+                Settings::instance().includeReferenceDateEvents() = includeReferenceDateEvents;
+                Settings::instance().includeTodaysCashFlows() = includeTodaysCashFlows;
+                Settings::instance().enforcesTodaysHistoricFixings() = enforcesTodaysHistoricFixings;
+                applyFixingHistories(fixingHistories);
+#endif
+                for (Size k = next++; k < tradesToBuild.size(); k = next++)
+                    results[k] = buildTrade(*tradesToBuild[k], engineFactory, context, ignoreTradeBuildFail(),
+                                            buildFailedTrades(), emitStructuredError);
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+    } else {
+        for (Size k = 0; k < tradesToBuild.size(); ++k)
+            results[k] = buildTrade(*tradesToBuild[k], engineFactory, context, ignoreTradeBuildFail(),
+                                    buildFailedTrades(), emitStructuredError);
+    }
+
+    // replace or remove the trades that failed to build
+
     auto trade = trades_.begin();
     Size initialSize = trades_.size();
     Size failedTrades = 0;
-    while (trade != trades_.end()) {
-        auto [ft, success] = buildTrade((*trade).second, engineFactory, context, ignoreTradeBuildFail(),
-                                        buildFailedTrades(), emitStructuredError);
+    for (auto const& [ft, success] : results) {
         if (success) {
             ++trade;
         } else if (ft) {
@@ -138,54 +291,71 @@ void Portfolio::build(const QuantLib::ext::shared_ptr<EngineFactory>& engineFact
             trade = trades_.erase(trade);
         }
     }
+    invalidateIndices();
     LOG("Built Portfolio. Initial size = " << initialSize << ", size now " << trades_.size() << ", built "
                                            << failedTrades << " failed trades, context is " + context);
 
     QL_REQUIRE(trades_.size() > 0, "Portfolio does not contain any built trades, context is '" + context + "'");
 }
 
+const Portfolio::Indices& Portfolio::indices() const {
+    auto indices = std::atomic_load(&indices_);
+    if (indices)
+        return *indices;
+    auto tmp = std::make_shared<Indices>();
+    tmp->maturity = Date::minDate();
+    tmp->maturities.reserve(trades_.size());
+    for (const auto& [tradeId, trade] : trades_) {
+        const Envelope& env = trade->envelope();
+        tmp->maturity = std::max(tmp->maturity, trade->maturity());
+        tmp->maturities.emplace_back(trade->maturity(), tradeId);
+        tmp->ids.insert(tmp->ids.end(), tradeId);
+        tmp->nettingSetMap.emplace_hint(tmp->nettingSetMap.end(), tradeId, env.nettingSetId());
+        tmp->counterparties.insert(env.counterparty());
+        tmp->counterpartyNettingSets[env.counterparty()].insert(env.nettingSetId());
+        tmp->nettingSetTrades[env.nettingSetId()].insert(tradeId);
+        tmp->counterpartyTrades[env.counterparty()].insert(tradeId);
+        tmp->portfolioIds.insert(trade->portfolioIds().begin(), trade->portfolioIds().end());
+    }
+    std::sort(tmp->maturities.begin(), tmp->maturities.end());
+    /* threads building the indices concurrently race to publish them, the losers return the published indices, so
+       that the returned reference is always owned by indices_ and does not dangle when tmp goes out of scope */
+    std::shared_ptr<const Indices> published;
+    if (std::atomic_compare_exchange_strong(&indices_, &published, std::shared_ptr<const Indices>(tmp)))
+        return *tmp;
+    return *published;
+}
+
+void Portfolio::invalidateIndices() {
+    std::atomic_store(&indices_, std::shared_ptr<const Indices>());
+    std::atomic_store(&tradeFixings_, std::shared_ptr<const TradeFixings>());
+}
+
 Date Portfolio::maturity() const {
     QL_REQUIRE(trades_.size() > 0, "Cannot get maturity of an empty portfolio");
-    Date mat = Date::minDate();
-    for (const auto& t : trades_)
-        mat = std::max(mat, t.second->maturity());
-    return mat;
+    return indices().maturity;
 }
 
-set<string> Portfolio::ids() const {
-    set<string> ids;
-    for (const auto& [tradeId, _] : trades_)
-        ids.insert(tradeId);
-    return ids;
-}
+const set<string>& Portfolio::ids() const { return indices().ids; }
 
 const std::map<std::string, QuantLib::ext::shared_ptr<Trade>>& Portfolio::trades() const { return trades_; }
 
-map<string, string> Portfolio::nettingSetMap() const {
-    map<string, string> nettingSetMap;
-    for (const auto& t : trades_)
-        nettingSetMap[t.second->id()] = t.second->envelope().nettingSetId();
-    return nettingSetMap;
-}
+const map<string, string>& Portfolio::nettingSetMap() const { return indices().nettingSetMap; }
 
-std::set<std::string> Portfolio::counterparties() const {
-    set<string> counterparties;
-    for (const auto& t : trades_)
-        counterparties.insert(t.second->envelope().counterparty());
-    return counterparties;
-}
+const std::set<std::string>& Portfolio::counterparties() const { return indices().counterparties; }
 
-map<string, set<string>> Portfolio::counterpartyNettingSets() const {
-    map<string, set<string>> cpNettingSets;
-    for (const auto& [tradeId, trade] : trades()) {
-        cpNettingSets[trade->envelope().counterparty()].insert(trade->envelope().nettingSetId());
-    }
-    return cpNettingSets;
+const map<string, set<string>>& Portfolio::counterpartyNettingSets() const {
+    return indices().counterpartyNettingSets;
 }
 
+const map<string, set<string>>& Portfolio::nettingSetTrades() const { return indices().nettingSetTrades; }
+
+const map<string, set<string>>& Portfolio::counterpartyTrades() const { return indices().counterpartyTrades; }
+
 void Portfolio::add(const QuantLib::ext::shared_ptr<Trade>& trade) {
     QL_REQUIRE(!has(trade->id()), "Attempted to add a trade to the portfolio with an id, which already exists.");
     underlyingIndicesCache_.clear();
+    invalidateIndices();
     trades_[trade->id()] = trade;
 }
 
@@ -199,13 +369,7 @@ QuantLib::ext::shared_ptr<Trade> Portfolio::get(const string& id) const {
         return nullptr;
 }
 
-std::set<std::string> Portfolio::portfolioIds() const {
-    std::set<std::string> portfolioIds;
-    for (const auto& [tradeId, trade] : trades()) {
-        portfolioIds.insert(trade->portfolioIds().begin(), trade->portfolioIds().end());
-    }
-    return portfolioIds;
-}
+const std::set<std::string>& Portfolio::portfolioIds() const { return indices().portfolioIds; }
 
 bool Portfolio::hasNettingSetDetails() const {
     bool hasNettingSetDetails = false;
@@ -217,11 +381,77 @@ bool Portfolio::hasNettingSetDetails() const {
     return hasNettingSetDetails;
 }
 
-map<string, RequiredFixings::FixingDates> Portfolio::fixings(const Date& settlementDate) const {
+std::shared_ptr<const map<string, map<string, RequiredFixings::FixingDates>>>
+Portfolio::tradeFixings(const Date& settlementDate, const Size nThreads) const {
+
+    // the settlement date defaults to the evaluation date of the calling thread
+
+    Date d = settlementDate == Date() ? Settings::instance().evaluationDate() : settlementDate;
+    auto cached = std::atomic_load(&tradeFixings_);
+    if (cached && cached->settlementDate == d)
+        return cached->fixings;
+
+    // the trades are not modified, so that they can be processed concurrently
+
+    std::vector<const Trade*> trades;
+    for (const auto& [id, t] : trades_)
+        trades.push_back(t.get());
+    std::vector<map<string, RequiredFixings::FixingDates>> results(trades.size());
+    Size nWorkers = std::min(nThreads, trades.size());
+    if (nWorkers > 1) {
+        DLOG("Portfolio::tradeFixings(): collecting fixings of " << trades.size() << " trades with " << nWorkers
+                                                                << " threads");
+#ifdef QL_ENABLE_SESSIONS
+        bool includeReferenceDateEvents = Settings::instance().includeReferenceDateEvents();
+        auto includeTodaysCashFlows = Settings::instance().includeTodaysCashFlows();
+#endif
+        std::atomic<Size> next(0);
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        std::vector<std::thread> workers;
+        for (Size i = 0; i < nWorkers; ++i) {
+            workers.emplace_back([&]() {
+#ifdef QL_ENABLE_SESSIONS
+                Settings::instance().evaluationDate() = d;
+                Settings::instance().includeReferenceDateEvents() = includeReferenceDateEvents;
+                Settings::instance().includeTodaysCashFlows() = includeTodaysCashFlows;
+#endif
+                try {
+                    for (Size k = next++; k < trades.size(); k = next++)
+                        results[k] = trades[k]->fixings(d);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error)
+                        error = std::current_exception();
+                    next = trades.size();
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        if (error)
+            std::rethrow_exception(error);
+    } else {
+        for (Size k = 0; k < trades.size(); ++k)
+            results[k] = trades[k]->fixings(d);
+    }
+
+    auto fixings = std::make_shared<map<string, map<string, RequiredFixings::FixingDates>>>();
+    Size k = 0;
+    for (const auto& [id, t] : trades_)
+        fixings->emplace_hint(fixings->end(), id, std::move(results[k++]));
+    auto tmp = std::make_shared<TradeFixings>();
+    tmp->settlementDate = d;
+    tmp->fixings = fixings;
+    std::atomic_store(&tradeFixings_, std::shared_ptr<const TradeFixings>(tmp));
+    return fixings;
+}
+
+map<string, RequiredFixings::FixingDates> Portfolio::fixings(const Date& settlementDate, const Size nThreads) const {
     map<string, RequiredFixings::FixingDates> result;
-    for (const auto& t : trades_) {
-        auto fixings = t.second->fixings(settlementDate);
-        for (const auto& [index, fixingDates] : fixings) {
+    auto fixings = tradeFixings(settlementDate, nThreads);
+    for (const auto& [tradeId, f] : *fixings) {
+        for (const auto& [index, fixingDates] : f) {
             if (!fixingDates.empty()) {
                 result[index].addDates(fixingDates);
             }
@@ -29,6 +29,8 @@
 #include <ored/portfolio/tradefactory.hpp>
 #include <ql/time/date.hpp>
 #include <ql/types.hpp>
+#include <functional>
+#include <memory>
 #include <vector>
 
 namespace ore {
@@ -73,15 +75,45 @@ public:
     void fromXML(XMLNode* node) override;
     XMLNode* toXML(XMLDocument& doc) const override;
 
+    //! Load the trades from a portfolio file one trade at a time
+    /*! In contrast to fromFile() the file is not parsed into a single document. The Trade elements are read one at a
+        time by an XMLStreamReader, parsed, loaded and released again, so that the memory used for the xml is bounded
+        by the size of the largest trade. Each loaded trade is passed to \p onTrade if given, e.g. to hand it over to
+        a build queue while the file is still being read. */
+    void fromFileStreaming(const std::string& filename,
+                           const std::function<void(const QuantLib::ext::shared_ptr<Trade>&)>& onTrade = {});
+
+    //! Serialise the trades into a compact binary form of their xml representation, see BinaryXMLWriter
+    /*! Loading the trades from the binary form skips the xml text parsing, e.g. to reload a cached portfolio or to
+        hand sub-portfolios to worker threads. The trades themselves are loaded via Trade::fromXML() as usual. */
+    std::string toBinaryString() const;
+    //! Load the trades from a binary form written by toBinaryString()
+    void fromBinaryString(const std::string& data);
+    //! Write the binary form to a file
+    void toBinaryFile(const std::string& filename) const;
+    //! Load the trades from a file written by toBinaryFile()
+    void fromBinaryFile(const std::string& filename);
+
     //! Remove specified trade from the portfolio
     bool remove(const std::string& tradeID);
 
     //! Remove matured trades from portfolio for a given date, each removal is logged with an Alert
+    /*! Only trades with a maturity on or before \p asof are checked via Trade::isExpired(), overrides of
+        isExpired() must not report trades with a later maturity as expired */
     void removeMatured(const QuantLib::Date& asof);
 
     //! Call build on all trades in the portfolio, the context is included in error messages
+    /*! If \p nThreads is greater than one, the trades are built concurrently by \p nThreads worker threads sharing
+        the engine factory and its market. The engine caches of the CachingEngineBuilders and the builder
+        initialisation are synchronised. If QuantLib is built with sessions, the evaluation date and the fixings of
+        the calling thread are copied to the worker threads.
+
+        This requires a QuantLib build with QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN = ON, since the trades register
+        with the shared market objects, otherwise the trades are built sequentially. The market objects should be
+        built upfront, i.e. not lazily, since the market lookups are not synchronised. Engine builders that do not
+        derive from CachingEngineBuilder must synchronise their state themselves. */
     void build(const QuantLib::ext::shared_ptr<EngineFactory>&, const std::string& context = "unspecified",
-               const bool emitStructuredError = true);
+               const bool emitStructuredError = true, const QuantLib::Size nThreads = 1);
 
     //! Calculates the maturity of the portfolio
     QuantLib::Date maturity() const;
@@ -89,20 +121,40 @@ public:
     //! Return the map tradeId -> trade
     const std::map<std::string, QuantLib::ext::shared_ptr<Trade>>& trades() const;
 
-    //! Build a set of tradeIds
-    std::set<std::string> ids() const;
+    /*! \name Trade indices
+        The indices are built on first use and kept until trades are added, removed or built, so that repeated
+        queries do not scan the portfolio. If trade data (e.g. the envelope) is modified in place, call
+        invalidateIndices().
+
+        The returned references point into the indices and are invalidated by add(), remove(), removeMatured(),
+        build(), clear(), reset() and invalidateIndices(), i.e. they must not be held across modifications of the
+        portfolio. Concurrent queries on a portfolio that is not modified are safe.
+    */
+    //@{
+    //! The set of tradeIds
+    const std::set<std::string>& ids() const;
+
+    //! The map from trade Ids to NettingSet
+    const std::map<std::string, std::string>& nettingSetMap() const;
+
+    //! The set of all counterparties in the portfolio
+    const std::set<std::string>& counterparties() const;
 
-    //! Build a map from trade Ids to NettingSet
-    std::map<std::string, std::string> nettingSetMap() const;
+    //! The map from counterparty to NettingSet
+    const std::map<std::string, std::set<std::string>>& counterpartyNettingSets() const;
 
-    //! Build a set of all counterparties in the portfolio
-    std::set<std::string> counterparties() const;
+    //! The map from NettingSet to trade Ids
+    const std::map<std::string, std::set<std::string>>& nettingSetTrades() const;
 
-    //! Build a map from counterparty to NettingSet
-    std::map<std::string, std::set<std::string>> counterpartyNettingSets() const;
+    //! The map from counterparty to trade Ids
+    const std::map<std::string, std::set<std::string>>& counterpartyTrades() const;
 
-    //! Compute set of portfolios
-    std::set<std::string> portfolioIds() const;
+    //! The set of portfolios
+    const std::set<std::string>& portfolioIds() const;
+
+    //! Discard the indices and the cached trade fixings, they are rebuilt on next use
+    void invalidateIndices();
+    //@}
 
     //! Check if at least one trade in the portfolio uses the NettingSetDetails node, and not just NettingSetId
     bool hasNettingSetDetails() const;
@@ -116,10 +168,17 @@ public:
     /*! Return the fixings that will be requested in order to price every Trade in this Portfolio given
         the \p settlementDate. The map key is the ORE name of the index and the map value is the set of fixing dates.
 
+        The fixings of the trades are computed by \p nThreads threads and cached per trade for the last requested
+        settlement date until trades are added, removed or built, see tradeFixings().
+
         \warning This method will return an empty map if the Portfolio has not been built.
     */
     std::map<std::string, RequiredFixings::FixingDates>
-    fixings(const QuantLib::Date& settlementDate = QuantLib::Date()) const;
+    fixings(const QuantLib::Date& settlementDate = QuantLib::Date(), const QuantLib::Size nThreads = 1) const;
+
+    //! The map tradeId -> Trade::fixings() for the given settlement date, cached as described in fixings()
+    std::shared_ptr<const std::map<std::string, std::map<std::string, RequiredFixings::FixingDates>>>
+    tradeFixings(const QuantLib::Date& settlementDate = QuantLib::Date(), const QuantLib::Size nThreads = 1) const;
 
     /*! Returns the names of the underlying instruments for each asset class */
     std::map<AssetClass, std::set<std::string>>
@@ -129,9 +188,30 @@ public:
                       const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceDataManager = nullptr);
 
 private:
+    // load a trade from its xml node and add it to the portfolio, returns the added trade or nullptr
+    QuantLib::ext::shared_ptr<Trade> loadTrade(XMLNode* node);
+
+    struct Indices {
+        QuantLib::Date maturity;
+        // (maturity, trade id) sorted by maturity
+        std::vector<std::pair<QuantLib::Date, std::string>> maturities;
+        std::set<std::string> ids, counterparties, portfolioIds;
+        std::map<std::string, std::string> nettingSetMap;
+        std::map<std::string, std::set<std::string>> counterpartyNettingSets, nettingSetTrades, counterpartyTrades;
+    };
+    const Indices& indices() const;
+
+    struct TradeFixings {
+        QuantLib::Date settlementDate;
+        std::shared_ptr<const std::map<std::string, std::map<std::string, RequiredFixings::FixingDates>>> fixings;
+    };
+
     bool buildFailedTrades_, ignoreTradeBuildFail_;
     std::map<std::string, QuantLib::ext::shared_ptr<Trade>> trades_;
     std::map<AssetClass, std::set<std::string>> underlyingIndicesCache_;
+    // accessed atomically, so that concurrent queries on a const portfolio are safe
+    mutable std::shared_ptr<const Indices> indices_;
+    mutable std::shared_ptr<const TradeFixings> tradeFixings_;
 };
 
 std::pair<QuantLib::ext::shared_ptr<Trade>, bool> buildTrade(
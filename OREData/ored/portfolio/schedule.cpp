@@ -17,6 +17,7 @@
 */
 
 #include <ored/portfolio/schedule.hpp>
+#include <ored/portfolio/schedulecache.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/parsers.hpp>
 #include <ored/utilities/to_string.hpp>
@@ -333,7 +334,8 @@ Schedule makeSchedule(const ScheduleDerived& data, const Schedule& baseSchedule)
                               endOfMonthConvention);
 }
 
-Schedule makeSchedule(const ScheduleRules& data, const Date& openEndDateReplacement) {
+namespace {
+Schedule buildSchedule(const ScheduleRules& data, const Date& openEndDateReplacement) {
     QL_REQUIRE(!data.endDate().empty() || openEndDateReplacement != Null<Date>(),
                "makeSchedule(): Schedule does not have an end date, this is not supported in this context / for this "
                "trade type. Please provide an end date.");
@@ -426,6 +428,13 @@ Schedule makeSchedule(const ScheduleRules& data, const Date& openEndDateReplacem
     return QuantLib::Schedule(startDate, endDate, tenor, calendar, bdc, bdcEnd, rule, endOfMonth, firstDate, lastDate,
                               data.removeFirstDate(), data.removeLastDate(), endOfMonthConvention);
 }
+} // namespace
+
+Schedule makeSchedule(const ScheduleRules& data, const Date& openEndDateReplacement) {
+    return ScheduleCache::instance().schedule(data, openEndDateReplacement, [&data, &openEndDateReplacement]() {
+        return buildSchedule(data, openEndDateReplacement);
+    });
+}
 
 namespace {
 // helper function used in makeSchedule below
@@ -0,0 +1,93 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/portfolio/schedulecache.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/parsers.hpp>
+
+#include <boost/thread/locks.hpp>
+
+#include <sstream>
+
+namespace ore {
+namespace data {
+
+namespace {
+std::string key(const ScheduleRules& rules, const QuantLib::Date& openEndDateReplacement) {
+    std::ostringstream out;
+    for (auto const& s : {rules.startDate(), rules.endDate(), rules.tenor(), rules.calendar(), rules.convention(),
+                          rules.termConvention(), rules.rule(), rules.endOfMonth(), rules.endOfMonthConvention(),
+                          rules.firstDate(), rules.lastDate()})
+        out << s << '\0';
+    out << rules.removeFirstDate() << rules.removeLastDate() << '\0';
+    out << (openEndDateReplacement == QuantLib::Null<QuantLib::Date>() ? 0 : openEndDateReplacement.serialNumber());
+    QuantLib::Calendar calendar = parseCalendar(rules.calendar());
+    out << '+';
+    for (auto const& d : calendar.addedHolidays())
+        out << d.serialNumber() << ',';
+    out << '-';
+    for (auto const& d : calendar.removedHolidays())
+        out << d.serialNumber() << ',';
+    return out.str();
+}
+} // namespace
+
+QuantLib::Schedule ScheduleCache::schedule(const ScheduleRules& rules, const QuantLib::Date& openEndDateReplacement,
+                                           const std::function<QuantLib::Schedule()>& builder) {
+    if (maxSize() == 0)
+        return builder();
+    std::string k = key(rules, openEndDateReplacement);
+    {
+        boost::shared_lock<boost::shared_mutex> lock(mutex_);
+        if (auto s = schedules_.find(k); s != schedules_.end())
+            return s->second;
+    }
+    QuantLib::Schedule schedule = builder();
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    if (schedules_.size() >= maxSize_) {
+        DLOG("ScheduleCache: maximum size " << maxSize_ << " reached, clear cache");
+        schedules_.clear();
+    }
+    schedules_.emplace(k, schedule);
+    return schedule;
+}
+
+void ScheduleCache::clear() {
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    schedules_.clear();
+}
+
+void ScheduleCache::setMaxSize(const QuantLib::Size maxSize) {
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    maxSize_ = maxSize;
+    if (schedules_.size() > maxSize_)
+        schedules_.clear();
+}
+
+QuantLib::Size ScheduleCache::size() const {
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return schedules_.size();
+}
+
+QuantLib::Size ScheduleCache::maxSize() const {
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return maxSize_;
+}
+
+} // namespace data
+} // namespace ore
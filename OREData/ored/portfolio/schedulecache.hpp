@@ -0,0 +1,69 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/portfolio/schedulecache.hpp
+    \brief process wide cache for schedules generated from schedule rules
+    \ingroup tradedata
+*/
+
+#pragma once
+
+#include <ored/portfolio/schedule.hpp>
+
+#include <ql/patterns/singleton.hpp>
+#include <ql/time/schedule.hpp>
+
+#include <boost/thread/shared_mutex.hpp>
+
+#include <functional>
+#include <unordered_map>
+
+namespace ore {
+namespace data {
+
+/*! Caches the schedules generated from schedule rules, so that trades sharing the same schedule parameters, e.g.
+    the trades of a large swap book that only differ in notionals, rates or counterparties, share one date
+    generation instead of one per trade and leg.
+
+    The key consists of all rule parameters, the open end date replacement and the holidays added to or removed from
+    the schedule calendar, so that calendar adjustments applied after a schedule was cached are taken into account.
+    The cache is cleared when it exceeds the maximum size, a maximum size of zero disables the cache. */
+class ScheduleCache : public QuantLib::Singleton<ScheduleCache, std::integral_constant<bool, true>> {
+public:
+    //! returns the cached schedule for the given rules, or the schedule built by \p builder if not in the cache yet
+    QuantLib::Schedule schedule(const ScheduleRules& rules, const QuantLib::Date& openEndDateReplacement,
+                                const std::function<QuantLib::Schedule()>& builder);
+
+    //! clear the cache
+    void clear();
+
+    //! set the maximum number of cached schedules, zero disables the cache
+    void setMaxSize(const QuantLib::Size maxSize);
+
+    //! inspectors
+    QuantLib::Size size() const;
+    QuantLib::Size maxSize() const;
+
+private:
+    mutable boost::shared_mutex mutex_;
+    QuantLib::Size maxSize_ = 100000;
+    std::unordered_map<std::string, QuantLib::Schedule> schedules_;
+};
+
+} // namespace data
+} // namespace ore
@@ -553,6 +553,14 @@ void ScriptedTradeScriptData::fromXML(XMLNode* node) {
     if (XMLNode* ns = XMLUtils::getChildNode(node, "ConditionalExpectation")) {
         conditionalExpectationModelStates_ = XMLUtils::getChildrenValues(ns, "ModelStates", "ModelState", false);
     }
+    std::vector<std::string> cvValues;
+    std::vector<std::string> cvPayoffs =
+        XMLUtils::getChildrenValuesWithAttributes(node, "ControlVariates", "ControlVariate", "value", cvValues, false);
+    for (Size i = 0; i < cvPayoffs.size(); ++i) {
+        QL_REQUIRE(!cvValues[i].empty(), "ScriptedTradeScriptData::fromXML(): control variate '"
+                                             << cvPayoffs[i] << "' requires a value attribute");
+        controlVariates_.push_back(std::make_pair(cvPayoffs[i], cvValues[i]));
+    }
 }
 
 XMLNode* ScriptedTradeScriptData::toXML(XMLDocument& doc) const {
@@ -580,6 +588,14 @@ XMLNode* ScriptedTradeScriptData::toXML(XMLDocument& doc) const {
     XMLNode* condExp = doc.allocNode("ConditionalExpectation");
     XMLUtils::appendNode(n, condExp);
     XMLUtils::addChildren(doc, condExp, "ModelStates", "ModelState", conditionalExpectationModelStates_);
+    if (!controlVariates_.empty()) {
+        std::vector<std::string> cvPayoffs, cvValues;
+        for (auto const& c : controlVariates_) {
+            cvPayoffs.push_back(c.first);
+            cvValues.push_back(c.second);
+        }
+        XMLUtils::addChildrenWithAttributes(doc, n, "ControlVariates", "ControlVariate", cvPayoffs, "value", cvValues);
+    }
     return n;
 }
 
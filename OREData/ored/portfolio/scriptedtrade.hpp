@@ -143,10 +143,11 @@ public:
                             const std::vector<NewScheduleData>& newSchedules = {},
                             const std::vector<CalibrationData>& calibrationSpec = {},
                             const std::vector<std::string>& stickyCloseOutStates = {},
-                            const std::vector<std::string>& conditionalExpectationModelStates = {})
+                            const std::vector<std::string>& conditionalExpectationModelStates = {},
+                            const std::vector<std::pair<std::string, std::string>>& controlVariates = {})
         : code_(code), npv_(npv), results_(results), schedulesEligibleForCoarsening_(schedulesEligibleForCoarsening),
           newSchedules_(newSchedules), calibrationSpec_(calibrationSpec), stickyCloseOutStates_(stickyCloseOutStates),
-          conditionalExpectationModelStates_(conditionalExpectationModelStates) {
+          conditionalExpectationModelStates_(conditionalExpectationModelStates), controlVariates_(controlVariates) {
         formatCode();
     }
 
@@ -164,6 +165,9 @@ public:
     const std::vector<std::string>& conditionalExpectationModelStates() const {
         return conditionalExpectationModelStates_;
     }
+    /* a control variate is given by a context variable holding the (discounted) companion payoff and its known value,
+       the latter either as a context variable or a number, e.g. ("EuropeanOption", "EuropeanOptionAnalytic") */
+    const std::vector<std::pair<std::string, std::string>>& controlVariates() const { return controlVariates_; }
 
 private:
     void formatCode();
@@ -175,6 +179,7 @@ private:
     std::vector<CalibrationData> calibrationSpec_;
     std::vector<std::string> stickyCloseOutStates_;
     std::vector<std::string> conditionalExpectationModelStates_;
+    std::vector<std::pair<std::string, std::string>> controlVariates_;
 };
 
 class ScriptLibraryData : public XMLSerializable {
@@ -146,6 +146,7 @@ void Trade::reset() {
     requiredFixings_.clear();
     sensitivityTemplate_.clear();
     sensitivityTemplateSet_ = false;
+    pricingEngine_.clear();
 }
     
 const std::map<std::string, boost::any>& Trade::additionalData() const { return additionalData_; }
@@ -295,6 +296,7 @@ void Trade::setLegBasedAdditionalData(const Size i, Size resultLegId) const {
 void Trade::setSensitivityTemplate(const EngineBuilder& builder) {
     sensitivityTemplate_ = builder.engineParameter("SensitivityTemplate", {}, false, std::string());
     sensitivityTemplateSet_ = true;
+    pricingEngine_ = builder.model() + "/" + builder.engine();
 }
 
 void Trade::setSensitivityTemplate(const std::string& id) {
@@ -168,6 +168,11 @@ public:
     /*! returns the sensi template, e.g. "IR_Analytical" for this trade,
         this is only available after build() has been called */
     const std::string& sensitivityTemplate() const;
+
+    /*! returns the model and engine of the engine builder used to build the trade as "Model/Engine", this is
+        available after build() has been called and empty if the trade builder did not set the sensitivity template
+        from an engine builder */
+    const std::string& pricingEngine() const { return pricingEngine_; }
     //@}
 
     //! \name Utility
@@ -205,6 +210,7 @@ protected:
     string issuer_;
     string sensitivityTemplate_;
     bool sensitivityTemplateSet_ = false;
+    string pricingEngine_;
 
     std::size_t savedNumberOfPricings_ = 0;
     boost::timer::nanosecond_type savedCumulativePricingTime_ = 0;
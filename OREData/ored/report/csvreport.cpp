@@ -30,62 +30,91 @@
 #include <boost/variant/static_visitor.hpp>
 #include <boost/algorithm/string/join.hpp>
 
+#include <charconv>
+#include <cstdio>
+
 using std::string;
 
 namespace ore {
 namespace data {
 
-// Local class for printing each report type via fprintf
+namespace {
+
+// the formatted rows are collected in memory and written to the file in blocks of this size
+constexpr std::size_t writeBufferSize = 1 << 20;
+
+void appendReal(string& out, int precision, Real d) {
+#ifdef __cpp_lib_to_chars
+    // to_chars gives the same digits as printf("%.*f"), but does not need to parse a format string
+    char buf[128];
+    auto r = std::to_chars(buf, buf + sizeof(buf), d, std::chars_format::fixed, precision);
+    if (r.ec == std::errc()) {
+        out.append(buf, r.ptr);
+        return;
+    }
+#endif
+    int n = std::snprintf(nullptr, 0, "%.*f", precision, d);
+    QL_REQUIRE(n >= 0, "CSVFileReport: can not format " << d);
+    std::size_t pos = out.size();
+    out.resize(pos + n + 1);
+    std::snprintf(&out[pos], n + 1, "%.*f", precision, d);
+    out.resize(pos + n);
+}
+
+void appendSize(string& out, Size i) {
+    char buf[32];
+    auto r = std::to_chars(buf, buf + sizeof(buf), i);
+    out.append(buf, r.ptr);
+}
+
+} // namespace
+
+// Local class for printing each report type to the write buffer
 class ReportTypePrinter : public boost::static_visitor<> {
 public:
-    ReportTypePrinter(FILE* fp, int prec, char quoteChar = '\0', const string& nullString = "#N/A")
-        : fp_(fp), rounding_(prec, QuantLib::Rounding::Closest), quoteChar_(quoteChar), null_(nullString) {}
+    ReportTypePrinter(string* out, int prec, char quoteChar = '\0', const string& nullString = "#N/A")
+        : out_(out), rounding_(prec, QuantLib::Rounding::Closest), quoteChar_(quoteChar), null_(nullString) {}
 
     void operator()(const Size i) const {
         if (i == QuantLib::Null<Size>()) {
-            fprintNull();
+            printNull();
         } else {
-            fprintf(fp_, "%zu", i);
+            appendSize(*out_, i);
         }
     }
     void operator()(const Real d) const {
         if (d == QuantLib::Null<Real>() || !std::isfinite(d)) {
-            fprintNull();
+            printNull();
         } else {
             Real r = rounding_(d);
-            fprintf(fp_, "%.*f", rounding_.precision(), QuantLib::close_enough(r, 0.0) ? 0.0 : r);
+            appendReal(*out_, rounding_.precision(), QuantLib::close_enough(r, 0.0) ? 0.0 : r);
         }
     }
-    void operator()(const string& s) const { fprintString(s); }
+    void operator()(const string& s) const { printString(s); }
     void operator()(const Date& d) const {
         if (d == QuantLib::Null<Date>()) {
-            fprintNull();
+            printNull();
         } else {
-            string s = to_string(d);
-            fprintString(s);
+            printString(to_string(d));
         }
     }
-    void operator()(const Period& p) const {
-        string s = to_string(p);
-        fprintString(s);
-    }
-
-    void updateFile(FILE* fp) { fp_ = fp; }
+    void operator()(const Period& p) const { printString(to_string(p)); }
 
 private:
-    void fprintNull() const { fprintf(fp_, "%s", null_.c_str()); }
+    void printNull() const { out_->append(null_); }
 
     // Shared implementation to include the quote character.
-    void fprintString(const string& s) const {
+    void printString(const string& s) const {
         bool quoted = s.size() > 1 && s[0] == quoteChar_ && s[s.size() - 1] == quoteChar_;
         if (!quoted && quoteChar_ != '\0')
-            fputc(quoteChar_, fp_);
-        fprintf(fp_, "%s", s.c_str());
+            out_->push_back(quoteChar_);
+        // as with printf("%s") the string ends at the first null character
+        out_->append(s.c_str());
         if (!quoted && quoteChar_ != '\0')
-            fputc(quoteChar_, fp_);
+            out_->push_back(quoteChar_);
     }
 
-    FILE* fp_;
+    string* out_;
     QuantLib::Rounding rounding_;
     char quoteChar_;
     string null_;
@@ -110,8 +139,8 @@ void CSVFileReport::open() {
     LOG("Opening CSV file report '" << filename_ << "'");
     fp_ = FileIO::fopen(filename_.c_str(), "w");
     QL_REQUIRE(fp_, "Error opening file '" << filename_ << "'");
-    for (auto& p : printers_)
-        p.updateFile(fp_);
+    buffer_.clear();
+    buffer_.reserve(writeBufferSize + writeBufferSize / 8);
     finalized_ = false;
 }
 
@@ -130,6 +159,7 @@ void CSVFileReport::rollover() {
 void CSVFileReport::flush() {
     checkIsOpen("flush()");
     LOG("CVS file report '" << filename_ << "' is flushed");
+    writeBuffer();
     fflush(fp_);
 }
 
@@ -137,15 +167,15 @@ Report& CSVFileReport::addColumn(const string& name, const ReportType& rt, Size
     checkIsOpen("addColumn(" + name + ")");
     columnTypes_.push_back(rt);
     headers_.push_back(name);
-    printers_.push_back(ReportTypePrinter(fp_, precision, quoteChar_, nullString_));
+    printers_.push_back(ReportTypePrinter(&buffer_, precision, quoteChar_, nullString_));
     if (i_ == 0 && commentCharacter_)
-        fprintf(fp_, "#");
+        buffer_.push_back('#');
     if (i_ > 0)
-        fprintf(fp_, "%c", sep_);
+        buffer_.push_back(sep_);
     string cpName = name;
     if (lowerHeader_ && !cpName.empty())
         cpName[0] = std::tolower(static_cast<unsigned char>(cpName[0]));
-    fprintf(fp_, "%s", cpName.c_str());
+    buffer_.append(cpName.c_str());
     i_++;
     return *this;
 }
@@ -154,6 +184,7 @@ Report& CSVFileReport::next() {
     // check the filesize every for every 1000 rows, and roll if necessary
     if (rolloverSize_ != QuantLib::Null<Size>()) {
         if (j_ >= 10000) {
+            writeBuffer();
             auto fileSize = boost::filesystem::file_size(filename_);
             TLOG("CSV size of " << filename_ << " is " << fileSize);
             if (fileSize > rolloverSize_ * 1024 * 1024)
@@ -167,8 +198,10 @@ Report& CSVFileReport::next() {
     QL_REQUIRE(i_ == columnTypes_.size(), "Cannot go to next line, only "
                                               << i_
                                               << " entries filled, report headers are: " << boost::join(headers_, ","));
-    fprintf(fp_, "\n");
-    i_ = 0;    
+    buffer_.push_back('\n');
+    if (buffer_.size() >= writeBufferSize)
+        writeBuffer();
+    i_ = 0;
     return *this;
 }
 
@@ -182,7 +215,7 @@ Report& CSVFileReport::add(const ReportType& rt) {
                                                            << ", report headers are: " << boost::join(headers_, ","));
 
     if (i_ != 0)
-        fprintf(fp_, "%c", sep_);
+        buffer_.push_back(sep_);
     boost::apply_visitor(printers_[i_], rt);
     i_++;
     return *this;
@@ -192,7 +225,8 @@ void CSVFileReport::end() {
     checkIsOpen("end()");
 
     if (fp_) {
-        fprintf(fp_, "\n");
+        buffer_.push_back('\n');
+        writeBuffer();
         if (int rc = fclose(fp_)) {
             ALOG("CSV file report '" << filename_ << "' can not be closed (return code " << rc << ")");
         } else {
@@ -208,6 +242,15 @@ void CSVFileReport::end() {
     finalized_ = true;
 }
 
+void CSVFileReport::writeBuffer() {
+    if (!buffer_.empty() && fp_) {
+        if (fwrite(buffer_.data(), 1, buffer_.size(), fp_) != buffer_.size()) {
+            ALOG("CSV file report '" << filename_ << "': error writing to file");
+        }
+    }
+    buffer_.clear();
+}
+
 void CSVFileReport::checkIsOpen(const std::string& op) const {
     QL_REQUIRE(!finalized_, "CSV file report '" << filename_ << "' is already finalized, can not process operation "
                                                 << op << ", report headers are: " << boost::join(headers_, ","));
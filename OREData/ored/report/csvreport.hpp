@@ -25,6 +25,7 @@
 
 #include <ored/report/report.hpp>
 #include <stdio.h>
+#include <string>
 #include <vector>
 
 namespace ore {
@@ -33,6 +34,9 @@ namespace data {
 class ReportTypePrinter;
 /*! CSV Report class
 
+The rows are formatted into an in-memory buffer which is written to the file in blocks of 1MB, on flush(),
+rollover() and end().
+
 \ingroup report
 */
 class CSVFileReport : public Report {
@@ -62,6 +66,7 @@ public:
 
 private:
     void checkIsOpen(const std::string& op) const;
+    void writeBuffer();
 
     std::vector<ReportType> columnTypes_;
     std::vector<ReportTypePrinter> printers_;
@@ -77,6 +82,7 @@ private:
     FILE* fp_;
     bool finalized_ = false;
     std::vector<std::string> headers_;
+    std::string buffer_;
 };
 } // namespace data
 } // namespace ore
@@ -23,20 +23,58 @@
 #include <boost/algorithm/string/join.hpp>
 #include <boost/serialization/serialization.hpp>
 #include <boost/serialization/vector.hpp>
-#include <boost/serialization/variant.hpp>
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 
 #include <fstream>
+#include <limits>
 
 namespace ore {
 namespace data {
 
+namespace {
+// the indices of the types in Report::ReportType
+enum ColumnType { SizeType = 0, RealType = 1, StringType = 2, DateType = 3, PeriodType = 4 };
+// the number of rows after which the accounted memory is updated while rows are added
+constexpr Size accountingRows = 4096;
+} // namespace
+
+QuantExt::MemoryAccount& InMemoryReport::memoryAccount() {
+    static QuantExt::MemoryAccount& account = QuantExt::MemoryAccounting::instance().account("InMemoryReport");
+    return account;
+}
+
+void InMemoryReport::updateAccountedMemory() const {
+    Size bytes = dictionaryBytes_;
+    for (auto const& c : data_) {
+        bytes += c.sizes.capacity() * sizeof(Size) + c.reals.capacity() * sizeof(Real) +
+                 c.strings.capacity() * sizeof(std::uint32_t) + c.dates.capacity() * sizeof(Date) +
+                 c.periods.capacity() * sizeof(Period);
+    }
+    for (auto const& c : cache_)
+        bytes += c.capacity() * sizeof(ReportType);
+    memory_.resize(bytes);
+}
+
+Size InMemoryReport::Column::size() const {
+    return sizes.size() + reals.size() + strings.size() + dates.size() + periods.size();
+}
+
+void InMemoryReport::Column::clear() {
+    sizes.clear();
+    reals.clear();
+    strings.clear();
+    dates.clear();
+    periods.clear();
+}
+
 Report& InMemoryReport::addColumn(const string& name, const ReportType& rt, Size precision) {
     headers_.push_back(name);
     columnTypes_.push_back(rt);
     columnPrecision_.push_back(precision);
-    data_.push_back(vector<ReportType>()); // Initialise vector for column
+    data_.push_back(Column()); // Initialise storage for column
+    dictionaries_.push_back(Dictionary());
+    cache_.push_back(vector<ReportType>());
     i_++;
     return *this;
 }
@@ -45,16 +83,21 @@ Report& InMemoryReport::next() {
     QL_REQUIRE(i_ == headers_.size(), "Cannot go to next line, only " << i_ << " entries filled, report headers are: "
                                                                       << boost::join(headers_, ","));
     i_ = 0;
-    if (bufferSize_ && data_[0].size() == bufferSize_ && !headers_.empty()) {
+    if (bufferSize_ && !headers_.empty() && data_[0].size() == bufferSize_) {
         std::string s = std::tmpnam(nullptr);
         std::ofstream os(s.c_str(), std::ios::binary);
         boost::archive::binary_oarchive oa(os, boost::archive::no_header);
         for (Size i = 0; i < headers_.size(); i++) {
-            oa << data_[i];
+            // the dictionaries are kept in memory, only the string indices are written
+            oa << data_[i].sizes << data_[i].reals << data_[i].strings << data_[i].dates << data_[i].periods;
             data_[i].clear();
+            cache_[i].clear();
         }
         os.close();
         files_.push_back(s);
+        updateAccountedMemory();
+    } else if (!headers_.empty() && data_[0].size() % accountingRows == 0) {
+        updateAccountedMemory();
     }
     return *this;
 }
@@ -67,7 +110,38 @@ Report& InMemoryReport::add(const ReportType& rt) {
                                                            << headers_[i_] << " of type " << columnTypes_[i_].which()
                                                            << ", report headers are: " << boost::join(headers_, ","));
 
-    data_[i_].push_back(rt);
+    Column& c = data_[i_];
+    switch (rt.which()) {
+    case SizeType:
+        c.sizes.push_back(boost::get<Size>(rt));
+        break;
+    case RealType:
+        c.reals.push_back(boost::get<Real>(rt));
+        break;
+    case StringType: {
+        Dictionary& d = dictionaries_[i_];
+        const string& v = boost::get<string>(rt);
+        auto it = d.index.find(v);
+        if (it == d.index.end()) {
+            QL_REQUIRE(d.values.size() < std::numeric_limits<std::uint32_t>::max(),
+                       "Too many distinct strings in column " << headers_[i_]);
+            it = d.index.emplace(v, static_cast<std::uint32_t>(d.values.size())).first;
+            d.values.push_back(v);
+            // the string is held in the index and the values
+            dictionaryBytes_ += 2 * (sizeof(string) + v.capacity()) + sizeof(std::uint32_t);
+        }
+        c.strings.push_back(it->second);
+        break;
+    }
+    case DateType:
+        c.dates.push_back(boost::get<Date>(rt));
+        break;
+    case PeriodType:
+        c.periods.push_back(boost::get<Period>(rt));
+        break;
+    default:
+        QL_FAIL("internal error: unknown report type " << rt.which());
+    }
     i_++;
     return *this;
 }
@@ -90,7 +164,7 @@ Report& InMemoryReport::add(const InMemoryReport& report) {
         
     for (Size rowIdx = 0; rowIdx < report.rows(); rowIdx++) {
         for (Size columnIdx = 0; columnIdx < report.columns(); columnIdx++) {
-            add(report.data(columnIdx)[rowIdx]);
+            add(report.data(columnIdx, rowIdx));
         }
         next();
     }
@@ -102,6 +176,24 @@ void InMemoryReport::end() {
     QL_REQUIRE(i_ == headers_.size() || i_ == 0, "report is finalized with incomplete row, got data for "
                                                      << i_ << " columns out of " << columns()
                                                      << ", report headers are: " << boost::join(headers_, ","));
+    updateAccountedMemory();
+}
+
+Report::ReportType InMemoryReport::value(Size i, const Column& column, Size j) const {
+    switch (columnTypes_[i].which()) {
+    case SizeType:
+        return column.sizes[j];
+    case RealType:
+        return column.reals[j];
+    case StringType:
+        return dictionaries_[i].values[column.strings[j]];
+    case DateType:
+        return column.dates[j];
+    case PeriodType:
+        return column.periods[j];
+    default:
+        QL_FAIL("internal error: unknown report type " << columnTypes_[i].which());
+    }
 }
 
 const vector<Report::ReportType>& InMemoryReport::data(Size i) const {
@@ -111,34 +203,74 @@ const vector<Report::ReportType>& InMemoryReport::data(Size i) const {
                                               << i << " (" << header(i) << ") contains " << data_[i].size()
                                               << " rows, expected are " << rows()
                                               << " rows, report headers are: " << boost::join(headers_, ","));
+    // the columns are only appended to, so that the cache can be extended by the rows added since the last call
+    vector<ReportType>& cached = cache_[i];
+    cached.reserve(data_[i].size());
+    for (Size j = cached.size(); j < data_[i].size(); ++j)
+        cached.push_back(value(i, data_[i], j));
+    updateAccountedMemory();
+    return cached;
+}
+
+Report::ReportType InMemoryReport::data(Size i, Size j) const {
+    QL_REQUIRE(files_.empty(), "Member function InMemoryReport::data() is not supported "
+        "when buffering is active");
+    QL_REQUIRE(i < columns(), "InMemoryReport::data(): column " << i << " out of range, report has " << columns()
+                                                                << " columns");
+    QL_REQUIRE(j < data_[i].size(), "InMemoryReport::data(): row " << j << " out of range, column " << header(i)
+                                                                   << " has " << data_[i].size() << " rows");
+    return value(i, data_[i], j);
+}
+
+const InMemoryReport::Column& InMemoryReport::column(Size i, int type) const {
+    QL_REQUIRE(files_.empty(), "InMemoryReport: typed column access is not supported when buffering is active");
+    QL_REQUIRE(i < columns(), "InMemoryReport: column " << i << " out of range, report has " << columns()
+                                                        << " columns");
+    QL_REQUIRE(columnTypes_[i].which() == type, "InMemoryReport: column " << header(i) << " has type "
+                                                                          << columnTypes_[i].which()
+                                                                          << ", expected " << type);
     return data_[i];
 }
 
+const vector<Size>& InMemoryReport::sizeColumn(Size i) const { return column(i, SizeType).sizes; }
+
+const vector<Real>& InMemoryReport::realColumn(Size i) const { return column(i, RealType).reals; }
+
+const vector<std::uint32_t>& InMemoryReport::stringColumn(Size i) const { return column(i, StringType).strings; }
+
+const vector<string>& InMemoryReport::stringDictionary(Size i) const {
+    column(i, StringType);
+    return dictionaries_[i].values;
+}
+
 void InMemoryReport::toFile(const string& filename, const char sep, const bool commentCharacter, char quoteChar,
                             const string& nullString, bool lowerHeader) {
-
     CSVFileReport cReport(filename, sep, commentCharacter, quoteChar, nullString, lowerHeader);
+    toReport(cReport);
+}
+
+void InMemoryReport::toReport(Report& report) const {
 
     for (Size i = 0; i < headers_.size(); i++) {
-        cReport.addColumn(headers_[i], columnTypes_[i], columnPrecision_[i]);
+        report.addColumn(headers_[i], columnTypes_[i], columnPrecision_[i]);
     }
 
     auto numColumns = columns();
     if (numColumns > 0) {
 
         for (auto &f : files_) {
-            vector<vector<ReportType>> data(numColumns);
+            vector<Column> data(numColumns);
             std::ifstream is(f.c_str(), std::ios::binary);
             boost::archive::binary_iarchive ia(is, boost::archive::no_header);
             for (Size i = 0; i < numColumns; i++) {
-                ia >> data[i];
+                ia >> data[i].sizes >> data[i].reals >> data[i].strings >> data[i].dates >> data[i].periods;
             }
             is.close();
 
             for (Size i = 0; i < data[0].size(); i++) {
-                cReport.next();
+                report.next();
                 for (Size j = 0; j < numColumns; j++) {
-                    cReport.add(data[j][i]);
+                    report.add(value(j, data[j], i));
                 }
             }
         }
@@ -146,14 +278,14 @@ void InMemoryReport::toFile(const string& filename, const char sep, const bool c
         auto numRows = data_[0].size();
 
         for (Size i = 0; i < numRows; i++) {
-            cReport.next();
+            report.next();
             for (Size j = 0; j < numColumns; j++) {
-                cReport.add(data_[j][i]);
+                report.add(value(j, data_[j], i));
             }
         }
     }
 
-    cReport.end();
+    report.end();
 }
 
 } // namespace data
@@ -27,6 +27,9 @@
 #include <ored/report/report.hpp>
 #include <ql/errors.hpp>
 #include <ql/tuple.hpp>
+#include <qle/utilities/memoryaccounting.hpp>
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 namespace ore {
@@ -36,6 +39,10 @@ using std::vector;
 
 /*! InMemoryReport just stores report information in local vectors and provides an interface to access
  *  the values. It could be used as a backend to a GUI
+
+    Each column is stored in a contiguous vector of its type, string columns are dictionary encoded, i.e. each
+    distinct string is stored once per column and the rows hold its index. If the number of rows reaches the buffer
+    size, the rows are moved to a temporary file, see toFile().
  \ingroup report
  */
 class InMemoryReport : public Report {
@@ -55,20 +62,63 @@ public:
     bool hasHeader(string h) const { return std::find(headers_.begin(), headers_.end(), h) != headers_.end(); }
     ReportType columnType(Size i) const { return columnTypes_[i]; }
     Size columnPrecision(Size i) const { return columnPrecision_[i]; }
-    //! Returns the data
+    //! Returns the data of column i
+    /*! The column is converted to report types on first access, prefer data(i, j) to access single values. The
+        returned reference is valid until data(i) is called again after rows were added. */
     const vector<ReportType>& data(Size i) const;
+    //! Returns the value in column i and row j
+    ReportType data(Size i, Size j) const;
+    //! \name Typed column access
+    /*! The returned vectors are the storage of the column, i.e. no copy is made, they must match the column type.
+        String columns are dictionary encoded, the rows hold indices into stringDictionary(i). The references are
+        valid until rows are added, buffering must not be active. */
+    //@{
+    const vector<Size>& sizeColumn(Size i) const;
+    const vector<Real>& realColumn(Size i) const;
+    const vector<std::uint32_t>& stringColumn(Size i) const;
+    const vector<string>& stringDictionary(Size i) const;
+    //@}
     void toFile(const string& filename, const char sep = ',', const bool commentCharacter = true, char quoteChar = '\0',
                 const string& nullString = "#N/A", bool lowerHeader = false);
+    //! Writes the columns and all rows, including those moved to temporary files, to the given report and ends it
+    void toReport(Report& report) const;
     void jumpToColumn(Size i) { i_ = i; }
 
 private:
+    // the values of a column, only the vector matching the column type is used
+    struct Column {
+        vector<Size> sizes;
+        vector<Real> reals;
+        vector<std::uint32_t> strings;
+        vector<Date> dates;
+        vector<Period> periods;
+        Size size() const;
+        void clear();
+    };
+    // the distinct strings of a column
+    struct Dictionary {
+        vector<string> values;
+        std::unordered_map<string, std::uint32_t> index;
+    };
+    ReportType value(Size i, const Column& column, Size j) const;
+    const Column& column(Size i, int type) const;
+    // account for the capacity of the buffers, the dictionaries and the cache
+    void updateAccountedMemory() const;
+    static QuantExt::MemoryAccount& memoryAccount();
+
     Size i_;
     Size bufferSize_;
     vector<string> headers_;
     vector<ReportType> columnTypes_;
     vector<Size> columnPrecision_;
-    vector<vector<ReportType>> data_;
+    vector<Column> data_;
+    vector<Dictionary> dictionaries_;
     vector<string> files_;
+    // columns converted to report types by data(i)
+    mutable vector<vector<ReportType>> cache_;
+    // the bytes held by the dictionary strings
+    Size dictionaryBytes_ = 0;
+    mutable QuantExt::AccountedMemory memory_ = QuantExt::AccountedMemory(memoryAccount());
 };
 
 //! InMemoryReport with access to plain types instead of boost::variant<>, to facilitate language bindings
@@ -87,12 +137,13 @@ public:
     vector<Date> dataAsDate(Size i) const { return data_T<Date>(i, 3); }
     vector<Period> dataAsPeriod(Size i) const { return data_T<Period>(i, 4); }
     // for convenience, access by row j and column i
-    Size rows() const { return columns() == 0 ? 0 : imReport_->data(0).size(); }
-    int dataAsSize(Size j, Size i) const { return int(boost::get<Size>(imReport_->data(i).at(j))); }
-    Real dataAsReal(Size j, Size i) const { return boost::get<Real>(imReport_->data(i).at(j)); }
-    string dataAsString(Size j, Size i) const { return boost::get<string>(imReport_->data(i).at(j)); }
-    Date dataAsDate(Size j, Size i) const { return boost::get<Date>(imReport_->data(i).at(j)); }
-    Period dataAsPeriod(Size j, Size i) const { return boost::get<Period>(imReport_->data(i).at(j)); }
+    Size rows() const { return imReport_->rows(); }
+    const QuantLib::ext::shared_ptr<InMemoryReport>& report() const { return imReport_; }
+    int dataAsSize(Size j, Size i) const { return int(boost::get<Size>(imReport_->data(i, j))); }
+    Real dataAsReal(Size j, Size i) const { return boost::get<Real>(imReport_->data(i, j)); }
+    string dataAsString(Size j, Size i) const { return boost::get<string>(imReport_->data(i, j)); }
+    Date dataAsDate(Size j, Size i) const { return boost::get<Date>(imReport_->data(i, j)); }
+    Period dataAsPeriod(Size j, Size i) const { return boost::get<Period>(imReport_->data(i, j)); }
 
 private:
     template <typename T> vector<T> data_T(Size i, Size w) const {
@@ -100,8 +151,10 @@ private:
                    "PlainTypeInMemoryReport::data_T(column=" << i << ",expectedType=" << w
                    << "): Type mismatch, have " << columnType(i));
         vector<T> tmp;
-        for(auto const& d: imReport_->data(i))
-            tmp.push_back(boost::get<T>(d));
+        Size n = imReport_->rows();
+        tmp.reserve(n);
+        for (Size j = 0; j < n; ++j)
+            tmp.push_back(boost::get<T>(imReport_->data(i, j)));
         return tmp;
     }
     vector<int> sizeToInt(const vector<Size>& v) const {
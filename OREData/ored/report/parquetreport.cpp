@@ -0,0 +1,224 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#ifdef ORE_USE_ARROW
+
+#include <ored/report/parquetreport.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/to_string.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/math/comparison.hpp>
+#include <ql/math/rounding.hpp>
+
+#include <boost/algorithm/string/join.hpp>
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/util/compression.h>
+#include <parquet/arrow/writer.h>
+#include <parquet/properties.h>
+
+#include <cmath>
+#include <cstdint>
+
+namespace ore {
+namespace data {
+
+namespace {
+
+enum ColumnType { SizeType = 0, RealType = 1, StringType = 2, DateType = 3, PeriodType = 4 };
+
+// the serial number of 1970-01-01, the epoch of the arrow date32 type
+constexpr QuantLib::Date::serial_type epochSerialNumber = 25569;
+
+void check(const arrow::Status& status, const string& filename, const string& what) {
+    QL_REQUIRE(status.ok(), "Parquet file report '" << filename << "': " << what << " failed: " << status.ToString());
+}
+
+std::shared_ptr<arrow::DataType> arrowType(const Report::ReportType& rt) {
+    switch (rt.which()) {
+    case SizeType:
+        return arrow::uint64();
+    case RealType:
+        return arrow::float64();
+    case DateType:
+        return arrow::date32();
+    default:
+        return arrow::utf8();
+    }
+}
+
+} // namespace
+
+ParquetFileReport::ParquetFileReport(const string& filename, const string& compression, QuantLib::Size rowGroupSize)
+    : filename_(filename), compression_(compression), rowGroupSize_(rowGroupSize) {
+    QL_REQUIRE(rowGroupSize_ > 0, "Parquet file report '" << filename_ << "': row group size must be positive");
+}
+
+ParquetFileReport::~ParquetFileReport() {
+    if (!finalized_) {
+        WLOG("Parquet file report '" << filename_ << "' was not finalized, call end() on the report instance.");
+        try {
+            end();
+        } catch (const std::exception& e) {
+            ALOG("Parquet file report '" << filename_ << "' can not be finalized: " << e.what());
+        }
+    }
+}
+
+Report& ParquetFileReport::addColumn(const string& name, const ReportType& rt, Size precision) {
+    checkIsOpen("addColumn(" + name + ")");
+    QL_REQUIRE(!writer_, "Parquet file report '" << filename_ << "': can not add column " << name
+                                                 << " after the first row");
+    columnTypes_.push_back(rt);
+    columnPrecision_.push_back(precision);
+    headers_.push_back(name);
+    i_++;
+    return *this;
+}
+
+void ParquetFileReport::open() {
+    LOG("Opening Parquet file report '" << filename_ << "'");
+    QL_REQUIRE(!headers_.empty(), "Parquet file report '" << filename_ << "' has no columns");
+
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    for (Size i = 0; i < headers_.size(); ++i) {
+        fields.push_back(arrow::field(headers_[i], arrowType(columnTypes_[i])));
+        auto builder = arrow::MakeBuilder(fields.back()->type(), arrow::default_memory_pool());
+        check(builder.status(), filename_, "creating column " + headers_[i]);
+        builders_.push_back(std::move(*builder));
+    }
+    schema_ = arrow::schema(fields);
+
+    auto codec = arrow::util::Codec::GetCompressionType(compression_);
+    check(codec.status(), filename_, "parsing compression '" + compression_ + "'");
+    auto properties = parquet::WriterProperties::Builder().compression(*codec)->build();
+
+    auto file = arrow::io::FileOutputStream::Open(filename_);
+    check(file.status(), filename_, "opening the file");
+    auto writer = parquet::arrow::FileWriter::Open(*schema_, arrow::default_memory_pool(), *file, properties);
+    check(writer.status(), filename_, "creating the writer");
+    writer_ = std::move(*writer);
+}
+
+Report& ParquetFileReport::next() {
+    checkIsOpen("next()");
+    QL_REQUIRE(i_ == columnTypes_.size(), "Cannot go to next line, only "
+                                              << i_
+                                              << " entries filled, report headers are: " << boost::join(headers_, ","));
+    if (!writer_)
+        open();
+    else if (static_cast<Size>(builders_.front()->length()) >= rowGroupSize_)
+        writeRowGroup();
+    i_ = 0;
+    return *this;
+}
+
+Report& ParquetFileReport::add(const ReportType& rt) {
+    checkIsOpen("add()");
+    QL_REQUIRE(writer_ && i_ < columnTypes_.size(),
+               "No column to add [" << rt << "] to, report headers are: " << boost::join(headers_, ","));
+    QL_REQUIRE(rt.which() == columnTypes_[i_].which(), "Cannot add value "
+                                                           << rt << " of type " << rt.which() << " to column " << i_
+                                                           << " of type " << columnTypes_[i_].which()
+                                                           << ", report headers are: " << boost::join(headers_, ","));
+
+    arrow::ArrayBuilder* b = builders_[i_].get();
+    arrow::Status status;
+    switch (rt.which()) {
+    case SizeType: {
+        Size v = boost::get<Size>(rt);
+        auto builder = static_cast<arrow::UInt64Builder*>(b);
+        status = v == QuantLib::Null<Size>() ? builder->AppendNull() : builder->Append(v);
+        break;
+    }
+    case RealType: {
+        Real v = boost::get<Real>(rt);
+        auto builder = static_cast<arrow::DoubleBuilder*>(b);
+        if (v == QuantLib::Null<Real>() || !std::isfinite(v)) {
+            status = builder->AppendNull();
+        } else {
+            Real r = QuantLib::ClosestRounding(static_cast<QuantLib::Integer>(columnPrecision_[i_]))(v);
+            status = builder->Append(QuantLib::close_enough(r, 0.0) ? 0.0 : r);
+        }
+        break;
+    }
+    case StringType:
+        status = static_cast<arrow::StringBuilder*>(b)->Append(boost::get<string>(rt));
+        break;
+    case DateType: {
+        const Date& d = boost::get<Date>(rt);
+        auto builder = static_cast<arrow::Date32Builder*>(b);
+        status = d == QuantLib::Null<Date>()
+                     ? builder->AppendNull()
+                     : builder->Append(static_cast<std::int32_t>(d.serialNumber() - epochSerialNumber));
+        break;
+    }
+    case PeriodType:
+        status = static_cast<arrow::StringBuilder*>(b)->Append(to_string(boost::get<Period>(rt)));
+        break;
+    default:
+        QL_FAIL("Parquet file report '" << filename_ << "': unexpected report type " << rt.which());
+    }
+    check(status, filename_, "adding a value to column " + headers_[i_]);
+    i_++;
+    return *this;
+}
+
+void ParquetFileReport::writeRowGroup() {
+    if (builders_.empty() || builders_.front()->length() == 0)
+        return;
+    std::vector<std::shared_ptr<arrow::Array>> arrays(builders_.size());
+    for (Size i = 0; i < builders_.size(); ++i)
+        check(builders_[i]->Finish(&arrays[i]), filename_, "finishing column " + headers_[i]);
+    auto table = arrow::Table::Make(schema_, arrays);
+    check(writer_->WriteTable(*table, table->num_rows()), filename_, "writing a row group");
+}
+
+void ParquetFileReport::flush() {
+    checkIsOpen("flush()");
+    if (writer_)
+        writeRowGroup();
+}
+
+void ParquetFileReport::end() {
+    checkIsOpen("end()");
+    // mark the report finalized first, so that a failure below does not lead to a second attempt in the destructor
+    finalized_ = true;
+    QL_REQUIRE(i_ == columnTypes_.size() || i_ == 0, "parquet report is finalized with incomplete row, got data for "
+                                                         << i_ << " columns out of " << columnTypes_.size()
+                                                         << ", report headers are: " << boost::join(headers_, ","));
+    // a report without rows is written as a file with the schema only
+    if (!writer_)
+        open();
+    writeRowGroup();
+    check(writer_->Close(), filename_, "closing the file");
+    LOG("Parquet file report '" << filename_ << "' closed.");
+}
+
+void ParquetFileReport::checkIsOpen(const std::string& op) const {
+    QL_REQUIRE(!finalized_, "Parquet file report '" << filename_
+                                                    << "' is already finalized, can not process operation " << op
+                                                    << ", report headers are: " << boost::join(headers_, ","));
+}
+
+} // namespace data
+} // namespace ore
+
+#endif
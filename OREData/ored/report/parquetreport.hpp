@@ -0,0 +1,98 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/report/parquetreport.hpp
+    \brief Parquet Report class
+    \ingroup report
+*/
+
+#pragma once
+
+#ifdef ORE_USE_ARROW
+
+#include <ored/report/report.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace arrow {
+class ArrayBuilder;
+class Schema;
+} // namespace arrow
+
+namespace parquet {
+namespace arrow {
+class FileWriter;
+} // namespace arrow
+} // namespace parquet
+
+namespace ore {
+namespace data {
+
+/*! Parquet Report class
+
+    Writes the report as a compressed, columnar Apache Parquet file. The column types are mapped to uint64 (Size),
+    float64 (Real), utf8 (string and Period) and date32 (Date). Real values are rounded to the column precision as
+    in the CSVFileReport. Null and non-finite values are written as Parquet nulls.
+
+    The rows are collected in Arrow builders and written as one row group per \c rowGroupSize rows, so that the
+    memory usage does not depend on the size of the report.
+
+    Only available in builds with ORE_USE_ARROW = ON.
+
+    \ingroup report
+*/
+class ParquetFileReport : public Report {
+public:
+    /*! Create a report with the given filename, the file is opened when the first row is added.
+        \param filename     name of the parquet file that is created
+        \param compression  the compression codec, e.g. zstd, snappy, gzip or uncompressed
+        \param rowGroupSize the maximum number of rows per row group
+    */
+    ParquetFileReport(const string& filename, const string& compression = "zstd",
+                      QuantLib::Size rowGroupSize = 1000000);
+    ~ParquetFileReport();
+
+    Report& addColumn(const string& name, const ReportType& rt, Size precision = 0) override;
+    Report& next() override;
+    Report& add(const ReportType& rt) override;
+    void end() override;
+    void flush() override;
+
+private:
+    void open();
+    void writeRowGroup();
+    void checkIsOpen(const std::string& op) const;
+
+    string filename_;
+    string compression_;
+    QuantLib::Size rowGroupSize_;
+    std::vector<ReportType> columnTypes_;
+    std::vector<Size> columnPrecision_;
+    std::vector<string> headers_;
+    Size i_ = 0;
+    bool finalized_ = false;
+    std::shared_ptr<arrow::Schema> schema_;
+    std::vector<std::shared_ptr<arrow::ArrayBuilder>> builders_;
+    std::unique_ptr<parquet::arrow::FileWriter> writer_;
+};
+
+} // namespace data
+} // namespace ore
+
+#endif
@@ -445,5 +445,22 @@ void LoopNode::accept(AcyclicVisitor& v) {
         ASTNode::accept(v);
 }
 
+namespace {
+void assignVariableIndices(const ASTNodePtr& n, Size& index) {
+    if (!n)
+        return;
+    if (auto v = QuantLib::ext::dynamic_pointer_cast<VariableNode>(n))
+        v->index = index++;
+    for (auto const& a : n->args)
+        assignVariableIndices(a, index);
+}
+} // namespace
+
+Size indexVariableNodes(const ASTNodePtr& root) {
+    Size index = 0;
+    assignVariableIndices(root, index);
+    return index;
+}
+
 } // namespace data
 } // namespace ore
@@ -228,10 +228,8 @@ struct VariableNode : public ASTNode {
     VariableNode(const std::string& name, const std::vector<ASTNodePtr>& args = {}) : ASTNode(args, 0, 1), name(name) {}
     void accept(AcyclicVisitor&) override;
     const std::string name;
-    // cache for optimised variable reference retrieval
-    bool isCached = false, isScalar = false;
-    ValueType* cachedScalar = nullptr;
-    std::vector<ValueType>* cachedVector = nullptr;
+    // dense index of the node in its ast, see indexVariableNodes(), used by the runners to cache variable references
+    Size index = Null<Size>();
 };
 
 struct SizeOpNode : public ASTNode {
@@ -321,5 +319,9 @@ struct LoopNode : public ASTNode {
     const std::string name;
 };
 
+/* assigns the indices 0, 1, 2, ... to the variable nodes of an ast in depth first order and returns the number of
+   variable nodes, this is done by the script parser */
+Size indexVariableNodes(const ASTNodePtr& root);
+
 } // namespace data
 } // namespace ore
@@ -18,7 +18,6 @@
 
 #include <ored/scripting/computationgraphbuilder.hpp>
 
-#include <ored/scripting/astresetter.hpp>
 #include <ored/scripting/safestack.hpp>
 #include <ored/scripting/scriptparser.hpp>
 #include <ored/scripting/utilities.hpp>
@@ -183,41 +182,41 @@ public:
 
     std::pair<ValueType&, long> getVariableRef(VariableNode& v) {
         checkpoint(v);
-        if (v.isCached) {
-            if (v.isScalar) {
-                return std::make_pair(QuantLib::ext::ref(*v.cachedScalar), 0);
-            } else {
-                QL_REQUIRE(v.args[0], "array subscript required for variable '" << v.name << "'");
-                v.args[0]->accept(*this);
-                auto arg = value.pop();
-                value_node.pop();
-                QL_REQUIRE(arg.which() == ValueTypeWhich::Number,
-                           "array subscript must be of type NUMBER, got " << valueTypeLabels.at(arg.which()));
-                RandomVariable i = QuantLib::ext::get<RandomVariable>(arg);
-                QL_REQUIRE(i.deterministic(), "array subscript must be deterministic");
-                long il = std::lround(i.at(0));
-                QL_REQUIRE(static_cast<long>(v.cachedVector->size()) >= il && il >= 1,
-                           "array index " << il << " out of bounds 1..." << v.cachedVector->size());
-                return std::make_pair(QuantLib::ext::ref(v.cachedVector->operator[](il - 1)), il - 1);
-            }
+        ValueType* scalar = nullptr;
+        std::vector<ValueType>* array = nullptr;
+        if (v.index != Null<Size>() && v.index < variableCache_.size() && variableCache_[v.index].node == &v) {
+            scalar = variableCache_[v.index].scalar;
+            array = variableCache_[v.index].array;
         } else {
-            auto scalar = context_.scalars.find(v.name);
-            if (scalar != context_.scalars.end()) {
+            if (auto s = context_.scalars.find(v.name); s != context_.scalars.end()) {
                 QL_REQUIRE(!v.args[0], "no array subscript allowed for variable '" << v.name << "'");
-                v.isCached = true;
-                v.isScalar = true;
-                v.cachedScalar = &scalar->second;
-                return std::make_pair(QuantLib::ext::ref(scalar->second), 0);
+                scalar = &s->second;
+            } else if (auto a = context_.arrays.find(v.name); a != context_.arrays.end()) {
+                array = &a->second;
+            } else {
+                QL_FAIL("variable '" << v.name << "' is not defined.");
             }
-            auto array = context_.arrays.find(v.name);
-            if (array != context_.arrays.end()) {
-                v.isCached = true;
-                v.isScalar = false;
-                v.cachedVector = &array->second;
-                return getVariableRef(v);
+            if (v.index != Null<Size>()) {
+                if (v.index >= variableCache_.size())
+                    variableCache_.resize(v.index + 1);
+                variableCache_[v.index] = {&v, scalar, array};
             }
-            QL_FAIL("variable '" << v.name << "' is not defined.");
         }
+        if (scalar)
+            return std::make_pair(QuantLib::ext::ref(*scalar), 0);
+        // the subscript may contain variables itself, so we do not keep references into the cache here
+        QL_REQUIRE(v.args[0], "array subscript required for variable '" << v.name << "'");
+        v.args[0]->accept(*this);
+        auto arg = value.pop();
+        value_node.pop();
+        QL_REQUIRE(arg.which() == ValueTypeWhich::Number,
+                   "array subscript must be of type NUMBER, got " << valueTypeLabels.at(arg.which()));
+        RandomVariable i = QuantLib::ext::get<RandomVariable>(arg);
+        QL_REQUIRE(i.deterministic(), "array subscript must be deterministic");
+        long il = std::lround(i.at(0));
+        QL_REQUIRE(static_cast<long>(array->size()) >= il && il >= 1,
+                   "array index " << il << " out of bounds 1..." << array->size());
+        return std::make_pair(QuantLib::ext::ref(array->operator[](il - 1)), il - 1);
     }
 
     // helepr to declare a new context variable
@@ -1473,6 +1472,15 @@ public:
     // working variables
     Context& context_;
     ASTNode*& lastVisitedNode_;
+    /* cache for optimised variable reference retrieval (scalar or array) by variable node index, this is kept in the
+       runner and not in the ast, so that an ast can be run concurrently on different contexts; the node is stored to
+       detect nodes which share an index, because they were not indexed together */
+    struct CachedVariable {
+        const VariableNode* node = nullptr;
+        ValueType* scalar = nullptr;
+        std::vector<ValueType>* array = nullptr;
+    };
+    std::vector<CachedVariable> variableCache_;
     // state of the runner
     SafeStack<Filter> filter;
     SafeStack<ValueType> value;
@@ -1510,7 +1518,6 @@ void ComputationGraphBuilder::run(const bool generatePayLog, const bool includeP
 
     boost::timer::cpu_timer timer;
     try {
-        reset(root_);
         root_->accept(runner);
         timer.stop();
         QL_REQUIRE(runner.value.size() == 1, "ComputationGraphBuilder::run(): value stack has wrong size ("
@@ -68,6 +68,7 @@ CliquetOptionMcScriptEngine::CliquetOptionMcScriptEngine(const std::string& unde
     ScriptParser parser(scriptStr);
     QL_REQUIRE(parser.success(), "could not initialise AST for McScriptEuropeanEngine: " << parser.error());
     ast_ = parser.ast();
+    bytecode_ = QuantLib::ext::make_shared<ScriptBytecode>(ast_);
     registerWith(p_);
 }
 
@@ -124,7 +125,7 @@ void CliquetOptionMcScriptEngine::calculate() const {
 
     // run the script engine and set the result
 
-    ScriptEngine engine(ast_, context, model);
+    ScriptEngine engine(ast_, context, model, bytecode_);
     engine.run("", interactive_);
     results_.value = expectation(QuantLib::ext::get<RandomVariable>(context->scalars.at("Option"))).at(0);
 }
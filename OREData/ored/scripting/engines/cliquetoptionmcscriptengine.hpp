@@ -22,6 +22,7 @@
 #include <ored/scripting/models/model.hpp>
 #include <ored/portfolio/scriptedtrade.hpp>
 #include <ored/scripting/ast.hpp>
+#include <ored/scripting/scriptbytecode.hpp>
 
 #include <ql/processes/blackscholesprocess.hpp>
 
@@ -43,6 +44,7 @@ private:
     const Size samples_, regressionOrder_;
     bool interactive_;
     ASTNodePtr ast_;
+    QuantLib::ext::shared_ptr<ScriptBytecode> bytecode_;
 };
 
 } // namespace data
@@ -30,6 +30,12 @@ namespace data {
 
 QuantLib::Currency ScriptedInstrumentAmcCalculator::npvCurrency() { return parseCurrency(model_->baseCcy()); }
 
+std::vector<QuantLib::Size> ScriptedInstrumentAmcCalculator::stateIndices() const {
+    if (auto amcModel = QuantLib::ext::dynamic_pointer_cast<AmcModel>(model_))
+        return amcModel->injectedPathIndices();
+    return {};
+}
+
 std::vector<QuantExt::RandomVariable> ScriptedInstrumentAmcCalculator::simulatePath(
     const std::vector<QuantLib::Real>& pathTimes, std::vector<std::vector<QuantExt::RandomVariable>>& paths,
     const std::vector<size_t>& relevantPathIndex, const std::vector<size_t>& relevantTimeIndex) {
@@ -95,7 +101,7 @@ std::vector<QuantExt::RandomVariable> ScriptedInstrumentAmcCalculator::simulateP
 
     // set up script engine and run it
 
-    ScriptEngine engine(ast_, workingContext, model_);
+    ScriptEngine engine(ast_, workingContext, model_, bytecode_);
     engine.run(script_, interactive_, nullptr);
 
     // extract AMC Exposure result and return them
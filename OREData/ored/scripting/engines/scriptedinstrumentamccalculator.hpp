@@ -26,6 +26,7 @@
 #include <ored/scripting/models/model.hpp>
 #include <ored/scripting/ast.hpp>
 #include <ored/scripting/context.hpp>
+#include <ored/scripting/scriptbytecode.hpp>
 #include <ored/scripting/scriptedinstrument.hpp>
 
 #include <qle/pricingengines/amccalculator.hpp>
@@ -40,9 +41,10 @@ public:
     ScriptedInstrumentAmcCalculator(const std::string& npv, const QuantLib::ext::shared_ptr<Model>& model, const ASTNodePtr ast,
                                     const QuantLib::ext::shared_ptr<Context>& context, const std::string& script = "",
                                     const bool interactive = false,
-                                    const std::set<std::string>& stickyCloseOutStates = {})
+                                    const std::set<std::string>& stickyCloseOutStates = {},
+                                    const QuantLib::ext::shared_ptr<ScriptBytecode>& bytecode = nullptr)
         : npv_(npv), model_(model), ast_(ast), context_(context), script_(script), interactive_(interactive),
-          stickyCloseOutStates_(stickyCloseOutStates) {}
+          stickyCloseOutStates_(stickyCloseOutStates), bytecode_(bytecode) {}
 
     QuantLib::Currency npvCurrency() override;
 
@@ -50,6 +52,7 @@ public:
                                                        std::vector<std::vector<QuantExt::RandomVariable>>& paths,
                                                        const std::vector<size_t>& relevantPathIndex,
                                                        const std::vector<size_t>& relevantTimeIndex) override;
+    std::vector<QuantLib::Size> stateIndices() const override;
 
 private:
     const std::string npv_;
@@ -59,6 +62,7 @@ private:
     const std::string script_;
     const bool interactive_;
     const std::set<std::string> stickyCloseOutStates_;
+    const QuantLib::ext::shared_ptr<ScriptBytecode> bytecode_;
     //
     std::map<std::string, ValueType> stickyCloseOutRunScalars_;
     std::map<std::string, std::vector<ValueType>> stickyCloseOutRunArrays_;
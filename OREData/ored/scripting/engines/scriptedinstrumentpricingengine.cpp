@@ -22,10 +22,15 @@
 #include <ored/scripting/utilities.hpp>
 
 #include <ored/utilities/log.hpp>
+#include <ored/utilities/parsers.hpp>
 
 #include <qle/instruments/cashflowresults.hpp>
 #include <qle/math/randomvariable.hpp>
 
+#include <ql/math/matrixutilities/svd.hpp>
+
+#include <boost/algorithm/string/predicate.hpp>
+
 namespace ore {
 namespace data {
 
@@ -50,6 +55,68 @@ boost::any valueToAny(const QuantLib::ext::shared_ptr<Model>& model, const Value
     return boost::apply_visitor(anyGetter(model), v);
 }
 
+// helpers to combine the additional results from several path chunks
+
+bool isMcErrorEstimate(const std::string& label) { return boost::algorithm::ends_with(label, "_MCErrEst"); }
+
+Real chunkWeighted(const Real x, const Real n, const bool isErrorEstimate) {
+    return isErrorEstimate ? n * n * x * x : n * x;
+}
+
+Real chunkFinalised(const Real x, const Real n, const bool isErrorEstimate) {
+    return isErrorEstimate ? std::sqrt(x) / n : x / n;
+}
+
+void accumulateChunkResult(boost::any& sum, const boost::any& value, const Real n, const bool isErrorEstimate) {
+    if (value.type() == typeid(double)) {
+        Real v = chunkWeighted(boost::any_cast<double>(value), n, isErrorEstimate);
+        sum = sum.empty() ? v : boost::any_cast<double>(sum) + v;
+    } else if (value.type() == typeid(std::vector<double>)) {
+        auto v = boost::any_cast<std::vector<double>>(value);
+        for (auto& x : v)
+            x = chunkWeighted(x, n, isErrorEstimate);
+        if (!sum.empty()) {
+            auto const& s = boost::any_cast<const std::vector<double>&>(sum);
+            QL_REQUIRE(s.size() == v.size(), "accumulateChunkResult(): result vector size ("
+                                                 << v.size() << ") differs from previous path chunk (" << s.size()
+                                                 << ")");
+            for (Size i = 0; i < v.size(); ++i)
+                v[i] += s[i];
+        }
+        sum = v;
+    } else if (value.type() == typeid(std::vector<CashFlowResults>)) {
+        auto v = boost::any_cast<std::vector<CashFlowResults>>(value);
+        for (auto& c : v)
+            c.amount *= n;
+        if (!sum.empty()) {
+            auto const& s = boost::any_cast<const std::vector<CashFlowResults>&>(sum);
+            QL_REQUIRE(s.size() == v.size(), "accumulateChunkResult(): number of cashflows ("
+                                                 << v.size() << ") differs from previous path chunk (" << s.size()
+                                                 << ")");
+            for (Size i = 0; i < v.size(); ++i)
+                v[i].amount += s[i].amount;
+        }
+        sum = v;
+    } else {
+        // non-numeric results do not depend on the paths, we keep the value from the last chunk
+        sum = value;
+    }
+}
+
+void finaliseChunkResult(boost::any& sum, const Real n, const bool isErrorEstimate) {
+    if (sum.type() == typeid(double)) {
+        sum = chunkFinalised(boost::any_cast<double>(sum), n, isErrorEstimate);
+    } else if (sum.type() == typeid(std::vector<double>)) {
+        auto& v = boost::any_cast<std::vector<double>&>(sum);
+        for (auto& x : v)
+            x = chunkFinalised(x, n, isErrorEstimate);
+    } else if (sum.type() == typeid(std::vector<CashFlowResults>)) {
+        auto& v = boost::any_cast<std::vector<CashFlowResults>&>(sum);
+        for (auto& c : v)
+            c.amount /= n;
+    }
+}
+
 } // namespace
 
 Real ScriptedInstrumentPricingEngine::addMcErrorEstimate(const std::string& label, const ValueType& v) const {
@@ -64,55 +131,73 @@ Real ScriptedInstrumentPricingEngine::addMcErrorEstimate(const std::string& labe
     return errEst;
 }
 
-void ScriptedInstrumentPricingEngine::calculate() const {
-
-    lastCalculationWasValid_ = false;
-
-    // make sure we release the memory allocated by the model after the pricing
-    struct MemoryReleaser {
-        ~MemoryReleaser() { model->releaseMemory(); }
-        QuantLib::ext::shared_ptr<Model> model;
-    };
-    MemoryReleaser memoryReleaser{model_};
-
-    // set up copy of initial context to run the script engine on
-
-    auto workingContext = QuantLib::ext::make_shared<Context>(*context_);
-
-    // set TODAY in the context
-
-    checkDuplicateName(workingContext, "TODAY");
-    Date referenceDate = model_->referenceDate();
-    workingContext->scalars["TODAY"] = EventVec{model_->size(), referenceDate};
-    workingContext->constants.insert("TODAY");
-
-    // clear NPVMem() regression coefficients
-
-    model_->resetNPVMem();
+RandomVariable
+ScriptedInstrumentPricingEngine::applyControlVariates(const QuantLib::ext::shared_ptr<Context>& workingContext,
+                                                      const RandomVariable& npv) const {
+
+    // collect the centered control variate payoffs and their known values
+
+    Size n = controlVariates_.size();
+    std::vector<RandomVariable> payoffs, centeredPayoffs;
+    std::vector<Real> knownValues;
+    for (auto const& [payoff, value] : controlVariates_) {
+        auto p = workingContext->scalars.find(payoff);
+        QL_REQUIRE(p != workingContext->scalars.end() && p->second.which() == ValueTypeWhich::Number,
+                   "control variate payoff '" << payoff << "' must be a scalar of type NUMBER");
+        payoffs.push_back(QuantLib::ext::get<RandomVariable>(p->second));
+        centeredPayoffs.push_back(payoffs.back() - expectation(payoffs.back()));
+        Real knownValue;
+        if (auto v = workingContext->scalars.find(value); v != workingContext->scalars.end()) {
+            QL_REQUIRE(v->second.which() == ValueTypeWhich::Number,
+                       "control variate value '" << value << "' must be of type NUMBER");
+            knownValue = model_->extractT0Result(QuantLib::ext::get<RandomVariable>(v->second));
+        } else {
+            QL_REQUIRE(tryParseReal(value, knownValue), "control variate value '"
+                                                            << value << "' is neither a script variable nor a number");
+        }
+        knownValues.push_back(knownValue);
+    }
 
-    // if the model uses a separate training phase for NPV(), run this
+    /* the optimal coefficients beta solve Cov(X) beta = Cov(X, npv), we use a svd to be robust against collinear
+       control variates or control variates that are constant on all paths */
 
-    if (model_->trainingSamples() != Null<Size>()) {
-        auto trainingContext = QuantLib::ext::make_shared<Context>(*workingContext);
-        trainingContext->resetSize(model_->trainingSamples());
-        struct TrainingPathToggle {
-            TrainingPathToggle(QuantLib::ext::shared_ptr<Model> model) : model(model) { model->toggleTrainingPaths(); }
-            ~TrainingPathToggle() { model->toggleTrainingPaths(); }
-            QuantLib::ext::shared_ptr<Model> model;
-        } toggle(model_);
-        ScriptEngine trainingEngine(ast_, trainingContext, model_);
-        trainingEngine.run(script_, interactive_);
+    RandomVariable centeredNpv = npv - expectation(npv);
+    QuantLib::Matrix cov(n, n);
+    QuantLib::Array rhs(n);
+    for (Size i = 0; i < n; ++i) {
+        rhs[i] = expectation(centeredPayoffs[i] * centeredNpv).at(0);
+        for (Size j = 0; j <= i; ++j)
+            cov[i][j] = cov[j][i] = expectation(centeredPayoffs[i] * centeredPayoffs[j]).at(0);
+    }
+    QuantLib::Array beta(n, 0.0);
+    QuantLib::SVD svd(cov);
+    if (svd.singularValues()[0] > 0.0)
+        beta = svd.solveFor(rhs);
+
+    RandomVariable result = npv;
+    for (Size i = 0; i < n; ++i) {
+        result -= RandomVariable(npv.size(), beta[i]) * (payoffs[i] - RandomVariable(npv.size(), knownValues[i]));
+        DLOG("control variate '" << controlVariates_[i].first << "': known value " << knownValues[i]
+                                 << ", mc value " << expectation(payoffs[i]).at(0) << ", beta " << beta[i]);
     }
 
-    // set up script engine and run it
+    Real varBefore = variance(npv).at(0), varAfter = variance(result).at(0);
+    Real reduction = QuantLib::close_enough(varAfter, 0.0) ? Null<Real>() : varBefore / varAfter;
+    DLOG("control variates reduce npv variance from " << varBefore << " to " << varAfter);
 
-    ScriptEngine engine(ast_, workingContext, model_);
+    if (generateAdditionalResults_) {
+        for (Size i = 0; i < n; ++i)
+            results_.additionalResults["ControlVariate_Beta_" + controlVariates_[i].first] = beta[i];
+        if (reduction != Null<Real>())
+            results_.additionalResults["ControlVariate_VarianceReductionFactor"] = reduction;
+        results_.additionalResults["NPV_NoControlVariate"] = model_->extractT0Result(npv);
+    }
 
-    QuantLib::ext::shared_ptr<PayLog> paylog;
-    if (generateAdditionalResults_)
-        paylog = QuantLib::ext::make_shared<PayLog>();
+    return result;
+}
 
-    engine.run(script_, interactive_, paylog, includePastCashflows_);
+void ScriptedInstrumentPricingEngine::setResults(const QuantLib::ext::shared_ptr<Context>& workingContext,
+                                                 const QuantLib::ext::shared_ptr<PayLog>& paylog) const {
 
     // extract npv result and set it
 
@@ -121,13 +206,16 @@ void ScriptedInstrumentPricingEngine::calculate() const {
                "did not find npv result variable '" << npv_ << "' as scalar in context");
     QL_REQUIRE(npv->second.which() == ValueTypeWhich::Number,
                "result variable '" << npv_ << "' must be of type NUMBER, got " << npv->second.which());
-    results_.value = model_->extractT0Result(QuantLib::ext::get<RandomVariable>(npv->second));
+    ValueType npvValue = npv->second;
+    if (!controlVariates_.empty() && model_->type() == Model::Type::MC)
+        npvValue = applyControlVariates(workingContext, QuantLib::ext::get<RandomVariable>(npvValue));
+    results_.value = model_->extractT0Result(QuantLib::ext::get<RandomVariable>(npvValue));
     DLOG("got NPV = " << results_.value << " " << model_->baseCcy());
 
     // set additional results, if this feature is enabled
 
     if (generateAdditionalResults_) {
-        results_.errorEstimate = addMcErrorEstimate("NPV_MCErrEst", npv->second);
+        results_.errorEstimate = addMcErrorEstimate("NPV_MCErrEst", npvValue);
         for (auto const& r : additionalResults_) {
             auto s = workingContext->scalars.find(r.second);
             bool resultSet = false;
@@ -199,7 +287,7 @@ void ScriptedInstrumentPricingEngine::calculate() const {
             Real discount = 1.0;
             if (paylog->dates().at(i) > model_->referenceDate()) {
                 fx = model_->fxSpotT0(paylog->currencies().at(i), model_->baseCcy());
-                discount = model_->discount(referenceDate, paylog->dates().at(i), paylog->currencies().at(i)).at(0);
+                discount = model_->discount(model_->referenceDate(), paylog->dates().at(i), paylog->currencies().at(i)).at(0);
             }
             cashFlowResults[i].amount = model_->extractT0Result(paylog->amounts().at(i)) / fx / discount;
             cashFlowResults[i].payDate = paylog->dates().at(i);
@@ -225,6 +313,115 @@ void ScriptedInstrumentPricingEngine::calculate() const {
         results_.additionalResults.insert(model_->additionalResults().begin(), model_->additionalResults().end());
 
     } // if generate additional results
+}
+
+void ScriptedInstrumentPricingEngine::calculate() const {
+
+    lastCalculationWasValid_ = false;
+
+    /* the model is calculated lazily and holds path and regression state used during the pricing, hold its lock so
+       that engines sharing the model can be calculated concurrently, everything else below is local to this engine */
+    std::lock_guard<std::recursive_mutex> modelLock(model_->mutex());
+
+    /* make sure we release the memory allocated by the model after the pricing, unless the model is shared with
+       other engines, which will reuse the model's paths */
+    struct MemoryReleaser {
+        ~MemoryReleaser() {
+            if (release)
+                model->releaseMemory();
+        }
+        QuantLib::ext::shared_ptr<Model> model;
+        bool release;
+    };
+    MemoryReleaser memoryReleaser{model_, releaseModelMemory_};
+
+    // set up copy of initial context to run the script engine on
+
+    auto workingContext = QuantLib::ext::make_shared<Context>(*context_);
+
+    // set TODAY in the context
+
+    checkDuplicateName(workingContext, "TODAY");
+    Date referenceDate = model_->referenceDate();
+    workingContext->scalars["TODAY"] = EventVec{model_->size(), referenceDate};
+    workingContext->constants.insert("TODAY");
+
+    // clear NPVMem() regression coefficients
+
+    model_->resetNPVMem();
+
+    // if the model uses a separate training phase for NPV(), run this
+
+    if (model_->trainingSamples() != Null<Size>()) {
+        auto trainingContext = QuantLib::ext::make_shared<Context>(*workingContext);
+        trainingContext->resetSize(model_->trainingSamples());
+        struct TrainingPathToggle {
+            TrainingPathToggle(QuantLib::ext::shared_ptr<Model> model) : model(model) { model->toggleTrainingPaths(); }
+            ~TrainingPathToggle() { model->toggleTrainingPaths(); }
+            QuantLib::ext::shared_ptr<Model> model;
+        } toggle(model_);
+        ScriptEngine trainingEngine(ast_, trainingContext, model_, bytecode_);
+        trainingEngine.run(script_, interactive_);
+    }
+
+    // set up script engine and run it, on all paths at once or chunk by chunk
+
+    Size nChunks = model_->numberOfPathChunks();
+
+    if (nChunks == 1) {
+        ScriptEngine engine(ast_, workingContext, model_, bytecode_);
+
+        QuantLib::ext::shared_ptr<PayLog> paylog;
+        if (generateAdditionalResults_)
+            paylog = QuantLib::ext::make_shared<PayLog>();
+
+        engine.run(script_, interactive_, paylog, includePastCashflows_);
+        setResults(workingContext, paylog);
+    } else {
+        QL_REQUIRE(!amcEnabled_, "ScriptedInstrumentPricingEngine: path chunks are not supported for amc");
+        DLOG("run script on " << nChunks << " path chunks");
+
+        /* the results of the chunks are averaged weighted by their number of paths, mc error estimates are combined
+           as sqrt(sum_i n_i^2 err_i^2) / n, the conditional expectations from the first chunk are reused by the model
+           for the other chunks */
+
+        Real npvSum = 0.0, errEstSum = 0.0;
+        Size totalSize = 0;
+        std::map<std::string, boost::any> additionalResultsSum;
+
+        for (Size c = 0; c < nChunks; ++c) {
+            model_->setPathChunk(c);
+            Size chunkSize = model_->size();
+            auto chunkContext = QuantLib::ext::make_shared<Context>(*workingContext);
+            chunkContext->resetSize(chunkSize);
+
+            ScriptEngine engine(ast_, chunkContext, model_, bytecode_);
+
+            QuantLib::ext::shared_ptr<PayLog> paylog;
+            if (generateAdditionalResults_)
+                paylog = QuantLib::ext::make_shared<PayLog>();
+
+            engine.run(script_, interactive_, paylog, includePastCashflows_);
+            results_.additionalResults.clear();
+            setResults(chunkContext, paylog);
+
+            npvSum += static_cast<Real>(chunkSize) * results_.value;
+            if (results_.errorEstimate != Null<Real>())
+                errEstSum += static_cast<Real>(chunkSize * chunkSize) * results_.errorEstimate * results_.errorEstimate;
+            for (auto const& [label, value] : results_.additionalResults)
+                accumulateChunkResult(additionalResultsSum[label], value, static_cast<Real>(chunkSize),
+                                      isMcErrorEstimate(label));
+            totalSize += chunkSize;
+        }
+
+        results_.value = npvSum / static_cast<Real>(totalSize);
+        if (results_.errorEstimate != Null<Real>())
+            results_.errorEstimate = std::sqrt(errEstSum) / static_cast<Real>(totalSize);
+        for (auto& [label, value] : additionalResultsSum)
+            finaliseChunkResult(value, static_cast<Real>(totalSize), isMcErrorEstimate(label));
+        results_.additionalResults = additionalResultsSum;
+        DLOG("got NPV = " << results_.value << " " << model_->baseCcy() << " over " << nChunks << " path chunks");
+    }
 
     // if the engine is amc enabled, add an amc calculator to the additional results
 
@@ -232,7 +429,7 @@ void ScriptedInstrumentPricingEngine::calculate() const {
         DLOG("add amc calculator to results");
         results_.additionalResults["amcCalculator"] =
             QuantLib::ext::static_pointer_cast<AmcCalculator>(QuantLib::ext::make_shared<ScriptedInstrumentAmcCalculator>(
-                npv_, model_, ast_, context_, script_, interactive_, amcStickyCloseOutStates_));
+                npv_, model_, ast_, context_, script_, interactive_, amcStickyCloseOutStates_, bytecode_));
     }
 
     lastCalculationWasValid_ = true;
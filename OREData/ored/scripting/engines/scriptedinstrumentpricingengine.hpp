@@ -25,6 +25,8 @@
 #include <ored/scripting/models/model.hpp>
 #include <ored/scripting/ast.hpp>
 #include <ored/scripting/context.hpp>
+#include <ored/scripting/paylog.hpp>
+#include <ored/scripting/scriptbytecode.hpp>
 #include <ored/scripting/scriptedinstrument.hpp>
 
 #include <ored/configuration/conventions.hpp>
@@ -41,11 +43,13 @@ public:
                                     const bool interactive = false, const bool amcEnabled = false,
                                     const std::set<std::string>& amcStickyCloseOutStates = {},
                                     const bool generateAdditionalResults = false,
-                                    const bool includePastCashflows = false)
-        : npv_(npv), additionalResults_(additionalResults), model_(model), ast_(ast), context_(context),
-          script_(script), interactive_(interactive), amcEnabled_(amcEnabled),
+                                    const bool includePastCashflows = false, const bool releaseModelMemory = true,
+                                    const std::vector<std::pair<std::string, std::string>>& controlVariates = {})
+        : npv_(npv), additionalResults_(additionalResults), model_(model), ast_(ast),
+          bytecode_(QuantLib::ext::make_shared<ScriptBytecode>(ast)), context_(context), script_(script), interactive_(interactive), amcEnabled_(amcEnabled),
           amcStickyCloseOutStates_(amcStickyCloseOutStates), generateAdditionalResults_(generateAdditionalResults),
-          includePastCashflows_(includePastCashflows) {
+          includePastCashflows_(includePastCashflows), releaseModelMemory_(releaseModelMemory),
+          controlVariates_(controlVariates) {
         registerWith(model_);
     }
 
@@ -54,6 +58,12 @@ public:
 private:
     void calculate() const override;
     Real addMcErrorEstimate(const std::string& label, const ValueType& v) const;
+    // returns the npv adjusted by the control variates using the optimal (least squares) coefficients
+    RandomVariable applyControlVariates(const QuantLib::ext::shared_ptr<Context>& workingContext,
+                                        const RandomVariable& npv) const;
+    // set the npv and additional results from the context after a script run
+    void setResults(const QuantLib::ext::shared_ptr<Context>& workingContext,
+                    const QuantLib::ext::shared_ptr<PayLog>& paylog) const;
 
     // calculation state, true iff calculate() was called at least once and last call went without errors
     mutable bool lastCalculationWasValid_ = false;
@@ -62,6 +72,7 @@ private:
     const std::vector<std::pair<std::string, std::string>> additionalResults_;
     const QuantLib::ext::shared_ptr<Model> model_;
     const ASTNodePtr ast_;
+    const QuantLib::ext::shared_ptr<ScriptBytecode> bytecode_;
     const QuantLib::ext::shared_ptr<Context> context_;
     const std::string script_;
     const bool interactive_;
@@ -69,6 +80,8 @@ private:
     const std::set<std::string> amcStickyCloseOutStates_;
     const bool generateAdditionalResults_;
     const bool includePastCashflows_;
+    const bool releaseModelMemory_;
+    const std::vector<std::pair<std::string, std::string>> controlVariates_;
 };
 
 } // namespace data
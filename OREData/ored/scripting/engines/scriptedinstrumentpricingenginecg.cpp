@@ -75,12 +75,13 @@ ScriptedInstrumentPricingEngineCG::ScriptedInstrumentPricingEngineCG(
     const QuantLib::ext::shared_ptr<Context>& context, const Model::McParams& mcParams, const std::string& script,
     const bool interactive, const bool generateAdditionalResults, const bool includePastCashflows,
     const bool useCachedSensis, const bool useExternalComputeFramework,
-    const bool useDoublePrecisionForExternalCalculation)
+    const bool useDoublePrecisionForExternalCalculation, const bool generateAdGreeks)
     : npv_(npv), additionalResults_(additionalResults), model_(model), ast_(ast), context_(context),
       mcParams_(mcParams), script_(script), interactive_(interactive),
       generateAdditionalResults_(generateAdditionalResults), includePastCashflows_(includePastCashflows),
       useCachedSensis_(useCachedSensis), useExternalComputeFramework_(useExternalComputeFramework),
-      useDoublePrecisionForExternalCalculation_(useDoublePrecisionForExternalCalculation) {
+      useDoublePrecisionForExternalCalculation_(useDoublePrecisionForExternalCalculation),
+      generateAdGreeks_(generateAdGreeks) {
 
     // register with model
 
@@ -93,9 +94,12 @@ ScriptedInstrumentPricingEngineCG::ScriptedInstrumentPricingEngineCG(
         opsExternal_ = getExternalRandomVariableOps();
         gradsExternal_ = getExternalRandomVariableGradients();
     } else {
-        ops_ = getRandomVariableOps(model_->size(), mcParams_.regressionOrder, mcParams_.polynomType, 0.0,
-                                    mcParams_.regressionVarianceCutoff);
-        grads_ = getRandomVariableGradients(model_->size(), mcParams_.regressionOrder, mcParams_.polynomType, 0.2,
+        /* if a smoothing width is given, the indicators are replaced by logistic functions in the forward evaluation
+           and the gradients are the derivatives of these, otherwise only the gradients are smoothed */
+        ops_ = getRandomVariableOps(model_->size(), mcParams_.regressionOrder, mcParams_.polynomType,
+                                    mcParams_.smoothingWidth, mcParams_.regressionVarianceCutoff);
+        grads_ = getRandomVariableGradients(model_->size(), mcParams_.regressionOrder, mcParams_.polynomType,
+                                            mcParams_.smoothingWidth > 0.0 ? mcParams_.smoothingWidth : 0.2,
                                             mcParams_.regressionVarianceCutoff);
     }
 }
@@ -170,6 +174,9 @@ void ScriptedInstrumentPricingEngineCG::calculate() const {
     QL_REQUIRE(!useExternalComputeFramework_ || !useCachedSensis_,
                "ScriptedInstrumentPricingEngineCG: when using external compute framework, usage of cached sensis is "
                "not supported yet");
+    QL_REQUIRE(!useExternalComputeFramework_ || !generateAdGreeks_,
+               "ScriptedInstrumentPricingEngineCG: when using external compute framework, generation of ad greeks is "
+               "not supported yet");
     QL_REQUIRE(model_->trainingSamples() == Null<Size>(), "ScriptedInstrumentPricingEngineCG: separate training phase "
                                                           "not supported, trainingSamples can not be specified.");
 
@@ -315,8 +322,8 @@ void ScriptedInstrumentPricingEngineCG::calculate() const {
                 DLOG("ran forward evaluation");
             }
         } else {
-            forwardEvaluation(*g, values, ops_, RandomVariable::deleter, useCachedSensis_, opNodeRequirements_,
-                              keepNodes);
+            forwardEvaluation(*g, values, ops_, RandomVariable::deleter, useCachedSensis_ || generateAdGreeks_,
+                              opNodeRequirements_, keepNodes);
             DLOG("ran forward evaluation");
         }
 
@@ -335,9 +342,9 @@ void ScriptedInstrumentPricingEngineCG::calculate() const {
 
         // extract additional results
 
-        if (generateAdditionalResults_) {
+        instrumentAdditionalResults_.clear();
 
-            instrumentAdditionalResults_.clear();
+        if (generateAdditionalResults_) {
 
             for (auto const& r : additionalResults_) {
 
@@ -439,7 +446,7 @@ void ScriptedInstrumentPricingEngineCG::calculate() const {
 
         } // if generate additional results
 
-        if (useCachedSensis_) {
+        if (useCachedSensis_ || generateAdGreeks_) {
 
             // extract sensis and store them
 
@@ -453,9 +460,17 @@ void ScriptedInstrumentPricingEngineCG::calculate() const {
             }
             DLOG("got backward sensitivities");
 
+            // set the greeks from the same backward sweep as additional results
+
+            if (generateAdGreeks_) {
+                for (auto const& [label, greek] : model_->greeks(baseModelParams_, sensis_))
+                    instrumentAdditionalResults_["ADGreek_" + label] = greek;
+                DLOG("set ad greeks as additional results");
+            }
+
             // set flag indicating that we can use cached sensis in subsequent calculations
 
-            haveBaseValues_ = true;
+            haveBaseValues_ = useCachedSensis_;
         }
 
     } else {
@@ -481,7 +496,7 @@ void ScriptedInstrumentPricingEngineCG::calculate() const {
         results_.value = npv;
     }
 
-    if (generateAdditionalResults_) {
+    if (generateAdditionalResults_ || generateAdGreeks_) {
         results_.additionalResults = instrumentAdditionalResults_;
     }
 
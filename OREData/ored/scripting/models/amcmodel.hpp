@@ -34,6 +34,8 @@ public:
     virtual void injectPaths(const std::vector<QuantLib::Real>* pathTimes,
                              const std::vector<std::vector<QuantExt::RandomVariable>>* variates,
                              const std::vector<size_t>* pathIndexes, const std::vector<size_t>* timeIndexes) = 0;
+    // the indices of the components of the injected paths that are read, empty if all might be read
+    virtual std::vector<QuantLib::Size> injectedPathIndices() const { return {}; }
 };
 
 } // namespace data
@@ -198,11 +198,14 @@ void BlackScholes::performCalculations() const {
 
     // evolve the process using correlated normal variates and set the underlying path values
 
-    populatePathValues(size(), underlyingPaths_,
-                       makeMultiPathVariateGenerator(mcParams_.sequenceType, indices_.size(),
-                                                     effectiveSimulationDates_.size() - 1, mcParams_.seed,
-                                                     mcParams_.sobolOrdering, mcParams_.sobolDirectionIntegers),
-                       drift, sqrtCov);
+    drift_ = drift;
+    sqrtCov_ = sqrtCov;
+    pathGenerator_ =
+        makeMultiPathVariateGenerator(mcParams_.sequenceType, indices_.size(), effectiveSimulationDates_.size() - 1,
+                                      mcParams_.seed, mcParams_.sobolOrdering, mcParams_.sobolDirectionIntegers);
+    nextPathInGenerator_ = 0;
+    populatePathValues(size(), underlyingPaths_, pathGenerator_, drift_, sqrtCov_);
+    nextPathInGenerator_ = size();
 
     if (trainingSamples() != Null<Size>()) {
         populatePathValues(trainingSamples(), underlyingPathsTraining_,
@@ -279,6 +282,30 @@ void BlackScholes::populatePathValues(const Size nSamples, std::map<Date, std::v
     }
 } // populatePathValues()
 
+void BlackScholes::populatePathChunk() const {
+
+    for (auto const& d : effectiveSimulationDates_)
+        underlyingPaths_[d] = std::vector<RandomVariable>(model_->processes().size(), RandomVariable(size(), 0.0));
+    for (Size l = 0; l < indices_.size(); ++l)
+        underlyingPaths_[*effectiveSimulationDates_.begin()][l].setAll(model_->processes()[l]->x0());
+
+    if (indices_.empty() || effectiveSimulationDates_.size() == 1)
+        return;
+
+    // position the generator at the first path of the chunk, chunks are usually requested in ascending order
+
+    Size firstPath = currentPathChunk_ * mcParams_.pathChunkSize;
+    if (nextPathInGenerator_ > firstPath) {
+        pathGenerator_->reset();
+        nextPathInGenerator_ = 0;
+    }
+    for (; nextPathInGenerator_ < firstPath; ++nextPathInGenerator_)
+        pathGenerator_->next();
+
+    populatePathValues(size(), underlyingPaths_, pathGenerator_, drift_, sqrtCov_);
+    nextPathInGenerator_ += size();
+}
+
 namespace {
 struct comp {
     comp(const std::string& indexInput) : indexInput_(indexInput) {}
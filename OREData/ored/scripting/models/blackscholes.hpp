@@ -64,6 +64,8 @@ private:
                                         const RandomVariable& barrier, const bool above) const override;
     // BlackScholesBase interface implementation
     void performCalculations() const override;
+    bool supportsPathChunks() const override { return true; }
+    void populatePathChunk() const override;
 
     void populatePathValues(const Size nSamples, std::map<Date, std::vector<RandomVariable>>& paths,
                             const QuantLib::ext::shared_ptr<MultiPathVariateGeneratorBase>& gen,
@@ -71,6 +73,12 @@ private:
     // covariance per effective simulation date
     mutable std::vector<Matrix> covariance_;
 
+    // drift, sqrt covariance and generator for the pricing paths, kept to populate further path chunks
+    mutable std::vector<Array> drift_;
+    mutable std::vector<Matrix> sqrtCov_;
+    mutable QuantLib::ext::shared_ptr<MultiPathVariateGeneratorBase> pathGenerator_;
+    mutable Size nextPathInGenerator_ = 0;
+
     // the calibration to use, ATM or Deal
     const std::string calibration_;
 
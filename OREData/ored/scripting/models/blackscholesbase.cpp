@@ -133,6 +133,7 @@ void BlackScholesBase::performCalculations() const {
 
     underlyingPaths_.clear();
     underlyingPathsTraining_.clear();
+    currentPathChunk_ = 0;
 }
 
 RandomVariable BlackScholesBase::getIndexValue(const Size indexNo, const Date& d, const Date& fwd) const {
@@ -269,18 +270,33 @@ RandomVariable BlackScholesBase::npv(const RandomVariable& amount, const Date& o
     Array coeff;
     Matrix coordinateTransform;
 
-    // if a memSlot is given and coefficients / coordinate transform are stored, we use them
+    /* the regression model is stored if a memSlot is given; if the paths are split into chunks, the models of the
+       other calls are stored as well, keyed by the call number, so that all chunks use the models from the first one */
 
-    bool haveStoredModel = false;
+    std::map<long, std::tuple<Array, Size, Matrix>>* regressionModelStore = nullptr;
+    long regressionModelKey = 0;
 
     if (memSlot) {
-        if (auto it = storedRegressionModel_.find(*memSlot); it != storedRegressionModel_.end()) {
+        regressionModelStore = &storedRegressionModel_;
+        regressionModelKey = *memSlot;
+    } else if (numberOfPathChunks() > 1) {
+        regressionModelStore = &pathChunkRegressionModel_;
+        regressionModelKey = static_cast<long>(npvCallCounter_++);
+    }
+
+    // if coefficients / coordinate transform are stored, we use them
+
+    bool haveStoredModel = false;
+
+    if (regressionModelStore) {
+        if (auto it = regressionModelStore->find(regressionModelKey); it != regressionModelStore->end()) {
             coeff = std::get<0>(it->second);
             coordinateTransform = std::get<2>(it->second);
             QL_REQUIRE(std::get<1>(it->second) == state.size(),
-                       "BlackScholesBase::npv(): stored regression coefficients at mem slot "
-                           << *memSlot << " are for state size " << std::get<1>(it->second) << ", actual state size is "
-                           << state.size() << " (before possible coordinate transform).");
+                       "BlackScholesBase::npv(): stored regression coefficients at "
+                           << (memSlot ? "mem slot " : "call #") << regressionModelKey << " are for state size "
+                           << std::get<1>(it->second) << ", actual state size is " << state.size()
+                           << " (before possible coordinate transform).");
             haveStoredModel = true;
         }
     }
@@ -312,8 +328,8 @@ RandomVariable BlackScholesBase::npv(const RandomVariable& amount, const Date& o
 
         // store model if requried
 
-        if (memSlot) {
-            storedRegressionModel_[*memSlot] = std::make_tuple(coeff, nModelStates, coordinateTransform);
+        if (regressionModelStore) {
+            (*regressionModelStore)[regressionModelKey] = std::make_tuple(coeff, nModelStates, coordinateTransform);
         }
 
     } else {
@@ -339,11 +355,15 @@ void BlackScholesBase::releaseMemory() {
     underlyingPathsTraining_.clear();
 }
 
-void BlackScholesBase::resetNPVMem() { storedRegressionModel_.clear(); }
+void BlackScholesBase::resetNPVMem() {
+    storedRegressionModel_.clear();
+    pathChunkRegressionModel_.clear();
+}
 
 void BlackScholesBase::toggleTrainingPaths() const {
     std::swap(underlyingPaths_, underlyingPathsTraining_);
     inTrainingPhase_ = !inTrainingPhase_;
+    npvCallCounter_ = 0;
 }
 
 Size BlackScholesBase::trainingSamples() const { return mcParams_.trainingSamples; }
@@ -351,9 +371,30 @@ Size BlackScholesBase::trainingSamples() const { return mcParams_.trainingSample
 Size BlackScholesBase::size() const {
     if (inTrainingPhase_)
         return mcParams_.trainingSamples;
+    else if (numberOfPathChunks() > 1)
+        return std::min(mcParams_.pathChunkSize, Model::size() - currentPathChunk_ * mcParams_.pathChunkSize);
     else
         return Model::size();
 }
 
+Size BlackScholesBase::numberOfPathChunks() const {
+    if (!supportsPathChunks() || mcParams_.pathChunkSize == Null<Size>() || mcParams_.pathChunkSize == 0 ||
+        mcParams_.pathChunkSize >= Model::size())
+        return 1;
+    return (Model::size() + mcParams_.pathChunkSize - 1) / mcParams_.pathChunkSize;
+}
+
+void BlackScholesBase::setPathChunk(const Size chunk) const {
+    calculate();
+    QL_REQUIRE(chunk < numberOfPathChunks(), "BlackScholesBase::setPathChunk(): chunk " << chunk << " out of range, have "
+                                                                                        << numberOfPathChunks()
+                                                                                        << " path chunks");
+    npvCallCounter_ = 0;
+    if (chunk != currentPathChunk_ || underlyingPaths_.empty()) {
+        currentPathChunk_ = chunk;
+        populatePathChunk();
+    }
+}
+
 } // namespace data
 } // namespace ore
@@ -80,6 +80,8 @@ public:
     void toggleTrainingPaths() const override;
     Size trainingSamples() const override;
     Size size() const override;
+    Size numberOfPathChunks() const override;
+    void setPathChunk(const Size chunk) const override;
 
 protected:
     // ModelImpl interface implementation (except initiModelState, this is done in the derived classes)
@@ -94,6 +96,11 @@ protected:
     // helper function that constructs the correlation matrix
     Matrix getCorrelation() const;
 
+    /* path chunks (mcParams_.pathChunkSize) are only used if supported by the derived class, which then has to
+       populate underlyingPaths_ for currentPathChunk_ with size() paths in populatePathChunk() */
+    virtual bool supportsPathChunks() const { return false; }
+    virtual void populatePathChunk() const {}
+
     // input parameters
     const std::vector<Handle<YieldTermStructure>> curves_;
     const std::vector<Handle<Quote>> fxSpots_;
@@ -111,8 +118,13 @@ protected:
     mutable std::map<Date, std::vector<RandomVariable>> underlyingPathsTraining_; // ditto (training phase)
     mutable bool inTrainingPhase_ = false; // are we currently using training paths?
 
-    // stored regression coefficients
+    // path chunk the pricing paths refer to
+    mutable Size currentPathChunk_ = 0;
+
+    // stored regression coefficients, by mem slot and, if the paths are chunked, by npv() call number
     mutable std::map<long, std::tuple<Array, Size, Matrix>> storedRegressionModel_;
+    mutable std::map<long, std::tuple<Array, Size, Matrix>> pathChunkRegressionModel_;
+    mutable Size npvCallCounter_ = 0;
 };
 
 } // namespace data
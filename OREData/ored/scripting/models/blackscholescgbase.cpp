@@ -19,6 +19,7 @@
 #include <ored/scripting/models/blackscholescgbase.hpp>
 
 #include <ored/utilities/indexparser.hpp>
+#include <ored/utilities/parsers.hpp>
 #include <ored/utilities/to_string.hpp>
 
 #include <qle/cashflows/averageonindexedcoupon.hpp>
@@ -32,6 +33,8 @@
 #include <ql/math/matrixutilities/pseudosqrt.hpp>
 #include <ql/quotes/simplequote.hpp>
 
+#include <boost/algorithm/string/predicate.hpp>
+
 namespace ore {
 namespace data {
 
@@ -257,6 +260,63 @@ Real BlackScholesCGBase::getDirectDiscountT0(const Date& paydate, const std::str
     return curves_.at(cidx)->discount(paydate);
 }
 
+std::map<std::string, Real>
+BlackScholesCGBase::greeks(const std::vector<std::pair<std::size_t, double>>& modelParameters,
+                           const std::vector<double>& sensitivities) const {
+
+    QL_REQUIRE(modelParameters.size() == sensitivities.size(), "BlackScholesCGBase::greeks(): model parameters size ("
+                                                                   << modelParameters.size()
+                                                                   << ") does not match sensitivities size ("
+                                                                   << sensitivities.size() << ")");
+
+    // splits an id of the form <prefix><no>_<date> into no and date
+
+    auto splitId = [](const std::string& id, const std::string& prefix) {
+        std::string tmp = id.substr(prefix.size());
+        auto pos = tmp.find('_');
+        QL_REQUIRE(pos != std::string::npos, "BlackScholesCGBase::greeks(): can not split model parameter id '" << id
+                                                                                                          << "'");
+        return std::make_pair(static_cast<Size>(std::stoul(tmp.substr(0, pos))), parseDate(tmp.substr(pos + 1)));
+    };
+
+    // sensitivity of a discount factor p = exp(-z t) to the continuously compounded zero rate z
+
+    auto zeroRateSensi = [this](const Date& d, const Real p, const Real sensi) {
+        return -ActualActual(ActualActual::ISDA).yearFraction(referenceDate(), d) * p * sensi;
+    };
+
+    /* spot deltas are w.r.t. the index spots, rate deltas w.r.t. the continuously compounded zero rates of the curves
+       and the index processes' rate and dividend curves, fx deltas w.r.t. the fx spots; the sensitivities w.r.t. all
+       other model parameters (e.g. covariances) are labelled by their id */
+
+    auto ids = modelParameterIds(modelParameters);
+    std::map<std::string, Real> result;
+    for (Size i = 0; i < modelParameters.size(); ++i) {
+        const std::string& id = ids.at(modelParameters[i].first);
+        Real p = modelParameters[i].second;
+        Real s = sensitivities[i];
+        if (boost::starts_with(id, "__x0_")) {
+            Size j = std::stoul(id.substr(5));
+            result["Delta_" + indices_.at(j).name()] += s / std::exp(p);
+        } else if (boost::starts_with(id, "__curve_")) {
+            auto [idx, d] = splitId(id, "__curve_");
+            result["RateDelta_" + currencies_.at(idx) + "_" + ore::data::to_string(d)] += zeroRateSensi(d, p, s);
+        } else if (boost::starts_with(id, "__rfr_")) {
+            auto [j, d] = splitId(id, "__rfr_");
+            result["RateDelta_" + indices_.at(j).name() + "_Rfr_" + ore::data::to_string(d)] += zeroRateSensi(d, p, s);
+        } else if (boost::starts_with(id, "__div_")) {
+            auto [j, d] = splitId(id, "__div_");
+            result["RateDelta_" + indices_.at(j).name() + "_Div_" + ore::data::to_string(d)] += zeroRateSensi(d, p, s);
+        } else if (boost::starts_with(id, "__fxspot_")) {
+            Size idx = std::stoul(id.substr(9));
+            result["FxDelta_" + currencies_.at(idx + 1) + currencies_.front()] += s;
+        } else {
+            result[id] += s;
+        }
+    }
+    return result;
+}
+
 std::size_t BlackScholesCGBase::npv(const std::size_t amount, const Date& obsdate, const std::size_t filter,
                                     const boost::optional<long>& memSlot, const std::size_t addRegressor1,
                                     const std::size_t addRegressor2) const {
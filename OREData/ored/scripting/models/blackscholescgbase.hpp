@@ -80,6 +80,10 @@ public:
     Real getDirectFxSpotT0(const std::string& forCcy, const std::string& domCcy) const override;
     Real getDirectDiscountT0(const Date& paydate, const std::string& currency) const override;
 
+    // greeks w.r.t. spots, zero rates and fx spots, see ModelCG
+    std::map<std::string, Real> greeks(const std::vector<std::pair<std::size_t, double>>& modelParameters,
+                                       const std::vector<double>& sensitivities) const override;
+
 protected:
     // ModelImpl interface implementation
     void performCalculations() const override;
@@ -76,6 +76,7 @@ public:
     void injectPaths(const std::vector<QuantLib::Real>* pathTimes,
                      const std::vector<std::vector<QuantExt::RandomVariable>>* paths,
                      const std::vector<size_t>* pathIndexes, const std::vector<size_t>* timeIndexes) override;
+    std::vector<Size> injectedPathIndices() const override { return projectedStateProcessIndices_; }
 
 private:
     // ModelImpl interface implementation
@@ -31,6 +31,23 @@ namespace data {
 using namespace QuantLib;
 using namespace QuantExt;
 
+namespace {
+// the number of points and the width in standard deviations around the forward of the local vol grids
+constexpr Size localVolGridPoints = 201;
+constexpr Real localVolGridStdDevs = 6.0;
+
+// local vol might throw / return nan, inf, we handle these cases by setting the local vol to zero
+Real safeLocalVol(const QuantLib::ext::shared_ptr<GeneralizedBlackScholesProcess>& process, const Real t,
+                  const Real spot) {
+    Real vol = 0.0;
+    try {
+        vol = process->localVolatility()->localVol(t, spot);
+    } catch (...) {
+    }
+    return std::isfinite(vol) ? vol : 0.0;
+}
+} // namespace
+
 LocalVol::LocalVol(const Size paths, const std::string& currency, const Handle<YieldTermStructure>& curve,
                    const std::string& index, const std::string& indexCurrency,
                    const Handle<BlackScholesModelWrapper>& model, const McParams& mcParams,
@@ -129,32 +146,80 @@ void LocalVol::performCalculations() const {
         sqrtdt[i] = std::sqrt(dt[i]);
     }
 
+    // precompute the local vol on the time steps, shared by the pricing and training paths
+
+    auto localVolGrid = localVolGrids(deterministicDrift, t, dt);
+
     // evolve the process using correlated normal variates and set the underlying path values
 
     populatePathValues(size(), underlyingPaths_,
                        makeMultiPathVariateGenerator(mcParams_.sequenceType, indices_.size(), timeGrid_.size() - 1,
                                                      mcParams_.seed, mcParams_.sobolOrdering,
                                                      mcParams_.sobolDirectionIntegers),
-                       correlation, sqrtCorr, deterministicDrift, eqComIdx, t, dt, sqrtdt);
+                       correlation, sqrtCorr, deterministicDrift, eqComIdx, t, dt, sqrtdt, localVolGrid);
 
     if (trainingSamples() != Null<Size>()) {
         populatePathValues(trainingSamples(), underlyingPathsTraining_,
                            makeMultiPathVariateGenerator(mcParams_.trainingSequenceType, indices_.size(),
                                                          timeGrid_.size() - 1, mcParams_.trainingSeed,
                                                          mcParams_.sobolOrdering, mcParams_.sobolDirectionIntegers),
-                           correlation, sqrtCorr, deterministicDrift, eqComIdx, t, dt, sqrtdt);
+                           correlation, sqrtCorr, deterministicDrift, eqComIdx, t, dt, sqrtdt, localVolGrid);
     }
 
 } // initPaths()
 
+Real LocalVol::LocalVolGrid::operator()(const Real logSpot) const {
+    Real s = (logSpot - xMin) / h;
+    if (!(s > 0.0))
+        return values.front();
+    if (s >= static_cast<Real>(values.size() - 1))
+        return values.back();
+    Size k = static_cast<Size>(s);
+    Real w = s - static_cast<Real>(k);
+    return (1.0 - w) * values[k] + w * values[k + 1];
+}
+
+std::vector<std::vector<LocalVol::LocalVolGrid>>
+LocalVol::localVolGrids(const std::vector<Array>& deterministicDrift, const std::vector<Real>& t,
+                        const std::vector<Real>& dt) const {
+
+    /* the grid of a time step is centered at the log forward and spans a multiple of the atm standard deviation to
+       the end of the step, so that the paths evaluate the local vol surface only once per grid point */
+
+    std::vector<std::vector<LocalVolGrid>> result(indices_.size(), std::vector<LocalVolGrid>(t.size()));
+    for (Size j = 0; j < indices_.size(); ++j) {
+        auto const& process = model_->processes()[j];
+        Real logForward = std::log(process->x0());
+        for (Size i = 0; i < t.size(); ++i) {
+            Real t1 = t[i] + dt[i];
+            Real stdDev = 0.0;
+            try {
+                stdDev = process->blackVolatility()->blackVol(t1, std::exp(logForward), true) * std::sqrt(t1);
+            } catch (...) {
+            }
+            // ensure a minimum width of the grid, this also covers a failing or zero atm vol
+            stdDev = std::max(std::isfinite(stdDev) ? stdDev : 0.0, 0.05);
+            LocalVolGrid& g = result[j][i];
+            g.xMin = logForward - localVolGridStdDevs * stdDev;
+            g.h = 2.0 * localVolGridStdDevs * stdDev / static_cast<Real>(localVolGridPoints - 1);
+            g.values.resize(localVolGridPoints);
+            for (Size k = 0; k < localVolGridPoints; ++k)
+                g.values[k] = safeLocalVol(process, t[i], std::exp(g.xMin + static_cast<Real>(k) * g.h));
+            logForward += deterministicDrift[i][j];
+        }
+    }
+    return result;
+}
+
 void LocalVol::populatePathValues(const Size nSamples, std::map<Date, std::vector<RandomVariable>>& paths,
                                   const QuantLib::ext::shared_ptr<MultiPathVariateGeneratorBase>& gen,
                                   const Matrix& correlation, const Matrix& sqrtCorr,
                                   const std::vector<Array>& deterministicDrift, const std::vector<Size>& eqComIdx,
                                   const std::vector<Real>& t, const std::vector<Real>& dt,
-                                  const std::vector<Real>& sqrtdt) const {
+                                  const std::vector<Real>& sqrtdt,
+                                  const std::vector<std::vector<LocalVolGrid>>& localVolGrid) const {
 
-    Array stateDiff(indices_.size()), logState(indices_.size()), logState0(indices_.size());
+    Array stateDiff(indices_.size()), logState(indices_.size()), logState0(indices_.size()), vol(indices_.size());
     for (Size j = 0; j < indices_.size(); ++j) {
         logState0[j] = std::log(model_->processes()[j]->x0());
     }
@@ -170,7 +235,7 @@ void LocalVol::populatePathValues(const Size nSamples, std::map<Date, std::vecto
         }
     }
 
-    for (Size path = 0; path < size(); ++path) {
+    for (Size path = 0; path < nSamples; ++path) {
         auto p = gen->next();
         logState = logState0;
         std::size_t date = 0;
@@ -178,16 +243,10 @@ void LocalVol::populatePathValues(const Size nSamples, std::map<Date, std::vecto
         ++pos;
         // evolve the process on the refined time grid
         for (Size i = 0; i < timeGrid_.size() - 1; ++i) {
+            for (Size j = 0; j < indices_.size(); ++j)
+                vol[j] = localVolGrid[j][i](logState[j]);
             for (Size j = 0; j < indices_.size(); ++j) {
-                // localVol might throw / return nan, inf, handle these cases here
-                // by setting the local vol to zero
-                Real volj = 0.0;
-                try {
-                    volj = model_->processes()[j]->localVolatility()->localVol(t[i], std::exp(logState[j]));
-                } catch (...) {
-                }
-                if (!std::isfinite(volj))
-                    volj = 0.0;
+                Real volj = vol[j];
                 Real dw = 0;
                 for (Size k = 0; k < indices_.size(); ++k) {
                     dw += sqrtCorr[j][k] * p.value[i][k];
@@ -195,9 +254,7 @@ void LocalVol::populatePathValues(const Size nSamples, std::map<Date, std::vecto
                 stateDiff[j] = volj * dw * sqrtdt[i] - 0.5 * volj * volj * dt[i];
                 // drift adjustment for eq / com indices that are not in base ccy
                 if (eqComIdx[j] != Null<Size>()) {
-                    Real volIdx = model_->processes()[eqComIdx[j]]->localVolatility()->localVol(
-                        t[i], std::exp(logState[eqComIdx[j]]));
-                    stateDiff[j] -= correlation[eqComIdx[j]][j] * volIdx * volj * dt[i];
+                    stateDiff[j] -= correlation[eqComIdx[j]][j] * vol[eqComIdx[j]] * volj * dt[i];
                 }
             }
             // update state with stateDiff from above and deterministic part of the drift
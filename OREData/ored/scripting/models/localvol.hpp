@@ -63,12 +63,26 @@ private:
     // BlackScholesBase interface implementation
     void performCalculations() const override;
 
+    /* local vol of one index at one time step on a uniform log spot grid, linearly interpolated between the grid
+       points and flat extrapolated outside the grid */
+    struct LocalVolGrid {
+        Real xMin = 0.0, h = 1.0;
+        std::vector<Real> values;
+        Real operator()(const Real logSpot) const;
+    };
+
+    // helper method to precompute the local vol grids, by index and time step
+    std::vector<std::vector<LocalVolGrid>> localVolGrids(const std::vector<Array>& deterministicDrift,
+                                                         const std::vector<Real>& t,
+                                                         const std::vector<Real>& dt) const;
+
     // helper method to populate path values
     void populatePathValues(const Size nSamples, std::map<Date, std::vector<RandomVariable>>& paths,
                             const QuantLib::ext::shared_ptr<MultiPathVariateGeneratorBase>& gen, const Matrix& correlation,
                             const Matrix& sqrtCorr, const std::vector<Array>& deterministicDrift,
                             const std::vector<Size>& eqComIdx, const std::vector<Real>& t, const std::vector<Real>& dt,
-                            const std::vector<Real>& sqrtdt) const;
+                            const std::vector<Real>& sqrtdt,
+                            const std::vector<std::vector<LocalVolGrid>>& localVolGrid) const;
 };
 
 } // namespace data
@@ -37,6 +37,8 @@
 #include <boost/any.hpp>
 #include <boost/enable_shared_from_this.hpp>
 
+#include <mutex>
+
 namespace ore {
 namespace data {
 
@@ -59,6 +61,8 @@ public:
         QuantLib::SobolBrownianGenerator::Ordering sobolOrdering = QuantLib::SobolBrownianGenerator::Steps;
         QuantLib::SobolRsg::DirectionIntegers sobolDirectionIntegers = QuantLib::SobolRsg::DirectionIntegers::JoeKuoD7;
         QuantLib::Real regressionVarianceCutoff = Null<QuantLib::Real>();
+        Size pathChunkSize = Null<Size>();
+        QuantLib::Real smoothingWidth = 0.0;
     };
 
     explicit Model(const Size n) : n_(n) {}
@@ -98,6 +102,14 @@ public:
     // refdate <= obsdate <= paydate required
     virtual RandomVariable discount(const Date& obsdate, const Date& paydate, const std::string& currency) const = 0;
 
+    /* number of chunks the paths are split into, if this is greater than one, the script is run on each chunk
+       separately and the results are averaged, the default implementation does not split the paths */
+    virtual Size numberOfPathChunks() const { return 1; }
+
+    /* set the chunk of paths the model operates on, size() is the number of paths in this chunk afterwards; the
+       conditional expectations computed on the first chunk (or the training paths) are reused on the other chunks */
+    virtual void setPathChunk(const Size chunk) const {}
+
     // refdate <= obsdate required
     virtual RandomVariable npv(const RandomVariable& amount, const Date& obsdate, const Filter& filter,
                                const boost::optional<long>& memSlot, const RandomVariable& addRegressor1,
@@ -145,6 +157,11 @@ public:
     // additional results provided by the model
     const std::map<std::string, boost::any>& additionalResults() const { return additionalResults_; }
 
+    /* Mutex guarding the model state, pricing engines running scripts on this model lock it for the duration of a
+       pricing, so that engines sharing a model can be calculated from different threads. Engines using different
+       model instances do not contend on this. */
+    std::recursive_mutex& mutex() const { return mutex_; }
+
 protected:
     // default implementation lazy object interface
     void performCalculations() const override {}
@@ -155,6 +172,7 @@ protected:
 private:
     // size of random variables within model
     const Size n_;
+    mutable std::recursive_mutex mutex_;
 };
 
 } // namespace data
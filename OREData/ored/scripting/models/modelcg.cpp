@@ -29,5 +29,30 @@ std::size_t ModelCG::dt(const Date& d1, const Date& d2) const {
     return cg_const(*g_, QuantLib::ActualActual(QuantLib::ActualActual::ISDA).yearFraction(d1, d2));
 }
 
+std::map<std::size_t, std::string>
+ModelCG::modelParameterIds(const std::vector<std::pair<std::size_t, double>>& modelParameters) const {
+    std::map<std::size_t, std::string> ids;
+    for (auto const& p : modelParameters)
+        ids[p.first];
+    for (auto const& [id, node] : g_->variables()) {
+        if (auto i = ids.find(node); i != ids.end())
+            i->second = id;
+    }
+    return ids;
+}
+
+std::map<std::string, Real> ModelCG::greeks(const std::vector<std::pair<std::size_t, double>>& modelParameters,
+                                            const std::vector<double>& sensitivities) const {
+    QL_REQUIRE(modelParameters.size() == sensitivities.size(), "ModelCG::greeks(): model parameters size ("
+                                                                   << modelParameters.size()
+                                                                   << ") does not match sensitivities size ("
+                                                                   << sensitivities.size() << ")");
+    auto ids = modelParameterIds(modelParameters);
+    std::map<std::string, Real> result;
+    for (Size i = 0; i < modelParameters.size(); ++i)
+        result[ids.at(modelParameters[i].first)] += sensitivities[i];
+    return result;
+}
+
 } // namespace data
 } // namespace ore
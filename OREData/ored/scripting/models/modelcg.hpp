@@ -132,6 +132,11 @@ public:
     virtual std::vector<std::pair<std::size_t, double>> modelParameters() const = 0;
     virtual std::vector<std::pair<std::size_t, std::function<double(void)>>>& modelParameterFunctors() const = 0;
 
+    /* translate the sensitivities w.r.t. the model parameters (as given by modelParameters()) to labelled greeks,
+       the default implementation labels the sensitivities by the id of the model parameter in the cg */
+    virtual std::map<std::string, Real> greeks(const std::vector<std::pair<std::size_t, double>>& modelParameters,
+                                               const std::vector<double>& sensitivities) const;
+
     // get fx spot as of today directly, i.e. bypassing the cg
     virtual Real getDirectFxSpotT0(const std::string& forCcy, const std::string& domCcy) const = 0;
 
@@ -142,6 +147,10 @@ public:
     void calculate() const override { LazyObject::calculate(); }
 
 protected:
+    // the id of the model parameters in the cg, keyed by node
+    std::map<std::size_t, std::string> modelParameterIds(
+        const std::vector<std::pair<std::size_t, double>>& modelParameters) const;
+
     // map with additional results provided by this model instance
     mutable std::map<std::string, boost::any> additionalResults_;
 
@@ -616,6 +616,7 @@ private:
 ASTNodePtr generateRandomAST(const Size maxSequenceLength, const Size maxDepth, const Size seed) {
     RandomASTGenerator gen(maxSequenceLength, maxDepth, seed);
     gen.createInstructionSequence();
+    indexVariableNodes(gen.current);
     return gen.current;
 }
 
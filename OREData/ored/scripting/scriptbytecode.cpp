@@ -0,0 +1,319 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/scripting/scriptbytecode.hpp>
+
+#include <ql/errors.hpp>
+
+#include <map>
+
+namespace ore {
+namespace data {
+
+class ScriptBytecodeCompiler : public AcyclicVisitor,
+                               public Visitor<ASTNode>,
+                               public Visitor<OperatorPlusNode>,
+                               public Visitor<OperatorMinusNode>,
+                               public Visitor<OperatorMultiplyNode>,
+                               public Visitor<OperatorDivideNode>,
+                               public Visitor<NegateNode>,
+                               public Visitor<FunctionAbsNode>,
+                               public Visitor<FunctionExpNode>,
+                               public Visitor<FunctionLogNode>,
+                               public Visitor<FunctionSqrtNode>,
+                               public Visitor<FunctionNormalCdfNode>,
+                               public Visitor<FunctionNormalPdfNode>,
+                               public Visitor<FunctionMinNode>,
+                               public Visitor<FunctionMaxNode>,
+                               public Visitor<FunctionPowNode>,
+                               public Visitor<ConditionEqNode>,
+                               public Visitor<ConditionNeqNode>,
+                               public Visitor<ConditionLtNode>,
+                               public Visitor<ConditionLeqNode>,
+                               public Visitor<ConditionGtNode>,
+                               public Visitor<ConditionGeqNode>,
+                               public Visitor<ConditionNotNode>,
+                               public Visitor<ConditionAndNode>,
+                               public Visitor<ConditionOrNode>,
+                               public Visitor<ConstantNumberNode>,
+                               public Visitor<VariableNode>,
+                               public Visitor<AssignmentNode>,
+                               public Visitor<RequireNode>,
+                               public Visitor<SequenceNode>,
+                               public Visitor<IfThenElseNode>,
+                               public Visitor<LoopNode> {
+public:
+    using OpCode = ScriptBytecode::OpCode;
+
+    explicit ScriptBytecodeCompiler(ScriptBytecode& bytecode) : bytecode_(bytecode) {}
+
+    void compileStatement(const ASTNodePtr& n, const Size depth) { compile(n, depth, false); }
+
+    void compileExpression(const ASTNodePtr& n, const Size depth) {
+        bytecode_.numberOfRegisters_ = std::max(bytecode_.numberOfRegisters_, depth + 1);
+        compile(n, depth, true);
+    }
+
+    // nodes that are not compiled are delegated to the ast visitor of the engine
+
+    void visit(ASTNode& n) override {
+        if (expression_)
+            emit(OpCode::Eval, n).r = depth_;
+        else
+            emit(OpCode::Exec, n);
+    }
+
+    void visit(OperatorPlusNode& n) override { binaryOp(n, OpCode::Add); }
+    void visit(OperatorMinusNode& n) override { binaryOp(n, OpCode::Subtract); }
+    void visit(OperatorMultiplyNode& n) override { binaryOp(n, OpCode::Multiply); }
+    void visit(OperatorDivideNode& n) override { binaryOp(n, OpCode::Divide); }
+    void visit(NegateNode& n) override { unaryOp(n, OpCode::Negate); }
+    void visit(FunctionAbsNode& n) override { unaryOp(n, OpCode::Abs); }
+    void visit(FunctionExpNode& n) override { unaryOp(n, OpCode::Exp); }
+    void visit(FunctionLogNode& n) override { unaryOp(n, OpCode::Log); }
+    void visit(FunctionSqrtNode& n) override { unaryOp(n, OpCode::Sqrt); }
+    void visit(FunctionNormalCdfNode& n) override { unaryOp(n, OpCode::NormalCdf); }
+    void visit(FunctionNormalPdfNode& n) override { unaryOp(n, OpCode::NormalPdf); }
+    void visit(FunctionMinNode& n) override { binaryOp(n, OpCode::Min); }
+    void visit(FunctionMaxNode& n) override { binaryOp(n, OpCode::Max); }
+    void visit(FunctionPowNode& n) override { binaryOp(n, OpCode::Pow); }
+    void visit(ConditionEqNode& n) override { binaryOp(n, OpCode::Eq); }
+    void visit(ConditionNeqNode& n) override { binaryOp(n, OpCode::Neq); }
+    void visit(ConditionLtNode& n) override { binaryOp(n, OpCode::Lt); }
+    void visit(ConditionLeqNode& n) override { binaryOp(n, OpCode::Leq); }
+    void visit(ConditionGtNode& n) override { binaryOp(n, OpCode::Gt); }
+    void visit(ConditionGeqNode& n) override { binaryOp(n, OpCode::Geq); }
+    void visit(ConditionNotNode& n) override { unaryOp(n, OpCode::Not); }
+    void visit(ConditionAndNode& n) override { shortcutOp(n, OpCode::AndShortcut, OpCode::And); }
+    void visit(ConditionOrNode& n) override { shortcutOp(n, OpCode::OrShortcut, OpCode::Or); }
+
+    void visit(ConstantNumberNode& n) override {
+        if (!expression_)
+            return visit(static_cast<ASTNode&>(n));
+        auto& i = emit(OpCode::Constant, n);
+        i.r = depth_;
+        i.value = n.value;
+    }
+
+    void visit(VariableNode& n) override {
+        if (!expression_)
+            return visit(static_cast<ASTNode&>(n));
+        Size d = depth_;
+        if (n.args[0]) {
+            compileExpression(n.args[0], d);
+            auto& i = emit(OpCode::LoadArray, n);
+            i.r = i.a = d;
+            i.slot = slot(n.name);
+        } else {
+            auto& i = emit(OpCode::LoadScalar, n);
+            i.r = d;
+            i.slot = slot(n.name);
+        }
+    }
+
+    void visit(AssignmentNode& n) override {
+        auto v = QuantLib::ext::dynamic_pointer_cast<VariableNode>(n.args[0]);
+        if (expression_ || !v)
+            return visit(static_cast<ASTNode&>(n));
+        Size d = depth_;
+        compileExpression(n.args[1], d);
+        Size check = instructions().size();
+        emit(OpCode::AssignCheck, n).slot = slot(v->name);
+        if (v->args[0]) {
+            compileExpression(v->args[0], d + 1);
+            auto& i = emit(OpCode::AssignArray, n);
+            i.a = d;
+            i.b = d + 1;
+            i.slot = slot(v->name);
+        } else {
+            auto& i = emit(OpCode::AssignScalar, n);
+            i.a = d;
+            i.slot = slot(v->name);
+        }
+        instructions()[check].target = instructions().size();
+    }
+
+    void visit(RequireNode& n) override {
+        if (expression_)
+            return visit(static_cast<ASTNode&>(n));
+        compileExpression(n.args[0], depth_);
+        emit(OpCode::Require, n).a = depth_;
+    }
+
+    void visit(SequenceNode& n) override {
+        if (expression_)
+            return visit(static_cast<ASTNode&>(n));
+        Size d = depth_;
+        for (auto const& arg : n.args)
+            compileStatement(arg, d);
+    }
+
+    void visit(IfThenElseNode& n) override {
+        if (expression_)
+            return visit(static_cast<ASTNode&>(n));
+        Size d = depth_;
+        compileExpression(n.args[0], d);
+        branch(n, OpCode::FilterThen, n.args[1], d);
+        if (n.args[2])
+            branch(n, OpCode::FilterElse, n.args[2], d);
+    }
+
+    void visit(LoopNode& n) override {
+        if (expression_)
+            return visit(static_cast<ASTNode&>(n));
+        Size d = depth_;
+        Size loop = bytecode_.numberOfLoops_++;
+        compileExpression(n.args[0], d);
+        compileExpression(n.args[1], d + 1);
+        compileExpression(n.args[2], d + 2);
+        Size start = instructions().size();
+        auto& i = emit(OpCode::LoopStart, n);
+        i.r = loop;
+        i.a = d;
+        i.b = d + 1;
+        i.c = d + 2;
+        i.slot = slot(n.name);
+        compileStatement(n.args[3], d);
+        auto& j = emit(OpCode::LoopEnd, n);
+        j.r = loop;
+        j.slot = slot(n.name);
+        j.target = start + 1;
+        instructions()[start].target = instructions().size();
+    }
+
+private:
+    std::vector<ScriptBytecode::Instruction>& instructions() { return bytecode_.instructions_; }
+
+    ScriptBytecode::Instruction& emit(const OpCode op, ASTNode& n) {
+        instructions().push_back(ScriptBytecode::Instruction());
+        instructions().back().op = op;
+        instructions().back().node = &n;
+        return instructions().back();
+    }
+
+    Size slot(const std::string& name) {
+        auto s = slots_.find(name);
+        if (s != slots_.end())
+            return s->second;
+        bytecode_.variables_.push_back(name);
+        return slots_[name] = bytecode_.variables_.size() - 1;
+    }
+
+    void compile(const ASTNodePtr& n, const Size depth, const bool expression) {
+        QL_REQUIRE(n, "ScriptBytecode: internal error, node is null");
+        Size d = depth_;
+        bool e = expression_;
+        depth_ = depth;
+        expression_ = expression;
+        n->accept(*this);
+        depth_ = d;
+        expression_ = e;
+    }
+
+    void unaryOp(ASTNode& n, const OpCode op) {
+        if (!expression_)
+            return visit(n);
+        Size d = depth_;
+        compileExpression(n.args[0], d);
+        auto& i = emit(op, n);
+        i.r = i.a = d;
+    }
+
+    void binaryOp(ASTNode& n, const OpCode op) {
+        if (!expression_)
+            return visit(n);
+        Size d = depth_;
+        compileExpression(n.args[0], d);
+        compileExpression(n.args[1], d + 1);
+        auto& i = emit(op, n);
+        i.r = i.a = d;
+        i.b = d + 1;
+    }
+
+    // the right hand side is not evaluated if the left hand side already determines the result
+
+    void shortcutOp(ASTNode& n, const OpCode shortcut, const OpCode op) {
+        if (!expression_)
+            return visit(n);
+        Size d = depth_;
+        compileExpression(n.args[0], d);
+        Size s = instructions().size();
+        auto& i = emit(shortcut, n);
+        i.r = i.a = d;
+        compileExpression(n.args[1], d + 1);
+        auto& j = emit(op, n);
+        j.r = j.a = d;
+        j.b = d + 1;
+        instructions()[s].target = instructions().size();
+    }
+
+    // a branch of an if-then-else, the condition in register d is kept until the else branch is done
+
+    void branch(ASTNode& n, const OpCode op, const ASTNodePtr& body, const Size d) {
+        Size s = instructions().size();
+        emit(op, n).a = d;
+        compileStatement(body, d + 1);
+        instructions()[s].target = instructions().size();
+        emit(OpCode::FilterPop, n);
+    }
+
+    ScriptBytecode& bytecode_;
+    std::map<std::string, Size> slots_;
+    Size depth_ = 0;
+    bool expression_ = false;
+};
+
+ScriptBytecode::ScriptBytecode(const ASTNodePtr root) : root_(root) {
+    QL_REQUIRE(root, "ScriptBytecode: root is null");
+    ScriptBytecodeCompiler compiler(*this);
+    compiler.compileStatement(root, 0);
+}
+
+std::ostream& operator<<(std::ostream& out, const ScriptBytecode& bytecode) {
+    static const std::vector<std::string> labels = {
+        "Constant",  "LoadScalar", "LoadArray",   "Negate",      "Abs",          "Exp",          "Log",
+        "Sqrt",      "NormalCdf",  "NormalPdf",   "Not",         "Add",          "Subtract",     "Multiply",
+        "Divide",    "Min",        "Max",         "Pow",         "Eq",           "Neq",          "Lt",
+        "Leq",       "Gt",         "Geq",         "And",         "Or",           "AndShortcut",  "OrShortcut",
+        "Eval",      "Exec",       "AssignCheck", "AssignScalar", "AssignArray", "Require",      "FilterThen",
+        "FilterElse", "FilterPop", "LoopStart",   "LoopEnd"};
+    auto field = [&out](const std::string& name, const Size v) {
+        if (v != Null<Size>())
+            out << " " << name << "=" << v;
+    };
+    for (Size k = 0; k < bytecode.instructions().size(); ++k) {
+        auto const& i = bytecode.instructions()[k];
+        out << k << ": " << labels.at(static_cast<Size>(i.op));
+        field("r", i.r);
+        field("a", i.a);
+        field("b", i.b);
+        field("c", i.c);
+        if (i.slot != Null<Size>())
+            out << " slot=" << i.slot << " (" << bytecode.variables().at(i.slot) << ")";
+        field("target", i.target);
+        if (i.op == ScriptBytecode::OpCode::Constant)
+            out << " value=" << i.value;
+        if (i.node != nullptr && i.node->locationInfo.initialised)
+            out << " at " << to_string(i.node->locationInfo);
+        out << "\n";
+    }
+    return out;
+}
+
+} // namespace data
+} // namespace ore
@@ -0,0 +1,136 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/scripting/scriptbytecode.hpp
+    \brief compilation of the script ast to a register based bytecode
+    \ingroup utilities
+*/
+
+#pragma once
+
+#include <ored/scripting/ast.hpp>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace data {
+
+//! Script AST compiled to a register based bytecode
+/*! The bytecode is a linear sequence of instructions executed by the ScriptEngine in a single dispatch loop. The
+    result of an expression is held in a register, registers are allocated by expression depth, so that the number of
+    registers is the maximum expression depth of the script. Variables are resolved to slots, which the engine binds to
+    the context entries once per run, control flow (if-then-else, loops, short cut evaluation of and / or) is
+    translated to jumps.
+
+    The arithmetic, function, condition, variable, assignment, require and control flow nodes are compiled. The
+    remaining nodes (e.g. PAY, LOGPAY, NPV, SORT, declarations) delegate to the ast visitor of the engine, which
+    evaluates the subtree rooted at the node, these are the Eval and Exec instructions.
+
+    The bytecode only depends on the AST, i.e. it can be compiled once per script and be reused for runs on different
+    contexts and models. */
+class ScriptBytecode {
+public:
+    enum class OpCode {
+        // r = value
+        Constant,
+        // r = scalar variable in slot
+        LoadScalar,
+        // r = array variable in slot, index in register a
+        LoadArray,
+        // r = op(a)
+        Negate,
+        Abs,
+        Exp,
+        Log,
+        Sqrt,
+        NormalCdf,
+        NormalPdf,
+        Not,
+        // r = op(a, b)
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Min,
+        Max,
+        Pow,
+        Eq,
+        Neq,
+        Lt,
+        Leq,
+        Gt,
+        Geq,
+        And,
+        Or,
+        // if a is a deterministic false (true) filter, set r = a and jump to target
+        AndShortcut,
+        OrShortcut,
+        // r = value of the subtree rooted at node, evaluated by the ast visitor
+        Eval,
+        // execute the subtree rooted at node with the ast visitor
+        Exec,
+        // jump to target if assignments to slot are ignored, fail if slot is a constant
+        AssignCheck,
+        // slot = a resp. slot[b] = a under the current filter
+        AssignScalar,
+        AssignArray,
+        // require condition a under the current filter
+        Require,
+        // push current filter && a resp. current filter && !a, jump to target if the new filter is always false
+        FilterThen,
+        FilterElse,
+        // pop filter
+        FilterPop,
+        // start loop r over slot with bounds a, b and step c, jump to target if there is no iteration
+        LoopStart,
+        // next iteration of loop r, jump to target (first instruction of the body) if there is one
+        LoopEnd
+    };
+
+    struct Instruction {
+        OpCode op;
+        Size r = Null<Size>(), a = Null<Size>(), b = Null<Size>(), c = Null<Size>();
+        Size slot = Null<Size>(), target = Null<Size>();
+        double value = 0.0;
+        // the node the instruction was compiled from, for diagnostics and for Eval, Exec
+        ASTNode* node = nullptr;
+    };
+
+    explicit ScriptBytecode(const ASTNodePtr root);
+
+    const ASTNodePtr root() const { return root_; }
+    const std::vector<Instruction>& instructions() const { return instructions_; }
+    //! the variable names by slot
+    const std::vector<std::string>& variables() const { return variables_; }
+    Size numberOfRegisters() const { return numberOfRegisters_; }
+    Size numberOfLoops() const { return numberOfLoops_; }
+
+private:
+    friend class ScriptBytecodeCompiler;
+    ASTNodePtr root_;
+    std::vector<Instruction> instructions_;
+    std::vector<std::string> variables_;
+    Size numberOfRegisters_ = 0, numberOfLoops_ = 0;
+};
+
+std::ostream& operator<<(std::ostream& out, const ScriptBytecode& bytecode);
+
+} // namespace data
+} // namespace ore
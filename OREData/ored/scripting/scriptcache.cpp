@@ -0,0 +1,177 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/scripting/astprinter.hpp>
+#include <ored/scripting/scriptcache.hpp>
+#include <ored/scripting/utilities.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <boost/thread/locks.hpp>
+
+#include <sstream>
+
+namespace ore {
+namespace data {
+
+namespace {
+// appends a value to the fingerprint, returns false if the value can not be represented (non-deterministic numbers)
+bool appendValue(std::ostringstream& out, const ValueType& v) {
+    out << v.which() << ':';
+    switch (v.which()) {
+    case ValueTypeWhich::Number: {
+        auto const& r = QuantLib::ext::get<RandomVariable>(v);
+        if (!r.deterministic())
+            return false;
+        out << r.at(0);
+        break;
+    }
+    case ValueTypeWhich::Event:
+        out << QuantLib::ext::get<EventVec>(v).value.serialNumber();
+        break;
+    case ValueTypeWhich::Currency:
+        out << QuantLib::ext::get<CurrencyVec>(v).value;
+        break;
+    case ValueTypeWhich::Index:
+        out << QuantLib::ext::get<IndexVec>(v).value;
+        break;
+    case ValueTypeWhich::Daycounter:
+        out << QuantLib::ext::get<DaycounterVec>(v).value;
+        break;
+    default:
+        return false;
+    }
+    out << ',';
+    return true;
+}
+
+// fingerprint of the values of the given variables, empty if the values can not be represented
+std::string fingerprint(const std::set<std::string>& variables, const Context& context) {
+    std::ostringstream out;
+    out.precision(17);
+    for (auto const& name : variables) {
+        out << name << '=';
+        if (auto s = context.scalars.find(name); s != context.scalars.end()) {
+            if (!appendValue(out, s->second))
+                return std::string();
+        }
+        if (auto a = context.arrays.find(name); a != context.arrays.end()) {
+            out << '[';
+            for (auto const& v : a->second)
+                if (!appendValue(out, v))
+                    return std::string();
+            out << ']';
+        }
+        out << ';';
+    }
+    return out.str();
+}
+} // namespace
+
+ASTNodePtr ScriptCache::ast(const std::string& code) {
+    {
+        boost::shared_lock<boost::shared_mutex> lock(mutex_);
+        if (auto e = entries_.find(code); e != entries_.end()) {
+            DLOG("retrieved ast from cache");
+            return e->second.ast;
+        }
+    }
+    ASTNodePtr ast = parseScript(code);
+    DLOGGERSTREAM("built ast:\n" << to_string(ast));
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    // another thread might have parsed the same script in the meantime, we keep the first ast in this case
+    return entries_.emplace(code, Entry{ast}).first->second.ast;
+}
+
+QuantLib::ext::shared_ptr<StaticAnalyser> ScriptCache::staticAnalyser(const std::string& code, const ASTNodePtr ast,
+                                                                       const QuantLib::ext::shared_ptr<Context>& context) {
+    std::string key;
+    {
+        boost::shared_lock<boost::shared_mutex> lock(mutex_);
+        if (auto e = entries_.find(code); e != entries_.end() && e->second.ast == ast && e->second.analysed) {
+            key = fingerprint(e->second.usedVariables, *context);
+            if (!key.empty()) {
+                if (auto a = e->second.analysers.find(key); a != e->second.analysers.end()) {
+                    DLOG("retrieved static analyser results from cache");
+                    return a->second;
+                }
+            }
+        }
+    }
+
+    auto analyser = QuantLib::ext::make_shared<StaticAnalyser>(ast, context);
+    analyser->run(code);
+    analyser->releaseContext();
+
+    if (key.empty())
+        key = fingerprint(analyser->usedVariables(), *context);
+    if (key.empty())
+        return analyser;
+
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    auto e = entries_.find(code);
+    if (maxStaticAnalysers_ == 0 || e == entries_.end() || e->second.ast != ast)
+        return analyser;
+    e->second.analysed = true;
+    e->second.usedVariables = analyser->usedVariables();
+    // another thread might have added the same analysis in the meantime, we keep the first analyser in this case
+    if (auto a = e->second.analysers.find(key); a != e->second.analysers.end())
+        return a->second;
+    if (numberOfStaticAnalysers_ >= maxStaticAnalysers_) {
+        DLOG("ScriptCache: maximum number of static analysers " << maxStaticAnalysers_ << " reached, clear them");
+        clearStaticAnalysers();
+    }
+    ++numberOfStaticAnalysers_;
+    return e->second.analysers.emplace(key, analyser).first->second;
+}
+
+void ScriptCache::clearStaticAnalysers() {
+    for (auto& e : entries_)
+        e.second.analysers.clear();
+    numberOfStaticAnalysers_ = 0;
+}
+
+void ScriptCache::clear() {
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    entries_.clear();
+    numberOfStaticAnalysers_ = 0;
+}
+
+void ScriptCache::setMaxStaticAnalysers(const Size maxStaticAnalysers) {
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    maxStaticAnalysers_ = maxStaticAnalysers;
+    if (numberOfStaticAnalysers_ > maxStaticAnalysers_)
+        clearStaticAnalysers();
+}
+
+Size ScriptCache::numberOfScripts() const {
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return entries_.size();
+}
+
+Size ScriptCache::numberOfStaticAnalysers() const {
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return numberOfStaticAnalysers_;
+}
+
+Size ScriptCache::maxStaticAnalysers() const {
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return maxStaticAnalysers_;
+}
+
+} // namespace data
+} // namespace ore
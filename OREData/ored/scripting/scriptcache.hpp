@@ -0,0 +1,86 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/scripting/scriptcache.hpp
+    \brief process wide cache for parsed scripts and static analyser results
+    \ingroup utilities
+*/
+
+#pragma once
+
+#include <ored/scripting/ast.hpp>
+#include <ored/scripting/context.hpp>
+#include <ored/scripting/staticanalyser.hpp>
+
+#include <ql/patterns/singleton.hpp>
+
+#include <boost/thread/shared_mutex.hpp>
+
+#include <set>
+#include <unordered_map>
+
+namespace ore {
+namespace data {
+
+/*! Caches the ast and the static analyser results per script code, so that the parsing and analysis cost is paid
+    once per distinct script instead of once per trade.
+
+    The static analyser results depend on the ast and the values of the context variables which are read during the
+    analysis, the names of these variables only depend on the ast. Analyser results are therefore cached per script
+    and the values of these variables, so trades sharing a script and the same dates, indices and currencies share
+    one analysis.
+
+    The analyser results are cleared when their number exceeds the maximum size, a maximum size of zero disables the
+    caching of analyser results. The asts are kept, their number is bounded by the number of distinct scripts. */
+class ScriptCache : public QuantLib::Singleton<ScriptCache, std::integral_constant<bool, true>> {
+public:
+    //! returns the ast for the given script code, the script is parsed if not in the cache yet
+    ASTNodePtr ast(const std::string& code);
+
+    /*! returns a static analyser that was run on the given ast and context, the analyser is taken from the cache
+        if possible, the returned analyser does not hold on to the context and must not be run again */
+    QuantLib::ext::shared_ptr<StaticAnalyser> staticAnalyser(const std::string& code, const ASTNodePtr ast,
+                                                             const QuantLib::ext::shared_ptr<Context>& context);
+
+    //! clear the cache
+    void clear();
+
+    //! set the maximum number of cached static analysers, zero disables their caching
+    void setMaxStaticAnalysers(const Size maxStaticAnalysers);
+
+    //! inspectors
+    Size numberOfScripts() const;
+    Size numberOfStaticAnalysers() const;
+    Size maxStaticAnalysers() const;
+
+private:
+    struct Entry {
+        ASTNodePtr ast;
+        bool analysed = false;
+        std::set<std::string> usedVariables;
+        std::unordered_map<std::string, QuantLib::ext::shared_ptr<StaticAnalyser>> analysers;
+    };
+    void clearStaticAnalysers();
+    mutable boost::shared_mutex mutex_;
+    Size maxStaticAnalysers_ = 10000;
+    Size numberOfStaticAnalysers_ = 0;
+    std::unordered_map<std::string, Entry> entries_;
+};
+
+} // namespace data
+} // namespace ore
@@ -16,8 +16,8 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
-#include <ored/scripting/astresetter.hpp>
 #include <ored/scripting/safestack.hpp>
+#include <ored/scripting/scriptbytecode.hpp>
 #include <ored/scripting/scriptengine.hpp>
 #include <ored/scripting/scriptparser.hpp>
 #include <ored/scripting/utilities.hpp>
@@ -53,6 +53,78 @@ namespace ore {
 namespace data {
 
 namespace {
+
+// helper functions shared by the ast runner and the bytecode runner
+
+long arrayIndex(const ValueType& arg, const Size arraySize) {
+    QL_REQUIRE(arg.which() == ValueTypeWhich::Number,
+               "array subscript must be of type NUMBER, got " << valueTypeLabels.at(arg.which()));
+    const RandomVariable& i = QuantLib::ext::get<RandomVariable>(arg);
+    QL_REQUIRE(i.deterministic(), "array subscript must be deterministic");
+    long il = std::lround(i.at(0));
+    QL_REQUIRE(static_cast<long>(arraySize) >= il && il >= 1, "array index " << il << " out of bounds 1..."
+                                                                             << arraySize);
+    return il - 1;
+}
+
+void assignValue(ValueType& target, const ValueType& right, const Filter& filter) {
+    if (target.which() == ValueTypeWhich::Event || target.which() == ValueTypeWhich::Currency ||
+        target.which() == ValueTypeWhich::Index) {
+        typeSafeAssign(target, right);
+    } else {
+        QL_REQUIRE(target.which() == ValueTypeWhich::Number,
+                   "internal error: expected NUMBER, got " << valueTypeLabels.at(target.which()));
+        QL_REQUIRE(right.which() == ValueTypeWhich::Number, "invalid assignment: type "
+                                                                << valueTypeLabels.at(target.which()) << " <- "
+                                                                << valueTypeLabels.at(right.which()));
+        // TODO, better have a RESETTIME() function?
+        QuantLib::ext::get<RandomVariable>(target).setTime(Null<Real>());
+        target = conditionalResult(filter, QuantLib::ext::get<RandomVariable>(right),
+                                   QuantLib::ext::get<RandomVariable>(target));
+        QuantLib::ext::get<RandomVariable>(target).updateDeterministic();
+    }
+}
+
+void requireCondition(const ValueType& condition, const Filter& filter) {
+    QL_REQUIRE(condition.which() == ValueTypeWhich::Filter, "expected condition");
+    // check implication filter true => condition true
+    auto c = !filter || QuantLib::ext::get<Filter>(condition);
+    c.updateDeterministic();
+    QL_REQUIRE(c.deterministic() && c.at(0), "required condition is not (always) fulfilled");
+}
+
+struct LoopBounds {
+    long first, last, step;
+};
+
+LoopBounds loopBounds(const ValueType& left, const ValueType& right, const ValueType& step) {
+    QL_REQUIRE(left.which() == ValueTypeWhich::Number && right.which() == ValueTypeWhich::Number &&
+                   step.which() == ValueTypeWhich::Number,
+               "loop bounds and step must be of type NUMBER, got " << valueTypeLabels.at(left.which()) << ", "
+                                                                   << valueTypeLabels.at(right.which()) << ", "
+                                                                   << valueTypeLabels.at(step.which()));
+    const RandomVariable& a = QuantLib::ext::get<RandomVariable>(left);
+    const RandomVariable& b = QuantLib::ext::get<RandomVariable>(right);
+    const RandomVariable& s = QuantLib::ext::get<RandomVariable>(step);
+    QL_REQUIRE(a.deterministic(), "first loop bound must be deterministic");
+    QL_REQUIRE(b.deterministic(), "second loop bound must be deterministic");
+    QL_REQUIRE(s.deterministic(), "loop step must be deterministic");
+    LoopBounds l{std::lround(a.at(0)), std::lround(b.at(0)), std::lround(s.at(0))};
+    QL_REQUIRE(l.step != 0, "loop step must be non-zero");
+    return l;
+}
+
+bool loopContinues(const LoopBounds& l, const long current) {
+    return (l.step > 0 && current <= l.last) || (l.step < 0 && current >= l.last);
+}
+
+void checkLoopVariable(const ValueType& var, const long current, const Size size) {
+    QL_REQUIRE(var.which() == ValueTypeWhich::Number &&
+                   close_enough_all(QuantLib::ext::get<RandomVariable>(var),
+                                    RandomVariable(size, static_cast<double>(current))),
+               "loop variable was modified in body from " << current << " to " << var << ", this is illegal.");
+}
+
 class ASTRunner : public AcyclicVisitor,
                   public Visitor<ASTNode>,
                   public Visitor<OperatorPlusNode>,
@@ -138,40 +210,34 @@ public:
 
     std::pair<ValueType&, long> getVariableRef(VariableNode& v) {
         checkpoint(v);
-        if (v.isCached) {
-            if (v.isScalar) {
-                return std::make_pair(QuantLib::ext::ref(*v.cachedScalar), 0);
-            } else {
-                QL_REQUIRE(v.args[0], "array subscript required for variable '" << v.name << "'");
-                v.args[0]->accept(*this);
-                auto arg = value.pop();
-                QL_REQUIRE(arg.which() == ValueTypeWhich::Number,
-                           "array subscript must be of type NUMBER, got " << valueTypeLabels.at(arg.which()));
-                RandomVariable i = QuantLib::ext::get<RandomVariable>(arg);
-                QL_REQUIRE(i.deterministic(), "array subscript must be deterministic");
-                long il = std::lround(i.at(0));
-                QL_REQUIRE(static_cast<long>(v.cachedVector->size()) >= il && il >= 1,
-                           "array index " << il << " out of bounds 1..." << v.cachedVector->size());
-                return std::make_pair(QuantLib::ext::ref(v.cachedVector->operator[](il - 1)), il - 1);
-            }
+        ValueType* scalar = nullptr;
+        std::vector<ValueType>* array = nullptr;
+        if (v.index != Null<Size>() && v.index < variableCache_.size() && variableCache_[v.index].node == &v) {
+            scalar = variableCache_[v.index].scalar;
+            array = variableCache_[v.index].array;
         } else {
-            auto scalar = context_.scalars.find(v.name);
-            if (scalar != context_.scalars.end()) {
+            if (auto s = context_.scalars.find(v.name); s != context_.scalars.end()) {
                 QL_REQUIRE(!v.args[0], "no array subscript allowed for variable '" << v.name << "'");
-                v.isCached = true;
-                v.isScalar = true;
-                v.cachedScalar = &scalar->second;
-                return std::make_pair(QuantLib::ext::ref(scalar->second), 0);
+                scalar = &s->second;
+            } else if (auto a = context_.arrays.find(v.name); a != context_.arrays.end()) {
+                array = &a->second;
+            } else {
+                QL_FAIL("variable '" << v.name << "' is not defined.");
             }
-            auto array = context_.arrays.find(v.name);
-            if (array != context_.arrays.end()) {
-                v.isCached = true;
-                v.isScalar = false;
-                v.cachedVector = &array->second;
-                return getVariableRef(v);
+            if (v.index != Null<Size>()) {
+                if (v.index >= variableCache_.size())
+                    variableCache_.resize(v.index + 1);
+                variableCache_[v.index] = {&v, scalar, array};
             }
-            QL_FAIL("variable '" << v.name << "' is not defined.");
         }
+        if (scalar)
+            return std::make_pair(QuantLib::ext::ref(*scalar), 0);
+        // the subscript may contain variables itself, so we do not keep references into the cache here
+        QL_REQUIRE(v.args[0], "array subscript required for variable '" << v.name << "'");
+        v.args[0]->accept(*this);
+        auto arg = value.pop();
+        long il = arrayIndex(arg, array->size());
+        return std::make_pair(QuantLib::ext::ref(array->operator[](il)), il);
     }
 
     // helepr to declare a new context variable
@@ -376,21 +442,7 @@ public:
                    "can not assign to const variable '" << v->name << "'");
         auto ref = getVariableRef(*v);
         checkpoint(n);
-        if (ref.first.which() == ValueTypeWhich::Event || ref.first.which() == ValueTypeWhich::Currency ||
-            ref.first.which() == ValueTypeWhich::Index) {
-            typeSafeAssign(ref.first, right);
-        } else {
-            QL_REQUIRE(ref.first.which() == ValueTypeWhich::Number,
-                       "internal error: expected NUMBER, got " << valueTypeLabels.at(ref.first.which()));
-            QL_REQUIRE(right.which() == ValueTypeWhich::Number, "invalid assignment: type "
-                                                                    << valueTypeLabels.at(ref.first.which()) << " <- "
-                                                                    << valueTypeLabels.at(right.which()));
-            // TODO, better have a RESETTIME() function?
-            QuantLib::ext::get<RandomVariable>(ref.first).setTime(Null<Real>());
-            ref.first = conditionalResult(filter.top(), QuantLib::ext::get<RandomVariable>(right),
-                                          QuantLib::ext::get<RandomVariable>(ref.first));
-            QuantLib::ext::get<RandomVariable>(ref.first).updateDeterministic();
-        }
+        assignValue(ref.first, right, filter.top());
         TRACE("assign( " << v->name << "[" << (ref.second + 1) << "] ) := " << ref.first << " ("
                          << valueTypeLabels.at(right.which()) << ") using filter " << filter.top(),
               n);
@@ -402,11 +454,7 @@ public:
         n.args[0]->accept(*this);
         auto condition = value.pop();
         checkpoint(n);
-        QL_REQUIRE(condition.which() == ValueTypeWhich::Filter, "expected condition");
-        // check implication filter true => condition true
-        auto c = !filter.top() || QuantLib::ext::get<Filter>(condition);
-        c.updateDeterministic();
-        QL_REQUIRE(c.deterministic() && c.at(0), "required condition is not (always) fulfilled");
+        requireCondition(condition, filter.top());
         TRACE("require( " << condition << " ) for filter " << filter.top(), n);
     }
 
@@ -464,33 +512,15 @@ public:
         auto right = value.pop();
         auto left = value.pop();
         checkpoint(n);
-        QL_REQUIRE(left.which() == ValueTypeWhich::Number && right.which() == ValueTypeWhich::Number &&
-                       step.which() == ValueTypeWhich::Number,
-                   "loop bounds and step must be of type NUMBER, got " << valueTypeLabels.at(left.which()) << ", "
-                                                                       << valueTypeLabels.at(right.which()) << ", "
-                                                                       << valueTypeLabels.at(step.which()));
-        RandomVariable a = QuantLib::ext::get<RandomVariable>(left);
-        RandomVariable b = QuantLib::ext::get<RandomVariable>(right);
-        RandomVariable s = QuantLib::ext::get<RandomVariable>(step);
-        QL_REQUIRE(a.deterministic(), "first loop bound must be deterministic");
-        QL_REQUIRE(b.deterministic(), "second loop bound must be deterministic");
-        QL_REQUIRE(s.deterministic(), "loop step must be deterministic");
-        long al = std::lround(a.at(0));
-        long bl = std::lround(b.at(0));
-        long sl = std::lround(s.at(0));
-        QL_REQUIRE(sl != 0, "loop step must be non-zero");
-        long cl = al;
-        while ((sl > 0 && cl <= bl) || (sl < 0 && cl >= bl)) {
-            TRACE("for( " << n.name << " : " << cl << " (" << al << "," << bl << "))", n);
+        LoopBounds l = loopBounds(left, right, step);
+        long cl = l.first;
+        while (loopContinues(l, cl)) {
+            TRACE("for( " << n.name << " : " << cl << " (" << l.first << "," << l.last << "))", n);
             var->second = RandomVariable(size_, static_cast<double>(cl));
             n.args[3]->accept(*this);
             checkpoint(n);
-            QL_REQUIRE(var->second.which() == ValueTypeWhich::Number &&
-                           close_enough_all(QuantLib::ext::get<RandomVariable>(var->second),
-                                            RandomVariable(size_, static_cast<double>(cl))),
-                       "loop variable was modified in body from " << cl << " to " << var->second
-                                                                  << ", this is illegal.");
-            cl += sl;
+            checkLoopVariable(var->second, cl, size_);
+            cl += l.step;
         }
     }
 
@@ -1153,17 +1183,277 @@ public:
     // working variables
     Context& context_;
     ASTNode*& lastVisitedNode_;
+    /* cache for optimised variable reference retrieval (scalar or array) by variable node index, this is kept in the
+       runner and not in the ast, so that an ast can be run concurrently on different contexts; the node is stored to
+       detect nodes which share an index, because they were not indexed together */
+    struct CachedVariable {
+        const VariableNode* node = nullptr;
+        ValueType* scalar = nullptr;
+        std::vector<ValueType>* array = nullptr;
+    };
+    std::vector<CachedVariable> variableCache_;
     // state of the runner
     SafeStack<Filter> filter;
     SafeStack<ValueType> value;
 };
 
+/* executes the bytecode of a script in a single dispatch loop, the nodes which are not compiled are delegated to the ast
+   runner, whose filter and value stacks are shared */
+
+class BytecodeRunner {
+public:
+    BytecodeRunner(const ScriptBytecode& bytecode, ASTRunner& runner, Context& context, const Size size,
+                   ASTNode*& lastVisitedNode)
+        : bytecode_(bytecode), runner_(runner), context_(context), size_(size), lastVisitedNode_(lastVisitedNode),
+          slots_(bytecode.variables().size()) {}
+
+    void run() {
+        using OpCode = ScriptBytecode::OpCode;
+
+        std::vector<ValueType> reg(bytecode_.numberOfRegisters());
+        std::vector<std::pair<LoopBounds, long>> loops(bytecode_.numberOfLoops());
+        auto& filter = runner_.filter;
+        auto const& instructions = bytecode_.instructions();
+
+        for (Size pc = 0; pc < instructions.size();) {
+            auto const& i = instructions[pc];
+            lastVisitedNode_ = i.node;
+            switch (i.op) {
+            case OpCode::Constant:
+                reg[i.r] = RandomVariable(size_, i.value);
+                break;
+            case OpCode::LoadScalar:
+                reg[i.r] = scalar(i.slot);
+                break;
+            case OpCode::LoadArray: {
+                auto& a = array(i.slot);
+                reg[i.r] = a[arrayIndex(reg[i.a], a.size())];
+                break;
+            }
+            case OpCode::Negate:
+                reg[i.r] = -reg[i.a];
+                break;
+            case OpCode::Abs:
+                reg[i.r] = abs(reg[i.a]);
+                break;
+            case OpCode::Exp:
+                reg[i.r] = exp(reg[i.a]);
+                break;
+            case OpCode::Log:
+                reg[i.r] = log(reg[i.a]);
+                break;
+            case OpCode::Sqrt:
+                reg[i.r] = sqrt(reg[i.a]);
+                break;
+            case OpCode::NormalCdf:
+                reg[i.r] = normalCdf(reg[i.a]);
+                break;
+            case OpCode::NormalPdf:
+                reg[i.r] = normalPdf(reg[i.a]);
+                break;
+            case OpCode::Not:
+                reg[i.r] = logicalNot(reg[i.a]);
+                break;
+            case OpCode::Add:
+                reg[i.r] = reg[i.a] + reg[i.b];
+                break;
+            case OpCode::Subtract:
+                reg[i.r] = reg[i.a] - reg[i.b];
+                break;
+            case OpCode::Multiply:
+                reg[i.r] = reg[i.a] * reg[i.b];
+                break;
+            case OpCode::Divide:
+                reg[i.r] = reg[i.a] / reg[i.b];
+                break;
+            case OpCode::Min:
+                reg[i.r] = min(reg[i.a], reg[i.b]);
+                break;
+            case OpCode::Max:
+                reg[i.r] = max(reg[i.a], reg[i.b]);
+                break;
+            case OpCode::Pow:
+                reg[i.r] = pow(reg[i.a], reg[i.b]);
+                break;
+            case OpCode::Eq:
+                reg[i.r] = equal(reg[i.a], reg[i.b]);
+                break;
+            case OpCode::Neq:
+                reg[i.r] = notequal(reg[i.a], reg[i.b]);
+                break;
+            case OpCode::Lt:
+                reg[i.r] = lt(reg[i.a], reg[i.b]);
+                break;
+            case OpCode::Leq:
+                reg[i.r] = leq(reg[i.a], reg[i.b]);
+                break;
+            case OpCode::Gt:
+                reg[i.r] = gt(reg[i.a], reg[i.b]);
+                break;
+            case OpCode::Geq:
+                reg[i.r] = geq(reg[i.a], reg[i.b]);
+                break;
+            case OpCode::And:
+                reg[i.r] = logicalAnd(reg[i.a], reg[i.b]);
+                break;
+            case OpCode::Or:
+                reg[i.r] = logicalOr(reg[i.a], reg[i.b]);
+                break;
+            case OpCode::AndShortcut:
+            case OpCode::OrShortcut: {
+                QL_REQUIRE(reg[i.a].which() == ValueTypeWhich::Filter, "expected condition");
+                const Filter& l = QuantLib::ext::get<Filter>(reg[i.a]);
+                bool shortcutValue = i.op == OpCode::OrShortcut;
+                if (l.deterministic() && l[0] == shortcutValue) {
+                    reg[i.r] = Filter(l.size(), shortcutValue);
+                    pc = i.target;
+                    continue;
+                }
+                break;
+            }
+            case OpCode::Eval:
+                i.node->accept(runner_);
+                reg[i.r] = runner_.value.pop();
+                break;
+            case OpCode::Exec:
+                i.node->accept(runner_);
+                break;
+            case OpCode::AssignCheck: {
+                auto& s = slots_[i.slot];
+                if (!s.flagsSet) {
+                    s.ignoreAssignments =
+                        context_.ignoreAssignments.find(variable(i.slot)) != context_.ignoreAssignments.end();
+                    s.constant = context_.constants.find(variable(i.slot)) != context_.constants.end();
+                    s.flagsSet = true;
+                }
+                if (s.ignoreAssignments) {
+                    pc = i.target;
+                    continue;
+                }
+                QL_REQUIRE(!s.constant, "can not assign to const variable '" << variable(i.slot) << "'");
+                break;
+            }
+            case OpCode::AssignScalar:
+                assignValue(scalar(i.slot), reg[i.a], filter.top());
+                break;
+            case OpCode::AssignArray: {
+                auto& a = array(i.slot);
+                assignValue(a[arrayIndex(reg[i.b], a.size())], reg[i.a], filter.top());
+                break;
+            }
+            case OpCode::Require:
+                requireCondition(reg[i.a], filter.top());
+                break;
+            case OpCode::FilterThen:
+            case OpCode::FilterElse: {
+                QL_REQUIRE(reg[i.a].which() == ValueTypeWhich::Filter,
+                           "IF must be followed by a boolean, got " << valueTypeLabels.at(reg[i.a].which()));
+                const Filter& cond = QuantLib::ext::get<Filter>(reg[i.a]);
+                Filter currentFilter = i.op == OpCode::FilterThen ? filter.top() && cond : filter.top() && !cond;
+                currentFilter.updateDeterministic();
+                filter.push(currentFilter);
+                if (currentFilter.deterministic() && !currentFilter[0]) {
+                    pc = i.target;
+                    continue;
+                }
+                break;
+            }
+            case OpCode::FilterPop:
+                filter.pop();
+                break;
+            case OpCode::LoopStart: {
+                ValueType* var = loopVariable(i.slot);
+                QL_REQUIRE(var != nullptr, "loop variable '" << variable(i.slot) << "' not defined or not scalar");
+                QL_REQUIRE(context_.constants.find(variable(i.slot)) == context_.constants.end(),
+                           "loop variable '" << variable(i.slot) << "' is constant");
+                loops[i.r] = std::make_pair(loopBounds(reg[i.a], reg[i.b], reg[i.c]), 0);
+                loops[i.r].second = loops[i.r].first.first;
+                if (!loopContinues(loops[i.r].first, loops[i.r].second)) {
+                    pc = i.target;
+                    continue;
+                }
+                *var = RandomVariable(size_, static_cast<double>(loops[i.r].second));
+                break;
+            }
+            case OpCode::LoopEnd: {
+                ValueType& var = scalar(i.slot);
+                auto& [bounds, current] = loops[i.r];
+                checkLoopVariable(var, current, size_);
+                current += bounds.step;
+                if (loopContinues(bounds, current)) {
+                    var = RandomVariable(size_, static_cast<double>(current));
+                    pc = i.target;
+                    continue;
+                }
+                break;
+            }
+            default:
+                QL_FAIL("BytecodeRunner: internal error, unhandled op code " << static_cast<int>(i.op));
+            }
+            ++pc;
+        }
+    }
+
+private:
+    // context entries bound to the slots, the binding is done on first use, since scripts can declare variables
+    struct Slot {
+        ValueType* scalar = nullptr;
+        std::vector<ValueType>* array = nullptr;
+        bool flagsSet = false, ignoreAssignments = false, constant = false;
+    };
+
+    const std::string& variable(const Size slot) const { return bytecode_.variables()[slot]; }
+
+    void bind(const Size slot) {
+        auto& s = slots_[slot];
+        if (s.scalar != nullptr || s.array != nullptr)
+            return;
+        if (auto sc = context_.scalars.find(variable(slot)); sc != context_.scalars.end()) {
+            s.scalar = &sc->second;
+        } else if (auto ar = context_.arrays.find(variable(slot)); ar != context_.arrays.end()) {
+            s.array = &ar->second;
+        } else {
+            QL_FAIL("variable '" << variable(slot) << "' is not defined.");
+        }
+    }
+
+    ValueType& scalar(const Size slot) {
+        bind(slot);
+        QL_REQUIRE(slots_[slot].scalar != nullptr, "array subscript required for variable '" << variable(slot) << "'");
+        return *slots_[slot].scalar;
+    }
+
+    std::vector<ValueType>& array(const Size slot) {
+        bind(slot);
+        QL_REQUIRE(slots_[slot].array != nullptr,
+                   "no array subscript allowed for variable '" << variable(slot) << "'");
+        return *slots_[slot].array;
+    }
+
+    ValueType* loopVariable(const Size slot) {
+        if (slots_[slot].scalar == nullptr) {
+            auto sc = context_.scalars.find(variable(slot));
+            if (sc == context_.scalars.end())
+                return nullptr;
+            slots_[slot].scalar = &sc->second;
+        }
+        return slots_[slot].scalar;
+    }
+
+    const ScriptBytecode& bytecode_;
+    ASTRunner& runner_;
+    Context& context_;
+    const Size size_;
+    ASTNode*& lastVisitedNode_;
+    std::vector<Slot> slots_;
+};
+
 } // namespace
 
 void ScriptEngine::run(const std::string& script, bool interactive, QuantLib::ext::shared_ptr<PayLog> paylog,
                        bool includePastCashflows) {
 
-    ASTNode* loc;
+    ASTNode* loc = nullptr;
     ASTRunner runner(model_, script, interactive, *context_, loc, paylog, paylog != nullptr && includePastCashflows);
 
     randomvariable_output_pattern pattern;
@@ -1184,8 +1474,14 @@ void ScriptEngine::run(const std::string& script, bool interactive, QuantLib::ex
 
     boost::timer::cpu_timer timer;
     try {
-        reset(root_);
-        root_->accept(runner);
+        if (interactive) {
+            root_->accept(runner);
+        } else {
+            auto bytecode = bytecode_;
+            if (bytecode == nullptr || bytecode->root() != root_)
+                bytecode = QuantLib::ext::make_shared<ScriptBytecode>(root_);
+            BytecodeRunner(*bytecode, runner, *context_, model_ ? model_->size() : 1, loc).run();
+        }
         timer.stop();
         QL_REQUIRE(runner.value.size() == 1,
                    "ScriptEngine::run(): value stack has wrong size (" << runner.value.size() << "), should be 1");
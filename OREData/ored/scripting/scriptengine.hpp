@@ -27,17 +27,22 @@
 #include <ored/scripting/ast.hpp>
 #include <ored/scripting/context.hpp>
 #include <ored/scripting/paylog.hpp>
+#include <ored/scripting/scriptbytecode.hpp>
 
 #include <ored/configuration/conventions.hpp>
 
 namespace ore {
 namespace data {
 
+/*! The script is executed as bytecode, see ScriptBytecode. The bytecode can be compiled once and passed to the
+    engine for repeated runs of the same script, otherwise it is compiled in run(). In interactive mode the ast is
+    visited directly, so that each node can be traced. */
 class ScriptEngine {
 public:
     ScriptEngine(const ASTNodePtr root, const QuantLib::ext::shared_ptr<Context> context,
-                 const QuantLib::ext::shared_ptr<Model> model = nullptr)
-        : root_(root), context_(context), model_(model) {}
+                 const QuantLib::ext::shared_ptr<Model> model = nullptr,
+                 const QuantLib::ext::shared_ptr<ScriptBytecode> bytecode = nullptr)
+        : root_(root), context_(context), model_(model), bytecode_(bytecode) {}
     void run(const std::string& script = "", bool interactive = false, QuantLib::ext::shared_ptr<PayLog> paylog = nullptr,
              bool includePastCashflows = false);
 
@@ -45,6 +50,7 @@ private:
     const ASTNodePtr root_;
     const QuantLib::ext::shared_ptr<Context> context_;
     const QuantLib::ext::shared_ptr<Model> model_;
+    const QuantLib::ext::shared_ptr<ScriptBytecode> bytecode_;
 };
 
 } // namespace data
@@ -70,6 +70,7 @@ ScriptParser::ScriptParser(const std::string& script) {
                    "ScriptParser: unexpected eval stack size (" << grammar.evalStack.size() << "), should be 1");
         ast_ = grammar.evalStack.top();
         QL_REQUIRE(ast_, "ScriptParser: ast is null");
+        indexVariableNodes(ast_);
     }
 }
 
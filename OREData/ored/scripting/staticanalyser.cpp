@@ -58,12 +58,14 @@ public:
                       std::map<std::string, std::set<QuantLib::Date>>& fwdCompAvgEvalDates,
                       std::map<std::string, std::set<QuantLib::Date>>& fwdCompAvgStartEndDates,
                       std::map<std::string, std::set<QuantLib::Date>>& probFixingDates,
-                      std::set<QuantLib::Date>& regressionDates, Context& context, ASTNode*& lastVisitedNode)
+                      std::set<QuantLib::Date>& regressionDates, std::set<std::string>& usedVariables,
+                      Context& context, ASTNode*& lastVisitedNode)
         : indexEvalDates_(indexEvalDates), indexFwdDates_(indexFwdDates), payObsDates_(payObsDates),
           payPayDates_(payPayDates), discountObsDates_(discountObsDates), discountPayDates_(discountPayDates),
           fwdCompAvgFixingDates_(fwdCompAvgFixingDates), fwdCompAvgEvalDates_(fwdCompAvgEvalDates),
           fwdCompAvgStartEndDates_(fwdCompAvgStartEndDates), probFixingDates_(probFixingDates),
-          regressionDates_(regressionDates), context_(context), lastVisitedNode_(lastVisitedNode) {}
+          regressionDates_(regressionDates), usedVariables_(usedVariables), context_(context),
+          lastVisitedNode_(lastVisitedNode) {}
 
     void checkpoint(ASTNode& n) { lastVisitedNode_ = &n; }
 
@@ -99,6 +101,7 @@ public:
         std::vector<ValueType> result;
         if (name.empty())
             return result;
+        usedVariables_.insert(name);
         bool found = false;
         // TODAY is allowed as an argument for a VarEvaluationNode, but actually not defined
         // in the context necessarily when running the static analysis, and we don't need to add
@@ -390,12 +393,14 @@ private:
         &discountObsDates_, &discountPayDates_, &fwdCompAvgFixingDates_, &fwdCompAvgEvalDates_,
         &fwdCompAvgStartEndDates_, &probFixingDates_;
     std::set<QuantLib::Date>& regressionDates_;
+    std::set<std::string>& usedVariables_;
     Context& context_;
     ASTNode*& lastVisitedNode_;
 };
 } // namespace
 
 void StaticAnalyser::run(const std::string& script) {
+    QL_REQUIRE(context_, "StaticAnalyser::run(): no context given");
     indexEvalDates_.clear();
     indexFwdDates_.clear();
     payObsDates_.clear();
@@ -407,11 +412,12 @@ void StaticAnalyser::run(const std::string& script) {
     fwdCompAvgStartEndDates_.clear();
     probFixingDates_.clear();
     regressionDates_.clear();
+    usedVariables_.clear();
 
     ASTNode* loc;
     ASTIndexExtractor runner(indexEvalDates_, indexFwdDates_, payObsDates_, payPayDates_, discountObsDates_,
                              discountPayDates_, fwdCompAvgFixingDates_, fwdCompAvgEvalDates_, fwdCompAvgStartEndDates_,
-                             probFixingDates_, regressionDates_, *context_, loc);
+                             probFixingDates_, regressionDates_, usedVariables_, *context_, loc);
 
     try {
         root_->accept(runner);
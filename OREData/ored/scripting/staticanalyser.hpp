@@ -39,6 +39,9 @@ public:
         : root_(root), context_(context) {}
     void run(const std::string& script = "");
 
+    // releases the context, the results remain available, but the analyser can not be run again afterwards
+    void releaseContext() { context_.reset(); }
+
     // maps an index (EQ-IDX, EUR-CMS-10Y, ...) to the set of observation dates on which it is is evaluated
     // via ()(obsDate) or ()(obsdate,fwdDate) or [ABOVE|BELOW]PROB(d1, d2)
     const std::map<std::string, std::set<QuantLib::Date>>& indexEvalDates() const { return indexEvalDates_; }
@@ -75,14 +78,19 @@ public:
     // maps an index (EQ-IDX, EUR-CMS-10Y, ...) to the set of fixing dates from [ABOVE|BELOW]PROB(d1, d2)
     const std::map<std::string, std::set<QuantLib::Date>>& probFixingDates() const { return probFixingDates_; }
 
+    /* the names of the context variables read during the analysis, the results only depend on the ast and the
+       values of these variables */
+    const std::set<std::string>& usedVariables() const { return usedVariables_; }
+
 private:
     const ASTNodePtr root_;
-    const QuantLib::ext::shared_ptr<Context> context_;
+    QuantLib::ext::shared_ptr<Context> context_;
     //
     std::map<std::string, std::set<QuantLib::Date>> indexEvalDates_, indexFwdDates_, payObsDates_, payPayDates_,
         discountObsDates_, discountPayDates_, fwdCompAvgFixingDates_, fwdCompAvgEvalDates_, fwdCompAvgStartEndDates_,
         probFixingDates_;
     std::set<QuantLib::Date> regressionDates_;
+    std::set<std::string> usedVariables_;
 };
 
 } // namespace data
@@ -0,0 +1,155 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/utilities/binaryxml.hpp>
+
+#include <ql/errors.hpp>
+
+#include <rapidxml.hpp>
+
+#include <cstring>
+#include <limits>
+
+namespace ore {
+namespace data {
+
+namespace {
+const char elementTag = 'e', dataTag = 'd', cdataTag = 'c';
+
+bool isWritten(XMLNode* node) {
+    return node->type() == rapidxml::node_element || node->type() == rapidxml::node_data ||
+           node->type() == rapidxml::node_cdata;
+}
+} // namespace
+
+void BinaryXMLWriter::writeInt(const std::uint32_t i) { data_.append(reinterpret_cast<const char*>(&i), sizeof(i)); }
+
+void BinaryXMLWriter::writeString(const char* s, const std::size_t n) {
+    QL_REQUIRE(n <= std::numeric_limits<std::uint32_t>::max(), "BinaryXMLWriter: string too long (" << n << ")");
+    writeInt(static_cast<std::uint32_t>(n));
+    data_.append(s, n);
+}
+
+void BinaryXMLWriter::writeName(const char* s, const std::size_t n) {
+    std::string name(s, n);
+    auto it = names_.find(name);
+    if (it != names_.end()) {
+        writeInt(it->second);
+    } else {
+        // a new name is introduced by the next free index followed by the name itself
+        std::uint32_t index = static_cast<std::uint32_t>(names_.size());
+        writeInt(index);
+        writeString(s, n);
+        names_[name] = index;
+    }
+}
+
+void BinaryXMLWriter::write(XMLNode* node) {
+    QL_REQUIRE(node, "BinaryXMLWriter: node is null");
+    switch (node->type()) {
+    case rapidxml::node_element: {
+        data_.push_back(elementTag);
+        writeName(node->name(), node->name_size());
+        writeString(node->value(), node->value_size());
+        std::uint32_t nAttributes = 0, nChildren = 0;
+        for (auto a = node->first_attribute(); a; a = a->next_attribute())
+            ++nAttributes;
+        writeInt(nAttributes);
+        for (auto a = node->first_attribute(); a; a = a->next_attribute()) {
+            writeName(a->name(), a->name_size());
+            writeString(a->value(), a->value_size());
+        }
+        for (auto c = node->first_node(); c; c = c->next_sibling())
+            if (isWritten(c))
+                ++nChildren;
+        writeInt(nChildren);
+        for (auto c = node->first_node(); c; c = c->next_sibling())
+            if (isWritten(c))
+                write(c);
+        break;
+    }
+    case rapidxml::node_data:
+        data_.push_back(dataTag);
+        writeString(node->value(), node->value_size());
+        break;
+    case rapidxml::node_cdata:
+        data_.push_back(cdataTag);
+        writeString(node->value(), node->value_size());
+        break;
+    default:
+        QL_FAIL("BinaryXMLWriter: unsupported node type " << static_cast<int>(node->type()));
+    }
+}
+
+BinaryXMLReader::BinaryXMLReader(const char* data, const std::size_t size) : data_(data), size_(size) {}
+
+std::uint32_t BinaryXMLReader::readInt() {
+    QL_REQUIRE(pos_ + sizeof(std::uint32_t) <= size_, "BinaryXMLReader: unexpected end of data");
+    std::uint32_t i;
+    std::memcpy(&i, data_ + pos_, sizeof(i));
+    pos_ += sizeof(i);
+    return i;
+}
+
+char* BinaryXMLReader::readString(XMLDocument& doc) {
+    std::size_t n = readInt();
+    QL_REQUIRE(pos_ + n <= size_, "BinaryXMLReader: unexpected end of data");
+    char* s = doc.doc()->allocate_string(nullptr, n + 1);
+    std::memcpy(s, data_ + pos_, n);
+    s[n] = '\0';
+    pos_ += n;
+    return s;
+}
+
+char* BinaryXMLReader::readName(XMLDocument& doc) {
+    std::uint32_t index = readInt();
+    if (index == names_.size()) {
+        std::size_t n = readInt();
+        QL_REQUIRE(pos_ + n <= size_, "BinaryXMLReader: unexpected end of data");
+        names_.emplace_back(data_ + pos_, n);
+        pos_ += n;
+    }
+    QL_REQUIRE(index < names_.size(), "BinaryXMLReader: invalid name index " << index);
+    return doc.allocString(names_[index]);
+}
+
+XMLNode* BinaryXMLReader::read(XMLDocument& doc) {
+    QL_REQUIRE(pos_ < size_, "BinaryXMLReader: unexpected end of data");
+    char tag = data_[pos_++];
+    if (tag == dataTag || tag == cdataTag) {
+        char* value = readString(doc);
+        return doc.doc()->allocate_node(tag == dataTag ? rapidxml::node_data : rapidxml::node_cdata, nullptr, value);
+    }
+    QL_REQUIRE(tag == elementTag, "BinaryXMLReader: invalid node tag " << static_cast<int>(tag));
+    char* name = readName(doc);
+    char* value = readString(doc);
+    XMLNode* node = doc.doc()->allocate_node(rapidxml::node_element, name, value);
+    std::uint32_t nAttributes = readInt();
+    for (std::uint32_t i = 0; i < nAttributes; ++i) {
+        char* attrName = readName(doc);
+        char* attrValue = readString(doc);
+        node->append_attribute(doc.doc()->allocate_attribute(attrName, attrValue));
+    }
+    std::uint32_t nChildren = readInt();
+    for (std::uint32_t i = 0; i < nChildren; ++i)
+        node->append_node(read(doc));
+    return node;
+}
+
+} // namespace data
+} // namespace ore
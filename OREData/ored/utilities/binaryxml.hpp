@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/utilities/binaryxml.hpp
+    \brief compact binary representation of xml node trees
+    \ingroup utilities
+*/
+
+#pragma once
+
+#include <ored/utilities/xmlutils.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ore {
+namespace data {
+
+//! Writer serialising xml node trees into a compact binary form
+/*! The nodes are written in pre-order. Element and attribute names are written once into a dictionary that is shared
+    by all trees written by the same writer and referenced by index afterwards, values are written as length prefixed
+    strings. Reading the binary form back with a BinaryXMLReader rebuilds the node tree without any text parsing.
+
+    Element, data and CDATA nodes are written, other node types (comments, declarations, etc.) are skipped. The
+    integers are written in native byte order.
+
+    \ingroup utilities
+*/
+class BinaryXMLWriter {
+public:
+    //! Append the tree with root \p node
+    void write(XMLNode* node);
+    //! The binary data written so far
+    const std::string& data() const { return data_; }
+
+private:
+    void writeInt(const std::uint32_t i);
+    void writeString(const char* s, const std::size_t n);
+    void writeName(const char* s, const std::size_t n);
+
+    std::string data_;
+    std::unordered_map<std::string, std::uint32_t> names_;
+};
+
+//! Reader rebuilding the xml node trees written by a BinaryXMLWriter
+/*! The nodes are allocated in the given document, so that the document can be released after each tree to bound the
+    memory used. The data must outlive the reader.
+
+    \ingroup utilities
+*/
+class BinaryXMLReader {
+public:
+    BinaryXMLReader(const char* data, const std::size_t size);
+
+    //! Read the next tree into \p doc, the returned root node is not appended to the document
+    XMLNode* read(XMLDocument& doc);
+    //! True if all trees have been read
+    bool atEnd() const { return pos_ == size_; }
+
+private:
+    std::uint32_t readInt();
+    char* readString(XMLDocument& doc);
+    char* readName(XMLDocument& doc);
+
+    const char* data_;
+    std::size_t size_, pos_ = 0;
+    std::vector<std::string> names_;
+};
+
+} // namespace data
+} // namespace ore
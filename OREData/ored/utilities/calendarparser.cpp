@@ -26,6 +26,7 @@
 #include <qle/calendars/amendedcalendar.hpp>
 #include <qle/calendars/austria.hpp>
 #include <qle/calendars/belgium.hpp>
+#include <qle/calendars/cachedcalendar.hpp>
 #include <qle/calendars/cme.hpp>
 #include <qle/calendars/colombia.hpp>
 #include <qle/calendars/cyprus.hpp>
@@ -58,37 +59,65 @@ using namespace QuantExt;
 CalendarParser::CalendarParser() { reset(); }
 
 QuantLib::Calendar CalendarParser::parseCalendar(const std::string& name) const {
-    boost::shared_lock<boost::shared_mutex> lock(mutex_);
-    auto it = calendars_.find(name);
-    if (it != calendars_.end())
-        return it->second;
-    else {
-        // Try to split them up
-        std::vector<std::string> calendarNames;
-        split(calendarNames, name, boost::is_any_of(",()")); // , is delimiter, the brackets may arise if joint calendar
-        // if we have only one token, we won't make progress and exit here to avoid an infinite loop by calling
-        // parseCalendar() recursively below
-        QL_REQUIRE(calendarNames.size() > 1, "Cannot convert \"" << name << "\" to calendar");
-        // now remove any leading strings indicating a joint calendar
-        calendarNames.erase(std::remove(calendarNames.begin(), calendarNames.end(), "JoinHolidays"),
-                            calendarNames.end());
-        calendarNames.erase(std::remove(calendarNames.begin(), calendarNames.end(), "JoinBusinessDays"),
-                            calendarNames.end());
-        calendarNames.erase(std::remove(calendarNames.begin(), calendarNames.end(), ""), calendarNames.end());
-        // Populate a vector of calendars.
-        std::vector<QuantLib::Calendar> calendars;
-        for (Size i = 0; i < calendarNames.size(); i++) {
-            boost::trim(calendarNames[i]);
-            try {
-                calendars.push_back(parseCalendar(calendarNames[i]));
-            } catch (std::exception& e) {
-                QL_FAIL("Cannot convert \"" << name << "\" to Calendar [exception:" << e.what() << "]");
-            } catch (...) {
-                QL_FAIL("Cannot convert \"" << name << "\" to Calendar [unhandled exception]");
-            }
+    QuantLib::Year firstYear, lastYear;
+    QuantLib::Calendar cal;
+    {
+        boost::shared_lock<boost::shared_mutex> lock(mutex_);
+        firstYear = cachedFirstYear_;
+        lastYear = cachedLastYear_;
+        if (firstYear <= lastYear) {
+            auto it = cachedCalendars_.find(name);
+            if (it != cachedCalendars_.end())
+                return it->second;
+        }
+        auto it = calendars_.find(name);
+        if (it != calendars_.end()) {
+            if (firstYear > lastYear)
+                return it->second;
+            cal = it->second;
         }
-        return QuantLib::JointCalendar(calendars);
     }
+    if (cal.empty()) {
+        std::vector<QuantLib::Calendar> calendars = jointCalendars(name);
+        if (firstYear > lastYear)
+            return QuantLib::JointCalendar(calendars);
+        cal = CachedCalendar(calendars, JoinHolidays, firstYear, lastYear);
+    } else {
+        cal = CachedCalendar(cal, firstYear, lastYear);
+    }
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    return cachedCalendars_.insert(std::make_pair(name, cal)).first->second;
+}
+
+std::vector<QuantLib::Calendar> CalendarParser::jointCalendars(const std::string& name) const {
+    // Try to split them up
+    std::vector<std::string> calendarNames;
+    split(calendarNames, name, boost::is_any_of(",()")); // , is delimiter, the brackets may arise if joint calendar
+    // if we have only one token, we won't make progress
+    QL_REQUIRE(calendarNames.size() > 1, "Cannot convert \"" << name << "\" to calendar");
+    // now remove any leading strings indicating a joint calendar
+    calendarNames.erase(std::remove(calendarNames.begin(), calendarNames.end(), "JoinHolidays"), calendarNames.end());
+    calendarNames.erase(std::remove(calendarNames.begin(), calendarNames.end(), "JoinBusinessDays"),
+                        calendarNames.end());
+    calendarNames.erase(std::remove(calendarNames.begin(), calendarNames.end(), ""), calendarNames.end());
+    // Populate a vector of calendars, the tokens are single calendar names
+    std::vector<QuantLib::Calendar> calendars;
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    for (Size i = 0; i < calendarNames.size(); i++) {
+        boost::trim(calendarNames[i]);
+        auto it = calendars_.find(calendarNames[i]);
+        QL_REQUIRE(it != calendars_.end(), "Cannot convert \"" << name << "\" to Calendar [exception:Cannot convert \""
+                                                                << calendarNames[i] << "\" to calendar]");
+        calendars.push_back(it->second);
+    }
+    return calendars;
+}
+
+void CalendarParser::setCachedYears(QuantLib::Year firstYear, QuantLib::Year lastYear) {
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    cachedFirstYear_ = firstYear;
+    cachedLastYear_ = lastYear;
+    cachedCalendars_.clear();
 }
 
 QuantLib::Calendar CalendarParser::addCalendar(const std::string baseName, std::string& newName) {
@@ -108,6 +137,8 @@ void CalendarParser::reset() {
     resetAddedAndRemovedHolidays();
 
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    cachedFirstYear_ = 1;
+    cachedLastYear_ = 0;
 
     // When adding to the static map, keep in mind that the calendar name on the LHS might be used to add or remove
     // holidays in calendaradjustmentconfig.xml. The calendar on the RHS of the mapping will then be adjusted, so this
@@ -439,6 +470,7 @@ void CalendarParser::reset() {
 
 void CalendarParser::resetAddedAndRemovedHolidays() {
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    cachedCalendars_.clear();
     for (auto& m : calendars_) {
         m.second.resetAddedAndRemovedHolidays();
     }
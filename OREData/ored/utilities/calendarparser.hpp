@@ -23,6 +23,7 @@
 #pragma once
 
 #include <map>
+#include <vector>
 #include <ql/patterns/singleton.hpp>
 #include <ql/time/calendar.hpp>
 
@@ -40,9 +41,20 @@ public:
     void reset();
     void resetAddedAndRemovedHolidays();
 
+    /*! Return calendars with the business days precomputed for the years firstYear to lastYear, see
+        QuantExt::CachedCalendar. Single and joint calendars are cached once per name. The calendar adjustments should
+        be applied before, holidays added to a returned calendar are not seen by other calendars. Caching is switched
+        off for firstYear > lastYear, which is the default. */
+    void setCachedYears(QuantLib::Year firstYear, QuantLib::Year lastYear);
+
 private:
+    // the calendars to join for a joint calendar name
+    std::vector<QuantLib::Calendar> jointCalendars(const std::string& name) const;
+
     mutable boost::shared_mutex mutex_;
     std::map<std::string, QuantLib::Calendar> calendars_;
+    QuantLib::Year cachedFirstYear_ = 1, cachedLastYear_ = 0;
+    mutable std::map<std::string, QuantLib::Calendar> cachedCalendars_;
 };
 
 } // namespace data
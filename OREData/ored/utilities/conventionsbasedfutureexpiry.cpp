@@ -20,6 +20,8 @@
 #include <ored/utilities/log.hpp>
 #include <qle/time/dateutilities.hpp>
 
+#include <boost/functional/hash.hpp>
+
 using namespace QuantLib;
 using std::string;
 
@@ -33,11 +35,12 @@ ConventionsBasedFutureExpiry::ConventionsBasedFutureExpiry(const std::string& co
     QL_REQUIRE(p, "ConventionsBasedFutureExpiry: could not cast to CommodityFutureConvention for '"
                       << commName << "', this is an internal error. Contact support.");
     convention_ = *p;
+    cache_ = convention_.expiryCache();
 }
 
 ConventionsBasedFutureExpiry::ConventionsBasedFutureExpiry(const CommodityFutureConvention& convention,
                                                            QuantLib::Size maxIterations)
-    : convention_(convention), maxIterations_(maxIterations) {}
+    : convention_(convention), maxIterations_(maxIterations), cache_(convention_.expiryCache()) {}
 
 Date ConventionsBasedFutureExpiry::nextExpiry(bool includeExpiry, const Date& referenceDate, Natural offset,
                                               bool forOption) {
@@ -144,8 +147,33 @@ QuantLib::Date ConventionsBasedFutureExpiry::applyFutureMonthOffset(const QuantL
     return tmp;
 }
 
-Date ConventionsBasedFutureExpiry::expiry(Day dayOfMonth, Month contractMonth, Year contractYear, QuantLib::Natural monthOffset,
-                                          bool forOption) const {
+Date ConventionsBasedFutureExpiry::expiry(Day dayOfMonth, Month contractMonth, Year contractYear,
+                                          QuantLib::Natural monthOffset, bool forOption) const {
+    if (!cache_)
+        return computeExpiry(dayOfMonth, contractMonth, contractYear, monthOffset, forOption);
+    auto key = std::make_tuple(dayOfMonth, contractMonth, contractYear, monthOffset, forOption);
+    std::size_t h = holidays();
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cache_->mutex);
+        if (cache_->holidays == h) {
+            auto it = cache_->expiries.find(key);
+            if (it != cache_->expiries.end())
+                return it->second;
+        }
+    }
+    Date result = computeExpiry(dayOfMonth, contractMonth, contractYear, monthOffset, forOption);
+    boost::unique_lock<boost::shared_mutex> lock(cache_->mutex);
+    if (cache_->holidays != h) {
+        cache_->expiries.clear();
+        cache_->nextExpiries.clear();
+        cache_->holidays = h;
+    }
+    cache_->expiries[key] = result;
+    return result;
+}
+
+Date ConventionsBasedFutureExpiry::computeExpiry(Day dayOfMonth, Month contractMonth, Year contractYear,
+                                                 QuantLib::Natural monthOffset, bool forOption) const {
 
     Date expiry;
     if (convention_.contractFrequency() == Weekly) {
@@ -279,6 +307,45 @@ Date ConventionsBasedFutureExpiry::expiry(Day dayOfMonth, Month contractMonth, Y
 }
 
 Date ConventionsBasedFutureExpiry::nextExpiry(const Date& referenceDate, bool forOption) const {
+    if (!cache_)
+        return computeNextExpiry(referenceDate, forOption);
+    auto key = std::make_pair(referenceDate, forOption);
+    std::size_t h = holidays();
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cache_->mutex);
+        if (cache_->holidays == h) {
+            auto it = cache_->nextExpiries.find(key);
+            if (it != cache_->nextExpiries.end())
+                return it->second;
+        }
+    }
+    Date result = computeNextExpiry(referenceDate, forOption);
+    boost::unique_lock<boost::shared_mutex> lock(cache_->mutex);
+    if (cache_->holidays != h) {
+        cache_->expiries.clear();
+        cache_->nextExpiries.clear();
+        cache_->holidays = h;
+    }
+    cache_->nextExpiries[key] = result;
+    return result;
+}
+
+std::size_t ConventionsBasedFutureExpiry::holidays() const {
+    std::size_t seed = 0;
+    for (const Calendar& c : {convention_.calendar(), convention_.expiryCalendar()}) {
+        if (c.empty())
+            continue;
+        for (const Date& d : c.addedHolidays())
+            boost::hash_combine(seed, d.serialNumber());
+        boost::hash_combine(seed, c.addedHolidays().size());
+        for (const Date& d : c.removedHolidays())
+            boost::hash_combine(seed, d.serialNumber());
+        boost::hash_combine(seed, c.removedHolidays().size());
+    }
+    return seed;
+}
+
+Date ConventionsBasedFutureExpiry::computeNextExpiry(const Date& referenceDate, bool forOption) const {
 
     // If contract frequency is daily, next expiry is simply the next valid date on expiry calendar.
 
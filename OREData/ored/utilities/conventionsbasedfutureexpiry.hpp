@@ -60,14 +60,26 @@ public:
 private:
     CommodityFutureConvention convention_;
     QuantLib::Size maxIterations_;
+    //! expiry dates shared by all calculators built from copies of the same convention
+    QuantLib::ext::shared_ptr<CommodityFutureConvention::ExpiryCache> cache_;
 
-    //! Given a \p contractMonth, a \p contractYear and \p conventions, calculate the contract expiry date
+    //! Given a \p contractMonth, a \p contractYear and \p conventions, return the (cached) contract expiry date
     QuantLib::Date expiry(QuantLib::Day dayOfMonth, QuantLib::Month contractMonth, QuantLib::Year contractYear,
                           QuantLib::Natural monthOffset, bool forOption) const;
 
-    //! Do the next expiry work
+    //! Calculate the contract expiry date
+    QuantLib::Date computeExpiry(QuantLib::Day dayOfMonth, QuantLib::Month contractMonth, QuantLib::Year contractYear,
+                                 QuantLib::Natural monthOffset, bool forOption) const;
+
+    //! Return the (cached) next expiry
     QuantLib::Date nextExpiry(const QuantLib::Date& referenceDate, bool forOption) const;
 
+    //! Do the next expiry work
+    QuantLib::Date computeNextExpiry(const QuantLib::Date& referenceDate, bool forOption) const;
+
+    //! Hash of the added and removed holidays of the convention calendars, the cache is cleared if it changes
+    std::size_t holidays() const;
+
     //! Account for prohibited expiries
     QuantLib::Date avoidProhibited(const QuantLib::Date& expiry, bool forOption) const;
 };
@@ -18,10 +18,19 @@
 
 #include <ored/utilities/csvfilereader.hpp>
 
-#include <ql/errors.hpp> 
-#include <ql/utilities/null.hpp> 
+#include <ored/utilities/parsers.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/utilities/null.hpp>
 
 #include <boost/algorithm/string/trim.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <exception>
+#include <future>
 
 using QuantLib::Null;
 
@@ -146,5 +155,187 @@ CSVBufferReader::CSVBufferReader(const std::string& bufferName, const bool first
 
 }
 
+CSVMappedFileReader::CSVMappedFileReader(const std::string& fileName, const bool firstLineContainsHeaders,
+                                         const std::string& delimiters, const char eolMarker)
+    : CSVReader(firstLineContainsHeaders, delimiters, "", "", eolMarker), fileName_(fileName),
+      delimiters_(delimiters) {
+    QL_REQUIRE(boost::filesystem::exists(fileName), "CSVMappedFileReader: file '" << fileName << "' not found");
+    // an empty file can not be mapped
+    if (boost::filesystem::file_size(fileName) > 0) {
+        file_.open(fileName);
+        dataBegin_ = file_.data();
+        end_ = file_.data() + file_.size();
+    }
+    if (hasHeaders_) {
+        QL_REQUIRE(dataBegin_ != end_, "CSVMappedFileReader: file '" << fileName << "' is empty");
+        std::string_view line = nextLine(dataBegin_);
+        split(line, fields_);
+        for (auto const& f : fields_)
+            headers_.push_back(std::string(f));
+        numberOfColumns_ = headers_.size();
+        fields_.clear();
+    }
+    pos_ = dataBegin_;
+}
+
+std::string_view CSVMappedFileReader::nextLine(const char*& pos) const {
+    const char* eol = std::find(pos, end_, eolMarker_);
+    const char *b = pos, *e = eol;
+    while (b != e && std::isspace(static_cast<unsigned char>(*b)))
+        ++b;
+    while (e != b && std::isspace(static_cast<unsigned char>(*(e - 1))))
+        --e;
+    pos = eol == end_ ? end_ : eol + 1;
+    return std::string_view(b, e - b);
+}
+
+void CSVMappedFileReader::split(const std::string_view line, std::vector<std::string_view>& fields) const {
+    fields.clear();
+    std::size_t start = 0;
+    while (true) {
+        std::size_t p = line.find_first_of(delimiters_, start);
+        if (p == std::string_view::npos) {
+            fields.push_back(line.substr(start));
+            return;
+        }
+        fields.push_back(line.substr(start, p - start));
+        start = p + 1;
+    }
+}
+
+bool CSVMappedFileReader::next() {
+    std::string_view line;
+    // skip empty lines
+    while (line.empty() && pos_ != end_)
+        line = nextLine(pos_);
+    if (line.empty()) {
+        fields_.clear();
+        return false;
+    }
+    if (currentLine_ == QuantLib::Null<Size>())
+        currentLine_ = 0;
+    else
+        ++currentLine_;
+    split(line, fields_);
+    if (numberOfColumns_ == QuantLib::Null<Size>())
+        numberOfColumns_ = fields_.size();
+    else
+        QL_REQUIRE(fields_.size() == numberOfColumns_, "CSVMappedFileReader: data line #"
+                                                           << currentLine_ << " has " << fields_.size()
+                                                           << " fields, expected " << numberOfColumns_);
+    return true;
+}
+
+std::string_view CSVMappedFileReader::field(const Size column) const {
+    QL_REQUIRE(currentLine_ != QuantLib::Null<Size>(),
+               "CSVMappedFileReader: can not get data, need call to next() first");
+    QL_REQUIRE(column < fields_.size(),
+               "CSVMappedFileReader: column " << column << " out of bounds 0..." << fields_.size() - 1);
+    return fields_[column];
+}
+
+std::string CSVMappedFileReader::get(const Size column) const { return std::string(field(column)); }
+
+std::string CSVMappedFileReader::get(const std::string& field) const {
+    QL_REQUIRE(hasHeaders_, "CSVMappedFileReader: can not get data by field, file does not have headers");
+    Size index = std::find(headers_.begin(), headers_.end(), field) - headers_.begin();
+    QL_REQUIRE(index < headers_.size(), "CSVMappedFileReader: field \"" << field << "\" not found.");
+    return get(index);
+}
+
+QuantLib::Real CSVMappedFileReader::getReal(const Size column) const {
+    std::string_view s = field(column);
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    const char* b = s.data();
+    const char* e = s.data() + s.size();
+    if (b != e && *b == '+')
+        ++b;
+    double value;
+    auto [ptr, ec] = std::from_chars(b, e, value);
+    QL_REQUIRE(ec == std::errc() && ptr == e, "CSVMappedFileReader: failed to parse real from '" << s << "'");
+    return value;
+#else
+    return parseReal(std::string(s));
+#endif
+}
+
+void CSVMappedFileReader::close() {
+    if (file_.is_open())
+        file_.close();
+    dataBegin_ = end_ = pos_ = nullptr;
+    fields_.clear();
+}
+
+void CSVMappedFileReader::forEachLine(const LineCallback& f, const Size nChunks) const {
+    QL_REQUIRE(nChunks > 0, "CSVMappedFileReader::forEachLine(): nChunks must be positive");
+
+    // determine the expected number of columns from the header or the first data line
+
+    Size nColumns = numberOfColumns_;
+    std::vector<std::string_view> fields;
+    if (nColumns == QuantLib::Null<Size>()) {
+        const char* p = dataBegin_;
+        std::string_view line;
+        while (line.empty() && p != end_)
+            line = nextLine(p);
+        if (line.empty())
+            return;
+        split(line, fields);
+        nColumns = fields.size();
+    }
+
+    // split the data at line boundaries
+
+    std::vector<const char*> bounds(1, dataBegin_);
+    const Size size = end_ - dataBegin_;
+    for (Size i = 1; i < nChunks; ++i) {
+        const char* b = std::max(bounds.back(), dataBegin_ + size * i / nChunks);
+        // the chunk starts after the next eol marker, unless the previous character is one
+        if (b != dataBegin_ && b != end_ && *(b - 1) != eolMarker_) {
+            b = std::find(b, end_, eolMarker_);
+            if (b != end_)
+                ++b;
+        }
+        bounds.push_back(b);
+    }
+    bounds.push_back(end_);
+
+    auto process = [this, &f, &bounds, nColumns](const Size chunk) {
+        std::vector<std::string_view> fields;
+        const char* p = bounds[chunk];
+        while (p < bounds[chunk + 1]) {
+            std::string_view line = nextLine(p);
+            if (line.empty())
+                continue;
+            split(line, fields);
+            QL_REQUIRE(fields.size() == nColumns, "CSVMappedFileReader: data line '"
+                                                      << line << "' in '" << fileName_ << "' has " << fields.size()
+                                                      << " fields, expected " << nColumns);
+            f(chunk, fields);
+        }
+    };
+
+    if (nChunks == 1) {
+        process(0);
+        return;
+    }
+
+    std::vector<std::future<void>> results;
+    for (Size i = 0; i < nChunks; ++i)
+        results.push_back(std::async(std::launch::async, process, i));
+    // wait for all chunks before rethrowing the first exception, since the chunks refer to local data
+    std::exception_ptr error;
+    for (auto& r : results) {
+        try {
+            r.get();
+        } catch (...) {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
 } // namespace data
 } // namespace ore
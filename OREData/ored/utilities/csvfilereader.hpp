@@ -25,10 +25,13 @@
 
 #include <ql/types.hpp>
 
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/tokenizer.hpp>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <sstream>
+#include <string_view>
 #include <vector>
 
 namespace ore {
@@ -54,23 +57,26 @@ public:
     /*! Returns the number of columns */
     Size numberOfColumns() const;
     /*! Go to next line in file, returns false if there are no more lines */
-    bool next();
+    virtual bool next();
     /*! Number of the current data line */
     Size currentLine() const;
     /*! Get content of field in current data line, throws if field is not present */
-    std::string get(const std::string& field) const;
+    virtual std::string get(const std::string& field) const;
     /*! Get content of column in current data line, throws if column is out of range */
-    std::string get(const Size column) const;
+    virtual std::string get(const Size column) const;
     /*! Close the file */
     virtual void close() {}
 
-private:
-    std::istream* stream_;
+protected:
     const bool hasHeaders_;
     const char eolMarker_;
     Size currentLine_, numberOfColumns_;
+    std::vector<std::string> headers_;
+
+private:
+    std::istream* stream_;
     boost::tokenizer<boost::escaped_list_separator<char>> tokenizer_;
-    std::vector<std::string> headers_, data_;
+    std::vector<std::string> data_;
 };
 
 class CSVFileReader : public CSVReader {
@@ -99,6 +105,49 @@ private:
     
 };
 
+/*! Reader for large delimited files, the file is memory mapped and the fields of a line are returned as views into
+    the mapped file without copying. Quote and escape characters are not supported, i.e. each delimiter starts a new
+    field, use the CSVFileReader for files that require quoting. Leading and trailing whitespace of a line is removed
+    and empty lines are skipped, as in the CSVReader.
+
+    In addition to the CSVReader interface, forEachLine() processes all data lines of the file in chunks split at
+    line boundaries, optionally in parallel. */
+class CSVMappedFileReader : public CSVReader {
+public:
+    //! Callback for forEachLine(), receiving the index of the chunk and the fields of a data line
+    using LineCallback = std::function<void(const Size chunk, const std::vector<std::string_view>& fields)>;
+
+    /*! Ctor */
+    CSVMappedFileReader(const std::string& fileName, const bool firstLineContainsHeaders,
+                        const std::string& delimiters = ",;\t", const char eolMarker = '\n');
+
+    bool next() override;
+    std::string get(const std::string& field) const override;
+    std::string get(const Size column) const override;
+    void close() override;
+
+    /*! Get a view on the content of a column in the current data line, throws if column is out of range. The view is
+        valid until the reader is closed or destroyed. */
+    std::string_view field(const Size column) const;
+    /*! Get the content of a column in the current data line as a real number */
+    QuantLib::Real getReal(const Size column) const;
+
+    /*! Call f for all data lines of the file, independent of the state of next(). The data is split into nChunks
+        chunks at line boundaries, which are processed in parallel if nChunks > 1. Within a chunk f is called in the
+        order of the lines in the file. If nChunks > 1, f must be thread safe. Exceptions thrown by f are rethrown. */
+    void forEachLine(const LineCallback& f, const Size nChunks = 1) const;
+
+private:
+    std::string_view nextLine(const char*& pos) const;
+    void split(const std::string_view line, std::vector<std::string_view>& fields) const;
+
+    const std::string fileName_;
+    const std::string delimiters_;
+    boost::iostreams::mapped_file_source file_;
+    const char *dataBegin_ = nullptr, *end_ = nullptr, *pos_ = nullptr;
+    std::vector<std::string_view> fields_;
+};
+
 } // namespace data
 } // namespace ore
 
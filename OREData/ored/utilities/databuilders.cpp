@@ -209,6 +209,7 @@
 #include <ored/portfolio/worstofbasketswap.hpp>
 
 #include <qle/math/basiccpuenvironment.hpp>
+#include <qle/math/cudaenvironment.hpp>
 #include <qle/math/openclenvironment.hpp>
 
 #include <boost/thread/lock_types.hpp>
@@ -543,6 +544,7 @@ void dataBuilders() {
     ORE_REGISTER_TRS_UNDERLYING_BUILDER("CBO", CBOTrsUnderlyingBuilder, false)
 
     ORE_REGISTER_COMPUTE_FRAMEWORK_CREATOR("OpenCL", QuantExt::OpenClFramework, false);
+    ORE_REGISTER_COMPUTE_FRAMEWORK_CREATOR("CUDA", QuantExt::CudaFramework, false);
     ORE_REGISTER_COMPUTE_FRAMEWORK_CREATOR("BasicCpu", QuantExt::BasicCpuFramework, false);
 }
 
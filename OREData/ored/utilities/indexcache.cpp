@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/configuration/conventions.hpp>
+#include <ored/utilities/indexcache.hpp>
+
+#include <ql/settings.hpp>
+
+#include <boost/thread/locks.hpp>
+
+#include <sstream>
+
+namespace ore {
+namespace data {
+
+namespace {
+std::string key(const std::string& name) {
+    // the conventions are identified by their generation, an address could be reused by conventions set later
+    std::ostringstream out;
+    out << name << '\0' << QuantLib::Settings::instance().evaluationDate().serialNumber() << '\0'
+        << InstrumentConventions::instance().generation();
+    return out.str();
+}
+} // namespace
+
+QuantLib::ext::shared_ptr<QuantLib::Index>
+IndexCache::index(const std::string& name, const std::function<QuantLib::ext::shared_ptr<QuantLib::Index>()>& builder) {
+    std::string k = key(name);
+    {
+        boost::shared_lock<boost::shared_mutex> lock(mutex_);
+        if (auto i = indices_.find(k); i != indices_.end()) {
+            ++hits_;
+            return i->second;
+        }
+    }
+    // failed parses throw and are not cached
+    auto index = builder();
+    ++misses_;
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    indices_.emplace(k, index);
+    return index;
+}
+
+void IndexCache::clear() {
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    indices_.clear();
+    hits_ = 0;
+    misses_ = 0;
+}
+
+QuantLib::Size IndexCache::size() const {
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return indices_.size();
+}
+
+} // namespace data
+} // namespace ore
@@ -0,0 +1,69 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/utilities/indexcache.hpp
+    \brief process wide cache for indices parsed from their ORE names
+    \ingroup utilities
+*/
+
+#pragma once
+
+#include <ql/index.hpp>
+#include <ql/patterns/singleton.hpp>
+
+#include <boost/thread/shared_mutex.hpp>
+
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+
+namespace ore {
+namespace data {
+
+/*! Caches the index prototypes returned by parseIndex(), so that repeated lookups of the same name, e.g. in
+    applyFixings(), the fixing manager or the trade builders, share one parse instead of trying the index parsers,
+    looking up the conventions and constructing a new index each time.
+
+    The cached indices are not linked to any term structure and are shared between callers, callers that need a
+    linked index clone the prototype as before. The key consists of the name, the evaluation date and the generation
+    of the conventions in use, since parsing depends on both, e.g. for commodity future indices with an expiry
+    relative to today.
+
+    The hit and miss counters report how many parses the cache saved, they are reset by clear(). */
+class IndexCache : public QuantLib::Singleton<IndexCache, std::integral_constant<bool, true>> {
+public:
+    //! returns the cached index for the given name, or the index built by \p builder if not in the cache yet
+    QuantLib::ext::shared_ptr<QuantLib::Index>
+    index(const std::string& name, const std::function<QuantLib::ext::shared_ptr<QuantLib::Index>()>& builder);
+
+    //! clear the cache and the counters
+    void clear();
+
+    //! inspectors
+    QuantLib::Size size() const;
+    QuantLib::Size hits() const { return hits_; }
+    QuantLib::Size misses() const { return misses_; }
+
+private:
+    mutable boost::shared_mutex mutex_;
+    std::unordered_map<std::string, QuantLib::ext::shared_ptr<QuantLib::Index>> indices_;
+    std::atomic<QuantLib::Size> hits_ = 0, misses_ = 0;
+};
+
+} // namespace data
+} // namespace ore
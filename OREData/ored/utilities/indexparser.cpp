@@ -28,6 +28,7 @@
 #include <map>
 #include <ored/configuration/conventions.hpp>
 #include <ored/utilities/conventionsbasedfutureexpiry.hpp>
+#include <ored/utilities/indexcache.hpp>
 #include <ored/utilities/indexnametranslator.hpp>
 #include <ored/utilities/indexparser.hpp>
 #include <ored/utilities/log.hpp>
@@ -906,7 +907,8 @@ QuantLib::ext::shared_ptr<QuantExt::CommodityIndex> parseCommodityIndex(const st
     return index;
 }
 
-QuantLib::ext::shared_ptr<Index> parseIndex(const string& s) {
+namespace {
+QuantLib::ext::shared_ptr<Index> parseIndexUncached(const string& s) {
     QuantLib::ext::shared_ptr<QuantLib::Index> ret_idx;
     try {
         ret_idx = parseEquityIndex(s);
@@ -963,6 +965,11 @@ QuantLib::ext::shared_ptr<Index> parseIndex(const string& s) {
     QL_REQUIRE(ret_idx, "parseIndex \"" << s << "\" not recognized");
     return ret_idx;
 }
+} // namespace
+
+QuantLib::ext::shared_ptr<Index> parseIndex(const string& s) {
+    return IndexCache::instance().index(s, [&s]() { return parseIndexUncached(s); });
+}
 
 bool isOvernightIndex(const string& indexName) {
     
@@ -177,7 +177,8 @@ QuantLib::ext::shared_ptr<QuantExt::CommodityIndex> parseCommodityIndex(
 QuantLib::ext::shared_ptr<QuantLib::Index> parseGenericIndex(const string& s);
 
 //! Convert std::string to QuantLib::Index
-/*!
+/*! The returned index is a prototype shared via the IndexCache, it is not linked to any term structure and must not
+    be modified, clone it to link term structures.
     \ingroup utilities
 */
 QuantLib::ext::shared_ptr<Index> parseIndex(const string& s);
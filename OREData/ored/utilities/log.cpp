@@ -31,6 +31,8 @@
 #include <boost/log/support/date_time.hpp>
 #include <boost/log/sources/severity_feature.hpp>
 #include <boost/phoenix/bind/bind_function.hpp>
+#include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/to_string.hpp>
@@ -268,13 +270,195 @@ void EventLogger::setFormatter(
         fileSink_->set_formatter(formatter);
 }
 
+// A single producer single consumer ring buffer of log records, used in the asynchronous mode of the Log. The
+// producer is the thread owning the queue, the consumer is the thread holding the flush mutex of the Log.
+class AsyncLogQueue {
+public:
+    struct Record {
+        unsigned mask = 0;
+        const char* filename = nullptr;
+        int lineNo = 0;
+        ptime time;
+        string msg;
+    };
+
+    explicit AsyncLogQueue(std::size_t capacity) : records_(capacity) {}
+
+    // returns false if the queue is full, r is only moved from on success
+    bool push(Record& r) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        std::size_t next = (tail + 1) % records_.size();
+        if (next == head_.load(std::memory_order_acquire))
+            return false;
+        records_[tail] = std::move(r);
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(Record& r) {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return false;
+        r = std::move(records_[head]);
+        head_.store((head + 1) % records_.size(), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+    // set when the owning thread exits, the queue is removed once it is empty
+    std::atomic<bool> closed = false;
+
+private:
+    std::vector<Record> records_;
+    std::atomic<std::size_t> head_ = 0, tail_ = 0;
+};
+
+namespace {
+
+// capacity of the per thread queues in asynchronous mode
+constexpr std::size_t asyncLogQueueSize = 8192;
+
+// the background thread writes the queued messages at least with this frequency
+constexpr std::chrono::milliseconds asyncLogFlushInterval(20);
+
+// marks the queue of a thread as closed when the thread exits
+struct ThreadLogQueue {
+    std::shared_ptr<AsyncLogQueue> queue;
+    ~ThreadLogQueue() {
+        if (queue)
+            queue->closed.store(true, std::memory_order_release);
+    }
+};
+
+// the queue of the calling thread, null until the thread logs in asynchronous mode
+thread_local ThreadLogQueue threadLogQueue;
+
+// counts the threads between the check of the asynchronous flag and the end of the push to their queue
+struct AsyncWriterGuard {
+    explicit AsyncWriterGuard(std::atomic<std::size_t>& writers) : writers_(writers) { writers_.fetch_add(1); }
+    ~AsyncWriterGuard() { writers_.fetch_sub(1); }
+    std::atomic<std::size_t>& writers_;
+};
+
+} // namespace
+
 // The Log itself
-Log::Log() : loggers_(), enabled_(false), mask_(255), ls_() {
+Log::Log() : loggers_(), enabled_(false), mask_(255), activeMask_(0), ls_() {
 
     ls_.setf(ios::fixed, ios::floatfield);
     ls_.setf(ios::showpoint);
 }
 
+Log::~Log() { setAsynchronous(false); }
+
+void Log::write(unsigned m, const char* filename, int lineNo, const string& msg) {
+    if (asynchronous()) {
+        /* the flag is checked again after registering as a writer, setAsynchronous(false) clears the flag and then
+           waits for the registered writers, so a message is either queued before the final drain or written
+           synchronously below */
+        AsyncWriterGuard guard(asyncWriters_);
+        if (asynchronous_.load()) {
+            AsyncLogQueue::Record r{m, filename, lineNo, microsec_clock::local_time(), msg};
+            AsyncLogQueue& queue = threadQueue();
+            while (!queue.push(r)) {
+                // the queue is full, wake up the background thread and wait for it to make room
+                flusherCondition_.notify_one();
+                std::this_thread::yield();
+            }
+            return;
+        }
+    }
+    // messages this thread queued before the asynchronous mode was switched off are written first
+    if (threadLogQueue.queue && !threadLogQueue.queue->empty())
+        flush();
+    if (checkExcludeFilters(msg))
+        return;
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    header(m, filename, lineNo);
+    ls_ << msg;
+    log(m);
+}
+
+AsyncLogQueue& Log::threadQueue() {
+    if (!threadLogQueue.queue) {
+        threadLogQueue.queue = std::make_shared<AsyncLogQueue>(asyncLogQueueSize);
+        std::lock_guard<std::mutex> lock(queuesMutex_);
+        queues_.push_back(threadLogQueue.queue);
+    }
+    return *threadLogQueue.queue;
+}
+
+std::size_t Log::flush() {
+    std::lock_guard<std::mutex> flushLock(flushMutex_);
+    std::vector<std::shared_ptr<AsyncLogQueue>> queues;
+    {
+        std::lock_guard<std::mutex> lock(queuesMutex_);
+        // remove the queues of exited threads once they are drained, the closed flag is read before the emptiness
+        // check, so that no message pushed before closing is lost
+        queues_.erase(std::remove_if(queues_.begin(), queues_.end(),
+                                     [](const std::shared_ptr<AsyncLogQueue>& q) {
+                                         return q->closed.load(std::memory_order_acquire) && q->empty();
+                                     }),
+                      queues_.end());
+        queues = queues_;
+    }
+    std::size_t n = 0;
+    AsyncLogQueue::Record r;
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    for (auto const& q : queues) {
+        // write the messages present now, a thread logging continuously must not block the other queues
+        for (std::size_t i = 0; i < asyncLogQueueSize && q->pop(r); ++i, ++n) {
+            if (excluded(r.msg))
+                continue;
+            header(r.mask, r.filename, r.lineNo, r.time);
+            ls_ << r.msg;
+            log(r.mask);
+        }
+    }
+    return n;
+}
+
+void Log::runFlusher() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(flusherMutex_);
+            if (stopFlusher_)
+                break;
+            flusherCondition_.wait_for(lock, asyncLogFlushInterval);
+        }
+        while (flush() > 0) {
+        }
+    }
+}
+
+void Log::setAsynchronous(bool b) {
+    if (b == asynchronous())
+        return;
+    if (b) {
+        {
+            std::lock_guard<std::mutex> lock(flusherMutex_);
+            stopFlusher_ = false;
+        }
+        flusher_ = std::thread(&Log::runFlusher, this);
+        asynchronous_.store(true, std::memory_order_release);
+    } else {
+        asynchronous_.store(false);
+        // wait for the threads that saw the asynchronous mode to finish their push, the flusher keeps making room
+        while (asyncWriters_.load() != 0)
+            std::this_thread::yield();
+        {
+            std::lock_guard<std::mutex> lock(flusherMutex_);
+            stopFlusher_ = true;
+        }
+        flusherCondition_.notify_one();
+        if (flusher_.joinable())
+            flusher_.join();
+        while (flush() > 0) {
+        }
+    }
+}
+
 void Log::registerLogger(const QuantLib::ext::shared_ptr<Logger>& logger) {
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     QL_REQUIRE(loggers_.find(logger->name()) == loggers_.end(),
@@ -318,6 +502,8 @@ QuantLib::ext::shared_ptr<IndependentLogger>& Log::independentLogger(const strin
 }
 
 void Log::removeLogger(const string& name) {
+    // write the queued messages to the loggers that were registered when they were logged
+    flush();
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     map<string, QuantLib::ext::shared_ptr<Logger>>::iterator it = loggers_.find(name);
     if (it != loggers_.end()) {
@@ -339,6 +525,7 @@ void Log::removeIndependentLogger(const string& name) {
 }
 
 void Log::removeAllLoggers() {
+    flush();
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     loggers_.clear();
     logging::core::get()->remove_all_sinks();
@@ -381,6 +568,10 @@ void Log::removeExcludeFilter(const string& key) {
 
 bool Log::checkExcludeFilters(const std::string& msg) {
     boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return excluded(msg);
+}
+
+bool Log::excluded(const std::string& msg) const {
     for (const auto& f : excludeFilters_) {
         if (f.second(msg))
             return true;
@@ -389,6 +580,10 @@ bool Log::checkExcludeFilters(const std::string& msg) {
 }
 
 void Log::header(unsigned m, const char* filename, int lineNo) {
+    header(m, filename, lineNo, microsec_clock::local_time());
+}
+
+void Log::header(unsigned m, const char* filename, int lineNo, const ptime& time) {
     // 1. Reset stringstream
     ls_.str(string());
     ls_.clear();
@@ -425,7 +620,7 @@ void Log::header(unsigned m, const char* filename, int lineNo) {
     // Timestamp
     // Use boost::posix_time microsecond clock to get better precision (when available).
     // format is "2014-Apr-04 11:10:16.179347"
-    ls_ << '[' << to_simple_string(microsec_clock::local_time()) << ']';
+    ls_ << '[' << to_simple_string(time) << ']';
 
     // Filename & line no
     // format is " (file:line)"
@@ -479,12 +674,8 @@ LoggerStream::~LoggerStream() {
     string text;
     while (getline(ss_, text)) {
         // we expand the MLOG macro here so we can overwrite __FILE__ and __LINE__
-        if (ore::data::Log::instance().enabled() && ore::data::Log::instance().filter(mask_)) {
-            boost::unique_lock<boost::shared_mutex> lock(ore::data::Log::instance().mutex());
-            ore::data::Log::instance().header(mask_, filename_, lineNo_);
-            ore::data::Log::instance().logStream() << text;
-            ore::data::Log::instance().log(mask_);
-        }
+        if (ore::data::logCompiledIn(mask_) && ore::data::Log::instance().active(mask_))
+            ore::data::Log::instance().write(mask_, filename_, lineNo_, text);
     }
 }
 
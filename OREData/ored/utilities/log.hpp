@@ -33,6 +33,13 @@
 #define ORE_DATA 64    // 01000000  127
 #define ORE_MEMORY 128 // 10000000  255
 
+/*! Log statements with a severity below ORE_COMPILE_TIME_LOG_LEVEL, i.e. with a higher value of the mask above, are
+    compiled out, e.g. -DORE_COMPILE_TIME_LOG_LEVEL=ORE_NOTICE removes all DLOG, TLOG and MEM_LOG statements. By
+    default all log statements are compiled in and filtered at run time by the log mask only. */
+#ifndef ORE_COMPILE_TIME_LOG_LEVEL
+#define ORE_COMPILE_TIME_LOG_LEVEL ORE_MEMORY
+#endif
+
 #include <fstream>
 #include <iostream>
 #include <string>
@@ -64,9 +71,17 @@
 #include <sstream>
 
 #include <boost/any.hpp>
+#include <boost/date_time/posix_time/ptime.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/thread/lock_types.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 enum oreSeverity {
     alert = ORE_ALERT,
     critical = ORE_CRITICAL,
@@ -120,6 +135,8 @@ namespace data {
 typedef boost::log::sinks::synchronous_sink<boost::log::sinks::text_file_backend> file_sink;
 typedef boost::log::sinks::synchronous_sink<boost::log::sinks::text_ostream_backend> text_sink;
 
+class AsyncLogQueue;
+
 //! The Base Custom Log Handler class
 /*!
   This base log handler class can be used to define your own custom handler and then registered with the Log class.
@@ -358,7 +375,8 @@ private:
   Once a message is received, it is immediately dispatched to each of the registered loggers, the order in which
   the loggers are called is not guaranteed.
 
-  Logging is done by the calling thread and the LOG call blocks until all the loggers have returned.
+  Logging is done by the calling thread and the LOG call blocks until all the loggers have returned, unless the
+  asynchronous mode is switched on, see setAsynchronous().
 
   At start up, the Log class has no loggers and so will ignore any LOG() messages until it is configured.
 
@@ -435,6 +453,20 @@ public:
 
     bool checkExcludeFilters(const std::string&);
 
+    //! macro utility function - writes a formatted message, thread safe
+    void write(unsigned m, const char* filename, int lineNo, const std::string& msg);
+
+    //! Switch the asynchronous mode on or off
+    /*! In asynchronous mode a logging thread only appends the message with its time stamp to a lock-free queue of
+        its own, a background thread passes the messages to the loggers. The messages of each thread are written in
+        the order in which they were logged, the messages of different threads may be interleaved differently than
+        in synchronous mode. Switching the asynchronous mode off writes all pending messages, including those of
+        threads that logged concurrently to the switch or have exited since. */
+    void setAsynchronous(bool b);
+    bool asynchronous() const { return asynchronous_.load(std::memory_order_acquire); }
+    //! Writes the messages queued in asynchronous mode to the loggers, returns the number of messages written
+    std::size_t flush();
+
     //! macro utility function - do not use directly, not thread safe
     void header(unsigned m, const char* filename, int lineNo);
     //! macro utility function - do not use directly, not thread safe
@@ -446,18 +478,16 @@ public:
     boost::shared_mutex& mutex() { return mutex_; }
 
     // Avoid a large number of warnings in VS by adding 0 !=
-    bool filter(unsigned mask) {
-        boost::shared_lock<boost::shared_mutex> lock(mutex());
-        return 0 != (mask & mask_);
-    }
-    unsigned mask() {
-        boost::shared_lock<boost::shared_mutex> lock(mutex());
-        return mask_;
-    }
+    // the mask and the enabled flag are atomic, so that filtered messages do not take any lock
+    bool filter(unsigned mask) { return 0 != (mask & mask_.load(std::memory_order_relaxed)); }
+    unsigned mask() { return mask_.load(std::memory_order_relaxed); }
     void setMask(unsigned mask) {
         boost::unique_lock<boost::shared_mutex> lock(mutex());
-        mask_ = mask;
+        mask_.store(mask, std::memory_order_relaxed);
+        updateActiveMask();
     }
+    //! macro utility function - equivalent to enabled() && filter(mask), but with a single relaxed atomic load
+    bool active(unsigned mask) { return 0 != (mask & activeMask_.load(std::memory_order_relaxed)); }
     const boost::filesystem::path& rootPath() {
         boost::shared_lock<boost::shared_mutex> lock(mutex());
         return rootPath_;
@@ -475,17 +505,16 @@ public:
         maxLen_ = n;
     }
 
-    bool enabled() {
-        boost::shared_lock<boost::shared_mutex> lock(mutex());
-        return enabled_;
-    }
+    bool enabled() { return enabled_.load(std::memory_order_relaxed); }
     void switchOn() {
         boost::unique_lock<boost::shared_mutex> lock(mutex());
-        enabled_ = true;
+        enabled_.store(true, std::memory_order_relaxed);
+        updateActiveMask();
     }
     void switchOff() {
         boost::unique_lock<boost::shared_mutex> lock(mutex());
-        enabled_ = false;
+        enabled_.store(false, std::memory_order_relaxed);
+        updateActiveMask();
     }
 
     bool writeSuppressedMessagesHint() {
@@ -496,16 +525,32 @@ public:
     //! if a PID is set for the logger, messages are tagged with [1234] if pid = 1234
     void setPid(const int pid) { pid_ = pid; }
 
+    ~Log();
+
 private:
     Log();
 
     // not thread safe
     std::string source(const char* filename, int lineNo) const;
+    // the mask if the log is enabled and 0 otherwise, the caller must hold a unique lock on the mutex
+    void updateActiveMask() {
+        activeMask_.store(enabled_.load(std::memory_order_relaxed) ? mask_.load(std::memory_order_relaxed) : 0,
+                          std::memory_order_relaxed);
+    }
+    void header(unsigned m, const char* filename, int lineNo, const boost::posix_time::ptime& time);
+    // checks the exclude filters, the caller must hold a lock on the mutex
+    bool excluded(const std::string& msg) const;
+
+    // the queue of the calling thread for the asynchronous mode, created on first use
+    AsyncLogQueue& threadQueue();
+    // the loop of the background thread in asynchronous mode
+    void runFlusher();
 
     std::map<std::string, QuantLib::ext::shared_ptr<Logger>> loggers_;
     std::map<std::string, QuantLib::ext::shared_ptr<IndependentLogger>> independentLoggers_;
-    bool enabled_;
-    unsigned mask_;
+    std::atomic<bool> enabled_;
+    std::atomic<unsigned> mask_;
+    std::atomic<unsigned> activeMask_;
     boost::filesystem::path rootPath_;
     std::ostringstream ls_;
 
@@ -521,22 +566,32 @@ private:
     mutable boost::shared_mutex mutex_;
 
     std::map<std::string, std::function<bool(const std::string&)>> excludeFilters_;
+
+    // asynchronous mode
+    std::atomic<bool> asynchronous_ = false;
+    std::atomic<std::size_t> asyncWriters_ = 0;
+    std::vector<std::shared_ptr<AsyncLogQueue>> queues_;
+    std::mutex queuesMutex_;
+    // only one thread at a time takes messages from the queues
+    std::mutex flushMutex_;
+    std::thread flusher_;
+    bool stopFlusher_ = false;
+    std::mutex flusherMutex_;
+    std::condition_variable flusherCondition_;
 };
 
+//! True if log statements with the given severity are compiled in, see ORE_COMPILE_TIME_LOG_LEVEL
+constexpr bool logCompiledIn(unsigned mask) { return mask <= ORE_COMPILE_TIME_LOG_LEVEL; }
+
 /*!
   Main Logging macro, do not use this directly, use on of the below 6 macros instead
  */                               
 #define MLOG(mask, text)                                                                                               \
     {                                                                                                                  \
-        if (ore::data::Log::instance().enabled() && ore::data::Log::instance().filter(mask)) {                         \
+        if (ore::data::logCompiledIn(mask) && ore::data::Log::instance().active(mask)) {                               \
             std::ostringstream __ore_mlog_tmp_stringstream__;                                                          \
             __ore_mlog_tmp_stringstream__ << text;                                                                     \
-            if (!ore::data::Log::instance().checkExcludeFilters(__ore_mlog_tmp_stringstream__.str())) {                \
-                boost::unique_lock<boost::shared_mutex> lock(ore::data::Log::instance().mutex());                      \
-                ore::data::Log::instance().header(mask, __FILE__, __LINE__);                                           \
-                ore::data::Log::instance().logStream() << __ore_mlog_tmp_stringstream__.str();                         \
-                ore::data::Log::instance().log(mask);                                                                  \
-            }                                                                                                          \
+            ore::data::Log::instance().write(mask, __FILE__, __LINE__, __ore_mlog_tmp_stringstream__.str());           \
         }                                                                                                              \
     }
 
@@ -560,12 +615,10 @@ private:
 
 #define MEM_LOG_USING_LEVEL(LEVEL)                                                                                      \
     {                                                                                                                   \
-        if (ore::data::Log::instance().enabled() && ore::data::Log::instance().filter(LEVEL)) {                         \
-            boost::unique_lock<boost::shared_mutex> lock(ore::data::Log::instance().mutex());                           \
-            ore::data::Log::instance().header(LEVEL, __FILE__, __LINE__);                                               \
-            ore::data::Log::instance().logStream() << std::to_string(ore::data::os::getPeakMemoryUsageBytes()) << "|";  \
-            ore::data::Log::instance().logStream() << std::to_string(ore::data::os::getMemoryUsageBytes());             \
-            ore::data::Log::instance().log(LEVEL);                                                                      \
+        if (ore::data::logCompiledIn(LEVEL) && ore::data::Log::instance().active(LEVEL)) {                              \
+            ore::data::Log::instance().write(LEVEL, __FILE__, __LINE__,                                                 \
+                                             std::to_string(ore::data::os::getPeakMemoryUsageBytes()) + "|" +           \
+                                                 std::to_string(ore::data::os::getMemoryUsageBytes()));                 \
         }                                                                                                               \
     }
 
@@ -620,7 +673,7 @@ private:
 };
 
 #define CHECKED_LOGGERSTREAM(LEVEL, text)                                                       \
-    if (ore::data::Log::instance().enabled() && ore::data::Log::instance().filter(LEVEL)) {     \
+    if (ore::data::logCompiledIn(LEVEL) && ore::data::Log::instance().active(LEVEL)) {          \
         (std::ostream&)ore::data::LoggerStream(LEVEL, __FILE__, __LINE__) << text;              \
     }
 
@@ -20,6 +20,7 @@
 
 #include <iomanip>
 #include <iostream>
+#include <limits>
 
 namespace ore {
 namespace data {
@@ -111,33 +112,111 @@ void ProgressLog::updateProgress(const unsigned long progress, const unsigned lo
 
 void ProgressLog::reset() { messageCounter_ = 0; }
 
+namespace {
+std::atomic<std::size_t> nextMultiThreadedProgressIndicatorId(0);
+} // namespace
+
 MultiThreadedProgressIndicator::MultiThreadedProgressIndicator(
-    const std::set<QuantLib::ext::shared_ptr<ProgressIndicator>>& indicators)
-    : indicators_(indicators) {}
-
-void MultiThreadedProgressIndicator::updateProgress(const unsigned long progress, const unsigned long total, const std::string& detail) {
-    boost::unique_lock<boost::shared_mutex> lock(mutex_);
-    threadData_[std::this_thread::get_id()] = std::make_tuple(progress, total, detail);
-    unsigned long progressTmp = 0;
-    unsigned long totalTmp = 0;
-    std::ostringstream detailTmp;
-    for (auto const& d : threadData_) {
-        progressTmp += std::get<0>(d.second);
-        totalTmp += std::get<1>(d.second);
-
-        if (detailTmp.tellp() != 0)
-            detailTmp << "|";
-        detailTmp << std::get<2>(d.second);
+    const std::set<QuantLib::ext::shared_ptr<ProgressIndicator>>& indicators, const std::chrono::milliseconds interval)
+    : indicators_(indicators), interval_(interval), id_(nextMultiThreadedProgressIndicatorId++),
+      reporter_(&MultiThreadedProgressIndicator::run, this) {}
+
+MultiThreadedProgressIndicator::~MultiThreadedProgressIndicator() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex_);
+        stop_ = true;
+    }
+    stopCondition_.notify_one();
+    reporter_.join();
+    try {
+        report();
+    } catch (const std::exception& e) {
+        ALOG("MultiThreadedProgressIndicator: error while reporting progress: " << e.what());
+    }
+}
+
+MultiThreadedProgressIndicator::ThreadSlot& MultiThreadedProgressIndicator::threadSlot() {
+    thread_local std::size_t cachedId = std::numeric_limits<std::size_t>::max();
+    thread_local ThreadSlot* cachedSlot = nullptr;
+    if (cachedId != id_) {
+        std::lock_guard<std::mutex> lock(slotMutex_);
+        auto& slot = slots_[std::this_thread::get_id()];
+        if (!slot)
+            slot = std::make_unique<ThreadSlot>();
+        cachedId = id_;
+        cachedSlot = slot.get();
+    }
+    return *cachedSlot;
+}
+
+void MultiThreadedProgressIndicator::updateProgress(const unsigned long progress, const unsigned long total,
+                                                    const std::string& detail) {
+    ThreadSlot& slot = threadSlot();
+    if (detail != slot.ownDetail) {
+        slot.ownDetail = detail;
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.detail = detail;
     }
+    slot.total.store(total, std::memory_order_relaxed);
+    slot.progress.store(progress, std::memory_order_relaxed);
+}
+
+void MultiThreadedProgressIndicator::report() {
+    unsigned long progress = 0;
+    unsigned long total = 0;
+    std::ostringstream detail;
+    {
+        std::lock_guard<std::mutex> lock(slotMutex_);
+        if (slots_.empty())
+            return;
+        for (auto const& [id, slot] : slots_) {
+            progress += slot->progress.load(std::memory_order_relaxed);
+            total += slot->total.load(std::memory_order_relaxed);
+            if (detail.tellp() != 0)
+                detail << "|";
+            std::lock_guard<std::mutex> slotLock(slot->mutex);
+            detail << slot->detail;
+        }
+    }
+    std::lock_guard<std::mutex> lock(reportMutex_);
+    if (reported_ && progress == lastProgress_ && total == lastTotal_ && detail.str() == lastDetail_)
+        return;
     for (auto& i : indicators_)
-        i->updateProgress(progressTmp, totalTmp, detailTmp.str());
+        i->updateProgress(progress, total, detail.str());
+    lastProgress_ = progress;
+    lastTotal_ = total;
+    lastDetail_ = detail.str();
+    reported_ = true;
+}
+
+void MultiThreadedProgressIndicator::flush() { report(); }
+
+void MultiThreadedProgressIndicator::run() {
+    std::unique_lock<std::mutex> lock(stopMutex_);
+    while (!stopCondition_.wait_for(lock, interval_, [this] { return stop_; })) {
+        lock.unlock();
+        try {
+            report();
+        } catch (const std::exception& e) {
+            ALOG("MultiThreadedProgressIndicator: error while reporting progress: " << e.what());
+        }
+        lock.lock();
+    }
 }
 
 void MultiThreadedProgressIndicator::reset() {
-    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    {
+        std::lock_guard<std::mutex> lock(slotMutex_);
+        // the details are kept, they are overwritten by the next update of each thread
+        for (auto const& [id, slot] : slots_) {
+            slot->progress.store(0, std::memory_order_relaxed);
+            slot->total.store(0, std::memory_order_relaxed);
+        }
+    }
+    std::lock_guard<std::mutex> lock(reportMutex_);
     for (auto& i : indicators_)
         i->reset();
-    threadData_.clear();
+    reported_ = false;
 }
 
 NoProgressBar::NoProgressBar(const std::string& message, const unsigned int messageWidth) {
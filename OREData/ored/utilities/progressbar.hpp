@@ -28,6 +28,12 @@
 #include <ql/shared_ptr.hpp>
 #include <boost/unordered_set.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <set>
@@ -126,17 +132,51 @@ public:
     void reset() override {}
 };
 
-/*! Progress Manager that consolidates updates from multiple threads */
+/*! Progress Manager that consolidates updates from multiple threads
+
+    Each thread writes its progress to its own slot without taking a lock (except on its first update and when its
+    detail changes). A reporter thread samples the slots at a fixed interval and forwards the consolidated progress to
+    the indicators if it has changed, so the indicators are only called from one thread and never from the calling
+    threads. The last state is forwarded in flush() and on destruction. */
 class MultiThreadedProgressIndicator : public ProgressIndicator {
 public:
-    explicit MultiThreadedProgressIndicator(const std::set<QuantLib::ext::shared_ptr<ProgressIndicator>>& indicators);
+    explicit MultiThreadedProgressIndicator(const std::set<QuantLib::ext::shared_ptr<ProgressIndicator>>& indicators,
+                                            const std::chrono::milliseconds interval = std::chrono::milliseconds(100));
+    ~MultiThreadedProgressIndicator() override;
     void updateProgress(const unsigned long progress, const unsigned long total, const std::string& detail) override;
     void reset() override;
+    //! forward the current progress to the indicators if it has changed since the last report
+    void flush();
 
 private:
-    mutable boost::shared_mutex mutex_;
+    struct ThreadSlot {
+        std::atomic<unsigned long> progress = 0, total = 0;
+        // only accessed by the owning thread
+        std::string ownDetail;
+        // guards detail, which is read by the reporter thread
+        std::mutex mutex;
+        std::string detail;
+    };
+    ThreadSlot& threadSlot();
+    void report();
+    void run();
+
     std::set<QuantLib::ext::shared_ptr<ProgressIndicator>> indicators_;
-    std::map<std::thread::id, std::tuple<unsigned long, unsigned long, std::string>> threadData_;
+    std::chrono::milliseconds interval_;
+    // identifies the instance in the thread local slot cache, addresses might be reused
+    const std::size_t id_;
+    // guards slots_
+    std::mutex slotMutex_;
+    std::map<std::thread::id, std::unique_ptr<ThreadSlot>> slots_;
+    // guards the indicators and the last reported state
+    std::mutex reportMutex_;
+    unsigned long lastProgress_ = 0, lastTotal_ = 0;
+    std::string lastDetail_;
+    bool reported_ = false;
+    std::mutex stopMutex_;
+    std::condition_variable stopCondition_;
+    bool stop_ = false;
+    std::thread reporter_;
 };
 
 } // namespace data
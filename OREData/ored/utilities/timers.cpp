@@ -0,0 +1,181 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/timers.hpp>
+
+#include <ql/errors.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+namespace ore {
+namespace data {
+
+namespace {
+
+// the number of trace events kept per thread, further events are dropped
+constexpr std::size_t maxTraceEvents = 1000000;
+
+void addStatistics(TimerRegistry::Statistics& s, const double value) {
+    if (s.count == 0) {
+        s.min = s.max = value;
+    } else {
+        s.min = std::min(s.min, value);
+        s.max = std::max(s.max, value);
+    }
+    s.total += value;
+    ++s.count;
+}
+
+std::string jsonEscape(const std::string& s) {
+    std::string result;
+    for (char c : s) {
+        if (c == '"' || c == '\\')
+            result.push_back('\\');
+        if (static_cast<unsigned char>(c) >= 0x20)
+            result.push_back(c);
+    }
+    return result;
+}
+
+} // namespace
+
+TimerRegistry& TimerRegistry::instance() {
+    static TimerRegistry registry;
+    return registry;
+}
+
+TimerRegistry::TimerRegistry() : origin_(std::chrono::steady_clock::now()) {}
+
+void TimerRegistry::enable(bool b, bool trace) {
+    tracing_.store(b && trace, std::memory_order_relaxed);
+    enabled_.store(b, std::memory_order_relaxed);
+}
+
+void TimerRegistry::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // the data of exited threads is only referenced by the registry and can be removed
+    threads_.erase(std::remove_if(threads_.begin(), threads_.end(),
+                                  [](const std::shared_ptr<ThreadData>& d) { return d.use_count() == 1; }),
+                   threads_.end());
+    for (auto const& d : threads_) {
+        std::lock_guard<std::mutex> dataLock(d->mutex);
+        d->timers.clear();
+        d->counters.clear();
+        d->events.clear();
+    }
+    origin_ = std::chrono::steady_clock::now();
+}
+
+TimerRegistry::ThreadData& TimerRegistry::threadData() {
+    thread_local std::shared_ptr<ThreadData> data;
+    if (!data) {
+        data = std::make_shared<ThreadData>();
+        std::lock_guard<std::mutex> lock(mutex_);
+        data->id = threads_.size();
+        threads_.push_back(data);
+    }
+    return *data;
+}
+
+void TimerRegistry::count(const std::string& name, double n) {
+    ThreadData& data = threadData();
+    std::string path = data.path.empty() ? name : data.path + '/' + name;
+    std::lock_guard<std::mutex> lock(data.mutex);
+    addStatistics(data.counters[path], n);
+}
+
+void TimerRegistry::record(ThreadData& data, std::size_t nameStart, std::chrono::steady_clock::time_point start,
+                           std::chrono::steady_clock::time_point end) {
+    std::lock_guard<std::mutex> lock(data.mutex);
+    addStatistics(data.timers[data.path], std::chrono::duration<double>(end - start).count());
+    if (tracing() && data.events.size() < maxTraceEvents) {
+        using std::chrono::microseconds;
+        data.events.push_back({data.path.substr(nameStart),
+                               std::chrono::duration_cast<microseconds>(start - origin_).count(),
+                               std::chrono::duration_cast<microseconds>(end - start).count()});
+    }
+}
+
+std::map<std::string, TimerRegistry::Statistics>
+TimerRegistry::merge(std::map<std::string, Statistics> ThreadData::*member) const {
+    std::map<std::string, Statistics> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto const& d : threads_) {
+        std::lock_guard<std::mutex> dataLock(d->mutex);
+        for (auto const& [path, s] : (*d).*member) {
+            Statistics& r = result[path];
+            r.min = r.count == 0 ? s.min : std::min(r.min, s.min);
+            r.max = r.count == 0 ? s.max : std::max(r.max, s.max);
+            r.count += s.count;
+            r.total += s.total;
+            ++r.threads;
+        }
+    }
+    return result;
+}
+
+std::map<std::string, TimerRegistry::Statistics> TimerRegistry::timers() const {
+    return merge(&ThreadData::timers);
+}
+
+std::map<std::string, TimerRegistry::Statistics> TimerRegistry::counters() const {
+    return merge(&ThreadData::counters);
+}
+
+void TimerRegistry::writeChromeTrace(const std::string& filename) const {
+    std::ofstream file(filename);
+    QL_REQUIRE(file.is_open(), "TimerRegistry: error opening file " << filename);
+    file << "{\"traceEvents\":[";
+    bool first = true;
+    std::size_t n = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto const& d : threads_) {
+        std::lock_guard<std::mutex> dataLock(d->mutex);
+        for (auto const& e : d->events) {
+            file << (first ? "\n" : ",\n") << "{\"name\":\"" << jsonEscape(e.name)
+                 << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << d->id << ",\"ts\":" << e.start << ",\"dur\":" << e.duration
+                 << "}";
+            first = false;
+            ++n;
+        }
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    file.close();
+    LOG("TimerRegistry: " << n << " trace events written to " << filename);
+}
+
+void ScopedTimer::start(const char* name) {
+    data_ = &TimerRegistry::instance().threadData();
+    parentLength_ = data_->path.size();
+    if (parentLength_ > 0)
+        data_->path.push_back('/');
+    data_->path.append(name);
+    start_ = std::chrono::steady_clock::now();
+}
+
+void ScopedTimer::stop() {
+    auto end = std::chrono::steady_clock::now();
+    std::size_t nameStart = parentLength_ > 0 ? parentLength_ + 1 : 0;
+    TimerRegistry::instance().record(*data_, nameStart, start_, end);
+    data_->path.resize(parentLength_);
+}
+
+} // namespace data
+} // namespace ore
@@ -0,0 +1,154 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/utilities/timers.hpp
+    \brief registry of hierarchical scoped timers and counters
+    \ingroup utilities
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace data {
+
+//! Registry collecting the statistics of scoped timers and counters
+/*! Timers and counters are identified by their path, i.e. the names of the enclosing timers of the same thread and
+    their own name, separated by '/'. Each thread records into its own storage, the statistics of all threads are
+    merged when they are retrieved. If requested, each timed scope is also recorded as an event, which can be written
+    as a trace file in the Chrome trace event format (to be viewed in chrome://tracing or Perfetto).
+
+    The registry is disabled by default, disabled timers and counters cost a single relaxed atomic load. Unlike the
+    Log, the registry is a process wide singleton and not a QuantLib::Singleton, so that the statistics of all
+    threads end up in the same registry also in builds with QL_ENABLE_SESSIONS = ON.
+
+    \ingroup utilities
+*/
+class TimerRegistry {
+public:
+    struct Statistics {
+        //! number of timed scopes or counter increments
+        std::size_t count = 0;
+        //! total, minimum and maximum time in seconds, resp. counter increment
+        double total = 0.0, min = 0.0, max = 0.0;
+        //! number of threads that contributed
+        std::size_t threads = 0;
+    };
+
+    static TimerRegistry& instance();
+
+    //! Switch the recording on or off, trace events are only recorded if \p trace is true
+    void enable(bool b, bool trace = false);
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    bool tracing() const { return tracing_.load(std::memory_order_relaxed); }
+
+    //! Discard everything recorded so far, should not be called while other threads are recording
+    void reset();
+
+    //! Add \p n to the counter with the given name below the current timer of the calling thread
+    void count(const std::string& name, double n = 1.0);
+
+    //! The merged statistics of the timers, by path
+    std::map<std::string, Statistics> timers() const;
+    //! The merged statistics of the counters, by path
+    std::map<std::string, Statistics> counters() const;
+
+    //! Write the recorded trace events in the Chrome trace event format
+    void writeChromeTrace(const std::string& filename) const;
+
+private:
+    friend class ScopedTimer;
+    TimerRegistry();
+
+    struct TraceEvent {
+        std::string name;
+        std::int64_t start, duration;
+    };
+    struct ThreadData {
+        std::size_t id;
+        // the path of the innermost running timer of the thread, only used by the owning thread
+        std::string path;
+        // guards the members below against concurrent reads
+        mutable std::mutex mutex;
+        std::map<std::string, Statistics> timers, counters;
+        std::vector<TraceEvent> events;
+    };
+
+    ThreadData& threadData();
+    // record the timer given by the current path of the thread, its name starts at nameStart
+    void record(ThreadData& data, std::size_t nameStart, std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::time_point end);
+    std::map<std::string, Statistics> merge(std::map<std::string, Statistics> ThreadData::*member) const;
+
+    std::atomic<bool> enabled_ = false, tracing_ = false;
+    std::chrono::steady_clock::time_point origin_;
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<ThreadData>> threads_;
+};
+
+//! Timer recording the time between its construction and destruction in the TimerRegistry
+/*! Use the macro ORE_TIMER to time the enclosing scope. */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char* name) {
+        if (TimerRegistry::instance().enabled())
+            start(name);
+    }
+    explicit ScopedTimer(const std::string& name) {
+        if (TimerRegistry::instance().enabled())
+            start(name.c_str());
+    }
+    ~ScopedTimer() {
+        if (data_)
+            stop();
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    void start(const char* name);
+    void stop();
+
+    TimerRegistry::ThreadData* data_ = nullptr;
+    std::size_t parentLength_ = 0;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace data
+} // namespace ore
+
+#define ORE_TIMER_CONCAT_IMPL(a, b) a##b
+#define ORE_TIMER_CONCAT(a, b) ORE_TIMER_CONCAT_IMPL(a, b)
+
+//! Time the enclosing scope under the given name
+#define ORE_TIMER(name) ore::data::ScopedTimer ORE_TIMER_CONCAT(ore_scoped_timer_, __LINE__)(name)
+
+//! Add n to the counter with the given name
+#define ORE_COUNTER(name, n)                                                                                           \
+    {                                                                                                                  \
+        if (ore::data::TimerRegistry::instance().enabled())                                                            \
+            ore::data::TimerRegistry::instance().count(name, n);                                                       \
+    }
@@ -65,13 +65,37 @@ std::size_t Wildcard::wildcardPos() const { return wildCardPos_; }
 
 bool Wildcard::isPrefix() const { return prefixString_ ? true : false; }
 
+namespace {
+// match s against a pattern where * is a placeholder for zero or more characters not equal to newline, this is
+// equivalent to matching the regex() string, but avoids the construction and backtracking of a std::regex
+bool globMatch(const std::string& s, const std::string& p) {
+    std::size_t i = 0, j = 0, star = std::string::npos, mark = 0;
+    while (i < s.size()) {
+        if (j < p.size() && p[j] == '*') {
+            star = j++;
+            mark = i;
+        } else if (j < p.size() && p[j] == s[i]) {
+            ++i;
+            ++j;
+        } else if (star != std::string::npos && s[mark] != '\n') {
+            // let the last * consume one more character and retry
+            j = star + 1;
+            i = ++mark;
+        } else {
+            return false;
+        }
+    }
+    while (j < p.size() && p[j] == '*')
+        ++j;
+    return j == p.size();
+}
+} // namespace
+
 bool Wildcard::matches(const std::string& s) const {
     if (prefixString_) {
-        return s.substr(0, (*prefixString_).size()) == (*prefixString_);
+        return s.compare(0, prefixString_->size(), *prefixString_) == 0;
     } else if (regexString_) {
-        if (regex_ == nullptr)
-            regex_ = QuantLib::ext::make_shared<std::regex>(*regexString_);
-        return std::regex_match(s, *regex_);
+        return globMatch(s, pattern_);
     } else {
         return s == pattern_;
     }
@@ -58,7 +58,6 @@ private:
     std::size_t wildCardPos_;
     boost::optional<std::string> regexString_;
     boost::optional<std::string> prefixString_;
-    mutable QuantLib::ext::shared_ptr<std::regex> regex_;
 };
 
 //! checks if at most one element in C has a wild card and returns it in this case
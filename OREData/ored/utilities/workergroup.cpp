@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/utilities/workergroup.hpp>
+
+#include <algorithm>
+
+namespace ore {
+namespace data {
+
+WorkerGroup::WorkerGroup(const QuantLib::Size nThreads) {
+    for (QuantLib::Size w = 1; w < std::max<QuantLib::Size>(nThreads, 1); ++w)
+        threads_.emplace_back([this, w]() { work(w); });
+}
+
+WorkerGroup::~WorkerGroup() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_.notify_all();
+    for (auto& t : threads_)
+        t.join();
+}
+
+void WorkerGroup::run(const QuantLib::Size n, const std::function<void(QuantLib::Size)>& f) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        n_ = n;
+        f_ = &f;
+        errors_.assign(size(), nullptr);
+        pending_ = threads_.size();
+        ++generation_;
+    }
+    start_.notify_all();
+    runBlock(0);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]() { return pending_ == 0; });
+    f_ = nullptr;
+    for (auto const& e : errors_) {
+        if (e)
+            std::rethrow_exception(e);
+    }
+}
+
+void WorkerGroup::work(const QuantLib::Size worker) {
+    QuantLib::Size seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_.wait(lock, [this, seen]() { return stop_ || generation_ != seen; });
+            if (stop_)
+                return;
+            seen = generation_;
+        }
+        runBlock(worker);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_ == 0)
+                done_.notify_one();
+        }
+    }
+}
+
+void WorkerGroup::runBlock(const QuantLib::Size worker) {
+    // n_, f_ and errors_ are set before the generation is incremented and not changed until all blocks are done
+    QuantLib::Size begin = worker * n_ / size(), end = (worker + 1) * n_ / size();
+    try {
+        for (QuantLib::Size i = begin; i < end; ++i)
+            (*f_)(i);
+    } catch (...) {
+        errors_[worker] = std::current_exception();
+    }
+}
+
+} // namespace data
+} // namespace ore
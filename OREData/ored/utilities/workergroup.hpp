@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/utilities/workergroup.hpp
+    \brief a fixed set of worker threads processing index ranges
+    \ingroup utilities
+*/
+
+#pragma once
+
+#include <ql/types.hpp>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ore {
+namespace data {
+
+/*! A fixed set of threads that is reused by successive run() calls, so that code processing its input in chunks does
+    not start new threads per chunk. The threads are started in the constructor and joined in the destructor.
+
+    \ingroup utilities
+*/
+class WorkerGroup {
+public:
+    //! The calling thread of run() is one of the \p nThreads workers, nThreads - 1 threads are started
+    explicit WorkerGroup(const QuantLib::Size nThreads);
+    ~WorkerGroup();
+
+    WorkerGroup(const WorkerGroup&) = delete;
+    WorkerGroup& operator=(const WorkerGroup&) = delete;
+
+    //! The number of workers including the calling thread
+    QuantLib::Size size() const { return threads_.size() + 1; }
+
+    /*! Call \p f(i) for i = 0, ..., n - 1. The range is split into contiguous blocks, one per worker, the calling
+        thread processes the first block. Returns when all blocks are done and rethrows the exception of the first
+        failing block, if any. Not reentrant, run() must not be called concurrently or from \p f. */
+    void run(const QuantLib::Size n, const std::function<void(QuantLib::Size)>& f);
+
+private:
+    void work(const QuantLib::Size worker);
+    void runBlock(const QuantLib::Size worker);
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_, done_;
+    QuantLib::Size generation_ = 0, pending_ = 0;
+    bool stop_ = false;
+    QuantLib::Size n_ = 0;
+    const std::function<void(QuantLib::Size)>* f_ = nullptr;
+    std::vector<std::exception_ptr> errors_;
+};
+
+} // namespace data
+} // namespace ore
@@ -0,0 +1,180 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/utilities/xmlstreamreader.hpp>
+
+#include <ql/errors.hpp>
+
+#include <algorithm>
+#include <cctype>
+
+using QuantLib::Size;
+
+namespace ore {
+namespace data {
+
+XMLStreamReader::XMLStreamReader(const std::string& filename, const std::string& elementName, const Size bufferSize)
+    : filename_(filename), elementName_(elementName), bufferSize_(bufferSize),
+      file_(filename, std::ios::in | std::ios::binary) {
+    QL_REQUIRE(file_.is_open(), "XMLStreamReader: error opening file '" << filename << "'");
+    QL_REQUIRE(bufferSize_ > 0, "XMLStreamReader: buffer size must be positive");
+}
+
+bool XMLStreamReader::readChunk() {
+    if (!file_)
+        return false;
+    // discard the processed part of the buffer, keeping the current element
+    std::string::size_type keep = std::min(pos_, elementStart_);
+    buffer_.erase(0, keep);
+    bufferOffset_ += keep;
+    pos_ -= keep;
+    if (elementStart_ != std::string::npos)
+        elementStart_ -= keep;
+    Size size = buffer_.size();
+    buffer_.resize(size + bufferSize_);
+    file_.read(&buffer_[size], bufferSize_);
+    buffer_.resize(size + static_cast<Size>(file_.gcount()));
+    return file_.gcount() > 0;
+}
+
+bool XMLStreamReader::require(const Size n) {
+    while (buffer_.size() - pos_ < n) {
+        if (!readChunk())
+            return false;
+    }
+    return true;
+}
+
+std::string::size_type XMLStreamReader::find(const std::string& s, Size offset) {
+    while (true) {
+        std::string::size_type p = buffer_.find(s, pos_ + offset);
+        if (p != std::string::npos)
+            return p;
+        // continue the search in the next chunk, a match might start in the unmatched tail of the buffer
+        Size available = buffer_.size() - pos_;
+        if (available >= s.size())
+            offset = std::max(offset, available - s.size() + 1);
+        if (!readChunk())
+            return std::string::npos;
+    }
+}
+
+bool XMLStreamReader::next(std::string& element) {
+
+    while (true) {
+
+        // find the next markup, text is skipped
+
+        std::string::size_type lt = find("<", 0);
+        if (lt == std::string::npos) {
+            QL_REQUIRE(elementStart_ == std::string::npos,
+                       "XMLStreamReader: unexpected end of file '" << filename_ << "' in element " << elementName_);
+            QL_REQUIRE(!rootName_.empty(), "XMLStreamReader: no root element found in file '" << filename_ << "'");
+            QL_REQUIRE(depth_ == 0, "XMLStreamReader: unexpected end of file '" << filename_ << "', root element "
+                                                                               << rootName_ << " is not closed");
+            return false;
+        }
+        pos_ = lt;
+        QL_REQUIRE(require(2), "XMLStreamReader: unexpected end of file '" << filename_ << "'");
+
+        // skip comments, cdata sections, processing instructions and document type declarations
+
+        std::string closing;
+        Size skip = 0;
+        if (require(4) && buffer_.compare(pos_, 4, "<!--") == 0) {
+            closing = "-->";
+            skip = 4;
+        } else if (require(9) && buffer_.compare(pos_, 9, "<![CDATA[") == 0) {
+            closing = "]]>";
+            skip = 9;
+        } else if (buffer_.compare(pos_, 2, "<?") == 0) {
+            closing = "?>";
+            skip = 2;
+        } else if (buffer_.compare(pos_, 2, "<!") == 0) {
+            closing = ">";
+            skip = 2;
+        }
+        if (!closing.empty()) {
+            std::string::size_type end = find(closing, skip);
+            QL_REQUIRE(end != std::string::npos,
+                       "XMLStreamReader: unexpected end of file '" << filename_ << "', expected '" << closing << "'");
+            pos_ = end + closing.size();
+            continue;
+        }
+
+        // find the end of the tag, '>' can appear in quoted attribute values
+
+        Size offset = 1;
+        char quote = 0;
+        while (true) {
+            if (pos_ + offset >= buffer_.size()) {
+                QL_REQUIRE(readChunk(), "XMLStreamReader: unexpected end of file '" << filename_ << "' in tag");
+                continue;
+            }
+            char c = buffer_[pos_ + offset];
+            if (quote != 0) {
+                if (c == quote)
+                    quote = 0;
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '>') {
+                break;
+            }
+            ++offset;
+        }
+
+        std::string::size_type tagStart = pos_, tagEnd = pos_ + offset;
+        bool isClosingTag = buffer_[tagStart + 1] == '/';
+        bool isEmptyElement = !isClosingTag && buffer_[tagEnd - 1] == '/';
+        Size nameStart = tagStart + (isClosingTag ? 2 : 1), nameEnd = nameStart;
+        while (nameEnd < tagEnd && !std::isspace(static_cast<unsigned char>(buffer_[nameEnd])) &&
+               buffer_[nameEnd] != '/')
+            ++nameEnd;
+        std::string name = buffer_.substr(nameStart, nameEnd - nameStart);
+        pos_ = tagEnd + 1;
+
+        if (isClosingTag) {
+            QL_REQUIRE(depth_ > 0, "XMLStreamReader: unexpected closing tag '" << name << "' in file '" << filename_
+                                                                              << "'");
+            --depth_;
+            if (depth_ == 1 && elementStart_ != std::string::npos) {
+                element = buffer_.substr(elementStart_, pos_ - elementStart_);
+                offset_ = bufferOffset_ + elementStart_;
+                elementStart_ = std::string::npos;
+                return true;
+            }
+        } else {
+            if (depth_ == 0) {
+                QL_REQUIRE(rootName_.empty(), "XMLStreamReader: multiple root elements in file '" << filename_ << "'");
+                rootName_ = name;
+            } else if (depth_ == 1 && name == elementName_) {
+                if (isEmptyElement) {
+                    element = buffer_.substr(tagStart, pos_ - tagStart);
+                    offset_ = bufferOffset_ + tagStart;
+                    return true;
+                }
+                elementStart_ = tagStart;
+            }
+            if (!isEmptyElement)
+                ++depth_;
+        }
+    }
+}
+
+} // namespace data
+} // namespace ore
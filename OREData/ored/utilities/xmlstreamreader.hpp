@@ -0,0 +1,80 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/utilities/xmlstreamreader.hpp
+    \brief reader returning the child elements of the root element of a large xml file one at a time
+    \ingroup utilities
+*/
+
+#pragma once
+
+#include <ql/types.hpp>
+
+#include <fstream>
+#include <string>
+
+namespace ore {
+namespace data {
+
+//! Reader returning the child elements with a given name of the root element of an xml file one at a time
+/*! The file is read in chunks of \p bufferSize bytes, only the current element and the unprocessed part of the last
+    chunk are held in memory, so that the memory used is bounded by the size of the largest element plus the buffer
+    size, independent of the size of the file. The returned elements can be parsed with XMLDocument::fromXMLString().
+
+    The reader scans the markup only, i.e. it skips comments, CDATA sections, processing instructions and document
+    type declarations and tracks the element depth, so that nested elements with the same name (e.g. the component
+    trades of a composite trade) are part of the returned element. The well-formedness of the elements is checked
+    by the xml parser when they are parsed. Document type declarations with an internal subset are not supported.
+
+    \ingroup utilities
+*/
+class XMLStreamReader {
+public:
+    XMLStreamReader(const std::string& filename, const std::string& elementName,
+                    const QuantLib::Size bufferSize = 1 << 20);
+
+    //! The name of the root element, empty before the first call to next()
+    const std::string& rootName() const { return rootName_; }
+
+    //! Read the next element into \p element, returns false if there are no more elements
+    bool next(std::string& element);
+
+    //! The offset in bytes of the element returned by the last call to next() from the start of the file
+    QuantLib::Size offset() const { return offset_; }
+
+private:
+    // read the next chunk of the file into the buffer, returns false at the end of the file
+    bool readChunk();
+    // make sure that the buffer contains the first n bytes from pos_, returns false at the end of the file
+    bool require(const QuantLib::Size n);
+    // find s from pos_ + offset, reading chunks as required, returns the position in the buffer or npos
+    std::string::size_type find(const std::string& s, const QuantLib::Size offset);
+
+    std::string filename_, elementName_;
+    QuantLib::Size bufferSize_;
+    std::ifstream file_;
+    std::string buffer_, rootName_;
+    // the current scan position in the buffer and the start of the current element or npos
+    std::string::size_type pos_ = 0, elementStart_ = std::string::npos;
+    QuantLib::Size depth_ = 0;
+    // the file offset of the start of the buffer and of the last returned element
+    QuantLib::Size bufferOffset_ = 0, offset_ = 0;
+};
+
+} // namespace data
+} // namespace ore
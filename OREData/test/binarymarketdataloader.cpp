@@ -0,0 +1,191 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/marketdata/binarymarketdataloader.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/inmemoryloader.hpp>
+#include <ored/marketdata/lazyclonedloader.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+using namespace ore::data;
+using namespace QuantLib;
+using namespace std;
+
+using ore::test::TopLevelFixture;
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(BinaryMarketDataLoaderTests)
+
+BOOST_AUTO_TEST_CASE(testAgainstCsvLoader) {
+
+    BOOST_TEST_MESSAGE("Testing BinaryMarketDataLoader against CSVLoader...");
+
+    std::string marketFile = TEST_OUTPUT_FILE("market.txt");
+    std::string binaryFile = TEST_OUTPUT_FILE("market.bin");
+
+    // two dates, reverse fx quotes, a duplicate and an invalid quote
+
+    {
+        std::ofstream out(marketFile);
+        out << "# comment line\n"
+            << "2016-02-26 ZERO/RATE/EUR/EUR1D/A365/2016-03-01 0.001\n"
+            << "2016-02-26 ZERO/RATE/EUR/EUR1D/A365/2017-02-26 0.002\n"
+            << "2016-02-26 ZERO/RATE/USD/USD1D/A365/2017-02-26 0.008\n"
+            << "2016-02-26 FX/RATE/EUR/USD 1.0861\n"
+            << "2016-02-26 FX/RATE/USD/EUR 0.9207\n"
+            << "2016-02-26 FX/RATE/USD/JPY 112.97\n"
+            << "2016-02-26 FX/RATE/USD/JPY 113.00\n"
+            << "2016-02-26 INVALID/QUOTE 1.0\n"
+            << "\n"
+            << "2016-02-25 ZERO/RATE/EUR/EUR1D/A365/2017-02-25 0.0021\n"
+            << "2016-02-25 FX/RATE/USD/EUR 0.9210\n";
+    }
+
+    writeBinaryMarketDataFile({marketFile}, binaryFile);
+
+    CSVLoader csvLoader(std::vector<std::string>{marketFile}, std::vector<std::string>{}, false);
+    BinaryMarketDataLoader loader(binaryFile);
+
+    BOOST_CHECK_EQUAL(loader.numberOfQuotes(), 9);
+    BOOST_CHECK_EQUAL(loader.numberOfMaterialisedQuotes(), 0);
+
+    // single quotes are materialised on demand
+
+    Date asof(26, Feb, 2016);
+    auto md = loader.get("ZERO/RATE/EUR/EUR1D/A365/2017-02-26", asof);
+    BOOST_CHECK_EQUAL(md->name(), "ZERO/RATE/EUR/EUR1D/A365/2017-02-26");
+    BOOST_CHECK_EQUAL(md->quote()->value(), 0.002);
+    BOOST_CHECK_EQUAL(md->asofDate(), asof);
+    BOOST_CHECK_EQUAL(loader.numberOfMaterialisedQuotes(), 1);
+    BOOST_CHECK(loader.get("ZERO/RATE/EUR/EUR1D/A365/2017-02-26", asof) == md);
+    BOOST_CHECK_EQUAL(loader.numberOfMaterialisedQuotes(), 1);
+    BOOST_CHECK_EQUAL(loader.get("FX/RATE/USD/JPY", asof)->quote()->value(), 112.97);
+    BOOST_CHECK_THROW(loader.get("ZERO/RATE/EUR/EUR1D/A365/2017-02-26", Date(25, Feb, 2016)), QuantLib::Error);
+    BOOST_CHECK(!loader.has("INVALID/QUOTE", asof));
+    BOOST_CHECK(!loader.has("UNKNOWN/QUOTE", asof));
+    BOOST_CHECK(!loader.hasQuotes(Date(24, Feb, 2016)));
+
+    // all queries match the CSVLoader
+
+    auto names = [](const std::vector<QuantLib::ext::shared_ptr<MarketDatum>>& v) {
+        std::set<std::string> result;
+        for (auto const& md : v)
+            result.insert(md->name());
+        return result;
+    };
+    auto namesFromSet = [&names](const std::set<QuantLib::ext::shared_ptr<MarketDatum>>& s) {
+        return names(std::vector<QuantLib::ext::shared_ptr<MarketDatum>>(s.begin(), s.end()));
+    };
+
+    for (auto const& d : {Date(25, Feb, 2016), asof, Date(24, Feb, 2016)}) {
+        auto expected = names(csvLoader.loadQuotes(d));
+        auto result = names(loader.loadQuotes(d));
+        BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), expected.begin(), expected.end());
+        BOOST_CHECK_EQUAL(loader.hasQuotes(d), csvLoader.hasQuotes(d));
+        for (auto const& md : csvLoader.loadQuotes(d))
+            BOOST_CHECK_EQUAL(loader.get(md->name(), d)->quote()->value(), md->quote()->value());
+        for (auto const& w : {"ZERO/RATE/EUR/*", "FX/RATE/*", "*/EUR1D/*", "ZERO/RATE/EUR/EUR1D/A365/2017-02-26",
+                              "NOTHING/*"}) {
+            auto expected = namesFromSet(csvLoader.get(Wildcard(w), d));
+            auto result = namesFromSet(loader.get(Wildcard(w), d));
+            BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), expected.begin(), expected.end());
+        }
+        std::set<std::string> query{"FX/RATE/EUR/USD", "FX/RATE/USD/EUR", "ZERO/RATE/USD/USD1D/A365/2017-02-26",
+                                    "INVALID/QUOTE"};
+        expected = namesFromSet(csvLoader.get(query, d));
+        result = namesFromSet(loader.get(query, d));
+        BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), expected.begin(), expected.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testLazyClonedLoader) {
+
+    BOOST_TEST_MESSAGE("Testing LazyClonedLoader...");
+
+    Date asof(26, Feb, 2016);
+    auto source = QuantLib::ext::make_shared<InMemoryLoader>();
+    source->add(asof, "ZERO/RATE/EUR/EUR1D/A365/2017-02-26", 0.002);
+    source->add(asof, "ZERO/RATE/USD/USD1D/A365/2017-02-26", 0.008);
+    source->add(asof, "FX/RATE/EUR/USD", 1.0861);
+    source->addFixing(Date(25, Feb, 2016), "EUR-EONIA", 0.0025);
+
+    LazyClonedLoader loader(asof, source);
+    BOOST_CHECK_EQUAL(loader.numberOfClonedQuotes(), 0);
+
+    // quotes are cloned on demand and memoised
+
+    auto original = source->get("FX/RATE/EUR/USD", asof);
+    auto md = loader.get("FX/RATE/EUR/USD", asof);
+    BOOST_CHECK(md != original);
+    BOOST_CHECK(md->quote().currentLink() != original->quote().currentLink());
+    BOOST_CHECK_EQUAL(md->name(), original->name());
+    BOOST_CHECK_EQUAL(md->quote()->value(), 1.0861);
+    BOOST_CHECK_EQUAL(loader.numberOfClonedQuotes(), 1);
+    BOOST_CHECK(loader.get("FX/RATE/EUR/USD", asof) == md);
+    BOOST_CHECK(loader.get(Wildcard("FX/RATE/*"), asof).count(md) == 1);
+    BOOST_CHECK_EQUAL(loader.numberOfClonedQuotes(), 1);
+
+    // bulk queries return the memoised clones as well
+
+    auto quotes = loader.loadQuotes(asof);
+    BOOST_CHECK_EQUAL(quotes.size(), 3);
+    BOOST_CHECK_EQUAL(loader.numberOfClonedQuotes(), 3);
+    BOOST_CHECK(std::find(quotes.begin(), quotes.end(), md) != quotes.end());
+    BOOST_CHECK(loader.has("ZERO/RATE/USD/USD1D/A365/2017-02-26", asof));
+    BOOST_CHECK(!loader.has("UNKNOWN/QUOTE", asof));
+
+    // fixings are forwarded to the source loader
+
+    BOOST_CHECK(loader.hasFixing("EUR-EONIA", Date(25, Feb, 2016)));
+    BOOST_CHECK_EQUAL(loader.getFixing("EUR-EONIA", Date(25, Feb, 2016)).fixing, 0.0025);
+    BOOST_CHECK_EQUAL(loader.loadFixings().size(), 1);
+
+    // loaders on several threads share the source, but each thread gets its own quotes
+
+    const Size nThreads = 4;
+    std::vector<QuantLib::ext::shared_ptr<MarketDatum>> clones(nThreads);
+    std::vector<std::thread> workers;
+    for (Size i = 0; i < nThreads; ++i) {
+        workers.emplace_back([&clones, &source, &asof, i]() {
+            LazyClonedLoader threadLoader(asof, source);
+            for (Size k = 0; k < 100; ++k)
+                threadLoader.loadQuotes(asof);
+            clones[i] = threadLoader.get("ZERO/RATE/EUR/EUR1D/A365/2017-02-26", asof);
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+    std::set<const Quote*> distinct;
+    for (auto const& c : clones) {
+        BOOST_REQUIRE(c);
+        BOOST_CHECK_EQUAL(c->quote()->value(), 0.002);
+        distinct.insert(c->quote().currentLink().get());
+    }
+    BOOST_CHECK_EQUAL(distinct.size(), nThreads);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/model/calibrationresultcache.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <boost/filesystem.hpp>
+
+using namespace ore::data;
+using namespace std;
+
+using ore::test::TopLevelFixture;
+
+namespace {
+// switches the cache off and removes the entries at the end of a test
+struct CalibrationResultCacheResetter {
+    ~CalibrationResultCacheResetter() {
+        CalibrationResultCache::instance().enable(false);
+        CalibrationResultCache::instance().clear();
+    }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CalibrationResultCacheTests)
+
+BOOST_AUTO_TEST_CASE(testKey) {
+
+    BOOST_TEST_MESSAGE("Testing the keys of the calibration result cache...");
+
+    // 64 bit FNV-1a reference values
+    BOOST_CHECK_EQUAL(CalibrationResultCache::key(""), "cbf29ce484222325");
+    BOOST_CHECK_EQUAL(CalibrationResultCache::key("a"), "af63dc4c8601ec8c");
+    BOOST_CHECK(CalibrationResultCache::key("LGM 1") != CalibrationResultCache::key("LGM 2"));
+}
+
+BOOST_AUTO_TEST_CASE(testSaveAndLoad) {
+
+    BOOST_TEST_MESSAGE("Testing saving and loading the calibration result cache...");
+
+    CalibrationResultCacheResetter resetter;
+    auto& cache = CalibrationResultCache::instance();
+    cache.clear();
+
+    cache.put("k1", {{0.01, 0.0123456789012345, -0.5}, 1.0E-9});
+    cache.put("k2", {{}, 0.0});
+
+    CalibrationResultCache::Entry entry;
+    BOOST_CHECK(!cache.get("k3", entry));
+    BOOST_REQUIRE(cache.get("k1", entry));
+    BOOST_CHECK_EQUAL(entry.params.size(), 3);
+
+    auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    cache.save(path.string());
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+    cache.load(path.string());
+    boost::filesystem::remove(path);
+
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+    BOOST_REQUIRE(cache.get("k1", entry));
+    BOOST_REQUIRE_EQUAL(entry.params.size(), 3);
+    // the values are written with full precision and must be restored exactly
+    BOOST_CHECK_EQUAL(entry.params[0], 0.01);
+    BOOST_CHECK_EQUAL(entry.params[1], 0.0123456789012345);
+    BOOST_CHECK_EQUAL(entry.params[2], -0.5);
+    BOOST_CHECK_EQUAL(entry.error, 1.0E-9);
+    BOOST_REQUIRE(cache.get("k2", entry));
+    BOOST_CHECK(entry.params.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -253,6 +253,26 @@ BOOST_AUTO_TEST_CASE(testCcySwapWithResetsPrice) {
         }
     }
     BOOST_CHECK_EQUAL(sumXNL, 0);
+
+    // a parallel build of copies of the swaps yields the same prices
+    auto parallelPortfolio = QuantLib::ext::make_shared<Portfolio>();
+    for (Size i = 0; i < 20; ++i) {
+        QuantLib::ext::shared_ptr<Trade> s(new ore::data::Swap(env, legUSD, i % 2 == 0 ? legEUR1 : legEUR2));
+        s->id() = "XCCY_Swap_" + std::to_string(i);
+        parallelPortfolio->add(s);
+    }
+    parallelPortfolio->build(engineFactory, "test", true, 4);
+    BOOST_REQUIRE_EQUAL(parallelPortfolio->size(), 20);
+    for (Size i = 0; i < 20; ++i) {
+        auto s = parallelPortfolio->get("XCCY_Swap_" + std::to_string(i));
+        BOOST_CHECK_CLOSE(s->instrument()->NPV(), (i % 2 == 0 ? swap1 : swap2)->instrument()->NPV(), 1E-10);
+    }
+
+    // all swaps share one cached engine
+    auto stats = engineFactory->builder("CrossCurrencySwap")->cacheStatistics();
+    BOOST_CHECK_EQUAL(stats.size, 1);
+    BOOST_CHECK_EQUAL(stats.misses, 1);
+    BOOST_CHECK_GE(stats.hits, 21);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
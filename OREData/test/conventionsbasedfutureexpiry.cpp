@@ -102,6 +102,37 @@ BOOST_DATA_TEST_CASE(testExpiryDates, bdata::make(commodityNames), commodityName
     }
 }
 
+BOOST_AUTO_TEST_CASE(testSharedExpiryCache) {
+
+    BOOST_TEST_MESSAGE("Testing that expiry dates are shared by calculators built from the same convention");
+
+    Conventions conventions;
+    conventions.fromFile(TEST_INPUT_FILE("nymex_cl_conventions.xml"));
+    auto convention = QuantLib::ext::dynamic_pointer_cast<CommodityFutureConvention>(conventions.get("nymex_cl"));
+    BOOST_TEST_REQUIRE(convention);
+    BOOST_TEST_REQUIRE(convention->expiryCache());
+
+    // the calculators hold copies of the convention, the second one reads the dates cached by the first one
+    ConventionsBasedFutureExpiry first(*convention);
+    Date contractDate(1, Feb, 2020);
+    BOOST_CHECK_EQUAL(first.expiryDate(contractDate, 0), Date(21, Jan, 2020));
+    Size cached = convention->expiryCache()->expiries.size();
+    BOOST_CHECK(cached > 0);
+    ConventionsBasedFutureExpiry second(*convention);
+    BOOST_CHECK_EQUAL(second.expiryDate(contractDate, 0), Date(21, Jan, 2020));
+    BOOST_CHECK_EQUAL(convention->expiryCache()->expiries.size(), cached);
+    BOOST_CHECK_EQUAL(second.nextExpiry(true, Date(2, Jan, 2020)), first.nextExpiry(true, Date(2, Jan, 2020)));
+    BOOST_CHECK(!convention->expiryCache()->nextExpiries.empty());
+
+    // a holiday on the cached expiry date invalidates the cache
+    Calendar calendar = convention->calendar();
+    calendar.addHoliday(Date(21, Jan, 2020));
+    Date shifted = second.expiryDate(contractDate, 0);
+    calendar.removeHoliday(Date(21, Jan, 2020));
+    BOOST_CHECK(shifted < Date(21, Jan, 2020));
+    BOOST_CHECK_EQUAL(first.expiryDate(contractDate, 0), Date(21, Jan, 2020));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,125 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+
+#include "oredtestmarket.hpp"
+
+#include <oret/toplevelfixture.hpp>
+
+#include <ored/model/crossassetmodelbuilder.hpp>
+#include <ored/model/irlgmdata.hpp>
+#include <ored/utilities/to_string.hpp>
+
+#include <ql/quotes/simplequote.hpp>
+#include <ql/time/calendars/target.hpp>
+
+using namespace ore::data;
+using namespace QuantLib;
+using namespace QuantExt;
+
+namespace {
+
+QuantLib::ext::shared_ptr<IrLgmData> lgmData(const std::string& ccy, const std::vector<Real>& times,
+                                             const std::vector<std::string>& expiries, const std::string& term) {
+    auto config = QuantLib::ext::make_shared<IrLgmData>();
+    config->qualifier() = ccy;
+    config->reversionType() = LgmData::ReversionType::HullWhite;
+    config->volatilityType() = LgmData::VolatilityType::Hagan;
+    config->calibrateH() = false;
+    config->hParamType() = ParamType::Constant;
+    config->hTimes() = std::vector<Real>();
+    config->calibrationType() = CalibrationType::Bootstrap;
+    config->scaling() = 1.0;
+    config->shiftHorizon() = 0.0;
+    config->hValues() = {0.0050};
+    config->calibrateA() = true;
+    config->aParamType() = ParamType::Piecewise;
+    config->aTimes() = times;
+    config->aValues() = std::vector<Real>(times.size() + 1, 0.0030);
+    config->optionExpiries() = expiries;
+    config->optionTerms() = std::vector<std::string>(expiries.size(), term);
+    config->optionStrikes() = std::vector<std::string>(expiries.size(), "ATM");
+    return config;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CrossAssetModelBuilderTest)
+
+BOOST_AUTO_TEST_CASE(testConcurrentIrCalibration) {
+
+    BOOST_TEST_MESSAGE("Testing that the IR calibration on several threads gives the sequential model parameters");
+
+    Date asof(7, July, 2019);
+    Settings::instance().evaluationDate() = asof;
+    auto testMarket = QuantLib::ext::make_shared<OredTestMarket>(asof);
+
+    std::vector<std::string> expiries;
+    std::vector<Real> times;
+    for (Size i = 1; i <= 9; ++i) {
+        expiries.push_back(ore::data::to_string(asof + i * Years));
+        times.push_back(testMarket->discountCurve("EUR")->timeFromReference(TARGET().advance(asof, i * Years)));
+    }
+
+    std::vector<QuantLib::ext::shared_ptr<IrModelData>> irConfigs = {lgmData("EUR", times, expiries, "2029-07-07"),
+                                                                     lgmData("USD", times, expiries, "2029-07-07")};
+
+    auto configFX = QuantLib::ext::make_shared<FxBsData>();
+    configFX->foreignCcy() = "USD";
+    configFX->domesticCcy() = "EUR";
+    configFX->calibrationType() = CalibrationType::Bootstrap;
+    configFX->calibrateSigma() = true;
+    configFX->sigmaParamType() = ParamType::Piecewise;
+    configFX->sigmaTimes() = times;
+    configFX->sigmaValues() = std::vector<Real>(times.size() + 1, 0.0030);
+    configFX->optionExpiries() = expiries;
+    configFX->optionStrikes() = std::vector<std::string>(expiries.size(), "ATMF");
+    std::vector<QuantLib::ext::shared_ptr<FxBsData>> fxConfigs = {configFX};
+
+    CorrelationMatrixBuilder cmb;
+    cmb.addCorrelation("IR:EUR", "IR:USD", Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(0.6)));
+    cmb.addCorrelation("IR:EUR", "FX:EURUSD", Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(0.2)));
+    cmb.addCorrelation("IR:USD", "FX:EURUSD", Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(0.3)));
+    auto config = QuantLib::ext::make_shared<CrossAssetModelData>(irConfigs, fxConfigs, cmb.correlations());
+
+    auto buildModel = [&testMarket, &config](const Size nThreads) {
+        CrossAssetModelBuilder builder(testMarket, config, Market::defaultConfiguration,
+                                       Market::defaultConfiguration, Market::defaultConfiguration,
+                                       Market::defaultConfiguration, Market::defaultConfiguration,
+                                       Market::defaultConfiguration, false, false, "", SalvagingAlgorithm::None,
+                                       "unknown", nThreads);
+        return *builder.model();
+    };
+
+    auto sequential = buildModel(1);
+    auto concurrent = buildModel(2);
+    Array p1 = sequential->params(), p2 = concurrent->params();
+    BOOST_REQUIRE_EQUAL(p1.size(), p2.size());
+    for (Size i = 0; i < p1.size(); ++i)
+        BOOST_CHECK_CLOSE(p1[i], p2[i], 1E-10);
+
+    // the calibrated volatilities differ from the initial values
+    BOOST_CHECK(sequential->irlgm1f(0)->parameterValues(1) != Array(times.size() + 1, 0.0030));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/utilities/csvfilereader.hpp>
+#include <ored/utilities/parsers.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <set>
+
+using namespace ore::data;
+using namespace QuantLib;
+using namespace std;
+
+using ore::test::TopLevelFixture;
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CSVFileReaderTests)
+
+BOOST_AUTO_TEST_CASE(testMappedFileReader) {
+
+    BOOST_TEST_MESSAGE("Testing CSVMappedFileReader against CSVFileReader...");
+
+    std::string fileName = TEST_OUTPUT_FILE("data.csv");
+    const Size nLines = 1000;
+    {
+        std::ofstream out(fileName);
+        out << "#Date,Name,Value\r\n";
+        for (Size i = 0; i < nLines; ++i) {
+            out << "2016-02-26,QUOTE_" << i << ";" << 0.001 * i << "\n";
+            if (i % 100 == 0)
+                out << "\n   \n";
+        }
+    }
+
+    // line by line via the CSVReader interface
+
+    CSVFileReader fileReader(fileName, true);
+    CSVMappedFileReader mappedReader(fileName, true);
+    BOOST_REQUIRE_EQUAL(mappedReader.numberOfColumns(), 3);
+    BOOST_CHECK(mappedReader.fields() == fileReader.fields());
+    BOOST_CHECK(mappedReader.hasField("Name"));
+    Size n = 0;
+    CSVReader& reader = mappedReader;
+    while (fileReader.next()) {
+        BOOST_REQUIRE(reader.next());
+        BOOST_CHECK_EQUAL(reader.currentLine(), fileReader.currentLine());
+        for (Size c = 0; c < 3; ++c)
+            BOOST_CHECK_EQUAL(reader.get(c), fileReader.get(c));
+        BOOST_CHECK_EQUAL(reader.get("Name"), fileReader.get("Name"));
+        BOOST_CHECK_EQUAL(mappedReader.field(1), fileReader.get(1));
+        BOOST_CHECK_CLOSE(mappedReader.getReal(2), parseReal(fileReader.get(2)), 1E-12);
+        ++n;
+    }
+    BOOST_CHECK(!reader.next());
+    BOOST_CHECK_EQUAL(n, nLines);
+    reader.close();
+
+    // batch api, sequential and in parallel
+
+    for (auto const& nChunks : {1, 3, 8}) {
+        CSVMappedFileReader batchReader(fileName, true);
+        std::atomic<Size> count(0);
+        std::mutex mutex;
+        std::set<std::string> names;
+        Real sum = 0.0;
+        batchReader.forEachLine(
+            [&count, &mutex, &names, &sum](const Size, const std::vector<std::string_view>& fields) {
+                ++count;
+                std::lock_guard<std::mutex> lock(mutex);
+                names.insert(std::string(fields[1]));
+                sum += parseReal(std::string(fields[2]));
+            },
+            nChunks);
+        BOOST_CHECK_EQUAL(count, nLines);
+        BOOST_CHECK_EQUAL(names.size(), nLines);
+        BOOST_CHECK_CLOSE(sum, 0.001 * nLines * (nLines - 1) / 2.0, 1E-10);
+    }
+
+    // invalid number of columns is reported from the batch api
+
+    {
+        std::ofstream out(fileName, std::ios::app);
+        out << "2016-02-26,QUOTE_X\n";
+    }
+    CSVMappedFileReader invalidReader(fileName, true);
+    BOOST_CHECK_THROW(invalidReader.forEachLine([](const Size, const std::vector<std::string_view>&) {}, 4),
+                      QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
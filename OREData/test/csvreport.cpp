@@ -0,0 +1,107 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/report/csvreport.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/math/rounding.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace std;
+using namespace ore::data;
+
+namespace {
+string readFile(const string& filename) {
+    std::ifstream file(filename);
+    std::stringstream s;
+    s << file.rdbuf();
+    return s.str();
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CSVReportTests)
+
+BOOST_AUTO_TEST_CASE(testCSVFileReportFormatting) {
+
+    BOOST_TEST_MESSAGE("Testing CSV file report formatting...");
+
+    string filename = TEST_OUTPUT_FILE("csvreport_formatting.csv");
+    {
+        CSVFileReport report(filename, ',', true, '"', "#N/A", true);
+        report.addColumn("Size", Size())
+            .addColumn("Real", Real(), 4)
+            .addColumn("String", string())
+            .addColumn("Date", Date())
+            .addColumn("Period", Period());
+        report.next().add(Size(42)).add(-1.23456).add(string("abc")).add(Date(5, March, 2024)).add(Period(3, Months));
+        report.next()
+            .add(Null<Size>())
+            .add(Null<Real>())
+            .add(string("\"quoted\""))
+            .add(Null<Date>())
+            .add(Period(2, Weeks));
+        report.next().add(Size(0)).add(-0.00001).add(string("")).add(Date(31, December, 2099)).add(Period(1, Years));
+        report.next().add(Size(1)).add(1.0e20).add(string("x")).add(Date(1, January, 2000)).add(Period(6, Days));
+        report.end();
+    }
+
+    string expected = "#size,real,string,date,period\n"
+                      "42,-1.2346,\"abc\",\"2024-03-05\",\"3M\"\n"
+                      "#N/A,#N/A,\"quoted\",#N/A,\"2W\"\n"
+                      "0,0.0000,\"\",\"2099-12-31\",\"1Y\"\n"
+                      "1,100000000000000000000.0000,\"x\",\"2000-01-01\",\"6D\"\n";
+    BOOST_CHECK_EQUAL(readFile(filename), expected);
+}
+
+BOOST_AUTO_TEST_CASE(testCSVFileReportLargeOutput) {
+
+    BOOST_TEST_MESSAGE("Testing CSV file report with output exceeding the write buffer...");
+
+    // the rows are written in blocks, check that nothing is lost or reordered across block boundaries
+
+    string filename = TEST_OUTPUT_FILE("csvreport_large.csv");
+    std::ostringstream expected;
+    expected << "#Id,Value";
+    {
+        CSVFileReport report(filename);
+        report.addColumn("Id", Size()).addColumn("Value", Real(), 8);
+        for (Size i = 0; i < 100000; ++i) {
+            Real v = std::sin(static_cast<Real>(i)) * 1000.0;
+            report.next().add(i).add(v);
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), "%.*f", 8, ClosestRounding(8)(v));
+            expected << "\n" << i << "," << buf;
+        }
+        report.end();
+    }
+    expected << "\n";
+    BOOST_CHECK(readFile(filename) == expected.str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -118,6 +118,25 @@ BOOST_AUTO_TEST_CASE(testMoreThanOneStep) {
     BOOST_CHECK_CLOSE(fx.getQuote("USDNZD")->value(), 1.6450 / 1.0861, tol);
 }
 
+BOOST_AUTO_TEST_CASE(testPreferredCurrencyPath) {
+
+    // JPYCAD can be triangulated via USD or EUR, USD is preferred
+
+    std::map<std::string, Handle<Quote>> quotes;
+    for (auto const& [pair, value] : std::map<std::string, Real>{
+             {"USDJPY", 110.0}, {"EURJPY", 130.0}, {"USDCAD", 1.3}, {"EURCAD", 1.5}})
+        quotes[pair] = Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(value));
+    FXTriangulation fxt(quotes);
+
+    BOOST_CHECK_CLOSE(fxt.getQuote("JPYCAD")->value(), 1.3 / 110.0, 1e-12);
+    BOOST_CHECK_CLOSE(fxt.getQuote("CADJPY")->value(), 110.0 / 1.3, 1e-12);
+
+    // repeated lookups return the cached quote
+
+    BOOST_CHECK(fxt.getQuote("JPYCAD").currentLink() == fxt.getQuote("JPYCAD").currentLink());
+    BOOST_CHECK(fxt.getQuote("CADCAD").currentLink() == fxt.getQuote("CADCAD").currentLink());
+}
+
 BOOST_AUTO_TEST_CASE(testBadInputsThrow) {
     BOOST_CHECK_THROW(fx.getQuote("BadInput"), QuantLib::Error);
     BOOST_CHECK_THROW(fx.getQuote(""), QuantLib::Error);
@@ -22,6 +22,7 @@
 // clang-format on
 
 #include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/inmemoryloader.hpp>
 #include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/marketdatumparser.hpp>
 #include <ored/portfolio/builders/fxoption.hpp>
@@ -37,6 +38,7 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/timer/timer.hpp>
 
 using namespace QuantLib;
 using namespace QuantExt;
@@ -137,6 +139,48 @@ BOOST_AUTO_TEST_CASE(testFxVolWildCards) {
     }
 }
 
+/* Benchmark for the wildcard quote lookups of the curve builders, disabled by default, run it explicitly with
+   --run_test=OREDataTestSuite/FxVolCurveTests/benchmarkFxVolWildCards --log_level=message */
+BOOST_AUTO_TEST_CASE(benchmarkFxVolWildCards, *boost::unit_test::disabled()) {
+
+    BOOST_TEST_MESSAGE("Benchmarking TodaysMarket build with FxVolatility Curve Wildcards");
+
+    Date asof(31, Dec, 2018);
+    TodaysMarketArguments tma_full(asof, "curveconfig_full.xml");
+    TodaysMarketArguments tma_wc(asof, "curveconfig_wc.xml");
+
+    // the quotes of the test market plus a large number of fx option quotes for other currency pairs, which are
+    // not matched by the wildcards, but share the prefix up to the currency pair
+
+    auto loader = QuantLib::ext::make_shared<InMemoryLoader>();
+    for (auto const& md : tma_wc.loader->loadQuotes(asof))
+        loader->add(asof, md->name(), md->quote()->value());
+    for (auto const& f : tma_wc.loader->loadFixings())
+        loader->addFixing(f.date, f.name, f.fixing);
+    std::vector<std::string> ccys = {"AUD", "CAD", "CHF", "DKK", "GBP", "HKD", "JPY", "NOK", "NZD", "SEK", "SGD",
+                                     "ZAR", "MXN", "PLN", "CZK", "HUF", "TRY", "CNH", "KRW", "INR"};
+    std::vector<std::string> deltas = {"ATM", "10RR", "25RR", "10BF", "25BF"};
+    for (auto const& c1 : ccys)
+        for (auto const& c2 : ccys)
+            for (Size y = 1; y <= 30; ++y)
+                for (auto const& d : deltas)
+                    if (c1 != c2)
+                        loader->add(asof, "FX_OPTION/RATE_LNVOL/" + c1 + "/" + c2 + "/" + std::to_string(y) + "Y/" + d,
+                                    0.1);
+    BOOST_TEST_MESSAGE("loader contains " << loader->loadQuotes(asof).size() << " quotes");
+
+    const Size n = 20;
+    for (auto const& [label, tma] : {std::make_pair("full", &tma_full), std::make_pair("wildcards", &tma_wc)}) {
+        boost::timer::cpu_timer timer;
+        for (Size i = 0; i < n; ++i) {
+            TodaysMarket market(tma->asof, tma->todaysMarketParameters, loader, tma->curveConfigs, false, true,
+                                false);
+        }
+        timer.stop();
+        BOOST_TEST_MESSAGE(label << ": " << timer.elapsed().wall / 1E6 / n << " ms per market build");
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
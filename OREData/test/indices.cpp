@@ -18,6 +18,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <ored/configuration/conventions.hpp>
+#include <ored/utilities/indexcache.hpp>
 #include <ored/utilities/indexparser.hpp>
 #include <oret/toplevelfixture.hpp>
 
@@ -482,6 +483,54 @@ BOOST_AUTO_TEST_CASE(testInflationIndexParsing) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testIndexCache) {
+
+    BOOST_TEST_MESSAGE("Testing IndexCache...");
+
+    data::InstrumentConventions::instance().setConventions(convs());
+    data::IndexCache::instance().clear();
+
+    // the second lookup is served from the cache and returns the same prototype
+
+    auto i1 = data::parseIndex("EUR-EURIBOR-6M");
+    auto i2 = data::parseIndex("EUR-EURIBOR-6M");
+    BOOST_CHECK(i1 == i2);
+    BOOST_CHECK_EQUAL(data::IndexCache::instance().size(), 1);
+    BOOST_CHECK_EQUAL(data::IndexCache::instance().hits(), 1);
+    BOOST_CHECK_EQUAL(data::IndexCache::instance().misses(), 1);
+
+    // names that can not be parsed are not cached
+
+    BOOST_CHECK_THROW(data::parseIndex("XYZ-UNKNOWN-INDEX"), QuantLib::Error);
+    BOOST_CHECK_EQUAL(data::IndexCache::instance().size(), 1);
+
+    // new conventions or a new evaluation date lead to a new parse
+
+    data::InstrumentConventions::instance().setConventions(convs());
+    auto i3 = data::parseIndex("EUR-EURIBOR-6M");
+    BOOST_CHECK(i3 != i1);
+    BOOST_CHECK_EQUAL(i3->name(), i1->name());
+    SavedSettings backup;
+    Settings::instance().evaluationDate() = Settings::instance().evaluationDate() + 1;
+    BOOST_CHECK(data::parseIndex("EUR-EURIBOR-6M") != i3);
+    BOOST_CHECK_EQUAL(data::IndexCache::instance().size(), 3);
+
+    // the key does not depend on the address of the conventions, setting the same conventions again leads to a new
+    // parse as well, since they might have been modified in between
+
+    auto conventions = data::InstrumentConventions::instance().conventions();
+    auto i4 = data::parseIndex("EUR-EURIBOR-6M");
+    Size generation = data::InstrumentConventions::instance().generation();
+    data::InstrumentConventions::instance().setConventions(conventions);
+    BOOST_CHECK_EQUAL(data::InstrumentConventions::instance().generation(), generation + 1);
+    BOOST_CHECK(data::parseIndex("EUR-EURIBOR-6M") != i4);
+    BOOST_CHECK_EQUAL(data::IndexCache::instance().size(), 4);
+
+    data::IndexCache::instance().clear();
+    BOOST_CHECK_EQUAL(data::IndexCache::instance().size(), 0);
+    BOOST_CHECK_EQUAL(data::IndexCache::instance().hits(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
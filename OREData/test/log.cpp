@@ -0,0 +1,158 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/utilities/log.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace ore::data;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+//! Collects the thread and message numbers of the test messages
+class CollectingLogger : public Logger {
+public:
+    CollectingLogger() : Logger("CollectingLogger") {}
+    void log(unsigned, const std::string& s) override {
+        std::size_t pos = s.find("asynclogtest ");
+        if (pos == std::string::npos)
+            return;
+        std::istringstream in(s.substr(pos + 13));
+        std::size_t thread, message;
+        in >> thread >> message;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (messages_.size() <= thread)
+            messages_.resize(thread + 1);
+        messages_[thread].push_back(message);
+    }
+    std::vector<std::vector<std::size_t>> messages() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::vector<std::size_t>> messages_;
+};
+
+//! Registers the collecting logger and restores the log settings afterwards
+struct AsyncLogFixture : public ore::test::TopLevelFixture {
+    AsyncLogFixture()
+        : logger(QuantLib::ext::make_shared<CollectingLogger>()), enabled(Log::instance().enabled()),
+          mask(Log::instance().mask()) {
+        Log::instance().registerLogger(logger);
+        Log::instance().setMask(255);
+        Log::instance().switchOn();
+    }
+    ~AsyncLogFixture() {
+        Log::instance().setAsynchronous(false);
+        Log::instance().removeLogger(logger->name());
+        Log::instance().setMask(mask);
+        if (!enabled)
+            Log::instance().switchOff();
+    }
+    QuantLib::ext::shared_ptr<CollectingLogger> logger;
+    bool enabled;
+    unsigned mask;
+};
+
+void logMessages(const std::size_t thread, const std::size_t begin, const std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i)
+        LOG("asynclogtest " << thread << " " << i);
+}
+
+//! Checks that each thread's messages 0, ..., n-1 were written exactly once and in order
+void checkMessages(const std::vector<std::vector<std::size_t>>& messages, const std::size_t nThreads,
+                   const std::size_t n) {
+    BOOST_REQUIRE_EQUAL(messages.size(), nThreads);
+    for (std::size_t t = 0; t < nThreads; ++t) {
+        BOOST_REQUIRE_EQUAL(messages[t].size(), n);
+        for (std::size_t i = 0; i < n; ++i)
+            BOOST_REQUIRE_EQUAL(messages[t][i], i);
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(LogTests)
+
+BOOST_FIXTURE_TEST_CASE(testAsyncPerThreadOrdering, AsyncLogFixture) {
+
+    BOOST_TEST_MESSAGE("Testing the order of the messages of each thread in asynchronous logging mode");
+
+    // more messages than fit into a queue, so that the threads also wait for the background thread
+    const std::size_t nThreads = 4, n = 20000;
+    Log::instance().setAsynchronous(true);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < nThreads; ++t)
+        threads.emplace_back(logMessages, t, 0, n);
+    for (auto& t : threads)
+        t.join();
+    Log::instance().setAsynchronous(false);
+    checkMessages(logger->messages(), nThreads, n);
+}
+
+BOOST_FIXTURE_TEST_CASE(testAsyncExitedThreadQueues, AsyncLogFixture) {
+
+    BOOST_TEST_MESSAGE("Testing that the queues of exited threads are drained in asynchronous logging mode");
+
+    const std::size_t n = 1000;
+    Log::instance().setAsynchronous(true);
+
+    // the messages of an exited thread are written while the asynchronous mode is still on
+    std::thread(logMessages, 0, 0, n).join();
+    while (Log::instance().flush() > 0) {
+    }
+    checkMessages(logger->messages(), 1, n);
+
+    // and on switching the mode off
+    std::thread(logMessages, 1, 0, n).join();
+    Log::instance().setAsynchronous(false);
+    checkMessages(logger->messages(), 2, n);
+}
+
+BOOST_FIXTURE_TEST_CASE(testAsyncSwitchOff, AsyncLogFixture) {
+
+    BOOST_TEST_MESSAGE("Testing switching the asynchronous logging mode on and off while threads are logging");
+
+    // no message may be lost or reordered when the mode changes between the check of the mode and the queueing
+    const std::size_t nThreads = 4, n = 20000;
+    Log::instance().setAsynchronous(true);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < nThreads; ++t)
+        threads.emplace_back(logMessages, t, 0, n);
+    for (std::size_t k = 0; k < 20; ++k) {
+        Log::instance().setAsynchronous(k % 2 == 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (auto& t : threads)
+        t.join();
+    Log::instance().setAsynchronous(false);
+    checkMessages(logger->messages(), nThreads, n);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,8 +20,13 @@
 #include <boost/test/unit_test.hpp>
 #include <ored/portfolio/fxforward.hpp>
 #include <ored/portfolio/portfolio.hpp>
+#include <ored/utilities/xmlstreamreader.hpp>
+#include <oret/datapaths.hpp>
 #include <oret/toplevelfixture.hpp>
 
+#include <fstream>
+#include <thread>
+
 using namespace QuantLib;
 using namespace boost::unit_test_framework;
 using namespace std;
@@ -119,6 +124,164 @@ BOOST_AUTO_TEST_CASE(testIds) {
     BOOST_CHECK(portfolio->ids() == trade_ids);
 }
 
+namespace {
+std::string fxForwardXml(const std::string& id, const std::string& boughtAmount) {
+    return "<Trade id=\"" + id + "\"><TradeType>FxForward</TradeType><Envelope><CounterParty>CP</CounterParty>"
+           "<NettingSetId>NS</NettingSetId><AdditionalFields/></Envelope><FxForwardData>"
+           "<ValueDate>2030-01-15</ValueDate><BoughtCurrency>EUR</BoughtCurrency><BoughtAmount>" +
+           boughtAmount +
+           "</BoughtAmount><SoldCurrency>USD</SoldCurrency><SoldAmount>1100000</SoldAmount>"
+           "</FxForwardData></Trade>";
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(testFromFileStreaming) {
+
+    // comments, cdata sections and '>' in attribute values must not confuse the reader
+
+    std::string xml = "<?xml version=\"1.0\"?>\n<!-- <Trade id=\"commented\"> -->\n<Portfolio>\n" +
+                      fxForwardXml("1", "1000000") + "\n<![CDATA[ <Trade id=\"cdata\"/> ]]>\n" +
+                      fxForwardXml("2>3", "2000000") + "\n" + fxForwardXml("3", "InvalidAmount") + "\n</Portfolio>\n";
+    std::string filename = TEST_OUTPUT_FILE("streaming_portfolio.xml");
+    {
+        std::ofstream file(filename);
+        file << xml;
+    }
+
+    Portfolio expected;
+    XMLDocument doc;
+    doc.fromXMLString(xml);
+    expected.fromXML(doc.getFirstNode("Portfolio"));
+
+    // use a small buffer so that elements span several chunks
+
+    Portfolio portfolio;
+    std::vector<std::string> loaded;
+    XMLStreamReader reader(filename, "Trade", 7);
+    std::string element;
+    while (reader.next(element))
+        loaded.push_back(element);
+    BOOST_CHECK_EQUAL(reader.rootName(), "Portfolio");
+    BOOST_REQUIRE_EQUAL(loaded.size(), 3);
+    BOOST_CHECK_EQUAL(loaded[0], fxForwardXml("1", "1000000"));
+
+    loaded.clear();
+    portfolio.fromFileStreaming(filename,
+                                [&loaded](const QuantLib::ext::shared_ptr<Trade>& t) { loaded.push_back(t->id()); });
+    BOOST_CHECK(portfolio.ids() == expected.ids());
+    BOOST_CHECK(loaded == std::vector<std::string>({"1", "2>3", "3"}));
+    BOOST_CHECK_EQUAL(portfolio.get("3")->tradeType(), "Failed");
+    BOOST_CHECK_EQUAL(portfolio.get("2>3")->tradeType(), "FxForward");
+
+    // nested elements with the same name belong to the outer element, a truncated file throws
+
+    {
+        std::ofstream file(filename);
+        file << "<Root><Trade id=\"a\"><Trade id=\"b\"/></Trade><Other><Trade id=\"c\"/></Other><Trade id=\"d\"/>";
+    }
+    XMLStreamReader nested(filename, "Trade", 3);
+    BOOST_REQUIRE(nested.next(element));
+    BOOST_CHECK_EQUAL(element, "<Trade id=\"a\"><Trade id=\"b\"/></Trade>");
+    BOOST_REQUIRE(nested.next(element));
+    BOOST_CHECK_EQUAL(element, "<Trade id=\"d\"/>");
+    BOOST_CHECK_THROW(nested.next(element), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_CASE(testBinaryRoundTrip) {
+
+    std::string xml = "<Portfolio>" + fxForwardXml("1", "1000000") + fxForwardXml("2", "2000000") +
+                      fxForwardXml("3", "InvalidAmount") + "</Portfolio>";
+    Portfolio portfolio;
+    portfolio.fromXMLString(xml);
+
+    Portfolio restored;
+    restored.fromBinaryString(portfolio.toBinaryString());
+    BOOST_CHECK(restored.ids() == portfolio.ids());
+    BOOST_CHECK_EQUAL(restored.toXMLString(), portfolio.toXMLString());
+    BOOST_CHECK_EQUAL(restored.get("3")->tradeType(), "Failed");
+
+    std::string filename = TEST_OUTPUT_FILE("portfolio.bin");
+    portfolio.toBinaryFile(filename);
+    Portfolio fromFile;
+    fromFile.fromBinaryFile(filename);
+    BOOST_CHECK_EQUAL(fromFile.toXMLString(), portfolio.toXMLString());
+
+    BOOST_CHECK_THROW(Portfolio().fromBinaryString(xml), QuantLib::Error);
+    std::string truncated = portfolio.toBinaryString();
+    truncated.resize(truncated.size() - 5);
+    BOOST_CHECK_THROW(Portfolio().fromBinaryString(truncated), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_CASE(testIndices) {
+    Portfolio portfolio;
+    std::vector<std::tuple<std::string, std::string, std::string, std::string>> data = {
+        {"1", "CP_A", "NS_1", "Desk1"}, {"2", "CP_A", "NS_2", "Desk2"}, {"3", "CP_B", "NS_1", "Desk1"}};
+    for (auto const& [id, cpty, ns, pf] : data) {
+        auto trade = QuantLib::ext::make_shared<FxForward>();
+        trade->id() = id;
+        trade->setEnvelope(Envelope(cpty, ns, {pf}));
+        portfolio.add(trade);
+    }
+
+    BOOST_CHECK(portfolio.counterparties() == std::set<std::string>({"CP_A", "CP_B"}));
+    BOOST_CHECK(portfolio.portfolioIds() == std::set<std::string>({"Desk1", "Desk2"}));
+    BOOST_CHECK_EQUAL(portfolio.nettingSetMap().at("2"), "NS_2");
+    BOOST_CHECK(portfolio.nettingSetTrades().at("NS_1") == std::set<std::string>({"1", "3"}));
+    BOOST_CHECK(portfolio.counterpartyTrades().at("CP_A") == std::set<std::string>({"1", "2"}));
+    BOOST_CHECK(portfolio.counterpartyNettingSets().at("CP_A") == std::set<std::string>({"NS_1", "NS_2"}));
+
+    // repeated queries return the same index
+    BOOST_CHECK(&portfolio.counterparties() == &portfolio.counterparties());
+
+    // the indices follow removals and in place modifications after invalidation
+    portfolio.remove("3");
+    BOOST_CHECK(portfolio.counterparties() == std::set<std::string>({"CP_A"}));
+    BOOST_CHECK(portfolio.nettingSetTrades().at("NS_1") == std::set<std::string>({"1"}));
+    portfolio.get("2")->setEnvelope(Envelope("CP_C", "NS_3"));
+    portfolio.invalidateIndices();
+    BOOST_CHECK(portfolio.counterparties() == std::set<std::string>({"CP_A", "CP_C"}));
+    BOOST_CHECK(portfolio.ids() == std::set<std::string>({"1", "2"}));
+
+    // threads building the indices concurrently all get the published indices
+    portfolio.invalidateIndices();
+    std::vector<const std::set<std::string>*> results(8, nullptr);
+    std::vector<std::thread> threads;
+    for (Size i = 0; i < results.size(); ++i)
+        threads.emplace_back([&portfolio, &results, i]() { results[i] = &portfolio.counterparties(); });
+    for (auto& t : threads)
+        t.join();
+    for (auto const r : results) {
+        BOOST_CHECK(r == &portfolio.counterparties());
+        BOOST_CHECK(*r == std::set<std::string>({"CP_A", "CP_C"}));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testTradeFixingsCache) {
+    Portfolio portfolio;
+    for (auto const& id : {"1", "2", "3"}) {
+        auto trade = QuantLib::ext::make_shared<FxForward>();
+        trade->id() = id;
+        portfolio.add(trade);
+    }
+
+    // the fixings of the unbuilt trades are empty, the result is cached per settlement date
+
+    auto fixings = portfolio.tradeFixings(Date(1, January, 2024), 2);
+    BOOST_REQUIRE_EQUAL(fixings->size(), 3);
+    BOOST_CHECK(fixings->at("2").empty());
+    BOOST_CHECK(portfolio.fixings(Date(1, January, 2024), 2).empty());
+    BOOST_CHECK_EQUAL(portfolio.tradeFixings(Date(1, January, 2024)), fixings);
+    BOOST_CHECK(portfolio.tradeFixings(Date(2, January, 2024)) != fixings);
+
+    // modifying the portfolio discards the cache
+
+    fixings = portfolio.tradeFixings(Date(1, January, 2024));
+    portfolio.remove("3");
+    auto updated = portfolio.tradeFixings(Date(1, January, 2024));
+    BOOST_CHECK(updated != fixings);
+    BOOST_CHECK_EQUAL(updated->size(), 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,100 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/portfolio/lazyreferencedatamanager.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <fstream>
+
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+using namespace std;
+using namespace ore::data;
+
+namespace {
+std::string creditDatumXml(const std::string& id, const std::string& validFrom, const std::string& name) {
+    return "<ReferenceDatum id=\"" + id + "\"" + (validFrom.empty() ? "" : " validFrom=\"" + validFrom + "\"") +
+           "><Type>Credit</Type><CreditReferenceData><Name>" + name +
+           "</Name><Group>Group</Group></CreditReferenceData></ReferenceDatum>";
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ReferenceDataTests)
+
+BOOST_AUTO_TEST_CASE(testLazyReferenceDataManager) {
+
+    BOOST_TEST_MESSAGE("Testing lazy reference data manager...");
+
+    std::string xml = "<?xml version=\"1.0\"?>\n<ReferenceData>\n<!-- <ReferenceDatum id=\"commented\"/> -->\n" +
+                      creditDatumXml("A", "", "Name A") + "\n" + creditDatumXml("B", "", "Name B 1") + "\n" +
+                      creditDatumXml("B", "2020-01-01", "Name B 2") + "\n" + creditDatumXml("C", "", "Name C") +
+                      "\n" + creditDatumXml("C", "", "Name C Duplicate") + "\n</ReferenceData>\n";
+    std::string filename = TEST_OUTPUT_FILE("lazy_referencedata.xml");
+    {
+        std::ofstream file(filename);
+        file << xml;
+    }
+
+    BasicReferenceDataManager expected(filename);
+    LazyReferenceDataManager lazy(filename);
+    BOOST_CHECK_EQUAL(lazy.pendingSize(), 3);
+
+    // only the requested (type, id) is loaded
+
+    BOOST_CHECK(lazy.hasData("Credit", "A", Date(1, January, 2021)));
+    BOOST_CHECK_EQUAL(lazy.pendingSize(), 2);
+    BOOST_CHECK(!lazy.hasData("Credit", "D", Date(1, January, 2021)));
+    BOOST_CHECK(!lazy.hasData("Equity", "A", Date(1, January, 2021)));
+    BOOST_CHECK_EQUAL(lazy.pendingSize(), 2);
+
+    // the results match the BasicReferenceDataManager, including validFrom and duplicate handling
+
+    for (auto const& [id, asof] : std::vector<std::pair<std::string, Date>>{{"A", Date(1, January, 2021)},
+                                                                            {"B", Date(1, January, 2019)},
+                                                                            {"B", Date(1, January, 2021)},
+                                                                            {"C", Date(1, January, 2021)}}) {
+        auto e = QuantLib::ext::dynamic_pointer_cast<CreditReferenceDatum>(expected.getData("Credit", id, asof));
+        auto l = QuantLib::ext::dynamic_pointer_cast<CreditReferenceDatum>(lazy.getData("Credit", id, asof));
+        BOOST_REQUIRE(e && l);
+        BOOST_CHECK_EQUAL(l->creditData().name, e->creditData().name);
+        BOOST_CHECK_EQUAL(l->validFrom(), e->validFrom());
+    }
+    BOOST_CHECK_EQUAL(lazy.pendingSize(), 0);
+    BOOST_CHECK_THROW(lazy.getData("Credit", "D", Date(1, January, 2021)), QuantLib::Error);
+
+    // an added datum overwrites the indexed one
+
+    LazyReferenceDataManager lazy2(filename);
+    CreditReferenceDatum::CreditData data;
+    data.name = "Name A Added";
+    lazy2.add(QuantLib::ext::make_shared<CreditReferenceDatum>("A", data));
+    auto a = QuantLib::ext::dynamic_pointer_cast<CreditReferenceDatum>(
+        lazy2.getData("Credit", "A", Date(1, January, 2021)));
+    BOOST_REQUIRE(a);
+    BOOST_CHECK_EQUAL(a->creditData().name, "Name A Added");
+    lazy2.loadAll();
+    BOOST_CHECK_EQUAL(lazy2.pendingSize(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
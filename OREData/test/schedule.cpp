@@ -18,6 +18,8 @@
 
 #include <boost/test/unit_test.hpp>
 #include <ored/portfolio/schedule.hpp>
+#include <ored/portfolio/schedulecache.hpp>
+#include <ored/utilities/parsers.hpp>
 #include <oret/toplevelfixture.hpp>
 
 using namespace boost::unit_test_framework;
@@ -91,6 +93,39 @@ BOOST_AUTO_TEST_CASE(testLastWednesdayDateGenerationRule) {
     BOOST_CHECK_EQUAL_COLLECTIONS(s.dates().begin(), s.dates().end(), expected.begin(), expected.end());
 }
 
+BOOST_AUTO_TEST_CASE(testScheduleCache) {
+
+    BOOST_TEST_MESSAGE("Testing ScheduleCache...");
+
+    ScheduleCache::instance().clear();
+    ScheduleRules rules("2015-01-09", "2016-01-09", "1M", "TARGET", "MF", "MF", "Forward");
+
+    // the second schedule is taken from the cache
+
+    Schedule s1 = makeSchedule(rules);
+    Schedule s2 = makeSchedule(ScheduleData(rules));
+    BOOST_CHECK_EQUAL(ScheduleCache::instance().size(), 1);
+    BOOST_CHECK_EQUAL_COLLECTIONS(s1.dates().begin(), s1.dates().end(), s2.dates().begin(), s2.dates().end());
+
+    // holidays added to the calendar after the schedule was cached are taken into account
+
+    Calendar target = parseCalendar("TARGET");
+    target.addHoliday(Date(9, Feb, 2015));
+    Schedule s3 = makeSchedule(rules);
+    target.removeHoliday(Date(9, Feb, 2015));
+    BOOST_CHECK_EQUAL(ScheduleCache::instance().size(), 2);
+    BOOST_CHECK_EQUAL(s3[1], Date(10, Feb, 2015));
+    BOOST_CHECK_EQUAL(makeSchedule(rules)[1], Date(9, Feb, 2015));
+
+    // a maximum size of zero disables the cache
+
+    ScheduleCache::instance().setMaxSize(0);
+    BOOST_CHECK_EQUAL(ScheduleCache::instance().size(), 0);
+    BOOST_CHECK_EQUAL(makeSchedule(rules).size(), s1.size());
+    BOOST_CHECK_EQUAL(ScheduleCache::instance().size(), 0);
+    ScheduleCache::instance().setMaxSize(100000);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
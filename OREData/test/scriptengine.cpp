@@ -25,6 +25,10 @@
 #include <ored/scripting/models/blackscholes.hpp>
 #include <ored/scripting/models/dummymodel.hpp>
 #include <ored/scripting/astprinter.hpp>
+#include <ored/scripting/engines/scriptedinstrumentpricingengine.hpp>
+#include <ored/scripting/scriptbytecode.hpp>
+#include <ored/scripting/scriptcache.hpp>
+#include <ored/scripting/scriptedinstrument.hpp>
 #include <ored/scripting/scriptengine.hpp>
 #include <ored/scripting/scriptparser.hpp>
 #include <ored/scripting/staticanalyser.hpp>
@@ -48,8 +52,10 @@
 #include <ql/time/calendars/nullcalendar.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <thread>
 
 using namespace ore::data;
 using namespace QuantExt;
@@ -79,6 +85,114 @@ BOOST_AUTO_TEST_CASE(testSimpleScript) {
     BOOST_CHECK(equal(context->scalars["x"], ValueType(RandomVariable(1, 100.0 / 2.0 * 101.0l))).at(0));
 }
 
+BOOST_AUTO_TEST_CASE(testBytecode) {
+    BOOST_TEST_MESSAGE("Testing script bytecode...");
+    std::string script = "NUMBER x, y[3], i; FOR i IN (1,3,1) DO IF i > 1 AND x >= 0 THEN y[i] = x + i; ELSE y[i] = -1; "
+                         "END; x = x + 1; END; REQUIRE x == 3;";
+    ScriptParser parser(script);
+    BOOST_REQUIRE(parser.success());
+
+    auto bytecode = QuantLib::ext::make_shared<ScriptBytecode>(parser.ast());
+    BOOST_TEST_MESSAGE("Bytecode:\n" << *bytecode);
+    BOOST_CHECK_EQUAL(bytecode->numberOfLoops(), 1);
+    BOOST_CHECK_EQUAL(bytecode->variables().size(), 3);
+    auto const& instructions = bytecode->instructions();
+    BOOST_REQUIRE(!instructions.empty());
+    // the declaration is delegated to the ast visitor
+    BOOST_CHECK(instructions.front().op == ScriptBytecode::OpCode::Exec);
+    BOOST_CHECK(std::any_of(instructions.begin(), instructions.end(), [](const ScriptBytecode::Instruction& i) {
+        return i.op == ScriptBytecode::OpCode::AssignArray;
+    }));
+
+    // run the same bytecode on two contexts
+
+    for (Size run = 0; run < 2; ++run) {
+        auto context = QuantLib::ext::make_shared<Context>();
+        ScriptEngine engine(parser.ast(), context, nullptr, bytecode);
+        BOOST_REQUIRE_NO_THROW(engine.run());
+        BOOST_CHECK(equal(context->scalars["x"], ValueType(RandomVariable(1, 3.0))).at(0));
+        BOOST_CHECK(equal(context->scalars["i"], ValueType(RandomVariable(1, 3.0))).at(0));
+        BOOST_REQUIRE_EQUAL(context->arrays["y"].size(), 3);
+        BOOST_CHECK(equal(context->arrays["y"][0], ValueType(RandomVariable(1, -1.0))).at(0));
+        BOOST_CHECK(equal(context->arrays["y"][1], ValueType(RandomVariable(1, 3.0))).at(0));
+        BOOST_CHECK(equal(context->arrays["y"][2], ValueType(RandomVariable(1, 5.0))).at(0));
+    }
+
+    // errors are reported at the location of the failing node
+
+    auto context = QuantLib::ext::make_shared<Context>();
+    context->scalars["x"] = RandomVariable(1, 0.0);
+    context->constants.insert("x");
+    ScriptEngine engine(ScriptParser("x = 1;").ast(), context);
+    BOOST_CHECK_EXCEPTION(engine.run(), QuantLib::Error, [](const QuantLib::Error& e) {
+        return std::string(e.what()).find("can not assign to const variable 'x'") != std::string::npos &&
+               std::string(e.what()).find("L1:1") != std::string::npos;
+    });
+}
+
+BOOST_AUTO_TEST_CASE(testScriptCache) {
+    BOOST_TEST_MESSAGE("Testing script cache...");
+    ScriptCache::instance().clear();
+    std::string script = "Option = PAY(Notional * (K - 1), Obs, Pay, Ccy);";
+
+    auto ast = ScriptCache::instance().ast(script);
+    BOOST_CHECK(ast == ScriptCache::instance().ast(script));
+    BOOST_CHECK_EQUAL(ScriptCache::instance().numberOfScripts(), 1);
+
+    auto makeContext = [](const Real notional, const Date& pay) {
+        auto context = QuantLib::ext::make_shared<Context>();
+        context->scalars["Option"] = RandomVariable(1, 0.0);
+        context->scalars["Notional"] = RandomVariable(1, notional);
+        context->scalars["K"] = RandomVariable(1, 1.5);
+        context->scalars["Obs"] = EventVec{1, Date(1, June, 2025)};
+        context->scalars["Pay"] = EventVec{1, pay};
+        context->scalars["Ccy"] = CurrencyVec{1, "EUR"};
+        return context;
+    };
+
+    // the analysis does not depend on the notional, so the results are shared
+
+    auto a1 = ScriptCache::instance().staticAnalyser(script, ast, makeContext(1.0, Date(3, June, 2025)));
+    auto a2 = ScriptCache::instance().staticAnalyser(script, ast, makeContext(2.0, Date(3, June, 2025)));
+    BOOST_CHECK(a1 == a2);
+    BOOST_CHECK_EQUAL(ScriptCache::instance().numberOfStaticAnalysers(), 1);
+    BOOST_CHECK(a1->usedVariables() == std::set<std::string>({"Ccy", "Obs", "Pay"}));
+
+    // but it does depend on the pay date
+
+    auto a3 = ScriptCache::instance().staticAnalyser(script, ast, makeContext(1.0, Date(4, June, 2025)));
+    BOOST_CHECK(a1 != a3);
+    BOOST_CHECK_EQUAL(ScriptCache::instance().numberOfStaticAnalysers(), 2);
+    BOOST_REQUIRE_EQUAL(a1->payPayDates().at("EUR").size(), 1);
+    BOOST_CHECK_EQUAL(*a1->payPayDates().at("EUR").begin(), Date(3, June, 2025));
+    BOOST_REQUIRE_EQUAL(a3->payPayDates().at("EUR").size(), 1);
+    BOOST_CHECK_EQUAL(*a3->payPayDates().at("EUR").begin(), Date(4, June, 2025));
+
+    // the analysers are cleared when the maximum size is reached, the asts are kept
+
+    Size maxStaticAnalysers = ScriptCache::instance().maxStaticAnalysers();
+    ScriptCache::instance().setMaxStaticAnalysers(3);
+    for (Size i = 0; i < 5; ++i) {
+        ScriptCache::instance().staticAnalyser(script, ast, makeContext(1.0, Date(10 + i, June, 2025)));
+        BOOST_CHECK(ScriptCache::instance().numberOfStaticAnalysers() <= 3);
+    }
+    BOOST_CHECK(ScriptCache::instance().ast(script) == ast);
+    auto a4 = ScriptCache::instance().staticAnalyser(script, ast, makeContext(1.0, Date(14, June, 2025)));
+    BOOST_CHECK(a4 == ScriptCache::instance().staticAnalyser(script, ast, makeContext(2.0, Date(14, June, 2025))));
+
+    // a maximum size of zero disables the caching of the analysers
+
+    ScriptCache::instance().setMaxStaticAnalysers(0);
+    BOOST_CHECK_EQUAL(ScriptCache::instance().numberOfStaticAnalysers(), 0);
+    auto a5 = ScriptCache::instance().staticAnalyser(script, ast, makeContext(1.0, Date(3, June, 2025)));
+    BOOST_CHECK(a5 != ScriptCache::instance().staticAnalyser(script, ast, makeContext(1.0, Date(3, June, 2025))));
+    BOOST_CHECK_EQUAL(ScriptCache::instance().numberOfStaticAnalysers(), 0);
+    ScriptCache::instance().setMaxStaticAnalysers(maxStaticAnalysers);
+
+    ScriptCache::instance().clear();
+    BOOST_CHECK_EQUAL(ScriptCache::instance().numberOfScripts(), 0);
+}
+
 namespace {
 // helper for testFunctions
 RandomVariable executeScript(const std::string& script, const QuantLib::ext::shared_ptr<Context> initialContext) {
@@ -1069,6 +1183,245 @@ BOOST_AUTO_TEST_CASE(testAmericanOption) {
     BOOST_CHECK_CLOSE(avg, fdNpv, 5.0);
 }
 
+BOOST_AUTO_TEST_CASE(testPathChunks) {
+    BOOST_TEST_MESSAGE("Testing scripted instrument pricing on path chunks...");
+
+    Date ref(7, May, 2019);
+    Settings::instance().evaluationDate() = ref;
+
+    std::string script = "NUMBER Exercise;\n"
+                         "NUMBER i;\n"
+                         "FOR i IN (SIZE(Expiry), 1, -1) DO\n"
+                         "    Exercise = PAY( PutCall * (Underlying(Expiry[i]) - Strike),\n"
+                         "                    Expiry[i], Expiry[i], PayCcy );\n"
+                         "    IF Exercise > NPV( Option, Expiry[i], Exercise > 0 ) AND Exercise > 0 THEN\n"
+                         "        Option = Exercise;\n"
+                         "    END;\n"
+                         "END;\n";
+
+    ScriptParser parser(script);
+    BOOST_REQUIRE(parser.success());
+
+    constexpr Size nPaths = 10000;
+    constexpr Size chunkSize = 3000;
+
+    Schedule expirySchedule(Date(8, May, 2019), Date(9, May, 2020), 1 * Months, NullCalendar(), Unadjusted,
+                            Unadjusted, DateGeneration::Forward, false);
+    std::vector<ValueType> expiryDates;
+    for (auto const& d : expirySchedule.dates())
+        expiryDates.push_back(EventVec{nPaths, d});
+
+    auto context = QuantLib::ext::make_shared<Context>();
+    context->scalars["PutCall"] = RandomVariable(nPaths, -1.0);
+    context->scalars["Strike"] = RandomVariable(nPaths, 100.0);
+    context->scalars["Underlying"] = IndexVec{nPaths, "EQ-SP5"};
+    context->arrays["Expiry"] = expiryDates;
+    context->scalars["PayCcy"] = CurrencyVec{nPaths, "USD"};
+    context->scalars["Option"] = RandomVariable(nPaths, 0.0);
+
+    std::set<Date> simulationDates(expirySchedule.dates().begin(), expirySchedule.dates().end());
+
+    Handle<YieldTermStructure> yts(QuantLib::ext::make_shared<FlatForward>(ref, 0.01, ActualActual(ActualActual::ISDA)));
+    Handle<YieldTermStructure> yts0(QuantLib::ext::make_shared<FlatForward>(ref, 0.0, ActualActual(ActualActual::ISDA)));
+    Handle<BlackVolTermStructure> volts(
+        QuantLib::ext::make_shared<BlackConstantVol>(ref, NullCalendar(), 0.18, ActualActual(ActualActual::ISDA)));
+    auto process = QuantLib::ext::make_shared<GeneralizedBlackScholesProcess>(
+        Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(100.0)), yts0, yts, volts);
+
+    auto price = [&](const Size pathChunkSize, Size& numberOfPathChunks) {
+        Model::McParams mcParams;
+        mcParams.regressionOrder = 4;
+        mcParams.pathChunkSize = pathChunkSize;
+        auto model = QuantLib::ext::make_shared<BlackScholes>(
+            nPaths, "USD", yts, "EQ-SP5", "USD",
+            BlackScholesModelBuilder(yts, process, simulationDates, std::set<Date>(), 1).model(), mcParams,
+            simulationDates);
+        numberOfPathChunks = model->numberOfPathChunks();
+        QuantExt::ScriptedInstrument instrument(expirySchedule.dates().back());
+        instrument.setPricingEngine(QuantLib::ext::make_shared<ScriptedInstrumentPricingEngine>(
+            "Option", std::vector<std::pair<std::string, std::string>>(), model, parser.ast(), context, script,
+            false, false, std::set<std::string>(), true));
+        Real npv = instrument.NPV();
+        BOOST_TEST_MESSAGE("npv = " << npv << " (" << numberOfPathChunks << " path chunks, error estimate "
+                                    << instrument.errorEstimate() << ")");
+        return npv;
+    };
+
+    Size nChunks;
+    Real npvFull = price(Null<Size>(), nChunks);
+    BOOST_CHECK_EQUAL(nChunks, 1);
+    Real npvChunked = price(chunkSize, nChunks);
+    BOOST_CHECK_EQUAL(nChunks, 4);
+
+    // the paths are identical, only the regression models are estimated on the first chunk
+    BOOST_CHECK_CLOSE(npvChunked, npvFull, 2.0);
+}
+
+BOOST_AUTO_TEST_CASE(testControlVariates) {
+    BOOST_TEST_MESSAGE("Testing scripted instrument pricing with control variates...");
+
+    Date ref(7, May, 2019);
+    Settings::instance().evaluationDate() = ref;
+
+    std::string script = "Option = PAY( max( Underlying(Expiry) - Strike, 0 ), Expiry, Expiry, PayCcy );\n"
+                         "Forward = PAY( Underlying(Expiry), Expiry, Expiry, PayCcy );\n";
+
+    ScriptParser parser(script);
+    BOOST_REQUIRE(parser.success());
+
+    constexpr Size nPaths = 5000;
+    Date expiry(7, May, 2020);
+
+    auto context = QuantLib::ext::make_shared<Context>();
+    context->scalars["Strike"] = RandomVariable(nPaths, 100.0);
+    context->scalars["Underlying"] = IndexVec{nPaths, "EQ-SP5"};
+    context->scalars["Expiry"] = EventVec{nPaths, expiry};
+    context->scalars["PayCcy"] = CurrencyVec{nPaths, "USD"};
+    context->scalars["Option"] = RandomVariable(nPaths, 0.0);
+    context->scalars["Forward"] = RandomVariable(nPaths, 0.0);
+
+    std::set<Date> simulationDates = {expiry};
+
+    Handle<YieldTermStructure> yts(QuantLib::ext::make_shared<FlatForward>(ref, 0.01, ActualActual(ActualActual::ISDA)));
+    Handle<YieldTermStructure> yts0(QuantLib::ext::make_shared<FlatForward>(ref, 0.0, ActualActual(ActualActual::ISDA)));
+    Handle<BlackVolTermStructure> volts(
+        QuantLib::ext::make_shared<BlackConstantVol>(ref, NullCalendar(), 0.18, ActualActual(ActualActual::ISDA)));
+    auto process = QuantLib::ext::make_shared<GeneralizedBlackScholesProcess>(
+        Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(100.0)), yts0, yts, volts);
+
+    Real t = ActualActual(ActualActual::ISDA).yearFraction(ref, expiry);
+    Real analytic = blackFormula(Option::Call, 100.0, 100.0 / yts->discount(t), 0.18 * std::sqrt(t), yts->discount(t));
+
+    // the discounted forward is a martingale, so its known value is the spot
+    auto price = [&](const std::vector<std::pair<std::string, std::string>>& controlVariates, Real& errorEstimate,
+                     std::map<std::string, boost::any>& additionalResults) {
+        Model::McParams mcParams;
+        mcParams.sequenceType = QuantExt::SequenceType::MersenneTwister;
+        auto model = QuantLib::ext::make_shared<BlackScholes>(
+            nPaths, "USD", yts, "EQ-SP5", "USD",
+            BlackScholesModelBuilder(yts, process, simulationDates, std::set<Date>(), 1).model(), mcParams,
+            simulationDates);
+        QuantExt::ScriptedInstrument instrument(expiry);
+        instrument.setPricingEngine(QuantLib::ext::make_shared<ScriptedInstrumentPricingEngine>(
+            "Option", std::vector<std::pair<std::string, std::string>>(), model, parser.ast(), context, script,
+            false, false, std::set<std::string>(), true, false, true, controlVariates));
+        Real npv = instrument.NPV();
+        errorEstimate = instrument.errorEstimate();
+        additionalResults = instrument.additionalResults();
+        BOOST_TEST_MESSAGE("npv = " << npv << " (error estimate " << errorEstimate << "), analytic " << analytic);
+        return npv;
+    };
+
+    Real errPlain, errCv;
+    std::map<std::string, boost::any> resPlain, resCv;
+    Real npvPlain = price({}, errPlain, resPlain);
+    Real npvCv = price({{"Forward", "100.0"}}, errCv, resCv);
+
+    BOOST_CHECK_SMALL(npvPlain - analytic, 3.0 * errPlain);
+    BOOST_CHECK_SMALL(npvCv - analytic, 3.0 * errCv);
+    BOOST_CHECK_LT(errCv, errPlain);
+    BOOST_CHECK_CLOSE(boost::any_cast<double>(resCv.at("NPV_NoControlVariate")), npvPlain, 1E-8);
+    BOOST_REQUIRE(resCv.count("ControlVariate_VarianceReductionFactor") == 1);
+    BOOST_CHECK_GT(boost::any_cast<double>(resCv.at("ControlVariate_VarianceReductionFactor")), 1.0);
+    BOOST_CHECK(resCv.count("ControlVariate_Beta_Forward") == 1);
+    BOOST_CHECK(resPlain.count("ControlVariate_VarianceReductionFactor") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testConcurrentPricing) {
+    BOOST_TEST_MESSAGE("Testing concurrent pricing of scripted instruments sharing a script and a model...");
+
+    Date ref(7, May, 2019);
+    Settings::instance().evaluationDate() = ref;
+
+    std::string script = "NUMBER avg; NUMBER i;"
+                         "FOR i IN (1,SIZE(ObservationDates),1) DO"
+                         "  avg = avg + Underlying(ObservationDates[i]);"
+                         "END;"
+                         "Option = PAY( max( avg / SIZE(ObservationDates) - Strike, 0),"
+                         "              Settlement, Settlement, PayCcy);";
+
+    ScriptParser parser(script);
+    BOOST_REQUIRE(parser.success());
+
+    constexpr Size nPaths = 2000;
+    constexpr Size nTrades = 8;
+    constexpr Size nThreads = 4;
+
+    Schedule observationSchedule(Date(9, May, 2019), Date(9, May, 2020), 1 * Months, NullCalendar(), Unadjusted,
+                                 Unadjusted, DateGeneration::Forward, false);
+    std::vector<ValueType> observationDates;
+    for (auto const& d : observationSchedule.dates())
+        observationDates.push_back(EventVec{nPaths, d});
+    std::set<Date> simulationDates(observationSchedule.dates().begin(), observationSchedule.dates().end());
+
+    Handle<YieldTermStructure> yts(QuantLib::ext::make_shared<FlatForward>(ref, 0.02, ActualActual(ActualActual::ISDA)));
+    Handle<YieldTermStructure> yts0(QuantLib::ext::make_shared<FlatForward>(ref, 0.0, ActualActual(ActualActual::ISDA)));
+    Handle<BlackVolTermStructure> volts(
+        QuantLib::ext::make_shared<BlackConstantVol>(ref, NullCalendar(), 0.18, ActualActual(ActualActual::ISDA)));
+    auto process = QuantLib::ext::make_shared<GeneralizedBlackScholesProcess>(
+        Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(100.0)), yts0, yts, volts);
+
+    auto buildModel = [&]() {
+        return QuantLib::ext::make_shared<BlackScholes>(
+            nPaths, "USD", yts, "EQ-SP5", "USD",
+            BlackScholesModelBuilder(yts, process, simulationDates, std::set<Date>(), 1).model(), Model::McParams(),
+            simulationDates);
+    };
+
+    // the trades differ in their strikes and share the ast
+    auto buildInstrument = [&](const Size i, const QuantLib::ext::shared_ptr<Model>& model) {
+        auto context = QuantLib::ext::make_shared<Context>();
+        context->scalars["Strike"] = RandomVariable(nPaths, 90.0 + 2.5 * static_cast<double>(i));
+        context->scalars["Underlying"] = IndexVec{nPaths, "EQ-SP5"};
+        context->arrays["ObservationDates"] = observationDates;
+        context->scalars["Settlement"] = observationDates.back();
+        context->scalars["PayCcy"] = CurrencyVec{nPaths, "USD"};
+        context->scalars["Option"] = RandomVariable(nPaths, 0.0);
+        auto instrument = QuantLib::ext::make_shared<QuantExt::ScriptedInstrument>(observationSchedule.dates().back());
+        instrument->setPricingEngine(QuantLib::ext::make_shared<ScriptedInstrumentPricingEngine>(
+            "Option", std::vector<std::pair<std::string, std::string>>(), model, parser.ast(), context, script));
+        return instrument;
+    };
+
+    auto sharedModel = buildModel();
+    std::vector<Real> sequentialNpvs;
+    for (Size i = 0; i < nTrades; ++i)
+        sequentialNpvs.push_back(buildInstrument(i, sharedModel)->NPV());
+
+    /* the instruments are set up before the workers are started, so that the observer registrations happen on this
+       thread, the engines lock the shared model while pricing */
+    for (bool shareModel : {true, false}) {
+        std::vector<QuantLib::ext::shared_ptr<QuantExt::ScriptedInstrument>> instruments;
+        for (Size i = 0; i < nTrades; ++i)
+            instruments.push_back(buildInstrument(i, shareModel ? sharedModel : buildModel()));
+        std::vector<Real> npvs(nTrades, Null<Real>());
+        std::vector<std::string> errors(nThreads);
+        std::vector<std::thread> workers;
+        for (Size t = 0; t < nThreads; ++t) {
+            workers.emplace_back([&, t]() {
+#ifdef QL_ENABLE_SESSIONS
+                Settings::instance().evaluationDate() = ref;
+#endif
+                try {
+                    for (Size i = t; i < nTrades; i += nThreads)
+                        npvs[i] = instruments[i]->NPV();
+                } catch (const std::exception& e) {
+                    errors[t] = e.what();
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        for (Size t = 0; t < nThreads; ++t)
+            BOOST_CHECK_MESSAGE(errors[t].empty(), "thread " << t << " failed: " << errors[t]);
+        for (Size i = 0; i < nTrades; ++i) {
+            BOOST_TEST_MESSAGE("trade " << i << (shareModel ? " (shared model)" : " (own model)") << ": npv "
+                                        << npvs[i] << ", sequential " << sequentialNpvs[i]);
+            BOOST_CHECK_CLOSE(npvs[i], sequentialNpvs[i], 1E-10);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testAsianOption) {
     BOOST_TEST_MESSAGE("Testing asian option...");
 
@@ -0,0 +1,365 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/* Throughput benchmarks for the scripting engine. The test cases are disabled by default, run them explicitly with
+   e.g. --run_test=OREDataTestSuite/ScriptEngineBenchmark --log_level=message to get the timings and allocation counts
+   reported. */
+
+// clang-format off
+#include <boost/test/unit_test.hpp>
+// clang-format on
+#include <boost/timer/timer.hpp>
+
+#include <ored/scripting/asttoscriptconverter.hpp>
+#include <ored/scripting/engines/scriptedinstrumentpricingengine.hpp>
+#include <ored/scripting/engines/scriptedinstrumentpricingenginecg.hpp>
+#include <ored/scripting/models/blackscholes.hpp>
+#include <ored/scripting/models/blackscholescg.hpp>
+#include <ored/scripting/models/fdblackscholesbase.hpp>
+#include <ored/scripting/randomastgenerator.hpp>
+#include <ored/scripting/scriptbytecode.hpp>
+#include <ored/scripting/scriptedinstrument.hpp>
+#include <ored/scripting/scriptparser.hpp>
+#include <ored/scripting/staticanalyser.hpp>
+
+#include <oret/toplevelfixture.hpp>
+
+#include <ored/model/blackscholesmodelbuilder.hpp>
+
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/volatility/equityfx/blackconstantvol.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/nullcalendar.hpp>
+#include <ql/time/daycounters/actualactual.hpp>
+#include <ql/time/schedule.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <new>
+#include <thread>
+
+using namespace ore::data;
+using namespace QuantExt;
+using boost::timer::cpu_timer;
+
+/* count the global allocations made while the benchmarks run, on platforms where shared libraries use their own
+   allocator (e.g. dlls on windows) only the allocations from code linked into the test binary are counted */
+
+namespace {
+std::atomic<std::size_t> allocationCount{0};
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+struct BenchmarkScript {
+    std::string name;
+    std::string code;
+    // the script can be priced with the fd model, i.e. it is not path dependent
+    bool fdEligible;
+    // the context for a given model size
+    std::function<QuantLib::ext::shared_ptr<Context>(const Size)> context;
+};
+
+std::vector<ValueType> eventArray(const Schedule& schedule, const Size n) {
+    std::vector<ValueType> result;
+    for (auto const& d : schedule.dates())
+        result.push_back(EventVec{n, d});
+    return result;
+}
+
+std::vector<BenchmarkScript> benchmarkScripts(const Date& ref) {
+
+    Schedule monthly(ref + 1 * Months, ref + 1 * Years, 1 * Months, NullCalendar(), Unadjusted, Unadjusted,
+                     DateGeneration::Forward, false);
+    Schedule weekly(ref + 1 * Weeks, ref + 1 * Years, 1 * Weeks, NullCalendar(), Unadjusted, Unadjusted,
+                    DateGeneration::Forward, false);
+    Schedule quarterly(ref + 3 * Months, ref + 3 * Years, 3 * Months, NullCalendar(), Unadjusted, Unadjusted,
+                       DateGeneration::Forward, false);
+
+    auto baseContext = [](const Size n) {
+        auto context = QuantLib::ext::make_shared<Context>();
+        context->scalars["Underlying"] = IndexVec{n, "EQ-SP5"};
+        context->scalars["PayCcy"] = CurrencyVec{n, "USD"};
+        context->scalars["Strike"] = RandomVariable(n, 100.0);
+        context->scalars["Option"] = RandomVariable(n, 0.0);
+        return context;
+    };
+
+    std::vector<BenchmarkScript> scripts;
+
+    scripts.push_back({"Bermudan", "NUMBER Exercise, i;\n"
+                                   "FOR i IN (SIZE(Expiry), 1, -1) DO\n"
+                                   "  Exercise = PAY( Strike - Underlying(Expiry[i]), Expiry[i], Expiry[i], PayCcy );\n"
+                                   "  IF Exercise > NPV( Option, Expiry[i] ) AND Exercise > 0 THEN\n"
+                                   "    Option = Exercise;\n"
+                                   "  END;\n"
+                                   "END;\n",
+                       true, [=](const Size n) {
+                           auto context = baseContext(n);
+                           context->arrays["Expiry"] = eventArray(monthly, n);
+                           return context;
+                       }});
+
+    scripts.push_back({"Asian", "NUMBER avg, i;\n"
+                                "FOR i IN (1, SIZE(ObservationDates), 1) DO\n"
+                                "  avg = avg + Underlying(ObservationDates[i]);\n"
+                                "END;\n"
+                                "Option = PAY( max( avg / SIZE(ObservationDates) - Strike, 0 ),\n"
+                                "              Settlement, Settlement, PayCcy );\n",
+                       false, [=](const Size n) {
+                           auto context = baseContext(n);
+                           context->arrays["ObservationDates"] = eventArray(monthly, n);
+                           context->scalars["Settlement"] = EventVec{n, monthly.dates().back()};
+                           return context;
+                       }});
+
+    scripts.push_back({"Accumulator", "NUMBER d, Alive, Fixing;\n"
+                                      "Alive = 1;\n"
+                                      "FOR d IN (1, SIZE(FixingDates), 1) DO\n"
+                                      "  Fixing = Underlying(FixingDates[d]);\n"
+                                      "  IF Alive == 1 AND Fixing >= KnockOutLevel THEN\n"
+                                      "    Alive = 0;\n"
+                                      "  END;\n"
+                                      "  IF Alive == 1 THEN\n"
+                                      "    IF Fixing >= Strike THEN\n"
+                                      "      Option = Option + PAY( FixingAmount * (Fixing - Strike),\n"
+                                      "                             FixingDates[d], FixingDates[d], PayCcy );\n"
+                                      "    ELSE\n"
+                                      "      Option = Option + PAY( 2 * FixingAmount * (Fixing - Strike),\n"
+                                      "                             FixingDates[d], FixingDates[d], PayCcy );\n"
+                                      "    END;\n"
+                                      "  END;\n"
+                                      "END;\n",
+                       false, [=](const Size n) {
+                           auto context = baseContext(n);
+                           context->arrays["FixingDates"] = eventArray(weekly, n);
+                           context->scalars["KnockOutLevel"] = RandomVariable(n, 115.0);
+                           context->scalars["FixingAmount"] = RandomVariable(n, 1000.0);
+                           return context;
+                       }});
+
+    scripts.push_back({"Autocallable", "NUMBER i, Alive, Performance;\n"
+                                       "Alive = 1;\n"
+                                       "FOR i IN (1, SIZE(ObservationDates), 1) DO\n"
+                                       "  Performance = Underlying(ObservationDates[i]) / Strike;\n"
+                                       "  IF Alive == 1 THEN\n"
+                                       "    IF Performance >= CouponBarrier THEN\n"
+                                       "      Option = Option + PAY( Notional * Coupon, ObservationDates[i],\n"
+                                       "                             ObservationDates[i], PayCcy );\n"
+                                       "    END;\n"
+                                       "    IF Performance >= AutocallBarrier THEN\n"
+                                       "      Option = Option + PAY( Notional, ObservationDates[i],\n"
+                                       "                             ObservationDates[i], PayCcy );\n"
+                                       "      Alive = 0;\n"
+                                       "    END;\n"
+                                       "  END;\n"
+                                       "END;\n"
+                                       "IF Alive == 1 THEN\n"
+                                       "  Option = Option + PAY( Notional * min( Performance / KnockInBarrier, 1 ),\n"
+                                       "                         ObservationDates[SIZE(ObservationDates)],\n"
+                                       "                         ObservationDates[SIZE(ObservationDates)], PayCcy );\n"
+                                       "END;\n",
+                       false, [=](const Size n) {
+                           auto context = baseContext(n);
+                           context->arrays["ObservationDates"] = eventArray(quarterly, n);
+                           context->scalars["Notional"] = RandomVariable(n, 1000000.0);
+                           context->scalars["Coupon"] = RandomVariable(n, 0.02);
+                           context->scalars["CouponBarrier"] = RandomVariable(n, 0.8);
+                           context->scalars["AutocallBarrier"] = RandomVariable(n, 1.0);
+                           context->scalars["KnockInBarrier"] = RandomVariable(n, 0.6);
+                           return context;
+                       }});
+
+    return scripts;
+}
+
+// prices the instrument once to warm up, then reports the timing and allocations of the given number of repricings
+void runBenchmark(const std::string& label, QuantExt::ScriptedInstrument& instrument, const Size size,
+                  const Size repetitions) {
+    cpu_timer timer;
+    std::size_t allocations = allocationCount.load();
+    Real npv = instrument.NPV();
+    timer.stop();
+    Real warmUp = timer.elapsed().wall * 1E-6;
+    std::size_t warmUpAllocations = allocationCount.load() - allocations;
+    allocations = allocationCount.load();
+    timer.start();
+    for (Size i = 0; i < repetitions; ++i)
+        instrument.recalculate();
+    timer.stop();
+    Real wall = timer.elapsed().wall * 1E-9 / static_cast<Real>(repetitions);
+    std::size_t runAllocations = (allocationCount.load() - allocations) / repetitions;
+    BOOST_TEST_MESSAGE(std::left << std::setw(40) << label << std::right << std::setw(8) << size << " npv "
+                                 << std::setw(14) << npv << " first run " << std::setw(10) << warmUp << " ms ("
+                                 << warmUpAllocations << " allocs), per run " << std::setw(10) << wall * 1E3
+                                 << " ms, " << std::setw(12) << static_cast<Real>(size) / wall << " evals/s, "
+                                 << runAllocations << " allocs");
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(ScriptEngineBenchmark)
+
+BOOST_AUTO_TEST_CASE(benchmarkRandomAst, *boost::unit_test::disabled()) {
+
+    BOOST_TEST_MESSAGE("Benchmarking parser and bytecode compiler on random scripts...");
+
+    /* the random scripts reference undeclared variables and call functions with random arguments, so they can not be
+       executed in a meaningful way, we measure the front end (script generation, parsing and bytecode compilation)
+       in parallel on all available threads */
+
+    Size nThreads = std::max<Size>(std::thread::hardware_concurrency(), 1);
+    if (auto t = getenv("ORE_BENCHMARK_THREADS"))
+        nThreads = std::max(atoi(t), 1);
+
+    std::vector<std::tuple<Size, Size, Size>> testSizes = {{5, 5, 2000}, {10, 5, 1000}, {10, 10, 200}};
+
+    for (auto const& testSize : testSizes) {
+        Size len = std::get<0>(testSize), dep = std::get<1>(testSize), n = std::get<2>(testSize);
+        std::atomic<Size> scriptLength{0}, parseFailures{0}, compileFailures{0};
+        std::size_t allocations = allocationCount.load();
+        cpu_timer timer;
+        std::vector<std::thread> workers;
+        for (Size t = 0; t < nThreads; ++t) {
+            workers.emplace_back([&, t]() {
+                for (Size i = t; i < n; i += nThreads) {
+                    std::string script = to_script(generateRandomAST(len, dep, 42 + i));
+                    scriptLength += script.length();
+                    ScriptParser parser(script);
+                    if (!parser.success()) {
+                        ++parseFailures;
+                        continue;
+                    }
+                    try {
+                        ScriptBytecode bytecode(parser.ast());
+                    } catch (const std::exception&) {
+                        ++compileFailures;
+                    }
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        timer.stop();
+        Real wall = timer.elapsed().wall * 1E-9;
+        BOOST_TEST_MESSAGE("len=" << len << ", dep=" << dep << ", n=" << n << ", threads=" << nThreads
+                                  << ": avg script size " << scriptLength.load() / n << ", " << static_cast<Real>(n) / wall
+                                  << " scripts/s, " << (allocationCount.load() - allocations) / n
+                                  << " allocs/script, parse failures " << parseFailures.load()
+                                  << ", compile failures " << compileFailures.load());
+        BOOST_CHECK_EQUAL(parseFailures.load(), 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(benchmarkLibraryScripts, *boost::unit_test::disabled()) {
+
+    BOOST_TEST_MESSAGE("Benchmarking representative scripts under MC, CG and FD...");
+
+    Date ref(7, May, 2019);
+    Settings::instance().evaluationDate() = ref;
+
+    Handle<YieldTermStructure> yts(QuantLib::ext::make_shared<FlatForward>(ref, 0.02, ActualActual(ActualActual::ISDA)));
+    Handle<YieldTermStructure> yts0(QuantLib::ext::make_shared<FlatForward>(ref, 0.0, ActualActual(ActualActual::ISDA)));
+    Handle<BlackVolTermStructure> volts(
+        QuantLib::ext::make_shared<BlackConstantVol>(ref, NullCalendar(), 0.18, ActualActual(ActualActual::ISDA)));
+    auto process = QuantLib::ext::make_shared<GeneralizedBlackScholesProcess>(
+        Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(100.0)), yts0, yts, volts);
+
+    constexpr Size repetitions = 5;
+    std::vector<Size> pathCounts = {1000, 10000, 50000};
+    std::vector<Size> gridPoints = {100, 400, 1600};
+
+    for (auto const& s : benchmarkScripts(ref)) {
+
+        ScriptParser parser(s.code);
+        BOOST_REQUIRE_MESSAGE(parser.success(), "could not parse script '" << s.name << "': " << parser.error());
+
+        // compile the simulation and pay dates
+
+        auto analyser = QuantLib::ext::make_shared<StaticAnalyser>(parser.ast(), s.context(1));
+        analyser->run(s.code);
+        std::set<Date> simulationDates, payDates;
+        for (auto const& d : analyser->indexEvalDates())
+            simulationDates.insert(d.second.begin(), d.second.end());
+        for (auto const& d : analyser->payObsDates())
+            simulationDates.insert(d.second.begin(), d.second.end());
+        simulationDates.insert(analyser->regressionDates().begin(), analyser->regressionDates().end());
+        for (auto const& d : analyser->payPayDates())
+            payDates.insert(d.second.begin(), d.second.end());
+        Date lastDate = std::max(*simulationDates.rbegin(), payDates.empty() ? Date::minDate() : *payDates.rbegin());
+
+        Model::McParams mcParams;
+        mcParams.regressionOrder = 4;
+
+        for (auto n : pathCounts) {
+            auto model = QuantLib::ext::make_shared<BlackScholes>(
+                n, "USD", yts, "EQ-SP5", "USD",
+                BlackScholesModelBuilder(yts, process, simulationDates, payDates, 1).model(), mcParams,
+                simulationDates);
+            QuantExt::ScriptedInstrument instrument(lastDate);
+            instrument.setPricingEngine(QuantLib::ext::make_shared<ScriptedInstrumentPricingEngine>(
+                "Option", std::vector<std::pair<std::string, std::string>>(), model, parser.ast(), s.context(n),
+                s.code, false, false, std::set<std::string>(), false, false, false));
+            runBenchmark(s.name + " / MC", instrument, n, repetitions);
+        }
+
+        for (auto n : pathCounts) {
+            auto model = QuantLib::ext::make_shared<BlackScholesCG>(
+                n, "USD", yts, "EQ-SP5", "USD",
+                BlackScholesModelBuilder(yts, process, simulationDates, payDates, 1).model(), simulationDates);
+            QuantExt::ScriptedInstrument instrument(lastDate);
+            instrument.setPricingEngine(QuantLib::ext::make_shared<ScriptedInstrumentPricingEngineCG>(
+                "Option", std::vector<std::pair<std::string, std::string>>(), model, parser.ast(), s.context(n),
+                mcParams, s.code));
+            runBenchmark(s.name + " / CG", instrument, n, repetitions);
+        }
+
+        if (!s.fdEligible)
+            continue;
+
+        for (auto n : gridPoints) {
+            auto model = QuantLib::ext::make_shared<FdBlackScholesBase>(
+                n, "USD", yts, "EQ-SP5", "USD",
+                BlackScholesModelBuilder(yts, process, simulationDates, payDates, 24).model(), simulationDates,
+                IborFallbackConfig::defaultConfig(), "ATM");
+            QuantExt::ScriptedInstrument instrument(lastDate);
+            instrument.setPricingEngine(QuantLib::ext::make_shared<ScriptedInstrumentPricingEngine>(
+                "Option", std::vector<std::pair<std::string, std::string>>(), model, parser.ast(), s.context(n),
+                s.code));
+            runBenchmark(s.name + " / FD", instrument, n, repetitions);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,122 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/utilities/timers.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace ore::data;
+using namespace std;
+
+using ore::test::TopLevelFixture;
+
+namespace {
+// switches the registry off and discards the recorded data at the end of a test
+struct TimerRegistryResetter {
+    ~TimerRegistryResetter() {
+        TimerRegistry::instance().enable(false);
+        TimerRegistry::instance().reset();
+    }
+};
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(TimersTests)
+
+BOOST_AUTO_TEST_CASE(testDisabledRegistryRecordsNothing) {
+
+    BOOST_TEST_MESSAGE("Testing that a disabled timer registry records nothing...");
+
+    TimerRegistryResetter resetter;
+    TimerRegistry::instance().reset();
+    {
+        ORE_TIMER("outer");
+        ORE_COUNTER("counter", 1.0);
+    }
+    BOOST_CHECK(TimerRegistry::instance().timers().empty());
+    BOOST_CHECK(TimerRegistry::instance().counters().empty());
+}
+
+BOOST_AUTO_TEST_CASE(testHierarchicalTimersAndCounters) {
+
+    BOOST_TEST_MESSAGE("Testing hierarchical timers and counters across threads...");
+
+    TimerRegistryResetter resetter;
+    TimerRegistry::instance().reset();
+    TimerRegistry::instance().enable(true);
+
+    auto work = [] {
+        ORE_TIMER("outer");
+        for (std::size_t i = 0; i < 3; ++i) {
+            ORE_TIMER(std::string("inner"));
+            ORE_COUNTER("counter", 2.0);
+        }
+    };
+    work();
+    std::thread t(work);
+    t.join();
+
+    auto timers = TimerRegistry::instance().timers();
+    BOOST_REQUIRE_EQUAL(timers.size(), 2);
+    BOOST_CHECK_EQUAL(timers["outer"].count, 2);
+    BOOST_CHECK_EQUAL(timers["outer"].threads, 2);
+    BOOST_CHECK_EQUAL(timers["outer/inner"].count, 6);
+    BOOST_CHECK(timers["outer/inner"].min <= timers["outer/inner"].max);
+    BOOST_CHECK(timers["outer/inner"].total <= timers["outer"].total);
+
+    auto counters = TimerRegistry::instance().counters();
+    BOOST_REQUIRE_EQUAL(counters.size(), 1);
+    BOOST_CHECK_EQUAL(counters["outer/inner/counter"].count, 6);
+    BOOST_CHECK_CLOSE(counters["outer/inner/counter"].total, 12.0, 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(testChromeTrace) {
+
+    BOOST_TEST_MESSAGE("Testing the chrome trace output of the timer registry...");
+
+    TimerRegistryResetter resetter;
+    TimerRegistry::instance().reset();
+    TimerRegistry::instance().enable(true, true);
+    {
+        ORE_TIMER("outer");
+        ORE_TIMER("inner");
+    }
+
+    auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    TimerRegistry::instance().writeChromeTrace(path.string());
+    std::ifstream file(path.string());
+    std::stringstream content;
+    content << file.rdbuf();
+    file.close();
+    boost::filesystem::remove(path);
+
+    BOOST_CHECK(content.str().find("\"traceEvents\"") != std::string::npos);
+    BOOST_CHECK(content.str().find("\"name\":\"outer\"") != std::string::npos);
+    BOOST_CHECK(content.str().find("\"name\":\"inner\"") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,6 +20,8 @@
 #include <ored/configuration/volatilityconfig.hpp>
 #include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/marketdatumparser.hpp>
+#include <ored/marketdata/marketsnapshot.hpp>
+#include <ored/marketdata/overlayloader.hpp>
 #include <ored/marketdata/todaysmarket.hpp>
 #include <ored/portfolio/builders/cms.hpp>
 #include <ored/portfolio/builders/cmsspread.hpp>
@@ -28,6 +30,7 @@
 #include <ored/portfolio/swap.hpp>
 #include <ored/utilities/parsers.hpp>
 #include <ored/utilities/to_string.hpp>
+#include <oret/datapaths.hpp>
 #include <oret/toplevelfixture.hpp>
 #include <ql/time/calendars/all.hpp>
 #include <ql/time/daycounters/actual360.hpp>
@@ -35,6 +38,8 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/assign/list_of.hpp>
+#include <fstream>
+#include <iterator>
 #include <map>
 
 using namespace QuantLib;
@@ -941,6 +946,160 @@ BOOST_AUTO_TEST_CASE(testCommodityCurve) {
     BOOST_CHECK(*commodityCurve);
 }
 
+BOOST_AUTO_TEST_CASE(testRestrictedParameters) {
+
+    BOOST_TEST_MESSAGE("Testing todays market restricted to the requested market objects...");
+
+    Date asof(26, February, 2016);
+    auto loader = QuantLib::ext::make_shared<MarketDataLoader>();
+    auto params = marketParameters();
+    auto configs = curveConfigurations();
+
+    // request a spreaded yield curve from a lazily built market
+
+    auto lazyMarket = QuantLib::ext::make_shared<TodaysMarket>(asof, params, loader, configs, false, true, true);
+    Handle<YieldTermStructure> dtsLend = lazyMarket->yieldCurve("EUR_LEND");
+    BOOST_REQUIRE(!dtsLend.empty());
+
+    auto requested = lazyMarket->requestedObjects();
+    BOOST_REQUIRE_EQUAL(requested.size(), 1);
+    BOOST_CHECK(requested.begin()->second[MarketObject::YieldCurve].count("EUR_LEND") == 1);
+
+    // the restricted parameters contain the curve and its dependencies only
+
+    std::map<std::string, std::string> buildErrors;
+    DependencyGraph dg(asof, params, configs);
+    auto restrictedParams = dg.restrictedParameters(requested, buildErrors);
+    BOOST_CHECK(buildErrors.empty());
+    BOOST_CHECK(restrictedParams->hasMarketObject(MarketObject::YieldCurve));
+    BOOST_CHECK(restrictedParams->hasMarketObject(MarketObject::DiscountCurve));
+    BOOST_CHECK(!restrictedParams->hasMarketObject(MarketObject::EquityCurve));
+    BOOST_CHECK(!restrictedParams->hasMarketObject(MarketObject::CommodityCurve));
+
+    // a non-lazy market on the restricted parameters builds and reproduces the requested curve
+
+    auto restrictedMarket = QuantLib::ext::make_shared<TodaysMarket>(asof, restrictedParams, loader, configs);
+    Handle<YieldTermStructure> dtsLendRestricted = restrictedMarket->yieldCurve("EUR_LEND");
+    BOOST_REQUIRE(!dtsLendRestricted.empty());
+    for (Size i = 1; i <= 120; ++i) {
+        Date d = asof + i * Months;
+        BOOST_CHECK_CLOSE(dtsLend->discount(d), dtsLendRestricted->discount(d), 1E-10);
+    }
+    BOOST_CHECK_THROW(restrictedMarket->equityCurve("SP5"), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_CASE(testIncrementalUpdate) {
+
+    BOOST_TEST_MESSAGE("Testing incremental todays market update on changed quotes...");
+
+    Date asof(26, February, 2016);
+    auto loader = QuantLib::ext::make_shared<MarketDataLoader>();
+    auto params = marketParameters();
+    auto configs = curveConfigurations();
+
+    auto market = QuantLib::ext::make_shared<TodaysMarket>(asof, params, loader, configs);
+    Handle<YieldTermStructure> eonia = market->discountCurve("EUR");
+    Handle<YieldTermStructure> lend = market->yieldCurve("EUR_LEND");
+    Handle<YieldTermStructure> usd = market->discountCurve("USD");
+    Handle<IborIndex> eoniaIndex = market->iborIndex("EUR-EONIA");
+    Date d = asof + 5 * Years;
+    Real eonia0 = eonia->discount(d), lend0 = lend->discount(d), usd0 = usd->discount(d);
+
+    // quotes not used by any market object do not trigger a rebuild
+
+    BOOST_CHECK_EQUAL(market->update({parseMarketDatum(asof, "MM/RATE/GBP/0D/1D", 0.01)}), 0);
+
+    // a change in the lending spreads rebuilds the lending curve only
+
+    std::vector<QuantLib::ext::shared_ptr<MarketDatum>> spreads;
+    for (auto const& t : {"2Y", "5Y", "10Y", "20Y"})
+        spreads.push_back(parseMarketDatum(asof, "ZERO/YIELD_SPREAD/EUR/BANK_EUR_LEND/A365/" + std::string(t), 0.0060));
+    BOOST_CHECK_EQUAL(market->update(spreads), 1);
+    BOOST_CHECK(market->updatedObjects() == std::set<MarketObject>{MarketObject::YieldCurve});
+    BOOST_CHECK_CLOSE(eonia->discount(d), eonia0, 1E-12);
+    BOOST_CHECK(market->yieldCurve("EUR_LEND")->discount(d) < lend0);
+
+    // a change in the Eonia curve rebuilds the Eonia curve and its dependents and relinks the handles in place
+
+    auto eoniaQuote = parseMarketDatum(asof, "IR_SWAP/RATE/EUR/2D/1D/5Y", -0.0019);
+    BOOST_CHECK(market->update({eoniaQuote}) >= 3);
+    BOOST_CHECK(eonia->discount(d) < eonia0);
+    BOOST_CHECK(market->discountCurve("EUR").currentLink() == eonia.currentLink());
+    BOOST_CHECK(eoniaIndex->forwardingTermStructure().currentLink() == eonia.currentLink());
+    BOOST_CHECK_CLOSE(usd->discount(d), usd0, 1E-12);
+
+    // the updated market matches a market built from scratch on the changed quotes
+
+    auto changedLoader = QuantLib::ext::make_shared<OverlayLoader>(loader);
+    for (auto const& md : spreads)
+        changedLoader->add(md);
+    changedLoader->add(eoniaQuote);
+    auto expected = QuantLib::ext::make_shared<TodaysMarket>(asof, params, changedLoader, configs);
+    for (Size i = 1; i <= 120; ++i) {
+        Date di = asof + i * Months;
+        BOOST_CHECK_CLOSE(eonia->discount(di), expected->discountCurve("EUR")->discount(di), 1E-10);
+        BOOST_CHECK_CLOSE(market->yieldCurve("EUR_LEND")->discount(di),
+                          expected->yieldCurve("EUR_LEND")->discount(di), 1E-10);
+        BOOST_CHECK_CLOSE(market->yieldCurve("EUR_BORROW")->discount(di),
+                          expected->yieldCurve("EUR_BORROW")->discount(di), 1E-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testMarketSnapshot) {
+
+    BOOST_TEST_MESSAGE("Testing market snapshot and restore...");
+
+    Date asof(26, February, 2016);
+    auto params = marketParameters();
+    auto market =
+        QuantLib::ext::make_shared<TodaysMarket>(asof, params, QuantLib::ext::make_shared<MarketDataLoader>(),
+                                                 curveConfigurations());
+
+    std::string filename = TEST_OUTPUT_FILE("market_snapshot.bin");
+    writeMarketSnapshot(*market, *params, filename, 10 * Years);
+    SnapshotMarket snapshot(filename);
+    BOOST_CHECK_EQUAL(snapshot.asofDate(), asof);
+
+    // the curves match on the daily grid and on the monthly grid beyond
+
+    std::vector<std::pair<Handle<YieldTermStructure>, Handle<YieldTermStructure>>> curves = {
+        {market->discountCurve("EUR"), snapshot.discountCurve("EUR")},
+        {market->discountCurve("USD"), snapshot.discountCurve("USD")},
+        {market->yieldCurve("EUR_LEND"), snapshot.yieldCurve("EUR_LEND")},
+        {market->iborIndex("USD-LIBOR-3M")->forwardingTermStructure(),
+         snapshot.iborIndex("USD-LIBOR-3M")->forwardingTermStructure()}};
+    for (auto const& [original, restored] : curves) {
+        BOOST_REQUIRE(original->referenceDate() == restored->referenceDate());
+        for (Date d = original->referenceDate(); d <= original->referenceDate() + 10 * Years; d += 7)
+            BOOST_CHECK_CLOSE(restored->discount(d), original->discount(d), 1E-10);
+        for (Size i = 121; i <= 240; ++i) {
+            Date d = original->referenceDate() + i * Months;
+            BOOST_CHECK_CLOSE(restored->discount(d), original->discount(d), 1E-10);
+        }
+    }
+
+    // shared term structures stay shared, indices forecast on the restored curves
+
+    BOOST_CHECK(snapshot.discountCurve("EUR").currentLink() ==
+                snapshot.iborIndex("EUR-EONIA")->forwardingTermStructure().currentLink());
+    Date fixingDate(2, March, 2018);
+    BOOST_CHECK_CLOSE(snapshot.iborIndex("USD-LIBOR-3M")->fixing(fixingDate),
+                      market->iborIndex("USD-LIBOR-3M")->fixing(fixingDate), 1E-8);
+    BOOST_CHECK_CLOSE(snapshot.swapIndex("USD-CMS-10Y")->fixing(fixingDate),
+                      market->swapIndex("USD-CMS-10Y")->fixing(fixingDate), 1E-8);
+
+    // a truncated snapshot is rejected
+
+    std::string truncated = TEST_OUTPUT_FILE("market_snapshot_truncated.bin");
+    {
+        std::ifstream in(filename, std::ios::binary);
+        std::vector<char> buffer(std::istreambuf_iterator<char>(in), {});
+        std::ofstream out(truncated, std::ios::binary);
+        out.write(buffer.data(), buffer.size() / 2);
+    }
+    BOOST_CHECK_THROW(SnapshotMarket{truncated}, QuantLib::Error);
+}
+
 BOOST_AUTO_TEST_CASE(testCorrelationCurve) {
 
     BOOST_TEST_MESSAGE("Testing correlation curve");
@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/utilities/wildcard.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <regex>
+
+using namespace ore::data;
+using namespace std;
+
+using ore::test::TopLevelFixture;
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(WildcardTests)
+
+BOOST_AUTO_TEST_CASE(testMatchesAgainstRegex) {
+
+    BOOST_TEST_MESSAGE("Testing wildcard matching against the equivalent regex...");
+
+    std::vector<std::string> patterns = {"*",
+                                         "**",
+                                         "FX_OPTION/RATE_LNVOL/EUR/USD/*",
+                                         "FX_OPTION/RATE_LNVOL/EUR/USD/*/ATM",
+                                         "*/EUR/*",
+                                         "ZERO/RATE/EUR/*/A365/*",
+                                         "*ATM",
+                                         "a*b*c",
+                                         "a*a*a",
+                                         "EQUITY_OPTION/RATE_LNVOL/SP5.IDX/USD/*",
+                                         "FX/RATE/EUR/USD",
+                                         "(a)*[b]+?"};
+    std::vector<std::string> strings = {"",
+                                        "FX_OPTION/RATE_LNVOL/EUR/USD/1Y/ATM",
+                                        "FX_OPTION/RATE_LNVOL/EUR/USD/1Y/25RR",
+                                        "FX_OPTION/RATE_LNVOL/EUR/USD/",
+                                        "FX_OPTION/RATE_LNVOL/EUR/GBP/1Y/ATM",
+                                        "ZERO/RATE/EUR/EUR1D/A365/2Y",
+                                        "ZERO/RATE/EUR/EUR1D/A360/2Y",
+                                        "EQUITY_OPTION/RATE_LNVOL/SP5.IDX/USD/1Y/ATMF",
+                                        "EQUITY_OPTION/RATE_LNVOL/SP5XIDX/USD/1Y/ATMF",
+                                        "FX/RATE/EUR/USD",
+                                        "abc",
+                                        "aXbYc",
+                                        "aXbYcZ",
+                                        "aaa",
+                                        "aa",
+                                        "a\nb\nc",
+                                        "(a)xyz[b]+?",
+                                        "(a)xyz[b]+"};
+
+    for (auto const& p : patterns) {
+        for (auto const& usePrefixes : {true, false}) {
+            Wildcard w(p, usePrefixes);
+            std::regex r(w.hasWildcard() && !w.isPrefix() ? w.regex() : std::string());
+            for (auto const& s : strings) {
+                bool expected;
+                if (!w.hasWildcard())
+                    expected = s == p;
+                else if (w.isPrefix())
+                    expected = s.substr(0, w.prefix().size()) == w.prefix();
+                else
+                    expected = std::regex_match(s, r);
+                BOOST_CHECK_MESSAGE(w.matches(s) == expected, "pattern '" << p << "' (usePrefixes = " << std::boolalpha
+                                                                          << usePrefixes << ") on '" << s
+                                                                          << "': got " << w.matches(s)
+                                                                          << ", expected " << expected);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
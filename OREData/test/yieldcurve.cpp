@@ -21,6 +21,7 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/data/test_case.hpp>
 // clang-format on
+#include <ored/marketdata/bootstrapseeds.hpp>
 #include <ored/marketdata/csvloader.hpp>
 #include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/marketdatumparser.hpp>
@@ -345,6 +346,57 @@ BOOST_DATA_TEST_CASE(testBootstrapARSinUSDPasses, bdata::make(curveConfigFiles),
     BOOST_TEST_MESSAGE("Discount: " << std::fixed << std::setprecision(14) << yts->discount(1.0));
 }
 
+BOOST_AUTO_TEST_CASE(testWarmStartBootstrap) {
+
+    BOOST_TEST_MESSAGE("Testing yield curve bootstrap warm started from a previous solution...");
+
+    BootstrapSeeds::instance().clear();
+
+    TodaysMarketArguments tma(Date(25, Sep, 2019), "ars_in_usd", "passing/zero_natural_cubic.xml");
+    for (auto const& id : {"ARS-IN-USD", "USD-FedFunds"}) {
+        auto config = tma.curveConfigs->yieldCurveConfig(id);
+        const BootstrapConfig& bc = config->bootstrapConfig();
+        config->setBootstrapConfig(BootstrapConfig(bc.accuracy(), bc.globalAccuracy(), bc.dontThrow(), bc.maxAttempts(),
+                                                   bc.maxFactor(), bc.minFactor(), bc.dontThrowSteps(), true));
+    }
+
+    auto discount = [&tma]() {
+        TodaysMarket market(tma.asof, tma.todaysMarketParameters, tma.loader, tma.curveConfigs, false, false);
+        return market.discountCurve("ARS")->discount(5.0);
+    };
+
+    // the first build records the solutions, later builds start from them and must reproduce the solution
+
+    Real expected = discount();
+    BOOST_REQUIRE_EQUAL(BootstrapSeeds::instance().size(), 2);
+    const std::string key = "Yield/ARS/ARS-IN-USD/Zero";
+    BootstrapSeeds::Seed seed = BootstrapSeeds::instance().seed(key);
+    BOOST_REQUIRE(!seed.empty());
+    BOOST_CHECK_CLOSE(discount(), expected, 1E-8);
+
+    // seeds persisted to and restored from a file
+
+    std::string filename = TEST_OUTPUT_FILE("bootstrapseeds.csv");
+    BootstrapSeeds::instance().save(filename);
+    BootstrapSeeds::instance().clear();
+    BootstrapSeeds::instance().load(filename);
+    BOOST_CHECK_EQUAL(BootstrapSeeds::instance().size(), 2);
+    BootstrapSeeds::Seed loaded = BootstrapSeeds::instance().seed(key);
+    BOOST_REQUIRE_EQUAL(loaded.size(), seed.size());
+    for (auto const& [d, v] : seed)
+        BOOST_CHECK_CLOSE(loaded[d], v, 1E-12);
+    BOOST_CHECK_CLOSE(discount(), expected, 1E-8);
+
+    // an unusable seed falls back to the generic initial guess
+
+    for (auto& s : seed)
+        s.second = 10.0;
+    BootstrapSeeds::instance().set(key, seed);
+    BOOST_CHECK_CLOSE(discount(), expected, 1E-8);
+
+    BootstrapSeeds::instance().clear();
+}
+
 BOOST_DATA_TEST_CASE(testOiFirstFutureDateVsValuationDate, bdata::make(oiFutureCases), oiFutureCase) {
 
     BOOST_TEST_MESSAGE("Testing OI future. " << oiFutureCase);
@@ -29,6 +29,7 @@
 #include <ql/settings.hpp>
 #include <qle/utilities/savedobservablesettings.hpp>
 #include <ored/configuration/conventions.hpp>
+#include <ored/utilities/indexcache.hpp>
 #include <ored/utilities/indexnametranslator.hpp>
 #include <ored/utilities/calendarparser.hpp>
 #include <ored/utilities/currencyparser.hpp>
@@ -63,6 +64,8 @@ public:
         ore::data::InstrumentConventions::instance().setConventions(QuantLib::ext::make_shared<ore::data::Conventions>());
         // Clear contents of the index name translator
 	ore::data::IndexNameTranslator::instance().clear();
+        // Clear the parsed indices
+        ore::data::IndexCache::instance().clear();
 	// Clear custom calendars and modified holidays
 	ore::data::CalendarParser::instance().reset();
 	// Clear custom currencies
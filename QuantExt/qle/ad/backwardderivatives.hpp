@@ -23,6 +23,7 @@
 #pragma once
 
 #include <qle/ad/computationgraph.hpp>
+#include <qle/ad/forwardevaluation.hpp>
 
 #include <ql/errors.hpp>
 
@@ -30,8 +31,13 @@
 
 namespace QuantExt {
 
+/*! Multi-output backward mode: propagates several adjoint seeds in one sweep over the graph. derivatives[d] holds the
+    adjoints of output d (of size g.size()) and is populated with the seed of the output on entry. The gradients of an
+    op are evaluated once per node and the red blocks are reconstructed once for all outputs, so that the cost of a
+    sweep grows only slowly with the number of outputs, while the memory consumption is proportional to it. The other
+    parameters have the same meaning as in the single output version below. */
 template <class T>
-void backwardDerivatives(const ComputationGraph& g, std::vector<T>& values, std::vector<T>& derivatives,
+void backwardDerivatives(const ComputationGraph& g, std::vector<T>& values, std::vector<std::vector<T>>& derivatives,
                          const std::vector<std::function<std::vector<T>(const std::vector<const T*>&, const T*)>>& grad,
                          std::function<void(T&)> deleter = {}, const std::vector<bool>& keepNodes = {},
                          const std::vector<std::function<T(const std::vector<const T*>&)>>& fwdOps = {},
@@ -39,13 +45,17 @@ void backwardDerivatives(const ComputationGraph& g, std::vector<T>& values, std:
                              fwdOpRequiresNodesForDerivatives = {},
                          const std::vector<bool>& fwdKeepNodes = {}, const std::size_t conditionalExpectationOpId = 0,
                          const std::function<T(const std::vector<const T*>&)>& conditionalExpectation = {},
-                         std::function<void(T&)> preDeleter = {}) {
+                         std::function<void(T&)> preDeleter = {}, const std::vector<std::size_t>& activeNodes = {}) {
 
     if (g.size() == 0)
         return;
 
     std::size_t redBlockId = 0;
 
+    // buffer reused for all nodes
+
+    std::vector<const T*> args;
+
     // loop over the nodes in the graph in reverse order
 
     for (std::size_t node = g.size() - 1; node > 0; --node) {
@@ -71,7 +81,7 @@ void backwardDerivatives(const ComputationGraph& g, std::vector<T>& values, std:
                 QL_REQUIRE(range.second != ComputationGraph::nan,
                            "backwardDerivatives(): red block " << g.redBlockId(node) << " was not closed.");
                 forwardEvaluation(g, values, fwdOps, deleter, true, fwdOpRequiresNodesForDerivatives, fwdKeepNodes,
-                                  range.first, range.second, true, preDeleter);
+                                  range.first, range.second, true, preDeleter, {}, activeNodes);
             }
 
             // update the red block id
@@ -79,38 +89,52 @@ void backwardDerivatives(const ComputationGraph& g, std::vector<T>& values, std:
             redBlockId = g.redBlockId(node);
         }
 
-        if (!g.predecessors(node).empty() && !isDeterministicAndZero(derivatives[node])) {
+        bool nonZeroDerivative = false;
+        for (auto const& d : derivatives)
+            nonZeroDerivative = nonZeroDerivative || !isDeterministicAndZero(d[node]);
 
-            // propagate the derivative at a node to its predecessors
+        if (!g.predecessors(node).empty() && nonZeroDerivative) {
 
-            std::vector<const T*> args(g.predecessors(node).size());
+            // propagate the derivatives at a node to its predecessors
+
+            args.resize(g.predecessors(node).size());
             for (std::size_t arg = 0; arg < g.predecessors(node).size(); ++arg) {
                 args[arg] = &values[g.predecessors(node)[arg]];
             }
 
-            QL_REQUIRE(derivatives[node].initialised(),
-                       "backwardDerivatives(): derivative at active node " << node << " is not initialized.");
+            for (auto const& d : derivatives) {
+                QL_REQUIRE(d[node].initialised(),
+                           "backwardDerivatives(): derivative at active node " << node << " is not initialized.");
+            }
 
             if (g.opId(node) == conditionalExpectationOpId && conditionalExpectation) {
 
                 // expected stochastic automatic differentiaion, Fries, 2017
-                args[0] = &derivatives[node];
-                derivatives[g.predecessors(node)[0]] += conditionalExpectation(args);
+                for (auto& d : derivatives) {
+                    if (isDeterministicAndZero(d[node]))
+                        continue;
+                    args[0] = &d[node];
+                    d[g.predecessors(node)[0]] += conditionalExpectation(args);
+                }
 
             } else {
 
                 auto gr = grad[g.opId(node)](args, &values[node]);
 
                 for (std::size_t p = 0; p < g.predecessors(node).size(); ++p) {
-                    QL_REQUIRE(derivatives[g.predecessors(node)[p]].initialised(),
-                               "backwardDerivatives: derivative at node "
-                                   << g.predecessors(node)[p] << " not initialized, which is an active predecessor of "
-                                   << node);
                     QL_REQUIRE(gr[p].initialised(),
                                "backwardDerivatives: gradient at node "
                                    << node << " (opId " << g.opId(node) << ") not initialized at component " << p
                                    << " but required to push to predecessor " << g.predecessors(node)[p]);
-                    derivatives[g.predecessors(node)[p]] += derivatives[node] * gr[p];
+                    for (auto& d : derivatives) {
+                        if (isDeterministicAndZero(d[node]))
+                            continue;
+                        QL_REQUIRE(d[g.predecessors(node)[p]].initialised(),
+                                   "backwardDerivatives: derivative at node "
+                                       << g.predecessors(node)[p]
+                                       << " not initialized, which is an active predecessor of " << node);
+                        d[g.predecessors(node)[p]] += d[node] * gr[p];
+                    }
                 }
             }
         }
@@ -126,10 +150,36 @@ void backwardDerivatives(const ComputationGraph& g, std::vector<T>& values, std:
 
             // apply the deleter
 
-            deleter(derivatives[node]);
+            for (auto& d : derivatives)
+                deleter(d[node]);
         }
 
     } // for node
 }
 
+template <class T>
+void backwardDerivatives(const ComputationGraph& g, std::vector<T>& values, std::vector<T>& derivatives,
+                         const std::vector<std::function<std::vector<T>(const std::vector<const T*>&, const T*)>>& grad,
+                         std::function<void(T&)> deleter = {}, const std::vector<bool>& keepNodes = {},
+                         const std::vector<std::function<T(const std::vector<const T*>&)>>& fwdOps = {},
+                         const std::vector<std::function<std::pair<std::vector<bool>, bool>(const std::size_t)>>&
+                             fwdOpRequiresNodesForDerivatives = {},
+                         const std::vector<bool>& fwdKeepNodes = {}, const std::size_t conditionalExpectationOpId = 0,
+                         const std::function<T(const std::vector<const T*>&)>& conditionalExpectation = {},
+                         std::function<void(T&)> preDeleter = {}, const std::vector<std::size_t>& activeNodes = {}) {
+
+    // the single output version is the multi-output version with one output, the vectors are swapped, not copied
+
+    std::vector<std::vector<T>> d(1);
+    d.front().swap(derivatives);
+    try {
+        backwardDerivatives(g, values, d, grad, deleter, keepNodes, fwdOps, fwdOpRequiresNodesForDerivatives,
+                            fwdKeepNodes, conditionalExpectationOpId, conditionalExpectation, preDeleter, activeNodes);
+    } catch (...) {
+        derivatives.swap(d.front());
+        throw;
+    }
+    derivatives.swap(d.front());
+}
+
 } // namespace QuantExt
@@ -23,7 +23,18 @@
 #include <ql/errors.hpp>
 #include <ql/math/comparison.hpp>
 
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/math/distributions/normal.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/set.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/unordered_map.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <fstream>
 
 namespace QuantExt {
 
@@ -40,6 +51,8 @@ void ComputationGraph::clear() {
     variables_.clear();
     variableVersion_.clear();
     labels_.clear();
+    cseNodes_.clear();
+    numberOfEliminatedSubexpressions_ = 0;
 }
 
 std::size_t ComputationGraph::size() const { return predecessors_.size(); }
@@ -59,7 +72,24 @@ std::size_t ComputationGraph::insert(const std::string& label) {
 
 std::size_t ComputationGraph::insert(const std::vector<std::size_t>& predecessors, const std::size_t opId,
                                      const std::string& label) {
+    std::size_t hash = 0;
+    if (enableCse_) {
+        boost::hash_combine(hash, opId);
+        boost::hash_range(hash, predecessors.begin(), predecessors.end());
+        auto range = cseNodes_.equal_range(hash);
+        for (auto c = range.first; c != range.second; ++c) {
+            if (opId_[c->second] == opId && predecessors_[c->second] == predecessors &&
+                (redBlockId_[c->second] == 0 || redBlockId_[c->second] == currentRedBlockId_)) {
+                ++numberOfEliminatedSubexpressions_;
+                if (enableLabels_ && !label.empty())
+                    labels_[c->second].insert(label);
+                return c->second;
+            }
+        }
+    }
     std::size_t node = predecessors_.size();
+    if (enableCse_)
+        cseNodes_.insert(std::make_pair(hash, node));
     predecessors_.push_back(predecessors);
     opId_.push_back(opId);
     for (auto const& p : predecessors) {
@@ -157,11 +187,15 @@ void ComputationGraph::setVariable(const std::string& name, const std::size_t no
 
 void ComputationGraph::enableLabels(const bool b) { enableLabels_ = b; }
 
+void ComputationGraph::enableCommonSubexpressionElimination(const bool b) { enableCse_ = b; }
+
+std::size_t ComputationGraph::numberOfEliminatedSubexpressions() const { return numberOfEliminatedSubexpressions_; }
+
 const std::map<std::size_t, std::set<std::string>>& ComputationGraph::labels() const { return labels_; }
 
 void ComputationGraph::startRedBlock() {
     currentRedBlockId_ = ++nextRedBlockId_;
-    if (!redBlockRange_.empty())
+    if (!redBlockRange_.empty() && redBlockRange_.back().second == nan)
         redBlockRange_.back().second = size();
     redBlockRange_.push_back(std::make_pair(size(), nan));
 }
@@ -184,6 +218,64 @@ bool ComputationGraph::isConstant(const std::size_t node) const { return isConst
 
 double ComputationGraph::constantValue(const std::size_t node) const { return constantValue_[node]; }
 
+template <class Archive> void ComputationGraph::serialize(Archive& ar, const unsigned int version) {
+    ar& predecessors_;
+    ar& opId_;
+    ar& isConstant_;
+    ar& constantValue_;
+    ar& maxNodeRequiringArg_;
+    ar& redBlockId_;
+    ar& constants_;
+    ar& variables_;
+    ar& variableVersion_;
+    ar& enableLabels_;
+    ar& labels_;
+    ar& enableCse_;
+    ar& cseNodes_;
+    ar& numberOfEliminatedSubexpressions_;
+    ar& currentRedBlockId_;
+    ar& nextRedBlockId_;
+    ar& redBlockRange_;
+    ar& redBlockDependencies_;
+}
+
+template void ComputationGraph::serialize(boost::archive::binary_oarchive& ar, const unsigned int version);
+template void ComputationGraph::serialize(boost::archive::binary_iarchive& ar, const unsigned int version);
+
+void saveComputationGraph(const ComputationGraph& g, const std::string& fileName) {
+    std::ofstream os(fileName, std::ios::binary);
+    QL_REQUIRE(os.is_open(), "saveComputationGraph(): error opening file '" << fileName << "'");
+    boost::archive::binary_oarchive oa(os, boost::archive::no_header);
+    oa << g;
+}
+
+void loadComputationGraph(ComputationGraph& g, const std::string& fileName) {
+    std::ifstream is(fileName, std::ios::binary);
+    QL_REQUIRE(is.is_open(), "loadComputationGraph(): error opening file '" << fileName << "'");
+    boost::archive::binary_iarchive ia(is, boost::archive::no_header);
+    ia >> g;
+}
+
+std::vector<std::size_t> deadNodeElimination(const ComputationGraph& g, const std::vector<bool>& outputNodes) {
+    QL_REQUIRE(outputNodes.size() == g.size(), "deadNodeElimination(): output nodes size ("
+                                                   << outputNodes.size() << ") does not match graph size (" << g.size()
+                                                   << ")");
+    std::vector<std::size_t> result(g.size(), ComputationGraph::nan);
+    for (std::size_t node = g.size(); node > 0; --node) {
+        std::size_t n = node - 1;
+        if (outputNodes[n] && result[n] == ComputationGraph::nan)
+            result[n] = 0;
+        if (result[n] == ComputationGraph::nan)
+            continue;
+        // the first visit of a predecessor is from its maximum required successor
+        for (auto const p : g.predecessors(n)) {
+            if (result[p] == ComputationGraph::nan)
+                result[p] = n;
+        }
+    }
+    return result;
+}
+
 std::size_t cg_const(ComputationGraph& g, const double value) { return g.constant(value); }
 
 std::size_t cg_insert(ComputationGraph& g, const std::string& label) { return g.insert(label); }
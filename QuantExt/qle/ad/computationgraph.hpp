@@ -23,10 +23,12 @@
 #pragma once
 
 #include <boost/integer.hpp>
+#include <boost/serialization/access.hpp>
 
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace QuantExt {
@@ -58,14 +60,27 @@ public:
     void setVariable(const std::string& name, const std::size_t node);
 
     void enableLabels(const bool b = true);
+
+    /*! if enabled, insert() returns an existing node with the same op and predecessors instead of adding a new one,
+        provided that the existing node is not in a red block or in the current red block */
+    void enableCommonSubexpressionElimination(const bool b = true);
+    std::size_t numberOfEliminatedSubexpressions() const;
     const std::map<std::size_t, std::set<std::string>>& labels() const;
 
+    /*! Red blocks are checkpointed segments of the graph: their values are not kept for derivatives in the forward
+        evaluation, but recomputed segment by segment from the kept values during the backward sweep. The nodes outside
+        a red block that it depends on (see redBlockDependencies()) must be kept by the caller. Calling startRedBlock()
+        in an active red block ends the latter and starts a new one. */
     void startRedBlock();
     void endRedBlock();
     std::size_t redBlockId(const std::size_t node) const;
     const std::vector<std::pair<std::size_t, std::size_t>>& redBlockRanges() const;
     const std::set<std::size_t>& redBlockDependencies() const;
 
+    //! Serialization
+    friend class boost::serialization::access;
+    template <class Archive> void serialize(Archive& ar, const unsigned int version);
+
 private:
     std::vector<std::vector<std::size_t>> predecessors_;
     std::vector<std::size_t> opId_;
@@ -82,12 +97,29 @@ private:
     bool enableLabels_ = false;
     std::map<std::size_t, std::set<std::string>> labels_;
 
+    bool enableCse_ = false;
+    std::unordered_multimap<std::size_t, std::size_t> cseNodes_;
+    std::size_t numberOfEliminatedSubexpressions_ = 0;
+
     std::size_t currentRedBlockId_ = 0;
     std::size_t nextRedBlockId_ = 0;
     std::vector<std::pair<std::size_t, std::size_t>> redBlockRange_;
     std::set<std::size_t> redBlockDependencies_;
 };
 
+/*! Dead node elimination: returns for each node required to compute one of the given output nodes the maximum
+    required node taking it as an argument (0 if there is none), and ComputationGraph::nan for nodes that are not
+    required. The result can be passed to forwardEvaluation() to skip the evaluation of the latter nodes. */
+std::vector<std::size_t> deadNodeElimination(const ComputationGraph& g, const std::vector<bool>& outputNodes);
+
+/*! Writes the graph to a binary file, so that it can be reused in a later run with unchanged portfolio and
+    configuration. Only the structure of the graph is stored, the values of the constants, variables (e.g. model
+    parameters, which can be looked up by name in variables()) and random variates have to be populated again. */
+void saveComputationGraph(const ComputationGraph& g, const std::string& fileName);
+
+//! Reads a graph written by saveComputationGraph()
+void loadComputationGraph(ComputationGraph& g, const std::string& fileName);
+
 // methods to construct cg
 
 std::size_t cg_const(ComputationGraph& g, const double value);
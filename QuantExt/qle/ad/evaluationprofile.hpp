@@ -0,0 +1,77 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/ad/evaluationprofile.hpp
+    \brief evaluation time and node counts by op and by region of a computation graph
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace QuantExt {
+
+/*! Accumulates the evaluation time and the number of evaluated nodes by op id and by region, see forwardEvaluation().
+    The region of a node is given by nodeRegion, if this is not empty, and by its red block id otherwise. The region
+    names are optional and used for reporting only. The number of flops of a node is estimated by the number of
+    samples, i.e. one flop per sample. */
+struct EvaluationProfile {
+    struct Entry {
+        std::size_t numberOfNodes = 0;
+        double nanoSeconds = 0.0;
+    };
+
+    explicit EvaluationProfile(const std::size_t samples = 1) : samples(samples) {}
+
+    void add(const std::size_t opId, const std::size_t region, const double nanoSeconds) {
+        if (opId >= byOpId.size())
+            byOpId.resize(opId + 1);
+        if (region >= byRegion.size())
+            byRegion.resize(region + 1);
+        byOpId[opId].numberOfNodes++;
+        byOpId[opId].nanoSeconds += nanoSeconds;
+        byRegion[region].numberOfNodes++;
+        byRegion[region].nanoSeconds += nanoSeconds;
+    }
+
+    void merge(const EvaluationProfile& p) {
+        if (p.byOpId.size() > byOpId.size())
+            byOpId.resize(p.byOpId.size());
+        if (p.byRegion.size() > byRegion.size())
+            byRegion.resize(p.byRegion.size());
+        for (std::size_t i = 0; i < p.byOpId.size(); ++i) {
+            byOpId[i].numberOfNodes += p.byOpId[i].numberOfNodes;
+            byOpId[i].nanoSeconds += p.byOpId[i].nanoSeconds;
+        }
+        for (std::size_t i = 0; i < p.byRegion.size(); ++i) {
+            byRegion[i].numberOfNodes += p.byRegion[i].numberOfNodes;
+            byRegion[i].nanoSeconds += p.byRegion[i].nanoSeconds;
+        }
+    }
+
+    double flops(const Entry& e) const { return static_cast<double>(e.numberOfNodes) * static_cast<double>(samples); }
+
+    std::size_t samples;
+    std::vector<std::size_t> nodeRegion;
+    std::vector<std::string> regionNames;
+    std::vector<Entry> byOpId, byRegion;
+};
+
+} // namespace QuantExt
@@ -26,6 +26,8 @@
 
 #include <ql/shared_ptr.hpp>
 
+#include <functional>
+
 namespace QuantExt {
 
 /* Note: This formulation assumes a separate forward run to calculate the values. We could combine the calculation of
@@ -93,4 +95,101 @@ void forwardDerivatives(const ComputationGraph& g, const std::vector<T>& values,
     }             // for node
 }
 
+/* Vector forward mode: evaluates the values and the derivatives in several tangent directions in a single sweep over
+   the graph, so that the values of red blocks or other deleted nodes are not required to be kept. derivatives[d]
+   holds the tangents of direction d (of size g.size()) and must be populated with the seeds on the input nodes,
+   uninitialised tangents are treated as zero and are not propagated. The gradients of an op are evaluated once per
+   node and applied to all directions, which makes this cheap for a small number of directions and a large number of
+   outputs.
+
+   Values and tangents of nodes no longer needed are deleted, unless they are marked in keepNodes. activeNodes has the
+   same meaning as in forwardEvaluation(). */
+template <class T>
+void forwardEvaluationAndDerivatives(
+    const ComputationGraph& g, std::vector<T>& values, std::vector<std::vector<T>>& derivatives,
+    const std::vector<std::function<T(const std::vector<const T*>&)>>& ops,
+    const std::vector<std::function<std::vector<T>(const std::vector<const T*>&, const T*)>>& grad,
+    std::function<void(T&)> deleter = {}, const std::vector<bool>& keepNodes = {},
+    const std::size_t conditionalExpectationOpId = 0,
+    const std::function<T(const std::vector<const T*>&)>& conditionalExpectation = {},
+    const std::vector<std::size_t>& activeNodes = {}) {
+
+    for (auto const& d : derivatives) {
+        QL_REQUIRE(d.size() == g.size(), "forwardEvaluationAndDerivatives(): derivatives size ("
+                                             << d.size() << ") does not match graph size (" << g.size() << ")");
+    }
+
+    std::vector<const T*> args, derivativeArgs;
+
+    for (std::size_t node = 0; node < g.size(); ++node) {
+
+        if (!activeNodes.empty() && activeNodes[node] == ComputationGraph::nan)
+            continue;
+
+        const std::vector<std::size_t>& pred = g.predecessors(node);
+        if (pred.empty())
+            continue;
+
+        // evaluate the node
+
+        args.resize(pred.size());
+        for (std::size_t arg = 0; arg < pred.size(); ++arg)
+            args[arg] = &values[pred[arg]];
+
+        values[node] = ops[g.opId(node)](args);
+
+        QL_REQUIRE(values[node].initialised(), "forwardEvaluationAndDerivatives(): value at active node "
+                                                   << node << " is not initialized, opId = " << g.opId(node));
+
+        // propagate the tangents, the regressors of a conditional expectation are treated as fixed
+
+        bool hasTangent = false;
+        for (auto const& d : derivatives) {
+            for (auto p : pred)
+                hasTangent = hasTangent || d[p].initialised();
+        }
+
+        if (hasTangent) {
+            if (g.opId(node) == conditionalExpectationOpId && conditionalExpectation) {
+                derivativeArgs = args;
+                for (auto& d : derivatives) {
+                    if (!d[pred[0]].initialised())
+                        continue;
+                    derivativeArgs[0] = &d[pred[0]];
+                    d[node] = conditionalExpectation(derivativeArgs);
+                }
+            } else {
+                auto gr = grad[g.opId(node)](args, &values[node]);
+                for (auto& d : derivatives) {
+                    for (std::size_t arg = 0; arg < pred.size(); ++arg) {
+                        if (!d[pred[arg]].initialised())
+                            continue;
+                        if (d[node].initialised())
+                            d[node] += d[pred[arg]] * gr[arg];
+                        else
+                            d[node] = d[pred[arg]] * gr[arg];
+                    }
+                }
+            }
+        }
+
+        // delete the values and tangents of the predecessors that are no longer needed
+
+        if (deleter) {
+            for (auto p : pred) {
+                if ((activeNodes.empty() ? g.maxNodeRequiringArg(p) : activeNodes[p]) > node)
+                    continue;
+                if (!keepNodes.empty() && keepNodes[p])
+                    continue;
+                if (values[p].initialised())
+                    deleter(values[p]);
+                for (auto& d : derivatives) {
+                    if (d[p].initialised())
+                        deleter(d[p]);
+                }
+            }
+        }
+    }
+}
+
 } // namespace QuantExt
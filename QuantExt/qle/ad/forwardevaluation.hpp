@@ -23,11 +23,92 @@
 #pragma once
 
 #include <qle/ad/computationgraph.hpp>
+#include <qle/ad/evaluationprofile.hpp>
 
 #include <ql/shared_ptr.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+
 namespace QuantExt {
 
+namespace detail {
+
+/* the node requirements only depend on the op and the number of args, we cache them, since evaluating them
+   allocates and they are needed for every arg of every node in the forward evaluation */
+class OpRequirementsCache {
+public:
+    explicit OpRequirementsCache(
+        const std::vector<std::function<std::pair<std::vector<bool>, bool>(const std::size_t)>>& op)
+        : op_(op) {}
+    const std::pair<std::vector<bool>, bool>& operator()(const std::size_t opId, const std::size_t nArgs) {
+        if (opId >= cache_.size())
+            cache_.resize(opId + 1);
+        auto& c = cache_[opId];
+        if (nArgs >= c.size())
+            c.resize(nArgs + 1);
+        if (!c[nArgs])
+            c[nArgs] = std::make_unique<std::pair<std::vector<bool>, bool>>(op_[opId](nArgs));
+        return *c[nArgs];
+    }
+
+private:
+    const std::vector<std::function<std::pair<std::vector<bool>, bool>(const std::size_t)>>& op_;
+    std::vector<std::vector<std::unique_ptr<std::pair<std::vector<bool>, bool>>>> cache_;
+};
+
+/* Returns groups of consecutive red blocks [first, second) (as indices into g.redBlockRanges()) within
+   [startNode, endNode), such that the blocks in a group only depend on nodes before the start of the group, on
+   input nodes (i.e. nodes without predecessors, which are not computed in the forward evaluation) and on nodes of
+   their own block. The blocks in such a group can be evaluated independently of each other. Only groups with at
+   least two blocks are returned. */
+inline std::vector<std::pair<std::size_t, std::size_t>>
+independentRedBlockGroups(const ComputationGraph& g, const std::size_t startNode, const std::size_t endNode) {
+    const auto& ranges = g.redBlockRanges();
+    auto blockIsIndependent = [&g](const std::pair<std::size_t, std::size_t>& range, const std::size_t groupStart) {
+        for (std::size_t node = range.first; node < range.second; ++node) {
+            for (auto p : g.predecessors(node)) {
+                if (p >= groupStart && p < range.first && !g.predecessors(p).empty())
+                    return false;
+            }
+        }
+        return true;
+    };
+    std::vector<std::pair<std::size_t, std::size_t>> groups;
+    std::size_t k = 0;
+    while (k < ranges.size()) {
+        if (ranges[k].first < startNode || ranges[k].second > endNode) {
+            ++k;
+            continue;
+        }
+        std::size_t l = k + 1;
+        while (l < ranges.size() && ranges[l].first == ranges[l - 1].second && ranges[l].second <= endNode &&
+               blockIsIndependent(ranges[l], ranges[k].first))
+            ++l;
+        if (l - k >= 2)
+            groups.push_back(std::make_pair(k, l));
+        k = l;
+    }
+    return groups;
+}
+
+} // namespace detail
+
+/*! Evaluates the nodes in [startNode, endNode) of the graph.
+
+    If nThreads > 1, consecutive red blocks that are independent of each other (see
+    detail::independentRedBlockGroups()), e.g. the trade subgraphs built on top of a common model layer, are evaluated
+    concurrently on up to nThreads threads. The ops must be thread-safe in this case and the preDeleter is not applied
+    to nodes outside the red block of the consumer. All other nodes are evaluated sequentially in ascending order,
+    in particular reductions over the values of several red blocks (e.g. netting set sums) are evaluated after the
+    blocks in a fixed order, so that the results do not depend on nThreads.
+
+    If a profile is given, the evaluation time of each node is added to it by op id and region. */
 template <class T>
 void forwardEvaluation(const ComputationGraph& g, std::vector<T>& values,
                        const std::vector<std::function<T(const std::vector<const T*>&)>>& ops,
@@ -36,77 +117,222 @@ void forwardEvaluation(const ComputationGraph& g, std::vector<T>& values,
                            opRequiresNodesForDerivatives = {},
                        const std::vector<bool>& keepNodes = {}, const std::size_t startNode = 0,
                        const std::size_t endNode = ComputationGraph::nan, const bool redBlockReconstruction = false,
-                       std::function<void(T&)> preDeleter = {}, const std::vector<bool>& opAllowsPredeletion = {}) {
+                       std::function<void(T&)> preDeleter = {}, const std::vector<bool>& opAllowsPredeletion = {},
+                       const std::vector<std::size_t>& activeNodes = {}, const std::size_t nThreads = 1,
+                       EvaluationProfile* profile = nullptr) {
 
-    std::vector<bool> keepNodesDerivatives;
-    if (deleter && keepValuesForDerivatives)
-        keepNodesDerivatives = std::vector<bool>(g.size(), false);
+    // we use char instead of bool, so that threads evaluating different red blocks can set flags concurrently
 
-    // loop over the nodes in the graph in ascending order
+    std::vector<char> keepNodesDerivatives, checkpointNodes;
+    if (deleter && keepValuesForDerivatives) {
+        keepNodesDerivatives = std::vector<char>(g.size(), 0);
+        checkpointNodes = std::vector<char>(g.size(), 0);
+    }
 
-    for (std::size_t node = startNode; node < (endNode == ComputationGraph::nan ? g.size() : endNode); ++node) {
+    auto nodeIsKept = [&g, &keepNodes, &keepNodesDerivatives, &checkpointNodes,
+                       redBlockReconstruction](const std::size_t p) {
+        return (!keepNodes.empty() && keepNodes[p]) ||
+               (!keepNodesDerivatives.empty() && keepNodesDerivatives[p] &&
+                (g.redBlockId(p) == 0 || redBlockReconstruction || checkpointNodes[p]));
+    };
 
-        // if a node is computed by an op applied to predecessors ...
+    // flags for nodes that are shared between concurrently evaluated red blocks, see below
 
-        if (!g.predecessors(node).empty()) {
+    constexpr char flagKeep = 1, flagCheckpoint = 2, flagDelete = 4;
 
-            // evaluate the node
+    /* evaluate a single node, if deferred is given, the node belongs to a red block evaluated concurrently with other
+       blocks starting at groupStart: flags and deletions of args that might be shared with other blocks are not
+       applied but stored in deferred. The evaluation time is added to nodeProfile, if given. */
 
-            std::vector<const T*> args(g.predecessors(node).size());
-            for (std::size_t arg = 0; arg < g.predecessors(node).size(); ++arg) {
-                args[arg] = &values[g.predecessors(node)[arg]];
-            }
+    auto evaluateNode = [&](const std::size_t node, detail::OpRequirementsCache& requirements,
+                            std::vector<const T*>& args, std::vector<std::size_t>& nodesToDelete,
+                            const std::size_t groupStart, std::vector<std::pair<std::size_t, char>>* deferred,
+                            EvaluationProfile* nodeProfile) {
 
-            std::set<std::size_t> nodesToDelete;
-            if (deleter) {
-                for (std::size_t arg = 0; arg < g.predecessors(node).size(); ++arg) {
-                    std::size_t p = g.predecessors(node)[arg];
+        // skip nodes that are not required to compute the output nodes, see deadNodeElimination()
 
-                    if (!keepNodesDerivatives.empty()) {
+        if (!activeNodes.empty() && activeNodes[node] == ComputationGraph::nan)
+            return;
 
-                        // is the node required to compute derivatives, then add it to the keep nodes vector
+        const std::vector<std::size_t>& pred = g.predecessors(node);
 
-                        if (opRequiresNodesForDerivatives[g.opId(p)](args.size()).second ||
-                            opRequiresNodesForDerivatives[g.opId(node)](args.size()).first[arg])
-                            keepNodesDerivatives[p] = true;
-                    }
+        // if a node is computed by an op applied to predecessors ...
 
-                    // is the node no longer needed for the forward evaluation?
+        if (pred.empty())
+            return;
 
-                    if (g.maxNodeRequiringArg(p) > node)
-                        continue;
+        // evaluate the node
 
-                    // is the node marked as to be kept ?
+        args.resize(pred.size());
+        for (std::size_t arg = 0; arg < pred.size(); ++arg) {
+            args[arg] = &values[pred[arg]];
+        }
 
-                    if ((!keepNodes.empty() && keepNodes[p]) ||
-                        (!keepNodesDerivatives.empty() && keepNodesDerivatives[p] &&
-                         (g.redBlockId(p) == 0 || redBlockReconstruction)))
-                        continue;
+        nodesToDelete.clear();
+        if (deleter) {
+            const std::vector<bool>* nodeRequiresArg =
+                keepNodesDerivatives.empty() ? nullptr : &requirements(g.opId(node), args.size()).first;
+            for (std::size_t arg = 0; arg < pred.size(); ++arg) {
+                std::size_t p = pred[arg];
+                bool shared = deferred != nullptr && (p < groupStart || g.predecessors(p).empty());
 
-                    // apply the deleter
+                if (!keepNodesDerivatives.empty()) {
 
-                    nodesToDelete.insert(p);
+                    // is the node required to compute derivatives, then add it to the keep nodes vector
 
-                } // for arg over g.predecessors
-            }
+                    if (requirements(g.opId(p), args.size()).second || (*nodeRequiresArg)[arg]) {
+                        if (shared)
+                            deferred->push_back(std::make_pair(p, flagKeep));
+                        else
+                            keepNodesDerivatives[p] = 1;
+                    }
+
+                    // a red block node required for the derivatives of a node outside its red block is needed
+                    // in the backward sweep before its red block is reconstructed, so we keep it as a checkpoint
 
-            if (preDeleter && !opAllowsPredeletion.empty() && opAllowsPredeletion[g.opId(node)]) {
-                for(auto n: nodesToDelete)
-                    preDeleter(values[n]);
+                    if ((*nodeRequiresArg)[arg] && g.redBlockId(p) != 0 && g.redBlockId(p) != g.redBlockId(node)) {
+                        if (shared)
+                            deferred->push_back(std::make_pair(p, flagCheckpoint));
+                        else
+                            checkpointNodes[p] = 1;
+                    }
+                }
+
+                // is the node no longer needed for the forward evaluation?
+
+                if ((activeNodes.empty() ? g.maxNodeRequiringArg(p) : activeNodes[p]) > node)
+                    continue;
+
+                // a shared node is deleted after all blocks of the group are evaluated
+
+                if (shared) {
+                    deferred->push_back(std::make_pair(p, flagDelete));
+                    continue;
+                }
+
+                // is the node marked as to be kept ?
+
+                if (nodeIsKept(p))
+                    continue;
+
+                // apply the deleter, a node can appear several times as an arg
+
+                if (std::find(nodesToDelete.begin(), nodesToDelete.end(), p) == nodesToDelete.end())
+                    nodesToDelete.push_back(p);
+
+            } // for arg over g.predecessors
+        }
+
+        if (preDeleter && !opAllowsPredeletion.empty() && opAllowsPredeletion[g.opId(node)]) {
+            for (auto n : nodesToDelete)
+                preDeleter(values[n]);
+        }
+
+        std::chrono::steady_clock::time_point start;
+        if (nodeProfile)
+            start = std::chrono::steady_clock::now();
+
+        values[node] = ops[g.opId(node)](args);
+
+        if (nodeProfile) {
+            nodeProfile->add(
+                g.opId(node), profile->nodeRegion.empty() ? g.redBlockId(node) : profile->nodeRegion[node],
+                std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        QL_REQUIRE(values[node].initialised(), "forwardEvaluation(): value at active node "
+                                                   << node << " is not initialized, opId = " << g.opId(node));
+
+        if (deleter) {
+            for (auto n : nodesToDelete)
+                deleter(values[n]);
+        }
+    };
+
+    const std::size_t end = endNode == ComputationGraph::nan ? g.size() : endNode;
+    const auto& ranges = g.redBlockRanges();
+
+    // evaluate a group of independent red blocks concurrently, the blocks are distributed dynamically to the threads
+
+    auto evaluateGroup = [&](const std::pair<std::size_t, std::size_t>& group) {
+        const std::size_t groupStart = ranges[group.first].first;
+        const std::size_t nWorkers = std::min(nThreads, group.second - group.first);
+        std::atomic<std::size_t> nextBlock(group.first);
+        std::vector<std::vector<std::pair<std::size_t, char>>> deferred(nWorkers);
+        std::vector<std::exception_ptr> exceptions(nWorkers);
+        std::vector<EvaluationProfile> profiles(nWorkers, EvaluationProfile(profile ? profile->samples : 1));
+        auto worker = [&](const std::size_t w) {
+            try {
+                detail::OpRequirementsCache requirements(opRequiresNodesForDerivatives);
+                std::vector<const T*> args;
+                std::vector<std::size_t> nodesToDelete;
+                for (std::size_t b = nextBlock++; b < group.second; b = nextBlock++) {
+                    for (std::size_t node = ranges[b].first; node < ranges[b].second; ++node)
+                        evaluateNode(node, requirements, args, nodesToDelete, groupStart, &deferred[w],
+                                     profile ? &profiles[w] : nullptr);
+                }
+            } catch (...) {
+                exceptions[w] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> workers;
+        for (std::size_t w = 1; w < nWorkers; ++w)
+            workers.emplace_back(worker, w);
+        worker(0);
+        for (auto& t : workers)
+            t.join();
+        for (auto const& e : exceptions) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+        if (profile) {
+            for (auto const& p : profiles)
+                profile->merge(p);
+        }
+
+        // first apply the flags of all threads, then the deletions of the shared nodes
+
+        std::vector<std::size_t> nodesToDelete;
+        for (auto const& d : deferred) {
+            for (auto const& [p, flag] : d) {
+                if (flag == flagKeep)
+                    keepNodesDerivatives[p] = 1;
+                else if (flag == flagCheckpoint)
+                    checkpointNodes[p] = 1;
+                else if (flag == flagDelete)
+                    nodesToDelete.push_back(p);
             }
+        }
+        std::sort(nodesToDelete.begin(), nodesToDelete.end());
+        nodesToDelete.erase(std::unique(nodesToDelete.begin(), nodesToDelete.end()), nodesToDelete.end());
+        for (auto p : nodesToDelete) {
+            if (!nodeIsKept(p))
+                deleter(values[p]);
+        }
+    };
 
-            values[node] = ops[g.opId(node)](args);
+    std::vector<std::pair<std::size_t, std::size_t>> groups;
+    if (nThreads > 1)
+        groups = detail::independentRedBlockGroups(g, startNode, end);
 
-            QL_REQUIRE(values[node].initialised(), "forwardEvaluation(): value at active node "
-                                                       << node << " is not initialized, opId = " << g.opId(node));
+    // buffers reused for all nodes, so that the loop below does not allocate once they reached their max size
 
-            if(deleter) {
-                for(auto n: nodesToDelete)
-                    deleter(values[n]);
-            }
+    detail::OpRequirementsCache requirements(opRequiresNodesForDerivatives);
+    std::vector<const T*> args;
+    std::vector<std::size_t> nodesToDelete;
+
+    // loop over the nodes in the graph in ascending order
 
-        }     // if !g.predecessors empty
-    }         // for node
+    std::size_t currentGroup = 0;
+    for (std::size_t node = startNode; node < end; ++node) {
+        if (currentGroup < groups.size() && node == ranges[groups[currentGroup].first].first) {
+            evaluateGroup(groups[currentGroup]);
+            node = ranges[groups[currentGroup].second - 1].second - 1;
+            ++currentGroup;
+            continue;
+        }
+        evaluateNode(node, requirements, args, nodesToDelete, 0, nullptr, profile);
+    }
 }
 
 } // namespace QuantExt
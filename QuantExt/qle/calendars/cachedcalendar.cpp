@@ -0,0 +1,70 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/calendars/cachedcalendar.hpp>
+
+#include <ql/errors.hpp>
+
+using namespace QuantLib;
+
+namespace QuantExt {
+
+CachedCalendar::Impl::Impl(const Calendar& calendar, const std::vector<Calendar>& underlyings, Year firstYear,
+                           Year lastYear)
+    : calendar_(calendar), underlyings_(underlyings) {
+    QL_REQUIRE(firstYear <= lastYear,
+               "CachedCalendar: first year (" << firstYear << ") must not be after last year (" << lastYear << ")");
+    firstSerial_ = Date(1, January, firstYear).serialNumber();
+    lastSerial_ = Date(31, December, lastYear).serialNumber();
+    businessDays_.resize(lastSerial_ - firstSerial_ + 1);
+    for (Date::serial_type s = firstSerial_; s <= lastSerial_; ++s)
+        businessDays_[s - firstSerial_] = calendar_.isBusinessDay(Date(s));
+    for (auto const& c : underlyings_)
+        amendments_.push_back(std::make_pair(c.addedHolidays().size(), c.removedHolidays().size()));
+}
+
+std::string CachedCalendar::Impl::name() const { return calendar_.name(); }
+
+bool CachedCalendar::Impl::isWeekend(Weekday w) const { return calendar_.isWeekend(w); }
+
+bool CachedCalendar::Impl::amended() const {
+    for (Size i = 0; i < underlyings_.size(); ++i) {
+        if (underlyings_[i].addedHolidays().size() != amendments_[i].first ||
+            underlyings_[i].removedHolidays().size() != amendments_[i].second)
+            return true;
+    }
+    return false;
+}
+
+bool CachedCalendar::Impl::isBusinessDay(const Date& date) const {
+    Date::serial_type s = date.serialNumber();
+    if (s < firstSerial_ || s > lastSerial_ || amended())
+        return calendar_.isBusinessDay(date);
+    return businessDays_[s - firstSerial_];
+}
+
+CachedCalendar::CachedCalendar(const Calendar& calendar, Year firstYear, Year lastYear) {
+    impl_ = ext::make_shared<CachedCalendar::Impl>(calendar, std::vector<Calendar>{calendar}, firstYear, lastYear);
+}
+
+CachedCalendar::CachedCalendar(const std::vector<Calendar>& calendars, JointCalendarRule rule, Year firstYear,
+                               Year lastYear) {
+    impl_ = ext::make_shared<CachedCalendar::Impl>(JointCalendar(calendars, rule), calendars, firstYear, lastYear);
+}
+
+} // namespace QuantExt
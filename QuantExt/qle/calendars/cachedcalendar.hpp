@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file cachedcalendar.hpp
+    \brief Calendar with precomputed business days
+*/
+
+#ifndef quantext_cached_calendar_h
+#define quantext_cached_calendar_h
+
+#include <ql/time/calendar.hpp>
+#include <ql/time/calendars/jointcalendar.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace QuantExt {
+
+//! Calendar with precomputed business days
+/*! The business days of the underlying calendar are evaluated once for the years firstYear to lastYear and stored in
+    a bitmap, so that isBusinessDay() and everything built on it (adjust, advance, businessDaysBetween) costs a lookup
+    instead of the holiday rule evaluation. Dates outside the range are forwarded to the underlying calendar.
+
+    The calendar has the name of the underlying calendar. Holidays added to or removed from the cached calendar are
+    taken into account as for any other calendar. If holidays are added to or removed from the underlying calendar
+    (resp. one of the joint calendars) after construction, the bitmap is outdated and the cached calendar forwards all
+    calls to the underlying calendar.
+
+    \ingroup calendars
+*/
+class CachedCalendar : public QuantLib::Calendar {
+private:
+    class Impl : public Calendar::Impl {
+    public:
+        Impl(const QuantLib::Calendar& calendar, const std::vector<QuantLib::Calendar>& underlyings,
+             QuantLib::Year firstYear, QuantLib::Year lastYear);
+        std::string name() const override;
+        bool isWeekend(QuantLib::Weekday) const override;
+        bool isBusinessDay(const QuantLib::Date&) const override;
+
+    private:
+        bool amended() const;
+
+        QuantLib::Calendar calendar_;
+        // the calendars whose added and removed holidays are monitored
+        std::vector<QuantLib::Calendar> underlyings_;
+        std::vector<std::pair<QuantLib::Size, QuantLib::Size>> amendments_;
+        QuantLib::Date::serial_type firstSerial_, lastSerial_;
+        std::vector<bool> businessDays_;
+    };
+
+public:
+    //! Cache the business days of the given calendar
+    CachedCalendar(const QuantLib::Calendar& calendar, QuantLib::Year firstYear = 1990,
+                   QuantLib::Year lastYear = 2100);
+    //! Cache the business days of the joint calendar of the given calendars
+    CachedCalendar(const std::vector<QuantLib::Calendar>& calendars,
+                   QuantLib::JointCalendarRule rule = QuantLib::JoinHolidays, QuantLib::Year firstYear = 1990,
+                   QuantLib::Year lastYear = 2100);
+};
+
+} // namespace QuantExt
+
+#endif
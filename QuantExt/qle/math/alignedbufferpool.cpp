@@ -0,0 +1,122 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/math/alignedbufferpool.hpp>
+#include <qle/utilities/memoryaccounting.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/align/aligned_alloc.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace QuantExt {
+
+namespace {
+
+// the buffers obtained from the system, whether in use or cached
+MemoryAccount& poolAccount() {
+    static MemoryAccount& account = MemoryAccounting::instance().account("RandomVariablePool");
+    return account;
+}
+
+std::size_t bucketSize(const std::size_t bytes) {
+    return (bytes + AlignedBufferPool::alignment - 1) / AlignedBufferPool::alignment * AlignedBufferPool::alignment;
+}
+
+struct ThreadBufferCache {
+    ~ThreadBufferCache();
+    void clear();
+    std::unordered_map<std::size_t, std::vector<void*>> freeLists;
+    std::size_t cachedBytes = 0;
+};
+
+/* Set when the thread local cache is destroyed. Objects with static storage duration might release buffers after
+   that point, these are then returned to the system directly. The flag is trivially destructible and thus remains
+   valid during the whole thread lifetime. */
+thread_local bool cacheDestroyed = false;
+
+ThreadBufferCache::~ThreadBufferCache() {
+    clear();
+    cacheDestroyed = true;
+}
+
+void ThreadBufferCache::clear() {
+    for (auto& f : freeLists) {
+        for (auto p : f.second)
+            boost::alignment::aligned_free(p);
+        poolAccount().release(f.first * f.second.size());
+    }
+    freeLists.clear();
+    cachedBytes = 0;
+}
+
+ThreadBufferCache& threadBufferCache() {
+    thread_local ThreadBufferCache cache;
+    return cache;
+}
+
+} // namespace
+
+void* AlignedBufferPool::allocate(const std::size_t bytes) {
+    QL_REQUIRE(bytes > 0, "AlignedBufferPool::allocate(): bytes must be positive");
+    std::size_t size = bucketSize(bytes);
+    if (!cacheDestroyed) {
+        auto& cache = threadBufferCache();
+        auto f = cache.freeLists.find(size);
+        if (f != cache.freeLists.end() && !f->second.empty()) {
+            void* p = f->second.back();
+            f->second.pop_back();
+            cache.cachedBytes -= size;
+            return p;
+        }
+    }
+    poolAccount().allocate(size);
+    void* p = boost::alignment::aligned_alloc(alignment, size);
+    if (p == nullptr) {
+        poolAccount().release(size);
+        QL_FAIL("AlignedBufferPool::allocate(): failed to allocate " << size << " bytes");
+    }
+    return p;
+}
+
+void AlignedBufferPool::deallocate(void* p, const std::size_t bytes) {
+    if (p == nullptr)
+        return;
+    std::size_t size = bucketSize(bytes);
+    if (!cacheDestroyed) {
+        auto& cache = threadBufferCache();
+        if (cache.cachedBytes + size <= maxCachedBytes) {
+            cache.freeLists[size].push_back(p);
+            cache.cachedBytes += size;
+            return;
+        }
+    }
+    boost::alignment::aligned_free(p);
+    poolAccount().release(size);
+}
+
+void AlignedBufferPool::releaseCachedBuffers() {
+    if (!cacheDestroyed)
+        threadBufferCache().clear();
+}
+
+std::size_t AlignedBufferPool::cachedBytes() { return cacheDestroyed ? 0 : threadBufferCache().cachedBytes; }
+
+} // namespace QuantExt
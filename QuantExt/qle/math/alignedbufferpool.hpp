@@ -0,0 +1,59 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/math/alignedbufferpool.hpp
+    \brief thread local pool of aligned buffers
+    \ingroup math
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace QuantExt {
+
+//! Thread local pool of 64-byte aligned buffers
+/*! Buffers are bucketed by their size rounded up to a multiple of the alignment. Released buffers are kept in a
+    free list of the releasing thread and handed out again by subsequent requests for the same bucket, so that
+    repeated allocations of equally sized buffers (e.g. the sample buffers of RandomVariable) do not hit the heap in
+    steady state. A buffer may be released by a different thread than the one it was obtained from.
+
+    The total size of the buffers cached by a thread is limited by maxCachedBytes, buffers released beyond that limit
+    are returned to the system. */
+class AlignedBufferPool {
+public:
+    static constexpr std::size_t alignment = 64;
+    static constexpr std::size_t maxCachedBytes = 256 * 1024 * 1024;
+
+    //! obtain a buffer of at least the given number of bytes, bytes must be positive
+    static void* allocate(const std::size_t bytes);
+    //! release a buffer, bytes must be the value passed to allocate()
+    static void deallocate(void* p, const std::size_t bytes);
+    //! return all cached buffers of the calling thread to the system
+    static void releaseCachedBuffers();
+    //! total size of the buffers cached by the calling thread
+    static std::size_t cachedBytes();
+
+    //! typed convenience wrappers
+    template <class T> static T* allocate(const std::size_t n) { return static_cast<T*>(allocate(n * sizeof(T))); }
+    template <class T> static void deallocate(T* p, const std::size_t n) {
+        deallocate(static_cast<void*>(p), n * sizeof(T));
+    }
+};
+
+} // namespace QuantExt
@@ -17,8 +17,11 @@
 */
 
 #include <qle/math/basiccpuenvironment.hpp>
+#include <qle/math/floatrandomvariable.hpp>
 #include <qle/math/randomvariable.hpp>
+#include <qle/math/randomvariable_fused.hpp>
 #include <qle/math/randomvariable_io.hpp>
+#include <qle/math/randomvariable_jit.hpp>
 #include <qle/math/randomvariable_opcodes.hpp>
 #include <qle/math/randomvariable_ops.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
@@ -31,11 +34,30 @@
 #include <boost/algorithm/string/join.hpp>
 #include <boost/timer/timer.hpp>
 
+#include <thread>
+#include <type_traits>
+
 namespace QuantExt {
 
+namespace {
+RandomVariable applyOp(const RandomVariableOp& op, const std::vector<const RandomVariable*>& args) { return op(args); }
+
+FloatRandomVariable applyOp(const RandomVariableOp& op, const std::vector<const FloatRandomVariable*>& args) {
+    std::vector<RandomVariable> tmp;
+    for (auto const& a : args)
+        tmp.push_back(a->toRandomVariable());
+    std::vector<const RandomVariable*> tmpArgs;
+    for (auto const& t : tmp)
+        tmpArgs.push_back(&t);
+    return FloatRandomVariable(op(tmpArgs));
+}
+} // namespace
+
 class BasicCpuContext : public ComputeContext {
 public:
-    BasicCpuContext();
+    /*! If jit is true, the chains of elementwise ops are compiled to native code when a calculation is executed the
+        first time in double precision, see RandomVariableJitModule. */
+    explicit BasicCpuContext(const bool jit = false);
     ~BasicCpuContext() override final;
     void init() override final;
 
@@ -60,6 +82,17 @@ public:
 private:
     enum class ComputeState { idle, createInput, createVariates, calc };
 
+    template <class V>
+    void executeProgram(std::vector<V>& values, std::vector<V>& variates, const std::vector<RandomVariableOp>& ops);
+
+    // a chain of elementwise ops in the program, with the variable ids of its inputs and outputs
+    struct FusedChain {
+        FusedRandomVariableKernel kernel;
+        std::vector<std::size_t> inputIds;
+        std::vector<std::size_t> outputIds;
+        Size jitIndex = Null<Size>();
+    };
+
     class program {
     public:
         program() {}
@@ -85,6 +118,7 @@ private:
     };
 
     bool initialized_ = false;
+    bool jit_;
 
     // will be accumulated over all calcs
     ComputeContext::DebugInfo debugInfo_;
@@ -100,6 +134,11 @@ private:
     std::vector<std::size_t> numberOfVars_;
     std::vector<std::vector<std::size_t>> outputVars_;
 
+    // 1b fused chains by their first instruction and the compiled chains per current calc id
+
+    std::vector<std::map<Size, FusedChain>> fusedChains_;
+    std::vector<std::unique_ptr<RandomVariableJitModule>> jitModule_;
+
     // 2 curent calc
 
     std::size_t currentId_ = 0;
@@ -110,6 +149,11 @@ private:
     std::vector<RandomVariable> values_;
     std::vector<std::size_t> freedVariables_;
 
+    // values and variates in single precision, if settings.useSinglePrecisionOnCpu is true
+
+    std::vector<FloatRandomVariable> floatValues_;
+    std::vector<FloatRandomVariable> floatVariates_;
+
     // shared random variates for all calcs
 
     std::unique_ptr<QuantLib::MersenneTwisterUniformRng> rng_;
@@ -117,7 +161,11 @@ private:
     std::vector<RandomVariable> variates_;
 };
 
-BasicCpuFramework::BasicCpuFramework() { contexts_["BasicCpu/Default/Default"] = new BasicCpuContext(); }
+BasicCpuFramework::BasicCpuFramework() {
+    contexts_["BasicCpu/Default/Default"] = new BasicCpuContext();
+    if (RandomVariableJitModule::available())
+        contexts_["BasicCpu/Jit/Default"] = new BasicCpuContext(true);
+}
 
 BasicCpuFramework::~BasicCpuFramework() {
     for (auto& [_, c] : contexts_) {
@@ -125,7 +173,7 @@ BasicCpuFramework::~BasicCpuFramework() {
     }
 }
 
-BasicCpuContext::BasicCpuContext() : initialized_(false) {}
+BasicCpuContext::BasicCpuContext(const bool jit) : initialized_(false), jit_(jit) {}
 
 BasicCpuContext::~BasicCpuContext() {}
 
@@ -136,6 +184,7 @@ void BasicCpuContext::init() {
     }
 
     debugInfo_.numberOfOperations = 0;
+    debugInfo_.numberOfOperationsByOpCode.clear();
     debugInfo_.nanoSecondsDataCopy = 0;
     debugInfo_.nanoSecondsProgramBuild = 0;
     debugInfo_.nanoSecondsCalculation = 0;
@@ -146,6 +195,8 @@ void BasicCpuContext::init() {
 void BasicCpuContext::disposeCalculation(const std::size_t id) {
     QL_REQUIRE(!disposed_[id - 1], "BasicCpuContext::disposeCalculation(): id " << id << " was already disposed.");
     program_[id - 1].clear();
+    fusedChains_[id - 1].clear();
+    jitModule_[id - 1].reset();
     disposed_[id - 1] = true;
 }
 
@@ -169,6 +220,8 @@ std::pair<std::size_t, bool> BasicCpuContext::initiateCalculation(const std::siz
         numberOfVariates_.push_back(0);
         numberOfVars_.push_back(0);
         outputVars_.push_back({});
+        fusedChains_.push_back({});
+        jitModule_.push_back(nullptr);
 
         currentId_ = size_.size();
         newCalc_ = true;
@@ -192,6 +245,8 @@ std::pair<std::size_t, bool> BasicCpuContext::initiateCalculation(const std::siz
             numberOfVariates_[id - 1] = 0;
             numberOfVars_[id - 1] = 0;
             outputVars_[id - 1].clear();
+            fusedChains_[id - 1].clear();
+            jitModule_[id - 1].reset();
             newCalc_ = true;
         }
 
@@ -295,8 +350,10 @@ std::size_t BasicCpuContext::applyOperation(const std::size_t randomVariableOpCo
 
     // update num of ops in debug info
 
-    if (settings_.debug)
+    if (settings_.debug) {
         debugInfo_.numberOfOperations += 1 * size_[currentId_ - 1];
+        debugInfo_.numberOfOperationsByOpCode[randomVariableOpCode] += 1 * size_[currentId_ - 1];
+    }
 
     // return result id
 
@@ -327,6 +384,168 @@ void BasicCpuContext::declareOutputVariable(const std::size_t id) {
     outputVars_[currentId_ - 1].push_back(id);
 }
 
+template <class V>
+void BasicCpuContext::executeProgram(std::vector<V>& values, std::vector<V>& variates,
+                                     const std::vector<RandomVariableOp>& ops) {
+
+    const auto& p = program_[currentId_ - 1];
+
+    // liveness info: the next instruction reading the result of an instruction and whether an instruction is the
+    // last one writing to its result id
+
+    Size nIds = numberOfInputVars_[currentId_ - 1] + numberOfVariates_[currentId_ - 1] + numberOfVars_[currentId_ - 1];
+    std::vector<Size> nextRead(p.size(), Null<Size>());
+    std::vector<bool> lastWrite(p.size(), false);
+    {
+        std::vector<Size> pendingRead(nIds, Null<Size>());
+        std::vector<bool> written(nIds, false);
+        for (Size i = p.size(); i > 0; --i) {
+            Size r = p.resultId(i - 1);
+            nextRead[i - 1] = pendingRead[r];
+            lastWrite[i - 1] = !written[r];
+            pendingRead[r] = Null<Size>();
+            written[r] = true;
+            for (auto const& a : p.args(i - 1))
+                pendingRead[a] = i - 1;
+        }
+    }
+
+    std::vector<bool> isOutput(nIds, false);
+    for (auto const& id : outputVars_[currentId_ - 1])
+        isOutput[id] = true;
+
+    // map variable ids to values resp. variates
+
+    auto variable = [this, &values, &variates](const std::size_t id) -> V* {
+        if (id < numberOfInputVars_[currentId_ - 1])
+            return &values[id];
+        else if (id < numberOfInputVars_[currentId_ - 1] + numberOfVariates_[currentId_ - 1])
+            return &variates[id - numberOfInputVars_[currentId_ - 1]];
+        else
+            return &values[id - numberOfVariates_[currentId_ - 1]];
+    };
+
+    auto result = [this, &values](const std::size_t id) -> V& {
+        if (id < numberOfInputVars_[currentId_ - 1])
+            return values[id];
+        else if (id >= numberOfInputVars_[currentId_ - 1] + numberOfVariates_[currentId_ - 1])
+            return values[id - numberOfVariates_[currentId_ - 1]];
+        else {
+            QL_FAIL("BasiCpuContext::finalizeCalculation(): internal error, result id "
+                    << id << " does not fall into values array.");
+        }
+    };
+
+    // the fused chains are evaluated multi-threaded, each thread processing a contiguous range of samples
+
+    Size nThreads = settings_.nThreads == 0 ? std::max<Size>(1, std::thread::hardware_concurrency()) : settings_.nThreads;
+
+    // the chain of elementwise ops [begin, end), built on first use and kept for replays of the calculation
+
+    auto& chains = fusedChains_[currentId_ - 1];
+
+    auto fusedChain = [&p, &nextRead, &lastWrite, &isOutput, &chains](const Size begin, const Size end) -> FusedChain& {
+        if (auto c = chains.find(begin); c != chains.end())
+            return c->second;
+        std::map<std::size_t, Size> slot;
+        std::set<std::size_t> written;
+        std::vector<std::size_t> inputIds;
+        for (Size i = begin; i < end; ++i) {
+            for (auto const& a : p.args(i)) {
+                if (written.find(a) == written.end() && slot.find(a) == slot.end()) {
+                    slot[a] = inputIds.size();
+                    inputIds.push_back(a);
+                }
+            }
+            written.insert(p.resultId(i));
+        }
+        FusedChain chain{FusedRandomVariableKernel(inputIds.size()), inputIds, {}};
+        for (Size i = begin; i < end; ++i) {
+            std::vector<Size> args;
+            for (auto const& a : p.args(i))
+                args.push_back(slot.at(a));
+            Size s = chain.kernel.add(p.op(i), args);
+            slot[p.resultId(i)] = s;
+            if ((nextRead[i] != Null<Size>() && nextRead[i] >= end) || (lastWrite[i] && isOutput[p.resultId(i)])) {
+                chain.kernel.markOutput(s);
+                chain.outputIds.push_back(p.resultId(i));
+            }
+        }
+        return chains.emplace(begin, std::move(chain)).first->second;
+    };
+
+    /* evaluate a chain of elementwise ops in a single pass, returns false if this is not possible because an input is
+       not initialised */
+
+    auto& jitModule = jitModule_[currentId_ - 1];
+
+    auto executeFused = [&variable, &result, &jitModule, nThreads](const FusedChain& chain) {
+        std::vector<const V*> inputs;
+        for (auto const& id : chain.inputIds) {
+            inputs.push_back(variable(id));
+            if (!inputs.back()->initialised())
+                return false;
+        }
+        std::vector<V> res;
+        if constexpr (std::is_same_v<V, RandomVariable>) {
+            if (chain.jitIndex != Null<Size>())
+                res = jitModule->evaluate(chain.jitIndex, inputs, nThreads);
+        }
+        if (res.empty())
+            res = chain.kernel.evaluate(inputs, nThreads);
+        for (Size j = 0; j < chain.outputIds.size(); ++j)
+            result(chain.outputIds[j]) = std::move(res[j]);
+        return true;
+    };
+
+    constexpr Size minFusedOps = std::is_same_v<V, FloatRandomVariable> ? 1 : 2;
+
+    auto chainEnd = [&p](const Size begin) {
+        Size end = begin;
+        while (end < p.size() && isFusableRandomVariableOpCode(p.op(end)))
+            ++end;
+        return end;
+    };
+
+    // compile the chains to native code on the first execution in double precision
+
+    if constexpr (std::is_same_v<V, RandomVariable>) {
+        if (jit_ && jitModule == nullptr) {
+            boost::timer::cpu_timer timer;
+            jitModule = std::make_unique<RandomVariableJitModule>();
+            for (Size i = 0; i < p.size();) {
+                Size end = chainEnd(i);
+                if (end >= i + minFusedOps) {
+                    FusedChain& chain = fusedChain(i, end);
+                    if (!chain.outputIds.empty())
+                        chain.jitIndex = jitModule->add(chain.kernel);
+                }
+                i = std::max(end, i + 1);
+            }
+            if (jitModule->size() > 0)
+                jitModule->compile();
+            if (settings_.debug)
+                debugInfo_.nanoSecondsProgramBuild += timer.elapsed().wall;
+        }
+    }
+
+    /* execute calculation, chains of elementwise ops are fused; in single precision each elementwise op is evaluated
+       by the fused kernel and the other ops are applied to the inputs converted to double precision */
+
+    for (Size i = 0; i < p.size();) {
+        Size end = chainEnd(i);
+        if (end >= i + minFusedOps && executeFused(fusedChain(i, end))) {
+            i = end;
+            continue;
+        }
+        std::vector<const V*> args(p.args(i).size());
+        for (Size j = 0; j < p.args(i).size(); ++j)
+            args[j] = variable(p.args(i)[j]);
+        result(p.resultId(i)) = applyOp(ops[p.op(i)], args);
+        ++i;
+    }
+}
+
 void BasicCpuContext::finalizeCalculation(std::vector<double*>& output) {
     struct exitGuard {
         exitGuard() {}
@@ -342,63 +561,61 @@ void BasicCpuContext::finalizeCalculation(std::vector<double*>& output) {
                    << output.size() << ") inconsistent to kernel output size (" << outputVars_[currentId_ - 1].size()
                    << ")");
 
-    const auto& p = program_[currentId_ - 1];
-
     auto ops = getRandomVariableOps(size_[currentId_ - 1], settings_.regressionOrder);
 
     // resize values vector to required size
 
     values_.resize(numberOfInputVars_[currentId_ - 1] + numberOfVars_[currentId_ - 1]);
 
-    // execute calculation
-
-    for (Size i = 0; i < program_[currentId_ - 1].size(); ++i) {
-        std::vector<const RandomVariable*> args(p.args(i).size());
-        for (Size j = 0; j < p.args(i).size(); ++j) {
-            if (p.args(i)[j] < numberOfInputVars_[currentId_ - 1])
-                args[j] = &values_[p.args(i)[j]];
-            else if (p.args(i)[j] < numberOfInputVars_[currentId_ - 1] + numberOfVariates_[currentId_ - 1])
-                args[j] = &variates_[p.args(i)[j] - numberOfInputVars_[currentId_ - 1]];
-            else
-                args[j] = &values_[p.args(i)[j] - numberOfVariates_[currentId_ - 1]];
-        }
-        if (p.resultId(i) < numberOfInputVars_[currentId_ - 1])
-            values_[p.resultId(i)] = ops[p.op(i)](args);
-        else if (p.resultId(i) >= numberOfInputVars_[currentId_ - 1] + numberOfVariates_[currentId_ - 1])
-            values_[p.resultId(i) - numberOfVariates_[currentId_ - 1]] = ops[p.op(i)](args);
-        else {
-            QL_FAIL("BasiCpuContext::finalizeCalculation(): internal error, result id "
-                    << p.resultId(i) << " does not fall into values array.");
-        }
-    }
-
     // fill output
 
-    for (Size i = 0; i < outputVars_[currentId_ - 1].size(); ++i) {
-        std::size_t id = outputVars_[currentId_ - 1][i];
-        RandomVariable* v;
-        if (id < numberOfInputVars_[currentId_ - 1])
-            v = &values_[id];
-        else if (id < numberOfInputVars_[currentId_ - 1] + numberOfVariates_[currentId_ - 1]) {
-            v = &variates_[id - numberOfInputVars_[currentId_ - 1]];
-        }
-        else
-            v = &values_[id - numberOfVariates_[currentId_ - 1]];
-        for (Size j = 0; j < size_[currentId_ - 1]; ++j) {
-            output[i][j] = v->operator[](j);
+    auto fillOutput = [this, &output](const auto& values, const auto& variates) {
+        for (Size i = 0; i < outputVars_[currentId_ - 1].size(); ++i) {
+            std::size_t id = outputVars_[currentId_ - 1][i];
+            const auto* v = values.data();
+            if (id < numberOfInputVars_[currentId_ - 1])
+                v = &values[id];
+            else if (id < numberOfInputVars_[currentId_ - 1] + numberOfVariates_[currentId_ - 1]) {
+                v = &variates[id - numberOfInputVars_[currentId_ - 1]];
+            } else
+                v = &values[id - numberOfVariates_[currentId_ - 1]];
+            for (Size j = 0; j < size_[currentId_ - 1]; ++j) {
+                output[i][j] = v->operator[](j);
+            }
         }
+    };
+
+    // execute calculation in double or single precision
+
+    if (!settings_.useSinglePrecisionOnCpu) {
+        executeProgram(values_, variates_, ops);
+        fillOutput(values_, variates_);
+    } else {
+        floatValues_.resize(values_.size());
+        for (Size i = 0; i < numberOfInputVars_[currentId_ - 1]; ++i)
+            floatValues_[i] = FloatRandomVariable(values_[i]);
+        for (Size i = floatVariates_.size(); i < variates_.size(); ++i)
+            floatVariates_.push_back(FloatRandomVariable(variates_[i]));
+        executeProgram(floatValues_, floatVariates_, ops);
+        fillOutput(floatValues_, floatVariates_);
     }
 }
 
 const ComputeContext::DebugInfo& BasicCpuContext::debugInfo() const { return debugInfo_; }
 
-std::set<std::string> BasicCpuFramework::getAvailableDevices() const { return {"BasicCpu/Default/Default"}; }
+std::set<std::string> BasicCpuFramework::getAvailableDevices() const {
+    std::set<std::string> result;
+    for (auto const& [name, _] : contexts_)
+        result.insert(name);
+    return result;
+}
 
 ComputeContext* BasicCpuFramework::getContext(const std::string& deviceName) {
-    QL_REQUIRE(deviceName == "BasicCpu/Default/Default",
-               "BasicCpuFramework::getContext(): device '"
-                   << deviceName << "' not supported. Available device is 'BasicCpu/Default/Default'.");
-    return contexts_[deviceName];
+    auto c = contexts_.find(deviceName);
+    QL_REQUIRE(c != contexts_.end(), "BasicCpuFramework::getContext(): device '"
+                                         << deviceName << "' not supported. Available devices are '"
+                                         << boost::algorithm::join(getAvailableDevices(), "', '") << "'.");
+    return c->second;
 }
 
 }; // namespace QuantExt
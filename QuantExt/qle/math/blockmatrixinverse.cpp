@@ -19,6 +19,7 @@
 #include <qle/math/blockmatrixinverse.hpp>
 
 #include <boost/numeric/ublas/lu.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
 
 using namespace boost::numeric::ublas;
 
@@ -48,13 +49,23 @@ bool isNull(const QuantLib::SparseMatrix& A) {
 
 QuantLib::SparseMatrix inverse(QuantLib::SparseMatrix m) {
     QL_REQUIRE(m.size1() == m.size2(), "matrix is not square");
+    // the factorisation is done on a dense copy, since the fill-in makes it slow on the compressed storage
+    boost::numeric::ublas::matrix<Real> lu(m);
     boost::numeric::ublas::permutation_matrix<Size> pert(m.size1());
     // lu decomposition
-    const Size singular = lu_factorize(m, pert);
+    const Size singular = lu_factorize(lu, pert);
     QL_REQUIRE(singular == 0, "singular matrix given");
-    QuantLib::SparseMatrix inverse = boost::numeric::ublas::identity_matrix<Real>(m.size1());
+    boost::numeric::ublas::matrix<Real> inv = boost::numeric::ublas::identity_matrix<Real>(m.size1());
     // backsubstitution
-    boost::numeric::ublas::lu_substitute(m, pert, inverse);
+    boost::numeric::ublas::lu_substitute(lu, pert, inv);
+    // copy the non-zero entries, row by row so that the compressed storage is only appended to
+    QuantLib::SparseMatrix inverse(m.size1(), m.size2());
+    for (Size i = 0; i < inv.size1(); ++i) {
+        for (Size j = 0; j < inv.size2(); ++j) {
+            if (inv(i, j) != 0.0)
+                inverse.push_back(i, j, inv(i, j));
+        }
+    }
     return inverse;
 }
 
@@ -179,29 +190,33 @@ QuantLib::SparseMatrix blockMatrixInverse(const QuantLib::SparseMatrix& A, const
     QuantLib::SparseMatrix a2 = aInv - p2;
     axpy_prod(-schurCompInv, tmp, c2);
 
-    QuantLib::SparseMatrix res(n, n);
+    // assemble the result in coordinate format, inserting the blocks into the compressed storage directly would
+    // move the existing entries for each entry of the right blocks
+
+    coordinate_matrix<Real> tmpRes(n, n, a2.nnz() + b2.nnz() + c2.nnz() + schurCompInv.nnz());
 
     for (auto i1 = a2.begin1(); i1 != a2.end1(); ++i1) {
         for (auto i2 = i1.begin(); i2 != i1.end(); ++i2) {
-            res(i2.index1(), i2.index2()) = *i2;
+            tmpRes.append_element(i2.index1(), i2.index2(), *i2);
         }
     }
     for (auto i1 = b2.begin1(); i1 != b2.end1(); ++i1) {
         for (auto i2 = i1.begin(); i2 != i1.end(); ++i2) {
-            res(i2.index1(), i2.index2() + m) = *i2;
+            tmpRes.append_element(i2.index1(), i2.index2() + m, *i2);
         }
     }
     for (auto i1 = c2.begin1(); i1 != c2.end1(); ++i1) {
         for (auto i2 = i1.begin(); i2 != i1.end(); ++i2) {
-            res(i2.index1() + m, i2.index2()) = *i2;
+            tmpRes.append_element(i2.index1() + m, i2.index2(), *i2);
         }
     }
     for (auto i1 = schurCompInv.begin1(); i1 != schurCompInv.end1(); ++i1) {
         for (auto i2 = i1.begin(); i2 != i1.end(); ++i2) {
-            res(i2.index1() + m, i2.index2() + m) = *i2;
+            tmpRes.append_element(i2.index1() + m, i2.index2() + m, *i2);
         }
     }
 
+    QuantLib::SparseMatrix res(tmpRes);
     return res;
 } // blockMatrixInverse(SparseMatrix)
 
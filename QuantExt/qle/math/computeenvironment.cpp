@@ -17,8 +17,12 @@
 */
 
 #include <qle/math/computeenvironment.hpp>
+#include <qle/math/multidevicecomputecontext.hpp>
 
+#include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/join.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
 
 #include <ql/errors.hpp>
 
@@ -29,6 +33,9 @@ ComputeEnvironment::ComputeEnvironment() { reset(); }
 ComputeEnvironment::~ComputeEnvironment() { releaseFrameworks(); }
 
 void ComputeEnvironment::releaseFrameworks() {
+    for (auto& [_, c] : multiDeviceContexts_)
+        delete c;
+    multiDeviceContexts_.clear();
     for (auto& f : frameworks_)
         delete f;
     frameworks_.clear();
@@ -53,19 +60,37 @@ std::set<std::string> ComputeEnvironment::getAvailableDevices() const {
 
 bool ComputeEnvironment::hasContext() const { return currentContext_ != nullptr; }
 
+ComputeContext* ComputeEnvironment::getContext(const std::string& deviceName) {
+    for (auto& f : frameworks_) {
+        if (auto tmp = f->getAvailableDevices(); tmp.find(deviceName) != tmp.end())
+            return f->getContext(deviceName);
+    }
+    QL_FAIL("ComputeEnvironment::selectContext(): device '"
+            << deviceName << "' not found. Available devices: " << boost::join(getAvailableDevices(), ","));
+}
+
 void ComputeEnvironment::selectContext(const std::string& deviceName) {
     if (currentContextDeviceName_ == deviceName)
         return;
-    for (auto& f : frameworks_) {
-        if (auto tmp = f->getAvailableDevices(); tmp.find(deviceName) != tmp.end()) {
-            currentContext_ = f->getContext(deviceName);
-            currentContext_->init();
-            currentContextDeviceName_ = deviceName;
-            return;
+    if (deviceName.find(';') == std::string::npos) {
+        currentContext_ = getContext(deviceName);
+    } else {
+        // a list of devices separated by ';', the samples are partitioned over these devices
+        auto c = multiDeviceContexts_.find(deviceName);
+        if (c == multiDeviceContexts_.end()) {
+            std::vector<std::string> names;
+            boost::split(names, deviceName, boost::is_any_of(";"));
+            std::vector<ComputeContext*> devices;
+            for (auto& n : names) {
+                boost::trim(n);
+                devices.push_back(getContext(n));
+            }
+            c = multiDeviceContexts_.insert(std::make_pair(deviceName, new MultiDeviceComputeContext(devices))).first;
         }
+        currentContext_ = c->second;
     }
-    QL_FAIL("ComputeEnvironment::selectContext(): device '"
-            << deviceName << "' not found. Available devices: " << boost::join(getAvailableDevices(), ","));
+    currentContext_->init();
+    currentContextDeviceName_ = deviceName;
 }
 
 ComputeContext& ComputeEnvironment::context() { return *currentContext_; }
@@ -29,6 +29,7 @@
 #include <boost/thread/shared_mutex.hpp>
 
 #include <cstdint>
+#include <map>
 #include <set>
 
 namespace QuantExt {
@@ -48,8 +49,10 @@ public:
 
 private:
     void releaseFrameworks();
+    ComputeContext* getContext(const std::string& deviceName);
 
     std::vector<ComputeFramework*> frameworks_;
+    std::map<std::string, ComputeContext*> multiDeviceContexts_;
     ComputeContext* currentContext_;
     std::string currentContextDeviceName_;
 };
@@ -65,13 +68,17 @@ class ComputeContext {
 public:
     struct Settings {
         Settings()
-            : debug(false), useDoublePrecision(false), rngSequenceType(QuantExt::SequenceType::MersenneTwister),
-              rngSeed(42), regressionOrder(4) {}
+            : debug(false), useDoublePrecision(false), useSinglePrecisionOnCpu(false),
+              rngSequenceType(QuantExt::SequenceType::MersenneTwister), rngSeed(42), regressionOrder(4), nThreads(1) {}
         bool debug;
         bool useDoublePrecision;
+        // cpu based contexts calculate in double precision unless this is set, useDoublePrecision is not used by them
+        bool useSinglePrecisionOnCpu;
         QuantExt::SequenceType rngSequenceType;
         std::size_t rngSeed;
         std::size_t regressionOrder;
+        // number of threads used by cpu based contexts, 0 means use the hardware concurrency
+        std::size_t nThreads;
     };
 
     struct DebugInfo {
@@ -79,6 +86,8 @@ public:
         unsigned long nanoSecondsDataCopy = 0;
         unsigned long nanoSecondsProgramBuild = 0;
         unsigned long nanoSecondsCalculation = 0;
+        // number of operations (as above) by random variable op code
+        std::map<std::size_t, unsigned long> numberOfOperationsByOpCode;
     };
 
     virtual ~ComputeContext() {}
@@ -25,6 +25,8 @@
 
 #include <ql/math/matrixutilities/pseudosqrt.hpp>
 
+#include <algorithm>
+
 namespace QuantExt {
 
 using QuantLib::Matrix;
@@ -64,4 +66,26 @@ struct SpectralCovarianceSalvage : public CovarianceSalvage {
     }
 };
 
+/*! Implementation that salvages with the given method and keeps the result for the last input matrix, so that
+    several calls with the same matrix, e.g. VaR numbers for several confidence levels, salvage it only once. The
+    given method must outlive this object, which is not thread-safe. */
+struct CachingCovarianceSalvage : public CovarianceSalvage {
+    explicit CachingCovarianceSalvage(const CovarianceSalvage& sal) : sal_(sal) {}
+    std::pair<Matrix, Matrix> salvage(const Matrix& m) const override {
+        if (!cached_ || m.rows() != input_.rows() || m.columns() != input_.columns() ||
+            !std::equal(m.begin(), m.end(), input_.begin())) {
+            result_ = sal_.salvage(m);
+            input_ = m;
+            cached_ = true;
+        }
+        return result_;
+    }
+
+private:
+    const CovarianceSalvage& sal_;
+    mutable bool cached_ = false;
+    mutable Matrix input_;
+    mutable std::pair<Matrix, Matrix> result_;
+};
+
 } // namespace QuantExt
@@ -0,0 +1,1451 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/math/cudaenvironment.hpp>
+#include <qle/math/randomvariable.hpp>
+#include <qle/math/randomvariable_opcodes.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/algorithm/string/join.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <set>
+
+#ifdef ORE_ENABLE_CUDA
+#include <nvrtc.h>
+#endif
+
+#define ORE_CUDA_MAX_N_DEV_INFO 1024U
+#define ORE_CUDA_MAX_BUILD_LOG_LOGFILE 1024U
+#define ORE_CUDA_BLOCK_SIZE 256U
+
+namespace QuantExt {
+
+#ifdef ORE_ENABLE_CUDA
+namespace {
+std::string errorText(CUresult err) {
+    const char* name;
+    const char* description;
+    if (cuGetErrorName(err, &name) != CUDA_SUCCESS)
+        return "unknown cuda error code " + std::to_string(err);
+    if (cuGetErrorString(err, &description) != CUDA_SUCCESS)
+        return std::string(name);
+    return std::string(name) + " (" + std::string(description) + ")";
+}
+
+std::string errorText(nvrtcResult err) { return std::string(nvrtcGetErrorString(err)); }
+
+// makes the given context current on the calling thread for the lifetime of the guard
+struct ContextGuard {
+    explicit ContextGuard(CUcontext context) {
+        CUresult err = cuCtxPushCurrent(context);
+        QL_REQUIRE(err == CUDA_SUCCESS, "CudaContext: error during cuCtxPushCurrent(): " << errorText(err));
+    }
+    ~ContextGuard() {
+        CUcontext tmp;
+        cuCtxPopCurrent(&tmp);
+    }
+};
+
+Size gridSize(const Size n) { return (n + ORE_CUDA_BLOCK_SIZE - 1) / ORE_CUDA_BLOCK_SIZE; }
+
+} // namespace
+
+class CudaContext : public ComputeContext {
+public:
+    CudaContext(CUdevice device, CUcontext context, const std::vector<std::pair<std::string, std::string>>& deviceInfo,
+                const bool supportsDoublePrecision);
+    ~CudaContext() override final;
+    void init() override final;
+
+    std::pair<std::size_t, bool> initiateCalculation(const std::size_t n, const std::size_t id = 0,
+                                                     const std::size_t version = 0,
+                                                     const Settings settings = {}) override final;
+    void disposeCalculation(const std::size_t n) override final;
+    std::size_t createInputVariable(double v) override final;
+    std::size_t createInputVariable(double* v) override final;
+    std::vector<std::vector<std::size_t>> createInputVariates(const std::size_t dim,
+                                                              const std::size_t steps) override final;
+    std::size_t applyOperation(const std::size_t randomVariableOpCode,
+                               const std::vector<std::size_t>& args) override final;
+    void freeVariable(const std::size_t id) override final;
+    void declareOutputVariable(const std::size_t id) override final;
+    void finalizeCalculation(std::vector<double*>& output) override final;
+
+    std::vector<std::pair<std::string, std::string>> deviceInfo() const override;
+    bool supportsDoublePrecision() const override;
+    const DebugInfo& debugInfo() const override final;
+
+private:
+    struct SSA {
+        struct ssa_entry {
+            std::string lhs_str;
+            std::optional<std::size_t> lhs_local_id;
+            std::string rhs_str;
+            std::set<std::size_t> rhs_local_id;
+            std::set<std::size_t> cond_exp_local_id;
+        };
+        void init();
+        void startNewPart();
+        void finalize();
+        std::vector<std::vector<ssa_entry>> ssa;
+        std::vector<std::set<std::size_t>> lhs_local_id;
+        std::vector<std::set<std::size_t>> rhs_local_id;
+        std::vector<std::set<std::size_t>> cond_exp_local_id;
+    };
+
+    std::size_t generateResultId();
+    std::pair<std::vector<std::string>, std::set<std::size_t>> getArgString(const std::vector<std::size_t>& args) const;
+    void startNewSsaPart();
+    std::string generateSsaCode(const std::vector<SSA::ssa_entry>& ssa) const;
+
+    void updateVariatesPool();
+
+    // compile source with nvrtc and load the resulting ptx as a module
+    CUmodule buildModule(const std::string& source, const std::string& description);
+    void launchKernel(CUfunction f, const Size n, std::vector<void*>& args, const std::string& description);
+
+    static void releaseMem(CUdeviceptr& m, const std::string& desc);
+    static void releaseModule(CUmodule& m, const std::string& desc);
+
+    enum class ComputeState { idle, createInput, createVariates, calc, declareOutput };
+
+    bool initialized_ = false;
+    CUdevice device_;   // passed from framework
+    CUcontext context_; // passed from framework (primary context of the device)
+    CUstream stream_;   // constructed per CudaContext
+
+    // set once in the ctor
+    std::vector<std::pair<std::string, std::string>> deviceInfo_;
+    bool supportsDoublePrecision_;
+    std::string gpuArchitecture_;
+
+    // will be accumulated over all calcs
+    ComputeContext::DebugInfo debugInfo_;
+
+    // 1a vectors per current calc id
+
+    std::vector<std::size_t> size_;
+    std::vector<bool> disposed_;
+    std::vector<bool> hasKernel_;
+    std::vector<std::size_t> version_;
+    std::vector<CUmodule> module_;
+    std::vector<std::vector<CUfunction>> kernel_;
+    std::vector<std::vector<std::vector<std::vector<std::size_t>>>> conditionalExpectationVarIds_;
+    std::vector<std::size_t> inputBufferSize_;
+    std::vector<std::size_t> nOutputVars_;
+    std::vector<std::vector<std::size_t>> nVars_;
+    std::vector<std::size_t> nVariates_;
+
+    // 1b variates (shared pool of mersenne twister based normal variates)
+
+    std::size_t variatesPoolSize_ = 0; // count of single random numbers
+    bool variatesPoolDoublePrecision_ = false;
+    CUdeviceptr variatesPool_;
+    CUdeviceptr variatesMtStateBuffer_;
+    CUmodule variatesModule_;
+    CUfunction variatesKernelSeedInit_;
+    CUfunction variatesKernelTwist_;
+    CUfunction variatesKernelGenerate_;
+
+    // 2 curent calc
+
+    std::size_t currentId_ = 0;
+    ComputeState currentState_ = ComputeState::idle;
+    std::size_t nVarsTmp_;
+    std::size_t nVariatesTmp_;
+    Settings settings_;
+    std::set<std::string> currentConditionalExpectationArgs_;
+
+    // 2a indexed by var id
+    std::vector<std::size_t> inputVarOffset_;
+    std::vector<bool> inputVarIsScalar_;
+    std::vector<float> inputVarValues32_;
+    std::vector<double> inputVarValues64_;
+
+    // 2b collection of variable ids
+    std::vector<std::size_t> freedVariables_;
+    std::vector<std::size_t> outputVariables_;
+
+    // 2d kernel ssa
+    SSA currentSsa_;
+};
+
+bool CudaFramework::initialized_ = false;
+boost::shared_mutex CudaFramework::mutex_;
+int CudaFramework::nDevices_ = 0;
+CUdevice CudaFramework::devices_[ORE_CUDA_MAX_N_DEVICES];
+CUcontext CudaFramework::context_[ORE_CUDA_MAX_N_DEVICES];
+std::string CudaFramework::deviceName_[ORE_CUDA_MAX_N_DEVICES];
+std::vector<std::pair<std::string, std::string>> CudaFramework::deviceInfo_[ORE_CUDA_MAX_N_DEVICES];
+bool CudaFramework::supportsDoublePrecision_[ORE_CUDA_MAX_N_DEVICES];
+
+void CudaFramework::init() {
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+
+    if (initialized_)
+        return;
+
+    initialized_ = true;
+
+    // if there is no driver or no device, we just do not provide any devices
+
+    if (cuInit(0) != CUDA_SUCCESS)
+        return;
+
+    if (cuDeviceGetCount(&nDevices_) != CUDA_SUCCESS) {
+        nDevices_ = 0;
+        return;
+    }
+
+    nDevices_ = std::min<int>(nDevices_, ORE_CUDA_MAX_N_DEVICES);
+
+    int driverVersion = 0;
+    cuDriverGetVersion(&driverVersion);
+
+    for (int d = 0; d < nDevices_; ++d) {
+        CUresult err = cuDeviceGet(&devices_[d], d);
+        QL_REQUIRE(err == CUDA_SUCCESS, "CudaFramework::init(): error during cuDeviceGet(): " << errorText(err));
+
+        char deviceName[ORE_CUDA_MAX_N_DEV_INFO];
+        cuDeviceGetName(deviceName, ORE_CUDA_MAX_N_DEV_INFO, devices_[d]);
+        int ccMajor = 0, ccMinor = 0, multiProcessors = 0;
+        cuDeviceGetAttribute(&ccMajor, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR, devices_[d]);
+        cuDeviceGetAttribute(&ccMinor, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR, devices_[d]);
+        cuDeviceGetAttribute(&multiProcessors, CU_DEVICE_ATTRIBUTE_MULTIPROCESSOR_COUNT, devices_[d]);
+        std::size_t totalMem = 0;
+        cuDeviceTotalMem(&totalMem, devices_[d]);
+
+        deviceInfo_[d].push_back(std::make_pair("device_name", std::string(deviceName)));
+        deviceInfo_[d].push_back(std::make_pair("driver_version", std::to_string(driverVersion / 1000) + "." +
+                                                                      std::to_string((driverVersion % 1000) / 10)));
+        deviceInfo_[d].push_back(
+            std::make_pair("compute_capability", std::to_string(ccMajor) + "." + std::to_string(ccMinor)));
+        deviceInfo_[d].push_back(std::make_pair("multiprocessor_count", std::to_string(multiProcessors)));
+        deviceInfo_[d].push_back(std::make_pair("total_memory", std::to_string(totalMem)));
+
+        deviceName_[d] = std::string(deviceName);
+
+        // all cuda devices with compute capability >= 1.3 support double precision
+        supportsDoublePrecision_[d] = ccMajor > 1 || (ccMajor == 1 && ccMinor >= 3);
+
+        // we use the primary context of the device, this is static and kept until program end
+
+        err = cuDevicePrimaryCtxRetain(&context_[d], devices_[d]);
+        QL_REQUIRE(err == CUDA_SUCCESS,
+                   "CudaFramework::init(): error during cuDevicePrimaryCtxRetain(): " << errorText(err));
+    }
+
+    // device names must be unique, several identical devices are distinguished by their ordinal
+
+    std::vector<std::string> names(deviceName_, deviceName_ + nDevices_);
+    for (int d = 0; d < nDevices_; ++d) {
+        if (std::count(names.begin(), names.end(), names[d]) > 1)
+            deviceName_[d] += " #" + std::to_string(d);
+    }
+}
+
+CudaFramework::CudaFramework() {
+    init();
+    for (int d = 0; d < nDevices_; ++d) {
+        contexts_["CUDA/NVIDIA/" + deviceName_[d]] =
+            new CudaContext(devices_[d], context_[d], deviceInfo_[d], supportsDoublePrecision_[d]);
+    }
+}
+
+CudaFramework::~CudaFramework() {
+    for (auto& [_, c] : contexts_) {
+        delete c;
+    }
+}
+
+CudaContext::CudaContext(CUdevice device, CUcontext context,
+                         const std::vector<std::pair<std::string, std::string>>& deviceInfo,
+                         const bool supportsDoublePrecision)
+    : initialized_(false), device_(device), context_(context), deviceInfo_(deviceInfo),
+      supportsDoublePrecision_(supportsDoublePrecision) {
+    int ccMajor = 0, ccMinor = 0;
+    cuDeviceGetAttribute(&ccMajor, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR, device_);
+    cuDeviceGetAttribute(&ccMinor, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR, device_);
+    gpuArchitecture_ = "--gpu-architecture=compute_" + std::to_string(ccMajor) + std::to_string(ccMinor);
+}
+
+CudaContext::~CudaContext() {
+    if (initialized_) {
+        ContextGuard guard(context_);
+
+        if (variatesPoolSize_ > 0) {
+            releaseMem(variatesPool_, "variates pool");
+            releaseMem(variatesMtStateBuffer_, "variates state buffer");
+            releaseModule(variatesModule_, "variates");
+        }
+
+        for (Size i = 0; i < module_.size(); ++i) {
+            if (disposed_[i] || !hasKernel_[i])
+                continue;
+            releaseModule(module_[i], "ore module");
+        }
+
+        CUresult err;
+        if (err = cuStreamDestroy(stream_); err != CUDA_SUCCESS) {
+            std::cerr << "CudaContext: error during cuStreamDestroy: " + errorText(err) << std::endl;
+        }
+    }
+}
+
+void CudaContext::releaseMem(CUdeviceptr& m, const std::string& description) {
+    CUresult err;
+    if (err = cuMemFree(m); err != CUDA_SUCCESS) {
+        std::cerr << "CudaContext: error during cuMemFree '" << description << "': " + errorText(err) << std::endl;
+    }
+}
+
+void CudaContext::releaseModule(CUmodule& m, const std::string& description) {
+    CUresult err;
+    if (err = cuModuleUnload(m); err != CUDA_SUCCESS) {
+        std::cerr << "CudaContext: error during cuModuleUnload '" << description << "': " + errorText(err)
+                  << std::endl;
+    }
+}
+
+CUmodule CudaContext::buildModule(const std::string& source, const std::string& description) {
+    nvrtcProgram program;
+    nvrtcResult err = nvrtcCreateProgram(&program, source.c_str(), description.c_str(), 0, NULL, NULL);
+    QL_REQUIRE(err == NVRTC_SUCCESS,
+               "CudaContext::buildModule(): error creating program '" << description << "': " << errorText(err));
+
+    struct ProgramDestroyer {
+        ~ProgramDestroyer() { nvrtcDestroyProgram(p); }
+        nvrtcProgram* p;
+    } programDestroyer{&program};
+
+    const char* options[] = {gpuArchitecture_.c_str(), "--std=c++17"};
+    err = nvrtcCompileProgram(program, 2, options);
+    if (err != NVRTC_SUCCESS) {
+        std::size_t logSize;
+        nvrtcGetProgramLogSize(program, &logSize);
+        std::string log(logSize, '\0');
+        nvrtcGetProgramLog(program, &log[0]);
+        QL_FAIL("CudaContext::buildModule(): error during program build for '"
+                << description << "': " << errorText(err) << ": " << log.substr(0, ORE_CUDA_MAX_BUILD_LOG_LOGFILE));
+    }
+
+    std::size_t ptxSize;
+    err = nvrtcGetPTXSize(program, &ptxSize);
+    QL_REQUIRE(err == NVRTC_SUCCESS,
+               "CudaContext::buildModule(): error getting ptx size for '" << description << "': " << errorText(err));
+    std::vector<char> ptx(ptxSize);
+    err = nvrtcGetPTX(program, &ptx[0]);
+    QL_REQUIRE(err == NVRTC_SUCCESS,
+               "CudaContext::buildModule(): error getting ptx for '" << description << "': " << errorText(err));
+
+    CUmodule module;
+    CUresult cuErr = cuModuleLoadData(&module, &ptx[0]);
+    QL_REQUIRE(cuErr == CUDA_SUCCESS,
+               "CudaContext::buildModule(): error loading module '" << description << "': " << errorText(cuErr));
+    return module;
+}
+
+void CudaContext::launchKernel(CUfunction f, const Size n, std::vector<void*>& args, const std::string& description) {
+    CUresult err = cuLaunchKernel(f, gridSize(n), 1, 1, ORE_CUDA_BLOCK_SIZE, 1, 1, 0, stream_,
+                                  args.empty() ? NULL : &args[0], NULL);
+    QL_REQUIRE(err == CUDA_SUCCESS,
+               "CudaContext: error launching kernel '" << description << "': " << errorText(err));
+}
+
+void CudaContext::init() {
+
+    if (initialized_) {
+        return;
+    }
+
+    debugInfo_.numberOfOperations = 0;
+    debugInfo_.numberOfOperationsByOpCode.clear();
+    debugInfo_.nanoSecondsDataCopy = 0;
+    debugInfo_.nanoSecondsProgramBuild = 0;
+    debugInfo_.nanoSecondsCalculation = 0;
+
+    ContextGuard guard(context_);
+
+    CUresult err = cuStreamCreate(&stream_, CU_STREAM_NON_BLOCKING);
+    QL_REQUIRE(err == CUDA_SUCCESS, "CudaContext::init(): error during cuStreamCreate(): " << errorText(err));
+
+    initialized_ = true;
+}
+
+void CudaContext::disposeCalculation(const std::size_t id) {
+    QL_REQUIRE(!disposed_[id - 1], "CudaContext::disposeCalculation(): id " << id << " was already disposed.");
+    disposed_[id - 1] = true;
+    if (hasKernel_[id - 1]) {
+        ContextGuard guard(context_);
+        releaseModule(module_[id - 1], "module id " + std::to_string(id) + " (during dispose())");
+    }
+}
+
+std::pair<std::size_t, bool> CudaContext::initiateCalculation(const std::size_t n, const std::size_t id,
+                                                              const std::size_t version, const Settings settings) {
+    QL_REQUIRE(n > 0, "CudaContext::initiateCalculation(): n must not be zero");
+
+    bool newCalc = false;
+    settings_ = settings;
+
+    if (id == 0) {
+
+        // initiate new calcaultion
+
+        size_.push_back(n);
+        disposed_.push_back(false);
+        hasKernel_.push_back(false);
+        version_.push_back(version);
+        module_.push_back(CUmodule());
+        kernel_.push_back(std::vector<CUfunction>());
+        conditionalExpectationVarIds_.push_back(std::vector<std::vector<std::vector<std::size_t>>>(1));
+        inputBufferSize_.push_back(0);
+        nOutputVars_.push_back(0);
+        nVars_.push_back(std::vector<std::size_t>());
+        nVariates_.push_back(0);
+
+        currentId_ = hasKernel_.size();
+        newCalc = true;
+
+    } else {
+
+        // initiate calculation on existing id
+
+        QL_REQUIRE(id <= hasKernel_.size(),
+                   "CudaContext::initiateCalculation(): id (" << id << ") invalid, got 1..." << hasKernel_.size());
+        QL_REQUIRE(size_[id - 1] == n, "CudaContext::initiateCalculation(): size ("
+                                           << size_[id - 1] << ") for id " << id << " does not match current size ("
+                                           << n << ")");
+        QL_REQUIRE(!disposed_[id - 1], "CudaContext::initiateCalculation(): id ("
+                                           << id << ") was already disposed, it can not be used any more.");
+
+        if (version != version_[id - 1]) {
+            if (hasKernel_[id - 1]) {
+                ContextGuard guard(context_);
+                releaseModule(module_[id - 1],
+                              "module id " + std::to_string(id) + " (during initiateCalculation, old version: " +
+                                  std::to_string(version_[id - 1]) + ", new version:" + std::to_string(version) + ")");
+            }
+            hasKernel_[id - 1] = false;
+            version_[id - 1] = version;
+            nVars_[id - 1].clear();
+            nVariates_[id - 1] = 0;
+            kernel_[id - 1].clear();
+            conditionalExpectationVarIds_[id - 1] = std::vector<std::vector<std::vector<std::size_t>>>(1);
+            newCalc = true;
+        }
+
+        currentId_ = id;
+    }
+
+    // reset variable info
+
+    nVarsTmp_ = 0;
+    nVariatesTmp_ = 0;
+
+    inputVarOffset_.clear();
+    inputVarIsScalar_.clear();
+    inputVarValues32_.clear();
+    inputVarValues64_.clear();
+
+    if (newCalc) {
+        freedVariables_.clear();
+        outputVariables_.clear();
+        currentSsa_.init();
+        currentConditionalExpectationArgs_.clear();
+    }
+
+    // set state
+
+    currentState_ = ComputeState::createInput;
+
+    // return calc id
+
+    return std::make_pair(currentId_, newCalc);
+}
+
+void CudaContext::SSA::init() {
+    ssa = std::vector<std::vector<ssa_entry>>(1);
+    lhs_local_id.clear();
+    rhs_local_id.clear();
+    cond_exp_local_id.clear();
+}
+
+void CudaContext::SSA::startNewPart() { ssa.push_back(std::vector<ssa_entry>()); }
+
+void CudaContext::SSA::finalize() {
+    for (auto const& p : ssa) {
+        lhs_local_id.push_back(std::set<std::size_t>());
+        rhs_local_id.push_back(std::set<std::size_t>());
+        cond_exp_local_id.push_back(std::set<std::size_t>());
+        for (auto const& l : p) {
+            if (l.lhs_local_id)
+                lhs_local_id.back().insert(*l.lhs_local_id);
+            rhs_local_id.back().insert(l.rhs_local_id.begin(), l.rhs_local_id.end());
+            cond_exp_local_id.back().insert(l.cond_exp_local_id.begin(), l.cond_exp_local_id.end());
+        }
+    }
+}
+
+std::size_t CudaContext::createInputVariable(double v) {
+    QL_REQUIRE(currentState_ == ComputeState::createInput,
+               "CudaContext::createInputVariable(): not in state createInput (" << static_cast<int>(currentState_)
+                                                                                << ")");
+    std::size_t nextOffset = 0;
+    if (!inputVarOffset_.empty()) {
+        nextOffset = inputVarOffset_.back() + (inputVarIsScalar_.back() ? 1 : size_[currentId_ - 1]);
+    }
+    inputVarOffset_.push_back(nextOffset);
+    inputVarIsScalar_.push_back(true);
+    if (settings_.useDoublePrecision) {
+        inputVarValues64_.push_back(v);
+    } else {
+        // ensure that v falls into the single precision range
+        inputVarValues32_.push_back((float)std::max(std::min(v, (double)std::numeric_limits<float>::max()),
+                                                    -(double)std::numeric_limits<float>::max()));
+    }
+    return nVarsTmp_++;
+}
+
+std::size_t CudaContext::createInputVariable(double* v) {
+    QL_REQUIRE(currentState_ == ComputeState::createInput,
+               "CudaContext::createInputVariable(): not in state createInput (" << static_cast<int>(currentState_)
+                                                                                << ")");
+    std::size_t nextOffset = 0;
+    if (!inputVarOffset_.empty()) {
+        nextOffset = inputVarOffset_.back() + (inputVarIsScalar_.back() ? 1 : size_[currentId_ - 1]);
+    }
+    inputVarOffset_.push_back(nextOffset);
+    inputVarIsScalar_.push_back(false);
+    for (std::size_t i = 0; i < size_[currentId_ - 1]; ++i) {
+        if (settings_.useDoublePrecision) {
+            inputVarValues64_.push_back(v[i]);
+        } else {
+            inputVarValues32_.push_back((float)std::max(std::min(v[i], (double)std::numeric_limits<float>::max()),
+                                                        -(double)std::numeric_limits<float>::max()));
+        }
+    }
+    return nVarsTmp_++;
+}
+
+void CudaContext::updateVariatesPool() {
+    QL_REQUIRE(nVariatesTmp_ > 0, "CudaContext::updateVariatesPool(): internal error, got nVariatesTmp_ == 0.");
+
+    constexpr std::size_t mt_N = 624; // mersenne twister N
+
+    std::size_t fpSize = settings_.useDoublePrecision ? sizeof(double) : sizeof(float);
+
+    QL_REQUIRE(!settings_.useDoublePrecision || supportsDoublePrecision(),
+               "CudaContext::updateVariatesPool(): double precision is configured for this calculation, but not "
+               "supported by the device. Switch to single precision or use an appropriate device.");
+
+    QL_REQUIRE(variatesPoolSize_ == 0 || variatesPoolDoublePrecision_ == settings_.useDoublePrecision,
+               "CudaContext::updateVariatesPool(): the variates pool was created with "
+                   << (variatesPoolDoublePrecision_ ? "double" : "single")
+                   << " precision, mixing single and double precision calculations on one context is not supported.");
+
+    ContextGuard guard(context_);
+
+    CUresult err;
+
+    if (variatesPoolSize_ == 0) {
+
+        // build the kernels to fill the variates pool
+
+        std::string fpTypeStr = settings_.useDoublePrecision ? "double" : "float";
+        std::string fpSuffix = settings_.useDoublePrecision ? "" : "f";
+        std::string fpMaxValue = settings_.useDoublePrecision ? "1.7976931348623157e308" : "3.4028234663852886e38f";
+
+        // clang-format off
+        // ported from from QuantLib::InverseCumulativeNormal
+        std::string sourceInvCumN = "__device__ " + fpTypeStr + " ore_invCumN(const unsigned int x0) {\n"
+            "    const " + fpTypeStr + " a1_ = -3.969683028665376e+01" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " a2_ = 2.209460984245205e+02" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " a3_ = -2.759285104469687e+02" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " a4_ = 1.383577518672690e+02" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " a5_ = -3.066479806614716e+01" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " a6_ = 2.506628277459239e+00" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " b1_ = -5.447609879822406e+01" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " b2_ = 1.615858368580409e+02" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " b3_ = -1.556989798598866e+02" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " b4_ = 6.680131188771972e+01" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " b5_ = -1.328068155288572e+01" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " c1_ = -7.784894002430293e-03" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " c2_ = -3.223964580411365e-01" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " c3_ = -2.400758277161838e+00" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " c4_ = -2.549732539343734e+00" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " c5_ = 4.374664141464968e+00" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " c6_ = 2.938163982698783e+00" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " d1_ = 7.784695709041462e-03" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " d2_ = 3.224671290700398e-01" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " d3_ = 2.445134137142996e+00" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " d4_ = 3.754408661907416e+00" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " x_low_ = 0.02425" + fpSuffix + ";\n"
+            "    const " + fpTypeStr + " x_high_ = 1.0" + fpSuffix + " - x_low_;\n"
+            "    const " + fpTypeStr + " x = ((" + fpTypeStr + ")x0 + 0.5" + fpSuffix + ") / 4294967296.0"+ fpSuffix + ";\n"
+            "    if (x < x_low_ || x_high_ < x) {\n"
+            "        if (x0 == 0xffffffffU) {\n"
+            "          return " + fpMaxValue + ";\n"
+            "        } else if(x0 == 0) {\n"
+            "          return -" + fpMaxValue + ";\n"
+            "        }\n"
+            "        " + fpTypeStr + " z;\n"
+            "        if (x < x_low_) {\n"
+            "            z = sqrt(-2.0" + fpSuffix + " * log(x));\n"
+            "            z = (((((c1_ * z + c2_) * z + c3_) * z + c4_) * z + c5_) * z + c6_) /\n"
+            "                ((((d1_ * z + d2_) * z + d3_) * z + d4_) * z + 1.0" + fpSuffix + ");\n"
+            "        } else {\n"
+            "            z = sqrt(-2.0" + fpSuffix + " * log(1.0" + fpSuffix + " - x));\n"
+            "            z = -(((((c1_ * z + c2_) * z + c3_) * z + c4_) * z + c5_) * z + c6_) /\n"
+            "                ((((d1_ * z + d2_) * z + d3_) * z + d4_) * z + 1.0" + fpSuffix + ");\n"
+            "        }\n"
+            "        return z;\n"
+            "    } else {\n"
+            "        " + fpTypeStr + " z = x - 0.5" + fpSuffix + ";\n"
+            "        " + fpTypeStr + " r = z * z;\n"
+            "        z = (((((a1_ * r + a2_) * r + a3_) * r + a4_) * r + a5_) * r + a6_) * z /\n"
+            "            (((((b1_ * r + b2_) * r + b3_) * r + b4_) * r + b5_) * r + 1.0" + fpSuffix +");\n"
+            "        return z;\n"
+            "    }\n"
+            "}\n\n";
+
+        // from QuantLib::MersenneTwisterUniformRng
+
+        std::string kernelSourceSeedInit =
+            "extern \"C\" __global__ void ore_seedInitialization(const unsigned long long s, unsigned long long* mt) {\n"
+            "  if (blockIdx.x * blockDim.x + threadIdx.x > 0) return;\n"
+            "  const unsigned long long N = 624;\n"
+            "  mt[0]= s & 0xffffffffULL;\n"
+            "  for (unsigned long long mti=1; mti<N; ++mti) {\n"
+            "    mt[mti] = (1812433253ULL * (mt[mti-1] ^ (mt[mti-1] >> 30)) + mti);\n"
+            "    mt[mti] &= 0xffffffffULL;\n"
+            "  }\n"
+            "}\n\n";
+
+        std::string kernelSourceTwist = "extern \"C\" __global__ void ore_twist(unsigned long long* mt) {\n"
+            " if (blockIdx.x * blockDim.x + threadIdx.x > 0) return;\n"
+            " const unsigned long long N = 624;\n"
+            " const unsigned long long M = 397;\n"
+            " const unsigned long long MATRIX_A = 0x9908b0dfULL;\n"
+            " const unsigned long long UPPER_MASK=0x80000000ULL;\n"
+            " const unsigned long long LOWER_MASK=0x7fffffffULL;\n"
+            " const unsigned long long mag01[2]={0x0ULL, MATRIX_A};\n"
+            " unsigned long long kk;\n"
+            " unsigned long long y;\n"
+            " for (kk=0;kk<N-M;++kk) {\n"
+            "     y = (mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK);\n"
+            "     mt[kk] = mt[kk+M] ^ (y >> 1) ^ mag01[y & 0x1ULL];\n"
+            " }\n"
+            " for (;kk<N-1;kk++) {\n"
+            "     y = (mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK);\n"
+            "     mt[kk] = mt[(kk+M)-N] ^ (y >> 1) ^ mag01[y & 0x1ULL];\n"
+            " }\n"
+            " y = (mt[N-1]&UPPER_MASK)|(mt[0]&LOWER_MASK);\n"
+            " mt[N-1] = mt[M-1] ^ (y >> 1) ^ mag01[y & 0x1ULL];\n"
+            "}\n\n";
+
+        std::string kernelSourceGenerate =
+            "extern \"C\" __global__ void ore_generate(const unsigned long long offset, unsigned long long* mt, " +
+            fpTypeStr + "* output) {\n"
+            "   unsigned long long mti = blockIdx.x * blockDim.x + threadIdx.x;\n"
+            "   if (mti >= 624) return;\n"
+            "   unsigned long long y = mt[mti];\n"
+            "   y ^= (y >> 11);\n"
+            "   y ^= (y << 7) & 0x9d2c5680ULL;\n"
+            "   y ^= (y << 15) & 0xefc60000ULL;\n"
+            "   y ^= (y >> 18);\n"
+            "   output[offset + mti] = ore_invCumN((unsigned int)y);\n"
+            "}\n\n";
+        // clang-format on
+
+        std::string programSource = sourceInvCumN + kernelSourceSeedInit + kernelSourceTwist + kernelSourceGenerate;
+
+        variatesModule_ = buildModule(programSource, "ore_variates.cu");
+
+        err = cuModuleGetFunction(&variatesKernelSeedInit_, variatesModule_, "ore_seedInitialization");
+        QL_REQUIRE(err == CUDA_SUCCESS,
+                   "CudaContext::updateVariatesPool(): error getting kernel seedInit: " << errorText(err));
+
+        err = cuModuleGetFunction(&variatesKernelTwist_, variatesModule_, "ore_twist");
+        QL_REQUIRE(err == CUDA_SUCCESS,
+                   "CudaContext::updateVariatesPool(): error getting kernel twist: " << errorText(err));
+
+        err = cuModuleGetFunction(&variatesKernelGenerate_, variatesModule_, "ore_generate");
+        QL_REQUIRE(err == CUDA_SUCCESS,
+                   "CudaContext::updateVariatesPool(): error getting kernel generate: " << errorText(err));
+
+        err = cuMemAlloc(&variatesMtStateBuffer_, sizeof(unsigned long long) * mt_N);
+        QL_REQUIRE(err == CUDA_SUCCESS,
+                   "CudaContext::updateVariatesPool(): error creating mt state buffer: " << errorText(err));
+
+        unsigned long long tmpSeed = (unsigned long long)settings_.rngSeed;
+        std::vector<void*> args = {&tmpSeed, &variatesMtStateBuffer_};
+        launchKernel(variatesKernelSeedInit_, 1, args, "ore_seedInitialization");
+
+        variatesPoolDoublePrecision_ = settings_.useDoublePrecision;
+    }
+
+    // if the variates pool is big enough, we exit early
+
+    if (variatesPoolSize_ >= nVariatesTmp_ * size_[currentId_ - 1]) {
+        err = cuStreamSynchronize(stream_);
+        QL_REQUIRE(err == CUDA_SUCCESS,
+                   "CudaContext::updateVariatesPool(): error during cuStreamSynchronize(): " << errorText(err));
+        return;
+    }
+
+    // create new buffer to hold the variates and copy the current buffer contents to the new buffer
+
+    Size alignedSize = 624 * (nVariatesTmp_ * size_[currentId_ - 1] / 624 +
+                              (nVariatesTmp_ * size_[currentId_ - 1] % 624 == 0 ? 0 : 1));
+
+    CUdeviceptr oldBuffer = variatesPool_;
+
+    struct OldBufferReleaser {
+        OldBufferReleaser(CUdeviceptr b, bool active) : b(b), active(active) {}
+        ~OldBufferReleaser() {
+            if (active)
+                CudaContext::releaseMem(b, "expired variates buffer");
+        }
+        CUdeviceptr b;
+        bool active;
+    } oldBufferReleaser(oldBuffer, variatesPoolSize_ > 0);
+
+    err = cuMemAlloc(&variatesPool_, fpSize * alignedSize);
+    QL_REQUIRE(err == CUDA_SUCCESS, "CudaContext::updateVariatesPool(): error creating variates buffer with size "
+                                        << fpSize * alignedSize << " bytes: " << errorText(err));
+    if (variatesPoolSize_ > 0) {
+        err = cuMemcpyDtoDAsync(variatesPool_, oldBuffer, fpSize * variatesPoolSize_, stream_);
+        QL_REQUIRE(err == CUDA_SUCCESS,
+                   "CudaContext::updateVariatesPool(): error copying existing variates buffer to new buffer: "
+                       << errorText(err));
+    }
+
+    // fill in the new variates, the kernels are executed in order on the stream
+
+    std::size_t currentPoolSize;
+    for (currentPoolSize = variatesPoolSize_; currentPoolSize < nVariatesTmp_ * size_[currentId_ - 1];
+         currentPoolSize += mt_N) {
+        std::vector<void*> twistArgs = {&variatesMtStateBuffer_};
+        launchKernel(variatesKernelTwist_, 1, twistArgs, "ore_twist");
+        unsigned long long offset = currentPoolSize;
+        std::vector<void*> generateArgs = {&offset, &variatesMtStateBuffer_, &variatesPool_};
+        launchKernel(variatesKernelGenerate_, mt_N, generateArgs, "ore_generate");
+    }
+
+    // wait for the kernels to finish (before the old buffer is released and the kernel args go out of scope)
+
+    err = cuStreamSynchronize(stream_);
+    QL_REQUIRE(err == CUDA_SUCCESS,
+               "CudaContext::updateVariatesPool(): error during cuStreamSynchronize(): " << errorText(err));
+
+    // update current variates pool size
+
+    QL_REQUIRE(currentPoolSize == alignedSize, "CudaContext::updateVariatesPool(): internal error, currentPoolSize = "
+                                                   << currentPoolSize << " does not match alignedSize " << alignedSize);
+    variatesPoolSize_ = currentPoolSize;
+}
+
+std::vector<std::vector<std::size_t>> CudaContext::createInputVariates(const std::size_t dim,
+                                                                       const std::size_t steps) {
+    QL_REQUIRE(currentState_ == ComputeState::createInput || currentState_ == ComputeState::createVariates,
+               "CudaContext::createInputVariates(): not in state createInput or createVariates ("
+                   << static_cast<int>(currentState_) << ")");
+    QL_REQUIRE(currentId_ > 0, "CudaContext::applyOperation(): current id is not set");
+    QL_REQUIRE(!hasKernel_[currentId_ - 1], "CudaContext::createInputVariates(): id ("
+                                                << currentId_ << ") in version " << version_[currentId_ - 1]
+                                                << " has a kernel already, input variates can not be regenerated.");
+    currentState_ = ComputeState::createVariates;
+    std::vector<std::vector<std::size_t>> resultIds(dim, std::vector<std::size_t>(steps));
+    for (std::size_t j = 0; j < steps; ++j) {
+        for (std::size_t i = 0; i < dim; ++i) {
+            resultIds[i][j] = nVarsTmp_++;
+        }
+    }
+    nVariatesTmp_ += dim * steps;
+    updateVariatesPool();
+    return resultIds;
+}
+
+std::size_t CudaContext::generateResultId() {
+    std::size_t resultId;
+    if (!freedVariables_.empty()) {
+        resultId = freedVariables_.back();
+        freedVariables_.pop_back();
+    } else {
+        resultId = nVarsTmp_++;
+    }
+    return resultId;
+}
+
+std::pair<std::vector<std::string>, std::set<std::size_t>>
+CudaContext::getArgString(const std::vector<std::size_t>& args) const {
+    std::vector<std::string> argStr(args.size());
+    std::set<std::size_t> localIds;
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        if (args[i] < inputVarOffset_.size()) {
+            argStr[i] = "input[" + std::to_string(inputVarOffset_[args[i]]) + "ULL" +
+                        (inputVarIsScalar_[args[i]] ? "]" : " + i]");
+        } else if (args[i] < inputVarOffset_.size() + nVariatesTmp_) {
+            argStr[i] =
+                "rn[" + std::to_string((args[i] - inputVarOffset_.size()) * size_[currentId_ - 1]) + "ULL + i]";
+        } else {
+            argStr[i] = "v" + std::to_string(args[i]);
+            localIds.insert(args[i]);
+        }
+    }
+    return std::make_pair(argStr, localIds);
+}
+
+void CudaContext::startNewSsaPart() {
+    currentSsa_.startNewPart();
+    conditionalExpectationVarIds_[currentId_ - 1].push_back(std::vector<std::vector<std::size_t>>());
+    nVars_[currentId_ - 1].push_back(nVarsTmp_);
+}
+
+std::size_t CudaContext::applyOperation(const std::size_t randomVariableOpCode,
+                                        const std::vector<std::size_t>& args) {
+    QL_REQUIRE(currentState_ == ComputeState::createInput || currentState_ == ComputeState::createVariates ||
+                   currentState_ == ComputeState::calc,
+               "CudaContext::applyOperation(): not in state createInput or calc (" << static_cast<int>(currentState_)
+                                                                                   << ")");
+    currentState_ = ComputeState::calc;
+    QL_REQUIRE(currentId_ > 0, "CudaContext::applyOperation(): current id is not set");
+    QL_REQUIRE(!hasKernel_[currentId_ - 1], "CudaContext::applyOperation(): id (" << currentId_ << ") in version "
+                                                                                  << version_[currentId_ - 1]
+                                                                                  << " has a kernel already.");
+
+    auto [argStr, argLocalIds] = getArgString(args);
+
+    if (std::find_if(argStr.begin(), argStr.end(), [this](const std::string& a) {
+            return currentConditionalExpectationArgs_.find(a) != currentConditionalExpectationArgs_.end();
+        }) != argStr.end()) {
+        startNewSsaPart();
+        currentConditionalExpectationArgs_.clear();
+    }
+
+    if (randomVariableOpCode == RandomVariableOpCode::ConditionalExpectation) {
+
+        std::vector<std::size_t> argIds;
+        for (std::size_t i = 0; i < argStr.size() + 1; ++i) {
+            argIds.push_back(generateResultId());
+        }
+
+        std::set<std::size_t> argIdsSet(argIds.begin(), argIds.end());
+
+        for (std::size_t i = 0; i < argStr.size() + 1; ++i) {
+            currentSsa_.ssa.back().push_back({std::string("v") + std::to_string(argIds[i]), argIds[i],
+                                              i == 0 ? "0.0" : argStr[i - 1], argLocalIds, argIdsSet});
+            currentConditionalExpectationArgs_.insert("v" + std::to_string(argIds[i]));
+        }
+
+        conditionalExpectationVarIds_[currentId_ - 1].back().push_back(argIds);
+
+        return argIds[0];
+
+    } else {
+
+        // op code is everythig but conditional expectation (i.e. a pathwise operation)
+
+        auto resultId = generateResultId();
+
+        const std::set<std::size_t>& localIds = argLocalIds;
+        auto add = [this, resultId, &localIds](const std::string& rhs) {
+            currentSsa_.ssa.back().push_back({"v" + std::to_string(resultId), resultId, rhs, localIds, {}});
+        };
+
+        switch (randomVariableOpCode) {
+        case RandomVariableOpCode::None:
+            break;
+        case RandomVariableOpCode::Add:
+            add(boost::join(argStr, "+"));
+            break;
+        case RandomVariableOpCode::Subtract:
+            add(argStr[0] + " - " + argStr[1]);
+            break;
+        case RandomVariableOpCode::Negative:
+            add("-" + argStr[0]);
+            break;
+        case RandomVariableOpCode::Mult:
+            add(argStr[0] + " * " + argStr[1]);
+            break;
+        case RandomVariableOpCode::Div:
+            add(argStr[0] + " / " + argStr[1]);
+            break;
+        case RandomVariableOpCode::IndicatorEq:
+            add("ore_indicatorEq(" + argStr[0] + "," + argStr[1] + ")");
+            break;
+        case RandomVariableOpCode::IndicatorGt:
+            add("ore_indicatorGt(" + argStr[0] + "," + argStr[1] + ")");
+            break;
+        case RandomVariableOpCode::IndicatorGeq:
+            add("ore_indicatorGeq(" + argStr[0] + "," + argStr[1] + ")");
+            break;
+        case RandomVariableOpCode::Min:
+            add("fmin(" + argStr[0] + "," + argStr[1] + ")");
+            break;
+        case RandomVariableOpCode::Max:
+            add("fmax(" + argStr[0] + "," + argStr[1] + ")");
+            break;
+        case RandomVariableOpCode::Abs:
+            add("fabs(" + argStr[0] + ")");
+            break;
+        case RandomVariableOpCode::Exp:
+            add("exp(" + argStr[0] + ")");
+            break;
+        case RandomVariableOpCode::Sqrt:
+            add("sqrt(" + argStr[0] + ")");
+            break;
+        case RandomVariableOpCode::Log:
+            add("log(" + argStr[0] + ")");
+            break;
+        case RandomVariableOpCode::Pow:
+            add("pow(" + argStr[0] + "," + argStr[1] + ")");
+            break;
+        case RandomVariableOpCode::NormalCdf:
+            add("ore_normalCdf(" + argStr[0] + ")");
+            break;
+        case RandomVariableOpCode::NormalPdf:
+            add("ore_normalPdf(" + argStr[0] + ")");
+            break;
+        default: {
+            QL_FAIL("CudaContext::applyOperation(): no implementation for op code "
+                    << randomVariableOpCode << " (" << getRandomVariableOpLabels()[randomVariableOpCode]
+                    << ") provided.");
+        }
+        } // switch random var op code
+
+        if (settings_.debug) {
+            debugInfo_.numberOfOperations += 1 * size_[currentId_ - 1];
+            debugInfo_.numberOfOperationsByOpCode[randomVariableOpCode] += 1 * size_[currentId_ - 1];
+        }
+
+        return resultId;
+    }
+}
+
+void CudaContext::freeVariable(const std::size_t id) {
+    QL_REQUIRE(currentState_ == ComputeState::calc,
+               "CudaContext::free(): not in state calc (" << static_cast<int>(currentState_) << ")");
+    QL_REQUIRE(currentId_ > 0, "CudaContext::freeVariable(): current id is not set");
+    QL_REQUIRE(!hasKernel_[currentId_ - 1], "CudaContext::freeVariable(): id ("
+                                                << currentId_ << ") in version " << version_[currentId_ - 1]
+                                                << " has a kernel already, variables can not be freed.");
+
+    // we do not free input variables, only variables that were added during the calc
+
+    if (id < inputVarOffset_.size() + nVariatesTmp_)
+        return;
+
+    freedVariables_.push_back(id);
+}
+
+void CudaContext::declareOutputVariable(const std::size_t id) {
+    QL_REQUIRE(currentState_ != ComputeState::idle, "CudaContext::declareOutputVariable(): state is idle");
+    QL_REQUIRE(currentId_ > 0, "CudaContext::declareOutputVariable(): current id not set");
+    QL_REQUIRE(!hasKernel_[currentId_ - 1], "CudaContext::declareOutputVariable(): id ("
+                                                << currentId_ << ") in version " << version_[currentId_ - 1]
+                                                << " has a kernel already, output variables can not be declared.");
+    currentState_ = ComputeState::declareOutput;
+    outputVariables_.push_back(id);
+    nOutputVars_[currentId_ - 1]++;
+
+    // if we declare a conditional expectation in the current ssa part as output, we need to create a new ssa part
+
+    if (currentConditionalExpectationArgs_.find("v" + std::to_string(id)) != currentConditionalExpectationArgs_.end()) {
+        startNewSsaPart();
+        currentConditionalExpectationArgs_.clear();
+    }
+}
+
+std::string CudaContext::generateSsaCode(const std::vector<SSA::ssa_entry>& ssa) const {
+    std::set<std::size_t> localVars;
+    for (auto const& s : ssa) {
+        localVars.insert(s.rhs_local_id.begin(), s.rhs_local_id.end());
+    }
+
+    std::string fpTypeStr = settings_.useDoublePrecision ? "double" : "float";
+
+    std::string result;
+    std::set<std::size_t> hasDeclaration;
+    for (auto const& s : ssa) {
+        if (s.lhs_local_id) {
+            if (localVars.find(*s.lhs_local_id) == localVars.end())
+                continue;
+            if (hasDeclaration.find(*s.lhs_local_id) == hasDeclaration.end()) {
+                result += fpTypeStr + " ";
+                hasDeclaration.insert(*s.lhs_local_id);
+            }
+        }
+        result += s.lhs_str + "=" + s.rhs_str + ";\n";
+    }
+    return result;
+}
+
+void CudaContext::finalizeCalculation(std::vector<double*>& output) {
+    struct exitGuard {
+        exitGuard() {}
+        ~exitGuard() {
+            *currentState = ComputeState::idle;
+            for (auto& m : mem)
+                cuMemFree(m);
+        }
+        ComputeState* currentState;
+        std::vector<CUdeviceptr> mem;
+    };
+
+    QL_REQUIRE(currentId_ > 0, "CudaContext::finalizeCalculation(): current id is not set");
+    QL_REQUIRE(output.size() == nOutputVars_[currentId_ - 1],
+               "CudaContext::finalizeCalculation(): output size ("
+                   << output.size() << ") inconsistent to kernel output size (" << nOutputVars_[currentId_ - 1] << ")");
+    QL_REQUIRE(!settings_.useDoublePrecision || supportsDoublePrecision(),
+               "CudaContext::finalizeCalculation(): double precision is configured for this calculation, but not "
+               "supported by the device. Switch to single precision or use an appropriate device.");
+
+    // the context guard must outlive the exit guard, which frees device memory
+
+    ContextGuard contextGuard(context_);
+    exitGuard guard;
+    guard.currentState = &currentState_;
+
+    // update nVars_, nVariates_ for this calculation if it was a new calculation
+
+    if (nVars_[currentId_ - 1].size() < currentSsa_.ssa.size())
+        nVars_[currentId_ - 1].push_back(nVarsTmp_);
+
+    if (nVariates_[currentId_ - 1] == 0)
+        nVariates_[currentId_ - 1] = nVariatesTmp_;
+
+    // add code to output results and finalize ssa (only once, when the kernel is generated)
+
+    if (!hasKernel_[currentId_ - 1]) {
+        for (std::size_t i = 0; i < nOutputVars_[currentId_ - 1]; ++i) {
+            std::size_t offset = i * size_[currentId_ - 1];
+            std::string output;
+            std::set<std::size_t> rhsLocalIds;
+            if (outputVariables_[i] < inputVarOffset_.size()) {
+                output = "input[" + std::to_string(inputVarOffset_[outputVariables_[i]]) + "ULL" +
+                         (inputVarIsScalar_[outputVariables_[i]] ? "]" : " + i] ");
+            } else if (outputVariables_[i] < inputVarOffset_.size() + nVariates_[currentId_ - 1]) {
+                output = "rn[" +
+                         std::to_string((outputVariables_[i] - inputVarOffset_.size()) * size_[currentId_ - 1]) +
+                         "ULL + i]";
+            } else {
+                output = "v" + std::to_string(outputVariables_[i]);
+                rhsLocalIds.insert(outputVariables_[i]);
+            }
+            currentSsa_.ssa.back().push_back(
+                {"output[" + std::to_string(offset) + "ULL + i]", std::nullopt, output, rhsLocalIds, {}});
+        }
+
+        currentSsa_.finalize();
+    }
+
+    // generate local var id mapping to values buffer offset
+
+    std::map<std::size_t, std::size_t> valuesBufferMap;
+    if (currentSsa_.ssa.size() > 1) {
+        std::set<std::size_t> allIds;
+        for (std::size_t part = 0; part < currentSsa_.ssa.size(); ++part) {
+            bool initFromValues = part > 0;
+            bool cacheToValues = part < currentSsa_.ssa.size() - 1;
+            if (initFromValues) {
+                allIds.insert(currentSsa_.rhs_local_id[part].begin(), currentSsa_.rhs_local_id[part].end());
+            }
+            if (cacheToValues) {
+                allIds.insert(currentSsa_.cond_exp_local_id[part].begin(), currentSsa_.cond_exp_local_id[part].end());
+                for (std::size_t p = part + 1; p < currentSsa_.ssa.size(); ++p)
+                    allIds.insert(currentSsa_.rhs_local_id[p].begin(), currentSsa_.rhs_local_id[p].end());
+            }
+        }
+        std::size_t counter = 0;
+        for (auto const id : allIds)
+            valuesBufferMap[id] = counter++;
+    }
+
+    // create input, values and output buffers
+
+    boost::timer::cpu_timer timer;
+    boost::timer::nanosecond_type timerBase;
+
+    std::size_t fpSize = settings_.useDoublePrecision ? sizeof(double) : sizeof(float);
+
+    if (settings_.debug) {
+        timerBase = timer.elapsed().wall;
+    }
+
+    std::size_t inputBufferSize = 0;
+    if (!inputVarOffset_.empty())
+        inputBufferSize = inputVarOffset_.back() + (inputVarIsScalar_.back() ? 1 : size_[currentId_ - 1]);
+    CUresult err;
+    CUdeviceptr inputBuffer;
+    if (inputBufferSize > 0) {
+        err = cuMemAlloc(&inputBuffer, fpSize * inputBufferSize);
+        QL_REQUIRE(err == CUDA_SUCCESS, "CudaContext::finalizeCalculation(): creating input buffer of size "
+                                            << inputBufferSize << " fails: " << errorText(err));
+        guard.mem.push_back(inputBuffer);
+    }
+
+    CUdeviceptr valuesBuffer;
+    if (!valuesBufferMap.empty()) {
+        err = cuMemAlloc(&valuesBuffer, fpSize * valuesBufferMap.size() * size_[currentId_ - 1]);
+        QL_REQUIRE(err == CUDA_SUCCESS, "CudaContext::finalizeCalculation(): creating values buffer of size "
+                                            << valuesBufferMap.size() * size_[currentId_ - 1]
+                                            << " fails: " << errorText(err));
+        guard.mem.push_back(valuesBuffer);
+    }
+
+    std::size_t outputBufferSize = nOutputVars_[currentId_ - 1] * size_[currentId_ - 1];
+    CUdeviceptr outputBuffer;
+    if (outputBufferSize > 0) {
+        err = cuMemAlloc(&outputBuffer, fpSize * outputBufferSize);
+        QL_REQUIRE(err == CUDA_SUCCESS, "CudaContext::finalizeCalculation(): creating output buffer of size "
+                                            << outputBufferSize << " fails: " << errorText(err));
+        guard.mem.push_back(outputBuffer);
+    }
+
+    if (settings_.debug) {
+        debugInfo_.nanoSecondsDataCopy += timer.elapsed().wall - timerBase;
+    }
+
+    // build kernel if necessary
+
+    if (!hasKernel_[currentId_ - 1]) {
+        std::string fpTypeStr = settings_.useDoublePrecision ? "double" : "float";
+        std::string fpEpsStr = settings_.useDoublePrecision ? "2.220446049250313e-16" : "1.1920929e-07f";
+        std::string fpSuffix = settings_.useDoublePrecision ? std::string() : "f";
+
+        // clang-format off
+        std::string kernelSource =
+            "__device__ bool ore_closeEnough(const " + fpTypeStr + " x, const " + fpTypeStr + " y) {\n"
+            "    const " + fpTypeStr + " tol = 42.0" + fpSuffix + " * " + fpEpsStr + ";\n"
+            "    " + fpTypeStr + " diff = fabs(x - y);\n"
+            "    if (x == 0.0" + fpSuffix + " || y == 0.0" + fpSuffix + ")\n"
+            "        return diff < tol * tol;\n"
+            "    return diff <= tol * fabs(x) || diff <= tol * fabs(y);\n"
+            "}\n"
+            "__device__ " + fpTypeStr + " ore_indicatorEq(const " + fpTypeStr + " x, const " + fpTypeStr + " y) "
+                "{ return ore_closeEnough(x, y) ? 1.0" + fpSuffix + " : 0.0" + fpSuffix +"; }\n\n"
+            "__device__ " + fpTypeStr + " ore_indicatorGt(const " + fpTypeStr + " x, const " + fpTypeStr + " y) "
+                "{ return x > y && !ore_closeEnough(x, y) ? 1.0" + fpSuffix + " : 0.0" + fpSuffix +"; }\n\n"
+            "__device__ " + fpTypeStr + " ore_indicatorGeq(const " + fpTypeStr + " x, const " + fpTypeStr + " y) "
+                "{ return x > y || ore_closeEnough(x, y) ? 1.0" + fpSuffix + " : 0.0" + fpSuffix +"; }\n\n"
+            "__device__ " + fpTypeStr + " ore_normalCdf(const " + fpTypeStr + " x) { return " +
+                (settings_.useDoublePrecision ? "normcdf" : "normcdff") + "(x); }\n\n"
+            "__device__ " + fpTypeStr + " ore_normalPdf(const " + fpTypeStr + " x) {\n"
+            "    " + fpTypeStr + " exponent = -(x*x)/2.0" + fpSuffix + ";\n"
+            "    return exponent <= -690.0" + fpSuffix + " ? 0.0" + fpSuffix + " : exp(exponent) * 0.3989422804014327" + fpSuffix + ";\n"
+            "}\n\n";
+        // clang-format on
+
+        std::string kernelNameStem =
+            "ore_kernel_" + std::to_string(currentId_) + "_" + std::to_string(version_[currentId_ - 1]) + "_";
+
+        for (std::size_t part = 0; part < currentSsa_.ssa.size(); ++part) {
+
+            bool initFromValues = part > 0;
+            bool cacheToValues = currentSsa_.ssa.size() > 1 && part < currentSsa_.ssa.size() - 1;
+            bool generateOutputValues = part == currentSsa_.ssa.size() - 1;
+
+            std::string kernelName = kernelNameStem + std::to_string(part);
+
+            std::vector<std::string> inputArgs;
+            if (inputBufferSize > 0)
+                inputArgs.push_back("const " + fpTypeStr + "* __restrict__ input");
+            if (nVariates_[currentId_ - 1] > 0)
+                inputArgs.push_back("const " + fpTypeStr + "* __restrict__ rn");
+            if (!valuesBufferMap.empty() && (initFromValues || cacheToValues))
+                inputArgs.push_back(fpTypeStr + "* __restrict__ values");
+            if (outputBufferSize > 0 && generateOutputValues)
+                inputArgs.push_back(fpTypeStr + "* __restrict__ output");
+
+            kernelSource += "extern \"C\" __global__ void " + kernelName + "(" + boost::join(inputArgs, ",") +
+                            ") {\n"
+                            "unsigned long long i = (unsigned long long)blockIdx.x * blockDim.x + threadIdx.x;\n"
+                            "if(i < " +
+                            std::to_string(size_[currentId_ - 1]) + "ULL) {\n";
+
+            std::vector<SSA::ssa_entry> ssa;
+
+            if (initFromValues) {
+                for (auto const i : currentSsa_.rhs_local_id[part]) {
+                    ssa.push_back({std::string("v") + std::to_string(i),
+                                   i,
+                                   std::string("values[") +
+                                       std::to_string(valuesBufferMap.at(i) * size_[currentId_ - 1]) + "ULL + i]",
+                                   {}});
+                }
+            }
+
+            ssa.insert(ssa.end(), currentSsa_.ssa[part].begin(), currentSsa_.ssa[part].end());
+
+            if (cacheToValues) {
+                std::set<std::size_t> tmp;
+                for (std::size_t p = part + 1; p < currentSsa_.ssa.size(); ++p)
+                    tmp.insert(currentSsa_.rhs_local_id[p].begin(), currentSsa_.rhs_local_id[p].end());
+                std::set<std::size_t> tmp2;
+                std::set_intersection(tmp.begin(), tmp.end(), currentSsa_.lhs_local_id[part].begin(),
+                                      currentSsa_.lhs_local_id[part].end(), std::inserter(tmp2, tmp2.end()));
+                tmp2.insert(currentSsa_.cond_exp_local_id[part].begin(), currentSsa_.cond_exp_local_id[part].end());
+                for (auto const i : tmp2) {
+                    ssa.push_back(
+                        {"values[" + std::to_string(valuesBufferMap.at(i) * size_[currentId_ - 1]) + "ULL + i]",
+                         std::nullopt,
+                         "v" + std::to_string(i),
+                         {i}});
+                }
+            }
+
+            kernelSource += generateSsaCode(ssa);
+            kernelSource += "}}\n";
+
+        } // for part
+
+        if (settings_.debug) {
+            timerBase = timer.elapsed().wall;
+        }
+
+        module_[currentId_ - 1] = buildModule(kernelSource, kernelNameStem + ".cu");
+        hasKernel_[currentId_ - 1] = true;
+
+        for (std::size_t part = 0; part < currentSsa_.ssa.size(); ++part) {
+            std::string kernelName = kernelNameStem + std::to_string(part);
+            kernel_[currentId_ - 1].push_back(CUfunction());
+            err = cuModuleGetFunction(&kernel_[currentId_ - 1].back(), module_[currentId_ - 1], kernelName.c_str());
+            QL_REQUIRE(err == CUDA_SUCCESS, "CudaContext::finalizeCalculation(): error during cuModuleGetFunction(), part #"
+                                                << part << ": " << errorText(err));
+        }
+
+        inputBufferSize_[currentId_ - 1] = inputBufferSize;
+
+        if (settings_.debug) {
+            debugInfo_.nanoSecondsProgramBuild += timer.elapsed().wall - timerBase;
+        }
+    } else {
+        QL_REQUIRE(inputBufferSize == inputBufferSize_[currentId_ - 1],
+                   "CudaContext::finalizeCalculation(): input buffer size ("
+                       << inputBufferSize << ") inconsistent to kernel input buffer size ("
+                       << inputBufferSize_[currentId_ - 1] << ")");
+    }
+
+    // write input data to input buffer (asynchronously)
+
+    if (settings_.debug) {
+        timerBase = timer.elapsed().wall;
+    }
+
+    if (inputBufferSize > 0) {
+        err = cuMemcpyHtoDAsync(inputBuffer,
+                                settings_.useDoublePrecision ? (void*)&inputVarValues64_[0]
+                                                             : (void*)&inputVarValues32_[0],
+                                fpSize * inputBufferSize, stream_);
+        QL_REQUIRE(err == CUDA_SUCCESS,
+                   "CudaContext::finalizeCalculation(): writing to input buffer fails: " << errorText(err));
+    }
+
+    if (settings_.debug) {
+        err = cuStreamSynchronize(stream_);
+        QL_REQUIRE(err == CUDA_SUCCESS, "CudaContext::cuStreamSynchronize(): error in debug mode: " << errorText(err));
+        debugInfo_.nanoSecondsDataCopy += timer.elapsed().wall - timerBase;
+    }
+
+    std::vector<double> values(valuesBufferMap.size() * size_[currentId_ - 1]);
+    std::vector<float> valuesFloat;
+    if (!settings_.useDoublePrecision) {
+        valuesFloat.resize(values.size());
+    }
+
+    for (std::size_t part = 0; part < kernel_[currentId_ - 1].size(); ++part) {
+        bool initFromValues = part > 0;
+        bool cacheToValues = currentSsa_.ssa.size() > 1 && part < currentSsa_.ssa.size() - 1;
+        bool generateOutputValues = part == currentSsa_.ssa.size() - 1;
+
+        // set kernel args
+
+        std::vector<void*> args;
+        if (inputBufferSize > 0)
+            args.push_back(&inputBuffer);
+        if (nVariates_[currentId_ - 1] > 0)
+            args.push_back(&variatesPool_);
+        if (!valuesBufferMap.empty() && (initFromValues || cacheToValues))
+            args.push_back(&valuesBuffer);
+        if (outputBufferSize > 0 && generateOutputValues)
+            args.push_back(&outputBuffer);
+
+        // execute kernel
+
+        if (settings_.debug) {
+            err = cuStreamSynchronize(stream_);
+            timerBase = timer.elapsed().wall;
+        }
+
+        launchKernel(kernel_[currentId_ - 1][part], size_[currentId_ - 1], args, "part #" + std::to_string(part));
+
+        // calculate conditional expectations, this is the variant where we do this on the host
+
+        if (kernel_[currentId_ - 1].size() > 1 && part < kernel_[currentId_ - 1].size() - 1) {
+
+            // copy values from device to host
+
+            err = cuMemcpyDtoHAsync(settings_.useDoublePrecision ? (void*)&values[0] : (void*)&valuesFloat[0],
+                                    valuesBuffer, fpSize * valuesBufferMap.size() * size_[currentId_ - 1], stream_);
+            QL_REQUIRE(err == CUDA_SUCCESS,
+                       "CudaContext::finalizeCalculation(): read values buffer fails: " << errorText(err));
+
+            err = cuStreamSynchronize(stream_);
+            QL_REQUIRE(err == CUDA_SUCCESS,
+                       "CudaContext::finalizeCalculation(): wait for read values buffer fails: " << errorText(err));
+
+            if (!settings_.useDoublePrecision) {
+                std::copy(valuesFloat.begin(), valuesFloat.end(), values.begin());
+            }
+
+            for (auto const& v : conditionalExpectationVarIds_[currentId_ - 1][part]) {
+
+                // calculate conditional expectation value
+
+                QL_REQUIRE(v.size() >= 3,
+                           "CudaContext::finalizeCalculation(): expected at least 3 varIds (2 args and 1 result) for "
+                           "conditional expectation, got "
+                               << v.size());
+
+                RandomVariable ce;
+                RandomVariable regressand(size_[currentId_ - 1],
+                                          &values[valuesBufferMap.at(v[1]) * size_[currentId_ - 1]]);
+                if (v.size() < 4) {
+                    // no regressor given -> take plain expectation
+                    ce = expectation(regressand);
+                } else {
+                    Filter filter =
+                        close_enough(RandomVariable(size_[currentId_ - 1],
+                                                    &values[valuesBufferMap.at(v[2]) * size_[currentId_ - 1]]),
+                                     RandomVariable(size_[currentId_ - 1], 1.0));
+                    std::vector<RandomVariable> regressor(v.size() - 3);
+                    for (std::size_t i = 3; i < v.size(); ++i) {
+                        regressor[i - 3] = RandomVariable(size_[currentId_ - 1],
+                                                          &values[valuesBufferMap.at(v[i]) * size_[currentId_ - 1]]);
+                    }
+
+                    ce = conditionalExpectation(regressand, vec2vecptr(regressor),
+                                                multiPathBasisSystem(regressor.size(), settings_.regressionOrder,
+                                                                     QuantLib::LsmBasisSystem::Monomial,
+                                                                     regressand.size()),
+                                                filter);
+                }
+
+                // overwrite the value
+
+                ce.expand();
+                std::copy(ce.data(), ce.data() + ce.size(), &values[valuesBufferMap.at(v[0]) * size_[currentId_ - 1]]);
+            }
+
+            if (!settings_.useDoublePrecision) {
+                std::copy(values.begin(), values.end(), valuesFloat.begin());
+            }
+
+            // copy values from host to device, the host buffer stays alive until the final synchronization
+
+            err = cuMemcpyHtoDAsync(valuesBuffer,
+                                    settings_.useDoublePrecision ? (void*)&values[0] : (void*)&valuesFloat[0],
+                                    fpSize * valuesBufferMap.size() * size_[currentId_ - 1], stream_);
+            QL_REQUIRE(err == CUDA_SUCCESS,
+                       "CudaContext::finalizeCalculation(): write values buffer fails: " << errorText(err));
+
+        } // if part > 0 (to update conditional expectation values)
+
+        if (settings_.debug) {
+            err = cuStreamSynchronize(stream_);
+            QL_REQUIRE(err == CUDA_SUCCESS,
+                       "CudaContext::cuStreamSynchronize(): error in debug mode: " << errorText(err));
+            debugInfo_.nanoSecondsCalculation += timer.elapsed().wall - timerBase;
+        }
+
+    } // for part (execute kernel part)
+
+    if (settings_.debug) {
+        timerBase = timer.elapsed().wall;
+    }
+
+    // copy the results
+
+    if (outputBufferSize > 0) {
+        std::vector<std::vector<float>> outputFloat;
+        if (!settings_.useDoublePrecision) {
+            outputFloat.resize(output.size(), std::vector<float>(size_[currentId_ - 1]));
+        }
+        for (std::size_t i = 0; i < output.size(); ++i) {
+            err = cuMemcpyDtoHAsync(settings_.useDoublePrecision ? (void*)&output[i][0] : (void*)&outputFloat[i][0],
+                                    outputBuffer + fpSize * i * size_[currentId_ - 1], fpSize * size_[currentId_ - 1],
+                                    stream_);
+            QL_REQUIRE(err == CUDA_SUCCESS,
+                       "CudaContext::finalizeCalculation(): reading from output buffer fails: " << errorText(err));
+        }
+        err = cuStreamSynchronize(stream_);
+        QL_REQUIRE(err == CUDA_SUCCESS,
+                   "CudaContext::finalizeCalculation(): wait for output buffer copy to finish fails: " << errorText(err));
+        if (!settings_.useDoublePrecision) {
+            for (std::size_t i = 0; i < output.size(); ++i) {
+                std::copy(outputFloat[i].begin(), outputFloat[i].end(), output[i]);
+            }
+        }
+    } else {
+        err = cuStreamSynchronize(stream_);
+        QL_REQUIRE(err == CUDA_SUCCESS,
+                   "CudaContext::finalizeCalculation(): wait for kernels to finish fails: " << errorText(err));
+    }
+
+    if (settings_.debug) {
+        debugInfo_.nanoSecondsDataCopy += timer.elapsed().wall - timerBase;
+    }
+}
+
+const ComputeContext::DebugInfo& CudaContext::debugInfo() const { return debugInfo_; }
+
+std::vector<std::pair<std::string, std::string>> CudaContext::deviceInfo() const { return deviceInfo_; }
+bool CudaContext::supportsDoublePrecision() const { return supportsDoublePrecision_; }
+
+#endif
+
+#ifndef ORE_ENABLE_CUDA
+CudaFramework::CudaFramework() {}
+CudaFramework::~CudaFramework() {}
+#endif
+
+std::set<std::string> CudaFramework::getAvailableDevices() const {
+    std::set<std::string> tmp;
+    for (auto const& [name, _] : contexts_)
+        tmp.insert(name);
+    return tmp;
+}
+
+ComputeContext* CudaFramework::getContext(const std::string& deviceName) {
+    auto c = contexts_.find(deviceName);
+    if (c != contexts_.end()) {
+        return c->second;
+    }
+    QL_FAIL("CudaFramework::getContext(): device '"
+            << deviceName << "' not found. Available devices: " << boost::join(getAvailableDevices(), ","));
+}
+
+} // namespace QuantExt
@@ -31,6 +31,7 @@
 #include <ql/math/matrix.hpp>
 #include <ql/math/matrixutilities/choleskydecomposition.hpp>
 #include <ql/math/matrixutilities/pseudosqrt.hpp>
+#include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
 #include <ql/math/randomnumbers/rngtraits.hpp>
 
 // fix for boost 1.64, see https://lists.boost.org/Archives/boost/2016/11/231756.php
@@ -117,13 +118,21 @@ std::vector<Real> deltaGammaVarMc(const Matrix& omega, const Array& delta, const
         double, boost::accumulators::stats<boost::accumulators::tag::tail_quantile<boost::accumulators::right> > >
         acc(boost::accumulators::tag::tail<boost::accumulators::right>::cache_size = cache);
 
+    /* with 0.5 L^T gamma L = Q diag(lambda) Q^T the pl is deltaBar^T w + sum_i lambda_i w_i^2, where
+       deltaBar = Q^T L^T delta and w = Q^T z is again a vector of independent standard normal variates, so the
+       matrix products are done once and each path only costs O(n) operations */
+    SymmetricSchurDecomposition schur(0.5 * transpose(L) * gamma * L);
+    const Array& lambda = schur.eigenvalues();
+    Array deltaBar = transpose(schur.eigenvectors()) * (transpose(L) * delta);
+
     typename RNG::rsg_type rng = RNG::make_sequence_generator(delta.size(), seed);
 
     for (Size i = 0; i < paths; ++i) {
-        std::vector<Real> seq = rng.nextSequence().value;
-        Array z(seq.begin(), seq.end());
-        Array u = L * z;
-        acc(DotProduct(u, delta) + 0.5 * DotProduct(u, gamma * u));
+        const std::vector<Real>& w = rng.nextSequence().value;
+        Real pl = 0.0;
+        for (Size j = 0; j < w.size(); ++j)
+            pl += (deltaBar[j] + lambda[j] * w[j]) * w[j];
+        acc(pl);
     }
 
     std::vector<Real> res;
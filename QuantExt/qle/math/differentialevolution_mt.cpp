@@ -39,6 +39,9 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/make_shared.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 
 namespace QuantExt {
@@ -61,6 +64,85 @@ template <class I> void randomize(I begin, I end, const MersenneTwisterUniformRn
 
 } // namespace
 
+// evaluates the cost of the members of a population, using a pool of threads that live as long as this object
+class DifferentialEvolution_MT::CostEvaluator {
+public:
+    explicit CostEvaluator(const std::vector<QuantLib::ext::shared_ptr<CostFunction>>& costFunctions)
+        : costFunctions_(costFunctions) {
+        QL_REQUIRE(!costFunctions_.empty(), "DifferentialEvolution_MT: number of available threads is zero");
+        // the calling thread uses the first cost function, the workers the remaining ones
+        for (Size i = 1; i < costFunctions_.size(); ++i)
+            workers_.emplace_back(&CostEvaluator::work, this, i);
+    }
+
+    ~CostEvaluator() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& w : workers_)
+            w.join();
+    }
+
+    void evaluate(std::vector<Candidate>& population) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            population_ = &population;
+            next_ = 0;
+            busy_ = workers_.size();
+            ++generation_;
+        }
+        start_.notify_all();
+        evaluate(0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return busy_ == 0; });
+        population_ = nullptr;
+    }
+
+private:
+    void work(const Size id) {
+        Size generation = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock, [this, generation] { return stop_ || generation_ != generation; });
+                if (stop_)
+                    return;
+                generation = generation_;
+            }
+            evaluate(id);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --busy_;
+            }
+            done_.notify_one();
+        }
+    }
+
+    void evaluate(const Size id) {
+        std::vector<Candidate>& population = *population_;
+        for (Size i = next_++; i < population.size(); i = next_++) {
+            try {
+                population[i].cost = costFunctions_[id]->value(population[i].values);
+            } catch (const std::exception&) {
+                population[i].cost = QL_MAX_REAL;
+            }
+            if (!std::isfinite(population[i].cost))
+                population[i].cost = QL_MAX_REAL;
+        }
+    }
+
+    std::vector<QuantLib::ext::shared_ptr<CostFunction>> costFunctions_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_, done_;
+    std::vector<Candidate>* population_ = nullptr;
+    std::atomic<Size> next_ = 0;
+    Size generation_ = 0, busy_ = 0;
+    bool stop_ = false;
+};
+
 bool DifferentialEvolution_MT::checkMaxTime() const {
     if (maxTime_.empty())
         return false;
@@ -103,11 +185,18 @@ EndCriteria::Type DifferentialEvolution_MT::minimize(Problem_MT& p, const EndCri
         fillInitialPopulation(population, p);
     }
 
+    // the worker pool is released when we leave this method, also if an exception is thrown
+    struct CostEvaluatorGuard {
+        ~CostEvaluatorGuard() { costEvaluator.reset(); }
+        QuantLib::ext::shared_ptr<CostEvaluator>& costEvaluator;
+    } costEvaluatorGuard{costEvaluator_};
+    costEvaluator_ = QuantLib::ext::make_shared<CostEvaluator>(p.costFunctions());
+
     updateCost(population, p);
 
     std::partial_sort(population.begin(), population.begin() + 1, population.end(), sort_by_cost());
     bestMemberEver_ = population.front();
-    Real fxOld = population.front().cost;
+    Real fxOld = bestMemberEver_.cost;
     Size iteration = 0, stationaryPointIteration = 0;
 
     // main loop - calculate consecutive emerging populations
@@ -116,7 +205,8 @@ EndCriteria::Type DifferentialEvolution_MT::minimize(Problem_MT& p, const EndCri
         std::partial_sort(population.begin(), population.begin() + 1, population.end(), sort_by_cost());
         if (population.front().cost < bestMemberEver_.cost)
             bestMemberEver_ = population.front();
-        Real fxNew = population.front().cost;
+        // stop if the best cost found so far stalls
+        Real fxNew = bestMemberEver_.cost;
         if (endCriteria.checkStationaryFunctionValue(fxOld, fxNew, stationaryPointIteration, ecType))
             break;
         fxOld = fxNew;
@@ -302,53 +392,8 @@ void DifferentialEvolution_MT::crossover(const std::vector<Candidate>& oldPopula
 }
 
 void DifferentialEvolution_MT::updateCost(std::vector<Candidate>& population, Problem_MT& p) const {
-    struct Worker {
-        Worker(std::vector<Candidate>& p, const Size s, const Size e, const QuantLib::ext::shared_ptr<CostFunction> c)
-            : population(p), start(s), end(e), costFunction(c) {}
-        void operator()() {
-            for (Size popIter = start; popIter < end; popIter++) {
-                // evaluate objective function as soon as possible to avoid unnecessary loops
-                try {
-                    population[popIter].cost = costFunction->value(population[popIter].values);
-                } catch (Error&) {
-                    population[popIter].cost = QL_MAX_REAL;
-                }
-                if (!std::isfinite(population[popIter].cost))
-                    population[popIter].cost = QL_MAX_REAL;
-            }
-        }
-        std::vector<Candidate>& population;
-        const Size start, end;
-        const QuantLib::ext::shared_ptr<CostFunction> costFunction;
-    };
-
-    Size threads = p.costFunctions().size();
-    QL_REQUIRE(threads > 0, "DifferentialEvolution_MT: number of available threads is zero");
-
-    std::vector<Size> chunks(threads, std::max<Size>(population.size() / threads, 1));
-    int rest = population.size() - threads * chunks[0];
-    do {
-        Size i = 0;
-        while (i < chunks.size() && rest > 0) {
-            chunks[i]++;
-            rest--;
-            ++i;
-        }
-    } while (rest > 0);
-
-    std::vector<QuantLib::ext::shared_ptr<std::thread>> workers(threads);
-
-    Size start = 0, end;
-    for (Size thread = 0; thread < threads; ++thread) {
-        end = std::min(start + chunks[thread], population.size());
-        Worker worker(population, start, end, p.costFunctions()[thread]);
-        workers[thread] = QuantLib::ext::make_shared<std::thread>(worker);
-        start = end;
-    }
-
-    for (Size thread = 0; thread < threads; ++thread) {
-        workers[thread]->join();
-    }
+    QL_REQUIRE(costEvaluator_, "DifferentialEvolution_MT: no cost evaluator, updateCost() called outside minimize()");
+    costEvaluator_->evaluate(population);
 }
 
 void DifferentialEvolution_MT::getCrossoverMask(std::vector<Array>& crossoverMask, std::vector<Array>& invCrossoverMask,
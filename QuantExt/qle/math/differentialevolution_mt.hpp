@@ -51,6 +51,12 @@
 namespace QuantExt {
 using namespace QuantLib;
 
+//! Multithreaded differential evolution
+/*! The cost of each generation is evaluated by a pool of worker threads, one per cost function of the problem, that
+    is started once per minimisation. The members of a generation are handed out to the workers one at a time, so
+    that the load is balanced if the cost of the evaluations differs. The minimisation stops when the best cost found
+    so far has not improved by more than the function epsilon of the end criteria for the given number of stationary
+    state iterations. */
 class DifferentialEvolution_MT : public OptimizationMethod_MT {
 public:
     using Strategy = DifferentialEvolution::Strategy;
@@ -66,6 +72,8 @@ public:
     const Configuration& configuration() const { return configuration_; }
 
 private:
+    class CostEvaluator;
+
     void updateCost(std::vector<Candidate>& population, Problem_MT& p) const;
 
     Configuration configuration_;
@@ -74,6 +82,8 @@ private:
     mutable Array currGenSizeWeights_, currGenCrossover_;
     Candidate bestMemberEver_;
     MersenneTwisterUniformRng rng_;
+    // the worker pool, only set during minimize()
+    QuantLib::ext::shared_ptr<CostEvaluator> costEvaluator_;
 
     bool checkMaxTime() const;
 
@@ -0,0 +1,60 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/math/floatrandomvariable.hpp>
+
+namespace QuantExt {
+
+FloatRandomVariable::FloatRandomVariable(const RandomVariable& r) : n_(r.size()) {
+    if (!r.initialised())
+        return;
+    if (r.deterministic()) {
+        constantData_ = static_cast<float>(r.at(0));
+    } else {
+        data_.resize(n_);
+        for (Size i = 0; i < n_; ++i)
+            data_[i] = static_cast<float>(r[i]);
+    }
+}
+
+RandomVariable FloatRandomVariable::toRandomVariable() const {
+    if (!initialised())
+        return RandomVariable();
+    if (data_.empty())
+        return RandomVariable(n_, constantData_);
+    RandomVariable r(n_, 0.0);
+    r.expand();
+    double* d = r.data();
+    for (Size i = 0; i < n_; ++i)
+        d[i] = data_[i];
+    return r;
+}
+
+float FloatRandomVariable::at(const Size i) const {
+    QL_REQUIRE(n_ > 0, "FloatRandomVariable::at(" << i << "): variable is not initialised");
+    QL_REQUIRE(i < n_, "FloatRandomVariable::at(" << i << "): out of bounds, size is " << n_);
+    return data_.empty() ? constantData_ : data_[i];
+}
+
+void FloatRandomVariable::expand() {
+    if (n_ == 0 || !data_.empty())
+        return;
+    data_.assign(n_, constantData_);
+}
+
+} // namespace QuantExt
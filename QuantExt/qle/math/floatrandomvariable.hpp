@@ -0,0 +1,63 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/math/floatrandomvariable.hpp
+    \brief random variable with single precision samples
+    \ingroup math
+*/
+
+#pragma once
+
+#include <qle/math/randomvariable.hpp>
+
+#include <vector>
+
+namespace QuantExt {
+
+//! Random variable with single precision samples
+/*! This is a storage type for single precision calculations on the cpu. Elementwise operations are evaluated on it
+    with the FusedRandomVariableKernel, all other operations (e.g. regressions) are done in double precision on the
+    RandomVariable obtained from toRandomVariable(). As for RandomVariable, a deterministic instance holds a single
+    constant value and no sample buffer. */
+class FloatRandomVariable {
+public:
+    FloatRandomVariable() = default;
+    FloatRandomVariable(const Size n, const float value) : n_(n), constantData_(value) {}
+    //! rounds the samples of r to single precision
+    explicit FloatRandomVariable(const RandomVariable& r);
+
+    //! the samples in double precision
+    RandomVariable toRandomVariable() const;
+
+    bool initialised() const { return n_ != 0; }
+    bool deterministic() const { return n_ != 0 && data_.empty(); }
+    Size size() const { return n_; }
+    float at(const Size i) const;
+    float operator[](const Size i) const { return data_.empty() ? constantData_ : data_[i]; }
+
+    void expand();
+    float* data() { return data_.empty() ? nullptr : data_.data(); }
+    const float* data() const { return data_.empty() ? nullptr : data_.data(); }
+
+private:
+    Size n_ = 0;
+    float constantData_ = 0.0f;
+    std::vector<float> data_;
+};
+
+} // namespace QuantExt
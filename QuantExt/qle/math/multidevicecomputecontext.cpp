@@ -0,0 +1,414 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/math/multidevicecomputecontext.hpp>
+#include <qle/math/randomvariable_opcodes.hpp>
+#include <qle/math/randomvariable_ops.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/timer/timer.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <set>
+#include <thread>
+
+namespace QuantExt {
+
+MultiDeviceComputeContext::MultiDeviceComputeContext(const std::vector<ComputeContext*>& devices)
+    : devices_(devices) {
+    QL_REQUIRE(!devices_.empty(), "MultiDeviceComputeContext: no devices given");
+    std::set<ComputeContext*> tmp(devices_.begin(), devices_.end());
+    distinctDevices_ = tmp.size() == devices_.size();
+}
+
+void MultiDeviceComputeContext::init() {
+    for (auto d : devices_)
+        d->init();
+}
+
+std::pair<std::size_t, bool> MultiDeviceComputeContext::initiateCalculation(const std::size_t n, const std::size_t id,
+                                                                            const std::size_t version,
+                                                                            const Settings settings) {
+    QL_REQUIRE(n > 0, "MultiDeviceComputeContext::initiateCalculation(): n must not be zero");
+
+    newCalc_ = false;
+    settings_ = settings;
+
+    if (id == 0) {
+
+        // initiate new calculation
+
+        calcs_.push_back(Calculation());
+        calcs_.back().n = n;
+        calcs_.back().version = version;
+        currentId_ = calcs_.size();
+        newCalc_ = true;
+
+    } else {
+
+        // initiate calculation on existing id
+
+        QL_REQUIRE(id <= calcs_.size(), "MultiDeviceComputeContext::initiateCalculation(): id ("
+                                            << id << ") invalid, got 1..." << calcs_.size());
+        auto& calc = calcs_[id - 1];
+        QL_REQUIRE(calc.n == n, "MultiDeviceComputeContext::initiateCalculation(): size ("
+                                    << calc.n << ") for id " << id << " does not match current size (" << n << ")");
+        QL_REQUIRE(!calc.disposed, "MultiDeviceComputeContext::initiateCalculation(): id ("
+                                       << id << ") was already disposed, it can not be used any more.");
+
+        if (version != calc.version) {
+            calc.version = version;
+            calc.hasPlan = false;
+            calc.numberOfVariates = 0;
+            calc.op.clear();
+            calc.args.clear();
+            calc.outputVars.clear();
+            newCalc_ = true;
+        }
+
+        currentId_ = id;
+    }
+
+    calcs_[currentId_ - 1].numberOfInputVars = 0;
+    values_.clear();
+
+    // split the samples into contiguous ranges, devices without samples are not used
+
+    Size nDevices = std::min(devices_.size(), n);
+    deviceOffset_.resize(nDevices);
+    deviceSize_.resize(nDevices);
+    for (Size d = 0, offset = 0; d < nDevices; ++d) {
+        deviceOffset_[d] = offset;
+        deviceSize_[d] = n / nDevices + (d < n % nDevices ? 1 : 0);
+        offset += deviceSize_[d];
+    }
+
+    currentState_ = ComputeState::createInput;
+
+    return std::make_pair(currentId_, newCalc_);
+}
+
+void MultiDeviceComputeContext::disposeCalculation(const std::size_t id) {
+    QL_REQUIRE(id > 0 && id <= calcs_.size(),
+               "MultiDeviceComputeContext::disposeCalculation(): id (" << id << ") invalid");
+    auto& calc = calcs_[id - 1];
+    QL_REQUIRE(!calc.disposed, "MultiDeviceComputeContext::disposeCalculation(): id " << id << " was already disposed.");
+    for (auto const& s : calc.segments) {
+        for (Size d = 0; d < s.deviceCalcId.size(); ++d) {
+            if (s.deviceCalcId[d] != 0)
+                devices_[d]->disposeCalculation(s.deviceCalcId[d]);
+        }
+    }
+    calc.segments.clear();
+    calc.op.clear();
+    calc.args.clear();
+    calc.disposed = true;
+}
+
+std::size_t MultiDeviceComputeContext::createInputVariable(double v) {
+    QL_REQUIRE(currentState_ == ComputeState::createInput,
+               "MultiDeviceComputeContext::createInputVariable(): not in state createInput ("
+                   << static_cast<int>(currentState_) << ")");
+    auto& calc = calcs_[currentId_ - 1];
+    values_.push_back(RandomVariable(calc.n, v));
+    return calc.numberOfInputVars++;
+}
+
+std::size_t MultiDeviceComputeContext::createInputVariable(double* v) {
+    QL_REQUIRE(currentState_ == ComputeState::createInput,
+               "MultiDeviceComputeContext::createInputVariable(): not in state createInput ("
+                   << static_cast<int>(currentState_) << ")");
+    auto& calc = calcs_[currentId_ - 1];
+    values_.push_back(RandomVariable(calc.n, v));
+    return calc.numberOfInputVars++;
+}
+
+std::vector<std::vector<std::size_t>> MultiDeviceComputeContext::createInputVariates(const std::size_t dim,
+                                                                                     const std::size_t steps) {
+    QL_REQUIRE(currentState_ == ComputeState::createInput || currentState_ == ComputeState::createVariates,
+               "MultiDeviceComputeContext::createInputVariates(): not in state createInput or createVariates ("
+                   << static_cast<int>(currentState_) << ")");
+    QL_REQUIRE(currentId_ > 0, "MultiDeviceComputeContext::createInputVariates(): current id is not set");
+    auto& calc = calcs_[currentId_ - 1];
+    QL_REQUIRE(newCalc_, "MultiDeviceComputeContext::createInputVariates(): id ("
+                             << currentId_ << ") in version " << calc.version << " is replayed.");
+    currentState_ = ComputeState::createVariates;
+
+    // same generation scheme as in the BasicCpu context
+
+    if (rng_ == nullptr) {
+        rng_ = std::make_unique<MersenneTwisterUniformRng>(settings_.rngSeed);
+    }
+
+    if (variates_.size() < calc.numberOfVariates + dim * steps) {
+        for (std::size_t i = variates_.size(); i < calc.numberOfVariates + dim * steps; ++i) {
+            variates_.push_back(RandomVariable(calc.n));
+            for (std::size_t j = 0; j < variates_.back().size(); ++j)
+                variates_.back().set(j, icn_(rng_->nextReal()));
+        }
+    }
+
+    std::vector<std::vector<std::size_t>> resultIds(dim, std::vector<std::size_t>(steps));
+    for (std::size_t i = 0; i < dim; ++i) {
+        for (std::size_t j = 0; j < steps; ++j) {
+            resultIds[i][j] = calc.numberOfInputVars + calc.numberOfVariates + j * dim + i;
+        }
+    }
+
+    calc.numberOfVariates += dim * steps;
+
+    return resultIds;
+}
+
+std::size_t MultiDeviceComputeContext::applyOperation(const std::size_t randomVariableOpCode,
+                                                      const std::vector<std::size_t>& args) {
+    QL_REQUIRE(currentState_ == ComputeState::createInput || currentState_ == ComputeState::createVariates ||
+                   currentState_ == ComputeState::calc,
+               "MultiDeviceComputeContext::applyOperation(): not in state createInput or calc ("
+                   << static_cast<int>(currentState_) << ")");
+    currentState_ = ComputeState::calc;
+    QL_REQUIRE(currentId_ > 0, "MultiDeviceComputeContext::applyOperation(): current id is not set");
+    auto& calc = calcs_[currentId_ - 1];
+    QL_REQUIRE(newCalc_, "MultiDeviceComputeContext::applyOperation(): id (" << currentId_ << ") in version "
+                                                                             << calc.version << " is replayed.");
+
+    // variables are never reused, so that each id is written exactly once
+
+    calc.op.push_back(randomVariableOpCode);
+    calc.args.push_back(args);
+
+    if (settings_.debug) {
+        debugInfo_.numberOfOperations += calc.n;
+        debugInfo_.numberOfOperationsByOpCode[randomVariableOpCode] += calc.n;
+    }
+
+    return calc.numberOfInputVars + calc.numberOfVariates + calc.op.size() - 1;
+}
+
+void MultiDeviceComputeContext::freeVariable(const std::size_t id) {
+    QL_REQUIRE(currentState_ == ComputeState::calc,
+               "MultiDeviceComputeContext::freeVariable(): not in state calc (" << static_cast<int>(currentState_)
+                                                                                << ")");
+}
+
+void MultiDeviceComputeContext::declareOutputVariable(const std::size_t id) {
+    QL_REQUIRE(currentState_ != ComputeState::idle, "MultiDeviceComputeContext::declareOutputVariable(): state is idle");
+    QL_REQUIRE(currentId_ > 0, "MultiDeviceComputeContext::declareOutputVariable(): current id not set");
+    auto& calc = calcs_[currentId_ - 1];
+    QL_REQUIRE(newCalc_, "MultiDeviceComputeContext::declareOutputVariable(): id ("
+                             << currentId_ << ") in version " << calc.version << " is replayed.");
+    calc.outputVars.push_back(id);
+}
+
+const RandomVariable& MultiDeviceComputeContext::value(const std::size_t id) const {
+    auto const& calc = calcs_[currentId_ - 1];
+    if (id >= calc.numberOfInputVars && id < calc.numberOfInputVars + calc.numberOfVariates)
+        return variates_[id - calc.numberOfInputVars];
+    return values_[id];
+}
+
+void MultiDeviceComputeContext::buildPlan(Calculation& calc) {
+
+    // split the ops into segments of pathwise ops, each followed by the conditional expectations depending on them
+
+    std::vector<Segment> segments(1);
+    for (Size i = 0; i < calc.op.size(); ++i) {
+        if (calc.op[i] == RandomVariableOpCode::ConditionalExpectation) {
+            segments.back().conditionalExpectations.push_back(i);
+        } else {
+            if (!segments.back().conditionalExpectations.empty())
+                segments.push_back(Segment());
+            segments.back().ops.push_back(i);
+        }
+    }
+
+    // the inputs of a segment are the args not computed in the segment, the outputs are the results that are read
+    // by a later segment, a conditional expectation or that are declared as output
+
+    std::size_t firstOpId = calc.numberOfInputVars + calc.numberOfVariates;
+    std::set<std::size_t> needed(calc.outputVars.begin(), calc.outputVars.end());
+    for (Size s = segments.size(); s > 0; --s) {
+        auto& seg = segments[s - 1];
+        for (auto const i : seg.conditionalExpectations)
+            needed.insert(calc.args[i].begin(), calc.args[i].end());
+        std::set<std::size_t> defined, inputs;
+        for (auto const i : seg.ops) {
+            for (auto const a : calc.args[i]) {
+                if (defined.find(a) == defined.end())
+                    inputs.insert(a);
+            }
+            defined.insert(firstOpId + i);
+        }
+        for (auto const id : defined) {
+            if (needed.find(id) != needed.end())
+                seg.outputs.push_back(id);
+        }
+        seg.inputs.assign(inputs.begin(), inputs.end());
+        needed.insert(inputs.begin(), inputs.end());
+    }
+
+    // keep the device calculations of the previous plan, dispose those that are not needed any more
+
+    for (Size s = 0; s < calc.segments.size(); ++s) {
+        for (Size d = 0; d < calc.segments[s].deviceCalcId.size(); ++d) {
+            if (s < segments.size())
+                segments[s].deviceCalcId.push_back(calc.segments[s].deviceCalcId[d]);
+            else if (calc.segments[s].deviceCalcId[d] != 0)
+                devices_[d]->disposeCalculation(calc.segments[s].deviceCalcId[d]);
+        }
+    }
+    for (auto& s : segments)
+        s.deviceCalcId.resize(devices_.size(), 0);
+
+    calc.segments.swap(segments);
+    calc.hasPlan = true;
+}
+
+void MultiDeviceComputeContext::runSegment(Calculation& calc, Segment& segment, const std::size_t d) {
+    auto* device = devices_[d];
+    std::size_t offset = deviceOffset_[d];
+    std::size_t firstOpId = calc.numberOfInputVars + calc.numberOfVariates;
+
+    auto [deviceCalcId, newDeviceCalc] =
+        device->initiateCalculation(deviceSize_[d], segment.deviceCalcId[d], calc.version, settings_);
+    segment.deviceCalcId[d] = deviceCalcId;
+
+    std::map<std::size_t, std::size_t> deviceVar;
+    for (auto const id : segment.inputs) {
+        const RandomVariable& v = value(id);
+        if (v.deterministic())
+            deviceVar[id] = device->createInputVariable(v.at(0));
+        else
+            deviceVar[id] = device->createInputVariable(const_cast<double*>(v.data()) + offset);
+    }
+
+    if (newDeviceCalc) {
+        std::vector<std::size_t> args;
+        for (auto const i : segment.ops) {
+            args.clear();
+            for (auto const a : calc.args[i])
+                args.push_back(deviceVar.at(a));
+            deviceVar[firstOpId + i] = device->applyOperation(calc.op[i], args);
+        }
+        for (auto const id : segment.outputs)
+            device->declareOutputVariable(deviceVar.at(id));
+    }
+
+    std::vector<double*> output;
+    for (auto const id : segment.outputs)
+        output.push_back(values_[id].data() + offset);
+    device->finalizeCalculation(output);
+}
+
+void MultiDeviceComputeContext::finalizeCalculation(std::vector<double*>& output) {
+    struct exitGuard {
+        exitGuard() {}
+        ~exitGuard() { *currentState = ComputeState::idle; }
+        ComputeState* currentState;
+    } guard;
+
+    guard.currentState = &currentState_;
+
+    QL_REQUIRE(currentId_ > 0, "MultiDeviceComputeContext::finalizeCalculation(): current id is not set");
+    auto& calc = calcs_[currentId_ - 1];
+    QL_REQUIRE(output.size() == calc.outputVars.size(),
+               "MultiDeviceComputeContext::finalizeCalculation(): output size ("
+                   << output.size() << ") inconsistent to kernel output size (" << calc.outputVars.size() << ")");
+
+    if (!calc.hasPlan)
+        buildPlan(calc);
+
+    auto ops = getRandomVariableOps(calc.n, settings_.regressionOrder);
+
+    boost::timer::cpu_timer timer;
+
+    values_.resize(calc.numberOfInputVars + calc.numberOfVariates + calc.op.size());
+
+    std::size_t firstOpId = calc.numberOfInputVars + calc.numberOfVariates;
+    for (auto& segment : calc.segments) {
+
+        // run the pathwise ops on the devices, the results are written into preallocated host vectors
+
+        if (!segment.ops.empty()) {
+            for (auto const id : segment.outputs) {
+                values_[id] = RandomVariable(calc.n);
+                values_[id].expand();
+            }
+            if (distinctDevices_ && deviceSize_.size() > 1) {
+                std::vector<std::thread> workers;
+                std::vector<std::exception_ptr> errors(deviceSize_.size());
+                for (Size d = 0; d < deviceSize_.size(); ++d) {
+                    workers.emplace_back([this, &calc, &segment, &errors, d]() {
+                        try {
+                            runSegment(calc, segment, d);
+                        } catch (...) {
+                            errors[d] = std::current_exception();
+                        }
+                    });
+                }
+                for (auto& w : workers)
+                    w.join();
+                for (auto const& e : errors) {
+                    if (e)
+                        std::rethrow_exception(e);
+                }
+            } else {
+                for (Size d = 0; d < deviceSize_.size(); ++d)
+                    runSegment(calc, segment, d);
+            }
+        }
+
+        // compute the conditional expectations on the host using the samples of all devices
+
+        for (auto const i : segment.conditionalExpectations) {
+            std::vector<const RandomVariable*> args;
+            for (auto const a : calc.args[i])
+                args.push_back(&value(a));
+            values_[firstOpId + i] = ops[calc.op[i]](args);
+        }
+    }
+
+    for (Size i = 0; i < calc.outputVars.size(); ++i) {
+        const RandomVariable& v = value(calc.outputVars[i]);
+        for (Size j = 0; j < calc.n; ++j)
+            output[i][j] = v[j];
+    }
+
+    if (settings_.debug)
+        debugInfo_.nanoSecondsCalculation += timer.elapsed().wall;
+}
+
+std::vector<std::pair<std::string, std::string>> MultiDeviceComputeContext::deviceInfo() const {
+    std::vector<std::pair<std::string, std::string>> result;
+    for (Size d = 0; d < devices_.size(); ++d) {
+        for (auto const& [field, value] : devices_[d]->deviceInfo())
+            result.push_back(std::make_pair("device_" + std::to_string(d) + "_" + field, value));
+    }
+    return result;
+}
+
+bool MultiDeviceComputeContext::supportsDoublePrecision() const {
+    return std::all_of(devices_.begin(), devices_.end(),
+                       [](const ComputeContext* d) { return d->supportsDoublePrecision(); });
+}
+
+const ComputeContext::DebugInfo& MultiDeviceComputeContext::debugInfo() const { return debugInfo_; }
+
+} // namespace QuantExt
@@ -0,0 +1,123 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/math/multidevicecomputecontext.hpp
+    \brief compute context splitting the sample dimension across several devices
+*/
+
+#pragma once
+
+#include <qle/math/computeenvironment.hpp>
+#include <qle/math/randomvariable.hpp>
+
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+#include <memory>
+
+namespace QuantExt {
+
+//! Compute context that distributes the samples of a calculation on several underlying contexts
+/*! The samples are split into contiguous ranges of (almost) equal size, one per device. The operations are recorded
+    and split into segments at conditional expectations. Each segment is run as a separate calculation on every
+    device, the devices run concurrently if they are distinct contexts. The conditional expectations are computed on
+    the host on the combined samples of all devices, i.e. the regression uses all paths as on a single device.
+
+    The random variates are generated on the host with the same generator as the BasicCpu context and passed to the
+    devices as input variables, so that the results do not depend on the number of devices.
+
+    The context is created by ComputeEnvironment::selectContext() for a device name that is a ';' separated list of
+    device names. */
+class MultiDeviceComputeContext : public ComputeContext {
+public:
+    explicit MultiDeviceComputeContext(const std::vector<ComputeContext*>& devices);
+
+    void init() override;
+
+    std::pair<std::size_t, bool> initiateCalculation(const std::size_t n, const std::size_t id = 0,
+                                                     const std::size_t version = 0,
+                                                     const Settings settings = {}) override;
+    void disposeCalculation(const std::size_t id) override;
+    std::size_t createInputVariable(double v) override;
+    std::size_t createInputVariable(double* v) override;
+    std::vector<std::vector<std::size_t>> createInputVariates(const std::size_t dim,
+                                                              const std::size_t steps) override;
+    std::size_t applyOperation(const std::size_t randomVariableOpCode,
+                               const std::vector<std::size_t>& args) override;
+    void freeVariable(const std::size_t id) override;
+    void declareOutputVariable(const std::size_t id) override;
+    void finalizeCalculation(std::vector<double*>& output) override;
+
+    std::vector<std::pair<std::string, std::string>> deviceInfo() const override;
+    bool supportsDoublePrecision() const override;
+    const DebugInfo& debugInfo() const override;
+
+private:
+    enum class ComputeState { idle, createInput, createVariates, calc };
+
+    // a chain of pathwise ops run on the devices, followed by conditional expectations computed on the host
+    struct Segment {
+        std::vector<std::size_t> ops;
+        std::vector<std::size_t> conditionalExpectations;
+        std::vector<std::size_t> inputs;
+        std::vector<std::size_t> outputs;
+        std::vector<std::size_t> deviceCalcId;
+    };
+
+    struct Calculation {
+        std::size_t n = 0;
+        std::size_t version = 0;
+        bool disposed = false;
+        bool hasPlan = false;
+        std::size_t numberOfInputVars = 0;
+        std::size_t numberOfVariates = 0;
+        std::vector<std::size_t> op;
+        std::vector<std::vector<std::size_t>> args;
+        std::vector<std::size_t> outputVars;
+        std::vector<Segment> segments;
+    };
+
+    void buildPlan(Calculation& calc);
+    void runSegment(Calculation& calc, Segment& segment, const std::size_t device);
+    const RandomVariable& value(const std::size_t id) const;
+
+    std::vector<ComputeContext*> devices_;
+    bool distinctDevices_;
+    mutable DebugInfo debugInfo_;
+
+    std::vector<Calculation> calcs_;
+
+    // current calc
+
+    std::size_t currentId_ = 0;
+    ComputeState currentState_ = ComputeState::idle;
+    Settings settings_;
+    bool newCalc_ = false;
+    std::vector<std::size_t> deviceOffset_;
+    std::vector<std::size_t> deviceSize_;
+
+    // input values and results indexed by var id (the variates are stored separately)
+    std::vector<RandomVariable> values_;
+
+    // shared random variates for all calcs
+    std::unique_ptr<QuantLib::MersenneTwisterUniformRng> rng_;
+    QuantLib::InverseCumulativeNormal icn_;
+    std::vector<RandomVariable> variates_;
+};
+
+} // namespace QuantExt
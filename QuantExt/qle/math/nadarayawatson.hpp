@@ -19,10 +19,16 @@
 #ifndef quantext_nadaraya_watson_regression_hpp
 #define quantext_nadaraya_watson_regression_hpp
 
+#include <ql/errors.hpp>
 #include <ql/math/comparison.hpp>
 
 #include <boost/make_shared.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
 /*! \file qle/math/nadarayawatson.hpp
     \brief Nadaraya-Watson regression
     \ingroup math
@@ -118,6 +124,98 @@ private:
     QuantLib::ext::shared_ptr<detail::RegressionImpl> impl_;
 };
 
+//! Nadaraya Watson regression on binned sample points
+/*! The sample points are assigned to an equidistant grid of bins by linear binning, i.e. each point contributes to
+    the two neighbouring bins with weights proportional to its distance from the other bin. The estimator is then
+    evaluated on the bins within \f$ c h \f$ of \f$ x \f$, where \f$ h \f$ is the kernel band width and \f$ c \f$
+    the cutoff in band widths. An evaluation costs \f$ O(c \cdot b) \f$ kernel evaluations for \f$ b \f$ bins per
+    band width instead of one per sample point, the error compared to the NadarayaWatson estimator is of order of the
+    squared bin width.
+
+    The number of bins is limited by \p maxBins, if the sample range requires more bins, the bin width is increased.
+
+    \ingroup math
+*/
+class BinnedNadarayaWatson {
+public:
+    /*! \pre kernel needs a Real operator()(Real x) implementation
+        \pre the band width must be positive
+    */
+    template <class I1, class I2, class Kernel>
+    BinnedNadarayaWatson(const I1& xBegin, const I1& xEnd, const I2& yBegin, const Kernel& kernel, const Real bandWidth,
+                         const Size binsPerBandWidth = 10, const Real cutoff = 6.0, const Size maxBins = 100000)
+        : kernel_(kernel), cutoff_(cutoff * bandWidth) {
+        QL_REQUIRE(bandWidth > 0.0, "BinnedNadarayaWatson: band width (" << bandWidth << ") must be positive");
+        QL_REQUIRE(binsPerBandWidth > 0, "BinnedNadarayaWatson: bins per band width must be positive");
+        QL_REQUIRE(maxBins > 1, "BinnedNadarayaWatson: max bins (" << maxBins << ") must be at least 2");
+        if (xBegin == xEnd)
+            return;
+        auto [xMin, xMax] = std::minmax_element(xBegin, xEnd);
+        xMin_ = *xMin;
+        binWidth_ = std::max(bandWidth / static_cast<Real>(binsPerBandWidth),
+                             (*xMax - xMin_) / static_cast<Real>(maxBins - 1));
+        Size n = std::min<Size>(static_cast<Size>(std::floor((*xMax - xMin_) / binWidth_)) + 2, maxBins);
+        w_.resize(n, 0.0);
+        wy_.resize(n, 0.0);
+        wyy_.resize(n, 0.0);
+        I2 y = yBegin;
+        for (I1 x = xBegin; x != xEnd; ++x, ++y) {
+            Real pos = (*x - xMin_) / binWidth_;
+            Size i = std::min<Size>(static_cast<Size>(pos), n - 2);
+            Real f = std::min(pos - static_cast<Real>(i), 1.0);
+            add(i, 1.0 - f, *y);
+            add(i + 1, f, *y);
+        }
+    }
+
+    Real operator()(Real x) const {
+        Real tmp1 = 0.0, tmp1b = 0.0, tmp2 = 0.0;
+        sums(x, tmp1, tmp1b, tmp2);
+        return QuantLib::close_enough(tmp2, 0.0) ? 0.0 : tmp1 / tmp2;
+    }
+
+    Real standardDeviation(Real x) const {
+        Real tmp1 = 0.0, tmp1b = 0.0, tmp2 = 0.0;
+        sums(x, tmp1, tmp1b, tmp2);
+        return QuantLib::close_enough(tmp2, 0.0)
+                   ? 0.0
+                   : std::sqrt(std::max(tmp1b / tmp2 - (tmp1 * tmp1) / (tmp2 * tmp2), 0.0));
+    }
+
+    //! The number of bins
+    Size bins() const { return w_.size(); }
+
+private:
+    void add(const Size i, const Real weight, const Real y) {
+        w_[i] += weight;
+        wy_[i] += weight * y;
+        wyy_[i] += weight * y * y;
+    }
+
+    void sums(const Real x, Real& tmp1, Real& tmp1b, Real& tmp2) const {
+        if (w_.empty())
+            return;
+        Real lower = std::ceil((x - cutoff_ - xMin_) / binWidth_);
+        Real upper = std::floor((x + cutoff_ - xMin_) / binWidth_);
+        if (upper < 0.0 || lower > static_cast<Real>(w_.size() - 1))
+            return;
+        Size i0 = static_cast<Size>(std::max(lower, 0.0));
+        Size i1 = static_cast<Size>(std::min(upper, static_cast<Real>(w_.size() - 1)));
+        for (Size i = i0; i <= i1; ++i) {
+            if (w_[i] == 0.0)
+                continue;
+            Real k = kernel_(x - xMin_ - static_cast<Real>(i) * binWidth_);
+            tmp1 += wy_[i] * k;
+            tmp1b += wyy_[i] * k;
+            tmp2 += w_[i] * k;
+        }
+    }
+
+    std::function<Real(Real)> kernel_;
+    Real cutoff_, xMin_ = 0.0, binWidth_ = 1.0;
+    std::vector<Real> w_, wy_, wyy_;
+};
+
 } // namespace QuantExt
 
 #endif
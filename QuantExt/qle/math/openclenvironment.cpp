@@ -27,7 +27,12 @@
 #include <boost/algorithm/string/join.hpp>
 #include <boost/timer/timer.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <optional>
 #include <thread>
@@ -170,6 +175,18 @@ void errorCallback(const char* errinfo, const void* private_info, size_t cb, voi
     printf("Callback from OpenCL context: errinfo = '%s'\n", errinfo);
 }
 
+// 64 bit FNV-1a hash, used to key the program binary cache, stable across runs and platforms
+std::uint64_t fnv1a64(const std::string& s, std::uint64_t h = 14695981039346656037ULL) {
+    for (auto c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// header of a cached program binary file
+constexpr char programCacheMagic[8] = {'O', 'R', 'E', 'C', 'L', 'B', 'I', 'N'};
+
 } // namespace
 
 class OpenClContext : public ComputeContext {
@@ -231,6 +248,12 @@ private:
     static void releaseKernel(std::vector<cl_kernel>& ks, const std::string& desc);
     static void releaseProgram(cl_program& p, const std::string& desc);
 
+    /* create and build a program from source, if a program cache directory is configured, the binary is loaded from
+       resp. stored in the cache */
+    cl_program buildProgram(const std::string& source, const std::string& description);
+    cl_program loadCachedProgram(const std::string& fileName, const std::uint64_t checkHash);
+    void storeCachedProgram(const cl_program program, const std::string& fileName, const std::uint64_t checkHash);
+
     enum class ComputeState { idle, createInput, createVariates, calc, declareOutput };
 
     bool initialized_ = false;
@@ -242,6 +265,10 @@ private:
     std::vector<std::pair<std::string, std::string>> deviceInfo_;
     bool supportsDoublePrecision_;
 
+    // program binary cache directory (empty if caching is disabled) and device identification for the cache key
+    std::string programCacheDirectory_;
+    std::string deviceKey_;
+
     // will be accumulated over all calcs
     ComputeContext::DebugInfo debugInfo_;
 
@@ -389,7 +416,12 @@ OpenClContext::OpenClContext(cl_device_id* device, cl_context* context,
                              const std::vector<std::pair<std::string, std::string>>& deviceInfo,
                              const bool supportsDoublePrecision)
     : initialized_(false), device_(device), context_(context), deviceInfo_(deviceInfo),
-      supportsDoublePrecision_(supportsDoublePrecision) {}
+      supportsDoublePrecision_(supportsDoublePrecision) {
+    if (auto dir = std::getenv("ORE_OPENCL_PROGRAM_CACHE_DIR"))
+        programCacheDirectory_ = dir;
+    for (auto const& [field, value] : deviceInfo_)
+        deviceKey_ += field + "=" + value + "\n";
+}
 
 OpenClContext::~OpenClContext() {
     if (initialized_) {
@@ -450,6 +482,109 @@ void OpenClContext::releaseProgram(cl_program& p, const std::string& description
     }
 }
 
+cl_program OpenClContext::loadCachedProgram(const std::string& fileName, const std::uint64_t checkHash) {
+    std::ifstream in(fileName, std::ios::binary);
+    if (!in)
+        return nullptr;
+    char magic[sizeof(programCacheMagic)];
+    std::uint64_t hash, size;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&hash), sizeof(hash));
+    in.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (!in || !std::equal(magic, magic + sizeof(magic), programCacheMagic) || hash != checkHash || size == 0)
+        return nullptr;
+    std::vector<unsigned char> binary(size);
+    in.read(reinterpret_cast<char*>(&binary[0]), size);
+    if (!in)
+        return nullptr;
+    const unsigned char* binaryPtr = &binary[0];
+    std::size_t binarySize = binary.size();
+    cl_int binaryStatus, err;
+    cl_program program = clCreateProgramWithBinary(*context_, 1, device_, &binarySize, &binaryPtr, &binaryStatus, &err);
+    if (err != CL_SUCCESS)
+        return nullptr;
+    if (binaryStatus != CL_SUCCESS || clBuildProgram(program, 1, device_, NULL, NULL, NULL) != CL_SUCCESS) {
+        releaseProgram(program, "cached program");
+        return nullptr;
+    }
+    return program;
+}
+
+void OpenClContext::storeCachedProgram(const cl_program program, const std::string& fileName,
+                                       const std::uint64_t checkHash) {
+    std::size_t binarySize;
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(std::size_t), &binarySize, NULL) != CL_SUCCESS ||
+        binarySize == 0)
+        return;
+    std::vector<unsigned char> binary(binarySize);
+    unsigned char* binaryPtr = &binary[0];
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(unsigned char*), &binaryPtr, NULL) != CL_SUCCESS)
+        return;
+    // write to a temporary file and rename it, so that concurrent runs never see a partially written binary
+    std::string tmpFileName =
+        fileName + ".tmp" +
+        std::to_string(fnv1a64(std::to_string(reinterpret_cast<std::uintptr_t>(this)) + "/" +
+                               std::to_string(std::chrono::steady_clock::now().time_since_epoch().count())));
+    {
+        std::ofstream out(tmpFileName, std::ios::binary | std::ios::trunc);
+        std::uint64_t size = binarySize;
+        out.write(programCacheMagic, sizeof(programCacheMagic));
+        out.write(reinterpret_cast<const char*>(&checkHash), sizeof(checkHash));
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(reinterpret_cast<const char*>(&binary[0]), binarySize);
+        if (!out) {
+            out.close();
+            std::remove(tmpFileName.c_str());
+            std::cerr << "OpenClContext: could not write program cache file '" << tmpFileName << "'" << std::endl;
+            return;
+        }
+    }
+    if (std::rename(tmpFileName.c_str(), fileName.c_str()) != 0) {
+        std::remove(tmpFileName.c_str());
+        std::cerr << "OpenClContext: could not write program cache file '" << fileName << "'" << std::endl;
+    }
+}
+
+cl_program OpenClContext::buildProgram(const std::string& source, const std::string& description) {
+
+    /* the cache key covers the source, the device (name, driver and device versions etc.) and the build options
+       (currently always empty), the file name is derived from the key hash, a second, independent hash of the key
+       is stored in the file and checked on load */
+
+    std::string fileName;
+    std::uint64_t checkHash = 0;
+    if (!programCacheDirectory_.empty()) {
+        std::string key = deviceKey_ + "build_options=\n" + source;
+        checkHash = fnv1a64(key, 0xcbf29ce484222325ULL ^ key.size());
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(fnv1a64(key)));
+        fileName = programCacheDirectory_ + "/ore_opencl_" + std::string(hex) + ".bin";
+        if (cl_program program = loadCachedProgram(fileName, checkHash))
+            return program;
+    }
+
+    cl_int err;
+    const char* sourcePtr = source.c_str();
+    cl_program program = clCreateProgramWithSource(*context_, 1, &sourcePtr, NULL, &err);
+    QL_REQUIRE(err == CL_SUCCESS,
+               "OpenClContext::buildProgram(): error creating program '" << description << "': " << errorText(err));
+    err = clBuildProgram(program, 1, device_, NULL, NULL, NULL);
+    if (err != CL_SUCCESS) {
+        char buffer[ORE_OPENCL_MAX_BUILD_LOG];
+        clGetProgramBuildInfo(program, *device_, CL_PROGRAM_BUILD_LOG, ORE_OPENCL_MAX_BUILD_LOG * sizeof(char), buffer,
+                              NULL);
+        releaseProgram(program, description);
+        QL_FAIL("OpenClContext::buildProgram(): error during program build for '"
+                << description << "': " << errorText(err) << ": "
+                << std::string(buffer).substr(ORE_OPENCL_MAX_BUILD_LOG_LOGFILE));
+    }
+
+    if (!fileName.empty())
+        storeCachedProgram(program, fileName, checkHash);
+
+    return program;
+}
+
 std::string OpenClContext::runHealthCheckProgram(const std::string& source, const std::string& kernelName) {
 
     struct CleanUp {
@@ -543,6 +678,7 @@ void OpenClContext::init() {
     }
 
     debugInfo_.numberOfOperations = 0;
+    debugInfo_.numberOfOperationsByOpCode.clear();
     debugInfo_.nanoSecondsDataCopy = 0;
     debugInfo_.nanoSecondsProgramBuild = 0;
     debugInfo_.nanoSecondsCalculation = 0;
@@ -840,19 +976,8 @@ void OpenClContext::updateVariatesPool() {
 
         // std::cerr << "generated variates program:\n" + programSource << std::endl;
 
-        const char* programSourcePtr = programSource.c_str();
         cl_int err;
-        variatesProgram_ = clCreateProgramWithSource(*context_, 1, &programSourcePtr, NULL, &err);
-        QL_REQUIRE(err == CL_SUCCESS,
-                   "OpenClContext::updateVariatesPool(): error creating program: " << errorText(err));
-        err = clBuildProgram(variatesProgram_, 1, device_, NULL, NULL, NULL);
-        if (err != CL_SUCCESS) {
-            char buffer[ORE_OPENCL_MAX_BUILD_LOG];
-            clGetProgramBuildInfo(variatesProgram_, *device_, CL_PROGRAM_BUILD_LOG,
-                                  ORE_OPENCL_MAX_BUILD_LOG * sizeof(char), buffer, NULL);
-            QL_FAIL("OpenClContext::updateVariatesPool(): error during program build: "
-                    << errorText(err) << ": " << std::string(buffer).substr(ORE_OPENCL_MAX_BUILD_LOG_LOGFILE));
-        }
+        variatesProgram_ = buildProgram(programSource, "variates");
 
         variatesKernelSeedInit_ = clCreateKernel(variatesProgram_, "ore_seedInitialization", &err);
         QL_REQUIRE(err == CL_SUCCESS,
@@ -1184,8 +1309,10 @@ std::size_t OpenClContext::applyOperation(const std::size_t randomVariableOpCode
         }
         } // switch random var op code
 
-        if (settings_.debug)
+        if (settings_.debug) {
             debugInfo_.numberOfOperations += 1 * size_[currentId_ - 1];
+            debugInfo_.numberOfOperationsByOpCode[randomVariableOpCode] += 1 * size_[currentId_ - 1];
+        }
 
         return resultId;
     }
@@ -1477,19 +1604,7 @@ void OpenClContext::finalizeCalculation(std::vector<double*>& output) {
         }
 
         cl_int err;
-        const char* kernelSourcePtr = kernelSource.c_str();
-        program_[currentId_ - 1] = clCreateProgramWithSource(*context_, 1, &kernelSourcePtr, NULL, &err);
-        QL_REQUIRE(err == CL_SUCCESS, "OpenClContext::finalizeCalculation(): error during clCreateProgramWithSource(): "
-                                          << errorText(err));
-        err = clBuildProgram(program_[currentId_ - 1], 1, device_, NULL, NULL, NULL);
-        if (err != CL_SUCCESS) {
-            char buffer[ORE_OPENCL_MAX_BUILD_LOG];
-            clGetProgramBuildInfo(program_[currentId_ - 1], *device_, CL_PROGRAM_BUILD_LOG,
-                                  ORE_OPENCL_MAX_BUILD_LOG * sizeof(char), buffer, NULL);
-            QL_FAIL("OpenClContext::finalizeCalculation(): error during program build for kernel '"
-                    << kernelNameStem << "*': " << errorText(err) << ": "
-                    << std::string(buffer).substr(ORE_OPENCL_MAX_BUILD_LOG_LOGFILE));
-        }
+        program_[currentId_ - 1] = buildProgram(kernelSource, "kernel " + kernelNameStem + "*");
 
         for (std::size_t part = 0; part < currentSsa_.ssa.size(); ++part) {
             std::string kernelName = kernelNameStem + std::to_string(part);
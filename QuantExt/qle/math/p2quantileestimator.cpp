@@ -0,0 +1,106 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/math/p2quantileestimator.hpp>
+
+#include <ql/errors.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace QuantExt {
+
+P2QuantileEstimator::P2QuantileEstimator(const Real p) : p_(p) {
+    QL_REQUIRE(p >= 0.0 && p <= 1.0, "P2QuantileEstimator: p (" << p << ") must be in [0,1]");
+    dn_ = {0.0, p / 2.0, p, (1.0 + p) / 2.0, 1.0};
+    np_ = {0.0, 2.0 * p, 4.0 * p, 2.0 + 2.0 * p, 4.0};
+    n_ = {0.0, 1.0, 2.0, 3.0, 4.0};
+}
+
+void P2QuantileEstimator::add(const Real x) {
+
+    // initialisation phase, collect the first five observations
+
+    if (count_ < 5) {
+        q_[count_++] = x;
+        if (count_ == 5)
+            std::sort(q_.begin(), q_.end());
+        return;
+    }
+
+    ++count_;
+
+    // find the cell k with q_k <= x < q_{k+1} and adjust the extreme markers
+
+    Size k;
+    if (x < q_[0]) {
+        q_[0] = x;
+        k = 0;
+    } else if (x >= q_[4]) {
+        q_[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (x >= q_[k + 1])
+            ++k;
+    }
+
+    // update positions
+
+    for (Size i = k + 1; i < 5; ++i)
+        n_[i] += 1.0;
+    for (Size i = 0; i < 5; ++i)
+        np_[i] += dn_[i];
+
+    // adjust the heights of the middle markers
+
+    for (Size i = 1; i < 4; ++i) {
+        Real d = np_[i] - n_[i];
+        if ((d >= 1.0 && n_[i + 1] - n_[i] > 1.0) || (d <= -1.0 && n_[i - 1] - n_[i] < -1.0)) {
+            int s = d > 0.0 ? 1 : -1;
+            Real qp = parabolic(i, s);
+            if (q_[i - 1] < qp && qp < q_[i + 1])
+                q_[i] = qp;
+            else
+                q_[i] = linear(i, s);
+            n_[i] += s;
+        }
+    }
+}
+
+Real P2QuantileEstimator::quantile() const {
+    QL_REQUIRE(count_ > 0, "P2QuantileEstimator: no observations");
+    if (count_ < 5) {
+        std::array<Real, 5> tmp = q_;
+        std::sort(tmp.begin(), tmp.begin() + count_);
+        return tmp[static_cast<Size>(std::floor(p_ * (count_ - 1) + 0.5))];
+    }
+    return q_[2];
+}
+
+Real P2QuantileEstimator::parabolic(const Size i, const Real d) const {
+    return q_[i] + d / (n_[i + 1] - n_[i - 1]) *
+                       ((n_[i] - n_[i - 1] + d) * (q_[i + 1] - q_[i]) / (n_[i + 1] - n_[i]) +
+                        (n_[i + 1] - n_[i] - d) * (q_[i] - q_[i - 1]) / (n_[i] - n_[i - 1]));
+}
+
+Real P2QuantileEstimator::linear(const Size i, const int d) const {
+    return q_[i] + d * (q_[i + d] - q_[i]) / (n_[i + d] - n_[i]);
+}
+
+} // namespace QuantExt
@@ -0,0 +1,69 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/math/p2quantileestimator.hpp
+    \brief streaming quantile estimation using the P^2 algorithm
+    \ingroup math
+*/
+
+#pragma once
+
+#include <ql/types.hpp>
+
+#include <array>
+#include <vector>
+
+namespace QuantExt {
+using QuantLib::Real;
+using QuantLib::Size;
+
+//! Streaming quantile estimator
+/*! Estimates the p-quantile of a sequence of observations in constant memory using the P^2 algorithm, see
+
+    R. Jain and I. Chlamtac, The P^2 algorithm for dynamic calculation of quantiles and histograms without storing
+    observations, Communications of the ACM, 28(10), 1985.
+
+    As long as less than five observations were added, the quantile is computed exactly as the observation with index
+    floor(p * (n - 1) + 0.5) in the sorted sample.
+*/
+class P2QuantileEstimator {
+public:
+    explicit P2QuantileEstimator(const Real p);
+
+    //! add an observation
+    void add(const Real x);
+    //! current estimate of the quantile, requires at least one observation
+    Real quantile() const;
+    //! number of observations
+    Size count() const { return count_; }
+    //! the quantile level
+    Real p() const { return p_; }
+
+private:
+    Real parabolic(const Size i, const Real d) const;
+    Real linear(const Size i, const int d) const;
+
+    Real p_;
+    Size count_ = 0;
+    std::array<Real, 5> q_;  // marker heights
+    std::array<Real, 5> n_;  // actual marker positions
+    std::array<Real, 5> np_; // desired marker positions
+    std::array<Real, 5> dn_; // increments of the desired marker positions
+};
+
+} // namespace QuantExt
@@ -16,7 +16,9 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <qle/math/alignedbufferpool.hpp>
 #include <qle/math/randomvariable.hpp>
+#include <qle/math/randomvariablekernels.hpp>
 #include <qle/math/randomvariablelsmbasissystem.hpp>
 
 #include <ql/experimental/math/moorepenroseinverse.hpp>
@@ -25,8 +27,6 @@
 #include <ql/math/matrixutilities/qrdecomposition.hpp>
 #include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
 
-#include <boost/math/distributions/normal.hpp>
-
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/covariance.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
@@ -98,7 +98,7 @@ Filter::Filter(const Filter& r) {
     constantData_ = r.constantData_;
     if (r.data_) {
         resumeDataStats();
-        data_ = new bool[n_];
+        data_ = AlignedBufferPool::allocate<bool>(n_);
         // std::memcpy(data_, r.data_, n_ * sizeof(bool));
         std::copy(r.data_, r.data_ + n_, data_);
         stopDataStats(n_);
@@ -120,24 +120,24 @@ Filter& Filter::operator=(const Filter& r) {
     if (r.deterministic_) {
         deterministic_ = true;
         if (data_) {
-            delete[] data_;
+            AlignedBufferPool::deallocate(data_, n_);
             data_ = nullptr;
         }
     } else {
         deterministic_ = false;
         if (r.n_ != 0) {
             resumeDataStats();
-            if (n_ != r.n_) {
+            if (data_ == nullptr || n_ != r.n_) {
                 if (data_)
-                    delete[] data_;
-                data_ = new bool[r.n_];
+                    AlignedBufferPool::deallocate(data_, n_);
+                data_ = AlignedBufferPool::allocate<bool>(r.n_);
             }
             // std::memcpy(data_, r.data_, r.n_ * sizeof(bool));
             std::copy(r.data_, r.data_ + r.n_, data_);
             stopDataStats(r.n_);
         } else {
             if (data_) {
-                delete[] data_;
+                AlignedBufferPool::deallocate(data_, n_);
                 data_ = nullptr;
             }
         }
@@ -148,11 +148,11 @@ Filter& Filter::operator=(const Filter& r) {
 }
 
 Filter& Filter::operator=(Filter&& r) {
-    n_ = r.n_;
-    constantData_ = r.constantData_;
     if (data_) {
-        delete[] data_;
+        AlignedBufferPool::deallocate(data_, n_);
     }
+    n_ = r.n_;
+    constantData_ = r.constantData_;
     data_ = r.data_;
     r.data_ = nullptr;
     deterministic_ = r.deterministic_;
@@ -162,12 +162,12 @@ Filter& Filter::operator=(Filter&& r) {
 Filter::Filter(const Size n, const bool value) : n_(n), constantData_(value), data_(nullptr), deterministic_(n != 0) {}
 
 void Filter::clear() {
-    n_ = 0;
-    constantData_ = false;
     if (data_) {
-        delete[] data_;
+        AlignedBufferPool::deallocate(data_, n_);
         data_ = nullptr;
     }
+    n_ = 0;
+    constantData_ = false;
     deterministic_ = false;
 }
 
@@ -188,7 +188,7 @@ void Filter::updateDeterministic() {
 void Filter::setAll(const bool v) {
     QL_REQUIRE(n_ > 0, "Filter::setAll(): dimension is zero");
     if (data_) {
-        delete[] data_;
+        AlignedBufferPool::deallocate(data_, n_);
         data_ = nullptr;
     }
     constantData_ = v;
@@ -205,7 +205,7 @@ void Filter::expand() {
         return;
     deterministic_ = false;
     resumeDataStats();
-    data_ = new bool[n_];
+    data_ = AlignedBufferPool::allocate<bool>(n_);
     std::fill(data_, data_ + n_, constantData_);
     stopDataStats(n_);
 }
@@ -317,7 +317,7 @@ RandomVariable::RandomVariable(const RandomVariable& r) {
     constantData_ = r.constantData_;
     if (r.data_) {
         resumeDataStats();
-        data_ = new double[n_];
+        data_ = AlignedBufferPool::allocate<double>(n_);
         // std::memcpy(data_, r.data_, n_ * sizeof(double));
         std::copy(r.data_, r.data_ + n_, data_);
         stopDataStats(n_);
@@ -341,24 +341,24 @@ RandomVariable& RandomVariable::operator=(const RandomVariable& r) {
     if (r.deterministic_) {
         deterministic_ = true;
         if (data_) {
-            delete[] data_;
+            AlignedBufferPool::deallocate(data_, n_);
             data_ = nullptr;
         }
     } else {
         deterministic_ = false;
         if (r.n_ != 0) {
             resumeDataStats();
-            if (n_ != r.n_) {
+            if (data_ == nullptr || n_ != r.n_) {
                 if (data_)
-                    delete[] data_;
-                data_ = new double[r.n_];
+                    AlignedBufferPool::deallocate(data_, n_);
+                data_ = AlignedBufferPool::allocate<double>(r.n_);
             }
             // std::memcpy(data_, r.data_, r.n_ * sizeof(double));
             std::copy(r.data_, r.data_ + r.n_, data_);
             stopDataStats(r.n_);
         } else {
             if (data_) {
-                delete[] data_;
+                AlignedBufferPool::deallocate(data_, n_);
                 data_ = nullptr;
             }
         }
@@ -370,11 +370,11 @@ RandomVariable& RandomVariable::operator=(const RandomVariable& r) {
 }
 
 RandomVariable& RandomVariable::operator=(RandomVariable&& r) {
-    n_ = r.n_;
-    constantData_ = r.constantData_;
     if (data_) {
-        delete[] data_;
+        AlignedBufferPool::deallocate(data_, n_);
     }
+    n_ = r.n_;
+    constantData_ = r.constantData_;
     data_ = r.data_;
     r.data_ = nullptr;
     deterministic_ = r.deterministic_;
@@ -399,7 +399,7 @@ RandomVariable::RandomVariable(const Filter& f, const Real valueTrue, const Real
         resumeDataStats();
         constantData_ = 0.0;
         deterministic_ = false;
-        data_ = new double[n_];
+        data_ = AlignedBufferPool::allocate<double>(n_);
         for (Size i = 0; i < n_; ++i)
             set(i, f[i] ? valueTrue : valueFalse);
         stopDataStats(n_);
@@ -413,7 +413,7 @@ RandomVariable::RandomVariable(const Size n, const Real* const data, const Real
     time_ = time;
     if (n_ != 0) {
         resumeDataStats();
-        data_ = new double[n_];
+        data_ = AlignedBufferPool::allocate<double>(n_);
         // std::memcpy(data_, array.begin(), n_ * sizeof(double));
         std::copy(data, data + n_, data_);
         stopDataStats(n_);
@@ -451,12 +451,12 @@ void RandomVariable::copyToArray(QuantLib::Array& array) const {
 }
 
 void RandomVariable::clear() {
-    n_ = 0;
-    constantData_ = 0.0;
     if (data_) {
-        delete[] data_;
+        AlignedBufferPool::deallocate(data_, n_);
         data_ = nullptr;
     }
+    n_ = 0;
+    constantData_ = 0.0;
     deterministic_ = false;
     time_ = Null<Real>();
 }
@@ -478,7 +478,7 @@ void RandomVariable::updateDeterministic() {
 void RandomVariable::setAll(const Real v) {
     QL_REQUIRE(n_ > 0, "RandomVariable::setAll(): dimension is zero");
     if (data_) {
-        delete[] data_;
+        AlignedBufferPool::deallocate(data_, n_);
         data_ = nullptr;
     }
     constantData_ = v;
@@ -495,7 +495,7 @@ void RandomVariable::expand() {
         return;
     deterministic_ = false;
     resumeDataStats();
-    data_ = new double[n_];
+    data_ = AlignedBufferPool::allocate<double>(n_);
     std::fill(data_, data_ + n_, constantData_);
     stopDataStats(n_);
 }
@@ -546,9 +546,10 @@ RandomVariable& RandomVariable::operator+=(const RandomVariable& y) {
         constantData_ += y.constantData_;
     else {
         resumeCalcStats();
-        for (Size i = 0; i < n_; ++i) {
-            data_[i] += y[i];
-        }
+        if (y.deterministic_)
+            RandomVariableKernels::add(n_, data_, y.constantData_);
+        else
+            RandomVariableKernels::add(n_, data_, y.data_);
         stopCalcStats(n_);
     }
     return *this;
@@ -570,9 +571,10 @@ RandomVariable& RandomVariable::operator-=(const RandomVariable& y) {
         constantData_ -= y.constantData_;
     else {
         resumeCalcStats();
-        for (Size i = 0; i < n_; ++i) {
-            data_[i] -= y[i];
-        }
+        if (y.deterministic_)
+            RandomVariableKernels::subtract(n_, data_, y.constantData_);
+        else
+            RandomVariableKernels::subtract(n_, data_, y.data_);
         stopCalcStats(n_);
     }
     return *this;
@@ -594,9 +596,10 @@ RandomVariable& RandomVariable::operator*=(const RandomVariable& y) {
         constantData_ *= y.constantData_;
     else {
         resumeCalcStats();
-        for (Size i = 0; i < n_; ++i) {
-            data_[i] *= y[i];
-        }
+        if (y.deterministic_)
+            RandomVariableKernels::multiply(n_, data_, y.constantData_);
+        else
+            RandomVariableKernels::multiply(n_, data_, y.data_);
         stopCalcStats(n_);
     }
     return *this;
@@ -618,9 +621,10 @@ RandomVariable& RandomVariable::operator/=(const RandomVariable& y) {
         constantData_ /= y.constantData_;
     else {
         resumeCalcStats();
-        for (Size i = 0; i < n_; ++i) {
-            data_[i] /= y[i];
-        }
+        if (y.deterministic_)
+            RandomVariableKernels::divide(n_, data_, y.constantData_);
+        else
+            RandomVariableKernels::divide(n_, data_, y.data_);
         stopCalcStats(n_);
     }
     return *this;
@@ -744,12 +748,10 @@ RandomVariable abs(RandomVariable x) {
 
 RandomVariable exp(RandomVariable x) {
     if (x.deterministic_)
-        x.constantData_ = std::exp(x.constantData_);
+        RandomVariableKernels::exp(1, &x.constantData_);
     else {
         resumeCalcStats();
-        for (Size i = 0; i < x.n_; ++i) {
-            x.data_[i] = std::exp(x.data_[i]);
-        }
+        RandomVariableKernels::exp(x.n_, x.data_);
         stopCalcStats(x.n_);
     }
     return x;
@@ -757,12 +759,10 @@ RandomVariable exp(RandomVariable x) {
 
 RandomVariable log(RandomVariable x) {
     if (x.deterministic_)
-        x.constantData_ = std::log(x.constantData_);
+        RandomVariableKernels::log(1, &x.constantData_);
     else {
         resumeCalcStats();
-        for (Size i = 0; i < x.n_; ++i) {
-            x.data_[i] = std::log(x.data_[i]);
-        }
+        RandomVariableKernels::log(x.n_, x.data_);
         stopCalcStats(x.n_);
     }
     return x;
@@ -773,9 +773,7 @@ RandomVariable sqrt(RandomVariable x) {
         x.constantData_ = std::sqrt(x.constantData_);
     else {
         resumeCalcStats();
-        for (Size i = 0; i < x.n_; ++i) {
-            x.data_[i] = std::sqrt(x.data_[i]);
-        }
+        RandomVariableKernels::sqrt(x.n_, x.data_);
         stopCalcStats(x.n_);
     }
     return x;
@@ -808,28 +806,24 @@ RandomVariable cos(RandomVariable x) {
 }
 
 RandomVariable normalCdf(RandomVariable x) {
-    static const boost::math::normal_distribution<double> n;
+    // use the kernel for deterministic values as well to get consistent results
     if (x.deterministic_)
-        x.constantData_ = boost::math::cdf(n, x.constantData_);
+        RandomVariableKernels::normalCdf(1, &x.constantData_);
     else {
         resumeCalcStats();
-        for (Size i = 0; i < x.n_; ++i) {
-            x.data_[i] = boost::math::cdf(n, x.data_[i]);
-        }
+        RandomVariableKernels::normalCdf(x.n_, x.data_);
         stopCalcStats(x.n_);
     }
     return x;
 }
 
 RandomVariable normalPdf(RandomVariable x) {
-    static const boost::math::normal_distribution<double> n;
+    // use the kernel for deterministic values as well to get consistent results
     if (x.deterministic_)
-        x.constantData_ = boost::math::pdf(n, x.constantData_);
+        RandomVariableKernels::normalPdf(1, &x.constantData_);
     else {
         resumeCalcStats();
-        for (Size i = 0; i < x.n_; ++i) {
-            x.data_[i] = boost::math::pdf(n, x.data_[i]);
-        }
+        RandomVariableKernels::normalPdf(x.n_, x.data_);
         stopCalcStats(x.n_);
     }
     return x;
@@ -881,10 +875,10 @@ RandomVariable conditionalResult(const Filter& f, RandomVariable x, const Random
         return f.at(0) ? x : y;
     resumeCalcStats();
     x.expand();
-    for (Size i = 0; i < f.size(); ++i) {
-        if (!f[i])
-            x.set(i, y[i]);
-    }
+    if (y.deterministic_)
+        RandomVariableKernels::conditionalResult(x.n_, x.data_, f.data_, y.constantData_);
+    else
+        RandomVariableKernels::conditionalResult(x.n_, x.data_, f.data_, y.data_);
     stopCalcStats(f.size());
     return x;
 }
@@ -919,17 +913,18 @@ RandomVariable indicatorGt(RandomVariable x, const RandomVariable& y, const Real
     if (!y.deterministic_)
         x.expand();
     if (eps != 0.0) {
-        Real delta = getDelta(x - y, eps);
+        // the smoothing is applied to x - y, the width is proportional to the rms of x - y
+        RandomVariable d = x - y;
+        Real delta = getDelta(d, eps);
         if (!QuantLib::close_enough(delta, 0.0)) {
             // logistic function
-            x.expand();
-            Real delta = getDelta(x - y, eps);
+            d.expand();
             resumeCalcStats();
-            for (Size i = 0; i < x.n_; ++i) {
-                x.data_[i] = falseVal + (trueVal - falseVal) * 1.0 / (1.0 + std::exp(-x.data_[i] / delta));
+            for (Size i = 0; i < d.n_; ++i) {
+                d.data_[i] = falseVal + (trueVal - falseVal) * 1.0 / (1.0 + std::exp(-d.data_[i] / delta));
             }
-            stopCalcStats(x.n_);
-            return x;
+            stopCalcStats(d.n_);
+            return d;
         }
     }
     // eps == 0.0 or delta == 0.0
@@ -939,9 +934,10 @@ RandomVariable indicatorGt(RandomVariable x, const RandomVariable& y, const Real
                                                                                                              : falseVal;
     } else {
         resumeCalcStats();
-        for (Size i = 0; i < x.n_; ++i) {
-            x.data_[i] = (x.data_[i] > y[i] && !QuantLib::close_enough(x.data_[i], y[i])) ? trueVal : falseVal;
-        }
+        if (y.deterministic_)
+            RandomVariableKernels::indicatorGt(x.n_, x.data_, y.constantData_, trueVal, falseVal);
+        else
+            RandomVariableKernels::indicatorGt(x.n_, x.data_, y.data_, trueVal, falseVal);
         stopCalcStats(x.n_);
     }
     return x;
@@ -957,17 +953,18 @@ RandomVariable indicatorGeq(RandomVariable x, const RandomVariable& y, const Rea
     if (!y.deterministic_)
         x.expand();
     if (eps != 0.0) {
-        Real delta = getDelta(x - y, eps);
+        // the smoothing is applied to x - y, the width is proportional to the rms of x - y
+        RandomVariable d = x - y;
+        Real delta = getDelta(d, eps);
         if (!QuantLib::close_enough(delta, 0.0)) {
             // logistic function
-            x.expand();
-            Real delta = getDelta(x - y, eps);
+            d.expand();
             resumeCalcStats();
-            for (Size i = 0; i < x.n_; ++i) {
-                x.data_[i] = falseVal + (trueVal - falseVal) * 1.0 / (1.0 + std::exp(-x.data_[i] / delta));
+            for (Size i = 0; i < d.n_; ++i) {
+                d.data_[i] = falseVal + (trueVal - falseVal) * 1.0 / (1.0 + std::exp(-d.data_[i] / delta));
             }
-            stopCalcStats(x.n_);
-            return x;
+            stopCalcStats(d.n_);
+            return d;
         }
     }
     // eps == 0.0 or delta == 0.0
@@ -1160,6 +1157,177 @@ std::vector<const RandomVariable*> vec2vecptr(const std::vector<RandomVariable>&
     return result;
 }
 
+namespace {
+
+/* Accumulates the lower triangle of X^T X (if xtx is not null) and X^T r (if r is not null) over blocks of samples, so
+   that the design matrix X is never materialised. Filtered samples do not contribute. */
+void accumulateNormalEquations(
+    const RandomVariable* r, const std::vector<const RandomVariable*>& regressor,
+    const std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>& basisFn,
+    const Filter& filter, const Size n, std::vector<double>* xtx, std::vector<double>* xty) {
+
+    constexpr Size blockSize = 1024;
+
+    const Size m = basisFn.size();
+
+    if (xtx)
+        xtx->assign(m * m, 0.0);
+    if (xty)
+        xty->assign(m, 0.0);
+
+    std::vector<double> x(m * blockSize), y(blockSize);
+    std::vector<RandomVariable> blockRegressor(regressor.size());
+    std::vector<const RandomVariable*> blockRegressorPtr(regressor.size());
+
+    for (Size offset = 0; offset < n; offset += blockSize) {
+        const Size b = std::min(blockSize, n - offset);
+
+        // slice the regressors and the regressand to the current block
+
+        for (Size k = 0; k < regressor.size(); ++k) {
+            if (regressor[k]->deterministic())
+                blockRegressor[k] = RandomVariable(b, regressor[k]->at(0));
+            else
+                blockRegressor[k] = RandomVariable(b, regressor[k]->data() + offset);
+            blockRegressorPtr[k] = &blockRegressor[k];
+        }
+
+        if (r) {
+            for (Size i = 0; i < b; ++i)
+                y[i] = (*r)[offset + i];
+        }
+
+        // evaluate the basis functions on the block, filtered samples are set to zero
+
+        for (Size j = 0; j < m; ++j) {
+            RandomVariable a = basisFn[j](blockRegressorPtr);
+            double* xj = &x[j * blockSize];
+            if (a.deterministic())
+                std::fill(xj, xj + b, a[0]);
+            else
+                std::copy(a.data(), a.data() + b, xj);
+            if (filter.initialised()) {
+                for (Size i = 0; i < b; ++i)
+                    xj[i] = filter[offset + i] ? xj[i] : 0.0;
+            }
+        }
+
+        // update the lower triangle of X^T X and X^T y
+
+        for (Size j = 0; j < m; ++j) {
+            const double* xj = &x[j * blockSize];
+            if (xtx) {
+                for (Size k = 0; k <= j; ++k) {
+                    const double* xk = &x[k * blockSize];
+                    double sum = 0.0;
+                    for (Size i = 0; i < b; ++i)
+                        sum += xj[i] * xk[i];
+                    (*xtx)[j * m + k] += sum;
+                }
+            }
+            if (xty) {
+                double sum = 0.0;
+                for (Size i = 0; i < b; ++i)
+                    sum += xj[i] * y[i];
+                (*xty)[j] += sum;
+            }
+        }
+    }
+}
+
+/* Cholesky decomposition of the equilibrated X^T X in place. The normal equations square the condition number of X, so
+   we require the pivots to be well above machine precision, otherwise false is returned. */
+bool factoriseNormalEquations(const Size m, std::vector<double>& xtx, std::vector<double>& scale) {
+
+    // equilibrate, a zero column (e.g. a basis function vanishing on the filtered samples) is not solvable
+
+    scale.resize(m);
+    for (Size j = 0; j < m; ++j) {
+        if (xtx[j * m + j] <= 0.0)
+            return false;
+        scale[j] = 1.0 / std::sqrt(xtx[j * m + j]);
+    }
+    for (Size j = 0; j < m; ++j) {
+        for (Size k = 0; k <= j; ++k)
+            xtx[j * m + k] *= scale[j] * scale[k];
+    }
+
+    constexpr double minPivot = 1E-10;
+
+    for (Size j = 0; j < m; ++j) {
+        double d = xtx[j * m + j];
+        for (Size k = 0; k < j; ++k)
+            d -= xtx[j * m + k] * xtx[j * m + k];
+        if (d < minPivot)
+            return false;
+        d = std::sqrt(d);
+        xtx[j * m + j] = d;
+        for (Size i = j + 1; i < m; ++i) {
+            double s = xtx[i * m + j];
+            for (Size k = 0; k < j; ++k)
+                s -= xtx[i * m + k] * xtx[j * m + k];
+            xtx[i * m + j] = s / d;
+        }
+    }
+
+    return true;
+}
+
+// forward and backward substitution using the factorisation from factoriseNormalEquations()
+Array solveNormalEquations(const Size m, const std::vector<double>& l, const std::vector<double>& scale,
+                           const std::vector<double>& xty) {
+    Array res(m);
+    for (Size j = 0; j < m; ++j) {
+        double s = xty[j] * scale[j];
+        for (Size k = 0; k < j; ++k)
+            s -= l[j * m + k] * res[k];
+        res[j] = s / l[j * m + j];
+    }
+    for (Size j = m; j > 0; --j) {
+        double s = res[j - 1];
+        for (Size k = j; k < m; ++k)
+            s -= l[k * m + j - 1] * res[k];
+        res[j - 1] = s / l[(j - 1) * m + j - 1];
+    }
+    for (Size j = 0; j < m; ++j)
+        res[j] *= scale[j];
+    return res;
+}
+
+} // namespace
+
+NormalEquationsFactorisation normalEquationsFactorisation(
+    const std::vector<const RandomVariable*>& regressor,
+    const std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>& basisFn,
+    const Filter& filter, const Size samples) {
+    QL_REQUIRE(samples >= basisFn.size(), "normalEquationsFactorisation(): sample size ("
+                                              << samples << ") must be geq basis fns size (" << basisFn.size() << ")");
+    resumeCalcStats();
+    NormalEquationsFactorisation result;
+    result.samples = samples;
+    accumulateNormalEquations(nullptr, regressor, basisFn, filter, samples, &result.choleskyFactor, nullptr);
+    result.valid = factoriseNormalEquations(basisFn.size(), result.choleskyFactor, result.scale);
+    stopCalcStats(samples * basisFn.size() * (basisFn.size() + 1) / 2);
+    return result;
+}
+
+Array regressionCoefficients(
+    const RandomVariable& r, const std::vector<const RandomVariable*>& regressor,
+    const std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>& basisFn,
+    const Filter& filter, const NormalEquationsFactorisation& factorisation) {
+    QL_REQUIRE(factorisation.samples == r.size(), "regressionCoefficients(): factorisation sample size ("
+                                                      << factorisation.samples << ") does not match regressand size ("
+                                                      << r.size() << ")");
+    if (!factorisation.valid)
+        return regressionCoefficients(r, regressor, basisFn, filter, RandomVariableRegressionMethod::QR);
+    resumeCalcStats();
+    std::vector<double> xty;
+    accumulateNormalEquations(&r, regressor, basisFn, filter, r.size(), nullptr, &xty);
+    Array res = solveNormalEquations(basisFn.size(), factorisation.choleskyFactor, factorisation.scale, xty);
+    stopCalcStats(r.size() * basisFn.size());
+    return res;
+}
+
 Array regressionCoefficients(
     RandomVariable r, std::vector<const RandomVariable*> regressor,
     const std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>& basisFn,
@@ -1177,8 +1345,29 @@ Array regressionCoefficients(
                                                << r.size() << ") must be geq basis fns size (" << basisFn.size()
                                                << ")");
 
+    if (!debugLabel.empty()) {
+        for (Size i = 0; i < r.size(); ++i) {
+            std::cout << debugLabel << "," << r[i] << ",";
+            for (Size j = 0; j < regressor.size(); ++j) {
+                std::cout << regressor[j]->operator[](i) << (j == regressor.size() - 1 ? "\n" : ",");
+            }
+        }
+        std::cout << std::flush;
+    }
+
     resumeCalcStats();
 
+    if (regressionMethod == RandomVariableRegressionMethod::NormalEquations) {
+        std::vector<double> xtx, xty, scale;
+        accumulateNormalEquations(&r, regressor, basisFn, filter, r.size(), &xtx, &xty);
+        bool valid = factoriseNormalEquations(basisFn.size(), xtx, scale);
+        stopCalcStats(r.size() * basisFn.size() * (basisFn.size() + 1));
+        if (valid)
+            return solveNormalEquations(basisFn.size(), xtx, scale, xty);
+        // fall back to a (pivoted) QR decomposition of the design matrix for ill-conditioned systems
+        return regressionCoefficients(r, regressor, basisFn, filter, RandomVariableRegressionMethod::QR);
+    }
+
     Matrix A(r.size(), basisFn.size());
     for (Size j = 0; j < basisFn.size(); ++j) {
         RandomVariable a = basisFn[j](regressor);
@@ -1191,16 +1380,6 @@ Array regressionCoefficients(
             a.copyToMatrixCol(A, j);
     }
 
-    if (!debugLabel.empty()) {
-        for (Size i = 0; i < r.size(); ++i) {
-            std::cout << debugLabel << "," << r[i] << ",";
-            for (Size j = 0; j < regressor.size(); ++j) {
-                std::cout << regressor[j]->operator[](i) << (j == regressor.size() - 1 ? "\n" : ",");
-            }
-        }
-        std::cout << std::flush;
-    }
-
     if (filter.size() > 0) {
         r = applyFilter(r, filter);
     }
@@ -63,6 +63,8 @@ struct RandomVariableStats : public QuantLib::Singleton<RandomVariableStats> {
 
 // filter class
 
+struct RandomVariable;
+
 struct Filter {
     // ctors
     ~Filter();
@@ -94,6 +96,7 @@ struct Filter {
     friend Filter equal(Filter, const Filter&);
     friend Filter operator!(Filter);
     friend bool operator==(const Filter&, const Filter&);
+    friend RandomVariable conditionalResult(const Filter&, RandomVariable, const RandomVariable&);
 
     // expand vector to full size and set deterministic to false
     void expand();
@@ -223,6 +226,7 @@ struct RandomVariable {
     void expand();
     // pointer to raw data, this is null for deterministic variables
     double* data();
+    const double* data() const;
 
     static std::function<void(RandomVariable&)> deleter;
 
@@ -241,7 +245,7 @@ private:
          - data_ = nullptr
        - if deterministic = false a possibly non-constant value is represented with
          - constantData_ initialized with last constant value that was set
-         - data_ an array of size n_
+         - data_ an array of size n_ obtained from the AlignedBufferPool
     */
     Size n_;
     double constantData_;
@@ -301,13 +305,33 @@ std::vector<RandomVariable> applyCoordinateTransform(const std::vector<const Ran
 std::vector<const RandomVariable*> vec2vecptr(const std::vector<RandomVariable>& values);
 
 // compute regression coefficients
-enum class RandomVariableRegressionMethod { QR, SVD };
+/* NormalEquations accumulates X^T X and X^T y over blocks of samples without building the full design matrix and
+   solves them via Cholesky, falling back to QR if the system is ill-conditioned */
+enum class RandomVariableRegressionMethod { QR, SVD, NormalEquations };
 Array regressionCoefficients(
     RandomVariable r, std::vector<const RandomVariable*> regressor,
     const std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>& basisFn,
     const Filter& filter = Filter(), const RandomVariableRegressionMethod = RandomVariableRegressionMethod::QR,
     const std::string& debugLabel = std::string());
 
+/* Cholesky factorisation of the equilibrated normal equations X^T X for given regressors, basis functions and filter,
+   this can be reused to compute the regression coefficients of several regressands. If the system is too
+   ill-conditioned, valid is false and regressionCoefficients() falls back to QR. */
+struct NormalEquationsFactorisation {
+    bool valid = false;
+    Size samples = 0;
+    std::vector<double> choleskyFactor;
+    std::vector<double> scale;
+};
+NormalEquationsFactorisation normalEquationsFactorisation(
+    const std::vector<const RandomVariable*>& regressor,
+    const std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>& basisFn,
+    const Filter& filter, const Size samples);
+Array regressionCoefficients(
+    const RandomVariable& r, const std::vector<const RandomVariable*>& regressor,
+    const std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>& basisFn,
+    const Filter& filter, const NormalEquationsFactorisation& factorisation);
+
 // evaluate regression function
 RandomVariable conditionalExpectation(
     const std::vector<const RandomVariable*>& regressor,
@@ -372,6 +396,8 @@ inline Real RandomVariable::at(const Size i) const {
 
 inline double* RandomVariable::data() { return data_; }
 
+inline const double* RandomVariable::data() const { return data_; }
+
 /*! helper function that returns a LSM basis system with size restriction: the order is reduced until
   the size of the basis system is not greater than the given bound (if this is not null) or the order is 1 */
 std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>
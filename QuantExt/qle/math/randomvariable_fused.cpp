@@ -0,0 +1,354 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/math/randomvariable_fused.hpp>
+#include <qle/math/randomvariable_opcodes.hpp>
+#include <qle/math/randomvariablekernels.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/math/comparison.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <thread>
+#include <type_traits>
+
+namespace QuantExt {
+
+namespace {
+
+// r = kernel(a) for m samples, for single precision the kernel is applied to a double buffer tmp of size m
+template <class T>
+void applyKernel(void (*kernel)(const std::size_t, double*), const Size m, T* r, const T* a, double* tmp) {
+    if constexpr (std::is_same_v<T, double>) {
+        std::copy(a, a + m, r);
+        kernel(m, r);
+    } else {
+        std::copy(a, a + m, tmp);
+        kernel(m, tmp);
+        std::copy(tmp, tmp + m, r);
+    }
+}
+
+// r = op(a[0], a[1], ...) for m samples, r does not alias any of the arguments
+template <class T>
+void applyElementwise(const std::size_t opCode, const Size m, T* r, const std::vector<const T*>& a, double* tmp) {
+    switch (opCode) {
+    case RandomVariableOpCode::Add:
+        std::copy(a[0], a[0] + m, r);
+        for (Size j = 1; j < a.size(); ++j)
+            RandomVariableKernels::add(m, r, a[j]);
+        break;
+    case RandomVariableOpCode::Subtract:
+        std::copy(a[0], a[0] + m, r);
+        RandomVariableKernels::subtract(m, r, a[1]);
+        break;
+    case RandomVariableOpCode::Negative:
+        for (Size i = 0; i < m; ++i)
+            r[i] = -a[0][i];
+        break;
+    case RandomVariableOpCode::Mult:
+        std::copy(a[0], a[0] + m, r);
+        RandomVariableKernels::multiply(m, r, a[1]);
+        break;
+    case RandomVariableOpCode::Div:
+        std::copy(a[0], a[0] + m, r);
+        RandomVariableKernels::divide(m, r, a[1]);
+        break;
+    case RandomVariableOpCode::IndicatorEq:
+        for (Size i = 0; i < m; ++i)
+            r[i] = QuantLib::close_enough(a[0][i], a[1][i]) ? T(1) : T(0);
+        break;
+    case RandomVariableOpCode::IndicatorGt:
+        if constexpr (std::is_same_v<T, double>) {
+            std::copy(a[0], a[0] + m, r);
+            RandomVariableKernels::indicatorGt(m, r, a[1], 1.0, 0.0);
+        } else {
+            for (Size i = 0; i < m; ++i)
+                r[i] = (a[0][i] > a[1][i] && !QuantLib::close_enough(a[0][i], a[1][i])) ? 1.0f : 0.0f;
+        }
+        break;
+    case RandomVariableOpCode::IndicatorGeq:
+        for (Size i = 0; i < m; ++i)
+            r[i] = (a[0][i] > a[1][i] || QuantLib::close_enough(a[0][i], a[1][i])) ? T(1) : T(0);
+        break;
+    case RandomVariableOpCode::Min:
+        for (Size i = 0; i < m; ++i)
+            r[i] = std::min(a[0][i], a[1][i]);
+        break;
+    case RandomVariableOpCode::Max:
+        for (Size i = 0; i < m; ++i)
+            r[i] = std::max(a[0][i], a[1][i]);
+        break;
+    case RandomVariableOpCode::Abs:
+        for (Size i = 0; i < m; ++i)
+            r[i] = std::abs(a[0][i]);
+        break;
+    case RandomVariableOpCode::Exp:
+        applyKernel<T>(&RandomVariableKernels::exp, m, r, a[0], tmp);
+        break;
+    case RandomVariableOpCode::Sqrt:
+        applyKernel<T>(&RandomVariableKernels::sqrt, m, r, a[0], tmp);
+        break;
+    case RandomVariableOpCode::Log:
+        applyKernel<T>(&RandomVariableKernels::log, m, r, a[0], tmp);
+        break;
+    case RandomVariableOpCode::Pow:
+        for (Size i = 0; i < m; ++i)
+            r[i] = std::pow(a[0][i], a[1][i]);
+        break;
+    case RandomVariableOpCode::NormalCdf:
+        applyKernel<T>(&RandomVariableKernels::normalCdf, m, r, a[0], tmp);
+        break;
+    case RandomVariableOpCode::NormalPdf:
+        applyKernel<T>(&RandomVariableKernels::normalPdf, m, r, a[0], tmp);
+        break;
+    default:
+        QL_FAIL("FusedRandomVariableKernel: op code " << opCode << " is not fusable");
+    }
+}
+
+Size numberOfArgs(const std::size_t opCode) {
+    switch (opCode) {
+    case RandomVariableOpCode::Add:
+        return 0; // variable
+    case RandomVariableOpCode::Negative:
+    case RandomVariableOpCode::Abs:
+    case RandomVariableOpCode::Exp:
+    case RandomVariableOpCode::Sqrt:
+    case RandomVariableOpCode::Log:
+    case RandomVariableOpCode::NormalCdf:
+    case RandomVariableOpCode::NormalPdf:
+        return 1;
+    default:
+        return 2;
+    }
+}
+
+} // namespace
+
+bool isFusableRandomVariableOpCode(const std::size_t opCode, const double eps) {
+    switch (opCode) {
+    case RandomVariableOpCode::Add:
+    case RandomVariableOpCode::Subtract:
+    case RandomVariableOpCode::Negative:
+    case RandomVariableOpCode::Mult:
+    case RandomVariableOpCode::Div:
+    case RandomVariableOpCode::IndicatorEq:
+    case RandomVariableOpCode::Abs:
+    case RandomVariableOpCode::Exp:
+    case RandomVariableOpCode::Sqrt:
+    case RandomVariableOpCode::Log:
+    case RandomVariableOpCode::Pow:
+    case RandomVariableOpCode::NormalCdf:
+    case RandomVariableOpCode::NormalPdf:
+        return true;
+    case RandomVariableOpCode::IndicatorGt:
+    case RandomVariableOpCode::IndicatorGeq:
+    case RandomVariableOpCode::Min:
+    case RandomVariableOpCode::Max:
+        return eps == 0.0;
+    default:
+        return false;
+    }
+}
+
+FusedRandomVariableKernel::FusedRandomVariableKernel(const Size nInputs) : nInputs_(nInputs) {}
+
+Size FusedRandomVariableKernel::add(const std::size_t opCode, const std::vector<Size>& args) {
+    QL_REQUIRE(isFusableRandomVariableOpCode(opCode), "FusedRandomVariableKernel::add(): op code " << opCode
+                                                                                                  << " is not fusable");
+    Size n = numberOfArgs(opCode);
+    QL_REQUIRE(n == 0 ? !args.empty() : args.size() == n, "FusedRandomVariableKernel::add(): op code "
+                                                               << opCode << " got " << args.size() << " args");
+    for (auto const& a : args) {
+        QL_REQUIRE(a < nInputs_ + ops_.size(), "FusedRandomVariableKernel::add(): arg slot "
+                                                   << a << " out of range, number of slots is "
+                                                   << nInputs_ + ops_.size());
+    }
+    ops_.push_back({opCode, args});
+    return nInputs_ + ops_.size() - 1;
+}
+
+void FusedRandomVariableKernel::markOutput(const Size slot) {
+    QL_REQUIRE(slot < nInputs_ + ops_.size(), "FusedRandomVariableKernel::markOutput(): slot "
+                                                  << slot << " out of range, number of slots is "
+                                                  << nInputs_ + ops_.size());
+    outputs_.push_back(slot);
+}
+
+template <class V, class T>
+std::vector<V> FusedRandomVariableKernel::evaluateImpl(const std::vector<const V*>& inputs, const Size nThreads) const {
+
+    QL_REQUIRE(inputs.size() == nInputs_, "FusedRandomVariableKernel::evaluate(): got " << inputs.size()
+                                                                                        << " inputs, expected "
+                                                                                        << nInputs_);
+    QL_REQUIRE(nInputs_ > 0, "FusedRandomVariableKernel::evaluate(): no inputs");
+
+    Size n = inputs.front()->size();
+    for (auto const& i : inputs) {
+        QL_REQUIRE(i->initialised(), "FusedRandomVariableKernel::evaluate(): input is not initialised");
+        QL_REQUIRE(i->size() == n, "FusedRandomVariableKernel::evaluate(): input sizes differ (" << i->size()
+                                                                                                 << ", " << n << ")");
+    }
+
+    // determine the deterministic slots and their values
+
+    Size nSlots = nInputs_ + ops_.size();
+    std::vector<bool> deterministic(nSlots, true);
+    std::vector<double> constant(nSlots, 0.0);
+    std::vector<const double*> args;
+
+    for (Size s = 0; s < nInputs_; ++s) {
+        deterministic[s] = inputs[s]->deterministic();
+        if (deterministic[s])
+            constant[s] = inputs[s]->at(0);
+    }
+
+    for (Size k = 0; k < ops_.size(); ++k) {
+        Size s = nInputs_ + k;
+        for (auto const& a : ops_[k].args)
+            deterministic[s] = deterministic[s] && deterministic[a];
+        if (deterministic[s]) {
+            args.clear();
+            for (auto const& a : ops_[k].args)
+                args.push_back(&constant[a]);
+            applyElementwise<double>(ops_[k].opCode, 1, &constant[s], args, nullptr);
+        }
+    }
+
+    // set up the outputs, non-deterministic outputs are written directly
+
+    std::vector<V> result;
+    std::vector<Size> outputIndex(nSlots, Null<Size>());
+    std::vector<std::pair<Size, Size>> duplicateOutputs;
+    for (auto const& s : outputs_) {
+        if (outputIndex[s] != Null<Size>()) {
+            duplicateOutputs.push_back(std::make_pair(result.size(), outputIndex[s]));
+            result.push_back(V());
+        } else if (deterministic[s]) {
+            result.push_back(V(n, static_cast<T>(constant[s])));
+        } else if (s < nInputs_) {
+            result.push_back(*inputs[s]);
+        } else {
+            result.push_back(V(n, T(0)));
+            result.back().expand();
+            outputIndex[s] = result.size() - 1;
+        }
+    }
+
+    /* scratch buffers: one block for each deterministic slot used by a non-deterministic op (filled with the constant
+       value) and one block for each non-deterministic op result that is not an output */
+
+    std::vector<Size> scratchIndex(nSlots, Null<Size>());
+    Size nScratch = 0;
+    for (Size k = 0; k < ops_.size(); ++k) {
+        Size s = nInputs_ + k;
+        if (deterministic[s])
+            continue;
+        for (auto const& a : ops_[k].args) {
+            if (deterministic[a] && scratchIndex[a] == Null<Size>())
+                scratchIndex[a] = nScratch++;
+        }
+        if (outputIndex[s] == Null<Size>())
+            scratchIndex[s] = nScratch++;
+    }
+
+    // evaluate the non-deterministic ops on the sample blocks [firstBlock, lastBlock)
+
+    auto processBlocks = [this, n, nSlots, nScratch, &inputs, &deterministic, &constant, &scratchIndex, &outputIndex,
+                          &result](const Size firstBlock, const Size lastBlock) {
+        std::vector<T> scratch(nScratch * blockSize);
+        std::vector<double> tmp(blockSize);
+        for (Size s = 0; s < nSlots; ++s) {
+            if (deterministic[s] && scratchIndex[s] != Null<Size>())
+                std::fill(&scratch[scratchIndex[s] * blockSize], &scratch[scratchIndex[s] * blockSize] + blockSize,
+                          static_cast<T>(constant[s]));
+        }
+        std::vector<const T*> block(nSlots, nullptr);
+        std::vector<const T*> blockArgs;
+        for (Size offset = firstBlock * blockSize; offset < std::min(n, lastBlock * blockSize); offset += blockSize) {
+            Size m = std::min(blockSize, n - offset);
+            for (Size s = 0; s < nInputs_; ++s) {
+                if (!deterministic[s])
+                    block[s] = inputs[s]->data() + offset;
+            }
+            for (Size k = 0; k < ops_.size(); ++k) {
+                Size s = nInputs_ + k;
+                if (deterministic[s])
+                    continue;
+                blockArgs.clear();
+                for (auto const& a : ops_[k].args)
+                    blockArgs.push_back(deterministic[a] ? &scratch[scratchIndex[a] * blockSize] : block[a]);
+                T* r = outputIndex[s] == Null<Size>() ? &scratch[scratchIndex[s] * blockSize]
+                                                      : result[outputIndex[s]].data() + offset;
+                applyElementwise<T>(ops_[k].opCode, m, r, blockArgs, &tmp[0]);
+                block[s] = r;
+            }
+        }
+    };
+
+    /* distribute contiguous ranges of blocks on the threads, a thread is only used if it gets enough work to
+       justify its start up cost */
+
+    Size nBlocks = (n + blockSize - 1) / blockSize;
+    Size workPerBlock = std::max<Size>(ops_.size(), 1) * blockSize;
+    Size effThreads = std::max<Size>(1, std::min<Size>({nThreads, nBlocks, nBlocks * workPerBlock / minWorkPerThread}));
+
+    if (effThreads == 1) {
+        processBlocks(0, nBlocks);
+    } else {
+        std::vector<std::thread> workers;
+        std::vector<std::exception_ptr> errors(effThreads);
+        Size blocksPerThread = (nBlocks + effThreads - 1) / effThreads;
+        for (Size t = 0; t < effThreads; ++t) {
+            workers.emplace_back([t, blocksPerThread, nBlocks, &processBlocks, &errors]() {
+                try {
+                    processBlocks(t * blocksPerThread, std::min(nBlocks, (t + 1) * blocksPerThread));
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        for (auto const& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+    }
+
+    for (auto const& [i, j] : duplicateOutputs)
+        result[i] = result[j];
+
+    return result;
+}
+
+std::vector<RandomVariable> FusedRandomVariableKernel::evaluate(const std::vector<const RandomVariable*>& inputs,
+                                                                const Size nThreads) const {
+    return evaluateImpl<RandomVariable, double>(inputs, nThreads);
+}
+
+std::vector<FloatRandomVariable>
+FusedRandomVariableKernel::evaluate(const std::vector<const FloatRandomVariable*>& inputs,
+                                    const Size nThreads) const {
+    return evaluateImpl<FloatRandomVariable, float>(inputs, nThreads);
+}
+
+} // namespace QuantExt
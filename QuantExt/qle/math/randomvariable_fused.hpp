@@ -0,0 +1,93 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/math/randomvariable_fused.hpp
+    \brief single pass evaluation of chains of elementwise random variable operations
+    \ingroup math
+*/
+
+#pragma once
+
+#include <qle/math/floatrandomvariable.hpp>
+#include <qle/math/randomvariable.hpp>
+
+#include <vector>
+
+namespace QuantExt {
+
+//! true if the op with the given RandomVariableOpCode acts elementwise on its arguments and can be fused
+/*! For eps != 0 the smoothed indicator, min and max ops depend on the whole sample and are not fusable. */
+bool isFusableRandomVariableOpCode(const std::size_t opCode, const double eps = 0.0);
+
+//! Single pass evaluation of a chain of elementwise random variable operations
+/*! The chain is given as a sequence of ops identified by their RandomVariableOpCode. The arguments of each op refer to
+    slots, where slots 0, ..., nInputs - 1 hold the input random variables and slot nInputs + k holds the result of
+    the k-th op added to the kernel.
+
+    The evaluation runs over the samples in blocks of blockSize, so that intermediate results never leave a small
+    scratch buffer and each input and output random variable is read resp. written exactly once. Only the slots
+    marked as output are materialised as random variables. Deterministic inputs are handled as in the RandomVariable
+    operations, i.e. a result is deterministic if and only if all its arguments are deterministic.
+
+    The results agree with those of the individual RandomVariable operations up to rounding where the latter skip
+    computations for deterministic arguments (e.g. x * y with y close to one). Time stamps are not propagated. */
+class FusedRandomVariableKernel {
+public:
+    static constexpr Size blockSize = 256;
+    //! minimum number of sample operations per thread in a multi-threaded evaluation
+    static constexpr Size minWorkPerThread = 262144;
+
+    explicit FusedRandomVariableKernel(const Size nInputs);
+
+    //! append an op, returns the slot holding its result
+    Size add(const std::size_t opCode, const std::vector<Size>& args);
+    //! mark a slot to be materialised by evaluate()
+    void markOutput(const Size slot);
+
+    Size nInputs() const { return nInputs_; }
+    Size size() const { return ops_.size(); }
+    //! op code and argument slots of the k-th op
+    std::size_t opCode(const Size k) const { return ops_[k].opCode; }
+    const std::vector<Size>& args(const Size k) const { return ops_[k].args; }
+    //! the slots marked as output, in the order of marking
+    const std::vector<Size>& outputs() const { return outputs_; }
+
+    /*! Evaluate the chain. Returns the marked output slots in the order of marking. All inputs must be initialised
+        and have the same size. For nThreads > 1 the sample blocks are split into contiguous ranges which are evaluated
+        in parallel, each thread running the whole chain on its range. Fewer threads are used if there is not enough
+        work to justify their start up. The results do not depend on the number of threads. */
+    std::vector<RandomVariable> evaluate(const std::vector<const RandomVariable*>& inputs,
+                                         const Size nThreads = 1) const;
+    /*! Single precision evaluation, transcendental functions are evaluated in double precision. Deterministic
+        slots are evaluated in double precision and rounded. */
+    std::vector<FloatRandomVariable> evaluate(const std::vector<const FloatRandomVariable*>& inputs,
+                                              const Size nThreads = 1) const;
+
+private:
+    template <class V, class T>
+    std::vector<V> evaluateImpl(const std::vector<const V*>& inputs, const Size nThreads) const;
+    struct Op {
+        std::size_t opCode;
+        std::vector<Size> args;
+    };
+    Size nInputs_;
+    std::vector<Op> ops_;
+    std::vector<Size> outputs_;
+};
+
+} // namespace QuantExt
@@ -0,0 +1,317 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/math/randomvariable_jit.hpp>
+#include <qle/math/randomvariable_opcodes.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#ifdef ORE_ENABLE_CPU_JIT
+#include <dlfcn.h>
+#endif
+
+namespace QuantExt {
+
+namespace {
+
+// C expression for an op applied to the local variables holding its arguments
+std::string expression(const std::size_t opCode, const std::vector<Size>& args) {
+    auto v = [&args](const Size i) { return "v" + std::to_string(args[i]); };
+    switch (opCode) {
+    case RandomVariableOpCode::Add: {
+        std::string r = v(0);
+        for (Size i = 1; i < args.size(); ++i)
+            r += " + " + v(i);
+        return r;
+    }
+    case RandomVariableOpCode::Subtract:
+        return v(0) + " - " + v(1);
+    case RandomVariableOpCode::Negative:
+        return "-" + v(0);
+    case RandomVariableOpCode::Mult:
+        return v(0) + " * " + v(1);
+    case RandomVariableOpCode::Div:
+        return v(0) + " / " + v(1);
+    case RandomVariableOpCode::IndicatorEq:
+        return "ore_close(" + v(0) + ", " + v(1) + ") ? 1.0 : 0.0";
+    case RandomVariableOpCode::IndicatorGt:
+        return "(" + v(0) + " > " + v(1) + " && !ore_close(" + v(0) + ", " + v(1) + ")) ? 1.0 : 0.0";
+    case RandomVariableOpCode::IndicatorGeq:
+        return "(" + v(0) + " > " + v(1) + " || ore_close(" + v(0) + ", " + v(1) + ")) ? 1.0 : 0.0";
+    case RandomVariableOpCode::Min:
+        return v(1) + " < " + v(0) + " ? " + v(1) + " : " + v(0);
+    case RandomVariableOpCode::Max:
+        return v(0) + " < " + v(1) + " ? " + v(1) + " : " + v(0);
+    case RandomVariableOpCode::Abs:
+        return "fabs(" + v(0) + ")";
+    case RandomVariableOpCode::Exp:
+        return "exp(" + v(0) + ")";
+    case RandomVariableOpCode::Sqrt:
+        return "sqrt(" + v(0) + ")";
+    case RandomVariableOpCode::Log:
+        return "log(" + v(0) + ")";
+    case RandomVariableOpCode::Pow:
+        return "pow(" + v(0) + ", " + v(1) + ")";
+    case RandomVariableOpCode::NormalCdf:
+        return "ore_ncdf(" + v(0) + ")";
+    case RandomVariableOpCode::NormalPdf:
+        return "ore_npdf(" + v(0) + ")";
+    default:
+        QL_FAIL("RandomVariableJitModule: op code " << opCode << " is not supported");
+    }
+}
+
+std::string environmentVariable(const char* name, const std::string& defaultValue) {
+    const char* v = std::getenv(name);
+    return v == nullptr || std::string(v).empty() ? defaultValue : std::string(v);
+}
+
+} // namespace
+
+bool RandomVariableJitModule::available() {
+#ifdef ORE_ENABLE_CPU_JIT
+    return true;
+#else
+    return false;
+#endif
+}
+
+Size RandomVariableJitModule::add(const FusedRandomVariableKernel& kernel) {
+    QL_REQUIRE(!compiled(), "RandomVariableJitModule::add(): module is already compiled");
+    Kernel k;
+    k.nInputs = kernel.nInputs();
+    for (Size i = 0; i < kernel.size(); ++i) {
+        k.opCodes.push_back(kernel.opCode(i));
+        k.args.push_back(kernel.args(i));
+    }
+    k.outputs = kernel.outputs();
+    kernels_.push_back(k);
+    return kernels_.size() - 1;
+}
+
+std::string RandomVariableJitModule::source() const {
+    std::ostringstream s;
+    s << "#include <float.h>\n"
+         "#include <math.h>\n\n"
+         "static int ore_close(const double x, const double y) {\n"
+         "    if (x == y)\n"
+         "        return 1;\n"
+         "    double d = fabs(x - y), tol = 42.0 * DBL_EPSILON;\n"
+         "    return d <= tol * fabs(x) || d <= tol * fabs(y);\n"
+         "}\n\n"
+         "static double ore_ncdf(const double x) { return 0.5 * erfc(-x * 0.70710678118654752440); }\n\n"
+         "static double ore_npdf(const double x) { return 0.39894228040143267794 * exp(-0.5 * x * x); }\n";
+    for (Size k = 0; k < kernels_.size(); ++k) {
+        const Kernel& ker = kernels_[k];
+        s << "\nvoid ore_rv_kernel_" << k
+          << "(const double* const* in, const unsigned long* is, double* const* out, const unsigned long* os,\n"
+             "    unsigned long begin, unsigned long end) {\n";
+        for (Size i = 0; i < ker.nInputs; ++i)
+            s << "    const double* const in" << i << " = in[" << i << "];\n";
+        for (Size i = 0; i < ker.outputs.size(); ++i)
+            s << "    double* const out" << i << " = out[" << i << "];\n";
+        s << "    for (unsigned long j = begin; j < end; ++j) {\n";
+        for (Size i = 0; i < ker.nInputs; ++i)
+            s << "        const double v" << i << " = in" << i << "[j * is[" << i << "]];\n";
+        for (Size i = 0; i < ker.opCodes.size(); ++i)
+            s << "        const double v" << ker.nInputs + i << " = " << expression(ker.opCodes[i], ker.args[i])
+              << ";\n";
+        for (Size i = 0; i < ker.outputs.size(); ++i)
+            s << "        out" << i << "[j * os[" << i << "]] = v" << ker.outputs[i] << ";\n";
+        s << "    }\n}\n";
+    }
+    return s.str();
+}
+
+void RandomVariableJitModule::compile() {
+    QL_REQUIRE(!compiled(), "RandomVariableJitModule::compile(): module is already compiled");
+#ifdef ORE_ENABLE_CPU_JIT
+
+    /* modules with the same source share the library, which is unloaded when the last module using it is destroyed;
+       the cache is keyed by the full source, so that a hash collision can not hand out a library with other kernels */
+
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<void>> cache;
+
+    std::string src = source();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto c = cache.find(src); c != cache.end())
+            library_ = c->second.lock();
+
+        if (library_ == nullptr) {
+            std::string base = (boost::filesystem::temp_directory_path() /
+                                boost::filesystem::unique_path("ore_jit_%%%%%%%%%%%%%%%%"))
+                                   .string();
+            std::string srcFile = base + ".c", libFile = base + ".so";
+            {
+                std::ofstream out(srcFile);
+                out << src;
+                QL_REQUIRE(out.good(), "RandomVariableJitModule::compile(): could not write '" << srcFile << "'");
+            }
+            std::string cmd = environmentVariable("ORE_CPU_JIT_COMPILER", "cc") + " " +
+                              environmentVariable("ORE_CPU_JIT_FLAGS", "-std=c99 -O3 -march=native -fPIC -shared") +
+                              " -o \"" + libFile + "\" \"" + srcFile + "\" -lm";
+            int rc = std::system(cmd.c_str());
+            boost::filesystem::remove(srcFile);
+            QL_REQUIRE(rc == 0, "RandomVariableJitModule::compile(): '" << cmd << "' failed with return code " << rc);
+            void* handle = dlopen(libFile.c_str(), RTLD_NOW | RTLD_LOCAL);
+            boost::filesystem::remove(libFile);
+            QL_REQUIRE(handle != nullptr, "RandomVariableJitModule::compile(): dlopen() failed: " << dlerror());
+            library_ = std::shared_ptr<void>(handle, [](void* h) { dlclose(h); });
+            // drop the entries of unloaded libraries, so that the cache does not grow with the number of sources
+            for (auto c = cache.begin(); c != cache.end();)
+                c = c->second.expired() ? cache.erase(c) : std::next(c);
+            cache[src] = library_;
+        }
+    }
+
+    functions_.clear();
+    for (Size k = 0; k < kernels_.size(); ++k) {
+        std::string name = "ore_rv_kernel_" + std::to_string(k);
+        void* f = dlsym(library_.get(), name.c_str());
+        QL_REQUIRE(f != nullptr, "RandomVariableJitModule::compile(): symbol '" << name << "' not found");
+        functions_.push_back(reinterpret_cast<KernelFunction>(f));
+    }
+
+#else
+    QL_FAIL("RandomVariableJitModule::compile(): not available, build with ORE_ENABLE_CPU_JIT");
+#endif
+}
+
+std::vector<RandomVariable> RandomVariableJitModule::evaluate(const Size k,
+                                                              const std::vector<const RandomVariable*>& inputs,
+                                                              const Size nThreads) const {
+
+    QL_REQUIRE(compiled(), "RandomVariableJitModule::evaluate(): module is not compiled");
+    QL_REQUIRE(k < kernels_.size(), "RandomVariableJitModule::evaluate(): kernel " << k << " out of range, module has "
+                                                                                   << kernels_.size() << " kernels");
+
+    const Kernel& ker = kernels_[k];
+
+    QL_REQUIRE(inputs.size() == ker.nInputs, "RandomVariableJitModule::evaluate(): got "
+                                                 << inputs.size() << " inputs, expected " << ker.nInputs);
+    QL_REQUIRE(ker.nInputs > 0, "RandomVariableJitModule::evaluate(): no inputs");
+
+    Size n = inputs.front()->size();
+    for (auto const& i : inputs) {
+        QL_REQUIRE(i->initialised(), "RandomVariableJitModule::evaluate(): input is not initialised");
+        QL_REQUIRE(i->size() == n, "RandomVariableJitModule::evaluate(): input sizes differ (" << i->size() << ", "
+                                                                                               << n << ")");
+    }
+
+    // deterministic inputs are passed with stride zero
+
+    Size nSlots = ker.nInputs + ker.opCodes.size();
+    std::vector<bool> deterministic(nSlots, true);
+    std::vector<double> constant(ker.nInputs);
+    std::vector<const double*> in(ker.nInputs);
+    std::vector<unsigned long> inStride(ker.nInputs);
+    for (Size s = 0; s < ker.nInputs; ++s) {
+        deterministic[s] = inputs[s]->deterministic();
+        if (deterministic[s]) {
+            constant[s] = inputs[s]->at(0);
+            in[s] = &constant[s];
+            inStride[s] = 0;
+        } else {
+            in[s] = inputs[s]->data();
+            inStride[s] = 1;
+        }
+    }
+    for (Size i = 0; i < ker.opCodes.size(); ++i) {
+        for (auto const& a : ker.args[i])
+            deterministic[ker.nInputs + i] = deterministic[ker.nInputs + i] && deterministic[a];
+    }
+
+    /* non-deterministic outputs are written directly, deterministic outputs with stride zero to a buffer per thread;
+       if all outputs are deterministic a single sample is evaluated */
+
+    Size nOutputs = ker.outputs.size();
+    std::vector<RandomVariable> result(nOutputs);
+    std::vector<unsigned long> outStride(nOutputs, 0);
+    bool allDeterministic = true;
+    for (Size i = 0; i < nOutputs; ++i) {
+        if (!deterministic[ker.outputs[i]]) {
+            result[i] = RandomVariable(n, 0.0);
+            result[i].expand();
+            outStride[i] = 1;
+            allDeterministic = false;
+        }
+    }
+
+    Size m = allDeterministic ? 1 : n;
+    Size work = std::max<Size>(ker.opCodes.size(), 1) * m;
+    Size effThreads =
+        std::max<Size>(1, std::min<Size>({nThreads, m, work / FusedRandomVariableKernel::minWorkPerThread}));
+    std::vector<std::vector<double>> buffer(effThreads, std::vector<double>(nOutputs));
+
+    KernelFunction f = functions_[k];
+    auto run = [f, m, effThreads, nOutputs, &in, &inStride, &outStride, &result, &buffer](const Size t) {
+        std::vector<double*> out(nOutputs);
+        for (Size i = 0; i < nOutputs; ++i)
+            out[i] = outStride[i] == 0 ? &buffer[t][i] : result[i].data();
+        Size chunk = (m + effThreads - 1) / effThreads;
+        Size begin = std::min(m, t * chunk), end = std::min(m, (t + 1) * chunk);
+        if (begin < end)
+            f(in.data(), inStride.data(), out.data(), outStride.data(), begin, end);
+    };
+
+    if (effThreads == 1) {
+        run(0);
+    } else {
+        std::vector<std::thread> workers;
+        std::vector<std::exception_ptr> errors(effThreads);
+        for (Size t = 0; t < effThreads; ++t) {
+            workers.emplace_back([t, &run, &errors]() {
+                try {
+                    run(t);
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+        for (auto const& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+    }
+
+    for (Size i = 0; i < nOutputs; ++i) {
+        if (outStride[i] == 0)
+            result[i] = RandomVariable(n, buffer[0][i]);
+    }
+
+    return result;
+}
+
+} // namespace QuantExt
@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/math/randomvariable_jit.hpp
+    \brief just in time compilation of chains of elementwise random variable operations to native code
+    \ingroup math
+*/
+
+#pragma once
+
+#include <qle/math/randomvariable.hpp>
+#include <qle/math/randomvariable_fused.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace QuantExt {
+
+//! A module of fused random variable kernels compiled to native code
+/*! Each kernel added to the module is translated to a C function running a single loop over the samples, with all
+    intermediate results held in local variables, so that the compiler can keep them in registers and vectorise the
+    loop. All kernels of a module are compiled into one shared library, which is loaded into the process. Modules with
+    the same source share the compiled library.
+
+    The compiler is invoked as
+
+    $ORE_CPU_JIT_COMPILER $ORE_CPU_JIT_FLAGS -o <library> <source> -lm
+
+    with the defaults "cc" and "-std=c99 -O3 -march=native -fPIC -shared", the latter does not allow the contraction
+    of floating point operations. Compilation is only available if ORE_ENABLE_CPU_JIT is defined and on platforms
+    supporting dlopen().
+
+    The results agree with those of the FusedRandomVariableKernel up to rounding, since the transcendental functions
+    are taken from the C math library. Deterministic inputs are handled as in the FusedRandomVariableKernel. */
+class RandomVariableJitModule {
+public:
+    RandomVariableJitModule() = default;
+
+    //! true if the compilation is supported by the build
+    static bool available();
+
+    //! add a kernel, returns its index in the module; the module must not be compiled yet
+    Size add(const FusedRandomVariableKernel& kernel);
+    Size size() const { return kernels_.size(); }
+
+    //! the C source of the module
+    std::string source() const;
+
+    //! compile and load the module
+    void compile();
+    bool compiled() const { return library_ != nullptr; }
+
+    /*! Evaluate the k-th kernel, returns the marked output slots in the order of marking. The inputs must satisfy
+        the same conditions as in FusedRandomVariableKernel::evaluate(). */
+    std::vector<RandomVariable> evaluate(const Size k, const std::vector<const RandomVariable*>& inputs,
+                                         const Size nThreads = 1) const;
+
+private:
+    typedef void (*KernelFunction)(const double* const* in, const unsigned long* inStride, double* const* out,
+                                   const unsigned long* outStride, unsigned long begin, unsigned long end);
+    struct Kernel {
+        Size nInputs;
+        std::vector<std::size_t> opCodes;
+        std::vector<std::vector<Size>> args;
+        std::vector<Size> outputs;
+    };
+    std::vector<Kernel> kernels_;
+    std::shared_ptr<void> library_;
+    std::vector<KernelFunction> functions_;
+};
+
+} // namespace QuantExt
@@ -0,0 +1,286 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/math/randomvariablekernels.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) && defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+#define QLE_KERNEL __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define QLE_KERNEL
+#endif
+
+namespace QuantExt {
+namespace RandomVariableKernels {
+
+namespace {
+
+constexpr double ln2Hi = 6.93147180369123816490e-01;
+constexpr double ln2Lo = 1.90821492927058770002e-10;
+constexpr double log2e = 1.44269504088896338700e+00;
+constexpr double sqrt2 = 1.41421356237309514547e+00;
+constexpr double sqrt2Pi = 2.50662827463100024161e+00;
+// 1.5 * 2^52, adding and subtracting this rounds to the nearest integer which is then also held in the low bits
+constexpr double roundShift = 6755399441055744.0;
+constexpr double expMaxArg = 709.782712893383973096;
+// below this the 2^(k-1) scaling in expKernel() would need a subnormal exponent (k < -1021), results are flushed to 0
+constexpr double expMinArg = -708.0;
+
+inline std::uint64_t toBits(const double x) {
+    std::uint64_t b;
+    std::memcpy(&b, &x, sizeof(double));
+    return b;
+}
+
+inline double fromBits(const std::uint64_t b) {
+    double x;
+    std::memcpy(&x, &b, sizeof(double));
+    return x;
+}
+
+inline double expKernel(const double x) {
+    double xc = x < expMinArg ? expMinArg : (x > expMaxArg ? expMaxArg : x);
+    double t = xc * log2e + roundShift;
+    double k = t - roundShift;
+    double r = (xc - k * ln2Hi) - k * ln2Lo;
+    double p = 1.0 / 6227020800.0;
+    p = p * r + 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+    // scale by 2^(k-1) and 2 separately to avoid an overflow of the exponent for k = 1024
+    std::uint64_t scale = (toBits(t) - toBits(roundShift) + 1022) << 52;
+    double res = (2.0 * p) * fromBits(scale);
+    res = x > expMaxArg ? std::numeric_limits<double>::infinity() : res;
+    res = x < expMinArg ? 0.0 : res;
+    return x != x ? x : res;
+}
+
+inline double logKernel(const double x) {
+    bool subnormal = x < std::numeric_limits<double>::min();
+    double xs = subnormal ? x * 18014398509481984.0 : x;
+    std::uint64_t b = toBits(xs);
+    std::uint64_t e = ((b >> 52) & 0x7ff) - (subnormal ? 1077 : 1023);
+    double m = fromBits((b & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);
+    bool upper = m > sqrt2;
+    m = upper ? 0.5 * m : m;
+    e = upper ? e + 1 : e;
+    double ed = fromBits(toBits(roundShift) + e) - roundShift;
+    double f = (m - 1.0) / (m + 1.0);
+    double s = f * f;
+    double p = 1.0 / 23.0;
+    p = p * s + 1.0 / 21.0;
+    p = p * s + 1.0 / 19.0;
+    p = p * s + 1.0 / 17.0;
+    p = p * s + 1.0 / 15.0;
+    p = p * s + 1.0 / 13.0;
+    p = p * s + 1.0 / 11.0;
+    p = p * s + 1.0 / 9.0;
+    p = p * s + 1.0 / 7.0;
+    p = p * s + 1.0 / 5.0;
+    p = p * s + 1.0 / 3.0;
+    double res = ed * ln2Hi + (ed * ln2Lo + (2.0 * f + 2.0 * f * s * p));
+    res = x == 0.0 ? -std::numeric_limits<double>::infinity() : res;
+    res = x < 0.0 ? std::numeric_limits<double>::quiet_NaN() : res;
+    res = x == std::numeric_limits<double>::infinity() ? x : res;
+    return x != x ? x : res;
+}
+
+/* exp(-x^2/2) with x^2 = h + l split exactly (Dekker), so that the relative error does not grow with x^2 */
+inline double gaussianKernel(const double x) {
+    double c = 134217729.0 * x;
+    double xh = c - (c - x);
+    double xl = x - xh;
+    double h = x * x;
+    double l = ((xh * xh - h) + 2.0 * xh * xl) + xl * xl;
+    return expKernel(-0.5 * h) * (1.0 - 0.5 * l);
+}
+
+inline double normalCdfKernel(const double x) {
+    double xa = std::fabs(x);
+    double ex = gaussianKernel(xa);
+    double num = 3.52624965998911E-02 * xa + 0.700383064443688;
+    num = num * xa + 6.37396220353165;
+    num = num * xa + 33.912866078383;
+    num = num * xa + 112.079291497871;
+    num = num * xa + 221.213596169931;
+    num = num * xa + 220.206867912376;
+    double den = 8.83883476483184E-02 * xa + 1.75566716318264;
+    den = den * xa + 16.064177579207;
+    den = den * xa + 86.7807322029461;
+    den = den * xa + 296.564248779674;
+    den = den * xa + 637.333633378831;
+    den = den * xa + 793.826512519948;
+    den = den * xa + 440.413735824752;
+    /* the rational approximation loses relative accuracy in the tail, we use the continued fraction
+       xa + 1 / (xa + 2 / (xa + 3 / ...)) there instead, evaluated with the forward recurrence for its convergents */
+    double a0 = 1.0, a1 = xa, b0 = 0.0, b1 = 1.0;
+#if defined(__GNUC__)
+#pragma GCC unroll 32
+#endif
+    for (int k = 1; k <= 32; ++k) {
+        double a2 = xa * a1 + static_cast<double>(k) * a0;
+        double b2 = xa * b1 + static_cast<double>(k) * b0;
+        a0 = a1;
+        a1 = a2;
+        b0 = b1;
+        b1 = b2;
+    }
+    double c = xa < 3.5 ? ex * num / den : ex * b1 / (a1 * sqrt2Pi);
+    c = xa > 37.0 ? 0.0 : c;
+    double res = x > 0.0 ? 1.0 - c : c;
+    return x != x ? x : res;
+}
+
+/* matches QuantLib::close_enough(x, y, 42) */
+inline bool closeEnough(const double x, const double y) {
+    constexpr double tol = 42.0 * std::numeric_limits<double>::epsilon();
+    double diff = std::fabs(x - y);
+    bool zero = x * y == 0.0;
+    return x == y || (zero && diff < tol * tol) ||
+           (!zero && (diff <= tol * std::fabs(x) || diff <= tol * std::fabs(y)));
+}
+
+} // namespace
+
+QLE_KERNEL void add(const std::size_t n, double* x, const double* y) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] += y[i];
+}
+
+QLE_KERNEL void subtract(const std::size_t n, double* x, const double* y) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] -= y[i];
+}
+
+QLE_KERNEL void multiply(const std::size_t n, double* x, const double* y) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] *= y[i];
+}
+
+QLE_KERNEL void divide(const std::size_t n, double* x, const double* y) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] /= y[i];
+}
+
+QLE_KERNEL void add(const std::size_t n, float* x, const float* y) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] += y[i];
+}
+
+QLE_KERNEL void subtract(const std::size_t n, float* x, const float* y) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] -= y[i];
+}
+
+QLE_KERNEL void multiply(const std::size_t n, float* x, const float* y) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] *= y[i];
+}
+
+QLE_KERNEL void divide(const std::size_t n, float* x, const float* y) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] /= y[i];
+}
+
+QLE_KERNEL void add(const std::size_t n, double* x, const double y) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] += y;
+}
+
+QLE_KERNEL void subtract(const std::size_t n, double* x, const double y) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] -= y;
+}
+
+QLE_KERNEL void multiply(const std::size_t n, double* x, const double y) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] *= y;
+}
+
+QLE_KERNEL void divide(const std::size_t n, double* x, const double y) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] /= y;
+}
+
+QLE_KERNEL void exp(const std::size_t n, double* x) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] = expKernel(x[i]);
+}
+
+QLE_KERNEL void log(const std::size_t n, double* x) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] = logKernel(x[i]);
+}
+
+QLE_KERNEL void sqrt(const std::size_t n, double* x) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] = std::sqrt(x[i]);
+}
+
+QLE_KERNEL void normalCdf(const std::size_t n, double* x) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] = normalCdfKernel(x[i]);
+}
+
+QLE_KERNEL void normalPdf(const std::size_t n, double* x) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] = gaussianKernel(x[i]) / sqrt2Pi;
+}
+
+QLE_KERNEL void conditionalResult(const std::size_t n, double* x, const bool* f, const double* y) {
+    for (std::size_t i = 0; i < n; ++i) {
+        double xi = x[i], yi = y[i];
+        x[i] = f[i] ? xi : yi;
+    }
+}
+
+QLE_KERNEL void conditionalResult(const std::size_t n, double* x, const bool* f, const double y) {
+    for (std::size_t i = 0; i < n; ++i) {
+        double xi = x[i];
+        x[i] = f[i] ? xi : y;
+    }
+}
+
+QLE_KERNEL void indicatorGt(const std::size_t n, double* x, const double* y, const double trueVal,
+                            const double falseVal) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] = (x[i] > y[i] && !closeEnough(x[i], y[i])) ? trueVal : falseVal;
+}
+
+QLE_KERNEL void indicatorGt(const std::size_t n, double* x, const double y, const double trueVal,
+                            const double falseVal) {
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] = (x[i] > y && !closeEnough(x[i], y)) ? trueVal : falseVal;
+}
+
+} // namespace RandomVariableKernels
+} // namespace QuantExt
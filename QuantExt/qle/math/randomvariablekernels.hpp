@@ -0,0 +1,100 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/math/randomvariablekernels.hpp
+    \brief vectorised kernels operating on the sample buffers of random variables
+    \ingroup math
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace QuantExt {
+
+//! Kernels for the non-deterministic paths of RandomVariable and Filter operations
+/*! The kernels operate on raw sample buffers and are written branch free, so that the compiler can vectorise them.
+    On x86-64 ELF platforms with GCC or Clang each kernel is compiled for AVX-512, AVX2 and the baseline instruction
+    set and the variant matching the executing CPU is selected at load time (function multiversioning). On other
+    platforms the baseline variant is used.
+
+    The transcendental kernels use their own approximations instead of the C library functions:
+
+    - exp(): Cody-Waite range reduction to |r| <= ln(2)/2 and a degree 13 Taylor polynomial, the relative error is
+      below 2 ulp. Values below -708 are flushed to zero (no subnormal results, exp(-708) ~ 3.3E-308 is still normal),
+      values above 709.78 give +inf.
+    - log(): reduction to a mantissa in [sqrt(1/2), sqrt(2)) and an atanh series in (m-1)/(m+1) up to degree 23,
+      relative error below 2 ulp. Subnormal inputs are supported, log(0) = -inf and log(x) = NaN for x < 0.
+    - normalCdf(): for |x| < 3.5 the double precision rational approximation of Hart (1968) as given in G. West,
+      Better approximations to cumulative normal functions, Wilmott Magazine (2005), beyond that the Laplace
+      continued fraction with 32 terms. The absolute error is below 1E-15, the relative error below 2E-13 for
+      x > -37. For x < -37 the result is 0 and for x > 37 it is 1.
+    - normalPdf(): exp(-x^2/2) / sqrt(2 pi) with x^2 split exactly into a high and low part before applying the
+      exp() kernel above, the relative error is below 4 ulp. The result is flushed to zero for |x| > 37.62.
+
+    NaN inputs are propagated by all transcendental kernels. */
+namespace RandomVariableKernels {
+
+//! x[i] += y[i]
+void add(const std::size_t n, double* x, const double* y);
+//! x[i] -= y[i]
+void subtract(const std::size_t n, double* x, const double* y);
+//! x[i] *= y[i]
+void multiply(const std::size_t n, double* x, const double* y);
+//! x[i] /= y[i]
+void divide(const std::size_t n, double* x, const double* y);
+
+//! single precision variants of the above
+void add(const std::size_t n, float* x, const float* y);
+void subtract(const std::size_t n, float* x, const float* y);
+void multiply(const std::size_t n, float* x, const float* y);
+void divide(const std::size_t n, float* x, const float* y);
+
+//! x[i] += y
+void add(const std::size_t n, double* x, const double y);
+//! x[i] -= y
+void subtract(const std::size_t n, double* x, const double y);
+//! x[i] *= y
+void multiply(const std::size_t n, double* x, const double y);
+//! x[i] /= y
+void divide(const std::size_t n, double* x, const double y);
+
+//! x[i] = exp(x[i])
+void exp(const std::size_t n, double* x);
+//! x[i] = log(x[i])
+void log(const std::size_t n, double* x);
+//! x[i] = sqrt(x[i])
+void sqrt(const std::size_t n, double* x);
+//! x[i] = Phi(x[i]), the standard normal cumulative distribution function
+void normalCdf(const std::size_t n, double* x);
+//! x[i] = phi(x[i]), the standard normal density
+void normalPdf(const std::size_t n, double* x);
+
+//! x[i] = f[i] ? x[i] : y[i]
+void conditionalResult(const std::size_t n, double* x, const bool* f, const double* y);
+//! x[i] = f[i] ? x[i] : y
+void conditionalResult(const std::size_t n, double* x, const bool* f, const double y);
+
+/*! x[i] = x[i] > y[i] && !close_enough(x[i], y[i]) ? trueVal : falseVal, with close_enough() matching
+    QuantLib::close_enough(x, y, 42) */
+void indicatorGt(const std::size_t n, double* x, const double* y, const double trueVal, const double falseVal);
+//! as above for a deterministic y
+void indicatorGt(const std::size_t n, double* x, const double y, const double trueVal, const double falseVal);
+
+} // namespace RandomVariableKernels
+} // namespace QuantExt
@@ -42,56 +42,67 @@ void FdmDefaultableEquityJumpDiffusionOp::setTime(Time t1, Time t2) {
 
     Size n = mesher_->locations(direction_).size();
 
-    Real r = model_->r(t1);
-    Real q = model_->q(t1);
-    Real v = model_->sigma(t1) * model_->sigma(t1);
+    if (t1 != cachedT1_ || t2 != cachedT2_) {
 
-    Array h(n);
-    for (Size i = 0; i < h.size(); ++i) {
-        h[i] = model_->h(t1, std::exp(mesher_->locations(direction_)[i]));
-    }
+        Real r = model_->r(t1);
+        Real q = model_->q(t1);
+        Real v = model_->sigma(t1) * model_->sigma(t1);
 
-    // overwrite discounting term with external curve and / or add external spread
+        h_ = Array(n);
+        for (Size i = 0; i < h_.size(); ++i) {
+            h_[i] = model_->h(t1, std::exp(mesher_->locations(direction_)[i]));
+        }
 
-    Real r_dis = r;
-    if (!discountingCurve_.empty()) {
-        r_dis = discountingCurve_->forwardRate(t1, t2, Continuous);
-    }
-    if (!discountingSpread_.empty()) {
-        r_dis += discountingSpread_->value();
-    }
+        // overwrite discounting term with external curve and / or add external spread
+
+        Real r_dis = r;
+        if (!discountingCurve_.empty()) {
+            r_dis = discountingCurve_->forwardRate(t1, t2, Continuous);
+        }
+        if (!discountingSpread_.empty()) {
+            r_dis += discountingSpread_->value();
+        }
+
+        // additional credit discounting term
+
+        h2_ = Array(n, 0.0);
+        if (!addCreditCurve_.empty()) {
+            QL_REQUIRE(!close_enough(addCreditCurve_->survivalProbability(t1), 0.0),
+                       "FdmDefaultableEquityJumpDiffusionOp: addCreditCurve implies zero survival probability at t = "
+                           << t1
+                           << ", this can not be handled. Check the credit curve / security spread provided in the "
+                              "market data. If this happens during a spread imply, the target price might not be "
+                              "ataainable even for high spreads.");
+            Real tmp = -std::log(addCreditCurve_->survivalProbability(t2) / addCreditCurve_->survivalProbability(t1)) /
+                       (t2 - t1);
+            std::fill(h2_.begin(), h2_.end(), tmp);
+        }
+
+        Array drift(n, r - q - 0.5 * v);
+        if (model_->adjustEquityForward())
+            drift += model_->eta() * h_;
+        mapT_.axpyb(drift, dxMap_, dxxMap_.mult(Array(n, 0.5 * v)), -(Array(n, r_dis) + h_ + h2_));
 
-    // additional credit discounting term
-
-    Array h2(n, 0.0);
-    if (!addCreditCurve_.empty()) {
-        QL_REQUIRE(!close_enough(addCreditCurve_->survivalProbability(t1), 0.0),
-                   "FdmDefaultableEquityJumpDiffusionOp: addCreditCurve implies zero survival probability at t = "
-                       << t1
-                       << ", this can not be handled. Check the credit curve / security spread provided in the market "
-                          "data. If this happens during a spread imply, the target price might not be ataainable even "
-                          "for high spreads.");
-        Real tmp =
-            -std::log(addCreditCurve_->survivalProbability(t2) / addCreditCurve_->survivalProbability(t1)) / (t2 - t1);
-        std::fill(h2.begin(), h2.end(), tmp);
+        cachedT1_ = t1;
+        cachedT2_ = t2;
+        recoveryTermValid_ = false;
     }
 
-    Array drift(n, r - q - 0.5 * v);
-    if (model_->adjustEquityForward())
-        drift += model_->eta() * h;
-    mapT_.axpyb(drift, dxMap_, dxxMap_.mult(Array(n, 0.5 * v)), -(Array(n, r_dis) + h + h2));
+    if (recoveryTermValid_)
+        return;
 
     for (Size i = 0; i < n; ++i) {
         Real S = std::exp(mesher_->locations(direction_)[i]);
         Real cr = conversionRatio_ ? conversionRatio_(S) : Null<Real>();
         recoveryTerm_[i] = 0.0;
         if (recovery_) {
-            recoveryTerm_[i] += recovery_(t1, S, cr) * h[i];
+            recoveryTerm_[i] += recovery_(t1, S, cr) * h_[i];
         }
         if (addRecovery_) {
-            recoveryTerm_[i] += addRecovery_(t1, S, cr) * h2[i];
+            recoveryTerm_[i] += addRecovery_(t1, S, cr) * h2_[i];
         }
     }
+    recoveryTermValid_ = true;
 }
 
 Array FdmDefaultableEquityJumpDiffusionOp::apply(const Array& r) const {
@@ -134,6 +145,7 @@ std::vector<QuantLib::SparseMatrix> FdmDefaultableEquityJumpDiffusionOp::toMatri
 
 void FdmDefaultableEquityJumpDiffusionOp::setConversionRatio(const std::function<Real(Real)>& conversionRatio) {
     conversionRatio_ = conversionRatio;
+    recoveryTermValid_ = false;
 }
 
 } // namespace QuantExt
@@ -40,6 +40,10 @@ public:
         - An additional credit curve and associated recovery rate function can be specified, which will constitute
           an additional discounting term and recovery term. This can e.g. be the bond credit curve for exchangeable
           convertible bonds (in this context, the model credit curve will be the equity credit curve then).
+        - Repeated calls of setTime() with the same times reuse the operator coefficients, and the recovery term
+          as long as the conversion ratio is not reset, so that several arrays can be rolled back over the same
+          time step at the cost of one operator evaluation. The operator should therefore be rebuilt when the
+          market data or the model changes.
      */
     FdmDefaultableEquityJumpDiffusionOp(
         const QuantLib::ext::shared_ptr<QuantLib::FdmMesher>& mesher,
@@ -81,8 +85,12 @@ private:
     QuantLib::TripleBandLinearOp dxxMap_;
     QuantLib::TripleBandLinearOp mapT_;
     Array recoveryTerm_;
+    Array h_, h2_;
 
     std::function<Real(Real)> conversionRatio_;
+
+    Real cachedT1_ = QuantLib::Null<Real>(), cachedT2_ = QuantLib::Null<Real>();
+    bool recoveryTermValid_ = false;
 };
 
 } // namespace QuantExt
@@ -20,10 +20,19 @@
 
 #include <boost/make_shared.hpp>
 
+#include <cstdint>
+#include <limits>
+
 using namespace QuantLib;
 
 namespace QuantExt {
 
+void MultiPathGeneratorBase::skipTo(const Size n) {
+    reset();
+    for (Size i = 0; i < n; ++i)
+        next();
+}
+
 MultiPathGeneratorMersenneTwister::MultiPathGeneratorMersenneTwister(
     const QuantLib::ext::shared_ptr<StochasticProcess>& process, const TimeGrid& grid, BigNatural seed, bool antitheticSampling)
     : process_(process), grid_(grid), seed_(seed), antitheticSampling_(antitheticSampling), antitheticVariate_(true),
@@ -32,7 +41,24 @@ MultiPathGeneratorMersenneTwister::MultiPathGeneratorMersenneTwister(
 }
 
 void MultiPathGeneratorMersenneTwister::reset() {
-    PseudoRandom::rsg_type rsg = PseudoRandom::make_sequence_generator(process_->factors() * (grid_.size() - 1), seed_);
+    build(PseudoRandom::make_sequence_generator(process_->factors() * (grid_.size() - 1), seed_));
+}
+
+void MultiPathGeneratorMersenneTwister::skipTo(const Size n) {
+    // each path (or pair of paths in antithetic mode) consumes one uniform variate per dimension, and each uniform
+    // variate consumes one 32 bit integer from the Mersenne Twister
+    const Size dim = process_->factors() * (grid_.size() - 1);
+    const Size draws = antitheticSampling_ ? n / 2 : n;
+    PseudoRandom::urng_type mt(seed_);
+    for (Size i = 0; i < draws * dim; ++i)
+        mt.nextInt32();
+    build(PseudoRandom::rsg_type(PseudoRandom::ursg_type(dim, mt)));
+    // in antithetic mode, an odd n means that the next path is the antithetic one of a path still to be drawn
+    if (antitheticSampling_ && n % 2 == 1)
+        next();
+}
+
+void MultiPathGeneratorMersenneTwister::build(const PseudoRandom::rsg_type& rsg) {
     if (auto tmp = QuantLib::ext::dynamic_pointer_cast<StochasticProcess1D>(process_)) {
         pg1D_ = QuantLib::ext::make_shared<PathGenerator<PseudoRandom::rsg_type>>(tmp, grid_, rsg, false);
     } else {
@@ -68,19 +94,21 @@ MultiPathGeneratorSobol::MultiPathGeneratorSobol(const QuantLib::ext::shared_ptr
     MultiPathGeneratorSobol::reset();
 }
 
-void MultiPathGeneratorSobol::reset() {
+void MultiPathGeneratorSobol::reset() { skipTo(0); }
+
+void MultiPathGeneratorSobol::skipTo(const Size n) {
+    QL_REQUIRE(n <= std::numeric_limits<std::uint_least32_t>::max(),
+               "MultiPathGeneratorSobol::skipTo(" << n << "): index exceeds the maximum sequence length");
+    SobolRsg rsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_);
+    if (n > 0)
+        rsg.skipTo(static_cast<std::uint_least32_t>(n));
     if (auto tmp = QuantLib::ext::dynamic_pointer_cast<StochasticProcess1D>(process_)) {
         pg1D_ = QuantLib::ext::make_shared<PathGenerator<InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>>>(
-            tmp, grid_,
-            InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>(
-                SobolRsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_)),
-            false);
+            tmp, grid_, InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>(rsg), false);
 
     } else {
         pg_ = QuantLib::ext::make_shared<MultiPathGenerator<InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>>>(
-            process_, grid_,
-            InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>(
-                SobolRsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_)));
+            process_, grid_, InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>(rsg));
     }
 }
 
@@ -102,19 +130,21 @@ MultiPathGeneratorBurley2020Sobol::MultiPathGeneratorBurley2020Sobol(const Quant
     MultiPathGeneratorBurley2020Sobol::reset();
 }
 
-void MultiPathGeneratorBurley2020Sobol::reset() {
+void MultiPathGeneratorBurley2020Sobol::reset() { skipTo(0); }
+
+void MultiPathGeneratorBurley2020Sobol::skipTo(const Size n) {
+    QL_REQUIRE(n <= std::numeric_limits<std::uint32_t>::max(),
+               "MultiPathGeneratorBurley2020Sobol::skipTo(" << n << "): index exceeds the maximum sequence length");
+    Burley2020SobolRsg rsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_, scrambleSeed_);
+    if (n > 0)
+        rsg.skipTo(static_cast<std::uint32_t>(n));
     if (auto tmp = QuantLib::ext::dynamic_pointer_cast<StochasticProcess1D>(process_)) {
         pg1D_ = QuantLib::ext::make_shared<PathGenerator<InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>>>(
-            tmp, grid_,
-            InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>(
-                Burley2020SobolRsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_, scrambleSeed_)),
-            false);
+            tmp, grid_, InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>(rsg), false);
 
     } else {
         pg_ = QuantLib::ext::make_shared<MultiPathGenerator<InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>>>(
-            process_, grid_,
-            InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>(Burley2020SobolRsg(
-                process_->factors() * (grid_.size() - 1), seed_, directionIntegers_, scrambleSeed_)));
+            process_, grid_, InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>(rsg));
     }
 }
 
@@ -160,6 +190,12 @@ const Sample<MultiPath>& MultiPathGeneratorSobolBrownianBridgeBase::next() const
     return next_;
 }
 
+void MultiPathGeneratorSobolBrownianBridgeBase::skipTo(const Size n) {
+    reset();
+    for (Size i = 0; i < n; ++i)
+        gen_->nextPath();
+}
+
 MultiPathGeneratorSobolBrownianBridge::MultiPathGeneratorSobolBrownianBridge(
     const QuantLib::ext::shared_ptr<StochasticProcess>& process, const TimeGrid& grid,
     SobolBrownianGenerator::Ordering ordering, BigNatural seed, SobolRsg::DirectionIntegers directionIntegers)
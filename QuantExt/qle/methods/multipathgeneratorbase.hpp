@@ -44,13 +44,20 @@ enum SequenceType {
 };
 
 //! Multi Path Generator Base
-/*! \ingroup methods
+/*! Generators support skip-ahead via skipTo(n), after which next() returns the same path as the (n+1)th call to
+    next() after a reset(). This allows several generator instances to produce disjoint ranges of the path sequence
+    in parallel, reproducing the sequential results exactly.
+
+    \ingroup methods
  */
 class MultiPathGeneratorBase {
 public:
     virtual ~MultiPathGeneratorBase() {}
     virtual const Sample<MultiPath>& next() const = 0;
     virtual void reset() = 0;
+    /*! reset the generator and skip the first n paths, the default implementation draws the n paths, derived classes
+        provide more efficient implementations */
+    virtual void skipTo(const Size n);
 };
 
 //! Instantiation of MultiPathGenerator with standard PseudoRandom traits
@@ -62,8 +69,12 @@ public:
                                       bool antitheticSampling = false);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    //! advances the underlying Mersenne Twister by the number of variates of the skipped paths
+    void skipTo(const Size n) override;
 
 private:
+    void build(const PseudoRandom::rsg_type& rsg);
+
     const QuantLib::ext::shared_ptr<StochasticProcess> process_;
     TimeGrid grid_;
     BigNatural seed_;
@@ -94,6 +105,8 @@ public:
                             SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    //! uses SobolRsg::skipTo()
+    void skipTo(const Size n) override;
 
 private:
     const QuantLib::ext::shared_ptr<StochasticProcess> process_;
@@ -120,6 +133,8 @@ public:
                                       BigNatural scrambleSeed = 43);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    //! uses Burley2020SobolRsg::skipTo()
+    void skipTo(const Size n) override;
 
 private:
     const QuantLib::ext::shared_ptr<StochasticProcess> process_;
@@ -143,6 +158,8 @@ public:
                                               BigNatural seed = 0,
                                               SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7);
     const Sample<MultiPath>& next() const override;
+    //! draws the variates of the skipped paths, but does not evolve the process along them
+    void skipTo(const Size n) override;
 
 protected:
     const QuantLib::ext::shared_ptr<StochasticProcess> process_;
@@ -751,6 +751,8 @@ void CrossAssetModel::calibrateBsVolatilitiesIterative(
     QL_REQUIRE(assetType == CrossAssetModel::AssetType::FX || assetType == CrossAssetModel::AssetType::EQ,
                "Unsupported AssetType for BS calibration");
     for (Size i = 0; i < helpers.size(); ++i) {
+        if (calibrateByRootSearch(helpers[i], endCriteria, constraint, MoveParameter(assetType, 0, idx, i)))
+            continue;
         std::vector<QuantLib::ext::shared_ptr<BlackCalibrationHelper>> h(1, helpers[i]);
         calibrate(h, method, endCriteria, constraint, weights, MoveParameter(assetType, 0, idx, i));
     }
@@ -771,6 +773,9 @@ void CrossAssetModel::calibrateInfDkVolatilitiesIterative(
     const Size index, const std::vector<QuantLib::ext::shared_ptr<BlackCalibrationHelper>>& helpers, OptimizationMethod& method,
     const EndCriteria& endCriteria, const Constraint& constraint, const std::vector<Real>& weights) {
     for (Size i = 0; i < helpers.size(); ++i) {
+        if (calibrateByRootSearch(helpers[i], endCriteria, constraint,
+                                  MoveParameter(CrossAssetModel::AssetType::INF, 0, index, i)))
+            continue;
         std::vector<QuantLib::ext::shared_ptr<BlackCalibrationHelper>> h(1, helpers[i]);
         calibrate(h, method, endCriteria, constraint, weights,
                   MoveParameter(CrossAssetModel::AssetType::INF, 0, index, i));
@@ -847,6 +852,9 @@ void CrossAssetModel::calibrateCrLgm1fVolatilitiesIterative(
     const Size index, const std::vector<QuantLib::ext::shared_ptr<BlackCalibrationHelper>>& helpers, OptimizationMethod& method,
     const EndCriteria& endCriteria, const Constraint& constraint, const std::vector<Real>& weights) {
     for (Size i = 0; i < helpers.size(); ++i) {
+        if (calibrateByRootSearch(helpers[i], endCriteria, constraint,
+                                  MoveParameter(CrossAssetModel::AssetType::CR, 0, index, i)))
+            continue;
         std::vector<QuantLib::ext::shared_ptr<BlackCalibrationHelper>> h(1, helpers[i]);
         calibrate(h, method, endCriteria, constraint, weights,
                   MoveParameter(CrossAssetModel::AssetType::CR, 0, index, i));
@@ -908,6 +916,25 @@ std::pair<Real, Real> CrossAssetModel::infdkI(const Size i, const Time t, const
     return std::make_pair(It, Itilde_t_T);
 }
 
+std::vector<Real> CrossAssetModel::infdkItilde(const Size i, const Time t, const std::vector<Time>& T,
+                                               const Real z) {
+    // as in infdkI()
+    Real Hyt = Hy(i).eval(*this, t);
+    const auto& zts = infdk(i)->termStructure();
+    auto dc = irlgm1f(0)->termStructure()->dayCounter();
+    bool indexIsInterpolated = true;
+    Real growth_t = inflationGrowth(zts, t, dc, indexIsInterpolated);
+    std::vector<Real> result(T.size());
+    for (Size j = 0; j < T.size(); ++j) {
+        QL_REQUIRE(t < T[j] || close_enough(t, T[j]), "infdkItilde: t (" << t << ") <= T (" << T[j] << ") required");
+        Real V_tilde = infdkV(i, t, T[j]).second;
+        Real HyT = Hy(i).eval(*this, T[j]);
+        Real growth_T = inflationGrowth(zts, T[j], dc, indexIsInterpolated);
+        result[j] = growth_T / growth_t * std::exp((HyT - Hyt) * z + V_tilde);
+    }
+    return result;
+}
+
 Real CrossAssetModel::infdkYY(const Size i, const Time t, const Time S, const Time T, const Real z, const Real y,
                               const Real irz) {
     Size ccy = ccyIndex(infdk(i)->currency());
@@ -280,6 +280,9 @@ public:
         with the index value (as of the base date of the inflation ts) */
     std::pair<Real, Real> infdkI(const Size i, const Time t, const Time T, const Real z, const Real y);
 
+    /*! return I^tilde(t,T_j) for several maturities T_j, the quantities depending on t only are evaluated once */
+    std::vector<Real> infdkItilde(const Size i, const Time t, const std::vector<Time>& T, const Real z);
+
     /*! return YoYIIS(t) in the notation of the book, the year on year
         swaplet price from S to T, at time t */
     Real infdkYY(const Size i, const Time t, const Time S, const Time T, const Real z, const Real y, const Real irz);
@@ -296,7 +299,8 @@ public:
     virtual std::pair<Real, Real> crS(const Size i, const Size ccy, const Time t, const Time T, const Real z,
                                       const Real y) const;
 
-    /*! calibration procedures */
+    /*! calibration procedures, the iterative volatility calibrations solve each step by a root search and use the
+        optimizer as a fallback only */
 
     /*! calibrate irlgm1f volatilities to a sequence of ir options with
         expiry times equal to step times in the parametrization */
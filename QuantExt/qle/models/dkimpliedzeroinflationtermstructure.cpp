@@ -40,6 +40,18 @@ Real DkImpliedZeroInflationTermStructure::zeroRateImpl(Time t) const {
     return std::pow(p.second, 1 / t) - 1;
 }
 
+std::vector<Real> DkImpliedZeroInflationTermStructure::zeroRates(const std::vector<Time>& t) const {
+    std::vector<Time> T(t.size());
+    for (Size i = 0; i < t.size(); ++i) {
+        QL_REQUIRE(t[i] >= 0.0, "DkImpliedZeroInflationTermStructure::zeroRates: negative time (" << t[i] << ") given");
+        T[i] = relativeTime_ + t[i];
+    }
+    std::vector<Real> result = model_->infdkItilde(index_, relativeTime_, T, state_[0]);
+    for (Size i = 0; i < t.size(); ++i)
+        result[i] = std::pow(result[i], 1 / t[i]) - 1;
+    return result;
+}
+
 void DkImpliedZeroInflationTermStructure::checkState() const {
     // For DK, expect the state to be two variables i.e. z_I and y_I.
     QL_REQUIRE(state_.size() == 2, "DkImpliedZeroInflationTermStructure: expected state to have " <<
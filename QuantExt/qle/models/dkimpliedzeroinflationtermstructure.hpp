@@ -42,6 +42,11 @@ public:
     QL_DEPRECATED
     DkImpliedZeroInflationTermStructure(const QuantLib::ext::shared_ptr<CrossAssetModel>& model, QuantLib::Size index, bool indexIsInterpolated);
 
+    //! \name ZeroInflationModelTermStructure interface
+    //@{
+    std::vector<QuantLib::Real> zeroRates(const std::vector<QuantLib::Time>& t) const override;
+    //@}
+
 protected:
     //! \name ZeroInflationTermStructure interface
     //@{
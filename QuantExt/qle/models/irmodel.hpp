@@ -28,6 +28,8 @@
 #include <qle/models/linkablecalibratedmodel.hpp>
 #include <qle/models/parametrization.hpp>
 
+#include <vector>
+
 namespace QuantExt {
 
 class IrModel : public LinkableCalibratedModel {
@@ -64,6 +66,17 @@ public:
         const QuantLib::Time t, const QuantLib::Time T, const QuantLib::Array& x,
         const QuantLib::Handle<QuantLib::YieldTermStructure>& discountCurve = Handle<YieldTermStructure>()) const = 0;
 
+    /*! discount bonds P(t,T_i) for several maturities T_i depending on one state (of dimension n()), the default
+        implementation calls discountBond() for each maturity */
+    virtual std::vector<QuantLib::Real> discountBonds(
+        const QuantLib::Time t, const std::vector<QuantLib::Time>& T, const QuantLib::Array& x,
+        const QuantLib::Handle<QuantLib::YieldTermStructure>& discountCurve = Handle<YieldTermStructure>()) const {
+        std::vector<QuantLib::Real> result(T.size());
+        for (QuantLib::Size i = 0; i < T.size(); ++i)
+            result[i] = discountBond(t, T[i], x, discountCurve);
+        return result;
+    }
+
     /*! numeraire depending on state and aux state (of dimensions n(), n_aux() */
     virtual QuantLib::Real
     numeraire(const QuantLib::Time t, const QuantLib::Array& x,
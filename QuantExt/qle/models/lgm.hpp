@@ -68,6 +68,11 @@ public:
                                 const QuantLib::Handle<QuantLib::YieldTermStructure>& discountCurve =
                                     Handle<YieldTermStructure>()) const override;
 
+    std::vector<QuantLib::Real> discountBonds(const QuantLib::Time t, const std::vector<QuantLib::Time>& T,
+                                              const QuantLib::Array& x,
+                                              const QuantLib::Handle<QuantLib::YieldTermStructure>& discountCurve =
+                                                  Handle<YieldTermStructure>()) const override;
+
     QuantLib::Real
     numeraire(const QuantLib::Time t, const QuantLib::Array& x,
               const QuantLib::Handle<QuantLib::YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
@@ -92,6 +97,10 @@ public:
     Real discountBond(const Time t, const Time T, const Real x,
                       Handle<YieldTermStructure> discountCurve = Handle<YieldTermStructure>()) const;
 
+    /*! discount bonds for several maturities, the quantities depending on t only are evaluated once */
+    std::vector<Real> discountBonds(const Time t, const std::vector<Time>& T, const Real x,
+                                    const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>()) const;
+
     Real reducedDiscountBond(const Time t, const Time T, const Real x,
                              const Handle<YieldTermStructure> discountCurve = Handle<YieldTermStructure>()) const;
 
@@ -99,7 +108,9 @@ public:
                             Handle<YieldTermStructure> discountCurve = Handle<YieldTermStructure>()) const;
 
     /*! calibrate volatilities to a sequence of ir options with
-        expiry times equal to step times in the parametrization */
+        expiry times equal to step times in the parametrization, each
+        step is solved by a root search, the optimizer is used as a
+        fallback only */
     void calibrateVolatilitiesIterative(const std::vector<QuantLib::ext::shared_ptr<BlackCalibrationHelper>>& helpers,
                                         OptimizationMethod& method, const EndCriteria& endCriteria,
                                         const Constraint& constraint = Constraint(),
@@ -184,6 +195,14 @@ LinearGaussMarkovModel::discountBond(const QuantLib::Time t, const QuantLib::Tim
     return discountBond(t, T, x[0], discountCurve);
 }
 
+inline std::vector<QuantLib::Real>
+LinearGaussMarkovModel::discountBonds(const QuantLib::Time t, const std::vector<QuantLib::Time>& T,
+                                      const QuantLib::Array& x,
+                                      const QuantLib::Handle<QuantLib::YieldTermStructure>& discountCurve) const {
+    QL_REQUIRE(x.size() == n(), "LinearGaussMarkovModel::discountBonds() requires input state of dimension " << n());
+    return discountBonds(t, T, x[0], discountCurve);
+}
+
 inline QuantLib::Real
 LinearGaussMarkovModel::numeraire(const QuantLib::Time t, const QuantLib::Array& x,
                                   const QuantLib::Handle<QuantLib::YieldTermStructure>& discountCurve,
@@ -223,6 +242,26 @@ inline Real LinearGaussMarkovModel::discountBond(const Time t, const Time T, con
            std::exp(-(HT - Ht) * x - 0.5 * (HT * HT - Ht * Ht) * parametrization_->zeta(t));
 }
 
+inline std::vector<Real> LinearGaussMarkovModel::discountBonds(const Time t, const std::vector<Time>& T, const Real x,
+                                                              const Handle<YieldTermStructure>& discountCurve) const {
+    QL_REQUIRE(t >= 0.0, "t (" << t << ") >= 0 required in LGM::discountBonds");
+    const Handle<YieldTermStructure>& curve = discountCurve.empty() ? parametrization_->termStructure() : discountCurve;
+    Real Ht = parametrization_->H(t);
+    Real zeta = parametrization_->zeta(t);
+    Real Pt = curve->discount(t);
+    std::vector<Real> result(T.size());
+    for (Size i = 0; i < T.size(); ++i) {
+        if (QuantLib::close_enough(t, T[i])) {
+            result[i] = 1.0;
+            continue;
+        }
+        QL_REQUIRE(T[i] >= t, "T(" << T[i] << ") >= t(" << t << ") required in LGM::discountBonds");
+        Real HT = parametrization_->H(T[i]);
+        result[i] = curve->discount(T[i]) / Pt * std::exp(-(HT - Ht) * x - 0.5 * (HT * HT - Ht * Ht) * zeta);
+    }
+    return result;
+}
+
 inline QuantLib::Real
 LinearGaussMarkovModel::shortRate(const QuantLib::Time t, const QuantLib::Array& x,
                                   const QuantLib::Handle<QuantLib::YieldTermStructure>& discountCurve) const {
@@ -260,6 +299,8 @@ inline void LinearGaussMarkovModel::calibrateVolatilitiesIterative(
     const std::vector<QuantLib::ext::shared_ptr<BlackCalibrationHelper>>& helpers, OptimizationMethod& method,
     const EndCriteria& endCriteria, const Constraint& constraint, const std::vector<Real>& weights) {
     for (Size i = 0; i < helpers.size(); ++i) {
+        if (calibrateByRootSearch(helpers[i], endCriteria, constraint, MoveVolatility(i)))
+            continue;
         std::vector<QuantLib::ext::shared_ptr<BlackCalibrationHelper>> h(1, helpers[i]);
         calibrate(h, method, endCriteria, constraint, weights, MoveVolatility(i));
     }
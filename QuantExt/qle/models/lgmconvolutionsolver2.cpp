@@ -68,49 +68,135 @@ RandomVariable LgmConvolutionSolver2::stateGrid(const Real t) const {
     return x;
 }
 
-RandomVariable LgmConvolutionSolver2::rollback(const RandomVariable& v, const Real t1, const Real t0, Size) const {
-    if (QuantLib::close_enough(t0, t1) || v.deterministic())
-        return v;
-    QL_REQUIRE(t0 < t1, "LgmConvolutionSolver2::rollback(): t0 (" << t0 << ") < t1 (" << t1 << ") required.");
-    Real sigma = std::sqrt(model_->parametrization()->zeta(t1));
+QuantLib::ext::shared_ptr<const LgmConvolutionSolver2::RollbackWeights>
+LgmConvolutionSolver2::rollbackWeights(const Real t1, const Real t0) const {
+
+    Real zeta0 = QuantLib::close_enough(t0, 0.0) ? 0.0 : model_->parametrization()->zeta(t0);
+    Real zeta1 = model_->parametrization()->zeta(t1);
+
+    {
+        std::lock_guard<std::mutex> lock(rollbackWeightsMutex_);
+        auto r = rollbackWeights_.find(std::make_pair(t1, t0));
+        if (r != rollbackWeights_.end() && r->second->zeta0 == zeta0 && r->second->zeta1 == zeta1)
+            return r->second;
+    }
+
+    auto result = QuantLib::ext::make_shared<RollbackWeights>();
+    result->zeta0 = zeta0;
+    result->zeta1 = zeta1;
+
+    Real sigma = std::sqrt(zeta1);
     Real dx = sigma / static_cast<Real>(nx_);
-    if (QuantLib::close_enough(t0, 0.0)) {
-        // rollback from t1 to t0 = 0
-        Real value = 0.0;
+    Real stdDev = std::sqrt(zeta1 - zeta0);
+    Real dx2 = std::sqrt(zeta0) / static_cast<Real>(nx_);
+
+    // if t0 = 0 there is only one state, i.e. one row in the matrix
+
+    int rows = QuantLib::close_enough(t0, 0.0) ? 1 : 2 * mx_ + 1;
+
+    result->offset.push_back(0);
+    for (int k = 0; k < rows; ++k) {
+        // Map y index to x index, not integer in general, kp is increasing in i
+        auto kp = [this, k, stdDev, dx, dx2](const int i) { return (dx2 * (k - mx_) + y_[i] * stdDev) / dx + mx_; };
+        // the range of x indices used in the linear interpolation with flat extrapolation below
+        int first = std::min(std::max(static_cast<int>(std::floor(kp(0))), 0), 2 * mx_);
+        int last = std::min(std::max(static_cast<int>(std::floor(kp(2 * my_))) + 1, 0), 2 * mx_);
+        std::vector<Real> row(last - first + 1, 0.0);
         for (int i = 0; i <= 2 * my_; i++) {
-            // Map y index to x index, not integer in general
-            Real kp = y_[i] * sigma / dx + mx_;
+            Real p = kp(i);
             // Adjacent integer x index <= k
-            int kk = int(floor(kp));
+            int kk = int(floor(p));
             // Get value at kp by linear interpolation on
             // kk <= kp <= kk + 1 with flat extrapolation
-            value +=
-                w_[i] *
-                (kk < 0 ? v[0] : (kk + 1 > 2 * mx_ ? v[2 * mx_] : (kp - kk) * v[kk + 1] + (1.0 + kk - kp) * v[kk]));
-        }
-        return RandomVariable(2 * mx_ + 1, value);
-    } else {
-        RandomVariable value(2 * mx_ + 1, 0.0);
-        value.expand();
-        // rollback from t1 to t0 > 0
-        Real std = std::sqrt(model_->parametrization()->zeta(t1) - model_->parametrization()->zeta(t0));
-        Real dx2 = std::sqrt(model_->parametrization()->zeta(t0)) / static_cast<Real>(nx_);
-        for (int k = 0; k <= 2 * mx_; k++) {
-            for (int i = 0; i <= 2 * my_; i++) {
-                // Map y index to x index, not integer in generalTo
-                Real kp = (dx2 * (k - mx_) + y_[i] * std) / dx + mx_;
-                // Adjacent integer x index <= k
-                int kk = int(floor(kp));
-                // Get value at kp by linear interpolation on
-                // kk <= kp <= kk + 1 with flat extrapolation
-                value.set(k, value[k] + w_[i] * (kk < 0 ? v[0]
-                                                        : (kk + 1 > 2 * mx_
-                                                               ? v[2 * mx_]
-                                                               : (kp - kk) * v[kk + 1] + (1.0 + kk - kp) * v[kk])));
+            if (kk < 0) {
+                row[0 - first] += w_[i];
+            } else if (kk + 1 > 2 * mx_) {
+                row[2 * mx_ - first] += w_[i];
+            } else {
+                row[kk + 1 - first] += w_[i] * (p - kk);
+                row[kk - first] += w_[i] * (1.0 + kk - p);
             }
         }
-        return value;
+        result->start.push_back(first);
+        result->weights.insert(result->weights.end(), row.begin(), row.end());
+        result->offset.push_back(result->weights.size());
+    }
+
+    std::lock_guard<std::mutex> lock(rollbackWeightsMutex_);
+    rollbackWeights_[std::make_pair(t1, t0)] = result;
+    return result;
+}
+
+RandomVariable LgmConvolutionSolver2::rollback(const RandomVariable& v, const Real t1, const Real t0, Size) const {
+    if (QuantLib::close_enough(t0, t1) || v.deterministic())
+        return v;
+    QL_REQUIRE(t0 < t1, "LgmConvolutionSolver2::rollback(): t0 (" << t0 << ") < t1 (" << t1 << ") required.");
+
+    // apply the (cached) convolution weights to the raw data
+
+    auto rw = rollbackWeights(t1, t0);
+    const Real* vd = v.data();
+    const Real* w = rw->weights.data();
+    Size rows = rw->start.size();
+    std::vector<Real> result(rows);
+    for (Size k = 0; k < rows; ++k) {
+        const Real* x = vd + rw->start[k];
+        Real sum = 0.0;
+        for (Size j = rw->offset[k], l = 0; j < rw->offset[k + 1]; ++j, ++l)
+            sum += w[j] * x[l];
+        result[k] = sum;
+    }
+
+    // rollback to t0 = 0 yields a deterministic result
+
+    if (rows == 1)
+        return RandomVariable(2 * mx_ + 1, result[0]);
+    return RandomVariable(result);
+}
+
+std::vector<RandomVariable> LgmConvolutionSolver2::rollbackBatch(const std::vector<RandomVariable>& v, const Real t1,
+                                                                 const Real t0, Size) const {
+    if (QuantLib::close_enough(t0, t1))
+        return v;
+    QL_REQUIRE(t0 < t1, "LgmConvolutionSolver2::rollbackBatch(): t0 (" << t0 << ") < t1 (" << t1 << ") required.");
+
+    // collect the stochastic arrays, deterministic ones are returned unchanged
+
+    std::vector<RandomVariable> result(v);
+    std::vector<Size> columns;
+    for (Size c = 0; c < v.size(); ++c) {
+        if (!v[c].deterministic())
+            columns.push_back(c);
+    }
+    if (columns.empty())
+        return result;
+
+    // apply the (cached) convolution weights row by row to all arrays, so that each row of weights is read once
+
+    auto rw = rollbackWeights(t1, t0);
+    const Real* w = rw->weights.data();
+    Size rows = rw->start.size();
+    std::vector<const Real*> vd(columns.size());
+    for (Size c = 0; c < columns.size(); ++c)
+        vd[c] = v[columns[c]].data();
+    std::vector<std::vector<Real>> values(columns.size(), std::vector<Real>(rows));
+    for (Size k = 0; k < rows; ++k) {
+        for (Size c = 0; c < columns.size(); ++c) {
+            const Real* x = vd[c] + rw->start[k];
+            Real sum = 0.0;
+            for (Size j = rw->offset[k], l = 0; j < rw->offset[k + 1]; ++j, ++l)
+                sum += w[j] * x[l];
+            values[c][k] = sum;
+        }
+    }
+
+    for (Size c = 0; c < columns.size(); ++c) {
+        if (rows == 1)
+            result[columns[c]] = RandomVariable(2 * mx_ + 1, values[c][0]);
+        else
+            result[columns[c]] = RandomVariable(values[c]);
     }
+    return result;
 }
 
 } // namespace QuantExt
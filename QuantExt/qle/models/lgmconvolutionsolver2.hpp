@@ -27,6 +27,9 @@
 #include <qle/math/randomvariable.hpp>
 #include <qle/models/lgmbackwardsolver.hpp>
 
+#include <map>
+#include <mutex>
+
 namespace QuantExt {
 
 //! Numerical convolution solver for the LGM model
@@ -43,13 +46,30 @@ public:
     // steps are always ignored, since we can take large steps
     RandomVariable rollback(const RandomVariable& v, const Real t1, const Real t0,
                             Size steps = Null<Size>()) const override;
+    // applies the same convolution weights to all arrays
+    std::vector<RandomVariable> rollbackBatch(const std::vector<RandomVariable>& v, const Real t1, const Real t0,
+                                              Size steps = Null<Size>()) const override;
     const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model() const override { return model_; }
 
 private:
+    /* the convolution from t1 to t0 as a sparse matrix, row k contains the weights offset[k], ..., offset[k+1]-1
+       applied to the values start[k], start[k]+1, ... at t1, the weights depend on the model only via zeta(t0) and
+       zeta(t1) */
+    struct RollbackWeights {
+        Real zeta0, zeta1;
+        std::vector<Size> start, offset;
+        std::vector<Real> weights;
+    };
+    QuantLib::ext::shared_ptr<const RollbackWeights> rollbackWeights(const Real t1, const Real t0) const;
+
     QuantLib::ext::shared_ptr<LinearGaussMarkovModel> model_;
     int mx_, my_, nx_;
     Real h_;
     std::vector<Real> y_, w_;
+
+    // rollback weights per (t1, t0), reused as long as the model's zeta at t0 and t1 is unchanged
+    mutable std::map<std::pair<Real, Real>, QuantLib::ext::shared_ptr<const RollbackWeights>> rollbackWeights_;
+    mutable std::mutex rollbackWeightsMutex_;
 };
 
 } // namespace QuantExt
@@ -0,0 +1,154 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/models/lgmfftsolver.hpp>
+
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/fastfouriertransform.hpp>
+
+#include <algorithm>
+#include <complex>
+
+namespace QuantExt {
+
+namespace {
+// linear interpolation of values given on the grid x_k = dx * (k - mx), k = 0, ..., 2 * mx with flat extrapolation
+Real interpolate(const Real* v, const int mx, const Real dx, const Real x) {
+    Real kp = x / dx + mx;
+    int kk = static_cast<int>(std::floor(kp));
+    if (kk < 0)
+        return v[0];
+    if (kk + 1 > 2 * mx)
+        return v[2 * mx];
+    return (kp - kk) * v[kk + 1] + (1.0 + kk - kp) * v[kk];
+}
+} // namespace
+
+LgmFftSolver::LgmFftSolver(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy,
+                           const Real sx, const Size nx)
+    : model_(model), sy_(sy), nx_(static_cast<int>(nx)) {
+    QL_REQUIRE(sy > 0.0, "LgmFftSolver: sy (" << sy << ") must be positive");
+    QL_REQUIRE(nx > 0, "LgmFftSolver: nx must be positive");
+    mx_ = static_cast<int>(floor(sx * static_cast<Real>(nx)) + 0.5);
+}
+
+RandomVariable LgmFftSolver::stateGrid(const Real t) const {
+    if (QuantLib::close_enough(t, 0.0))
+        return RandomVariable(2 * mx_ + 1, 0.0);
+    RandomVariable x(2 * mx_ + 1);
+    Real dx = std::sqrt(model_->parametrization()->zeta(t)) / static_cast<Real>(nx_);
+    for (int k = 0; k <= 2 * mx_; ++k) {
+        x.set(k, dx * (k - mx_));
+    }
+    return x;
+}
+
+RandomVariable LgmFftSolver::rollback(const RandomVariable& v, const Real t1, const Real t0, Size steps) const {
+    return rollbackBatch({v}, t1, t0, steps).front();
+}
+
+std::vector<RandomVariable> LgmFftSolver::rollbackBatch(const std::vector<RandomVariable>& v, const Real t1,
+                                                        const Real t0, Size) const {
+    if (QuantLib::close_enough(t0, t1))
+        return v;
+    QL_REQUIRE(t0 < t1, "LgmFftSolver::rollback(): t0 (" << t0 << ") < t1 (" << t1 << ") required.");
+
+    // deterministic arrays are returned unchanged
+
+    std::vector<RandomVariable> result(v);
+    std::vector<Size> columns;
+    for (Size c = 0; c < v.size(); ++c) {
+        if (!v[c].deterministic())
+            columns.push_back(c);
+    }
+    if (columns.empty())
+        return result;
+
+    Real zeta1 = model_->parametrization()->zeta(t1);
+    Real dx1 = std::sqrt(zeta1) / static_cast<Real>(nx_);
+
+    CumulativeNormalDistribution N;
+
+    if (QuantLib::close_enough(t0, 0.0)) {
+        // rollback from t1 to t0 = 0, integrate against the N(0, zeta1) density using the cell probabilities
+        std::vector<Real> p(2 * mx_ + 1);
+        Real mass = 0.0;
+        for (int k = 0; k <= 2 * mx_; ++k) {
+            Real lower = k == 0 ? -QL_MAX_REAL : (k - mx_ - 0.5) / static_cast<Real>(nx_);
+            Real upper = k == 2 * mx_ ? QL_MAX_REAL : (k - mx_ + 0.5) / static_cast<Real>(nx_);
+            p[k] = N(upper) - N(lower);
+            mass += p[k];
+        }
+        for (auto c : columns) {
+            const Real* vd = v[c].data();
+            Real value = 0.0;
+            for (int k = 0; k <= 2 * mx_; ++k)
+                value += p[k] * vd[k];
+            result[c] = RandomVariable(2 * mx_ + 1, value / mass);
+        }
+        return result;
+    }
+
+    // rollback from t1 to t0 > 0
+
+    Real zeta0 = model_->parametrization()->zeta(t0);
+    Real h = std::sqrt(zeta0) / static_cast<Real>(nx_);
+    Real stdDev = std::sqrt(std::max(zeta1 - zeta0, 0.0));
+    int m = static_cast<int>(std::ceil(sy_ * stdDev / h));
+
+    // the kernel, given as the probabilities of the lattice cells under N(0, zeta1 - zeta0), normalised to one
+
+    std::vector<Real> kernel(2 * m + 1);
+    Real mass = 0.0;
+    for (int i = -m; i <= m; ++i) {
+        kernel[i + m] = m == 0 ? 1.0 : N((i + 0.5) * h / stdDev) - N((i - 0.5) * h / stdDev);
+        mass += kernel[i + m];
+    }
+
+    int nValues = 2 * (mx_ + m) + 1;
+    Size order = QuantLib::FastFourierTransform::min_order(static_cast<Size>(nValues + 2 * m));
+    QuantLib::FastFourierTransform fft(order);
+    Size n = fft.output_size();
+
+    std::vector<std::complex<Real>> kernelPadded(n, 0.0), kernelFft(n);
+    for (int i = 0; i <= 2 * m; ++i)
+        kernelPadded[i] = kernel[i] / mass;
+    fft.transform(kernelPadded.begin(), kernelPadded.end(), kernelFft.begin());
+
+    // the values at t1 interpolated on the lattice h * (j - mx - m), j = 0, ..., 2 * (mx + m), the kernel is
+    // symmetric, so the correlation sum_i kernel_i values_{k+i} is the convolution, with an offset 2m
+
+    std::vector<std::complex<Real>> values(n), valuesFft(n), conv(n);
+    for (auto c : columns) {
+        const Real* vd = v[c].data();
+        std::fill(values.begin(), values.end(), 0.0);
+        for (int j = 0; j < nValues; ++j)
+            values[j] = interpolate(vd, mx_, dx1, h * (j - mx_ - m));
+        fft.transform(values.begin(), values.end(), valuesFft.begin());
+        for (Size i = 0; i < n; ++i)
+            valuesFft[i] *= kernelFft[i];
+        fft.inverse_transform(valuesFft.begin(), valuesFft.end(), conv.begin());
+        RandomVariable value(2 * mx_ + 1);
+        for (int k = 0; k <= 2 * mx_; ++k)
+            value.set(k, conv[k + 2 * m].real() / static_cast<Real>(n));
+        result[c] = value;
+    }
+    return result;
+}
+
+} // namespace QuantExt
@@ -0,0 +1,61 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file lgmfftsolver.hpp
+    \brief fft based convolution solver for the LGM model
+
+    \ingroup models
+*/
+
+#pragma once
+
+#include <qle/math/randomvariable.hpp>
+#include <qle/models/lgmbackwardsolver.hpp>
+
+#include <vector>
+
+namespace QuantExt {
+
+//! FFT based convolution solver for the LGM model
+/*! The state grid is the same as for the LgmConvolutionSolver2, i.e. it covers sx standard deviations with nx points
+    per standard deviation. A rollback from t1 to t0 > 0 interpolates the values linearly (with flat extrapolation) on
+    a lattice with the spacing of the t0 grid, and convolves them with the Gaussian transition density truncated at sy
+    standard deviations using a fast fourier transform. The cost of a rollback is O(n log n) in the number n of lattice
+    points, compared to O(nx * ny) for the direct convolution. The rollback to t0 = 0 is done by a direct integration
+    of the linearly interpolated values against the Gaussian density. */
+class LgmFftSolver : public LgmBackwardSolver {
+public:
+    LgmFftSolver(const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Real sx,
+                 const Size nx);
+    Size gridSize() const override { return 2 * mx_ + 1; }
+    RandomVariable stateGrid(const Real t) const override;
+    // steps are always ignored, since we can take large steps
+    RandomVariable rollback(const RandomVariable& v, const Real t1, const Real t0,
+                            Size steps = Null<Size>()) const override;
+    // transforms the kernel only once for all arrays
+    std::vector<RandomVariable> rollbackBatch(const std::vector<RandomVariable>& v, const Real t1, const Real t0,
+                                              Size steps = Null<Size>()) const override;
+    const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& model() const override { return model_; }
+
+private:
+    QuantLib::ext::shared_ptr<LinearGaussMarkovModel> model_;
+    Real sy_;
+    int mx_, nx_;
+};
+
+} // namespace QuantExt
@@ -28,6 +28,8 @@
 
 #include <ql/termstructures/yieldtermstructure.hpp>
 
+#include <vector>
+
 namespace QuantExt {
 using namespace QuantLib;
 
@@ -60,6 +62,10 @@ public:
     void move(const Date& d, const Real s);
     void move(const Time t, const Real s);
 
+    /*! discount factors for several times relative to the reference date, the model quantities depending on the
+        reference time only are evaluated once */
+    virtual std::vector<Real> discounts(const std::vector<Time>& t) const;
+
     virtual void update() override;
 
 protected:
@@ -89,6 +95,7 @@ public:
 
     void referenceDate(const Date& d) override;
     void referenceTime(const Time t) override;
+    std::vector<Real> discounts(const std::vector<Time>& t) const override;
 
 protected:
     Real discountImpl(Time t) const override;
@@ -109,6 +116,8 @@ public:
                                const Handle<YieldTermStructure> targetCurve, const DayCounter& dc,
                                const bool purelyTimeBased, const bool cacheValues = false);
 
+    std::vector<Real> discounts(const std::vector<Time>& t) const override;
+
 protected:
     Real discountImpl(Time t) const override;
 
@@ -224,6 +233,38 @@ inline Real LgmImpliedYtsFwdFwdCorrected::discountImpl(Time t) const {
     }
 }
 
+inline std::vector<Real> LgmImpliedYieldTermStructure::discounts(const std::vector<Time>& t) const {
+    std::vector<Time> T(t.size());
+    for (Size i = 0; i < t.size(); ++i) {
+        QL_REQUIRE(t[i] >= 0.0, "negative time (" << t[i] << ") given");
+        T[i] = relativeTime_ + t[i];
+    }
+    return model_->discountBonds(relativeTime_, T, state_);
+}
+
+inline std::vector<Real> LgmImpliedYtsFwdFwdCorrected::discounts(const std::vector<Time>& t) const {
+    std::vector<Real> result(t.size());
+    if (QuantLib::close_enough(relativeTime_, 0.0)) {
+        for (Size i = 0; i < t.size(); ++i) {
+            QL_REQUIRE(t[i] >= 0.0, "negative time (" << t[i] << ") given");
+            result[i] = targetCurve_->discount(t[i]);
+        }
+        return result;
+    }
+    if (!cacheValues_) {
+        dt_ = targetCurve_->discount(relativeTime_);
+        zeta_ = model_->parametrization()->zeta(relativeTime_);
+        Ht_ = model_->parametrization()->H(relativeTime_);
+    }
+    for (Size i = 0; i < t.size(); ++i) {
+        QL_REQUIRE(t[i] >= 0.0, "negative time (" << t[i] << ") given");
+        Real HT = model_->parametrization()->H(relativeTime_ + t[i]);
+        result[i] = std::exp(-(HT - Ht_) * state_ - 0.5 * (HT * HT - Ht_ * Ht_) * zeta_) *
+                    targetCurve_->discount(relativeTime_ + t[i]) / dt_;
+    }
+    return result;
+}
+
 inline Real LgmImpliedYtsSpotCorrected::discountImpl(Time t) const {
     QL_REQUIRE(t >= 0.0, "negative time (" << t << ") given");
     return LgmImpliedYieldTermStructure::discountImpl(t) * targetCurve_->discount(t) *
@@ -231,6 +272,15 @@ inline Real LgmImpliedYtsSpotCorrected::discountImpl(Time t) const {
            model_->parametrization()->termStructure()->discount(relativeTime_ + t);
 }
 
+inline std::vector<Real> LgmImpliedYtsSpotCorrected::discounts(const std::vector<Time>& t) const {
+    std::vector<Real> result = LgmImpliedYieldTermStructure::discounts(t);
+    Real dt = model_->parametrization()->termStructure()->discount(relativeTime_);
+    for (Size i = 0; i < t.size(); ++i)
+        result[i] *= targetCurve_->discount(t[i]) * dt /
+                     model_->parametrization()->termStructure()->discount(relativeTime_ + t[i]);
+    return result;
+}
+
 } // namespace QuantExt
 
 #endif
@@ -51,6 +51,30 @@ RandomVariable LgmVectorised::discountBond(const Time t, const Time T, const Ran
            exp(-(HT - Ht) * x - RandomVariable(x.size(), 0.5 * p_->zeta(t)) * (HT * HT - Ht * Ht));
 }
 
+std::vector<RandomVariable> LgmVectorised::discountBonds(const Time t, const std::vector<Time>& T,
+                                                        const RandomVariable& x,
+                                                        const Handle<YieldTermStructure>& discountCurve) const {
+    QL_REQUIRE(t >= 0.0, "t(" << t << ") >= 0 required in LGMVectorised::discountBonds");
+    const Handle<YieldTermStructure>& curve = discountCurve.empty() ? p_->termStructure() : discountCurve;
+    Real Ht = p_->H(t);
+    Real zeta = p_->zeta(t);
+    Real Pt = curve->discount(t);
+    std::vector<RandomVariable> result;
+    result.reserve(T.size());
+    for (auto const T_i : T) {
+        if (QuantLib::close_enough(t, T_i)) {
+            result.push_back(RandomVariable(x.size(), 1.0));
+            continue;
+        }
+        QL_REQUIRE(T_i >= t, "T(" << T_i << ") >= t(" << t << ") required in LGMVectorised::discountBonds");
+        Real HT = p_->H(T_i);
+        result.push_back(RandomVariable(x.size(), curve->discount(T_i) / Pt) *
+                         exp(RandomVariable(x.size(), -(HT - Ht)) * x -
+                             RandomVariable(x.size(), 0.5 * (HT * HT - Ht * Ht) * zeta)));
+    }
+    return result;
+}
+
 RandomVariable LgmVectorised::reducedDiscountBond(const Time t, const Time T, const RandomVariable& x,
                                                   const Handle<YieldTermStructure>& discountCurve) const {
     if (QuantLib::close_enough(t, T))
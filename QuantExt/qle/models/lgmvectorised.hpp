@@ -47,6 +47,12 @@ public:
     RandomVariable discountBond(const Time t, const Time T, const RandomVariable& x,
                                 const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>()) const;
 
+    /* discount bonds for several maturities across the states x, the quantities depending on t only are evaluated
+       once */
+    std::vector<RandomVariable>
+    discountBonds(const Time t, const std::vector<Time>& T, const RandomVariable& x,
+                  const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>()) const;
+
     RandomVariable
     reducedDiscountBond(const Time t, const Time T, const RandomVariable& x,
                         const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>()) const;
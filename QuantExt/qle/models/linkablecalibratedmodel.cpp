@@ -16,12 +16,16 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <ql/math/comparison.hpp>
 #include <ql/math/optimization/problem.hpp>
 #include <ql/math/optimization/projectedconstraint.hpp>
 #include <ql/math/optimization/projection.hpp>
+#include <ql/math/solvers1d/brent.hpp>
 #include <ql/utilities/null_deleter.hpp>
 #include <qle/models/linkablecalibratedmodel.hpp>
 
+#include <algorithm>
+
 using QuantLib::ext::shared_ptr;
 using std::vector;
 
@@ -106,6 +110,54 @@ void LinkableCalibratedModel::calibrate(const vector<shared_ptr<CalibrationHelpe
     notifyObservers();
 }
 
+bool LinkableCalibratedModel::calibrateByRootSearch(const shared_ptr<BlackCalibrationHelper>& helper,
+                                                    const EndCriteria& endCriteria,
+                                                    const Constraint& additionalConstraint,
+                                                    const vector<bool>& fixParameters) {
+
+    if (!rootSearchCalibration_)
+        return false;
+
+    Array prms = params();
+    QL_REQUIRE(fixParameters.size() == prms.size(),
+               "LinkableCalibratedModel::calibrateByRootSearch(): fixParameters size ("
+                   << fixParameters.size() << ") does not match number of parameters (" << prms.size() << ")");
+    if (std::count(fixParameters.begin(), fixParameters.end(), false) != 1)
+        return false;
+    Size idx = std::distance(fixParameters.begin(), std::find(fixParameters.begin(), fixParameters.end(), false));
+
+    Real marketValue = helper->marketValue();
+    if (close_enough(marketValue, 0.0))
+        return false;
+
+    Array trial = prms;
+    auto f = [this, &trial, &helper, idx, marketValue](const Real x) {
+        trial[idx] = x;
+        setParams(trial);
+        return helper->modelValue() / marketValue - 1.0;
+    };
+
+    try {
+        Brent solver;
+        solver.setMaxEvaluations(endCriteria.maxIterations());
+        Real guess = prms[idx];
+        Real x = solver.solve(f, QL_EPSILON, guess, std::max(0.1 * std::fabs(guess), 1E-4));
+        trial[idx] = x;
+        if (!constraint_->test(trial) || (!additionalConstraint.empty() && !additionalConstraint.test(trial))) {
+            setParams(prms);
+            return false;
+        }
+        setParams(trial);
+    } catch (const std::exception&) {
+        setParams(prms);
+        return false;
+    }
+
+    endCriteria_ = EndCriteria::StationaryPoint;
+    problemValues_ = Array(1, helper->calibrationError());
+    return true;
+}
+
 Real LinkableCalibratedModel::value(const Array& params,
                                     const vector<QuantLib::ext::shared_ptr<BlackCalibrationHelper> >& instruments) {
     vector<ext::shared_ptr<CalibrationHelper> > tmp(instruments.size());
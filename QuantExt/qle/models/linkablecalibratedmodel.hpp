@@ -61,6 +61,22 @@ public:
                            const std::vector<Real>& weights = std::vector<Real>(),
                            const std::vector<bool>& fixParameters = std::vector<bool>());
 
+    //! Calibrate a single parameter to a single instrument by a one dimensional root search
+    /*! The parameter that is not fixed in \p fixParameters is moved until the model value of the helper matches its
+        market value, which requires the model value to be monotonic in the parameter. This typically needs far fewer
+        model valuations than calibrate(), which uses a finite difference Jacobian. If there is not exactly one free
+        parameter, no root is found within endCriteria.maxIterations() evaluations or the solution violates the
+        constraints, the initial parameters are restored and false is returned, so that the caller can fall back to
+        calibrate(). Thanks to the superlinear convergence of the solver the root is determined to machine precision
+        with a few additional valuations only. If the root search is switched off, false is returned immediately. */
+    bool calibrateByRootSearch(const QuantLib::ext::shared_ptr<BlackCalibrationHelper>& helper,
+                               const EndCriteria& endCriteria, const Constraint& constraint,
+                               const std::vector<bool>& fixParameters);
+
+    //! Switch the root search in the iterative calibrations on (the default) or off, i.e. always use the optimizer
+    void setRootSearchCalibration(const bool b) { rootSearchCalibration_ = b; }
+    bool rootSearchCalibration() const { return rootSearchCalibration_; }
+
     Real value(const Array& params, const std::vector<QuantLib::ext::shared_ptr<CalibrationHelper> >&);
 
     //! for backward compatibility
@@ -86,6 +102,7 @@ protected:
     QuantLib::ext::shared_ptr<Constraint> constraint_;
     EndCriteria::Type endCriteria_;
     Array problemValues_;
+    bool rootSearchCalibration_ = true;
 
 private:
     //! Constraint imposed on arguments
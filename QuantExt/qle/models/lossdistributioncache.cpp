@@ -0,0 +1,47 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/models/lossdistributioncache.hpp>
+
+namespace QuantExt {
+
+QuantLib::ext::shared_ptr<const QuantLib::Distribution> LossDistributionCache::get(const Key& key) const {
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    auto e = entries_.find(key);
+    return e == entries_.end() ? nullptr : e->second;
+}
+
+void LossDistributionCache::add(const Key& key,
+                                const QuantLib::ext::shared_ptr<const QuantLib::Distribution>& distribution) {
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    if (entries_.size() >= maxEntries)
+        entries_.clear();
+    entries_[key] = distribution;
+}
+
+void LossDistributionCache::clear() {
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    entries_.clear();
+}
+
+QuantLib::Size LossDistributionCache::size() const {
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return entries_.size();
+}
+
+} // namespace QuantExt
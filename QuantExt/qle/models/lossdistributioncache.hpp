@@ -0,0 +1,62 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/models/lossdistributioncache.hpp
+    \brief cache for portfolio loss distributions shared between pool loss models
+    \ingroup models
+*/
+
+#pragma once
+
+#include <ql/experimental/credit/distribution.hpp>
+#include <ql/patterns/singleton.hpp>
+#include <ql/shared_ptr.hpp>
+
+#include <boost/thread/shared_mutex.hpp>
+
+#include <map>
+#include <vector>
+
+namespace QuantExt {
+
+/*! Cache for the portfolio loss distributions computed by the PoolLossModel. A CDS index tranche [A,D] is priced as
+    the difference of the equity tranches [0,D] and [0,A], each with its own loss model using the base correlation
+    at the respective point. The [0,D] equity tranche of one tranche in the capital structure is the [0,A] equity
+    tranche of the next one, so that the loss distributions can be shared between the tranches on the same index.
+    The key holds the values of all inputs of the loss distribution, including the date and the marginal default
+    probabilities of the pool constituents, so that entries remain valid under market moves. The full key is
+    compared on a lookup, a hit therefore always refers to the same inputs. */
+struct LossDistributionCache : public QuantLib::Singleton<LossDistributionCache> {
+
+    //! the inputs of a loss distribution, flattened, variable length inputs are preceded by their length
+    using Key = std::vector<QuantLib::Real>;
+
+    QuantLib::ext::shared_ptr<const QuantLib::Distribution> get(const Key& key) const;
+    void add(const Key& key, const QuantLib::ext::shared_ptr<const QuantLib::Distribution>& distribution);
+    void clear();
+    QuantLib::Size size() const;
+
+    bool enabled = true;
+    QuantLib::Size maxEntries = 4096;
+
+private:
+    mutable boost::shared_mutex mutex_;
+    std::map<Key, QuantLib::ext::shared_ptr<const QuantLib::Distribution>> entries_;
+};
+
+} // namespace QuantExt
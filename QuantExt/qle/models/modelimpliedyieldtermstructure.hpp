@@ -28,6 +28,8 @@
 #include <ql/termstructures/yieldtermstructure.hpp>
 #include <ql/math/comparison.hpp>
 
+#include <vector>
+
 namespace QuantExt {
 using namespace QuantLib;
 
@@ -59,6 +61,10 @@ public:
     void move(const Date& d, const Array& s);
     void move(const Time t, const Array& s);
 
+    /*! discount factors for several times relative to the reference date, the model quantities depending on the
+        reference time only are evaluated once */
+    virtual std::vector<Real> discounts(const std::vector<Time>& t) const;
+
     virtual void update() override;
 
 protected:
@@ -85,6 +91,7 @@ public:
 
     void referenceDate(const Date& d) override;
     void referenceTime(const Time t) override;
+    std::vector<Real> discounts(const std::vector<Time>& t) const override;
 
 protected:
     Real discountImpl(Time t) const override;
@@ -104,6 +111,8 @@ public:
     ModelImpliedYtsSpotCorrected(const QuantLib::ext::shared_ptr<IrModel>& model, const Handle<YieldTermStructure> targetCurve,
                                  const DayCounter& dc, const bool purelyTimeBased);
 
+    std::vector<Real> discounts(const std::vector<Time>& t) const override;
+
 protected:
     Real discountImpl(Time t) const override;
 
@@ -186,6 +195,15 @@ inline Real ModelImpliedYieldTermStructure::discountImpl(Time t) const {
     return model_->discountBond(relativeTime_, relativeTime_ + t, state_);
 }
 
+inline std::vector<Real> ModelImpliedYieldTermStructure::discounts(const std::vector<Time>& t) const {
+    std::vector<Time> T(t.size());
+    for (Size i = 0; i < t.size(); ++i) {
+        QL_REQUIRE(t[i] >= 0.0, "negative time (" << t[i] << ") given");
+        T[i] = relativeTime_ + t[i];
+    }
+    return model_->discountBonds(relativeTime_, T, state_);
+}
+
 inline Real ModelImpliedYtsFwdFwdCorrected::discountImpl(Time t) const {
     QL_REQUIRE(t >= 0.0, "negative time (" << t << ") given");
     // if relativeTime_ is close to zero, we return the discount factor directly from the target curve
@@ -196,10 +214,35 @@ inline Real ModelImpliedYtsFwdFwdCorrected::discountImpl(Time t) const {
     }
 }
 
+inline std::vector<Real> ModelImpliedYtsFwdFwdCorrected::discounts(const std::vector<Time>& t) const {
+    if (!QuantLib::close_enough(relativeTime_, 0.0)) {
+        std::vector<Time> T(t.size());
+        for (Size i = 0; i < t.size(); ++i) {
+            QL_REQUIRE(t[i] >= 0.0, "negative time (" << t[i] << ") given");
+            T[i] = relativeTime_ + t[i];
+        }
+        return model_->discountBonds(relativeTime_, T, state_, targetCurve_);
+    }
+    std::vector<Real> result(t.size());
+    for (Size i = 0; i < t.size(); ++i) {
+        QL_REQUIRE(t[i] >= 0.0, "negative time (" << t[i] << ") given");
+        result[i] = targetCurve_->discount(t[i]);
+    }
+    return result;
+}
+
 inline Real ModelImpliedYtsSpotCorrected::discountImpl(Time t) const {
     QL_REQUIRE(t >= 0.0, "negative time (" << t << ") given");
     return ModelImpliedYieldTermStructure::discountImpl(t) * targetCurve_->discount(t) *
            model_->termStructure()->discount(relativeTime_) / model_->termStructure()->discount(relativeTime_ + t);
 }
 
+inline std::vector<Real> ModelImpliedYtsSpotCorrected::discounts(const std::vector<Time>& t) const {
+    std::vector<Real> result = ModelImpliedYieldTermStructure::discounts(t);
+    Real dt = model_->termStructure()->discount(relativeTime_);
+    for (Size i = 0; i < t.size(); ++i)
+        result[i] *= targetCurve_->discount(t[i]) * dt / model_->termStructure()->discount(relativeTime_ + t[i]);
+    return result;
+}
+
 } // namespace QuantExt
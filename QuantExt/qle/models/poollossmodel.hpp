@@ -24,8 +24,10 @@
 #include <qle/models/extendedconstantlosslatentmodel.hpp>
 #include <qle/models/defaultlossmodel.hpp>
 #include <qle/models/hullwhitebucketing.hpp>
+#include <qle/models/lossdistributioncache.hpp>
 #include <functional>
 #include <iostream>
+#include <type_traits>
 
 // clang-format off
 namespace QuantExt {
@@ -88,6 +90,10 @@ private:
     mutable std::vector<std::vector<QuantLib::Real>> cprVV_;
     
     QuantLib::Distribution lossDistrib(const QuantLib::Date& d, Real recoveryRate = Null<Real>()) const;
+    // lossDistrib() using the LossDistributionCache if enabled
+    QuantLib::Distribution cachedLossDistrib(const QuantLib::Date& d, Real recoveryRate = Null<Real>()) const;
+    // all inputs to lossDistrib()
+    LossDistributionCache::Key lossDistribKey(const QuantLib::Date& d, Real recoveryRate) const;
     // update lgdVV_
     void updateLGDs(Real recoveryRate = Null<Real>()) const;
     // update q_and c_
@@ -166,7 +172,7 @@ PoolLossModel<CopulaPolicy>::PoolLossModel(
 template <class CopulaPolicy>
 QuantLib::Real PoolLossModel<CopulaPolicy>::expectedTrancheLoss(const QuantLib::Date& d, Real recoveryRate) const {
 
-    QuantLib::Distribution dist = lossDistrib(d, recoveryRate);
+    QuantLib::Distribution dist = cachedLossDistrib(d, recoveryRate);
 
     // RL: dist.trancheExpectedValue() using x = dist.average(i)
     // FIXME: some remaining inaccuracy in dist.cumulativeDensity(detachAmount_)
@@ -227,7 +233,7 @@ QuantLib::Real PoolLossModel<CopulaPolicy>::expectedTrancheLoss2(const QuantLib:
 
 template <class CopulaPolicy>
 QuantLib::Real PoolLossModel<CopulaPolicy>::percentile(const QuantLib::Date& d, QuantLib::Real percentile) const {
-    QuantLib::Real portfLoss = lossDistrib(d).confidenceLevel(percentile);
+    QuantLib::Real portfLoss = cachedLossDistrib(d).confidenceLevel(percentile);
     return std::min(std::max(portfLoss - attachAmount_, 0.), detachAmount_ - attachAmount_);
 }
 
@@ -235,7 +241,7 @@ template <class CopulaPolicy>
 QuantLib::Real PoolLossModel<CopulaPolicy>::expectedShortfall(
     const QuantLib::Date& d, QuantLib::Probability percentile) const {
 
-    QuantLib::Distribution dist = lossDistrib(d);
+    QuantLib::Distribution dist = cachedLossDistrib(d);
     dist.tranche(attachAmount_, detachAmount_);
     return dist.expectedShortfall(percentile);
 }
@@ -400,6 +406,54 @@ void PoolLossModel<CopulaPolicy>::resetModel() {
     copula_->resetBasket(basket_.currentLink());
 }
     
+template <class CopulaPolicy>
+LossDistributionCache::Key PoolLossModel<CopulaPolicy>::lossDistribKey(const QuantLib::Date& d,
+                                                                       Real recoveryRate) const {
+    LossDistributionCache::Key key{static_cast<Real>(d.serialNumber()),
+                                   static_cast<Real>(homogeneous_),
+                                   static_cast<Real>(nBuckets_),
+                                   max_,
+                                   min_,
+                                   static_cast<Real>(nSteps_),
+                                   static_cast<Real>(useQuadrature_),
+                                   static_cast<Real>(useStochasticRecovery_),
+                                   detachAmount_,
+                                   recoveryRate};
+    auto append = [&key](const std::vector<Real>& v) {
+        key.push_back(static_cast<Real>(v.size()));
+        key.insert(key.end(), v.begin(), v.end());
+    };
+    append(notionals_);
+    append(copula_->recoveries());
+    key.push_back(static_cast<Real>(copula_->factorWeights().size()));
+    for (auto const& w : copula_->factorWeights())
+        append(w);
+    if (useStochasticRecovery_) {
+        key.push_back(static_cast<Real>(copula_->recoveryProbabilities().size()));
+        for (auto const& r : copula_->recoveryProbabilities())
+            append(r);
+        key.push_back(static_cast<Real>(copula_->recoveryRateGrids().size()));
+        for (auto const& r : copula_->recoveryRateGrids())
+            append(r);
+    }
+    append(basket_->remainingProbabilities(d));
+    return key;
+}
+
+template <class CopulaPolicy>
+QuantLib::Distribution PoolLossModel<CopulaPolicy>::cachedLossDistrib(const QuantLib::Date& d,
+                                                                      Real recoveryRate) const {
+    // restricted to the Gaussian copula, other copula policies have parameters that are not part of the key
+    if (!std::is_same<CopulaPolicy, GaussianCopulaPolicy>::value || !LossDistributionCache::instance().enabled)
+        return lossDistrib(d, recoveryRate);
+    LossDistributionCache::Key key = lossDistribKey(d, recoveryRate);
+    if (auto dist = LossDistributionCache::instance().get(key))
+        return *dist;
+    auto dist = QuantLib::ext::make_shared<const QuantLib::Distribution>(lossDistrib(d, recoveryRate));
+    LossDistributionCache::instance().add(key, dist);
+    return *dist;
+}
+
 template <class CopulaPolicy>
 QuantLib::Distribution PoolLossModel<CopulaPolicy>::lossDistrib(const QuantLib::Date& d, Real recoveryRate) const {
 
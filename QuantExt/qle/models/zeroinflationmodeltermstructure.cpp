@@ -89,4 +89,11 @@ void ZeroInflationModelTermStructure::move(const Date& d, const Array& s) {
     referenceDate(d);
 }
 
+std::vector<Real> ZeroInflationModelTermStructure::zeroRates(const std::vector<Time>& t) const {
+    std::vector<Real> result(t.size());
+    for (Size i = 0; i < t.size(); ++i)
+        result[i] = zeroRate(t[i]);
+    return result;
+}
+
 }
@@ -75,6 +75,11 @@ public:
     //! Set the current state and move the reference date to date \p d
     void move(const QuantLib::Date& d, const QuantLib::Array& s);
 
+    /*! Zero rates for several times relative to the reference date, the default implementation calls zeroRate() for
+        each time, derived classes can evaluate the quantities depending on the reference time only once.
+    */
+    virtual std::vector<QuantLib::Real> zeroRates(const std::vector<QuantLib::Time>& t) const;
+
 protected:
     QuantLib::ext::shared_ptr<CrossAssetModel> model_;
     QuantLib::Size index_;
@@ -49,6 +49,10 @@ public:
                  std::vector<std::vector<QuantExt::RandomVariable>>& paths, 
                  const std::vector<size_t>& relevantPathIndex,
                  const std::vector<size_t>& relevantTimeIndex) = 0;
+
+    /*! indices of the state process components that simulatePath() reads from the paths, an empty vector means
+        that all components might be read */
+    virtual std::vector<QuantLib::Size> stateIndices() const { return {}; }
 };
 
 } // namespace QuantExt
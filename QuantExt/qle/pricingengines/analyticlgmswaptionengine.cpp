@@ -64,6 +64,10 @@ void AnalyticLgmSwaptionEngine::enableCache(const bool lgm_H_constant, const boo
     clearCache();
 }
 
+void AnalyticLgmSwaptionEngine::enableParameterSensitivities(const bool enable) {
+    computeParameterSensitivities_ = enable;
+}
+
 void AnalyticLgmSwaptionEngine::clearCache() {
     S_.clear();             // indicates that H / alpha independent variables are not yet computed
     Hj_.clear();            // indicates that H dependent variables not yet computed
@@ -258,6 +262,13 @@ void AnalyticLgmSwaptionEngine::calculate() const {
         for (Size j = j1_; j < fixedLeg_.size(); ++j) {
             Dj_[j - j1_] = c_->discount(fixedLeg_[j - j1_]->date());
         }
+
+        // corrected fixed amounts, these do not depend on the model parameters
+
+        netAmounts_.resize(fixedLeg_.size() - j1_);
+        for (Size j = j1_; j < fixedLeg_.size(); ++j) {
+            netAmounts_[j - j1_] = fixedLeg_[j]->amount() - S_[j - j1_];
+        }
     }
 
     if (!caching_ || !lgm_H_constant_ || Hj_.empty()) {
@@ -270,6 +281,10 @@ void AnalyticLgmSwaptionEngine::calculate() const {
         for (Size j = j1_; j < fixedLeg_.size(); ++j) {
             Hj_[j - j1_] = p_->H(p_->termStructure()->timeFromReference(fixedLeg_[j]->date()));
         }
+        dHj_.resize(Hj_.size());
+        for (Size j = 0; j < Hj_.size(); ++j) {
+            dHj_[j] = Hj_[j] - H0_;
+        }
     }
 
     if (!caching_ || !lgm_alpha_constant_ || zetaex_ == Null<Real>()) {
@@ -308,28 +323,49 @@ void AnalyticLgmSwaptionEngine::calculate() const {
     Real sqrt_zetaex = std::sqrt(zetaex_);
     Real sum = 0.0;
     for (Size j = j1_; j < fixedLeg_.size(); ++j) {
-        sum += w_ * (fixedLeg_[j]->amount() - S_[j - j1_]) * Dj_[j - j1_] *
-               N(u_ * w_ * (yStar + (Hj_[j - j1_] - H0_) * zetaex_) / sqrt_zetaex);
+        sum += w_ * netAmounts_[j - j1_] * Dj_[j - j1_] * N(u_ * w_ * (yStar + dHj_[j - j1_] * zetaex_) / sqrt_zetaex);
     }
     sum += -w_ * S_m1 * D0_ * N(u_ * w_ * yStar / sqrt_zetaex);
-    sum += w_ * (nominal_ * Dj_.back() * N(u_ * w_ * (yStar + (Hj_.back() - H0_) * zetaex_) / sqrt_zetaex) -
+    sum += w_ * (nominal_ * Dj_.back() * N(u_ * w_ * (yStar + dHj_.back() * zetaex_) / sqrt_zetaex) -
                  nominal_ * D0_ * N(u_ * w_ * yStar / sqrt_zetaex));
     results_.value = sum;
 
     results_.additionalResults["fixedAmountCorrectionSettlement"] = S_m1;
     results_.additionalResults["fixedAmountCorrections"] = S_;
 
+    if (!computeParameterSensitivities_)
+        return;
+
+    // sensitivities w.r.t. zeta(expiry), H(t_0) and H(t_j), by definition of yStar the price does not depend on yStar
+    // to first order, so that the partial derivatives for fixed yStar are the total derivatives
+
+    NormalDistribution phi;
+    Real dZeta = 0.0, dH0 = 0.0;
+    std::vector<Real> dHj(Hj_.size(), 0.0);
+    for (Size j = 0; j < Hj_.size(); ++j) {
+        Real c = netAmounts_[j] + (j == Hj_.size() - 1 ? nominal_ : 0.0);
+        Real d = phi(u_ * w_ * (yStar + dHj_[j] * zetaex_) / sqrt_zetaex) * u_ * c * Dj_[j];
+        dZeta += d * (dHj_[j] * zetaex_ - yStar) / (2.0 * zetaex_ * sqrt_zetaex);
+        dHj[j] = d * sqrt_zetaex;
+        dH0 -= dHj[j];
+    }
+    dZeta += phi(u_ * w_ * yStar / sqrt_zetaex) * u_ * (S_m1 + nominal_) * D0_ * yStar /
+             (2.0 * zetaex_ * sqrt_zetaex);
+
+    results_.additionalResults["sensitivityZetaExpiry"] = dZeta;
+    results_.additionalResults["sensitivityHStart"] = dH0;
+    results_.additionalResults["sensitivityHFixedPayDates"] = dHj;
+
 } // calculate
 
 Real AnalyticLgmSwaptionEngine::yStarHelper(const Real y) const {
     Real sum = 0.0;
     for (Size j = j1_; j < fixedLeg_.size(); ++j) {
-        sum += (fixedLeg_[j]->amount() - S_[j - j1_]) * Dj_[j - j1_] *
-               std::exp(-(Hj_[j - j1_] - H0_) * y - 0.5 * (Hj_[j - j1_] - H0_) * (Hj_[j - j1_] - H0_) * zetaex_);
+        Real dH = dHj_[j - j1_];
+        sum += netAmounts_[j - j1_] * Dj_[j - j1_] * std::exp(-dH * y - 0.5 * dH * dH * zetaex_);
     }
     sum += -S_m1 * D0_;
-    sum += Dj_.back() * nominal_ *
-           std::exp(-(Hj_.back() - H0_) * y - 0.5 * (Hj_.back() - H0_) * (Hj_.back() - H0_) * zetaex_);
+    sum += Dj_.back() * nominal_ * std::exp(-dHj_.back() * y - 0.5 * dHj_.back() * dHj_.back() * zetaex_);
     sum -= D0_ * nominal_;
     return sum;
 }
@@ -94,6 +94,12 @@ public:
     void enableCache(const bool lgm_H_constant = true, const bool lgm_alpha_constant = false);
     void clearCache();
 
+    /* If enabled, the sensitivities of the npv w.r.t. the model quantities zeta(expiry), H(t_0) (start of the
+       underlying) and H(t_j) (pay dates of the fixed coupons after expiry) are written to the additional results
+       sensitivityZetaExpiry, sensitivityHStart and sensitivityHFixedPayDates. They can be combined with the
+       derivatives of zeta and H w.r.t. the LGM parameters to get the gradient of the npv in a calibration. */
+    void enableParameterSensitivities(const bool enable = true);
+
 private:
     Real flatAmount(const Size k) const;
     Real yStarHelper(const Real y) const;
@@ -101,8 +107,9 @@ private:
     Handle<YieldTermStructure> c_;
     mutable FloatSpreadMapping floatSpreadMapping_;
     bool caching_, lgm_H_constant_, lgm_alpha_constant_;
+    bool computeParameterSensitivities_ = false;
     mutable Real H0_, D0_, zetaex_, S_m1, u_, w_;
-    mutable std::vector<Real> S_, Hj_, Dj_;
+    mutable std::vector<Real> S_, Hj_, Dj_, dHj_, netAmounts_;
     mutable Size j1_, k1_;
     mutable std::vector<QuantLib::ext::shared_ptr<FixedRateCoupon>> fixedLeg_;
     mutable std::vector<QuantLib::ext::shared_ptr<FloatingRateCoupon>> floatingLeg_;
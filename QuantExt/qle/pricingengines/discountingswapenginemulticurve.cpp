@@ -25,6 +25,10 @@
 #include <ql/utilities/dataformatters.hpp>
 
 #include <qle/pricingengines/discountingswapenginemulticurve.hpp>
+#include <qle/termstructures/interpolateddiscountcurve.hpp>
+
+#include <algorithm>
+#include <map>
 
 namespace QuantExt {
 
@@ -108,11 +112,83 @@ void AdditionalAmountGetter::visit(IborCoupon& c) {
     AmountGetter::visit(c);
     bpsFactor_ = c.accrualPeriod() * c.nominal();
 }
+
+// weights such that the log discount at a date is w0 * L[i0] + w1 * L[i1], L = log discounts at the curve pillars
+struct PillarWeights {
+    Size i0 = 0, i1 = 0;
+    Real w0 = 0.0, w1 = 0.0;
+};
+
+// returns the curve if the curve array fast path is applicable to it, otherwise null
+const InterpolatedDiscountCurve* curveArrayCurve(const Handle<YieldTermStructure>& c) {
+    if (c.empty())
+        return nullptr;
+    auto curve = dynamic_cast<const InterpolatedDiscountCurve*>(c.currentLink().get());
+    if (curve == nullptr || curve->interpolation() != InterpolatedDiscountCurve::Interpolation::logLinear ||
+        !curve->jumpDates().empty())
+        return nullptr;
+    return curve;
+}
+
+// mirrors InterpolatedDiscountCurve::discountImpl() for log linear interpolation, requires t >= 0
+PillarWeights pillarWeights(const InterpolatedDiscountCurve& curve, const Time t) {
+    const std::vector<Time>& times = curve.times();
+    PillarWeights w;
+    if (t > times.back() && curve.extrapolation() == InterpolatedDiscountCurve::Extrapolation::flatZero) {
+        w.i0 = w.i1 = times.size() - 1;
+        w.w0 = t / times.back();
+        return w;
+    }
+    Size i = std::min<Size>(std::upper_bound(times.begin(), times.end(), t) - times.begin(), times.size() - 1);
+    Real weight = (times[i] - t) / (times[i] - times[i - 1]);
+    w.i0 = i;
+    w.i1 = i - 1;
+    w.w0 = 1.0 - weight;
+    w.w1 = weight;
+    return w;
+}
+
+inline Real logDiscount(const PillarWeights& w, const std::vector<Real>& logDiscounts) {
+    return w.w0 * logDiscounts[w.i0] + w.w1 * logDiscounts[w.i1];
+}
 } // namespace
 
 class DiscountingSwapEngineMultiCurve::AmountImpl {
 public:
     QuantLib::ext::shared_ptr<AmountGetter> amountGetter_;
+
+    /* Curve array fast path: if the discount curve is a log linear InterpolatedDiscountCurve (as set up by the
+       scenario sim market) we precompute per swap the pillar indices and weights for all cashflow dates and for the
+       accrual dates of the ibor coupons which are projected on such a curve. A reprice is then a dot product against
+       the log discounts at the pillars. */
+    struct Flow {
+        Size leg;
+        QuantLib::ext::shared_ptr<CashFlow> cashflow;
+        PillarWeights discount;
+        // the amount and bps factor are taken from the amount getter, unless iborForwardCurve is set
+        bool callAmount;
+        Size iborForwardCurve = Null<Size>();
+        PillarWeights accrualStart, accrualEnd;
+        Real gearing, nominal, indexDcf, accrualPeriod, spreadTimesAccrual, bpsFactor;
+    };
+
+    struct SwapData {
+        QuantLib::ext::weak_ptr<CashFlow> firstFlow;
+        std::vector<Size> legSizes;
+        Date referenceDate, settlementDate;
+        bool includeRefDateFlows;
+        const YieldTermStructure* discountCurve;
+        std::vector<Handle<YieldTermStructure>> forwardCurveHandles;
+        std::vector<const InterpolatedDiscountCurve*> forwardCurves;
+        std::vector<Flow> flows;
+    };
+
+    // returns the (cached) swap data, the amount logic mirrors the one in calculate()
+    const SwapData& swapData(const Swap::arguments& arguments, const InterpolatedDiscountCurve& curve,
+                             const Date& settlementDate, const bool includeRefDateFlows, const bool minimalResults);
+
+    // cached swap data, keyed by the first cashflow of the swap
+    std::map<const CashFlow*, SwapData> swapData_;
 };
 
 DiscountingSwapEngineMultiCurve::DiscountingSwapEngineMultiCurve(const Handle<YieldTermStructure>& discountCurve,
@@ -174,6 +250,18 @@ void DiscountingSwapEngineMultiCurve::calculate() const {
 
     const Spread bp = 1.0e-4;
 
+    if (auto curve = curveArrayCurve(discountCurve_)) {
+        calculateOnCurveArray(*curve, settlementDate, includeRefDateFlows);
+        for (Size i = 0; i < numLegs; i++) {
+            results_.legNPV[i] *= arguments_.payer[i];
+            results_.legNPV[i] /= results_.npvDateDiscount;
+            results_.legBPS[i] *= arguments_.payer[i] * bp;
+            results_.legBPS[i] /= results_.npvDateDiscount;
+            results_.value += results_.legNPV[i];
+        }
+        return;
+    }
+
     for (Size i = 0; i < numLegs; i++) {
 
         Leg leg = arguments_.legs[i];
@@ -209,4 +297,127 @@ void DiscountingSwapEngineMultiCurve::calculate() const {
         results_.value += results_.legNPV[i];
     }
 }
+
+const DiscountingSwapEngineMultiCurve::AmountImpl::SwapData&
+DiscountingSwapEngineMultiCurve::AmountImpl::swapData(const Swap::arguments& arguments,
+                                                      const InterpolatedDiscountCurve& curve, const Date& settlementDate,
+                                                      const bool includeRefDateFlows, const bool minimalResults) {
+
+    // look up the cached data and check if it is still valid
+
+    const CashFlow* key = nullptr;
+    std::vector<Size> legSizes;
+    for (auto const& l : arguments.legs) {
+        if (key == nullptr && !l.empty())
+            key = l.front().get();
+        legSizes.push_back(l.size());
+    }
+
+    auto d = swapData_.find(key);
+    if (d != swapData_.end()) {
+        const SwapData& data = d->second;
+        bool valid = data.firstFlow.lock().get() == key && data.legSizes == legSizes &&
+                     data.referenceDate == curve.referenceDate() && data.settlementDate == settlementDate &&
+                     data.includeRefDateFlows == includeRefDateFlows && data.discountCurve == &curve;
+        for (Size k = 0; valid && k < data.forwardCurves.size(); ++k)
+            valid = data.forwardCurveHandles[k].currentLink().get() == data.forwardCurves[k];
+        if (valid)
+            return data;
+    }
+
+    // build the data
+
+    SwapData data;
+    for (auto const& l : arguments.legs) {
+        if (!l.empty()) {
+            data.firstFlow = l.front();
+            break;
+        }
+    }
+    data.legSizes = legSizes;
+    data.referenceDate = curve.referenceDate();
+    data.settlementDate = settlementDate;
+    data.includeRefDateFlows = includeRefDateFlows;
+    data.discountCurve = &curve;
+
+    for (Size i = 0; i < arguments.legs.size(); ++i) {
+        const Leg& leg = arguments.legs[i];
+        bool callAmount = true;
+        for (Size j = 0; j < leg.size(); ++j) {
+            if (leg[j]->hasOccurred(settlementDate, includeRefDateFlows))
+                continue;
+            Flow f;
+            f.leg = i;
+            f.cashflow = leg[j];
+            f.discount = pillarWeights(curve, curve.timeFromReference(leg[j]->date()));
+            f.callAmount = callAmount;
+            if (!callAmount) {
+                if (auto c = QuantLib::ext::dynamic_pointer_cast<IborCoupon>(leg[j])) {
+                    Handle<YieldTermStructure> forwardingCurve = c->iborIndex()->forwardingTermStructure();
+                    auto fwdCurve = curveArrayCurve(forwardingCurve);
+                    if (fwdCurve != nullptr && fwdCurve->timeFromReference(c->accrualStartDate()) >= 0.0) {
+                        auto fc = std::find(data.forwardCurves.begin(), data.forwardCurves.end(), fwdCurve);
+                        f.iborForwardCurve = std::distance(data.forwardCurves.begin(), fc);
+                        if (fc == data.forwardCurves.end()) {
+                            data.forwardCurves.push_back(fwdCurve);
+                            data.forwardCurveHandles.push_back(forwardingCurve);
+                        }
+                        f.accrualStart = pillarWeights(*fwdCurve, fwdCurve->timeFromReference(c->accrualStartDate()));
+                        f.accrualEnd = pillarWeights(*fwdCurve, fwdCurve->timeFromReference(c->accrualEndDate()));
+                        f.gearing = c->gearing();
+                        f.nominal = c->nominal();
+                        DayCounter indexBasis = c->iborIndex()->dayCounter();
+                        f.indexDcf = indexBasis == c->dayCounter()
+                                         ? Null<Real>()
+                                         : indexBasis.yearFraction(c->accrualStartDate(), c->accrualEndDate());
+                        f.accrualPeriod = c->accrualPeriod();
+                        f.spreadTimesAccrual = c->spread() * c->accrualPeriod();
+                        f.bpsFactor = minimalResults ? 0.0 : c->accrualPeriod() * c->nominal();
+                    }
+                }
+            }
+            data.flows.push_back(f);
+            if (j == 1)
+                callAmount = false;
+        }
+    }
+
+    return swapData_[key] = data;
+}
+
+void DiscountingSwapEngineMultiCurve::calculateOnCurveArray(const InterpolatedDiscountCurve& curve,
+                                                            const Date& settlementDate,
+                                                            bool includeRefDateFlows) const {
+    const AmountImpl::SwapData& data =
+        impl_->swapData(arguments_, curve, settlementDate, includeRefDateFlows, minimalResults_);
+
+    std::vector<Real> discountLogs = curve.logDiscounts();
+    std::vector<std::vector<Real>> forwardLogs;
+    for (auto const c : data.forwardCurves)
+        forwardLogs.push_back(c->logDiscounts());
+
+    for (Size i = 0; i < arguments_.legs.size(); ++i) {
+        results_.legNPV[i] = 0.0;
+        results_.legBPS[i] = 0.0;
+    }
+
+    for (auto const& f : data.flows) {
+        DiscountFactor discount = std::exp(logDiscount(f.discount, discountLogs));
+        if (f.iborForwardCurve == Null<Size>()) {
+            impl_->amountGetter_->setCallAmount(f.callAmount);
+            f.cashflow->accept(*(impl_->amountGetter_));
+            results_.legNPV[f.leg] += impl_->amountGetter_->amount() * discount;
+            results_.legBPS[f.leg] += impl_->amountGetter_->bpsFactor() * discount;
+        } else {
+            const std::vector<Real>& logs = forwardLogs[f.iborForwardCurve];
+            Real fixingTimesDcf =
+                std::exp(logDiscount(f.accrualStart, logs)) / std::exp(logDiscount(f.accrualEnd, logs)) - 1;
+            if (f.indexDcf != Null<Real>())
+                fixingTimesDcf = fixingTimesDcf / f.indexDcf * f.accrualPeriod;
+            results_.legNPV[f.leg] += (f.gearing * fixingTimesDcf + f.spreadTimesAccrual) * f.nominal * discount;
+            results_.legBPS[f.leg] += f.bpsFactor * discount;
+        }
+    }
+}
+
 } // namespace QuantExt
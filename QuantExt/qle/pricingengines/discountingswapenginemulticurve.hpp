@@ -31,6 +31,8 @@
 namespace QuantExt {
 using namespace QuantLib;
 
+class InterpolatedDiscountCurve;
+
 //! Discounting Swap Engine - Multi Curve
 /*! This class prices a swap with numerous simplifications in the case of
     an ibor coupon leg to speed up the calculations:
@@ -39,6 +41,11 @@ using namespace QuantLib;
       date.
     - start and end discounts of Swap::results not populated.
 
+    If the discount curve is a log linear QuantExt::InterpolatedDiscountCurve, the pillar indices and
+    interpolation weights for all cashflow dates (and for the accrual dates of ibor coupons projected on
+    such a curve) are precomputed and cached per swap, so that repricing the swap on new pillar values
+    (e.g. in sensitivity or historical simulation runs) is a dot product against the pillar log discounts.
+
     \warning if an IborCoupon with non-natural fixing and/or accrual
              period is present, the NPV will be false
 
@@ -54,6 +61,9 @@ public:
     Handle<YieldTermStructure> discountCurve() const { return discountCurve_; }
 
 private:
+    void calculateOnCurveArray(const InterpolatedDiscountCurve& curve, const Date& settlementDate,
+                               bool includeRefDateFlows) const;
+
     Handle<YieldTermStructure> discountCurve_;
     bool minimalResults_;
     boost::optional<bool> includeSettlementDateFlows_;
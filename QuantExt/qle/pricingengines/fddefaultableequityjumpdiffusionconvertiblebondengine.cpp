@@ -278,6 +278,7 @@ void FdDefaultableEquityJumpDiffusionConvertibleBondEngine::calculate() const {
 
     Size n = mesher_->locations().size();
     std::vector<Array> value(stochasticConversionRatios.size(), Array(n, 0.0)), valueTmp;
+    Array valueBondFloor(n, 0.0);
     std::vector<Array> conversionIndicator;
     if (generateAdditionalResults_)
         conversionIndicator.resize(stochasticConversionRatios.size(), Array(n, 0.0));
@@ -605,23 +606,18 @@ void FdDefaultableEquityJumpDiffusionConvertibleBondEngine::calculate() const {
 
         } // loop over stochastic conversion ratio planes
 
-    } // loop over times (PDE rollback)
-
-    // 12 do a second roll back to compute the bond floor (include final redemption even for perpetuals)
+        // 11.12 roll back the bond floor (include final redemption even for perpetuals), this reuses the operator
+        //       coefficients on the current time step, only the recovery term is updated
 
-    fdmOp->setConversionRatio([](const Real S) { return Null<Real>(); });
-
-    Array valueBondFloor(n, 0.0);
-    for (Size i = grid.size() - 1; i > 0; --i) {
-        Real t_from = grid[i];
-        Real t_to = grid[i - 1];
         if (events.hasBondCashflow(i)) {
             valueBondFloor += events.getBondCashflow(i) + events.getBondFinalRedemption(i);
         }
+        fdmOp->setConversionRatio([](const Real S) { return Null<Real>(); });
         solver->rollback(valueBondFloor, t_from, t_to, 1, 0);
-    }
 
-    // 13 set result
+    } // loop over times (PDE rollback)
+
+    // 12 set result
 
     QL_REQUIRE(
         value.size() == 1,
@@ -643,12 +639,12 @@ void FdDefaultableEquityJumpDiffusionConvertibleBondEngine::calculate() const {
 
     results_.settlementValue = results_.value; // FIXME this is not entirely correct of course
 
-    // 14 set additional results, if not disabled
+    // 13 set additional results, if not disabled
 
     if (!generateAdditionalResults_)
         return;
 
-    // 14.1 output events table
+    // 13.1 output events table
 
     constexpr Size width = 12;
     std::ostringstream header;
@@ -777,7 +773,7 @@ void FdDefaultableEquityJumpDiffusionConvertibleBondEngine::calculate() const {
             break;
     }
 
-    // 14.2 more additional results
+    // 13.2 more additional results
 
     results_.additionalResults.insert(events.additionalResults().begin(), events.additionalResults().end());
 
@@ -29,11 +29,13 @@ McCamCurrencySwapEngine::McCamCurrencySwapEngine(
     const LsmBasisSystem::PolynomialType polynomType, const SobolBrownianGenerator::Ordering ordering,
     const SobolRsg::DirectionIntegers directionIntegers, const std::vector<Handle<YieldTermStructure>>& discountCurves,
     const std::vector<Date>& simulationDates, const std::vector<Size>& externalModelIndices, const bool minimalObsDate,
-    const RegressorModel regressorModel, const Real regressionVarianceCutoff)
+    const RegressorModel regressorModel, const Real regressionVarianceCutoff,
+    const Size regressionMaxBasisSize, const Real regressionSignificanceThreshold)
     : McMultiLegBaseEngine(model, calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
                            calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
                            discountCurves, simulationDates, externalModelIndices, minimalObsDate, regressorModel,
-                           regressionVarianceCutoff),
+                           regressionVarianceCutoff, regressionMaxBasisSize,
+                           regressionSignificanceThreshold),
       currencies_(currencies), npvCcy_(npvCcy) {
     registerWith(model_);
     for (auto const& h : discountCurves)
@@ -59,6 +61,8 @@ void McCamCurrencySwapEngine::calculate() const {
         fxSpot = model_->fxbs(npvCcyIndex - 1)->fxSpotToday()->value();
     results_.value = resultValue_ / fxSpot;
     results_.additionalResults["amcCalculator"] = amcCalculator();
+    results_.additionalResults["regressorSize"] = resultRegressorSize_;
+    results_.additionalResults["regressionBasisSize"] = resultBasisSize_;
 } // calculate
 
 } // namespace QuantExt
@@ -32,11 +32,13 @@ McCamFxForwardEngine::McCamFxForwardEngine(
     const SobolBrownianGenerator::Ordering ordering, const SobolRsg::DirectionIntegers directionIntegers,
     const std::vector<Handle<YieldTermStructure>>& discountCurves, const std::vector<Date>& simulationDates,
     const std::vector<Size>& externalModelIndices, const bool minimalObsDate, const RegressorModel regressorModel,
-    const Real regressionVarianceCutoff)
+    const Real regressionVarianceCutoff,
+    const Size regressionMaxBasisSize, const Real regressionSignificanceThreshold)
     : McMultiLegBaseEngine(model, calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
                            calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
                            discountCurves, simulationDates, externalModelIndices, minimalObsDate, regressorModel,
-                           regressionVarianceCutoff),
+                           regressionVarianceCutoff, regressionMaxBasisSize,
+                           regressionSignificanceThreshold),
       domesticCcy_(domesticCcy), foreignCcy_(foreignCcy), npvCcy_(npvCcy) {
     registerWith(model_);
     for (auto const& h : discountCurves)
@@ -64,6 +66,8 @@ void McCamFxForwardEngine::calculate() const {
     results_.value = resultValue_ / fxSpot;
     results_.additionalResults["underlyingNpv"] = resultUnderlyingNpv_ / fxSpot;
     results_.additionalResults["amcCalculator"] = amcCalculator();
+    results_.additionalResults["regressorSize"] = resultRegressorSize_;
+    results_.additionalResults["regressionBasisSize"] = resultBasisSize_;
 
 } // calculate
 
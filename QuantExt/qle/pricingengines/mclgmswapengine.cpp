@@ -33,6 +33,8 @@ void McLgmSwapEngine::calculate() const {
     McMultiLegBaseEngine::calculate();
     results_.value = resultValue_;
     results_.additionalResults["amcCalculator"] = amcCalculator();
+    results_.additionalResults["regressorSize"] = resultRegressorSize_;
+    results_.additionalResults["regressionBasisSize"] = resultBasisSize_;
 } // McLgmSwaptionEngine::calculate
 
 } // namespace QuantExt
@@ -35,6 +35,8 @@ void McLgmSwaptionEngine::calculate() const {
     results_.value = resultValue_;
     results_.additionalResults["underlyingNpv"] = resultUnderlyingNpv_;
     results_.additionalResults["amcCalculator"] = amcCalculator();
+    results_.additionalResults["regressorSize"] = resultRegressorSize_;
+    results_.additionalResults["regressionBasisSize"] = resultBasisSize_;
 } // McLgmSwaptionEngine::calculate
 
 void McLgmNonstandardSwaptionEngine::calculate() const {
@@ -50,6 +52,8 @@ void McLgmNonstandardSwaptionEngine::calculate() const {
     results_.value = resultValue_;
     results_.additionalResults["underlyingNpv"] = resultUnderlyingNpv_;
     results_.additionalResults["amcCalculator"] = amcCalculator();
+    results_.additionalResults["regressorSize"] = resultRegressorSize_;
+    results_.additionalResults["regressionBasisSize"] = resultBasisSize_;
 } // McLgmSwaptionEngine::calculate
 
 } // namespace QuantExt
@@ -44,14 +44,17 @@ public:
                         const std::vector<Date> simulationDates = std::vector<Date>(),
                         const std::vector<Size> externalModelIndices = std::vector<Size>(),
                         const bool minimalObsDate = true, const RegressorModel regressorModel = RegressorModel::Simple,
-                        const Real regressionVarianceCutoff = Null<Real>())
+                        const Real regressionVarianceCutoff = Null<Real>(),
+                        const Size regressionMaxBasisSize = Null<Size>(),
+                        const Real regressionSignificanceThreshold = Null<Real>())
         : GenericEngine<QuantLib::Swaption::arguments, QuantLib::Swaption::results>(),
           McMultiLegBaseEngine(Handle<CrossAssetModel>(QuantLib::ext::make_shared<CrossAssetModel>(
                                    std::vector<QuantLib::ext::shared_ptr<IrModel>>(1, model),
                                    std::vector<QuantLib::ext::shared_ptr<FxBsParametrization>>())),
                                calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
                                calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
-                               {discountCurve}, simulationDates, externalModelIndices, minimalObsDate, regressorModel) {
+                               {discountCurve}, simulationDates, externalModelIndices, minimalObsDate, regressorModel,
+                               regressionVarianceCutoff, regressionMaxBasisSize, regressionSignificanceThreshold) {
         registerWith(model);
     }
 
@@ -38,8 +38,46 @@
 #include <ql/experimental/coupons/strippedcapflooredcoupon.hpp>
 #include <ql/indexes/swapindex.hpp>
 
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <numeric>
+
 namespace QuantExt {
 
+namespace {
+// simulate the states of the model on the given times, pathValues must be of size times x state process size
+void generatePathValues(const CrossAssetModel& model, const SequenceType sequenceType, const Size samples,
+                        const Size seed, const SobolBrownianGenerator::Ordering ordering,
+                        const SobolRsg::DirectionIntegers directionIntegers, const std::set<Real>& times,
+                        std::vector<std::vector<RandomVariable>>& pathValues) {
+
+    TimeGrid timeGrid(times.begin(), times.end());
+
+    QuantLib::ext::shared_ptr<StochasticProcess> process = model.stateProcess();
+    if (model.dimension() == 1) {
+        // use lgm process if possible for better performance
+        auto tmp = QuantLib::ext::make_shared<IrLgm1fStateProcess>(model.irlgm1f(0));
+        tmp->resetCache(timeGrid.size() - 1);
+        process = tmp;
+    } else if (auto tmp = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(process)) {
+        // enable cache
+        tmp->resetCache(timeGrid.size() - 1);
+    }
+
+    auto pathGenerator = makeMultiPathGenerator(sequenceType, process, timeGrid, seed, ordering, directionIntegers);
+
+    for (Size i = 0; i < samples; ++i) {
+        const MultiPath& path = pathGenerator->next().value;
+        for (Size j = 0; j < times.size(); ++j) {
+            for (Size k = 0; k < model.stateProcess()->size(); ++k) {
+                pathValues[j][k].data()[i] = path[k][j + 1];
+            }
+        }
+    }
+}
+} // namespace
+
 McMultiLegBaseEngine::McMultiLegBaseEngine(
     const Handle<CrossAssetModel>& model, const SequenceType calibrationPathGenerator,
     const SequenceType pricingPathGenerator, const Size calibrationSamples, const Size pricingSamples,
@@ -47,13 +85,15 @@ McMultiLegBaseEngine::McMultiLegBaseEngine(
     const LsmBasisSystem::PolynomialType polynomType, const SobolBrownianGenerator::Ordering ordering,
     SobolRsg::DirectionIntegers directionIntegers, const std::vector<Handle<YieldTermStructure>>& discountCurves,
     const std::vector<Date>& simulationDates, const std::vector<Size>& externalModelIndices, const bool minimalObsDate,
-    const RegressorModel regressorModel, const Real regressionVarianceCutoff)
+    const RegressorModel regressorModel, const Real regressionVarianceCutoff,
+    const Size regressionMaxBasisSize, const Real regressionSignificanceThreshold)
     : model_(model), calibrationPathGenerator_(calibrationPathGenerator), pricingPathGenerator_(pricingPathGenerator),
       calibrationSamples_(calibrationSamples), pricingSamples_(pricingSamples), calibrationSeed_(calibrationSeed),
       pricingSeed_(pricingSeed), polynomOrder_(polynomOrder), polynomType_(polynomType), ordering_(ordering),
       directionIntegers_(directionIntegers), discountCurves_(discountCurves), simulationDates_(simulationDates),
       externalModelIndices_(externalModelIndices), minimalObsDate_(minimalObsDate), regressorModel_(regressorModel),
-      regressionVarianceCutoff_(regressionVarianceCutoff) {
+      regressionVarianceCutoff_(regressionVarianceCutoff), regressionMaxBasisSize_(regressionMaxBasisSize),
+      regressionSignificanceThreshold_(regressionSignificanceThreshold) {
 
     if (discountCurves_.empty())
         discountCurves_.resize(model_->components(CrossAssetModel::AssetType::IR));
@@ -773,8 +813,24 @@ void McMultiLegBaseEngine::calculate() const {
     simulationTimes.insert(exerciseTimes.begin(), exerciseTimes.end());
     simulationTimes.insert(xvaTimes.begin(), xvaTimes.end());
 
+    // check whether we can use shared calibration paths, in the collection phase we only register the times
+
+    auto& sharedPaths = McSharedPaths::instance();
+    QuantLib::ext::shared_ptr<CrossAssetModel> externalModel;
+    if (externalModelIndices_.size() == model_->stateProcess()->size())
+        externalModel = sharedPaths.externalModel(**model_);
+    McSharedPaths::Key sharedPathsKey(calibrationPathGenerator_, calibrationSamples_, calibrationSeed_, ordering_,
+                                      directionIntegers_);
+
     McEngineStats::instance().other_timer.stop();
 
+    auto regressionCache = externalModel ? sharedPaths.regressionCache(externalModel) : nullptr;
+
+    if (externalModel && sharedPaths.collecting(externalModel)) {
+        sharedPaths.registerTimes(externalModel, sharedPathsKey, simulationTimes);
+        throw McSharedPaths::TimesCollected();
+    }
+
     // simulate the paths for the calibration
 
     McEngineStats::instance().path_timer.resume();
@@ -794,29 +850,21 @@ void McMultiLegBaseEngine::calculate() const {
         }
     }
 
-    TimeGrid timeGrid(simulationTimes.begin(), simulationTimes.end());
-
-    QuantLib::ext::shared_ptr<StochasticProcess> process = model_->stateProcess();
-    if (model_->dimension() == 1) {
-        // use lgm process if possible for better performance
-        auto tmp = QuantLib::ext::make_shared<IrLgm1fStateProcess>(model_->irlgm1f(0));
-        tmp->resetCache(timeGrid.size() - 1);
-        process = tmp;
-    } else if (auto tmp = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(process)) {
-        // enable cache
-        tmp->resetCache(timeGrid.size() - 1);
-    }
-
-    auto pathGenerator = makeMultiPathGenerator(calibrationPathGenerator_, process, timeGrid, calibrationSeed_,
-                                                ordering_, directionIntegers_);
-
-    for (Size i = 0; i < calibrationSamples_; ++i) {
-        const MultiPath& path = pathGenerator->next().value;
-        for (Size j = 0; j < simulationTimes.size(); ++j) {
-            for (Size k = 0; k < model_->stateProcess()->size(); ++k) {
-                pathValues[j][k].data()[i] = path[k][j + 1];
-            }
+    auto shared = externalModel ? sharedPaths.paths(externalModel, sharedPathsKey, simulationTimes) : nullptr;
+
+    if (shared) {
+        // copy the states from the shared paths, the external model indices map the states to the external model
+        Size j = 0;
+        for (auto const t : simulationTimes) {
+            Size idx = std::distance(shared->times.begin(),
+                                     std::lower_bound(shared->times.begin(), shared->times.end(), t));
+            for (Size k = 0; k < model_->stateProcess()->size(); ++k)
+                pathValues[j][k] = shared->values[idx][externalModelIndices_[k]];
+            ++j;
         }
+    } else {
+        generatePathValues(*model_, calibrationPathGenerator_, calibrationSamples_, calibrationSeed_, ordering_,
+                           directionIntegers_, simulationTimes, pathValues);
     }
 
     McEngineStats::instance().path_timer.stop();
@@ -875,9 +923,9 @@ void McMultiLegBaseEngine::calculate() const {
         if (exercise_ != nullptr) {
             regModelUndExInto[counter] = RegressionModel(
                 *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
-                regressorModel_, regressionVarianceCutoff_);
+                regressorModel_, regressionVarianceCutoff_, regressionMaxBasisSize_, regressionSignificanceThreshold_);
             regModelUndExInto[counter].train(polynomOrder_, polynomType_, pathValueUndExInto, pathValuesRef,
-                                             simulationTimes);
+                                             simulationTimes, Filter(), regressionCache.get());
         }
 
         if (isExerciseTime) {
@@ -885,10 +933,11 @@ void McMultiLegBaseEngine::calculate() const {
                                                                   pathValuesRef, simulationTimes);
             regModelContinuationValue[counter] = RegressionModel(
                 *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
-                regressorModel_, regressionVarianceCutoff_);
+                regressorModel_, regressionVarianceCutoff_, regressionMaxBasisSize_, regressionSignificanceThreshold_);
             regModelContinuationValue[counter].train(polynomOrder_, polynomType_, pathValueOption, pathValuesRef,
                                                      simulationTimes,
-                                                     exerciseValue > RandomVariable(calibrationSamples_, 0.0));
+                                                     exerciseValue > RandomVariable(calibrationSamples_, 0.0),
+                                                     regressionCache.get());
             auto continuationValue = regModelContinuationValue[counter].apply(model_->stateProcess()->initialValues(),
                                                                               pathValuesRef, simulationTimes);
             pathValueOption = conditionalResult(exerciseValue > continuationValue &&
@@ -896,23 +945,25 @@ void McMultiLegBaseEngine::calculate() const {
                                                 pathValueUndExInto, pathValueOption);
             regModelOption[counter] = RegressionModel(
                 *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
-                regressorModel_, regressionVarianceCutoff_);
-            regModelOption[counter].train(polynomOrder_, polynomType_, pathValueOption, pathValuesRef, simulationTimes);
+                regressorModel_, regressionVarianceCutoff_, regressionMaxBasisSize_, regressionSignificanceThreshold_);
+            regModelOption[counter].train(polynomOrder_, polynomType_, pathValueOption, pathValuesRef, simulationTimes,
+                                          Filter(), regressionCache.get());
         }
 
         if (isXvaTime) {
             regModelUndDirty[counter] = RegressionModel(
                 *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] != CfStatus::open; }, **model_,
-                regressorModel_, regressionVarianceCutoff_);
+                regressorModel_, regressionVarianceCutoff_, regressionMaxBasisSize_, regressionSignificanceThreshold_);
             regModelUndDirty[counter].train(polynomOrder_, polynomType_, pathValueUndDirty, pathValuesRef,
-                                            simulationTimes);
+                                            simulationTimes, Filter(), regressionCache.get());
         }
 
         if (exercise_ != nullptr) {
             regModelOption[counter] = RegressionModel(
                 *t, cashflowInfo, [&cfStatus](std::size_t i) { return cfStatus[i] == CfStatus::done; }, **model_,
-                regressorModel_, regressionVarianceCutoff_);
-            regModelOption[counter].train(polynomOrder_, polynomType_, pathValueOption, pathValuesRef, simulationTimes);
+                regressorModel_, regressionVarianceCutoff_, regressionMaxBasisSize_, regressionSignificanceThreshold_);
+            regModelOption[counter].train(polynomOrder_, polynomType_, pathValueOption, pathValuesRef, simulationTimes,
+                                          Filter(), regressionCache.get());
         }
 
         --counter;
@@ -932,6 +983,16 @@ void McMultiLegBaseEngine::calculate() const {
                        ? resultUnderlyingNpv_
                        : expectation(pathValueOption).at(0) * model_->numeraire(0, 0.0, 0.0, discountCurves_[0]);
 
+    // collect the effective regressor and basis sizes
+
+    resultRegressorSize_ = resultBasisSize_ = 0;
+    for (auto const* regModels : {&regModelUndDirty, &regModelUndExInto, &regModelContinuationValue, &regModelOption}) {
+        for (auto const& m : *regModels) {
+            resultRegressorSize_ = std::max(resultRegressorSize_, m.regressorSize());
+            resultBasisSize_ = std::max(resultBasisSize_, m.basisSize());
+        }
+    }
+
     McEngineStats::instance().calc_timer.stop();
 
     // construct the amc calculator
@@ -1101,13 +1162,215 @@ std::vector<QuantExt::RandomVariable> McMultiLegBaseEngine::MultiLegBaseAmcCalcu
     return result;
 }
 
+std::size_t McRegressionCache::hash(const std::vector<const RandomVariable*>& regressor, const Filter& filter,
+                                    const Size polynomOrder, const LsmBasisSystem::PolynomialType polynomType,
+                                    const Real regressionVarianceCutoff, const Size regressionMaxBasisSize) {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, polynomOrder);
+    boost::hash_combine(seed, static_cast<int>(polynomType));
+    boost::hash_combine(seed, regressionVarianceCutoff);
+    boost::hash_combine(seed, regressionMaxBasisSize);
+    boost::hash_combine(seed, regressor.size());
+    for (auto const r : regressor) {
+        boost::hash_combine(seed, r->size());
+        boost::hash_combine(seed, r->deterministic());
+        if (r->deterministic())
+            boost::hash_combine(seed, r->at(0));
+        else
+            boost::hash_range(seed, r->data(), r->data() + r->size());
+    }
+    boost::hash_combine(seed, filter.size());
+    for (Size i = 0; i < filter.size(); ++i)
+        boost::hash_combine(seed, filter[i]);
+    return seed;
+}
+
+QuantLib::ext::shared_ptr<const McRegressionCache::Entry>
+McRegressionCache::get(const std::size_t hash, const std::vector<const RandomVariable*>& regressor,
+                       const Filter& filter, const Size polynomOrder, const LsmBasisSystem::PolynomialType polynomType,
+                       const Real regressionVarianceCutoff, const Size regressionMaxBasisSize) const {
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    auto e = entries_.find(hash);
+    if (e == entries_.end())
+        return nullptr;
+    for (auto const& entry : e->second) {
+        const Key& k = entry->key;
+        if (k.polynomOrder != polynomOrder || k.polynomType != polynomType ||
+            k.regressionVarianceCutoff != regressionVarianceCutoff ||
+            k.regressionMaxBasisSize != regressionMaxBasisSize || k.regressor.size() != regressor.size() ||
+            k.filter != filter)
+            continue;
+        bool match = true;
+        for (Size i = 0; i < regressor.size() && match; ++i)
+            match = k.regressor[i] == *regressor[i];
+        if (match)
+            return entry;
+    }
+    return nullptr;
+}
+
+void McRegressionCache::add(const std::size_t hash, const QuantLib::ext::shared_ptr<const Entry>& entry) {
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    if (size_ >= maxEntries) {
+        entries_.clear();
+        size_ = 0;
+    }
+    entries_[hash].push_back(entry);
+    ++size_;
+}
+
+void McRegressionCache::clear() {
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    entries_.clear();
+    size_ = 0;
+}
+
+Size McRegressionCache::size() const {
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return size_;
+}
+
+McSharedPaths::Scope::Scope(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel, const Size maxTimes)
+    : externalModel_(externalModel) {
+    McSharedPaths::instance().add(externalModel_, maxTimes);
+}
+
+McSharedPaths::Scope::~Scope() { McSharedPaths::instance().remove(externalModel_); }
+
+void McSharedPaths::add(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel, const Size maxTimes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry newEntry{externalModel, maxTimes};
+    newEntry.regressionCache = QuantLib::ext::make_shared<McRegressionCache>();
+    if (auto e = entry(externalModel))
+        *e = newEntry;
+    else
+        entries_.push_back(newEntry);
+}
+
+void McSharedPaths::remove(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                  [&externalModel](const Entry& e) { return e.model == externalModel; }),
+                   entries_.end());
+}
+
+void McSharedPaths::setCollecting(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel,
+                                  const bool collecting) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto e = entry(externalModel))
+        e->collecting = collecting;
+}
+
+QuantLib::ext::shared_ptr<CrossAssetModel> McSharedPaths::externalModel(const CrossAssetModel& engineModel) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto const& e : entries_) {
+        if (e.model->irModel(0) == engineModel.irModel(0))
+            return e.model;
+    }
+    return nullptr;
+}
+
+bool McSharedPaths::collecting(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto e = std::find_if(entries_.begin(), entries_.end(),
+                          [&externalModel](const Entry& e) { return e.model == externalModel; });
+    return e != entries_.end() && e->collecting;
+}
+
+void McSharedPaths::registerTimes(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel, const Key& key,
+                                  const std::set<Real>& times) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto e = entry(externalModel))
+        e->times[key].insert(times.begin(), times.end());
+}
+
+QuantLib::ext::shared_ptr<const McSharedPaths::Paths>
+McSharedPaths::paths(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel, const Key& key,
+                     const std::set<Real>& times) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto e = entry(externalModel);
+    if (e == nullptr)
+        return nullptr;
+    auto t = e->times.find(key);
+    if (t == e->times.end() || t->second.empty() || t->second.size() > e->maxTimes ||
+        !std::includes(t->second.begin(), t->second.end(), times.begin(), times.end()))
+        return nullptr;
+    auto p = e->paths.find(key);
+    if (p != e->paths.end())
+        return p->second;
+    auto result = QuantLib::ext::make_shared<Paths>();
+    result->times.assign(t->second.begin(), t->second.end());
+    result->values.resize(t->second.size(), std::vector<RandomVariable>(e->model->stateProcess()->size(),
+                                                                        RandomVariable(std::get<1>(key))));
+    for (auto& v : result->values) {
+        for (auto& w : v)
+            w.expand();
+    }
+    generatePathValues(*e->model, std::get<0>(key), std::get<1>(key), std::get<2>(key), std::get<3>(key),
+                       std::get<4>(key), t->second, result->values);
+    e->paths[key] = result;
+    return result;
+}
+
+QuantLib::ext::shared_ptr<McRegressionCache>
+McSharedPaths::regressionCache(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto e = std::find_if(entries_.begin(), entries_.end(),
+                          [&externalModel](const Entry& e) { return e.model == externalModel; });
+    return e == entries_.end() ? nullptr : e->regressionCache;
+}
+
+McSharedPaths::Entry* McSharedPaths::entry(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel) {
+    auto e = std::find_if(entries_.begin(), entries_.end(),
+                          [&externalModel](const Entry& e) { return e.model == externalModel; });
+    return e == entries_.end() ? nullptr : &*e;
+}
+
+namespace {
+/* significance of a regressor x for the regressand y: max of |corr(x, y)| and |corr(x^2, y)| on the filtered
+   samples, the second term catches regressors entering the conditional expectation in a symmetric way */
+Real regressorSignificance(const RandomVariable& x, const RandomVariable& y, const Filter& filter) {
+    if (x.deterministic())
+        return 0.0;
+    Real n = 0.0, sx = 0.0, sxx = 0.0, sx4 = 0.0, sy = 0.0, syy = 0.0, sxy = 0.0, sxxy = 0.0;
+    for (Size i = 0; i < y.size(); ++i) {
+        if (filter.initialised() && !filter[i])
+            continue;
+        Real xi = x[i], yi = y[i], xi2 = xi * xi;
+        n += 1.0;
+        sx += xi;
+        sxx += xi2;
+        sx4 += xi2 * xi2;
+        sy += yi;
+        syy += yi * yi;
+        sxy += xi * yi;
+        sxxy += xi2 * yi;
+    }
+    if (n < 2.0)
+        return 0.0;
+    Real varX = sxx / n - (sx / n) * (sx / n), varXX = sx4 / n - (sxx / n) * (sxx / n),
+         varY = syy / n - (sy / n) * (sy / n);
+    if (varY < QL_EPSILON)
+        return 0.0;
+    Real result = 0.0;
+    if (varX > QL_EPSILON)
+        result = std::abs(sxy / n - sx / n * sy / n) / std::sqrt(varX * varY);
+    if (varXX > QL_EPSILON)
+        result = std::max(result, std::abs(sxxy / n - sxx / n * sy / n) / std::sqrt(varXX * varY));
+    return result;
+}
+} // namespace
+
 McMultiLegBaseEngine::RegressionModel::RegressionModel(const Real observationTime,
                                                        const std::vector<CashflowInfo>& cashflowInfo,
                                                        const std::function<bool(std::size_t)>& cashflowRelevant,
                                                        const CrossAssetModel& model,
                                                        const McMultiLegBaseEngine::RegressorModel regressorModel,
-                                                       const Real regressionVarianceCutoff)
-    : observationTime_(observationTime), regressionVarianceCutoff_(regressionVarianceCutoff) {
+                                                       const Real regressionVarianceCutoff,
+                                                       const Size regressionMaxBasisSize,
+                                                       const Real regressionSignificanceThreshold)
+    : observationTime_(observationTime), regressionVarianceCutoff_(regressionVarianceCutoff),
+      regressionMaxBasisSize_(regressionMaxBasisSize), regressionSignificanceThreshold_(regressionSignificanceThreshold) {
 
     // we always include the full model state as of the observation time
 
@@ -1148,7 +1411,8 @@ void McMultiLegBaseEngine::RegressionModel::train(const Size polynomOrder,
                                                   const LsmBasisSystem::PolynomialType polynomType,
                                                   const RandomVariable& regressand,
                                                   const std::vector<std::vector<const RandomVariable*>>& paths,
-                                                  const std::set<Real>& pathTimes, const Filter& filter) {
+                                                  const std::set<Real>& pathTimes, const Filter& filter,
+                                                  McRegressionCache* regressionCache) {
 
     // check if the model is in the correct state
 
@@ -1166,11 +1430,64 @@ void McMultiLegBaseEngine::RegressionModel::train(const Size polynomOrder,
         regressor.push_back(paths[std::distance(pathTimes.begin(), pt)][modelIdx]);
      }
 
+    /* regressor selection: drop regressors whose significance for the regressand is below the threshold and, if a
+       max basis size is given, keep at most as many regressors as fit into a basis of order one, we always keep the
+       most significant regressor and do not select anything if the regressand is constant */
+
+    Size maxRegressors = regressionMaxBasisSize_ == Null<Size>() ? Null<Size>()
+                                                                 : std::max<Size>(regressionMaxBasisSize_, 2) - 1;
+    if (!regressor.empty() &&
+        (regressionSignificanceThreshold_ != Null<Real>() ||
+         (maxRegressors != Null<Size>() && regressor.size() > maxRegressors))) {
+        std::vector<Real> significance(regressor.size());
+        for (Size i = 0; i < regressor.size(); ++i)
+            significance[i] = regressorSignificance(*regressor[i], regressand, filter);
+        if (*std::max_element(significance.begin(), significance.end()) > 0.0) {
+            std::vector<Size> rank(regressor.size());
+            std::iota(rank.begin(), rank.end(), 0);
+            std::stable_sort(rank.begin(), rank.end(),
+                             [&significance](Size i, Size j) { return significance[i] > significance[j]; });
+            std::vector<bool> keep(regressor.size(), false);
+            for (Size k = 0; k < rank.size(); ++k) {
+                if (k > 0 && ((regressionSignificanceThreshold_ != Null<Real>() &&
+                               significance[rank[k]] < regressionSignificanceThreshold_) ||
+                              (maxRegressors != Null<Size>() && k >= maxRegressors)))
+                    break;
+                keep[rank[k]] = true;
+            }
+            std::vector<const RandomVariable*> selectedRegressor;
+            Size i = 0;
+            for (auto r = regressorTimesModelIndices_.begin(); r != regressorTimesModelIndices_.end(); ++i) {
+                if (keep[i]) {
+                    selectedRegressor.push_back(regressor[i]);
+                    ++r;
+                } else {
+                    r = regressorTimesModelIndices_.erase(r);
+                }
+            }
+            regressor = selectedRegressor;
+        }
+    }
+
+    // look up the coordinate transform and the factorisation of the normal equations in the cache
+
+    QuantLib::ext::shared_ptr<const McRegressionCache::Entry> cacheEntry;
+    std::size_t cacheHash = 0;
+    if (regressionCache) {
+        cacheHash = McRegressionCache::hash(regressor, filter, polynomOrder, polynomType, regressionVarianceCutoff_,
+                                            regressionMaxBasisSize_);
+        cacheEntry = regressionCache->get(cacheHash, regressor, filter, polynomOrder, polynomType,
+                                          regressionVarianceCutoff_, regressionMaxBasisSize_);
+    }
+
     // factor reduction to reduce dimensionalitty and handle collinearity
 
+    std::vector<const RandomVariable*> untransformedRegressor = regressor;
+
     std::vector<RandomVariable> transformedRegressor;
     if (regressionVarianceCutoff_ != Null<Real>()) {
-        coordinateTransform_ = pcaCoordinateTransform(regressor, regressionVarianceCutoff_);
+        coordinateTransform_ = cacheEntry ? cacheEntry->coordinateTransform
+                                          : pcaCoordinateTransform(regressor, regressionVarianceCutoff_);
         transformedRegressor = applyCoordinateTransform(regressor, coordinateTransform_);
         regressor = vec2vecptr(transformedRegressor);
     }
@@ -1181,12 +1498,29 @@ void McMultiLegBaseEngine::RegressionModel::train(const Size polynomOrder,
 
         // get the basis functions
 
-        basisFns_ = multiPathBasisSystem(regressor.size(), polynomOrder, polynomType, Null<Size>());
+        regressorSize_ = regressor.size();
+        basisFns_ = multiPathBasisSystem(regressor.size(), polynomOrder, polynomType, regressionMaxBasisSize_);
 
         // compute the regression coefficients
 
-        regressionCoeffs_ =
-            regressionCoefficients(regressand, regressor, basisFns_, filter, RandomVariableRegressionMethod::QR);
+        if (regressionCache) {
+            if (!cacheEntry) {
+                auto entry = QuantLib::ext::make_shared<McRegressionCache::Entry>();
+                entry->key = McRegressionCache::Key{polynomOrder, polynomType, regressionVarianceCutoff_,
+                                                    regressionMaxBasisSize_, {}, filter};
+                for (auto const r : untransformedRegressor)
+                    entry->key.regressor.push_back(*r);
+                entry->coordinateTransform = coordinateTransform_;
+                entry->factorisation = normalEquationsFactorisation(regressor, basisFns_, filter, regressand.size());
+                regressionCache->add(cacheHash, entry);
+                cacheEntry = entry;
+            }
+            regressionCoeffs_ =
+                regressionCoefficients(regressand, regressor, basisFns_, filter, cacheEntry->factorisation);
+        } else {
+            regressionCoeffs_ =
+                regressionCoefficients(regressand, regressor, basisFns_, filter, RandomVariableRegressionMethod::QR);
+        }
 
     } else {
 
@@ -24,6 +24,7 @@
 
 #include <qle/indexes/fxindex.hpp>
 #include <qle/instruments/multilegoption.hpp>
+#include <qle/math/randomvariable.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
 #include <qle/models/crossassetmodel.hpp>
 #include <qle/models/lgmvectorised.hpp>
@@ -33,6 +34,12 @@
 #include <ql/instruments/swaption.hpp>
 #include <ql/methods/montecarlo/lsmbasissystem.hpp>
 
+#include <boost/thread/shared_mutex.hpp>
+
+#include <map>
+#include <mutex>
+#include <tuple>
+
 namespace QuantExt {
 
 // statistics
@@ -58,6 +65,115 @@ struct McEngineStats : public QuantLib::Singleton<McEngineStats> {
     boost::timer::cpu_timer calc_timer;
 };
 
+/* Cache for the regressions in McMultiLegBaseEngine::RegressionModel::train(). Trades priced on the same paths with
+   the same regressors (and filter) share the coordinate transform and the factorisation of the normal equations, only
+   the projection of their own regressand is computed per trade. An entry stores its full key, i.e. the regressor
+   values, the filter and the regression parameters, which is compared on a hit, so that a hash collision can not
+   return the factorisation of different regressors. There is one cache per external model registered in McSharedPaths,
+   i.e. per AMC run, the engines running on other models do not use a cache. */
+struct McRegressionCache {
+    struct Key {
+        Size polynomOrder;
+        LsmBasisSystem::PolynomialType polynomType;
+        Real regressionVarianceCutoff;
+        Size regressionMaxBasisSize;
+        std::vector<RandomVariable> regressor;
+        Filter filter;
+    };
+
+    struct Entry {
+        Key key;
+        Matrix coordinateTransform;
+        NormalEquationsFactorisation factorisation;
+    };
+
+    // hash of the regressor values, the filter and the regression parameters
+    static std::size_t hash(const std::vector<const RandomVariable*>& regressor, const Filter& filter,
+                            const Size polynomOrder, const LsmBasisSystem::PolynomialType polynomType,
+                            const Real regressionVarianceCutoff, const Size regressionMaxBasisSize);
+
+    // the entry with the given key data, or null if there is none
+    QuantLib::ext::shared_ptr<const Entry> get(const std::size_t hash,
+                                               const std::vector<const RandomVariable*>& regressor,
+                                               const Filter& filter, const Size polynomOrder,
+                                               const LsmBasisSystem::PolynomialType polynomType,
+                                               const Real regressionVarianceCutoff,
+                                               const Size regressionMaxBasisSize) const;
+    void add(const std::size_t hash, const QuantLib::ext::shared_ptr<const Entry>& entry);
+    void clear();
+    Size size() const;
+
+    Size maxEntries = 256;
+
+private:
+    mutable boost::shared_mutex mutex_;
+    std::map<std::size_t, std::vector<QuantLib::ext::shared_ptr<const Entry>>> entries_;
+    Size size_ = 0;
+};
+
+/* Calibration paths shared by the McMultiLegBaseEngine instances running on the same external cross asset model, used
+   by the AMC valuation engine. An engine is associated with an external model if its (projected) model shares the base
+   currency IR model with the external model and external model indices are given. In the collection phase each engine
+   registers its simulation times and aborts its calculation by throwing TimesCollected. Afterwards the paths are
+   generated once per set of path generator settings on the union of the registered times and the engines copy their
+   states from these paths instead of generating their own paths. If the union of the times exceeds maxTimes or an
+   engine requests times that were not registered, the engine generates its own paths as usual. */
+struct McSharedPaths : public QuantLib::Singleton<McSharedPaths> {
+    struct TimesCollected : public std::exception {
+        const char* what() const noexcept override { return "McSharedPaths: simulation times collected"; }
+    };
+
+    // sequence type, samples, seed, ordering, direction integers
+    using Key = std::tuple<SequenceType, Size, Size, SobolBrownianGenerator::Ordering, SobolRsg::DirectionIntegers>;
+
+    struct Paths {
+        std::vector<Real> times;
+        std::vector<std::vector<RandomVariable>> values; // times x state process size of the external model
+    };
+
+    /* Registers an external model for the lifetime of the scope, the model is removed again on destruction, also if
+       the run is left by an exception */
+    class Scope {
+    public:
+        explicit Scope(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel, const Size maxTimes = 500);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        QuantLib::ext::shared_ptr<CrossAssetModel> externalModel_;
+    };
+
+    void add(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel, const Size maxTimes = 500);
+    void remove(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel);
+    void setCollecting(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel, const bool collecting);
+
+    // the external model associated with an engine model, or null if there is none
+    QuantLib::ext::shared_ptr<CrossAssetModel> externalModel(const CrossAssetModel& engineModel) const;
+    bool collecting(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel) const;
+    void registerTimes(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel, const Key& key,
+                       const std::set<Real>& times);
+    // the shared paths, generated on the first call, or null if the given times are not covered
+    QuantLib::ext::shared_ptr<const Paths> paths(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel,
+                                                 const Key& key, const std::set<Real>& times);
+    // the regression cache of the external model, or null if the model is not registered
+    QuantLib::ext::shared_ptr<McRegressionCache>
+    regressionCache(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel) const;
+
+private:
+    struct Entry {
+        QuantLib::ext::shared_ptr<CrossAssetModel> model;
+        Size maxTimes;
+        bool collecting = false;
+        std::map<Key, std::set<Real>> times;
+        std::map<Key, QuantLib::ext::shared_ptr<const Paths>> paths;
+        QuantLib::ext::shared_ptr<McRegressionCache> regressionCache;
+    };
+    Entry* entry(const QuantLib::ext::shared_ptr<CrossAssetModel>& externalModel);
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+};
+
 class McMultiLegBaseEngine {
 public:
     enum RegressorModel { Simple, LaggedFX };
@@ -81,7 +197,9 @@ protected:
         const std::vector<Date>& simulationDates = std::vector<Date>(),
         const std::vector<Size>& externalModelIndices = std::vector<Size>(), const bool minimalObsDate = true,
         const RegressorModel regressorModel = RegressorModel::Simple,
-        const Real regressionVarianceCutoff = Null<Real>());
+        const Real regressionVarianceCutoff = Null<Real>(),
+        const Size regressionMaxBasisSize = Null<Size>(),
+        const Real regressionSignificanceThreshold = Null<Real>());
 
     // run calibration and pricing (called from derived engines)
     void calculate() const;
@@ -111,12 +229,16 @@ protected:
     bool minimalObsDate_;
     RegressorModel regressorModel_;
     Real regressionVarianceCutoff_;
+    Size regressionMaxBasisSize_;
+    Real regressionSignificanceThreshold_;
 
     // the generated amc calculator
     mutable QuantLib::ext::shared_ptr<AmcCalculator> amcCalculator_;
 
     // results, these are read from derived engines
     mutable Real resultUnderlyingNpv_, resultValue_;
+    // max effective number of regressors and basis functions over the regressions of the last calculation
+    mutable Size resultRegressorSize_ = 0, resultBasisSize_ = 0;
 
 private:
     static constexpr Real tinyTime = 1E-10;
@@ -140,18 +262,28 @@ private:
         RegressionModel() = default;
         RegressionModel(const Real observationTime, const std::vector<CashflowInfo>& cashflowInfo,
                         const std::function<bool(std::size_t)>& cashflowRelevant, const CrossAssetModel& model,
-                        const RegressorModel regressorModel, const Real regressionVarianceCutoff = Null<Real>());
-        // pathTimes must contain the observation time and the relevant cashflow simulation times
+                        const RegressorModel regressorModel, const Real regressionVarianceCutoff = Null<Real>(),
+                        const Size regressionMaxBasisSize = Null<Size>(),
+                        const Real regressionSignificanceThreshold = Null<Real>());
+        /* pathTimes must contain the observation time and the relevant cashflow simulation times, if a regression
+           cache is given the coordinate transform and the factorisation of the normal equations are looked up there */
         void train(const Size polynomOrder, const LsmBasisSystem::PolynomialType polynomType,
                    const RandomVariable& regressand, const std::vector<std::vector<const RandomVariable*>>& paths,
-                   const std::set<Real>& pathTimes, const Filter& filter = Filter());
+                   const std::set<Real>& pathTimes, const Filter& filter = Filter(),
+                   McRegressionCache* regressionCache = nullptr);
         // pathTimes do not need to contain the observation time or the relevant cashflow simulation times
         RandomVariable apply(const Array& initialState, const std::vector<std::vector<const RandomVariable*>>& paths,
                              const std::set<Real>& pathTimes) const;
+        // effective number of regressors (after selection and factor reduction) and basis functions
+        Size regressorSize() const { return regressorSize_; }
+        Size basisSize() const { return basisFns_.size(); }
 
     private:
         Real observationTime_ = Null<Real>();
         Real regressionVarianceCutoff_ = Null<Real>();
+        Size regressionMaxBasisSize_ = Null<Size>();
+        Real regressionSignificanceThreshold_ = Null<Real>();
+        Size regressorSize_ = 0;
         bool isTrained_ = false;
         std::set<std::pair<Real, Size>> regressorTimesModelIndices_;
         Matrix coordinateTransform_;
@@ -176,6 +308,7 @@ private:
                                                            std::vector<std::vector<QuantExt::RandomVariable>>& paths,
                                                            const std::vector<size_t>& relevantPathIndex,
                                                            const std::vector<size_t>& relevantTimeIndex) override;
+        std::vector<Size> stateIndices() const override { return externalModelIndices_; }
 
     private:
         std::vector<Size> externalModelIndices_;
@@ -27,11 +27,13 @@ McMultiLegOptionEngine::McMultiLegOptionEngine(
     const LsmBasisSystem::PolynomialType polynomType, const SobolBrownianGenerator::Ordering ordering,
     const SobolRsg::DirectionIntegers directionIntegers, const std::vector<Handle<YieldTermStructure>>& discountCurves,
     const std::vector<Date>& simulationDates, const std::vector<Size>& externalModelIndices, const bool minObsDate,
-    const RegressorModel regressorModel, const Real regressionVarianceCutoff)
+    const RegressorModel regressorModel, const Real regressionVarianceCutoff,
+    const Size regressionMaxBasisSize, const Real regressionSignificanceThreshold)
     : McMultiLegBaseEngine(model, calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
                            calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
                            discountCurves, simulationDates, externalModelIndices, minObsDate, regressorModel,
-                           regressionVarianceCutoff) {
+                           regressionVarianceCutoff, regressionMaxBasisSize,
+                           regressionSignificanceThreshold) {
     registerWith(model_);
     for (auto& h : discountCurves_) {
         registerWith(h);
@@ -45,14 +47,16 @@ McMultiLegOptionEngine::McMultiLegOptionEngine(
     const LsmBasisSystem::PolynomialType polynomType, const SobolBrownianGenerator::Ordering ordering,
     const SobolRsg::DirectionIntegers directionIntegers, const Handle<YieldTermStructure>& discountCurve,
     const std::vector<Date>& simulationDates, const std::vector<Size>& externalModelIndices, const bool minimalObsDate,
-    const RegressorModel regressorModel, const Real regressionVarianceCutoff)
+    const RegressorModel regressorModel, const Real regressionVarianceCutoff,
+    const Size regressionMaxBasisSize, const Real regressionSignificanceThreshold)
     : McMultiLegOptionEngine(Handle<CrossAssetModel>(QuantLib::ext::make_shared<CrossAssetModel>(
                                  std::vector<QuantLib::ext::shared_ptr<IrModel>>(1, model),
                                  std::vector<QuantLib::ext::shared_ptr<FxBsParametrization>>())),
                              calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
                              calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
                              {discountCurve}, simulationDates, externalModelIndices, minimalObsDate, regressorModel,
-                             regressionVarianceCutoff) {}
+                             regressionVarianceCutoff, regressionMaxBasisSize,
+                             regressionSignificanceThreshold) {}
 
 void McMultiLegOptionEngine::calculate() const {
 
@@ -72,6 +76,8 @@ void McMultiLegOptionEngine::calculate() const {
     results_.value = resultValue_ / fxSpot;
     results_.additionalResults["underlyingNpv"] = resultUnderlyingNpv_ / fxSpot;
     results_.additionalResults["amcCalculator"] = amcCalculator();
+    results_.additionalResults["regressorSize"] = resultRegressorSize_;
+    results_.additionalResults["regressionBasisSize"] = resultBasisSize_;
 } // calculate
 
 } // namespace QuantExt
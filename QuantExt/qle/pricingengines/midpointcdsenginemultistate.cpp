@@ -55,18 +55,11 @@ void MidPointCdsEngineMultiState::linkCurves(Size i) const {
 
 void MidPointCdsEngineMultiState::calculate() const {
 
-    // calculate all states except the main states
+    // calculate all states in one pass
 
-    std::vector<Real> values(defaultCurves_.size() + 1);
-    for (Size i = 0; i < defaultCurves_.size(); ++i) {
-        if (i == mainResultState_)
-            continue;
-        linkCurves(i);
-        MidPointCdsEngine::calculate();
-        values[i] = results_.value;
-    }
+    std::vector<Real> values = calculateStateValues();
 
-    // calculate the main state last to keep the results from this calculation
+    // calculate the main state with the base engine to get the full set of results
 
     linkCurves(mainResultState_);
     MidPointCdsEngine::calculate();
@@ -74,13 +67,92 @@ void MidPointCdsEngineMultiState::calculate() const {
 
     // calculate the default state
 
-    values.back() = calculateDefaultValue();
+    values.push_back(calculateDefaultValue());
 
     // set additional result
 
     results_.additionalResults["stateNpv"] = values;
 }
 
+std::vector<Real> MidPointCdsEngineMultiState::calculateStateValues() const {
+
+    /* This follows the mid point logic in MidPointCdsEngine, but the coupon dates, amounts and discount factors
+       are computed once and shared between the states, only the survival / default probabilities and the claim
+       amounts are evaluated per state. */
+
+    Size n = defaultCurves_.size();
+    std::vector<Real> recoveryRates(n), couponLegNpv(n, 0.0), defaultLegNpv(n, 0.0);
+    for (Size s = 0; s < n; ++s)
+        recoveryRates[s] = recoveryRates_[s]->value();
+
+    Date refDate = defaultCurves_[mainResultState_]->referenceDate();
+    Date settlementDate = discountCurve_->referenceDate();
+
+    Real upfrontNpv = 0.0, accrualRebateNpv = 0.0;
+    if (!arguments_.upfrontPayment->hasOccurred(settlementDate, includeSettlementDateFlows_))
+        upfrontNpv = discountCurve_->discount(arguments_.upfrontPayment->date()) * arguments_.upfrontPayment->amount();
+    if (arguments_.accrualRebate && arguments_.accrualRebate->amount() != 0.0 &&
+        !arguments_.accrualRebate->hasOccurred(settlementDate, includeSettlementDateFlows_))
+        accrualRebateNpv =
+            discountCurve_->discount(arguments_.accrualRebate->date()) * arguments_.accrualRebate->amount();
+
+    bool paysAtDefaultTime = arguments_.protectionPaymentTime == CreditDefaultSwap::ProtectionPaymentTime::atDefault;
+
+    for (Size i = 0; i < arguments_.leg.size(); ++i) {
+        if (arguments_.leg[i]->hasOccurred(settlementDate, includeSettlementDateFlows_))
+            continue;
+        auto coupon = QuantLib::ext::dynamic_pointer_cast<FixedRateCoupon>(arguments_.leg[i]);
+        QL_REQUIRE(coupon, "MidPointCdsEngineMultiState: expected fixed rate coupon");
+
+        // state independent quantities
+
+        Date paymentDate = coupon->date(), startDate = i == 0 ? arguments_.protectionStart : coupon->accrualStartDate(),
+             endDate = coupon->accrualEndDate();
+        Date effectiveStartDate = (startDate <= refDate && refDate <= endDate) ? refDate : startDate;
+        Date defaultDate = effectiveStartDate + (endDate - effectiveStartDate) / 2;
+
+        Date protectionPaymentDate;
+        if (arguments_.protectionPaymentTime == CreditDefaultSwap::ProtectionPaymentTime::atDefault) {
+            protectionPaymentDate = defaultDate;
+        } else if (arguments_.protectionPaymentTime == CreditDefaultSwap::ProtectionPaymentTime::atPeriodEnd) {
+            protectionPaymentDate = paymentDate;
+        } else if (arguments_.protectionPaymentTime == CreditDefaultSwap::ProtectionPaymentTime::atMaturity) {
+            protectionPaymentDate = arguments_.maturity;
+        } else {
+            QL_FAIL("MidPointCdsEngineMultiState: protectionPaymentTime not handled");
+        }
+
+        Real couponAmount = coupon->amount();
+        DiscountFactor paymentDiscount = discountCurve_->discount(paymentDate);
+        DiscountFactor protectionDiscount = discountCurve_->discount(protectionPaymentDate);
+        Real accrualAmount = 0.0;
+        DiscountFactor accrualDiscount = 0.0;
+        if (arguments_.settlesAccrual) {
+            accrualAmount = paysAtDefaultTime ? coupon->accruedAmount(defaultDate) : couponAmount;
+            accrualDiscount = paysAtDefaultTime ? discountCurve_->discount(defaultDate) : paymentDiscount;
+        }
+
+        // state dependent quantities
+
+        for (Size s = 0; s < n; ++s) {
+            Probability S = defaultCurves_[s]->survivalProbability(paymentDate);
+            Probability P = defaultCurves_[s]->defaultProbability(effectiveStartDate, endDate);
+            couponLegNpv[s] += S * couponAmount * paymentDiscount + P * accrualAmount * accrualDiscount;
+            defaultLegNpv[s] += arguments_.claim->amount(defaultDate, arguments_.notional, recoveryRates[s]) * P *
+                                protectionDiscount;
+        }
+    }
+
+    std::vector<Real> values(n);
+    for (Size s = 0; s < n; ++s) {
+        if (arguments_.side == Protection::Seller)
+            values[s] = couponLegNpv[s] - defaultLegNpv[s] + upfrontNpv - accrualRebateNpv;
+        else
+            values[s] = defaultLegNpv[s] - couponLegNpv[s] - upfrontNpv + accrualRebateNpv;
+    }
+    return values;
+}
+
 Real MidPointCdsEngineMultiState::calculateDefaultValue() const {
     Date defaultDate = discountCurve_->referenceDate();
     Real phi = arguments_.side == Protection::Seller ? -1.0 : 1.0;
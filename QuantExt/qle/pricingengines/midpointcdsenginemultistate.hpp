@@ -47,6 +47,8 @@ public:
 
 private:
     void linkCurves(Size i) const;
+    // npv for each state, computed in one pass sharing the state independent quantities
+    std::vector<Real> calculateStateValues() const;
     Real calculateDefaultValue() const;
 
     std::vector<Handle<DefaultProbabilityTermStructure>> defaultCurves_;
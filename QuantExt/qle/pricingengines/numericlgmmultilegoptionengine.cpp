@@ -336,7 +336,7 @@ bool NumericLgmMultiLegOptionEngineBase::instrumentIsHandled(
     return isHandled;
 }
 
-void NumericLgmMultiLegOptionEngineBase::calculate() const {
+bool NumericLgmMultiLegOptionEngineBase::initRollbackState(RollbackState& s) const {
 
     std::vector<std::string> messages;
     QL_REQUIRE(
@@ -353,39 +353,37 @@ void NumericLgmMultiLegOptionEngineBase::calculate() const {
             }
         }
         underlyingNpv_ = npv_;
-        return;
+        return false;
     }
 
     // we have a non-empty exercise
 
-    auto rebatedExercise = QuantLib::ext::dynamic_pointer_cast<QuantExt::RebatedExercise>(exercise_);
+    s.rebatedExercise = QuantLib::ext::dynamic_pointer_cast<QuantExt::RebatedExercise>(exercise_);
     auto const& ts = solver_->model()->parametrization()->termStructure();
     Date refDate = ts->referenceDate();
 
     /* Build the cashflow info */
 
-    enum class CashflowStatus { Open, Cached, Done };
-
-    std::vector<CashflowInfo> cashflows;
-    std::vector<CashflowStatus> cashflowStatus;
+    s.cashflows.clear();
+    s.cashflowStatus.clear();
 
     for (Size i = 0; i < legs_.size(); ++i) {
         for (Size j = 0; j < legs_[i].size(); ++j) {
-            cashflows.push_back(buildCashflowInfo(i, j));
-            cashflowStatus.push_back(CashflowStatus::Open);
+            s.cashflows.push_back(buildCashflowInfo(i, j));
+            s.cashflowStatus.push_back(CashflowStatus::Open);
         }
     }
 
     /* Build the time grid containing the option times */
 
-    std::set<Real> optionTimes;
-    std::map<Real, Date> optionDates;
+    s.optionTimes.clear();
+    s.optionDates.clear();
 
     if (exercise_->type() == Exercise::Bermudan || exercise_->type() == Exercise::European) {
         for (auto const& d : exercise_->dates()) {
             if (d > refDate) {
-                optionTimes.insert(ts->timeFromReference(d));
-                optionDates[ts->timeFromReference(d)] = d;
+                s.optionTimes.insert(ts->timeFromReference(d));
+                s.optionDates[ts->timeFromReference(d)] = d;
             }
         }
     } else if (exercise_->type() == Exercise::American) {
@@ -396,9 +394,9 @@ void NumericLgmMultiLegOptionEngineBase::calculate() const {
         Real t2 = std::max(t1, ts->timeFromReference(exercise_->dates().back()));
         Size steps =
             std::max<Size>(1, static_cast<Size>((t2 - t1) * static_cast<Real>(americanExerciseTimeStepsPerYear_)));
-        optionTimes.insert(t1);
+        s.optionTimes.insert(t1);
         for (Size i = 0; i <= steps; ++i) {
-            optionTimes.insert(t1 + static_cast<Real>(i) * (t2 - t1) / static_cast<Real>(steps));
+            s.optionTimes.insert(t1 + static_cast<Real>(i) * (t2 - t1) / static_cast<Real>(steps));
         }
     } else {
         QL_FAIL("NumericLgmMultiLegOptionEngineBase::calculate(): internal error: exercise type "
@@ -409,114 +407,140 @@ void NumericLgmMultiLegOptionEngineBase::calculate() const {
 
     std::set<Real> requiredCfSimTimes;
 
-    for (auto const& c : cashflows) {
+    for (auto const& c : s.cashflows) {
         if (Real t = c.requiredSimulationTime(); t != Null<Real>())
             requiredCfSimTimes.insert(t);
     }
 
     /* Join the two grids to get the time grid which we use for the backward run */
 
-    std::set<Real> timeGrid{0.0};
-    timeGrid.insert(optionTimes.begin(), optionTimes.end());
-    timeGrid.insert(requiredCfSimTimes.begin(), requiredCfSimTimes.end());
-
-    /* Step backwards through the grid and compute the option npv */
-
-    LgmVectorised lgm(solver_->model()->parametrization());
+    s.timeGrid = {0.0};
+    s.timeGrid.insert(s.optionTimes.begin(), s.optionTimes.end());
+    s.timeGrid.insert(requiredCfSimTimes.begin(), requiredCfSimTimes.end());
 
-    RandomVariable underlyingNpv(solver_->gridSize(), 0.0);
-    RandomVariable optionNpv(solver_->gridSize(), 0.0);
-    RandomVariable provisionalNpv(solver_->gridSize(), 0.0);
+    /* Initialise the values */
 
-    std::vector<RandomVariable> cache(cashflows.size());
+    s.underlyingNpv = RandomVariable(solver_->gridSize(), 0.0);
+    s.optionNpv = RandomVariable(solver_->gridSize(), 0.0);
+    s.provisionalNpv = RandomVariable(solver_->gridSize(), 0.0);
+    s.cache = std::vector<RandomVariable>(s.cashflows.size());
 
-    for (auto it = timeGrid.rbegin(); it != timeGrid.rend(); ++it) {
+    return true;
+}
 
-        Real t_from = *it;
-        Real t_to = (it != std::next(timeGrid.rend(), -1)) ? *std::next(it, 1) : t_from;
+void NumericLgmMultiLegOptionEngineBase::processTime(RollbackState& s, const LgmVectorised& lgm, const Real t_from,
+                                                     const RandomVariable& state) const {
 
-        RandomVariable state = solver_->stateGrid(t_from);
+    // update cashflows on current time
 
-        // update cashflows on current time
+    s.provisionalNpv = RandomVariable(solver_->gridSize(), 0.0);
 
-        provisionalNpv = RandomVariable(solver_->gridSize(), 0.0);
-
-        for (Size i = 0; i < cashflows.size(); ++i) {
-            if (cashflowStatus[i] == CashflowStatus::Done)
-                continue;
-            if (cashflows[i].isPartOfUnderlying(t_from)) {
-                RandomVariable cpnRatio(solver_->gridSize(), cashflows[i].couponRatio(t_from));
-                bool isBrokenCoupon = !QuantLib::close_enough(cpnRatio.at(0), 1.0);
-                if (cashflowStatus[i] == CashflowStatus::Cached) {
-                    if (isBrokenCoupon) {
-                        provisionalNpv += cache[i] * cpnRatio;
-                    } else {
-                        underlyingNpv += cache[i];
-                        cache[i].clear();
-                        cashflowStatus[i] = CashflowStatus::Done;
-                    }
-                } else if (cashflows[i].canBeEstimated(t_from)) {
-                    if (isBrokenCoupon) {
-                        cache[i] = cashflows[i].pv(lgm, t_from, state, discountCurve_);
-                        cashflowStatus[i] = CashflowStatus::Cached;
-                        provisionalNpv += cache[i] * cpnRatio;
-                    } else {
-                        underlyingNpv += cashflows[i].pv(lgm, t_from, state, discountCurve_);
-                        cashflowStatus[i] = CashflowStatus::Done;
-                    }
+    for (Size i = 0; i < s.cashflows.size(); ++i) {
+        if (s.cashflowStatus[i] == CashflowStatus::Done)
+            continue;
+        if (s.cashflows[i].isPartOfUnderlying(t_from)) {
+            RandomVariable cpnRatio(solver_->gridSize(), s.cashflows[i].couponRatio(t_from));
+            bool isBrokenCoupon = !QuantLib::close_enough(cpnRatio.at(0), 1.0);
+            if (s.cashflowStatus[i] == CashflowStatus::Cached) {
+                if (isBrokenCoupon) {
+                    s.provisionalNpv += s.cache[i] * cpnRatio;
+                } else {
+                    s.underlyingNpv += s.cache[i];
+                    s.cache[i].clear();
+                    s.cashflowStatus[i] = CashflowStatus::Done;
+                }
+            } else if (s.cashflows[i].canBeEstimated(t_from)) {
+                if (isBrokenCoupon) {
+                    s.cache[i] = s.cashflows[i].pv(lgm, t_from, state, discountCurve_);
+                    s.cashflowStatus[i] = CashflowStatus::Cached;
+                    s.provisionalNpv += s.cache[i] * cpnRatio;
                 } else {
-                    provisionalNpv += cashflows[i].pv(lgm, t_from, state, discountCurve_) * cpnRatio;
+                    s.underlyingNpv += s.cashflows[i].pv(lgm, t_from, state, discountCurve_);
+                    s.cashflowStatus[i] = CashflowStatus::Done;
                 }
-            } else if (cashflows[i].mustBeEstimated(t_from) && cashflowStatus[i] == CashflowStatus::Open) {
-                cache[i] = cashflows[i].pv(lgm, t_from, state, discountCurve_);
-                cashflowStatus[i] = CashflowStatus::Cached;
+            } else {
+                s.provisionalNpv += s.cashflows[i].pv(lgm, t_from, state, discountCurve_) * cpnRatio;
             }
+        } else if (s.cashflows[i].mustBeEstimated(t_from) && s.cashflowStatus[i] == CashflowStatus::Open) {
+            s.cache[i] = s.cashflows[i].pv(lgm, t_from, state, discountCurve_);
+            s.cashflowStatus[i] = CashflowStatus::Cached;
         }
+    }
 
-        // process optionality
-
-        if (optionTimes.find(t_from) != optionTimes.end()) {
-            auto rebateNpv =
-                getRebatePv(lgm, t_from, state, discountCurve_, rebatedExercise,
-                            exercise_->type() == Exercise::American ? Null<Date>() : optionDates.at(t_from));
-            optionNpv = max(optionNpv, underlyingNpv + provisionalNpv + rebateNpv);
-        }
-
-        // roll back
+    // process optionality
 
-        if (t_from != t_to) {
-            underlyingNpv = solver_->rollback(underlyingNpv, t_from, t_to);
-            optionNpv = solver_->rollback(optionNpv, t_from, t_to);
-            for (auto& c : cache) {
-                if (!c.initialised())
-                    continue;
-                c = solver_->rollback(c, t_from, t_to);
-            }
-            // need to roll back provisionalNpv only for the last step t_1 -> t_0 = 0
-            if (it == std::next(timeGrid.rend(), -1))
-                provisionalNpv = solver_->rollback(provisionalNpv, t_from, t_to);
-        }
+    if (s.optionTimes.find(t_from) != s.optionTimes.end()) {
+        auto rebateNpv =
+            getRebatePv(lgm, t_from, state, discountCurve_, s.rebatedExercise,
+                        exercise_->type() == Exercise::American ? Null<Date>() : s.optionDates.at(t_from));
+        s.optionNpv = max(s.optionNpv, s.underlyingNpv + s.provisionalNpv + rebateNpv);
     }
+}
 
-    /* Set the results */
+void NumericLgmMultiLegOptionEngineBase::collectRollbackValues(RollbackState& s, const Real t_to,
+                                                               std::vector<RandomVariable*>& values) const {
+    values.push_back(&s.underlyingNpv);
+    values.push_back(&s.optionNpv);
+    for (auto& c : s.cache) {
+        if (c.initialised())
+            values.push_back(&c);
+    }
+    // need to roll back provisionalNpv only after the smallest positive time of the grid was processed
+    if (s.timeGrid.size() > 1 && t_to < *std::next(s.timeGrid.begin(), 1))
+        values.push_back(&s.provisionalNpv);
+}
 
-    npv_ = optionNpv.at(0);
-    underlyingNpv_ = underlyingNpv.at(0);
-    for (auto const& c : cache) {
+void NumericLgmMultiLegOptionEngineBase::setResults(const RollbackState& s) const {
+    npv_ = s.optionNpv.at(0);
+    underlyingNpv_ = s.underlyingNpv.at(0);
+    for (auto const& c : s.cache) {
         if (c.initialised())
             underlyingNpv_ += c.at(0);
     }
-    underlyingNpv_ += provisionalNpv.at(0);
+    underlyingNpv_ += s.provisionalNpv.at(0);
 
     additionalResults_ = getAdditionalResultsMap(solver_->model()->getCalibrationInfo());
 
-    if (rebatedExercise) {
-        for (Size i = 0; i < rebatedExercise->dates().size(); ++i) {
+    if (s.rebatedExercise) {
+        for (Size i = 0; i < s.rebatedExercise->dates().size(); ++i) {
             std::ostringstream d;
-            d << QuantLib::io::iso_date(rebatedExercise->dates()[i]);
-            additionalResults_["exerciseFee_" + d.str()] = -rebatedExercise->rebate(i);
+            d << QuantLib::io::iso_date(s.rebatedExercise->dates()[i]);
+            additionalResults_["exerciseFee_" + d.str()] = -s.rebatedExercise->rebate(i);
         }
     }
+}
+
+void NumericLgmMultiLegOptionEngineBase::calculate() const {
+
+    RollbackState s;
+    if (!initRollbackState(s))
+        return;
+
+    /* Step backwards through the grid and compute the option npv */
+
+    LgmVectorised lgm(solver_->model()->parametrization());
+    std::vector<RandomVariable*> values;
+
+    for (auto it = s.timeGrid.rbegin(); it != s.timeGrid.rend(); ++it) {
+
+        Real t_from = *it;
+        Real t_to = (it != std::next(s.timeGrid.rend(), -1)) ? *std::next(it, 1) : t_from;
+
+        processTime(s, lgm, t_from, solver_->stateGrid(t_from));
+
+        // roll back
+
+        if (t_from != t_to) {
+            values.clear();
+            collectRollbackValues(s, t_to, values);
+            for (auto v : values)
+                *v = solver_->rollback(*v, t_from, t_to);
+        }
+    }
+
+    /* Set the results */
+
+    setResults(s);
 
 } // NumericLgmMultiLegOptionEngineBase::calculate()
 
@@ -544,6 +568,14 @@ NumericLgmMultiLegOptionEngine::NumericLgmMultiLegOptionEngine(const QuantLib::e
     registerWith(discountCurve_);
 }
 
+NumericLgmMultiLegOptionEngine::NumericLgmMultiLegOptionEngine(const QuantLib::ext::shared_ptr<LgmBackwardSolver>& solver,
+                                                               const Handle<YieldTermStructure>& discountCurve,
+                                                               const Size americanExerciseTimeStepsPerYear)
+    : NumericLgmMultiLegOptionEngineBase(solver, discountCurve, americanExerciseTimeStepsPerYear) {
+    registerWith(solver_->model());
+    registerWith(discountCurve_);
+}
+
 void NumericLgmMultiLegOptionEngine::calculate() const {
     legs_ = arguments_.legs;
     payer_ = arguments_.payer;
@@ -583,6 +615,14 @@ NumericLgmSwaptionEngine::NumericLgmSwaptionEngine(const QuantLib::ext::shared_p
     registerWith(discountCurve_);
 }
 
+NumericLgmSwaptionEngine::NumericLgmSwaptionEngine(const QuantLib::ext::shared_ptr<LgmBackwardSolver>& solver,
+                                                   const Handle<YieldTermStructure>& discountCurve,
+                                                   const Size americanExerciseTimeStepsPerYear)
+    : NumericLgmMultiLegOptionEngineBase(solver, discountCurve, americanExerciseTimeStepsPerYear) {
+    registerWith(solver_->model());
+    registerWith(discountCurve_);
+}
+
 void NumericLgmSwaptionEngine::calculate() const {
     legs_ = arguments_.legs;
     payer_.resize(arguments_.payer.size());
@@ -621,6 +661,14 @@ NumericLgmNonstandardSwaptionEngine::NumericLgmNonstandardSwaptionEngine(
     registerWith(discountCurve_);
 }
 
+NumericLgmNonstandardSwaptionEngine::NumericLgmNonstandardSwaptionEngine(
+    const QuantLib::ext::shared_ptr<LgmBackwardSolver>& solver, const Handle<YieldTermStructure>& discountCurve,
+    const Size americanExerciseTimeStepsPerYear)
+    : NumericLgmMultiLegOptionEngineBase(solver, discountCurve, americanExerciseTimeStepsPerYear) {
+    registerWith(solver_->model());
+    registerWith(discountCurve_);
+}
+
 void NumericLgmNonstandardSwaptionEngine::calculate() const {
     legs_ = arguments_.legs;
     payer_.resize(arguments_.payer.size());
@@ -639,4 +687,83 @@ void NumericLgmNonstandardSwaptionEngine::calculate() const {
     results_.additionalResults["underlyingNpv"] = underlyingNpv_;
 } // NumericLgmSwaptionEngine::calculate
 
+NumericLgmMultiLegOptionBatchEngine::NumericLgmMultiLegOptionBatchEngine(
+    const QuantLib::ext::shared_ptr<LgmBackwardSolver>& solver, const Handle<YieldTermStructure>& discountCurve,
+    const Size americanExerciseTimeStepsPerYear)
+    : solver_(solver), discountCurve_(discountCurve),
+      americanExerciseTimeStepsPerYear_(americanExerciseTimeStepsPerYear) {}
+
+void NumericLgmMultiLegOptionBatchEngine::calculate(
+    const std::vector<QuantLib::ext::shared_ptr<MultiLegOption>>& options) const {
+
+    /* Set up one single instrument engine and backward induction state per option */
+
+    std::vector<NumericLgmMultiLegOptionEngineBase> engines(
+        options.size(),
+        NumericLgmMultiLegOptionEngineBase(solver_, discountCurve_, americanExerciseTimeStepsPerYear_));
+    std::vector<NumericLgmMultiLegOptionEngineBase::RollbackState> states(options.size());
+    std::vector<bool> active(options.size(), false);
+
+    std::set<Real> timeGrid{0.0};
+    for (Size i = 0; i < options.size(); ++i) {
+        QL_REQUIRE(options[i], "NumericLgmMultiLegOptionBatchEngine::calculate(): option #" << i << " is null");
+        auto& e = engines[i];
+        e.legs_ = options[i]->legs();
+        e.payer_ = options[i]->payer();
+        e.currency_ = options[i]->currency();
+        e.exercise_ = options[i]->exercise();
+        e.settlementType_ = options[i]->settlementType();
+        e.settlementMethod_ = options[i]->settlementMethod();
+        active[i] = e.initRollbackState(states[i]);
+        if (active[i])
+            timeGrid.insert(states[i].timeGrid.begin(), states[i].timeGrid.end());
+    }
+
+    /* Step backwards through the joint grid, rolling back the values of all options together */
+
+    LgmVectorised lgm(solver_->model()->parametrization());
+    std::vector<RandomVariable*> values;
+    std::vector<RandomVariable> rollbackValues;
+
+    for (auto it = timeGrid.rbegin(); it != timeGrid.rend(); ++it) {
+
+        Real t_from = *it;
+        Real t_to = (it != std::next(timeGrid.rend(), -1)) ? *std::next(it, 1) : t_from;
+
+        RandomVariable state = solver_->stateGrid(t_from);
+
+        values.clear();
+        for (Size i = 0; i < options.size(); ++i) {
+            if (!active[i])
+                continue;
+            if (states[i].timeGrid.find(t_from) != states[i].timeGrid.end())
+                engines[i].processTime(states[i], lgm, t_from, state);
+            if (t_from != t_to)
+                engines[i].collectRollbackValues(states[i], t_to, values);
+        }
+
+        // roll back
+
+        if (t_from != t_to) {
+            rollbackValues.resize(values.size());
+            for (Size j = 0; j < values.size(); ++j)
+                rollbackValues[j] = std::move(*values[j]);
+            rollbackValues = solver_->rollbackBatch(rollbackValues, t_from, t_to);
+            for (Size j = 0; j < values.size(); ++j)
+                *values[j] = std::move(rollbackValues[j]);
+        }
+    }
+
+    /* Set the results */
+
+    npvs_.resize(options.size());
+    underlyingNpvs_.resize(options.size());
+    for (Size i = 0; i < options.size(); ++i) {
+        if (active[i])
+            engines[i].setResults(states[i]);
+        npvs_[i] = engines[i].npv_;
+        underlyingNpvs_[i] = engines[i].underlyingNpv_;
+    }
+}
+
 } // namespace QuantExt
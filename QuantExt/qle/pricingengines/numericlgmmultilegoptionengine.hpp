@@ -27,8 +27,13 @@
 #include <ql/methods/finitedifferences/solvers/fdmbackwardsolver.hpp>
 #include <ql/pricingengines/genericmodelengine.hpp>
 
+#include <map>
+#include <set>
+
 namespace QuantExt {
 
+class RebatedExercise;
+
 class NumericLgmMultiLegOptionEngineBase {
 public:
     NumericLgmMultiLegOptionEngineBase(const QuantLib::ext::shared_ptr<LgmBackwardSolver>& solver,
@@ -63,6 +68,28 @@ protected:
 
     CashflowInfo buildCashflowInfo(const Size i, const Size j) const;
 
+    // the state of the backward induction for one instrument
+    enum class CashflowStatus { Open, Cached, Done };
+    struct RollbackState {
+        std::vector<CashflowInfo> cashflows;
+        std::vector<CashflowStatus> cashflowStatus;
+        std::set<Real> optionTimes;
+        std::map<Real, Date> optionDates;
+        std::set<Real> timeGrid;
+        QuantLib::ext::shared_ptr<RebatedExercise> rebatedExercise;
+        RandomVariable underlyingNpv, optionNpv, provisionalNpv;
+        std::vector<RandomVariable> cache;
+    };
+
+    // returns false if there is no exercise, in this case the results are set directly
+    bool initRollbackState(RollbackState& s) const;
+    // update the cashflows and process the optionality at a time t_from of the state's time grid
+    void processTime(RollbackState& s, const LgmVectorised& lgm, const Real t_from, const RandomVariable& state) const;
+    // add the values which have to be rolled back to t_to after the last processed time
+    void collectRollbackValues(RollbackState& s, const Real t_to, std::vector<RandomVariable*>& values) const;
+    // set the results from the state rolled back to t = 0
+    void setResults(const RollbackState& s) const;
+
     void calculate() const;
 
     // inputs set in ctor
@@ -81,6 +108,8 @@ protected:
     // outputs
     mutable Real npv_, underlyingNpv_;
     mutable std::map<std::string, boost::any> additionalResults_;
+
+    friend class NumericLgmMultiLegOptionBatchEngine;
 };
 
 class NumericLgmMultiLegOptionEngine
@@ -99,6 +128,10 @@ public:
                                    const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
                                    const Size americanExerciseTimeStepsPerYear = 24);
 
+    NumericLgmMultiLegOptionEngine(const QuantLib::ext::shared_ptr<LgmBackwardSolver>& solver,
+                                   const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
+                                   const Size americanExerciseTimeStepsPerYear = 24);
+
     void calculate() const override;
 };
 
@@ -117,6 +150,10 @@ public:
                              const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
                              const Size americanExerciseTimeStepsPerYear = 24);
 
+    NumericLgmSwaptionEngine(const QuantLib::ext::shared_ptr<LgmBackwardSolver>& solver,
+                             const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
+                             const Size americanExerciseTimeStepsPerYear = 24);
+
     void calculate() const override;
 };
 
@@ -137,7 +174,38 @@ public:
                                         const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
                                         const Size americanExerciseTimeStepsPerYear = 24);
 
+    NumericLgmNonstandardSwaptionEngine(const QuantLib::ext::shared_ptr<LgmBackwardSolver>& solver,
+                                        const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
+                                        const Size americanExerciseTimeStepsPerYear = 24);
+
     void calculate() const override;
 };
 
+//! Batched backward induction for several multileg options on the same LGM solver
+/*! The options share the state grid and the rollback operators of the solver. In each step of the backward induction
+    the values of all options are rolled back together using LgmBackwardSolver::rollbackBatch(), which allows the
+    solver to reuse its convolution weights or transformed kernel for all options. The time grid is the union of the
+    time grids of the single options, each option processes its cashflows and exercise decisions on its own times
+    only. */
+class NumericLgmMultiLegOptionBatchEngine {
+public:
+    NumericLgmMultiLegOptionBatchEngine(const QuantLib::ext::shared_ptr<LgmBackwardSolver>& solver,
+                                        const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>(),
+                                        const Size americanExerciseTimeStepsPerYear = 24);
+
+    //! compute the npvs of the given options
+    void calculate(const std::vector<QuantLib::ext::shared_ptr<MultiLegOption>>& options) const;
+
+    //! results of the last calculation, in the order of the options
+    const std::vector<Real>& npvs() const { return npvs_; }
+    const std::vector<Real>& underlyingNpvs() const { return underlyingNpvs_; }
+
+private:
+    QuantLib::ext::shared_ptr<LgmBackwardSolver> solver_;
+    Handle<YieldTermStructure> discountCurve_;
+    Size americanExerciseTimeStepsPerYear_;
+
+    mutable std::vector<Real> npvs_, underlyingNpvs_;
+};
+
 } // namespace QuantExt
@@ -85,11 +85,18 @@ void CrossAssetStateProcess::resetCache(const Size timeSteps) const {
     timeStepCache_m_ = timeStepCache_d_ = 0;
     cache_m_.clear();
     cache_d_.clear();
+    keyedCache_d_.clear();
     if (auto tmp = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess::ExactDiscretization>(discretization_))
         tmp->resetCache(timeSteps);
     updateSqrtCorrelation();
 }
 
+void CrossAssetStateProcess::enableKeyedCache(const bool b) {
+    keyedCacheEnabled_ = b;
+    if (auto tmp = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess::ExactDiscretization>(discretization_))
+        tmp->enableKeyedCache(b);
+}
+
 void CrossAssetStateProcess::updateSqrtCorrelation() const {
     if (model_->discretization() != CrossAssetModel::Discretization::Euler)
         return;
@@ -343,6 +350,10 @@ Matrix CrossAssetStateProcess::diffusion(Time t, const Array& x) const {
 
 Matrix CrossAssetStateProcess::diffusionOnCorrelatedBrownians(Time t, const Array& x) const {
     if (cacheNotReady_d_) {
+        // the diffusion does not depend on x, see diffusionOnCorrelatedBrowniansImpl()
+        if (timeStepsToCache_d_ == 0 && keyedCacheEnabled_)
+            return keyedCache_d_.value(timeKey(t),
+                                       [this, t, &x]() { return diffusionOnCorrelatedBrowniansImpl(t, x); });
         Matrix tmp = diffusionOnCorrelatedBrowniansImpl(t, x);
         if (timeStepsToCache_d_ > 0) {
             cache_d_.push_back(tmp);
@@ -607,6 +618,10 @@ Array CrossAssetStateProcess::ExactDiscretization::drift(const StochasticProcess
 Matrix CrossAssetStateProcess::ExactDiscretization::diffusion(const StochasticProcess& p, Time t0, const Array& x0,
                                                               Time dt) const {
     if (cacheNotReady_d_) {
+        if (timeStepsToCache_d_ == 0 && keyedCacheEnabled_)
+            return keyedCache_d_.value(std::make_pair(timeKey(t0), timeKey(dt)), [this, &p, t0, &x0, dt]() {
+                return pseudoSqrt(covariance(p, t0, x0, dt), salvaging_);
+            });
         Matrix res = pseudoSqrt(covariance(p, t0, x0, dt), salvaging_);
         // note that covariance actually does not depend on x0
         if (timeStepsToCache_d_ > 0) {
@@ -626,6 +641,9 @@ Matrix CrossAssetStateProcess::ExactDiscretization::diffusion(const StochasticPr
 Matrix CrossAssetStateProcess::ExactDiscretization::covariance(const StochasticProcess& p, Time t0, const Array& x0,
                                                                Time dt) const {
     if (cacheNotReady_v_) {
+        if (timeStepsToCache_v_ == 0 && keyedCacheEnabled_)
+            return keyedCache_v_.value(std::make_pair(timeKey(t0), timeKey(dt)),
+                                       [this, &p, t0, &x0, dt]() { return covarianceImpl(p, t0, x0, dt); });
         Matrix res = covarianceImpl(p, t0, x0, dt);
         if (timeStepsToCache_v_ > 0) {
             cache_v_.push_back(res);
@@ -986,6 +1004,8 @@ void CrossAssetStateProcess::ExactDiscretization::resetCache(const Size timeStep
     cache_m_.clear();
     cache_v_.clear();
     cache_d_.clear();
+    keyedCache_v_.clear();
+    keyedCache_d_.clear();
 }
 
 } // namespace QuantExt
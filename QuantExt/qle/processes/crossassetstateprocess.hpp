@@ -28,8 +28,12 @@
 #include <ql/math/matrixutilities/pseudosqrt.hpp>
 #include <ql/stochasticprocess.hpp>
 
+#include <boost/thread/shared_mutex.hpp>
 #include <boost/unordered_map.hpp>
 
+#include <cmath>
+#include <cstdint>
+
 namespace QuantExt {
 using namespace QuantLib;
 
@@ -51,10 +55,33 @@ public:
     Matrix diffusion(Time t, const Array& x) const override;
     Array evolve(Time t0, const Array& x0, Time dt, const Array& dw) const override;
 
-    // enables and resets the cache, once enabled the simulated times must stay the stame
+    /* enables and resets the cache, once enabled the simulated times must stay the stame; with timeSteps = 0 and
+       the keyed cache enabled, the time dependent matrices are cached by time instead, this cache is reset here,
+       i.e. on each model update */
     void resetCache(const Size timeSteps) const;
 
+    /* enables the keyed cache, which is used while no time steps are cached and holds the time dependent matrices by
+       their (quantised) times; it is shared by all path generators using this process, which may run concurrently,
+       and disabled by default */
+    void enableKeyedCache(const bool b);
+
 protected:
+    //! times are quantised to this resolution to build the keys of the keyed caches
+    static constexpr Real keyedCacheTimeResolution = 1.0E-10;
+    static std::int64_t timeKey(const Time t) { return std::llround(t / keyedCacheTimeResolution); }
+
+    //! matrices by key, guarded by a shared mutex, the cache is cleared when it holds maxSize entries
+    template <class K> class KeyedMatrixCache {
+    public:
+        static constexpr Size maxSize = 10000;
+        template <class F> Matrix value(const K& key, const F& f);
+        void clear();
+
+    private:
+        boost::unordered_map<K, Matrix> cache_;
+        boost::shared_mutex mutex_;
+    };
+
     virtual Matrix diffusionOnCorrelatedBrownians(Time t, const Array& x) const;
     virtual Matrix diffusionOnCorrelatedBrowniansImpl(Time t, const Array& x) const;
     void updateSqrtCorrelation() const;
@@ -74,6 +101,7 @@ protected:
         virtual Matrix diffusion(const StochasticProcess&, Time t0, const Array& x0, Time dt) const override;
         virtual Matrix covariance(const StochasticProcess&, Time t0, const Array& x0, Time dt) const override;
         void resetCache(const Size timeSteps) const;
+        void enableKeyedCache(const bool b) { keyedCacheEnabled_ = b; }
 
     protected:
         virtual Array driftImpl1(const StochasticProcess&, Time t0, const Array& x0, Time dt) const;
@@ -94,6 +122,11 @@ protected:
         mutable Size timeStepCache_v_ = 0;
         mutable std::vector<Array> cache_m_;
         mutable std::vector<Matrix> cache_v_, cache_d_;
+        /* covariance and diffusion by the quantised (t0, dt), used while no time steps are cached, the matrices only
+           depend on the model parameters and correlations, so the cache is cleared by resetCache(), which the model
+           calls on each update */
+        bool keyedCacheEnabled_ = false;
+        mutable KeyedMatrixCache<std::pair<std::int64_t, std::int64_t>> keyedCache_v_, keyedCache_d_;
     }; // ExactDiscretization
 
     mutable bool cacheNotReady_m_ = true;
@@ -104,8 +137,35 @@ protected:
     mutable Size timeStepCache_d_ = 0;
     mutable std::vector<Array> cache_m_;
     mutable std::vector<Matrix> cache_d_;
+    // diffusion on correlated brownians by the quantised t, used while no time steps are cached, see resetCache()
+    bool keyedCacheEnabled_ = false;
+    mutable KeyedMatrixCache<std::int64_t> keyedCache_d_;
 }; // CrossAssetStateProcess
 
+// inline
+
+template <class K>
+template <class F>
+Matrix CrossAssetStateProcess::KeyedMatrixCache<K>::value(const K& key, const F& f) {
+    {
+        boost::shared_lock<boost::shared_mutex> lock(mutex_);
+        if (auto c = cache_.find(key); c != cache_.end())
+            return c->second;
+    }
+    // computed outside the lock, a concurrent computation of the same matrix yields the same result
+    Matrix m = f();
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    if (cache_.size() >= maxSize)
+        cache_.clear();
+    cache_.emplace(key, m);
+    return m;
+}
+
+template <class K> void CrossAssetStateProcess::KeyedMatrixCache<K>::clear() {
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    cache_.clear();
+}
+
 } // namespace QuantExt
 
 #endif
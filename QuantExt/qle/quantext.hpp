@@ -7,6 +7,7 @@
 
 #include <qle/ad/backwardderivatives.hpp>
 #include <qle/ad/computationgraph.hpp>
+#include <qle/ad/evaluationprofile.hpp>
 #include <qle/ad/external_randomvariable_ops.hpp>
 #include <qle/ad/forwardderivatives.hpp>
 #include <qle/ad/forwardevaluation.hpp>
@@ -14,6 +15,7 @@
 #include <qle/calendars/amendedcalendar.hpp>
 #include <qle/calendars/austria.hpp>
 #include <qle/calendars/belgium.hpp>
+#include <qle/calendars/cachedcalendar.hpp>
 #include <qle/calendars/cme.hpp>
 #include <qle/calendars/colombia.hpp>
 #include <qle/calendars/cyprus.hpp>
@@ -220,6 +222,7 @@
 #include <qle/instruments/vanillaforwardoption.hpp>
 #include <qle/instruments/varianceswap.hpp>
 #include <qle/interpolators/optioninterpolator2d.hpp>
+#include <qle/math/alignedbufferpool.hpp>
 #include <qle/math/basiccpuenvironment.hpp>
 #include <qle/math/blockmatrixinverse.hpp>
 #include <qle/math/bucketeddistribution.hpp>
@@ -227,22 +230,28 @@
 #include <qle/math/computeenvironment.hpp>
 #include <qle/math/constantinterpolation.hpp>
 #include <qle/math/covariancesalvage.hpp>
+#include <qle/math/cudaenvironment.hpp>
 #include <qle/math/deltagammavar.hpp>
 #include <qle/math/differentialevolution_mt.hpp>
 #include <qle/math/discretedistribution.hpp>
 #include <qle/math/fillemptymatrix.hpp>
 #include <qle/math/flatextrapolation.hpp>
 #include <qle/math/flatextrapolation2d.hpp>
+#include <qle/math/floatrandomvariable.hpp>
 #include <qle/math/kendallrankcorrelation.hpp>
 #include <qle/math/logquadraticinterpolation.hpp>
 #include <qle/math/matrixfunctions.hpp>
 #include <qle/math/method_mt.hpp>
+#include <qle/math/multidevicecomputecontext.hpp>
 #include <qle/math/nadarayawatson.hpp>
 #include <qle/math/openclenvironment.hpp>
+#include <qle/math/p2quantileestimator.hpp>
 #include <qle/math/problem_mt.hpp>
 #include <qle/math/quadraticinterpolation.hpp>
 #include <qle/math/randomvariable.hpp>
+#include <qle/math/randomvariable_fused.hpp>
 #include <qle/math/randomvariable_io.hpp>
+#include <qle/math/randomvariable_jit.hpp>
 #include <qle/math/randomvariable_opcodes.hpp>
 #include <qle/math/randomvariable_ops.hpp>
 #include <qle/math/randomvariablelsmbasissystem.hpp>
@@ -328,11 +337,13 @@
 #include <qle/models/lgmcalibrationinfo.hpp>
 #include <qle/models/lgmconvolutionsolver2.hpp>
 #include <qle/models/lgmfdsolver.hpp>
+#include <qle/models/lgmfftsolver.hpp>
 #include <qle/models/lgmimplieddefaulttermstructure.hpp>
 #include <qle/models/lgmimpliedyieldtermstructure.hpp>
 #include <qle/models/lgmvectorised.hpp>
 #include <qle/models/linearannuitymapping.hpp>
 #include <qle/models/linkablecalibratedmodel.hpp>
+#include <qle/models/lossdistributioncache.hpp>
 #include <qle/models/marketobserver.hpp>
 #include <qle/models/modelbuilder.hpp>
 #include <qle/models/modelimpliedpricetermstructure.hpp>
@@ -585,6 +596,7 @@
 #include <qle/utilities/commodity.hpp>
 #include <qle/utilities/inflation.hpp>
 #include <qle/utilities/interpolation.hpp>
+#include <qle/utilities/memoryaccounting.hpp>
 #include <qle/utilities/savedobservablesettings.hpp>
 #include <qle/utilities/time.hpp>
 #include <qle/version.hpp>
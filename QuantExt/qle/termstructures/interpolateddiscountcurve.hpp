@@ -67,6 +67,20 @@ public:
     }
     //@}
 
+    //! \name Inspectors
+    //@{
+    const std::vector<Time>& times() const { return times_; }
+    Interpolation interpolation() const { return interpolation_; }
+    Extrapolation extrapolation() const { return extrapolation_; }
+    //! log discount factors at the pillar times
+    std::vector<Real> logDiscounts() const {
+        std::vector<Real> result(quotes_.size());
+        for (Size i = 0; i < quotes_.size(); ++i)
+            result[i] = quotes_[i]->value();
+        return result;
+    }
+    //@}
+
 private:
     void initalise(const std::vector<Handle<Quote>>& quotes) {
         QL_REQUIRE(times_.size() > 1, "at least two times required");
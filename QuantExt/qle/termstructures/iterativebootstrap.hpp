@@ -30,6 +30,8 @@
 #include <ql/termstructures/bootstraphelper.hpp>
 #include <ql/utilities/dataformatters.hpp>
 
+#include <map>
+
 namespace QuantExt {
 
 namespace detail {
@@ -91,17 +93,24 @@ public:
         \param minFactor      Factor for min value retry on each iteration if there is a failure.
         \param dontThrowSteps If \p dontThrow is \c true, this gives the number of steps to use when searching
                               for a fallback curve pillar value that gives the minimum bootstrap helper error.
+        \param initialGuess   Optional pillar values, in the representation of the curve's traits, e.g. from a
+                              previous bootstrap of the same curve. If given, the first bootstrap starts from these
+                              values, interpolated linearly in the pillar dates and extrapolated flat, instead of the
+                              traits' generic guess. If the guess turns out to be unusable, the bootstrap falls back
+                              to the generic guess as it does for an invalid previous curve state.
     */
     IterativeBootstrap(QuantLib::Real accuracy = QuantLib::Null<QuantLib::Real>(),
                        QuantLib::Real globalAccuracy = QuantLib::Null<QuantLib::Real>(), bool dontThrow = false,
                        QuantLib::Size maxAttempts = 1, QuantLib::Real maxFactor = 2.0, QuantLib::Real minFactor = 2.0,
-                       QuantLib::Size dontThrowSteps = 10);
+                       QuantLib::Size dontThrowSteps = 10,
+                       const std::map<QuantLib::Date, QuantLib::Real>& initialGuess = {});
 
     void setup(Curve* ts);
     void calculate() const;
 
 private:
     void initialize() const;
+    bool applyInitialGuess() const;
     Curve* ts_;
     QuantLib::Size n_;
     QuantLib::Brent firstSolver_;
@@ -117,15 +126,19 @@ private:
     QuantLib::Real maxFactor_;
     QuantLib::Real minFactor_;
     QuantLib::Size dontThrowSteps_;
+    std::map<QuantLib::Date, QuantLib::Real> initialGuess_;
+    mutable bool initialGuessUsed_;
 };
 
 template <class Curve>
 IterativeBootstrap<Curve>::IterativeBootstrap(QuantLib::Real accuracy, QuantLib::Real globalAccuracy, bool dontThrow,
                                               QuantLib::Size maxAttempts, QuantLib::Real maxFactor,
-                                              QuantLib::Real minFactor, QuantLib::Size dontThrowSteps)
+                                              QuantLib::Real minFactor, QuantLib::Size dontThrowSteps,
+                                              const std::map<QuantLib::Date, QuantLib::Real>& initialGuess)
     : ts_(0), n_(0), initialized_(false), validCurve_(false), loopRequired_(Interpolator::global),
       firstAliveHelper_(0), alive_(0), accuracy_(accuracy), globalAccuracy_(globalAccuracy), dontThrow_(dontThrow),
-      maxAttempts_(maxAttempts), maxFactor_(maxFactor), minFactor_(minFactor), dontThrowSteps_(dontThrowSteps) {}
+      maxAttempts_(maxAttempts), maxFactor_(maxFactor), minFactor_(minFactor), dontThrowSteps_(dontThrowSteps),
+      initialGuess_(initialGuess), initialGuessUsed_(false) {}
 
 template <class Curve> void IterativeBootstrap<Curve>::setup(Curve* ts) {
     ts_ = ts;
@@ -200,10 +213,43 @@ template <class Curve> void IterativeBootstrap<Curve>::initialize() const {
         // because, e.g., of interpolation's early checks
         ts_->data_ = std::vector<QuantLib::Real>(alive_ + 1, Traits::initialValue(ts_));
         previousData_.resize(alive_ + 1);
+        // the initial guess is only used once, if it fails we retry with the generic guess
+        if (!initialGuessUsed_ && !initialGuess_.empty()) {
+            initialGuessUsed_ = true;
+            validCurve_ = applyInitialGuess();
+        }
     }
     initialized_ = true;
 }
 
+template <class Curve> bool IterativeBootstrap<Curve>::applyInitialGuess() const {
+    std::vector<QuantLib::Real>& data = ts_->data_;
+    const std::vector<QuantLib::Date>& dates = ts_->dates_;
+    const std::vector<QuantLib::Time>& times = ts_->times_;
+    for (QuantLib::Size i = 1; i <= alive_; ++i) {
+        auto u = initialGuess_.lower_bound(dates[i]);
+        if (u == initialGuess_.end()) {
+            data[i] = std::prev(u)->second;
+        } else if (u->first == dates[i] || u == initialGuess_.begin()) {
+            data[i] = u->second;
+        } else {
+            auto l = std::prev(u);
+            QuantLib::Real w = static_cast<QuantLib::Real>(dates[i] - l->first) / (u->first - l->first);
+            data[i] = l->second + w * (u->second - l->second);
+        }
+    }
+    // the bootstrap does not extend the interpolation pillar by pillar when starting from a valid curve state, so we
+    // need the full interpolation here
+    try {
+        ts_->interpolation_ = ts_->interpolator_.interpolate(times.begin(), times.end(), data.begin());
+        ts_->interpolation_.update();
+    } catch (...) {
+        std::fill(data.begin(), data.end(), Traits::initialValue(ts_));
+        return false;
+    }
+    return true;
+}
+
 template <class Curve> void IterativeBootstrap<Curve>::calculate() const {
 
     // we might have to call initialize even if the curve is initialized
@@ -105,6 +105,18 @@ Real ParametricVolatility::convert(const Real inputQuote, const MarketQuoteType
     }
 }
 
+std::vector<Real> ParametricVolatility::evaluate(const Real timeToExpiry, const Real underlyingLength,
+                                                 const std::vector<Real>& strikes, const Real forward,
+                                                 const MarketQuoteType outputMarketQuoteType,
+                                                 const Real outputLognormalShift,
+                                                 const boost::optional<QuantLib::Option::Type> outputOptionType) const {
+    std::vector<Real> result(strikes.size());
+    for (std::size_t i = 0; i < strikes.size(); ++i)
+        result[i] = evaluate(timeToExpiry, underlyingLength, strikes[i], forward, outputMarketQuoteType,
+                             outputLognormalShift, outputOptionType);
+    return result;
+}
+
 bool operator<(const ParametricVolatility::MarketSmile& s, const ParametricVolatility::MarketSmile& t) {
     if (s.timeToExpiry < t.timeToExpiry)
         return true;
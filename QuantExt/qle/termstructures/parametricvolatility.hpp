@@ -73,6 +73,15 @@ public:
              const QuantLib::Real outputLognormalShift = QuantLib::Null<QuantLib::Real>(),
              const boost::optional<QuantLib::Option::Type> outputOptionType = boost::none) const = 0;
 
+    /* evaluate a smile for several strikes, the default implementation calls evaluate() for each strike, derived
+       classes can override this to share the work that only depends on the expiry and underlying length */
+    virtual std::vector<QuantLib::Real>
+    evaluate(const QuantLib::Real timeToExpiry, const QuantLib::Real underlyingLength,
+             const std::vector<QuantLib::Real>& strikes, const QuantLib::Real forward,
+             const MarketQuoteType outputMarketQuoteType,
+             const QuantLib::Real outputLognormalShift = QuantLib::Null<QuantLib::Real>(),
+             const boost::optional<QuantLib::Option::Type> outputOptionType = boost::none) const;
+
 protected:
     std::vector<MarketSmile> marketSmiles_;
     MarketModelType marketModelType_;
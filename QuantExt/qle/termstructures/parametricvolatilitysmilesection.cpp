@@ -37,4 +37,22 @@ Real ParametricVolatilitySmileSection::volatilityImpl(Rate strike) const {
     return tmp;
 }
 
+std::vector<Real> ParametricVolatilitySmileSection::volatilities(const std::vector<Rate>& strikes) const {
+    std::vector<Real> missing;
+    for (auto const& k : strikes) {
+        if (cache_.find(k) == cache_.end())
+            missing.push_back(k);
+    }
+    if (!missing.empty()) {
+        std::vector<Real> tmp =
+            parametricVolatility_->evaluate(optionTime_, swapLength_, missing, atmLevel_, outputMarketQuoteType_);
+        for (Size i = 0; i < missing.size(); ++i)
+            cache_[missing[i]] = tmp[i];
+    }
+    std::vector<Real> result;
+    for (auto const& k : strikes)
+        result.push_back(cache_[k]);
+    return result;
+}
+
 } // namespace QuantExt
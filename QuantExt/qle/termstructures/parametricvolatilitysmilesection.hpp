@@ -39,6 +39,8 @@ public:
     Real minStrike() const override { return -QL_MAX_REAL; }
     Real maxStrike() const override { return QL_MAX_REAL; }
     Real atmLevel() const override;
+    //! volatilities for several strikes, evaluating the parametric volatility once for the strikes not cached yet
+    std::vector<Real> volatilities(const std::vector<Rate>& strikes) const;
 
 private:
     Volatility volatilityImpl(Rate strike) const override;
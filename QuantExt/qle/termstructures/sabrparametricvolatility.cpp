@@ -438,6 +438,7 @@ void SabrParametricVolatility::calculate() {
     calibratedSabrParams_.clear();
     lognormalShifts_.clear();
     calibrationErrors_.clear();
+    interpolatedModelParameters_.clear();
 
     // for each market smile calibrate the SABR variant
 
@@ -599,21 +600,45 @@ void SabrParametricVolatility::calculate() {
     lognormalShiftInterpolation_.enableExtrapolation();
 }
 
+const std::array<Real, 5>& SabrParametricVolatility::interpolatedModelParameters(const Real timeToExpiry,
+                                                                                 const Real underlyingLength) const {
+    auto key = std::make_pair(timeToExpiry, underlyingLength);
+    if (auto p = interpolatedModelParameters_.find(key); p != interpolatedModelParameters_.end())
+        return p->second;
+    return interpolatedModelParameters_
+        .emplace(key, std::array<Real, 5>{alphaInterpolation_(timeToExpiry, underlyingLength),
+                                          betaInterpolation_(timeToExpiry, underlyingLength),
+                                          nuInterpolation_(timeToExpiry, underlyingLength),
+                                          rhoInterpolation_(timeToExpiry, underlyingLength),
+                                          lognormalShiftInterpolation_(timeToExpiry, underlyingLength)})
+        .first->second;
+}
+
 Real SabrParametricVolatility::evaluate(const Real timeToExpiry, const Real underlyingLength, const Real strike,
                                         const Real forward, const MarketQuoteType outputMarketQuoteType,
                                         const Real outputLognormalShift,
                                         const boost::optional<QuantLib::Option::Type> outputOptionType) const {
+    return evaluate(timeToExpiry, underlyingLength, std::vector<Real>{strike}, forward, outputMarketQuoteType,
+                    outputLognormalShift, outputOptionType)
+        .front();
+}
 
-    Real alpha = alphaInterpolation_(timeToExpiry, underlyingLength);
-    Real beta = betaInterpolation_(timeToExpiry, underlyingLength);
-    Real nu = nuInterpolation_(timeToExpiry, underlyingLength);
-    Real rho = rhoInterpolation_(timeToExpiry, underlyingLength);
-    Real lognormalShift = lognormalShiftInterpolation_(timeToExpiry, underlyingLength);
+std::vector<Real> SabrParametricVolatility::evaluate(const Real timeToExpiry, const Real underlyingLength,
+                                                     const std::vector<Real>& strikes, const Real forward,
+                                                     const MarketQuoteType outputMarketQuoteType,
+                                                     const Real outputLognormalShift,
+                                                     const boost::optional<QuantLib::Option::Type> outputOptionType) const {
 
-    Real result = evaluateSabr({alpha, beta, nu, rho}, forward, timeToExpiry, lognormalShift, {strike}).front();
-    return convert(result, preferredOutputQuoteType(), lognormalShift, boost::none, timeToExpiry, strike, forward,
-                   outputMarketQuoteType, outputLognormalShift == Null<Real>() ? lognormalShift : outputLognormalShift,
-                   outputOptionType);
+    auto const& [alpha, beta, nu, rho, lognormalShift] = interpolatedModelParameters(timeToExpiry, underlyingLength);
+
+    std::vector<Real> result = evaluateSabr({alpha, beta, nu, rho}, forward, timeToExpiry, lognormalShift, strikes);
+    for (Size i = 0; i < strikes.size(); ++i) {
+        result[i] = convert(result[i], preferredOutputQuoteType(), lognormalShift, boost::none, timeToExpiry,
+                            strikes[i], forward, outputMarketQuoteType,
+                            outputLognormalShift == Null<Real>() ? lognormalShift : outputLognormalShift,
+                            outputOptionType);
+    }
+    return result;
 }
 
 } // namespace QuantExt
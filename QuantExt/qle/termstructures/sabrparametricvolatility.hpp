@@ -26,6 +26,8 @@
 
 #include <ql/math/interpolations/interpolation2d.hpp>
 
+#include <array>
+
 namespace QuantExt {
 
 class SabrParametricVolatility final : public ParametricVolatility {
@@ -56,6 +58,15 @@ public:
              const QuantLib::Real outputLognormalShift = QuantLib::Null<QuantLib::Real>(),
              const boost::optional<QuantLib::Option::Type> outputOptionType = boost::none) const override;
 
+    /* evaluates the model once for all strikes, i.e. the parameters are interpolated once and for the pde model
+       variant the density is computed once */
+    std::vector<QuantLib::Real>
+    evaluate(const QuantLib::Real timeToExpiry, const QuantLib::Real underlyingLength,
+             const std::vector<QuantLib::Real>& strikes, const QuantLib::Real forward,
+             const MarketQuoteType outputMarketQuoteType,
+             const QuantLib::Real outputLognormalShift = QuantLib::Null<QuantLib::Real>(),
+             const boost::optional<QuantLib::Option::Type> outputOptionType = boost::none) const override;
+
     // the calculated grid of option expiries and the underlying lenghts
     const std::vector<Real>& timeToEpiries() const;
     const std::vector<Real>& underlyingLenghts() const;
@@ -87,6 +98,8 @@ private:
     std::vector<Real> inverse(const std::vector<Real>& y, const Real forward, const Real lognormalShift) const;
     std::vector<Real> evaluateSabr(const std::vector<Real>& params, const Real forward, const Real timeToExpiry,
                                    const Real lognormalShift, const std::vector<Real>& strikes) const;
+    // the interpolated alpha, beta, nu, rho and lognormal shift, cached by (tte, underlyingLen)
+    const std::array<Real, 5>& interpolatedModelParameters(const Real timeToExpiry, const Real underlyingLength) const;
     std::tuple<std::vector<Real>, Real, QuantLib::Size>
     calibrateModelParameters(const MarketSmile& marketSmile, const std::vector<std::pair<Real, bool>>& params) const;
 
@@ -107,6 +120,7 @@ private:
         numberOfCalibrationAttempts_;
     mutable QuantLib::Interpolation2D alphaInterpolation_, betaInterpolation_, nuInterpolation_, rhoInterpolation_,
         lognormalShiftInterpolation_;
+    mutable std::map<std::pair<Real, Real>, std::array<Real, 5>> interpolatedModelParameters_;
 };
 
 } // namespace QuantExt
@@ -0,0 +1,168 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/utilities/memoryaccounting.hpp>
+
+#include <ql/errors.hpp>
+
+#include <limits>
+#include <sstream>
+
+namespace QuantExt {
+
+namespace {
+double megaBytes(const std::size_t bytes) { return static_cast<double>(bytes) / 1024.0 / 1024.0; }
+} // namespace
+
+void MemoryAccount::allocate(const std::size_t bytes) {
+    if (bytes == 0)
+        return;
+    MemoryAccounting& accounting = MemoryAccounting::instance();
+    std::size_t total = accounting.current_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    std::size_t budget = accounting.budget();
+    if (budget > 0 && total > budget) {
+        accounting.current_.fetch_sub(bytes, std::memory_order_relaxed);
+        QL_FAIL("memory budget of " << megaBytes(budget) << " MB exceeded when allocating " << megaBytes(bytes)
+                                    << " MB for " << name_ << ", current usage: " << accounting.usage());
+    }
+    std::size_t current = current_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    std::size_t peak = peak_.load(std::memory_order_relaxed);
+    while (current > peak && !peak_.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+}
+
+void MemoryAccount::release(const std::size_t bytes) {
+    if (bytes == 0)
+        return;
+    current_.fetch_sub(bytes, std::memory_order_relaxed);
+    MemoryAccounting::instance().current_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+MemoryAccounting& MemoryAccounting::instance() {
+    /* not a QuantLib::Singleton, the accounts are shared by all sessions, the instance is never destroyed, since
+       objects with static or thread storage duration may release accounted memory during their destruction */
+    static MemoryAccounting* accounting = new MemoryAccounting;
+    return *accounting;
+}
+
+MemoryAccount& MemoryAccounting::account(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& a = accounts_[name];
+    if (!a)
+        a = std::make_unique<MemoryAccount>(name);
+    return *a;
+}
+
+std::vector<const MemoryAccount*> MemoryAccounting::accounts() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<const MemoryAccount*> result;
+    for (auto const& [name, a] : accounts_)
+        result.push_back(a.get());
+    return result;
+}
+
+std::size_t MemoryAccounting::available() const {
+    std::size_t b = budget(), c = current();
+    if (b == 0 || !enabled())
+        return std::numeric_limits<std::size_t>::max();
+    return b > c ? b - c : 0;
+}
+
+void MemoryAccounting::resetPeaks() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto const& [name, a] : accounts_)
+        a->resetPeak();
+}
+
+std::string MemoryAccounting::usage() const {
+    std::ostringstream os;
+    os.precision(1);
+    os << std::fixed;
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool first = true;
+    for (auto const& [name, a] : accounts_) {
+        if (a->current() == 0)
+            continue;
+        os << (first ? "" : ", ") << name << " " << megaBytes(a->current()) << " MB";
+        first = false;
+    }
+    return first ? "none" : os.str();
+}
+
+AccountedMemory::AccountedMemory(MemoryAccount& account, const std::size_t bytes) : account_(&account) {
+    resize(bytes);
+}
+
+AccountedMemory::AccountedMemory(const AccountedMemory& other) : account_(other.account_) { resize(other.bytes_); }
+
+AccountedMemory::AccountedMemory(AccountedMemory&& other) noexcept
+    : account_(other.account_), bytes_(other.bytes_), accounted_(other.accounted_) {
+    other.bytes_ = other.accounted_ = 0;
+}
+
+AccountedMemory& AccountedMemory::operator=(const AccountedMemory& other) {
+    if (this != &other) {
+        if (account_ != other.account_) {
+            resize(0);
+            account_ = other.account_;
+        }
+        resize(other.bytes_);
+    }
+    return *this;
+}
+
+AccountedMemory& AccountedMemory::operator=(AccountedMemory&& other) noexcept {
+    if (this != &other) {
+        if (account_)
+            account_->release(accounted_);
+        account_ = other.account_;
+        bytes_ = other.bytes_;
+        accounted_ = other.accounted_;
+        other.bytes_ = other.accounted_ = 0;
+    }
+    return *this;
+}
+
+AccountedMemory::~AccountedMemory() {
+    if (account_)
+        account_->release(accounted_);
+}
+
+void AccountedMemory::resize(const std::size_t bytes) {
+    // the default path, a relaxed load and no update of the process-wide counters
+    if (!MemoryAccounting::instance().enabled()) {
+        if (accounted_ > 0) {
+            account_->release(accounted_);
+            accounted_ = 0;
+        }
+        bytes_ = bytes;
+        return;
+    }
+    if (bytes == accounted_) {
+        bytes_ = bytes;
+        return;
+    }
+    QL_REQUIRE(account_ != nullptr, "AccountedMemory::resize(): no account given");
+    if (bytes > accounted_)
+        account_->allocate(bytes - accounted_);
+    else
+        account_->release(accounted_ - bytes);
+    bytes_ = accounted_ = bytes;
+}
+
+} // namespace QuantExt
@@ -0,0 +1,126 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/utilities/memoryaccounting.hpp
+    \brief accounting of the memory held by large data structures, per component
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace QuantExt {
+
+//! The current and peak number of bytes held by one component, e.g. all NPV cubes
+/*! Accounts are obtained from MemoryAccounting::account() and live until the end of the program. */
+class MemoryAccount {
+public:
+    explicit MemoryAccount(const std::string& name) : name_(name) {}
+    const std::string& name() const { return name_; }
+
+    //! Account for bytes about to be allocated, throws if this exceeds the memory budget
+    void allocate(const std::size_t bytes);
+    //! Account for bytes released
+    void release(const std::size_t bytes);
+
+    std::size_t current() const { return current_.load(std::memory_order_relaxed); }
+    std::size_t peak() const { return peak_.load(std::memory_order_relaxed); }
+    //! Set the peak to the current number of bytes
+    void resetPeak() { peak_.store(current(), std::memory_order_relaxed); }
+
+private:
+    std::string name_;
+    std::atomic<std::size_t> current_ = 0, peak_ = 0;
+};
+
+//! Registry of the memory accounts and the optional memory budget
+/*! The accounting covers the large data buffers of a run (cubes, scenarios, reports, random variable buffers etc.),
+    not the total memory of the process. If a budget is set, an allocation that would take the sum over all accounts
+    above the budget fails with an exception listing the current usage per component, so that a run stops early
+    instead of being killed by the operating system.
+
+    The accounting is switched off by default, AccountedMemory then only checks the flag and does not update the
+    process-wide counters. The budget is only enforced while the accounting is switched on. */
+class MemoryAccounting {
+public:
+    static MemoryAccounting& instance();
+
+    //! Whether AccountedMemory objects update their accounts
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    //! Switch the accounting on or off, switching it off releases the bytes of AccountedMemory objects on resize
+    void enable(const bool b) { enabled_.store(b, std::memory_order_relaxed); }
+
+    //! The account with the given name, created on first use
+    MemoryAccount& account(const std::string& name);
+    //! All accounts
+    std::vector<const MemoryAccount*> accounts() const;
+
+    //! Set the budget in bytes, 0 means no budget
+    void setBudget(const std::size_t bytes) { budget_.store(bytes, std::memory_order_relaxed); }
+    std::size_t budget() const { return budget_.load(std::memory_order_relaxed); }
+    /*! The number of bytes that can still be allocated within the budget, max size_t if there is no budget or the
+        accounting is switched off */
+    std::size_t available() const;
+
+    //! The sum of the current bytes over all accounts
+    std::size_t current() const { return current_.load(std::memory_order_relaxed); }
+    //! Reset the peaks of all accounts to their current values
+    void resetPeaks();
+
+private:
+    friend class MemoryAccount;
+    MemoryAccounting() {}
+    std::string usage() const;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<MemoryAccount>> accounts_;
+    std::atomic<std::size_t> current_ = 0, budget_ = 0;
+    std::atomic<bool> enabled_ = false;
+};
+
+//! A number of bytes accounted for in a MemoryAccount for the lifetime of this object
+/*! Intended as a member of the class owning the accounted buffers, copies account for the same number of bytes
+    again, so that the class can keep its implicit copy and move operations. While the accounting is switched off
+    only the requested number of bytes is stored, it is accounted for on the first resize after switching it on. */
+class AccountedMemory {
+public:
+    AccountedMemory() {}
+    AccountedMemory(MemoryAccount& account, const std::size_t bytes = 0);
+    AccountedMemory(const AccountedMemory& other);
+    AccountedMemory(AccountedMemory&& other) noexcept;
+    AccountedMemory& operator=(const AccountedMemory& other);
+    AccountedMemory& operator=(AccountedMemory&& other) noexcept;
+    ~AccountedMemory();
+
+    //! Change the accounted number of bytes, throws if an increase exceeds the budget
+    void resize(const std::size_t bytes);
+    std::size_t bytes() const { return bytes_; }
+
+private:
+    MemoryAccount* account_ = nullptr;
+    // the requested bytes and the bytes currently accounted for in account_
+    std::size_t bytes_ = 0, accounted_ = 0;
+};
+
+} // namespace QuantExt
@@ -28,6 +28,7 @@
 #include <ql/math/randomnumbers/inversecumulativerng.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 
 using namespace QuantExt;
@@ -109,6 +110,21 @@ BOOST_AUTO_TEST_CASE(testBackwardDerivatives) {
     BOOST_CHECK_CLOSE(derivativesBwd[u][0], 2.0, tol);
     // dz/dz = 1
     BOOST_CHECK_CLOSE(derivativesBwd[z][0], 1.0, tol);
+
+    // multi-output backward derivatives for z and u in one sweep
+
+    std::vector<std::vector<RandomVariable>> derivativesMulti(
+        2, std::vector<RandomVariable>(g.size(), RandomVariable(1, 0.0)));
+    derivativesMulti[0][z] = RandomVariable(1, 1.0);
+    derivativesMulti[1][u] = RandomVariable(1, 1.0);
+
+    backwardDerivatives(g, values, derivativesMulti, getRandomVariableGradients(1), RandomVariable::deleter, keep);
+
+    BOOST_CHECK_CLOSE(derivativesMulti[0][x][0], 7.0, tol);
+    BOOST_CHECK_CLOSE(derivativesMulti[0][y][0], 2.0, tol);
+    // du/dx = du/dy = 1
+    BOOST_CHECK_CLOSE(derivativesMulti[1][x][0], 1.0, tol);
+    BOOST_CHECK_CLOSE(derivativesMulti[1][y][0], 1.0, tol);
 }
 
 BOOST_AUTO_TEST_CASE(testForwardDerivatives) {
@@ -147,6 +163,21 @@ BOOST_AUTO_TEST_CASE(testForwardDerivatives) {
     BOOST_CHECK_CLOSE(derivativesFwdX[z][0], 7.0, tol);
     // dz/dy = x
     BOOST_CHECK_CLOSE(derivativesFwdY[z][0], 2.0, tol);
+
+    // vector forward mode, both directions in one sweep, z is recomputed
+
+    std::vector<std::vector<RandomVariable>> derivativesFwd(2, std::vector<RandomVariable>(g.size()));
+    derivativesFwd[0][x] = RandomVariable(1, 1.0);
+    derivativesFwd[1][y] = RandomVariable(1, 1.0);
+    values[z] = RandomVariable();
+
+    forwardEvaluationAndDerivatives(g, values, derivativesFwd, getRandomVariableOps(1), getRandomVariableGradients(1),
+                                    RandomVariable::deleter, {false, false, false, true});
+
+    BOOST_CHECK_CLOSE(values[z][0], 10.0, tol);
+    BOOST_CHECK_CLOSE(derivativesFwd[0][z][0], 7.0, tol);
+    BOOST_CHECK_CLOSE(derivativesFwd[1][z][0], 2.0, tol);
+    BOOST_CHECK(!derivativesFwd[1][u].initialised());
 }
 
 BOOST_AUTO_TEST_CASE(testIndicatorDerivative) {
@@ -190,6 +221,216 @@ BOOST_AUTO_TEST_CASE(testIndicatorDerivative) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testGraphOptimisation) {
+    BOOST_TEST_MESSAGE("Testing common subexpression and dead node elimination...");
+
+    ComputationGraph g;
+    g.enableCommonSubexpressionElimination();
+
+    auto x = cg_insert(g);
+    auto y = cg_insert(g);
+    auto a = cg_mult(g, x, y);
+    auto b = cg_mult(g, x, y);
+    auto c = cg_exp(g, a);
+    auto dead = cg_log(g, b);
+    auto z = cg_add(g, c, cg_exp(g, b));
+
+    BOOST_CHECK_EQUAL(a, b);
+    BOOST_CHECK_EQUAL(g.numberOfEliminatedSubexpressions(), 2);
+    BOOST_CHECK_EQUAL(g.size(), 6);
+
+    // nodes in different red blocks are not shared
+
+    g.startRedBlock();
+    auto r1 = cg_sqrt(g, z);
+    g.endRedBlock();
+    g.startRedBlock();
+    auto r2 = cg_sqrt(g, z);
+    g.endRedBlock();
+    BOOST_CHECK(r1 != r2);
+
+    std::vector<bool> outputNodes(g.size(), false);
+    outputNodes[z] = true;
+    auto activeNodes = deadNodeElimination(g, outputNodes);
+    BOOST_CHECK_EQUAL(activeNodes[dead], ComputationGraph::nan);
+    BOOST_CHECK_EQUAL(activeNodes[r1], ComputationGraph::nan);
+    BOOST_CHECK_EQUAL(activeNodes[a], c);
+
+    std::vector<RandomVariable> values(g.size());
+    values[x] = RandomVariable(1, 2.0);
+    values[y] = RandomVariable(1, 3.0);
+    std::vector<bool> keepNodes(g.size(), false);
+    keepNodes[z] = true;
+    forwardEvaluation(g, values, getRandomVariableOps(1), RandomVariable::deleter, false, {}, keepNodes, 0,
+                      ComputationGraph::nan, false, {}, {}, activeNodes);
+    BOOST_CHECK_CLOSE(values[z][0], 2.0 * std::exp(6.0), 1E-10);
+    BOOST_CHECK(!values[dead].initialised());
+}
+
+BOOST_AUTO_TEST_CASE(testCheckpointedBackwardDerivatives) {
+    BOOST_TEST_MESSAGE("Testing backward derivatives with checkpointed red blocks...");
+
+    ComputationGraph g;
+    auto one = cg_const(g, 1.0);
+    auto x = cg_insert(g);
+    g.startRedBlock();
+    auto a = cg_exp(g, x);
+    auto b = cg_mult(g, a, a);
+    g.startRedBlock();
+    auto c = cg_add(g, b, one);
+    g.endRedBlock();
+    // d needs the value of b for its derivative, although b is in a red block
+    auto d = cg_mult(g, cg_mult(g, b, x), c);
+
+    std::vector<bool> keepNodes(g.size(), false);
+    keepNodes[one] = keepNodes[x] = keepNodes[d] = true;
+    for (auto const n : g.redBlockDependencies())
+        keepNodes[n] = true;
+
+    Real x0 = 0.3;
+    std::vector<RandomVariable> values(g.size()), derivatives(g.size(), RandomVariable(1, 0.0));
+    values[one] = RandomVariable(1, 1.0);
+    values[x] = RandomVariable(1, x0);
+
+    auto ops = getRandomVariableOps(1);
+    auto opNodeRequirements = getRandomVariableOpNodeRequirements();
+    forwardEvaluation(g, values, ops, RandomVariable::deleter, true, opNodeRequirements, keepNodes);
+    BOOST_CHECK(!values[a].initialised());
+
+    derivatives[d] = RandomVariable(1, 1.0);
+    std::vector<bool> keepNodesDerivatives(g.size(), false);
+    keepNodesDerivatives[x] = true;
+    backwardDerivatives(g, values, derivatives, getRandomVariableGradients(1), RandomVariable::deleter,
+                        keepNodesDerivatives, ops, opNodeRequirements, keepNodes);
+
+    // d = e^{2x} x (e^{2x} + 1)
+    Real e = std::exp(2.0 * x0);
+    BOOST_CHECK_CLOSE(values[d][0], e * x0 * (e + 1.0), 1E-10);
+    BOOST_CHECK_CLOSE(derivatives[x][0], (2.0 * e * x0 + e) * (e + 1.0) + e * x0 * 2.0 * e, 1E-10);
+}
+
+BOOST_AUTO_TEST_CASE(testParallelForwardEvaluation) {
+    BOOST_TEST_MESSAGE("Testing parallel forward evaluation of independent red blocks...");
+
+    constexpr Size nSamples = 1000, nBlocks = 20;
+
+    // a model layer m = exp(x), followed by independent trade blocks and a sum over the trades
+
+    ComputationGraph g;
+    auto x = cg_insert(g);
+    auto m = cg_exp(g, x);
+    std::vector<std::size_t> tradeNodes;
+    for (Size i = 0; i < nBlocks; ++i) {
+        g.startRedBlock();
+        // the constants are created in the first block and shared with the other blocks
+        auto a = cg_mult(g, m, cg_const(g, static_cast<double>(i % 3 + 1)));
+        tradeNodes.push_back(cg_max(g, cg_subtract(g, a, cg_const(g, 1.0)), cg_const(g, 0.0)));
+        g.endRedBlock();
+    }
+    auto sum = cg_add(g, tradeNodes);
+    g.startRedBlock();
+    auto d = cg_mult(g, sum, m);
+    g.startRedBlock();
+    // this block depends on the previous red block, so it can not be evaluated concurrently with it
+    auto e = cg_add(g, d, tradeNodes.front());
+    g.endRedBlock();
+
+    auto groups = QuantExt::detail::independentRedBlockGroups(g, 0, g.size());
+    BOOST_REQUIRE_EQUAL(groups.size(), 1);
+    BOOST_CHECK_EQUAL(groups.front().first, 0);
+    BOOST_CHECK_EQUAL(groups.front().second, nBlocks);
+
+    auto ops = getRandomVariableOps(nSamples);
+    auto opNodeRequirements = getRandomVariableOpNodeRequirements();
+    std::vector<bool> keepNodes(g.size(), false);
+    keepNodes[x] = keepNodes[sum] = keepNodes[e] = true;
+    for (auto const& c : g.constants())
+        keepNodes[c.second] = true;
+
+    std::vector<RandomVariable> values1, values4;
+    for (auto v : {&values1, &values4}) {
+        v->resize(g.size());
+        for (auto const& c : g.constants())
+            (*v)[c.second] = RandomVariable(nSamples, c.first);
+        (*v)[x] = RandomVariable(nSamples);
+        for (Size k = 0; k < nSamples; ++k)
+            (*v)[x].set(k, -1.0 + 2.0 * static_cast<double>(k) / nSamples);
+    }
+
+    forwardEvaluation(g, values1, ops, RandomVariable::deleter, false, opNodeRequirements, keepNodes);
+    EvaluationProfile profile(nSamples);
+    forwardEvaluation(g, values4, ops, RandomVariable::deleter, false, opNodeRequirements, keepNodes, 0,
+                      ComputationGraph::nan, false, {}, {}, {}, 4, &profile);
+
+    BOOST_CHECK(values4[sum] == values1[sum]);
+    BOOST_CHECK(values4[e] == values1[e]);
+    BOOST_CHECK(!values4[m].initialised());
+    BOOST_CHECK(!values4[tradeNodes.back()].initialised());
+    for (auto const& c : g.constants())
+        BOOST_CHECK(values4[c.second].initialised());
+
+    // the profile counts each evaluated node once by op and by region (= red block id here)
+
+    std::size_t nEvaluated = 0;
+    for (std::size_t n = 0; n < g.size(); ++n)
+        nEvaluated += g.predecessors(n).empty() ? 0 : 1;
+    std::size_t nByOp = 0, nByRegion = 0;
+    for (auto const& e : profile.byOpId)
+        nByOp += e.numberOfNodes;
+    for (auto const& e : profile.byRegion)
+        nByRegion += e.numberOfNodes;
+    BOOST_CHECK_EQUAL(nByOp, nEvaluated);
+    BOOST_CHECK_EQUAL(nByRegion, nEvaluated);
+    BOOST_REQUIRE_EQUAL(profile.byRegion.size(), nBlocks + 3);
+    BOOST_CHECK_EQUAL(profile.byRegion[nBlocks + 2].numberOfNodes, 1);
+    BOOST_CHECK_CLOSE(profile.flops(profile.byRegion[nBlocks + 2]), static_cast<double>(nSamples), 1E-10);
+}
+
+BOOST_AUTO_TEST_CASE(testGraphSerialization) {
+    BOOST_TEST_MESSAGE("Testing computation graph serialization...");
+
+    ComputationGraph g;
+    auto x = cg_var(g, "x", ComputationGraph::VarDoesntExist::Create);
+    auto y = cg_exp(g, cg_mult(g, x, cg_const(g, 2.0)));
+    g.startRedBlock();
+    auto z = cg_add(g, y, cg_const(g, 1.0));
+    g.endRedBlock();
+    auto w = cg_mult(g, z, x);
+
+    auto fileName = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    saveComputationGraph(g, fileName);
+    ComputationGraph h;
+    loadComputationGraph(h, fileName);
+    boost::filesystem::remove(fileName);
+
+    BOOST_REQUIRE_EQUAL(h.size(), g.size());
+    for (std::size_t n = 0; n < g.size(); ++n) {
+        BOOST_CHECK_EQUAL(h.opId(n), g.opId(n));
+        BOOST_CHECK(h.predecessors(n) == g.predecessors(n));
+        BOOST_CHECK_EQUAL(h.maxNodeRequiringArg(n), g.maxNodeRequiringArg(n));
+        BOOST_CHECK_EQUAL(h.redBlockId(n), g.redBlockId(n));
+    }
+    BOOST_CHECK(h.constants() == g.constants());
+    BOOST_CHECK(h.variables() == g.variables());
+    BOOST_CHECK(h.redBlockRanges() == g.redBlockRanges());
+    BOOST_CHECK(h.redBlockDependencies() == g.redBlockDependencies());
+
+    // populate the inputs of the loaded graph and evaluate it
+
+    std::vector<RandomVariable> values(h.size());
+    for (auto const& c : h.constants())
+        values[c.second] = RandomVariable(1, c.first);
+    values[h.variable("x")] = RandomVariable(1, 0.5);
+    forwardEvaluation(h, values, getRandomVariableOps(1));
+    BOOST_CHECK_CLOSE(values[w][0], (std::exp(1.0) + 1.0) * 0.5, 1E-10);
+
+    // the loaded graph can be extended
+
+    auto v = cg_add(h, w, cg_const(h, 1.0));
+    BOOST_CHECK_EQUAL(v, g.size());
+    BOOST_CHECK_EQUAL(h.constant(2.0), g.constant(2.0));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
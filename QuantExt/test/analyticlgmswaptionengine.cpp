@@ -568,6 +568,61 @@ BOOST_AUTO_TEST_CASE(testLgmInvariances) {
     }
 } // testInvariances
 
+BOOST_AUTO_TEST_CASE(testParameterSensitivities) {
+
+    BOOST_TEST_MESSAGE("Testing analytic LGM swaption engine parameter sensitivities against finite differences...");
+
+    Handle<YieldTermStructure> flatCurve(
+        QuantLib::ext::make_shared<FlatForward>(0, NullCalendar(), 0.02, Actual365Fixed()));
+    QuantLib::ext::shared_ptr<SwapIndex> index = QuantLib::ext::make_shared<EuriborSwapIsdaFixA>(10 * Years, flatCurve);
+
+    const Real alpha = 0.01, kappa = 0.02, h = 1E-5;
+
+    auto price = [&flatCurve](Swaption& swaption, const Real alpha, const Real kappa) {
+        auto engine = QuantLib::ext::make_shared<AnalyticLgmSwaptionEngine>(
+            QuantLib::ext::make_shared<IrLgm1fConstantParametrization>(EURCurrency(), flatCurve, alpha, kappa),
+            flatCurve);
+        engine->enableParameterSensitivities();
+        swaption.setPricingEngine(engine);
+        return swaption.NPV();
+    };
+
+    // H(t) = (1 - exp(-kappa t)) / kappa, zeta(t) = alpha^2 t for the constant parametrization
+
+    auto dHdKappa = [kappa](const Real t) {
+        return (kappa * t * std::exp(-kappa * t) - 1.0 + std::exp(-kappa * t)) / (kappa * kappa);
+    };
+
+    for (auto const& strike : {0.01, 0.02, 0.03}) {
+        for (auto const& type : {VanillaSwap::Payer, VanillaSwap::Receiver}) {
+            Swaption swaption = MakeSwaption(index, 5 * Years, strike).withUnderlyingType(type);
+            price(swaption, alpha, kappa);
+            Real sensZeta = swaption.result<Real>("sensitivityZetaExpiry");
+            Real sensH0 = swaption.result<Real>("sensitivityHStart");
+            std::vector<Real> sensHj = swaption.result<std::vector<Real>>("sensitivityHFixedPayDates");
+
+            const Leg& fixedLeg = swaption.underlyingSwap()->fixedLeg();
+            const Leg& floatingLeg = swaption.underlyingSwap()->floatingLeg();
+            BOOST_REQUIRE_EQUAL(sensHj.size(), fixedLeg.size());
+
+            Real texp = flatCurve->timeFromReference(swaption.exercise()->dates().back());
+            Real sensAlpha = sensZeta * 2.0 * alpha * texp;
+            Real sensKappa = sensH0 * dHdKappa(flatCurve->timeFromReference(
+                                          QuantLib::ext::dynamic_pointer_cast<Coupon>(floatingLeg.front())->accrualStartDate()));
+            for (Size j = 0; j < fixedLeg.size(); ++j)
+                sensKappa += sensHj[j] * dHdKappa(flatCurve->timeFromReference(fixedLeg[j]->date()));
+
+            Real fdAlpha = (price(swaption, alpha + h, kappa) - price(swaption, alpha - h, kappa)) / (2.0 * h);
+            Real fdKappa = (price(swaption, alpha, kappa + h) - price(swaption, alpha, kappa - h)) / (2.0 * h);
+
+            BOOST_TEST_MESSAGE("strike " << strike << ", type " << type << ": alpha " << sensAlpha << " vs "
+                                         << fdAlpha << ", kappa " << sensKappa << " vs " << fdKappa);
+            BOOST_CHECK_CLOSE(sensAlpha, fdAlpha, 1E-2);
+            BOOST_CHECK_CLOSE(sensKappa, fdKappa, 1E-2);
+        }
+    }
+} // testParameterSensitivities
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
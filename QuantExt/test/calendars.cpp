@@ -18,9 +18,12 @@
 
 #include "toplevelfixture.hpp"
 #include <boost/test/unit_test.hpp>
+#include <qle/calendars/cachedcalendar.hpp>
 #include <qle/calendars/russia.hpp>
 #include <qle/calendars/unitedarabemirates.hpp>
 #include <ql/settings.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/calendars/unitedkingdom.hpp>
 
 using namespace std;
 using namespace boost::unit_test_framework;
@@ -115,6 +118,38 @@ BOOST_AUTO_TEST_CASE(updatedArabEmirates){
 
 }
 
+BOOST_AUTO_TEST_CASE(testCachedCalendar) {
+    BOOST_TEST_MESSAGE("Testing CachedCalendar against the underlying calendars");
+
+    Calendar target = TARGET();
+    Calendar uk = UnitedKingdom();
+    Calendar joint = JointCalendar(target, uk);
+    Calendar cachedTarget = CachedCalendar(target, 2020, 2030);
+    Calendar cachedJoint = CachedCalendar({target, uk}, JoinHolidays, 2020, 2030);
+    BOOST_CHECK_EQUAL(cachedTarget.name(), target.name());
+    BOOST_CHECK_EQUAL(cachedJoint.name(), joint.name());
+
+    // inside and outside the cached years
+    for (Date d(1, January, 2018); d <= Date(31, December, 2032); ++d) {
+        BOOST_CHECK_EQUAL(cachedTarget.isBusinessDay(d), target.isBusinessDay(d));
+        BOOST_CHECK_EQUAL(cachedJoint.isBusinessDay(d), joint.isBusinessDay(d));
+    }
+    BOOST_CHECK_EQUAL(cachedJoint.advance(Date(20, December, 2024), 5 * Days),
+                      joint.advance(Date(20, December, 2024), 5 * Days));
+
+    // holidays added to the cached calendar or to an underlying calendar after construction
+    Date d(15, May, 2025);
+    BOOST_REQUIRE(cachedJoint.isBusinessDay(d));
+    cachedTarget.addHoliday(d);
+    BOOST_CHECK(!cachedTarget.isBusinessDay(d));
+    BOOST_CHECK(target.isBusinessDay(d));
+    uk.addHoliday(d);
+    BOOST_CHECK(!cachedJoint.isBusinessDay(d));
+    uk.removeHoliday(d);
+    uk.resetAddedAndRemovedHolidays();
+    BOOST_CHECK(cachedJoint.isBusinessDay(d));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
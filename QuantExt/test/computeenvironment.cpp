@@ -18,6 +18,7 @@
 
 #include <qle/math/basiccpuenvironment.hpp>
 #include <qle/math/computeenvironment.hpp>
+#include <qle/math/cudaenvironment.hpp>
 #include <qle/math/openclenvironment.hpp>
 #include <qle/math/randomvariable.hpp>
 #include <qle/math/randomvariable_io.hpp>
@@ -42,6 +43,8 @@ struct ComputeEnvironmentFixture {
     ComputeEnvironmentFixture() {
         QuantExt::ComputeFrameworkRegistry::instance().add(
             "OpenCL", &QuantExt::createComputeFrameworkCreator<QuantExt::OpenClFramework>, true);
+        QuantExt::ComputeFrameworkRegistry::instance().add(
+            "CUDA", &QuantExt::createComputeFrameworkCreator<QuantExt::CudaFramework>, true);
         QuantExt::ComputeFrameworkRegistry::instance().add(
             "BasicCpu", &QuantExt::createComputeFrameworkCreator<QuantExt::BasicCpuFramework>, true);
     }
@@ -406,6 +409,91 @@ BOOST_AUTO_TEST_CASE(testConditionalExpectation) {
     BOOST_CHECK(true);
 }
 
+BOOST_AUTO_TEST_CASE(testBasicCpuSinglePrecision) {
+    BOOST_TEST_MESSAGE("testing single and double precision on the basic cpu context");
+    ComputeEnvironmentFixture fixture;
+    const std::size_t n = 1001;
+
+    auto calc = [n](ComputeContext& c, const ComputeContext::Settings& settings) {
+        std::vector<double> rx(n);
+        for (Size i = 0; i < n; ++i)
+            rx[i] = 1.29382757483823819 + 0.001 * i;
+        std::vector<std::vector<double>> output(1, std::vector<double>(n));
+        c.initiateCalculation(n, 0, 0, settings);
+        auto x = c.createInputVariable(&rx[0]);
+        auto y = c.createInputVariable(0.1234567890123);
+        auto z = c.applyOperation(RandomVariableOpCode::Mult, {x, y});
+        auto w = c.applyOperation(RandomVariableOpCode::Add, {z, x});
+        auto e = c.applyOperation(RandomVariableOpCode::Exp, {w});
+        c.declareOutputVariable(c.applyOperation(RandomVariableOpCode::Mult, {e, w}));
+        c.finalizeCalculation(output);
+        std::vector<double> expected(n);
+        for (Size i = 0; i < n; ++i) {
+            double v = rx[i] * 0.1234567890123 + rx[i];
+            expected[i] = std::exp(v) * v;
+        }
+        return std::make_pair(output.front(), expected);
+    };
+
+    ComputeEnvironment::instance().selectContext("BasicCpu/Default/Default");
+    auto& c = ComputeEnvironment::instance().context();
+
+    // the default settings calculate in double precision
+    ComputeContext::Settings settings;
+    auto [dbl, expected] = calc(c, settings);
+    for (Size i = 0; i < n; ++i)
+        BOOST_CHECK_CLOSE(dbl[i], expected[i], 1.0E-12);
+
+    // single precision is used if requested explicitly
+    settings.useSinglePrecisionOnCpu = true;
+    auto [flt, expected2] = calc(c, settings);
+    double maxDiff = 0.0;
+    for (Size i = 0; i < n; ++i) {
+        BOOST_CHECK_CLOSE(flt[i], expected2[i], 1.0E-4);
+        maxDiff = std::max(maxDiff, std::abs(flt[i] - dbl[i]) / dbl[i]);
+    }
+    BOOST_CHECK(maxDiff > 1.0E-12);
+}
+
+BOOST_AUTO_TEST_CASE(testMultiDeviceCalc) {
+    BOOST_TEST_MESSAGE("testing calc with samples partitioned over several devices");
+    ComputeEnvironmentFixture fixture;
+    const std::size_t n = 1001;
+
+    auto calc = [n](ComputeContext& c, const double input) {
+        ComputeContext::Settings settings;
+        settings.useDoublePrecision = true;
+        std::vector<double> rx(n);
+        for (Size i = 0; i < n; ++i)
+            rx[i] = input + 0.001 * i;
+        std::vector<std::vector<double>> output(2, std::vector<double>(n));
+        auto [id, newCalc] = c.initiateCalculation(n, 0, 0, settings);
+        auto x = c.createInputVariable(&rx[0]);
+        auto one = c.createInputVariable(1.0);
+        auto vs = c.createInputVariates(1, 2);
+        auto y = c.applyOperation(RandomVariableOpCode::Add, {vs[0][0], x});
+        auto ce = c.applyOperation(RandomVariableOpCode::ConditionalExpectation, {y, one, vs[0][1]});
+        auto z = c.applyOperation(RandomVariableOpCode::Mult, {ce, vs[0][1]});
+        auto w = c.applyOperation(RandomVariableOpCode::Add, {z, y});
+        c.declareOutputVariable(ce);
+        c.declareOutputVariable(w);
+        c.finalizeCalculation(output);
+        return output;
+    };
+
+    ComputeEnvironment::instance().selectContext("BasicCpu/Default/Default");
+    auto reference = calc(ComputeEnvironment::instance().context(), 1.0);
+
+    ComputeEnvironment::instance().selectContext("BasicCpu/Default/Default;BasicCpu/Default/Default");
+    auto result = calc(ComputeEnvironment::instance().context(), 1.0);
+
+    for (Size k = 0; k < reference.size(); ++k) {
+        for (Size i = 0; i < n; ++i) {
+            BOOST_CHECK_CLOSE(result[k][i], reference[k][i], 1.0E-8);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -54,7 +54,9 @@
 #include <qle/models/lgm.hpp>
 #include <qle/models/lgmimplieddefaulttermstructure.hpp>
 #include <qle/models/lgmimpliedyieldtermstructure.hpp>
+#include <qle/models/lgmvectorised.hpp>
 #include <qle/models/linkablecalibratedmodel.hpp>
+#include <qle/models/modelimpliedyieldtermstructure.hpp>
 #include <qle/models/parametrization.hpp>
 #include <qle/models/piecewiseconstanthelper.hpp>
 #include <qle/models/pseudoparameter.hpp>
@@ -453,6 +455,122 @@ BOOST_AUTO_TEST_CASE(testLgm1fCalibration) {
 
 } // testLgm1fCalibration
 
+namespace {
+// rejects parameters whose first n entries exceed a maximum in absolute value, the others are not restricted
+class MaxParameterConstraint : public Constraint {
+    class Impl : public Constraint::Impl {
+    public:
+        Impl(const Size n, const Real max) : n_(n), max_(max) {}
+        bool test(const Array& params) const override {
+            for (Size i = 0; i < std::min(n_, params.size()); ++i) {
+                if (std::fabs(params[i]) > max_)
+                    return false;
+            }
+            return true;
+        }
+
+    private:
+        Size n_;
+        Real max_;
+    };
+
+public:
+    MaxParameterConstraint(const Size n, const Real max) : Constraint(QuantLib::ext::make_shared<Impl>(n, max)) {}
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(testLgm1fRootSearchCalibration) {
+
+    BOOST_TEST_MESSAGE("Testing root search against optimizer in the iterative calibration of LGM 1F model...");
+
+    SavedSettings backup;
+
+    Date evalDate(12, January, 2015);
+    Settings::instance().evaluationDate() = evalDate;
+    Handle<YieldTermStructure> yts(QuantLib::ext::make_shared<FlatForward>(evalDate, 0.02, Actual365Fixed()));
+    QuantLib::ext::shared_ptr<IborIndex> euribor6m = QuantLib::ext::make_shared<Euribor>(6 * Months, yts);
+
+    // coterminal basket 1y-9y, 2y-8y, ... 9y-1y
+
+    std::vector<QuantLib::ext::shared_ptr<BlackCalibrationHelper> > basket;
+    Real impliedVols[] = { 0.4, 0.39, 0.38, 0.35, 0.35, 0.34, 0.33, 0.32, 0.31 };
+    std::vector<Date> expiryDates;
+    for (Size i = 0; i < 9; ++i) {
+        QuantLib::ext::shared_ptr<BlackCalibrationHelper> helper = QuantLib::ext::make_shared<SwaptionHelper>(
+            (i + 1) * Years, (9 - i) * Years, Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(impliedVols[i])),
+            euribor6m, 1 * Years, Thirty360(Thirty360::BondBasis), Actual360(), yts);
+        basket.push_back(helper);
+        expiryDates.push_back(
+            QuantLib::ext::static_pointer_cast<SwaptionHelper>(helper)->swaption()->exercise()->dates().back());
+    }
+
+    Array stepTimes_a(expiryDates.size() - 1);
+    for (Size i = 0; i < stepTimes_a.size(); ++i)
+        stepTimes_a[i] = yts->timeFromReference(expiryDates[i]);
+    Array sigmas_a(stepTimes_a.size() + 1, 0.0050), kappas_a(stepTimes_a.size() + 1, 0.05);
+
+    auto lgmModel = [&yts, &stepTimes_a, &sigmas_a, &kappas_a]() {
+        return QuantLib::ext::make_shared<LinearGaussMarkovModel>(
+            QuantLib::ext::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(EURCurrency(), yts, stepTimes_a,
+                                                                                 sigmas_a, stepTimes_a, kappas_a));
+    };
+    auto calibrate = [&basket](const QuantLib::ext::shared_ptr<LinearGaussMarkovModel>& lgm,
+                               const Constraint& constraint) {
+        auto engine = QuantLib::ext::make_shared<AnalyticLgmSwaptionEngine>(lgm);
+        for (auto const& h : basket)
+            h->setPricingEngine(engine);
+        LevenbergMarquardt lm(1E-8, 1E-8, 1E-8);
+        EndCriteria ec(1000, 500, 1E-8, 1E-8, 1E-8);
+        lgm->calibrateVolatilitiesIterative(basket, lm, ec, constraint);
+        return lgm->parametrization()->parameterValues(0);
+    };
+
+    // the root search and the optimizer give the same volatilities
+
+    auto lgmRootSearch = lgmModel();
+    BOOST_CHECK(lgmRootSearch->rootSearchCalibration());
+    Array sigmasRootSearch = calibrate(lgmRootSearch, Constraint());
+    for (Size i = 0; i < basket.size(); ++i)
+        BOOST_CHECK_SMALL(basket[i]->modelValue() - basket[i]->marketValue(), 1E-10);
+
+    auto lgmOptimizer = lgmModel();
+    lgmOptimizer->setRootSearchCalibration(false);
+    Array sigmasOptimizer = calibrate(lgmOptimizer, Constraint());
+    BOOST_REQUIRE_EQUAL(sigmasRootSearch.size(), sigmasOptimizer.size());
+    for (Size i = 0; i < sigmasRootSearch.size(); ++i)
+        BOOST_CHECK_CLOSE(sigmasRootSearch[i], sigmasOptimizer[i], 1E-3);
+
+    // the root search is not used if switched off or if there is not exactly one free parameter
+
+    EndCriteria ec(1000, 500, 1E-8, 1E-8, 1E-8);
+    Array params = lgmOptimizer->params();
+    std::vector<bool> fixParameters(params.size(), true);
+    fixParameters[0] = false;
+    BOOST_CHECK(!lgmOptimizer->calibrateByRootSearch(basket[0], ec, Constraint(), fixParameters));
+    BOOST_CHECK(!lgmRootSearch->calibrateByRootSearch(basket[0], ec, Constraint(),
+                                                      std::vector<bool>(params.size(), false)));
+
+    // the optimizer is used as a fallback if the root violates the constraint
+
+    Real maxSigma = 0.9 * *std::min_element(sigmasRootSearch.begin(), sigmasRootSearch.end());
+    BOOST_REQUIRE(maxSigma > sigmas_a[0]);
+    // the raw parameters of the adaptor are the square roots of the volatilities
+    MaxParameterConstraint constraint(sigmas_a.size(), std::sqrt(maxSigma));
+    auto lgmFallback = lgmModel();
+    Array initialParams = lgmFallback->params();
+    auto engine = QuantLib::ext::make_shared<AnalyticLgmSwaptionEngine>(lgmFallback);
+    basket[0]->setPricingEngine(engine);
+    BOOST_CHECK(!lgmFallback->calibrateByRootSearch(basket[0], ec, constraint, fixParameters));
+    Array paramsAfterRootSearch = lgmFallback->params();
+    for (Size i = 0; i < initialParams.size(); ++i)
+        BOOST_CHECK_EQUAL(paramsAfterRootSearch[i], initialParams[i]);
+    Array sigmasFallback = calibrate(lgmFallback, constraint);
+    for (Size i = 0; i < sigmasFallback.size(); ++i) {
+        BOOST_CHECK(sigmasFallback[i] <= maxSigma * (1.0 + 1E-10));
+        BOOST_CHECK(sigmasFallback[i] > sigmas_a[i]);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testCcyLgm3fForeignPayouts) {
 
     BOOST_TEST_MESSAGE("Testing pricing of foreign payouts under domestic "
@@ -1322,6 +1440,75 @@ BOOST_AUTO_TEST_CASE(testLgm5fMoments) {
 
 } // testLgm5fMoments
 
+BOOST_AUTO_TEST_CASE(testLgm5fKeyedCovarianceCache) {
+
+    BOOST_TEST_MESSAGE("Testing the keyed covariance cache of the exact discretization in Ccy LGM 5F model...");
+
+    Lgm5fTestData d;
+
+    auto p = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(d.ccLgmExact->stateProcess());
+    BOOST_REQUIRE(p);
+
+    TimeGrid grid(10.0, 40);
+    std::vector<Matrix> v, s;
+    for (Size i = 0; i < grid.size() - 1; ++i) {
+        v.push_back(p->covariance(grid[i], p->initialValues(), grid.dt(i)));
+        s.push_back(p->stdDeviation(grid[i], p->initialValues(), grid.dt(i)));
+    }
+
+    // the first pass fills the cache, the second one reads from it, the cache is reset on a model update
+    p->enableKeyedCache(true);
+    for (Size pass = 0; pass < 3; ++pass) {
+        if (pass == 2)
+            d.ccLgmExact->update();
+        for (Size i = 0; i < grid.size() - 1; ++i) {
+            Matrix vc = p->covariance(grid[i], p->initialValues(), grid.dt(i));
+            Matrix sc = p->stdDeviation(grid[i], p->initialValues(), grid.dt(i));
+            BOOST_REQUIRE_EQUAL(vc.rows(), v[i].rows());
+            for (Size r = 0; r < vc.rows(); ++r) {
+                for (Size c = 0; c < vc.columns(); ++c) {
+                    BOOST_CHECK_SMALL(vc[r][c] - v[i][r][c], 1E-14);
+                    BOOST_CHECK_SMALL(sc[r][c] - s[i][r][c], 1E-14);
+                }
+            }
+        }
+    }
+    p->enableKeyedCache(false);
+}
+
+BOOST_AUTO_TEST_CASE(testLgm5fKeyedDiffusionCache) {
+
+    BOOST_TEST_MESSAGE("Testing the keyed diffusion cache of the Euler discretization in Ccy LGM 5F model...");
+
+    Lgm5fTestData d;
+
+    auto p = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(d.ccLgmEuler->stateProcess());
+    BOOST_REQUIRE(p);
+
+    TimeGrid grid(10.0, 40);
+    Size paths = 50;
+
+    auto simulate = [&p, &grid, paths]() {
+        std::vector<MultiPath> result;
+        MultiPathGeneratorMersenneTwister pg(p, grid, 42, false);
+        for (Size i = 0; i < paths; ++i)
+            result.push_back(pg.next().value);
+        return result;
+    };
+
+    auto uncached = simulate();
+    p->enableKeyedCache(true);
+    // the first run fills the cache, the second one reads from it
+    for (Size run = 0; run < 2; ++run) {
+        auto cached = simulate();
+        for (Size i = 0; i < paths; ++i)
+            for (Size k = 0; k < p->size(); ++k)
+                for (Size j = 0; j < grid.size(); ++j)
+                    BOOST_CHECK_EQUAL(cached[i][k][j], uncached[i][k][j]);
+    }
+    p->enableKeyedCache(false);
+}
+
 BOOST_AUTO_TEST_CASE(testLgmGsrEquivalence) {
 
     BOOST_TEST_MESSAGE("Testing equivalence of GSR and LGM models...");
@@ -1474,6 +1661,58 @@ BOOST_AUTO_TEST_CASE(testLgmMcWithShift) {
 
 } // testLgmMcWithShift
 
+BOOST_AUTO_TEST_CASE(testLgmBatchDiscountBonds) {
+    BOOST_TEST_MESSAGE("Testing LGM1F batch discount bonds against single evaluations...");
+
+    Handle<YieldTermStructure> yts(QuantLib::ext::make_shared<FlatForward>(0, NullCalendar(), 0.02, Actual365Fixed()));
+    Handle<YieldTermStructure> target(
+        QuantLib::ext::make_shared<FlatForward>(0, NullCalendar(), 0.03, Actual365Fixed()));
+    auto lgm = QuantLib::ext::make_shared<IrLgm1fConstantParametrization>(EURCurrency(), yts, 0.01, 0.01);
+    auto model = QuantLib::ext::make_shared<LinearGaussMarkovModel>(lgm);
+
+    std::vector<Time> times = {0.0, 0.25, 1.0, 5.0, 10.0, 30.0};
+    std::vector<Real> states = {-0.05, 0.0, 0.03};
+    Time t = 2.0;
+
+    ModelImpliedYieldTermStructure implied(model, Actual365Fixed(), true);
+    ModelImpliedYtsFwdFwdCorrected impliedFwdFwd(model, target, Actual365Fixed(), true);
+    ModelImpliedYtsSpotCorrected impliedSpot(model, target, Actual365Fixed(), true);
+    LgmImpliedYieldTermStructure lgmImplied(model, Actual365Fixed(), true);
+    LgmImpliedYtsFwdFwdCorrected lgmImpliedFwdFwd(model, target, Actual365Fixed(), true);
+
+    for (auto x : states) {
+        implied.move(t, Array(1, x));
+        impliedFwdFwd.move(t, Array(1, x));
+        impliedSpot.move(t, Array(1, x));
+        lgmImplied.move(t, x);
+        lgmImpliedFwdFwd.move(t, x);
+        std::vector<Real> d1 = implied.discounts(times), d2 = impliedFwdFwd.discounts(times),
+                          d3 = impliedSpot.discounts(times), d4 = lgmImplied.discounts(times),
+                          d5 = lgmImpliedFwdFwd.discounts(times);
+        for (Size i = 0; i < times.size(); ++i) {
+            BOOST_CHECK_CLOSE(d1[i], implied.discount(times[i]), 1e-10);
+            BOOST_CHECK_CLOSE(d2[i], impliedFwdFwd.discount(times[i]), 1e-10);
+            BOOST_CHECK_CLOSE(d3[i], impliedSpot.discount(times[i]), 1e-10);
+            BOOST_CHECK_CLOSE(d4[i], lgmImplied.discount(times[i]), 1e-10);
+            BOOST_CHECK_CLOSE(d5[i], lgmImpliedFwdFwd.discount(times[i]), 1e-10);
+        }
+    }
+
+    // vectorised across the states
+    LgmVectorised lgmVectorised(lgm);
+    RandomVariable x(states.size());
+    for (Size k = 0; k < states.size(); ++k)
+        x.set(k, states[k]);
+    std::vector<Time> T(times.size());
+    for (Size i = 0; i < times.size(); ++i)
+        T[i] = t + times[i];
+    auto bonds = lgmVectorised.discountBonds(t, T, x, target);
+    for (Size i = 0; i < times.size(); ++i) {
+        for (Size k = 0; k < states.size(); ++k)
+            BOOST_CHECK_CLOSE(bonds[i][k], model->discountBond(t, T[i], states[k], target), 1e-10);
+    }
+} // testLgmBatchDiscountBonds
+
 BOOST_AUTO_TEST_CASE(testIrFxCrCirppMartingaleProperty) {
 
     BOOST_TEST_MESSAGE("Testing martingale property in ir-fx-cr(lgm)-cf(cir++) model for "
@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <qle/math/differentialevolution_mt.hpp>
+
+#include <ql/math/optimization/constraint.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+using namespace boost::unit_test_framework;
+using std::vector;
+
+namespace {
+
+// the Rosenbrock function, its minimum 0 is attained at (1, ..., 1)
+class Rosenbrock : public CostFunction {
+public:
+    Real value(const Array& x) const override {
+        Real sum = 0.0;
+        for (Size i = 0; i + 1 < x.size(); ++i)
+            sum += 100.0 * (x[i + 1] - x[i] * x[i]) * (x[i + 1] - x[i] * x[i]) + (1.0 - x[i]) * (1.0 - x[i]);
+        return sum;
+    }
+    Array values(const Array& x) const override { return Array(1, value(x)); }
+};
+
+Array minimize(const Size threads, Real& cost, EndCriteria::Type& ecType) {
+    vector<QuantLib::ext::shared_ptr<CostFunction>> costFunctions;
+    for (Size i = 0; i < threads; ++i)
+        costFunctions.push_back(QuantLib::ext::make_shared<Rosenbrock>());
+    BoundaryConstraint constraint(-5.0, 5.0);
+    Problem_MT problem(costFunctions, constraint, Array(3, 0.0));
+    DifferentialEvolution_MT de(DifferentialEvolution::Configuration()
+                                    .withStrategy(DifferentialEvolution::BestMemberWithJitter)
+                                    .withPopulationMembers(60)
+                                    .withSeed(42));
+    ecType = de.minimize(problem, EndCriteria(2000, 100, 1E-12, 1E-12, 1E-12));
+    cost = problem.functionValue();
+    return problem.currentValue();
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(DifferentialEvolutionMtTest)
+
+BOOST_AUTO_TEST_CASE(testRosenbrock) {
+
+    BOOST_TEST_MESSAGE("Testing multithreaded differential evolution on the Rosenbrock function...");
+
+    Real cost1, cost4;
+    EndCriteria::Type ecType1, ecType4;
+    Array x1 = minimize(1, cost1, ecType1);
+    Array x4 = minimize(4, cost4, ecType4);
+
+    BOOST_TEST_MESSAGE("1 thread : x = " << x1 << ", cost = " << cost1 << ", end criteria = " << ecType1);
+    BOOST_TEST_MESSAGE("4 threads: x = " << x4 << ", cost = " << cost4 << ", end criteria = " << ecType4);
+
+    // the random numbers are drawn in the calling thread only, so the result does not depend on the threads
+    BOOST_CHECK_EQUAL(cost1, cost4);
+    BOOST_CHECK_EQUAL(ecType1, ecType4);
+    for (Size i = 0; i < x1.size(); ++i) {
+        BOOST_CHECK_EQUAL(x1[i], x4[i]);
+        BOOST_CHECK_SMALL(x1[i] - 1.0, 0.05);
+    }
+    BOOST_CHECK_SMALL(cost1, 1E-3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <qle/pricingengines/discountingswapenginemulticurve.hpp>
+#include <qle/termstructures/interpolateddiscountcurve.hpp>
+
+#include <ql/indexes/ibor/euribor.hpp>
+#include <ql/instruments/makevanillaswap.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/yield/discountcurve.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(DiscountingSwapEngineMultiCurveTest)
+
+BOOST_AUTO_TEST_CASE(testCurveArrayFastPath) {
+
+    BOOST_TEST_MESSAGE("Testing curve array fast path in DiscountingSwapEngineMultiCurve against generic curves...");
+
+    Date refDate(22, Aug, 2016);
+    Settings::instance().evaluationDate() = refDate;
+
+    std::vector<Date> dates;
+    for (auto const& p : {0 * Days, 6 * Months, 1 * Years, 2 * Years, 3 * Years, 5 * Years, 7 * Years, 10 * Years,
+                          15 * Years, 20 * Years})
+        dates.push_back(refDate + p);
+
+    // scenario sim market style curves on quotes vs. curves of a different type rebuilt per scenario
+
+    std::vector<QuantLib::ext::shared_ptr<SimpleQuote>> discountQuotes, forwardQuotes;
+    std::vector<Handle<Quote>> discountHandles, forwardHandles;
+    for (Size i = 0; i < dates.size(); ++i) {
+        Real t = Actual365Fixed().yearFraction(refDate, dates[i]);
+        discountQuotes.push_back(QuantLib::ext::make_shared<SimpleQuote>(std::exp(-0.02 * t)));
+        forwardQuotes.push_back(QuantLib::ext::make_shared<SimpleQuote>(std::exp(-0.03 * t)));
+        discountHandles.push_back(Handle<Quote>(discountQuotes.back()));
+        forwardHandles.push_back(Handle<Quote>(forwardQuotes.back()));
+    }
+
+    Handle<YieldTermStructure> discountCurve(QuantLib::ext::make_shared<QuantExt::InterpolatedDiscountCurve>(
+        dates, discountHandles, 0, TARGET(), Actual365Fixed()));
+    Handle<YieldTermStructure> forwardCurve(QuantLib::ext::make_shared<QuantExt::InterpolatedDiscountCurve>(
+        dates, forwardHandles, 0, TARGET(), Actual365Fixed()));
+    RelinkableHandle<YieldTermStructure> discountCurveRef, forwardCurveRef;
+
+    auto relinkReferenceCurves = [&]() {
+        std::vector<DiscountFactor> dfDiscount, dfForward;
+        for (Size i = 0; i < dates.size(); ++i) {
+            dfDiscount.push_back(discountQuotes[i]->value());
+            dfForward.push_back(forwardQuotes[i]->value());
+        }
+        discountCurveRef.linkTo(QuantLib::ext::make_shared<DiscountCurve>(dates, dfDiscount, Actual365Fixed()));
+        forwardCurveRef.linkTo(QuantLib::ext::make_shared<DiscountCurve>(dates, dfForward, Actual365Fixed()));
+    };
+    relinkReferenceCurves();
+
+    auto engine = QuantLib::ext::make_shared<DiscountingSwapEngineMultiCurve>(discountCurve, false);
+    auto engineRef = QuantLib::ext::make_shared<DiscountingSwapEngineMultiCurve>(discountCurveRef, false);
+
+    std::vector<QuantLib::ext::shared_ptr<VanillaSwap>> swaps, swapsRef;
+    for (auto const& fwdStart : {0 * Days, 1 * Years}) {
+        for (auto const& spread : {0.0, 0.001}) {
+            swaps.push_back(MakeVanillaSwap(13 * Years, QuantLib::ext::make_shared<Euribor>(6 * Months, forwardCurve),
+                                            0.03, fwdStart)
+                                .withNominal(10.0)
+                                .withFloatingLegSpread(spread)
+                                .withPricingEngine(engine));
+            swapsRef.push_back(MakeVanillaSwap(13 * Years,
+                                               QuantLib::ext::make_shared<Euribor>(6 * Months, forwardCurveRef), 0.03,
+                                               fwdStart)
+                                   .withNominal(10.0)
+                                   .withFloatingLegSpread(spread)
+                                   .withPricingEngine(engineRef));
+        }
+    }
+
+    // reprice on a few scenarios, from the second scenario on the cached pillar weights are used
+
+    const Real tol = 1E-10;
+    for (Size scenario = 0; scenario < 4; ++scenario) {
+        for (Size i = 0; i < dates.size(); ++i) {
+            Real t = Actual365Fixed().yearFraction(refDate, dates[i]);
+            discountQuotes[i]->setValue(std::exp(-(0.02 + 0.001 * scenario * (i % 3)) * t));
+            forwardQuotes[i]->setValue(std::exp(-(0.03 - 0.0005 * scenario * (i % 2)) * t));
+        }
+        relinkReferenceCurves();
+        for (Size k = 0; k < swaps.size(); ++k) {
+            BOOST_TEST_MESSAGE("scenario " << scenario << ", swap " << k << ": npv = " << swaps[k]->NPV()
+                                           << ", reference = " << swapsRef[k]->NPV());
+            BOOST_CHECK_SMALL(swaps[k]->NPV() - swapsRef[k]->NPV(), tol);
+            BOOST_CHECK_SMALL(swaps[k]->legBPS(0) - swapsRef[k]->legBPS(0), tol);
+            BOOST_CHECK_SMALL(swaps[k]->legBPS(1) - swapsRef[k]->legBPS(1), tol);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
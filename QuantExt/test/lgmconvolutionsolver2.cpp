@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+
+#include <qle/models/irlgm1fconstantparametrization.hpp>
+#include <qle/models/lgm.hpp>
+#include <qle/models/lgmconvolutionsolver2.hpp>
+
+#include <ql/currencies/europe.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/nullcalendar.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(LgmConvolutionSolver2Test)
+
+BOOST_AUTO_TEST_CASE(testRollbackWeightsCache) {
+
+    BOOST_TEST_MESSAGE("Testing LgmConvolutionSolver2 rollback with cached convolution weights...");
+
+    Handle<YieldTermStructure> yts(QuantLib::ext::make_shared<FlatForward>(0, NullCalendar(), 0.02, Actual365Fixed()));
+    auto model = QuantLib::ext::make_shared<LinearGaussMarkovModel>(
+        QuantLib::ext::make_shared<IrLgm1fConstantParametrization>(EURCurrency(), yts, 0.01, 0.01));
+
+    LgmConvolutionSolver2 solver(model, 7.0, 16, 7.0, 32);
+
+    Real t0 = 2.0, t1 = 5.0;
+    RandomVariable x1 = solver.stateGrid(t1), x0 = solver.stateGrid(t0);
+
+    // the state is a martingale, the rollback of the state should reproduce the state in the interior of the grid
+
+    RandomVariable v0 = solver.rollback(x1, t1, t0);
+    for (Size k = solver.gridSize() / 4; k < 3 * solver.gridSize() / 4; ++k)
+        BOOST_CHECK_SMALL(v0[k] - x0[k], 1E-6);
+
+    BOOST_CHECK_SMALL(solver.rollback(x1, t1, 0.0).at(0), 1E-6);
+    BOOST_CHECK(solver.rollback(x1, t1, 0.0).deterministic());
+
+    // repeated rollbacks use the cached weights and must give identical results
+
+    BOOST_CHECK(close_enough_all(solver.rollback(x1, t1, t0), v0));
+
+    // after a change of the model parameters the weights must be recomputed
+
+    Array params = model->params();
+    params[0] *= 1.5;
+    model->setParams(params);
+
+    LgmConvolutionSolver2 freshSolver(model, 7.0, 16, 7.0, 32);
+    RandomVariable y1 = solver.stateGrid(t1) * solver.stateGrid(t1);
+    RandomVariable w0 = solver.rollback(y1, t1, t0);
+    RandomVariable w0Fresh = freshSolver.rollback(y1, t1, t0);
+    for (Size k = 0; k < solver.gridSize(); ++k)
+        BOOST_CHECK_CLOSE(w0[k], w0Fresh[k], 1E-10);
+    BOOST_CHECK_CLOSE(solver.rollback(y1, t1, 0.0).at(0), freshSolver.rollback(y1, t1, 0.0).at(0), 1E-10);
+
+    // the rolled back second moment is zeta(t1) - zeta(t0) + x0^2
+    RandomVariable x0New = solver.stateGrid(t0);
+    Real dZeta = model->parametrization()->zeta(t1) - model->parametrization()->zeta(t0);
+    Size mid = solver.gridSize() / 2;
+    BOOST_CHECK_CLOSE(w0[mid], dZeta + x0New[mid] * x0New[mid], 1E-2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+
+#include <qle/models/irlgm1fconstantparametrization.hpp>
+#include <qle/models/lgm.hpp>
+#include <qle/models/lgmconvolutionsolver2.hpp>
+#include <qle/models/lgmfftsolver.hpp>
+
+#include <ql/currencies/europe.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/nullcalendar.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(LgmFftSolverTest)
+
+BOOST_AUTO_TEST_CASE(testRollback) {
+
+    BOOST_TEST_MESSAGE("Testing LgmFftSolver rollback against LgmConvolutionSolver2...");
+
+    Handle<YieldTermStructure> yts(QuantLib::ext::make_shared<FlatForward>(0, NullCalendar(), 0.02, Actual365Fixed()));
+    auto model = QuantLib::ext::make_shared<LinearGaussMarkovModel>(
+        QuantLib::ext::make_shared<IrLgm1fConstantParametrization>(EURCurrency(), yts, 0.01, 0.01));
+
+    LgmFftSolver solver(model, 7.0, 7.0, 32);
+    LgmConvolutionSolver2 refSolver(model, 7.0, 32, 7.0, 32);
+
+    BOOST_REQUIRE_EQUAL(solver.gridSize(), refSolver.gridSize());
+
+    Real t0 = 2.0, t1 = 5.0;
+    RandomVariable x1 = solver.stateGrid(t1), x0 = solver.stateGrid(t0);
+    BOOST_CHECK(close_enough_all(x1, refSolver.stateGrid(t1)));
+
+    // the state is a martingale, the second moment grows by zeta(t1) - zeta(t0)
+
+    RandomVariable v0 = solver.rollback(x1, t1, t0);
+    RandomVariable w0 = solver.rollback(x1 * x1, t1, t0);
+    Real dZeta = model->parametrization()->zeta(t1) - model->parametrization()->zeta(t0);
+    for (Size k = solver.gridSize() / 4; k < 3 * solver.gridSize() / 4; ++k) {
+        BOOST_CHECK_SMALL(v0[k] - x0[k], 1E-6);
+        BOOST_CHECK_CLOSE(w0[k], dZeta + x0[k] * x0[k], 1E-1);
+    }
+
+    // an option type payoff should match the direct convolution
+
+    RandomVariable payoff = max(x1 - RandomVariable(x1.size(), 0.01), RandomVariable(x1.size(), 0.0));
+    RandomVariable p0 = solver.rollback(payoff, t1, t0), p0Ref = refSolver.rollback(payoff, t1, t0);
+    for (Size k = solver.gridSize() / 4; k < 3 * solver.gridSize() / 4; ++k)
+        BOOST_CHECK_SMALL(p0[k] - p0Ref[k], 1E-5);
+
+    // rollback to zero
+
+    RandomVariable p = solver.rollback(p0, t0, 0.0);
+    BOOST_CHECK(p.deterministic());
+    BOOST_CHECK_SMALL(p.at(0) - refSolver.rollback(p0Ref, t0, 0.0).at(0), 1E-5);
+    BOOST_CHECK_SMALL(solver.rollback(x1, t1, 0.0).at(0), 1E-6);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
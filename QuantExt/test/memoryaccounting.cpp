@@ -0,0 +1,130 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <qle/utilities/memoryaccounting.hpp>
+
+#include <ql/errors.hpp>
+
+#include <limits>
+#include <utility>
+
+using namespace QuantExt;
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(MemoryAccountingTest)
+
+BOOST_AUTO_TEST_CASE(testAccountedMemory) {
+    BOOST_TEST_MESSAGE("Testing current and peak bytes of a memory account");
+
+    bool previousEnabled = MemoryAccounting::instance().enabled();
+    MemoryAccounting::instance().enable(true);
+    MemoryAccount& account = MemoryAccounting::instance().account("MemoryAccountingTest");
+    BOOST_CHECK_EQUAL(&account, &MemoryAccounting::instance().account("MemoryAccountingTest"));
+    BOOST_REQUIRE_EQUAL(account.current(), 0);
+    std::size_t total = MemoryAccounting::instance().current();
+
+    {
+        AccountedMemory m1(account, 1000);
+        AccountedMemory m2(m1);
+        BOOST_CHECK_EQUAL(account.current(), 2000);
+        BOOST_CHECK_EQUAL(MemoryAccounting::instance().current(), total + 2000);
+        m2.resize(500);
+        BOOST_CHECK_EQUAL(account.current(), 1500);
+        BOOST_CHECK_EQUAL(account.peak(), 2000);
+        AccountedMemory m3(std::move(m1));
+        BOOST_CHECK_EQUAL(m1.bytes(), 0);
+        BOOST_CHECK_EQUAL(m3.bytes(), 1000);
+        BOOST_CHECK_EQUAL(account.current(), 1500);
+        account.resetPeak();
+        BOOST_CHECK_EQUAL(account.peak(), 1500);
+    }
+
+    BOOST_CHECK_EQUAL(account.current(), 0);
+    BOOST_CHECK_EQUAL(MemoryAccounting::instance().current(), total);
+    MemoryAccounting::instance().enable(previousEnabled);
+}
+
+BOOST_AUTO_TEST_CASE(testDisabledAccounting) {
+    BOOST_TEST_MESSAGE("Testing that switched off memory accounting does not update the accounts");
+
+    MemoryAccounting& accounting = MemoryAccounting::instance();
+    MemoryAccount& account = accounting.account("MemoryAccountingTest");
+    bool previousEnabled = accounting.enabled();
+    std::size_t previousBudget = accounting.budget();
+    accounting.enable(false);
+    accounting.setBudget(accounting.current() + 1000);
+    BOOST_REQUIRE_EQUAL(account.current(), 0);
+
+    {
+        // neither accounted nor subject to the budget
+        AccountedMemory m(account, 2000);
+        BOOST_CHECK_EQUAL(m.bytes(), 2000);
+        BOOST_CHECK_EQUAL(account.current(), 0);
+        BOOST_CHECK_EQUAL(accounting.available(), std::numeric_limits<std::size_t>::max());
+
+        // the requested bytes are accounted for on the first resize after switching the accounting on
+        accounting.setBudget(previousBudget);
+        accounting.enable(true);
+        m.resize(1500);
+        BOOST_CHECK_EQUAL(account.current(), 1500);
+        AccountedMemory m2(m);
+        BOOST_CHECK_EQUAL(account.current(), 3000);
+
+        // and released on the first resize after switching it off
+        accounting.enable(false);
+        m.resize(1000);
+        BOOST_CHECK_EQUAL(m.bytes(), 1000);
+        BOOST_CHECK_EQUAL(account.current(), 1500);
+    }
+
+    BOOST_CHECK_EQUAL(account.current(), 0);
+    accounting.enable(previousEnabled);
+}
+
+BOOST_AUTO_TEST_CASE(testBudget) {
+    BOOST_TEST_MESSAGE("Testing memory budget");
+
+    MemoryAccounting& accounting = MemoryAccounting::instance();
+    MemoryAccount& account = accounting.account("MemoryAccountingTest");
+    bool previousEnabled = accounting.enabled();
+    std::size_t previousBudget = accounting.budget();
+    accounting.enable(true);
+    accounting.setBudget(accounting.current() + 1000);
+    BOOST_CHECK_EQUAL(accounting.available(), 1000);
+
+    AccountedMemory m(account, 800);
+    BOOST_CHECK_EQUAL(accounting.available(), 200);
+    BOOST_CHECK_THROW(m.resize(1200), QuantLib::Error);
+    BOOST_CHECK_EQUAL(m.bytes(), 800);
+    BOOST_CHECK_EQUAL(account.current(), 800);
+    BOOST_CHECK_THROW(AccountedMemory(account, 300), QuantLib::Error);
+    BOOST_CHECK_NO_THROW(m.resize(1000));
+    BOOST_CHECK_EQUAL(accounting.available(), 0);
+
+    accounting.setBudget(previousBudget);
+    accounting.enable(previousEnabled);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
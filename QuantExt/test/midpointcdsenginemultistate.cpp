@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <qle/instruments/makecds.hpp>
+#include <qle/pricingengines/midpointcdsenginemultistate.hpp>
+
+#include <ql/pricingengines/credit/midpointcdsengine.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/credit/flathazardrate.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(MidPointCdsEngineMultiStateTest)
+
+BOOST_AUTO_TEST_CASE(testStateNpvs) {
+
+    BOOST_TEST_MESSAGE("Testing state npvs of MidPointCdsEngineMultiState against MidPointCdsEngine...");
+
+    Date refDate(22, Aug, 2016);
+    Settings::instance().evaluationDate() = refDate;
+
+    Handle<YieldTermStructure> discountCurve(QuantLib::ext::make_shared<FlatForward>(refDate, 0.02, Actual365Fixed()));
+
+    std::vector<Handle<DefaultProbabilityTermStructure>> defaultCurves;
+    std::vector<Handle<Quote>> recoveryRates;
+    for (auto const& h : {0.002, 0.005, 0.01, 0.02, 0.05, 0.1}) {
+        defaultCurves.push_back(Handle<DefaultProbabilityTermStructure>(
+            QuantLib::ext::make_shared<FlatHazardRate>(refDate, h, Actual365Fixed())));
+        recoveryRates.push_back(Handle<Quote>(QuantLib::ext::make_shared<SimpleQuote>(0.4 - h)));
+    }
+
+    const Size mainResultState = 2;
+    auto engine = QuantLib::ext::make_shared<MidPointCdsEngineMultiState>(defaultCurves, recoveryRates, discountCurve,
+                                                                          mainResultState);
+
+    for (auto const& side : {Protection::Buyer, Protection::Seller}) {
+        QuantLib::ext::shared_ptr<CreditDefaultSwap> cds =
+            MakeCreditDefaultSwap(5 * Years, 0.01).withSide(side).withNominal(1.0E6).withUpfrontRate(0.01);
+        cds->setPricingEngine(engine);
+        Real npv = cds->NPV();
+        auto stateNpv = cds->result<std::vector<Real>>("stateNpv");
+        BOOST_REQUIRE_EQUAL(stateNpv.size(), defaultCurves.size() + 1);
+        BOOST_CHECK_CLOSE(npv, stateNpv[mainResultState], 1E-10);
+        for (Size i = 0; i < defaultCurves.size(); ++i) {
+            cds->setPricingEngine(QuantLib::ext::make_shared<MidPointCdsEngine>(
+                defaultCurves[i], recoveryRates[i]->value(), discountCurve));
+            BOOST_TEST_MESSAGE("side " << side << ", state " << i << ": npv = " << cds->NPV()
+                                       << ", state npv = " << stateNpv[i]);
+            BOOST_CHECK_SMALL(cds->NPV() - stateNpv[i], 1E-6);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -24,6 +24,8 @@
 
 #include <qle/models/crossassetmodel.hpp>
 #include <qle/models/fxbsconstantparametrization.hpp>
+#include <qle/models/lgmconvolutionsolver2.hpp>
+#include <qle/models/lgmfftsolver.hpp>
 #include <qle/pricingengines/analyticcclgmfxoptionengine.hpp>
 #include <qle/pricingengines/numericlgmmultilegoptionengine.hpp>
 
@@ -198,6 +200,214 @@ BOOST_AUTO_TEST_CASE(testFxOption) {
 
 } // testFxOption
 
+BOOST_FIXTURE_TEST_CASE(testBatchedBermudanSwaptions, BermudanTestData) {
+
+    BOOST_TEST_MESSAGE("Testing batched backward induction of bermudan swaptions vs single numeric lgm engine");
+
+    auto lgm_p = QuantLib::ext::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(EURCurrency(), yts, stepTimes_a, sigmas_a,
+                                                                              stepTimes_a, kappas_a);
+    auto lgm = QuantLib::ext::make_shared<LinearGaussMarkovModel>(lgm_p);
+
+    // options with different strikes, directions and exercise schedules
+
+    std::vector<QuantLib::ext::shared_ptr<MultiLegOption>> options;
+    auto shortExercise = QuantLib::ext::make_shared<BermudanExercise>(
+        std::vector<Date>(exerciseDates.begin() + 3, exerciseDates.end()), false);
+    for (auto const& strike : {0.01, 0.02, 0.03}) {
+        for (auto const& type : {VanillaSwap::Payer, VanillaSwap::Receiver}) {
+            VanillaSwap swap(type, 1.0, fixedSchedule, strike, Thirty360(Thirty360::BondBasis), floatingSchedule,
+                             euribor6m, 0.0, Actual360());
+            for (auto const& ex : {exercise, QuantLib::ext::static_pointer_cast<Exercise>(shortExercise)}) {
+                options.push_back(QuantLib::ext::make_shared<MultiLegOption>(
+                    std::vector<Leg>{swap.leg(0), swap.leg(1)}, std::vector<bool>{type == VanillaSwap::Payer,
+                                                                                  type == VanillaSwap::Receiver},
+                    std::vector<Currency>{EURCurrency(), EURCurrency()}, ex));
+            }
+        }
+    }
+
+    for (auto const& solver : std::vector<QuantLib::ext::shared_ptr<LgmBackwardSolver>>{
+             QuantLib::ext::make_shared<LgmConvolutionSolver2>(lgm, 7.0, 16, 7.0, 32),
+             QuantLib::ext::make_shared<LgmFftSolver>(lgm, 7.0, 7.0, 32)}) {
+
+        NumericLgmMultiLegOptionBatchEngine batchEngine(solver, yts);
+        batchEngine.calculate(options);
+        BOOST_REQUIRE_EQUAL(batchEngine.npvs().size(), options.size());
+
+        auto engine = QuantLib::ext::make_shared<NumericLgmMultiLegOptionEngine>(solver, yts);
+        for (Size i = 0; i < options.size(); ++i) {
+            options[i]->setPricingEngine(engine);
+            BOOST_TEST_MESSAGE("option #" << i << ": npv single = " << options[i]->NPV()
+                                          << ", batch = " << batchEngine.npvs()[i]);
+            // the batch runs on the joint time grid, which adds steps for the options with the short exercise
+            BOOST_CHECK_SMALL(options[i]->NPV() - batchEngine.npvs()[i], 1.0E-5);
+            BOOST_CHECK_SMALL(options[i]->underlyingNpv() - batchEngine.underlyingNpvs()[i], 1.0E-5);
+        }
+    }
+
+} // testBatchedBermudanSwaptions
+
+BOOST_FIXTURE_TEST_CASE(testSharedCalibrationPaths, BermudanTestData) {
+
+    BOOST_TEST_MESSAGE("Testing mc multi leg option engine with shared calibration paths");
+
+    auto lgm_p = QuantLib::ext::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(EURCurrency(), yts, stepTimes_a, sigmas_a,
+                                                                              stepTimes_a, kappas_a);
+    auto cam = QuantLib::ext::make_shared<CrossAssetModel>(std::vector<QuantLib::ext::shared_ptr<Parametrization>>{lgm_p});
+    auto lgm = QuantLib::ext::make_shared<LinearGaussMarkovModel>(lgm_p);
+
+    std::vector<QuantLib::ext::shared_ptr<MultiLegOption>> options;
+    for (auto const& payer : {true, false}) {
+        options.push_back(QuantLib::ext::make_shared<MultiLegOption>(
+            std::vector<Leg>{underlying->leg(0), underlying->leg(1)}, std::vector<bool>{payer, !payer},
+            std::vector<Currency>{EURCurrency(), EURCurrency()}, exercise));
+    }
+
+    // the engine's model is the external model itself here, i.e. the external model indices are the identity
+
+    auto mcEngine = QuantLib::ext::make_shared<McMultiLegOptionEngine>(
+        Handle<CrossAssetModel>(cam), SobolBrownianBridge, SobolBrownianBridge, 25000, 0, 42, 42, 4,
+        LsmBasisSystem::Monomial, SobolBrownianGenerator::Steps, SobolRsg::JoeKuoD7,
+        std::vector<Handle<YieldTermStructure>>(), std::vector<Date>(), std::vector<Size>{0});
+    auto numericEngine = QuantLib::ext::make_shared<NumericLgmMultiLegOptionEngine>(lgm, 7.0, 16, 7.0, 32, yts);
+
+    McSharedPaths::instance().add(cam);
+
+    // in the collection phase the engine only registers its simulation times
+
+    McSharedPaths::instance().setCollecting(cam, true);
+    for (auto const& o : options) {
+        o->setPricingEngine(mcEngine);
+        BOOST_CHECK_THROW(o->NPV(), McSharedPaths::TimesCollected);
+    }
+    McSharedPaths::instance().setCollecting(cam, false);
+
+    McSharedPaths::Key key(SobolBrownianBridge, 25000, 42, SobolBrownianGenerator::Steps, SobolRsg::JoeKuoD7);
+    auto paths = McSharedPaths::instance().paths(cam, key, {});
+    BOOST_REQUIRE(paths != nullptr);
+
+    for (auto const& o : options) {
+        o->recalculate();
+        Real npvMc = o->NPV();
+        o->setPricingEngine(numericEngine);
+        Real npvNumeric = o->NPV();
+        BOOST_TEST_MESSAGE("npv (shared paths) = " << npvMc << ", npv (numeric lgm) = " << npvNumeric);
+        BOOST_CHECK_SMALL(std::abs(npvMc - npvNumeric), 2.0E-4);
+    }
+
+    // the paths were generated once and reused by both options
+
+    BOOST_CHECK(McSharedPaths::instance().paths(cam, key, {}) == paths);
+
+    McSharedPaths::instance().remove(cam);
+    BOOST_CHECK(McSharedPaths::instance().paths(cam, key, {}) == nullptr);
+
+} // testSharedCalibrationPaths
+
+BOOST_FIXTURE_TEST_CASE(testRegressionCache, BermudanTestData) {
+
+    BOOST_TEST_MESSAGE("Testing the regression cache of the mc multi leg option engine");
+
+    // a hit requires the full key data to match, not only the hash
+
+    const Size n = 100;
+    RandomVariable x1(n), x2(n);
+    Filter filter(n, true);
+    for (Size i = 0; i < n; ++i) {
+        x1.set(i, std::sin(static_cast<double>(i)));
+        x2.set(i, std::cos(static_cast<double>(i)));
+        filter.set(i, i % 3 != 0);
+    }
+    std::vector<const RandomVariable*> regressor = {&x1, &x2};
+    McRegressionCache cache;
+    std::size_t hash = McRegressionCache::hash(regressor, filter, 2, LsmBasisSystem::Monomial, Null<Real>(), 10);
+    auto entry = QuantLib::ext::make_shared<McRegressionCache::Entry>();
+    entry->key = McRegressionCache::Key{2, LsmBasisSystem::Monomial, Null<Real>(), 10, {x1, x2}, filter};
+    cache.add(hash, entry);
+    BOOST_CHECK(cache.get(hash, regressor, filter, 2, LsmBasisSystem::Monomial, Null<Real>(), 10) == entry);
+    RandomVariable y1 = x1;
+    y1.set(n - 1, 0.5);
+    std::vector<const RandomVariable*> otherRegressor = {&y1, &x2};
+    BOOST_CHECK(cache.get(hash, otherRegressor, filter, 2, LsmBasisSystem::Monomial, Null<Real>(), 10) == nullptr);
+    BOOST_CHECK(cache.get(hash, regressor, Filter(), 2, LsmBasisSystem::Monomial, Null<Real>(), 10) == nullptr);
+    BOOST_CHECK(cache.get(hash, regressor, filter, 3, LsmBasisSystem::Monomial, Null<Real>(), 10) == nullptr);
+    BOOST_CHECK(cache.get(hash, regressor, filter, 2, LsmBasisSystem::Monomial, 0.9, 10) == nullptr);
+
+    // the engine uses the cache of its external model only while the model is registered
+
+    auto lgm_p = QuantLib::ext::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(EURCurrency(), yts, stepTimes_a,
+                                                                                  sigmas_a, stepTimes_a, kappas_a);
+    auto cam =
+        QuantLib::ext::make_shared<CrossAssetModel>(std::vector<QuantLib::ext::shared_ptr<Parametrization>>{lgm_p});
+    auto option = QuantLib::ext::make_shared<MultiLegOption>(
+        std::vector<Leg>{underlying->leg(0), underlying->leg(1)}, std::vector<bool>{true, false},
+        std::vector<Currency>{EURCurrency(), EURCurrency()}, exercise);
+    option->setPricingEngine(QuantLib::ext::make_shared<McMultiLegOptionEngine>(
+        Handle<CrossAssetModel>(cam), SobolBrownianBridge, SobolBrownianBridge, 25000, 0, 42, 42, 4,
+        LsmBasisSystem::Monomial, SobolBrownianGenerator::Steps, SobolRsg::JoeKuoD7,
+        std::vector<Handle<YieldTermStructure>>(), std::vector<Date>(), std::vector<Size>{0}));
+
+    Real npvUncached = option->NPV();
+    {
+        McSharedPaths::Scope scope(cam);
+        auto regressionCache = McSharedPaths::instance().regressionCache(cam);
+        BOOST_REQUIRE(regressionCache != nullptr);
+        option->recalculate();
+        Real npvCached = option->NPV();
+        Size cacheSize = regressionCache->size();
+        BOOST_CHECK(cacheSize > 0);
+        BOOST_CHECK_CLOSE(npvCached, npvUncached, 1.0E-6);
+        // a second calculation on the same paths hits the cache for all regressions
+        option->recalculate();
+        BOOST_CHECK_EQUAL(option->NPV(), npvCached);
+        BOOST_CHECK_EQUAL(regressionCache->size(), cacheSize);
+    }
+    BOOST_CHECK(McSharedPaths::instance().regressionCache(cam) == nullptr);
+
+} // testRegressionCache
+
+BOOST_FIXTURE_TEST_CASE(testRegressionBasisControl, BermudanTestData) {
+
+    BOOST_TEST_MESSAGE("Testing mc multi leg option engine with regressor selection and capped basis size");
+
+    auto multiLegOption = QuantLib::ext::make_shared<MultiLegOption>(
+        std::vector<Leg>{underlying->leg(0), underlying->leg(1)}, std::vector<bool>{true, false},
+        std::vector<Currency>{EURCurrency(), EURCurrency()}, exercise);
+
+    auto lgm_p = QuantLib::ext::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(EURCurrency(), yts, stepTimes_a, sigmas_a,
+                                                                              stepTimes_a, kappas_a);
+    auto xasset = Handle<CrossAssetModel>(
+        QuantLib::ext::make_shared<CrossAssetModel>(std::vector<QuantLib::ext::shared_ptr<Parametrization>>{lgm_p}));
+    auto lgm = QuantLib::ext::make_shared<LinearGaussMarkovModel>(lgm_p);
+
+    swaption->setPricingEngine(QuantLib::ext::make_shared<NumericLgmSwaptionEngine>(lgm, 7.0, 16, 7.0, 32));
+    Real npv0 = swaption->NPV();
+
+    // without selection and cap we use the full monomial basis of order 4 on the one dimensional state
+
+    multiLegOption->setPricingEngine(QuantLib::ext::make_shared<McMultiLegOptionEngine>(
+        xasset, SobolBrownianBridge, SobolBrownianBridge, 25000, 0, 42, 42, 4, LsmBasisSystem::Monomial));
+    Real npv1 = multiLegOption->NPV();
+    BOOST_CHECK_EQUAL(multiLegOption->result<Size>("regressorSize"), 1);
+    BOOST_CHECK_EQUAL(multiLegOption->result<Size>("regressionBasisSize"), 5);
+
+    // with a cap of 3 basis functions the order is reduced to 2, the significant state is kept
+
+    multiLegOption->setPricingEngine(QuantLib::ext::make_shared<McMultiLegOptionEngine>(
+        xasset, SobolBrownianBridge, SobolBrownianBridge, 25000, 0, 42, 42, 4, LsmBasisSystem::Monomial,
+        SobolBrownianGenerator::Steps, SobolRsg::JoeKuoD7, std::vector<Handle<YieldTermStructure>>(),
+        std::vector<Date>(), std::vector<Size>(), true, McMultiLegBaseEngine::RegressorModel::Simple, Null<Real>(), 3,
+        0.05));
+    Real npv2 = multiLegOption->NPV();
+    BOOST_CHECK_EQUAL(multiLegOption->result<Size>("regressorSize"), 1);
+    BOOST_CHECK_EQUAL(multiLegOption->result<Size>("regressionBasisSize"), 3);
+
+    BOOST_TEST_MESSAGE("npv numeric = " << npv0 << ", mc full basis = " << npv1 << ", mc capped basis = " << npv2);
+    BOOST_CHECK_SMALL(std::abs(npv0 - npv1), 1.0E-4);
+    BOOST_CHECK_SMALL(std::abs(npv0 - npv2), 5.0E-4);
+
+} // testRegressionBasisControl
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,89 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+
+#include <qle/methods/multipathgeneratorbase.hpp>
+
+#include <ql/math/matrix.hpp>
+#include <ql/processes/geometricbrownianprocess.hpp>
+#include <ql/processes/stochasticprocessarray.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+namespace {
+
+void checkSkipTo(const SequenceType s, const QuantLib::ext::shared_ptr<StochasticProcess>& process) {
+    TimeGrid grid(5.0, 10);
+    constexpr Size nPaths = 17;
+
+    // sequential reference paths
+    auto ref = makeMultiPathGenerator(s, process, grid, 42);
+    std::vector<MultiPath> paths;
+    for (Size i = 0; i < nPaths; ++i)
+        paths.push_back(ref->next().value);
+
+    // generate disjoint ranges of paths with separate generators and compare to the reference paths
+    for (Size start : {0, 1, 2, 5, 10, 16}) {
+        auto gen = makeMultiPathGenerator(s, process, grid, 42);
+        gen->skipTo(start);
+        for (Size i = start; i < std::min(start + 3, nPaths); ++i) {
+            const MultiPath& p = gen->next().value;
+            for (Size j = 0; j < p.assetNumber(); ++j) {
+                for (Size k = 0; k < p.pathSize(); ++k) {
+                    if (p[j][k] != paths[i][j][k]) {
+                        BOOST_ERROR("sequence type " << s << ", skipTo(" << start << "): path " << i << " asset " << j
+                                                     << " time step " << k << " is " << p[j][k] << ", expected "
+                                                     << paths[i][j][k]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(MultiPathGeneratorTest)
+
+BOOST_AUTO_TEST_CASE(testSkipTo) {
+
+    BOOST_TEST_MESSAGE("Testing multi path generator skip-ahead...");
+
+    auto p1 = QuantLib::ext::make_shared<GeometricBrownianMotionProcess>(100.0, 0.01, 0.20);
+    auto p2 = QuantLib::ext::make_shared<GeometricBrownianMotionProcess>(50.0, 0.02, 0.30);
+    Matrix corr(2, 2, 1.0);
+    corr[0][1] = corr[1][0] = 0.5;
+    auto p12 = QuantLib::ext::make_shared<StochasticProcessArray>(
+        std::vector<QuantLib::ext::shared_ptr<StochasticProcess1D>>{p1, p2}, corr);
+
+    for (auto s : {MersenneTwister, MersenneTwisterAntithetic, Sobol, Burley2020Sobol, SobolBrownianBridge,
+                   Burley2020SobolBrownianBridge}) {
+        checkSkipTo(s, p1);
+        checkSkipTo(s, p12);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+
+#include "toplevelfixture.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <qle/math/nadarayawatson.hpp>
+
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/kernelfunctions.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(NadarayaWatsonTest)
+
+BOOST_AUTO_TEST_CASE(testBinnedAgainstExact) {
+    BOOST_TEST_MESSAGE("Testing binned Nadaraya Watson regression against the exact estimator");
+
+    // heteroscedastic sample y = sin(x) + sqrt(1 + x^2) z / 4 with standard normal x and z
+    MersenneTwisterUniformRng rng(42);
+    InverseCumulativeNormal icn;
+    std::vector<Real> x(20000), y(x.size());
+    for (auto& v : x)
+        v = icn(rng.nextReal());
+    std::sort(x.begin(), x.end());
+    for (Size i = 0; i < x.size(); ++i)
+        y[i] = std::sin(x[i]) + 0.25 * std::sqrt(1.0 + x[i] * x[i]) * icn(rng.nextReal());
+
+    Real bandWidth = 0.25;
+    NadarayaWatson exact(x.begin(), x.end(), y.begin(), GaussianKernel(0.0, bandWidth));
+    BinnedNadarayaWatson binned(x.begin(), x.end(), y.begin(), GaussianKernel(0.0, bandWidth), bandWidth);
+
+    // ten bins per band width over the sample range
+    Real range = x.back() - x.front();
+    BOOST_CHECK_EQUAL(binned.bins(), static_cast<Size>(std::floor(range / (bandWidth / 10.0))) + 2);
+
+    for (Real p = -2.5; p <= 2.5; p += 0.25) {
+        Real e = exact(p), b = binned(p);
+        Real eStd = exact.standardDeviation(p), bStd = binned.standardDeviation(p);
+        BOOST_TEST_MESSAGE("x = " << p << ": value " << b << " (exact " << e << "), standard deviation " << bStd
+                                  << " (exact " << eStd << ")");
+        BOOST_CHECK_SMALL(b - e, 1E-3);
+        BOOST_CHECK_SMALL((bStd - eStd) / eStd, 5E-3);
+    }
+
+    // far outside the sample range the binned estimator vanishes
+    BOOST_CHECK_EQUAL(binned(20.0), 0.0);
+    BOOST_CHECK_EQUAL(binned.standardDeviation(-20.0), 0.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
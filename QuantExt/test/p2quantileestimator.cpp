@@ -0,0 +1,74 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <qle/math/p2quantileestimator.hpp>
+
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+#include <algorithm>
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(P2QuantileEstimatorTest)
+
+BOOST_AUTO_TEST_CASE(testAgainstEmpiricalQuantile) {
+    BOOST_TEST_MESSAGE("Testing P2 quantile estimator against empirical quantiles of a normal sample");
+
+    MersenneTwisterUniformRng rng(42);
+    InverseCumulativeNormal icn;
+    std::vector<Real> sample(100000);
+    for (auto& x : sample)
+        x = icn(rng.nextReal());
+
+    std::vector<Real> sorted(sample);
+    std::sort(sorted.begin(), sorted.end());
+
+    for (Real p : {0.05, 0.5, 0.95, 0.99}) {
+        P2QuantileEstimator est(p);
+        for (auto x : sample)
+            est.add(x);
+        Real empirical = sorted[static_cast<Size>(std::floor(p * (sorted.size() - 1) + 0.5))];
+        BOOST_TEST_MESSAGE("p = " << p << ": estimate " << est.quantile() << ", empirical " << empirical);
+        BOOST_CHECK_EQUAL(est.count(), sample.size());
+        BOOST_CHECK_SMALL(est.quantile() - empirical, 0.01);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testSmallSample) {
+    BOOST_TEST_MESSAGE("Testing P2 quantile estimator with less than five observations");
+
+    P2QuantileEstimator est(0.9);
+    BOOST_CHECK_THROW(est.quantile(), QuantLib::Error);
+    est.add(3.0);
+    est.add(1.0);
+    est.add(2.0);
+    BOOST_CHECK_EQUAL(est.quantile(), 3.0);
+    BOOST_CHECK_THROW(P2QuantileEstimator(1.5), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
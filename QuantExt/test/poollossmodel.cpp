@@ -0,0 +1,128 @@
+/*
+ Copyright (C) 2026 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <qle/models/basket.hpp>
+#include <qle/models/lossdistributioncache.hpp>
+#include <qle/models/poollossmodel.hpp>
+
+#include <ql/currencies/america.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/credit/flathazardrate.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+using namespace boost::unit_test_framework;
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(PoolLossModelTest)
+
+BOOST_AUTO_TEST_CASE(testLossDistributionCache) {
+
+    BOOST_TEST_MESSAGE("Testing expected tranche losses using the loss distribution cache...");
+
+    Date refDate(22, Aug, 2016);
+    Settings::instance().evaluationDate() = refDate;
+
+    // a small inhomogeneous pool
+
+    const Size poolSize = 10;
+    auto pool = QuantLib::ext::make_shared<Pool>();
+    std::vector<std::string> names;
+    std::vector<Real> notionals, recoveryRates;
+    std::vector<QuantLib::ext::shared_ptr<SimpleQuote>> hazardRates;
+    for (Size i = 0; i < poolSize; ++i) {
+        names.push_back("Name" + std::to_string(i));
+        notionals.push_back(1.0E6);
+        recoveryRates.push_back(0.4);
+        hazardRates.push_back(QuantLib::ext::make_shared<SimpleQuote>(0.005 + 0.002 * i));
+        DefaultProbKey key = NorthAmericaCorpDefaultKey(USDCurrency(), SeniorSec, Period(), 1.0);
+        Handle<DefaultProbabilityTermStructure> curve(QuantLib::ext::make_shared<FlatHazardRate>(
+            refDate, Handle<Quote>(hazardRates.back()), Actual365Fixed()));
+        pool->add(names.back(), Issuer({std::make_pair(key, curve)}, DefaultEventSet()), key);
+    }
+
+    // equity tranches [0, D] with base correlations, [0, 0.07] is shared between the [0.03, 0.07] and the
+    // [0.07, 0.15] tranche, as in the SyntheticCDO trade
+
+    std::vector<std::pair<Real, Real>> tranches{{0.03, 0.3}, {0.07, 0.4}, {0.07, 0.4}, {0.15, 0.5}};
+    std::vector<QuantLib::ext::shared_ptr<Basket>> baskets;
+    for (auto const& t : tranches) {
+        auto basket = QuantLib::ext::make_shared<Basket>(refDate, names, notionals, pool, 0.0, t.first);
+        Handle<Quote> correlation(QuantLib::ext::make_shared<SimpleQuote>(t.second));
+        auto copula = QuantLib::ext::make_shared<ExtendedGaussianConstantLossLM>(
+            correlation, recoveryRates, std::vector<std::vector<Real>>(), std::vector<std::vector<Real>>(),
+            LatentModelIntegrationType::GaussianQuadrature, poolSize, GaussianCopulaPolicy::initTraits());
+        basket->setLossModel(QuantLib::ext::make_shared<GaussPoolLossModel>(false, copula, 200, 5.0, -5.0, 50));
+        baskets.push_back(basket);
+    }
+
+    std::vector<Date> dates{refDate + 1 * Years, refDate + 3 * Years, refDate + 5 * Years};
+
+    auto etls = [&baskets, &dates](const bool useCache) {
+        LossDistributionCache::instance().enabled = useCache;
+        std::vector<Real> result;
+        for (auto const& b : baskets)
+            for (auto const& d : dates)
+                result.push_back(b->expectedTrancheLoss(d));
+        LossDistributionCache::instance().enabled = true;
+        return result;
+    };
+
+    // the cache must be transparent, also after a market move with entries from the previous market in the cache
+
+    LossDistributionCache::instance().clear();
+    const Real tol = 1E-12;
+    for (Size scenario = 0; scenario < 3; ++scenario) {
+        hazardRates[scenario]->setValue(hazardRates[scenario]->value() + 0.001);
+        auto cached = etls(true);
+        auto cachedAgain = etls(true);
+        auto ref = etls(false);
+        BOOST_REQUIRE_EQUAL(ref.size(), cached.size());
+        for (Size i = 0; i < ref.size(); ++i) {
+            BOOST_TEST_MESSAGE("scenario " << scenario << ", etl " << i << ": " << ref[i] << " " << cached[i]);
+            BOOST_CHECK_SMALL(ref[i] - cached[i], tol);
+            BOOST_CHECK_SMALL(ref[i] - cachedAgain[i], tol);
+        }
+        // the two [0, 0.07] baskets share their distributions
+        for (Size j = 0; j < dates.size(); ++j)
+            BOOST_CHECK_SMALL(cached[dates.size() + j] - cached[2 * dates.size() + j], tol);
+    }
+
+    // the shared [0, 0.07] distributions are stored once, the other tranches add one entry per date and scenario
+    BOOST_CHECK_EQUAL(LossDistributionCache::instance().size(), 3 * 3 * dates.size());
+
+    // a lookup compares the full key
+    LossDistributionCache::instance().clear();
+    auto dist = QuantLib::ext::make_shared<const Distribution>(10, 0.0, 1.0);
+    LossDistributionCache::Key key{1.0, 0.5, 0.25};
+    LossDistributionCache::instance().add(key, dist);
+    BOOST_CHECK(LossDistributionCache::instance().get(key) == dist);
+    BOOST_CHECK(LossDistributionCache::instance().get({1.0, 0.5, 0.25 + 1E-15}) == nullptr);
+    BOOST_CHECK(LossDistributionCache::instance().get({1.0, 0.5}) == nullptr);
+    LossDistributionCache::instance().clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
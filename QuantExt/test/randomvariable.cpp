@@ -23,13 +23,18 @@
 #include <boost/test/data/test_case.hpp>
 // clang-format on
 
+#include <qle/math/alignedbufferpool.hpp>
 #include <qle/math/randomvariable.hpp>
+#include <qle/math/randomvariable_fused.hpp>
+#include <qle/math/randomvariable_jit.hpp>
+#include <qle/math/randomvariable_opcodes.hpp>
 
 #include <ql/time/date.hpp>
 #include <ql/pricingengines/blackformula.hpp>
 
 #include <boost/math/distributions/normal.hpp>
 
+#include <cstdint>
 #include <iostream>
 #include <iomanip>
 
@@ -161,6 +166,33 @@ BOOST_AUTO_TEST_CASE(testFunctions) {
     BOOST_CHECK_CLOSE((normalPdf(X)).at(0), boost::math::pdf(n, x), tol);
 }
 
+BOOST_AUTO_TEST_CASE(testSmoothedIndicators) {
+    BOOST_TEST_MESSAGE("Testing smoothed indicators...");
+
+    RandomVariable x(5), y(5, 100.0);
+    for (Size i = 0; i < 5; ++i)
+        x.set(i, 80.0 + 10.0 * static_cast<double>(i));
+
+    // without smoothing we get the crisp indicators
+
+    RandomVariable gt = indicatorGt(x, y), geq = indicatorGeq(x, y);
+    for (Size i = 0; i < 5; ++i) {
+        BOOST_CHECK_EQUAL(gt.at(i), i > 2 ? 1.0 : 0.0);
+        BOOST_CHECK_EQUAL(geq.at(i), i >= 2 ? 1.0 : 0.0);
+    }
+
+    // with smoothing the indicators are logistic functions of x - y, i.e. 1/2 for x = y and symmetric around it
+
+    RandomVariable gtSmooth = indicatorGt(x, y, 1.0, 0.0, 0.2), geqSmooth = indicatorGeq(x, y, 1.0, 0.0, 0.2);
+    BOOST_CHECK_CLOSE(gtSmooth.at(2), 0.5, 1E-10);
+    BOOST_CHECK_CLOSE(geqSmooth.at(2), 0.5, 1E-10);
+    for (Size i = 0; i < 2; ++i) {
+        BOOST_CHECK_CLOSE(gtSmooth.at(i) + gtSmooth.at(4 - i), 1.0, 1E-10);
+        BOOST_CHECK(gtSmooth.at(i) < gtSmooth.at(i + 1));
+        BOOST_CHECK(gtSmooth.at(i) > 0.0);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testBlack) {
     BOOST_TEST_MESSAGE("Testing black formula...");
 
@@ -192,6 +224,310 @@ BOOST_AUTO_TEST_CASE(testBlack) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testVectorisedFunctions) {
+    BOOST_TEST_MESSAGE("Testing vectorised functions on non-deterministic random variables...");
+
+    const Size n = 1001;
+    std::vector<double> xs(n), ys(n), zs(n);
+    for (Size i = 0; i < n; ++i) {
+        xs[i] = -40.0 + 80.0 * static_cast<double>(i) / static_cast<double>(n - 1);
+        ys[i] = std::pow(10.0, -300.0 + 600.0 * static_cast<double>(i) / static_cast<double>(n - 1));
+        zs[i] = -700.0 + 1400.0 * static_cast<double>(i) / static_cast<double>(n - 1);
+    }
+    RandomVariable X(xs), Y(ys), Z(zs);
+    boost::math::normal_distribution<double> nd;
+
+    RandomVariable expZ = QuantExt::exp(Z), logY = QuantExt::log(Y), cdfX = normalCdf(X), pdfX = normalPdf(X);
+    for (Size i = 0; i < n; ++i) {
+        BOOST_CHECK_CLOSE(expZ[i], std::exp(zs[i]), 1E-12);
+        BOOST_CHECK_CLOSE(logY[i], std::log(ys[i]), 1E-12);
+        BOOST_CHECK_SMALL(cdfX[i] - boost::math::cdf(nd, xs[i]), 1E-15);
+        if (xs[i] > -37.0)
+            BOOST_CHECK_CLOSE(cdfX[i], boost::math::cdf(nd, xs[i]), 1E-10);
+        // pdf values are flushed to zero when the exp() argument is below -708
+        if (std::abs(xs[i]) < 37.0)
+            BOOST_CHECK_CLOSE(pdfX[i], boost::math::pdf(nd, xs[i]), 1E-12);
+    }
+
+    // special values
+    RandomVariable S(std::vector<double>{0.0, -1.0, 1000.0, -1000.0, -708.0, -708.2});
+    RandomVariable expS = QuantExt::exp(S), logS = QuantExt::log(S);
+    BOOST_CHECK_EQUAL(expS[0], 1.0);
+    BOOST_CHECK(std::isinf(expS[2]));
+    BOOST_CHECK_EQUAL(expS[3], 0.0);
+    BOOST_CHECK_CLOSE(expS[4], std::exp(-708.0), 1E-12);
+    BOOST_CHECK_EQUAL(expS[5], 0.0);
+    BOOST_CHECK(std::isinf(logS[0]) && logS[0] < 0.0);
+    BOOST_CHECK(std::isnan(logS[1]));
+}
+
+BOOST_AUTO_TEST_CASE(testFusedKernel) {
+    BOOST_TEST_MESSAGE("Testing fused evaluation of elementwise random variable operations...");
+
+    // max(a * b + c - d, 0) * df, exp(a) with a slot that is used twice and a deterministic subchain
+
+    const Size n = 1000;
+    RandomVariable a(n), b(n), c(n), d(n), df(n, 0.97);
+    for (Size i = 0; i < n; ++i) {
+        a.set(i, std::sin(static_cast<double>(i)));
+        b.set(i, std::cos(0.5 * static_cast<double>(i)));
+        c.set(i, 0.1 * static_cast<double>(i % 7));
+        d.set(i, 0.3);
+    }
+
+    FusedRandomVariableKernel kernel(5);
+    Size ab = kernel.add(RandomVariableOpCode::Mult, {0, 1});
+    Size abc = kernel.add(RandomVariableOpCode::Add, {ab, 2});
+    Size abcd = kernel.add(RandomVariableOpCode::Subtract, {abc, 3});
+    Size zero = kernel.add(RandomVariableOpCode::Subtract, {4, 4});
+    Size payoff = kernel.add(RandomVariableOpCode::Max, {abcd, zero});
+    Size pv = kernel.add(RandomVariableOpCode::Mult, {payoff, 4});
+    Size ea = kernel.add(RandomVariableOpCode::Exp, {0});
+    Size dfSquared = kernel.add(RandomVariableOpCode::Mult, {4, 4});
+    kernel.markOutput(pv);
+    kernel.markOutput(ea);
+    kernel.markOutput(dfSquared);
+    kernel.markOutput(ab);
+
+    auto res = kernel.evaluate({&a, &b, &c, &d, &df});
+    BOOST_REQUIRE_EQUAL(res.size(), 4);
+
+    RandomVariable pvRef = QuantExt::max(a * b + c - d, RandomVariable(n, 0.0)) * df;
+    RandomVariable eaRef = QuantExt::exp(a);
+    RandomVariable abRef = a * b;
+
+    BOOST_CHECK(!res[0].deterministic());
+    BOOST_CHECK(res[2].deterministic());
+    BOOST_CHECK_CLOSE(res[2].at(0), 0.97 * 0.97, 1E-12);
+    for (Size i = 0; i < n; ++i) {
+        BOOST_CHECK_CLOSE(res[0][i], pvRef[i], 1E-12);
+        BOOST_CHECK_CLOSE(res[1][i], eaRef[i], 1E-12);
+        BOOST_CHECK_CLOSE(res[3][i], abRef[i], 1E-12);
+    }
+
+    // single precision evaluation
+
+    FloatRandomVariable af(a), bf(b), cf(c), df2(d), dff(df);
+    auto resf = kernel.evaluate({&af, &bf, &cf, &df2, &dff});
+    BOOST_REQUIRE_EQUAL(resf.size(), 4);
+    BOOST_CHECK(resf[2].deterministic());
+    for (Size i = 0; i < n; ++i) {
+        BOOST_CHECK_SMALL(resf[0][i] - pvRef[i], 1E-5);
+        BOOST_CHECK_SMALL(resf[1][i] - eaRef[i], 1E-5);
+    }
+    RandomVariable pvf = resf[0].toRandomVariable();
+    BOOST_CHECK(!pvf.deterministic());
+    BOOST_CHECK_SMALL(pvf[n - 1] - pvRef[n - 1], 1E-5);
+}
+
+BOOST_AUTO_TEST_CASE(testFusedKernelMultiThreaded) {
+    BOOST_TEST_MESSAGE("Testing multi-threaded fused evaluation of random variable operations...");
+
+    // enough samples to use several threads, not a multiple of the block size
+
+    const Size n = 200003;
+    RandomVariable a(n), b(n), c(n, 0.5);
+    for (Size i = 0; i < n; ++i) {
+        a.set(i, std::sin(static_cast<double>(i)));
+        b.set(i, std::cos(0.5 * static_cast<double>(i)));
+    }
+
+    FusedRandomVariableKernel kernel(3);
+    Size ab = kernel.add(RandomVariableOpCode::Mult, {0, 1});
+    Size abc = kernel.add(RandomVariableOpCode::Add, {ab, 2});
+    Size e = kernel.add(RandomVariableOpCode::Exp, {abc});
+    Size l = kernel.add(RandomVariableOpCode::Log, {e});
+    Size d = kernel.add(RandomVariableOpCode::Subtract, {l, 0});
+    Size p = kernel.add(RandomVariableOpCode::NormalCdf, {d});
+    Size q = kernel.add(RandomVariableOpCode::Mult, {p, 2});
+    Size r = kernel.add(RandomVariableOpCode::Max, {q, b});
+    kernel.markOutput(r);
+    kernel.markOutput(e);
+
+    auto res1 = kernel.evaluate({&a, &b, &c}, 1);
+    auto res4 = kernel.evaluate({&a, &b, &c}, 4);
+    BOOST_REQUIRE_EQUAL(res4.size(), 2);
+    for (Size k = 0; k < 2; ++k) {
+        BOOST_REQUIRE_EQUAL(res4[k].size(), n);
+        for (Size i = 0; i < n; ++i) {
+            if (res4[k][i] != res1[k][i]) {
+                BOOST_ERROR("multi-threaded result " << k << " differs at sample " << i << ": " << res4[k][i]
+                                                     << " vs " << res1[k][i]);
+                break;
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testJitKernel) {
+    BOOST_TEST_MESSAGE("Testing native code compilation of fused random variable operations...");
+
+    const Size n = 10007;
+    RandomVariable a(n), b(n), c(n, 0.5);
+    for (Size i = 0; i < n; ++i) {
+        a.set(i, std::sin(static_cast<double>(i)));
+        b.set(i, 1.5 + std::cos(0.5 * static_cast<double>(i)));
+    }
+
+    FusedRandomVariableKernel kernel(3);
+    Size ab = kernel.add(RandomVariableOpCode::Mult, {0, 1});
+    Size abc = kernel.add(RandomVariableOpCode::Add, {ab, 2, 0});
+    Size e = kernel.add(RandomVariableOpCode::Exp, {abc});
+    Size l = kernel.add(RandomVariableOpCode::Log, {1});
+    Size p = kernel.add(RandomVariableOpCode::NormalCdf, {0});
+    Size q = kernel.add(RandomVariableOpCode::Pow, {1, 2});
+    Size g = kernel.add(RandomVariableOpCode::IndicatorGt, {0, 2});
+    Size r = kernel.add(RandomVariableOpCode::Max, {e, l});
+    Size s = kernel.add(RandomVariableOpCode::Sqrt, {2});
+    for (auto const& o : {r, p, q, g, s})
+        kernel.markOutput(o);
+
+    RandomVariableJitModule module;
+    Size k = module.add(kernel);
+    BOOST_CHECK(module.source().find("void ore_rv_kernel_0(") != std::string::npos);
+
+    if (!RandomVariableJitModule::available()) {
+        BOOST_CHECK_THROW(module.compile(), QuantLib::Error);
+        BOOST_TEST_MESSAGE("skipping evaluation, build does not support native code compilation");
+        return;
+    }
+
+    module.compile();
+    BOOST_REQUIRE(module.compiled());
+
+    auto ref = kernel.evaluate({&a, &b, &c});
+    for (Size nThreads : {1, 4}) {
+        auto res = module.evaluate(k, {&a, &b, &c}, nThreads);
+        BOOST_REQUIRE_EQUAL(res.size(), ref.size());
+        for (Size j = 0; j < res.size(); ++j) {
+            BOOST_CHECK_EQUAL(res[j].deterministic(), ref[j].deterministic());
+            for (Size i = 0; i < n; ++i)
+                BOOST_CHECK_CLOSE(res[j][i], ref[j][i], 1E-12);
+        }
+    }
+    BOOST_CHECK_CLOSE(module.evaluate(k, {&a, &b, &c})[4].at(0), std::sqrt(0.5), 1E-12);
+
+    // modules are matched by their source: an identical module reuses the library, a different one gets its own
+
+    RandomVariableJitModule same, other;
+    same.add(kernel);
+    FusedRandomVariableKernel otherKernel(2);
+    otherKernel.markOutput(otherKernel.add(RandomVariableOpCode::Subtract, {0, 1}));
+    other.add(otherKernel);
+    same.compile();
+    other.compile();
+    auto sameRes = same.evaluate(0, {&a, &b, &c});
+    auto otherRes = other.evaluate(0, {&a, &b});
+    auto moduleRes = module.evaluate(k, {&a, &b, &c});
+    BOOST_REQUIRE_EQUAL(sameRes.size(), ref.size());
+    BOOST_REQUIRE_EQUAL(otherRes.size(), 1);
+    for (Size i = 0; i < n; ++i) {
+        BOOST_CHECK_EQUAL(sameRes[0][i], moduleRes[0][i]);
+        BOOST_CHECK_CLOSE(otherRes[0][i], a[i] - b[i], 1E-12);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testBufferPool) {
+    BOOST_TEST_MESSAGE("Testing aligned buffer pool for random variable data...");
+
+    AlignedBufferPool::releaseCachedBuffers();
+
+    const Size n = 10000;
+    const double* buffer;
+    {
+        RandomVariable x(n, 1.0);
+        x.expand();
+        buffer = x.data();
+        BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(buffer) % AlignedBufferPool::alignment, 0);
+    }
+
+    // the buffer released above is reused for the next random variable of the same size
+    RandomVariable y(n, 2.0);
+    y.expand();
+    BOOST_CHECK_EQUAL(y.data(), buffer);
+
+    // arithmetic on pooled buffers is unaffected
+    RandomVariable z = y + RandomVariable(n, 3.0);
+    z.expand();
+    for (Size i = 0; i < n; ++i)
+        BOOST_CHECK_CLOSE(z[i], 5.0, 1E-12);
+
+    // copy assignment to a deterministic variable of the same size allocates a buffer
+    RandomVariable w(n, 0.0);
+    w = y;
+    BOOST_CHECK(!w.deterministic());
+    BOOST_CHECK(w.data() != y.data());
+    BOOST_CHECK_CLOSE(w[n - 1], 2.0, 1E-12);
+
+    AlignedBufferPool::releaseCachedBuffers();
+    BOOST_CHECK_EQUAL(AlignedBufferPool::cachedBytes(), 0u);
+
+    // the cached buffers are bounded by their total size, not by their number
+    const std::size_t bytes = AlignedBufferPool::maxCachedBytes / 4;
+    std::vector<void*> buffers;
+    for (Size i = 0; i < 6; ++i)
+        buffers.push_back(AlignedBufferPool::allocate(bytes));
+    for (auto p : buffers)
+        AlignedBufferPool::deallocate(p, bytes);
+    BOOST_CHECK_EQUAL(AlignedBufferPool::cachedBytes(), 4 * bytes);
+    void* p = AlignedBufferPool::allocate(bytes);
+    BOOST_CHECK_EQUAL(AlignedBufferPool::cachedBytes(), 3 * bytes);
+    AlignedBufferPool::deallocate(p, bytes);
+
+    AlignedBufferPool::releaseCachedBuffers();
+    BOOST_CHECK_EQUAL(AlignedBufferPool::cachedBytes(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(testNormalEquationsRegression) {
+    BOOST_TEST_MESSAGE("Testing regression via blocked normal equations...");
+
+    // two regressors, order 4 polynomials, not a multiple of the block size
+
+    const Size n = 10007;
+    RandomVariable x1(n), x2(n), y(n);
+    Filter filter(n, true);
+    for (Size i = 0; i < n; ++i) {
+        double u = std::sin(static_cast<double>(i)), v = std::cos(0.7 * static_cast<double>(i));
+        x1.set(i, u);
+        x2.set(i, v);
+        y.set(i, std::exp(u) * v + 0.1 * std::sin(3.0 * static_cast<double>(i)));
+        filter.set(i, i % 3 != 0);
+    }
+    std::vector<const RandomVariable*> regressor = {&x1, &x2};
+    auto basisFn = multiPathBasisSystem(2, 4, QuantLib::LsmBasisSystem::Monomial);
+
+    for (auto const& f : {Filter(), filter}) {
+        Array qr = regressionCoefficients(y, regressor, basisFn, f, RandomVariableRegressionMethod::QR);
+        Array ne = regressionCoefficients(y, regressor, basisFn, f, RandomVariableRegressionMethod::NormalEquations);
+        BOOST_REQUIRE_EQUAL(qr.size(), ne.size());
+        for (Size j = 0; j < qr.size(); ++j)
+            BOOST_CHECK_SMALL(qr[j] - ne[j], 1E-8);
+
+        // a factorisation can be reused for several regressands
+
+        auto factorisation = normalEquationsFactorisation(regressor, basisFn, f, n);
+        BOOST_CHECK(factorisation.valid);
+        RandomVariable y2 = y * x1 + RandomVariable(n, 1.0);
+        Array c1 = regressionCoefficients(y, regressor, basisFn, f, factorisation);
+        Array c2 = regressionCoefficients(y2, regressor, basisFn, f, factorisation);
+        Array qr2 = regressionCoefficients(y2, regressor, basisFn, f, RandomVariableRegressionMethod::QR);
+        for (Size j = 0; j < qr.size(); ++j) {
+            BOOST_CHECK_SMALL(c1[j] - ne[j], 1E-12);
+            BOOST_CHECK_SMALL(c2[j] - qr2[j], 1E-8);
+        }
+    }
+
+    // collinear regressors fall back to a pivoted QR
+
+    std::vector<const RandomVariable*> collinear = {&x1, &x1};
+    auto basisFn1 = multiPathBasisSystem(2, 1, QuantLib::LsmBasisSystem::Monomial);
+    RandomVariable ceQr = conditionalExpectation(y, collinear, basisFn1, Filter(), RandomVariableRegressionMethod::QR);
+    RandomVariable ceNe =
+        conditionalExpectation(y, collinear, basisFn1, Filter(), RandomVariableRegressionMethod::NormalEquations);
+    for (Size i = 0; i < n; ++i)
+        BOOST_CHECK_SMALL(ceQr[i] - ceNe[i], 1E-10);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
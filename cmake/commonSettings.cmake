@@ -49,6 +49,26 @@ if (ORE_ENABLE_OPENCL)
   add_compile_definitions(ORE_ENABLE_OPENCL)
 endif()
 
+# set compiler macro if cuda is enabled
+if (ORE_ENABLE_CUDA)
+  add_compile_definitions(ORE_ENABLE_CUDA)
+endif()
+
+# set compiler macro if the parquet report output is enabled
+if (ORE_USE_ARROW)
+  add_compile_definitions(ORE_USE_ARROW)
+endif()
+
+# set compiler macro if log statements below a given level are compiled out
+if (ORE_COMPILE_TIME_LOG_LEVEL)
+  add_compile_definitions(ORE_COMPILE_TIME_LOG_LEVEL=${ORE_COMPILE_TIME_LOG_LEVEL})
+endif()
+
+# set compiler macro if the native code compilation of the basic cpu framework is enabled
+if (ORE_ENABLE_CPU_JIT)
+  add_compile_definitions(ORE_ENABLE_CPU_JIT)
+endif()
+
 
 # On single-configuration builds, select a default build type that gives the same compilation flags as a default autotools build.
 if(NOT CMAKE_BUILD_TYPE AND NOT CMAKE_CONFIGURATION_TYPES)